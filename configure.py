@@ -1440,10 +1440,8 @@ def set_sycl_extra_options(environ_cp):
       write_to_bazelrc('build:sycl --copt=-D{}=1'.format(platform))
   write_action_env_to_bazelrc('TF_SYCL_PLATFORM', platform)
 
-  #TODO(codeplay): Add support for half
-  #use_half = int(
-  #    get_var(environ_cp, 'TF_SYCL_USE_HALF', 'half types in SYCL', False))
-  use_half = 0
+  use_half = int(
+      get_var(environ_cp, 'TF_SYCL_USE_HALF', 'half types in SYCL', False))
   write_action_env_to_bazelrc('TF_SYCL_USE_HALF', use_half)
   if use_half == 0:
     write_to_bazelrc('build:sycl --cxxopt=-DTENSORFLOW_SYCL_NO_HALF=1')
@@ -8455,3 +8455,98 @@ void TF_EnqueueNamedTensor(TF_Session* session, int tensor_id,
                 /*run_metadata*/ nullptr, status);
   VLOG(1) << "Enqueuing is done.";
 }
+
+struct TF_SessionCallable {
+  tensorflow::Session::CallableHandle handle;
+  int ninputs;
+  int noutputs;
+};
+
+TF_SessionCallable* TF_SessionMakeCallable(
+    TF_Session* session, const TF_Buffer* run_options, const TF_Output* inputs,
+    int ninputs, const TF_Output* outputs, int noutputs,
+    const TF_Operation* const* target_opers, int ntargets, TF_Status* status) {
+  if (session->extend_before_run &&
+      !tensorflow::ExtendSessionGraphHelper(session, status)) {
+    return nullptr;
+  }
+
+  tensorflow::CallableOptions callable_options;
+  if (run_options != nullptr &&
+      !callable_options.mutable_run_options()->ParseFromArray(
+          run_options->data, run_options->length)) {
+    status->status =
+        tensorflow::errors::InvalidArgument("Unparseable RunOptions proto");
+    return nullptr;
+  }
+  for (int i = 0; i < ninputs; ++i) {
+    callable_options.add_feed(tensorflow::strings::StrCat(
+        inputs[i].oper->node.name(), ":", inputs[i].index));
+  }
+  for (int i = 0; i < noutputs; ++i) {
+    callable_options.add_fetch(tensorflow::strings::StrCat(
+        outputs[i].oper->node.name(), ":", outputs[i].index));
+  }
+  for (int i = 0; i < ntargets; ++i) {
+    callable_options.add_target(target_opers[i]->node.name());
+  }
+
+  tensorflow::Session::CallableHandle handle;
+  status->status = session->session->MakeCallable(callable_options, &handle);
+  if (!status->status.ok()) return nullptr;
+  return new TF_SessionCallable{handle, ninputs, noutputs};
+}
+
+void TF_SessionRunCallable(TF_Session* session, TF_SessionCallable* callable,
+                           TF_Tensor* const* input_values, int ninputs,
+                           TF_Tensor* const* output_values, int noutputs,
+                           TF_Buffer* run_metadata, TF_Status* status) {
+  if (ninputs != callable->ninputs || noutputs != callable->noutputs) {
+    status->status = tensorflow::errors::InvalidArgument(
+        "Expected ", callable->ninputs, " inputs and ", callable->noutputs,
+        " outputs, but got ", ninputs, " and ", noutputs);
+    return;
+  }
+  if (run_metadata != nullptr && run_metadata->data != nullptr) {
+    status->status = tensorflow::errors::InvalidArgument(
+        "Passing non-empty run_metadata is invalid.");
+    return;
+  }
+
+  // Both conversions share the buffers of the TF_Tensors, except for
+  // TF_STRING inputs.
+  std::vector<tensorflow::Tensor> feed_tensors(ninputs);
+  for (int i = 0; i < ninputs; ++i) {
+    status->status =
+        tensorflow::TF_TensorToTensor(input_values[i], &feed_tensors[i]);
+    if (!status->status.ok()) return;
+  }
+  std::vector<tensorflow::Tensor> fetch_tensors(noutputs);
+  for (int i = 0; i < noutputs; ++i) {
+    if (TF_TensorType(output_values[i]) == TF_STRING ||
+        TF_TensorType(output_values[i]) == TF_RESOURCE) {
+      status->status = tensorflow::errors::InvalidArgument(
+          "Output ", i, " must not be a TF_STRING or TF_RESOURCE tensor");
+      return;
+    }
+    status->status =
+        tensorflow::TF_TensorToTensor(output_values[i], &fetch_tensors[i]);
+    if (!status->status.ok()) return;
+  }
+
+  tensorflow::RunMetadata run_metadata_proto;
+  status->status = session->session->RunCallableIntoBuffers(
+      callable->handle, feed_tensors, &fetch_tensors, &run_metadata_proto);
+  if (!status->status.ok()) return;
+  if (run_metadata != nullptr) {
+    status->status =
+        tensorflow::MessageToBuffer(run_metadata_proto, run_metadata);
+  }
+}
+
+void TF_SessionReleaseCallable(TF_Session* session,
+                               TF_SessionCallable* callable,
+                               TF_Status* status) {
+  status->status = session->session->ReleaseCallable(callable->handle);
+  delete callable;
+}
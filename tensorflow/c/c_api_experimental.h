@@ -115,6 +115,44 @@ TF_CAPI_EXPORT extern void TF_EnqueueNamedTensor(TF_Session* session,
                                                  TF_Tensor* tensor,
                                                  TF_Status* status);
 
+// A subgraph of the graph of a TF_Session, with fixed inputs, outputs and
+// targets, which can be run repeatedly into buffers owned by the caller.
+typedef struct TF_SessionCallable TF_SessionCallable;
+
+// Creates a callable running `target_opers` and fetching `outputs` from
+// `session`, fed with `inputs`. `run_options` is an optional serialized
+// RunOptions proto used by every run of the callable.
+//
+// The caller must release the returned callable with
+// TF_SessionReleaseCallable().
+TF_CAPI_EXPORT extern TF_SessionCallable* TF_SessionMakeCallable(
+    TF_Session* session, const TF_Buffer* run_options, const TF_Output* inputs,
+    int ninputs, const TF_Output* outputs, int noutputs,
+    const TF_Operation* const* target_opers, int ntargets, TF_Status* status);
+
+// Runs `callable`, fed with `input_values`, and writes its outputs into
+// `output_values`, which the caller preallocated with the type and shape of
+// each output, e.g. with TF_NewTensor() over its own memory.
+//
+// Unlike TF_SessionRun(), no tensors are allocated for the outputs: the ops
+// producing them on the CPU write directly into the buffers of
+// `output_values`, and the other outputs are copied into them. Inputs
+// whose data is aligned are fed without a copy, as TF_NewTensor() ensures.
+// TF_STRING and TF_RESOURCE outputs are not supported. The caller keeps the
+// ownership of all the tensors.
+//
+// `run_metadata` is an optional empty buffer, which receives a serialized
+// RunMetadata proto.
+TF_CAPI_EXPORT extern void TF_SessionRunCallable(
+    TF_Session* session, TF_SessionCallable* callable,
+    TF_Tensor* const* input_values, int ninputs,
+    TF_Tensor* const* output_values, int noutputs, TF_Buffer* run_metadata,
+    TF_Status* status);
+
+// Releases `callable`, which must not be used afterwards.
+TF_CAPI_EXPORT extern void TF_SessionReleaseCallable(
+    TF_Session* session, TF_SessionCallable* callable, TF_Status* status);
+
 #ifdef __cplusplus
 } /* end extern "C" */
 #endif
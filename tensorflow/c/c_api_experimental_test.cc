@@ -116,5 +116,66 @@ TEST(CAPI_EXPERIMENTAL, ImagenetIteratorGetNext) {
   TF_DeleteStatus(s);
 }
 
+TEST(CAPI_EXPERIMENTAL, RunCallableIntoCallerBuffers) {
+  TF_Status* s = TF_NewStatus();
+  TF_Graph* graph = TF_NewGraph();
+
+  TF_Operation* feed = Placeholder(graph, s, "feed", TF_INT32, {3});
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  TF_Operation* add = Add(feed, feed, graph, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  CSession csession(graph, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  TF_Session* session = csession.mutable_session();
+
+  TF_Output input{feed, 0};
+  TF_Output output{add, 0};
+  TF_SessionCallable* callable =
+      TF_SessionMakeCallable(session, /*run_options*/ nullptr, &input, 1,
+                             &output, 1, /*target_opers*/ nullptr, 0, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  // The buffers are owned by the test, not by the tensors.
+  alignas(EIGEN_MAX_ALIGN_BYTES) int32 in[3];
+  alignas(EIGEN_MAX_ALIGN_BYTES) int32 out[3];
+  const int64_t dims[] = {3};
+  auto no_op = [](void*, size_t, void*) {};
+  TF_Tensor* input_value =
+      TF_NewTensor(TF_INT32, dims, 1, in, sizeof(in), no_op, nullptr);
+  TF_Tensor* output_value =
+      TF_NewTensor(TF_INT32, dims, 1, out, sizeof(out), no_op, nullptr);
+
+  for (int i = 0; i < 3; ++i) {
+    in[0] = i;
+    in[1] = 10 * i;
+    in[2] = -i;
+    TF_SessionRunCallable(session, callable, &input_value, 1, &output_value, 1,
+                          /*run_metadata*/ nullptr, s);
+    ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+    EXPECT_EQ(out, TF_TensorData(output_value));
+    EXPECT_EQ(2 * i, out[0]);
+    EXPECT_EQ(20 * i, out[1]);
+    EXPECT_EQ(-2 * i, out[2]);
+  }
+
+  // The output buffer must have the type of the output.
+  TF_Tensor* float_value = TF_AllocateTensor(TF_FLOAT, dims, 1, sizeof(out));
+  TF_SessionRunCallable(session, callable, &input_value, 1, &float_value, 1,
+                        /*run_metadata*/ nullptr, s);
+  EXPECT_EQ(TF_INVALID_ARGUMENT, TF_GetCode(s)) << TF_Message(s);
+
+  // Clean up
+  TF_DeleteTensor(float_value);
+  TF_DeleteTensor(output_value);
+  TF_DeleteTensor(input_value);
+  TF_SessionReleaseCallable(session, callable, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  csession.CloseAndDelete(s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  TF_DeleteGraph(graph);
+  TF_DeleteStatus(s);
+}
+
 }  // namespace
 }  // namespace tensorflow
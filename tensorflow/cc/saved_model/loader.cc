@@ -15,14 +15,20 @@ limitations under the License.
 
 #include "tensorflow/cc/saved_model/loader.h"
 
+#include <algorithm>
+#include <atomic>
 #include <unordered_set>
 
 #include "tensorflow/cc/saved_model/constants.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/protobuf_internal.h"
+#include "tensorflow/core/protobuf/master.pb.h"
 #include "tensorflow/core/protobuf/saved_model.pb.h"
 #include "tensorflow/core/protobuf/saver.pb.h"
 #include "tensorflow/core/public/session.h"
@@ -42,6 +48,61 @@ auto* load_latency = monitoring::Counter<1>::New(
     "model_path");
 constexpr char kLoadAttemptFail[] = "fail";
 constexpr char kLoadAttemptSuccess[] = "success";
+constexpr int kMaxWarmupRequests = 1000;
+
+// Reads the variables data files of a SavedModel on background threads, one
+// per shard, so that the restore op later finds them in the file system
+// cache. Errors are ignored: the restore op reports them. The destructor
+// stops the reads and waits for the threads.
+class VariablesPrefetcher {
+ public:
+  explicit VariablesPrefetcher(const string& export_dir) {
+    const string data_pattern = strings::StrCat(
+        io::JoinPath(export_dir, kSavedModelVariablesDirectory,
+                     kSavedModelVariablesFilename),
+        ".data-*");
+    std::vector<string> data_paths;
+    if (!Env::Default()->GetMatchingPaths(data_pattern, &data_paths).ok() ||
+        data_paths.empty()) {
+      return;
+    }
+    const int num_threads = std::max(
+        1, std::min<int>(data_paths.size(), port::NumSchedulableCPUs()));
+    thread_pool_.reset(new thread::ThreadPool(
+        Env::Default(), "saved_model_prefetch", num_threads));
+    for (const string& data_path : data_paths) {
+      thread_pool_->Schedule([this, data_path]() { Prefetch(data_path); });
+    }
+  }
+
+  ~VariablesPrefetcher() {
+    cancelled_ = true;
+    thread_pool_.reset();
+  }
+
+ private:
+  static constexpr size_t kChunkBytes = 8 << 20;
+
+  void Prefetch(const string& data_path) {
+    std::unique_ptr<RandomAccessFile> file;
+    if (!Env::Default()->NewRandomAccessFile(data_path, &file).ok()) return;
+    std::unique_ptr<char[]> scratch(new char[kChunkBytes]);
+    uint64 offset = 0;
+    while (!cancelled_) {
+      StringPiece chunk;
+      const Status status =
+          file->Read(offset, kChunkBytes, &chunk, scratch.get());
+      // Reading past the end of the file returns OUT_OF_RANGE.
+      if (!status.ok() || chunk.size() < kChunkBytes) return;
+      offset += chunk.size();
+    }
+  }
+
+  std::atomic<bool> cancelled_{false};
+  std::unique_ptr<thread::ThreadPool> thread_pool_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(VariablesPrefetcher);
+};
 
 Status ReadSavedModel(const string& export_dir, SavedModel* saved_model_proto) {
   const string saved_model_pb_path =
@@ -213,6 +274,88 @@ Status RunLegacyInitOp(const RunOptions& run_options, const string& export_dir,
   return Status::OK();
 }
 
+// Reads the warm-up requests of the SavedModel in "export_dir", if any.
+Status ReadWarmupRequests(const string& export_dir,
+                          std::vector<RunStepRequest>* requests) {
+  const string warmup_path =
+      io::JoinPath(export_dir, kSavedModelAssetsExtraDirectory,
+                   kSavedModelWarmupRequestsFilename);
+  if (!Env::Default()->FileExists(warmup_path).ok()) {
+    LOG(INFO) << "The specified SavedModel has no warm-up requests.";
+    return Status::OK();
+  }
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(Env::Default()->NewRandomAccessFile(warmup_path, &file));
+  io::RecordReader reader(file.get());
+  uint64 offset = 0;
+  string record;
+  while (true) {
+    const Status status = reader.ReadRecord(&offset, &record);
+    if (errors::IsOutOfRange(status)) break;
+    TF_RETURN_IF_ERROR(status);
+    if (requests->size() == kMaxWarmupRequests) {
+      return errors::InvalidArgument("More than ", kMaxWarmupRequests,
+                                     " warm-up requests in ", warmup_path);
+    }
+    requests->emplace_back();
+    if (!requests->back().ParseFromString(record)) {
+      return errors::DataLoss("Could not parse warm-up request ",
+                              requests->size() - 1, " in ", warmup_path);
+    }
+  }
+  return Status::OK();
+}
+
+// Runs "request" in "session", discarding the outputs.
+Status RunWarmupRequest(const RunOptions& run_options,
+                        const RunStepRequest& request, Session* session) {
+  std::vector<std::pair<string, Tensor>> inputs;
+  for (const NamedTensorProto& feed : request.feed()) {
+    Tensor tensor;
+    if (!tensor.FromProto(feed.tensor())) {
+      return errors::InvalidArgument("Invalid warm-up tensor for feed ",
+                                     feed.name());
+    }
+    inputs.emplace_back(feed.name(), tensor);
+  }
+  const std::vector<string> output_tensor_names(request.fetch().begin(),
+                                                request.fetch().end());
+  const std::vector<string> target_node_names(request.target().begin(),
+                                              request.target().end());
+  std::vector<Tensor> outputs;
+  RunMetadata run_metadata;
+  return session->Run(run_options, inputs, output_tensor_names,
+                      target_node_names, &outputs, &run_metadata);
+}
+
+// Replays the warm-up requests of the SavedModel in "export_dir" through
+// "session" on "num_threads" threads.
+Status RunWarmup(const RunOptions& run_options, const string& export_dir,
+                 int num_threads, Session* session) {
+  std::vector<RunStepRequest> requests;
+  TF_RETURN_IF_ERROR(ReadWarmupRequests(export_dir, &requests));
+  if (requests.empty()) return Status::OK();
+  LOG(INFO) << "Running " << requests.size()
+            << " warm-up requests on SavedModel bundle.";
+  std::vector<Status> statuses(requests.size());
+  {
+    thread::ThreadPool thread_pool(Env::Default(), "saved_model_warmup",
+                                   std::max(1, num_threads));
+    for (int i = 0; i < requests.size(); ++i) {
+      thread_pool.Schedule([&run_options, &requests, &statuses, session, i]() {
+        statuses[i] = RunWarmupRequest(run_options, requests[i], session);
+      });
+    }
+  }
+  for (int i = 0; i < statuses.size(); ++i) {
+    if (!statuses[i].ok()) {
+      return errors::FailedPrecondition("Warm-up request ", i, " failed: ",
+                                        statuses[i].ToString());
+    }
+  }
+  return Status::OK();
+}
+
 Status GetAssetFileDefs(const MetaGraphDef& meta_graph_def,
                         std::vector<AssetFileDef>* asset_file_defs) {
   const auto& collection_def_map = meta_graph_def.collection_def();
@@ -234,6 +377,7 @@ Status LoadSavedModelInternal(const SessionOptions& session_options,
                               const RunOptions& run_options,
                               const string& export_dir,
                               const std::unordered_set<string>& tags,
+                              const LoadSavedModelOptions& load_options,
                               SavedModelBundle* const bundle) {
   if (!MaybeSavedModelDirectory(export_dir)) {
     return Status(error::Code::NOT_FOUND,
@@ -242,6 +386,12 @@ Status LoadSavedModelInternal(const SessionOptions& session_options,
   LOG(INFO) << "Loading SavedModel with tags: " << GetTagsAsString(tags)
             << "; from: " << export_dir;
 
+  // Overlaps the reads of the variables with the import of the meta graph.
+  std::unique_ptr<VariablesPrefetcher> prefetcher;
+  if (load_options.prefetch_variables) {
+    prefetcher.reset(new VariablesPrefetcher(export_dir));
+  }
+
   SavedModel saved_model_proto;
   TF_RETURN_IF_ERROR(ReadSavedModel(export_dir, &saved_model_proto));
 
@@ -259,6 +409,7 @@ Status LoadSavedModelInternal(const SessionOptions& session_options,
                  bundle->meta_graph_def.saver_def().restore_op_name(),
                  bundle->meta_graph_def.saver_def().filename_tensor_name(),
                  asset_file_defs, bundle->session.get()));
+  prefetcher.reset();
   if (HasMainOp(bundle->meta_graph_def)) {
     TF_RETURN_IF_ERROR(RunMainOp(run_options, export_dir,
                                  bundle->meta_graph_def, asset_file_defs,
@@ -268,6 +419,11 @@ Status LoadSavedModelInternal(const SessionOptions& session_options,
                                        bundle->meta_graph_def, asset_file_defs,
                                        bundle->session.get()));
   }
+  if (load_options.run_warmup_requests) {
+    TF_RETURN_IF_ERROR(RunWarmup(run_options, export_dir,
+                                 load_options.num_warmup_threads,
+                                 bundle->session.get()));
+  }
   return Status::OK();
 }
 
@@ -277,10 +433,19 @@ Status LoadSavedModel(const SessionOptions& session_options,
                       const RunOptions& run_options, const string& export_dir,
                       const std::unordered_set<string>& tags,
                       SavedModelBundle* const bundle) {
+  return LoadSavedModel(session_options, run_options, export_dir, tags,
+                        LoadSavedModelOptions(), bundle);
+}
+
+Status LoadSavedModel(const SessionOptions& session_options,
+                      const RunOptions& run_options, const string& export_dir,
+                      const std::unordered_set<string>& tags,
+                      const LoadSavedModelOptions& load_options,
+                      SavedModelBundle* const bundle) {
   // TODO(robson): Add tests for the counters.
   const uint64 start_microseconds = Env::Default()->NowMicros();
-  const Status status = LoadSavedModelInternal(session_options, run_options,
-                                               export_dir, tags, bundle);
+  const Status status = LoadSavedModelInternal(
+      session_options, run_options, export_dir, tags, load_options, bundle);
   const uint64 load_latency_microsecs = [&]() -> uint64 {
     const uint64 end_microseconds = Env::Default()->NowMicros();
     // Avoid clock skew.
@@ -43,6 +43,29 @@ struct SavedModelBundle {
   SavedModelBundle() = default;
 };
 
+/// Options for LoadSavedModel beyond those of the session it creates.
+struct LoadSavedModelOptions {
+  /// If true, the variables data files are read on background threads, one
+  /// per shard, while the meta graph is imported into the session and the
+  /// restore subgraph is optimized. The restore op then reads the variables
+  /// from the file system cache. Only useful when the variables fit in the
+  /// host memory; combine it with TF_RESTORE_V2_MEMORY_MAP to keep a single
+  /// copy of them.
+  bool prefetch_variables = false;
+
+  /// If true, the requests in assets.extra/saved_model_warmup_requests are
+  /// replayed through the session once the variables are restored and the
+  /// init op has run, so that the first real requests do not pay for kernel
+  /// compilation, allocator growth or autotuning. The file holds up to 1000
+  /// uncompressed TFRecords, each a serialized RunStepRequest of which the
+  /// feed, fetch and target fields are used. A missing file is not an error,
+  /// but a failing request fails the load.
+  bool run_warmup_requests = false;
+
+  /// The number of threads replaying the warm-up requests concurrently.
+  int num_warmup_threads = 1;
+};
+
 /// Loads a SavedModel from the specified export directory. The meta graph def
 /// to be loaded is identified by the supplied tags, corresponding exactly to
 /// the set of tags used at SavedModel build time. Returns a SavedModel bundle
@@ -52,6 +75,13 @@ Status LoadSavedModel(const SessionOptions& session_options,
                       const std::unordered_set<string>& tags,
                       SavedModelBundle* const bundle);
 
+/// As above, with the loading behavior configured by `load_options`.
+Status LoadSavedModel(const SessionOptions& session_options,
+                      const RunOptions& run_options, const string& export_dir,
+                      const std::unordered_set<string>& tags,
+                      const LoadSavedModelOptions& load_options,
+                      SavedModelBundle* const bundle);
+
 /// Checks whether the provided directory could contain a SavedModel. Note that
 /// the method does not load any data by itself. If the method returns `false`,
 /// the export directory definitely does not contain a SavedModel. If the method
@@ -24,8 +24,10 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/io/record_writer.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/master.pb.h"
 
 namespace tensorflow {
 namespace {
@@ -198,6 +200,88 @@ TEST_F(LoaderTest, MainOpFormat) {
   CheckSavedModelBundle(export_dir, bundle);
 }
 
+TEST_F(LoaderTest, PrefetchVariables) {
+  SavedModelBundle bundle;
+  SessionOptions session_options;
+  RunOptions run_options;
+  LoadSavedModelOptions load_options;
+  load_options.prefetch_variables = true;
+
+  const string export_dir =
+      io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded);
+  TF_ASSERT_OK(LoadSavedModel(session_options, run_options, export_dir,
+                              {kSavedModelTagServe}, load_options, &bundle));
+  CheckSavedModelBundle(export_dir, bundle);
+}
+
+TEST_F(LoaderTest, WarmupRequests) {
+  // Copies the SavedModel, adding warm-up requests to it.
+  const string src_dir =
+      io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded);
+  const string export_dir = io::JoinPath(testing::TmpDir(), "warmup");
+  Env* env = Env::Default();
+  for (const string& dir :
+       {export_dir, io::JoinPath(export_dir, kSavedModelAssetsDirectory),
+        io::JoinPath(export_dir, kSavedModelAssetsExtraDirectory),
+        io::JoinPath(export_dir, kSavedModelVariablesDirectory)}) {
+    TF_ASSERT_OK(env->RecursivelyCreateDir(dir));
+  }
+  for (const string& file :
+       {string(kSavedModelFilenamePb), string("assets/foo.txt"),
+        string("variables/variables.index"),
+        string("variables/variables.data-00000-of-00001")}) {
+    string contents;
+    TF_ASSERT_OK(
+        ReadFileToString(env, io::JoinPath(src_dir, file), &contents));
+    TF_ASSERT_OK(
+        WriteStringToFile(env, io::JoinPath(export_dir, file), contents));
+  }
+
+  const string warmup_path =
+      io::JoinPath(export_dir, kSavedModelAssetsExtraDirectory,
+                   kSavedModelWarmupRequestsFilename);
+  auto write_warmup_requests = [&](const string& output_name) {
+    std::unique_ptr<WritableFile> file;
+    TF_ASSERT_OK(env->NewWritableFile(warmup_path, &file));
+    io::RecordWriter writer(file.get());
+    for (float x : {0, 1, 2}) {
+      RunStepRequest request;
+      NamedTensorProto* feed = request.add_feed();
+      feed->set_name("tf_example:0");
+      test::AsTensor<string>({MakeSerializedExample(x)}, TensorShape({1}))
+          .AsProtoTensorContent(feed->mutable_tensor());
+      request.add_fetch(output_name);
+      TF_ASSERT_OK(writer.WriteRecord(request.SerializeAsString()));
+    }
+    TF_ASSERT_OK(writer.Close());
+    TF_ASSERT_OK(file->Close());
+  };
+
+  SessionOptions session_options;
+  RunOptions run_options;
+  LoadSavedModelOptions load_options;
+  load_options.run_warmup_requests = true;
+  load_options.num_warmup_threads = 2;
+  {
+    write_warmup_requests("y:0");
+    SavedModelBundle bundle;
+    TF_ASSERT_OK(LoadSavedModel(session_options, run_options, export_dir,
+                                {kSavedModelTagServe}, load_options, &bundle));
+    CheckSavedModelBundle(export_dir, bundle);
+  }
+  {
+    write_warmup_requests("missing:0");
+    SavedModelBundle bundle;
+    const Status status =
+        LoadSavedModel(session_options, run_options, export_dir,
+                       {kSavedModelTagServe}, load_options, &bundle);
+    EXPECT_FALSE(status.ok());
+    EXPECT_TRUE(str_util::StrContains(status.error_message(),
+                                      "Warm-up request"))
+        << status;
+  }
+}
+
 TEST_F(LoaderTest, InvalidExportPath) {
   SavedModelBundle bundle;
   RunOptions run_options;
@@ -68,6 +68,11 @@ void AppendMainFlags(std::vector<Flag>* flag_list, MainFlags* flags) {
        "function."},
       {"out_session_module", &flags->out_session_module,
        "Output session module proto."},
+      {"batch_size", &flags->batch_size,
+       "If positive, overrides the first dimension of all feed shapes, to "
+       "compile the variant of the model for that batch size.  Each batch "
+       "size needs its own --cpp_class and --entry_point, so that several "
+       "variants can be linked into the same binary."},
       {"gen_name_to_index", &flags->gen_name_to_index,
        "Generate name-to-index data for Lookup{Arg,Result}Index methods."},
       {"gen_program_shape", &flags->gen_program_shape,
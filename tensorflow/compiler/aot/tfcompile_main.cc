@@ -62,6 +62,19 @@ Status ReadProtoFile(const string& fname, protobuf::Message* proto) {
   }
 }
 
+// Sets the first dimension of the shapes of all feeds in `config` to
+// `batch_size`.
+Status SetFeedBatchSize(int32 batch_size, tf2xla::Config* config) {
+  for (tf2xla::Feed& feed : *config->mutable_feed()) {
+    if (feed.shape().dim_size() == 0) {
+      return errors::InvalidArgument("Feed ", feed.id().node_name(),
+                                     " has no batch dimension");
+    }
+    feed.mutable_shape()->mutable_dim(0)->set_size(batch_size);
+  }
+  return Status::OK();
+}
+
 Status Main(const MainFlags& flags) {
   // Process config.
   tf2xla::Config config;
@@ -70,6 +83,9 @@ Status Main(const MainFlags& flags) {
   }
   TF_RETURN_IF_ERROR(ReadProtoFile(flags.config, &config));
   TF_RETURN_IF_ERROR(ValidateConfig(config));
+  if (flags.batch_size > 0) {
+    TF_RETURN_IF_ERROR(SetFeedBatchSize(flags.batch_size, &config));
+  }
   if (flags.dump_fetch_nodes) {
     std::set<string> nodes;
     for (const tf2xla::Fetch& fetch : config.fetch()) {
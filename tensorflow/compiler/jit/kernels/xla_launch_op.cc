@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/compiler/jit/kernels/xla_launch_op.h"
 
 #include "tensorflow/compiler/jit/defs.h"
+#include "tensorflow/compiler/jit/legacy_flags/mark_for_compilation_pass_flags.h"
 #include "tensorflow/compiler/jit/xla_device.h"
 #include "tensorflow/compiler/jit/xla_launch_util.h"
 #include "tensorflow/compiler/tf2xla/shape_util.h"
@@ -43,7 +44,7 @@ XlaLocalLaunchBase::XlaLocalLaunchBase(OpKernelConstruction* ctx,
                                        const std::vector<int>& constants,
                                        const std::vector<int>& resources,
                                        const NameAttrList& function)
-    : OpKernel(ctx),
+    : AsyncOpKernel(ctx),
       constants_(constants),
       resources_(resources),
       device_type_(ctx->device_type()),
@@ -90,28 +91,116 @@ Status XlaLocalLaunchBase::BuildCompilationCache(OpKernelContext* ctx,
   return Status::OK();
 }
 
-void XlaLocalLaunchBase::Compute(OpKernelContext* ctx) {
+void XlaLocalLaunchBase::ComputeAsync(OpKernelContext* ctx,
+                                      DoneCallback done) {
   VLOG(1) << "XlaLocalLaunchOpBase::Compute "
           << Canonicalize(function_.name(), AttrSlice(&function_.attr()));
   // We store information about the JIT-compiled XLA computation
   // in the ResourceMgr.
   ResourceMgr* rm = ctx->resource_manager();
-  OP_REQUIRES(ctx, rm, errors::Internal("No resource manager."));
-
-  se::Stream* stream =
-      ctx->op_device_context() ? ctx->op_device_context()->stream() : nullptr;
+  OP_REQUIRES_ASYNC(ctx, rm, errors::Internal("No resource manager."), done);
 
   XlaCompilationCache* cache;
-  OP_REQUIRES_OK(ctx, rm->LookupOrCreate<XlaCompilationCache>(
-                          rm->default_container(), "xla_cache", &cache,
-                          [this, ctx](XlaCompilationCache** cache) {
-                            return BuildCompilationCache(ctx, cache);
-                          }));
+  OP_REQUIRES_OK_ASYNC(ctx,
+                       rm->LookupOrCreate<XlaCompilationCache>(
+                           rm->default_container(), "xla_cache", &cache,
+                           [this, ctx](XlaCompilationCache** cache) {
+                             return BuildCompilationCache(ctx, cache);
+                           }),
+                       done);
   // Hold the reference to the JIT during evaluation. (We could probably
   // free it sooner because the ResourceMgr will retain a reference, but
   // this is more obviously correct.)
   core::ScopedUnref cache_ref(cache);
 
+  std::map<int, OptionalTensor> variables =
+      SnapshotResourceVariables(ctx, resources_);
+
+  std::map<int, Tensor> constant_args;
+  for (int i : constants_) {
+    constant_args.insert({i, ctx->input(i)});
+  }
+
+  // Clusters whose input shapes keep changing would be compiled over and
+  // over. Past the limit of signatures, run their TensorFlow graph instead.
+  const legacy_flags::MarkForCompilationPassFlags* flags =
+      legacy_flags::GetMarkForCompilationPassFlags();
+  const int64 max_signatures = flags->tf_xla_max_cluster_signatures;
+  const XlaDevice::Metadata* metadata = nullptr;
+  const bool can_fall_back =
+      allow_function_fallback_ && !XlaDevice::GetMetadata(ctx, &metadata).ok();
+  if (can_fall_back && max_signatures > 0 &&
+      cache->ReachedSignatureLimit(function_, constant_args, variables, ctx,
+                                   max_signatures)) {
+    VLOG(1) << "Running the TensorFlow graph of " << function_.name()
+            << ", compiled for " << max_signatures << " signatures already";
+    RunFunction(ctx, std::move(done));
+    return;
+  }
+
+  bool pending = false;
+  CompileAndRun(ctx, cache, constant_args, variables,
+                can_fall_back && flags->tf_xla_async_compilation, &pending);
+  if (pending) {
+    VLOG(1) << "Running the TensorFlow graph of " << function_.name()
+            << " while it is compiled";
+    RunFunction(ctx, std::move(done));
+    return;
+  }
+  done();
+}
+
+void XlaLocalLaunchBase::RunFunction(OpKernelContext* ctx,
+                                     DoneCallback done) {
+  FunctionLibraryRuntime* lib = ctx->function_library();
+  OP_REQUIRES_ASYNC(ctx, lib != nullptr,
+                    errors::Internal("No function library is provided."),
+                    done);
+  FunctionLibraryRuntime::Handle handle;
+  OP_REQUIRES_OK_ASYNC(ctx,
+                       lib->Instantiate(function_.name(),
+                                        AttrSlice(&function_.attr()), &handle),
+                       done);
+
+  FunctionLibraryRuntime::Options opts;
+  opts.step_id = ctx->step_id();
+  opts.rendezvous = ctx->rendezvous();
+  opts.cancellation_manager = ctx->cancellation_manager();
+  opts.runner = ctx->runner();
+  opts.stats_collector = ctx->stats_collector();
+  opts.step_container = ctx->step_container();
+  opts.collective_executor = ctx->collective_executor();
+  std::vector<Tensor> args;
+  args.reserve(ctx->num_inputs());
+  for (int i = 0; i < ctx->num_inputs(); ++i) {
+    args.push_back(ctx->input(i));
+  }
+  std::vector<Tensor>* rets = new std::vector<Tensor>;
+  lib->Run(opts, handle, args, rets, [ctx, done, rets](const Status& status) {
+    if (!status.ok()) {
+      ctx->SetStatus(status);
+    } else if (rets->size() != static_cast<size_t>(ctx->num_outputs())) {
+      ctx->SetStatus(errors::Internal(
+          "The function of XlaLaunch returned ", rets->size(),
+          " tensor(s) instead of ", ctx->num_outputs()));
+    } else {
+      for (size_t i = 0; i < rets->size(); ++i) {
+        ctx->set_output(i, (*rets)[i]);
+      }
+    }
+    delete rets;
+    done();
+  });
+}
+
+void XlaLocalLaunchBase::CompileAndRun(
+    OpKernelContext* ctx, XlaCompilationCache* cache,
+    const std::map<int, Tensor>& constant_args,
+    const std::map<int, OptionalTensor>& variables, bool compile_async,
+    bool* pending) {
+  se::Stream* stream =
+      ctx->op_device_context() ? ctx->op_device_context()->stream() : nullptr;
+
   const XlaDevice::Metadata* metadata = nullptr;
   Status s = XlaDevice::GetMetadata(ctx, &metadata);
   bool allocate_xla_tensors = s.ok();
@@ -123,9 +212,6 @@ void XlaLocalLaunchBase::Compute(OpKernelContext* ctx) {
     }
   }
 
-  std::map<int, OptionalTensor> variables =
-      SnapshotResourceVariables(ctx, resources_);
-
   xla::LocalClient* client = static_cast<xla::LocalClient*>(cache->client());
 
   XlaAllocator local_xla_allocator(client->backend().platform(),
@@ -160,15 +246,21 @@ void XlaLocalLaunchBase::Compute(OpKernelContext* ctx) {
   const XlaCompiler::CompilationResult* kernel;
   xla::LocalExecutable* executable;
 
-  std::map<int, Tensor> constant_args;
-  for (int i : constants_) {
-    constant_args.insert({i, ctx->input(i)});
-  }
   XlaCompiler::CompileOptions compile_options;
   compile_options.is_entry_computation = true;
-  OP_REQUIRES_OK(
-      ctx, cache->Compile(options, function_, constant_args, variables, ctx,
-                          &kernel, &executable, &compile_options));
+  if (compile_async) {
+    OP_REQUIRES_OK(ctx, cache->CompileAsync(options, function_, constant_args,
+                                            variables, ctx, &kernel,
+                                            &executable, &compile_options));
+    if (kernel == nullptr) {
+      *pending = true;
+      return;
+    }
+  } else {
+    OP_REQUIRES_OK(
+        ctx, cache->Compile(options, function_, constant_args, variables, ctx,
+                            &kernel, &executable, &compile_options));
+  }
 
   VLOG(1) << "Executing XLA Computation...";
 
@@ -250,7 +342,11 @@ NameAttrList FunctionAttr(OpKernelConstruction* ctx) {
 
 XlaLocalLaunchOp::XlaLocalLaunchOp(OpKernelConstruction* ctx)
     : XlaLocalLaunchBase(ctx, ConstantsVector(ctx), ResourcesVector(ctx),
-                         FunctionAttr(ctx)) {}
+                         FunctionAttr(ctx)) {
+  // The inputs of XlaLaunch are the arguments of its function, whose body
+  // runs on the device's own kernels.
+  allow_function_fallback_ = true;
+}
 
 XlaLocalLaunchOp::~XlaLocalLaunchOp() {
   VLOG(1) << "XlaLocalLaunchOp destroyed";
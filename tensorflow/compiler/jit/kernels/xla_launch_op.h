@@ -34,7 +34,7 @@ namespace tensorflow {
 // in the GraphDef.
 // Currently, it is used by eager runtime. FunctionLibraryRuntime creates
 // this kernel when asked to create a kernel for an XLA-compiled function.
-class XlaLocalLaunchBase : public OpKernel {
+class XlaLocalLaunchBase : public AsyncOpKernel {
  public:
   XlaLocalLaunchBase(OpKernelConstruction* ctx,
                      const std::vector<int>& constants,
@@ -44,13 +44,25 @@ class XlaLocalLaunchBase : public OpKernel {
   XlaLocalLaunchBase& operator=(const XlaLocalLaunchBase&) = delete;
   ~XlaLocalLaunchBase() override = default;
 
-  void Compute(OpKernelContext* ctx) override;
+  void ComputeAsync(OpKernelContext* ctx, DoneCallback done) override;
 
  protected:
   // Builds a XlaCompilationCache class suitable for the current device.
   Status BuildCompilationCache(OpKernelContext* ctx,
                                XlaCompilationCache** cache);
 
+  // Compiles the function for the inputs of `ctx`, if needed, and runs it.
+  // With `compile_async`, a function not compiled yet for these inputs is
+  // compiled in the background instead, and `*pending` is set to true
+  // without running anything.
+  void CompileAndRun(OpKernelContext* ctx, XlaCompilationCache* cache,
+                     const std::map<int, Tensor>& constant_args,
+                     const std::map<int, OptionalTensor>& variables,
+                     bool compile_async, bool* pending);
+
+  // Runs the TensorFlow graph of the function, without compiling it.
+  void RunFunction(OpKernelContext* ctx, DoneCallback done);
+
   // Indexes of compile-time constant inputs
   std::vector<int> constants_;
   // Indexes of resource inputs
@@ -59,6 +71,10 @@ class XlaLocalLaunchBase : public OpKernel {
   DeviceType device_type_;
   NameAttrList function_;
   se::Platform::Id platform_id_;
+
+  // Whether the function may be run by the FunctionLibraryRuntime, when it
+  // was compiled for too many signatures already.
+  bool allow_function_fallback_ = false;
 };
 
 // XlaLocalLaunchOp is used to replace a region of the TensorFlow graph
@@ -42,6 +42,8 @@ static void AllocateFlags() {
   flags->tf_xla_cpu_global_jit = false;
   flags->tf_xla_clustering_fuel = std::numeric_limits<int64>::max();
   flags->tf_xla_fusion_only = false;
+  flags->tf_xla_max_cluster_signatures = 0;
+  flags->tf_xla_async_compilation = false;
   flag_list = new std::vector<Flag>(
       {Flag("tf_xla_auto_jit", &flags->tf_xla_auto_jit,
             "Control compilation of operators into XLA computations on CPU and "
@@ -63,7 +65,16 @@ static void AllocateFlags() {
             "eligible for clustering."),
        Flag("tf_xla_fusion_only", &flags->tf_xla_fusion_only,
             "enable fusion of element-wise operations only using XLA when "
-            "global_jit_level is ON*.")});
+            "global_jit_level is ON*."),
+       Flag("tf_xla_max_cluster_signatures",
+            &flags->tf_xla_max_cluster_signatures,
+            "Maximum number of input signatures an XLA cluster on a CPU or GPU "
+            "device is compiled for. Beyond it, new signatures run the "
+            "cluster's TensorFlow graph instead. 0 = no limit."),
+       Flag("tf_xla_async_compilation", &flags->tf_xla_async_compilation,
+            "Compile XLA clusters on CPU or GPU devices for new input "
+            "signatures in the background, running the cluster's TensorFlow "
+            "graph until the compilation is done.")});
   xla::legacy_flags::ParseFlagsFromEnv(*flag_list);
 }
 
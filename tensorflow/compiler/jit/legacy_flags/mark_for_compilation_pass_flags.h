@@ -55,6 +55,15 @@ typedef struct {
                             // is set to ON* and overrides its behavior. If
                             // true, enable fusion of element-wise operations
                             // only using XLA.
+  int64 tf_xla_max_cluster_signatures;  // Maximum number of input signatures
+                                        // an XLA cluster on a CPU or GPU
+                                        // device is compiled for. Beyond it,
+                                        // new signatures run the cluster's
+                                        // TensorFlow graph. 0 = no limit.
+  bool tf_xla_async_compilation;  // If true, XLA clusters on CPU or GPU
+                                  // devices are compiled in the background
+                                  // for new signatures, running their
+                                  // TensorFlow graph meanwhile.
 } MarkForCompilationPassFlags;
 
 // Return a pointer to the MarkForCompilationPassFlags struct;
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/compiler/jit/xla_compilation_cache.h"
 
+#include <algorithm>
+#include <memory>
 #include <numeric>
 
 #include "tensorflow/compiler/tf2xla/dump_graph.h"
@@ -30,13 +32,43 @@ limitations under the License.
 #include "tensorflow/core/graph/graph_constructor.h"
 #include "tensorflow/core/graph/node_builder.h"
 #include "tensorflow/core/kernels/variable_ops.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/public/version.h"
 
 namespace tensorflow {
 
+namespace {
+
+auto* xla_compilations = monitoring::Counter<1>::New(
+    "/tensorflow/core/xla_compilations",
+    "The number of XLA compilations of each function or op.", "function");
+
+auto* xla_compilation_time_usecs = monitoring::Counter<1>::New(
+    "/tensorflow/core/xla_compilation_time_usecs",
+    "The time spent compiling each function or op with XLA.", "function");
+
+// Records a compilation of `name` taking `elapsed_us` in the metrics.
+void RecordCompilation(const string& name, uint64 elapsed_us) {
+  xla_compilations->GetCell(name)->IncrementBy(1);
+  xla_compilation_time_usecs->GetCell(name)->IncrementBy(elapsed_us);
+  VLOG(1) << "Compiled " << name << " in " << elapsed_us << "us";
+}
+
+// The threads of CompileAsync(), shared by all the caches.
+thread::ThreadPool* GetCompilationThreadPool() {
+  static thread::ThreadPool* pool = new thread::ThreadPool(
+      Env::Default(), "xla_compilation",
+      std::max(1, port::NumSchedulableCPUs() / 2));
+  return pool;
+}
+
+}  // namespace
+
 XlaCompilationCache::XlaCompilationCache(xla::LocalClient* client,
                                          DeviceType device_type)
     : client_(client), device_type_(std::move(device_type)) {}
@@ -120,6 +152,21 @@ Status XlaCompilationCache::BuildSignature(
   return Status::OK();
 }
 
+bool XlaCompilationCache::ReachedSignatureLimit(
+    const NameAttrList& function, const std::map<int, Tensor>& constant_args,
+    const std::map<int, OptionalTensor>& variable_args, OpKernelContext* ctx,
+    int64 max_signatures) {
+  Signature signature;
+  if (!BuildSignature(function, constant_args, variable_args, ctx, &signature)
+           .ok()) {
+    return false;
+  }
+  mutex_lock lock(mu_);
+  if (cache_.count(signature) > 0) return false;
+  auto it = num_signatures_.find(signature.name);
+  return it != num_signatures_.end() && it->second >= max_signatures;
+}
+
 namespace {
 
 // Builds a XlaCompiler::Argument vector from the arguments to the XlaLaunch op.
@@ -232,6 +279,108 @@ Status XlaCompilationCache::CompileSingleOp(
                      compilation_result, executable, compile_options, true);
 }
 
+XlaCompilationCache::Entry* XlaCompilationCache::LookupOrCreateEntry(
+    const Signature& signature) {
+  // The outer lock protects the existence of the cache entry. It does not
+  // protect the contents of the cache entry.
+  mutex_lock lock(mu_);
+  // Find or create a cache entry.
+  std::unique_ptr<Entry>& e = cache_[signature];
+  if (!e) {
+    e.reset(new Entry);
+    ++num_signatures_[signature.name];
+  }
+  return e.get();
+}
+
+Status XlaCompilationCache::CompileAsync(
+    const XlaCompiler::Options& options, const NameAttrList& function,
+    const std::map<int, Tensor>& constant_args,
+    const std::map<int, OptionalTensor>& variable_args, OpKernelContext* ctx,
+    const XlaCompiler::CompilationResult** compilation_result,
+    xla::LocalExecutable** executable,
+    const XlaCompiler::CompileOptions* compile_options) {
+  *compilation_result = nullptr;
+  *executable = nullptr;
+  TF_RET_CHECK(constant_args.size() + variable_args.size() <=
+               ctx->num_inputs());
+
+  Signature signature;
+  TF_RETURN_IF_ERROR(
+      BuildSignature(function, constant_args, variable_args, ctx, &signature));
+  Entry* entry = LookupOrCreateEntry(signature);
+  {
+    mutex_lock entry_lock(entry->mu);
+    if (entry->compiled) {
+      *compilation_result = &entry->compilation_result;
+      *executable = entry->executable.get();
+      return entry->compilation_status;
+    }
+    if (entry->compiling) {
+      return Status::OK();
+    }
+  }
+
+  // The arguments are built on this thread, the only one with `ctx`.
+  std::vector<XlaCompiler::Argument> args;
+  TF_RETURN_IF_ERROR(BuildArguments(constant_args, variable_args, ctx, &args));
+  {
+    mutex_lock entry_lock(entry->mu);
+    if (entry->compiled || entry->compiling) {
+      return Status::OK();
+    }
+    entry->compiling = true;
+  }
+  VLOG(1) << "Compiling signature in the background: "
+          << SignatureDebugString(signature);
+
+  // The function library is copied, as the caller's one may be destroyed
+  // before the compilation is done.
+  std::shared_ptr<FunctionLibraryDefinition> flib_def(
+      new FunctionLibraryDefinition(*options.flib_def));
+  XlaCompiler::Options background_options = options;
+  background_options.flib_def = flib_def.get();
+  background_options.device_allocator = nullptr;
+  const XlaCompiler::CompileOptions background_compile_options =
+      compile_options ? *compile_options : XlaCompiler::CompileOptions();
+  const string name = signature.name;
+
+  // The cache must outlive the compilation.
+  Ref();
+  GetCompilationThreadPool()->Schedule([this, entry, flib_def,
+                                        background_options,
+                                        background_compile_options, function,
+                                        args, name]() {
+    const uint64 start_us = Env::Default()->NowMicros();
+    XlaCompiler::CompilationResult result;
+    std::unique_ptr<xla::LocalExecutable> executable;
+    Status status;
+    {
+      XlaCompiler compiler(background_options);
+      status = compiler.CompileFunction(background_compile_options, function,
+                                        args, &result);
+    }
+    if (status.ok()) {
+      status = BuildExecutable(background_options, result, &executable);
+    }
+    RecordCompilation(name, Env::Default()->NowMicros() - start_us);
+    {
+      mutex_lock entry_lock(entry->mu);
+      // A synchronous Compile() may have filled the entry meanwhile, whose
+      // results are in use.
+      if (!entry->compiled) {
+        entry->compilation_status = status;
+        entry->compilation_result = std::move(result);
+        entry->executable = std::move(executable);
+        entry->compiled = true;
+      }
+      entry->compiling = false;
+    }
+    Unref();
+  });
+  return Status::OK();
+}
+
 Status XlaCompilationCache::CompileImpl(
     const XlaCompiler::Options& options, const NameAttrList& function,
     const std::map<int, Tensor>& constant_args,
@@ -273,18 +422,7 @@ Status XlaCompilationCache::CompileImpl(
       BuildSignature(function, constant_args, variable_args, ctx, &signature));
 
   VLOG(2) << "Signature: " << SignatureDebugString(signature);
-  // The outer lock protects the existence of the cache entry. It does not
-  // protect the contents of the cache entry.
-  Entry* entry;
-  {
-    mutex_lock lock(mu_);
-    // Find or create a cache entry.
-    std::unique_ptr<Entry>& e = cache_[signature];
-    if (!e) {
-      e.reset(new Entry);
-    }
-    entry = e.get();
-  }
+  Entry* entry = LookupOrCreateEntry(signature);
 
   // Acquire the cache entry lock and compile, if necessary.
   // TODO(phawkins): this locking will need to be restructured when we implement
@@ -302,6 +440,7 @@ Status XlaCompilationCache::CompileImpl(
     XlaCompiler compiler(options);
     entry->compiled = true;
 
+    const uint64 start_us = Env::Default()->NowMicros();
     if (compile_single_op) {
       entry->compilation_status = compiler.CompileSingleOp(
           compile_options ? *compile_options : XlaCompiler::CompileOptions(),
@@ -311,12 +450,16 @@ Status XlaCompilationCache::CompileImpl(
           compile_options ? *compile_options : XlaCompiler::CompileOptions(),
           function, args, &entry->compilation_result);
     }
+    RecordCompilation(signature.name, Env::Default()->NowMicros() - start_us);
   }
   *compilation_result = &entry->compilation_result;
   if (entry->compilation_status.ok() && executable) {
     if (entry->executable == nullptr) {
+      const uint64 start_us = Env::Default()->NowMicros();
       entry->compilation_status = BuildExecutable(
           options, entry->compilation_result, &entry->executable);
+      xla_compilation_time_usecs->GetCell(signature.name)
+          ->IncrementBy(Env::Default()->NowMicros() - start_us);
     }
     *executable = entry->executable.get();
   }
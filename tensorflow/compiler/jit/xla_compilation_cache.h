@@ -81,6 +81,30 @@ class XlaCompilationCache : public ResourceBase {
       xla::LocalExecutable** executable,
       const XlaCompiler::CompileOptions* compile_options);
 
+  // As Compile(), but a signature not compiled yet is compiled on a background
+  // thread rather than on the caller's one. Until that compilation is done,
+  // returns OK with `*compilation_result` and `*executable` set to null, and
+  // the caller is expected to run `function` some other way. The executable
+  // is built without `options.device_allocator`, which may not outlive the
+  // call.
+  Status CompileAsync(const XlaCompiler::Options& options,
+                      const NameAttrList& function,
+                      const std::map<int, Tensor>& constant_args,
+                      const std::map<int, OptionalTensor>& variable_args,
+                      OpKernelContext* ctx,
+                      const XlaCompiler::CompilationResult** compilation_result,
+                      xla::LocalExecutable** executable,
+                      const XlaCompiler::CompileOptions* compile_options);
+
+  // Returns whether `function` was compiled for `max_signatures` signatures
+  // already, none of which matches the given arguments. Compile() would then
+  // compile it once more, which callers able to run the function otherwise
+  // may want to avoid when shapes keep changing.
+  bool ReachedSignatureLimit(const NameAttrList& function,
+                             const std::map<int, Tensor>& constant_args,
+                             const std::map<int, OptionalTensor>& variable_args,
+                             OpKernelContext* ctx, int64 max_signatures);
+
   xla::LocalClient* client() const { return client_; }
   const DeviceType& device_type() const { return device_type_; }
 
@@ -139,6 +163,9 @@ class XlaCompilationCache : public ResourceBase {
     // Have we tried compiling this entry?
     bool compiled = false;
 
+    // Is this entry being compiled by CompileAsync()?
+    bool compiling = false;
+
     // Did compilation succeed?
     Status compilation_status GUARDED_BY(mu);
 
@@ -150,10 +177,16 @@ class XlaCompilationCache : public ResourceBase {
     std::unique_ptr<xla::LocalExecutable> executable GUARDED_BY(mu);
   };
 
+  // Returns the cache entry of `signature`, creating it if needed.
+  Entry* LookupOrCreateEntry(const Signature& signature);
+
   mutex mu_;
   std::unordered_map<Signature, std::unique_ptr<Entry>, Signature::Hash> cache_
       GUARDED_BY(mu_);
 
+  // The number of entries of `cache_` for each function name.
+  std::unordered_map<string, int64> num_signatures_ GUARDED_BY(mu_);
+
   TF_DISALLOW_COPY_AND_ASSIGN(XlaCompilationCache);
 };
 
@@ -247,7 +247,13 @@ void XlaComputationLaunchContext::PopulateOutputs(
     }
   }
 
-  // Apply variable updates, if any.
+  // Apply variable updates, if any. The buffers XLA wrote the new values to
+  // become the variables' tensors, without copies; the old values are freed
+  // once no other tensor refers to them.
+  // TODO(b/35625933): Update variables in place, which would save holding the
+  // old and new values of each variable during the launch. This needs XLA's
+  // buffer assignment to alias entry parameters with outputs, which it
+  // doesn't support: results are always freshly allocated.
   VLOG(2) << "Applying variable updates";
   for (int i = 0; i < kernel->resource_updates.size(); ++i) {
     Allocator* allocator = ctx->device()->GetAllocator({});
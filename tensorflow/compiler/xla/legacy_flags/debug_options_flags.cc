@@ -234,6 +234,11 @@ void AllocateFlags() {
           int32_setter_for(&DebugOptions::set_xla_gpu_max_kernel_unroll_factor),
           flag_values->xla_gpu_max_kernel_unroll_factor(),
           "Specify the maximum kernel unroll factor for the GPU backend."),
+      tensorflow::Flag(
+          "xla_gpu_compilation_cache_dir",
+          flag_values->mutable_xla_gpu_compilation_cache_dir(),
+          "If non-empty, the GPU backend caches the PTX and cubin it compiles "
+          "in this directory, across processes."),
       tensorflow::Flag(
           "xla_dump_optimized_hlo_proto_to",
           flag_values->mutable_xla_dump_optimized_hlo_proto_to(),
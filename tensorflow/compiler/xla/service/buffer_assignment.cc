@@ -224,6 +224,19 @@ std::vector<int64> ColorInterferenceGraph(
   return assigned_colors;
 }
 
+// Returns the heap algorithm used to assign offsets to the buffers of a
+// sequential ordering.  Lazy-best-fit comes first, so that it wins ties.
+std::unique_ptr<HeapAlgorithm> MakeHeapAlgorithm(int64 alignment) {
+  std::vector<std::unique_ptr<HeapAlgorithm>> algorithms;
+  algorithms.push_back(MakeUnique<DecreasingSizeRunsHeap>(
+      MakeUnique<LazyBestFitHeap>(alignment)));
+  algorithms.push_back(MakeUnique<GlobalDecreasingSizeBestFitHeap>(
+      alignment, GlobalDecreasingSizeBestFitHeap::kSpatial));
+  algorithms.push_back(MakeUnique<GlobalDecreasingSizeBestFitHeap>(
+      alignment, GlobalDecreasingSizeBestFitHeap::kTemporal));
+  return MakeUnique<ChooseBestHeapAlgorithm>(std::move(algorithms));
+}
+
 }  // namespace
 
 size_t BufferAllocation::Slice::Hasher::operator()(Slice s) const {
@@ -1057,9 +1070,10 @@ Status BufferAssigner::AssignBuffersWithSequentialOrdering(
     const FlatMap<const HloComputation*, FlatSet<const LogicalBuffer*>>&
         buffers_to_assign_sequentially,
     bool run_whole_module_heap_simulation, BufferAssignment* assignment) {
-  // Run the sequence of instructions through the heap simulator.  The heuristic
-  // that seems to give the best results is lazy-best-fit, with all runs of
-  // alloc / free calls sorted in decreasing size order.
+  // Run the sequence of instructions through the heap simulator.  No single
+  // heuristic gives the best results on all modules, so we run lazy-best-fit,
+  // with all runs of alloc / free calls sorted in decreasing size order, and
+  // global best-fit over all buffers, and keep the smallest heap.
   const HloOrdering& hlo_ordering = assignment->liveness().hlo_ordering();
   if (run_whole_module_heap_simulation) {
     // Run the heap simulation over the whole module. This reduces memory usage,
@@ -1089,8 +1103,7 @@ Status BufferAssigner::AssignBuffersWithSequentialOrdering(
       options.buffers_to_assign = &buffer_value_set;
       TF_ASSIGN_OR_RETURN(
           const HeapSimulator::Result result,
-          HeapSimulator::Run(MakeUnique<DecreasingSizeRunsHeap>(
-                                 MakeUnique<LazyBestFitHeap>(alignment)),
+          HeapSimulator::Run(MakeHeapAlgorithm(alignment),
                              assignment->module(), module_sequence,
                              assignment->points_to_analysis(),
                              assignment->buffer_size_, options));
@@ -1119,8 +1132,7 @@ Status BufferAssigner::AssignBuffersWithSequentialOrdering(
         options.buffers_to_assign = &buffer_value_set;
         TF_ASSIGN_OR_RETURN(
             const HeapSimulator::Result result,
-            HeapSimulator::Run(MakeUnique<DecreasingSizeRunsHeap>(
-                                   MakeUnique<LazyBestFitHeap>(alignment)),
+            HeapSimulator::Run(MakeHeapAlgorithm(alignment),
                                *computation, *instruction_sequence,
                                assignment->points_to_analysis(),
                                assignment->buffer_size_, options));
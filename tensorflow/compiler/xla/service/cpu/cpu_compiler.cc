@@ -612,8 +612,17 @@ StatusOr<std::unique_ptr<Executable>> CpuCompiler::RunBackend(
 
   XLA_VLOG_LINES(2, "LLVM IR:\n" + llvm_ir::DumpModuleToString(*llvm_module));
 
-  // JIT compile the LLVM IR module to in-memory machine code.
-  jit->AddModule(std::move(llvm_module));
+  // JIT compile the LLVM IR module to in-memory machine code. Large modules
+  // may be split to be optimized and lowered on several threads, unless the
+  // IR hooks expect to see the whole module.
+  const int64 split_count =
+      options::ParallelCodegenSplitCount(module->config());
+  if (split_count > 1 && !pre_optimization_ir_hook &&
+      !post_optimization_ir_hook) {
+    jit->AddModuleInParallel(std::move(llvm_module), split_count);
+  } else {
+    jit->AddModule(std::move(llvm_module));
+  }
   cpu_executable.reset(new CpuExecutable(
       std::move(jit), std::move(assignment), std::move(module), function_name,
       std::move(hlo_profile_printer_data), std::move(hlo_profile_index_map)));
@@ -24,6 +24,10 @@ const char* const kXlaDisableVectorizedReduce = "xla_disable_vectorized_reduce";
 const char* const kLlvmIrDotTilingFactor = "xla_llvm_dot_tiling_factor";
 const char* const kXlaEnableExperimentalLlvmIrGemm =
     "xla_enable_experimental_llvm_ir_gemm";
+const char* const kXlaParallelCodegenSplitCount =
+    "xla_cpu_parallel_codegen_split_count";
+const char* const kXlaParallelTaskCostCalibration =
+    "xla_cpu_parallel_task_cost_calibration";
 
 }  // namespace
 
@@ -62,6 +66,26 @@ bool EnableExperimentalLlvmIrGemm(const HloModuleConfig& config) {
   return extra_options_map.count(kXlaEnableExperimentalLlvmIrGemm) > 0;
 }
 
+int64 ParallelCodegenSplitCount(const HloModuleConfig& config) {
+  const auto& extra_options_map =
+      config.debug_options().xla_backend_extra_options();
+  auto it = extra_options_map.find(kXlaParallelCodegenSplitCount);
+  int64 split_count;
+  if (it != extra_options_map.end() &&
+      tensorflow::strings::safe_strto64(it->second, &split_count) &&
+      split_count > 1) {
+    return split_count;
+  }
+  return 1;
+}
+
+string ParallelTaskCostCalibration(const HloModuleConfig& config) {
+  const auto& extra_options_map =
+      config.debug_options().xla_backend_extra_options();
+  auto it = extra_options_map.find(kXlaParallelTaskCostCalibration);
+  return it != extra_options_map.end() ? it->second : "";
+}
+
 }  // namespace options
 }  // namespace cpu
 }  // namespace xla
@@ -29,6 +29,12 @@ bool VectorizedReduceDisabled(const HloModuleConfig& config);
 bool EnableExperimentalLlvmIrGemm(const HloModuleConfig& config);
 tensorflow::gtl::optional<int64> LlvmIrGemvTilingFactor(
     const HloModuleConfig& config);
+// The number of LLVM modules the module is split into, to optimize and
+// generate code for them in parallel, or 1 if it is not split.
+int64 ParallelCodegenSplitCount(const HloModuleConfig& config);
+// The measured cost of HLO opcodes the parallel task assignment uses, as
+// 'opcode:nanoseconds_per_element' pairs separated by ';', or "" if none.
+string ParallelTaskCostCalibration(const HloModuleConfig& config);
 
 }  // namespace options
 }  // namespace cpu
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/service/cpu/dot_op_emitter.h"
 
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -671,24 +672,31 @@ class MatrixMatrixBlockPanelEmitter {
   // The innermost reduction loop executes the matrix multiply in tiles of size
   // [`tile_size_m`, `tile_size_k`] from the LHS and [`tile_size_k`,
   // <vectorization width>] in the RHS.
+  //
+  // The reduction loops run over blocks of [`block_size_k`, `block_size_n`]
+  // of the RHS, one after the other, so that the block being multiplied stays
+  // in cache while it is reused for all the rows of the LHS.
   class Config {
    public:
     explicit Config(PrimitiveType scalar_type, Dimensions dims,
                     int64 max_vectorization_width,
                     int64 min_vectorization_width, int64 tile_size_m,
-                    int64 tile_size_k)
+                    int64 tile_size_k, int64 block_size_k, int64 block_size_n)
         : scalar_type_(scalar_type),
           dims_(dims),
           max_vectorization_width_(max_vectorization_width),
           min_vectorization_width_(min_vectorization_width),
           tile_size_m_(tile_size_m),
-          tile_size_k_(tile_size_k) {}
+          tile_size_k_(tile_size_k),
+          block_size_k_(block_size_k),
+          block_size_n_(block_size_n) {}
 
     string GetCacheKey() const {
       return tensorflow::strings::StrCat(
           "gebp_", PrimitiveType_Name(scalar_type()), "_", dims().ToString(),
           "_", max_vectorization_width(), "_", min_vectorization_width(), "_",
-          tile_size_m(), "_", tile_size_k());
+          tile_size_m(), "_", tile_size_k(), "_", block_size_k(), "_",
+          block_size_n());
     }
 
     PrimitiveType scalar_type() const { return scalar_type_; }
@@ -699,6 +707,9 @@ class MatrixMatrixBlockPanelEmitter {
     int64 tile_size_m() const { return tile_size_m_; }
     int64 tile_size_k() const { return tile_size_k_; }
 
+    int64 block_size_k() const { return block_size_k_; }
+    int64 block_size_n() const { return block_size_n_; }
+
    private:
     PrimitiveType scalar_type_;
     Dimensions dims_;
@@ -706,6 +717,8 @@ class MatrixMatrixBlockPanelEmitter {
     int64 min_vectorization_width_;
     int64 tile_size_m_;
     int64 tile_size_k_;
+    int64 block_size_k_;
+    int64 block_size_n_;
   };
 
   // Creates an instance of MatrixMatrixBlockPanelEmitter that matrix-multiplies
@@ -724,20 +737,32 @@ class MatrixMatrixBlockPanelEmitter {
     CHECK(min_vectorization_width() > 0 &&
           IsPowerOfTwo(static_cast<uint64>(min_vectorization_width())));
     CHECK_GT(tile_size_k(), 0);
+    CHECK_GT(block_size_k(), 0);
+    CHECK_GT(block_size_n(), 0);
   }
 
   void Emit();
 
  private:
-  // This emits a loop that loops over the `n` dimension in multiples of
+  // This emits a loop over the blocks of `block_size` covering [0, `size`),
+  // calling `emit_block` with the start and the (constant) size of each block.
+  // The last block may be smaller, and is emitted separately.
+  void EmitLoopOverBlocks(
+      tensorflow::StringPiece name, int64 size, int64 block_size,
+      const std::function<void(llvm::Value*, int64)>& emit_block);
+
+  // This emits a loop that loops over the block of `n_size` elements of the
+  // `n` dimension starting at `n_base`, in multiples of
   // `max_vectorization_width` as much as possible and then emits a remainder
   // epilogue.
-  void EmitLoopOverN();
+  void EmitLoopOverN(llvm::Value* k_base, int64 k_size, llvm::Value* n_base,
+                     int64 n_size);
 
-  // This emits a loop that loops over the `k` dimension in multiples of
-  // `tile_size_k` as much as possible and then emits a remainder epilogue.
-  void EmitLoopOverK(VectorSupportLibrary* vsl, llvm::Value* n_start,
-                     llvm::Value* n_end);
+  // This emits a loop that loops over the block of `k_size` elements of the
+  // `k` dimension starting at `k_base`, in multiples of `tile_size_k` as much
+  // as possible and then emits a remainder epilogue.
+  void EmitLoopOverK(VectorSupportLibrary* vsl, llvm::Value* k_base,
+                     int64 k_size, llvm::Value* n_start, llvm::Value* n_end);
 
   // This emits a loop that loops over the `m` dimension in multiples of
   // `tile_size_m` as much as possible and then emits a remainder epilogue.
@@ -768,6 +793,8 @@ class MatrixMatrixBlockPanelEmitter {
   }
   int64 tile_size_m() const { return config().tile_size_m(); }
   int64 tile_size_k() const { return config().tile_size_k(); }
+  int64 block_size_k() const { return config().block_size_k(); }
+  int64 block_size_n() const { return config().block_size_n(); }
   PrimitiveType scalar_type() const { return config().scalar_type(); }
 
   llvm::Value* lhs_;
@@ -779,9 +806,36 @@ class MatrixMatrixBlockPanelEmitter {
   KernelSupportLibrary ksl_;
 };
 
-void MatrixMatrixBlockPanelEmitter::Emit() { EmitLoopOverN(); }
+void MatrixMatrixBlockPanelEmitter::Emit() {
+  EmitLoopOverBlocks(
+      "dot.n.block", dims().n(), block_size_n(),
+      [&](llvm::Value* n_base, int64 n_size) {
+        EmitLoopOverBlocks("dot.k.block", dims().k(), block_size_k(),
+                           [&](llvm::Value* k_base, int64 k_size) {
+                             EmitLoopOverN(k_base, k_size, n_base, n_size);
+                           });
+      });
+}
+
+void MatrixMatrixBlockPanelEmitter::EmitLoopOverBlocks(
+    tensorflow::StringPiece name, int64 size, int64 block_size,
+    const std::function<void(llvm::Value*, int64)>& emit_block) {
+  if (size <= block_size) {
+    emit_block(GetInt64(0), size);
+    return;
+  }
+  const int64 full_blocks_end = size - size % block_size;
+  ksl_.For(name, 0, full_blocks_end, block_size,
+           [&](llvm::Value* base) { emit_block(base, block_size); });
+  if (full_blocks_end != size) {
+    emit_block(GetInt64(full_blocks_end), size - full_blocks_end);
+  }
+}
 
-void MatrixMatrixBlockPanelEmitter::EmitLoopOverN() {
+void MatrixMatrixBlockPanelEmitter::EmitLoopOverN(llvm::Value* k_base,
+                                                  int64 k_size,
+                                                  llvm::Value* n_base,
+                                                  int64 n_size) {
   // We can only iterate the `n` dimension for an extent that is divisible by
   // the vectorization width.  So we emit an outer loop that first processes the
   // largest extent in `n` that is divisible by max_vectorization_width, then
@@ -790,42 +844,52 @@ void MatrixMatrixBlockPanelEmitter::EmitLoopOverN() {
 
   int64 current_vectorization_width = max_vectorization_width();
   int64 n_start = 0;
-  while (n_start != dims().n() &&
+  while (n_start != n_size &&
          current_vectorization_width >= min_vectorization_width()) {
-    int64 n_end = dims().n() - (dims().n() % current_vectorization_width);
+    int64 n_end = n_size - (n_size % current_vectorization_width);
     if (n_start != n_end) {
       VectorSupportLibrary vsl(scalar_type(), current_vectorization_width,
                                ir_builder_, "gebp");
-      EmitLoopOverK(&vsl, GetInt64(n_start), GetInt64(n_end));
+      EmitLoopOverK(&vsl, k_base, k_size,
+                    ir_builder_->CreateAdd(n_base, GetInt64(n_start)),
+                    ir_builder_->CreateAdd(n_base, GetInt64(n_end)));
       n_start = n_end;
     }
     current_vectorization_width /= 2;
   }
 
-  if (n_start != dims().n()) {
+  if (n_start != n_size) {
     VectorSupportLibrary vsl(scalar_type(), 1, ir_builder_, "gebp");
-    ksl_.For("epi.n", n_start, dims().n(), 1, [&](llvm::Value* n_i) {
-      llvm::Value* n_i_next =
-          ir_builder_->CreateAdd(n_i, ir_builder_->getInt64(1));
-      EmitLoopOverK(&vsl, n_i, n_i_next);
-    });
+    ksl_.For("epi.n", ir_builder_->CreateAdd(n_base, GetInt64(n_start)),
+             ir_builder_->CreateAdd(n_base, GetInt64(n_size)), 1,
+             [&](llvm::Value* n_i) {
+               llvm::Value* n_i_next =
+                   ir_builder_->CreateAdd(n_i, ir_builder_->getInt64(1));
+               EmitLoopOverK(&vsl, k_base, k_size, n_i, n_i_next);
+             });
   }
 }
 
 void MatrixMatrixBlockPanelEmitter::EmitLoopOverK(VectorSupportLibrary* vsl,
+                                                  llvm::Value* k_base,
+                                                  int64 k_size,
                                                   llvm::Value* n_start,
                                                   llvm::Value* n_end) {
   int64 k_start = 0;
-  int64 k_end = dims().k() - (dims().k() % tile_size_k());
+  int64 k_end = k_size - (k_size % tile_size_k());
   if (k_end != k_start) {
-    EmitLoopOverM(vsl, tile_size_k(), GetInt64(k_start), GetInt64(k_end),
-                  n_start, n_end);
+    EmitLoopOverM(vsl, tile_size_k(),
+                  ir_builder_->CreateAdd(k_base, GetInt64(k_start)),
+                  ir_builder_->CreateAdd(k_base, GetInt64(k_end)), n_start,
+                  n_end);
     k_start = k_end;
   }
 
-  if (k_start != dims().k()) {
-    EmitLoopOverM(vsl, dims().k() - k_start, GetInt64(k_start),
-                  GetInt64(dims().k()), n_start, n_end);
+  if (k_start != k_size) {
+    EmitLoopOverM(vsl, k_size - k_start,
+                  ir_builder_->CreateAdd(k_base, GetInt64(k_start)),
+                  ir_builder_->CreateAdd(k_base, GetInt64(k_size)), n_start,
+                  n_end);
   }
 }
 
@@ -1027,12 +1091,25 @@ bool DotOpEmitter::EmitExperimentalGebpDotIfEnabled(
       target_machine_features_.vector_register_num_elements(
           *ir_builder_->GetInsertBlock()->getParent(), primitive_type);
 
+  // A block of the RHS is reused for all the rows of the LHS, so it is sized
+  // to stay in the L2 cache, in rows of a whole number of vectors.
+  const int64 kBlockSizeK = 256;
+  const int64 kRhsBlockBytes = 128 * 1024;
+  const int64 block_size_n = std::max<int64>(
+      max_vector_width,
+      RoundDownToNearest<int64>(
+          kRhsBlockBytes /
+              (kBlockSizeK *
+               ShapeUtil::ByteSizeOfPrimitiveType(primitive_type)),
+          max_vector_width));
+
   MatrixMatrixBlockPanelEmitter::Config config(
       /*scalar_type=*/primitive_type,
       MatrixMatrixBlockPanelEmitter::Dimensions{/*m=*/m, /*k=*/k, /*n=*/n},
       /*max_vectorization_width=*/max_vector_width,
       /*min_vectorization_width=*/std::min<int64>(4, max_vector_width),
-      /*tile_size_m=*/3, /*tile_size_k=*/5);
+      /*tile_size_m=*/3, /*tile_size_k=*/5, /*block_size_k=*/kBlockSizeK,
+      /*block_size_n=*/block_size_n);
 
   VLOG(2) << "Emitting GEBP kernel in LLVM IR with config "
           << config.GetCacheKey();
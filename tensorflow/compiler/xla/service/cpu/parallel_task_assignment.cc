@@ -15,12 +15,17 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/service/cpu/parallel_task_assignment.h"
 
+#include <map>
+
+#include "tensorflow/compiler/xla/service/cpu/cpu_options.h"
 #include "tensorflow/compiler/xla/service/cpu/dot_op_emitter.h"
 #include "tensorflow/compiler/xla/service/cpu/ir_emission_utils.h"
 #include "tensorflow/compiler/xla/service/cpu/shape_partition.h"
 #include "tensorflow/compiler/xla/service/hlo_computation.h"
 #include "tensorflow/compiler/xla/service/hlo_instruction.h"
 #include "tensorflow/compiler/xla/service/hlo_opcode.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/lib/strings/str_util.h"
 
 namespace xla {
 namespace cpu {
@@ -102,6 +107,87 @@ class DefaultCostModel : public ParallelCostModel {
   const std::unique_ptr<HloCostAnalysis> cost_analysis_;
 };
 
+// Cost model based on the time per element of HLO opcodes, measured on the
+// target machine (e.g. from HLO profiles), rather than inferred from flop and
+// byte counts. The cost of a loop fusion is the sum of the costs of its fused
+// instructions. Instructions with opcodes not measured are left to
+// 'fallback'.
+class CalibratedCostModel : public ParallelCostModel {
+ public:
+  CalibratedCostModel(const int64 max_parallelism,
+                      std::map<HloOpcode, double> nanos_per_element,
+                      std::unique_ptr<ParallelCostModel> fallback)
+      : max_parallelism_(max_parallelism),
+        nanos_per_element_(std::move(nanos_per_element)),
+        fallback_(std::move(fallback)) {}
+  ~CalibratedCostModel() override {}
+
+  // Parses 'calibration', a list of 'opcode:nanoseconds_per_element' pairs
+  // separated by ';'.
+  static StatusOr<std::map<HloOpcode, double>> ParseCalibration(
+      const string& calibration) {
+    std::map<HloOpcode, double> nanos_per_element;
+    for (const string& entry :
+         tensorflow::str_util::Split(calibration, ';',
+                                     tensorflow::str_util::SkipEmpty())) {
+      std::vector<string> fields = tensorflow::str_util::Split(entry, ':');
+      double nanos;
+      if (fields.size() != 2 ||
+          !tensorflow::strings::safe_strtod(fields[1].c_str(), &nanos) ||
+          nanos < 0) {
+        return InvalidArgument("Invalid parallel task cost calibration: %s",
+                               entry.c_str());
+      }
+      TF_ASSIGN_OR_RETURN(HloOpcode opcode, StringToHloOpcode(fields[0]));
+      nanos_per_element[opcode] = nanos;
+    }
+    return std::move(nanos_per_element);
+  }
+
+  int64 GetParallelTaskCount(HloInstruction* instruction) override {
+    const double nanos_per_element = NanosPerElement(*instruction);
+    if (nanos_per_element < 0) {
+      return fallback_->GetParallelTaskCount(instruction);
+    }
+    const double instruction_nanos =
+        nanos_per_element * ShapeUtil::ElementsIn(instruction->shape());
+    // Tasks shorter than this don't make up for the cost of dispatching them.
+    const double min_nanos_per_task = 50000;  // 50us.
+    // Return target parallel task count in [1, max_parallelism_].
+    return std::min(
+        max_parallelism_,
+        std::max(int64{1},
+                 static_cast<int64>(instruction_nanos / min_nanos_per_task)));
+  }
+
+ private:
+  // Returns the measured time per output element of 'instruction', or -1 if
+  // it is unknown.
+  double NanosPerElement(const HloInstruction& instruction) const {
+    if (instruction.opcode() == HloOpcode::kFusion) {
+      double nanos = 0;
+      for (const HloInstruction* fused : instruction.fused_instructions()) {
+        if (fused->opcode() == HloOpcode::kParameter ||
+            fused->opcode() == HloOpcode::kConstant) {
+          continue;
+        }
+        const double fused_nanos = NanosPerElement(*fused);
+        if (fused_nanos < 0) {
+          return -1;
+        }
+        nanos += fused_nanos;
+      }
+      return nanos;
+    }
+    auto it = nanos_per_element_.find(instruction.opcode());
+    return it != nanos_per_element_.end() ? it->second : -1;
+  }
+
+  const int64 max_parallelism_;
+  const std::map<HloOpcode, double> nanos_per_element_;
+  const std::unique_ptr<ParallelCostModel> fallback_;
+};
+
 ParallelTaskAssignment::ParallelTaskAssignment(
     const int64 max_parallelism,
     const HloCostAnalysis::ShapeSizeFunction& shape_size, HloModule* module,
@@ -122,6 +208,21 @@ ParallelTaskAssignment::ParallelTaskAssignment(
     // HLOs like CustomCall are not yet implemented in the HloCostAnalysis).
     cost_model_.reset(new SimpleCostModel(max_parallelism, shape_size));
   }
+
+  const string calibration =
+      options::ParallelTaskCostCalibration(module->config());
+  if (!calibration.empty()) {
+    auto nanos_per_element =
+        CalibratedCostModel::ParseCalibration(calibration);
+    if (nanos_per_element.ok()) {
+      cost_model_.reset(new CalibratedCostModel(
+          max_parallelism, nanos_per_element.ConsumeValueOrDie(),
+          std::move(cost_model_)));
+    } else {
+      LOG(WARNING) << "Ignoring the parallel task cost calibration: "
+                   << nanos_per_element.status();
+    }
+  }
 }
 
 int64 ParallelTaskAssignment::GetTargetParallelTaskCount(
@@ -18,6 +18,7 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/cpu/target_machine_features_fake.h"
 #include "tensorflow/compiler/xla/test.h"
 #include "tensorflow/compiler/xla/tests/hlo_verified_test_base.h"
+#include "tensorflow/compiler/xla/tools/parser/hlo_parser.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 
@@ -120,5 +121,52 @@ TEST_F(ParallelTaskAssignmentTest, InfeedOutfeedOperationNotParallelized) {
   EXPECT_FALSE(changed);
 }
 
+TEST_F(ParallelTaskAssignmentTest, CalibratedCostModelParallelizesCostlyOps) {
+  // An elementwise op on 400KB, which the default cost model considers too
+  // small to parallelize.
+  const string hlo_string = R"(
+    HloModule TestTaskParallel_Calibrated
+    ENTRY Calibrated {
+      p0 = f32[1000,100]{1,0} parameter(0)
+      ROOT exp = f32[1000,100]{1,0} exponential(p0)
+    }
+  )";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, tools::Parse(hlo_string));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          RunParallelTaskAssigner(module.get()));
+  EXPECT_FALSE(changed);
+
+  // Measured at 10ns per element, it is worth running in parallel.
+  HloModuleConfig config;
+  DebugOptions debug_options;
+  (*debug_options.mutable_xla_backend_extra_options())
+      ["xla_cpu_parallel_task_cost_calibration"] = "add:1;exponential:10";
+  config.set_debug_options(debug_options);
+  TF_ASSERT_OK_AND_ASSIGN(module, tools::Parse(hlo_string, config));
+  TF_ASSERT_OK_AND_ASSIGN(changed, RunParallelTaskAssigner(module.get()));
+  EXPECT_TRUE(changed);
+}
+
+TEST_F(ParallelTaskAssignmentTest, CalibratedCostModelKeepsCheapOpsSerial) {
+  const string hlo_string = R"(
+    HloModule TestTaskParallel_CalibratedCheap
+    ENTRY CalibratedCheap {
+      p0 = f32[1000,100]{1,0} parameter(0)
+      ROOT exp = f32[1000,100]{1,0} exponential(p0)
+    }
+  )";
+
+  // 100000 elements at 0.1ns per element are 10us of work.
+  HloModuleConfig config;
+  DebugOptions debug_options;
+  (*debug_options.mutable_xla_backend_extra_options())
+      ["xla_cpu_parallel_task_cost_calibration"] = "exponential:0.1";
+  config.set_debug_options(debug_options);
+  TF_ASSERT_OK_AND_ASSIGN(auto module, tools::Parse(hlo_string, config));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunParallelTaskAssigner(module.get()));
+  EXPECT_FALSE(changed);
+}
+
 }  // namespace
 }  // namespace xla
@@ -17,6 +17,9 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
+#include <atomic>
+
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/compiler/xla/executable_run_options.h"
 #include "tensorflow/core/lib/core/blocking_counter.h"
@@ -30,8 +33,11 @@ using tensorflow::uint64;
 using ComputeFunctionType = void (*)(void*, const void*, const void**, void**,
                                      int64*, uint64*);
 
-// Dispatches 'num_partitions - 1' calls to 'function_ptr' in parallel.
-// Calls 'function_ptr' for first partition inline.
+// Calls 'function_ptr' for each partition, in parallel on the calling thread
+// and on up to one helper per thread of the intra-op thread pool. Threads
+// claim the next partition when done with one, rather than being assigned a
+// fixed one, which balances partitions of uneven cost and makes partitioning
+// more finely than the number of threads worthwhile.
 // Uses blocking counter to synchonize threads after parallel calls complete.
 //
 // The 'partitions' array has a total number of elements equal to
@@ -74,24 +80,31 @@ void __xla_cpu_runtime_ParallelForkJoin(
   // Compute partition stride in 'partitions' array.
   const int64 stride = 2 * num_partitioned_dims;
 
-  // Dispatch 'num_partitions - 1' compute functions to run in parallel.
-  tensorflow::BlockingCounter bc(num_partitions - 1);
-  for (int32 i = 1; i < num_partitions; ++i) {
-    const int64 offset = i * stride;
+  // Runs the partitions not claimed yet, one at a time.
+  std::atomic<int32> next_partition(0);
+  auto run_partitions = [&]() {
+    for (int32 i = next_partition++; i < num_partitions;
+         i = next_partition++) {
+      function(result_ptr, run_options_ptr, params, temps,
+               &partitions[i * stride], prof_counters);
+      VLOG(3) << "ParallelForkJoin partition " << i << " done.";
+    }
+  };
+
+  // Dispatch helpers to run partitions in parallel.
+  const int32 num_helpers = std::min<int32>(
+      num_partitions - 1, run_options->intra_op_thread_pool()->numThreads());
+  tensorflow::BlockingCounter bc(num_helpers);
+  for (int32 i = 0; i < num_helpers; ++i) {
     run_options->intra_op_thread_pool()->enqueueNoNotification(
-        [i, function, result_ptr, run_options_ptr, params, temps, prof_counters,
-         partitions, offset, &bc]() {
-          function(result_ptr, run_options_ptr, params, temps,
-                   &partitions[offset], prof_counters);
+        [&run_partitions, &bc]() {
+          run_partitions();
           bc.DecrementCount();
-          VLOG(3) << "ParallelForkJoin partition " << i << " done.";
         });
   }
 
-  // Call first compute function inline.
-  function(result_ptr, run_options_ptr, params, temps, &partitions[0],
-           prof_counters);
-  VLOG(3) << "ParallelForkJoin partition 0 done.";
+  // Run partitions inline as well.
+  run_partitions();
   bc.Wait();
   VLOG(2) << "ParallelForkJoin EXIT";
 }
@@ -20,12 +20,18 @@ limitations under the License.
 #include <list>
 #include <utility>
 
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
 #include "llvm/ExecutionEngine/JITSymbol.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
+#include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Mangler.h"
 #include "llvm/Support/CodeGen.h"
 #include "llvm/Support/Host.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include "tensorflow/compiler/xla/ptr_util.h"
 #include "tensorflow/compiler/xla/service/cpu/cpu_runtime.h"
 #include "tensorflow/compiler/xla/service/cpu/custom_call_target_registry.h"
@@ -42,6 +48,8 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/cpu/runtime_single_threaded_matmul.h"
 #include "tensorflow/compiler/xla/service/cpu/windows_compatibility.h"
 #include "tensorflow/compiler/xla/types.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 
 namespace xla {
@@ -96,7 +104,12 @@ SimpleOrcJIT::SimpleOrcJIT(const llvm::TargetOptions& target_options,
                            bool disable_expensive_passes,
                            LLVMCompiler::ModuleHook pre_optimization_hook,
                            LLVMCompiler::ModuleHook post_optimization_hook)
-    : target_machine_(InferTargetMachineForJIT(target_options, opt_level)),
+    : target_options_(target_options),
+      opt_level_(opt_level),
+      optimize_for_size_(optimize_for_size),
+      enable_fast_math_(enable_fast_math),
+      disable_expensive_passes_(disable_expensive_passes),
+      target_machine_(InferTargetMachineForJIT(target_options, opt_level)),
       disassembler_(*target_machine_),
       data_layout_(target_machine_->createDataLayout()),
       symbol_resolver_(llvm::orc::createLegacyLookupResolver(
@@ -127,6 +140,9 @@ SimpleOrcJIT::SimpleOrcJIT(const llvm::TargetOptions& target_options,
 }
 
 llvm::JITSymbol SimpleOrcJIT::ResolveRuntimeSymbol(const std::string& name) {
+  if (auto symbol = FindSymbolInParts(name)) {
+    return symbol;
+  }
   if (const uint8* from_constant_pool =
           external_constant_pool_.Find(string(name))) {
     return llvm::JITEvaluatedSymbol(
@@ -151,6 +167,66 @@ SimpleOrcJIT::VModuleKeyT SimpleOrcJIT::AddModule(
   return key;
 }
 
+void SimpleOrcJIT::AddModuleInParallel(std::unique_ptr<llvm::Module> module,
+                                       int num_parts) {
+  // The parts share the context of `module`, which can't be used by several
+  // threads, so they are moved to contexts of their own through bitcode, as
+  // llvm::splitCodeGen does.
+  std::vector<llvm::SmallString<0>> bitcodes;
+  llvm::SplitModule(
+      std::move(module), num_parts,
+      [&bitcodes](std::unique_ptr<llvm::Module> part) {
+        bitcodes.emplace_back();
+        llvm::raw_svector_ostream stream(bitcodes.back());
+        llvm::WriteBitcodeToFile(*part, stream);
+      },
+      /*PreserveLocals=*/false);
+  VLOG(1) << "Compiling the module in " << bitcodes.size() << " parts";
+
+  // Creating target machines queries the host, which is done on this thread.
+  std::vector<std::unique_ptr<llvm::TargetMachine>> target_machines;
+  for (size_t i = 0; i < bitcodes.size(); ++i) {
+    target_machines.push_back(
+        InferTargetMachineForJIT(target_options_, opt_level_));
+  }
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> objects(bitcodes.size());
+  {
+    tensorflow::thread::ThreadPool pool(tensorflow::Env::Default(),
+                                        "xla_cpu_codegen", bitcodes.size());
+    for (size_t i = 0; i < bitcodes.size(); ++i) {
+      pool.Schedule([this, i, &bitcodes, &target_machines, &objects]() {
+        llvm::LLVMContext context;
+        std::unique_ptr<llvm::Module> part =
+            llvm::cantFail(llvm::parseBitcodeFile(
+                llvm::MemoryBufferRef(bitcodes[i].str(), "part"), context));
+        const Disassembler disassembler(*target_machines[i]);
+        CompilerFunctor compiler(target_machines[i].get(), &disassembler,
+                                 opt_level_, optimize_for_size_,
+                                 enable_fast_math_, disable_expensive_passes_);
+        objects[i] = compiler(*part);
+      });
+    }
+    // The destructor of the pool waits for all the parts.
+  }
+
+  for (auto& object : objects) {
+    auto key = execution_session_.allocateVModule();
+    cantFail(object_layer_.addObject(key, std::move(object)));
+    module_keys_.push_back(key);
+    part_keys_.push_back(key);
+  }
+}
+
+llvm::JITSymbol SimpleOrcJIT::FindSymbolInParts(const std::string& name) {
+  for (auto& key : part_keys_) {
+    if (auto symbol = object_layer_.findSymbolIn(
+            key, name, /*ExportedSymbolsOnly=*/false)) {
+      return symbol;
+    }
+  }
+  return nullptr;
+}
+
 void SimpleOrcJIT::RemoveModule(SimpleOrcJIT::VModuleKeyT key) {
   module_keys_.erase(std::remove(module_keys_.begin(), module_keys_.end(), key),
                      module_keys_.end());
@@ -82,6 +82,13 @@ class SimpleOrcJIT {
   // remove this module.
   VModuleKeyT AddModule(std::unique_ptr<llvm::Module> module);
 
+  // Splits a module into |num_parts| modules, which are optimized and lowered
+  // to object files in parallel, each with its own LLVM context and target
+  // machine, then linked together. The parts can't be removed. The module
+  // must not need the optimization hooks, which would see each part instead.
+  void AddModuleInParallel(std::unique_ptr<llvm::Module> module,
+                           int num_parts);
+
   // Remove a module from the JIT and free the memory associated with it.
   void RemoveModule(VModuleKeyT key);
 
@@ -104,7 +111,20 @@ class SimpleOrcJIT {
  private:
   llvm::JITSymbol ResolveRuntimeSymbol(const std::string& name);
 
+  // Finds a symbol defined by a part added by AddModuleInParallel(), including
+  // the non-exported ones, as parts call the internal functions of others.
+  llvm::JITSymbol FindSymbolInParts(const std::string& name);
+
+  // The options the JIT was created with, to create a CompilerFunctor for
+  // each part in AddModuleInParallel().
+  const llvm::TargetOptions target_options_;
+  const llvm::CodeGenOpt::Level opt_level_;
+  const bool optimize_for_size_;
+  const bool enable_fast_math_;
+  const bool disable_expensive_passes_;
+
   std::vector<VModuleKeyT> module_keys_;
+  std::vector<VModuleKeyT> part_keys_;
   std::unique_ptr<llvm::TargetMachine> target_machine_;
   const Disassembler disassembler_;
   const llvm::DataLayout data_layout_;
@@ -18,6 +18,7 @@ limitations under the License.
 #include <stdlib.h>
 #include <atomic>
 #include <functional>
+#include <map>
 #include <mutex>  // NOLINT(build/c++11): only using std::call_once, not mutex.
 #include <utility>
 
@@ -86,6 +87,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/cuda_libdevice_path.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/regexp.h"
 #include "tensorflow/core/platform/stream_executor_no_cuda.h"
@@ -474,6 +476,78 @@ StatusOr<std::vector<uint8>> CompilePtx(const string& ptx, int cc_major,
   return cubin_vector;
 }
 
+// Returns the path prefix of the entry of the persistent compilation cache in
+// `cache_dir` for the given unoptimized LLVM module, i.e. a fingerprint of the
+// module and of everything else the PTX and cubin compiled from it depend on.
+string CompilationCachePath(const string& cache_dir,
+                            const llvm::Module& llvm_module, int cc_major,
+                            int cc_minor, const HloModuleConfig& config,
+                            const string& libdevice_dir) {
+  const DebugOptions& debug_options = config.debug_options();
+  string key = tensorflow::strings::StrCat(
+      llvm_ir::DumpModuleToString(llvm_module), "\nsm_", cc_major, cc_minor,
+      "\n", libdevice_dir, "\n",
+      debug_options.xla_backend_optimization_level(), "\n",
+      debug_options.xla_gpu_ftz());
+  // The backend extra options are passed to LLVM. Sort them, as the order of
+  // map fields is unspecified.
+  std::map<string, string> extra_options(
+      debug_options.xla_backend_extra_options().begin(),
+      debug_options.xla_backend_extra_options().end());
+  for (const auto& option : extra_options) {
+    tensorflow::strings::StrAppend(&key, "\n", option.first, "=",
+                                   option.second);
+  }
+  const tensorflow::Fprint128 fingerprint = tensorflow::Fingerprint128(key);
+  return tensorflow::io::JoinPath(
+      cache_dir,
+      tensorflow::strings::StrCat(
+          tensorflow::strings::Hex(fingerprint.high64,
+                                   tensorflow::strings::kZeroPad16),
+          tensorflow::strings::Hex(fingerprint.low64,
+                                   tensorflow::strings::kZeroPad16)));
+}
+
+// Reads the PTX and cubin of the cache entry at `path`. Returns false if the
+// entry doesn't exist.
+bool ReadCompilationCacheEntry(const string& path, string* ptx,
+                               std::vector<uint8>* cubin) {
+  auto* env = tensorflow::Env::Default();
+  string cubin_data;
+  if (!tensorflow::ReadFileToString(env, path + ".ptx", ptx).ok() ||
+      !tensorflow::ReadFileToString(env, path + ".cubin", &cubin_data).ok()) {
+    return false;
+  }
+  cubin->assign(cubin_data.begin(), cubin_data.end());
+  return true;
+}
+
+// Writes the cache entry at `path`. Each file is written under a temporary
+// name first, so that processes sharing the cache never read a partial entry.
+// The PTX is written last, as it marks a complete entry.
+Status WriteCompilationCacheEntry(const string& path, const string& ptx,
+                                  const std::vector<uint8>& cubin) {
+  auto* env = tensorflow::Env::Default();
+  TF_RETURN_IF_ERROR(
+      env->RecursivelyCreateDir(tensorflow::io::Dirname(path).ToString()));
+  auto write_file = [env](const string& file_path,
+                          tensorflow::StringPiece data) -> Status {
+    string temp_path;
+    if (!env->LocalTempFilename(&temp_path)) {
+      return InternalError("couldn't get temp file name");
+    }
+    temp_path = tensorflow::strings::StrCat(
+        file_path, ".", tensorflow::io::Basename(temp_path), ".tmp");
+    TF_RETURN_IF_ERROR(tensorflow::WriteStringToFile(env, temp_path, data));
+    return env->RenameFile(temp_path, file_path);
+  };
+  TF_RETURN_IF_ERROR(write_file(
+      path + ".cubin",
+      tensorflow::StringPiece(reinterpret_cast<const char*>(cubin.data()),
+                              cubin.size())));
+  return write_file(path + ".ptx", ptx);
+}
+
 }  // namespace
 
 GpuCompiler::GpuCompiler()
@@ -620,8 +694,28 @@ StatusOr<std::unique_ptr<Executable>> GpuCompiler::RunBackend(
     cc_minor = 0;
   }
 
+  // The persistent compilation cache maps the unoptimized LLVM module to the
+  // PTX and cubin compiled from it. It is bypassed when the optimized module
+  // is needed.
+  const string& compilation_cache_dir =
+      module->config().debug_options().xla_gpu_compilation_cache_dir();
+  string compilation_cache_path;
+  if (!compilation_cache_dir.empty() && ir_dump_directory.empty() &&
+      !user_post_optimization_hook_) {
+    compilation_cache_path =
+        CompilationCachePath(compilation_cache_dir, llvm_module, cc_major,
+                             cc_minor, module->config(), libdevice_dir);
+  }
+
   string ptx;
-  {
+  std::vector<uint8> cubin;
+  const bool cached =
+      !compilation_cache_path.empty() &&
+      ReadCompilationCacheEntry(compilation_cache_path, &ptx, &cubin);
+  if (cached) {
+    VLOG(1) << "Found the PTX and cubin of " << module->name() << " in "
+            << compilation_cache_path;
+  } else {
     XLA_SCOPED_LOGGING_TIMER("GpuCompiler::RunBackend - CompileToPtx");
     TF_ASSIGN_OR_RETURN(ptx, CompileToPtx(&llvm_module, {cc_major, cc_minor},
                                           module->config(), libdevice_dir));
@@ -658,8 +752,19 @@ StatusOr<std::unique_ptr<Executable>> GpuCompiler::RunBackend(
     }
   }
 
-  const std::vector<uint8> cubin =
-      CompilePtxOrGetCachedResult(ptx, cc_major, cc_minor);
+  if (!cached) {
+    cubin = CompilePtxOrGetCachedResult(ptx, cc_major, cc_minor);
+    // An empty cubin means ptxas failed, and the driver compiles the PTX;
+    // don't keep it, so that later processes try ptxas again.
+    if (!compilation_cache_path.empty() && !cubin.empty()) {
+      Status status =
+          WriteCompilationCacheEntry(compilation_cache_path, ptx, cubin);
+      if (!status.ok()) {
+        LOG(WARNING) << "Couldn't write the compilation cache entry "
+                     << compilation_cache_path << ": " << status;
+      }
+    }
+  }
 
   auto thunk_schedule = MakeUnique<ThunkSchedule>(
       ir_emitter.ConsumeThunkSequence(), std::move(stream_assignment),
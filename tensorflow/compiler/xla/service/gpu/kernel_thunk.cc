@@ -25,6 +25,33 @@ limitations under the License.
 
 namespace xla {
 namespace gpu {
+namespace {
+
+// Launches "kernel" on "stream" with the device addresses of "args" packed
+// into "kernel_args".
+template <size_t kNumArgs>
+Status LaunchKernel(const string& kernel_name, const se::KernelBase& kernel,
+                    const LaunchDimensions& launch_dimensions,
+                    const std::vector<const BufferAllocation*>& args,
+                    const BufferAllocations& buffer_allocations,
+                    se::Stream* stream,
+                    se::KernelArgsArray<kNumArgs>* kernel_args) {
+  for (const BufferAllocation* arg : args) {
+    const auto& buf = buffer_allocations.GetDeviceAddress(arg->index());
+    kernel_args->add_device_memory_argument(buf);
+    VLOG(3) << "  Arg: alloc #" << arg->index() << ": " << buf.opaque() << " ("
+            << buf.size() << "B)";
+  }
+  if (!stream->parent()->Launch(
+          stream, se::ThreadDim(launch_dimensions.threads_per_block()),
+          se::BlockDim(launch_dimensions.block_count()), kernel,
+          *kernel_args)) {
+    return InternalError("Unable to launch kernel %s", kernel_name.c_str());
+  }
+  return Status::OK();
+}
+
+}  // namespace
 
 KernelThunk::KernelThunk(
     tensorflow::gtl::ArraySlice<const BufferAllocation*> args,
@@ -91,22 +118,20 @@ Status KernelThunk::ExecuteOnStream(const BufferAllocations& buffer_allocations,
   }
 
   VLOG(3) << "Launching " << kernel->name();
-  // Launch the kernel with potentially multiple blocks and threads.
+  // Launch the kernel with potentially multiple blocks and threads. Most
+  // kernels take few arguments, which are packed on the stack: the array for
+  // the largest number of arguments is too big for that, and allocating it
+  // on every launch adds to the host overhead of small kernels.
+  static constexpr size_t kSmallKernelArgsLimit = 64;
   static constexpr int kKernelArgsLimit = 1024;
-  auto kernel_args = MakeUnique<se::KernelArgsArray<kKernelArgsLimit>>();
-  for (const BufferAllocation* arg : args_) {
-    const auto& buf = buffer_allocations.GetDeviceAddress(arg->index());
-    kernel_args->add_device_memory_argument(buf);
-    VLOG(3) << "  Arg: alloc #" << arg->index() << ": " << buf.opaque() << " ("
-            << buf.size() << "B)";
+  if (args_.size() <= kSmallKernelArgsLimit) {
+    se::KernelArgsArray<kSmallKernelArgsLimit> kernel_args;
+    return LaunchKernel(kernel_name_, *kernel, launch_dimensions, args_,
+                        buffer_allocations, stream, &kernel_args);
   }
-  if (!stream->parent()->Launch(
-          stream, se::ThreadDim(launch_dimensions.threads_per_block()),
-          se::BlockDim(launch_dimensions.block_count()), *kernel,
-          *kernel_args)) {
-    return InternalError("Unable to launch kernel %s", kernel_name_.c_str());
-  }
-  return Status::OK();
+  auto kernel_args = MakeUnique<se::KernelArgsArray<kKernelArgsLimit>>();
+  return LaunchKernel(kernel_name_, *kernel, launch_dimensions, args_,
+                      buffer_allocations, stream, kernel_args.get());
 }
 
 }  // namespace gpu
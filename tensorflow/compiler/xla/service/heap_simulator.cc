@@ -642,4 +642,131 @@ HeapSimulator::Result LazyBestFitHeap::Finish() {
   return result_;
 }
 
+void GlobalDecreasingSizeBestFitHeap::Alloc(const BufferValue* buffer,
+                                            int64 size) {
+  const bool inserted =
+      buffer_intervals_
+          .emplace(buffer, BufferInterval{buffer, size, current_time_, -1})
+          .second;
+  CHECK(inserted) << "Alloc called twice on buffer: " << *buffer;
+  ++current_time_;
+}
+
+void GlobalDecreasingSizeBestFitHeap::Free(const BufferValue* buffer,
+                                           int64 size) {
+  auto it = buffer_intervals_.find(buffer);
+  CHECK(it != buffer_intervals_.end())
+      << "Free called on non-allocated buffer: " << *buffer;
+  BufferInterval* interval = &it->second;
+  CHECK_EQ(interval->size, size) << "Free with mismatched sizes: " << *buffer;
+  CHECK_EQ(interval->end, -1) << "Free called twice on buffer: " << *buffer;
+  interval->end = current_time_;
+  ++current_time_;
+}
+
+HeapSimulator::Result GlobalDecreasingSizeBestFitHeap::Finish() {
+  std::vector<BufferInterval> sorted_intervals;
+  sorted_intervals.reserve(buffer_intervals_.size());
+  for (auto& entry : buffer_intervals_) {
+    BufferInterval& interval = entry.second;
+    // Buffers that are never freed stay live until the end.
+    if (interval.end == -1) {
+      interval.end = current_time_;
+    }
+    sorted_intervals.push_back(interval);
+  }
+  // Break ties by buffer id, to keep the assignment deterministic.
+  const Type type = type_;
+  std::sort(sorted_intervals.begin(), sorted_intervals.end(),
+            [type](const BufferInterval& a, const BufferInterval& b) {
+              const int64 a_length = a.end - a.start;
+              const int64 b_length = b.end - b.start;
+              if (type == kTemporal && a_length != b_length) {
+                return a_length > b_length;
+              }
+              if (a.size != b.size) {
+                return a.size > b.size;
+              }
+              if (a_length != b_length) {
+                return a_length > b_length;
+              }
+              return a.buffer->id() < b.buffer->id();
+            });
+
+  std::vector<std::pair<BufferInterval, Chunk>> placed;
+  placed.reserve(sorted_intervals.size());
+  for (const BufferInterval& interval : sorted_intervals) {
+    // Degenerate case: 0-sized buffers are always allocated at offset 0.
+    if (interval.size == 0) {
+      result_.chunk_map.emplace(interval.buffer, Chunk{0, 0});
+      continue;
+    }
+
+    // Collect the chunks of the placed buffers live at the same time.
+    std::vector<Chunk> conflicts;
+    for (const auto& entry : placed) {
+      const BufferInterval& other = entry.first;
+      if (other.start <= interval.end && interval.start <= other.end) {
+        conflicts.push_back(entry.second);
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end(),
+              [](const Chunk& a, const Chunk& b) {
+                return a.offset < b.offset;
+              });
+
+    // Find the smallest gap between the conflicting chunks that fits the
+    // buffer, accounting for alignment.
+    int64 best_offset = -1;
+    int64 best_gap = -1;
+    int64 free_start = 0;
+    for (const Chunk& conflict : conflicts) {
+      if (conflict.offset > free_start) {
+        const int64 gap = conflict.offset - free_start;
+        const int64 offset = RoundUpToNearest(free_start, alignment_);
+        if (offset + interval.size <= conflict.offset &&
+            (best_gap == -1 || gap < best_gap)) {
+          best_offset = offset;
+          best_gap = gap;
+        }
+      }
+      free_start = std::max(free_start, conflict.chunk_end());
+    }
+    // Otherwise place the buffer after all the conflicting chunks.
+    if (best_offset == -1) {
+      best_offset = RoundUpToNearest(free_start, alignment_);
+    }
+
+    const Chunk chunk{best_offset, interval.size};
+    result_.chunk_map.emplace(interval.buffer, chunk);
+    result_.heap_size = std::max(result_.heap_size, chunk.chunk_end());
+    placed.emplace_back(interval, chunk);
+  }
+  return result_;
+}
+
+void ChooseBestHeapAlgorithm::Alloc(const BufferValue* buffer, int64 size) {
+  for (auto& algorithm : algorithms_) {
+    algorithm->Alloc(buffer, size);
+  }
+}
+
+void ChooseBestHeapAlgorithm::Free(const BufferValue* buffer, int64 size) {
+  for (auto& algorithm : algorithms_) {
+    algorithm->Free(buffer, size);
+  }
+}
+
+HeapSimulator::Result ChooseBestHeapAlgorithm::Finish() {
+  CHECK(!algorithms_.empty());
+  Result best_result = algorithms_[0]->Finish();
+  for (int i = 1; i < algorithms_.size(); ++i) {
+    Result result = algorithms_[i]->Finish();
+    if (result.heap_size < best_result.heap_size) {
+      best_result = std::move(result);
+    }
+  }
+  return best_result;
+}
+
 }  // namespace xla
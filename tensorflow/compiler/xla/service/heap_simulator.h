@@ -292,6 +292,66 @@ class LazyBestFitHeap : public HeapAlgorithm {
   std::set<Chunk, OrderChunkByIncreasingSize> free_;
 };
 
+// GlobalDecreasingSizeBestFitHeap collects the live ranges of all buffers, and
+// only assigns offsets in Finish, in a single best-fit pass over the buffers
+// sorted by decreasing size.  Unlike DecreasingSizeRunsHeap, which only sorts
+// the runs of consecutive Alloc or Free calls, this sees every buffer up-front;
+// with a whole-module simulation that includes the buffers of while bodies and
+// conditionals.  Each buffer is placed in the smallest gap between the chunks
+// of the already placed buffers whose live ranges overlap its own, or at the
+// end of them if no gap fits.
+class GlobalDecreasingSizeBestFitHeap : public HeapAlgorithm {
+ public:
+  // The order buffers are placed in.  kSpatial sorts by decreasing size, then
+  // by decreasing live range; kTemporal sorts by decreasing live range, then
+  // by decreasing size, which tends to pack long-lived buffers together.
+  enum Type { kSpatial, kTemporal };
+
+  GlobalDecreasingSizeBestFitHeap(int64 alignment, Type type = kSpatial)
+      : alignment_(alignment), type_(type) {}
+  ~GlobalDecreasingSizeBestFitHeap() override {}
+
+  void Alloc(const BufferValue* buffer, int64 size) override;
+  void Free(const BufferValue* buffer, int64 size) override;
+  Result Finish() override;
+
+ private:
+  // The live range of a buffer, in the logical time of Alloc and Free calls.
+  struct BufferInterval {
+    const BufferValue* buffer;
+    int64 size;
+    int64 start;
+    int64 end;
+  };
+
+  const int64 alignment_;
+  const Type type_;
+  Result result_;
+
+  // The logical time of the next Alloc or Free call.
+  int64 current_time_ = 0;
+  tensorflow::gtl::FlatMap<const BufferValue*, BufferInterval>
+      buffer_intervals_;
+};
+
+// ChooseBestHeapAlgorithm runs all the given heap algorithms on the same
+// sequence of Alloc and Free calls, and returns the result of the one with the
+// smallest heap size.  Ties go to the earlier algorithm.
+class ChooseBestHeapAlgorithm : public HeapAlgorithm {
+ public:
+  ChooseBestHeapAlgorithm(
+      std::vector<std::unique_ptr<HeapAlgorithm>> algorithms)
+      : algorithms_(std::move(algorithms)) {}
+  ~ChooseBestHeapAlgorithm() override {}
+
+  void Alloc(const BufferValue* buffer, int64 size) override;
+  void Free(const BufferValue* buffer, int64 size) override;
+  Result Finish() override;
+
+ private:
+  const std::vector<std::unique_ptr<HeapAlgorithm>> algorithms_;
+};
+
 }  // namespace xla
 
 #endif  // TENSORFLOW_COMPILER_XLA_SERVICE_HEAP_SIMULATOR_H_
@@ -910,5 +910,128 @@ TEST_F(LazyBestFitHeapTest, Alignment) {
   EXPECT_EQ(128, result.chunk_map.at(buffer_e_).offset);
 }
 
+class GlobalDecreasingSizeBestFitHeapTest : public HeapAlgorithmTestBase {};
+
+TEST_F(GlobalDecreasingSizeBestFitHeapTest, Empty) {
+  GlobalDecreasingSizeBestFitHeap heap(/*alignment=*/1);
+  const HeapSimulator::Result result = heap.Finish();
+  EXPECT_EQ(0, result.heap_size);
+  EXPECT_EQ(0, result.chunk_map.size());
+}
+
+TEST_F(GlobalDecreasingSizeBestFitHeapTest, DecreasingSize) {
+  GlobalDecreasingSizeBestFitHeap heap(/*alignment=*/1);
+  heap.Alloc(buffer_a_, 10);
+  heap.Alloc(buffer_b_, 30);
+  heap.Alloc(buffer_c_, 20);
+  heap.Alloc(buffer_d_, 40);
+  heap.Free(buffer_a_, 10);
+  heap.Free(buffer_b_, 30);
+  heap.Free(buffer_c_, 20);
+  heap.Free(buffer_d_, 40);
+
+  // All buffers are live at the same time, so they are laid out by decreasing
+  // size.
+  const HeapSimulator::Result result = heap.Finish();
+  EXPECT_EQ(100, result.heap_size);
+  EXPECT_EQ(10, result.chunk_map.at(buffer_a_).size);
+  EXPECT_EQ(30, result.chunk_map.at(buffer_b_).size);
+  EXPECT_EQ(20, result.chunk_map.at(buffer_c_).size);
+  EXPECT_EQ(40, result.chunk_map.at(buffer_d_).size);
+
+  EXPECT_EQ(90, result.chunk_map.at(buffer_a_).offset);
+  EXPECT_EQ(40, result.chunk_map.at(buffer_b_).offset);
+  EXPECT_EQ(70, result.chunk_map.at(buffer_c_).offset);
+  EXPECT_EQ(0, result.chunk_map.at(buffer_d_).offset);
+}
+
+TEST_F(GlobalDecreasingSizeBestFitHeapTest, ReuseGaps) {
+  GlobalDecreasingSizeBestFitHeap heap(/*alignment=*/1);
+  heap.Alloc(buffer_a_, 50);  // A time = [0, 2]
+  heap.Alloc(buffer_d_, 8);   // D time = [1, 9]
+  heap.Free(buffer_a_, 50);
+  heap.Alloc(buffer_b_, 20);  // B time = [3, 7]
+  heap.Alloc(buffer_c_, 10);  // C time = [4, 8]
+  heap.Alloc(buffer_e_, 5);   // E time = [5, 6]
+  heap.Free(buffer_e_, 5);
+  heap.Free(buffer_b_, 20);
+  heap.Free(buffer_c_, 10);
+  heap.Free(buffer_d_, 8);
+
+  // A range = [0, 50)
+  // B range = [0, 20), A is dead
+  // C range = [20, 30), after B
+  // D range = [50, 58), after A
+  // E range = [30, 35), in the gap between C and D
+  const HeapSimulator::Result result = heap.Finish();
+  EXPECT_EQ(58, result.heap_size);
+  EXPECT_EQ(0, result.chunk_map.at(buffer_a_).offset);
+  EXPECT_EQ(0, result.chunk_map.at(buffer_b_).offset);
+  EXPECT_EQ(20, result.chunk_map.at(buffer_c_).offset);
+  EXPECT_EQ(50, result.chunk_map.at(buffer_d_).offset);
+  EXPECT_EQ(30, result.chunk_map.at(buffer_e_).offset);
+}
+
+TEST_F(GlobalDecreasingSizeBestFitHeapTest, BestFit) {
+  GlobalDecreasingSizeBestFitHeap heap(/*alignment=*/1);
+  heap.Alloc(buffer_a_, 30);  // A time = [0, 4]
+  heap.Alloc(buffer_b_, 20);  // B time = [1, 8]
+  heap.Alloc(buffer_c_, 10);  // C time = [2, 5]
+  heap.Alloc(buffer_d_, 5);   // D time = [3, 9]
+  heap.Free(buffer_a_, 30);
+  heap.Free(buffer_c_, 10);
+  heap.Alloc(buffer_e_, 4);  // E time = [6, 7]
+  heap.Free(buffer_e_, 4);
+  heap.Free(buffer_b_, 20);
+  heap.Free(buffer_d_, 5);
+
+  // A range = [0, 30)
+  // B range = [30, 50)
+  // C range = [50, 60)
+  // D range = [60, 65)
+  // E fits both in the gap [0, 30) left by A and in the gap [50, 60) left by
+  // C; it gets the smallest one.
+  const HeapSimulator::Result result = heap.Finish();
+  EXPECT_EQ(65, result.heap_size);
+  EXPECT_EQ(0, result.chunk_map.at(buffer_a_).offset);
+  EXPECT_EQ(30, result.chunk_map.at(buffer_b_).offset);
+  EXPECT_EQ(50, result.chunk_map.at(buffer_c_).offset);
+  EXPECT_EQ(60, result.chunk_map.at(buffer_d_).offset);
+  EXPECT_EQ(50, result.chunk_map.at(buffer_e_).offset);
+}
+
+TEST_F(GlobalDecreasingSizeBestFitHeapTest, Alignment) {
+  GlobalDecreasingSizeBestFitHeap heap(/*alignment=*/64);
+  heap.Alloc(buffer_a_, 10);
+  heap.Alloc(buffer_b_, 5);
+  heap.Free(buffer_a_, 10);
+  heap.Free(buffer_b_, 5);
+
+  const HeapSimulator::Result result = heap.Finish();
+  EXPECT_EQ(69, result.heap_size);
+  EXPECT_EQ(0, result.chunk_map.at(buffer_a_).offset);
+  EXPECT_EQ(64, result.chunk_map.at(buffer_b_).offset);
+}
+
+class ChooseBestHeapAlgorithmTest : public HeapAlgorithmTestBase {};
+
+TEST_F(ChooseBestHeapAlgorithmTest, ChoosesSmallestHeap) {
+  std::vector<std::unique_ptr<HeapAlgorithm>> algorithms;
+  algorithms.push_back(
+      MakeUnique<GlobalDecreasingSizeBestFitHeap>(/*alignment=*/64));
+  algorithms.push_back(
+      MakeUnique<GlobalDecreasingSizeBestFitHeap>(/*alignment=*/1));
+  ChooseBestHeapAlgorithm heap(std::move(algorithms));
+  heap.Alloc(buffer_a_, 10);
+  heap.Alloc(buffer_b_, 5);
+  heap.Free(buffer_a_, 10);
+  heap.Free(buffer_b_, 5);
+
+  const HeapSimulator::Result result = heap.Finish();
+  EXPECT_EQ(15, result.heap_size);
+  EXPECT_EQ(0, result.chunk_map.at(buffer_a_).offset);
+  EXPECT_EQ(10, result.chunk_map.at(buffer_b_).offset);
+}
+
 }  // namespace
 }  // namespace xla
@@ -549,6 +549,33 @@ XLA_TYPED_TEST(DotOperationTest_F16F32F64, ConcurrentMatMult) {
                                         this->error_spec_);
 }
 
+// The LLVM IR GEMM of the CPU backend multiplies the RHS in blocks of 256 rows
+// and a few hundred columns; these shapes end with partial blocks in both
+// dimensions. Other backends ignore the options.
+XLA_TEST_F(DotOperationTest, MatMulWithPartialGemmBlocks) {
+  execution_options_.mutable_debug_options()->set_xla_cpu_multi_thread_eigen(
+      false);
+  (*execution_options_.mutable_debug_options()
+        ->mutable_xla_backend_extra_options())
+      ["xla_enable_experimental_llvm_ir_gemm"] = "";
+
+  Array2D<float> lhs(7, 300);
+  lhs.FillRandom(1.0f);
+  Array2D<float> rhs(300, 515);
+  rhs.FillRandom(1.0f);
+
+  XlaBuilder builder(TestName());
+  XlaOp lhs_param;
+  XlaOp rhs_param;
+  auto lhs_data = CreateR2Parameter<float>(lhs, 0, "lhs", &builder, &lhs_param);
+  auto rhs_data = CreateR2Parameter<float>(rhs, 1, "rhs", &builder, &rhs_param);
+  builder.Dot(lhs_param, rhs_param);
+
+  ComputeAndCompareR2<float>(&builder, *ReferenceUtil::MatmulArray2D(lhs, rhs),
+                             {lhs_data.get(), rhs_data.get()},
+                             ErrorSpec{1e-3, 1e-3});
+}
+
 template <typename T>
 class DotOperationTestForBatchMatMul : public DotOperationTest {};
 TYPED_TEST_CASE(DotOperationTestForBatchMatMul, TypesF16F32F64);
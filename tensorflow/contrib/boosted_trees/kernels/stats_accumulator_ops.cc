@@ -14,8 +14,8 @@
 // =============================================================================
 #include <algorithm>
 #include <iterator>
-#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "tensorflow/contrib/boosted_trees/lib/utils/parallel_for.h"
@@ -28,6 +28,8 @@
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/gtl/flatmap.h"
+#include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/util/work_sharder.h"
 
@@ -66,6 +68,16 @@ struct PartitionKey {
     }
   };
 
+  // Hash for PartitionKey.
+  struct Hash {
+    size_t operator()(const PartitionKey& key) const {
+      // Hash all the bits: the flat map takes its buckets from the high bits,
+      // while keys mostly differ in the low bits of their feature id.
+      const int64 fields[] = {key.partition_id, key.feature_id, key.dimension};
+      return Hash64(reinterpret_cast<const char*>(fields), sizeof(fields));
+    }
+  };
+
   // Tree partition defined by traversing the tree to the leaf.
   int32 partition_id;
 
@@ -76,13 +88,17 @@ struct PartitionKey {
   int32 dimension;
 };
 
+// Accumulates gradient and hessian stats per partition key. The stats are
+// added to an open addressed hash map, and only sorted by key when they are
+// serialized, which happens once per layer while the stats of every batch are
+// added to them.
 template <typename GradientType, typename HessianType>
 class StatsAccumulatorResource : public boosted_trees::StampedResource {
+ public:
+  using Stats = std::pair<GradientType, HessianType>;
   using StatsByPartition =
-      std::map<PartitionKey, std::pair<GradientType, HessianType>,
-               PartitionKey::Less>;
+      gtl::FlatMap<PartitionKey, Stats, PartitionKey::Hash>;
 
- public:
   StatsAccumulatorResource(const TensorShape& gradient_shape,
                            const TensorShape& hessian_shape)
       : gradient_shape_(gradient_shape),
@@ -109,6 +125,22 @@ class StatsAccumulatorResource : public boosted_trees::StampedResource {
   tensorflow::mutex* mutex() { return &mu_; }
   StatsByPartition* mutable_values() { return &values_; }
   const StatsByPartition& values() const { return values_; }
+
+  // Returns the keys and stats ordered by key.
+  std::vector<std::pair<PartitionKey, const Stats*>> SortedValues() const {
+    std::vector<std::pair<PartitionKey, const Stats*>> sorted_values;
+    sorted_values.reserve(values_.size());
+    for (const auto& iter : values_) {
+      sorted_values.emplace_back(iter.first, &iter.second);
+    }
+    PartitionKey::Less less;
+    std::sort(sorted_values.begin(), sorted_values.end(),
+              [&less](const std::pair<PartitionKey, const Stats*>& a,
+                      const std::pair<PartitionKey, const Stats*>& b) {
+                return less(a.first, b.first);
+              });
+    return sorted_values;
+  }
   const int64& num_updates() const { return num_updates_; }
   void set_num_updates(int64 val) { num_updates_ = val; }
   const TensorShape& gradient_shape() const { return gradient_shape_; }
@@ -159,13 +191,13 @@ void SerializeScalarAccumulatorToOutput(
   auto hessians = hessians_t->vec<float>();
 
   int i = 0;
-  for (const auto& iter : accumulator_resource.values()) {
+  for (const auto& iter : accumulator_resource.SortedValues()) {
     partition_ids(i) = iter.first.partition_id;
     feature_ids(i, 0) = iter.first.feature_id;
     feature_ids(i, 1) = iter.first.dimension;
 
-    gradients(i) = iter.second.first;
-    hessians(i) = iter.second.second;
+    gradients(i) = iter.second->first;
+    hessians(i) = iter.second->second;
     ++i;
   }
 }
@@ -204,16 +236,16 @@ void SerializeTensorAccumulatorToOutput(
   auto hessians = hessians_t->flat_outer_dims<float>();
 
   int i = 0;
-  for (const auto& iter : accumulator_resource.values()) {
+  for (const auto& iter : accumulator_resource.SortedValues()) {
     partition_ids(i) = iter.first.partition_id;
     feature_ids(i, 0) = iter.first.feature_id;
     feature_ids(i, 1) = iter.first.dimension;
 
     for (int j = 0; j < num_gradient_elements; ++j) {
-      gradients(i, j) = iter.second.first[j];
+      gradients(i, j) = iter.second->first[j];
     }
     for (int j = 0; j < num_hessian_elements; ++j) {
-      hessians(i, j) = iter.second.second[j];
+      hessians(i, j) = iter.second->second[j];
     }
     ++i;
   }
@@ -237,13 +269,10 @@ void AddToScalarAccumulator(
     const auto key =
         PartitionKey(partition_ids(i), feature_ids_and_dimensions(i, 0),
                      feature_ids_and_dimensions(i, 1));
-    auto itr = stats_map->find(key);
-    if (itr != stats_map->end()) {
-      itr->second.first += gradients(i);
-      itr->second.second += hessians(i);
-    } else {
-      (*stats_map)[key] = {gradients(i), hessians(i)};
-    }
+    // New stats start at zero.
+    auto& stats = (*stats_map)[key];
+    stats.first += gradients(i);
+    stats.second += hessians(i);
   }
 }
 
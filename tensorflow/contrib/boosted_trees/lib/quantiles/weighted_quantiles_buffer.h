@@ -16,6 +16,8 @@
 #define TENSORFLOW_CONTRIB_BOOSTED_TREES_LIB_QUANTILES_WEIGHTED_QUANTILES_BUFFER_H_
 
 #include <algorithm>
+#include <cstring>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -26,6 +28,88 @@ namespace tensorflow {
 namespace boosted_trees {
 namespace quantiles {
 
+namespace internal {
+
+// Maps floating point values to unsigned integers with the same order, so that
+// they can be radix sorted.
+template <typename ValueType>
+struct RadixSortKey;
+
+template <>
+struct RadixSortKey<float> {
+  using Type = uint32;
+  static Type Get(float value) {
+    Type bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 31) ? ~bits : bits | (Type{1} << 31);
+  }
+};
+
+template <>
+struct RadixSortKey<double> {
+  using Type = uint64;
+  static Type Get(double value) {
+    Type bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 63) ? ~bits : bits | (Type{1} << 63);
+  }
+};
+
+// Whether buffers of ValueType ordered by CompareFn are radix sorted.
+template <typename ValueType, typename CompareFn>
+struct UseRadixSort : std::false_type {};
+template <>
+struct UseRadixSort<float, std::less<float>> : std::true_type {};
+template <>
+struct UseRadixSort<double, std::less<double>> : std::true_type {};
+
+// Sorts the entries by value with a stable least significant digit radix sort.
+// The histograms of all the digits are computed in one pass, and the digits
+// all the entries share are skipped.
+template <typename Entry>
+void RadixSortEntries(std::vector<Entry>* entries) {
+  using Key = RadixSortKey<decltype(Entry::value)>;
+  constexpr int kDigitBits = 11;
+  constexpr int kNumDigits = (8 * sizeof(typename Key::Type) + kDigitBits - 1) /
+                             kDigitBits;
+  constexpr size_t kNumBuckets = size_t{1} << kDigitBits;
+  constexpr size_t kDigitMask = kNumBuckets - 1;
+
+  std::vector<size_t> histograms(kNumDigits * kNumBuckets, 0);
+  for (const Entry& entry : *entries) {
+    const typename Key::Type key = Key::Get(entry.value);
+    for (int digit = 0; digit < kNumDigits; ++digit) {
+      ++histograms[digit * kNumBuckets +
+                   ((key >> (digit * kDigitBits)) & kDigitMask)];
+    }
+  }
+
+  std::vector<Entry> sorted(entries->size());
+  for (int digit = 0; digit < kNumDigits; ++digit) {
+    size_t* offsets = &histograms[digit * kNumBuckets];
+    const size_t first_bucket =
+        (Key::Get(entries->front().value) >> (digit * kDigitBits)) &
+        kDigitMask;
+    if (offsets[first_bucket] == entries->size()) {
+      continue;
+    }
+    size_t offset = 0;
+    for (size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+      const size_t count = offsets[bucket];
+      offsets[bucket] = offset;
+      offset += count;
+    }
+    for (const Entry& entry : *entries) {
+      const size_t bucket =
+          (Key::Get(entry.value) >> (digit * kDigitBits)) & kDigitMask;
+      sorted[offsets[bucket]++] = entry;
+    }
+    entries->swap(sorted);
+  }
+}
+
+}  // namespace internal
+
 // Buffering container ideally suited for scenarios where we need
 // to sort and dedupe/compact fixed chunks of a stream of weighted elements.
 template <typename ValueType, typename WeightType,
@@ -91,7 +175,7 @@ class WeightedQuantilesBuffer {
     }
     ret.swap(vec_);
     vec_.reserve(max_size_);
-    std::sort(ret.begin(), ret.end());
+    SortEntries(&ret, internal::UseRadixSort<ValueType, CompareFn>());
     size_t num_entries = 0;
     for (size_t i = 1; i < ret.size(); ++i) {
       if (ret[i].value != ret[i - 1].value) {
@@ -113,6 +197,24 @@ class WeightedQuantilesBuffer {
  private:
   using BufferVector = typename std::vector<BufferEntry>;
 
+  // Buffers smaller than this are sorted with std::sort rather than radix
+  // sorted, as the radix sort has a fixed cost per digit.
+  static constexpr size_t kMinRadixSortSize = 1024;
+
+  // Sorts the entries by value. Floating point values ordered by std::less
+  // are radix sorted, which is linear in the number of entries and dominates
+  // the cost of building summaries from large buffers.
+  static void SortEntries(BufferVector* entries, std::true_type) {
+    if (entries->size() < kMinRadixSortSize) {
+      std::sort(entries->begin(), entries->end());
+    } else {
+      internal::RadixSortEntries(entries);
+    }
+  }
+  static void SortEntries(BufferVector* entries, std::false_type) {
+    std::sort(entries->begin(), entries->end());
+  }
+
   // Comparison function.
   static constexpr decltype(CompareFn()) kCompFn = CompareFn();
 
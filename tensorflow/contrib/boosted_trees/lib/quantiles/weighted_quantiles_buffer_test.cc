@@ -14,6 +14,8 @@
 // =============================================================================
 #include "tensorflow/contrib/boosted_trees/lib/quantiles/weighted_quantiles_buffer.h"
 
+#include <map>
+
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/platform/test.h"
@@ -76,6 +78,44 @@ TEST_F(WeightedQuantilesBufferTest, PushEntryFull) {
   EXPECT_FALSE(buffer.IsFull());
 }
 
+template <typename T>
+void ExpectSortedAndDeduped(int64 num_entries) {
+  // Large enough to be radix sorted.
+  boosted_trees::quantiles::WeightedQuantilesBuffer<T, T> buffer(num_entries,
+                                                                  num_entries);
+  random::PhiloxRandom philox(13);
+  random::SimplePhilox rand(&philox);
+  std::map<T, T> expected_weights;
+  for (int64 i = 0; i < num_entries; ++i) {
+    // Few distinct values of both signs, with both zeros.
+    T value = static_cast<T>(rand.Uniform(2000)) / 8 - 125;
+    if (value == 0 && rand.OneIn(2)) value = -value;
+    const T weight = 1 + rand.Uniform(4);
+    buffer.PushEntry(value, weight);
+    expected_weights[value] += weight;
+  }
+  ASSERT_TRUE(buffer.IsFull());
+
+  std::vector<typename decltype(buffer)::BufferEntry> expected;
+  for (const auto& value_and_weight : expected_weights) {
+    expected.emplace_back(value_and_weight.first, value_and_weight.second);
+  }
+  const auto entries = buffer.GenerateEntryList();
+  ASSERT_EQ(entries.size(), expected.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    EXPECT_EQ(entries[i].value, expected[i].value);
+    EXPECT_EQ(entries[i].weight, expected[i].weight);
+  }
+}
+
+TEST_F(WeightedQuantilesBufferTest, GenerateEntryListLargeFloat) {
+  ExpectSortedAndDeduped<float>(10000);
+}
+
+TEST_F(WeightedQuantilesBufferTest, GenerateEntryListLargeDouble) {
+  ExpectSortedAndDeduped<double>(10000);
+}
+
 TEST_F(WeightedQuantilesBufferTest, PushEntryFullDeath) {
   // buffer capacity is 4.
   Buffer buffer(2, 100);
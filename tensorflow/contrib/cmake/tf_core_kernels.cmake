@@ -74,6 +74,7 @@ if(tensorflow_BUILD_CONTRIB_KERNELS)
       "${tensorflow_source_dir}/tensorflow/contrib/data/kernels/prefetching_kernels.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/data/kernels/threadpool_dataset_op.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/data/kernels/unique_dataset_op.cc"
+      "${tensorflow_source_dir}/tensorflow/contrib/data/kernels/worker_dataset_op.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/data/ops/dataset_ops.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/factorization/kernels/clustering_ops.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/factorization/kernels/masked_matmul_ops.cc"
@@ -96,10 +97,13 @@ if(tensorflow_BUILD_CONTRIB_KERNELS)
       "${tensorflow_source_dir}/tensorflow/contrib/layers/ops/sparse_feature_cross_op.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/libsvm/kernels/decode_libsvm_op.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/libsvm/ops/libsvm_ops.cc"
+      "${tensorflow_source_dir}/tensorflow/contrib/model_pruning/kernels/block_sparse_matmul_op.cc"
+      "${tensorflow_source_dir}/tensorflow/contrib/model_pruning/ops/block_sparse_ops.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/nccl/kernels/nccl_manager.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/nccl/kernels/nccl_ops.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/nccl/ops/nccl_ops.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/nearest_neighbor/kernels/hyperplane_lsh_probes.cc"
+      "${tensorflow_source_dir}/tensorflow/contrib/nearest_neighbor/kernels/lsh_bucket_search.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/nearest_neighbor/ops/nearest_neighbor_ops.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/resampler/kernels/resampler_ops.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/resampler/ops/resampler_ops.cc"
@@ -163,7 +167,10 @@ if(WIN32)
       # not working on windows yet
       "${tensorflow_source_dir}/tensorflow/core/kernels/neon/*"
       # not in core - those are loaded dynamically as dll
+      "${tensorflow_source_dir}/tensorflow/contrib/model_pruning/kernels/block_sparse_matmul_op.cc"
+      "${tensorflow_source_dir}/tensorflow/contrib/model_pruning/ops/block_sparse_ops.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/nearest_neighbor/kernels/hyperplane_lsh_probes.cc"
+      "${tensorflow_source_dir}/tensorflow/contrib/nearest_neighbor/kernels/lsh_bucket_search.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/nearest_neighbor/ops/nearest_neighbor_ops.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/resampler/kernels/resampler_ops.cc"
       "${tensorflow_source_dir}/tensorflow/contrib/rnn/kernels/blas_gemm.cc"
@@ -393,6 +393,8 @@ GENERATE_PYTHON_OP_LIB("contrib_layers_sparse_feature_cross_ops"
   DESTINATION ${CMAKE_CURRENT_BINARY_DIR}/tf_python/tensorflow/contrib/layers/ops/gen_sparse_feature_cross_op.py)
 GENERATE_PYTHON_OP_LIB("contrib_memory_stats_ops"
   DESTINATION ${CMAKE_CURRENT_BINARY_DIR}/tf_python/tensorflow/contrib/memory_stats/ops/gen_memory_stats_ops.py)
+GENERATE_PYTHON_OP_LIB("contrib_model_pruning_block_sparse_ops"
+  DESTINATION ${CMAKE_CURRENT_BINARY_DIR}/tf_python/tensorflow/contrib/model_pruning/python/ops/gen_block_sparse_ops.py)
 GENERATE_PYTHON_OP_LIB("contrib_nccl_ops"
   DESTINATION ${CMAKE_CURRENT_BINARY_DIR}/tf_python/tensorflow/contrib/nccl/ops/gen_nccl_ops.py)
 GENERATE_PYTHON_OP_LIB("contrib_periodic_resample_ops"
@@ -634,6 +636,8 @@ if(WIN32)
         "${tensorflow_source_dir}/tensorflow/contrib/nearest_neighbor/kernels/heap.h"
         "${tensorflow_source_dir}/tensorflow/contrib/nearest_neighbor/kernels/hyperplane_lsh_probes.h"
         "${tensorflow_source_dir}/tensorflow/contrib/nearest_neighbor/kernels/hyperplane_lsh_probes.cc"
+        "${tensorflow_source_dir}/tensorflow/contrib/nearest_neighbor/kernels/lsh_bucket_search.h"
+        "${tensorflow_source_dir}/tensorflow/contrib/nearest_neighbor/kernels/lsh_bucket_search.cc"
         "${tensorflow_source_dir}/tensorflow/contrib/nearest_neighbor/ops/nearest_neighbor_ops.cc"
     )
 
@@ -641,6 +645,18 @@ if(WIN32)
         SOURCES "${tf_nearest_neighbor_srcs}"
         DEPENDS pywrap_tensorflow_internal tf_python_ops
         DISTCOPY ${CMAKE_CURRENT_BINARY_DIR}/tf_python/tensorflow/contrib/nearest_neighbor/python/ops/)
+
+    # include contrib/model_pruning block sparse ops as .so
+    #
+    set(tf_block_sparse_srcs
+        "${tensorflow_source_dir}/tensorflow/contrib/model_pruning/kernels/block_sparse_matmul_op.cc"
+        "${tensorflow_source_dir}/tensorflow/contrib/model_pruning/ops/block_sparse_ops.cc"
+    )
+
+    AddUserOps(TARGET _block_sparse_ops
+        SOURCES "${tf_block_sparse_srcs}"
+        DEPENDS pywrap_tensorflow_internal tf_python_ops
+        DISTCOPY ${CMAKE_CURRENT_BINARY_DIR}/tf_python/tensorflow/contrib/model_pruning/python/ops/)
 endif(WIN32)
 
 if(WIN32)
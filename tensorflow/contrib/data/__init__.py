@@ -26,6 +26,7 @@ See @{$guide/datasets$Importing Data} for an overview.
 @@CheckpointInputPipelineHook
 @@CsvDataset
 @@SqlDataset
+@@TFRecordExampleDataset
 
 @@assert_element_shape
 @@batch_and_drop_remainder
@@ -43,6 +44,7 @@ See @{$guide/datasets$Importing Data} for an overview.
 @@parallel_interleave
 @@prefetch_to_device
 @@read_batch_features
+@@read_from_workers
 @@rejection_resample
 @@sample_from_datasets
 @@scan
@@ -79,11 +81,13 @@ from tensorflow.contrib.data.python.ops.interleave_ops import sloppy_interleave
 from tensorflow.contrib.data.python.ops.iterator_ops import CheckpointInputPipelineHook
 from tensorflow.contrib.data.python.ops.iterator_ops import make_saveable_from_iterator
 from tensorflow.contrib.data.python.ops.prefetching_ops import prefetch_to_device
+from tensorflow.contrib.data.python.ops.prefetching_ops import read_from_workers
 from tensorflow.contrib.data.python.ops.readers import CsvDataset
 from tensorflow.contrib.data.python.ops.readers import make_batched_features_dataset
 from tensorflow.contrib.data.python.ops.readers import make_csv_dataset
 from tensorflow.contrib.data.python.ops.readers import read_batch_features
 from tensorflow.contrib.data.python.ops.readers import SqlDataset
+from tensorflow.contrib.data.python.ops.readers import TFRecordExampleDataset
 from tensorflow.contrib.data.python.ops.resampling import rejection_resample
 from tensorflow.contrib.data.python.ops.scan_ops import scan
 from tensorflow.contrib.data.python.ops.shuffle_ops import shuffle_and_repeat
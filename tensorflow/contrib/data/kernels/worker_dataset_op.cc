@@ -0,0 +1,328 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include <deque>
+
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/partial_tensor_shape.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/util/device_name_utils.h"
+
+namespace tensorflow {
+namespace {
+
+// See documentation in ../ops/dataset_ops.cc for a high-level
+// description of the following op.
+
+class WorkerDatasetOp : public DatasetOpKernel {
+ public:
+  explicit WorkerDatasetOp(OpKernelConstruction* ctx) : DatasetOpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("f", &func_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("output_types", &output_types_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("output_shapes", &output_shapes_));
+  }
+
+  void MakeDataset(OpKernelContext* ctx, DatasetBase** output) override {
+    const Tensor* iterator_handles_t;
+    OP_REQUIRES_OK(ctx, ctx->input("iterator_handles", &iterator_handles_t));
+    const Tensor* worker_devices_t;
+    OP_REQUIRES_OK(ctx, ctx->input("worker_devices", &worker_devices_t));
+    OP_REQUIRES(
+        ctx, TensorShapeUtils::IsVector(iterator_handles_t->shape()),
+        errors::InvalidArgument("`iterator_handles` must be a vector."));
+    OP_REQUIRES(ctx, TensorShapeUtils::IsVector(worker_devices_t->shape()),
+                errors::InvalidArgument("`worker_devices` must be a vector."));
+    OP_REQUIRES(ctx, iterator_handles_t->NumElements() > 0,
+                errors::InvalidArgument(
+                    "`iterator_handles` must contain at least one handle."));
+    OP_REQUIRES(
+        ctx,
+        iterator_handles_t->NumElements() == worker_devices_t->NumElements(),
+        errors::InvalidArgument(
+            "`iterator_handles` and `worker_devices` must have the same "
+            "number of elements, but got ",
+            iterator_handles_t->NumElements(), " and ",
+            worker_devices_t->NumElements(), "."));
+
+    int64 buffer_size;
+    OP_REQUIRES_OK(
+        ctx, ParseScalarArgument<int64>(ctx, "buffer_size", &buffer_size));
+    OP_REQUIRES(ctx, buffer_size > 0,
+                errors::InvalidArgument("`buffer_size` must be > 0."));
+
+    std::vector<Tensor> iterator_handles;
+    std::vector<string> worker_devices;
+    for (int64 i = 0; i < iterator_handles_t->NumElements(); ++i) {
+      Tensor handle(DT_STRING, TensorShape({}));
+      handle.scalar<string>()() = iterator_handles_t->vec<string>()(i);
+      iterator_handles.push_back(std::move(handle));
+      worker_devices.push_back(DeviceNameUtils::CanonicalizeDeviceName(
+          worker_devices_t->vec<string>()(i)));
+    }
+
+    *output = new Dataset(ctx, func_, std::move(iterator_handles),
+                          std::move(worker_devices), buffer_size,
+                          output_types_, output_shapes_);
+  }
+
+ private:
+  class Dataset : public GraphDatasetBase {
+   public:
+    Dataset(OpKernelContext* ctx, const NameAttrList& func,
+            std::vector<Tensor> iterator_handles,
+            std::vector<string> worker_devices, int64 buffer_size,
+            const DataTypeVector& output_types,
+            const std::vector<PartialTensorShape>& output_shapes)
+        : GraphDatasetBase(ctx),
+          func_(func),
+          iterator_handles_(std::move(iterator_handles)),
+          worker_devices_(std::move(worker_devices)),
+          buffer_size_(buffer_size),
+          output_types_(output_types),
+          output_shapes_(output_shapes) {}
+
+    std::unique_ptr<IteratorBase> MakeIteratorInternal(
+        const string& prefix) const override {
+      return std::unique_ptr<IteratorBase>(
+          new Iterator({this, strings::StrCat(prefix, "::Worker")}));
+    }
+
+    const DataTypeVector& output_dtypes() const override {
+      return output_types_;
+    }
+    const std::vector<PartialTensorShape>& output_shapes() const override {
+      return output_shapes_;
+    }
+
+    string DebugString() const override {
+      return strings::StrCat("WorkerDatasetOp(", worker_devices_.size(),
+                             ")::Dataset");
+    }
+
+   private:
+    // Calls `func_` on each worker to get the next element of the iterator
+    // running there, keeping up to `buffer_size_` elements of each worker
+    // buffered, and returns the elements of the workers in a round-robin
+    // order.
+    //
+    // At most one call is in flight per worker at any time, so that the
+    // elements of a worker are returned in the order its iterator produced
+    // them.
+    class Iterator : public DatasetIterator<Dataset> {
+     public:
+      explicit Iterator(const Params& params)
+          : DatasetIterator<Dataset>(params),
+            handles_(params.dataset->iterator_handles_.size()),
+            workers_(params.dataset->iterator_handles_.size()) {}
+
+      ~Iterator() override {
+        mutex_lock l(mu_);
+        cancelled_ = true;
+        while (num_calls_ > 0) {
+          cond_var_.wait(l);
+        }
+      }
+
+      Status Initialize(IteratorContext* ctx) override {
+        lib_ = ctx->lib();
+        if (lib_ == nullptr) {
+          return errors::Internal("No function library is provided.");
+        }
+        AttrValueMap attr_values = dataset()->func_.attr();
+        for (size_t i = 0; i < handles_.size(); ++i) {
+          FunctionLibraryRuntime::InstantiateOptions opts;
+          opts.target = dataset()->worker_devices_[i];
+          TF_RETURN_IF_ERROR(lib_->Instantiate(dataset()->func_.name(),
+                                               AttrSlice(&attr_values), opts,
+                                               &handles_[i]));
+        }
+        return Status::OK();
+      }
+
+      Status GetNextInternal(IteratorContext* ctx,
+                             std::vector<Tensor>* out_tensors,
+                             bool* end_of_sequence) override {
+        // The function library runtime may invoke the callback of a call
+        // synchronously, so the calls are started without holding `mu_`.
+        std::vector<size_t> calls_to_start;
+        {
+          mutex_lock l(mu_);
+          for (size_t i = 0; i < workers_.size(); ++i) {
+            if (ShouldStartCallLocked(i)) {
+              calls_to_start.push_back(i);
+            }
+          }
+        }
+        for (size_t i : calls_to_start) {
+          StartCall(i);
+        }
+        calls_to_start.clear();
+
+        BufferElement element;
+        *end_of_sequence = false;
+        {
+          mutex_lock l(mu_);
+          while (true) {
+            // Skip the workers whose iterator is exhausted.
+            size_t num_skipped = 0;
+            while (num_skipped < workers_.size() &&
+                   FinishedLocked(workers_[next_worker_])) {
+              next_worker_ = (next_worker_ + 1) % workers_.size();
+              ++num_skipped;
+            }
+            if (num_skipped == workers_.size()) {
+              *end_of_sequence = true;
+              break;
+            }
+            if (!workers_[next_worker_].buffer.empty()) {
+              break;
+            }
+            RecordWaitStart(ctx);
+            cond_var_.wait(l);
+            RecordWaitStop(ctx);
+          }
+          if (!*end_of_sequence) {
+            Worker* worker = &workers_[next_worker_];
+            element = std::move(worker->buffer.front());
+            worker->buffer.pop_front();
+            if (ShouldStartCallLocked(next_worker_)) {
+              calls_to_start.push_back(next_worker_);
+            }
+            next_worker_ = (next_worker_ + 1) % workers_.size();
+          }
+        }
+        for (size_t i : calls_to_start) {
+          StartCall(i);
+        }
+        if (*end_of_sequence) {
+          return Status::OK();
+        }
+        if (!element.status.ok()) {
+          return element.status;
+        }
+        *out_tensors = std::move(element.value);
+        return Status::OK();
+      }
+
+     private:
+      struct BufferElement {
+        // The worker sets `status` if getting the element fails.
+        Status status;
+        std::vector<Tensor> value;
+      };
+
+      struct Worker {
+        std::deque<BufferElement> buffer;
+        bool call_in_flight = false;
+        bool end_of_sequence = false;
+      };
+
+      bool FinishedLocked(const Worker& worker) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        return worker.end_of_sequence && worker.buffer.empty();
+      }
+
+      // Returns true if a call should be started for worker `index`, in which
+      // case the call is accounted for and the caller must `StartCall()` it.
+      bool ShouldStartCallLocked(size_t index) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        Worker* worker = &workers_[index];
+        if (cancelled_ || worker->call_in_flight || worker->end_of_sequence ||
+            worker->buffer.size() >=
+                static_cast<size_t>(dataset()->buffer_size_)) {
+          return false;
+        }
+        worker->call_in_flight = true;
+        ++num_calls_;
+        return true;
+      }
+
+      void StartCall(size_t index) LOCKS_EXCLUDED(mu_) {
+        FunctionLibraryRuntime::Options opts;
+        // Copied from CapturedFunction::generate_step_id();
+        opts.step_id = -std::abs(static_cast<int64>(random::New64()));
+        opts.source_device = lib_->device()->name();
+        AllocatorAttributes arg_alloc_attr;
+        arg_alloc_attr.set_on_host(true);
+        opts.args_alloc_attrs.push_back(arg_alloc_attr);
+        if (opts.source_device != dataset()->worker_devices_[index]) {
+          opts.remote_execution = true;
+        }
+        opts.create_rendezvous = true;
+        auto* rets = new std::vector<Tensor>;
+        lib_->Run(opts, handles_[index],
+                  {dataset()->iterator_handles_[index]}, rets,
+                  [this, index, rets](const Status& status) {
+                    CallCompleted(index, status, rets);
+                  });
+      }
+
+      void CallCompleted(size_t index, const Status& status,
+                         std::vector<Tensor>* rets) LOCKS_EXCLUDED(mu_) {
+        std::unique_ptr<std::vector<Tensor>> rets_deleter(rets);
+        bool restart = false;
+        {
+          mutex_lock l(mu_);
+          Worker* worker = &workers_[index];
+          worker->call_in_flight = false;
+          --num_calls_;
+          if (errors::IsOutOfRange(status)) {
+            // The iterator of the worker is exhausted.
+            worker->end_of_sequence = true;
+          } else {
+            BufferElement element;
+            element.status = status;
+            element.value.swap(*rets);
+            worker->buffer.push_back(std::move(element));
+          }
+          restart = ShouldStartCallLocked(index);
+          // NOTE: Once `mu_` is released, the destructor may run unless a new
+          // call is in flight, so `this` must not be used afterwards.
+          cond_var_.notify_all();
+        }
+        if (restart) {
+          StartCall(index);
+        }
+      }
+
+      mutex mu_;
+      condition_variable cond_var_;
+      FunctionLibraryRuntime* lib_ = nullptr;  // Not owned.
+      // The instantiated `func_` of each worker.
+      std::vector<FunctionLibraryRuntime::Handle> handles_;
+      std::vector<Worker> workers_ GUARDED_BY(mu_);
+      size_t next_worker_ GUARDED_BY(mu_) = 0;
+      int64 num_calls_ GUARDED_BY(mu_) = 0;
+      bool cancelled_ GUARDED_BY(mu_) = false;
+    };
+
+    const NameAttrList func_;
+    const std::vector<Tensor> iterator_handles_;
+    const std::vector<string> worker_devices_;
+    const int64 buffer_size_;
+    const DataTypeVector output_types_;
+    const std::vector<PartialTensorShape> output_shapes_;
+  };
+
+  NameAttrList func_;
+  DataTypeVector output_types_;
+  std::vector<PartialTensorShape> output_shapes_;
+};
+
+REGISTER_KERNEL_BUILDER(Name("WorkerDataset").Device(DEVICE_CPU),
+                        WorkerDatasetOp);
+
+}  // namespace
+}  // namespace tensorflow
@@ -141,6 +141,37 @@ Resets the FunctionBufferingResource.
 function_buffer_resource: The FunctionBufferingResource handle.
 )doc");
 
+REGISTER_OP("WorkerDataset")
+    .Input("iterator_handles: string")
+    .Input("worker_devices: string")
+    .Input("buffer_size: int64")
+    .Output("handle: variant")
+    .Attr("f: func")
+    .Attr("output_types: list(type) >= 1")
+    .Attr("output_shapes: list(shape) >= 1")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 1, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 0, &unused));
+      return shape_inference::ScalarShape(c);
+    })
+    .Doc(R"doc(
+Creates a dataset that reads the elements of iterators running on workers.
+
+The input pipeline of each worker runs on the device (typically the CPU of a
+separate task) where its iterator has been placed, and the elements it produces
+are transferred by calling `f` on that device. The elements of the workers are
+returned in a round-robin order, skipping the workers whose iterator is
+exhausted.
+
+iterator_handles: A vector of string handles of the iterators of the workers.
+worker_devices: A vector of the devices on which the iterators have been placed.
+buffer_size: The maximum number of elements to buffer for each worker.
+f: A function that takes the string handle of an iterator and returns its next
+  element, raising `OutOfRange` when the iterator is exhausted.
+)doc");
+
 REGISTER_OP("ThreadPoolDataset")
     .Input("input_dataset: variant")
     .Input("thread_pool: resource")
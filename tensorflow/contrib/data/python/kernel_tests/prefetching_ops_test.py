@@ -31,6 +31,7 @@ from tensorflow.python.framework import ops
 from tensorflow.python.framework import sparse_tensor
 from tensorflow.python.framework import test_util
 from tensorflow.python.ops import resource_variable_ops
+from tensorflow.python.ops import string_ops
 from tensorflow.python.platform import test
 
 
@@ -322,6 +323,27 @@ class PrefetchToDeviceTest(test.TestCase):
       with self.assertRaises(errors.OutOfRangeError):
         sess.run(next_element)
 
+  def testPrefetchStringsToDevice(self):
+    host_dataset = dataset_ops.Dataset.range(10).map(
+        lambda x: (x, string_ops.as_string(x)))
+    device_dataset = host_dataset.apply(
+        prefetching_ops.prefetch_to_device("/cpu:1", buffer_size=3))
+
+    with ops.device("/cpu:0"):
+      iterator = device_dataset.make_one_shot_iterator()
+
+    next_element = iterator.get_next()
+    self.assertEqual(dtypes.int64, next_element[0].dtype)
+    self.assertEqual(dtypes.string, next_element[1].dtype)
+
+    worker_config = config_pb2.ConfigProto()
+    worker_config.device_count["CPU"] = 2
+    with self.test_session(config=worker_config) as sess:
+      for i in range(10):
+        self.assertEqual((i, str(i).encode()), sess.run(next_element))
+      with self.assertRaises(errors.OutOfRangeError):
+        sess.run(next_element)
+
   def testPrefetchToDeviceWithReInit(self):
     host_dataset = dataset_ops.Dataset.range(10)
     device_dataset = host_dataset.apply(
@@ -380,5 +402,63 @@ class PrefetchToDeviceTest(test.TestCase):
         sess.run(next_element)
 
 
+
+class ReadFromWorkersTest(test.TestCase):
+
+  def testReadFromWorkers(self):
+
+    def dataset_fn(worker_index, num_workers):
+      return dataset_ops.Dataset.range(10).shard(num_workers, worker_index)
+
+    with ops.device("/cpu:0"):
+      dataset = prefetching_ops.read_from_workers(
+          dataset_fn, ["/cpu:1", "/cpu:2"], buffer_size=2)
+      iterator = dataset.make_one_shot_iterator()
+    self.assertEqual(dtypes.int64, dataset.output_types)
+    self.assertEqual([], dataset.output_shapes)
+    next_element = iterator.get_next()
+
+    worker_config = config_pb2.ConfigProto()
+    worker_config.device_count["CPU"] = 3
+    with self.test_session(config=worker_config) as sess:
+      for i in range(10):
+        self.assertEqual(i, sess.run(next_element))
+      with self.assertRaises(errors.OutOfRangeError):
+        sess.run(next_element)
+
+  def testUnevenWorkers(self):
+
+    def dataset_fn(worker_index, num_workers):
+      del num_workers  # Unused.
+      return dataset_ops.Dataset.range(worker_index * 3).map(
+          lambda x: {"worker": worker_index, "value": x})
+
+    with ops.device("/cpu:0"):
+      dataset = prefetching_ops.read_from_workers(dataset_fn,
+                                                  ["/cpu:1", "/cpu:2"])
+      next_element = dataset.make_one_shot_iterator().get_next()
+
+    worker_config = config_pb2.ConfigProto()
+    worker_config.device_count["CPU"] = 3
+    with self.test_session(config=worker_config) as sess:
+      # The first worker has no elements, so the second one produces all of
+      # them.
+      for i in range(3):
+        self.assertEqual({"worker": 1, "value": i}, sess.run(next_element))
+      with self.assertRaises(errors.OutOfRangeError):
+        sess.run(next_element)
+
+  def testDifferentTypes(self):
+
+    def dataset_fn(worker_index, num_workers):
+      del num_workers  # Unused.
+      if worker_index == 0:
+        return dataset_ops.Dataset.range(10)
+      return dataset_ops.Dataset.from_tensors(1.0)
+
+    with self.assertRaises(TypeError):
+      prefetching_ops.read_from_workers(dataset_fn, ["/cpu:1", "/cpu:2"])
+
+
 if __name__ == "__main__":
   test.main()
@@ -33,6 +33,7 @@ from tensorflow.python.framework import constant_op
 from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import errors
 from tensorflow.python.framework import ops
+from tensorflow.python.framework import sparse_tensor
 from tensorflow.python.lib.io import python_io
 from tensorflow.python.ops import array_ops
 from tensorflow.python.ops import parsing_ops
@@ -580,6 +581,45 @@ class ReadBatchFeaturesTest(test.TestCase):
             if isinstance(tensor, ops.Tensor):  # Guard against SparseTensor.
               self.assertEqual(tensor.shape[0], batch_size)
 
+  def testTFRecordExampleDataset(self):
+    features = {
+        "file": parsing_ops.FixedLenFeature([], dtypes.int64),
+        "record": parsing_ops.FixedLenFeature([], dtypes.int64),
+        "keywords": parsing_ops.VarLenFeature(dtypes.string),
+        "missing": parsing_ops.FixedLenFeature([2], dtypes.float32,
+                                               default_value=[1.0, 2.0]),
+    }
+    for batch_size in [1, 3, 20]:
+      for num_parallel_calls in [1, 4]:
+        with ops.Graph().as_default():
+          fused = readers.TFRecordExampleDataset(
+              self.test_filenames, features, batch_size,
+              num_parallel_calls=num_parallel_calls)
+          self.assertEqual(
+              sparse_tensor.SparseTensor, fused.output_classes["keywords"])
+          self.assertEqual([None, 2], fused.output_shapes["missing"].as_list())
+          expected = core_readers.TFRecordDataset(self.test_filenames).batch(
+              batch_size).map(lambda x: parsing_ops.parse_example(x, features))
+          fused_next = fused.make_one_shot_iterator().get_next()
+          expected_next = expected.make_one_shot_iterator().get_next()
+          with self.test_session() as sess:
+            while True:
+              try:
+                expected_value = sess.run(expected_next)
+              except errors.OutOfRangeError:
+                break
+              fused_value = sess.run(fused_next)
+              for key in ["file", "record", "missing"]:
+                self.assertAllEqual(expected_value[key], fused_value[key])
+              self.assertAllEqual(expected_value["keywords"].indices,
+                                  fused_value["keywords"].indices)
+              self.assertAllEqual(expected_value["keywords"].values,
+                                  fused_value["keywords"].values)
+              self.assertAllEqual(expected_value["keywords"].dense_shape,
+                                  fused_value["keywords"].dense_shape)
+            with self.assertRaises(errors.OutOfRangeError):
+              sess.run(fused_next)
+
 
 class MakeCsvDatasetTest(test.TestCase):
 
@@ -467,9 +467,10 @@ class _MapAndBatchDataset(dataset_ops.MapDataset):
   """A `Dataset` that maps a function over a batch of elements."""
 
   def __init__(self, input_dataset, map_func, batch_size, num_parallel_calls,
-               drop_remainder):
+               drop_remainder, sloppy=False):
     """See `Dataset.map()` for details."""
     super(_MapAndBatchDataset, self).__init__(input_dataset, map_func)
+    self._sloppy = sloppy
     self._batch_size_t = ops.convert_to_tensor(
         batch_size, dtype=dtypes.int64, name="batch_size")
     self._num_parallel_calls_t = ops.convert_to_tensor(
@@ -490,6 +491,7 @@ class _MapAndBatchDataset(dataset_ops.MapDataset):
         batch_size=self._batch_size_t,
         num_parallel_calls=self._num_parallel_calls_t,
         drop_remainder=self._drop_remainder_t,
+        sloppy=self._sloppy,
         output_types=nest.flatten(
             sparse.as_dense_types(self.output_types, self.output_classes)),
         output_shapes=nest.flatten(
@@ -513,7 +515,8 @@ def map_and_batch(map_func,
                   batch_size,
                   num_parallel_batches=None,
                   drop_remainder=False,
-                  num_parallel_calls=None):
+                  num_parallel_calls=None,
+                  sloppy=False):
   """Fused implementation of `map` and `batch`.
 
   Maps `map_func` across `batch_size` consecutive elements of this dataset
@@ -540,6 +543,9 @@ def map_and_batch(map_func,
         representing the number of elements to process in parallel. If not
         specified, `batch_size * num_parallel_batches` elements will be
         processed in parallel.
+    sloppy: (Optional.) A `bool`. If `True`, the elements are batched in the
+      order in which `map_func` completes for them rather than in the order of
+      the input, so that a slow element does not delay the batches after it.
 
   Returns:
     A `Dataset` transformation function, which can be passed to
@@ -560,6 +566,6 @@ def map_and_batch(map_func,
 
   def _apply_fn(dataset):
     return _MapAndBatchDataset(dataset, map_func, batch_size,
-                               num_parallel_calls, drop_remainder)
+                               num_parallel_calls, drop_remainder, sloppy)
 
   return _apply_fn
@@ -93,6 +93,12 @@ class _PrefetchToDeviceIterator(object):
     self._input_dataset = input_dataset
     self._get_next_call_count = 0
     self._one_shot = one_shot
+    self._flat_output_types = nest.flatten(
+        sparse.as_dense_types(input_dataset.output_types,
+                              input_dataset.output_classes))
+    self._flat_output_shapes = nest.flatten(
+        sparse.as_dense_shapes(input_dataset.output_shapes,
+                               input_dataset.output_classes))
     if shared_name is None:
       shared_name = ""
 
@@ -104,29 +110,52 @@ class _PrefetchToDeviceIterator(object):
           shared_name, self._input_dataset.output_classes)
     input_iterator_handle = self._input_iterator.string_handle()
 
-    @function.Defun(dtypes.string)
-    def _prefetch_fn(handle):
-      """Prefetches one element from `input_iterator`."""
-      remote_iterator = iterator_ops.Iterator.from_string_handle(
-          handle, self._input_iterator.output_types,
-          self._input_iterator.output_shapes,
-          self._input_iterator.output_classes)
-      ret = remote_iterator.get_next()
-      return nest.flatten(sparse.serialize_sparse_tensors(ret))
-
-    iterator_device = gen_dataset_ops.iterator_get_device(
-        self._input_iterator._iterator_resource)
+    # Elements whose components can all be copied to `device` are prefetched
+    # by a native iterator, which copies them in the background with the
+    # host-to-device transfers of `device`. Other elements (e.g. with strings
+    # or sparse tensors) are read by calling a function on the device of the
+    # input iterator.
+    self._use_device_prefetch = all(
+        dtype not in (dtypes.string, dtypes.variant, dtypes.resource)
+        for dtype in self._flat_output_types)
+    if self._use_device_prefetch:
+      with ops.device(device):
+        self._buffering_resource = (
+            core_gen_dataset_ops.device_prefetch_iterator(
+                input_iterator_handle,
+                buffer_size=buffer_size,
+                output_types=self._flat_output_types,
+                output_shapes=self._flat_output_shapes,
+                shared_name=shared_name))
+    else:
 
-    with ops.device(device):
-      self._buffering_resource = function_buffering_resource(
-          f=_prefetch_fn,
-          target_device=iterator_device,
-          string_arg=input_iterator_handle,
-          buffer_size=buffer_size,
-          shared_name=shared_name)
+      @function.Defun(dtypes.string)
+      def _prefetch_fn(handle):
+        """Prefetches one element from `input_iterator`."""
+        remote_iterator = iterator_ops.Iterator.from_string_handle(
+            handle, self._input_iterator.output_types,
+            self._input_iterator.output_shapes,
+            self._input_iterator.output_classes)
+        ret = remote_iterator.get_next()
+        return nest.flatten(sparse.serialize_sparse_tensors(ret))
+
+      iterator_device = gen_dataset_ops.iterator_get_device(
+          self._input_iterator._iterator_resource)
+
+      with ops.device(device):
+        self._buffering_resource = function_buffering_resource(
+            f=_prefetch_fn,
+            target_device=iterator_device,
+            string_arg=input_iterator_handle,
+            buffer_size=buffer_size,
+            shared_name=shared_name)
 
     if not self._one_shot:
-      reset_op = function_buffering_resource_reset(self._buffering_resource)
+      if self._use_device_prefetch:
+        reset_op = core_gen_dataset_ops.device_prefetch_iterator_reset(
+            self._buffering_resource)
+      else:
+        reset_op = function_buffering_resource_reset(self._buffering_resource)
       with ops.control_dependencies([reset_op]):
         self._initializer = self._input_iterator.make_initializer(
             self._input_dataset)
@@ -137,10 +166,17 @@ class _PrefetchToDeviceIterator(object):
     if self._get_next_call_count > iterator_ops.GET_NEXT_CALL_WARNING_THRESHOLD:
       warnings.warn(iterator_ops.GET_NEXT_CALL_WARNING_MESSAGE)
 
-    flat_ret = gen_dataset_ops.function_buffering_resource_get_next(
-        self._buffering_resource,
-        output_types=nest.flatten(sparse.as_dense_types(
-            self.output_types, self.output_classes)), name=name)
+    if self._use_device_prefetch:
+      flat_ret = core_gen_dataset_ops.device_prefetch_iterator_get_next(
+          self._buffering_resource,
+          output_types=self._flat_output_types,
+          output_shapes=self._flat_output_shapes,
+          name=name)
+    else:
+      flat_ret = gen_dataset_ops.function_buffering_resource_get_next(
+          self._buffering_resource,
+          output_types=self._flat_output_types,
+          name=name)
 
     ret = sparse.deserialize_sparse_tensors(
         nest.pack_sequence_as(self.output_types, flat_ret),
@@ -323,3 +359,118 @@ def prefetch_to_device(device, buffer_size=None):
     return _PrefetchToDeviceDataset(dataset, device, buffer_size)
 
   return _apply_fn
+
+
+class _WorkerDataset(dataset_ops.Dataset):
+  """A `Dataset` that reads the elements of datasets running on workers."""
+
+  def __init__(self, dataset_fn, worker_devices, buffer_size):
+    super(_WorkerDataset, self).__init__()
+    self._worker_devices = list(worker_devices)
+    if not self._worker_devices:
+      raise ValueError("`worker_devices` must contain at least one device.")
+    self._buffer_size = ops.convert_to_tensor(
+        buffer_size if buffer_size is not None else 1,
+        dtype=dtypes.int64,
+        name="buffer_size")
+    num_workers = len(self._worker_devices)
+    self._datasets = [
+        dataset_fn(i, num_workers) for i in range(num_workers)
+    ]
+    for dataset in self._datasets[1:]:
+      if (dataset.output_types != self._datasets[0].output_types or
+          dataset.output_classes != self._datasets[0].output_classes):
+        raise TypeError("The datasets of all workers must have the same type.")
+
+  def _as_variant_tensor(self):
+    iterator_handles = []
+    for device, dataset in zip(self._worker_devices, self._datasets):
+      # The input pipeline of each worker, and its iterator, run on the device
+      # of the worker.
+      with ops.device(device):
+        iterator_handles.append(
+            dataset.make_one_shot_iterator().string_handle())
+
+    @function.Defun(dtypes.string)
+    def _remote_fn(handle):
+      """Gets the next element of the iterator of a worker."""
+      remote_iterator = iterator_ops.Iterator.from_string_handle(
+          handle, self.output_types, self.output_shapes, self.output_classes)
+      ret = remote_iterator.get_next()
+      return nest.flatten(sparse.serialize_sparse_tensors(ret))
+
+    return gen_dataset_ops.worker_dataset(
+        iterator_handles,
+        self._worker_devices,
+        self._buffer_size,
+        f=_remote_fn,
+        output_types=nest.flatten(
+            sparse.as_dense_types(self.output_types, self.output_classes)),
+        output_shapes=nest.flatten(
+            sparse.as_dense_shapes(self.output_shapes, self.output_classes)))
+
+  @property
+  def output_classes(self):
+    return self._datasets[0].output_classes
+
+  @property
+  def output_shapes(self):
+    ret = self._datasets[0].output_shapes
+    for dataset in self._datasets[1:]:
+      ret = nest.pack_sequence_as(ret, [
+          ts1.most_specific_compatible_shape(ts2) for (ts1, ts2) in zip(
+              nest.flatten(ret), nest.flatten(dataset.output_shapes))
+      ])
+    return ret
+
+  @property
+  def output_types(self):
+    return self._datasets[0].output_types
+
+
+def read_from_workers(dataset_fn, worker_devices, buffer_size=None):
+  """Creates a dataset whose input pipeline runs on other tasks.
+
+  `dataset_fn(worker_index, num_workers)` is called for each device in
+  `worker_devices` to build the input pipeline of that worker, which typically
+  reads and preprocesses the `worker_index`-th shard of the input (e.g. with
+  @{tf.data.Dataset.shard}). Each pipeline runs on its device, so that the
+  preprocessing of a job can be spread over the CPUs of separate tasks of a
+  cluster (e.g. `"/job:input/task:3/cpu:0"`), rather than competing with the
+  training step for the resources of its host. The produced elements are
+  transferred to the device of the returned dataset, and interleaved in a
+  round-robin order.
+
+  For example:
+
+  ```python
+  def dataset_fn(worker_index, num_workers):
+    return (tf.data.TFRecordDataset(filenames)
+            .shard(num_workers, worker_index)
+            .map(parse_and_augment, num_parallel_calls=8)
+            .batch(32))
+
+  dataset = tf.contrib.data.read_from_workers(
+      dataset_fn, ["/job:input/task:%d/cpu:0" % i for i in range(4)])
+  ```
+
+  NOTE: The iterators of the workers are created along with the returned
+  dataset's iterator, and are not re-initialized with it.
+
+  Args:
+    dataset_fn: A function mapping a worker index and the number of workers to
+      a @{tf.data.Dataset}. The datasets of all workers must have the same
+      type.
+    worker_devices: A list of strings. The devices on which the input pipelines
+      of the workers run.
+    buffer_size: (Optional.) A `tf.int64` scalar `tf.Tensor`, representing the
+      maximum number of elements buffered for each worker. Defaults to 1.
+
+  Returns:
+    A @{tf.data.Dataset}.
+
+  Raises:
+    TypeError: If the datasets of the workers have different types.
+    ValueError: If `worker_devices` is empty.
+  """
+  return _WorkerDataset(dataset_fn, worker_devices, buffer_size)
@@ -30,11 +30,14 @@ from tensorflow.python.data.ops import dataset_ops
 from tensorflow.python.data.ops import readers as core_readers
 from tensorflow.python.data.util import convert
 from tensorflow.python.data.util import nest
+from tensorflow.python.data.util import sparse
 from tensorflow.python.framework import constant_op
 from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import ops
+from tensorflow.python.framework import sparse_tensor
 from tensorflow.python.framework import tensor_shape
 from tensorflow.python.lib.io import file_io
+from tensorflow.python.ops import array_ops
 from tensorflow.python.ops import gen_dataset_ops
 from tensorflow.python.ops import parsing_ops
 from tensorflow.python.platform import gfile
@@ -635,6 +638,144 @@ class CsvDataset(dataset_ops.Dataset):
     return self._output_classes
 
 
+class TFRecordExampleDataset(dataset_ops.Dataset):
+  """A `Dataset` of batches of `Example` records parsed from TFRecord files.
+
+  This is equivalent to
+  `tf.data.TFRecordDataset(filenames).batch(batch_size).map(
+  lambda x: tf.parse_example(x, features))`, but reads and parses the records
+  in a single stage: the records are parsed without going through a string
+  tensor, and the records of a batch are parsed on `num_parallel_calls`
+  threads.
+
+  For example:
+
+  ```python
+  dataset = tf.contrib.data.TFRecordExampleDataset(
+      ["/var/data/file1.tfrecord", "/var/data/file2.tfrecord"],
+      features={
+          "label": tf.FixedLenFeature([], tf.int64),
+          "tokens": tf.VarLenFeature(tf.string),
+      },
+      batch_size=128,
+      num_parallel_calls=4)
+  ```
+  """
+
+  def __init__(self,
+               filenames,
+               features,
+               batch_size,
+               compression_type=None,
+               buffer_size=None,
+               num_parallel_calls=None):
+    """Creates a `TFRecordExampleDataset`.
+
+    Args:
+      filenames: A `tf.string` tensor containing one or more filenames.
+      features: A `dict` mapping feature keys to `FixedLenFeature`,
+        `FixedLenSequenceFeature` or `VarLenFeature` values, as the `features`
+        argument of `tf.parse_example`.
+      batch_size: A `tf.int64` scalar `tf.Tensor`, representing the number of
+        records to parse into each element. The last element may be smaller.
+      compression_type: (Optional.) A `tf.string` scalar evaluating to one of
+        `""` (no compression), `"ZLIB"`, or `"GZIP"`.
+      buffer_size: (Optional.) A `tf.int64` scalar representing the number of
+        bytes in the read buffer. Defaults to 4MB.
+      num_parallel_calls: (Optional.) A `tf.int64` scalar representing the
+        number of threads on which the records of a batch are parsed. Defaults
+        to 1.
+
+    Raises:
+      ValueError: If `features` is empty or holds an unsupported feature type.
+    """
+    super(TFRecordExampleDataset, self).__init__()
+    if not features:
+      raise ValueError("Missing: features was %s." % features)
+    self._filenames = ops.convert_to_tensor(
+        filenames, dtype=dtypes.string, name="filenames")
+    self._compression_type = convert.optional_param_to_tensor(
+        "compression_type",
+        compression_type,
+        argument_default="",
+        argument_dtype=dtypes.string)
+    self._buffer_size = convert.optional_param_to_tensor(
+        "buffer_size", buffer_size, _DEFAULT_READER_BUFFER_SIZE_BYTES)
+    self._batch_size = ops.convert_to_tensor(
+        batch_size, dtype=dtypes.int64, name="batch_size")
+    self._num_parallel_calls = convert.optional_param_to_tensor(
+        "num_parallel_calls", num_parallel_calls, argument_default=1)
+
+    # pylint: disable=protected-access
+    (self._sparse_keys, self._sparse_types, self._dense_keys,
+     self._dense_types, dense_defaults,
+     dense_shapes) = parsing_ops._features_to_raw_params(
+         features, [
+             parsing_ops.VarLenFeature, parsing_ops.FixedLenFeature,
+             parsing_ops.FixedLenSequenceFeature
+         ])
+    # pylint: enable=protected-access
+    self._dense_shapes = [tensor_shape.as_shape(s) for s in dense_shapes]
+    self._dense_defaults = []
+    for key, dtype, shape in zip(self._dense_keys, self._dense_types,
+                                 self._dense_shapes):
+      default_value = dense_defaults.get(key)
+      if shape.ndims and shape[0].value is None:
+        # A variable length feature is padded with a scalar.
+        if default_value is None:
+          default_value = "" if dtype == dtypes.string else 0
+        default_value = array_ops.reshape(
+            ops.convert_to_tensor(default_value, dtype=dtype), [])
+      elif default_value is None:
+        default_value = constant_op.constant([], dtype=dtype)
+      else:
+        default_value = array_ops.reshape(
+            ops.convert_to_tensor(default_value, dtype=dtype), shape)
+      self._dense_defaults.append(default_value)
+
+    self._output_classes = {}
+    self._output_types = {}
+    self._output_shapes = {}
+    for key, dtype, shape in zip(self._dense_keys, self._dense_types,
+                                 self._dense_shapes):
+      self._output_classes[key] = ops.Tensor
+      self._output_types[key] = dtype
+      self._output_shapes[key] = tensor_shape.vector(None).concatenate(shape)
+    for key, dtype in zip(self._sparse_keys, self._sparse_types):
+      self._output_classes[key] = sparse_tensor.SparseTensor
+      self._output_types[key] = dtype
+      self._output_shapes[key] = tensor_shape.matrix(None, None)
+
+  def _as_variant_tensor(self):
+    return gen_dataset_ops.tf_record_example_dataset(
+        self._filenames,
+        self._compression_type,
+        self._buffer_size,
+        self._batch_size,
+        self._num_parallel_calls,
+        self._dense_defaults,
+        sparse_keys=self._sparse_keys,
+        dense_keys=self._dense_keys,
+        sparse_types=self._sparse_types,
+        dense_shapes=self._dense_shapes,
+        output_types=nest.flatten(
+            sparse.as_dense_types(self.output_types, self.output_classes)),
+        output_shapes=nest.flatten(
+            sparse.as_dense_shapes(self.output_shapes, self.output_classes)))
+
+  @property
+  def output_classes(self):
+    return self._output_classes
+
+  @property
+  def output_shapes(self):
+    return self._output_shapes
+
+  @property
+  def output_types(self):
+    return self._output_types
+
+
 def make_batched_features_dataset(file_pattern,
                                   batch_size,
                                   features,
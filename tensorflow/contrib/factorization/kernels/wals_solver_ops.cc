@@ -23,6 +23,7 @@
 // This is only used for std::this_thread::get_id()
 #include <thread>  // NOLINT
 
+#include "third_party/eigen3/Eigen/Cholesky"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -32,6 +33,7 @@
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 using tensorflow::DEVICE_CPU;
 using tensorflow::DT_BOOL;
@@ -58,6 +60,75 @@ typedef Eigen::Map<
     const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor>>
     ConstEigenMatrixFloatMap;
 
+namespace {
+
+// Batch the rank-one updates into a rank-k update to lower memory traffic
+constexpr int kMaxBatchSize = 128;
+
+// Validates the inputs the WALS ops share.
+Status ValidateWALSInputs(OpKernelContext* context) {
+  if (!TensorShapeUtils::IsMatrix(context->input(0).shape())) {
+    return InvalidArgument("Input factors should be a matrix.");
+  }
+  if (!TensorShapeUtils::IsVector(context->input(1).shape())) {
+    return InvalidArgument("Input factor_weights should be a vector.");
+  }
+  if (!TensorShapeUtils::IsScalar(context->input(2).shape())) {
+    return InvalidArgument("Input unobserved_weights should be a scalar.");
+  }
+  if (!TensorShapeUtils::IsVector(context->input(3).shape())) {
+    return InvalidArgument("Input input_weights should be a vector.");
+  }
+  if (!TensorShapeUtils::IsMatrix(context->input(4).shape())) {
+    return InvalidArgument("Input input_indices should be a matrix.");
+  }
+  if (!TensorShapeUtils::IsVector(context->input(5).shape())) {
+    return InvalidArgument("Input input_values should be a vector");
+  }
+  if (!TensorShapeUtils::IsScalar(context->input(6).shape())) {
+    return InvalidArgument("Input input_block_size should be a scalar.");
+  }
+  if (!TensorShapeUtils::IsScalar(context->input(7).shape())) {
+    return InvalidArgument("Input input_is_transpose should be a scalar.");
+  }
+  return Status::OK();
+}
+
+// Computes a permutation "perm" of the non-zero elements such that
+// get_input_index(perm[i]) is sorted, and the [start, end) ranges of "perm"
+// with identical input index. These are the units of work that can be
+// processed in parallel without locking.
+template <typename GetInputIndex>
+void GroupByInputIndex(int64 num_nonzero_elements,
+                       const GetInputIndex& get_input_index,
+                       std::vector<int64>* perm,
+                       std::vector<std::pair<int64, int64>>* runs) {
+  // TODO(rmlarsen): In principle, we should be using the SparseTensor class
+  // and machinery for iterating over groups, but the fact that class
+  // SparseTensor makes a complete copy of the matrix makes me reluctant to
+  // use it.
+  perm->resize(num_nonzero_elements);
+  std::iota(perm->begin(), perm->end(), 0);
+  // Use stable_sort to preserve spatial locality.
+  std::stable_sort(perm->begin(), perm->end(),
+                   [&get_input_index](int64 i, int64 j) {
+                     return get_input_index(i) < get_input_index(j);
+                   });
+
+  int64 start = 0;
+  int64 end = 0;
+  while (end < num_nonzero_elements) {
+    start = end;
+    while (end < num_nonzero_elements &&
+           get_input_index((*perm)[start]) == get_input_index((*perm)[end])) {
+      ++end;
+    }
+    runs->emplace_back(start, end);
+  }
+}
+
+}  // namespace
+
 class WALSComputePartialLhsAndRhsOp : public OpKernel {
  public:
   explicit WALSComputePartialLhsAndRhsOp(OpKernelConstruction* context)
@@ -77,25 +148,7 @@ class WALSComputePartialLhsAndRhsOp : public OpKernel {
     const Tensor& input_values = context->input(5);
     const Tensor& input_block_size = context->input(6);
     const Tensor& input_is_transpose = context->input(7);
-
-    OP_REQUIRES(context, TensorShapeUtils::IsMatrix(factors.shape()),
-                InvalidArgument("Input factors should be a matrix."));
-    OP_REQUIRES(context, TensorShapeUtils::IsVector(factor_weights.shape()),
-                InvalidArgument("Input factor_weights should be a vector."));
-    OP_REQUIRES(
-        context, TensorShapeUtils::IsScalar(unobserved_weights.shape()),
-        InvalidArgument("Input unobserved_weights should be a scalar."));
-    OP_REQUIRES(context, TensorShapeUtils::IsVector(input_weights.shape()),
-                InvalidArgument("Input input_weights should be a vector."));
-    OP_REQUIRES(context, TensorShapeUtils::IsMatrix(input_indices.shape()),
-                InvalidArgument("Input input_indices should be a matrix."));
-    OP_REQUIRES(context, TensorShapeUtils::IsVector(input_values.shape()),
-                InvalidArgument("Input input_values should be a vector"));
-    OP_REQUIRES(context, TensorShapeUtils::IsScalar(input_block_size.shape()),
-                InvalidArgument("Input input_block_size should be a scalar."));
-    OP_REQUIRES(
-        context, TensorShapeUtils::IsScalar(input_is_transpose.shape()),
-        InvalidArgument("Input input_is_transpose should be a scalar."));
+    OP_REQUIRES_OK(context, ValidateWALSInputs(context));
 
     const int64 factor_dim = factors.dim_size(1);
     const int64 factors_size = factors.dim_size(0);
@@ -134,45 +187,14 @@ class WALSComputePartialLhsAndRhsOp : public OpKernel {
       return is_transpose ? indices_mat(0, i) : indices_mat(1, i);
     };
 
-    // TODO(rmlarsen): In principle, we should be using the SparseTensor class
-    // and machinery for iterating over groups, but the fact that class
-    // SparseTensor makes a complete copy of the matrix makes me reluctant to
-    // use it.
-    std::vector<int64> perm(num_nonzero_elements);
-    std::iota(perm.begin(), perm.end(), 0);
-
     typedef std::pair<int64, int64> Shard;
+    std::vector<int64> perm;
     std::vector<Shard> shards;
     auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
-    int64 shard_total = 0;
-    // Compute a permutation such that get_input_index(perm[i]) is sorted, use
-    // stable_sort to preserve spatial locality.
-    std::stable_sort(perm.begin(), perm.end(),
-                     [&get_input_index](int64 i, int64 j) {
-                       return get_input_index(i) < get_input_index(j);
-                     });
-
-    // Compute the start and end of runs with identical input_index.
-    // These are the shards of work that can be processed in parallel
-    // without locking.
-    int64 start = 0;
-    int64 end = 0;
-    while (end < num_nonzero_elements) {
-      start = end;
-      while (end < num_nonzero_elements &&
-             get_input_index(perm[start]) == get_input_index(perm[end])) {
-        ++end;
-      }
-      shards.emplace_back(start, end);
-      shard_total += end - start;
-    }
-    CHECK_EQ(shard_total, num_nonzero_elements);
+    GroupByInputIndex(num_nonzero_elements, get_input_index, &perm, &shards);
     CHECK_LE(shards.size(), num_nonzero_elements);
     CHECK_GT(shards.size(), 0);
 
-    // Batch the rank-one updates into a rank-k update to lower memory traffic
-    const int kMaxBatchSize = 128;
-
     // Since we do not have an easy way of generating thread id's within the
     // range [0,num_threads), we can instead call out to an std::unordered_map
     // of matrices and initialize the matrix on the first call.
@@ -263,4 +285,160 @@ class WALSComputePartialLhsAndRhsOp : public OpKernel {
 REGISTER_KERNEL_BUILDER(Name("WALSComputePartialLhsAndRhs").Device(DEVICE_CPU),
                         WALSComputePartialLhsAndRhsOp);
 
+// Fuses WALSComputePartialLhsAndRhs with the solve of the normal equations.
+// Each row's left-hand side lives in a per-shard k x k buffer while it is
+// accumulated and factored, instead of in a block_size x k x k output that is
+// written, then read again by the solve.
+class WALSSolveOp : public OpKernel {
+ public:
+  typedef Eigen::Map<const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic,
+                                         Eigen::RowMajor>>
+      ConstEigenRowMajorMatrixFloatMap;
+
+  explicit WALSSolveOp(OpKernelConstruction* context) : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->MatchSignature(
+                                {DT_FLOAT, DT_FLOAT, DT_FLOAT, DT_FLOAT,
+                                 DT_INT64, DT_FLOAT, DT_INT64, DT_BOOL,
+                                 DT_FLOAT},
+                                {DT_FLOAT}));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    OP_REQUIRES_OK(context, ValidateWALSInputs(context));
+    const Tensor& factors = context->input(0);
+    const Tensor& input_indices = context->input(4);
+    const Tensor& input_values = context->input(5);
+    const Tensor& lhs = context->input(8);
+
+    const int64 factor_dim = factors.dim_size(1);
+    const int64 factors_size = factors.dim_size(0);
+    const int64 num_nonzero_elements = input_indices.dim_size(0);
+    const int64 block_size = context->input(6).scalar<int64>()();
+    const bool is_transpose = context->input(7).scalar<bool>()();
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsMatrix(lhs.shape()) &&
+                    lhs.dim_size(0) == factor_dim &&
+                    lhs.dim_size(1) == factor_dim,
+                InvalidArgument("Input lhs should be a ", factor_dim, " x ",
+                                factor_dim, " matrix, got shape ",
+                                lhs.shape().DebugString()));
+    OP_REQUIRES(context,
+                input_indices.dim_size(1) == 2 &&
+                    input_values.dim_size(0) == num_nonzero_elements,
+                InvalidArgument("Input input_indices and input_values should "
+                                "have shapes [nnz, 2] and [nnz], got ",
+                                input_indices.shape().DebugString(), " and ",
+                                input_values.shape().DebugString()));
+    OP_REQUIRES(
+        context, block_size >= 0,
+        InvalidArgument("Input input_block_size should be non-negative."));
+
+    const auto& factor_weights_vec = context->input(1).vec<float>();
+    const auto& input_weights_vec = context->input(3).vec<float>();
+    const float w_0 = context->input(2).scalar<float>()();
+    const auto& input_values_vec = input_values.vec<float>();
+    ConstEigenMatrixFloatMap factors_mat(factors.matrix<float>().data(),
+                                         factor_dim, factors_size);
+    ConstEigenMatrixInt64Map indices_mat(input_indices.matrix<int64>().data(),
+                                         2, num_nonzero_elements);
+    ConstEigenRowMajorMatrixFloatMap lhs_mat(lhs.matrix<float>().data(),
+                                             factor_dim, factor_dim);
+
+    auto get_input_index = [is_transpose, &indices_mat](int64 i) {
+      return is_transpose ? indices_mat(1, i) : indices_mat(0, i);
+    };
+    auto get_factor_index = [is_transpose, &indices_mat](int64 i) {
+      return is_transpose ? indices_mat(0, i) : indices_mat(1, i);
+    };
+    for (int64 i = 0; i < num_nonzero_elements; ++i) {
+      const int64 input_index = get_input_index(i);
+      const int64 factor_index = get_factor_index(i);
+      OP_REQUIRES(
+          context,
+          input_index >= 0 && input_index < block_size &&
+              input_index < input_weights_vec.size() && factor_index >= 0 &&
+              factor_index < factors_size &&
+              factor_index < factor_weights_vec.size(),
+          InvalidArgument("Input input_indices has out of range index ",
+                          input_index, ", ", factor_index, " at ", i));
+    }
+
+    Tensor* solution_tensor;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                0, TensorShape({block_size, factor_dim}),
+                                &solution_tensor));
+    // Rows without non-zero elements have a zero right-hand side.
+    solution_tensor->flat<float>().setZero();
+    if (num_nonzero_elements == 0) return;
+
+    std::vector<int64> perm;
+    std::vector<std::pair<int64, int64>> runs;
+    GroupByInputIndex(num_nonzero_elements, get_input_index, &perm, &runs);
+
+    mutex mu;
+    Status status;
+    auto work = [&](int64 start, int64 limit) {
+      Eigen::MatrixXf row_lhs(factor_dim, factor_dim);
+      Eigen::VectorXf row_rhs(factor_dim);
+      Eigen::MatrixXf factor_batch(factor_dim, kMaxBatchSize);
+      // Eigen factors large matrices with a blocked algorithm.
+      Eigen::LLT<Eigen::MatrixXf, Eigen::Lower> llt(factor_dim);
+      for (int64 r = start; r < limit; ++r) {
+        const int64 input_index = get_input_index(perm[runs[r].first]);
+        // Only the lower triangle is accumulated and factored.
+        row_lhs.triangularView<Eigen::Lower>() =
+            lhs_mat.triangularView<Eigen::Lower>();
+        row_rhs.setZero();
+        auto row_lhs_symm = row_lhs.selfadjointView<Eigen::Lower>();
+        int num_batched = 0;
+        for (int64 p = runs[r].first; p < runs[r].second; ++p) {
+          const int64 i = perm[p];
+          const int64 factor_index = get_factor_index(i);
+          const float weight =
+              input_weights_vec(input_index) * factor_weights_vec(factor_index);
+          if (weight < 0) {
+            mutex_lock l(mu);
+            status.Update(InvalidArgument("Negative weight ", weight,
+                                          " for input row ", input_index));
+            return;
+          }
+          factor_batch.col(num_batched) =
+              factors_mat.col(factor_index) * std::sqrt(weight);
+          ++num_batched;
+          if (num_batched == kMaxBatchSize) {
+            row_lhs_symm.rankUpdate(factor_batch);
+            num_batched = 0;
+          }
+          row_rhs += input_values_vec(i) * (w_0 + weight) *
+                     factors_mat.col(factor_index);
+        }
+        if (num_batched != 0) {
+          row_lhs_symm.rankUpdate(factor_batch.leftCols(num_batched));
+        }
+
+        llt.compute(row_lhs);
+        if (llt.info() != Eigen::Success) {
+          mutex_lock l(mu);
+          status.Update(InvalidArgument(
+              "The normal equations of input row ", input_index,
+              " are not positive definite."));
+          return;
+        }
+        Eigen::Map<Eigen::VectorXf>(
+            solution_tensor->flat<float>().data() + input_index * factor_dim,
+            factor_dim) = llt.solve(row_rhs);
+      }
+    };
+    const int64 cost_per_run =
+        (num_nonzero_elements / runs.size() + factor_dim) * factor_dim *
+        factor_dim;
+    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+    tensorflow::Shard(worker_threads.num_threads, worker_threads.workers,
+                      runs.size(), cost_per_run, work);
+    OP_REQUIRES_OK(context, status);
+  }
+};
+
+REGISTER_KERNEL_BUILDER(Name("WALSSolve").Device(DEVICE_CPU), WALSSolveOp);
+
 }  // namespace tensorflow
@@ -45,6 +45,42 @@ partial_lhs: 3-D tensor with size input_block_size x k x k.
 partial_rhs: Matrix with size input_block_size x k.
 )");
 
+REGISTER_OP("WALSSolve")
+    .Input("factors: float32")
+    .Input("factor_weights: float32")
+    .Input("unobserved_weights: float32")
+    .Input("input_weights: float32")
+    .Input("input_indices: int64")
+    .Input("input_values: float32")
+    .Input("input_block_size: int64")
+    .Input("input_is_transpose: bool")
+    .Input("lhs: float32")
+    .Output("solution: float32")
+    .SetShapeFn(shape_inference::UnknownShape)
+    .Doc(R"(
+Computes and solves the normal equations of a WALS update.
+
+For each row of the input, adds its partial left-hand side, as computed by
+WALSComputePartialLhsAndRhs, to `lhs` and solves the resulting normal
+equations for its right-hand side. This is equivalent to solving the outputs
+of WALSComputePartialLhsAndRhs plus `lhs` with MatrixSolve, but the partial
+left-hand sides are never materialized: each row is accumulated and solved
+with a Cholesky decomposition while it is in cache, in parallel over the rows.
+
+factors: Matrix of size m * k.
+factor_weights: Vector of size m. Corresponds to column weights
+unobserved_weights: Scalar. Weight for unobserved input entries.
+input_weights: Vector of size n. Corresponds to row weights.
+input_indices: Indices for the input SparseTensor.
+input_values: Values for the input SparseTensor.
+input_block_size: Scalar. Number of rows spanned by input.
+input_is_transpose: If true, logically transposes the input for processing.
+lhs: Matrix of size k x k. The part of the left-hand side shared by all the
+  rows, such as the weighted gramian plus regularization. It must be
+  symmetric; only its lower triangle is read.
+solution: Matrix with size input_block_size x k.
+)");
+
 REGISTER_OP("MaskedMatmul")
     .Input("a: float32")
     .Input("b: float32")
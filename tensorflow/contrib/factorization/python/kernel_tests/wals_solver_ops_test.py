@@ -79,5 +79,38 @@ class WalsSolverOpsTest(test.TestCase):
                                               [0.492800, 0.563200, 0.633600]])
 
 
+  def testWalsSolve(self):
+    sparse_block = SparseBlock3x3()
+    shared_lhs = np.array([[1.0, 0.1, 0.2], [0.1, 2.0, 0.3],
+                           [0.2, 0.3, 3.0]]).astype(np.float32)
+    for transpose in [False, True]:
+      with self.test_session():
+        factors = self._row_factors if transpose else self._column_factors
+        factor_weights = (
+            self._row_weights if transpose else self._column_weights)
+        input_weights = (
+            self._column_weights if transpose else self._row_weights)
+        block_size = sparse_block.dense_shape[1 if transpose else 0]
+        args = (factors, factor_weights, self._unobserved_weights,
+                input_weights, sparse_block.indices, sparse_block.values,
+                block_size, transpose)
+        partial_lhs, rhs = (
+            gen_factorization_ops.wals_compute_partial_lhs_and_rhs(*args))
+        solution = gen_factorization_ops.wals_solve(*(args + (shared_lhs,)))
+        expected = np.linalg.solve(shared_lhs + partial_lhs.eval(),
+                                   rhs.eval()[:, :, np.newaxis])[:, :, 0]
+        self.assertAllClose(expected, solution.eval(), rtol=1e-4, atol=1e-5)
+
+  def testWalsSolveRejectsIndefiniteEquations(self):
+    sparse_block = SparseBlock3x3()
+    with self.test_session():
+      solution = gen_factorization_ops.wals_solve(
+          self._column_factors, self._column_weights, self._unobserved_weights,
+          self._row_weights, sparse_block.indices, sparse_block.values,
+          sparse_block.dense_shape[0], False, -10 * np.eye(3, dtype=np.float32))
+      with self.assertRaisesOpError("not positive definite"):
+        solution.eval()
+
+
 if __name__ == "__main__":
   test.main()
@@ -37,6 +37,9 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/gpu/gpu_util.h"
 #include "tensorflow/core/common_runtime/gpu/process_state.h"
 #endif  // GOOGLE_CUDA
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/common_runtime/sycl/sycl_device.h"
+#endif  // TENSORFLOW_USE_SYCL
 #include "tensorflow/core/framework/allocator_registry.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/macros.h"
@@ -110,6 +113,21 @@ void MRDeleter(ibv_mr* mr) {
   }
 }
 
+#ifdef TENSORFLOW_USE_SYCL
+// SYCL buffers can't be registered as memory regions, so tensors in SYCL
+// device memory are staged in SYCL host memory, which is.
+bool InSYCLDeviceMemory(Device* device, bool on_host) {
+  return !on_host && device->attributes().device_type() == DEVICE_SYCL;
+}
+
+Allocator* SYCLStagingAllocator(Device* device) {
+  AllocatorAttributes attr;
+  attr.set_on_host(true);
+  attr.set_gpu_compatible(true);
+  return device->GetAllocator(attr);
+}
+#endif  // TENSORFLOW_USE_SYCL
+
 using RdmaEndpointPtr = std::unique_ptr<rdma_cm_id, decltype(&EndpointDeleter)>;
 
 using MemoryRegionPtr = std::unique_ptr<ibv_mr, decltype(&MRDeleter)>;
@@ -277,6 +295,9 @@ Status GdrMemoryManager::Init() {
     ProcessState::singleton()->GetCUDAHostAllocator(0),
     ProcessState::singleton()->GetCPUAllocator(0),
 #endif  // GOOGLE_CUDA
+#ifdef TENSORFLOW_USE_SYCL
+    GSYCLInterface::instance()->GetSYCLHostAllocator(),
+#endif  // TENSORFLOW_USE_SYCL
     cpu_allocator(),
   };
 
@@ -426,6 +447,28 @@ void GdrMemoryManager::TransportOptionsFromTensor(
     return;
   }
 
+#ifdef TENSORFLOW_USE_SYCL
+  if (InSYCLDeviceMemory(device, on_host)) {
+    Tensor* host_copy = new Tensor(SYCLStagingAllocator(device),
+                                   tensor.dtype(), tensor.shape());
+    device_context->CopyDeviceTensorToCPU(
+        &tensor, "" /*tensor_name*/, device, host_copy,
+        [this, done, host_copy, mutable_transport_options, device,
+         device_context](const Status& s) {
+          if (s.ok()) {
+            // Keeps a reference to the buffer of host_copy.
+            TransportOptionsFromTensor(mutable_transport_options, *host_copy,
+                                       device, device_context,
+                                       true /*on_host*/, done);
+          } else {
+            done(s);
+          }
+          delete host_copy;
+        });
+    return;
+  }
+#endif  // TENSORFLOW_USE_SYCL
+
   ibv_mr* mr = FindMemoryRegion(addr, length);
 
 #if GOOGLE_CUDA
@@ -530,6 +573,16 @@ void GdrMemoryManager::TensorFromTransportOptions(
   ibv_mr* mr = FindMemoryRegion(addr, length);
 
   Tensor host_copy;
+#ifdef TENSORFLOW_USE_SYCL
+  if (InSYCLDeviceMemory(device, on_host)) {
+    host_copy =
+        Tensor(SYCLStagingAllocator(device), tensor->dtype(), tensor->shape());
+    buffer = DMAHelper::buffer(&host_copy);
+    addr = buffer->data();
+    length = buffer->size();
+    mr = FindMemoryRegion(addr, length);
+  }
+#endif  // TENSORFLOW_USE_SYCL
 #if GOOGLE_CUDA
   if (mr == nullptr && !on_host) {
     Allocator* alloc = ProcessState::singleton()->GetCUDAHostAllocator(0);
@@ -591,6 +644,19 @@ void GdrMemoryManager::TensorFromTransportOptions(
     return;
   }
 
+#ifdef TENSORFLOW_USE_SYCL
+  if (host_copy.NumElements() > 0) {
+    Tensor* ref = new Tensor;
+    std::swap(host_copy, *ref);
+    device_context->CopyCPUTensorToDevice(ref, device, tensor,
+                                          [ref, done](const Status& s) {
+                                            done(s);
+                                            delete ref;
+                                          });
+    return;
+  }
+#endif  // TENSORFLOW_USE_SYCL
+
 #if GOOGLE_CUDA
   if (host_copy.NumElements() > 0) {
     uint64_t checksum = 0;
@@ -15,6 +15,7 @@
 """Kafka Dataset.
 
 @@KafkaDataset
+@@parallel_kafka_dataset
 """
 
 from __future__ import absolute_import
@@ -22,11 +23,13 @@ from __future__ import division
 from __future__ import print_function
 
 from tensorflow.contrib.kafka.python.ops.kafka_dataset_ops import KafkaDataset
+from tensorflow.contrib.kafka.python.ops.kafka_dataset_ops import parallel_kafka_dataset
 
 from tensorflow.python.util.all_util import remove_undocumented
 
 _allowed_symbols = [
     "KafkaDataset",
+    "parallel_kafka_dataset",
 ]
 
 remove_undocumented(__name__)
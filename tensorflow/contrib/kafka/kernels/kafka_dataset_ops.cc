@@ -48,7 +48,21 @@ class KafkaDatasetOp : public DatasetOpKernel {
     OP_REQUIRES(ctx, (timeout > 0),
                 errors::InvalidArgument(
                     "Timeout value should be large than 0, got ", timeout));
-    *output = new Dataset(ctx, std::move(topics), servers, group, eof, timeout);
+
+    // KafkaBatchDataset emits vectors of up to `batch_size` messages.
+    int64 batch_size = 0;
+    int64 max_batch_bytes = -1;
+    if (type_string() == "KafkaBatchDataset") {
+      OP_REQUIRES_OK(
+          ctx, ParseScalarArgument<int64>(ctx, "batch_size", &batch_size));
+      OP_REQUIRES(ctx, batch_size > 0,
+                  errors::InvalidArgument(
+                      "Batch size should be larger than 0, got ", batch_size));
+      OP_REQUIRES_OK(ctx, ParseScalarArgument<int64>(ctx, "max_batch_bytes",
+                                                     &max_batch_bytes));
+    }
+    *output = new Dataset(ctx, std::move(topics), servers, group, eof, timeout,
+                          batch_size, max_batch_bytes);
   }
 
  private:
@@ -56,13 +70,16 @@ class KafkaDatasetOp : public DatasetOpKernel {
    public:
     Dataset(OpKernelContext* ctx, std::vector<string> topics,
             const string& servers, const string& group, const bool eof,
-            const int64 timeout)
+            const int64 timeout, const int64 batch_size,
+            const int64 max_batch_bytes)
         : GraphDatasetBase(ctx),
           topics_(std::move(topics)),
           servers_(servers),
           group_(group),
           eof_(eof),
-          timeout_(timeout) {}
+          timeout_(timeout),
+          batch_size_(batch_size),
+          max_batch_bytes_(max_batch_bytes) {}
 
     std::unique_ptr<IteratorBase> MakeIteratorInternal(
         const string& prefix) const override {
@@ -78,7 +95,9 @@ class KafkaDatasetOp : public DatasetOpKernel {
     const std::vector<PartialTensorShape>& output_shapes() const override {
       static std::vector<PartialTensorShape>* shapes =
           new std::vector<PartialTensorShape>({{}});
-      return *shapes;
+      static std::vector<PartialTensorShape>* batch_shapes =
+          new std::vector<PartialTensorShape>({{-1}});
+      return batch_size_ > 0 ? *batch_shapes : *shapes;
     }
 
     string DebugString() const override { return "KafkaDatasetOp::Dataset"; }
@@ -96,6 +115,18 @@ class KafkaDatasetOp : public DatasetOpKernel {
       TF_RETURN_IF_ERROR(b->AddScalar(eof_, &eof));
       Node* timeout = nullptr;
       TF_RETURN_IF_ERROR(b->AddScalar(timeout_, &timeout));
+      if (batch_size_ > 0) {
+        Node* batch_size = nullptr;
+        TF_RETURN_IF_ERROR(b->AddScalar(batch_size_, &batch_size));
+        Node* max_batch_bytes = nullptr;
+        TF_RETURN_IF_ERROR(b->AddScalar(max_batch_bytes_, &max_batch_bytes));
+        TF_RETURN_IF_ERROR(b->AddDataset(
+            this,
+            {topics, servers, group, eof, timeout, batch_size,
+             max_batch_bytes},
+            output));
+        return Status::OK();
+      }
       TF_RETURN_IF_ERROR(
           b->AddDataset(this, {topics, servers, group, eof, timeout}, output));
       return Status::OK();
@@ -111,6 +142,11 @@ class KafkaDatasetOp : public DatasetOpKernel {
                              std::vector<Tensor>* out_tensors,
                              bool* end_of_sequence) override {
         mutex_lock l(mu_);
+        const bool batched = dataset()->batch_size_ > 0;
+        // The messages of the current batch and their total size. A batch
+        // ends early at the end of a topic and does not span topics.
+        std::vector<std::unique_ptr<RdKafka::Message>> messages;
+        int64 batch_bytes = 0;
         do {
           // We are currently processing a topic, so try to read the next line.
           if (consumer_.get()) {
@@ -120,18 +156,29 @@ class KafkaDatasetOp : public DatasetOpKernel {
                 // EOF current topic
                 break;
               }
+              if (batched && BatchFull(messages.size(), batch_bytes)) {
+                EmitBatch(messages, out_tensors);
+                *end_of_sequence = false;
+                return Status::OK();
+              }
               std::unique_ptr<RdKafka::Message> message(
                   consumer_->consume(dataset()->timeout_));
               if (message->err() == RdKafka::ERR_NO_ERROR) {
-                // Produce the line as output.
+                // Sync offset
+                offset_ = message->offset();
+                if (batched) {
+                  batch_bytes += message->len();
+                  messages.push_back(std::move(message));
+                  continue;
+                }
+                // Produce the line as output, copying the payload straight
+                // into the tensor.
                 Tensor line_tensor(cpu_allocator(), DT_STRING, {});
-                line_tensor.scalar<string>()() =
-                    std::string(static_cast<const char*>(message->payload()),
-                                message->len());
+                line_tensor.scalar<string>()().assign(
+                    static_cast<const char*>(message->payload()),
+                    message->len());
                 out_tensors->emplace_back(std::move(line_tensor));
                 *end_of_sequence = false;
-                // Sync offset
-                offset_ = message->offset();
                 return Status::OK();
               }
 
@@ -152,6 +199,11 @@ class KafkaDatasetOp : public DatasetOpKernel {
             // move on to next topic.
             ResetStreamsLocked();
             ++current_topic_index_;
+            if (!messages.empty()) {
+              EmitBatch(messages, out_tensors);
+              *end_of_sequence = false;
+              return Status::OK();
+            }
           }
 
           // Iteration ends when there are no more topic to process.
@@ -207,6 +259,28 @@ class KafkaDatasetOp : public DatasetOpKernel {
       }
 
      private:
+      // Returns whether a batch of `num_messages` messages totalling
+      // `batch_bytes` bytes is complete.
+      bool BatchFull(size_t num_messages, int64 batch_bytes) const {
+        return static_cast<int64>(num_messages) >= dataset()->batch_size_ ||
+               (dataset()->max_batch_bytes_ > 0 && num_messages > 0 &&
+                batch_bytes >= dataset()->max_batch_bytes_);
+      }
+
+      // Copies the payloads of `messages` into a string vector tensor.
+      static void EmitBatch(
+          const std::vector<std::unique_ptr<RdKafka::Message>>& messages,
+          std::vector<Tensor>* out_tensors) {
+        Tensor batch_tensor(cpu_allocator(), DT_STRING,
+                            {static_cast<int64>(messages.size())});
+        auto batch = batch_tensor.vec<string>();
+        for (size_t i = 0; i < messages.size(); ++i) {
+          batch(i).assign(static_cast<const char*>(messages[i]->payload()),
+                          messages[i]->len());
+        }
+        out_tensors->emplace_back(std::move(batch_tensor));
+      }
+
       // Sets up Kafka streams to read from the topic at
       // `current_topic_index_`.
       Status SetupStreamsLocked(Env* env) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
@@ -310,10 +384,14 @@ class KafkaDatasetOp : public DatasetOpKernel {
     const std::string group_;
     const bool eof_;
     const int64 timeout_;
+    const int64 batch_size_;
+    const int64 max_batch_bytes_;
   };
 };
 
 REGISTER_KERNEL_BUILDER(Name("KafkaDataset").Device(DEVICE_CPU),
                         KafkaDatasetOp);
+REGISTER_KERNEL_BUILDER(Name("KafkaBatchDataset").Device(DEVICE_CPU),
+                        KafkaDatasetOp);
 
 }  // namespace tensorflow
@@ -41,4 +41,35 @@ timeout: The timeout value for the Kafka Consumer to wait
   (in millisecond).
 )doc");
 
+REGISTER_OP("KafkaBatchDataset")
+    .Input("topics: string")
+    .Input("servers: string")
+    .Input("group: string")
+    .Input("eof: bool")
+    .Input("timeout: int64")
+    .Input("batch_size: int64")
+    .Input("max_batch_bytes: int64")
+    .Output("handle: variant")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::ScalarShape)
+    .Doc(R"doc(
+Creates a dataset that emits batches of the messages of Kafka topics.
+
+Like `KafkaDataset`, but each element is a vector of up to `batch_size`
+messages consumed in one call. A batch ends early at the end of a
+subscription, and batches do not span subscriptions.
+
+topics: A `tf.string` tensor containing one or more subscriptions,
+  in the format of [topic:partition:offset:length],
+  by default length is -1 for unlimited.
+servers: A list of bootstrap servers.
+group: The consumer group id.
+eof: If True, the kafka reader will stop on EOF.
+timeout: The timeout value for the Kafka Consumer to wait
+  (in millisecond).
+batch_size: The maximum number of messages in a batch.
+max_batch_bytes: If positive, a batch also ends once its messages total at
+  least this many bytes.
+)doc");
+
 }  // namespace tensorflow
@@ -110,6 +110,61 @@ class KafkaDatasetTest(test.TestCase):
         self.assertAllEqual(["D" + str(i + 5) for i in range(5)],
                             sess.run(get_next))
 
+  def testKafkaBatchDataset(self):
+    topics = array_ops.placeholder(dtypes.string, shape=[None])
+    max_batch_bytes = array_ops.placeholder(dtypes.int64, shape=[])
+
+    batch_dataset = kafka_dataset_ops.KafkaDataset(
+        topics, group="test", eof=True, batch_size=3,
+        max_batch_bytes=max_batch_bytes)
+    iterator = batch_dataset.make_initializable_iterator()
+    get_next = iterator.get_next()
+
+    with self.test_session() as sess:
+      # Batches end at the end of each subscription.
+      sess.run(
+          iterator.initializer,
+          feed_dict={
+              topics: ["test:0:0:4", "test:0:5:-1"],
+              max_batch_bytes: -1
+          })
+      self.assertAllEqual(["D0", "D1", "D2"], sess.run(get_next))
+      self.assertAllEqual(["D3", "D4"], sess.run(get_next))
+      self.assertAllEqual(["D5", "D6", "D7"], sess.run(get_next))
+      self.assertAllEqual(["D8", "D9"], sess.run(get_next))
+      with self.assertRaises(errors.OutOfRangeError):
+        sess.run(get_next)
+
+      # Each message is 2 bytes, so a budget of 4 bytes makes pairs.
+      sess.run(
+          iterator.initializer,
+          feed_dict={
+              topics: ["test:0:0:4"],
+              max_batch_bytes: 4
+          })
+      self.assertAllEqual(["D0", "D1"], sess.run(get_next))
+      self.assertAllEqual(["D2", "D3"], sess.run(get_next))
+      self.assertAllEqual(["D4"], sess.run(get_next))
+      with self.assertRaises(errors.OutOfRangeError):
+        sess.run(get_next)
+
+  def testParallelKafkaDataset(self):
+    dataset = kafka_dataset_ops.parallel_kafka_dataset(
+        ["test:0:0:4", "test:0:5:-1"],
+        num_parallel_partitions=2,
+        group="test",
+        eof=True)
+    get_next = dataset.make_one_shot_iterator().get_next()
+
+    with self.test_session() as sess:
+      # The subscriptions are merged round-robin.
+      expected = []
+      for i in range(5):
+        expected.extend(["D" + str(i), "D" + str(i + 5)])
+      self.assertEqual(expected, [sess.run(get_next) for _ in range(10)])
+      with self.assertRaises(errors.OutOfRangeError):
+        sess.run(get_next)
+
 
 if __name__ == "__main__":
   test.main()
@@ -17,6 +17,7 @@ from __future__ import absolute_import
 from __future__ import division
 from __future__ import print_function
 
+from tensorflow.contrib.data.python.ops import interleave_ops
 from tensorflow.contrib.kafka.python.ops import kafka_op_loader  # pylint: disable=unused-import
 from tensorflow.contrib.kafka.python.ops import gen_dataset_ops
 from tensorflow.python.data.ops.dataset_ops import Dataset
@@ -34,7 +35,9 @@ class KafkaDataset(Dataset):
                servers="localhost",
                group="",
                eof=False,
-               timeout=1000):
+               timeout=1000,
+               batch_size=None,
+               max_batch_bytes=-1):
     """Create a KafkaReader.
 
     Args:
@@ -46,6 +49,13 @@ class KafkaDataset(Dataset):
       eof: If True, the kafka reader will stop on EOF.
       timeout: The timeout value for the Kafka Consumer to wait
                (in millisecond).
+      batch_size: (Optional.) If set, each element is a vector of up to
+              `batch_size` messages consumed in one call, rather than a
+              single message. A batch ends early at the end of a
+              subscription, and batches do not span subscriptions.
+      max_batch_bytes: (Optional.) If positive and `batch_size` is set, a
+              batch also ends once its messages total at least this many
+              bytes.
     """
     super(KafkaDataset, self).__init__()
     self._topics = ops.convert_to_tensor(
@@ -57,8 +67,18 @@ class KafkaDataset(Dataset):
     self._eof = ops.convert_to_tensor(eof, dtype=dtypes.bool, name="eof")
     self._timeout = ops.convert_to_tensor(
         timeout, dtype=dtypes.int64, name="timeout")
+    self._batch_size = None
+    if batch_size is not None:
+      self._batch_size = ops.convert_to_tensor(
+          batch_size, dtype=dtypes.int64, name="batch_size")
+      self._max_batch_bytes = ops.convert_to_tensor(
+          max_batch_bytes, dtype=dtypes.int64, name="max_batch_bytes")
 
   def _as_variant_tensor(self):
+    if self._batch_size is not None:
+      return gen_dataset_ops.kafka_batch_dataset(
+          self._topics, self._servers, self._group, self._eof, self._timeout,
+          self._batch_size, self._max_batch_bytes)
     return gen_dataset_ops.kafka_dataset(self._topics, self._servers,
                                          self._group, self._eof, self._timeout)
 
@@ -68,8 +88,64 @@ class KafkaDataset(Dataset):
 
   @property
   def output_shapes(self):
+    if self._batch_size is not None:
+      return tensor_shape.vector(None)
     return tensor_shape.scalar()
 
   @property
   def output_types(self):
     return dtypes.string
+
+
+def parallel_kafka_dataset(topics,
+                           num_parallel_partitions,
+                           servers="localhost",
+                           group="",
+                           eof=False,
+                           timeout=1000,
+                           batch_size=None,
+                           max_batch_bytes=-1,
+                           sloppy=False):
+  """Consumes several Kafka subscriptions concurrently.
+
+  Each subscription in `topics` gets its own `KafkaDataset` and consumer, and
+  up to `num_parallel_partitions` of them are consumed at the same time on
+  background threads with `tf.contrib.data.parallel_interleave`.
+
+  Args:
+    topics: A `tf.string` vector of subscriptions, in the format of
+            [topic:partition:offset:length], usually one per partition.
+    num_parallel_partitions: The number of subscriptions consumed at the same
+            time.
+    servers: A list of bootstrap servers.
+    group: The consumer group id.
+    eof: If True, each kafka reader will stop on EOF.
+    timeout: The timeout value for the Kafka Consumers to wait
+             (in millisecond).
+    batch_size: (Optional.) If set, the elements are batches of up to
+            `batch_size` messages of one subscription, as in `KafkaDataset`.
+    max_batch_bytes: (Optional.) The byte budget of a batch, as in
+            `KafkaDataset`.
+    sloppy: If False, the elements of the subscriptions are merged in a
+            deterministic round-robin order. If True, they are merged in the
+            order they arrive, so a slow partition does not hold up the
+            others.
+
+  Returns:
+    A `Dataset` of the messages, or message batches, of all the
+    subscriptions.
+  """
+
+  def consume(topic):
+    return KafkaDataset(
+        topic,
+        servers=servers,
+        group=group,
+        eof=eof,
+        timeout=timeout,
+        batch_size=batch_size,
+        max_batch_bytes=max_batch_bytes)
+
+  return Dataset.from_tensor_slices(topics).apply(
+      interleave_ops.parallel_interleave(
+          consume, cycle_length=num_parallel_partitions, sloppy=sloppy))
@@ -53,6 +53,16 @@ int64_t ArenaPlanner::BasePointer(TfLiteAllocationType type) {
   return 0;
 }
 
+size_t ArenaPlanner::GetAllocatedBytes(TfLiteAllocationType type) const {
+  if (type == kTfLiteArenaRwPersistent) {
+    return persistent_arena_.BufferSize();
+  }
+  if (type == kTfLiteArenaRw) {
+    return arena_.BufferSize();
+  }
+  return 0;
+}
+
 TfLiteStatus ArenaPlanner::ResetAllocations() {
   TF_LITE_ENSURE_STATUS(arena_.Clear());
   TF_LITE_ENSURE_STATUS(persistent_arena_.Clear());
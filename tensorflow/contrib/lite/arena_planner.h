@@ -52,6 +52,7 @@ class ArenaPlanner : public MemoryPlanner {
   TfLiteStatus ResetAllocations() override;
   TfLiteStatus PlanAllocations() override;
   TfLiteStatus ExecuteAllocations(int first_node, int last_node) override;
+  size_t GetAllocatedBytes(TfLiteAllocationType type) const override;
 
   // Returns the base arena location for a given allocation type.
   int64_t BasePointer(TfLiteAllocationType type);
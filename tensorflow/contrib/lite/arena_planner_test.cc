@@ -235,6 +235,10 @@ TEST_F(ArenaPlannerTest, SimpleGraph) {
   EXPECT_EQ(GetOffset(4), GetOffsetAfter(2));
   EXPECT_EQ(GetOffset(5), GetOffsetAfter(4));
   EXPECT_EQ(GetOffset(3), 0);
+
+  // The arena is large enough for the peak of +0 +1 +2 +4 +5.
+  EXPECT_GE(planner_->GetAllocatedBytes(kTfLiteArenaRw), GetOffsetAfter(5));
+  EXPECT_EQ(planner_->GetAllocatedBytes(kTfLiteMmapRo), 0);
 }
 
 TEST_F(ArenaPlannerTest, SimpleGraphWithTemporary) {
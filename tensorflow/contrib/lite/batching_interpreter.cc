@@ -0,0 +1,275 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/contrib/lite/batching_interpreter.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace tflite {
+
+namespace {
+
+// Returns the size of one example of `tensor`, whose first dimension is the
+// batch of `batch_size` examples, or 0 if it has no such dimension.
+size_t GetExampleBytes(const TfLiteTensor* tensor, int batch_size) {
+  if (tensor->dims == nullptr || tensor->dims->size < 1 ||
+      tensor->dims->data[0] != batch_size || tensor->type == kTfLiteString) {
+    return 0;
+  }
+  return tensor->bytes / batch_size;
+}
+
+}  // namespace
+
+BatchingInterpreter::BatchingInterpreter(const Options& options,
+                                         ErrorReporter* error_reporter)
+    : options_(options), error_reporter_(error_reporter) {}
+
+std::unique_ptr<BatchingInterpreter> BatchingInterpreter::Build(
+    const Options& options, const InterpreterFactory& factory,
+    ErrorReporter* error_reporter) {
+  if (options.batch_sizes.empty() || options.num_batch_threads < 1 ||
+      options.batch_timeout_micros < 0 || options.max_enqueued_requests < 1) {
+    error_reporter->Report("Invalid BatchingInterpreter options.");
+    return nullptr;
+  }
+  for (int batch_size : options.batch_sizes) {
+    if (batch_size < 1) {
+      error_reporter->Report("Invalid batch size %d.", batch_size);
+      return nullptr;
+    }
+  }
+
+  Options sorted_options = options;
+  std::sort(sorted_options.batch_sizes.begin(),
+            sorted_options.batch_sizes.end());
+  sorted_options.batch_sizes.erase(
+      std::unique(sorted_options.batch_sizes.begin(),
+                  sorted_options.batch_sizes.end()),
+      sorted_options.batch_sizes.end());
+
+  std::unique_ptr<BatchingInterpreter> batching_interpreter(
+      new BatchingInterpreter(sorted_options, error_reporter));
+  batching_interpreter->max_batch_size_ = sorted_options.batch_sizes.back();
+  for (int i = 0; i < sorted_options.num_batch_threads; ++i) {
+    std::unique_ptr<BatchThread> batch_thread(new BatchThread);
+    if (batching_interpreter->BuildInterpreters(factory, batch_thread.get()) !=
+        kTfLiteOk) {
+      return nullptr;
+    }
+    batching_interpreter->batch_threads_.push_back(std::move(batch_thread));
+  }
+  // The threads only start once all the interpreters are built, so that a
+  // failure leaves none running.
+  for (auto& batch_thread : batching_interpreter->batch_threads_) {
+    BatchThread* thread = batch_thread.get();
+    BatchingInterpreter* self = batching_interpreter.get();
+    thread->thread = std::thread([self, thread]() {
+      self->ProcessBatches(thread);
+    });
+  }
+  return batching_interpreter;
+}
+
+BatchingInterpreter::~BatchingInterpreter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  queue_changed_.notify_all();
+  for (auto& batch_thread : batch_threads_) {
+    if (batch_thread->thread.joinable()) batch_thread->thread.join();
+  }
+}
+
+TfLiteStatus BatchingInterpreter::BuildInterpreters(
+    const InterpreterFactory& factory, BatchThread* batch_thread) {
+  for (int batch_size : options_.batch_sizes) {
+    std::unique_ptr<Interpreter> interpreter = factory();
+    if (!interpreter) {
+      error_reporter_->Report("Failed to build an interpreter.");
+      return kTfLiteError;
+    }
+    for (int input : interpreter->inputs()) {
+      std::vector<int> dims;
+      const TfLiteTensor* tensor = interpreter->tensor(input);
+      if (tensor->dims != nullptr) {
+        dims.assign(tensor->dims->data,
+                    tensor->dims->data + tensor->dims->size);
+      }
+      if (dims.empty()) {
+        error_reporter_->Report("Input %d has no batch dimension.", input);
+        return kTfLiteError;
+      }
+      dims[0] = batch_size;
+      if (interpreter->ResizeInputTensor(input, dims) != kTfLiteOk) {
+        return kTfLiteError;
+      }
+    }
+    if (interpreter->AllocateTensors() != kTfLiteOk) {
+      error_reporter_->Report("Failed to allocate the tensors for batch %d.",
+                              batch_size);
+      return kTfLiteError;
+    }
+
+    // All the interpreters must agree on the size of an example.
+    const bool first = input_bytes_.empty() && output_bytes_.empty();
+    std::vector<size_t> input_bytes;
+    for (int input : interpreter->inputs()) {
+      input_bytes.push_back(
+          GetExampleBytes(interpreter->tensor(input), batch_size));
+    }
+    std::vector<size_t> output_bytes;
+    for (int output : interpreter->outputs()) {
+      output_bytes.push_back(
+          GetExampleBytes(interpreter->tensor(output), batch_size));
+    }
+    if (std::count(input_bytes.begin(), input_bytes.end(), 0) > 0 ||
+        std::count(output_bytes.begin(), output_bytes.end(), 0) > 0) {
+      error_reporter_->Report(
+          "All the inputs and outputs must be non-empty numeric tensors with "
+          "the batch as first dimension.");
+      return kTfLiteError;
+    }
+    if (first) {
+      input_bytes_ = input_bytes;
+      output_bytes_ = output_bytes;
+    } else if (input_bytes != input_bytes_ || output_bytes != output_bytes_) {
+      error_reporter_->Report(
+          "The size of an example differs between the interpreters.");
+      return kTfLiteError;
+    }
+    batch_thread->interpreters.push_back(std::move(interpreter));
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus BatchingInterpreter::RunAsync(
+    std::vector<const void*> inputs, std::vector<void*> outputs,
+    std::function<void(TfLiteStatus)> done) {
+  if (inputs.size() != input_bytes_.size() ||
+      outputs.size() != output_bytes_.size()) {
+    error_reporter_->Report(
+        "Expected %d inputs and %d outputs, got %d and %d.",
+        static_cast<int>(input_bytes_.size()),
+        static_cast<int>(output_bytes_.size()),
+        static_cast<int>(inputs.size()), static_cast<int>(outputs.size()));
+    return kTfLiteError;
+  }
+  std::unique_ptr<Request> request(new Request);
+  request->inputs = std::move(inputs);
+  request->outputs = std::move(outputs);
+  request->done = std::move(done);
+  request->enqueue_time = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_ || queue_.size() >= options_.max_enqueued_requests) {
+      error_reporter_->Report("The batching queue is full.");
+      return kTfLiteError;
+    }
+    queue_.push_back(std::move(request));
+  }
+  queue_changed_.notify_all();
+  return kTfLiteOk;
+}
+
+TfLiteStatus BatchingInterpreter::Run(std::vector<const void*> inputs,
+                                      std::vector<void*> outputs) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool finished = false;
+  TfLiteStatus status = kTfLiteOk;
+  TF_LITE_ENSURE_STATUS(RunAsync(std::move(inputs), std::move(outputs),
+                                 [&](TfLiteStatus batch_status) {
+                                   std::lock_guard<std::mutex> lock(mutex);
+                                   status = batch_status;
+                                   finished = true;
+                                   cv.notify_one();
+                                 }));
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [&finished]() { return finished; });
+  return status;
+}
+
+bool BatchingInterpreter::TakeBatch(
+    std::vector<std::unique_ptr<Request>>* batch) {
+  const std::chrono::microseconds timeout(options_.batch_timeout_micros);
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    if (queue_.empty()) {
+      if (stopping_) return false;
+      queue_changed_.wait(lock);
+      continue;
+    }
+    if (stopping_ || queue_.size() >= max_batch_size_) break;
+    const auto deadline = queue_.front()->enqueue_time + timeout;
+    if (std::chrono::steady_clock::now() >= deadline) break;
+    queue_changed_.wait_until(lock, deadline);
+  }
+  const int batch_size = std::min<int>(queue_.size(), max_batch_size_);
+  for (int i = 0; i < batch_size; ++i) {
+    batch->push_back(std::move(queue_.front()));
+    queue_.pop_front();
+  }
+  // Let another batch thread pick the remaining requests up.
+  if (!queue_.empty()) queue_changed_.notify_all();
+  return true;
+}
+
+void BatchingInterpreter::ProcessBatches(BatchThread* batch_thread) {
+  std::vector<std::unique_ptr<Request>> batch;
+  while (TakeBatch(&batch)) {
+    RunBatch(batch_thread, &batch);
+    batch.clear();
+  }
+}
+
+void BatchingInterpreter::RunBatch(
+    BatchThread* batch_thread, std::vector<std::unique_ptr<Request>>* batch) {
+  const int num_requests = batch->size();
+  const int bucket =
+      std::lower_bound(options_.batch_sizes.begin(),
+                       options_.batch_sizes.end(), num_requests) -
+      options_.batch_sizes.begin();
+  const int batch_size = options_.batch_sizes[bucket];
+  Interpreter* interpreter = batch_thread->interpreters[bucket].get();
+
+  for (int i = 0; i < input_bytes_.size(); ++i) {
+    const size_t bytes = input_bytes_[i];
+    char* data = interpreter->tensor(interpreter->inputs()[i])->data.raw;
+    for (int r = 0; r < num_requests; ++r) {
+      memcpy(data + r * bytes, (*batch)[r]->inputs[i], bytes);
+    }
+    memset(data + num_requests * bytes, 0,
+           (batch_size - num_requests) * bytes);
+  }
+
+  const TfLiteStatus status = interpreter->Invoke();
+  if (status == kTfLiteOk) {
+    for (int i = 0; i < output_bytes_.size(); ++i) {
+      const size_t bytes = output_bytes_[i];
+      const char* data =
+          interpreter->tensor(interpreter->outputs()[i])->data.raw;
+      for (int r = 0; r < num_requests; ++r) {
+        memcpy((*batch)[r]->outputs[i], data + r * bytes, bytes);
+      }
+    }
+  }
+  for (auto& request : *batch) {
+    request->done(status);
+  }
+}
+
+}  // namespace tflite
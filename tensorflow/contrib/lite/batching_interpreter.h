@@ -0,0 +1,168 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// A front end batching the single-example requests of concurrent callers
+// into the runs of an interpreter, for server-side inference.
+#ifndef TENSORFLOW_CONTRIB_LITE_BATCHING_INTERPRETER_H_
+#define TENSORFLOW_CONTRIB_LITE_BATCHING_INTERPRETER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "tensorflow/contrib/lite/context.h"
+#include "tensorflow/contrib/lite/error_reporter.h"
+#include "tensorflow/contrib/lite/interpreter.h"
+
+namespace tflite {
+
+// Runs the requests of concurrent callers, each holding one example, in
+// batches. It follows the design of BasicBatchScheduler in
+// tensorflow/core/kernels/batching_util: requests are queued, and batch
+// threads take up to the largest batch size of them, waiting at most
+// `batch_timeout_micros` after the oldest one for the batch to fill up.
+//
+// The model must have the batch as the first dimension of all its inputs and
+// outputs. Each batch thread owns one interpreter per batch size, whose
+// tensors are allocated once, when the BatchingInterpreter is built; a batch
+// runs on the interpreter of the smallest batch size that holds it, with the
+// unused examples zeroed. Running a batch thus never resizes or reallocates
+// tensors. Interpreters built from the same FlatBufferModel share the weights
+// derived from its constants, so each one mostly costs its tensor arena.
+//
+// Example usage:
+//
+//   BatchingInterpreter::Options options;
+//   options.batch_sizes = {1, 4, 16};
+//   options.batch_timeout_micros = 2000;
+//   auto batching_interpreter = BatchingInterpreter::Build(
+//       options, [&model, &resolver]() {
+//         std::unique_ptr<Interpreter> interpreter;
+//         InterpreterBuilder(*model, resolver)(&interpreter);
+//         return interpreter;
+//       });
+//   // From any thread:
+//   float input[kInputSize], output[kOutputSize];
+//   batching_interpreter->Run({input}, {output});
+//
+// WARNING: This is an experimental API and subject to change.
+class BatchingInterpreter {
+ public:
+  struct Options {
+    // The batch sizes the interpreters are allocated for. The largest one is
+    // the most requests a batch holds.
+    std::vector<int> batch_sizes = {1, 2, 4, 8};
+
+    // How long the oldest queued request waits for a batch to fill up. With
+    // 0, a batch thread takes whatever requests are queued when it is free.
+    int64_t batch_timeout_micros = 0;
+
+    // The number of threads running batches. Each one owns its own
+    // interpreters.
+    int num_batch_threads = 1;
+
+    // The maximum number of queued requests. Requests beyond it are rejected.
+    int max_enqueued_requests = 1000;
+  };
+
+  // Returns a new interpreter of the model, with its inputs and outputs set.
+  // It is called once per batch size and batch thread.
+  using InterpreterFactory = std::function<std::unique_ptr<Interpreter>()>;
+
+  // Builds the interpreters for all the batch sizes and starts the batch
+  // threads. Returns nullptr in case of failure, reported to
+  // `error_reporter`, which must outlive the BatchingInterpreter.
+  static std::unique_ptr<BatchingInterpreter> Build(
+      const Options& options, const InterpreterFactory& factory,
+      ErrorReporter* error_reporter = DefaultErrorReporter());
+
+  // Runs the queued requests, then stops the batch threads.
+  ~BatchingInterpreter();
+
+  BatchingInterpreter(const BatchingInterpreter&) = delete;
+  BatchingInterpreter& operator=(const BatchingInterpreter&) = delete;
+
+  // Queues a request for one example. `inputs` and `outputs` point to the
+  // data of each input and output tensor of the model for that example,
+  // i.e. input_bytes(i) and output_bytes(i) bytes, and must stay valid until
+  // `done` is called with the status of the batch. Returns an error, without
+  // calling `done`, if the request is malformed or the queue is full.
+  TfLiteStatus RunAsync(std::vector<const void*> inputs,
+                        std::vector<void*> outputs,
+                        std::function<void(TfLiteStatus)> done);
+
+  // Like RunAsync(), but waits for the request to be run.
+  TfLiteStatus Run(std::vector<const void*> inputs, std::vector<void*> outputs);
+
+  // The sizes of the inputs and outputs of one example.
+  size_t input_bytes(int index) const { return input_bytes_[index]; }
+  size_t output_bytes(int index) const { return output_bytes_[index]; }
+  int num_inputs() const { return input_bytes_.size(); }
+  int num_outputs() const { return output_bytes_.size(); }
+
+ private:
+  struct Request {
+    std::vector<const void*> inputs;
+    std::vector<void*> outputs;
+    std::function<void(TfLiteStatus)> done;
+    std::chrono::steady_clock::time_point enqueue_time;
+  };
+
+  // A batch thread with its interpreters, one per batch size.
+  struct BatchThread {
+    std::vector<std::unique_ptr<Interpreter>> interpreters;
+    std::thread thread;
+  };
+
+  BatchingInterpreter(const Options& options, ErrorReporter* error_reporter);
+
+  // Builds the interpreters of `batch_thread` and checks that their inputs
+  // and outputs have the sizes of the first one built.
+  TfLiteStatus BuildInterpreters(const InterpreterFactory& factory,
+                                 BatchThread* batch_thread);
+
+  // The loop of the batch threads.
+  void ProcessBatches(BatchThread* batch_thread);
+
+  // Takes the requests of the next batch from the queue, waiting for them if
+  // needed. Returns false once the queue is drained and stopping.
+  bool TakeBatch(std::vector<std::unique_ptr<Request>>* batch);
+
+  // Runs `batch` on the interpreters of `batch_thread` and completes its
+  // requests.
+  void RunBatch(BatchThread* batch_thread,
+                std::vector<std::unique_ptr<Request>>* batch);
+
+  const Options options_;
+  ErrorReporter* const error_reporter_;
+  int max_batch_size_ = 0;
+  std::vector<size_t> input_bytes_;
+  std::vector<size_t> output_bytes_;
+  std::vector<std::unique_ptr<BatchThread>> batch_threads_;
+
+  std::mutex mutex_;
+  std::condition_variable queue_changed_;
+  std::deque<std::unique_ptr<Request>> queue_;
+  bool stopping_ = false;
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_CONTRIB_LITE_BATCHING_INTERPRETER_H_
@@ -0,0 +1,207 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/contrib/lite/batching_interpreter.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/contrib/lite/testing/util.h"
+
+namespace tflite {
+namespace {
+
+constexpr int kExampleSize = 2;
+
+// The batch sizes the test op was invoked with.
+std::mutex invoked_batch_sizes_mutex;
+std::vector<int> invoked_batch_sizes;
+
+// An op adding 1 to its input.
+TfLiteRegistration* GetAddOneRegistration() {
+  static TfLiteRegistration registration = {
+      nullptr, nullptr,
+      [](TfLiteContext* context, TfLiteNode* node) {
+        const TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+        TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+        return context->ResizeTensor(context, output,
+                                     TfLiteIntArrayCopy(input->dims));
+      },
+      [](TfLiteContext* context, TfLiteNode* node) {
+        const TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+        TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+        const int size = input->bytes / sizeof(float);
+        for (int i = 0; i < size; ++i) {
+          output->data.f[i] = input->data.f[i] + 1;
+        }
+        std::lock_guard<std::mutex> lock(invoked_batch_sizes_mutex);
+        invoked_batch_sizes.push_back(input->dims->data[0]);
+        return kTfLiteOk;
+      }};
+  return &registration;
+}
+
+std::unique_ptr<Interpreter> BuildAddOneInterpreter() {
+  std::unique_ptr<Interpreter> interpreter(new Interpreter);
+  interpreter->AddTensors(2);
+  interpreter->SetInputs({0});
+  interpreter->SetOutputs({1});
+  for (int i = 0; i < 2; ++i) {
+    interpreter->SetTensorParametersReadWrite(
+        i, kTfLiteFloat32, "", {1, kExampleSize}, TfLiteQuantizationParams());
+  }
+  interpreter->AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr,
+                                     GetAddOneRegistration());
+  return interpreter;
+}
+
+class BatchingInterpreterTest : public ::testing::Test {
+ protected:
+  void SetUp() override { invoked_batch_sizes.clear(); }
+};
+
+TEST_F(BatchingInterpreterTest, RunsSingleRequest) {
+  BatchingInterpreter::Options options;
+  auto batching_interpreter =
+      BatchingInterpreter::Build(options, BuildAddOneInterpreter);
+  ASSERT_NE(batching_interpreter, nullptr);
+  EXPECT_EQ(batching_interpreter->num_inputs(), 1);
+  EXPECT_EQ(batching_interpreter->input_bytes(0), kExampleSize * sizeof(float));
+
+  float input[kExampleSize] = {1, 2};
+  float output[kExampleSize];
+  ASSERT_EQ(batching_interpreter->Run({input}, {output}), kTfLiteOk);
+  EXPECT_EQ(output[0], 2);
+  EXPECT_EQ(output[1], 3);
+  EXPECT_EQ(invoked_batch_sizes, std::vector<int>({1}));
+}
+
+TEST_F(BatchingInterpreterTest, CoalescesConcurrentRequests) {
+  BatchingInterpreter::Options options;
+  options.batch_sizes = {8, 1, 4};
+  // Long enough for all the requests to be queued before the batch runs.
+  options.batch_timeout_micros = 10 * 1000 * 1000;
+  auto batching_interpreter =
+      BatchingInterpreter::Build(options, BuildAddOneInterpreter);
+  ASSERT_NE(batching_interpreter, nullptr);
+
+  constexpr int kNumRequests = 11;
+  float inputs[kNumRequests][kExampleSize];
+  float outputs[kNumRequests][kExampleSize];
+  std::atomic<int> num_done(0);
+  for (int r = 0; r < kNumRequests; ++r) {
+    inputs[r][0] = r;
+    inputs[r][1] = -r;
+    ASSERT_EQ(batching_interpreter->RunAsync({inputs[r]}, {outputs[r]},
+                                             [&num_done](TfLiteStatus status) {
+                                               EXPECT_EQ(status, kTfLiteOk);
+                                               ++num_done;
+                                             }),
+              kTfLiteOk);
+  }
+  // The last 3 requests wait for the timeout, or the destructor.
+  batching_interpreter.reset();
+
+  EXPECT_EQ(num_done, kNumRequests);
+  for (int r = 0; r < kNumRequests; ++r) {
+    EXPECT_EQ(outputs[r][0], r + 1);
+    EXPECT_EQ(outputs[r][1], -r + 1);
+  }
+  // A full batch, then the rest on the smallest batch size holding them.
+  EXPECT_EQ(invoked_batch_sizes, std::vector<int>({8, 4}));
+}
+
+TEST_F(BatchingInterpreterTest, RunsConcurrentCallers) {
+  BatchingInterpreter::Options options;
+  options.batch_sizes = {1, 2, 4};
+  options.batch_timeout_micros = 1000;
+  options.num_batch_threads = 2;
+  auto batching_interpreter =
+      BatchingInterpreter::Build(options, BuildAddOneInterpreter);
+  ASSERT_NE(batching_interpreter, nullptr);
+
+  std::vector<std::thread> callers;
+  for (int t = 0; t < 8; ++t) {
+    callers.emplace_back([t, &batching_interpreter]() {
+      for (int i = 0; i < 20; ++i) {
+        float input[kExampleSize] = {static_cast<float>(t),
+                                     static_cast<float>(i)};
+        float output[kExampleSize];
+        EXPECT_EQ(batching_interpreter->Run({input}, {output}), kTfLiteOk);
+        EXPECT_EQ(output[0], t + 1);
+        EXPECT_EQ(output[1], i + 1);
+      }
+    });
+  }
+  for (auto& caller : callers) caller.join();
+
+  int num_examples = 0;
+  for (int batch_size : invoked_batch_sizes) {
+    EXPECT_LE(batch_size, 4);
+    num_examples += batch_size;
+  }
+  EXPECT_GE(num_examples, 8 * 20);
+}
+
+TEST_F(BatchingInterpreterTest, RejectsMalformedRequests) {
+  BatchingInterpreter::Options options;
+  auto batching_interpreter =
+      BatchingInterpreter::Build(options, BuildAddOneInterpreter);
+  ASSERT_NE(batching_interpreter, nullptr);
+
+  float input[kExampleSize];
+  float output[kExampleSize];
+  EXPECT_NE(batching_interpreter->Run({input, input}, {output}), kTfLiteOk);
+  EXPECT_NE(batching_interpreter->Run({input}, {}), kTfLiteOk);
+}
+
+TEST_F(BatchingInterpreterTest, RejectsInvalidOptions) {
+  BatchingInterpreter::Options options;
+  options.batch_sizes = {};
+  EXPECT_EQ(BatchingInterpreter::Build(options, BuildAddOneInterpreter),
+            nullptr);
+  options.batch_sizes = {0, 2};
+  EXPECT_EQ(BatchingInterpreter::Build(options, BuildAddOneInterpreter),
+            nullptr);
+}
+
+TEST_F(BatchingInterpreterTest, RejectsModelsWithoutBatchDimension) {
+  BatchingInterpreter::Options options;
+  auto build_scalar_interpreter = []() {
+    std::unique_ptr<Interpreter> interpreter(new Interpreter);
+    interpreter->AddTensors(1);
+    interpreter->SetInputs({0});
+    interpreter->SetOutputs({0});
+    interpreter->SetTensorParametersReadWrite(0, kTfLiteFloat32, "", {},
+                                              TfLiteQuantizationParams());
+    return interpreter;
+  };
+  EXPECT_EQ(BatchingInterpreter::Build(options, build_scalar_interpreter),
+            nullptr);
+  EXPECT_EQ(BatchingInterpreter::Build(
+                options, []() { return std::unique_ptr<Interpreter>(); }),
+            nullptr);
+}
+
+}  // namespace
+}  // namespace tflite
+
+int main(int argc, char** argv) {
+  ::tflite::LogToStderr();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
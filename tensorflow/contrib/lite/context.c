@@ -82,6 +82,8 @@ void TfLiteTensorReset(TfLiteType type, const char* name, TfLiteIntArray* dims,
   tensor->name = name;
   tensor->dims = dims;
   tensor->params = quantization;
+  tensor->channel_scales = NULL;
+  tensor->num_channel_scales = 0;
   tensor->data.raw = buffer;
   tensor->bytes = size;
   tensor->allocation_type = allocation_type;
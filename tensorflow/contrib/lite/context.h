@@ -223,6 +223,14 @@ typedef struct {
   // delegate buffer.
   // WARNING: This is an // experimental interface that is subject to change.
   bool data_is_stale;
+
+  // The scales of a tensor quantized per channel, one for each slice along the
+  // dimension of its output channels (e.g. the first dimension of a conv
+  // filter), or null. When set, they replace `params.scale`. The scales are
+  // owned by whoever sets them, usually the model.
+  // WARNING: This is an experimental interface that is subject to change.
+  const float* channel_scales;
+  int num_channel_scales;
 } TfLiteTensor;
 
 // Free data memory of tensor `t`;
@@ -332,8 +340,15 @@ typedef struct TfLiteContext {
 
   // TODO(ahentz): we should create a more general mechanism for this sort of
   // library-global objects.
+  // The gemmlowp context also holds the thread pool that the multithreaded
+  // kernels share (see kernels/gemm_support.h).
   void* gemm_context;
   void* eigen_context;
+
+  // The tflite::WeightCache shared by the interpreters of the same model, or
+  // null (see weight_cache.h).
+  // WARNING: This is an experimental interface that is subject to change.
+  void* weight_cache;
 } TfLiteContext;
 
 typedef struct _TfLiteRegistration {
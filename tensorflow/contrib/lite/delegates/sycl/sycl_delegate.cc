@@ -0,0 +1,783 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/contrib/lite/delegates/sycl/sycl_delegate.h"
+
+#ifdef TENSORFLOW_USE_SYCL
+
+#define EIGEN_USE_SYCL
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+
+#include "sycldnn/backend/eigen_backend.h"
+#include "sycldnn/conv2d/launch.h"
+#include "sycldnn/conv2d/params.h"
+#include "sycldnn/conv2d/selector/default_selector.h"
+#include "sycldnn/depthwise_conv2d/launch.h"
+#include "sycldnn/depthwise_conv2d/params.h"
+#include "sycldnn/pooling/launch.h"
+#include "sycldnn/pooling/operators.h"
+#include "sycldnn/pooling/params.h"
+#include "sycldnn/status.h"
+
+#include "tensorflow/contrib/lite/builtin_op_data.h"
+#include "tensorflow/contrib/lite/builtin_ops.h"
+#include "tensorflow/contrib/lite/kernels/padding.h"
+
+#endif  // TENSORFLOW_USE_SYCL
+
+namespace tflite {
+
+#ifdef TENSORFLOW_USE_SYCL
+
+namespace {
+
+using SNNBackend = sycldnn::backend::EigenBackend;
+
+template <int N>
+using DeviceTensor =
+    Eigen::TensorMap<Eigen::Tensor<float, N, Eigen::RowMajor, int>>;
+template <int N>
+using ConstDeviceTensor =
+    Eigen::TensorMap<Eigen::Tensor<const float, N, Eigen::RowMajor, int>>;
+
+// Device memory allocated through the Eigen SYCL device.
+struct DeviceBuffer {
+  float* data;
+  size_t bytes;
+};
+
+// Owns the SYCL queue of the delegate, and the device buffers behind the
+// buffer handles of the tensors it produces.
+class SyclDelegate {
+ public:
+  SyclDelegate()
+      : queue_(cl::sycl::default_selector()),
+        device_(&queue_),
+        backend_(device_),
+        selector_(sycldnn::conv2d::get_default_selector(
+            queue_.sycl_queue().get_device())) {
+    delegate_.data_ = this;
+    delegate_.Prepare = DoPrepare;
+    delegate_.CopyFromBufferHandle = DoCopyFromBufferHandle;
+    delegate_.CopyToBufferHandle = DoCopyToBufferHandle;
+    delegate_.FreeBufferHandle = DoFreeBufferHandle;
+  }
+
+  ~SyclDelegate() { queue_.deallocate_all(); }
+
+  TfLiteDelegate* tflite_delegate() { return &delegate_; }
+  const Eigen::SyclDevice& device() const { return device_; }
+  SNNBackend& backend() { return backend_; }
+  sycldnn::conv2d::Selector& selector() { return *selector_; }
+
+  float* Allocate(size_t bytes) {
+    // SYCL buffers cannot be empty.
+    return static_cast<float*>(device_.allocate(std::max<size_t>(bytes, 1)));
+  }
+  void Deallocate(float* data) { device_.deallocate(data); }
+
+  // The copies block until they are done, so that the host memory can be
+  // reused as soon as they return.
+  void CopyToDevice(const void* src, float* dst, size_t bytes) {
+    if (bytes == 0) return;
+    device_.memcpyHostToDevice(dst, static_cast<const float*>(src), bytes);
+    device_.synchronize();
+  }
+  void CopyToHost(const float* src, void* dst, size_t bytes) {
+    if (bytes == 0) return;
+    device_.memcpyDeviceToHost(dst, src, bytes);
+    device_.synchronize();
+  }
+  void Synchronize() { device_.synchronize(); }
+
+  TfLiteBufferHandle NewBuffer(size_t bytes) {
+    DeviceBuffer buffer{Allocate(bytes), bytes};
+    std::lock_guard<std::mutex> lock(mu_);
+    const TfLiteBufferHandle handle = next_handle_++;
+    buffers_[handle] = buffer;
+    return handle;
+  }
+
+  // Returns nullptr if `handle` is not a buffer of the delegate.
+  const DeviceBuffer* GetBuffer(TfLiteBufferHandle handle) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = buffers_.find(handle);
+    return it == buffers_.end() ? nullptr : &it->second;
+  }
+
+ private:
+  static TfLiteStatus DoPrepare(TfLiteContext* context,
+                                TfLiteDelegate* delegate);
+
+  static TfLiteStatus DoCopyFromBufferHandle(TfLiteDelegate* delegate,
+                                             TfLiteBufferHandle buffer_handle,
+                                             void* data, size_t size) {
+    auto* sycl = static_cast<SyclDelegate*>(delegate->data_);
+    const DeviceBuffer* buffer = sycl->GetBuffer(buffer_handle);
+    if (buffer == nullptr || buffer->bytes < size) return kTfLiteError;
+    sycl->CopyToHost(buffer->data, data, size);
+    return kTfLiteOk;
+  }
+
+  static TfLiteStatus DoCopyToBufferHandle(TfLiteDelegate* delegate,
+                                           TfLiteBufferHandle buffer_handle,
+                                           void* data, size_t size) {
+    auto* sycl = static_cast<SyclDelegate*>(delegate->data_);
+    const DeviceBuffer* buffer = sycl->GetBuffer(buffer_handle);
+    if (buffer == nullptr || buffer->bytes < size) return kTfLiteError;
+    sycl->CopyToDevice(data, buffer->data, size);
+    return kTfLiteOk;
+  }
+
+  static void DoFreeBufferHandle(TfLiteDelegate* delegate,
+                                 TfLiteBufferHandle* handle) {
+    auto* sycl = static_cast<SyclDelegate*>(delegate->data_);
+    float* data = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(sycl->mu_);
+      auto it = sycl->buffers_.find(*handle);
+      if (it != sycl->buffers_.end()) {
+        data = it->second.data;
+        sycl->buffers_.erase(it);
+      }
+    }
+    if (data != nullptr) sycl->Deallocate(data);
+    *handle = kTfLiteNullBufferHandle;
+  }
+
+  Eigen::QueueInterface queue_;
+  Eigen::SyclDevice device_;
+  SNNBackend backend_;
+  std::unique_ptr<sycldnn::conv2d::Selector> selector_;
+  TfLiteDelegate delegate_;
+
+  std::mutex mu_;
+  std::unordered_map<TfLiteBufferHandle, DeviceBuffer> buffers_;
+  TfLiteBufferHandle next_handle_ = 0;
+};
+
+int NumElements(const TfLiteTensor& tensor) {
+  int count = 1;
+  for (int i = 0; i < tensor.dims->size; ++i) {
+    count *= tensor.dims->data[i];
+  }
+  return count;
+}
+
+bool IsConstantTensor(const TfLiteTensor& tensor) {
+  return tensor.allocation_type == kTfLiteMmapRo;
+}
+
+bool IsSupportedActivation(TfLiteFusedActivation activation) {
+  switch (activation) {
+    case kTfLiteActNone:
+    case kTfLiteActRelu:
+    case kTfLiteActRelu1:
+    case kTfLiteActRelu6:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// The fused activation of a node that has one.
+TfLiteFusedActivation GetActivation(int builtin_code,
+                                    const void* builtin_data) {
+  switch (builtin_code) {
+    case kTfLiteBuiltinConv2d:
+      return static_cast<const TfLiteConvParams*>(builtin_data)->activation;
+    case kTfLiteBuiltinDepthwiseConv2d:
+      return static_cast<const TfLiteDepthwiseConvParams*>(builtin_data)
+          ->activation;
+    case kTfLiteBuiltinAveragePool2d:
+    case kTfLiteBuiltinMaxPool2d:
+      return static_cast<const TfLitePoolParams*>(builtin_data)->activation;
+    case kTfLiteBuiltinFullyConnected:
+      return static_cast<const TfLiteFullyConnectedParams*>(builtin_data)
+          ->activation;
+    case kTfLiteBuiltinAdd:
+      return static_cast<const TfLiteAddParams*>(builtin_data)->activation;
+    case kTfLiteBuiltinSub:
+      return static_cast<const TfLiteSubParams*>(builtin_data)->activation;
+    case kTfLiteBuiltinMul:
+      return static_cast<const TfLiteMulParams*>(builtin_data)->activation;
+    default:
+      return kTfLiteActNone;
+  }
+}
+
+// Returns true if the delegate can run `node` on the device.
+bool IsNodeSupported(TfLiteContext* context, const TfLiteNode* node,
+                     const TfLiteRegistration* registration) {
+  if (node->outputs->size != 1) return false;
+  for (int i = 0; i < node->inputs->size; ++i) {
+    const int index = node->inputs->data[i];
+    if (index != kOptionalTensor &&
+        context->tensors[index].type != kTfLiteFloat32) {
+      return false;
+    }
+  }
+  const TfLiteTensor& output = context->tensors[node->outputs->data[0]];
+  if (output.type != kTfLiteFloat32 ||
+      output.allocation_type == kTfLiteDynamic) {
+    return false;
+  }
+  const int builtin_code = registration->builtin_code;
+  if (!IsSupportedActivation(
+          GetActivation(builtin_code, node->builtin_data))) {
+    return false;
+  }
+  auto input = [context, node](int i) -> const TfLiteTensor& {
+    return context->tensors[node->inputs->data[i]];
+  };
+  switch (builtin_code) {
+    case kTfLiteBuiltinConv2d:
+      // The filter is transposed to the layout of SYCL-DNN once.
+      return (node->inputs->size == 2 || node->inputs->size == 3) &&
+             input(0).dims->size == 4 && input(1).dims->size == 4 &&
+             IsConstantTensor(input(1));
+    case kTfLiteBuiltinDepthwiseConv2d:
+      return node->inputs->size == 3 && input(0).dims->size == 4 &&
+             input(1).dims->size == 4 && input(1).dims->data[0] == 1;
+    case kTfLiteBuiltinAveragePool2d:
+    case kTfLiteBuiltinMaxPool2d:
+      return node->inputs->size == 1 && input(0).dims->size == 4;
+    case kTfLiteBuiltinFullyConnected:
+      return (node->inputs->size == 2 || node->inputs->size == 3) &&
+             input(1).dims->size == 2;
+    case kTfLiteBuiltinAdd:
+    case kTfLiteBuiltinSub:
+    case kTfLiteBuiltinMul:
+      // Broadcasting is left to the CPU kernels.
+      return node->inputs->size == 2 &&
+             TfLiteIntArrayEqual(input(0).dims, input(1).dims);
+    case kTfLiteBuiltinRelu:
+    case kTfLiteBuiltinRelu6:
+    case kTfLiteBuiltinLogistic:
+    case kTfLiteBuiltinTanh:
+      return node->inputs->size == 1;
+    default:
+      return false;
+  }
+}
+
+// A node of a subgraph claimed by the delegate.
+struct SyclNode {
+  int builtin_code;
+  std::vector<int> inputs;
+  int output;
+  // Owned by the original node, which the interpreter keeps.
+  const void* builtin_data;
+
+  // Set by SyclSubgraph::Prepare.
+  sycldnn::conv2d::Conv2DParams conv;
+  sycldnn::depthwise_conv2d::DepthwiseConv2DParams depthwise;
+  sycldnn::pooling::PoolingParams pool;
+  // The filter of a CONV_2D node, transposed from the OHWI layout of
+  // TensorFlow Lite to the HWIO layout of SYCL-DNN.
+  float* filter = nullptr;
+};
+
+// The kernel of a subgraph claimed by the delegate. The tensors produced and
+// consumed inside the subgraph only live on the device, and the outputs of the
+// subgraph are left in the buffers of their handles.
+class SyclSubgraph {
+ public:
+  explicit SyclSubgraph(SyclDelegate* delegate) : delegate_(delegate) {}
+  ~SyclSubgraph() { ReleaseBuffers(); }
+
+  TfLiteStatus Init(TfLiteContext* context,
+                    const TfLiteDelegateParams* params);
+  TfLiteStatus Prepare(TfLiteContext* context);
+  TfLiteStatus Invoke(TfLiteContext* context);
+
+ private:
+  TfLiteStatus PrepareNode(TfLiteContext* context, SyclNode* node);
+  TfLiteStatus InvokeNode(TfLiteContext* context, const SyclNode& node);
+
+  float* AllocateInternal(size_t bytes) {
+    float* data = delegate_->Allocate(bytes);
+    internal_.push_back(data);
+    return data;
+  }
+
+  void ReleaseBuffers() {
+    for (float* data : internal_) {
+      delegate_->Deallocate(data);
+    }
+    internal_.clear();
+  }
+
+  float* Data(int tensor_index) { return data_[tensor_index]; }
+
+  // Adds the bias of the channels of `data` and applies `activation`.
+  void FinishOutput(const float* bias, int channels,
+                    TfLiteFusedActivation activation, float* data, int size);
+
+  SyclDelegate* const delegate_;
+  std::vector<SyclNode> nodes_;
+  std::vector<int> inputs_;
+  std::vector<int> outputs_;
+  // Device data of the tensors read or written by the nodes.
+  std::unordered_map<int, float*> data_;
+  // The non-constant inputs, with the device memory their host data is
+  // copied to when they are not already in a buffer of the delegate.
+  std::unordered_map<int, float*> staged_inputs_;
+  // Device memory owned by the subgraph.
+  std::vector<float*> internal_;
+};
+
+TfLiteStatus SyclSubgraph::Init(TfLiteContext* context,
+                                const TfLiteDelegateParams* params) {
+  for (int i = 0; i < params->nodes_to_replace->size; ++i) {
+    TfLiteNode* node;
+    TfLiteRegistration* registration;
+    TF_LITE_ENSURE_STATUS(context->GetNodeAndRegistration(
+        context, params->nodes_to_replace->data[i], &node, &registration));
+    SyclNode sycl_node;
+    sycl_node.builtin_code = registration->builtin_code;
+    sycl_node.inputs.assign(node->inputs->data,
+                            node->inputs->data + node->inputs->size);
+    sycl_node.output = node->outputs->data[0];
+    sycl_node.builtin_data = node->builtin_data;
+    nodes_.push_back(sycl_node);
+  }
+  inputs_.assign(params->input_tensors->data,
+                 params->input_tensors->data + params->input_tensors->size);
+  outputs_.assign(params->output_tensors->data,
+                  params->output_tensors->data + params->output_tensors->size);
+  return kTfLiteOk;
+}
+
+TfLiteStatus SyclSubgraph::Prepare(TfLiteContext* context) {
+  ReleaseBuffers();
+  data_.clear();
+  staged_inputs_.clear();
+
+  // The filters of the convolutions are only read in their transposed form.
+  std::unordered_set<int> read_tensors;
+  for (const SyclNode& node : nodes_) {
+    for (int i = 0; i < node.inputs.size(); ++i) {
+      if (node.inputs[i] == kOptionalTensor) continue;
+      if (node.builtin_code == kTfLiteBuiltinConv2d && i == 1) continue;
+      read_tensors.insert(node.inputs[i]);
+    }
+  }
+
+  for (int index : inputs_) {
+    if (read_tensors.count(index) == 0) continue;
+    const TfLiteTensor& tensor = context->tensors[index];
+    float* data = AllocateInternal(tensor.bytes);
+    if (IsConstantTensor(tensor)) {
+      delegate_->CopyToDevice(tensor.data.raw, data, tensor.bytes);
+    } else {
+      staged_inputs_[index] = data;
+    }
+    data_[index] = data;
+  }
+
+  TfLiteDelegate* delegate = delegate_->tflite_delegate();
+  for (int index : outputs_) {
+    TfLiteTensor* tensor = &context->tensors[index];
+    TF_LITE_ENSURE_EQ(context, tensor->delegate, delegate);
+    if (tensor->buffer_handle == kTfLiteNullBufferHandle) {
+      tensor->buffer_handle = delegate_->NewBuffer(tensor->bytes);
+    }
+    const DeviceBuffer* buffer = delegate_->GetBuffer(tensor->buffer_handle);
+    TF_LITE_ENSURE(context, buffer != nullptr);
+    TF_LITE_ENSURE(context, buffer->bytes >= tensor->bytes);
+    data_[index] = buffer->data;
+  }
+
+  for (SyclNode& node : nodes_) {
+    if (data_.count(node.output) == 0) {
+      // An intermediate tensor of the subgraph.
+      data_[node.output] =
+          AllocateInternal(context->tensors[node.output].bytes);
+    }
+    TF_LITE_ENSURE_STATUS(PrepareNode(context, &node));
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus SyclSubgraph::PrepareNode(TfLiteContext* context,
+                                       SyclNode* node) {
+  const TfLiteTensor& input = context->tensors[node->inputs[0]];
+  const TfLiteTensor& output = context->tensors[node->output];
+  switch (node->builtin_code) {
+    case kTfLiteBuiltinConv2d: {
+      const TfLiteTensor& filter = context->tensors[node->inputs[1]];
+      const auto* params =
+          static_cast<const TfLiteConvParams*>(node->builtin_data);
+      sycldnn::conv2d::Conv2DParams& p = node->conv;
+      p.batch = input.dims->data[0];
+      p.in_rows = input.dims->data[1];
+      p.in_cols = input.dims->data[2];
+      p.channels = input.dims->data[3];
+      p.features = filter.dims->data[0];
+      p.window_rows = filter.dims->data[1];
+      p.window_cols = filter.dims->data[2];
+      p.stride_rows = params->stride_height;
+      p.stride_cols = params->stride_width;
+      p.dilation_rows = params->dilation_height_factor;
+      p.dilation_cols = params->dilation_width_factor;
+      p.out_rows = output.dims->data[1];
+      p.out_cols = output.dims->data[2];
+      p.pad_rows = ComputePadding(p.stride_rows, p.dilation_rows, p.in_rows,
+                                  p.window_rows, p.out_rows);
+      p.pad_cols = ComputePadding(p.stride_cols, p.dilation_cols, p.in_cols,
+                                  p.window_cols, p.out_cols);
+      TF_LITE_ENSURE_EQ(context, filter.dims->data[3], p.channels);
+
+      std::vector<float> hwio(NumElements(filter));
+      const float* ohwi = filter.data.f;
+      for (int o = 0; o < p.features; ++o) {
+        for (int h = 0; h < p.window_rows; ++h) {
+          for (int w = 0; w < p.window_cols; ++w) {
+            for (int i = 0; i < p.channels; ++i) {
+              hwio[((h * p.window_cols + w) * p.channels + i) * p.features +
+                   o] =
+                  ohwi[((o * p.window_rows + h) * p.window_cols + w) *
+                           p.channels +
+                       i];
+            }
+          }
+        }
+      }
+      node->filter = AllocateInternal(filter.bytes);
+      delegate_->CopyToDevice(hwio.data(), node->filter, filter.bytes);
+      return kTfLiteOk;
+    }
+    case kTfLiteBuiltinDepthwiseConv2d: {
+      const TfLiteTensor& filter = context->tensors[node->inputs[1]];
+      const auto* params =
+          static_cast<const TfLiteDepthwiseConvParams*>(node->builtin_data);
+      // The [1, H, W, I * M] filter of TensorFlow Lite has the memory layout
+      // of the [H, W, I, M] filter of SYCL-DNN.
+      sycldnn::depthwise_conv2d::DepthwiseConv2DParams& p = node->depthwise;
+      p.batch = input.dims->data[0];
+      p.in_rows = input.dims->data[1];
+      p.in_cols = input.dims->data[2];
+      p.channels = input.dims->data[3];
+      p.channel_multiplier = params->depth_multiplier;
+      p.window_rows = filter.dims->data[1];
+      p.window_cols = filter.dims->data[2];
+      p.stride_rows = params->stride_height;
+      p.stride_cols = params->stride_width;
+      p.out_rows = output.dims->data[1];
+      p.out_cols = output.dims->data[2];
+      p.pad_rows = ComputePadding(p.stride_rows, 1, p.in_rows, p.window_rows,
+                                  p.out_rows);
+      p.pad_cols = ComputePadding(p.stride_cols, 1, p.in_cols, p.window_cols,
+                                  p.out_cols);
+      TF_LITE_ENSURE_EQ(context, filter.dims->data[3],
+                        p.channels * p.channel_multiplier);
+      return kTfLiteOk;
+    }
+    case kTfLiteBuiltinAveragePool2d:
+    case kTfLiteBuiltinMaxPool2d: {
+      const auto* params =
+          static_cast<const TfLitePoolParams*>(node->builtin_data);
+      sycldnn::pooling::PoolingParams& p = node->pool;
+      p.batch = input.dims->data[0];
+      p.in_rows = input.dims->data[1];
+      p.in_cols = input.dims->data[2];
+      p.channels = input.dims->data[3];
+      p.window_rows = params->filter_height;
+      p.window_cols = params->filter_width;
+      p.stride_rows = params->stride_height;
+      p.stride_cols = params->stride_width;
+      p.out_rows = output.dims->data[1];
+      p.out_cols = output.dims->data[2];
+      p.pad_rows = ComputePadding(p.stride_rows, 1, p.in_rows, p.window_rows,
+                                  p.out_rows);
+      p.pad_cols = ComputePadding(p.stride_cols, 1, p.in_cols, p.window_cols,
+                                  p.out_cols);
+      return kTfLiteOk;
+    }
+    case kTfLiteBuiltinFullyConnected: {
+      const TfLiteTensor& weights = context->tensors[node->inputs[1]];
+      TF_LITE_ENSURE_EQ(context, NumElements(input) % weights.dims->data[1],
+                        0);
+      return kTfLiteOk;
+    }
+    default:
+      return kTfLiteOk;
+  }
+}
+
+void SyclSubgraph::FinishOutput(const float* bias, int channels,
+                                TfLiteFusedActivation activation, float* data,
+                                int size) {
+  const Eigen::SyclDevice& device = delegate_->device();
+  DeviceTensor<1> out(data, size);
+  if (bias != nullptr) {
+    const int rows = size / channels;
+    DeviceTensor<2> out_matrix(data, rows, channels);
+    ConstDeviceTensor<2> bias_row(bias, 1, channels);
+    const Eigen::array<int, 2> broadcast{{rows, 1}};
+    out_matrix.device(device) = out_matrix + bias_row.broadcast(broadcast);
+  }
+  float low = -std::numeric_limits<float>::infinity();
+  float high = std::numeric_limits<float>::infinity();
+  switch (activation) {
+    case kTfLiteActRelu:
+      low = 0.f;
+      break;
+    case kTfLiteActRelu1:
+      low = -1.f;
+      high = 1.f;
+      break;
+    case kTfLiteActRelu6:
+      low = 0.f;
+      high = 6.f;
+      break;
+    default:
+      return;
+  }
+  out.device(device) = out.cwiseMax(low).cwiseMin(high);
+}
+
+TfLiteStatus SyclSubgraph::InvokeNode(TfLiteContext* context,
+                                      const SyclNode& node) {
+  const Eigen::SyclDevice& device = delegate_->device();
+  const TfLiteTensor& output = context->tensors[node.output];
+  const int size = NumElements(output);
+  const int channels = output.dims->data[output.dims->size - 1];
+  float* in = Data(node.inputs[0]);
+  float* out = Data(node.output);
+  auto bias = [this, &node](int i) -> const float* {
+    return i < node.inputs.size() && node.inputs[i] != kOptionalTensor
+               ? Data(node.inputs[i])
+               : nullptr;
+  };
+  const TfLiteFusedActivation activation =
+      GetActivation(node.builtin_code, node.builtin_data);
+  sycldnn::SNNStatus status;
+  status.status = sycldnn::StatusCode::OK;
+  switch (node.builtin_code) {
+    case kTfLiteBuiltinConv2d:
+      status = sycldnn::conv2d::launch<float,
+                                       sycldnn::conv2d::conv_type::Forward>(
+          in, node.filter, out, node.conv, delegate_->selector(),
+          delegate_->backend());
+      if (status.status == sycldnn::StatusCode::OK) {
+        FinishOutput(bias(2), channels, activation, out, size);
+      }
+      break;
+    case kTfLiteBuiltinDepthwiseConv2d:
+      status = sycldnn::depthwise_conv2d::launch<
+          float, sycldnn::conv2d::conv_type::Forward>(
+          in, Data(node.inputs[1]), out, node.depthwise, delegate_->backend());
+      if (status.status == sycldnn::StatusCode::OK) {
+        FinishOutput(bias(2), channels, activation, out, size);
+      }
+      break;
+    case kTfLiteBuiltinAveragePool2d:
+      status = sycldnn::pooling::launch<float, sycldnn::pooling::Average,
+                                        sycldnn::pooling::Forward>(
+          in, out, node.pool, delegate_->backend());
+      if (status.status == sycldnn::StatusCode::OK) {
+        FinishOutput(nullptr, channels, activation, out, size);
+      }
+      break;
+    case kTfLiteBuiltinMaxPool2d:
+      status = sycldnn::pooling::launch<float, sycldnn::pooling::Max,
+                                        sycldnn::pooling::Forward>(
+          in, out, node.pool, delegate_->backend());
+      if (status.status == sycldnn::StatusCode::OK) {
+        FinishOutput(nullptr, channels, activation, out, size);
+      }
+      break;
+    case kTfLiteBuiltinFullyConnected: {
+      const TfLiteTensor& weights = context->tensors[node.inputs[1]];
+      const int num_units = weights.dims->data[0];
+      const int input_size = weights.dims->data[1];
+      const int batch_size =
+          NumElements(context->tensors[node.inputs[0]]) / input_size;
+      ConstDeviceTensor<2> in_matrix(in, batch_size, input_size);
+      ConstDeviceTensor<2> weights_matrix(Data(node.inputs[1]), num_units,
+                                          input_size);
+      DeviceTensor<2> out_matrix(out, batch_size, num_units);
+      const Eigen::array<Eigen::IndexPair<int>, 1> contract_dims{
+          {Eigen::IndexPair<int>(1, 1)}};
+      out_matrix.device(device) =
+          in_matrix.contract(weights_matrix, contract_dims);
+      FinishOutput(bias(2), num_units, activation, out, size);
+      break;
+    }
+    case kTfLiteBuiltinAdd:
+    case kTfLiteBuiltinSub:
+    case kTfLiteBuiltinMul: {
+      ConstDeviceTensor<1> x(in, size);
+      ConstDeviceTensor<1> y(Data(node.inputs[1]), size);
+      DeviceTensor<1> z(out, size);
+      if (node.builtin_code == kTfLiteBuiltinAdd) {
+        z.device(device) = x + y;
+      } else if (node.builtin_code == kTfLiteBuiltinSub) {
+        z.device(device) = x - y;
+      } else {
+        z.device(device) = x * y;
+      }
+      FinishOutput(nullptr, channels, activation, out, size);
+      break;
+    }
+    case kTfLiteBuiltinRelu:
+    case kTfLiteBuiltinRelu6:
+    case kTfLiteBuiltinLogistic:
+    case kTfLiteBuiltinTanh: {
+      ConstDeviceTensor<1> x(in, size);
+      DeviceTensor<1> y(out, size);
+      if (node.builtin_code == kTfLiteBuiltinRelu) {
+        y.device(device) = x.cwiseMax(0.f);
+      } else if (node.builtin_code == kTfLiteBuiltinRelu6) {
+        y.device(device) = x.cwiseMax(0.f).cwiseMin(6.f);
+      } else if (node.builtin_code == kTfLiteBuiltinLogistic) {
+        y.device(device) = x.sigmoid();
+      } else {
+        y.device(device) = x.tanh();
+      }
+      break;
+    }
+    default:
+      context->ReportError(context, "Node type %d is not supported by SYCL.",
+                           node.builtin_code);
+      return kTfLiteError;
+  }
+  if (status.status != sycldnn::StatusCode::OK) {
+    context->ReportError(context, "SYCL-DNN failed on node type %d: %d",
+                         node.builtin_code, static_cast<int>(status.status));
+    return kTfLiteError;
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus SyclSubgraph::Invoke(TfLiteContext* context) {
+  TfLiteDelegate* delegate = delegate_->tflite_delegate();
+  for (const auto& staged : staged_inputs_) {
+    const TfLiteTensor& tensor = context->tensors[staged.first];
+    if (tensor.delegate == delegate &&
+        tensor.buffer_handle != kTfLiteNullBufferHandle) {
+      // Produced by another subgraph of the delegate, or bound by the caller
+      // with Interpreter::SetBufferHandle: the data is already on the device.
+      const DeviceBuffer* buffer = delegate_->GetBuffer(tensor.buffer_handle);
+      TF_LITE_ENSURE(context, buffer != nullptr);
+      data_[staged.first] = buffer->data;
+    } else {
+      delegate_->CopyToDevice(tensor.data.raw, staged.second, tensor.bytes);
+      data_[staged.first] = staged.second;
+    }
+  }
+
+  TfLiteStatus status = kTfLiteOk;
+  for (const SyclNode& node : nodes_) {
+    status = InvokeNode(context, node);
+    if (status != kTfLiteOk) break;
+  }
+  delegate_->Synchronize();
+
+  // The host data of the outputs is copied on demand by the interpreter.
+  for (int index : outputs_) {
+    context->tensors[index].data_is_stale = true;
+  }
+  return status;
+}
+
+TfLiteRegistration GetSubgraphRegistration() {
+  TfLiteRegistration registration = {nullptr, nullptr, nullptr, nullptr};
+  registration.init = [](TfLiteContext* context, const char* buffer,
+                         size_t length) -> void* {
+    const auto* params = reinterpret_cast<const TfLiteDelegateParams*>(buffer);
+    auto* delegate = static_cast<SyclDelegate*>(params->delegate->data_);
+    std::unique_ptr<SyclSubgraph> subgraph(new SyclSubgraph(delegate));
+    if (subgraph->Init(context, params) != kTfLiteOk) {
+      return nullptr;
+    }
+    return subgraph.release();
+  };
+  registration.free = [](TfLiteContext* context, void* buffer) {
+    delete static_cast<SyclSubgraph*>(buffer);
+  };
+  registration.prepare = [](TfLiteContext* context,
+                            TfLiteNode* node) -> TfLiteStatus {
+    auto* subgraph = static_cast<SyclSubgraph*>(node->user_data);
+    TF_LITE_ENSURE(context, subgraph != nullptr);
+    return subgraph->Prepare(context);
+  };
+  registration.invoke = [](TfLiteContext* context,
+                           TfLiteNode* node) -> TfLiteStatus {
+    return static_cast<SyclSubgraph*>(node->user_data)->Invoke(context);
+  };
+  registration.custom_name = "SyclDelegate";
+  return registration;
+}
+
+TfLiteStatus SyclDelegate::DoPrepare(TfLiteContext* context,
+                                     TfLiteDelegate* delegate) {
+  TfLiteIntArray* execution_plan;
+  TF_LITE_ENSURE_STATUS(context->GetExecutionPlan(context, &execution_plan));
+  std::vector<int> supported_nodes;
+  for (int i = 0; i < execution_plan->size; ++i) {
+    const int node_index = execution_plan->data[i];
+    TfLiteNode* node;
+    TfLiteRegistration* registration;
+    TF_LITE_ENSURE_STATUS(context->GetNodeAndRegistration(
+        context, node_index, &node, &registration));
+    if (IsNodeSupported(context, node, registration)) {
+      supported_nodes.push_back(node_index);
+    }
+  }
+  if (supported_nodes.empty()) {
+    return kTfLiteOk;
+  }
+  TfLiteIntArray* nodes_to_replace =
+      TfLiteIntArrayCreate(supported_nodes.size());
+  std::copy(supported_nodes.begin(), supported_nodes.end(),
+            nodes_to_replace->data);
+  const TfLiteStatus status = context->ReplaceSubgraphsWithDelegateKernels(
+      context, GetSubgraphRegistration(), nodes_to_replace, delegate);
+  TfLiteIntArrayFree(nodes_to_replace);
+  return status;
+}
+
+}  // namespace
+
+TfLiteDelegate* NewSyclDelegate() {
+  return (new SyclDelegate)->tflite_delegate();
+}
+
+void DeleteSyclDelegate(TfLiteDelegate* delegate) {
+  if (delegate != nullptr) {
+    delete static_cast<SyclDelegate*>(delegate->data_);
+  }
+}
+
+#else  // TENSORFLOW_USE_SYCL
+
+TfLiteDelegate* NewSyclDelegate() { return nullptr; }
+
+void DeleteSyclDelegate(TfLiteDelegate* delegate) {}
+
+#endif  // TENSORFLOW_USE_SYCL
+
+}  // namespace tflite
@@ -0,0 +1,50 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CONTRIB_LITE_DELEGATES_SYCL_SYCL_DELEGATE_H_
+#define TENSORFLOW_CONTRIB_LITE_DELEGATES_SYCL_SYCL_DELEGATE_H_
+
+#include "tensorflow/contrib/lite/context.h"
+
+namespace tflite {
+
+// Returns a delegate that runs the float32 CONV_2D, DEPTHWISE_CONV_2D,
+// FULLY_CONNECTED, AVERAGE_POOL_2D, MAX_POOL_2D, ADD, SUB, MUL, RELU, RELU6,
+// LOGISTIC and TANH nodes of a graph on the default SYCL device (e.g. an
+// OpenCL GPU), or nullptr if TensorFlow Lite was built without SYCL support.
+//
+// The tensors produced by a subgraph claimed by the delegate stay in device
+// buffers: a subgraph reads the outputs of another one on the device, and
+// the interpreter copies them to the host through `CopyFromBufferHandle` only
+// when a node running on the CPU or the caller reads them (see
+// Interpreter::EnsureTensorDataIsReadable). Only the tensors crossing the
+// boundary of the delegated subgraphs are copied.
+//
+// Usage:
+//   TfLiteDelegate* delegate = NewSyclDelegate();
+//   if (delegate) interpreter->ModifyGraphWithDelegate(delegate);
+//   ...
+//   // After the interpreter is destroyed.
+//   DeleteSyclDelegate(delegate);
+//
+// WARNING: This is an experimental interface that is subject to change.
+TfLiteDelegate* NewSyclDelegate();
+
+// Destroys a delegate returned by NewSyclDelegate(), which must outlive all
+// the interpreters it was applied to.
+void DeleteSyclDelegate(TfLiteDelegate* delegate);
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_CONTRIB_LITE_DELEGATES_SYCL_SYCL_DELEGATE_H_
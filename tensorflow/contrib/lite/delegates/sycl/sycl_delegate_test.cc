@@ -0,0 +1,111 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/contrib/lite/delegates/sycl/sycl_delegate.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include <gtest/gtest.h>
+#include "tensorflow/contrib/lite/builtin_op_data.h"
+#include "tensorflow/contrib/lite/interpreter.h"
+#include "tensorflow/contrib/lite/kernels/register.h"
+#include "tensorflow/contrib/lite/testing/util.h"
+
+namespace tflite {
+namespace {
+
+constexpr int kNumElements = 6;
+
+// Builds out = exp(relu(a + b)) * a, where the EXP node is not supported by
+// the delegate and splits the graph in two delegated subgraphs.
+void BuildGraph(Interpreter* interpreter) {
+  ops::builtin::BuiltinOpResolver resolver;
+  ASSERT_EQ(interpreter->AddTensors(6), kTfLiteOk);
+  for (int i = 0; i < 6; ++i) {
+    ASSERT_EQ(interpreter->SetTensorParametersReadWrite(
+                  i, kTfLiteFloat32, "", {1, 2, 3}, TfLiteQuantizationParams()),
+              kTfLiteOk);
+  }
+  ASSERT_EQ(interpreter->SetInputs({0, 1}), kTfLiteOk);
+  ASSERT_EQ(interpreter->SetOutputs({5}), kTfLiteOk);
+
+  auto* add_params =
+      reinterpret_cast<TfLiteAddParams*>(malloc(sizeof(TfLiteAddParams)));
+  add_params->activation = kTfLiteActNone;
+  ASSERT_EQ(interpreter->AddNodeWithParameters(
+                {0, 1}, {2}, nullptr, 0, add_params,
+                resolver.FindOp(BuiltinOperator_ADD, 1)),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter->AddNodeWithParameters(
+                {2}, {3}, nullptr, 0, nullptr,
+                resolver.FindOp(BuiltinOperator_RELU, 1)),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter->AddNodeWithParameters(
+                {3}, {4}, nullptr, 0, nullptr,
+                resolver.FindOp(BuiltinOperator_EXP, 1)),
+            kTfLiteOk);
+  auto* mul_params =
+      reinterpret_cast<TfLiteMulParams*>(malloc(sizeof(TfLiteMulParams)));
+  mul_params->activation = kTfLiteActNone;
+  ASSERT_EQ(interpreter->AddNodeWithParameters(
+                {4, 0}, {5}, nullptr, 0, mul_params,
+                resolver.FindOp(BuiltinOperator_MUL, 1)),
+            kTfLiteOk);
+}
+
+TEST(SyclDelegateTest, MixedGraph) {
+  TfLiteDelegate* delegate = NewSyclDelegate();
+  if (delegate == nullptr) {
+    // Built without SYCL support.
+    return;
+  }
+  {
+    Interpreter interpreter;
+    BuildGraph(&interpreter);
+    ASSERT_EQ(interpreter.ModifyGraphWithDelegate(delegate), kTfLiteOk);
+    // ADD and RELU, EXP, and MUL.
+    ASSERT_EQ(interpreter.execution_plan().size(), 3);
+    EXPECT_EQ(interpreter.tensor(3)->delegate, delegate);
+    EXPECT_EQ(interpreter.tensor(4)->delegate, nullptr);
+    EXPECT_EQ(interpreter.tensor(5)->delegate, delegate);
+
+    const float a[kNumElements] = {-2.f, -1.f, 0.f, 1.f, 2.f, 3.f};
+    const float b[kNumElements] = {1.f, -1.f, 0.5f, 0.5f, -3.f, 1.f};
+    for (int step = 0; step < 2; ++step) {
+      for (int i = 0; i < kNumElements; ++i) {
+        interpreter.typed_tensor<float>(0)[i] = a[i] * (step + 1);
+        interpreter.typed_tensor<float>(1)[i] = b[i];
+      }
+      ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+      const float* out = interpreter.typed_tensor<float>(5);
+      for (int i = 0; i < kNumElements; ++i) {
+        const float x = a[i] * (step + 1);
+        const float expected = std::exp(std::max(x + b[i], 0.f)) * x;
+        EXPECT_NEAR(out[i], expected, 1e-4f * std::abs(expected) + 1e-5f);
+      }
+    }
+  }
+  DeleteSyclDelegate(delegate);
+}
+
+}  // namespace
+}  // namespace tflite
+
+int main(int argc, char** argv) {
+  ::tflite::LogToStderr();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
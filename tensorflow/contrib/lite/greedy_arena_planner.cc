@@ -0,0 +1,307 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/contrib/lite/greedy_arena_planner.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace tflite {
+
+namespace {
+
+// Memory allocation tuning, as in ArenaPlanner.
+constexpr const int kDefaultArenaAlignment = 64;
+constexpr const int kDefaultTensorAlignment = 4;
+
+// Value of the first and last uses of the tensors that are not used by any
+// node, and are therefore not allocated.
+constexpr const int kNotUsed = -1;
+
+template <typename T>
+T AlignTo(size_t alignment, T offset) {
+  return offset % alignment == 0 ? offset
+                                 : offset + (alignment - offset % alignment);
+}
+
+}  // namespace
+
+GreedyArenaPlanner::GreedyArenaPlanner(TfLiteContext* context,
+                                       std::unique_ptr<GraphInfo> graph_info)
+    : context_(context),
+      graph_info_(std::move(graph_info)),
+      arena_size_(0),
+      buffer_size_(0),
+      aligned_buffer_(nullptr),
+      persistent_arena_(kDefaultArenaAlignment) {}
+
+GreedyArenaPlanner::~GreedyArenaPlanner() {}
+
+int64_t GreedyArenaPlanner::BasePointer(TfLiteAllocationType type) {
+  if (type == kTfLiteArenaRwPersistent) {
+    return persistent_arena_.BasePointer();
+  }
+  if (type == kTfLiteArenaRw) {
+    return reinterpret_cast<int64_t>(aligned_buffer_);
+  }
+  return 0;
+}
+
+size_t GreedyArenaPlanner::GetAllocatedBytes(TfLiteAllocationType type) const {
+  if (type == kTfLiteArenaRwPersistent) {
+    return persistent_arena_.BufferSize();
+  }
+  if (type == kTfLiteArenaRw) {
+    return buffer_size_;
+  }
+  return 0;
+}
+
+MemoryPlan GreedyArenaPlanner::GetMemoryPlan() const {
+  MemoryPlan plan;
+  plan.offsets = offsets_;
+  plan.sizes = sizes_;
+  return plan;
+}
+
+TfLiteStatus GreedyArenaPlanner::ResetAllocations() {
+  TF_LITE_ENSURE_STATUS(persistent_arena_.Clear());
+  const size_t num_tensors = graph_info_->num_tensors();
+  offsets_.assign(num_tensors, MemoryPlan::kNotPlanned);
+  sizes_.assign(num_tensors, 0);
+  placed_tensors_.clear();
+  arena_size_ = 0;
+  persistent_allocs_.assign(num_tensors, ArenaAlloc());
+  is_persistent_allocated_.assign(num_tensors, false);
+  return kTfLiteOk;
+}
+
+TfLiteStatus GreedyArenaPlanner::PlanAllocations() {
+  // Invalidate any existing data.
+  TF_LITE_ENSURE_STATUS(ResetAllocations());
+
+  const int num_nodes = graph_info_->num_nodes();
+  first_use_.assign(graph_info_->num_tensors(), kNotUsed);
+  last_use_.assign(graph_info_->num_tensors(), kNotUsed);
+
+  // Graph inputs are alive from the start.
+  for (int tensor_index : graph_info_->inputs()) {
+    if (tensor_index != kOptionalTensor) {
+      first_use_[tensor_index] = 0;
+      last_use_[tensor_index] = 0;
+    }
+  }
+
+  // A tensor is alive from the node that produces it to the last node that
+  // consumes it.
+  for (int i = 0; i < num_nodes; ++i) {
+    const TfLiteNode& node = graph_info_->node(i);
+    TfLiteIntArray* node_outputs = node.outputs;
+    for (int j = 0; j < node_outputs->size; ++j) {
+      int tensor_index = node_outputs->data[j];
+      if (first_use_[tensor_index] == kNotUsed) {
+        first_use_[tensor_index] = i;
+      }
+      last_use_[tensor_index] = std::max(last_use_[tensor_index], i);
+    }
+    TfLiteIntArray* node_inputs = node.inputs;
+    for (int j = 0; j < node_inputs->size; ++j) {
+      int tensor_index = node_inputs->data[j];
+      if (tensor_index != kOptionalTensor) {
+        last_use_[tensor_index] = std::max(last_use_[tensor_index], i);
+      }
+    }
+  }
+
+  // We must make sure the output tensors are never overwritten, so they stay
+  // alive after the last node.
+  for (int tensor_index : graph_info_->outputs()) {
+    last_use_[tensor_index] = num_nodes;
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus GreedyArenaPlanner::ExecuteAllocations(int first_node,
+                                                    int last_node) {
+  // Grow the per-tensor state if necessary. This allows allocating temporary
+  // tensors in op's `prepare` function.
+  const size_t num_tensors = graph_info_->num_tensors();
+  TF_LITE_ENSURE(context_, num_tensors >= offsets_.size());
+  first_use_.resize(num_tensors, kNotUsed);
+  last_use_.resize(num_tensors, kNotUsed);
+  offsets_.resize(num_tensors, MemoryPlan::kNotPlanned);
+  sizes_.resize(num_tensors, 0);
+  persistent_allocs_.resize(num_tensors);
+  is_persistent_allocated_.resize(num_tensors, false);
+
+  // The temporaries of a node are only alive while it runs.
+  const int num_nodes = graph_info_->num_nodes();
+  for (int i = first_node; i <= last_node && i < num_nodes; ++i) {
+    TfLiteIntArray* node_temporaries = graph_info_->node(i).temporaries;
+    for (int j = 0; j < node_temporaries->size; ++j) {
+      int tensor_index = node_temporaries->data[j];
+      first_use_[tensor_index] = i;
+      last_use_[tensor_index] = i;
+    }
+  }
+
+  TF_LITE_ENSURE_STATUS(CalculateAllocations(first_node, last_node));
+  TF_LITE_ENSURE_STATUS(Commit());
+
+  for (int i = 0; i < num_tensors; ++i) {
+    TfLiteTensor& tensor = *graph_info_->tensor(i);
+    if (tensor.allocation_type == kTfLiteArenaRw &&
+        offsets_[i] != MemoryPlan::kNotPlanned) {
+      tensor.data.raw = aligned_buffer_ + offsets_[i];
+    }
+    if (tensor.allocation_type == kTfLiteArenaRwPersistent &&
+        is_persistent_allocated_[i]) {
+      TF_LITE_ENSURE_STATUS(persistent_arena_.ResolveAlloc(
+          context_, persistent_allocs_[i], &tensor.data.raw));
+    }
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus GreedyArenaPlanner::CalculateAllocations(int first_node,
+                                                      int last_node) {
+  std::vector<int> tensors_to_place;
+  for (int i = 0; i < graph_info_->num_tensors(); ++i) {
+    if (first_use_[i] == kNotUsed || first_use_[i] > last_node) {
+      continue;
+    }
+    TfLiteTensor& tensor = *graph_info_->tensor(i);
+    if (tensor.allocation_type == kTfLiteArenaRwPersistent &&
+        !is_persistent_allocated_[i]) {
+      TF_LITE_ENSURE_STATUS(
+          persistent_arena_.Allocate(context_, kDefaultTensorAlignment,
+                                     tensor.bytes, &persistent_allocs_[i]));
+      is_persistent_allocated_[i] = true;
+    }
+    // Tensors of size zero are left as nullptr.
+    if (tensor.allocation_type == kTfLiteArenaRw &&
+        offsets_[i] == MemoryPlan::kNotPlanned && tensor.bytes != 0) {
+      tensors_to_place.push_back(i);
+    }
+  }
+
+  auto place = [this](int tensor_index, int64_t offset) {
+    offsets_[tensor_index] = offset;
+    sizes_[tensor_index] = graph_info_->tensor(tensor_index)->bytes;
+    placed_tensors_.push_back(tensor_index);
+    arena_size_ =
+        std::max<size_t>(arena_size_, offset + sizes_[tensor_index]);
+  };
+
+  // Use the offline plan for the tensors it covers first, so that the others
+  // don't take their places.
+  std::vector<int> tensors_to_plan;
+  for (int tensor_index : tensors_to_place) {
+    const int64_t size = graph_info_->tensor(tensor_index)->bytes;
+    if (tensor_index < offline_plan_.offsets.size() &&
+        tensor_index < offline_plan_.sizes.size() &&
+        offline_plan_.sizes[tensor_index] == size) {
+      const int64_t offset = offline_plan_.offsets[tensor_index];
+      if (offset >= 0 && offset % kDefaultTensorAlignment == 0 &&
+          IsFree(tensor_index, offset, size)) {
+        place(tensor_index, offset);
+        continue;
+      }
+    }
+    tensors_to_plan.push_back(tensor_index);
+  }
+
+  // Place the largest tensors first, as they are the hardest to fit.
+  std::stable_sort(tensors_to_plan.begin(), tensors_to_plan.end(),
+                   [this](int a, int b) {
+                     return graph_info_->tensor(a)->bytes >
+                            graph_info_->tensor(b)->bytes;
+                   });
+  for (int tensor_index : tensors_to_plan) {
+    place(tensor_index, FindBestOffset(tensor_index));
+  }
+  return kTfLiteOk;
+}
+
+bool GreedyArenaPlanner::IsFree(int tensor_index, int64_t offset,
+                                int64_t size) const {
+  for (int other : placed_tensors_) {
+    const bool lifetimes_overlap =
+        first_use_[other] <= last_use_[tensor_index] &&
+        first_use_[tensor_index] <= last_use_[other];
+    if (lifetimes_overlap && offsets_[other] < offset + size &&
+        offset < offsets_[other] + sizes_[other]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int64_t GreedyArenaPlanner::FindBestOffset(int tensor_index) const {
+  // The intervals of the arena used by the tensors alive at the same time.
+  std::vector<std::pair<int64_t, int64_t>> used;
+  for (int other : placed_tensors_) {
+    if (first_use_[other] <= last_use_[tensor_index] &&
+        first_use_[tensor_index] <= last_use_[other]) {
+      used.emplace_back(offsets_[other], offsets_[other] + sizes_[other]);
+    }
+  }
+  std::sort(used.begin(), used.end());
+
+  // Take the smallest gap between them that is large enough, or the end of
+  // the used part of the arena.
+  const int64_t size = graph_info_->tensor(tensor_index)->bytes;
+  int64_t best_offset = MemoryPlan::kNotPlanned;
+  int64_t best_gap = std::numeric_limits<int64_t>::max();
+  int64_t current_offset = 0;
+  for (const auto& interval : used) {
+    const int64_t aligned_offset =
+        AlignTo(kDefaultTensorAlignment, current_offset);
+    const int64_t gap = interval.first - current_offset;
+    if (aligned_offset + size <= interval.first && gap < best_gap) {
+      best_offset = aligned_offset;
+      best_gap = gap;
+    }
+    current_offset = std::max(current_offset, interval.second);
+  }
+  if (best_offset == MemoryPlan::kNotPlanned) {
+    best_offset = AlignTo(kDefaultTensorAlignment, current_offset);
+  }
+  return best_offset;
+}
+
+TfLiteStatus GreedyArenaPlanner::Commit() {
+  const size_t required_size = kDefaultArenaAlignment + arena_size_;
+  if (required_size > buffer_size_) {
+    char* new_buffer = new char[required_size];
+    char* new_aligned_buffer = reinterpret_cast<char*>(AlignTo(
+        kDefaultArenaAlignment, reinterpret_cast<intptr_t>(new_buffer)));
+    // Tensors placed in an earlier step may hold data already. Since they are
+    // located by their offsets, they remain valid in the new buffer.
+    if (aligned_buffer_ != nullptr) {
+      const size_t old_size = buffer_.get() + buffer_size_ - aligned_buffer_;
+      memcpy(new_aligned_buffer, aligned_buffer_,
+             std::min(old_size, arena_size_));
+    }
+    buffer_.reset(new_buffer);
+    buffer_size_ = required_size;
+    aligned_buffer_ = new_aligned_buffer;
+  }
+  TF_LITE_ENSURE_STATUS(persistent_arena_.Commit(context_));
+  return kTfLiteOk;
+}
+
+}  // namespace tflite
@@ -0,0 +1,119 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CONTRIB_LITE_GREEDY_ARENA_PLANNER_H_
+#define TENSORFLOW_CONTRIB_LITE_GREEDY_ARENA_PLANNER_H_
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/contrib/lite/context.h"
+#include "tensorflow/contrib/lite/graph_info.h"
+#include "tensorflow/contrib/lite/memory_plan.h"
+#include "tensorflow/contrib/lite/memory_planner.h"
+#include "tensorflow/contrib/lite/simple_memory_arena.h"
+
+namespace tflite {
+
+// A memory planner that assigns the offsets of all the tensors in the arena at
+// once, instead of in execution order like ArenaPlanner.
+//
+// The lifetime of each tensor, from the node that produces it to the last
+// node that consumes it, is known after PlanAllocations(). The tensors are
+// then placed by decreasing size, each one in the smallest gap left by the
+// already placed tensors whose lifetimes overlap its own. This usually gets
+// much closer to the peak of the live tensors than the first-fit allocation
+// of ArenaPlanner.
+//
+// The offsets can also come from a MemoryPlan computed ahead of time (see
+// GetMemoryPlan()), in which case no planning happens at all, as long as the
+// sizes of the tensors did not change.
+//
+// As with ArenaPlanner, dynamic tensors make the interpreter execute the
+// allocations in several steps. The tensors placed in an earlier step keep
+// their offsets, and the new ones are placed around them.
+class GreedyArenaPlanner : public MemoryPlanner {
+ public:
+  // Ownership of 'context' is not taken and it must remain until the
+  // GreedyArenaPlanner is destroyed.
+  GreedyArenaPlanner(TfLiteContext* context,
+                     std::unique_ptr<GraphInfo> graph_info);
+  ~GreedyArenaPlanner() override;
+  GreedyArenaPlanner(const GreedyArenaPlanner&) = delete;
+  GreedyArenaPlanner& operator=(const GreedyArenaPlanner&) = delete;
+
+  TfLiteStatus ResetAllocations() override;
+  TfLiteStatus PlanAllocations() override;
+  TfLiteStatus ExecuteAllocations(int first_node, int last_node) override;
+  size_t GetAllocatedBytes(TfLiteAllocationType type) const override;
+
+  // Returns the base arena location for a given allocation type.
+  int64_t BasePointer(TfLiteAllocationType type);
+
+  // Sets the offsets to use instead of planning them, for the tensors whose
+  // size matches the plan.
+  void SetOfflinePlan(const MemoryPlan& plan) { offline_plan_ = plan; }
+
+  // Returns the offsets of the tensors currently placed in the arena.
+  MemoryPlan GetMemoryPlan() const;
+
+ private:
+  // Places the kTfLiteArenaRw tensors needed by the nodes in the interval
+  // [first_node, last_node] that are not placed yet.
+  TfLiteStatus CalculateAllocations(int first_node, int last_node);
+
+  // Returns whether [offset, offset + size) is free during the lifetime of
+  // `tensor_index`.
+  bool IsFree(int tensor_index, int64_t offset, int64_t size) const;
+
+  // Returns the offset of the smallest gap that can hold `tensor_index`.
+  int64_t FindBestOffset(int tensor_index) const;
+
+  // Make sure the arenas have reserved enough memory to store all their
+  // tensors.
+  TfLiteStatus Commit();
+
+  TfLiteContext* context_;
+  std::unique_ptr<GraphInfo> graph_info_;
+
+  // The first and last nodes using each tensor.
+  std::vector<int> first_use_;
+  std::vector<int> last_use_;
+
+  // The offset of each kTfLiteArenaRw tensor in the arena, or
+  // MemoryPlan::kNotPlanned, and the size it was placed with.
+  std::vector<int64_t> offsets_;
+  std::vector<int64_t> sizes_;
+  // The tensors placed in the arena, in the order they were placed.
+  std::vector<int> placed_tensors_;
+  size_t arena_size_;
+
+  // Raw memory buffer for the kTfLiteArenaRw tensors. It is grown when a step
+  // of the allocations needs a larger arena, keeping the data of the tensors
+  // already placed.
+  std::unique_ptr<char[]> buffer_;
+  size_t buffer_size_;
+  char* aligned_buffer_;
+
+  // Stores the allocations of the persistent tensors, which are never freed.
+  std::vector<ArenaAlloc> persistent_allocs_;
+  std::vector<bool> is_persistent_allocated_;
+  SimpleMemoryArena persistent_arena_;
+
+  MemoryPlan offline_plan_;
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_CONTRIB_LITE_GREEDY_ARENA_PLANNER_H_
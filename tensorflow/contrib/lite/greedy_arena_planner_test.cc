@@ -0,0 +1,397 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/contrib/lite/greedy_arena_planner.h"
+
+#include <algorithm>
+#include <cstdarg>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorflow/contrib/lite/arena_planner.h"
+#include "tensorflow/contrib/lite/testing/util.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tflite {
+namespace {
+
+// A simple op to be used in tests, as syntactic sugar.
+class TestOp {
+ public:
+  TestOp(std::initializer_list<int> inputs, std::initializer_list<int> outputs,
+         std::initializer_list<int> temporaries)
+      : inputs_(inputs), outputs_(outputs), temporaries_(temporaries) {}
+
+  const std::vector<int>& inputs() const { return inputs_; }
+  const std::vector<int>& outputs() const { return outputs_; }
+  const std::vector<int>& temporaries() const { return temporaries_; }
+
+ private:
+  std::vector<int> inputs_;
+  std::vector<int> outputs_;
+  std::vector<int> temporaries_;
+};
+
+// A test graph where inputs are processed by the given nodes to produce
+// outputs.
+class TestGraph {
+ public:
+  TestGraph(std::initializer_list<int> inputs,
+            std::initializer_list<TestOp> nodes,
+            std::initializer_list<int> outputs)
+      : inputs_(inputs), outputs_(outputs) {
+    int max_tensor_index = 0;
+
+    for (int t : inputs) {
+      max_tensor_index = std::max(max_tensor_index, t);
+    }
+    for (int t : outputs) {
+      max_tensor_index = std::max(max_tensor_index, t);
+    }
+    for (const auto& node : nodes) {
+      auto int_array = [](const std::vector<int>& x) {
+        TfLiteIntArray* lite = TfLiteIntArrayCreate(x.size());
+        for (size_t i = 0; i < x.size(); i++) lite->data[i] = x[i];
+        return lite;
+      };
+
+      nodes_.push_back(TfLiteNode());
+      nodes_.back().inputs = int_array(node.inputs());
+      for (int t : node.inputs()) {
+        max_tensor_index = std::max(max_tensor_index, t);
+      }
+      nodes_.back().outputs = int_array(node.outputs());
+      for (int t : node.outputs()) {
+        max_tensor_index = std::max(max_tensor_index, t);
+      }
+      nodes_.back().temporaries = int_array(node.temporaries());
+      for (int t : node.temporaries()) {
+        max_tensor_index = std::max(max_tensor_index, t);
+      }
+    }
+
+    for (int i = 0; i <= max_tensor_index; ++i) {
+      tensors_.push_back(TfLiteTensor());
+      // Set some default values for allocation_type and bytes, which are the
+      // only fields used by the arena planner.
+      tensors_.back().allocation_type = kTfLiteArenaRw;
+      tensors_.back().bytes = (i + 1) * 3;
+    }
+  }
+
+  ~TestGraph() {
+    for (auto node : nodes_) {
+      TfLiteIntArrayFree(node.inputs);
+      TfLiteIntArrayFree(node.outputs);
+      TfLiteIntArrayFree(node.temporaries);
+    }
+  }
+
+  const std::vector<TfLiteNode>& nodes() { return nodes_; }
+  std::vector<TfLiteTensor>* tensors() { return &tensors_; }
+  const std::vector<int>& inputs() { return inputs_; }
+  const std::vector<int>& outputs() { return outputs_; }
+
+ private:
+  std::vector<TfLiteNode> nodes_;
+  std::vector<TfLiteTensor> tensors_;
+  std::vector<int> inputs_;
+  std::vector<int> outputs_;
+};
+
+// The GraphInfo for a TestGraph.
+class TestGraphInfo : public GraphInfo {
+ public:
+  explicit TestGraphInfo(TestGraph* graph) : graph_(graph) {}
+
+  size_t num_tensors() const override { return graph_->tensors()->size(); }
+  TfLiteTensor* tensor(size_t index) override {
+    return &graph_->tensors()->at(index);
+  }
+  size_t num_nodes() const override { return graph_->nodes().size(); }
+  const TfLiteNode& node(size_t index) const override {
+    return graph_->nodes()[index];
+  }
+  const std::vector<int>& inputs() const override { return graph_->inputs(); }
+  const std::vector<int>& outputs() const override { return graph_->outputs(); }
+
+ private:
+  TestGraph* graph_;
+};
+
+void ReportError(TfLiteContext* context, const char* format, ...) {
+  const size_t kBufferSize = 1024;
+  char temp_buffer[kBufferSize];
+
+  va_list args;
+  va_start(args, format);
+  vsnprintf(temp_buffer, kBufferSize, format, args);
+  va_end(args);
+
+  LOG(INFO) << temp_buffer;
+}
+
+class GreedyArenaPlannerTest : public ::testing::Test {
+ protected:
+  void SetGraph(TestGraph* graph, const MemoryPlan* offline_plan = nullptr) {
+    graph_ = graph;
+    context_.ReportError = ReportError;
+    planner_.reset(new GreedyArenaPlanner(
+        &context_, std::unique_ptr<GraphInfo>(new TestGraphInfo(graph))));
+    if (offline_plan) planner_->SetOfflinePlan(*offline_plan);
+    CHECK(planner_->ResetAllocations() == kTfLiteOk);
+    CHECK(planner_->PlanAllocations() == kTfLiteOk);
+  }
+
+  void Execute(int start, int end) {
+    CHECK(planner_->ExecuteAllocations(start, end) == kTfLiteOk);
+  }
+
+  // Returns the actual offset of a given tensor, relative to the start of its
+  // arena.
+  int64_t GetOffset(int tensor_index) {
+    const TfLiteTensor& tensor = (*graph_->tensors())[tensor_index];
+    return reinterpret_cast<int64_t>(tensor.data.raw) -
+           planner_->BasePointer(tensor.allocation_type);
+  }
+
+  // Returns whether two tensors share some bytes of the same arena.
+  bool Overlap(int a, int b) {
+    const TfLiteTensor& tensor_a = (*graph_->tensors())[a];
+    const TfLiteTensor& tensor_b = (*graph_->tensors())[b];
+    return tensor_a.allocation_type == tensor_b.allocation_type &&
+           GetOffset(a) < GetOffset(b) + tensor_b.bytes &&
+           GetOffset(b) < GetOffset(a) + tensor_a.bytes;
+  }
+
+  // Checks that no two tensors alive at the same time share memory. A tensor
+  // is alive from the node producing it, or the start for the graph inputs,
+  // to the last node consuming it, or the end for the graph outputs.
+  void ExpectNoConflicts() {
+    const int num_nodes = graph_->nodes().size();
+    const int num_tensors = graph_->tensors()->size();
+    std::vector<int> first(num_tensors, -1);
+    std::vector<int> last(num_tensors, -1);
+    for (int t : graph_->inputs()) first[t] = last[t] = 0;
+    for (int i = 0; i < num_nodes; ++i) {
+      const TfLiteNode& node = graph_->nodes()[i];
+      for (int j = 0; j < node.outputs->size; ++j) {
+        int t = node.outputs->data[j];
+        if (first[t] == -1) first[t] = i;
+        last[t] = std::max(last[t], i);
+      }
+      for (int j = 0; j < node.temporaries->size; ++j) {
+        first[node.temporaries->data[j]] = last[node.temporaries->data[j]] = i;
+      }
+      for (int j = 0; j < node.inputs->size; ++j) {
+        int t = node.inputs->data[j];
+        if (t >= 0) last[t] = std::max(last[t], i);
+      }
+    }
+    for (int t : graph_->outputs()) last[t] = num_nodes;
+
+    for (int a = 0; a < num_tensors; ++a) {
+      for (int b = a + 1; b < num_tensors; ++b) {
+        if (first[a] == -1 || first[b] == -1) continue;
+        if (first[a] <= last[b] && first[b] <= last[a]) {
+          EXPECT_FALSE(Overlap(a, b)) << "tensors " << a << " and " << b;
+        }
+      }
+    }
+  }
+
+  TfLiteContext context_;
+  TestGraph* graph_;
+  std::unique_ptr<GreedyArenaPlanner> planner_;
+};
+
+// Returns the size of the arena ArenaPlanner needs for the graph.
+size_t GetArenaPlannerBytes(TestGraph* graph) {
+  TfLiteContext context;
+  context.ReportError = ReportError;
+  ArenaPlanner planner(&context,
+                       std::unique_ptr<GraphInfo>(new TestGraphInfo(graph)));
+  CHECK(planner.ResetAllocations() == kTfLiteOk);
+  CHECK(planner.PlanAllocations() == kTfLiteOk);
+  CHECK(planner.ExecuteAllocations(0, 10) == kTfLiteOk);
+  return planner.GetAllocatedBytes(kTfLiteArenaRw);
+}
+
+TEST_F(GreedyArenaPlannerTest, EmptyGraph) {
+  TestGraph graph({}, {}, {});
+  SetGraph(&graph);
+  Execute(0, 10);
+}
+
+TEST_F(GreedyArenaPlannerTest, GraphWithOneOp) {
+  TestGraph graph({1}, {{{1}, {2}, {}}}, {2});
+  SetGraph(&graph);
+  Execute(0, 10);
+  // The largest tensor is placed first.
+  EXPECT_EQ(GetOffset(2), 0);
+  EXPECT_EQ(GetOffset(1), 12);
+}
+
+TEST_F(GreedyArenaPlannerTest, ZeroSizedTensors) {
+  TestGraph graph({1}, {{{1}, {2}, {}}}, {2});
+  (*graph.tensors())[1].bytes = 0;
+  SetGraph(&graph);
+  Execute(0, 10);
+  EXPECT_TRUE((*graph.tensors())[1].data.raw == nullptr);
+  EXPECT_EQ(GetOffset(2), 0);
+}
+
+TEST_F(GreedyArenaPlannerTest, SimpleGraph) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},     // First op
+                      {{2, 0}, {4, 5}, {}},  // Second op
+                      {{4, 5}, {3}, {}}      // Third op
+                  },
+                  {3});
+  SetGraph(&graph);
+  Execute(0, 10);
+  ExpectNoConflicts();
+  EXPECT_LE(planner_->GetAllocatedBytes(kTfLiteArenaRw),
+            GetArenaPlannerBytes(&graph));
+}
+
+TEST_F(GreedyArenaPlannerTest, SimpleGraphWithTemporary) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},   // First op
+                      {{2, 0}, {4}, {5}},  // Second op, with temporary
+                      {{4}, {3}, {}}       // Third op
+                  },
+                  {3});
+  SetGraph(&graph);
+  Execute(0, 10);
+  ExpectNoConflicts();
+  // #5 is the largest tensor.
+  EXPECT_EQ(GetOffset(5), 0);
+  // #3 can take the place of the temporary.
+  EXPECT_EQ(GetOffset(3), 0);
+}
+
+TEST_F(GreedyArenaPlannerTest, PersistentTensors) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},   // First op
+                      {{2, 0}, {4}, {5}},  // Second op, with persistent
+                      {{4}, {3}, {}}       // Third op
+                  },
+                  {3});
+  (*graph.tensors())[5].allocation_type = kTfLiteArenaRwPersistent;
+  SetGraph(&graph);
+  Execute(0, 10);
+  ExpectNoConflicts();
+  EXPECT_EQ(GetOffset(5), 0);
+  EXPECT_GE(planner_->GetAllocatedBytes(kTfLiteArenaRwPersistent), 18);
+}
+
+TEST_F(GreedyArenaPlannerTest, LargerGraphAndStepwiseAllocation) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2, 3}, {}},
+                      {{2, 0}, {4, 5}, {6}},
+                      {{1, -1}, {7}, {}},
+                      {{7, 3}, {8}, {9}},
+                      {{4, 5, 8}, {10}, {}},
+                  },
+                  {10});
+  SetGraph(&graph);
+
+  Execute(0, 0);
+  const int64_t offset_0 = GetOffset(0);
+  const int64_t offset_3 = GetOffset(3);
+  EXPECT_TRUE((*graph.tensors())[4].data.raw == nullptr);
+  EXPECT_TRUE((*graph.tensors())[10].data.raw == nullptr);
+
+  Execute(1, 2);
+  Execute(3, 4);
+  // The tensors placed in an earlier step keep their offsets.
+  EXPECT_EQ(GetOffset(0), offset_0);
+  EXPECT_EQ(GetOffset(3), offset_3);
+  ExpectNoConflicts();
+}
+
+TEST_F(GreedyArenaPlannerTest, SmallerThanArenaPlanner) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2, 3}, {}},
+                      {{2, 0}, {4, 5}, {6}},
+                      {{1, -1}, {7}, {}},
+                      {{7, 3}, {8}, {9}},
+                      {{4, 5, 8}, {10}, {}},
+                  },
+                  {10});
+  SetGraph(&graph);
+  Execute(0, 10);
+  ExpectNoConflicts();
+  EXPECT_LT(planner_->GetAllocatedBytes(kTfLiteArenaRw),
+            GetArenaPlannerBytes(&graph));
+}
+
+TEST_F(GreedyArenaPlannerTest, OfflinePlan) {
+  TestGraph graph({1}, {{{1}, {2}, {}}}, {2});
+  MemoryPlan plan;
+  plan.offsets = {MemoryPlan::kNotPlanned, 0, 8};
+  plan.sizes = {0, 6, 9};
+  SetGraph(&graph, &plan);
+  Execute(0, 10);
+  EXPECT_EQ(GetOffset(1), 0);
+  EXPECT_EQ(GetOffset(2), 8);
+
+  MemoryPlan memory_plan = planner_->GetMemoryPlan();
+  EXPECT_EQ(memory_plan.offsets, plan.offsets);
+  EXPECT_EQ(memory_plan.sizes, plan.sizes);
+}
+
+TEST_F(GreedyArenaPlannerTest, OfflinePlanIgnoredForOtherSizes) {
+  TestGraph graph({1}, {{{1}, {2}, {}}}, {2});
+  MemoryPlan plan;
+  plan.offsets = {MemoryPlan::kNotPlanned, 0, 8};
+  plan.sizes = {0, 6, 9};
+  (*graph.tensors())[2].bytes = 16;
+  SetGraph(&graph, &plan);
+  Execute(0, 10);
+  // #1 is placed as planned, but #2 is now too large for its planned offset.
+  EXPECT_EQ(GetOffset(1), 0);
+  EXPECT_EQ(GetOffset(2), 8);
+  EXPECT_FALSE(Overlap(1, 2));
+}
+
+TEST_F(GreedyArenaPlannerTest, OfflinePlanWithConflicts) {
+  TestGraph graph({1}, {{{1}, {2}, {}}}, {2});
+  MemoryPlan plan;
+  plan.offsets = {MemoryPlan::kNotPlanned, 0, 0};
+  plan.sizes = {0, 6, 9};
+  SetGraph(&graph, &plan);
+  Execute(0, 10);
+  EXPECT_FALSE(Overlap(1, 2));
+}
+
+}  // namespace
+}  // namespace tflite
+
+int main(int argc, char** argv) {
+  ::tflite::LogToStderr();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
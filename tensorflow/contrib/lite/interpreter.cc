@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/contrib/lite/context.h"
 #include "tensorflow/contrib/lite/error_reporter.h"
 #include "tensorflow/contrib/lite/graph_info.h"
+#include "tensorflow/contrib/lite/greedy_arena_planner.h"
 #include "tensorflow/contrib/lite/kernels/eigen_support.h"
 #include "tensorflow/contrib/lite/kernels/gemm_support.h"
 #include "tensorflow/contrib/lite/memory_planner.h"
@@ -98,6 +99,7 @@ Interpreter::Interpreter(ErrorReporter* error_reporter)
   context_.tensors_size = 0;
   context_.eigen_context = nullptr;
   context_.gemm_context = nullptr;
+  context_.weight_cache = nullptr;
   context_.recommended_num_threads = -1;
 
   // Invalid to call these these except from TfLiteDelegate
@@ -292,6 +294,7 @@ TfLiteStatus Interpreter::SetInputs(std::vector<int> inputs) {
   TF_LITE_ENSURE_OK(&context_,
                     CheckTensorIndices("inputs", inputs.data(), inputs.size()));
   inputs_ = std::move(inputs);
+  ops_prepared_ = false;
   return kTfLiteOk;
 }
 
@@ -299,6 +302,7 @@ TfLiteStatus Interpreter::SetOutputs(std::vector<int> outputs) {
   TF_LITE_ENSURE_OK(
       &context_, CheckTensorIndices("outputs", outputs.data(), outputs.size()));
   outputs_ = std::move(outputs);
+  ops_prepared_ = false;
   return kTfLiteOk;
 }
 
@@ -366,12 +370,26 @@ TfLiteStatus Interpreter::AllocateTensors() {
     return kTfLiteError;
   }
 
-  TF_LITE_ENSURE_STATUS(PrepareOpsAndTensors());
+  // If only inputs were resized since all the ops were prepared, the ops
+  // whose input shapes didn't change don't need to be prepared again.
+  const bool only_inputs_resized = ops_prepared_ && !resized_inputs_.empty();
+  std::vector<int> resized_inputs;
+  resized_inputs.swap(resized_inputs_);
+  ops_prepared_ = false;
+  bool prepared = false;
+  if (only_inputs_resized) {
+    TF_LITE_ENSURE_STATUS(PrepareResizedOps(resized_inputs, &prepared));
+  }
+  if (!prepared) {
+    TF_LITE_ENSURE_STATUS(PrepareOpsAndTensors());
+  }
   if (state_ == kStateUninvokable) {
     state_ = kStateInvokable;
   }
   TF_LITE_ENSURE(&context_, state_ == kStateInvokable ||
                                 state_ == kStateInvokableAndImmutable);
+  ops_prepared_ =
+      next_execution_plan_index_to_prepare_ == execution_plan_.size();
   return kTfLiteOk;
 }
 
@@ -385,6 +403,7 @@ TfLiteStatus Interpreter::AddNodeWithParameters(
     return kTfLiteError;
   }
   state_ = kStateUninvokable;
+  ops_prepared_ = false;
 
   std::unique_ptr<void, decltype(free)*> builtin_data_deleter(builtin_data,
                                                               free);
@@ -452,7 +471,10 @@ TfLiteStatus Interpreter::ResizeInputTensor(int tensor_index,
   TF_LITE_ENSURE(&context_,
                  tensor_index < context_.tensors_size && tensor_index >= 0);
   TfLiteIntArray* dims_lite = ConvertVectorToTfLiteIntArray(dims);
-  return ResizeTensorImpl(&context_.tensors[tensor_index], dims_lite);
+  TF_LITE_ENSURE_STATUS(
+      ResizeTensorImpl(&context_.tensors[tensor_index], dims_lite));
+  if (ops_prepared_) resized_inputs_.push_back(tensor_index);
+  return kTfLiteOk;
 }
 
 // Returns true if at least one tensor in the given list is kTfLiteDynamic.
@@ -492,10 +514,94 @@ TfLiteStatus Interpreter::PrepareOpsStartingAt(
   return kTfLiteOk;
 }
 
+TfLiteStatus Interpreter::PrepareResizedOps(
+    const std::vector<int>& resized_tensors, bool* prepared) {
+  *prepared = false;
+  std::vector<bool> changed(context_.tensors_size, false);
+  for (int tensor_index : resized_tensors) {
+    changed[tensor_index] = true;
+  }
+  auto is_changed = [&changed](int tensor_index) {
+    return tensor_index != kOptionalTensor && tensor_index < changed.size() &&
+           changed[tensor_index];
+  };
+
+  for (int execution_plan_index = 0;
+       execution_plan_index < execution_plan_.size(); execution_plan_index++) {
+    int node_index = execution_plan_[execution_plan_index];
+    TfLiteNode& node = nodes_and_registration_[node_index].first;
+    const TfLiteRegistration& registration =
+        nodes_and_registration_[node_index].second;
+    bool inputs_changed = false;
+    for (int i = 0; i < node.inputs->size; ++i) {
+      inputs_changed |= is_changed(node.inputs->data[i]);
+    }
+    if (!inputs_changed) continue;
+
+    std::vector<std::unique_ptr<TfLiteIntArray, TfLiteIntArrayDeleter>>
+        output_dims;
+    for (int i = 0; i < node.outputs->size; ++i) {
+      output_dims.emplace_back(
+          TfLiteIntArrayCopy(context_.tensors[node.outputs->data[i]].dims));
+    }
+    EnsureTensorsVectorCapacity();
+    if (OpPrepare(registration, &node) == kTfLiteError) {
+      return kTfLiteError;
+    }
+    if (HasDynamicTensor(context_, node.outputs)) {
+      return kTfLiteOk;
+    }
+    // The ops reading outputs whose shape changed are prepared again too.
+    for (int i = 0; i < node.outputs->size; ++i) {
+      int tensor_index = node.outputs->data[i];
+      if (!TfLiteIntArrayEqual(output_dims[i].get(),
+                               context_.tensors[tensor_index].dims)) {
+        if (tensor_index >= changed.size()) changed.resize(tensor_index + 1);
+        changed[tensor_index] = true;
+      }
+    }
+  }
+
+  // The arena only grows if the new plan doesn't fit in its buffer.
+  TF_LITE_ENSURE_STATUS(
+      memory_planner_->ExecuteAllocations(0, execution_plan_.size() - 1));
+  next_execution_plan_index_to_prepare_ = execution_plan_.size();
+  *prepared = true;
+  return kTfLiteOk;
+}
+
+void Interpreter::UseGreedyMemoryPlanner(const MemoryPlan* plan) {
+  use_greedy_memory_planner_ = true;
+  offline_memory_plan_ = plan ? *plan : MemoryPlan();
+  // The planner is created again by the next AllocateTensors().
+  memory_planner_.reset();
+  state_ = kStateUninvokable;
+  ops_prepared_ = false;
+}
+
+TfLiteStatus Interpreter::GetMemoryPlan(MemoryPlan* plan) const {
+  if (!use_greedy_memory_planner_ || !memory_planner_) {
+    error_reporter_->Report(
+        "GetMemoryPlan() requires UseGreedyMemoryPlanner() and "
+        "AllocateTensors().");
+    return kTfLiteError;
+  }
+  *plan = static_cast<const GreedyArenaPlanner*>(memory_planner_.get())
+              ->GetMemoryPlan();
+  return kTfLiteOk;
+}
+
 TfLiteStatus Interpreter::PrepareOpsAndTensors() {
   if (!memory_planner_) {
-    memory_planner_.reset(new ArenaPlanner(
-        &context_, std::unique_ptr<GraphInfo>(new InterpreterInfo(this))));
+    std::unique_ptr<GraphInfo> graph_info(new InterpreterInfo(this));
+    if (use_greedy_memory_planner_) {
+      GreedyArenaPlanner* planner =
+          new GreedyArenaPlanner(&context_, std::move(graph_info));
+      planner->SetOfflinePlan(offline_memory_plan_);
+      memory_planner_.reset(planner);
+    } else {
+      memory_planner_.reset(new ArenaPlanner(&context_, std::move(graph_info)));
+    }
     memory_planner_->PlanAllocations();
   }
 
@@ -681,10 +787,13 @@ TfLiteStatus Interpreter::SetTensorParametersReadOnly(
     tensor.data.raw = const_cast<char*>(buffer);
     if (!tensor.dims) tensor.dims = ConvertArrayToTfLiteIntArray(rank, dims);
     tensor.params = quantization;
+    tensor.channel_scales = nullptr;
+    tensor.num_channel_scales = 0;
     tensor.allocation_type = kTfLiteMmapRo;
     tensor.allocation = allocation;
   } else {
     state_ = kStateUninvokable;
+    ops_prepared_ = false;
     TfLiteTensorReset(type, name, ConvertArrayToTfLiteIntArray(rank, dims),
                       quantization, const_cast<char*>(buffer), bytes,
                       kTfLiteMmapRo, allocation, &tensor);
@@ -716,6 +825,7 @@ TfLiteStatus Interpreter::SetTensorParametersReadWrite(
     TF_LITE_ENSURE_OK(&context_,
                       BytesRequired(type, dims, rank, &required_bytes));
   }
+  ops_prepared_ = false;
   TfLiteTensorReset(type, name, ConvertArrayToTfLiteIntArray(rank, dims),
                     quantization,
                     /*buffer=*/nullptr, required_bytes,
@@ -724,11 +834,25 @@ TfLiteStatus Interpreter::SetTensorParametersReadWrite(
   return kTfLiteOk;
 }
 
+TfLiteStatus Interpreter::SetTensorChannelScales(int tensor_index,
+                                                 const float* scales,
+                                                 int num_scales) {
+  TF_LITE_ENSURE(&context_,
+                 tensor_index < context_.tensors_size && tensor_index >= 0);
+  TF_LITE_ENSURE(&context_, scales != nullptr || num_scales == 0);
+  TfLiteTensor& tensor = context_.tensors[tensor_index];
+  tensor.channel_scales = scales;
+  tensor.num_channel_scales = num_scales;
+  ops_prepared_ = false;
+  return kTfLiteOk;
+}
+
 TfLiteStatus Interpreter::SetExecutionPlan(const std::vector<int>& new_plan) {
   for (int node_index : new_plan) {
     TF_LITE_ENSURE(&context_, node_index >= 0 && node_index < nodes_size());
   }
   execution_plan_ = new_plan;
+  ops_prepared_ = false;
   return kTfLiteOk;
 }
 
@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/contrib/lite/allocation.h"
 #include "tensorflow/contrib/lite/context.h"
 #include "tensorflow/contrib/lite/error_reporter.h"
+#include "tensorflow/contrib/lite/memory_plan.h"
 #include "tensorflow/contrib/lite/memory_planner.h"
 #include "tensorflow/contrib/lite/profiling/profiler.h"
 
@@ -57,6 +58,7 @@ constexpr TfLiteType typeToTfLiteType<bool>() {
 
 // Forward declare since NNAPIDelegate uses Interpreter.
 class NNAPIDelegate;
+class WeightCache;
 
 // An interpreter for a graph of nodes that input and output from tensors.
 // Each node of the graph processes a set of input tensors and produces a
@@ -168,6 +170,13 @@ class Interpreter {
       int tensor_index, TfLiteType type, const char* name, const size_t rank,
       const int* dims, TfLiteQuantizationParams quantization);
 
+  // Sets the scales of a tensor quantized per channel, which replace the scale
+  // in its quantization parameters. `scales` must outlive the interpreter, and
+  // null clears them.
+  // WARNING: This is an experimental interface that is subject to change.
+  TfLiteStatus SetTensorChannelScales(int tensor_index, const float* scales,
+                                      int num_scales);
+
   // Functions to access tensor data
 
   // Read only access to list of inputs.
@@ -201,6 +210,27 @@ class Interpreter {
   // Overrides execution plan. This bounds checks indices sent in.
   TfLiteStatus SetExecutionPlan(const std::vector<int>& new_plan);
 
+  // WARNING: Experimental interface, subject to change
+  // Returns the number of bytes the memory planner reserved for the tensors of
+  // the given allocation type (kTfLiteArenaRw or kTfLiteArenaRwPersistent), or
+  // 0 before AllocateTensors() is called.
+  size_t GetArenaBytes(TfLiteAllocationType type) const {
+    return memory_planner_ ? memory_planner_->GetAllocatedBytes(type) : 0;
+  }
+
+  // WARNING: Experimental interface, subject to change
+  // Makes the next AllocateTensors() place the tensors with a
+  // GreedyArenaPlanner, which usually needs a smaller arena than the default
+  // planner. If `plan` is not null, the offsets it holds are used instead of
+  // planning them. InterpreterBuilder calls this when the model carries a plan.
+  void UseGreedyMemoryPlanner(const MemoryPlan* plan = nullptr);
+
+  // WARNING: Experimental interface, subject to change
+  // Returns in `plan` the offsets of the tensors placed by the greedy planner,
+  // so that they can be stored in the model. Fails if UseGreedyMemoryPlanner()
+  // was not called before AllocateTensors().
+  TfLiteStatus GetMemoryPlan(MemoryPlan* plan) const;
+
   // Get a mutable tensor data structure.
   // TODO(aselle): Create a safe ArrayHandle interface to avoid exposing this
   // read/write access to structure
@@ -289,6 +319,9 @@ class Interpreter {
   // Update allocations for all tensors. This will redim dependent tensors using
   // the input tensor dimensionality as given. This is relatively expensive.
   // If you know that your sizes are not changing, you need not call this.
+  // When only the sizes of inputs changed since the last call, only the ops
+  // whose input shapes changed are prepared again, and the arena keeps its
+  // buffer if the new plan fits in it.
 
   // Returns status of success or failure.
   TfLiteStatus AllocateTensors();
@@ -304,7 +337,11 @@ class Interpreter {
   // Enable or disable the NN API (true to enable)
   void UseNNAPI(bool enable);
 
-  // Set the number of threads available to the interpreter.
+  // Set the number of threads available to the interpreter. They are shared
+  // by all its kernels: convolutions and fully connected layers, and the
+  // optimized depthwise convolutions, poolings, softmax, resize bilinear,
+  // element-wise additions and multiplications, and concatenations, which
+  // split their outputs over batches, rows or elements.
   void SetNumThreads(int num_threads);
 
   // Allow a delegate to look at the graph and modify the graph to handle
@@ -359,6 +396,15 @@ class Interpreter {
 
   profiling::Profiler* GetProfiler() { return profiler_; }
 
+  // Sets the cache the kernels keep the weights they derive from constant
+  // tensors in, e.g. transposed filters. InterpreterBuilder shares the cache
+  // of the FlatBufferModel between all the interpreters built from it. The
+  // cache must outlive the interpreter.
+  // WARNING: This is an experimental API and subject to change.
+  void SetWeightCache(WeightCache* weight_cache) {
+    context_.weight_cache = weight_cache;
+  }
+
   // The default capacity of `tensors_` vector.
   static constexpr int kTensorsReservedCapacity = 128;
   // The capacity headroom of `tensors_` vector before calling ops'
@@ -421,6 +467,13 @@ class Interpreter {
   TfLiteStatus PrepareOpsStartingAt(int first_execution_plan_index,
                                     int* last_execution_plan_index_prepared);
 
+  // Call OpPrepare() for the ops whose input shapes changed since they were
+  // last prepared, starting from the 'resized_tensors', then plan the arena
+  // again. Set 'prepared' to false, leaving the preparation to
+  // PrepareOpsAndTensors(), if one of them has dynamic outputs.
+  TfLiteStatus PrepareResizedOps(const std::vector<int>& resized_tensors,
+                                 bool* prepared);
+
   // Tensors needed by the interpreter. Use `AddTensors` to add more blank
   // tensor entries. Note, `tensors_.data()` needs to be synchronized to the
   // `context_` whenever this std::vector is reallocated. Currently this
@@ -554,6 +607,11 @@ class Interpreter {
   // NOTE: this relies on the order of nodes that is in topological order.
   int next_execution_plan_index_to_prepare_;
 
+  // Whether the last AllocateTensors() prepared all the ops, and nothing but
+  // the sizes of `resized_inputs_` changed since.
+  bool ops_prepared_ = false;
+  std::vector<int> resized_inputs_;
+
   // WARNING: This is an experimental interface that is subject to change.
   // This is a list of node indices (to index into nodes_and_registration).
   // This represents a valid topological sort (dependency ordered) execution
@@ -570,6 +628,11 @@ class Interpreter {
 
   std::unique_ptr<MemoryPlanner> memory_planner_;
 
+  // Whether `memory_planner_` is a GreedyArenaPlanner, and the plan it
+  // starts from.
+  bool use_greedy_memory_planner_ = false;
+  MemoryPlan offline_memory_plan_;
+
   bool allow_buffer_handle_output_ = false;
 
   // Profiler for this interpreter instance.
@@ -286,6 +286,31 @@ TEST(BasicInterpreter, NoOpInterpreter) {
   ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
 }
 
+TEST(BasicInterpreter, GreedyMemoryPlanner) {
+  Interpreter interpreter;
+  ASSERT_EQ(interpreter.AddTensors(1), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetInputs({0}), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetOutputs({0}), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetTensorParametersReadWrite(
+                0, kTfLiteFloat32, "", {3}, TfLiteQuantizationParams()),
+            kTfLiteOk);
+
+  MemoryPlan plan;
+  ASSERT_NE(interpreter.GetMemoryPlan(&plan), kTfLiteOk);
+
+  // Place the input where an offline plan says.
+  plan.offsets = {16};
+  plan.sizes = {3 * sizeof(float)};
+  interpreter.UseGreedyMemoryPlanner(&plan);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+
+  MemoryPlan new_plan;
+  ASSERT_EQ(interpreter.GetMemoryPlan(&new_plan), kTfLiteOk);
+  EXPECT_EQ(new_plan.offsets, plan.offsets);
+  EXPECT_GE(interpreter.GetArenaBytes(kTfLiteArenaRw), 16 + 3 * sizeof(float));
+}
+
 TEST(BasicInterpreter, ResizingTensors) {
   Interpreter interpreter;
   ASSERT_EQ(interpreter.AddTensors(1), kTfLiteOk);
@@ -538,6 +563,112 @@ TEST(BasicInterpreter, AllocateTwice) {
   ASSERT_EQ(old_tensor1_ptr, interpreter.tensor(1)->data.raw);
 }
 
+// Builds a graph with two chains of copy ops, 0 -> 1 -> 2 and 3 -> 4, whose
+// nodes count how many times they were prepared.
+void BuildCountingCopyGraph(Interpreter* interpreter) {
+  ASSERT_EQ(interpreter->AddTensors(5), kTfLiteOk);
+  ASSERT_EQ(interpreter->SetInputs({0, 3}), kTfLiteOk);
+  ASSERT_EQ(interpreter->SetOutputs({2, 4}), kTfLiteOk);
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_EQ(interpreter->SetTensorParametersReadWrite(
+                  i, kTfLiteFloat32, "", {2}, TfLiteQuantizationParams()),
+              kTfLiteOk);
+  }
+
+  TfLiteRegistration reg = {nullptr, nullptr, nullptr, nullptr};
+  reg.init = [](TfLiteContext* context, const char*, size_t) -> void* {
+    return new int(0);
+  };
+  reg.free = [](TfLiteContext* context, void* buffer) {
+    delete reinterpret_cast<int*>(buffer);
+  };
+  reg.prepare = [](TfLiteContext* context, TfLiteNode* node) {
+    ++*reinterpret_cast<int*>(node->user_data);
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    return context->ResizeTensor(context, output,
+                                 TfLiteIntArrayCopy(input->dims));
+  };
+  reg.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    memcpy(output->data.raw, input->data.raw, input->bytes);
+    return kTfLiteOk;
+  };
+  ASSERT_EQ(
+      interpreter->AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr, &reg),
+      kTfLiteOk);
+  ASSERT_EQ(
+      interpreter->AddNodeWithParameters({1}, {2}, nullptr, 0, nullptr, &reg),
+      kTfLiteOk);
+  ASSERT_EQ(
+      interpreter->AddNodeWithParameters({3}, {4}, nullptr, 0, nullptr, &reg),
+      kTfLiteOk);
+}
+
+int NumPrepares(const Interpreter& interpreter, int node_index) {
+  return *reinterpret_cast<int*>(
+      interpreter.node_and_registration(node_index)->first.user_data);
+}
+
+TEST(BasicInterpreter, ResizingInputsOnlyPreparesAffectedOps) {
+  Interpreter interpreter;
+  BuildCountingCopyGraph(&interpreter);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(NumPrepares(interpreter, 0), 1);
+  EXPECT_EQ(NumPrepares(interpreter, 1), 1);
+  EXPECT_EQ(NumPrepares(interpreter, 2), 1);
+
+  ASSERT_EQ(interpreter.ResizeInputTensor(0, {4}), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(NumPrepares(interpreter, 0), 2);
+  EXPECT_EQ(NumPrepares(interpreter, 1), 2);
+  EXPECT_EQ(NumPrepares(interpreter, 2), 1);
+  EXPECT_EQ(interpreter.tensor(2)->bytes, 4 * sizeof(float));
+
+  float* input0 = interpreter.typed_tensor<float>(0);
+  float* input3 = interpreter.typed_tensor<float>(3);
+  for (int i = 0; i < 4; ++i) input0[i] = i;
+  for (int i = 0; i < 2; ++i) input3[i] = 10 + i;
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(interpreter.typed_tensor<float>(2)[i], i);
+  }
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(interpreter.typed_tensor<float>(4)[i], 10 + i);
+  }
+
+  // Shrinking the input reuses the arena buffer.
+  const size_t arena_bytes = interpreter.GetArenaBytes(kTfLiteArenaRw);
+  ASSERT_EQ(interpreter.ResizeInputTensor(3, {1}), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(NumPrepares(interpreter, 0), 2);
+  EXPECT_EQ(NumPrepares(interpreter, 1), 2);
+  EXPECT_EQ(NumPrepares(interpreter, 2), 2);
+  EXPECT_EQ(interpreter.GetArenaBytes(kTfLiteArenaRw), arena_bytes);
+  EXPECT_EQ(interpreter.tensor(4)->bytes, sizeof(float));
+}
+
+TEST(BasicInterpreter, OtherChangesPrepareAllOps) {
+  Interpreter interpreter;
+  BuildCountingCopyGraph(&interpreter);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+  // Allocating again without resizing inputs prepares all the ops.
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(NumPrepares(interpreter, 2), 2);
+
+  // As does resizing inputs along with other changes.
+  ASSERT_EQ(interpreter.ResizeInputTensor(0, {4}), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetTensorParametersReadWrite(
+                3, kTfLiteFloat32, "", {3}, TfLiteQuantizationParams()),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(NumPrepares(interpreter, 0), 3);
+  EXPECT_EQ(NumPrepares(interpreter, 2), 3);
+  EXPECT_EQ(interpreter.tensor(4)->bytes, 3 * sizeof(float));
+}
+
 struct TestErrorReporter : public ErrorReporter {
   int Report(const char* format, va_list args) override {
     char buffer[1024];
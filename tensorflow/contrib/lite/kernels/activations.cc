@@ -22,6 +22,8 @@ limitations under the License.
 
 #include "tensorflow/contrib/lite/builtin_op_data.h"
 #include "tensorflow/contrib/lite/context.h"
+#include "tensorflow/contrib/lite/kernels/gemm_support.h"
+#include "tensorflow/contrib/lite/kernels/internal/optimized/multithreaded_ops.h"
 #include "tensorflow/contrib/lite/kernels/internal/optimized/optimized_ops.h"
 #include "tensorflow/contrib/lite/kernels/internal/quantization_util.h"
 #include "tensorflow/contrib/lite/kernels/internal/reference/reference_ops.h"
@@ -45,10 +47,12 @@ void* Init(TfLiteContext* context, const char* buffer, size_t length) {
   // This is a builtin op, so we don't use the contents in 'buffer', if any.
   // Instead, we allocate a new object to carry information from Prepare() to
   // Eval().
+  gemm_support::IncrementUsageCounter(context);
   return new OpData;
 }
 
 void Free(TfLiteContext* context, void* buffer) {
+  gemm_support::DecrementUsageCounter(context);
   delete reinterpret_cast<OpData*>(buffer);
 }
 
@@ -348,11 +352,12 @@ void Softmax2DQuantized(const TfLiteTensor* input, TfLiteTensor* output,
 }
 
 // Takes a 4D tensor and perform softmax along the forth dimension.
-void Softmax4DFloat(const TfLiteTensor* input, TfLiteTensor* output,
-                    TfLiteSoftmaxParams* params) {
-  optimized_ops::Softmax(GetTensorData<float>(input), GetTensorDims(input),
-                         params->beta, GetTensorData<float>(output),
-                         GetTensorDims(output));
+void Softmax4DFloat(TfLiteContext* context, const TfLiteTensor* input,
+                    TfLiteTensor* output, TfLiteSoftmaxParams* params) {
+  multithreaded_ops::Softmax(GetTensorData<float>(input), GetTensorDims(input),
+                             params->beta, GetTensorData<float>(output),
+                             GetTensorDims(output),
+                             gemm_support::GetFromContext(context));
 }
 
 void Softmax4DQuantized(const TfLiteTensor* input, TfLiteTensor* output,
@@ -379,7 +384,7 @@ TfLiteStatus SoftmaxEval(TfLiteContext* context, TfLiteNode* node) {
         return kTfLiteOk;
       }
       if (NumDimensions(input) == 4) {
-        Softmax4DFloat(input, output, params);
+        Softmax4DFloat(context, input, output, params);
         return kTfLiteOk;
       }
       context->ReportError(
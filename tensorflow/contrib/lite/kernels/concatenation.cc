@@ -22,6 +22,8 @@ limitations under the License.
 
 #include "tensorflow/contrib/lite/builtin_op_data.h"
 #include "tensorflow/contrib/lite/context.h"
+#include "tensorflow/contrib/lite/kernels/gemm_support.h"
+#include "tensorflow/contrib/lite/kernels/internal/optimized/multithreaded_ops.h"
 #include "tensorflow/contrib/lite/kernels/internal/optimized/optimized_ops.h"
 #include "tensorflow/contrib/lite/kernels/internal/reference/reference_ops.h"
 #include "tensorflow/contrib/lite/kernels/internal/tensor.h"
@@ -39,6 +41,15 @@ enum KernelType {
   kGenericOptimized,
 };
 
+void* Init(TfLiteContext* context, const char* buffer, size_t length) {
+  gemm_support::IncrementUsageCounter(context);
+  return nullptr;
+}
+
+void Free(TfLiteContext* context, void* buffer) {
+  gemm_support::DecrementUsageCounter(context);
+}
+
 TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   auto* params =
       reinterpret_cast<TfLiteConcatenationParams*>(node->builtin_data);
@@ -119,7 +130,11 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
       if (kernel_type == kReference) {
         TF_LITE_CONCATENATION(reference_ops, float);
       } else {
-        TF_LITE_CONCATENATION(optimized_ops, float);
+        VectorOfTensors<float> all_inputs(*context, *node->inputs);
+        multithreaded_ops::Concatenation(
+            RemapDim(NumDimensions(output), axis), all_inputs.data(),
+            all_inputs.dims(), node->inputs->size, GetTensorData<float>(output),
+            GetTensorDims(output), gemm_support::GetFromContext(context));
       }
       break;
     case kTfLiteUInt8:
@@ -147,14 +162,14 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 
 TfLiteRegistration* Register_CONCATENATION_REF() {
   static TfLiteRegistration r = {
-      nullptr, nullptr, concatenation::Prepare,
+      concatenation::Init, concatenation::Free, concatenation::Prepare,
       concatenation::Eval<concatenation::kReference>};
   return &r;
 }
 
 TfLiteRegistration* Register_CONCATENATION_GENERIC_OPT() {
   static TfLiteRegistration r = {
-      nullptr, nullptr, concatenation::Prepare,
+      concatenation::Init, concatenation::Free, concatenation::Prepare,
       concatenation::Eval<concatenation::kGenericOptimized>};
   return &r;
 }
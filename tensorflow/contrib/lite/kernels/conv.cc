@@ -18,8 +18,10 @@ limitations under the License.
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <limits>
+#include <vector>
 
 #include "tensorflow/contrib/lite/builtin_op_data.h"
 #include "tensorflow/contrib/lite/context.h"
@@ -31,9 +33,11 @@ limitations under the License.
 #include "tensorflow/contrib/lite/kernels/internal/quantization_util.h"
 #include "tensorflow/contrib/lite/kernels/internal/reference/reference_ops.h"
 #include "tensorflow/contrib/lite/kernels/internal/tensor.h"
+#include "tensorflow/contrib/lite/kernels/internal/tensor_utils.h"
 #include "tensorflow/contrib/lite/kernels/kernel_util.h"
 #include "tensorflow/contrib/lite/kernels/op_macros.h"
 #include "tensorflow/contrib/lite/kernels/padding.h"
+#include "tensorflow/contrib/lite/weight_cache.h"
 
 namespace tflite {
 namespace ops {
@@ -61,12 +65,20 @@ struct OpData {
   // memory buffers.
   int im2col_id = kTensorNotAllocated;
   int hwcn_weights_id = kTensorNotAllocated;
+  int input_quantized_id = kTensorNotAllocated;
+  int scaling_factors_id = kTensorNotAllocated;
+  int accum_scratch_id = kTensorNotAllocated;
 
   TfLitePaddingValues padding;
   // The scaling factor from input to output (aka the 'real multiplier') can
   // be represented as a fixed point multiplier plus a left shift.
   int32_t output_multiplier;
   int output_shift;
+  // The same for each output channel, when the filter is quantized per
+  // channel (see TfLiteTensor::channel_scales). Positive shifts are right
+  // shifts.
+  std::vector<int32_t> per_channel_output_multiplier;
+  std::vector<int> per_channel_output_shift;
   // The range of the fused activation layer. For example for kNone and
   // uint8_t these would be 0 and 255.
   int32_t output_activation_min;
@@ -75,11 +87,23 @@ struct OpData {
   // of the allocated temporaries.
   int32_t im2col_index;
   int32_t hwcn_weights_index;
+  int32_t input_quantized_index;
+  int32_t scaling_factors_index;
+  int32_t accum_scratch_index;
   bool need_hwcn_weights;
   bool have_weights_been_transposed;
+  // The transposed filter in the weight cache of the model, if the filter is
+  // a constant of the model. Replaces the `hwcn_weights` temporary.
+  const float* shared_hwcn_weights = nullptr;
   bool need_im2col;
 
   bool run_multithreaded_kernel;
+  // Whether the filter is quantized while the input and output are float, in
+  // which case the input is quantized on the fly (see EvalHybrid).
+  bool is_hybrid;
+  // Whether the input, filter and output are quantized, with one scale for
+  // each output channel of the filter.
+  bool is_per_channel;
 };
 
 void* Init(TfLiteContext* context, const char* buffer, size_t length) {
@@ -101,11 +125,8 @@ void Free(TfLiteContext* context, void* buffer) {
 // Naive implementation of transpose for floats. Could be optimized to be more
 // cache friendly, but for now it's a one-time cost on first run, and we would
 // prefer to remove the need to do this at all eventually.
-void TransposeFloatTensor(TfLiteTensor* input, TfLiteTensor* output) {
-  const int rows = output->dims->data[1];
-  const int cols = output->dims->data[0];
-  const float* input_data = GetTensorData<float>(input);
-  float* output_data = GetTensorData<float>(output);
+void TransposeFloatData(const float* input_data, int rows, int cols,
+                        float* output_data) {
   for (int i = 0; i < rows; ++i) {
     for (int j = 0; j < cols; ++j) {
       const float in_value = input_data[i * cols + j];
@@ -114,6 +135,62 @@ void TransposeFloatTensor(TfLiteTensor* input, TfLiteTensor* output) {
   }
 }
 
+void TransposeFloatTensor(TfLiteTensor* input, TfLiteTensor* output) {
+  TransposeFloatData(GetTensorData<float>(input), output->dims->data[1],
+                     output->dims->data[0], GetTensorData<float>(output));
+}
+
+// Returns the transposed `filter` from the weight cache of the model, so that
+// all the interpreters of the model share it, or nullptr if the filter is not
+// a constant of the model.
+const float* GetSharedHwcnWeights(TfLiteContext* context,
+                                  const TfLiteTensor* filter) {
+  WeightCache* weight_cache = GetWeightCache(context);
+  if (weight_cache == nullptr || filter->allocation_type != kTfLiteMmapRo ||
+      filter->type != kTfLiteFloat32 || filter->dims->size != 4) {
+    return nullptr;
+  }
+  const int rows = filter->dims->data[0];
+  const int cols = rows == 0 ? 0 : NumElements(filter) / rows;
+  return static_cast<const float*>(weight_cache->GetOrCreate(
+      filter->data.raw, filter->bytes, "conv_hwcn_weights", filter->bytes,
+      [filter, rows, cols](void* buffer) {
+        TransposeFloatData(GetTensorData<float>(filter), rows, cols,
+                           static_cast<float*>(buffer));
+      }));
+}
+
+// Extracts the patches of a quantized input image as the rows of `im2col`,
+// in the layout of the rows of the filter, with zeros for the padding.
+void QuantizedIm2col(const int8_t* input_data, int height, int width,
+                     int depth, int filter_height, int filter_width,
+                     int stride_height, int stride_width,
+                     int dilation_height_factor, int dilation_width_factor,
+                     int pad_height, int pad_width, int output_height,
+                     int output_width, int8_t* im2col_data) {
+  const int row_size = filter_height * filter_width * depth;
+  for (int out_y = 0; out_y < output_height; ++out_y) {
+    for (int out_x = 0; out_x < output_width; ++out_x) {
+      int8_t* row = im2col_data + (out_y * output_width + out_x) * row_size;
+      for (int filter_y = 0; filter_y < filter_height; ++filter_y) {
+        const int in_y =
+            out_y * stride_height - pad_height +
+            filter_y * dilation_height_factor;
+        for (int filter_x = 0; filter_x < filter_width; ++filter_x) {
+          const int in_x = out_x * stride_width - pad_width +
+                           filter_x * dilation_width_factor;
+          int8_t* dest = row + (filter_y * filter_width + filter_x) * depth;
+          if (in_y >= 0 && in_y < height && in_x >= 0 && in_x < width) {
+            memcpy(dest, input_data + (in_y * width + in_x) * depth, depth);
+          } else {
+            memset(dest, 0, depth);
+          }
+        }
+      }
+    }
+  }
+}
+
 // Allocate temporary tensors (`im2col`, `hwcn_weights` if necessary).
 // Note: `context->AddTensors` might invalidate pointers to existing tensors.
 // Therefore the logic to add tensors are isolated into this function.
@@ -143,9 +220,20 @@ static TfLiteStatus AllocateTemporaryTensorsIfRequired(TfLiteContext* context,
   // filter_count]. We get to that format by transposing, and create a temporary
   // buffer to store the results.
   // This path is only used for float processing, so only create the buffer if
-  // we're running with that data type.
+  // we're running with that data type. Constant filters are transposed once in
+  // the weight cache of the model instead.
+  data->is_hybrid =
+      input->type == kTfLiteFloat32 && filter->type == kTfLiteUInt8;
+  data->is_per_channel =
+      input->type == kTfLiteUInt8 && filter->channel_scales != nullptr;
+  data->shared_hwcn_weights = nullptr;
+  if (input->type == kTfLiteFloat32 && data->run_multithreaded_kernel &&
+      !data->is_hybrid) {
+    data->shared_hwcn_weights = GetSharedHwcnWeights(context, filter);
+  }
   data->need_hwcn_weights =
-      (input->type == kTfLiteFloat32 && data->run_multithreaded_kernel);
+      (input->type == kTfLiteFloat32 && data->run_multithreaded_kernel &&
+       !data->is_hybrid && data->shared_hwcn_weights == nullptr);
 
   int temporaries_count = 0;
   if (data->need_im2col) {
@@ -162,6 +250,29 @@ static TfLiteStatus AllocateTemporaryTensorsIfRequired(TfLiteContext* context,
     }
     ++temporaries_count;
   }
+  // Hybrid convolutions quantize the input on the fly, and need its scaling
+  // factor for each row of the im2col matrix.
+  if (data->is_hybrid) {
+    data->input_quantized_index = temporaries_count;
+    if (data->input_quantized_id == kTensorNotAllocated) {
+      context->AddTensors(context, 1, &data->input_quantized_id);
+    }
+    ++temporaries_count;
+    data->scaling_factors_index = temporaries_count;
+    if (data->scaling_factors_id == kTensorNotAllocated) {
+      context->AddTensors(context, 1, &data->scaling_factors_id);
+    }
+    ++temporaries_count;
+  }
+  // The optimized per-channel kernel keeps the int32 results of the GEMM
+  // before scaling them down.
+  if (data->is_per_channel) {
+    data->accum_scratch_index = temporaries_count;
+    if (data->accum_scratch_id == kTensorNotAllocated) {
+      context->AddTensors(context, 1, &data->accum_scratch_id);
+    }
+    ++temporaries_count;
+  }
 
   TfLiteIntArrayFree(node->temporaries);
   node->temporaries = TfLiteIntArrayCreate(temporaries_count);
@@ -196,7 +307,9 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE(context,
                  data_type == kTfLiteFloat32 || data_type == kTfLiteUInt8);
   TF_LITE_ENSURE_EQ(context, output->type, data_type);
-  TF_LITE_ENSURE_EQ(context, filter->type, data_type);
+  if (!data->is_hybrid) {
+    TF_LITE_ENSURE_EQ(context, filter->type, data_type);
+  }
 
   TfLiteTensor* bias = nullptr;
 
@@ -216,6 +329,9 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   }
 
   int channels_out = filter->dims->data[0];
+  if (filter->channel_scales) {
+    TF_LITE_ENSURE_EQ(context, filter->num_channel_scales, channels_out);
+  }
   int width = input->dims->data[2];
   int height = input->dims->data[1];
   int filter_width = filter->dims->data[2];
@@ -250,7 +366,23 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
 
   // Note that quantized inference requires that all tensors have their
   // parameters set. This is usually done during quantized training.
-  if (data_type != kTfLiteFloat32) {
+  if (data->is_per_channel) {
+    std::vector<double> real_multipliers(channels_out);
+    TF_LITE_ENSURE_STATUS(GetQuantizedConvolutionMultipliers(
+        context, input, filter, bias, output, channels_out,
+        real_multipliers.data()));
+    data->per_channel_output_multiplier.resize(channels_out);
+    data->per_channel_output_shift.resize(channels_out);
+    for (int i = 0; i < channels_out; ++i) {
+      int exponent;
+      QuantizeMultiplier(real_multipliers[i],
+                         &data->per_channel_output_multiplier[i], &exponent);
+      data->per_channel_output_shift[i] = -exponent;
+    }
+    CalculateActivationRangeUint8(params->activation, output,
+                                  &data->output_activation_min,
+                                  &data->output_activation_max);
+  } else if (data_type != kTfLiteFloat32) {
     double real_multiplier = 0.0;
     TF_LITE_ENSURE_STATUS(GetQuantizedConvolutionMultipler(
         context, input, filter, bias, output, &real_multiplier));
@@ -284,7 +416,7 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
 
     TfLiteTensor* im2col =
         &context->tensors[node->temporaries->data[data->im2col_index]];
-    im2col->type = data_type;
+    im2col->type = data->is_hybrid ? kTfLiteUInt8 : data_type;
     im2col->allocation_type = kTfLiteArenaRw;
     auto im2col_status = context->ResizeTensor(context, im2col, im2col_size);
     if (im2col_status != kTfLiteOk) return im2col_status;
@@ -326,6 +458,45 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
     data->have_weights_been_transposed = false;
   }
 
+  if (data->is_hybrid) {
+    node->temporaries->data[data->input_quantized_index] =
+        data->input_quantized_id;
+    TfLiteTensor* input_quantized =
+        &context->tensors[data->input_quantized_id];
+    input_quantized->type = kTfLiteUInt8;
+    input_quantized->allocation_type = kTfLiteArenaRw;
+    if (!TfLiteIntArrayEqual(input_quantized->dims, input->dims)) {
+      TfLiteIntArray* input_quantized_size = TfLiteIntArrayCopy(input->dims);
+      TF_LITE_ENSURE_OK(context, context->ResizeTensor(context, input_quantized,
+                                                       input_quantized_size));
+    }
+
+    // One scaling factor for each output position of a batch.
+    node->temporaries->data[data->scaling_factors_index] =
+        data->scaling_factors_id;
+    TfLiteTensor* scaling_factors =
+        &context->tensors[data->scaling_factors_id];
+    scaling_factors->type = kTfLiteFloat32;
+    scaling_factors->allocation_type = kTfLiteArenaRw;
+    TfLiteIntArray* scaling_factors_size = TfLiteIntArrayCreate(1);
+    scaling_factors_size->data[0] = outHeight * outWidth;
+    TF_LITE_ENSURE_OK(context, context->ResizeTensor(context, scaling_factors,
+                                                     scaling_factors_size));
+  }
+
+  if (data->is_per_channel) {
+    node->temporaries->data[data->accum_scratch_index] =
+        data->accum_scratch_id;
+    TfLiteTensor* accum_scratch = &context->tensors[data->accum_scratch_id];
+    accum_scratch->type = kTfLiteInt32;
+    accum_scratch->allocation_type = kTfLiteArenaRw;
+    TfLiteIntArray* accum_scratch_size = TfLiteIntArrayCreate(2);
+    accum_scratch_size->data[0] = batches * outHeight * outWidth;
+    accum_scratch_size->data[1] = channels_out;
+    TF_LITE_ENSURE_OK(context, context->ResizeTensor(context, accum_scratch,
+                                                     accum_scratch_size));
+  }
+
   return kTfLiteOk;
 }
 
@@ -372,6 +543,130 @@ void EvalQuantized(TfLiteContext* context, TfLiteNode* node,
   }
 }
 
+template <KernelType kernel_type>
+void EvalQuantizedPerChannel(TfLiteContext* context, TfLiteNode* node,
+                             TfLiteConvParams* params, OpData* data,
+                             TfLiteTensor* input, TfLiteTensor* filter,
+                             TfLiteTensor* bias, TfLiteTensor* im2col,
+                             TfLiteTensor* accum_scratch,
+                             TfLiteTensor* output) {
+  auto input_offset = -input->params.zero_point;
+  auto filter_offset = -filter->params.zero_point;
+  auto output_offset = output->params.zero_point;
+
+  switch (kernel_type) {
+    case kReference:
+      reference_ops::ConvPerChannel(
+          GetTensorData<uint8_t>(input), GetTensorDims(input), input_offset,
+          GetTensorData<uint8_t>(filter), GetTensorDims(filter), filter_offset,
+          GetTensorData<int32_t>(bias), GetTensorDims(bias),
+          params->stride_width, params->stride_height, data->padding.width,
+          data->padding.height, output_offset,
+          data->per_channel_output_multiplier.data(),
+          data->per_channel_output_shift.data(), data->output_activation_min,
+          data->output_activation_max, GetTensorData<uint8_t>(output),
+          GetTensorDims(output));
+      break;
+    case kGenericOptimized:
+    case kMultithreadOptimized:
+    case kCblasOptimized:
+      optimized_ops::ConvPerChannel(
+          GetTensorData<uint8_t>(input), GetTensorDims(input), input_offset,
+          GetTensorData<uint8_t>(filter), GetTensorDims(filter), filter_offset,
+          GetTensorData<int32_t>(bias), GetTensorDims(bias),
+          params->stride_width, params->stride_height, data->padding.width,
+          data->padding.height, output_offset,
+          data->per_channel_output_multiplier.data(),
+          data->per_channel_output_shift.data(), data->output_activation_min,
+          data->output_activation_max, GetTensorData<uint8_t>(output),
+          GetTensorDims(output), GetTensorData<uint8_t>(im2col),
+          GetTensorDims(im2col), GetTensorData<int32_t>(accum_scratch),
+          gemm_support::GetFromContext(context));
+      break;
+  }
+}
+
+// Evaluates a convolution with float input and output and weights quantized
+// symmetrically to int8 (stored as uint8), optionally per output channel.
+// Each batch of the input is quantized the same way, so that the products run
+// on 8-bit integers; the int32 sums are then scaled back to float.
+void EvalHybrid(TfLiteContext* context, TfLiteNode* node,
+                TfLiteConvParams* params, OpData* data, TfLiteTensor* input,
+                TfLiteTensor* filter, TfLiteTensor* bias, TfLiteTensor* im2col,
+                TfLiteTensor* input_quantized, TfLiteTensor* scaling_factors,
+                TfLiteTensor* output) {
+  const int batches = input->dims->data[0];
+  const int input_height = input->dims->data[1];
+  const int input_width = input->dims->data[2];
+  const int input_depth = input->dims->data[3];
+  const int filter_height = filter->dims->data[1];
+  const int filter_width = filter->dims->data[2];
+  const int output_height = output->dims->data[1];
+  const int output_width = output->dims->data[2];
+  const int output_depth = output->dims->data[3];
+  const int input_size = input_height * input_width * input_depth;
+  const int row_size = filter_height * filter_width * input_depth;
+  const int num_rows = output_height * output_width;
+
+  const int8_t* filter_data =
+      reinterpret_cast<const int8_t*>(GetTensorData<uint8_t>(filter));
+  int8_t* quantized_input_data =
+      reinterpret_cast<int8_t*>(GetTensorData<uint8_t>(input_quantized));
+  int8_t* im2col_data =
+      im2col ? reinterpret_cast<int8_t*>(GetTensorData<uint8_t>(im2col))
+             : nullptr;
+  float* scaling_factors_data = GetTensorData<float>(scaling_factors);
+  float* output_data = GetTensorData<float>(output);
+
+  tensor_utils::ZeroVector(output_data, batches * num_rows * output_depth);
+  for (int b = 0; b < batches; ++b) {
+    int8_t* quantized_batch = quantized_input_data + b * input_size;
+    float min, max, scaling_factor;
+    tensor_utils::SymmetricQuantizeFloats(
+        GetTensorData<float>(input) + b * input_size, input_size,
+        quantized_batch, &min, &max, &scaling_factor);
+    for (int i = 0; i < num_rows; ++i) {
+      scaling_factors_data[i] = scaling_factor;
+    }
+
+    // Without im2col (1x1 filter with unit strides) the quantized input
+    // already holds the rows of the matrix.
+    const int8_t* rows = quantized_batch;
+    if (data->need_im2col) {
+      int8_t* batch_im2col = im2col_data + b * num_rows * row_size;
+      QuantizedIm2col(quantized_batch, input_height, input_width, input_depth,
+                      filter_height, filter_width, params->stride_height,
+                      params->stride_width, params->dilation_height_factor,
+                      params->dilation_width_factor, data->padding.height,
+                      data->padding.width, output_height, output_width,
+                      batch_im2col);
+      rows = batch_im2col;
+    }
+
+    tensor_utils::MatrixBatchVectorMultiplyAccumulate(
+        filter_data, output_depth, row_size, rows, scaling_factors_data,
+        num_rows, output_data + b * num_rows * output_depth,
+        /*result_stride=*/1);
+  }
+
+  // Dequantize with the scales of the filter, which like the scaling factors
+  // of the input are the factors the values were multiplied by, then apply
+  // the bias and the activation.
+  float output_activation_min, output_activation_max;
+  CalculateActivationRangeFloat(params->activation, &output_activation_min,
+                                &output_activation_max);
+  const float* bias_data = GetTensorData<float>(bias);
+  for (int i = 0; i < batches * num_rows; ++i) {
+    float* output_row = output_data + i * output_depth;
+    for (int c = 0; c < output_depth; ++c) {
+      const float value = output_row[c] / GetChannelScale(filter, c) +
+                          (bias_data ? bias_data[c] : 0.0f);
+      output_row[c] = std::min(std::max(value, output_activation_min),
+                               output_activation_max);
+    }
+  }
+}
+
 template <KernelType kernel_type>
 void EvalFloat(TfLiteContext* context, TfLiteNode* node,
                TfLiteConvParams* params, OpData* data, TfLiteTensor* input,
@@ -418,7 +713,9 @@ void EvalFloat(TfLiteContext* context, TfLiteNode* node,
     }
     case kMultithreadOptimized: {
       const float* filter_data;
-      if (data->need_hwcn_weights) {
+      if (data->shared_hwcn_weights != nullptr) {
+        filter_data = data->shared_hwcn_weights;
+      } else if (data->need_hwcn_weights) {
         filter_data = GetTensorData<float>(hwcn_weights);
       } else {
         filter_data = GetTensorData<float>(filter);
@@ -476,7 +773,12 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   // separate ops to avoid dispatch overhead here.
   switch (input->type) {  // Already know in/outtypes are same.
     case kTfLiteFloat32:
-      if (data->run_multithreaded_kernel) {
+      if (data->is_hybrid) {
+        EvalHybrid(
+            context, node, params, data, input, filter, bias, im2col,
+            &context->tensors[data->input_quantized_id],
+            &context->tensors[data->scaling_factors_id], output);
+      } else if (data->run_multithreaded_kernel) {
         EvalFloat<kernel_type>(context, node, params, data, input, filter, bias,
                                im2col, hwcn_weights, output);
       } else {
@@ -485,8 +787,14 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
       }
       break;
     case kTfLiteUInt8:
-      EvalQuantized<kernel_type>(context, node, params, data, input, filter,
-                                 bias, im2col, hwcn_weights, output);
+      if (data->is_per_channel) {
+        EvalQuantizedPerChannel<kernel_type>(
+            context, node, params, data, input, filter, bias, im2col,
+            &context->tensors[data->accum_scratch_id], output);
+      } else {
+        EvalQuantized<kernel_type>(context, node, params, data, input, filter,
+                                   bias, im2col, hwcn_weights, output);
+      }
       break;
     default:
       context->ReportError(context, "Type %d not currently supported.",
@@ -441,6 +441,65 @@ TEST_P(ConvolutionOpTest, SimpleTestQuantized) {
                              }));
 }
 
+class PerChannelQuantizedConvolutionOpModel
+    : public QuantizedConvolutionOpModel {
+ public:
+  using QuantizedConvolutionOpModel::QuantizedConvolutionOpModel;
+
+  // Gives each output channel of the filter its own scale, and the bias the
+  // matching ones.
+  void SetFilterScales(const std::vector<float>& scales) {
+    std::vector<float> bias_scales;
+    for (float scale : scales) {
+      bias_scales.push_back(GetScale(input_) * scale);
+    }
+    SetChannelScales(filter_, scales);
+    SetChannelScales(bias_, bias_scales);
+    CHECK(interpreter_->AllocateTensors() == kTfLiteOk);
+  }
+
+  void SetFilter(std::initializer_list<float> data) {
+    PerChannelQuantizeAndPopulate<uint8_t>(filter_, data, /*channel_dim=*/0);
+  }
+
+  void SetBias(std::initializer_list<float> data) {
+    PerChannelQuantizeAndPopulate<int32_t>(bias_, data, /*channel_dim=*/0);
+  }
+};
+
+// The same as SimpleTestQuantized, with finer scales for the filters that
+// don't need the whole range.
+TEST_P(ConvolutionOpTest, SimpleTestQuantizedPerChannel) {
+  PerChannelQuantizedConvolutionOpModel m(
+      GetRegistration(), {TensorType_UINT8, {2, 2, 4, 1}, -63.5, 64},
+      {TensorType_UINT8, {3, 2, 2, 1}, -63.5, 64},
+      {TensorType_UINT8, {}, -127, 128});
+  m.SetFilterScales({0.5, 0.25, 0.125});
+  m.SetInput({
+      // First batch
+      1, 1, 1, 1,  // row = 1
+      2, 2, 2, 2,  // row = 2
+      // Second batch
+      1, 2, 3, 4,  // row = 1
+      1, 2, 3, 4,  // row = 2
+  });
+  m.SetFilter({
+      1, 2, 3, 4,    // first 2x2 filter
+      -1, 1, -1, 1,  // second 2x2 filter
+      -1, -1, 1, 1,  // third 2x2 filter
+  });
+  m.SetBias({1, 2, 3});
+
+  m.Invoke();
+
+  EXPECT_THAT(m.GetOutput(), ElementsAreArray({
+                                 145, 129, 132,  //
+                                 145, 129, 132,  //
+                                 144, 131, 130,  //
+                                 164, 131, 130,  //
+                             }));
+}
+
 TEST_P(ConvolutionOpTest, SimpleTestQuantizedWithAnisotropicStrides) {
   QuantizedConvolutionOpModel m(GetRegistration(),
                                 {TensorType_UINT8, {1, 3, 6, 1}, -63.5, 64},
@@ -468,6 +527,96 @@ TEST_P(ConvolutionOpTest, SimpleTestQuantizedWithAnisotropicStrides) {
                              }));
 }
 
+class HybridConvolutionOpModel : public BaseConvolutionOpModel {
+ public:
+  using BaseConvolutionOpModel::BaseConvolutionOpModel;
+
+  void SetFilter(std::initializer_list<float> f) {
+    SymmetricQuantizeAndPopulate(filter_, f);
+  }
+
+  void SetPerChannelFilter(std::initializer_list<float> f) {
+    PerChannelSymmetricQuantizeAndPopulate(filter_, f, /*channel_dim=*/0);
+  }
+
+  void SetBias(std::initializer_list<float> f) { PopulateTensor(bias_, f); }
+
+  void SetInput(std::initializer_list<float> data) {
+    PopulateTensor(input_, data);
+  }
+  std::vector<float> GetOutput() { return ExtractVector<float>(output_); }
+};
+
+TEST_P(ConvolutionOpTest, SimpleTestHybrid) {
+  HybridConvolutionOpModel m(
+      GetRegistration(), {TensorType_FLOAT32, {2, 2, 4, 1}},
+      {TensorType_UINT8, {3, 2, 2, 1}}, {TensorType_FLOAT32, {}});
+
+  m.SetInput({
+      // First batch
+      1, 1, 1, 1,  // row = 1
+      2, 2, 2, 2,  // row = 2
+      // Second batch
+      1, 2, 3, 4,  // row = 1
+      1, 2, 3, 4,  // row = 2
+  });
+  m.SetFilter({
+      1, 2, 3, 4,    // first 2x2 filter
+      -1, 1, -1, 1,  // second 2x2 filter
+      -1, -1, 1, 1,  // third 2x2 filter
+  });
+  m.SetBias({1, 2, 3});
+
+  m.Invoke();
+
+  // The input and the filter are quantized to 8 bits, so the results are only
+  // close to the ones of SimpleTestFloat32.
+  EXPECT_THAT(m.GetOutput(), ElementsAreArray(ArrayFloatNear(
+                                 {
+                                     18, 2, 5,  // first batch, left
+                                     18, 2, 5,  // first batch, right
+                                     17, 4, 3,  // second batch, left
+                                     37, 4, 3,  // second batch, right
+                                 },
+                                 0.2)));
+}
+
+TEST_P(ConvolutionOpTest, SimpleTestHybridPerChannel) {
+  HybridConvolutionOpModel m(
+      GetRegistration(), {TensorType_FLOAT32, {2, 2, 4, 1}},
+      {TensorType_UINT8, {3, 2, 2, 1}}, {TensorType_FLOAT32, {}},
+      /*stride_width=*/2, /*stride_height=*/2, Padding_VALID,
+      ActivationFunctionType_RELU);
+
+  m.SetInput({
+      // First batch
+      1, 1, 1, 1,  // row = 1
+      2, 2, 2, 2,  // row = 2
+      // Second batch
+      1, 2, 3, 4,  // row = 1
+      1, 2, 3, 4,  // row = 2
+  });
+  m.SetPerChannelFilter({
+      1, 2, 3, 4,            // first 2x2 filter
+      -0.1, 0.1, -0.1, 0.1,  // second 2x2 filter
+      -10, -10, 10, 10,      // third 2x2 filter
+  });
+  m.SetBias({1, 2, -20});
+
+  m.Invoke();
+
+  // Each filter has its own scale, so the small second filter is quantized as
+  // precisely as the others.
+  EXPECT_THAT(m.GetOutput(), ElementsAreArray(ArrayFloatNear(
+                                 {
+                                     18, 2, 0,    // first batch, left
+                                     18, 2, 0,    // first batch, right
+                                     17, 2.2, 0,  // second batch, left
+                                     37, 2.2, 0,  // second batch, right
+                                 },
+                                 0.2)));
+}
+
 INSTANTIATE_TEST_CASE_P(
     ConvolutionOpTest, ConvolutionOpTest,
     ::testing::ValuesIn(SingleOpTest::GetKernelTags(*kKernelMap)));
@@ -13,21 +13,27 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 #include <unistd.h>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <limits>
+#include <vector>
 
 #include "tensorflow/contrib/lite/builtin_op_data.h"
 #include "tensorflow/contrib/lite/context.h"
+#include "tensorflow/contrib/lite/kernels/gemm_support.h"
 #include "tensorflow/contrib/lite/kernels/internal/optimized/depthwiseconv_float.h"
 #include "tensorflow/contrib/lite/kernels/internal/optimized/depthwiseconv_uint8.h"
+#include "tensorflow/contrib/lite/kernels/internal/optimized/multithreaded_ops.h"
 #include "tensorflow/contrib/lite/kernels/internal/quantization_util.h"
 #include "tensorflow/contrib/lite/kernels/internal/reference/depthwiseconv_float.h"
 #include "tensorflow/contrib/lite/kernels/internal/reference/depthwiseconv_uint8.h"
 #include "tensorflow/contrib/lite/kernels/internal/tensor.h"
+#include "tensorflow/contrib/lite/kernels/internal/tensor_utils.h"
 #include "tensorflow/contrib/lite/kernels/kernel_util.h"
 #include "tensorflow/contrib/lite/kernels/op_macros.h"
 #include "tensorflow/contrib/lite/kernels/padding.h"
@@ -55,20 +61,34 @@ struct OpData {
   // be represented as a fixed point multiplier plus a left shift.
   int32_t output_multiplier;
   int output_shift;
+  // The same for each output channel, when the filter is quantized per
+  // channel (see TfLiteTensor::channel_scales). Positive shifts are right
+  // shifts.
+  std::vector<int32_t> per_channel_output_multiplier;
+  std::vector<int> per_channel_output_shift;
   // The range of the fused activation layer. For example for kNone and
   // uint8_t these would be 0 and 255.
   int32_t output_activation_min;
   int32_t output_activation_max;
+  // The indices of the temporary tensors where hybrid kernels quantize the
+  // input and accumulate the products of each output position.
+  int input_quantized_index;
+  int accumulators_index;
 };
 
 void* Init(TfLiteContext* context, const char* buffer, size_t length) {
   // This is a builtin op, so we don't use the contents in 'buffer', if any.
   // Instead, we allocate a new object to carry information from Prepare() to
   // Eval().
-  return new OpData;
+  gemm_support::IncrementUsageCounter(context);
+  auto* data = new OpData;
+  context->AddTensors(context, 1, &data->input_quantized_index);
+  context->AddTensors(context, 1, &data->accumulators_index);
+  return data;
 }
 
 void Free(TfLiteContext* context, void* buffer) {
+  gemm_support::DecrementUsageCounter(context);
   delete reinterpret_cast<OpData*>(buffer);
 }
 
@@ -103,7 +123,13 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE(context,
                  data_type == kTfLiteFloat32 || data_type == kTfLiteUInt8);
   TF_LITE_ENSURE_EQ(context, output->type, data_type);
-  TF_LITE_ENSURE_EQ(context, filter->type, data_type);
+  // Float inputs can also go with weights quantized symmetrically to int8 (see
+  // EvalHybrid).
+  const bool is_hybrid =
+      data_type == kTfLiteFloat32 && filter->type == kTfLiteUInt8;
+  if (!is_hybrid) {
+    TF_LITE_ENSURE_EQ(context, filter->type, data_type);
+  }
 
   if (hasBias) {
     bias = GetInput(context, node, kBiasTensor);
@@ -119,6 +145,9 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   }
 
   int channels_out = SizeOfDimension(filter, 3);
+  if (filter->channel_scales) {
+    TF_LITE_ENSURE_EQ(context, filter->num_channel_scales, channels_out);
+  }
   int width = SizeOfDimension(input, 2);
   int height = SizeOfDimension(input, 1);
   int filter_width = SizeOfDimension(filter, 2);
@@ -147,7 +176,25 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
 
   // Note that quantized inference requires that all tensors have their
   // parameters set. This is usually done during quantized training.
-  if (data_type != kTfLiteFloat32) {
+  if (data_type != kTfLiteFloat32 && filter->channel_scales) {
+    std::vector<double> real_multipliers(channels_out);
+    TF_LITE_ENSURE_STATUS(GetQuantizedConvolutionMultipliers(
+        context, input, filter, bias, output, channels_out,
+        real_multipliers.data()));
+    data->per_channel_output_multiplier.resize(channels_out);
+    data->per_channel_output_shift.resize(channels_out);
+    for (int i = 0; i < channels_out; ++i) {
+      int exponent;
+      QuantizeMultiplier(real_multipliers[i],
+                         &data->per_channel_output_multiplier[i], &exponent);
+      data->per_channel_output_shift[i] = -exponent;
+    }
+    CalculateActivationRangeUint8(params->activation, output,
+                                  &data->output_activation_min,
+                                  &data->output_activation_max);
+  } else if (data_type != kTfLiteFloat32) {
+    data->per_channel_output_multiplier.clear();
+    data->per_channel_output_shift.clear();
     double real_multiplier = 0.0;
     TF_LITE_ENSURE_STATUS(GetQuantizedConvolutionMultipler(
         context, input, filter, bias, output, &real_multiplier));
@@ -159,6 +206,32 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
                                   &data->output_activation_max);
   }
 
+  TfLiteIntArrayFree(node->temporaries);
+  if (is_hybrid) {
+    node->temporaries = TfLiteIntArrayCreate(2);
+    node->temporaries->data[0] = data->input_quantized_index;
+    node->temporaries->data[1] = data->accumulators_index;
+
+    TfLiteTensor* input_quantized = GetTemporary(context, node, 0);
+    input_quantized->type = kTfLiteUInt8;
+    input_quantized->allocation_type = kTfLiteArenaRw;
+    if (!TfLiteIntArrayEqual(input_quantized->dims, input->dims)) {
+      TfLiteIntArray* input_quantized_size = TfLiteIntArrayCopy(input->dims);
+      TF_LITE_ENSURE_OK(context, context->ResizeTensor(context, input_quantized,
+                                                       input_quantized_size));
+    }
+
+    TfLiteTensor* accumulators = GetTemporary(context, node, 1);
+    accumulators->type = kTfLiteInt32;
+    accumulators->allocation_type = kTfLiteArenaRw;
+    TfLiteIntArray* accumulators_size = TfLiteIntArrayCreate(1);
+    accumulators_size->data[0] = channels_out;
+    TF_LITE_ENSURE_OK(context, context->ResizeTensor(context, accumulators,
+                                                     accumulators_size));
+  } else {
+    node->temporaries = TfLiteIntArrayCreate(0);
+  }
+
   TfLiteIntArray* outputSize = TfLiteIntArrayCreate(4);
   outputSize->data[0] = batches;
   outputSize->data[1] = out_height;
@@ -176,22 +249,24 @@ void EvalFloat(TfLiteContext* context, TfLiteNode* node,
   CalculateActivationRangeFloat(params->activation, &output_activation_min,
                                 &output_activation_max);
 
-  void (*depthwise_conv)(const float*, const Dims<4>&, const float*,
-                         const Dims<4>&, const float*, const Dims<4>&, int, int,
-                         int, int, int, float, float, float*, const Dims<4>&);
   if (kernel_type == kReference) {
-    depthwise_conv = &reference_ops::DepthwiseConv;
+    reference_ops::DepthwiseConv(
+        GetTensorData<float>(input), GetTensorDims(input),
+        GetTensorData<float>(filter), GetTensorDims(filter),
+        GetTensorData<float>(bias), GetTensorDims(bias), params->stride_width,
+        params->stride_height, data->padding.width, data->padding.height,
+        params->depth_multiplier, output_activation_min, output_activation_max,
+        GetTensorData<float>(output), GetTensorDims(output));
   } else {
-    depthwise_conv = &optimized_ops::DepthwiseConv;
+    multithreaded_ops::DepthwiseConv(
+        GetTensorData<float>(input), GetTensorDims(input),
+        GetTensorData<float>(filter), GetTensorDims(filter),
+        GetTensorData<float>(bias), GetTensorDims(bias), params->stride_width,
+        params->stride_height, data->padding.width, data->padding.height,
+        params->depth_multiplier, output_activation_min, output_activation_max,
+        GetTensorData<float>(output), GetTensorDims(output),
+        gemm_support::GetFromContext(context));
   }
-
-  depthwise_conv(
-      GetTensorData<float>(input), GetTensorDims(input),
-      GetTensorData<float>(filter), GetTensorDims(filter),
-      GetTensorData<float>(bias), GetTensorDims(bias), params->stride_width,
-      params->stride_height, data->padding.width, data->padding.height,
-      params->depth_multiplier, output_activation_min, output_activation_max,
-      GetTensorData<float>(output), GetTensorDims(output));
 }
 
 template <KernelType kernel_type>
@@ -203,25 +278,144 @@ void EvalQuantized(TfLiteContext* context, TfLiteNode* node,
   auto filter_offset = -filter->params.zero_point;
   auto output_offset = output->params.zero_point;
 
-  void (*depthwise_conv)(const uint8*, const Dims<4>&, int32, const uint8*,
-                         const Dims<4>&, int32, const int32*, const Dims<4>&,
-                         int, int, int, int, int, int32, int32, int, int32,
-                         int32, uint8*, const Dims<4>&);
   if (kernel_type == kReference) {
-    depthwise_conv = &reference_ops::DepthwiseConv;
+    reference_ops::DepthwiseConv(
+        GetTensorData<uint8_t>(input), GetTensorDims(input), input_offset,
+        GetTensorData<uint8_t>(filter), GetTensorDims(filter), filter_offset,
+        GetTensorData<int32_t>(bias), GetTensorDims(bias), params->stride_width,
+        params->stride_height, data->padding.width, data->padding.height,
+        params->depth_multiplier, output_offset, data->output_multiplier,
+        data->output_shift, data->output_activation_min,
+        data->output_activation_max, GetTensorData<uint8_t>(output),
+        GetTensorDims(output));
+  } else {
+    multithreaded_ops::DepthwiseConv(
+        GetTensorData<uint8_t>(input), GetTensorDims(input), input_offset,
+        GetTensorData<uint8_t>(filter), GetTensorDims(filter), filter_offset,
+        GetTensorData<int32_t>(bias), GetTensorDims(bias), params->stride_width,
+        params->stride_height, data->padding.width, data->padding.height,
+        params->depth_multiplier, output_offset, data->output_multiplier,
+        data->output_shift, data->output_activation_min,
+        data->output_activation_max, GetTensorData<uint8_t>(output),
+        GetTensorDims(output), gemm_support::GetFromContext(context));
+  }
+}
+
+template <KernelType kernel_type>
+void EvalQuantizedPerChannel(TfLiteContext* context, TfLiteNode* node,
+                             TfLiteDepthwiseConvParams* params, OpData* data,
+                             const TfLiteTensor* input,
+                             const TfLiteTensor* filter,
+                             const TfLiteTensor* bias, TfLiteTensor* output) {
+  auto input_offset = -input->params.zero_point;
+  auto filter_offset = -filter->params.zero_point;
+  auto output_offset = output->params.zero_point;
+
+  if (kernel_type == kReference) {
+    reference_ops::DepthwiseConvPerChannel(
+        GetTensorData<uint8_t>(input), GetTensorDims(input), input_offset,
+        GetTensorData<uint8_t>(filter), GetTensorDims(filter), filter_offset,
+        GetTensorData<int32_t>(bias), GetTensorDims(bias), params->stride_width,
+        params->stride_height, data->padding.width, data->padding.height,
+        params->depth_multiplier, output_offset,
+        data->per_channel_output_multiplier.data(),
+        data->per_channel_output_shift.data(), data->output_activation_min,
+        data->output_activation_max, GetTensorData<uint8_t>(output),
+        GetTensorDims(output));
   } else {
-    depthwise_conv = &optimized_ops::DepthwiseConv;
+    multithreaded_ops::DepthwiseConvPerChannel(
+        GetTensorData<uint8_t>(input), GetTensorDims(input), input_offset,
+        GetTensorData<uint8_t>(filter), GetTensorDims(filter), filter_offset,
+        GetTensorData<int32_t>(bias), GetTensorDims(bias), params->stride_width,
+        params->stride_height, data->padding.width, data->padding.height,
+        params->depth_multiplier, output_offset,
+        data->per_channel_output_multiplier.data(),
+        data->per_channel_output_shift.data(), data->output_activation_min,
+        data->output_activation_max, GetTensorData<uint8_t>(output),
+        GetTensorDims(output), gemm_support::GetFromContext(context));
   }
+}
 
-  depthwise_conv(
-      GetTensorData<uint8_t>(input), GetTensorDims(input), input_offset,
-      GetTensorData<uint8_t>(filter), GetTensorDims(filter), filter_offset,
-      GetTensorData<int32_t>(bias), GetTensorDims(bias), params->stride_width,
-      params->stride_height, data->padding.width, data->padding.height,
-      params->depth_multiplier, output_offset, data->output_multiplier,
-      data->output_shift, data->output_activation_min,
-      data->output_activation_max, GetTensorData<uint8_t>(output),
-      GetTensorDims(output));
+// Evaluates a depthwise convolution with float input and output and weights
+// quantized symmetrically to int8 (stored as uint8), optionally per output
+// channel. Each batch of the input is quantized the same way, so that the
+// products run on 8-bit integers; the int32 sums are then scaled back to float.
+void EvalHybrid(TfLiteContext* context, TfLiteNode* node,
+                TfLiteDepthwiseConvParams* params, OpData* data,
+                const TfLiteTensor* input, const TfLiteTensor* filter,
+                const TfLiteTensor* bias, TfLiteTensor* output) {
+  const int batches = SizeOfDimension(input, 0);
+  const int input_height = SizeOfDimension(input, 1);
+  const int input_width = SizeOfDimension(input, 2);
+  const int input_depth = SizeOfDimension(input, 3);
+  const int filter_height = SizeOfDimension(filter, 1);
+  const int filter_width = SizeOfDimension(filter, 2);
+  const int output_height = SizeOfDimension(output, 1);
+  const int output_width = SizeOfDimension(output, 2);
+  const int output_depth = SizeOfDimension(output, 3);
+  const int depth_multiplier = params->depth_multiplier;
+  const int input_size = input_height * input_width * input_depth;
+
+  const int8_t* filter_data =
+      reinterpret_cast<const int8_t*>(GetTensorData<uint8_t>(filter));
+  int8_t* quantized_input_data = reinterpret_cast<int8_t*>(
+      GetTensorData<uint8_t>(GetTemporary(context, node, 0)));
+  int32_t* accumulators =
+      GetTensorData<int32_t>(GetTemporary(context, node, 1));
+  const float* bias_data = GetTensorData<float>(bias);
+  float* output_data = GetTensorData<float>(output);
+
+  float output_activation_min, output_activation_max;
+  CalculateActivationRangeFloat(params->activation, &output_activation_min,
+                                &output_activation_max);
+
+  for (int b = 0; b < batches; ++b) {
+    float min, max, scaling_factor;
+    tensor_utils::SymmetricQuantizeFloats(
+        GetTensorData<float>(input) + b * input_size, input_size,
+        quantized_input_data, &min, &max, &scaling_factor);
+    for (int out_y = 0; out_y < output_height; ++out_y) {
+      for (int out_x = 0; out_x < output_width; ++out_x) {
+        memset(accumulators, 0, output_depth * sizeof(int32_t));
+        for (int filter_y = 0; filter_y < filter_height; ++filter_y) {
+          const int in_y =
+              out_y * params->stride_height - data->padding.height + filter_y;
+          if (in_y < 0 || in_y >= input_height) continue;
+          for (int filter_x = 0; filter_x < filter_width; ++filter_x) {
+            const int in_x =
+                out_x * params->stride_width - data->padding.width + filter_x;
+            if (in_x < 0 || in_x >= input_width) continue;
+            const int8_t* input_ptr =
+                quantized_input_data +
+                (in_y * input_width + in_x) * input_depth;
+            const int8_t* filter_ptr =
+                filter_data +
+                (filter_y * filter_width + filter_x) * output_depth;
+            for (int ic = 0; ic < input_depth; ++ic) {
+              const int32_t input_value = input_ptr[ic];
+              for (int m = 0; m < depth_multiplier; ++m) {
+                const int oc = ic * depth_multiplier + m;
+                accumulators[oc] += input_value * filter_ptr[oc];
+              }
+            }
+          }
+        }
+        // Dequantize with the scales of the input and the filter, which are
+        // the factors the values were multiplied by.
+        float* output_ptr =
+            output_data +
+            ((b * output_height + out_y) * output_width + out_x) * output_depth;
+        for (int oc = 0; oc < output_depth; ++oc) {
+          const float value =
+              accumulators[oc] /
+                  (scaling_factor * GetChannelScale(filter, oc)) +
+              (bias_data ? bias_data[oc] : 0.0f);
+          output_ptr[oc] = std::min(std::max(value, output_activation_min),
+                                    output_activation_max);
+        }
+      }
+    }
+  }
 }
 
 template <KernelType kernel_type>
@@ -240,12 +434,21 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   // separate ops to avoid dispatch overhead here.
   switch (input->type) {  // Already know in/out types are same.
     case kTfLiteFloat32:
-      EvalFloat<kernel_type>(context, node, params, data, input, filter, bias,
-                             output);
+      if (filter->type == kTfLiteUInt8) {
+        EvalHybrid(context, node, params, data, input, filter, bias, output);
+      } else {
+        EvalFloat<kernel_type>(context, node, params, data, input, filter,
+                               bias, output);
+      }
       break;
     case kTfLiteUInt8:
-      EvalQuantized<kernel_type>(context, node, params, data, input, filter,
-                                 bias, output);
+      if (filter->channel_scales) {
+        EvalQuantizedPerChannel<kernel_type>(context, node, params, data, input,
+                                             filter, bias, output);
+      } else {
+        EvalQuantized<kernel_type>(context, node, params, data, input, filter,
+                                   bias, output);
+      }
       break;
     default:
       context->ReportError(context, "Type %d not currently supported.",
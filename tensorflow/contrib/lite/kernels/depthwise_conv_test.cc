@@ -110,6 +110,84 @@ TEST(DepthwiseConvolutionOpTest, SimpleTest) {
                              }));
 }
 
+class HybridDepthwiseConvolutionOpModel
+    : public BaseDepthwiseConvolutionOpModel {
+ public:
+  using BaseDepthwiseConvolutionOpModel::BaseDepthwiseConvolutionOpModel;
+
+  void SetFilter(std::initializer_list<float> f) {
+    SymmetricQuantizeAndPopulate(filter_, f);
+  }
+
+  void SetPerChannelFilter(std::initializer_list<float> f) {
+    PerChannelSymmetricQuantizeAndPopulate(filter_, f, /*channel_dim=*/3);
+  }
+
+  void SetBias(std::initializer_list<float> f) { PopulateTensor(bias_, f); }
+
+  void SetInput(std::initializer_list<float> data) {
+    PopulateTensor(input_, data);
+  }
+
+  std::vector<float> GetOutput() { return ExtractVector<float>(output_); }
+};
+
+TEST(HybridDepthwiseConvolutionOpTest, SimpleTest) {
+  HybridDepthwiseConvolutionOpModel m({TensorType_FLOAT32, {1, 3, 2, 2}},
+                                      {TensorType_UINT8, {1, 2, 2, 4}},
+                                      {TensorType_FLOAT32, {}});
+
+  m.SetInput({
+      1, 2, 7, 8,    // column 1
+      3, 4, 9, 10,   // column 2
+      5, 6, 11, 12,  // column 3
+  });
+  m.SetFilter({
+      1, 2, 3, 4,        //
+      -9, 10, -11, 12,   //
+      5, 6, 7, 8,        //
+      13, -14, 15, -16,  //
+  });
+  m.SetBias({1, 2, 3, 4});
+
+  m.Invoke();
+
+  EXPECT_THAT(m.GetOutput(), ElementsAreArray(ArrayFloatNear(
+                                 {
+                                     71, -34, 99, -20,  //
+                                     91, -26, 127, -4,  //
+                                 },
+                                 1.0)));
+}
+
+TEST(HybridDepthwiseConvolutionOpTest, SimpleTestPerChannel) {
+  HybridDepthwiseConvolutionOpModel m({TensorType_FLOAT32, {1, 3, 2, 2}},
+                                      {TensorType_UINT8, {1, 2, 2, 4}},
+                                      {TensorType_FLOAT32, {}});
+
+  m.SetInput({
+      1, 2, 7, 8,    // column 1
+      3, 4, 9, 10,   // column 2
+      5, 6, 11, 12,  // column 3
+  });
+  m.SetPerChannelFilter({
+      1, 2, 3, 4,        //
+      -9, 10, -11, 12,   //
+      5, 6, 7, 8,        //
+      13, -14, 15, -16,  //
+  });
+  m.SetBias({1, 2, 3, 4});
+
+  m.Invoke();
+
+  EXPECT_THAT(m.GetOutput(), ElementsAreArray(ArrayFloatNear(
+                                 {
+                                     71, -34, 99, -20,  //
+                                     91, -26, 127, -4,  //
+                                 },
+                                 1.0)));
+}
+
 class QuantizedDepthwiseConvolutionOpModel
     : public BaseDepthwiseConvolutionOpModel {
  public:
@@ -170,6 +248,61 @@ TEST(QuantizedDepthwiseConvolutionOpTest, SimpleTestQuantized) {
                              }));
 }
 
+class PerChannelQuantizedDepthwiseConvolutionOpModel
+    : public QuantizedDepthwiseConvolutionOpModel {
+ public:
+  using QuantizedDepthwiseConvolutionOpModel::
+      QuantizedDepthwiseConvolutionOpModel;
+
+  // Gives each output channel of the filter its own scale, and the bias the
+  // matching ones.
+  void SetFilterScales(const std::vector<float>& scales) {
+    std::vector<float> bias_scales;
+    for (float scale : scales) {
+      bias_scales.push_back(GetScale(input_) * scale);
+    }
+    SetChannelScales(filter_, scales);
+    SetChannelScales(bias_, bias_scales);
+    CHECK(interpreter_->AllocateTensors() == kTfLiteOk);
+  }
+
+  void SetFilter(std::initializer_list<float> data) {
+    PerChannelQuantizeAndPopulate<uint8_t>(filter_, data, /*channel_dim=*/3);
+  }
+
+  void SetBias(std::initializer_list<float> data) {
+    PerChannelQuantizeAndPopulate<int32_t>(bias_, data, /*channel_dim=*/0);
+  }
+};
+
+TEST(QuantizedDepthwiseConvolutionOpTest, SimpleTestQuantizedPerChannel) {
+  PerChannelQuantizedDepthwiseConvolutionOpModel m(
+      {TensorType_UINT8, {1, 3, 2, 2}, -63.5, 64},
+      {TensorType_UINT8, {1, 2, 2, 4}, -63.5, 64},
+      {TensorType_UINT8, {}, -127, 128});
+  m.SetFilterScales({0.125, 0.25, 0.125, 0.5});
+
+  m.SetInput({
+      1, 2, 7, 8,    // column 1
+      3, 4, 9, 10,   // column 2
+      5, 6, 11, 12,  // column 3
+  });
+  m.SetFilter({
+      1, 2, 3, 4,        //
+      -9, 10, -11, 12,   //
+      5, 6, 7, 8,        //
+      13, -14, 15, -16,  //
+  });
+  m.SetBias({1, 2, 3, 4});
+
+  m.Invoke();
+
+  EXPECT_THAT(m.GetOutput(), ElementsAreArray({
+                                 198, 93, 226, 107,   //
+                                 218, 101, 254, 123,  //
+                             }));
+}
+
 TEST(QuantizedDepthwiseConvolutionOpTest,
      SimpleTestQuantizedFilterMultiplierGreaterThan1) {
   QuantizedDepthwiseConvolutionOpModel quant_op(
@@ -20,6 +20,7 @@ limitations under the License.
 #include <cstdlib>
 #include <iostream>
 #include <limits>
+#include <vector>
 
 #include "tensorflow/contrib/lite/builtin_op_data.h"
 #include "tensorflow/contrib/lite/context.h"
@@ -51,12 +52,19 @@ struct OpData {
   // be represented as a fixed point multiplier plus a left shift.
   int32_t output_multiplier;
   int output_shift;
+  // The same for each output unit, when the weights are quantized per unit
+  // (see TfLiteTensor::channel_scales). Positive shifts are right shifts.
+  std::vector<int32_t> per_channel_output_multiplier;
+  std::vector<int> per_channel_output_shift;
   // The range of the fused activation layer. For example for kNone and
   // uint8_t these would be 0 and 255.
   int32_t output_activation_min;
   int32_t output_activation_max;
   // The index of the temporary tensor where the quantized inputs are cached.
   int input_quantized_index;
+  // The index of the temporary tensor holding the int32 accumulators of the
+  // kernels with per-channel weights.
+  int accum_scratch_index;
 };
 
 constexpr int kInputTensor = 0;
@@ -72,6 +80,7 @@ void* Init(TfLiteContext* context, const char* buffer, size_t length) {
   gemm_support::IncrementUsageCounter(context);
   auto* op_data = new OpData;
   context->AddTensors(context, 1, &op_data->input_quantized_index);
+  context->AddTensors(context, 1, &op_data->accum_scratch_index);
   return op_data;
 }
 
@@ -113,7 +122,25 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   // Note that quantized inference requires that all tensors have their
   // parameters set. This is usually done during quantized training.
   TfLiteType data_type = input->type;
-  if (data_type != kTfLiteFloat32) {
+  const bool is_per_channel =
+      data_type == kTfLiteUInt8 && filter->channel_scales != nullptr;
+  if (is_per_channel) {
+    std::vector<double> real_multipliers(num_units);
+    TF_LITE_ENSURE_STATUS(GetQuantizedConvolutionMultipliers(
+        context, input, filter, bias, output, num_units,
+        real_multipliers.data()));
+    data->per_channel_output_multiplier.resize(num_units);
+    data->per_channel_output_shift.resize(num_units);
+    for (int i = 0; i < num_units; ++i) {
+      int exponent;
+      QuantizeMultiplier(real_multipliers[i],
+                         &data->per_channel_output_multiplier[i], &exponent);
+      data->per_channel_output_shift[i] = -exponent;
+    }
+    CalculateActivationRangeUint8(params->activation, output,
+                                  &data->output_activation_min,
+                                  &data->output_activation_max);
+  } else if (data_type != kTfLiteFloat32) {
     double real_multiplier = 0.0;
     TF_LITE_ENSURE_STATUS(GetQuantizedConvolutionMultipler(
         context, input, filter, bias, output, &real_multiplier));
@@ -146,6 +173,23 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
     }
   }
 
+  // The optimized kernels for per-channel weights need the int32 accumulators
+  // of the whole output before scaling them down.
+  if (is_per_channel) {
+    TfLiteIntArrayFree(node->temporaries);
+    node->temporaries = TfLiteIntArrayCreate(1);
+    node->temporaries->data[0] = data->accum_scratch_index;
+
+    TfLiteTensor* accum_scratch = &context->tensors[data->accum_scratch_index];
+    accum_scratch->type = kTfLiteInt32;
+    accum_scratch->allocation_type = kTfLiteArenaRw;
+    TfLiteIntArray* accum_scratch_size = TfLiteIntArrayCreate(2);
+    accum_scratch_size->data[0] = batch_size;
+    accum_scratch_size->data[1] = num_units;
+    TF_LITE_ENSURE_OK(context, context->ResizeTensor(context, accum_scratch,
+                                                     accum_scratch_size));
+  }
+
   // Resize output.
   TfLiteIntArray* output_size_array = TfLiteIntArrayCreate(2);
   output_size_array->data[0] = batch_size;
@@ -307,6 +351,40 @@ TfLiteStatus EvalQuantized(TfLiteContext* context, TfLiteNode* node,
   return kTfLiteOk;
 }
 
+template <KernelType kernel_type>
+TfLiteStatus EvalQuantizedPerChannel(TfLiteContext* context, TfLiteNode* node,
+                                     TfLiteFullyConnectedParams* params,
+                                     OpData* data, const TfLiteTensor* input,
+                                     const TfLiteTensor* filter,
+                                     const TfLiteTensor* bias,
+                                     TfLiteTensor* output) {
+  int32_t input_offset = -input->params.zero_point;
+  int32_t filter_offset = -filter->params.zero_point;
+  int32_t output_offset = output->params.zero_point;
+  if (kernel_type == kReference) {
+    reference_ops::FullyConnectedPerChannel(
+        GetTensorData<uint8_t>(input), GetTensorDims(input), input_offset,
+        GetTensorData<uint8_t>(filter), GetTensorDims(filter), filter_offset,
+        GetTensorData<int32_t>(bias), GetTensorDims(bias), output_offset,
+        data->per_channel_output_multiplier.data(),
+        data->per_channel_output_shift.data(), data->output_activation_min,
+        data->output_activation_max, GetTensorData<uint8_t>(output),
+        GetTensorDims(output));
+  } else {
+    TfLiteTensor* accum_scratch = &context->tensors[data->accum_scratch_index];
+    optimized_ops::FullyConnectedPerChannel(
+        GetTensorData<uint8_t>(input), GetTensorDims(input), input_offset,
+        GetTensorData<uint8_t>(filter), GetTensorDims(filter), filter_offset,
+        GetTensorData<int32_t>(bias), GetTensorDims(bias), output_offset,
+        data->per_channel_output_multiplier.data(),
+        data->per_channel_output_shift.data(), data->output_activation_min,
+        data->output_activation_max, GetTensorData<uint8_t>(output),
+        GetTensorDims(output), GetTensorData<int32_t>(accum_scratch),
+        gemm_support::GetFromContext(context));
+  }
+  return kTfLiteOk;
+}
+
 template <KernelType kernel_type>
 TfLiteStatus EvalFloat(TfLiteContext* context, TfLiteNode* node,
                        TfLiteFullyConnectedParams* params, OpData* data,
@@ -351,6 +429,10 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
       return EvalFloat<kernel_type>(context, node, params, data, input, filter,
                                     bias, output);
     case kTfLiteUInt8:
+      if (input->type == kTfLiteUInt8 && filter->channel_scales) {
+        return EvalQuantizedPerChannel<kernel_type>(
+            context, node, params, data, input, filter, bias, output);
+      }
       return EvalQuantized<kernel_type>(context, node, params, data, input,
                                         filter, bias, output);
     default:
@@ -225,6 +225,31 @@ class QuantizedFullyConnectedOpModel : public BaseFullyConnectedOpModel {
   }
 };
 
+class PerChannelQuantizedFullyConnectedOpModel
+    : public QuantizedFullyConnectedOpModel {
+ public:
+  using QuantizedFullyConnectedOpModel::QuantizedFullyConnectedOpModel;
+
+  // Gives the weights of each unit their own scale, and the bias the matching
+  // ones.
+  void SetWeightScales(const std::vector<float>& scales) {
+    std::vector<float> bias_scales;
+    for (float scale : scales) {
+      bias_scales.push_back(GetScale(input_) * scale);
+    }
+    SetChannelScales(weights_, scales);
+    SetChannelScales(bias_, bias_scales);
+    CHECK(interpreter_->AllocateTensors() == kTfLiteOk);
+  }
+
+  void SetBias(std::initializer_list<float> data) {
+    PerChannelQuantizeAndPopulate<int32_t>(bias_, data, /*channel_dim=*/0);
+  }
+  void SetWeights(std::initializer_list<float> data) {
+    PerChannelQuantizeAndPopulate<uint8_t>(weights_, data, /*channel_dim=*/0);
+  }
+};
+
 // In the hybrid model the weights are quantized (to uint8). But the bias,
 // input (and output) are expected to be in float precision.
 class HybridFullyConnectedOpModel : public SingleOpModel {
@@ -368,6 +393,30 @@ TEST_P(QuantizedFullyConnectedOpTest, SimpleTestQuantized) {
   EXPECT_THAT(m.GetOutput(), ElementsAre(151, 152, 153, 185, 186, 187));
 }
 
+TEST_P(QuantizedFullyConnectedOpTest, SimpleTestQuantizedPerChannel) {
+  PerChannelQuantizedFullyConnectedOpModel m(
+      GetRegistration(), /*units=*/3, /*batches*/ 2,
+      /*input=*/{TensorType_UINT8, {2, 10}, -63.5, 64},
+      /*output=*/{TensorType_UINT8, {}, -127, 128});
+  m.SetWeightScales({0.5, 0.25, 0.125});
+
+  m.SetWeights({
+      1, 2, 3, 4, 5, 6, 7, 8, 9, 10,  // u = 0
+      1, 2, 3, 4, 5, 6, 7, 8, 9, 10,  // u = 1
+      1, 2, 3, 4, 5, 6, 7, 8, 9, 10,  // u = 2
+  });
+  m.SetBias({1, 2, 3});
+
+  m.SetInput({
+      1, 2, 3, 4, 5, 6, 7, 8,  -9, -10,  // b = 0
+      1, 2, 3, 4, 5, 6, 7, -8, 9,  -10,  // b = 1
+  });
+
+  m.Invoke();
+
+  EXPECT_THAT(m.GetOutput(), ElementsAre(151, 152, 153, 185, 186, 187));
+}
+
 TEST(HybridFullyConnectedOpTest, SimpleTestQuantized) {
   HybridFullyConnectedOpModel m(
       /*units=*/3, /*batches=*/2,
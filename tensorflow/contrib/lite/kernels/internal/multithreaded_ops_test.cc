@@ -0,0 +1,210 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "public/gemmlowp.h"
+#include "tensorflow/contrib/lite/kernels/internal/test_util.h"
+#include "tensorflow/contrib/lite/kernels/internal/types.h"
+
+#define ALLOW_SLOW_GENERIC_DEPTHWISECONV_FALLBACK
+#include "tensorflow/contrib/lite/kernels/internal/optimized/multithreaded_ops.h"
+
+namespace tflite {
+namespace {
+
+constexpr int kNumThreads = 4;
+
+// Large enough for the ops to be split over all the threads.
+struct TestShape {
+  int batch;
+  int depth;
+  int width;
+  int height;
+  int filter_size;
+  int stride;
+  PaddingType padding_type;
+};
+
+std::vector<TestShape> TestShapes() {
+  return {
+      {1, 32, 56, 56, 3, 1, PaddingType::kSame},
+      {1, 64, 28, 28, 3, 2, PaddingType::kSame},
+      {1, 16, 40, 33, 5, 2, PaddingType::kValid},
+      {3, 24, 30, 30, 3, 1, PaddingType::kSame},
+      {5, 8, 20, 20, 2, 2, PaddingType::kValid},
+  };
+}
+
+class MultithreadedOpsTest : public ::testing::Test {
+ protected:
+  MultithreadedOpsTest() { gemm_context_.set_max_num_threads(kNumThreads); }
+
+  gemmlowp::GemmContext gemm_context_;
+};
+
+TEST_F(MultithreadedOpsTest, DepthwiseConvMatchesSingleThreaded) {
+  for (const TestShape& shape : TestShapes()) {
+    const Dims<4> input_dims = MakeDimsForInference(shape.depth, shape.width,
+                                                    shape.height, shape.batch);
+    Dims<4> output_dims;
+    int pad_width, pad_height;
+    ASSERT_TRUE(ComputeConvSizes(input_dims, shape.depth, shape.filter_size,
+                                 shape.filter_size, shape.stride,
+                                 shape.padding_type, &output_dims, &pad_width,
+                                 &pad_height));
+    const Dims<4> filter_dims = MakeDimsForInference(
+        shape.depth, shape.filter_size, shape.filter_size, 1);
+    const Dims<4> bias_dims = MakeDimsForInference(shape.depth, 1, 1, 1);
+    std::vector<float> input(RequiredBufferSizeForDims(input_dims));
+    std::vector<float> filter(RequiredBufferSizeForDims(filter_dims));
+    std::vector<float> bias(shape.depth);
+    FillRandom(&input, -1.f, 1.f);
+    FillRandom(&filter, -1.f, 1.f);
+    FillRandom(&bias, -1.f, 1.f);
+
+    const int output_size = RequiredBufferSizeForDims(output_dims);
+    std::vector<float> expected(output_size);
+    std::vector<float> output(output_size);
+    optimized_ops::DepthwiseConv(
+        input.data(), input_dims, filter.data(), filter_dims, bias.data(),
+        bias_dims, shape.stride, shape.stride, pad_width, pad_height,
+        /*depth_multiplier=*/1, 0.f, 6.f, expected.data(), output_dims);
+    multithreaded_ops::DepthwiseConv(
+        input.data(), input_dims, filter.data(), filter_dims, bias.data(),
+        bias_dims, shape.stride, shape.stride, pad_width, pad_height,
+        /*depth_multiplier=*/1, 0.f, 6.f, output.data(), output_dims,
+        &gemm_context_);
+    EXPECT_EQ(output, expected);
+  }
+}
+
+TEST_F(MultithreadedOpsTest, PoolingMatchesSingleThreaded) {
+  for (const TestShape& shape : TestShapes()) {
+    const Dims<4> input_dims = MakeDimsForInference(shape.depth, shape.width,
+                                                    shape.height, shape.batch);
+    Dims<4> output_dims;
+    int pad_width, pad_height;
+    ASSERT_TRUE(ComputeConvSizes(input_dims, shape.depth, shape.filter_size,
+                                 shape.filter_size, shape.stride,
+                                 shape.padding_type, &output_dims, &pad_width,
+                                 &pad_height));
+    std::vector<float> input(RequiredBufferSizeForDims(input_dims));
+    FillRandom(&input, -1.f, 1.f);
+
+    const int output_size = RequiredBufferSizeForDims(output_dims);
+    std::vector<float> expected(output_size);
+    std::vector<float> output(output_size);
+    optimized_ops::AveragePool(input.data(), input_dims, shape.stride,
+                               shape.stride, pad_width, pad_height,
+                               shape.filter_size, shape.filter_size, -10.f,
+                               10.f, expected.data(), output_dims);
+    multithreaded_ops::AveragePool(input.data(), input_dims, shape.stride,
+                                   shape.stride, pad_width, pad_height,
+                                   shape.filter_size, shape.filter_size,
+                                   -10.f, 10.f, output.data(), output_dims,
+                                   &gemm_context_);
+    EXPECT_EQ(output, expected);
+
+    optimized_ops::MaxPool(input.data(), input_dims, shape.stride,
+                           shape.stride, pad_width, pad_height,
+                           shape.filter_size, shape.filter_size, -10.f, 10.f,
+                           expected.data(), output_dims);
+    multithreaded_ops::MaxPool(input.data(), input_dims, shape.stride,
+                               shape.stride, pad_width, pad_height,
+                               shape.filter_size, shape.filter_size, -10.f,
+                               10.f, output.data(), output_dims,
+                               &gemm_context_);
+    EXPECT_EQ(output, expected);
+  }
+}
+
+TEST_F(MultithreadedOpsTest, ElementwiseMatchesSingleThreaded) {
+  const Dims<4> dims = MakeDimsForInference(32, 56, 56, 1);
+  const int size = RequiredBufferSizeForDims(dims);
+  std::vector<float> input1(size);
+  std::vector<float> input2(size);
+  FillRandom(&input1, -1.f, 1.f);
+  FillRandom(&input2, -1.f, 1.f);
+  std::vector<float> expected(size);
+  std::vector<float> output(size);
+
+  optimized_ops::Add(input1.data(), dims, input2.data(), dims, -1.f, 1.f,
+                     expected.data(), dims);
+  multithreaded_ops::Add(input1.data(), dims, input2.data(), dims, -1.f, 1.f,
+                         output.data(), dims, &gemm_context_);
+  EXPECT_EQ(output, expected);
+
+  optimized_ops::Mul(input1.data(), dims, input2.data(), dims, -1.f, 1.f,
+                     expected.data(), dims);
+  multithreaded_ops::Mul(input1.data(), dims, input2.data(), dims, -1.f, 1.f,
+                         output.data(), dims, &gemm_context_);
+  EXPECT_EQ(output, expected);
+
+  optimized_ops::Softmax(input1.data(), dims, 1.f, expected.data(), dims);
+  multithreaded_ops::Softmax(input1.data(), dims, 1.f, output.data(), dims,
+                             &gemm_context_);
+  for (int i = 0; i < size; ++i) {
+    EXPECT_NEAR(output[i], expected[i], 1e-6f);
+  }
+}
+
+TEST_F(MultithreadedOpsTest, ResizeBilinearMatchesSingleThreaded) {
+  const Dims<4> input_dims = MakeDimsForInference(16, 30, 20, 2);
+  const Dims<4> output_size_dims = MakeDimsForInference(2, 1, 1, 1);
+  std::vector<float> input(RequiredBufferSizeForDims(input_dims));
+  FillRandom(&input, -1.f, 1.f);
+  // A 2x2 upsampling, which has its own kernel, and a generic one.
+  for (const std::vector<int32>& output_size :
+       {std::vector<int32>{40, 60}, std::vector<int32>{33, 47}}) {
+    const Dims<4> output_dims =
+        MakeDimsForInference(16, output_size[1], output_size[0], 2);
+    const int size = RequiredBufferSizeForDims(output_dims);
+    std::vector<float> expected(size);
+    std::vector<float> output(size);
+    optimized_ops::ResizeBilinear(input.data(), input_dims, output_size.data(),
+                                  output_size_dims, expected.data(),
+                                  output_dims, /*align_corners=*/false);
+    multithreaded_ops::ResizeBilinear(
+        input.data(), input_dims, output_size.data(), output_size_dims,
+        output.data(), output_dims, /*align_corners=*/false, &gemm_context_);
+    EXPECT_EQ(output, expected);
+  }
+}
+
+TEST_F(MultithreadedOpsTest, ConcatenationMatchesSingleThreaded) {
+  const Dims<4> input1_dims = MakeDimsForInference(16, 40, 40, 1);
+  const Dims<4> input2_dims = MakeDimsForInference(24, 40, 40, 1);
+  const Dims<4> output_dims = MakeDimsForInference(40, 40, 40, 1);
+  std::vector<float> input1(RequiredBufferSizeForDims(input1_dims));
+  std::vector<float> input2(RequiredBufferSizeForDims(input2_dims));
+  FillRandom(&input1, -1.f, 1.f);
+  FillRandom(&input2, -1.f, 1.f);
+  const float* input_data[] = {input1.data(), input2.data()};
+  const Dims<4>* input_dims[] = {&input1_dims, &input2_dims};
+
+  const int size = RequiredBufferSizeForDims(output_dims);
+  std::vector<float> expected(size);
+  std::vector<float> output(size);
+  optimized_ops::Concatenation<FusedActivationFunctionType::kNone, float>(
+      /*concat_dim=*/0, input_data, input_dims, 2, expected.data(),
+      output_dims);
+  multithreaded_ops::Concatenation(/*concat_dim=*/0, input_data, input_dims, 2,
+                                   output.data(), output_dims, &gemm_context_);
+  EXPECT_EQ(output, expected);
+}
+
+}  // namespace
+}  // namespace tflite
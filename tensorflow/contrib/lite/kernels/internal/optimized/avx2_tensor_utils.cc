@@ -0,0 +1,368 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+
+#include "tensorflow/contrib/lite/kernels/internal/compatibility.h"
+#include "tensorflow/contrib/lite/kernels/internal/optimized/cpu_check.h"
+#include "tensorflow/contrib/lite/kernels/internal/optimized/tensor_utils_impl.h"
+#include "tensorflow/contrib/lite/kernels/internal/round.h"
+
+#ifdef TFLITE_USE_AVX2_DISPATCH
+
+#include <immintrin.h>
+
+// The kernels below are compiled for AVX2 and FMA whatever the build flags,
+// and must only be called when TestCPUFeatureAvx2() holds.
+#define TFLITE_AVX2_TARGET __attribute__((target("avx2,fma")))
+
+#define kFloatWeightsPerAvx2Lane 8
+
+namespace tflite {
+namespace tensor_utils {
+namespace {
+
+// Returns the sum of the 8 floats of `v`.
+TFLITE_AVX2_TARGET inline float HorizontalSum(__m256 v) {
+  __m128 sum =
+      _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+  return _mm_cvtss_f32(sum);
+}
+
+// Returns the sum of the 8 int32 of `v`.
+TFLITE_AVX2_TARGET inline int32_t HorizontalSum(__m256i v) {
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v),
+                              _mm256_extracti128_si256(v, 1));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum);
+}
+
+}  // namespace
+
+TFLITE_AVX2_TARGET void Avx2MatrixBatchVectorMultiplyAccumulate(
+    const float* matrix, int m_rows, int m_cols, const float* vector,
+    int n_batch, float* result, int result_stride) {
+  // If m_cols is not divisible by kFloatWeightsPerAvx2Lane, we cannot use the
+  // main vectorized loop, and we need to process sequentially.
+  // postamble_start shows the start index where this should happen.
+  const int postamble_start =
+      m_cols - (m_cols & (kFloatWeightsPerAvx2Lane - 1));
+
+  // Four rows are processed at once, so that each load of the vector serves
+  // four multiply-adds.
+  const int kUnrollSize = 4;
+  for (int b = 0; b < n_batch; b++) {
+    float* result_in_batch = result + b * m_rows * result_stride;
+    const float* vector_in_batch = vector + b * m_cols;
+    const float* matrix_ptr = matrix;
+
+    int r = 0;
+    for (; r <= m_rows - kUnrollSize; r += kUnrollSize) {
+      __m256 acc0 = _mm256_setzero_ps();
+      __m256 acc1 = _mm256_setzero_ps();
+      __m256 acc2 = _mm256_setzero_ps();
+      __m256 acc3 = _mm256_setzero_ps();
+      for (int c = 0; c < postamble_start; c += kFloatWeightsPerAvx2Lane) {
+        const __m256 v = _mm256_loadu_ps(vector_in_batch + c);
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(matrix_ptr + c), v, acc0);
+        acc1 =
+            _mm256_fmadd_ps(_mm256_loadu_ps(matrix_ptr + m_cols + c), v, acc1);
+        acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(matrix_ptr + 2 * m_cols + c), v,
+                               acc2);
+        acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(matrix_ptr + 3 * m_cols + c), v,
+                               acc3);
+      }
+      float sum0 = HorizontalSum(acc0);
+      float sum1 = HorizontalSum(acc1);
+      float sum2 = HorizontalSum(acc2);
+      float sum3 = HorizontalSum(acc3);
+      for (int c = postamble_start; c < m_cols; c++) {
+        sum0 += matrix_ptr[c] * vector_in_batch[c];
+        sum1 += matrix_ptr[m_cols + c] * vector_in_batch[c];
+        sum2 += matrix_ptr[2 * m_cols + c] * vector_in_batch[c];
+        sum3 += matrix_ptr[3 * m_cols + c] * vector_in_batch[c];
+      }
+      result_in_batch[0] += sum0;
+      result_in_batch[result_stride] += sum1;
+      result_in_batch[2 * result_stride] += sum2;
+      result_in_batch[3 * result_stride] += sum3;
+      matrix_ptr += kUnrollSize * m_cols;
+      result_in_batch += kUnrollSize * result_stride;
+    }
+    for (; r < m_rows; r++) {
+      __m256 acc = _mm256_setzero_ps();
+      for (int c = 0; c < postamble_start; c += kFloatWeightsPerAvx2Lane) {
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(matrix_ptr + c),
+                              _mm256_loadu_ps(vector_in_batch + c), acc);
+      }
+      float sum = HorizontalSum(acc);
+      for (int c = postamble_start; c < m_cols; c++) {
+        sum += matrix_ptr[c] * vector_in_batch[c];
+      }
+      *result_in_batch += sum;
+      matrix_ptr += m_cols;
+      result_in_batch += result_stride;
+    }
+  }
+}
+
+TFLITE_AVX2_TARGET void Avx2MatrixBatchVectorMultiplyAccumulate(
+    const int8_t* __restrict__ matrix, const int m_rows, const int m_cols,
+    const int8_t* __restrict__ vectors, const float* scaling_factors,
+    int n_batch, float* __restrict__ result, int result_stride) {
+  const int kWeightsPerAvx2Lane = 32;
+  const int postamble_start = m_cols - (m_cols & (kWeightsPerAvx2Lane - 1));
+  const __m256i ones_16x16 = _mm256_set1_epi16(1);
+
+  for (int batch = 0; batch < n_batch; ++batch, vectors += m_cols) {
+    const float batch_scaling_factor_inv = 1.0 / scaling_factors[batch];
+    const int8_t* row_ptr = matrix;
+    for (int row = 0; row < m_rows; ++row, result += result_stride) {
+      __m256i dotprod_32x8 = _mm256_setzero_si256();
+      int col = 0;
+      for (; col < postamble_start; col += kWeightsPerAvx2Lane) {
+        const __m256i v_8x32 =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vectors + col));
+        const __m256i m_8x32 =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row_ptr + col));
+        // _mm256_maddubs_epi16 multiplies unsigned by signed bytes, so the
+        // sign of the vector moves to the matrix. As the values are quantized
+        // to [-127, 127], the sums of two products fit in 16 bits.
+        const __m256i prod_16x16 = _mm256_maddubs_epi16(
+            _mm256_sign_epi8(v_8x32, v_8x32), _mm256_sign_epi8(m_8x32, v_8x32));
+        dotprod_32x8 = _mm256_add_epi32(
+            dotprod_32x8, _mm256_madd_epi16(prod_16x16, ones_16x16));
+      }
+      int32_t dotprod = HorizontalSum(dotprod_32x8);
+      // Postamble loop.
+      for (; col < m_cols; ++col) {
+        dotprod += row_ptr[col] * vectors[col];
+      }
+      *result += dotprod * batch_scaling_factor_inv;
+      row_ptr += m_cols;
+    }
+  }
+}
+
+TFLITE_AVX2_TARGET void Avx2VectorVectorCwiseProduct(const float* vector1,
+                                                     const float* vector2,
+                                                     int v_size,
+                                                     float* result) {
+  const int postamble_start =
+      v_size - (v_size & (kFloatWeightsPerAvx2Lane - 1));
+  for (int v = 0; v < postamble_start; v += kFloatWeightsPerAvx2Lane) {
+    _mm256_storeu_ps(result + v, _mm256_mul_ps(_mm256_loadu_ps(vector1 + v),
+                                               _mm256_loadu_ps(vector2 + v)));
+  }
+  for (int v = postamble_start; v < v_size; v++) {
+    result[v] = vector1[v] * vector2[v];
+  }
+}
+
+TFLITE_AVX2_TARGET void Avx2VectorVectorCwiseProductAccumulate(
+    const float* vector1, const float* vector2, int v_size, float* result) {
+  const int postamble_start =
+      v_size - (v_size & (kFloatWeightsPerAvx2Lane - 1));
+  for (int v = 0; v < postamble_start; v += kFloatWeightsPerAvx2Lane) {
+    _mm256_storeu_ps(result + v, _mm256_fmadd_ps(_mm256_loadu_ps(vector1 + v),
+                                                 _mm256_loadu_ps(vector2 + v),
+                                                 _mm256_loadu_ps(result + v)));
+  }
+  for (int v = postamble_start; v < v_size; v++) {
+    result[v] += vector1[v] * vector2[v];
+  }
+}
+
+TFLITE_AVX2_TARGET void Avx2VectorBatchVectorCwiseProductAccumulate(
+    const float* vector, int v_size, const float* batch_vector, int n_batch,
+    float* result) {
+  for (int b = 0; b < n_batch; b++) {
+    Avx2VectorVectorCwiseProductAccumulate(vector, batch_vector, v_size,
+                                           result);
+    batch_vector += v_size;
+    result += v_size;
+  }
+}
+
+TFLITE_AVX2_TARGET float Avx2VectorVectorDotProduct(const float* vector1,
+                                                    const float* vector2,
+                                                    int v_size) {
+  const int postamble_start =
+      v_size - (v_size & (kFloatWeightsPerAvx2Lane - 1));
+  __m256 acc = _mm256_setzero_ps();
+  for (int v = 0; v < postamble_start; v += kFloatWeightsPerAvx2Lane) {
+    acc = _mm256_fmadd_ps(_mm256_loadu_ps(vector1 + v),
+                          _mm256_loadu_ps(vector2 + v), acc);
+  }
+  float result = HorizontalSum(acc);
+  for (int v = postamble_start; v < v_size; v++) {
+    result += vector1[v] * vector2[v];
+  }
+  return result;
+}
+
+TFLITE_AVX2_TARGET void Avx2BatchVectorBatchVectorDotProduct(
+    const float* vector1, const float* vector2, int v_size, int n_batch,
+    float* result, int result_stride) {
+  for (int b = 0; b < n_batch; b++) {
+    *result = Avx2VectorVectorDotProduct(vector1, vector2, v_size);
+    vector1 += v_size;
+    vector2 += v_size;
+    result += result_stride;
+  }
+}
+
+TFLITE_AVX2_TARGET void Avx2Sub1Vector(const float* vector, int v_size,
+                                       float* result) {
+  const int postamble_start =
+      v_size - (v_size & (kFloatWeightsPerAvx2Lane - 1));
+  const __m256 one = _mm256_set1_ps(1.0f);
+  for (int v = 0; v < postamble_start; v += kFloatWeightsPerAvx2Lane) {
+    _mm256_storeu_ps(result + v,
+                     _mm256_sub_ps(one, _mm256_loadu_ps(vector + v)));
+  }
+  for (int v = postamble_start; v < v_size; v++) {
+    result[v] = 1.0f - vector[v];
+  }
+}
+
+TFLITE_AVX2_TARGET bool Avx2IsZeroVector(const float* vector, int v_size) {
+  const int postamble_start =
+      v_size - (v_size & (kFloatWeightsPerAvx2Lane - 1));
+  const __m256 zero = _mm256_setzero_ps();
+  for (int v = 0; v < postamble_start; v += kFloatWeightsPerAvx2Lane) {
+    const __m256 non_zero =
+        _mm256_cmp_ps(_mm256_loadu_ps(vector + v), zero, _CMP_NEQ_UQ);
+    if (_mm256_movemask_ps(non_zero) != 0) return false;
+  }
+  for (int v = postamble_start; v < v_size; ++v) {
+    if (vector[v] != 0.0) return false;
+  }
+  return true;
+}
+
+TFLITE_AVX2_TARGET void Avx2ClipVector(const float* vector, int v_size,
+                                       float abs_limit, float* result) {
+  const int postamble_start =
+      v_size - (v_size & (kFloatWeightsPerAvx2Lane - 1));
+  const __m256 abs_limit_f32x8 = _mm256_set1_ps(abs_limit);
+  const __m256 neg_abs_limit_f32x8 = _mm256_set1_ps(-abs_limit);
+  for (int v = 0; v < postamble_start; v += kFloatWeightsPerAvx2Lane) {
+    // The values are the second operands so that NaNs go through, as in the
+    // portable version.
+    __m256 v_f32x8 = _mm256_loadu_ps(vector + v);
+    v_f32x8 = _mm256_min_ps(abs_limit_f32x8, v_f32x8);
+    v_f32x8 = _mm256_max_ps(neg_abs_limit_f32x8, v_f32x8);
+    _mm256_storeu_ps(result + v, v_f32x8);
+  }
+  for (int v = postamble_start; v < v_size; v++) {
+    result[v] = (abs_limit < vector[v]) ? abs_limit : vector[v];
+    result[v] = (-abs_limit > result[v]) ? -abs_limit : result[v];
+  }
+}
+
+TFLITE_AVX2_TARGET void Avx2SymmetricQuantizeFloats(const float* values,
+                                                    const int size,
+                                                    int8_t* quantized_values,
+                                                    float* min, float* max,
+                                                    float* scaling_factor) {
+  const int postamble_start = size - (size & (kFloatWeightsPerAvx2Lane - 1));
+  if (postamble_start > 0) {
+    __m256 min_f32x8 = _mm256_loadu_ps(values);
+    __m256 max_f32x8 = min_f32x8;
+    for (int i = kFloatWeightsPerAvx2Lane; i < postamble_start;
+         i += kFloatWeightsPerAvx2Lane) {
+      const __m256 v_f32x8 = _mm256_loadu_ps(values + i);
+      min_f32x8 = _mm256_min_ps(min_f32x8, v_f32x8);
+      max_f32x8 = _mm256_max_ps(max_f32x8, v_f32x8);
+    }
+    float mins[kFloatWeightsPerAvx2Lane];
+    float maxs[kFloatWeightsPerAvx2Lane];
+    _mm256_storeu_ps(mins, min_f32x8);
+    _mm256_storeu_ps(maxs, max_f32x8);
+    *min = *std::min_element(mins, mins + kFloatWeightsPerAvx2Lane);
+    *max = *std::max_element(maxs, maxs + kFloatWeightsPerAvx2Lane);
+  } else if (size > 0) {
+    *min = *max = values[0];
+  }
+  for (int i = postamble_start; i < size; ++i) {
+    *min = std::min(*min, values[i]);
+    *max = std::max(*max, values[i]);
+  }
+
+  const int kScale = 127;
+  const float range = std::max(std::abs(*min), std::abs(*max));
+  if (range == 0) {
+    memset(quantized_values, 0, size * sizeof(int8_t));
+    *scaling_factor = 1;
+    return;
+  }
+  *scaling_factor = kScale / range;
+
+  const __m256 q_factor_f32x8 = _mm256_set1_ps(*scaling_factor);
+  const __m256 point5_f32x8 = _mm256_set1_ps(0.5f);
+  const __m256 sign_mask_f32x8 = _mm256_set1_ps(-0.0f);
+  const __m256i scale_i32x8 = _mm256_set1_epi32(kScale);
+  const __m256i neg_scale_i32x8 = _mm256_set1_epi32(-kScale);
+  for (int i = 0; i < postamble_start; i += kFloatWeightsPerAvx2Lane) {
+    // Rounds half away from zero, as TfLiteRound(), by adding +/-0.5 and
+    // truncating.
+    const __m256 mul_f32x8 =
+        _mm256_mul_ps(_mm256_loadu_ps(values + i), q_factor_f32x8);
+    const __m256 half_f32x8 =
+        _mm256_or_ps(point5_f32x8, _mm256_and_ps(mul_f32x8, sign_mask_f32x8));
+    __m256i q_i32x8 = _mm256_cvttps_epi32(_mm256_add_ps(mul_f32x8, half_f32x8));
+    q_i32x8 = _mm256_min_epi32(_mm256_max_epi32(q_i32x8, neg_scale_i32x8),
+                               scale_i32x8);
+    const __m128i q_i16x8 =
+        _mm_packs_epi32(_mm256_castsi256_si128(q_i32x8),
+                        _mm256_extracti128_si256(q_i32x8, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(quantized_values + i),
+                     _mm_packs_epi16(q_i16x8, q_i16x8));
+  }
+  for (int i = postamble_start; i < size; ++i) {
+    const int32_t quantized_value =
+        static_cast<int32_t>(TfLiteRound(*scaling_factor * values[i]));
+    quantized_values[i] = std::min(kScale, std::max(-kScale, quantized_value));
+  }
+}
+
+TFLITE_AVX2_TARGET void Avx2ReductionSumVector(const float* input_vector,
+                                               float* output_vector,
+                                               int output_size,
+                                               int reduction_size) {
+  const int postamble_start =
+      reduction_size - (reduction_size & (kFloatWeightsPerAvx2Lane - 1));
+  for (int o = 0; o < output_size; o++) {
+    __m256 sum_f32x8 = _mm256_setzero_ps();
+    for (int r = 0; r < postamble_start; r += kFloatWeightsPerAvx2Lane) {
+      sum_f32x8 = _mm256_add_ps(sum_f32x8, _mm256_loadu_ps(input_vector + r));
+    }
+    output_vector[o] += HorizontalSum(sum_f32x8);
+    for (int r = postamble_start; r < reduction_size; r++) {
+      output_vector[o] += input_vector[r];
+    }
+    input_vector += reduction_size;
+  }
+}
+
+}  // namespace tensor_utils
+}  // namespace tflite
+
+#endif  // TFLITE_USE_AVX2_DISPATCH
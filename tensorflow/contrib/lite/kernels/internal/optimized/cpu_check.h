@@ -44,6 +44,26 @@ inline bool TestCPUFeatureNeon() { return false; }
 
 #endif
 
+// On x86, the tensor utils have AVX2 and FMA versions, compiled function by
+// function for those instructions whatever the build flags, and selected when
+// the CPU supports them.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define TFLITE_USE_AVX2_DISPATCH
+
+inline bool TestCPUFeatureAvx2() {
+  static const bool kUseAvx2 = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  }();
+  return kUseAvx2;
+}
+
+#else
+
+inline bool TestCPUFeatureAvx2() { return false; }
+
+#endif
+
 }  // namespace tflite
 
 // NEON_OR_PORTABLE(SomeFunc, arcs) calls NeonSomeFunc(args) if Neon is both
@@ -19,6 +19,7 @@ limitations under the License.
 #include "public/gemmlowp.h"
 #include "tensorflow/contrib/lite/kernels/internal/common.h"
 #include "tensorflow/contrib/lite/kernels/internal/optimized/depthwiseconv_uint8_3x3_filter.h"
+#include "tensorflow/contrib/lite/kernels/internal/optimized/per_channel_output_stage.h"
 #include "tensorflow/contrib/lite/kernels/internal/types.h"
 
 namespace tflite {
@@ -1669,6 +1670,72 @@ inline void DepthwiseConvInitAccBuffer(int num_output_pixels, int output_depth,
   }
 }
 
+using QuantizedDepthwiseConvAccumRowFunc =
+    decltype(&QuantizedDepthwiseConvAccumRowGeneric);
+
+// Returns the core accumulation function to use for a DepthwiseConv op.
+inline QuantizedDepthwiseConvAccumRowFunc
+GetQuantizedDepthwiseConvAccumRowFunc(int stride_width, int input_depth,
+                                      int depth_multiplier) {
+  QuantizedDepthwiseConvAccumRowFunc row_accum_func = nullptr;
+
+#define TFMINI_USE_DEPTHWISECONV_KERNEL(ALLOW_STRIDED, FIXED_INPUT_DEPTH, \
+                                        FIXED_DEPTH_MULTIPLIER)           \
+  if (!row_accum_func && (stride_width == 1 || ALLOW_STRIDED) &&          \
+      (input_depth == FIXED_INPUT_DEPTH || FIXED_INPUT_DEPTH == 0) &&     \
+      depth_multiplier == FIXED_DEPTH_MULTIPLIER) {                       \
+    row_accum_func =                                                      \
+        QuantizedDepthwiseConvAccumRow<ALLOW_STRIDED, FIXED_INPUT_DEPTH,  \
+                                       FIXED_DEPTH_MULTIPLIER>;           \
+  }
+
+#ifdef USE_NEON
+  // We go over our list of kernels by decreasing order of preference
+  // for the cases where multiple kernels could apply.
+
+  // Start with the fastest kernels: AllowStrided=false, fixed input depth.
+
+  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 1, 2)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 2, 2)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 4, 2)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 1, 4)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 4, 1)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 4, 4)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 8, 1)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 2, 8)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 2, 1)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 12, 1)
+
+  // Next come the strided kernels: AllowStrided=true, fixed input depth.
+  // They are a bit less efficient, but allow stride!=1.
+
+  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 8, 2)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 16, 1)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 1, 16)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 1, 20)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 1, 32)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 1, 8)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 8, 1)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 2, 1)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 4, 1)
+
+  // Finally, the kernels allowing a variable input depth,
+  // these are the least efficient but most general kernels.
+
+  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 0, 1)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 0, 2)
+  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 0, 3)
+#endif  // USE_NEON
+
+  // No matching fast kernel found, use slow fallback.
+  if (!row_accum_func) {
+    row_accum_func = QuantizedDepthwiseConvAccumRowGeneric;
+  }
+
+#undef TFMINI_USE_DEPTHWISECONV_KERNEL
+  return row_accum_func;
+}
+
 inline void DepthwiseConv(const uint8* input_data, const Dims<4>& input_dims,
                           int32 input_offset, const uint8* filter_data,
                           const Dims<4>& filter_dims, int32 filter_offset,
@@ -1727,63 +1794,9 @@ inline void DepthwiseConv(const uint8* input_data, const Dims<4>& input_dims,
 
   // row_accum_func will point to the core accumulation function to be used
   // for this DepthwiseConv op.
-  using row_accum_func_t = decltype(&QuantizedDepthwiseConvAccumRowGeneric);
-  row_accum_func_t row_accum_func = nullptr;
-
-#define TFMINI_USE_DEPTHWISECONV_KERNEL(ALLOW_STRIDED, FIXED_INPUT_DEPTH, \
-                                        FIXED_DEPTH_MULTIPLIER)           \
-  if (!row_accum_func && (stride_width == 1 || ALLOW_STRIDED) &&          \
-      (input_depth == FIXED_INPUT_DEPTH || FIXED_INPUT_DEPTH == 0) &&     \
-      depth_multiplier == FIXED_DEPTH_MULTIPLIER) {                       \
-    row_accum_func =                                                      \
-        QuantizedDepthwiseConvAccumRow<ALLOW_STRIDED, FIXED_INPUT_DEPTH,  \
-                                       FIXED_DEPTH_MULTIPLIER>;           \
-  }
-
-#ifdef USE_NEON
-  // We go over our list of kernels by decreasing order of preference
-  // for the cases where multiple kernels could apply.
-
-  // Start with the fastest kernels: AllowStrided=false, fixed input depth.
-
-  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 1, 2)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 2, 2)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 4, 2)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 1, 4)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 4, 1)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 4, 4)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 8, 1)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 2, 8)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 2, 1)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(false, 12, 1)
-
-  // Next come the strided kernels: AllowStrided=true, fixed input depth.
-  // They are a bit less efficient, but allow stride!=1.
-
-  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 8, 2)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 16, 1)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 1, 16)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 1, 20)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 1, 32)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 1, 8)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 8, 1)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 2, 1)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 4, 1)
-
-  // Finally, the kernels allowing a variable input depth,
-  // these are the least efficient but most general kernels.
-
-  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 0, 1)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 0, 2)
-  TFMINI_USE_DEPTHWISECONV_KERNEL(true, 0, 3)
-#endif  // USE_NEON
-
-  // No matching fast kernel found, use slow fallback.
-  if (!row_accum_func) {
-    row_accum_func = QuantizedDepthwiseConvAccumRowGeneric;
-  }
-
-#undef TFMINI_USE_DEPTHWISECONV_KERNEL
+  const QuantizedDepthwiseConvAccumRowFunc row_accum_func =
+      GetQuantizedDepthwiseConvAccumRowFunc(stride_width, input_depth,
+                                            depth_multiplier);
 
   // Now that we have determined row_accum_func, we can start work.
   uint8* output_ptr = output_data;
@@ -1964,6 +1977,77 @@ inline void DepthwiseConv(const uint8* input_data, const Dims<4>& input_dims,
   }
 }
 
+// Like the quantized DepthwiseConv, but with one output multiplier and shift
+// for each output channel. The accumulation is the same, only the output
+// stage differs.
+inline void DepthwiseConvPerChannel(
+    const uint8* input_data, const Dims<4>& input_dims, int32 input_offset,
+    const uint8* filter_data, const Dims<4>& filter_dims, int32 filter_offset,
+    const int32* bias_data, const Dims<4>& bias_dims, int stride_width,
+    int stride_height, int pad_width, int pad_height, int depth_multiplier,
+    int32 output_offset, const int32* output_multiplier,
+    const int* output_shift, int32 output_activation_min,
+    int32 output_activation_max, uint8* output_data,
+    const Dims<4>& output_dims) {
+  gemmlowp::ScopedProfilingLabel label("DepthwiseConvPerChannel/8bit");
+  TFLITE_DCHECK_LE(output_activation_min, output_activation_max);
+
+  const int batches = MatchingArraySize(input_dims, 3, output_dims, 3);
+  const int output_depth = MatchingArraySize(filter_dims, 0, output_dims, 0);
+  const int input_height = ArraySize(input_dims, 2);
+  const int input_width = ArraySize(input_dims, 1);
+  const int input_depth = ArraySize(input_dims, 0);
+  const int filter_height = ArraySize(filter_dims, 2);
+  const int filter_width = ArraySize(filter_dims, 1);
+  const int output_height = ArraySize(output_dims, 2);
+  const int output_width = ArraySize(output_dims, 1);
+  TFLITE_DCHECK(output_depth == input_depth * depth_multiplier);
+
+  static const int kAccBufferMaxSize = 2048;
+  int32 acc_buffer[kAccBufferMaxSize];
+  TFLITE_DCHECK_GE(kAccBufferMaxSize, output_depth);
+  const int kOutputPixelsInAccBuffer = kAccBufferMaxSize / output_depth;
+  TFLITE_DCHECK_GE(kOutputPixelsInAccBuffer, 1);
+
+  const QuantizedDepthwiseConvAccumRowFunc row_accum_func =
+      GetQuantizedDepthwiseConvAccumRowFunc(stride_width, input_depth,
+                                            depth_multiplier);
+
+  uint8* output_ptr = output_data;
+  for (int b = 0; b < batches; ++b) {
+    for (int out_y = 0; out_y < output_height; ++out_y) {
+      const int in_y_origin = (out_y * stride_height) - pad_height;
+      const int filter_y_start = std::max(0, -in_y_origin);
+      const int filter_y_end =
+          std::min(filter_height, input_height - in_y_origin);
+      for (int out_x_buffer_start = 0; out_x_buffer_start < output_width;
+           out_x_buffer_start += kOutputPixelsInAccBuffer) {
+        const int out_x_buffer_end = std::min(
+            output_width, out_x_buffer_start + kOutputPixelsInAccBuffer);
+        const int num_output_pixels = out_x_buffer_end - out_x_buffer_start;
+        DepthwiseConvInitAccBuffer(num_output_pixels, output_depth, bias_data,
+                                   acc_buffer);
+        for (int filter_y = filter_y_start; filter_y < filter_y_end;
+             ++filter_y) {
+          const int in_y = in_y_origin + filter_y;
+          row_accum_func(
+              stride_width, input_depth, input_width,
+              input_data + in_y * input_dims.strides[2] +
+                  b * input_dims.strides[3],
+              input_offset, pad_width, depth_multiplier, filter_width,
+              filter_data + filter_y * filter_dims.strides[2], filter_offset,
+              out_x_buffer_start, out_x_buffer_end, output_depth, acc_buffer);
+        }
+        PerChannelQuantizeDown(acc_buffer, num_output_pixels, output_depth,
+                               output_multiplier, output_shift, output_offset,
+                               output_activation_min, output_activation_max,
+                               output_ptr);
+        output_ptr += num_output_pixels * output_depth;
+      }
+    }
+  }
+}
+
 // Legacy, for compatibility with old checked-in code.
 template <FusedActivationFunctionType Ac>
 void DepthwiseConv(const uint8* input_data, const Dims<4>& input_dims,
@@ -0,0 +1,404 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CONTRIB_LITE_KERNELS_INTERNAL_OPTIMIZED_MULTITHREADED_OPS_H_
+#define TENSORFLOW_CONTRIB_LITE_KERNELS_INTERNAL_OPTIMIZED_MULTITHREADED_OPS_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "public/gemmlowp.h"
+#include "tensorflow/contrib/lite/kernels/internal/common.h"
+#include "tensorflow/contrib/lite/kernels/internal/optimized/depthwiseconv_float.h"
+#include "tensorflow/contrib/lite/kernels/internal/optimized/depthwiseconv_uint8.h"
+#include "tensorflow/contrib/lite/kernels/internal/optimized/optimized_ops.h"
+#include "tensorflow/contrib/lite/kernels/internal/types.h"
+
+// Versions of the optimized ops that split their work over the threads of the
+// gemmlowp workers pool of `gemm_context`, which is shared by all the kernels
+// of an interpreter and sized by Interpreter::SetNumThreads(). Each of them
+// produces the same results as its optimized_ops counterpart, which it calls
+// on disjoint parts of the output, and runs it on the calling thread when the
+// op is too small to be worth splitting.
+
+namespace tflite {
+namespace multithreaded_ops {
+
+// Rough amount of work, in multiply-adds or elements, below which it costs
+// more to wake up another thread than to do the work on the calling thread.
+constexpr int kMinWorkPerThread = 16 * 1024;
+
+// Returns the number of threads to use for `work` units of work that can be
+// split in at most `max_shards` parts.
+inline int HowManyThreads(gemmlowp::GemmContext* gemm_context, int max_shards,
+                          int64_t work) {
+  const int max_threads =
+      gemmlowp::GetHardwareConcurrency(gemm_context->max_num_threads());
+  const int64_t threads_for_work = work / kMinWorkPerThread;
+  const int64_t thread_count = std::min<int64_t>(
+      std::min<int64_t>(max_threads, max_shards), threads_for_work);
+  return std::max<int>(1, static_cast<int>(thread_count));
+}
+
+// Wraps a call to `shard_fn` on [start, end) into a Task class to allow using
+// gemmlowp's threadpool.
+template <typename ShardFn>
+struct ShardTask : gemmlowp::Task {
+  ShardTask(const ShardFn& shard_fn, int start, int end)
+      : shard_fn_(shard_fn), start_(start), end_(end) {}
+
+  void Run() override { shard_fn_(start_, end_); }
+
+  const ShardFn& shard_fn_;
+  int start_;
+  int end_;
+};
+
+// Calls `shard_fn(start, end)` on `thread_count` contiguous shards covering
+// [0, size), one of them on the calling thread, and returns once all of them
+// are done.
+template <typename ShardFn>
+void ParallelFor(gemmlowp::GemmContext* gemm_context, int thread_count,
+                 int size, const ShardFn& shard_fn) {
+  if (thread_count <= 1) {
+    shard_fn(0, size);
+    return;
+  }
+  std::vector<gemmlowp::Task*> tasks(thread_count);
+  int start = 0;
+  for (int i = 0; i < thread_count; ++i) {
+    const int end = start + (size - start) / (thread_count - i);
+    tasks[i] = new ShardTask<ShardFn>(shard_fn, start, end);
+    start = end;
+  }
+  TFLITE_DCHECK_EQ(start, size);
+  gemm_context->workers_pool()->Execute(tasks);
+}
+
+// Dims of `rows` packed rows of `depth` elements.
+inline Dims<4> RowsDims(int depth, int rows) {
+  Dims<4> dims;
+  dims.sizes[0] = depth;
+  dims.sizes[1] = rows;
+  dims.sizes[2] = 1;
+  dims.sizes[3] = 1;
+  dims.strides[0] = 1;
+  dims.strides[1] = depth;
+  dims.strides[2] = depth * rows;
+  dims.strides[3] = depth * rows;
+  return dims;
+}
+
+// The part of the input and of the output of a pooling or a depthwise
+// convolution that computes the output batches [start, end), or the output
+// rows [start, end) of a single batch.
+struct WindowShard {
+  int input_offset;
+  int output_offset;
+  Dims<4> input_dims;
+  Dims<4> output_dims;
+  int pad_height;
+};
+
+inline WindowShard GetWindowShard(const Dims<4>& input_dims,
+                                  const Dims<4>& output_dims, int stride_height,
+                                  int pad_height, bool split_rows, int start,
+                                  int end) {
+  WindowShard shard;
+  shard.input_dims = input_dims;
+  shard.output_dims = output_dims;
+  if (!split_rows) {
+    shard.input_offset = start * input_dims.strides[3];
+    shard.output_offset = start * output_dims.strides[3];
+    shard.input_dims.sizes[3] = end - start;
+    shard.output_dims.sizes[3] = end - start;
+    shard.pad_height = pad_height;
+    return shard;
+  }
+  // The shard starts at the first input row read by its first output row, and
+  // the padding absorbs the difference, so that the kernels see the same
+  // window for each output row.
+  const int input_height = ArraySize(input_dims, 2);
+  const int in_y_origin = start * stride_height - pad_height;
+  const int in_y_start = std::max(0, std::min(in_y_origin, input_height - 1));
+  shard.input_offset = in_y_start * input_dims.strides[2];
+  shard.output_offset = start * output_dims.strides[2];
+  shard.input_dims.sizes[2] = input_height - in_y_start;
+  shard.input_dims.strides[3] =
+      shard.input_dims.sizes[2] * shard.input_dims.strides[2];
+  shard.output_dims.sizes[2] = end - start;
+  shard.output_dims.strides[3] =
+      shard.output_dims.sizes[2] * shard.output_dims.strides[2];
+  shard.pad_height = in_y_start - in_y_origin;
+  return shard;
+}
+
+// Splits a pooling or a depthwise convolution over the batches, or over the
+// output rows when there is a single batch, e.g. for MobileNet inference.
+// `run_shard` is called with each WindowShard.
+template <typename RunShardFn>
+void ParallelForWindows(gemmlowp::GemmContext* gemm_context,
+                        const Dims<4>& input_dims, const Dims<4>& output_dims,
+                        int stride_height, int pad_height,
+                        int64_t work_per_output, const RunShardFn& run_shard) {
+  const int batches = MatchingArraySize(input_dims, 3, output_dims, 3);
+  const bool split_rows = batches == 1;
+  const int size = split_rows ? ArraySize(output_dims, 2) : batches;
+  const int thread_count = HowManyThreads(
+      gemm_context, size, FlatSize(output_dims) * work_per_output);
+  ParallelFor(gemm_context, thread_count, size, [&](int start, int end) {
+    run_shard(GetWindowShard(input_dims, output_dims, stride_height,
+                             pad_height, split_rows, start, end));
+  });
+}
+
+inline void DepthwiseConv(const float* input_data, const Dims<4>& input_dims,
+                          const float* filter_data, const Dims<4>& filter_dims,
+                          const float* bias_data, const Dims<4>& bias_dims,
+                          int stride_width, int stride_height, int pad_width,
+                          int pad_height, int depth_multiplier,
+                          float output_activation_min,
+                          float output_activation_max, float* output_data,
+                          const Dims<4>& output_dims,
+                          gemmlowp::GemmContext* gemm_context) {
+  const int64_t work_per_output =
+      ArraySize(filter_dims, 1) * ArraySize(filter_dims, 2);
+  ParallelForWindows(
+      gemm_context, input_dims, output_dims, stride_height, pad_height,
+      work_per_output, [&](const WindowShard& shard) {
+        optimized_ops::DepthwiseConv(
+            input_data + shard.input_offset, shard.input_dims, filter_data,
+            filter_dims, bias_data, bias_dims, stride_width, stride_height,
+            pad_width, shard.pad_height, depth_multiplier,
+            output_activation_min, output_activation_max,
+            output_data + shard.output_offset, shard.output_dims);
+      });
+}
+
+inline void DepthwiseConv(const uint8* input_data, const Dims<4>& input_dims,
+                          int32 input_offset, const uint8* filter_data,
+                          const Dims<4>& filter_dims, int32 filter_offset,
+                          const int32* bias_data, const Dims<4>& bias_dims,
+                          int stride_width, int stride_height, int pad_width,
+                          int pad_height, int depth_multiplier,
+                          int32 output_offset, int32 output_multiplier,
+                          int output_shift, int32 output_activation_min,
+                          int32 output_activation_max, uint8* output_data,
+                          const Dims<4>& output_dims,
+                          gemmlowp::GemmContext* gemm_context) {
+  const int64_t work_per_output =
+      ArraySize(filter_dims, 1) * ArraySize(filter_dims, 2);
+  ParallelForWindows(
+      gemm_context, input_dims, output_dims, stride_height, pad_height,
+      work_per_output, [&](const WindowShard& shard) {
+        optimized_ops::DepthwiseConv(
+            input_data + shard.input_offset, shard.input_dims, input_offset,
+            filter_data, filter_dims, filter_offset, bias_data, bias_dims,
+            stride_width, stride_height, pad_width, shard.pad_height,
+            depth_multiplier, output_offset, output_multiplier, output_shift,
+            output_activation_min, output_activation_max,
+            output_data + shard.output_offset, shard.output_dims);
+      });
+}
+
+inline void DepthwiseConvPerChannel(
+    const uint8* input_data, const Dims<4>& input_dims, int32 input_offset,
+    const uint8* filter_data, const Dims<4>& filter_dims, int32 filter_offset,
+    const int32* bias_data, const Dims<4>& bias_dims, int stride_width,
+    int stride_height, int pad_width, int pad_height, int depth_multiplier,
+    int32 output_offset, const int32* output_multiplier,
+    const int* output_shift, int32 output_activation_min,
+    int32 output_activation_max, uint8* output_data,
+    const Dims<4>& output_dims, gemmlowp::GemmContext* gemm_context) {
+  const int64_t work_per_output =
+      ArraySize(filter_dims, 1) * ArraySize(filter_dims, 2);
+  ParallelForWindows(
+      gemm_context, input_dims, output_dims, stride_height, pad_height,
+      work_per_output, [&](const WindowShard& shard) {
+        optimized_ops::DepthwiseConvPerChannel(
+            input_data + shard.input_offset, shard.input_dims, input_offset,
+            filter_data, filter_dims, filter_offset, bias_data, bias_dims,
+            stride_width, stride_height, pad_width, shard.pad_height,
+            depth_multiplier, output_offset, output_multiplier, output_shift,
+            output_activation_min, output_activation_max,
+            output_data + shard.output_offset, shard.output_dims);
+      });
+}
+
+#define TFLITE_MULTITHREADED_POOL(NAME, T, ACTIVATION_T)                      \
+  inline void NAME(const T* input_data, const Dims<4>& input_dims,            \
+                   int stride_width, int stride_height, int pad_width,        \
+                   int pad_height, int filter_width, int filter_height,       \
+                   ACTIVATION_T output_activation_min,                        \
+                   ACTIVATION_T output_activation_max, T* output_data,        \
+                   const Dims<4>& output_dims,                                \
+                   gemmlowp::GemmContext* gemm_context) {                     \
+    ParallelForWindows(                                                       \
+        gemm_context, input_dims, output_dims, stride_height, pad_height,     \
+        filter_width * filter_height, [&](const WindowShard& shard) {         \
+          optimized_ops::NAME(input_data + shard.input_offset,                \
+                              shard.input_dims, stride_width, stride_height,  \
+                              pad_width, shard.pad_height, filter_width,      \
+                              filter_height, output_activation_min,           \
+                              output_activation_max,                          \
+                              output_data + shard.output_offset,              \
+                              shard.output_dims);                             \
+        });                                                                   \
+  }
+
+TFLITE_MULTITHREADED_POOL(AveragePool, float, float)
+TFLITE_MULTITHREADED_POOL(AveragePool, uint8, int32)
+TFLITE_MULTITHREADED_POOL(MaxPool, float, float)
+TFLITE_MULTITHREADED_POOL(MaxPool, uint8, int32)
+
+#undef TFLITE_MULTITHREADED_POOL
+
+// Splits over the rows of the innermost dimension.
+inline void Softmax(const float* input_data, const Dims<4>& input_dims,
+                    float beta, float* output_data, const Dims<4>& output_dims,
+                    gemmlowp::GemmContext* gemm_context) {
+  const int depth = MatchingArraySize(input_dims, 0, output_dims, 0);
+  const int rows = MatchingFlatSizeSkipDim(input_dims, 0, output_dims);
+  const int thread_count = HowManyThreads(
+      gemm_context, rows, MatchingFlatSize(input_dims, output_dims));
+  ParallelFor(gemm_context, thread_count, rows, [&](int start, int end) {
+    const Dims<4> dims = RowsDims(depth, end - start);
+    optimized_ops::Softmax(input_data + start * depth, dims, beta,
+                           output_data + start * depth, dims);
+  });
+}
+
+// Splits over the output rows of all the batches.
+inline void ResizeBilinear(const float* input_data, const Dims<4>& input_dims,
+                           const int32* output_size_data,
+                           const Dims<4>& output_size_dims, float* output_data,
+                           const Dims<4>& output_dims, bool align_corners,
+                           gemmlowp::GemmContext* gemm_context) {
+  gemmlowp::ScopedProfilingLabel label("ResizeBilinear");
+  int32 batches = MatchingArraySize(input_dims, 3, output_dims, 3);
+  int32 input_height = ArraySize(input_dims, 2);
+  int32 input_width = ArraySize(input_dims, 1);
+  int32 depth = MatchingArraySize(input_dims, 0, output_dims, 0);
+
+  TFLITE_DCHECK_EQ(ArraySize(output_size_dims, 3), 1);
+  TFLITE_DCHECK_EQ(ArraySize(output_size_dims, 2), 1);
+  TFLITE_DCHECK_EQ(ArraySize(output_size_dims, 1), 1);
+  TFLITE_DCHECK_EQ(ArraySize(output_size_dims, 0), 2);
+  int32 output_height = output_size_data[Offset(output_size_dims, 0, 0, 0, 0)];
+  int32 output_width = output_size_data[Offset(output_size_dims, 1, 0, 0, 0)];
+
+  // Each output value reads four input values.
+  const int64_t work = 4 * static_cast<int64_t>(FlatSize(output_dims));
+  // Specialize for 2x2 upsample.
+  if (!align_corners && output_height == 2 * input_height &&
+      output_width == 2 * input_width) {
+    const int rows = batches * input_height;
+    ParallelFor(gemm_context, HowManyThreads(gemm_context, rows, work), rows,
+                [&](int start, int end) {
+                  optimized_ops::ResizeBilinear2x2Rows(
+                      input_data, input_dims, output_data, output_dims, start,
+                      end, input_height, input_width, depth, output_width);
+                });
+  } else {
+    float height_scale = static_cast<float>(input_height) / output_height;
+    float width_scale = static_cast<float>(input_width) / output_width;
+    if (align_corners && output_height > 1) {
+      height_scale = static_cast<float>(input_height - 1) / (output_height - 1);
+    }
+    if (align_corners && output_width > 1) {
+      width_scale = static_cast<float>(input_width - 1) / (output_width - 1);
+    }
+
+    const int rows = batches * output_height;
+    ParallelFor(gemm_context, HowManyThreads(gemm_context, rows, work), rows,
+                [&](int start, int end) {
+                  optimized_ops::ResizeBilinearGenericRows(
+                      input_data, input_dims, output_data, output_dims, start,
+                      end, input_height, input_width, depth, output_height,
+                      output_width, height_scale, width_scale);
+                });
+  }
+}
+
+// The element-wise ops split their packed arrays in blocks of kElementwiseBlock
+// elements, so that each shard keeps the vectorized loops of the kernels busy.
+constexpr int kElementwiseBlock = 16;
+
+#define TFLITE_MULTITHREADED_ELEMENTWISE(NAME)                                 \
+  inline void NAME(const float* input1_data, const Dims<4>& input1_dims,      \
+                   const float* input2_data, const Dims<4>& input2_dims,      \
+                   float output_activation_min, float output_activation_max,  \
+                   float* output_data, const Dims<4>& output_dims,            \
+                   gemmlowp::GemmContext* gemm_context) {                     \
+    const int size = MatchingFlatSize(input1_dims, input2_dims, output_dims); \
+    const int blocks = (size + kElementwiseBlock - 1) / kElementwiseBlock;    \
+    ParallelFor(                                                              \
+        gemm_context, HowManyThreads(gemm_context, blocks, size), blocks,     \
+        [&](int start, int end) {                                             \
+          const int offset = start * kElementwiseBlock;                       \
+          const Dims<4> dims = RowsDims(                                      \
+              std::min(end * kElementwiseBlock, size) - offset, 1);           \
+          optimized_ops::NAME(input1_data + offset, dims,                     \
+                              input2_data + offset, dims,                     \
+                              output_activation_min, output_activation_max,   \
+                              output_data + offset, dims);                    \
+        });                                                                   \
+  }
+
+TFLITE_MULTITHREADED_ELEMENTWISE(Add)
+TFLITE_MULTITHREADED_ELEMENTWISE(Mul)
+
+#undef TFLITE_MULTITHREADED_ELEMENTWISE
+
+// Splits over the dimensions outer to `concat_dim`.
+template <typename Scalar>
+void Concatenation(int concat_dim, const Scalar* const* input_data,
+                   const Dims<4>* const* input_dims, int inputs_count,
+                   Scalar* output_data, const Dims<4>& output_dims,
+                   gemmlowp::GemmContext* gemm_context) {
+  TFLITE_DCHECK(IsPackedWithoutStrides(output_dims));
+  int outer_size = 1;
+  for (int i = concat_dim + 1; i < 4; i++) {
+    outer_size *= output_dims.sizes[i];
+  }
+  const int thread_count =
+      HowManyThreads(gemm_context, outer_size, FlatSize(output_dims));
+  if (thread_count == 1) {
+    optimized_ops::Concatenation<FusedActivationFunctionType::kNone, Scalar>(
+        concat_dim, input_data, input_dims, inputs_count, output_data,
+        output_dims);
+    return;
+  }
+  const int output_copy_size =
+      output_dims.sizes[concat_dim] * output_dims.strides[concat_dim];
+  ParallelFor(gemm_context, thread_count, outer_size, [&](int start, int end) {
+    Scalar* output_ptr = output_data + start * output_copy_size;
+    for (int k = start; k < end; k++) {
+      for (int i = 0; i < inputs_count; ++i) {
+        const int copy_size = input_dims[i]->sizes[concat_dim] *
+                              input_dims[i]->strides[concat_dim];
+        memcpy(output_ptr, input_data[i] + k * copy_size,
+               copy_size * sizeof(Scalar));
+        output_ptr += copy_size;
+      }
+    }
+  });
+}
+
+}  // namespace multithreaded_ops
+}  // namespace tflite
+
+#endif  // TENSORFLOW_CONTRIB_LITE_KERNELS_INTERNAL_OPTIMIZED_MULTITHREADED_OPS_H_
@@ -30,6 +30,7 @@ limitations under the License.
 #include "fixedpoint/fixedpoint.h"
 #include "public/gemmlowp.h"
 #include "tensorflow/contrib/lite/kernels/internal/common.h"
+#include "tensorflow/contrib/lite/kernels/internal/optimized/per_channel_output_stage.h"
 #include "tensorflow/contrib/lite/kernels/internal/quantization_util.h"
 #include "tensorflow/contrib/lite/kernels/internal/reference/reference_ops.h"
 #include "tensorflow/contrib/lite/kernels/internal/round.h"
@@ -1155,6 +1156,60 @@ inline void FullyConnected(const uint8* input_data, const Dims<4>& input_dims,
       input_offset, output_pipeline);
 }
 
+// The output pipeline of the per-channel kernels: gemmlowp only adds the bias
+// and leaves the int32 accumulators to PerChannelQuantizeDown().
+struct GemmlowpPerChannelOutputPipeline {
+  typedef gemmlowp::VectorMap<const int32, gemmlowp::VectorShape::Col>
+      ColVectorMap;
+  typedef std::tuple<gemmlowp::OutputStageBiasAddition<ColVectorMap>> Pipeline;
+  static Pipeline Make(const int32* bias_data, int output_rows) {
+    ColVectorMap bias_vector(bias_data, output_rows);
+    gemmlowp::OutputStageBiasAddition<ColVectorMap> bias_addition_stage;
+    bias_addition_stage.bias_vector = bias_vector;
+    return std::make_tuple(bias_addition_stage);
+  }
+};
+
+// Like the quantized FullyConnected, but with one output multiplier and shift
+// for each output channel (row of the filter). Positive shifts are right
+// shifts. `accum_scratch` holds the int32 results of the GEMM, one per output
+// value.
+inline void FullyConnectedPerChannel(
+    const uint8* input_data, const Dims<4>& input_dims, int32 input_offset,
+    const uint8* filter_data, const Dims<4>& filter_dims, int32 filter_offset,
+    const int32* bias_data, const Dims<4>& bias_dims, int32 output_offset,
+    const int32* output_multiplier, const int* output_shift,
+    int32 output_activation_min, int32 output_activation_max,
+    uint8* output_data, const Dims<4>& output_dims, int32* accum_scratch,
+    gemmlowp::GemmContext* gemm_context) {
+  gemmlowp::ScopedProfilingLabel label("FullyConnectedPerChannel/8bit");
+  const int batches = FlatSizeSkipDim(output_dims, 0);
+  const int filter_rows = filter_dims.sizes[1];
+  const int filter_cols = filter_dims.sizes[0];
+  TFLITE_DCHECK_EQ(filter_dims.sizes[2], 1);
+  TFLITE_DCHECK_EQ(filter_dims.sizes[3], 1);
+  const int output_rows = output_dims.sizes[0];
+  TFLITE_DCHECK_EQ(output_rows, filter_rows);
+  TFLITE_DCHECK_EQ(bias_dims.sizes[0], output_rows);
+
+  gemmlowp::MatrixMap<const uint8, gemmlowp::MapOrder::RowMajor> filter_matrix(
+      filter_data, output_rows, filter_cols, filter_cols);
+  gemmlowp::MatrixMap<const uint8, gemmlowp::MapOrder::ColMajor> input_matrix(
+      input_data, filter_cols, batches, filter_cols);
+  gemmlowp::MatrixMap<int32, gemmlowp::MapOrder::ColMajor> accum_matrix(
+      accum_scratch, output_rows, batches, output_rows);
+  const auto& output_pipeline =
+      GemmlowpPerChannelOutputPipeline::Make(bias_data, output_rows);
+  gemmlowp::GemmWithOutputPipeline<uint8, int32,
+                                   gemmlowp::L8R8WithLhsNonzeroBitDepthParams>(
+      gemm_context, filter_matrix, input_matrix, &accum_matrix, filter_offset,
+      input_offset, output_pipeline);
+  PerChannelQuantizeDown(accum_scratch, batches, output_rows,
+                         output_multiplier, output_shift, output_offset,
+                         output_activation_min, output_activation_max,
+                         output_data);
+}
+
 inline void FullyConnected(
     const uint8* input_data, const Dims<4>& input_dims, int32 input_offset,
     const uint8* filter_data, const Dims<4>& filter_dims, int32 filter_offset,
@@ -2064,6 +2119,80 @@ inline void Conv(const uint8* input_data, const Dims<4>& input_dims,
       input_offset, output_pipeline);
 }
 
+// Like the quantized Conv, but with one output multiplier and shift for each
+// output channel. Positive shifts are right shifts. `accum_scratch` holds the
+// int32 results of the GEMM, one per output value.
+inline void ConvPerChannel(
+    const uint8* input_data, const Dims<4>& input_dims, int32 input_offset,
+    const uint8* filter_data, const Dims<4>& filter_dims, int32 filter_offset,
+    const int32* bias_data, const Dims<4>& bias_dims, int stride_width,
+    int stride_height, int pad_width, int pad_height, int32 output_offset,
+    const int32* output_multiplier, const int* output_shift,
+    int32 output_activation_min, int32 output_activation_max,
+    uint8* output_data, const Dims<4>& output_dims, uint8* im2col_data,
+    const Dims<4>& im2col_dims, int32* accum_scratch,
+    gemmlowp::GemmContext* gemm_context) {
+  gemmlowp::ScopedProfilingLabel label("ConvPerChannel/8bit");
+
+  TFLITE_DCHECK(IsPackedWithoutStrides(input_dims));
+  TFLITE_DCHECK(IsPackedWithoutStrides(filter_dims));
+  TFLITE_DCHECK(IsPackedWithoutStrides(output_dims));
+
+  const uint8* gemm_input_data = nullptr;
+  const Dims<4>* gemm_input_dims = nullptr;
+  const int filter_width = ArraySize(filter_dims, 1);
+  const int filter_height = ArraySize(filter_dims, 2);
+  const bool need_im2col = stride_width != 1 || stride_height != 1 ||
+                           filter_width != 1 || filter_height != 1;
+  if (need_im2col) {
+    TFLITE_DCHECK(im2col_data);
+    const int input_zero_point = -input_offset;
+    TFLITE_DCHECK_GE(input_zero_point, 0);
+    TFLITE_DCHECK_LE(input_zero_point, 255);
+    Im2col(input_data, input_dims, stride_width, stride_height, pad_width,
+           pad_height, filter_height, filter_width, input_zero_point,
+           im2col_data, im2col_dims);
+    gemm_input_data = im2col_data;
+    gemm_input_dims = &im2col_dims;
+  } else {
+    TFLITE_DCHECK(!im2col_data);
+    gemm_input_data = input_data;
+    gemm_input_dims = &input_dims;
+  }
+
+  const int gemm_input_rows = gemm_input_dims->sizes[0];
+  // See b/79927784 in Conv.
+  const int gemm_input_cols = gemm_input_dims->sizes[1] *
+                              gemm_input_dims->sizes[2] *
+                              gemm_input_dims->sizes[3];
+  const int filter_rows = filter_dims.sizes[3];
+  const int filter_cols =
+      filter_dims.sizes[0] * filter_dims.sizes[1] * filter_dims.sizes[2];
+  const int output_rows = output_dims.sizes[0];
+  const int output_cols =
+      output_dims.sizes[1] * output_dims.sizes[2] * output_dims.sizes[3];
+  TFLITE_DCHECK_EQ(output_rows, filter_rows);
+  TFLITE_DCHECK_EQ(output_cols, gemm_input_cols);
+  TFLITE_DCHECK_EQ(filter_cols, gemm_input_rows);
+  TFLITE_DCHECK_EQ(bias_dims.sizes[0], output_rows);
+  gemmlowp::MatrixMap<const uint8, gemmlowp::MapOrder::RowMajor> filter_matrix(
+      filter_data, filter_rows, filter_cols);
+  gemmlowp::MatrixMap<const uint8, gemmlowp::MapOrder::ColMajor> input_matrix(
+      gemm_input_data, gemm_input_rows, gemm_input_cols);
+  gemmlowp::MatrixMap<int32, gemmlowp::MapOrder::ColMajor> accum_matrix(
+      accum_scratch, output_rows, output_cols);
+  const auto& output_pipeline =
+      GemmlowpPerChannelOutputPipeline::Make(bias_data, output_rows);
+  gemmlowp::GemmWithOutputPipeline<uint8, int32,
+                                   gemmlowp::L8R8WithLhsNonzeroBitDepthParams>(
+      gemm_context, filter_matrix, input_matrix, &accum_matrix, filter_offset,
+      input_offset, output_pipeline);
+  PerChannelQuantizeDown(accum_scratch, output_cols, output_rows,
+                         output_multiplier, output_shift, output_offset,
+                         output_activation_min, output_activation_max,
+                         output_data);
+}
+
 // legacy, for compatibility with old checked-in code
 template <FusedActivationFunctionType Ac>
 inline void Conv(const uint8* input_data, const Dims<4>& input_dims,
@@ -5626,20 +5755,85 @@ inline void ResizeBilinearKernel2x2(int32 x0, int32 x1, int32 y0, int32 y1,
 #endif
 }
 
+// Computes the pairs of output rows produced by the input rows
+// [row_start, row_end), numbered across batches, so that disjoint ranges can
+// be computed concurrently.
+inline void ResizeBilinear2x2Rows(const float* input_data,
+                                  const Dims<4>& input_dims,
+                                  float* output_data,
+                                  const Dims<4>& output_dims, int32 row_start,
+                                  int32 row_end, int32 input_height,
+                                  int32 input_width, int32 depth,
+                                  int32 output_width) {
+  for (int32 row = row_start; row < row_end; ++row) {
+    const int32 b = row / input_height;
+    const int32 y0 = row % input_height;
+    const int32 y = 2 * y0;
+    for (int x0 = 0, x = 0; x <= output_width - 2; x += 2, x0++) {
+      int32 x1 = std::min(x0 + 1, input_width - 1);
+      int32 y1 = std::min(y0 + 1, input_height - 1);
+      ResizeBilinearKernel2x2(x0, x1, y0, y1, x, y, depth, b, input_data,
+                              input_dims, output_data, output_dims);
+    }
+  }
+}
+
 inline void ResizeBilinear2x2(const float* input_data,
                               const Dims<4>& input_dims, float* output_data,
                               const Dims<4>& output_dims, int32 batches,
                               int32 input_height, int32 input_width,
                               int32 depth, int32 output_height,
                               int32 output_width) {
-  for (int b = 0; b < batches; b++) {
-    for (int y0 = 0, y = 0; y <= output_height - 2; y += 2, y0++) {
-      for (int x0 = 0, x = 0; x <= output_width - 2; x += 2, x0++) {
-        int32 x1 = std::min(x0 + 1, input_width - 1);
-        int32 y1 = std::min(y0 + 1, input_height - 1);
-        ResizeBilinearKernel2x2(x0, x1, y0, y1, x, y, depth, b, input_data,
-                                input_dims, output_data, output_dims);
-      }
+  ResizeBilinear2x2Rows(input_data, input_dims, output_data, output_dims, 0,
+                        batches * input_height, input_height, input_width,
+                        depth, output_width);
+}
+
+// Computes the output rows [row_start, row_end), numbered across batches, so
+// that disjoint ranges can be computed concurrently.
+inline void ResizeBilinearGenericRows(
+    const float* input_data, const Dims<4>& input_dims, float* output_data,
+    const Dims<4>& output_dims, int32 row_start, int32 row_end,
+    int32 input_height, int32 input_width, int32 depth, int32 output_height,
+    int32 output_width, float height_scale, float width_scale) {
+  for (int32 row = row_start; row < row_end; ++row) {
+    const int32 b = row / output_height;
+    const int32 y = row % output_height;
+    int32 output_offset = Offset(output_dims, 0, 0, y, b);
+    memset(output_data + output_offset, 0,
+           output_width * depth * sizeof(float));
+
+    float input_y = y * height_scale;
+    int32 y0 = static_cast<int32>(std::floor(input_y));
+    int32 y1 = std::min(y0 + 1, input_height - 1);
+    for (int x = 0; x < output_width; ++x) {
+      float input_x = x * width_scale;
+      int32 x0 = static_cast<int32>(input_x);
+      int32 x1 = std::min(x0 + 1, input_width - 1);
+      float* output_ptr = &output_data[output_offset];
+
+      // Run kernel on the 4 corners of the bilinear resize algorithm.
+      int32 input_offset = Offset(input_dims, 0, x0, y0, b);
+      float scale = (1 - (input_y - y0)) * (1 - (input_x - x0));
+      const float* input_ptr = &input_data[input_offset];
+      ResizeBilinearKernel(input_ptr, depth, scale, output_ptr);
+
+      input_offset = Offset(input_dims, 0, x1, y0, b);
+      scale = (1 - (input_y - y0)) * (input_x - x0);
+      input_ptr = &input_data[input_offset];
+      ResizeBilinearKernel(input_ptr, depth, scale, output_ptr);
+
+      input_offset = Offset(input_dims, 0, x0, y1, b);
+      scale = (input_y - y0) * (1 - (input_x - x0));
+      input_ptr = &input_data[input_offset];
+      ResizeBilinearKernel(input_ptr, depth, scale, output_ptr);
+
+      input_offset = Offset(input_dims, 0, x1, y1, b);
+      scale = (input_y - y0) * (input_x - x0);
+      input_ptr = &input_data[input_offset];
+      ResizeBilinearKernel(input_ptr, depth, scale, output_ptr);
+
+      output_offset += depth;
     }
   }
 }
@@ -5651,46 +5845,10 @@ inline void ResizeBilinearGeneric(const float* input_data,
                                   int32 depth, int32 output_height,
                                   int32 output_width, float height_scale,
                                   float width_scale) {
-  memset(output_data, 0,
-         batches * output_height * output_width * depth * sizeof(float));
-
-  int32 output_offset = 0;
-  for (int b = 0; b < batches; ++b) {
-    for (int y = 0; y < output_height; ++y) {
-      float input_y = y * height_scale;
-      int32 y0 = static_cast<int32>(std::floor(input_y));
-      int32 y1 = std::min(y0 + 1, input_height - 1);
-      for (int x = 0; x < output_width; ++x) {
-        float input_x = x * width_scale;
-        int32 x0 = static_cast<int32>(input_x);
-        int32 x1 = std::min(x0 + 1, input_width - 1);
-        float* output_ptr = &output_data[output_offset];
-
-        // Run kernel on the 4 corners of the bilinear resize algorithm.
-        int32 input_offset = Offset(input_dims, 0, x0, y0, b);
-        float scale = (1 - (input_y - y0)) * (1 - (input_x - x0));
-        const float* input_ptr = &input_data[input_offset];
-        ResizeBilinearKernel(input_ptr, depth, scale, output_ptr);
-
-        input_offset = Offset(input_dims, 0, x1, y0, b);
-        scale = (1 - (input_y - y0)) * (input_x - x0);
-        input_ptr = &input_data[input_offset];
-        ResizeBilinearKernel(input_ptr, depth, scale, output_ptr);
-
-        input_offset = Offset(input_dims, 0, x0, y1, b);
-        scale = (input_y - y0) * (1 - (input_x - x0));
-        input_ptr = &input_data[input_offset];
-        ResizeBilinearKernel(input_ptr, depth, scale, output_ptr);
-
-        input_offset = Offset(input_dims, 0, x1, y1, b);
-        scale = (input_y - y0) * (input_x - x0);
-        input_ptr = &input_data[input_offset];
-        ResizeBilinearKernel(input_ptr, depth, scale, output_ptr);
-
-        output_offset += depth;
-      }
-    }
-  }
+  ResizeBilinearGenericRows(input_data, input_dims, output_data, output_dims,
+                            0, batches * output_height, input_height,
+                            input_width, depth, output_height, output_width,
+                            height_scale, width_scale);
 }
 
 inline void ResizeBilinear(const float* input_data, const Dims<4>& input_dims,
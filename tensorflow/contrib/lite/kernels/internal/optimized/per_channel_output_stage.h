@@ -0,0 +1,98 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CONTRIB_LITE_KERNELS_INTERNAL_OPTIMIZED_PER_CHANNEL_OUTPUT_STAGE_H_
+#define TENSORFLOW_CONTRIB_LITE_KERNELS_INTERNAL_OPTIMIZED_PER_CHANNEL_OUTPUT_STAGE_H_
+
+#include <algorithm>
+
+#include "fixedpoint/fixedpoint.h"
+#include "public/gemmlowp.h"
+#include "tensorflow/contrib/lite/kernels/internal/common.h"
+#include "tensorflow/contrib/lite/kernels/internal/types.h"
+
+namespace tflite {
+namespace optimized_ops {
+
+// Scales the int32 accumulators of `num_pixels` pixels of `depth` channels
+// each, stored with the channels innermost, down to uint8 with one output
+// multiplier and shift per channel. This is the output stage of the kernels
+// for filters quantized per output channel, which gemmlowp's output pipelines
+// can't express. Positive shifts are right shifts, as in
+// MultiplyByQuantizedMultiplier(acc, multiplier, -shift).
+inline void PerChannelQuantizeDown(const int32* acc_data, int num_pixels,
+                                   int depth, const int32* output_multiplier,
+                                   const int* output_shift,
+                                   int32 output_offset,
+                                   int32 output_activation_min,
+                                   int32 output_activation_max,
+                                   uint8* output_data) {
+  gemmlowp::ScopedProfilingLabel label("PerChannelQuantizeDown");
+#ifdef USE_NEON
+  const int32x4_t output_offset_vec = vdupq_n_s32(output_offset);
+  const int32x4_t output_activation_min_vec =
+      vdupq_n_s32(output_activation_min);
+  const int32x4_t output_activation_max_vec =
+      vdupq_n_s32(output_activation_max);
+  const int32x4_t zero_vec = vdupq_n_s32(0);
+#endif
+  for (int p = 0; p < num_pixels; ++p) {
+    const int32* acc_ptr = acc_data + p * depth;
+    uint8* output_ptr = output_data + p * depth;
+    int c = 0;
+#ifdef USE_NEON
+    for (; c <= depth - 4; c += 4) {
+      int32x4_t acc = vld1q_s32(acc_ptr + c);
+      const int32x4_t multiplier = vld1q_s32(output_multiplier + c);
+      const int32x4_t neg_shift = vnegq_s32(
+          vld1q_s32(reinterpret_cast<const int32*>(output_shift + c)));
+      // Negative shifts are left shifts, applied before the multiplication.
+      const int32x4_t left_shift = vmaxq_s32(neg_shift, zero_vec);
+      const int32x4_t neg_right_shift = vminq_s32(neg_shift, zero_vec);
+      acc = vshlq_s32(acc, left_shift);
+      // Fixed-point multiplication.
+      acc = vqrdmulhq_s32(acc, multiplier);
+      // Rounding right shift, with the ties of the negative values rounded
+      // away from zero as in gemmlowp's RoundingDivideByPOT.
+      const int32x4_t fixup =
+          vshrq_n_s32(vandq_s32(acc, neg_right_shift), 31);
+      acc = vrshlq_s32(vqaddq_s32(acc, fixup), neg_right_shift);
+      // Add the output offset and apply the activation function.
+      acc = vaddq_s32(acc, output_offset_vec);
+      acc = vmaxq_s32(acc, output_activation_min_vec);
+      acc = vminq_s32(acc, output_activation_max_vec);
+      // Saturating cast to uint8 and store to destination.
+      const int16x4_t acc_s16 = vqmovn_s32(acc);
+      const uint8x8_t res_u8 = vqmovun_s16(vcombine_s16(acc_s16, acc_s16));
+      vst1_lane_u8(output_ptr + c + 0, res_u8, 0);
+      vst1_lane_u8(output_ptr + c + 1, res_u8, 1);
+      vst1_lane_u8(output_ptr + c + 2, res_u8, 2);
+      vst1_lane_u8(output_ptr + c + 3, res_u8, 3);
+    }
+#endif  // USE_NEON
+    for (; c < depth; ++c) {
+      int32 acc = MultiplyByQuantizedMultiplier(
+          acc_ptr[c], output_multiplier[c], -output_shift[c]);
+      acc += output_offset;
+      acc = std::max(acc, output_activation_min);
+      acc = std::min(acc, output_activation_max);
+      output_ptr[c] = static_cast<uint8>(acc);
+    }
+  }
+}
+
+}  // namespace optimized_ops
+}  // namespace tflite
+
+#endif  // TENSORFLOW_CONTRIB_LITE_KERNELS_INTERNAL_OPTIMIZED_PER_CHANNEL_OUTPUT_STAGE_H_
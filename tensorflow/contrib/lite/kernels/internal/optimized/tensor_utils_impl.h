@@ -39,6 +39,10 @@ void NeonMatrixBatchVectorMultiplyAccumulate(const float* matrix, int m_rows,
                                              int m_cols, const float* vector,
                                              int n_batch, float* result,
                                              int result_stride);
+void Avx2MatrixBatchVectorMultiplyAccumulate(const float* matrix, int m_rows,
+                                             int m_cols, const float* vector,
+                                             int n_batch, float* result,
+                                             int result_stride);
 
 // Matrix multiplication for quantized values using symmetric quantization.
 void PortableMatrixBatchVectorMultiplyAccumulate(
@@ -49,6 +53,10 @@ void NeonMatrixBatchVectorMultiplyAccumulate(
     const int8_t* __restrict__ matrix, const int m_rows, const int m_cols,
     const int8_t* __restrict__ vectors, const float* scaling_factors,
     int n_batch, float* __restrict__ result, int result_stride);
+void Avx2MatrixBatchVectorMultiplyAccumulate(
+    const int8_t* __restrict__ matrix, const int m_rows, const int m_cols,
+    const int8_t* __restrict__ vectors, const float* scaling_factors,
+    int n_batch, float* __restrict__ result, int result_stride);
 
 // Cwise product of two vectors.
 void PortableVectorVectorCwiseProduct(const float* vector1,
@@ -56,6 +64,8 @@ void PortableVectorVectorCwiseProduct(const float* vector1,
                                       float* result);
 void NeonVectorVectorCwiseProduct(const float* vector1, const float* vector2,
                                   int v_size, float* result);
+void Avx2VectorVectorCwiseProduct(const float* vector1, const float* vector2,
+                                  int v_size, float* result);
 
 // Cwise product and accumulate of two vectors. Since it's a MAC operation, the
 // assumption here is that result array is initialized to valid values.
@@ -65,12 +75,17 @@ void PortableVectorVectorCwiseProductAccumulate(const float* vector1,
 void NeonVectorVectorCwiseProductAccumulate(const float* vector1,
                                             const float* vector2, int v_size,
                                             float* result);
+void Avx2VectorVectorCwiseProductAccumulate(const float* vector1,
+                                            const float* vector2, int v_size,
+                                            float* result);
 
 // Dot product of two vectors.
 float PortableVectorVectorDotProduct(const float* vector1, const float* vector2,
                                      int v_size);
 float NeonVectorVectorDotProduct(const float* vector1, const float* vector2,
                                  int v_size);
+float Avx2VectorVectorDotProduct(const float* vector1, const float* vector2,
+                                 int v_size);
 
 // Dot product of two batch vectors.
 void PortableBatchVectorBatchVectorDotProduct(const float* vector1,
@@ -81,6 +96,10 @@ void NeonBatchVectorBatchVectorDotProduct(const float* vector1,
                                           const float* vector2, int v_size,
                                           int n_batch, float* result,
                                           int result_stride);
+void Avx2BatchVectorBatchVectorDotProduct(const float* vector1,
+                                          const float* vector2, int v_size,
+                                          int n_batch, float* result,
+                                          int result_stride);
 
 // Cwise product and accumulate of a vector and a batch-vector. Since it's a MAC
 // operation, the assumption here is that result array is initialized to valid
@@ -94,16 +113,23 @@ void NeonVectorBatchVectorCwiseProductAccumulate(const float* vector,
                                                  int v_size,
                                                  const float* batch_vector,
                                                  int n_batch, float* result);
+void Avx2VectorBatchVectorCwiseProductAccumulate(const float* vector,
+                                                 int v_size,
+                                                 const float* batch_vector,
+                                                 int n_batch, float* result);
 
 // Compute "1.0f - elements of vector" (used in CIFG).
 void PortableSub1Vector(const float* vector, int v_size, float* result);
 void NeonSub1Vector(const float* vector, int v_size, float* result);
+void Avx2Sub1Vector(const float* vector, int v_size, float* result);
 
 // Clip elements of a vector using a abs_limit value.
 void PortableClipVector(const float* vector, int v_size, float abs_limit,
                         float* result);
 void NeonClipVector(const float* vector, int v_size, float abs_limit,
                     float* result);
+void Avx2ClipVector(const float* vector, int v_size, float abs_limit,
+                    float* result);
 
 // Batch vector initialization with another vector.
 void PortableVectorBatchVectorAssign(const float* vector, int v_size,
@@ -130,6 +156,7 @@ float PortableClip(float f, float abs_limit);
 // Check if all entries of a vector are zero.
 bool PortableIsZeroVector(const float* vector, int v_size);
 bool NeonIsZeroVector(const float* vector, int v_size);
+bool Avx2IsZeroVector(const float* vector, int v_size);
 
 // Symmetric quantizer.
 void PortableSymmetricQuantizeFloats(const float* values, const int size,
@@ -138,6 +165,9 @@ void PortableSymmetricQuantizeFloats(const float* values, const int size,
 void NeonSymmetricQuantizeFloats(const float* values, const int size,
                                  int8_t* quantized_values, float* min,
                                  float* max, float* scaling_factor);
+void Avx2SymmetricQuantizeFloats(const float* values, const int size,
+                                 int8_t* quantized_values, float* min,
+                                 float* max, float* scaling_factor);
 
 // Shift left a vector in place with v_size size.
 void PortableVectorShiftLeft(float* vector, int v_size, float shift_value);
@@ -153,6 +183,8 @@ void PortableReductionSumVector(const float* input_vector, float* output_vector,
                                 int output_size, int reduction_size);
 void NeonReductionSumVector(const float* input_vector, float* output_vector,
                             int output_size, int reduction_size);
+void Avx2ReductionSumVector(const float* input_vector, float* output_vector,
+                            int output_size, int reduction_size);
 
 }  // namespace tensor_utils
 }  // namespace tflite
@@ -21,8 +21,12 @@ limitations under the License.
 #endif  //  defined(__ARM_NEON__) || defined(__ARM_NEON)
 #endif  //  USE_NEON
 
-#ifdef USE_NEON
+#include "tensorflow/contrib/lite/kernels/internal/optimized/cpu_check.h"
+
+#if defined(TFLITE_USE_AVX2_DISPATCH)
+#include "tensorflow/contrib/lite/kernels/internal/optimized/avx2_tensor_utils.h"
+#elif defined(USE_NEON)
 #include "tensorflow/contrib/lite/kernels/internal/optimized/neon_tensor_utils.h"
 #else
 #include "tensorflow/contrib/lite/kernels/internal/reference/portable_tensor_utils.h"
-#endif  // USE_NEON
+#endif  // TFLITE_USE_AVX2_DISPATCH
@@ -449,6 +449,57 @@ TEST(uKernels, MatrixBatchVectorMultiplyAccumulateSymmetricQuantizedTest) {
   aligned_free(a_int8_data);
 }
 
+// Checks the vectorized kernels on sizes that cover both their main loops and
+// their leftovers, against plain loops.
+TEST(uKernels, MatrixBatchVectorMultiplyAccumulateOddSizesTest) {
+  for (int rows = 1; rows <= 9; ++rows) {
+    for (int cols = 1; cols <= 70; cols += 3) {
+      const int batches = 2;
+      std::vector<float> matrix(rows * cols);
+      std::vector<int8_t> matrix_int8(rows * cols);
+      for (int i = 0; i < matrix.size(); ++i) {
+        matrix_int8[i] = (i * 37) % 255 - 127;
+        matrix[i] = matrix_int8[i] / 16.0f;
+      }
+      std::vector<float> vectors(cols * batches);
+      std::vector<int8_t> vectors_int8(cols * batches);
+      for (int i = 0; i < vectors.size(); ++i) {
+        vectors_int8[i] = (i * 53 + 11) % 255 - 127;
+        vectors[i] = vectors_int8[i] / 16.0f;
+      }
+      const float scaling_factors[batches] = {1.0f, 0.5f};
+
+      std::vector<float> expected(rows * batches, 1.0f);
+      std::vector<float> expected_int8(rows * batches, 1.0f);
+      for (int b = 0; b < batches; ++b) {
+        for (int r = 0; r < rows; ++r) {
+          float sum = 0.0f;
+          int32_t sum_int8 = 0;
+          for (int c = 0; c < cols; ++c) {
+            sum += matrix[r * cols + c] * vectors[b * cols + c];
+            sum_int8 += matrix_int8[r * cols + c] * vectors_int8[b * cols + c];
+          }
+          expected[b * rows + r] += sum;
+          expected_int8[b * rows + r] += sum_int8 / scaling_factors[b];
+        }
+      }
+
+      std::vector<float> output(rows * batches, 1.0f);
+      MatrixBatchVectorMultiplyAccumulate(matrix.data(), rows, cols,
+                                          vectors.data(), batches,
+                                          output.data(), /*result_stride=*/1);
+      EXPECT_THAT(output, ElementsAreArray(ArrayFloatNear(expected, 1e-3)));
+
+      std::vector<float> output_int8(rows * batches, 1.0f);
+      MatrixBatchVectorMultiplyAccumulate(
+          matrix_int8.data(), rows, cols, vectors_int8.data(), scaling_factors,
+          batches, output_int8.data(), /*result_stride=*/1);
+      EXPECT_THAT(output_int8,
+                  ElementsAreArray(ArrayFloatNear(expected_int8, 1e-3)));
+    }
+  }
+}
+
 TEST(uKernels, VectorVectorCwiseProductTest) {
   constexpr int kVectorSize = 10;
   static float input1[kVectorSize] = {0.0,  -0.5, 1.0,  -1.5, 2.0,
@@ -43,6 +43,31 @@ TfLiteStatus GetQuantizedConvolutionMultipler(TfLiteContext* context,
   return kTfLiteOk;
 }
 
+TfLiteStatus GetQuantizedConvolutionMultipliers(TfLiteContext* context,
+                                                const TfLiteTensor* input,
+                                                const TfLiteTensor* filter,
+                                                const TfLiteTensor* bias,
+                                                TfLiteTensor* output,
+                                                int num_channels,
+                                                double* multipliers) {
+  TF_LITE_ENSURE(context, filter->channel_scales == nullptr ||
+                              filter->num_channel_scales == num_channels);
+  const double output_scale = output->params.scale;
+  for (int channel = 0; channel < num_channels; ++channel) {
+    const double input_product_scale =
+        input->params.scale * GetChannelScale(filter, channel);
+    const double bias_scale = GetChannelScale(bias, channel);
+    // As above, the scale of the bias of each channel must match the one of
+    // its products.
+    TF_LITE_ENSURE(context,
+                   std::abs(input_product_scale - bias_scale) <=
+                       1e-6 * std::min(input_product_scale, bias_scale));
+    TF_LITE_ENSURE(context, input_product_scale >= 0);
+    multipliers[channel] = input_product_scale / output_scale;
+  }
+  return kTfLiteOk;
+}
+
 void CalculateActivationRangeUint8(TfLiteFusedActivation activation,
                                    TfLiteTensor* output, int32_t* act_min,
                                    int32_t* act_max) {
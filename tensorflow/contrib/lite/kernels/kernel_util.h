@@ -76,6 +76,13 @@ inline void SetTensorToDynamic(TfLiteTensor* tensor) {
   }
 }
 
+// Returns the scale of the given output channel of a tensor, which is the
+// scale of the whole tensor unless it is quantized per channel.
+inline float GetChannelScale(const TfLiteTensor* tensor, int channel) {
+  return tensor->channel_scales ? tensor->channel_scales[channel]
+                                : tensor->params.scale;
+}
+
 // Calculates the multiplication factor for a quantized convolution (or
 // quantized depthwise convolution) involving the given tensors. Returns an
 // error if the scales of the tensors are not compatible.
@@ -86,6 +93,17 @@ TfLiteStatus GetQuantizedConvolutionMultipler(TfLiteContext* context,
                                               TfLiteTensor* output,
                                               double* multiplier);
 
+// Like GetQuantizedConvolutionMultipler(), for a filter quantized with one
+// scale per output channel: fills `multipliers` with the factor of each of its
+// `num_channels` output channels.
+TfLiteStatus GetQuantizedConvolutionMultipliers(TfLiteContext* context,
+                                                const TfLiteTensor* input,
+                                                const TfLiteTensor* filter,
+                                                const TfLiteTensor* bias,
+                                                TfLiteTensor* output,
+                                                int num_channels,
+                                                double* multipliers);
+
 // Calculates the useful range of an activation layer given its activation
 // tensor.
 void CalculateActivationRangeUint8(TfLiteFusedActivation activation,
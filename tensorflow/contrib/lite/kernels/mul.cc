@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/contrib/lite/builtin_op_data.h"
 #include "tensorflow/contrib/lite/context.h"
+#include "tensorflow/contrib/lite/kernels/gemm_support.h"
+#include "tensorflow/contrib/lite/kernels/internal/optimized/multithreaded_ops.h"
 #include "tensorflow/contrib/lite/kernels/internal/optimized/optimized_ops.h"
 #include "tensorflow/contrib/lite/kernels/internal/quantization_util.h"
 #include "tensorflow/contrib/lite/kernels/internal/reference/reference_ops.h"
@@ -42,12 +44,14 @@ struct OpData {
 };
 
 void* Init(TfLiteContext* context, const char* buffer, size_t length) {
+  gemm_support::IncrementUsageCounter(context);
   auto* data = new OpData;
   data->requires_broadcast = false;
   return data;
 }
 
 void Free(TfLiteContext* context, void* buffer) {
+  gemm_support::DecrementUsageCounter(context);
   delete reinterpret_cast<OpData*>(buffer);
 }
 
@@ -100,7 +104,12 @@ void EvalFloat(TfLiteContext* context, TfLiteNode* node,
     if (data->requires_broadcast) {
       TF_LITE_MUL(optimized_ops, BroadcastMul);
     } else {
-      TF_LITE_MUL(optimized_ops, Mul);
+      multithreaded_ops::Mul(
+          GetTensorData<float>(input1), GetTensorDims(input1),
+          GetTensorData<float>(input2), GetTensorDims(input2),
+          output_activation_min, output_activation_max,
+          GetTensorData<float>(output), GetTensorDims(output),
+          gemm_support::GetFromContext(context));
     }
   }
 #undef TF_LITE_MUL
@@ -22,6 +22,8 @@ limitations under the License.
 
 #include "tensorflow/contrib/lite/builtin_op_data.h"
 #include "tensorflow/contrib/lite/context.h"
+#include "tensorflow/contrib/lite/kernels/gemm_support.h"
+#include "tensorflow/contrib/lite/kernels/internal/optimized/multithreaded_ops.h"
 #include "tensorflow/contrib/lite/kernels/internal/optimized/optimized_ops.h"
 #include "tensorflow/contrib/lite/kernels/internal/reference/reference_ops.h"
 #include "tensorflow/contrib/lite/kernels/internal/tensor.h"
@@ -54,10 +56,12 @@ void* Init(TfLiteContext* context, const char* buffer, size_t length) {
   // This is a builtin op, so we don't use the contents in 'buffer', if any.
   // Instead, we allocate a new object to carry information from Prepare() to
   // Eval().
+  gemm_support::IncrementUsageCounter(context);
   return new OpData;
 }
 
 void Free(TfLiteContext* context, void* buffer) {
+  gemm_support::DecrementUsageCounter(context);
   delete reinterpret_cast<OpData*>(buffer);
 }
 
@@ -126,18 +130,20 @@ void AverageEvalFloat(TfLiteContext* context, TfLiteNode* node,
   float activation_min, activation_max;
   CalculateActivationRangeFloat(params->activation, &activation_min,
                                 &activation_max);
-#define TF_LITE_AVERAGE_POOL(type)                                             \
-  type::AveragePool(                                                           \
-      GetTensorData<float>(input), GetTensorDims(input), params->stride_width, \
-      params->stride_height, data->padding.width, data->padding.height,        \
-      params->filter_width, params->filter_height, activation_min,             \
-      activation_max, GetTensorData<float>(output), GetTensorDims(output))
   if (kernel_type == kReference) {
-    TF_LITE_AVERAGE_POOL(reference_ops);
+    reference_ops::AveragePool(
+        GetTensorData<float>(input), GetTensorDims(input), params->stride_width,
+        params->stride_height, data->padding.width, data->padding.height,
+        params->filter_width, params->filter_height, activation_min,
+        activation_max, GetTensorData<float>(output), GetTensorDims(output));
   } else {
-    TF_LITE_AVERAGE_POOL(optimized_ops);
+    multithreaded_ops::AveragePool(
+        GetTensorData<float>(input), GetTensorDims(input), params->stride_width,
+        params->stride_height, data->padding.width, data->padding.height,
+        params->filter_width, params->filter_height, activation_min,
+        activation_max, GetTensorData<float>(output), GetTensorDims(output),
+        gemm_support::GetFromContext(context));
   }
-#undef TF_LITE_AVERAGE_POOL
 }
 
 template <KernelType kernel_type>
@@ -148,19 +154,21 @@ void AverageEvalQuantized(TfLiteContext* context, TfLiteNode* node,
   int32_t activation_max;
   CalculateActivationRangeUint8(params->activation, output, &activation_min,
                                 &activation_max);
-#define TF_LITE_AVERAGE_POOL(type)                                       \
-  type::AveragePool(GetTensorData<uint8_t>(input), GetTensorDims(input), \
-                    params->stride_width, params->stride_height,         \
-                    data->padding.width, data->padding.height,           \
-                    params->filter_width, params->filter_height,         \
-                    activation_min, activation_max,                      \
-                    GetTensorData<uint8_t>(output), GetTensorDims(output))
   if (kernel_type == kReference) {
-    TF_LITE_AVERAGE_POOL(reference_ops);
+    reference_ops::AveragePool(
+        GetTensorData<uint8_t>(input), GetTensorDims(input),
+        params->stride_width, params->stride_height, data->padding.width,
+        data->padding.height, params->filter_width, params->filter_height,
+        activation_min, activation_max, GetTensorData<uint8_t>(output),
+        GetTensorDims(output));
   } else {
-    TF_LITE_AVERAGE_POOL(optimized_ops);
+    multithreaded_ops::AveragePool(
+        GetTensorData<uint8_t>(input), GetTensorDims(input),
+        params->stride_width, params->stride_height, data->padding.width,
+        data->padding.height, params->filter_width, params->filter_height,
+        activation_min, activation_max, GetTensorData<uint8_t>(output),
+        GetTensorDims(output), gemm_support::GetFromContext(context));
   }
-#undef TF_LITE_AVERAGE_POOL
 }
 
 template <KernelType kernel_type>
@@ -170,18 +178,20 @@ void MaxEvalFloat(TfLiteContext* context, TfLiteNode* node,
   float activation_min, activation_max;
   CalculateActivationRangeFloat(params->activation, &activation_min,
                                 &activation_max);
-#define TF_LITE_MAX_POOL(type)                                                 \
-  type::MaxPool(                                                               \
-      GetTensorData<float>(input), GetTensorDims(input), params->stride_width, \
-      params->stride_height, data->padding.width, data->padding.height,        \
-      params->filter_width, params->filter_height, activation_min,             \
-      activation_max, GetTensorData<float>(output), GetTensorDims(output))
   if (kernel_type == kReference) {
-    TF_LITE_MAX_POOL(reference_ops);
+    reference_ops::MaxPool(
+        GetTensorData<float>(input), GetTensorDims(input), params->stride_width,
+        params->stride_height, data->padding.width, data->padding.height,
+        params->filter_width, params->filter_height, activation_min,
+        activation_max, GetTensorData<float>(output), GetTensorDims(output));
   } else {
-    TF_LITE_MAX_POOL(optimized_ops);
+    multithreaded_ops::MaxPool(
+        GetTensorData<float>(input), GetTensorDims(input), params->stride_width,
+        params->stride_height, data->padding.width, data->padding.height,
+        params->filter_width, params->filter_height, activation_min,
+        activation_max, GetTensorData<float>(output), GetTensorDims(output),
+        gemm_support::GetFromContext(context));
   }
-#undef TF_LITE_MAX_POOL
 }
 
 template <KernelType kernel_type>
@@ -192,19 +202,21 @@ void MaxEvalQuantized(TfLiteContext* context, TfLiteNode* node,
   int32_t activation_max;
   CalculateActivationRangeUint8(params->activation, output, &activation_min,
                                 &activation_max);
-#define TF_LITE_MAX_POOL(type)                                               \
-  type::MaxPool(GetTensorData<uint8_t>(input), GetTensorDims(input),         \
-                params->stride_width, params->stride_height,                 \
-                data->padding.width, data->padding.height,                   \
-                params->filter_width, params->filter_height, activation_min, \
-                activation_max, GetTensorData<uint8_t>(output),              \
-                GetTensorDims(output))
   if (kernel_type == kReference) {
-    TF_LITE_MAX_POOL(reference_ops);
+    reference_ops::MaxPool(
+        GetTensorData<uint8_t>(input), GetTensorDims(input),
+        params->stride_width, params->stride_height, data->padding.width,
+        data->padding.height, params->filter_width, params->filter_height,
+        activation_min, activation_max, GetTensorData<uint8_t>(output),
+        GetTensorDims(output));
   } else {
-    TF_LITE_MAX_POOL(optimized_ops);
+    multithreaded_ops::MaxPool(
+        GetTensorData<uint8_t>(input), GetTensorDims(input),
+        params->stride_width, params->stride_height, data->padding.width,
+        data->padding.height, params->filter_width, params->filter_height,
+        activation_min, activation_max, GetTensorData<uint8_t>(output),
+        GetTensorDims(output), gemm_support::GetFromContext(context));
   }
-#undef TF_LITE_MAX_POOL
 }
 
 template <KernelType kernel_type>
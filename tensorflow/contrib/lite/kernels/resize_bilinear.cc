@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/contrib/lite/builtin_op_data.h"
 #include "tensorflow/contrib/lite/context.h"
+#include "tensorflow/contrib/lite/kernels/gemm_support.h"
+#include "tensorflow/contrib/lite/kernels/internal/optimized/multithreaded_ops.h"
 #include "tensorflow/contrib/lite/kernels/internal/optimized/optimized_ops.h"
 #include "tensorflow/contrib/lite/kernels/internal/reference/reference_ops.h"
 #include "tensorflow/contrib/lite/kernels/internal/tensor.h"
@@ -36,6 +38,15 @@ constexpr int kInputTensor = 0;
 constexpr int kSizeTensor = 1;
 constexpr int kOutputTensor = 0;
 
+void* Init(TfLiteContext* context, const char* buffer, size_t length) {
+  gemm_support::IncrementUsageCounter(context);
+  return nullptr;
+}
+
+void Free(TfLiteContext* context, void* buffer) {
+  gemm_support::DecrementUsageCounter(context);
+}
+
 TfLiteStatus ResizeOutputTensor(TfLiteContext* context,
                                 const TfLiteTensor* input,
                                 const TfLiteTensor* size,
@@ -99,10 +110,14 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
     if (kernel_type == kReference) {
       TF_LITE_RESIZE_BILINEAR(reference_ops);
     }
+#undef TF_LITE_RESIZE_BILINEAR
     if (kernel_type == kGenericOptimized || kernel_type == kNeonOptimized) {
-      TF_LITE_RESIZE_BILINEAR(optimized_ops);
+      multithreaded_ops::ResizeBilinear(
+          GetTensorData<float>(input), GetTensorDims(input),
+          GetTensorData<int32>(size), GetTensorDims(size),
+          GetTensorData<float>(output), GetTensorDims(output),
+          params->align_corners, gemm_support::GetFromContext(context));
     }
-#undef TF_LITE_RESIZE_BILINEAR
   } else {
     context->ReportError(context, "Output type is %d, requires float.",
                          output->type);
@@ -116,21 +131,21 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 
 TfLiteRegistration* Register_RESIZE_BILINEAR_REF() {
   static TfLiteRegistration r = {
-      nullptr, nullptr, resize_bilinear::Prepare,
+      resize_bilinear::Init, resize_bilinear::Free, resize_bilinear::Prepare,
       resize_bilinear::Eval<resize_bilinear::kReference>};
   return &r;
 }
 
 TfLiteRegistration* Register_RESIZE_BILINEAR_GENERIC_OPT() {
   static TfLiteRegistration r = {
-      nullptr, nullptr, resize_bilinear::Prepare,
+      resize_bilinear::Init, resize_bilinear::Free, resize_bilinear::Prepare,
       resize_bilinear::Eval<resize_bilinear::kGenericOptimized>};
   return &r;
 }
 
 TfLiteRegistration* Register_RESIZE_BILINEAR_NEON_OPT() {
   static TfLiteRegistration r = {
-      nullptr, nullptr, resize_bilinear::Prepare,
+      resize_bilinear::Init, resize_bilinear::Free, resize_bilinear::Prepare,
       resize_bilinear::Eval<resize_bilinear::kNeonOptimized>};
   return &r;
 }
@@ -15,6 +15,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CONTRIB_LITE_KERNELS_TEST_UTIL_H_
 #define TENSORFLOW_CONTRIB_LITE_KERNELS_TEST_UTIL_H_
 
+#include <algorithm>
+#include <cmath>
+#include <map>
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -161,6 +164,71 @@ class SingleOpModel {
                    reinterpret_cast<uint8_t*>(q.data() + q.size()));
   }
 
+  // Like SymmetricQuantizeAndPopulate, but with one scaling factor for each
+  // slice of the tensor along `channel_dim`.
+  void PerChannelSymmetricQuantizeAndPopulate(
+      int index, std::initializer_list<float> data, int channel_dim) {
+    TfLiteTensor* t = interpreter_->tensor(index);
+    std::vector<float> values(data);
+    const int num_channels = t->dims->data[channel_dim];
+    int inner_size = 1;
+    for (int i = channel_dim + 1; i < t->dims->size; ++i) {
+      inner_size *= t->dims->data[i];
+    }
+    auto channel_of = [&](int i) { return (i / inner_size) % num_channels; };
+
+    std::vector<float>& scales = channel_scales_[index];
+    scales.assign(num_channels, 0.0f);
+    for (int i = 0; i < values.size(); ++i) {
+      scales[channel_of(i)] =
+          std::max(scales[channel_of(i)], std::abs(values[i]));
+    }
+    for (float& scale : scales) {
+      scale = scale == 0.0f ? 1.0f : 127.0f / scale;
+    }
+    std::vector<int8_t> q(values.size());
+    for (int i = 0; i < values.size(); ++i) {
+      const float quantized = std::round(values[i] * scales[channel_of(i)]);
+      q[i] = static_cast<int8_t>(
+          std::min(127.0f, std::max(-127.0f, quantized)));
+    }
+    t->params.scale = 1.0f;
+    t->params.zero_point = 0;
+    interpreter_->SetTensorChannelScales(index, scales.data(), num_channels);
+    PopulateTensor(index, /*offset=*/0, reinterpret_cast<uint8_t*>(q.data()),
+                   reinterpret_cast<uint8_t*>(q.data() + q.size()));
+  }
+
+  // Sets the scales of a tensor quantized per channel. The kernels only see
+  // them once the tensors are allocated again, which clears the arena.
+  void SetChannelScales(int index, const std::vector<float>& scales) {
+    std::vector<float>& stored_scales = channel_scales_[index];
+    stored_scales = scales;
+    interpreter_->SetTensorChannelScales(index, stored_scales.data(),
+                                         stored_scales.size());
+  }
+
+  // Like QuantizeAndPopulate, but with the scale set by SetChannelScales() for
+  // each slice of the tensor along `channel_dim`.
+  template <typename T>
+  void PerChannelQuantizeAndPopulate(int index,
+                                     std::initializer_list<float> data,
+                                     int channel_dim) {
+    TfLiteTensor* t = interpreter_->tensor(index);
+    const std::vector<float>& scales = channel_scales_.at(index);
+    std::vector<float> values(data);
+    int inner_size = 1;
+    for (int i = channel_dim + 1; i < t->dims->size; ++i) {
+      inner_size *= t->dims->data[i];
+    }
+    std::vector<T> q(values.size());
+    for (int i = 0; i < values.size(); ++i) {
+      const float scale = scales[(i / inner_size) % scales.size()];
+      q[i] = Quantize<T>({values[i]}, scale, t->params.zero_point)[0];
+    }
+    PopulateTensor(index, /*offset=*/0, q.data(), q.data() + q.size());
+  }
+
   const std::vector<int>& GetShape(int id) { return tensor_data_.at(id).shape; }
 
   float GetScale(int id) { return tensor_data_.at(id).scale; }
@@ -310,6 +378,8 @@ class SingleOpModel {
   }
 
   std::map<int, TensorData> tensor_data_;
+  // The per-channel scaling factors the tensors point to.
+  std::map<int, std::vector<float>> channel_scales_;
   std::vector<int32_t> inputs_;
   std::vector<int32_t> outputs_;
   std::vector<flatbuffers::Offset<Tensor>> tensors_;
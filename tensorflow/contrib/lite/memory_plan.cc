@@ -0,0 +1,77 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/contrib/lite/memory_plan.h"
+
+#include <cstring>
+
+namespace tflite {
+
+namespace {
+
+// The serialized plan is the identifier followed by the number of tensors and
+// the offset and size of each tensor, all as 32-bit integers in the byte
+// order of the host (little-endian, like the rest of the model).
+constexpr char kMemoryPlanIdentifier[] = "TFLMPLN1";
+constexpr size_t kIdentifierSize = sizeof(kMemoryPlanIdentifier) - 1;
+
+void AppendInt32(int32_t value, std::string* buffer) {
+  buffer->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+int32_t ReadInt32(const char* data) {
+  int32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+}  // namespace
+
+constexpr int64_t MemoryPlan::kNotPlanned;
+
+std::string SerializeMemoryPlan(const MemoryPlan& plan) {
+  std::string buffer(kMemoryPlanIdentifier, kIdentifierSize);
+  AppendInt32(plan.offsets.size(), &buffer);
+  for (size_t i = 0; i < plan.offsets.size(); ++i) {
+    AppendInt32(plan.offsets[i], &buffer);
+    AppendInt32(i < plan.sizes.size() ? plan.sizes[i] : 0, &buffer);
+  }
+  return buffer;
+}
+
+bool ParseMemoryPlan(const void* data, size_t size, MemoryPlan* plan) {
+  const char* bytes = static_cast<const char*>(data);
+  const size_t header_size = kIdentifierSize + sizeof(int32_t);
+  if (size < header_size ||
+      memcmp(bytes, kMemoryPlanIdentifier, kIdentifierSize) != 0) {
+    return false;
+  }
+  const int32_t num_tensors = ReadInt32(bytes + kIdentifierSize);
+  if (num_tensors < 0 ||
+      size != header_size + 2 * sizeof(int32_t) * num_tensors) {
+    return false;
+  }
+  plan->offsets.resize(num_tensors);
+  plan->sizes.resize(num_tensors);
+  const char* entry = bytes + header_size;
+  for (int i = 0; i < num_tensors; ++i) {
+    plan->offsets[i] = ReadInt32(entry);
+    plan->sizes[i] = ReadInt32(entry + sizeof(int32_t));
+    entry += 2 * sizeof(int32_t);
+  }
+  return true;
+}
+
+}  // namespace tflite
@@ -0,0 +1,48 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CONTRIB_LITE_MEMORY_PLAN_H_
+#define TENSORFLOW_CONTRIB_LITE_MEMORY_PLAN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tflite {
+
+// The offsets of the kTfLiteArenaRw tensors of a graph in its arena, computed
+// ahead of time by a GreedyArenaPlanner so that devices don't have to plan the
+// arena at startup. It can be stored in the metadata buffers of a model.
+struct MemoryPlan {
+  // Value of `offsets` for the tensors that are not in the arena.
+  static constexpr int64_t kNotPlanned = -1;
+
+  // The offset of each tensor in the arena, indexed by tensor index.
+  std::vector<int64_t> offsets;
+  // The size of each tensor the offsets were computed for. A planned offset
+  // is only used for a tensor of the same size.
+  std::vector<int64_t> sizes;
+};
+
+// Serializes `plan` into the contents of a model metadata buffer.
+std::string SerializeMemoryPlan(const MemoryPlan& plan);
+
+// Parses the contents of a metadata buffer. Returns false if the buffer does
+// not hold a memory plan.
+bool ParseMemoryPlan(const void* data, size_t size, MemoryPlan* plan);
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_CONTRIB_LITE_MEMORY_PLAN_H_
@@ -0,0 +1,63 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/contrib/lite/memory_plan.h"
+
+#include <gtest/gtest.h>
+#include "tensorflow/contrib/lite/testing/util.h"
+
+namespace tflite {
+namespace {
+
+TEST(MemoryPlanTest, SerializeAndParse) {
+  MemoryPlan plan;
+  plan.offsets = {0, MemoryPlan::kNotPlanned, 64, 128};
+  plan.sizes = {16, 0, 40, 4};
+  const std::string buffer = SerializeMemoryPlan(plan);
+
+  MemoryPlan parsed;
+  ASSERT_TRUE(ParseMemoryPlan(buffer.data(), buffer.size(), &parsed));
+  EXPECT_EQ(parsed.offsets, plan.offsets);
+  EXPECT_EQ(parsed.sizes, plan.sizes);
+}
+
+TEST(MemoryPlanTest, EmptyPlan) {
+  const std::string buffer = SerializeMemoryPlan(MemoryPlan());
+  MemoryPlan parsed;
+  ASSERT_TRUE(ParseMemoryPlan(buffer.data(), buffer.size(), &parsed));
+  EXPECT_TRUE(parsed.offsets.empty());
+  EXPECT_TRUE(parsed.sizes.empty());
+}
+
+TEST(MemoryPlanTest, RejectsOtherMetadata) {
+  MemoryPlan parsed;
+  const std::string other = "min_runtime_version 1.9";
+  EXPECT_FALSE(ParseMemoryPlan(other.data(), other.size(), &parsed));
+  EXPECT_FALSE(ParseMemoryPlan(other.data(), 0, &parsed));
+
+  MemoryPlan plan;
+  plan.offsets = {0, 8};
+  plan.sizes = {8, 8};
+  const std::string buffer = SerializeMemoryPlan(plan);
+  EXPECT_FALSE(ParseMemoryPlan(buffer.data(), buffer.size() - 1, &parsed));
+}
+
+}  // namespace
+}  // namespace tflite
+
+int main(int argc, char** argv) {
+  ::tflite::LogToStderr();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
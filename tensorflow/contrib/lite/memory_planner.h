@@ -38,6 +38,10 @@ class MemoryPlanner {
   // have changed. All planned allocations remain, but can't be used until
   // ExecuteAllocations() is called.
   virtual TfLiteStatus ResetAllocations() = 0;
+
+  // Returns the number of bytes reserved for the tensors of the given
+  // allocation type.
+  virtual size_t GetAllocatedBytes(TfLiteAllocationType type) const = 0;
 };
 
 }  // namespace tflite
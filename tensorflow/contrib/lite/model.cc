@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/contrib/lite/allocation.h"
 #include "tensorflow/contrib/lite/builtin_op_data.h"
 #include "tensorflow/contrib/lite/error_reporter.h"
+#include "tensorflow/contrib/lite/memory_plan.h"
 #include "tensorflow/contrib/lite/model.h"
 #include "tensorflow/contrib/lite/nnapi_delegate.h"
 #include "tensorflow/contrib/lite/version.h"
@@ -162,6 +163,8 @@ FlatBufferModel::FlatBufferModel(Allocation* allocation,
   if (!allocation_->valid() || !CheckModelIdentifier()) return;
 
   model_ = ::tflite::GetModel(allocation_->base());
+  weight_cache_.reset(
+      new WeightCache(allocation_->base(), allocation_->bytes()));
 }
 
 FlatBufferModel::~FlatBufferModel() { delete allocation_; }
@@ -171,7 +174,8 @@ InterpreterBuilder::InterpreterBuilder(const FlatBufferModel& model,
     : model_(model.GetModel()),
       op_resolver_(op_resolver),
       error_reporter_(ValidateErrorReporter(model.error_reporter())),
-      allocation_(model.allocation()) {}
+      allocation_(model.allocation()),
+      weight_cache_(model.weight_cache()) {}
 
 InterpreterBuilder::InterpreterBuilder(const ::tflite::Model* model,
                                        const OpResolver& op_resolver,
@@ -792,32 +796,45 @@ TfLiteStatus InterpreterBuilder::ParseTensors(
     TfLiteQuantizationParams quantization;
     quantization.scale = 0;
     quantization.zero_point = 0;
+    // The scales of the constant tensors quantized per channel, such as the
+    // weights of hybrid convolutions or the filters and biases of quantized
+    // ones. They point into the model.
+    const float* channel_scales = nullptr;
+    int num_channel_scales = 0;
     auto* q_params = tensor->quantization();
     if (q_params) {
       // Note that the schema could hold per-channel quantization parameters
-      // but we really only support one value for the whole tensor.
+      // but we only support them for the scales of constant tensors, which
+      // must then share a single zero point.
       // TODO(aselle): This breaks as well if these are nullptr's.
-      // TODO(aselle): This assumes non per-channel quantization.
 
       if (q_params->scale()) {
-        if (q_params->scale()->size() != 1) {
+        if (q_params->scale()->size() == 1) {
+          quantization.scale = q_params->scale()->Get(0);
+        } else if (q_params->scale()->size() > 1 && tensor->buffer() != 0) {
+          channel_scales = q_params->scale()->data();
+          num_channel_scales = q_params->scale()->size();
+        } else {
           error_reporter_->Report(
-              "QuantizationParam has %d scale values (only 1 is supported).",
-              q_params->scale()->size());
+              "QuantizationParam has %d scale values (only 1 is supported "
+              "for tensor %d).",
+              q_params->scale()->size(), i);
           return kTfLiteError;
         }
-        quantization.scale = q_params->scale()->Get(0);
       }
 
-      if (q_params->zero_point()) {
-        if (q_params->zero_point()->size() != 1) {
-          error_reporter_->Report(
-              "QuantizationParam has %d zero_point values"
-              " (only 1 is supported).",
-              q_params->zero_point()->size());
-          return kTfLiteError;
+      if (q_params->zero_point() && q_params->zero_point()->size() > 0) {
+        auto* zero_points = q_params->zero_point();
+        for (int j = 1; j < zero_points->size(); ++j) {
+          if (zero_points->Get(j) != zero_points->Get(0)) {
+            error_reporter_->Report(
+                "QuantizationParam has %d different zero_point values"
+                " (only 1 is supported).",
+                zero_points->size());
+            return kTfLiteError;
+          }
         }
-        quantization.zero_point = q_params->zero_point()->Get(0);
+        quantization.zero_point = zero_points->Get(0);
       }
     }
 
@@ -862,6 +879,10 @@ TfLiteStatus InterpreterBuilder::ParseTensors(
                                 i);
         status = kTfLiteError;
       }
+      if (channel_scales) {
+        interpreter->SetTensorChannelScales(i, channel_scales,
+                                            num_channel_scales);
+      }
     } else {
       if (interpreter->SetTensorParametersReadWrite(
               i, type, get_name(tensor), dims, quantization) != kTfLiteOk) {
@@ -933,6 +954,7 @@ TfLiteStatus InterpreterBuilder::operator()(
     return cleanup_and_error();
   }
   interpreter->reset(new Interpreter(error_reporter_));
+  (**interpreter).SetWeightCache(weight_cache_);
   if ((**interpreter).AddTensors(tensors->Length()) != kTfLiteOk) {
     return cleanup_and_error();
   }
@@ -948,6 +970,19 @@ TfLiteStatus InterpreterBuilder::operator()(
   if (ParseTensors(buffers, tensors, interpreter->get()) != kTfLiteOk)
     return cleanup_and_error();
 
+  // Place the tensors as planned offline if the model carries a memory plan.
+  if (auto* metadata_buffer = model_->metadata_buffer()) {
+    for (int buffer_index : *metadata_buffer) {
+      if (buffer_index < 0 || buffer_index >= buffers->size()) continue;
+      auto* data = (*buffers)[buffer_index]->data();
+      MemoryPlan plan;
+      if (data && ParseMemoryPlan(data->data(), data->size(), &plan)) {
+        (**interpreter).UseGreedyMemoryPlanner(&plan);
+        break;
+      }
+    }
+  }
+
   return kTfLiteOk;
 }
 
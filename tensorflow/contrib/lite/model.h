@@ -39,6 +39,7 @@ limitations under the License.
 #include "tensorflow/contrib/lite/interpreter.h"
 #include "tensorflow/contrib/lite/op_resolver.h"
 #include "tensorflow/contrib/lite/schema/schema_generated.h"
+#include "tensorflow/contrib/lite/weight_cache.h"
 
 namespace tflite {
 
@@ -105,6 +106,11 @@ class FlatBufferModel {
   ErrorReporter* error_reporter() const { return error_reporter_; }
   const Allocation* allocation() const { return allocation_; }
 
+  // Returns the cache of the weights derived from the constant tensors of the
+  // model, shared by the interpreters built from it, or nullptr if the model
+  // was built with BuildFromModel().
+  WeightCache* weight_cache() const { return weight_cache_.get(); }
+
   // Returns true if the model identifier is correct (otherwise false and
   // reports an error).
   bool CheckModelIdentifier() const;
@@ -130,6 +136,8 @@ class FlatBufferModel {
   ErrorReporter* error_reporter_;
   // The allocator used for holding memory of the model.
   Allocation* allocation_ = nullptr;
+  // The weights derived from the constant tensors in `allocation_`.
+  std::unique_ptr<WeightCache> weight_cache_;
 };
 
 // Build an interpreter capable of interpreting `model`.
@@ -179,6 +187,7 @@ class InterpreterBuilder {
   std::vector<const TfLiteRegistration*> flatbuffer_op_index_to_registration_;
   std::vector<BuiltinOperator> flatbuffer_op_index_to_registration_types_;
   const Allocation* allocation_ = nullptr;
+  WeightCache* weight_cache_ = nullptr;
 };
 
 }  // namespace tflite
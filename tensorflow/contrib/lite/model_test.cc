@@ -194,6 +194,37 @@ TEST(BasicFlatBufferModel, TestModelInInterpreter) {
   }
 }
 
+// Interpreters built from the same model share its constant tensors and the
+// weights derived from them.
+TEST(BasicFlatBufferModel, TestSharedWeights) {
+  auto model = FlatBufferModel::BuildFromFile(
+      "tensorflow/contrib/lite/testdata/test_model.bin");
+  ASSERT_TRUE(model);
+  ASSERT_NE(model->weight_cache(), nullptr);
+  std::unique_ptr<Interpreter> interpreter1;
+  std::unique_ptr<Interpreter> interpreter2;
+  ASSERT_EQ(
+      InterpreterBuilder(*model, TrivialResolver(&dummy_reg))(&interpreter1),
+      kTfLiteOk);
+  ASSERT_EQ(
+      InterpreterBuilder(*model, TrivialResolver(&dummy_reg))(&interpreter2),
+      kTfLiteOk);
+  const TfLiteTensor* weights1 = interpreter1->tensor(0);
+  const TfLiteTensor* weights2 = interpreter2->tensor(0);
+  ASSERT_EQ(weights1->allocation_type, kTfLiteMmapRo);
+  EXPECT_EQ(weights1->data.raw, weights2->data.raw);
+
+  int num_fills = 0;
+  auto fill = [&num_fills](void* buffer) { ++num_fills; };
+  const void* derived1 = model->weight_cache()->GetOrCreate(
+      weights1->data.raw, weights1->bytes, "test", weights1->bytes, fill);
+  const void* derived2 = model->weight_cache()->GetOrCreate(
+      weights2->data.raw, weights2->bytes, "test", weights2->bytes, fill);
+  ASSERT_NE(derived1, nullptr);
+  EXPECT_EQ(derived1, derived2);
+  EXPECT_EQ(num_fills, 1);
+}
+
 // This tests on a flatbuffer that defines a shape of 2 to be a memory mapped
 // buffer. But the buffer is provided to be only 1 element.
 TEST(BasicFlatBufferModel, TestBrokenMmap) {
@@ -293,6 +324,7 @@ TEST(BasicFlatBufferModel, TestBuildFromModel) {
 
   auto model = FlatBufferModel::BuildFromModel(model_fb);
   ASSERT_TRUE(model);
+  EXPECT_EQ(model->weight_cache(), nullptr);
 
   std::unique_ptr<Interpreter> interpreter;
   ASSERT_EQ(
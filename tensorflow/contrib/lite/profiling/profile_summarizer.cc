@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/contrib/lite/profiling/profile_summarizer.h"
 
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 
 #include "tensorflow/contrib/lite/schema/schema_generated.h"
@@ -84,6 +86,40 @@ OperatorDetails GetOperatorDetails(const tflite::Interpreter& interpreter,
   return details;
 }
 
+// Returns the nearest-rank percentile of sorted samples.
+int64_t Percentile(const std::vector<int64_t>& sorted_samples, int percentile) {
+  const size_t rank = static_cast<size_t>(
+      std::ceil(percentile / 100.0 * sorted_samples.size()));
+  return sorted_samples[std::max<size_t>(rank, 1) - 1];
+}
+
+ProfileSummarizer::TimingStats ComputeTimingStats(
+    const string& name, const string& type, std::vector<int64_t> samples) {
+  ProfileSummarizer::TimingStats stats;
+  stats.name = name;
+  stats.type = type;
+  if (samples.empty()) {
+    return stats;
+  }
+  std::sort(samples.begin(), samples.end());
+  double sum = 0;
+  double squared_sum = 0;
+  for (int64_t sample : samples) {
+    sum += sample;
+    squared_sum += static_cast<double>(sample) * sample;
+  }
+  stats.count = samples.size();
+  stats.mean_us = sum / stats.count;
+  stats.std_us = std::sqrt(
+      std::max(squared_sum / stats.count - stats.mean_us * stats.mean_us, 0.0));
+  stats.min_us = samples.front();
+  stats.p50_us = Percentile(samples, 50);
+  stats.p90_us = Percentile(samples, 90);
+  stats.p99_us = Percentile(samples, 99);
+  stats.max_us = samples.back();
+  return stats;
+}
+
 }  // namespace
 
 ProfileSummarizer::ProfileSummarizer()
@@ -113,6 +149,7 @@ void ProfileSummarizer::ProcessProfiles(
   int node_num = 0;
   int64_t curr_total_us = 0;
   std::map<std::string, Detail> details;
+  std::map<std::string, int64_t> op_type_totals_us;
   for (auto event : events) {
     auto op_details = GetOperatorDetails(interpreter, event->event_metadata);
     auto node_name = ToString(op_details.outputs);
@@ -124,6 +161,14 @@ void ProfileSummarizer::ProcessProfiles(
     detail->rel_end_us.UpdateStat(node_exec_time);
     curr_total_us += node_exec_time;
     ++node_num;
+    op_type_totals_us[op_details.name] += node_exec_time;
+
+    NodeSamples* samples = &node_samples_[node_name];
+    if (samples->times_us.empty()) {
+      samples->type = op_details.name;
+      samples->run_order = node_num;
+    }
+    samples->times_us.push_back(node_exec_time);
 
     if (result.second) {
       detail->name = node_name;
@@ -135,6 +180,45 @@ void ProfileSummarizer::ProcessProfiles(
   }
   stats_calculator_->UpdateDetails(details);
   stats_calculator_->UpdateRunTotalUs(curr_total_us);
+  for (const auto& op_type_total : op_type_totals_us) {
+    op_type_samples_[op_type_total.first].push_back(op_type_total.second);
+  }
 }
+
+std::vector<ProfileSummarizer::TimingStats> ProfileSummarizer::GetNodeTimings()
+    const {
+  std::vector<const std::pair<const std::string, NodeSamples>*> nodes;
+  for (const auto& node : node_samples_) {
+    nodes.push_back(&node);
+  }
+  std::sort(nodes.begin(), nodes.end(),
+            [](const std::pair<const std::string, NodeSamples>* a,
+               const std::pair<const std::string, NodeSamples>* b) {
+              return a->second.run_order < b->second.run_order;
+            });
+  std::vector<TimingStats> timings;
+  timings.reserve(nodes.size());
+  for (const auto* node : nodes) {
+    timings.push_back(ComputeTimingStats(node->first, node->second.type,
+                                         node->second.times_us));
+  }
+  return timings;
+}
+
+std::vector<ProfileSummarizer::TimingStats>
+ProfileSummarizer::GetOpTypeTimings() const {
+  std::vector<TimingStats> timings;
+  timings.reserve(op_type_samples_.size());
+  for (const auto& op_type : op_type_samples_) {
+    timings.push_back(
+        ComputeTimingStats(op_type.first, op_type.first, op_type.second));
+  }
+  std::sort(timings.begin(), timings.end(),
+            [](const TimingStats& a, const TimingStats& b) {
+              return a.mean_us > b.mean_us;
+            });
+  return timings;
+}
+
 }  // namespace profiling
 }  // namespace tflite
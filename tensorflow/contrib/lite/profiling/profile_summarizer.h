@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_CONTRIB_LITE_PROFILING_PROFILE_SUMMARIZER_H_
 #define TENSORFLOW_CONTRIB_LITE_PROFILING_PROFILE_SUMMARIZER_H_
 
+#include <map>
+#include <string>
 #include <vector>
 
 #include "tensorflow/contrib/lite/interpreter.h"
@@ -48,8 +50,42 @@ class ProfileSummarizer {
   // Prints the string returned by GetOutputString().
   void PrintStepStats() const { stats_calculator_->PrintStepStats(); }
 
+  // Returns the number of runs processed so far.
+  int num_runs() const { return stats_calculator_->num_runs(); }
+
+  // Distribution of the time spent, in microseconds, by a node in each of its
+  // invocations, or by all the nodes of an op type in each run.
+  struct TimingStats {
+    std::string name;
+    std::string type;
+    int64_t count = 0;
+    double mean_us = 0;
+    double std_us = 0;
+    int64_t min_us = 0;
+    int64_t p50_us = 0;
+    int64_t p90_us = 0;
+    int64_t p99_us = 0;
+    int64_t max_us = 0;
+  };
+
+  // Returns the timings of each node, in execution order.
+  std::vector<TimingStats> GetNodeTimings() const;
+
+  // Returns the timings of each op type, by decreasing mean time per run.
+  std::vector<TimingStats> GetOpTypeTimings() const;
+
  private:
+  struct NodeSamples {
+    std::string type;
+    int64_t run_order;
+    std::vector<int64_t> times_us;
+  };
+
   std::unique_ptr<tensorflow::StatsCalculator> stats_calculator_;
+  // Keyed by node name; all the samples are kept to compute the percentiles.
+  std::map<std::string, NodeSamples> node_samples_;
+  // Total time spent in the nodes of each op type, one sample per run.
+  std::map<std::string, std::vector<int64_t>> op_type_samples_;
 };
 
 }  // namespace profiling
@@ -82,6 +82,41 @@ TEST(ProfileSummarizerTest, Empty) {
   EXPECT_GT(output.size(), 0);
 }
 
+TEST(ProfileSummarizerTest, NodeAndOpTypeTimings) {
+  SimpleOpModel m;
+  m.Init();
+  ProfileSummarizer summarizer;
+  // Runs taking 1us, 2us, ..., 100us.
+  for (int run = 1; run <= 100; ++run) {
+    ProfileEvent event;
+    event.tag = "SimpleOpEval";
+    event.begin_timestamp_us = 1000 * run;
+    event.end_timestamp_us = 1000 * run + run;
+    event.event_type = ProfileEvent::EventType::OPERATOR_INVOKE_EVENT;
+    event.event_metadata = 0;
+    summarizer.ProcessProfiles({&event}, *m.GetInterpreter());
+  }
+  EXPECT_EQ(summarizer.num_runs(), 100);
+
+  auto node_timings = summarizer.GetNodeTimings();
+  ASSERT_EQ(node_timings.size(), 1);
+  EXPECT_EQ(node_timings[0].type, "SimpleOpEval");
+  EXPECT_EQ(node_timings[0].count, 100);
+  EXPECT_DOUBLE_EQ(node_timings[0].mean_us, 50.5);
+  EXPECT_NEAR(node_timings[0].std_us, 28.866, 1e-3);
+  EXPECT_EQ(node_timings[0].min_us, 1);
+  EXPECT_EQ(node_timings[0].p50_us, 50);
+  EXPECT_EQ(node_timings[0].p90_us, 90);
+  EXPECT_EQ(node_timings[0].p99_us, 99);
+  EXPECT_EQ(node_timings[0].max_us, 100);
+
+  auto op_type_timings = summarizer.GetOpTypeTimings();
+  ASSERT_EQ(op_type_timings.size(), 1);
+  EXPECT_EQ(op_type_timings[0].name, "SimpleOpEval");
+  EXPECT_EQ(op_type_timings[0].count, 100);
+  EXPECT_EQ(op_type_timings[0].p90_us, 90);
+}
+
 #ifdef TFLITE_PROFILING_ENABLED
 TEST(ProfileSummarizerTest, Interpreter) {
   Profiler profiler;
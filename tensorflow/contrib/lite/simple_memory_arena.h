@@ -72,6 +72,9 @@ class SimpleMemoryArena {
     return reinterpret_cast<int64_t>(underlying_buffer_aligned_ptr_);
   }
 
+  // Returns the size of the buffer reserved by the last Commit().
+  size_t BufferSize() const { return underlying_buffer_size_; }
+
  private:
   bool committed_;
   size_t arena_alignment_;
@@ -0,0 +1,172 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "tensorflow/contrib/lite/toco/graph_transformations/graph_transformations.h"
+#include "tensorflow/contrib/lite/toco/model.h"
+#include "tensorflow/contrib/lite/toco/tooling_util.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace toco {
+
+namespace {
+
+// Returns the padding that SAME padding adds before the input in one
+// dimension, as computed by PropagateFixedSizes, and sets "output_size" to
+// the resulting output size.
+int SamePaddingBefore(int input_size, int dilated_kernel_size, int stride,
+                      int* output_size) {
+  *output_size = (input_size + stride - 1) / stride;
+  return std::max(
+      0, ((*output_size - 1) * stride + dilated_kernel_size - input_size) / 2);
+}
+
+// Returns whether a VALID convolution of the input padded with
+// "padding_before" and "padding_after" reads the same windows as a SAME
+// convolution of the input. The windows start at the same offset if the
+// padding before the input is the one SAME padding adds, and there are as
+// many of them if the output sizes match: any padding after the input
+// beyond the last window is never read.
+bool PaddingIsSame(int input_size, int padding_before, int padding_after,
+                   int dilated_kernel_size, int stride,
+                   int* same_padding_before) {
+  int same_output_size;
+  *same_padding_before = SamePaddingBefore(input_size, dilated_kernel_size,
+                                           stride, &same_output_size);
+  const int padded_size = input_size + padding_before + padding_after;
+  if (padded_size < dilated_kernel_size) return false;
+  const int valid_output_size =
+      (padded_size + stride - dilated_kernel_size) / stride;
+  return padding_before == *same_padding_before &&
+         valid_output_size == same_output_size;
+}
+
+}  // namespace
+
+// Models exported from frameworks which do not use TensorFlow's SAME padding
+// pad the input of convolutions explicitly:
+//
+//     Pad -> Conv (VALID)
+//
+// When the explicit padding amounts to the one SAME padding adds, the Pad op
+// is only a copy of the input. This transformation removes it and makes the
+// convolution pad instead.
+//
+// Pooling ops are not handled: their SAME padding is not equivalent to
+// padding with zeros.
+bool FusePadIntoFollowingConv::Run(Model* model, std::size_t op_index) {
+  const auto pad_it = model->operators.begin() + op_index;
+  auto* pad_op = static_cast<PadOperator*>(pad_it->get());
+  if (pad_op->type != OperatorType::kPad) {
+    return false;
+  }
+  // Yield until the paddings have been resolved.
+  if (pad_op->left_padding.size() != 4) {
+    return false;
+  }
+  // Only the height and width can be padded by the convolution.
+  if (pad_op->left_padding[0] != 0 || pad_op->right_padding[0] != 0 ||
+      pad_op->left_padding[3] != 0 || pad_op->right_padding[3] != 0) {
+    return false;
+  }
+  const string& padded_name = pad_op->outputs[0];
+  if (!IsDiscardableArray(*model, padded_name) ||
+      CountOpsWithInput(*model, padded_name) != 1) {
+    return false;
+  }
+
+  Operator* conv_op = GetOpWithInput(*model, padded_name);
+  if (conv_op == nullptr || conv_op->inputs[0] != padded_name) {
+    return false;
+  }
+  Padding* padding = nullptr;
+  int stride_height = 0;
+  int stride_width = 0;
+  int dilation_height_factor = 1;
+  int dilation_width_factor = 1;
+  if (conv_op->type == OperatorType::kConv) {
+    auto* conv = static_cast<ConvOperator*>(conv_op);
+    padding = &conv->padding;
+    stride_height = conv->stride_height;
+    stride_width = conv->stride_width;
+    dilation_height_factor = conv->dilation_height_factor;
+    dilation_width_factor = conv->dilation_width_factor;
+  } else if (conv_op->type == OperatorType::kDepthwiseConv) {
+    auto* conv = static_cast<DepthwiseConvOperator*>(conv_op);
+    padding = &conv->padding;
+    stride_height = conv->stride_height;
+    stride_width = conv->stride_width;
+  } else {
+    return false;
+  }
+  if (padding->type != PaddingType::kValid) {
+    return false;
+  }
+
+  // Yield until the shapes have been resolved.
+  const auto& input_array = model->GetArray(pad_op->inputs[0]);
+  const auto& weights_array = model->GetArray(conv_op->inputs[1]);
+  if (!input_array.has_shape() || !weights_array.has_shape()) {
+    return false;
+  }
+  const Shape& input_shape = input_array.shape();
+  const Shape& weights_shape = weights_array.shape();
+  if (input_shape.dimensions_count() != 4 ||
+      weights_shape.dimensions_count() != 4) {
+    return false;
+  }
+  // The weights of both Conv and DepthwiseConv have their height and width
+  // as dimensions 1 and 2.
+  const int dilated_kheight =
+      dilation_height_factor * (weights_shape.dims(1) - 1) + 1;
+  const int dilated_kwidth =
+      dilation_width_factor * (weights_shape.dims(2) - 1) + 1;
+
+  int padding_height;
+  int padding_width;
+  if (!PaddingIsSame(input_shape.dims(1), pad_op->left_padding[1],
+                     pad_op->right_padding[1], dilated_kheight, stride_height,
+                     &padding_height) ||
+      !PaddingIsSame(input_shape.dims(2), pad_op->left_padding[2],
+                     pad_op->right_padding[2], dilated_kwidth, stride_width,
+                     &padding_width)) {
+    AddMessageF(
+        "Not fusing %s into the following %s because its padding is not the "
+        "one of SAME padding",
+        LogName(*pad_op), LogName(*conv_op));
+    return false;
+  }
+
+  AddMessageF("Fusing %s into the following %s", LogName(*pad_op),
+              LogName(*conv_op));
+
+  padding->type = PaddingType::kSame;
+  FixedPadding& fixed_padding = padding->GetOrCreateFixedPadding();
+  fixed_padding.height = padding_height;
+  fixed_padding.width = padding_width;
+  conv_op->inputs[0] = pad_op->inputs[0];
+
+  // Order is important. Delete the output array first, then the op, then its
+  // redundant inputs.
+  model->EraseArray(padded_name);
+  const string paddings_name = pad_op->inputs[1];
+  model->operators.erase(pad_it);
+  DeleteArrayIfUnused(paddings_name, model);
+  return true;
+}
+
+}  // namespace toco
@@ -0,0 +1,121 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/contrib/lite/toco/graph_transformations/graph_transformations.h"
+#include "tensorflow/contrib/lite/toco/model.h"
+#include "tensorflow/contrib/lite/toco/tooling_util.h"
+
+namespace toco {
+
+class FusePadIntoFollowingConvTest : public ::testing::Test {
+ protected:
+  // Prepares a model computing a VALID 3x3 convolution with the given stride
+  // of a 1x8x8x2 input padded by "pad_before" and "pad_after" in height and
+  // width.
+  void PrepareModel(Model* model, int pad_before, int pad_after, int stride) {
+    Array& input = model->GetOrCreateArray("input");
+    input.data_type = ArrayDataType::kFloat;
+    *input.mutable_shape()->mutable_dims() = {1, 8, 8, 2};
+
+    Array& paddings = model->GetOrCreateArray("paddings");
+    paddings.data_type = ArrayDataType::kInt32;
+    *paddings.mutable_shape()->mutable_dims() = {4, 2};
+    paddings.GetMutableBuffer<ArrayDataType::kInt32>().data = {
+        0, 0, pad_before, pad_after, pad_before, pad_after, 0, 0};
+
+    Array& weights = model->GetOrCreateArray("weights");
+    weights.data_type = ArrayDataType::kFloat;
+    *weights.mutable_shape()->mutable_dims() = {4, 3, 3, 2};
+    weights.GetMutableBuffer<ArrayDataType::kFloat>().data.resize(4 * 3 * 3 *
+                                                                  2);
+
+    model->GetOrCreateArray("padded").data_type = ArrayDataType::kFloat;
+    model->GetOrCreateArray("output").data_type = ArrayDataType::kFloat;
+    model->flags.add_output_arrays("output");
+
+    auto* pad_op = new PadOperator;
+    pad_op->inputs = {"input", "paddings"};
+    pad_op->outputs = {"padded"};
+    pad_op->left_padding = {0, pad_before, pad_before, 0};
+    pad_op->right_padding = {0, pad_after, pad_after, 0};
+    model->operators.push_back(std::unique_ptr<Operator>(pad_op));
+
+    auto* conv_op = new ConvOperator;
+    conv_op->inputs = {"padded", "weights"};
+    conv_op->outputs = {"output"};
+    conv_op->padding.type = PaddingType::kValid;
+    conv_op->stride_height = stride;
+    conv_op->stride_width = stride;
+    model->operators.push_back(std::unique_ptr<Operator>(conv_op));
+  }
+};
+
+TEST_F(FusePadIntoFollowingConvTest, FusesSamePadding) {
+  Model model;
+  PrepareModel(&model, /*pad_before=*/1, /*pad_after=*/1, /*stride=*/1);
+
+  FusePadIntoFollowingConv transformation;
+  EXPECT_TRUE(transformation.Run(&model, /*op_index=*/0));
+  ASSERT_EQ(model.operators.size(), 1);
+  const auto& conv_op = static_cast<const ConvOperator&>(*model.operators[0]);
+  EXPECT_EQ(conv_op.inputs[0], "input");
+  EXPECT_EQ(conv_op.padding.type, PaddingType::kSame);
+  ASSERT_NE(conv_op.padding.fixed, nullptr);
+  EXPECT_EQ(conv_op.padding.fixed->height, 1);
+  EXPECT_EQ(conv_op.padding.fixed->width, 1);
+  EXPECT_FALSE(model.HasArray("padded"));
+  EXPECT_FALSE(model.HasArray("paddings"));
+}
+
+TEST_F(FusePadIntoFollowingConvTest, FusesStridedSamePadding) {
+  // SAME padding of a 3x3 convolution with stride 2 of an even size pads
+  // only after the input.
+  Model model;
+  PrepareModel(&model, /*pad_before=*/0, /*pad_after=*/1, /*stride=*/2);
+
+  FusePadIntoFollowingConv transformation;
+  EXPECT_TRUE(transformation.Run(&model, /*op_index=*/0));
+  ASSERT_EQ(model.operators.size(), 1);
+  const auto& conv_op = static_cast<const ConvOperator&>(*model.operators[0]);
+  EXPECT_EQ(conv_op.padding.type, PaddingType::kSame);
+  EXPECT_EQ(conv_op.padding.fixed->height, 0);
+  EXPECT_EQ(conv_op.padding.fixed->width, 0);
+}
+
+TEST_F(FusePadIntoFollowingConvTest, KeepsOtherPadding) {
+  Model model;
+  PrepareModel(&model, /*pad_before=*/2, /*pad_after=*/2, /*stride=*/1);
+
+  FusePadIntoFollowingConv transformation;
+  EXPECT_FALSE(transformation.Run(&model, /*op_index=*/0));
+  EXPECT_EQ(model.operators.size(), 2);
+  EXPECT_EQ(model.operators[1]->inputs[0], "padded");
+}
+
+TEST_F(FusePadIntoFollowingConvTest, KeepsPaddedModelOutput) {
+  Model model;
+  PrepareModel(&model, /*pad_before=*/1, /*pad_after=*/1, /*stride=*/1);
+  model.flags.add_output_arrays("padded");
+
+  FusePadIntoFollowingConv transformation;
+  EXPECT_FALSE(transformation.Run(&model, /*op_index=*/0));
+  EXPECT_EQ(model.operators.size(), 2);
+}
+
+}  // namespace toco
@@ -16,13 +16,18 @@ limitations under the License.
 #include "tensorflow/contrib/lite/tools/benchmark_tflite_model.h"
 
 #include <cstdarg>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <unordered_set>
 #include <vector>
 
+#include "tensorflow/contrib/lite/delegates/sycl/sycl_delegate.h"
 #include "tensorflow/contrib/lite/kernels/register.h"
 #include "tensorflow/contrib/lite/model.h"
 #include "tensorflow/contrib/lite/op_resolver.h"
@@ -36,30 +41,269 @@ void RegisterSelectedOps(::tflite::MutableOpResolver* resolver);
 namespace tflite {
 namespace benchmark {
 
+namespace {
+
+using TimingStats = profiling::ProfileSummarizer::TimingStats;
+
+// A subgraph claimed by a delegate, which runs as a single node.
+struct DelegatePartition {
+  std::string name;
+  int node_index;
+  int num_nodes;
+  int num_input_tensors;
+  int num_output_tensors;
+};
+
+std::vector<DelegatePartition> GetDelegatePartitions(
+    const Interpreter& interpreter) {
+  std::vector<DelegatePartition> partitions;
+  for (int node_index : interpreter.execution_plan()) {
+    const auto* node_and_reg = interpreter.node_and_registration(node_index);
+    const TfLiteNode& node = node_and_reg->first;
+    if (node.delegate == nullptr) {
+      continue;
+    }
+    const auto* params =
+        reinterpret_cast<const TfLiteDelegateParams*>(node.builtin_data);
+    const char* custom_name = node_and_reg->second.custom_name;
+    DelegatePartition partition;
+    partition.name = custom_name ? custom_name : "UnknownDelegate";
+    partition.node_index = node_index;
+    partition.num_nodes = params->nodes_to_replace->size;
+    partition.num_input_tensors = params->input_tensors->size;
+    partition.num_output_tensors = params->output_tensors->size;
+    partitions.push_back(partition);
+  }
+  return partitions;
+}
+
+std::string GetMemorySummary(const Interpreter& interpreter) {
+  std::stringstream stream;
+  stream << "Arena sizes: read-write "
+         << interpreter.GetArenaBytes(kTfLiteArenaRw) << " bytes, persistent "
+         << interpreter.GetArenaBytes(kTfLiteArenaRwPersistent) << " bytes";
+  return stream.str();
+}
+
+std::string GetDelegateSummary(const Interpreter& interpreter) {
+  const std::vector<DelegatePartition> partitions =
+      GetDelegatePartitions(interpreter);
+  int num_delegated_nodes = 0;
+  for (const DelegatePartition& partition : partitions) {
+    num_delegated_nodes += partition.num_nodes;
+  }
+  const int num_cpu_nodes =
+      interpreter.execution_plan().size() - partitions.size();
+  std::stringstream stream;
+  stream << "Delegated " << num_delegated_nodes << " of "
+         << num_delegated_nodes + num_cpu_nodes << " nodes in "
+         << partitions.size() << " partitions";
+  for (const DelegatePartition& partition : partitions) {
+    stream << "\n  " << partition.name << " node " << partition.node_index
+           << ": " << partition.num_nodes << " nodes, "
+           << partition.num_input_tensors << " inputs, "
+           << partition.num_output_tensors << " outputs";
+  }
+  return stream.str();
+}
+
+std::string GetTimingsString(const std::string& title,
+                             const std::vector<TimingStats>& timings) {
+  std::stringstream stream;
+  stream << "============================== " << title
+         << " ==============================\n";
+  stream << std::setw(24) << "[type]" << std::setw(10) << "[count]"
+         << std::setw(12) << "[mean us]" << std::setw(12) << "[std us]"
+         << std::setw(10) << "[p50 us]" << std::setw(10) << "[p90 us]"
+         << std::setw(10) << "[p99 us]"
+         << "\t[name]\n";
+  for (const TimingStats& stats : timings) {
+    stream << std::setw(24) << stats.type << std::setw(10) << stats.count
+           << std::fixed << std::setprecision(1) << std::setw(12)
+           << stats.mean_us << std::setw(12) << stats.std_us << std::setw(10)
+           << stats.p50_us << std::setw(10) << stats.p90_us << std::setw(10)
+           << stats.p99_us << "\t" << stats.name << "\n";
+  }
+  return stream.str();
+}
+
+std::string CsvString(const std::string& str) {
+  std::string quoted = "\"";
+  for (char c : str) {
+    if (c == '"') {
+      quoted += '"';
+    }
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+std::string JsonString(const std::string& str) {
+  std::string quoted = "\"";
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+      quoted += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      quoted += escaped;
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + "\"";
+}
+
+void WriteCsvTimings(const std::string& phase, const std::string& kind,
+                     const std::vector<TimingStats>& timings,
+                     std::ostream* stream) {
+  for (const TimingStats& stats : timings) {
+    *stream << phase << "," << kind << "," << CsvString(stats.name) << ","
+            << CsvString(stats.type) << "," << stats.count << ","
+            << stats.mean_us << "," << stats.std_us << "," << stats.min_us
+            << "," << stats.p50_us << "," << stats.p90_us << ","
+            << stats.p99_us << "," << stats.max_us << "\n";
+  }
+}
+
+void WriteJsonTimings(const std::vector<TimingStats>& timings,
+                      std::ostream* stream) {
+  *stream << "[";
+  for (int i = 0; i < timings.size(); ++i) {
+    const TimingStats& stats = timings[i];
+    *stream << (i == 0 ? "" : ",") << "\n      {\"name\": "
+            << JsonString(stats.name) << ", \"type\": "
+            << JsonString(stats.type) << ", \"count\": " << stats.count
+            << ", \"mean_us\": " << stats.mean_us
+            << ", \"std_us\": " << stats.std_us
+            << ", \"min_us\": " << stats.min_us
+            << ", \"p50_us\": " << stats.p50_us
+            << ", \"p90_us\": " << stats.p90_us
+            << ", \"p99_us\": " << stats.p99_us
+            << ", \"max_us\": " << stats.max_us << "}";
+  }
+  *stream << (timings.empty() ? "]" : "\n    ]");
+}
+
+void WriteJsonPhase(const tensorflow::Stat<int64_t>& run_time_us,
+                    const profiling::ProfileSummarizer& summarizer,
+                    std::ostream* stream) {
+  *stream << "{\n    \"runs\": {\"count\": " << run_time_us.count()
+          << ", \"mean_us\": " << (run_time_us.empty() ? 0 : run_time_us.avg())
+          << ", \"std_us\": " << run_time_us.std_deviation()
+          << ", \"min_us\": " << (run_time_us.empty() ? 0 : run_time_us.min())
+          << ", \"max_us\": " << (run_time_us.empty() ? 0 : run_time_us.max())
+          << "},\n    \"op_types\": ";
+  WriteJsonTimings(summarizer.GetOpTypeTimings(), stream);
+  *stream << ",\n    \"nodes\": ";
+  WriteJsonTimings(summarizer.GetNodeTimings(), stream);
+  *stream << "\n  }";
+}
+
+}  // namespace
+
 void ProfilingListener::SetInterpreter(tflite::Interpreter* interpreter) {
   TFLITE_BENCHMARK_CHECK(interpreter);
   interpreter_ = interpreter;
   interpreter_->SetProfiler(&profiler_);
 }
 
+void ProfilingListener::SetOutputFiles(const std::string& csv_file,
+                                       const std::string& json_file) {
+  csv_file_ = csv_file;
+  json_file_ = json_file;
+}
+
 void ProfilingListener::OnSingleRunStart(RunType run_type) {
-  if (run_type == REGULAR) {
-    profiler_.Reset();
-    profiler_.StartProfiling();
-  }
+  run_type_ = run_type;
+  profiler_.Reset();
+  profiler_.StartProfiling();
 }
 
 void ProfilingListener::OnBenchmarkEnd(const BenchmarkResults& results) {
+  TFLITE_LOG(INFO) << GetMemorySummary(*interpreter_);
+  TFLITE_LOG(INFO) << GetDelegateSummary(*interpreter_);
   if (has_profiles_) {
+    if (warmup_summarizer_.num_runs() > 0) {
+      TFLITE_LOG(INFO) << GetTimingsString(
+          "Warm-up time per op type", warmup_summarizer_.GetOpTypeTimings());
+    }
     TFLITE_LOG(INFO) << summarizer_.GetOutputString();
+    TFLITE_LOG(INFO) << GetTimingsString("Steady-state time per op type",
+                                         summarizer_.GetOpTypeTimings());
+  }
+  if (!csv_file_.empty()) {
+    WriteCsv();
+  }
+  if (!json_file_.empty()) {
+    WriteJson(results);
   }
 }
 
 void ProfilingListener::OnSingleRunEnd() {
   profiler_.StopProfiling();
   auto profile_events = profiler_.GetProfileEvents();
-  has_profiles_ = !profile_events.empty();
-  summarizer_.ProcessProfiles(profile_events, *interpreter_);
+  if (profile_events.empty()) {
+    return;
+  }
+  has_profiles_ = true;
+  if (run_type_ == WARMUP) {
+    warmup_summarizer_.ProcessProfiles(profile_events, *interpreter_);
+  } else {
+    summarizer_.ProcessProfiles(profile_events, *interpreter_);
+  }
+}
+
+void ProfilingListener::WriteCsv() const {
+  std::ofstream stream(csv_file_);
+  if (!stream) {
+    TFLITE_LOG(ERROR) << "Failed to open " << csv_file_;
+    return;
+  }
+  stream << "phase,kind,name,type,count,mean_us,std_us,min_us,p50_us,p90_us,"
+            "p99_us,max_us\n";
+  WriteCsvTimings("warmup", "op_type", warmup_summarizer_.GetOpTypeTimings(),
+                  &stream);
+  WriteCsvTimings("warmup", "node", warmup_summarizer_.GetNodeTimings(),
+                  &stream);
+  WriteCsvTimings("steady_state", "op_type", summarizer_.GetOpTypeTimings(),
+                  &stream);
+  WriteCsvTimings("steady_state", "node", summarizer_.GetNodeTimings(),
+                  &stream);
+  TFLITE_LOG(INFO) << "Wrote the op timings to " << csv_file_;
+}
+
+void ProfilingListener::WriteJson(const BenchmarkResults& results) const {
+  std::ofstream stream(json_file_);
+  if (!stream) {
+    TFLITE_LOG(ERROR) << "Failed to open " << json_file_;
+    return;
+  }
+  stream << "{\n  \"startup_latency_us\": " << results.startup_latency_us()
+         << ",\n  \"arena_bytes\": {\"read_write\": "
+         << interpreter_->GetArenaBytes(kTfLiteArenaRw)
+         << ", \"persistent\": "
+         << interpreter_->GetArenaBytes(kTfLiteArenaRwPersistent)
+         << "},\n  \"delegate_partitions\": [";
+  const std::vector<DelegatePartition> partitions =
+      GetDelegatePartitions(*interpreter_);
+  for (int i = 0; i < partitions.size(); ++i) {
+    const DelegatePartition& partition = partitions[i];
+    stream << (i == 0 ? "" : ",") << "\n    {\"delegate\": "
+           << JsonString(partition.name)
+           << ", \"node_index\": " << partition.node_index
+           << ", \"num_nodes\": " << partition.num_nodes
+           << ", \"num_input_tensors\": " << partition.num_input_tensors
+           << ", \"num_output_tensors\": " << partition.num_output_tensors
+           << "}";
+  }
+  stream << (partitions.empty() ? "]" : "\n  ]") << ",\n  \"warmup\": ";
+  WriteJsonPhase(results.warmup_time_us(), warmup_summarizer_, &stream);
+  stream << ",\n  \"steady_state\": ";
+  WriteJsonPhase(results.inference_time_us(), summarizer_, &stream);
+  stream << "\n}\n";
+  TFLITE_LOG(INFO) << "Wrote the benchmark report to " << json_file_;
 }
 
 namespace {
@@ -213,7 +457,14 @@ std::vector<Flag> BenchmarkTfLiteModel::GetFlags() {
       Flag("input_layer_values", &input_layer_values_string,
            "values to initialize the inputs with"),
       Flag("output_layer", &output_layer_string, "output layer name"),
-      Flag("use_nnapi", &use_nnapi, "use nnapi api")};
+      Flag("use_nnapi", &use_nnapi, "use nnapi api"),
+      Flag("use_sycl", &use_sycl, "run the supported ops with SYCL"),
+      Flag("profiling_output_csv_file", &profiling_output_csv_file,
+           "file the per-op timings of the warm-up and regular runs are "
+           "written to as CSV"),
+      Flag("profiling_output_json_file", &profiling_output_json_file,
+           "file the run and per-op timings, arena sizes and delegate "
+           "partitions are written to as JSON")};
 
   flags.insert(flags.end(), specific_flags.begin(), specific_flags.end());
   return flags;
@@ -227,6 +478,11 @@ void BenchmarkTfLiteModel::LogFlags() {
   TFLITE_LOG(INFO) << "Input types: [" << input_layer_type_string << "]";
   TFLITE_LOG(INFO) << "Output layers: [" << output_layer_string << "]";
   TFLITE_LOG(INFO) << "Use nnapi : [" << use_nnapi << "]";
+  TFLITE_LOG(INFO) << "Use sycl : [" << use_sycl << "]";
+  TFLITE_LOG(INFO) << "Profiling CSV output: [" << profiling_output_csv_file
+                   << "]";
+  TFLITE_LOG(INFO) << "Profiling JSON output: [" << profiling_output_json_file
+                   << "]";
 }
 
 bool BenchmarkTfLiteModel::ValidateFlags() {
@@ -250,6 +506,14 @@ uint64_t BenchmarkTfLiteModel::ComputeInputBytes() {
   return total_input_bytes;
 }
 
+BenchmarkTfLiteModel::~BenchmarkTfLiteModel() {
+  // The delegate must outlive the interpreter it was applied to.
+  interpreter.reset();
+  if (delegate_ != nullptr) {
+    DeleteSyclDelegate(delegate_);
+  }
+}
+
 void BenchmarkTfLiteModel::Init() {
   model = tflite::FlatBufferModel::BuildFromFile(graph.c_str());
   if (!model) {
@@ -271,12 +535,22 @@ void BenchmarkTfLiteModel::Init() {
     TFLITE_LOG(FATAL) << "Failed to construct interpreter";
   }
   profiling_listener_.SetInterpreter(interpreter.get());
+  profiling_listener_.SetOutputFiles(profiling_output_csv_file,
+                                     profiling_output_json_file);
 
   if (params_.num_threads != -1) {
     interpreter->SetNumThreads(params_.num_threads);
   }
 
   interpreter->UseNNAPI(use_nnapi);
+  if (use_sycl) {
+    delegate_ = NewSyclDelegate();
+    if (delegate_ == nullptr) {
+      TFLITE_LOG(WARN) << "SYCL is not supported in this build";
+    } else if (interpreter->ModifyGraphWithDelegate(delegate_) != kTfLiteOk) {
+      TFLITE_LOG(FATAL) << "Failed to apply the SYCL delegate";
+    }
+  }
   auto interpreter_inputs = interpreter->inputs();
 
   if (!inputs.empty()) {
@@ -27,13 +27,21 @@ limitations under the License.
 namespace tflite {
 namespace benchmark {
 
-// Dumps profiling events if profiling is enabled
+// Summarizes the operator invocations if profiling is enabled, separately for
+// the warm-up and the regular runs, and reports them along with the memory
+// reserved for the tensors and the subgraphs claimed by delegates.
 class ProfilingListener : public BenchmarkListener {
  public:
-  explicit ProfilingListener() : interpreter_(nullptr), has_profiles_(false) {}
+  explicit ProfilingListener()
+      : interpreter_(nullptr), run_type_(REGULAR), has_profiles_(false) {}
 
   void SetInterpreter(Interpreter* interpreter);
 
+  // Sets the files the report is written to as CSV and as JSON. An empty file
+  // name disables the corresponding output.
+  void SetOutputFiles(const std::string& csv_file,
+                      const std::string& json_file);
+
   void OnSingleRunStart(RunType run_type) override;
 
   void OnSingleRunEnd() override;
@@ -41,16 +49,24 @@ class ProfilingListener : public BenchmarkListener {
   void OnBenchmarkEnd(const BenchmarkResults& results) override;
 
  private:
+  void WriteCsv() const;
+  void WriteJson(const BenchmarkResults& results) const;
+
   Interpreter* interpreter_;
   profiling::Profiler profiler_;
+  profiling::ProfileSummarizer warmup_summarizer_;
   profiling::ProfileSummarizer summarizer_;
+  RunType run_type_;
   bool has_profiles_;
+  std::string csv_file_;
+  std::string json_file_;
 };
 
 // Benchmarks a TFLite model by running tflite interpreter.
 class BenchmarkTfLiteModel : public BenchmarkModel {
  public:
-  BenchmarkTfLiteModel() : use_nnapi(false) {
+  BenchmarkTfLiteModel()
+      : use_nnapi(false), use_sycl(false), delegate_(nullptr) {
     AddListener(&profiling_listener_);
   }
 
@@ -60,7 +76,7 @@ class BenchmarkTfLiteModel : public BenchmarkModel {
   uint64_t ComputeInputBytes() override;
   void Init() override;
   void RunImpl() override;
-  virtual ~BenchmarkTfLiteModel() {}
+  virtual ~BenchmarkTfLiteModel();
 
   struct InputLayerInfo {
     std::string name;
@@ -80,7 +96,11 @@ class BenchmarkTfLiteModel : public BenchmarkModel {
   std::string input_layer_values_string;
   std::string output_layer_string;
   std::vector<InputLayerInfo> inputs;
+  std::string profiling_output_csv_file;
+  std::string profiling_output_json_file;
   bool use_nnapi;
+  bool use_sycl;
+  TfLiteDelegate* delegate_;
   ProfilingListener profiling_listener_;
 };
 
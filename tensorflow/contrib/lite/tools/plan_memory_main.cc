@@ -0,0 +1,123 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Plans the arena of a model with the greedy planner and stores the plan in
+// the metadata buffers of the model, so that the interpreters built from it
+// place their tensors without planning them. The plan is computed for the
+// shapes of the inputs in the model: resizing an input invalidates the
+// planned offsets of the tensors whose size changes.
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/contrib/lite/interpreter.h"
+#include "tensorflow/contrib/lite/kernels/register.h"
+#include "tensorflow/contrib/lite/memory_plan.h"
+#include "tensorflow/contrib/lite/model.h"
+#include "tensorflow/contrib/lite/schema/schema_generated.h"
+#include "tensorflow/core/platform/init_main.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/command_line_flags.h"
+
+const char kInputModelFlag[] = "input_model";
+const char kOutputModelFlag[] = "output_model";
+
+using tensorflow::Flag;
+using tensorflow::Flags;
+using tensorflow::string;
+
+void ParseFlagAndInit(int argc, char** argv, string* input_model,
+                      string* output_model) {
+  std::vector<tensorflow::Flag> flag_list = {
+      Flag(kInputModelFlag, input_model, "path to the tflite model"),
+      Flag(kOutputModelFlag, output_model,
+           "path to write the model with its memory plan to"),
+  };
+
+  Flags::Parse(&argc, argv, flag_list);
+  tensorflow::port::InitMain(argv[0], &argc, &argv);
+}
+
+namespace {
+
+// Replaces the memory plans already in `model` with `plan`.
+void SetMemoryPlan(const tflite::MemoryPlan& plan, tflite::ModelT* model) {
+  std::vector<int32_t> metadata_buffer;
+  for (int32_t buffer_index : model->metadata_buffer) {
+    std::vector<uint8_t>& data = model->buffers[buffer_index]->data;
+    tflite::MemoryPlan old_plan;
+    if (tflite::ParseMemoryPlan(data.data(), data.size(), &old_plan)) {
+      data.clear();
+    } else {
+      metadata_buffer.push_back(buffer_index);
+    }
+  }
+
+  const string serialized_plan = tflite::SerializeMemoryPlan(plan);
+  std::unique_ptr<tflite::BufferT> buffer(new tflite::BufferT);
+  buffer->data.assign(serialized_plan.begin(), serialized_plan.end());
+  metadata_buffer.push_back(model->buffers.size());
+  model->buffers.push_back(std::move(buffer));
+  model->metadata_buffer = metadata_buffer;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  string input_model;
+  string output_model;
+  ParseFlagAndInit(argc, argv, &input_model, &output_model);
+
+  auto model = tflite::FlatBufferModel::BuildFromFile(input_model.c_str());
+  if (!model) {
+    LOG(ERROR) << "Failed to load model " << input_model;
+    return 1;
+  }
+  tflite::ops::builtin::BuiltinOpResolver resolver;
+  std::unique_ptr<tflite::Interpreter> interpreter;
+  if (tflite::InterpreterBuilder(*model, resolver)(&interpreter) !=
+      kTfLiteOk) {
+    LOG(ERROR) << "Failed to build the interpreter";
+    return 1;
+  }
+
+  // Plan from scratch, even if the model already has a plan.
+  tflite::MemoryPlan plan;
+  interpreter->UseGreedyMemoryPlanner();
+  if (interpreter->AllocateTensors() != kTfLiteOk ||
+      interpreter->GetMemoryPlan(&plan) != kTfLiteOk) {
+    LOG(ERROR) << "Failed to plan the tensors";
+    return 1;
+  }
+  LOG(INFO) << "Arena size: "
+            << interpreter->GetArenaBytes(kTfLiteArenaRw) << " bytes";
+
+  std::unique_ptr<tflite::ModelT> model_t(model->GetModel()->UnPack());
+  SetMemoryPlan(plan, model_t.get());
+  flatbuffers::FlatBufferBuilder builder;
+  tflite::FinishModelBuffer(builder,
+                            tflite::Model::Pack(builder, model_t.get()));
+
+  std::ofstream fout(output_model, std::ios::binary);
+  fout.write(reinterpret_cast<const char*>(builder.GetBufferPointer()),
+             builder.GetSize());
+  if (!fout) {
+    LOG(ERROR) << "Failed to write " << output_model;
+    return 1;
+  }
+  return 0;
+}
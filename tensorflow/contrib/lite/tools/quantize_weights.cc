@@ -0,0 +1,157 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/contrib/lite/tools/quantize_weights.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace tflite {
+
+namespace {
+
+// The index of the weights in the inputs of the operators that have hybrid
+// kernels.
+constexpr int kWeightsInputIndex = 1;
+
+// Returns the dimension of the weights of `op` along which they get one
+// scaling factor each, or -1 for a single one. Returns false if `op` has no
+// hybrid kernel.
+bool GetChannelDim(BuiltinOperator op, int* channel_dim) {
+  switch (op) {
+    case BuiltinOperator_CONV_2D:
+      // The filter is [channels_out, height, width, channels_in].
+      *channel_dim = 0;
+      return true;
+    case BuiltinOperator_DEPTHWISE_CONV_2D:
+      // The filter is [1, height, width, channels_out].
+      *channel_dim = 3;
+      return true;
+    case BuiltinOperator_FULLY_CONNECTED:
+      *channel_dim = -1;
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Quantizes the float data of `tensor`, stored in `buffer`, in place.
+void QuantizeTensor(int channel_dim, TensorT* tensor, BufferT* buffer) {
+  const int num_elements = buffer->data.size() / sizeof(float);
+  std::vector<float> values(num_elements);
+  memcpy(values.data(), buffer->data.data(), num_elements * sizeof(float));
+
+  int num_channels = 1;
+  int inner_size = num_elements;
+  if (channel_dim >= 0) {
+    num_channels = tensor->shape[channel_dim];
+    inner_size = 1;
+    for (int i = channel_dim + 1; i < tensor->shape.size(); ++i) {
+      inner_size *= tensor->shape[i];
+    }
+  }
+  auto channel_of = [&](int i) { return (i / inner_size) % num_channels; };
+
+  // As in SymmetricQuantizeFloats(), the scaling factors map the range of the
+  // values to [-127, 127], and are used as value * scaling_factor.
+  std::vector<float> scales(num_channels, 0.0f);
+  for (int i = 0; i < num_elements; ++i) {
+    scales[channel_of(i)] =
+        std::max(scales[channel_of(i)], std::abs(values[i]));
+  }
+  for (float& scale : scales) {
+    scale = scale == 0.0f ? 1.0f : 127.0f / scale;
+  }
+
+  std::vector<uint8_t> data(num_elements);
+  for (int i = 0; i < num_elements; ++i) {
+    const float quantized = std::round(values[i] * scales[channel_of(i)]);
+    data[i] = static_cast<uint8_t>(
+        static_cast<int8_t>(std::min(127.0f, std::max(-127.0f, quantized))));
+  }
+  buffer->data = data;
+
+  tensor->type = TensorType_UINT8;
+  tensor->quantization.reset(new QuantizationParametersT);
+  tensor->quantization->scale = scales;
+  tensor->quantization->zero_point.assign(num_channels, 0);
+}
+
+}  // namespace
+
+TfLiteStatus QuantizeWeights(int min_num_elements, ModelT* model,
+                             ErrorReporter* error_reporter) {
+  // Weights can only be quantized if nothing else reads their buffer.
+  std::map<int, int> buffer_uses;
+  for (const auto& subgraph : model->subgraphs) {
+    for (const auto& tensor : subgraph->tensors) {
+      ++buffer_uses[tensor->buffer];
+    }
+  }
+
+  for (const auto& subgraph : model->subgraphs) {
+    std::map<int, int> tensor_uses;
+    for (const auto& op : subgraph->operators) {
+      for (int input : op->inputs) {
+        ++tensor_uses[input];
+      }
+    }
+
+    for (const auto& op : subgraph->operators) {
+      if (op->opcode_index >= model->operator_codes.size()) {
+        error_reporter->Report("Invalid opcode index %d.\n", op->opcode_index);
+        return kTfLiteError;
+      }
+      const BuiltinOperator builtin_code =
+          model->operator_codes[op->opcode_index]->builtin_code;
+      int channel_dim;
+      if (!GetChannelDim(builtin_code, &channel_dim) ||
+          op->inputs.size() <= kWeightsInputIndex) {
+        continue;
+      }
+      const int input_index = op->inputs[0];
+      const int weights_index = op->inputs[kWeightsInputIndex];
+      if (input_index < 0 || weights_index < 0 ||
+          subgraph->tensors[input_index]->type != TensorType_FLOAT32) {
+        continue;
+      }
+
+      TensorT* weights = subgraph->tensors[weights_index].get();
+      if (weights->type != TensorType_FLOAT32 || weights->buffer == 0 ||
+          weights->buffer >= model->buffers.size()) {
+        continue;
+      }
+      BufferT* buffer = model->buffers[weights->buffer].get();
+      const int num_elements = buffer->data.size() / sizeof(float);
+      if (num_elements < std::max(min_num_elements, 1) ||
+          tensor_uses[weights_index] != 1 ||
+          buffer_uses[weights->buffer] != 1) {
+        continue;
+      }
+      if (channel_dim >= static_cast<int>(weights->shape.size())) {
+        error_reporter->Report("Unexpected rank %d for the weights '%s'.\n",
+                               static_cast<int>(weights->shape.size()),
+                               weights->name.c_str());
+        return kTfLiteError;
+      }
+      QuantizeTensor(channel_dim, weights, buffer);
+    }
+  }
+  return kTfLiteOk;
+}
+
+}  // namespace tflite
@@ -0,0 +1,41 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CONTRIB_LITE_TOOLS_QUANTIZE_WEIGHTS_H_
+#define TENSORFLOW_CONTRIB_LITE_TOOLS_QUANTIZE_WEIGHTS_H_
+
+#include "tensorflow/contrib/lite/context.h"
+#include "tensorflow/contrib/lite/error_reporter.h"
+#include "tensorflow/contrib/lite/schema/schema_generated.h"
+
+namespace tflite {
+
+// Quantizes the constant float weights of the CONV_2D, DEPTHWISE_CONV_2D and
+// FULLY_CONNECTED operators of `model` to 8 bits, so that they run with the
+// hybrid kernels: the activations stay in float and are quantized on the fly.
+//
+// The weights are quantized symmetrically, as in
+// tensor_utils::SymmetricQuantizeFloats(), and stored as uint8 tensors holding
+// int8 values. The convolutions get one scaling factor per output channel,
+// the fully connected operators a single one.
+//
+// Only the weights with at least `min_num_elements` elements are quantized;
+// the small ones save little and lose the most accuracy. Weights shared with
+// other operators or tensors are left in float.
+TfLiteStatus QuantizeWeights(int min_num_elements, ModelT* model,
+                             ErrorReporter* error_reporter);
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_CONTRIB_LITE_TOOLS_QUANTIZE_WEIGHTS_H_
@@ -0,0 +1,84 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Quantizes the weights of the convolutions and fully connected operators of
+// a float model to 8 bits, so that it runs with the hybrid kernels.
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/contrib/lite/model.h"
+#include "tensorflow/contrib/lite/schema/schema_generated.h"
+#include "tensorflow/contrib/lite/tools/quantize_weights.h"
+#include "tensorflow/core/platform/init_main.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/command_line_flags.h"
+
+const char kInputModelFlag[] = "input_model";
+const char kOutputModelFlag[] = "output_model";
+const char kMinNumElementsFlag[] = "min_num_elements";
+
+using tensorflow::Flag;
+using tensorflow::Flags;
+using tensorflow::string;
+
+void ParseFlagAndInit(int argc, char** argv, string* input_model,
+                      string* output_model, int* min_num_elements) {
+  std::vector<tensorflow::Flag> flag_list = {
+      Flag(kInputModelFlag, input_model, "path to the float tflite model"),
+      Flag(kOutputModelFlag, output_model,
+           "path to write the model with quantized weights to"),
+      Flag(kMinNumElementsFlag, min_num_elements,
+           "weights with fewer elements are left in float"),
+  };
+
+  Flags::Parse(&argc, argv, flag_list);
+  tensorflow::port::InitMain(argv[0], &argc, &argv);
+}
+
+int main(int argc, char** argv) {
+  string input_model;
+  string output_model;
+  int min_num_elements = 1024;
+  ParseFlagAndInit(argc, argv, &input_model, &output_model,
+                   &min_num_elements);
+
+  auto model = tflite::FlatBufferModel::BuildFromFile(input_model.c_str());
+  if (!model) {
+    LOG(ERROR) << "Failed to load model " << input_model;
+    return 1;
+  }
+
+  std::unique_ptr<tflite::ModelT> model_t(model->GetModel()->UnPack());
+  if (tflite::QuantizeWeights(min_num_elements, model_t.get(),
+                              tflite::DefaultErrorReporter()) != kTfLiteOk) {
+    LOG(ERROR) << "Failed to quantize the weights";
+    return 1;
+  }
+  flatbuffers::FlatBufferBuilder builder;
+  tflite::FinishModelBuffer(builder,
+                            tflite::Model::Pack(builder, model_t.get()));
+
+  std::ofstream fout(output_model, std::ios::binary);
+  fout.write(reinterpret_cast<const char*>(builder.GetBufferPointer()),
+             builder.GetSize());
+  if (!fout) {
+    LOG(ERROR) << "Failed to write " << output_model;
+    return 1;
+  }
+  return 0;
+}
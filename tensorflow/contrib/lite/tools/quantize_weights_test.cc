@@ -0,0 +1,152 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/contrib/lite/tools/quantize_weights.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorflow/contrib/lite/error_reporter.h"
+#include "tensorflow/contrib/lite/testing/util.h"
+
+namespace tflite {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::FloatEq;
+
+// Builds a model with a single operator reading a float input and constant
+// float weights.
+class ModelWithWeights {
+ public:
+  ModelWithWeights(BuiltinOperator op, const std::vector<int>& shape,
+                   const std::vector<float>& weights)
+      : model_(new ModelT) {
+    model_->buffers.emplace_back(new BufferT);
+    std::unique_ptr<OperatorCodeT> opcode(new OperatorCodeT);
+    opcode->builtin_code = op;
+    model_->operator_codes.push_back(std::move(opcode));
+
+    std::unique_ptr<SubGraphT> subgraph(new SubGraphT);
+    subgraph->tensors.push_back(NewTensor("input", /*buffer=*/0));
+    subgraph->tensors.push_back(NewTensor("weights", /*buffer=*/1));
+    subgraph->tensors.back()->shape = shape;
+    subgraph->tensors.push_back(NewTensor("output", /*buffer=*/0));
+    std::unique_ptr<OperatorT> op_t(new OperatorT);
+    op_t->opcode_index = 0;
+    op_t->inputs = {0, 1};
+    op_t->outputs = {2};
+    subgraph->operators.push_back(std::move(op_t));
+    model_->subgraphs.push_back(std::move(subgraph));
+
+    std::unique_ptr<BufferT> buffer(new BufferT);
+    buffer->data.resize(weights.size() * sizeof(float));
+    memcpy(buffer->data.data(), weights.data(), buffer->data.size());
+    model_->buffers.push_back(std::move(buffer));
+  }
+
+  ModelT* model() { return model_.get(); }
+  TensorT* weights() { return model_->subgraphs[0]->tensors[1].get(); }
+  std::vector<int8_t> quantized_weights() {
+    const std::vector<uint8_t>& data = model_->buffers[1]->data;
+    return std::vector<int8_t>(data.begin(), data.end());
+  }
+
+ private:
+  static std::unique_ptr<TensorT> NewTensor(const char* name, int buffer) {
+    std::unique_ptr<TensorT> tensor(new TensorT);
+    tensor->name = name;
+    tensor->type = TensorType_FLOAT32;
+    tensor->buffer = buffer;
+    return tensor;
+  }
+
+  std::unique_ptr<ModelT> model_;
+};
+
+TEST(QuantizeWeightsTest, ConvGetsOneScalePerOutputChannel) {
+  ModelWithWeights m(BuiltinOperator_CONV_2D, {2, 1, 1, 2},
+                     {1, -2, 0.5, 0.25});
+  ASSERT_EQ(QuantizeWeights(1, m.model(), DefaultErrorReporter()), kTfLiteOk);
+
+  EXPECT_EQ(m.weights()->type, TensorType_UINT8);
+  EXPECT_THAT(m.weights()->quantization->scale,
+              ElementsAre(FloatEq(127.0f / 2), FloatEq(127.0f / 0.5)));
+  EXPECT_THAT(m.weights()->quantization->zero_point, ElementsAre(0, 0));
+  EXPECT_THAT(m.quantized_weights(), ElementsAreArray({64, -127, 127, 64}));
+}
+
+TEST(QuantizeWeightsTest, DepthwiseConvGetsOneScalePerOutputChannel) {
+  ModelWithWeights m(BuiltinOperator_DEPTHWISE_CONV_2D, {1, 2, 1, 2},
+                     {1, 0, -4, 0});
+  ASSERT_EQ(QuantizeWeights(1, m.model(), DefaultErrorReporter()), kTfLiteOk);
+
+  EXPECT_EQ(m.weights()->type, TensorType_UINT8);
+  // All-zero channels get a scale of 1.
+  EXPECT_THAT(m.weights()->quantization->scale,
+              ElementsAre(FloatEq(127.0f / 4), FloatEq(1)));
+  EXPECT_THAT(m.quantized_weights(), ElementsAreArray({32, 0, -127, 0}));
+}
+
+TEST(QuantizeWeightsTest, FullyConnectedGetsASingleScale) {
+  ModelWithWeights m(BuiltinOperator_FULLY_CONNECTED, {2, 2},
+                     {1, -2, 0.5, 0.25});
+  ASSERT_EQ(QuantizeWeights(1, m.model(), DefaultErrorReporter()), kTfLiteOk);
+
+  EXPECT_EQ(m.weights()->type, TensorType_UINT8);
+  EXPECT_THAT(m.weights()->quantization->scale,
+              ElementsAre(FloatEq(127.0f / 2)));
+  EXPECT_THAT(m.quantized_weights(), ElementsAreArray({64, -127, 32, 16}));
+}
+
+TEST(QuantizeWeightsTest, SmallWeightsAreNotQuantized) {
+  ModelWithWeights m(BuiltinOperator_CONV_2D, {2, 1, 1, 2},
+                     {1, -2, 0.5, 0.25});
+  ASSERT_EQ(QuantizeWeights(5, m.model(), DefaultErrorReporter()), kTfLiteOk);
+  EXPECT_EQ(m.weights()->type, TensorType_FLOAT32);
+  EXPECT_EQ(m.model()->buffers[1]->data.size(), 4 * sizeof(float));
+}
+
+TEST(QuantizeWeightsTest, OtherOperatorsAreNotQuantized) {
+  ModelWithWeights m(BuiltinOperator_ADD, {2, 2}, {1, -2, 0.5, 0.25});
+  ASSERT_EQ(QuantizeWeights(1, m.model(), DefaultErrorReporter()), kTfLiteOk);
+  EXPECT_EQ(m.weights()->type, TensorType_FLOAT32);
+}
+
+TEST(QuantizeWeightsTest, SharedWeightsAreNotQuantized) {
+  ModelWithWeights m(BuiltinOperator_FULLY_CONNECTED, {2, 2},
+                     {1, -2, 0.5, 0.25});
+  // Another operator reads the weights as float.
+  std::unique_ptr<OperatorT> op(new OperatorT);
+  op->opcode_index = 0;
+  op->inputs = {1, 1};
+  op->outputs = {2};
+  m.model()->subgraphs[0]->operators.push_back(std::move(op));
+
+  ASSERT_EQ(QuantizeWeights(1, m.model(), DefaultErrorReporter()), kTfLiteOk);
+  EXPECT_EQ(m.weights()->type, TensorType_FLOAT32);
+}
+
+}  // namespace
+}  // namespace tflite
+
+int main(int argc, char** argv) {
+  ::tflite::LogToStderr();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,47 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/contrib/lite/weight_cache.h"
+
+#include <cstdint>
+
+namespace tflite {
+
+const void* WeightCache::GetOrCreate(
+    const void* source, size_t source_bytes, const std::string& kind,
+    size_t bytes, const std::function<void(void* buffer)>& fill) {
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(base_);
+  const uintptr_t data = reinterpret_cast<uintptr_t>(source);
+  if (data < begin || data + source_bytes > begin + size_) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unique_ptr<char[]>& buffer =
+      buffers_[std::make_tuple(source, source_bytes, kind)];
+  if (buffer == nullptr) {
+    buffer.reset(new char[bytes]);
+    fill(buffer.get());
+    bytes_ += bytes;
+  }
+  return buffer.get();
+}
+
+size_t WeightCache::bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_;
+}
+
+}  // namespace tflite
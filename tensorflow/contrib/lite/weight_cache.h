@@ -0,0 +1,73 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CONTRIB_LITE_WEIGHT_CACHE_H_
+#define TENSORFLOW_CONTRIB_LITE_WEIGHT_CACHE_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "tensorflow/contrib/lite/context.h"
+
+namespace tflite {
+
+// A cache of the buffers that kernels derive from the read-only constant data
+// of a model, e.g. transposed filters. It is owned by the FlatBufferModel and
+// shared by all the interpreters built from it, so that running several
+// interpreters of the same model only costs one copy of the derived weights;
+// each interpreter then only owns its tensor arenas.
+//
+// The buffers are never evicted and live as long as the cache. The cache is
+// thread-safe, as interpreters of the same model may be prepared concurrently.
+class WeightCache {
+ public:
+  // Creates a cache for the constant data in [`base`, `base` + `size`).
+  WeightCache(const void* base, size_t size) : base_(base), size_(size) {}
+  WeightCache(const WeightCache&) = delete;
+  WeightCache& operator=(const WeightCache&) = delete;
+
+  // Returns a buffer of `bytes` bytes derived from the `source_bytes` bytes of
+  // constant data at `source`, called `kind`, e.g. "conv_hwcn_weights". The
+  // first request for a buffer calls `fill` to compute its contents. Returns
+  // nullptr if `source` is not part of the constant data of the cache.
+  const void* GetOrCreate(const void* source, size_t source_bytes,
+                          const std::string& kind, size_t bytes,
+                          const std::function<void(void* buffer)>& fill);
+
+  // Returns the total size of the cached buffers.
+  size_t bytes() const;
+
+ private:
+  typedef std::tuple<const void*, size_t, std::string> Key;
+
+  const void* const base_;
+  const size_t size_;
+  mutable std::mutex mutex_;
+  std::map<Key, std::unique_ptr<char[]>> buffers_;
+  size_t bytes_ = 0;
+};
+
+// Returns the weight cache of the interpreter that owns `context`, or nullptr
+// if it was not built from a FlatBufferModel.
+inline WeightCache* GetWeightCache(TfLiteContext* context) {
+  return static_cast<WeightCache*>(context->weight_cache);
+}
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_CONTRIB_LITE_WEIGHT_CACHE_H_
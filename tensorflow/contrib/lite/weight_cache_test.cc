@@ -0,0 +1,82 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/contrib/lite/weight_cache.h"
+
+#include <gtest/gtest.h>
+#include "tensorflow/contrib/lite/testing/util.h"
+
+namespace tflite {
+namespace {
+
+void Negate(const float* source, int size, void* buffer) {
+  float* output = static_cast<float*>(buffer);
+  for (int i = 0; i < size; ++i) {
+    output[i] = -source[i];
+  }
+}
+
+TEST(WeightCacheTest, FillsEachBufferOnce) {
+  const float weights[] = {1.f, 2.f, 3.f, 4.f};
+  WeightCache cache(weights, sizeof(weights));
+  int num_fills = 0;
+  auto fill = [&weights, &num_fills](void* buffer) {
+    Negate(weights, 4, buffer);
+    ++num_fills;
+  };
+
+  const void* buffer =
+      cache.GetOrCreate(weights, sizeof(weights), "negated", 16, fill);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_EQ(static_cast<const float*>(buffer)[3], -4.f);
+  EXPECT_EQ(cache.GetOrCreate(weights, sizeof(weights), "negated", 16, fill),
+            buffer);
+  EXPECT_EQ(num_fills, 1);
+  EXPECT_EQ(cache.bytes(), 16);
+
+  // Other kinds and other slices of the data get their own buffers.
+  EXPECT_NE(cache.GetOrCreate(weights, sizeof(weights), "other", 16, fill),
+            buffer);
+  EXPECT_NE(cache.GetOrCreate(weights, 2 * sizeof(float), "negated", 16, fill),
+            buffer);
+  EXPECT_EQ(num_fills, 3);
+  EXPECT_EQ(cache.bytes(), 48);
+}
+
+TEST(WeightCacheTest, RejectsDataOutsideOfTheModel) {
+  const float weights[] = {1.f, 2.f, 3.f, 4.f};
+  const float other_weights[] = {1.f, 2.f};
+  WeightCache cache(weights, sizeof(weights));
+  int num_fills = 0;
+  auto fill = [&num_fills](void* buffer) { ++num_fills; };
+
+  EXPECT_EQ(cache.GetOrCreate(other_weights, sizeof(other_weights), "negated",
+                              8, fill),
+            nullptr);
+  EXPECT_EQ(cache.GetOrCreate(weights + 2, sizeof(weights), "negated", 16,
+                              fill),
+            nullptr);
+  EXPECT_EQ(num_fills, 0);
+  EXPECT_EQ(cache.bytes(), 0);
+}
+
+}  // namespace
+}  // namespace tflite
+
+int main(int argc, char** argv) {
+  ::tflite::LogToStderr();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
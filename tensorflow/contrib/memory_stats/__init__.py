@@ -16,6 +16,8 @@
 
 @@BytesInUse
 @@BytesLimit
+@@BytesReserved
+@@LargestFreeBlock
 @@MaxBytesInUse
 """
 
@@ -25,6 +27,8 @@ from __future__ import print_function
 
 from tensorflow.contrib.memory_stats.python.ops.memory_stats_ops import BytesInUse
 from tensorflow.contrib.memory_stats.python.ops.memory_stats_ops import BytesLimit
+from tensorflow.contrib.memory_stats.python.ops.memory_stats_ops import BytesReserved
+from tensorflow.contrib.memory_stats.python.ops.memory_stats_ops import LargestFreeBlock
 from tensorflow.contrib.memory_stats.python.ops.memory_stats_ops import MaxBytesInUse
 
 from tensorflow.python.util.all_util import remove_undocumented
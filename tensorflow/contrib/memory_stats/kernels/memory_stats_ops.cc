@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/lib/core/errors.h"
 
 namespace tensorflow {
 
@@ -109,4 +110,82 @@ REGISTER_KERNEL_BUILDER(
     MaxBytesInUseOp);
 #endif  // TENSORFLOW_USE_SYCL
 
+// Base class of ops that report how fragmented the memory held by the
+// allocator of a device is.
+class MemoryFragmentationOp : public OpKernel {
+ public:
+  explicit MemoryFragmentationOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    Allocator* allocator =
+        context->device()->GetAllocator(AllocatorAttributes());
+    AllocatorFragmentation fragmentation;
+    OP_REQUIRES(context, allocator->GetFragmentation(&fragmentation),
+                errors::Unimplemented("Allocator ", allocator->Name(),
+                                      " does not track fragmentation"));
+
+    Tensor* output_tensor = nullptr;
+    OP_REQUIRES_OK(
+        context, context->allocate_output(0, TensorShape({}), &output_tensor));
+    output_tensor->scalar<int64>()() =
+        ExtractAllocatorFragmentation(fragmentation);
+  }
+
+ protected:
+  // Extracts a certain field (determined by subclasses) from an allocator
+  // fragmentation.
+  virtual int64 ExtractAllocatorFragmentation(
+      const AllocatorFragmentation& fragmentation) const = 0;
+};
+
+// Op that measures the device memory (in bytes) held by the allocator, used
+// or not.
+class BytesReservedOp : public MemoryFragmentationOp {
+ public:
+  explicit BytesReservedOp(OpKernelConstruction* context)
+      : MemoryFragmentationOp(context) {}
+
+ private:
+  int64 ExtractAllocatorFragmentation(
+      const AllocatorFragmentation& fragmentation) const override {
+    return fragmentation.region_bytes;
+  }
+};
+
+REGISTER_KERNEL_BUILDER(
+    Name("BytesReserved").Device(DEVICE_GPU).HostMemory("out"),
+    BytesReservedOp);
+
+#ifdef TENSORFLOW_USE_SYCL
+REGISTER_KERNEL_BUILDER(
+    Name("BytesReserved").Device(DEVICE_SYCL).HostMemory("out"),
+    BytesReservedOp);
+#endif  // TENSORFLOW_USE_SYCL
+
+// Op that measures the largest allocation (in bytes) the allocator can serve
+// from the memory it holds. Together with BytesReserved and BytesInUse it
+// tells how fragmented the free memory is.
+class LargestFreeBlockOp : public MemoryFragmentationOp {
+ public:
+  explicit LargestFreeBlockOp(OpKernelConstruction* context)
+      : MemoryFragmentationOp(context) {}
+
+ private:
+  int64 ExtractAllocatorFragmentation(
+      const AllocatorFragmentation& fragmentation) const override {
+    return fragmentation.largest_free_block_bytes;
+  }
+};
+
+REGISTER_KERNEL_BUILDER(
+    Name("LargestFreeBlock").Device(DEVICE_GPU).HostMemory("out"),
+    LargestFreeBlockOp);
+
+#ifdef TENSORFLOW_USE_SYCL
+REGISTER_KERNEL_BUILDER(
+    Name("LargestFreeBlock").Device(DEVICE_SYCL).HostMemory("out"),
+    LargestFreeBlockOp);
+#endif  // TENSORFLOW_USE_SYCL
+
 }  // namespace tensorflow
@@ -29,5 +29,13 @@ REGISTER_OP("MaxBytesInUse")
     .Output("out: int64")
     .SetIsStateful()
     .SetShapeFn(shape_inference::ScalarShape);
+REGISTER_OP("BytesReserved")
+    .Output("out: int64")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::ScalarShape);
+REGISTER_OP("LargestFreeBlock")
+    .Output("out: int64")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::ScalarShape);
 
 }  // namespace tensorflow
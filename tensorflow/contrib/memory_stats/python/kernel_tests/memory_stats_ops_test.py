@@ -89,6 +89,25 @@ class MemoryStatsOpsTest(test_util.TensorFlowTestCase):
       # max usage is still 3 because it reflects maxium from previous .run call
       self.assertGreaterEqual(max_bytes_in_use, matrix_size_in_bytes * 3)
 
+  def testFragmentation(self):
+    # The fragmentation ops are registered on GPU only. See
+    # kernels/memory_stats_ops.cc.
+    if not test.is_gpu_available():
+      return
+
+    with self.test_session(use_gpu=True) as sess:
+      matrix_shape = tensor_shape.TensorShape([64, 64])
+      a = random_ops.random_uniform(matrix_shape)
+      with ops.control_dependencies([a]):
+        bytes_in_use_op = memory_stats_ops.BytesInUse()
+        bytes_reserved_op = memory_stats_ops.BytesReserved()
+        largest_free_block_op = memory_stats_ops.LargestFreeBlock()
+      _, bytes_in_use, bytes_reserved, largest_free_block = sess.run(
+          [a, bytes_in_use_op, bytes_reserved_op, largest_free_block_op])
+
+      self.assertGreaterEqual(bytes_reserved, bytes_in_use)
+      self.assertLessEqual(largest_free_block, bytes_reserved)
+
 
 if __name__ == '__main__':
   test.main()
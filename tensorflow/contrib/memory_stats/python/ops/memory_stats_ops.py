@@ -39,3 +39,13 @@ def BytesLimit():
 def MaxBytesInUse():
   """Generates an op that computes the peak memory of a device."""
   return gen_memory_stats_ops.max_bytes_in_use()
+
+
+def BytesReserved():
+  """Generates an op that measures the memory held by a device's allocator."""
+  return gen_memory_stats_ops.bytes_reserved()
+
+
+def LargestFreeBlock():
+  """Generates an op that measures the largest free block of a device."""
+  return gen_memory_stats_ops.largest_free_block()
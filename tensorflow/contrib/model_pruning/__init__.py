@@ -19,6 +19,11 @@ from __future__ import division
 from __future__ import print_function
 
 # pylint: disable=unused-import
+from tensorflow.contrib.model_pruning.python.ops.block_sparse_ops import block_sparse_conv2d_1x1
+from tensorflow.contrib.model_pruning.python.ops.block_sparse_ops import block_sparse_from_masked_weights
+from tensorflow.contrib.model_pruning.python.ops.block_sparse_ops import block_sparse_matmul
+from tensorflow.contrib.model_pruning.python.ops.block_sparse_ops import BlockSparseMatrix
+from tensorflow.contrib.model_pruning.python.ops.block_sparse_ops import masked_weights_to_block_sparse
 from tensorflow.contrib.model_pruning.python.layers.layers import masked_conv2d
 from tensorflow.contrib.model_pruning.python.layers.layers import masked_convolution
 from tensorflow.contrib.model_pruning.python.layers.layers import masked_fully_connected
@@ -41,7 +46,9 @@ _allowed_symbols = [
     'masked_convolution', 'masked_conv2d', 'masked_fully_connected',
     'MaskedBasicLSTMCell', 'MaskedLSTMCell', 'train', 'apply_mask',
     'get_masked_weights', 'get_masks', 'get_pruning_hparams', 'get_thresholds',
-    'get_weights', 'get_weight_sparsity', 'Pruning'
+    'get_weights', 'get_weight_sparsity', 'Pruning', 'BlockSparseMatrix',
+    'block_sparse_conv2d_1x1', 'block_sparse_from_masked_weights',
+    'block_sparse_matmul', 'masked_weights_to_block_sparse'
 ]
 
 remove_undocumented(__name__, _allowed_symbols)
@@ -0,0 +1,163 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/block_sparse_ops.cc.
+
+#include <algorithm>
+
+#include "third_party/eigen3/Eigen/Core"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+using errors::InvalidArgument;
+
+template <typename T>
+class BlockSparseMatMulOp : public OpKernel {
+ public:
+  using Matrix =
+      Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  using ConstMatrixMap = Eigen::Map<const Matrix>;
+  using MatrixMap = Eigen::Map<Matrix>;
+
+  explicit BlockSparseMatMulOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& a = context->input(0);
+    const Tensor& b_values = context->input(1);
+    const Tensor& b_block_row_indices = context->input(2);
+    const Tensor& b_block_col_ptr = context->input(3);
+    const Tensor& b_shape = context->input(4);
+    OP_REQUIRES(context, TensorShapeUtils::IsMatrix(a.shape()),
+                InvalidArgument("a must be a matrix, got shape ",
+                                a.shape().DebugString()));
+    OP_REQUIRES(context, b_values.dims() == 3,
+                InvalidArgument("b_values must have rank 3, got shape ",
+                                b_values.shape().DebugString()));
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(b_block_row_indices.shape()) &&
+                    b_block_row_indices.dim_size(0) == b_values.dim_size(0),
+                InvalidArgument("b_block_row_indices must be a vector of ",
+                                b_values.dim_size(0), " indices, got shape ",
+                                b_block_row_indices.shape().DebugString()));
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(b_shape.shape()) &&
+                    b_shape.NumElements() == 2,
+                InvalidArgument("b_shape must be a vector of 2 elements, got "
+                                "shape ",
+                                b_shape.shape().DebugString()));
+
+    const int64 m = a.dim_size(0);
+    const int64 k = a.dim_size(1);
+    const int64 num_blocks = b_values.dim_size(0);
+    const int64 block_height = b_values.dim_size(1);
+    const int64 block_width = b_values.dim_size(2);
+    const int64 b_rows = b_shape.vec<int64>()(0);
+    const int64 n = b_shape.vec<int64>()(1);
+    OP_REQUIRES(context, b_rows == k,
+                InvalidArgument("Matrix size-incompatible: a has ", k,
+                                " columns but b has ", b_rows, " rows"));
+    OP_REQUIRES(context, block_height > 0 && block_width > 0,
+                InvalidArgument("The blocks of b must not be empty, got "
+                                "b_values of shape ",
+                                b_values.shape().DebugString()));
+    OP_REQUIRES(context,
+                n >= 0 && k % block_height == 0 && n % block_width == 0,
+                InvalidArgument("The shape [", k, ", ", n,
+                                "] of b is not a multiple of its block shape [",
+                                block_height, ", ", block_width, "]"));
+    const int64 num_block_rows = k / block_height;
+    const int64 num_block_cols = n / block_width;
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(b_block_col_ptr.shape()) &&
+                    b_block_col_ptr.dim_size(0) == num_block_cols + 1,
+                InvalidArgument("b_block_col_ptr must be a vector of ",
+                                num_block_cols + 1, " offsets, got shape ",
+                                b_block_col_ptr.shape().DebugString()));
+
+    const auto col_ptr = b_block_col_ptr.vec<int32>();
+    const auto row_indices = b_block_row_indices.vec<int32>();
+    OP_REQUIRES(context,
+                col_ptr(0) == 0 && col_ptr(num_block_cols) == num_blocks,
+                InvalidArgument("b_block_col_ptr must start at 0 and end at ",
+                                num_blocks));
+    for (int64 j = 0; j < num_block_cols; ++j) {
+      OP_REQUIRES(context, col_ptr(j) <= col_ptr(j + 1),
+                  InvalidArgument("b_block_col_ptr must be non-decreasing, "
+                                  "but offset ",
+                                  j + 1, " is ", col_ptr(j + 1),
+                                  " after ", col_ptr(j)));
+    }
+    for (int64 i = 0; i < num_blocks; ++i) {
+      OP_REQUIRES(context,
+                  row_indices(i) >= 0 && row_indices(i) < num_block_rows,
+                  InvalidArgument("b_block_row_indices[", i, "] = ",
+                                  row_indices(i), " is not in [0, ",
+                                  num_block_rows, ")"));
+    }
+
+    Tensor* product = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                0, TensorShape({m, n}), &product));
+    if (product->NumElements() == 0) return;
+
+    ConstMatrixMap a_matrix(a.flat<T>().data(), m, k);
+    MatrixMap product_matrix(product->flat<T>().data(), m, n);
+    const T* values = b_values.flat<T>().data();
+    const int64 block_size = block_height * block_width;
+
+    // Each column of blocks of b gives block_width columns of the product,
+    // so the columns of blocks are independent and computed in parallel.
+    // Within a block, Eigen multiplies the rows of a with vector code.
+    auto compute = [&](int64 start, int64 limit) {
+      for (int64 j = start; j < limit; ++j) {
+        auto product_block =
+            product_matrix.middleCols(j * block_width, block_width);
+        product_block.setZero();
+        for (int32 i = col_ptr(j); i < col_ptr(j + 1); ++i) {
+          ConstMatrixMap block(values + i * block_size, block_height,
+                               block_width);
+          product_block.noalias() +=
+              a_matrix.middleCols(row_indices(i) * block_height,
+                                  block_height) *
+              block;
+        }
+      }
+    };
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    const int64 cost_per_block_col =
+        2 * m * block_size * std::max<int64>(1, num_blocks / num_block_cols);
+    Shard(worker_threads.num_threads, worker_threads.workers, num_block_cols,
+          cost_per_block_col, compute);
+  }
+};
+
+#define REGISTER_CPU(T)                                                   \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("BlockSparseMatMul").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      BlockSparseMatMulOp<T>);
+
+TF_CALL_float(REGISTER_CPU);
+TF_CALL_double(REGISTER_CPU);
+#undef REGISTER_CPU
+
+}  // namespace tensorflow
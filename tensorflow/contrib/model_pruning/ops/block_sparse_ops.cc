@@ -0,0 +1,74 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/common_shape_fns.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/shape_inference.h"
+
+namespace tensorflow {
+
+using shape_inference::DimensionHandle;
+using shape_inference::InferenceContext;
+using shape_inference::ShapeHandle;
+
+REGISTER_OP("BlockSparseMatMul")
+    .Attr("T: {float, double}")
+    .Input("a: T")
+    .Input("b_values: T")
+    .Input("b_block_row_indices: int32")
+    .Input("b_block_col_ptr: int32")
+    .Input("b_shape: int64")
+    .Output("product: T")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle a;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 2, &a));
+      ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 3, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 1, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(3), 1, &unused));
+      ShapeHandle b_shape;
+      TF_RETURN_IF_ERROR(c->MakeShapeFromShapeTensor(4, &b_shape));
+      TF_RETURN_IF_ERROR(c->WithRank(b_shape, 2, &b_shape));
+      DimensionHandle unused_dim;
+      TF_RETURN_IF_ERROR(
+          c->Merge(c->Dim(a, 1), c->Dim(b_shape, 0), &unused_dim));
+      c->set_output(0, c->Matrix(c->Dim(a, 0), c->Dim(b_shape, 1)));
+      return Status::OK();
+    })
+    .Doc(R"doc(
+Multiplies a dense matrix `a` by a block sparse matrix `b`.
+
+`b` is stored in the block compressed sparse column format: it is split into
+blocks of `block_height` times `block_width` values, and only its non-zero
+blocks are stored, ordered by column of blocks. The non-zero blocks of column
+`j` are `b_values[b_block_col_ptr[j]:b_block_col_ptr[j + 1]]`, and the block
+`b_values[i]` is at row `b_block_row_indices[i] * block_height` of `b`.
+
+The cost of the product is proportional to the number of non-zero blocks, so
+pruning the weights of a layer by blocks makes its inference faster.
+
+a: the dense matrix, of shape `[m, k]`.
+b_values: the non-zero blocks of `b`, of shape
+  `[num_blocks, block_height, block_width]`.
+b_block_row_indices: the row of blocks of each non-zero block, of shape
+  `[num_blocks]`.
+b_block_col_ptr: the offsets in `b_values` of the blocks of each column of
+  blocks, of shape `[n / block_width + 1]`.
+b_shape: the dense shape `[k, n]` of `b`. It must be a multiple of the block
+  shape.
+product: `a` times `b`, of shape `[m, n]`.
+)doc");
+
+}  // namespace tensorflow
@@ -0,0 +1,104 @@
+# Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""Tests for the block sparse ops."""
+
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import numpy as np
+
+from tensorflow.contrib.model_pruning.python.ops import block_sparse_ops
+from tensorflow.python.framework import errors
+from tensorflow.python.platform import test
+
+
+class BlockSparseOpsTest(test.TestCase):
+
+  def _prunedWeights(self, rows, cols, block_shape, density=0.3):
+    block_height, block_width = block_shape
+    weights = np.random.randn(rows, cols).astype(np.float32)
+    block_mask = np.random.rand(rows // block_height, cols // block_width)
+    mask = np.kron(block_mask < density,
+                   np.ones(block_shape)).astype(np.float32)
+    return weights, mask
+
+  def testFromMaskedWeights(self):
+    weights = np.arange(1, 17, dtype=np.float32).reshape(4, 4)
+    mask = np.zeros_like(weights)
+    mask[0:2, 2:4] = 1
+    mask[2:4, 2] = 1
+    b = block_sparse_ops.block_sparse_from_masked_weights(
+        weights, mask, block_shape=(2, 2))
+    self.assertAllEqual([[[3, 4], [7, 8]], [[11, 0], [15, 0]]], b.values)
+    self.assertAllEqual([0, 1], b.block_row_indices)
+    self.assertAllEqual([0, 0, 2], b.block_col_ptr)
+    self.assertAllEqual([4, 4], b.dense_shape)
+
+  def testFromMaskedWeightsRejectsUnalignedShapes(self):
+    with self.assertRaises(ValueError):
+      block_sparse_ops.block_sparse_from_masked_weights(
+          np.ones([4, 6]), block_shape=(4, 4))
+
+  def testMatMul(self):
+    for block_shape in [(1, 1), (4, 4), (8, 1)]:
+      weights, mask = self._prunedWeights(32, 24, block_shape)
+      a = np.random.randn(5, 32).astype(np.float32)
+      b = block_sparse_ops.block_sparse_from_masked_weights(
+          weights, mask, block_shape)
+      with self.test_session():
+        product = block_sparse_ops.block_sparse_matmul(a, b)
+        self.assertEqual([5, 24], product.get_shape().as_list())
+        self.assertAllClose(
+            np.dot(a, weights * mask), product.eval(), rtol=1e-5, atol=1e-5)
+
+  def testMatMulWithoutBlocks(self):
+    b = block_sparse_ops.block_sparse_from_masked_weights(
+        np.zeros([8, 8], dtype=np.float32), block_shape=(4, 4))
+    with self.test_session():
+      product = block_sparse_ops.block_sparse_matmul(
+          np.ones([3, 8], dtype=np.float32), b)
+      self.assertAllEqual(np.zeros([3, 8]), product.eval())
+
+  def testConv2D1x1(self):
+    weights, mask = self._prunedWeights(16, 8, (4, 1))
+    inputs = np.random.randn(2, 3, 5, 16).astype(np.float32)
+    filters = block_sparse_ops.block_sparse_from_masked_weights(
+        weights.reshape(1, 1, 16, 8), mask.reshape(1, 1, 16, 8), (4, 1))
+    with self.test_session():
+      outputs = block_sparse_ops.block_sparse_conv2d_1x1(inputs, filters)
+      self.assertAllClose(
+          np.dot(inputs, weights * mask), outputs.eval(), rtol=1e-5,
+          atol=1e-5)
+
+  def testInvalidColumnPointers(self):
+    b = block_sparse_ops.BlockSparseMatrix(
+        np.ones([2, 2, 2], dtype=np.float32), [0, 1], [0, 3, 2], [4, 4])
+    with self.test_session():
+      with self.assertRaisesOpError("non-decreasing"):
+        block_sparse_ops.block_sparse_matmul(
+            np.ones([1, 4], dtype=np.float32), b).eval()
+
+  def testInvalidRowIndices(self):
+    b = block_sparse_ops.BlockSparseMatrix(
+        np.ones([1, 2, 2], dtype=np.float32), [2], [0, 1, 1], [4, 4])
+    with self.test_session():
+      with self.assertRaises(errors.InvalidArgumentError):
+        block_sparse_ops.block_sparse_matmul(
+            np.ones([1, 4], dtype=np.float32), b).eval()
+
+
+if __name__ == "__main__":
+  test.main()
@@ -0,0 +1,185 @@
+# Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""Block sparse matrices for the inference of pruned models.
+
+Pruning masks the weights of a layer, but the masked weights are still
+multiplied densely. `block_sparse_from_masked_weights` converts pruned weights
+into a `BlockSparseMatrix` holding only their non-zero blocks, and
+`block_sparse_matmul` and `block_sparse_conv2d_1x1` compute fully connected
+and 1x1 convolution layers with them, in time proportional to the number of
+non-zero blocks.
+"""
+
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import collections
+
+import numpy as np
+
+from tensorflow.contrib.model_pruning.python import pruning
+from tensorflow.contrib.util import loader
+from tensorflow.python.framework import dtypes
+from tensorflow.python.framework import ops
+from tensorflow.python.ops import array_ops
+from tensorflow.python.platform import resource_loader
+
+_block_sparse_ops = loader.load_op_library(
+    resource_loader.get_path_to_datafile("_block_sparse_ops.so"))
+
+
+class BlockSparseMatrix(
+    collections.namedtuple(
+        "BlockSparseMatrix",
+        ["values", "block_row_indices", "block_col_ptr", "dense_shape"])):
+  """A matrix in the block compressed sparse column format.
+
+  The matrix is split into blocks of `block_height` times `block_width`
+  values and only its non-zero blocks are stored, ordered by column of blocks.
+
+  Attributes:
+    values: the non-zero blocks, of shape
+      `[num_blocks, block_height, block_width]`.
+    block_row_indices: the row of blocks of each non-zero block, of shape
+      `[num_blocks]`.
+    block_col_ptr: the offsets in `values` of the blocks of each column of
+      blocks, of shape `[num_block_cols + 1]`.
+    dense_shape: the shape `[rows, cols]` of the dense matrix.
+  """
+  pass
+
+
+def block_sparse_from_masked_weights(weights, mask=None, block_shape=(1, 1)):
+  """Converts pruned weights into a `BlockSparseMatrix`.
+
+  A block is stored if any of its values is kept by the mask, so the product
+  with the returned matrix equals the product with the masked weights. The
+  block shape should be the one the weights were pruned with, for instance the
+  `block_height` and `block_width` pruning hyperparameters.
+
+  Args:
+    weights: the numpy weights of a fully connected layer, of shape
+      `[rows, cols]`, or of a 1x1 convolution, of shape `[1, 1, rows, cols]`.
+    mask: the numpy pruning mask of the weights, of the same shape. If None,
+      the zero values of the weights are pruned.
+    block_shape: the `(block_height, block_width)` of the blocks. They must
+      divide the rows and columns of the weights.
+
+  Returns:
+    A `BlockSparseMatrix` with the masked weights.
+
+  Raises:
+    ValueError: if the weights are not a matrix or a 1x1 convolution filter,
+      or if their shape is not a multiple of the block shape.
+  """
+  weights = np.asarray(weights)
+  mask = weights != 0 if mask is None else np.asarray(mask) != 0
+  if weights.ndim == 4 and weights.shape[:2] == (1, 1):
+    weights = weights.reshape(weights.shape[2:])
+    mask = mask.reshape(weights.shape)
+  if weights.ndim != 2:
+    raise ValueError("Expected a matrix or a 1x1 convolution filter, got "
+                     "weights of shape %s" % (weights.shape,))
+  rows, cols = weights.shape
+  block_height, block_width = block_shape
+  if rows % block_height or cols % block_width:
+    raise ValueError("The shape %s of the weights is not a multiple of the "
+                     "block shape %s" % (weights.shape, tuple(block_shape)))
+
+  def to_blocks(matrix):
+    # [num_block_cols, num_block_rows, block_height, block_width]
+    return matrix.reshape(rows // block_height, block_height,
+                          cols // block_width, block_width).transpose(
+                              2, 0, 1, 3)
+
+  kept = to_blocks(mask).any(axis=(2, 3))
+  values = to_blocks(weights * mask)[kept]
+  block_row_indices = np.nonzero(kept)[1].astype(np.int32)
+  block_col_ptr = np.concatenate([[0], np.cumsum(kept.sum(axis=1))])
+  return BlockSparseMatrix(values, block_row_indices,
+                           block_col_ptr.astype(np.int32),
+                           np.array([rows, cols], dtype=np.int64))
+
+
+def masked_weights_to_block_sparse(session, block_shape=(1, 1)):
+  """Converts the pruned weights of the default graph into block sparse ones.
+
+  Args:
+    session: the session holding the values of the weights and masks.
+    block_shape: the `(block_height, block_width)` of the blocks.
+
+  Returns:
+    A dict from the name of each pruned weight variable to its
+    `BlockSparseMatrix`.
+  """
+  weights = pruning.get_weights()
+  weight_values, mask_values = session.run([weights, pruning.get_masks()])
+  return {
+      weight.op.name: block_sparse_from_masked_weights(value, mask,
+                                                       block_shape)
+      for weight, value, mask in zip(weights, weight_values, mask_values)
+  }
+
+
+def block_sparse_matmul(a, b, name=None):
+  """Multiplies a dense matrix by a block sparse matrix.
+
+  Args:
+    a: a `Tensor` of shape `[m, k]`.
+    b: a `BlockSparseMatrix` of dense shape `[k, n]` and the same type as `a`.
+    name: A name for the operation (optional).
+
+  Returns:
+    The `Tensor` `a` times `b`, of shape `[m, n]`.
+  """
+  with ops.name_scope(name, "BlockSparseMatMul", [a]) as name:
+    a = ops.convert_to_tensor(a, name="a")
+    return _block_sparse_ops.block_sparse_mat_mul(
+        a,
+        ops.convert_to_tensor(b.values, dtype=a.dtype, name="b_values"),
+        ops.convert_to_tensor(
+            b.block_row_indices, dtype=dtypes.int32,
+            name="b_block_row_indices"),
+        ops.convert_to_tensor(
+            b.block_col_ptr, dtype=dtypes.int32, name="b_block_col_ptr"),
+        ops.convert_to_tensor(b.dense_shape, dtype=dtypes.int64,
+                              name="b_shape"),
+        name=name)
+
+
+def block_sparse_conv2d_1x1(inputs, filters, name=None):
+  """Computes a 1x1 convolution with stride 1 and a block sparse filter.
+
+  Args:
+    inputs: a `Tensor` of shape `[batch, height, width, in_channels]`.
+    filters: a `BlockSparseMatrix` of dense shape
+      `[in_channels, out_channels]`.
+    name: A name for the operation (optional).
+
+  Returns:
+    A `Tensor` of shape `[batch, height, width, out_channels]`.
+  """
+  with ops.name_scope(name, "BlockSparseConv2D1x1", [inputs]) as name:
+    inputs = ops.convert_to_tensor(inputs, name="inputs")
+    in_channels, out_channels = (int(dim) for dim in filters.dense_shape)
+    products = block_sparse_matmul(
+        array_ops.reshape(inputs, [-1, in_channels]), filters)
+    output_shape = array_ops.concat(
+        [array_ops.shape(inputs)[:-1], [out_channels]], 0)
+    return array_ops.reshape(products, output_shape, name=name)
+
+
+ops.NotDifferentiable("BlockSparseMatMul")
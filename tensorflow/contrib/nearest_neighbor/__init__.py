@@ -25,6 +25,14 @@ The following ops generate multiprobe sequences for various hash families.
 
 @@hyperplane_lsh_hash
 
+### Approximate nearest neighbor search
+
+The following ops build a bucketed index of points and search it.
+
+@@hyperplane_lsh_index
+@@hyperplane_lsh_search
+@@lsh_bucket_search
+
 """
 
 from __future__ import absolute_import
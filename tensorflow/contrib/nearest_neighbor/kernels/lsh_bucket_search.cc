@@ -0,0 +1,188 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <limits>
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/mutex.h"
+
+#include "tensorflow/contrib/nearest_neighbor/kernels/lsh_bucket_search.h"
+
+namespace tensorflow {
+
+using errors::InvalidArgument;
+
+using nearest_neighbor::LSHBucketSearch;
+
+// This class wraps the bucket scan in lsh_bucket_search in a TensorFlow op
+// implementation.
+template <typename CoordinateType>
+class LSHBucketSearchOp : public OpKernel {
+ public:
+  using Search = LSHBucketSearch<CoordinateType, int32>;
+
+  explicit LSHBucketSearchOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    // Get the input tensors and check their shapes.
+    const Tensor& queries_tensor = context->input(0);
+    OP_REQUIRES(context, queries_tensor.dims() == 2,
+                InvalidArgument("Need a two-dimensional queries tensor, got ",
+                                queries_tensor.dims(), " dimensions."));
+    const Tensor& points_tensor = context->input(1);
+    OP_REQUIRES(context, points_tensor.dims() == 2,
+                InvalidArgument("Need a two-dimensional points tensor, got ",
+                                points_tensor.dims(), " dimensions."));
+    OP_REQUIRES(context,
+                queries_tensor.dim_size(1) == points_tensor.dim_size(1),
+                InvalidArgument("Queries have dimension ",
+                                queries_tensor.dim_size(1),
+                                " but points have dimension ",
+                                points_tensor.dim_size(1), "."));
+    OP_REQUIRES(context,
+                points_tensor.dim_size(0) <= std::numeric_limits<int32>::max(),
+                InvalidArgument("Need at most 2^31 - 1 points, got ",
+                                points_tensor.dim_size(0), "."));
+
+    const Tensor& bucket_offsets_tensor = context->input(2);
+    OP_REQUIRES(context,
+                bucket_offsets_tensor.dims() == 2 &&
+                    bucket_offsets_tensor.dim_size(1) >= 2,
+                InvalidArgument("Need a bucket_offsets tensor of shape "
+                                "[num_tables, num_buckets + 1] with at least "
+                                "one bucket, got shape ",
+                                bucket_offsets_tensor.shape().DebugString(),
+                                "."));
+    const Tensor& point_ids_tensor = context->input(3);
+    OP_REQUIRES(context,
+                point_ids_tensor.dims() == 2 &&
+                    point_ids_tensor.dim_size(0) ==
+                        bucket_offsets_tensor.dim_size(0),
+                InvalidArgument("Need a point_ids tensor of shape "
+                                "[num_tables, num_points] with ",
+                                bucket_offsets_tensor.dim_size(0),
+                                " tables, got shape ",
+                                point_ids_tensor.shape().DebugString(), "."));
+
+    const Tensor& probes_tensor = context->input(4);
+    const Tensor& table_ids_tensor = context->input(5);
+    OP_REQUIRES(context,
+                probes_tensor.dims() == 2 &&
+                    probes_tensor.dim_size(0) == queries_tensor.dim_size(0),
+                InvalidArgument("Need a probes tensor of shape "
+                                "[batch_size, num_probes] with batch_size ",
+                                queries_tensor.dim_size(0), ", got shape ",
+                                probes_tensor.shape().DebugString(), "."));
+    OP_REQUIRES(context, table_ids_tensor.shape() == probes_tensor.shape(),
+                InvalidArgument("The table_ids tensor must have the shape of "
+                                "the probes tensor ",
+                                probes_tensor.shape().DebugString(), ", got ",
+                                table_ids_tensor.shape().DebugString(), "."));
+
+    const Tensor& k_tensor = context->input(6);
+    OP_REQUIRES(context, k_tensor.dims() == 0,
+                InvalidArgument("Need a scalar k tensor, got ",
+                                k_tensor.dims(), " dimensions."));
+    const int k = k_tensor.scalar<int32>()();
+    OP_REQUIRES(context, k >= 1,
+                InvalidArgument("k must be at least 1 but got ", k, "."));
+
+    const int64 batch_size = queries_tensor.dim_size(0);
+    const int64 dimension = queries_tensor.dim_size(1);
+    const int64 num_probes = probes_tensor.dim_size(1);
+    Tensor* ids_tensor = nullptr;
+    Tensor* scores_tensor = nullptr;
+    TensorShape output_shape({batch_size, k});
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(0, output_shape, &ids_tensor));
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(1, output_shape, &scores_tensor));
+    if (batch_size == 0) {
+      return;
+    }
+
+    typename Search::ConstMatrixMap queries(
+        queries_tensor.flat<CoordinateType>().data(), batch_size, dimension);
+    typename Search::ConstMatrixMap points(
+        points_tensor.flat<CoordinateType>().data(), points_tensor.dim_size(0),
+        dimension);
+    typename Search::ConstIndexMatrixMap bucket_offsets(
+        bucket_offsets_tensor.flat<int32>().data(),
+        bucket_offsets_tensor.dim_size(0), bucket_offsets_tensor.dim_size(1));
+    typename Search::ConstIndexMatrixMap point_ids(
+        point_ids_tensor.flat<int32>().data(), point_ids_tensor.dim_size(0),
+        point_ids_tensor.dim_size(1));
+    const int32* probes = probes_tensor.flat<int32>().data();
+    const int32* table_ids = table_ids_tensor.flat<int32>().data();
+    int32* ids = ids_tensor->flat<int32>().data();
+    CoordinateType* scores = scores_tensor->flat<CoordinateType>().data();
+
+    // Assume each probe finds about as many points as an average bucket, and
+    // each point costs an inner product and a heap comparison.
+    const int64 points_per_probe =
+        1 + point_ids.cols() / (bucket_offsets.cols() - 1);
+    const int64 cost_per_unit =
+        num_probes * points_per_probe * (2 * dimension + 10) + k * 20;
+    mutex mu;
+    Status status;
+    context->device()->tensorflow_cpu_worker_threads()->workers->ParallelFor(
+        batch_size, cost_per_unit, [&](int64 start, int64 end) {
+          Search search(points, bucket_offsets, point_ids);
+          for (int64 query_index = start; query_index < end; ++query_index) {
+            if (!search.Search(queries.row(query_index),
+                               probes + query_index * num_probes,
+                               table_ids + query_index * num_probes,
+                               num_probes, k, ids + query_index * k,
+                               scores + query_index * k)) {
+              mutex_lock l(mu);
+              status = SearchError(search.error(), query_index);
+              return;
+            }
+          }
+        });
+    OP_REQUIRES_OK(context, status);
+  }
+
+ private:
+  static Status SearchError(typename Search::Error error, int64 query_index) {
+    switch (error) {
+      case Search::Error::kInvalidProbe:
+        return InvalidArgument("Probe out of range for query ", query_index,
+                               ".");
+      case Search::Error::kInvalidBucketOffsets:
+        return InvalidArgument("Invalid bucket offsets probed for query ",
+                               query_index, ".");
+      case Search::Error::kInvalidPointId:
+        return InvalidArgument("Point id out of range probed for query ",
+                               query_index, ".");
+      default:
+        return errors::Internal("Search failed for query ", query_index, ".");
+    }
+  }
+};
+
+REGISTER_KERNEL_BUILDER(Name("LSHBucketSearch")
+                            .Device(DEVICE_CPU)
+                            .TypeConstraint<float>("CoordinateType"),
+                        LSHBucketSearchOp<float>);
+
+REGISTER_KERNEL_BUILDER(Name("LSHBucketSearch")
+                            .Device(DEVICE_CPU)
+                            .TypeConstraint<double>("CoordinateType"),
+                        LSHBucketSearchOp<double>);
+
+}  // namespace tensorflow
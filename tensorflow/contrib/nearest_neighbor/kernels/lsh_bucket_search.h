@@ -0,0 +1,177 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CONTRIB_NEAREST_NEIGHBOR_KERNELS_LSH_BUCKET_SEARCH_H_
+#define TENSORFLOW_CONTRIB_NEAREST_NEIGHBOR_KERNELS_LSH_BUCKET_SEARCH_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "third_party/eigen3/Eigen/Core"
+
+namespace tensorflow {
+namespace nearest_neighbor {
+
+// This class scans the hash buckets probed for a query (e.g., the probes
+// computed by HyperplaneMultiprobe) and returns the k candidate points with
+// the largest inner product with the query.
+//
+// The index is stored as in a compressed sparse row matrix: for each table,
+// point_ids holds a permutation of all the point ids sorted by their hash in
+// that table, and bucket_offsets holds, for each table, the num_buckets + 1
+// offsets in point_ids where the buckets start. So the points in bucket b of
+// table t are point_ids(t, bucket_offsets(t, b)) to
+// point_ids(t, bucket_offsets(t, b + 1) - 1).
+//
+// A point found in several probed buckets is only scored once. An object of
+// this class reuses its buffers across queries, so it should be used by one
+// thread at a time.
+template <typename CoordinateType, typename IndexType>
+class LSHBucketSearch {
+ public:
+  using Matrix = Eigen::Matrix<CoordinateType, Eigen::Dynamic, Eigen::Dynamic,
+                               Eigen::RowMajor>;
+  using ConstMatrixMap = Eigen::Map<const Matrix>;
+  using IndexMatrix =
+      Eigen::Matrix<IndexType, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  using ConstIndexMatrixMap = Eigen::Map<const IndexMatrix>;
+  using Vector =
+      Eigen::Matrix<CoordinateType, Eigen::Dynamic, 1, Eigen::ColMajor>;
+
+  // The error found by Search, if any.
+  enum class Error {
+    kNone,
+    kInvalidProbe,
+    kInvalidBucketOffsets,
+    kInvalidPointId,
+  };
+
+  LSHBucketSearch(const ConstMatrixMap& points,
+                  const ConstIndexMatrixMap& bucket_offsets,
+                  const ConstIndexMatrixMap& point_ids)
+      : points_(points),
+        bucket_offsets_(bucket_offsets),
+        point_ids_(point_ids),
+        scored_(points.rows(), false) {}
+
+  // Stores the ids and inner products of the k best candidates for query in
+  // ids and scores, best first. Ties are broken in favor of the lower id. If
+  // there are fewer than k candidates, the remaining ids are -1 and the
+  // remaining scores the lowest CoordinateType. probes and table_ids hold
+  // num_probes bucket and table indices. Returns false and sets error if a
+  // probe or the index is invalid.
+  template <typename QueryType>
+  bool Search(const QueryType& query, const IndexType* probes,
+              const IndexType* table_ids, int_fast64_t num_probes,
+              int_fast64_t k, IndexType* ids, CoordinateType* scores) {
+    const int_fast64_t num_tables = bucket_offsets_.rows();
+    const int_fast64_t num_buckets = bucket_offsets_.cols() - 1;
+    const int_fast64_t table_size = point_ids_.cols();
+    error_ = Error::kNone;
+    heap_.clear();
+    touched_.clear();
+    for (int_fast64_t ii = 0; ii < num_probes && error_ == Error::kNone;
+         ++ii) {
+      const IndexType table = table_ids[ii];
+      const IndexType bucket = probes[ii];
+      if (table < 0 || table >= num_tables || bucket < 0 ||
+          bucket >= num_buckets) {
+        error_ = Error::kInvalidProbe;
+        break;
+      }
+      const IndexType begin = bucket_offsets_(table, bucket);
+      const IndexType end = bucket_offsets_(table, bucket + 1);
+      if (begin < 0 || begin > end || end > table_size) {
+        error_ = Error::kInvalidBucketOffsets;
+        break;
+      }
+      for (IndexType jj = begin; jj < end; ++jj) {
+        const IndexType id = point_ids_(table, jj);
+        if (id < 0 || id >= points_.rows()) {
+          error_ = Error::kInvalidPointId;
+          break;
+        }
+        if (scored_[id]) {
+          continue;
+        }
+        scored_[id] = true;
+        touched_.push_back(id);
+        // Eigen vectorizes the inner product.
+        Consider(points_.row(id).dot(query), id, k);
+      }
+    }
+    for (IndexType id : touched_) {
+      scored_[id] = false;
+    }
+    if (error_ != Error::kNone) {
+      return false;
+    }
+
+    std::sort_heap(heap_.begin(), heap_.end(), Better);
+    const int_fast64_t num_found = heap_.size();
+    for (int_fast64_t ii = 0; ii < k; ++ii) {
+      if (ii < num_found) {
+        scores[ii] = heap_[ii].first;
+        ids[ii] = heap_[ii].second;
+      } else {
+        scores[ii] = std::numeric_limits<CoordinateType>::lowest();
+        ids[ii] = -1;
+      }
+    }
+    return true;
+  }
+
+  Error error() const { return error_; }
+
+  // The number of distinct points scored by the last call to Search.
+  int_fast64_t num_scored() const { return touched_.size(); }
+
+ private:
+  using Candidate = std::pair<CoordinateType, IndexType>;
+
+  static bool Better(const Candidate& c1, const Candidate& c2) {
+    return c1.first > c2.first ||
+           (c1.first == c2.first && c1.second < c2.second);
+  }
+
+  // Keeps the k best candidates in heap_, with the worst one on top.
+  void Consider(CoordinateType score, IndexType id, int_fast64_t k) {
+    const Candidate candidate(score, id);
+    if (static_cast<int_fast64_t>(heap_.size()) < k) {
+      heap_.push_back(candidate);
+      std::push_heap(heap_.begin(), heap_.end(), Better);
+    } else if (k > 0 && Better(candidate, heap_.front())) {
+      std::pop_heap(heap_.begin(), heap_.end(), Better);
+      heap_.back() = candidate;
+      std::push_heap(heap_.begin(), heap_.end(), Better);
+    }
+  }
+
+  ConstMatrixMap points_;
+  ConstIndexMatrixMap bucket_offsets_;
+  ConstIndexMatrixMap point_ids_;
+  std::vector<bool> scored_;
+  std::vector<IndexType> touched_;
+  std::vector<Candidate> heap_;
+  Error error_ = Error::kNone;
+};
+
+}  // namespace nearest_neighbor
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CONTRIB_NEAREST_NEIGHBOR_KERNELS_LSH_BUCKET_SEARCH_H_
@@ -0,0 +1,122 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/contrib/nearest_neighbor/kernels/lsh_bucket_search.h"
+
+#include <limits>
+#include <vector>
+
+#include "tensorflow/core/kernels/ops_testutil.h"
+
+namespace {
+
+using tensorflow::int32;
+
+typedef tensorflow::nearest_neighbor::LSHBucketSearch<float, int32> Search;
+
+// Five points in two dimensions, hashed into two tables of two buckets.
+class LSHBucketSearchTest : public ::testing::Test {
+ protected:
+  LSHBucketSearchTest()
+      : points_({1.0, 0.0,    // 0
+                 0.0, 1.0,    // 1
+                 2.0, 2.0,    // 2
+                 -1.0, 0.0,   // 3
+                 0.5, 0.5}),  // 4
+        // Table 0: bucket 0 = {3, 1}, bucket 1 = {0, 2, 4}.
+        // Table 1: bucket 0 = {3}, bucket 1 = {4, 1, 2, 0}.
+        bucket_offsets_({0, 2, 5,  //
+                         0, 1, 5}),
+        point_ids_({3, 1, 0, 2, 4,  //
+                    3, 4, 1, 2, 0}),
+        search_(Search::ConstMatrixMap(points_.data(), 5, 2),
+                Search::ConstIndexMatrixMap(bucket_offsets_.data(), 2, 3),
+                Search::ConstIndexMatrixMap(point_ids_.data(), 2, 5)) {}
+
+  bool Run(const std::vector<int32>& probes, const std::vector<int32>& tables,
+           int k) {
+    Search::Vector query(2);
+    query << 1.0, 0.5;
+    ids_.assign(k, 0);
+    scores_.assign(k, 0.0);
+    return search_.Search(query, probes.data(), tables.data(), probes.size(),
+                          k, ids_.data(), scores_.data());
+  }
+
+  std::vector<float> points_;
+  std::vector<int32> bucket_offsets_;
+  std::vector<int32> point_ids_;
+  Search search_;
+  std::vector<int32> ids_;
+  std::vector<float> scores_;
+};
+
+TEST_F(LSHBucketSearchTest, SingleBucket) {
+  ASSERT_TRUE(Run({1}, {0}, 2));
+  EXPECT_EQ(std::vector<int32>({2, 0}), ids_);
+  EXPECT_EQ(std::vector<float>({3.0, 1.0}), scores_);
+  EXPECT_EQ(3, search_.num_scored());
+}
+
+TEST_F(LSHBucketSearchTest, MergesBucketsAcrossTables) {
+  // Most points are in several of the probed buckets but only scored once.
+  ASSERT_TRUE(Run({1, 0, 1}, {1, 0, 0}, 5));
+  EXPECT_EQ(std::vector<int32>({2, 0, 4, 1, 3}), ids_);
+  EXPECT_EQ(std::vector<float>({3.0, 1.0, 0.75, 0.5, -1.0}), scores_);
+  EXPECT_EQ(5, search_.num_scored());
+}
+
+TEST_F(LSHBucketSearchTest, PadsMissingCandidates) {
+  ASSERT_TRUE(Run({0}, {1}, 3));
+  EXPECT_EQ(std::vector<int32>({3, -1, -1}), ids_);
+  EXPECT_EQ(-1.0, scores_[0]);
+  EXPECT_EQ(std::numeric_limits<float>::lowest(), scores_[1]);
+  EXPECT_EQ(std::numeric_limits<float>::lowest(), scores_[2]);
+}
+
+TEST_F(LSHBucketSearchTest, BreaksTiesByLowerId) {
+  // Points 0, 1 and 4 have the same inner product with (1, 1).
+  Search::Vector query(2);
+  query << 1.0, 1.0;
+  const std::vector<int32> probes = {0, 1};
+  const std::vector<int32> tables = {0, 0};
+  std::vector<int32> ids(3);
+  std::vector<float> scores(3);
+  ASSERT_TRUE(search_.Search(query, probes.data(), tables.data(), 2, 3,
+                             ids.data(), scores.data()));
+  EXPECT_EQ(std::vector<int32>({2, 0, 1}), ids);
+}
+
+TEST_F(LSHBucketSearchTest, RejectsInvalidProbes) {
+  EXPECT_FALSE(Run({2}, {0}, 1));
+  EXPECT_EQ(Search::Error::kInvalidProbe, search_.error());
+  EXPECT_FALSE(Run({0}, {2}, 1));
+  EXPECT_EQ(Search::Error::kInvalidProbe, search_.error());
+  // The search still works after an error.
+  EXPECT_TRUE(Run({0}, {1}, 1));
+  EXPECT_EQ(std::vector<int32>({3}), ids_);
+}
+
+TEST_F(LSHBucketSearchTest, RejectsInvalidIndex) {
+  bucket_offsets_[1] = 6;
+  EXPECT_FALSE(Run({1}, {0}, 1));
+  EXPECT_EQ(Search::Error::kInvalidBucketOffsets, search_.error());
+  bucket_offsets_[1] = 2;
+  point_ids_[0] = 5;
+  EXPECT_FALSE(Run({0}, {0}, 1));
+  EXPECT_EQ(Search::Error::kInvalidPointId, search_.error());
+}
+
+}  // namespace
@@ -46,4 +46,46 @@ probes: the output matrix of probes. Size `batch_size` times `num_probes`.
 table_ids: the output matrix of tables ids. Size `batch_size` times `num_probes`.
 )doc");
 
+REGISTER_OP("LSHBucketSearch")
+    .Attr("CoordinateType: {float, double}")
+    .Input("queries: CoordinateType")
+    .Input("points: CoordinateType")
+    .Input("bucket_offsets: int32")
+    .Input("point_ids: int32")
+    .Input("probes: int32")
+    .Input("table_ids: int32")
+    .Input("k: int32")
+    .Output("ids: int32")
+    .Output("scores: CoordinateType")
+    .Doc(R"doc(
+Finds the points with the largest inner products in the probed hash buckets.
+
+For each query, scans the points in the buckets given by `probes` and
+`table_ids` (e.g., the output of `HyperplaneLSHProbes`), scores each distinct
+point once by its inner product with the query and returns the `k` best
+candidates, best first. Ties are broken in favor of the lower point id.
+
+The index is stored as in a compressed sparse row matrix: row `t` of
+`point_ids` holds all the point ids sorted by their hash in table `t`, and
+the points in bucket `b` of table `t` are
+`point_ids[t, bucket_offsets[t, b]:bucket_offsets[t, b + 1]]`.
+
+queries: the query points. Size `batch_size` times `dimension`.
+points: the indexed points. Size `num_points` times `dimension`.
+bucket_offsets: the offsets of the buckets in `point_ids`. Size `num_tables`
+  times `num_buckets + 1`.
+point_ids: the point ids sorted by bucket. Size `num_tables` times
+  `num_points`.
+probes: the buckets to scan for each query. Size `batch_size` times
+  `num_probes`.
+table_ids: the tables of the buckets to scan. Size `batch_size` times
+  `num_probes`.
+k: the number of candidates to return for each query.
+ids: the ids of the best candidates. Size `batch_size` times `k`. If fewer than
+  `k` points were found, the remaining ids are -1.
+scores: the inner products of the best candidates with the queries. Size
+  `batch_size` times `k`. If fewer than `k` points were found, the remaining
+  scores are the lowest value of `CoordinateType`.
+)doc");
+
 }  // namespace tensorflow
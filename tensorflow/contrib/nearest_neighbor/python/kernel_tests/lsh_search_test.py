@@ -0,0 +1,97 @@
+# Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+"""Tests for the LSH index and bucket search ops."""
+
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import numpy as np
+
+from tensorflow.contrib.nearest_neighbor.python.ops import nearest_neighbor_ops
+from tensorflow.python.platform import test
+
+
+class LshSearchTest(test.TestCase):
+
+  def testIndex(self):
+    with self.test_session():
+      hyperplanes = np.eye(2)
+      points = np.array([[1.0, 1.0], [-1.0, 1.0], [1.0, -1.0], [2.0, 3.0]])
+      # One table per hyperplane. The hashes are [1, 0, 1, 1] in table 0 and
+      # [1, 1, 0, 1] in table 1.
+      bucket_offsets, point_ids = nearest_neighbor_ops.hyperplane_lsh_index(
+          points, hyperplanes, num_tables=2, num_hyperplanes_per_table=1)
+      self.assertAllEqual([[0, 1, 4], [0, 1, 4]], bucket_offsets.eval())
+      self.assertAllEqual([[1, 0, 2, 3], [2, 0, 1, 3]], point_ids.eval())
+
+  def testSearchAllBucketsIsExact(self):
+    num_tables = 1
+    num_hyperplanes_per_table = 3
+    k = 5
+    np.random.seed(0)
+    points = np.random.randn(200, 8).astype(np.float32)
+    queries = np.random.randn(10, 8).astype(np.float32)
+    hyperplanes = np.random.randn(
+        8, num_tables * num_hyperplanes_per_table).astype(np.float32)
+    with self.test_session():
+      bucket_offsets, point_ids = nearest_neighbor_ops.hyperplane_lsh_index(
+          points, hyperplanes, num_tables, num_hyperplanes_per_table)
+      # Probing every bucket of the table scans all the points.
+      ids, scores = nearest_neighbor_ops.hyperplane_lsh_search(
+          queries, points, hyperplanes, bucket_offsets, point_ids, num_tables,
+          num_hyperplanes_per_table, 2**num_hyperplanes_per_table, k)
+      ids, scores = ids.eval(), scores.eval()
+
+    products = np.dot(queries, points.T)
+    expected_ids = np.argsort(-products, axis=1)[:, :k]
+    self.assertAllEqual(expected_ids, ids)
+    self.assertAllClose(np.sort(products, axis=1)[:, ::-1][:, :k], scores)
+
+  def testSearchFindsPointsInProbedBuckets(self):
+    with self.test_session():
+      points = np.array([[1.0, 0.0], [0.0, 1.0], [2.0, 2.0], [-1.0, 0.0]])
+      # Table 0: bucket 0 = {3}, bucket 1 = {0, 1, 2}.
+      bucket_offsets = np.array([[0, 1, 4]], dtype=np.int32)
+      point_ids = np.array([[3, 0, 1, 2]], dtype=np.int32)
+      ids, scores = nearest_neighbor_ops.lsh_bucket_search(
+          queries=np.array([[1.0, 0.5], [-1.0, 0.0]]),
+          points=points,
+          bucket_offsets=bucket_offsets,
+          point_ids=point_ids,
+          probes=[[1], [0]],
+          table_ids=[[0], [0]],
+          k=2)
+      self.assertAllEqual([[2, 0], [3, -1]], ids.eval())
+      self.assertAllClose([3.0, 1.0], scores.eval()[0])
+      self.assertAllClose(1.0, scores.eval()[1, 0])
+
+  def testSearchRejectsInvalidProbes(self):
+    with self.test_session():
+      ids, _ = nearest_neighbor_ops.lsh_bucket_search(
+          queries=np.zeros([1, 2]),
+          points=np.zeros([3, 2]),
+          bucket_offsets=np.array([[0, 1, 3]], dtype=np.int32),
+          point_ids=np.array([[0, 1, 2]], dtype=np.int32),
+          probes=[[2]],
+          table_ids=[[0]],
+          k=1)
+      with self.assertRaisesOpError("Probe out of range for query 0"):
+        ids.eval()
+
+
+if __name__ == '__main__':
+  test.main()
@@ -19,7 +19,11 @@ from __future__ import division
 from __future__ import print_function
 
 from tensorflow.contrib.util import loader
+from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import ops
+from tensorflow.python.ops import array_ops
+from tensorflow.python.ops import math_ops
+from tensorflow.python.ops import nn_ops
 from tensorflow.python.platform import resource_loader
 
 _nearest_neighbor_ops = loader.load_op_library(
@@ -62,3 +66,152 @@ def hyperplane_lsh_probes(point_hyperplane_product,
                                                      name=name)
 
 ops.NotDifferentiable("HyperplaneLSHProbes")
+
+
+def lsh_bucket_search(queries,
+                      points,
+                      bucket_offsets,
+                      point_ids,
+                      probes,
+                      table_ids,
+                      k,
+                      name=None):
+  """Finds the points with the largest inner products in the probed buckets.
+
+  For each query, scans the points in the buckets given by `probes` and
+  `table_ids`, scores each distinct point once by its inner product with the
+  query and returns the `k` best candidates, best first.
+
+  Args:
+    queries: the query points. Size `batch_size` times `dimension`.
+    points: the indexed points. Size `num_points` times `dimension`.
+    bucket_offsets: the offsets of the buckets in `point_ids`, as returned by
+      `hyperplane_lsh_index`. Size `num_tables` times `num_buckets + 1`.
+    point_ids: the point ids sorted by bucket, as returned by
+      `hyperplane_lsh_index`. Size `num_tables` times `num_points`.
+    probes: the buckets to scan for each query. Size `batch_size` times
+      `num_probes`.
+    table_ids: the tables of the buckets to scan. Size `batch_size` times
+      `num_probes`.
+    k: the number of candidates to return for each query.
+    name: A name prefix for the returned tensors (optional).
+
+  Returns:
+    ids: the ids of the best candidates. Size `batch_size` times `k`. If fewer
+      than `k` points were found, the remaining ids are -1.
+    scores: the inner products of the best candidates with the queries. Size
+      `batch_size` times `k`.
+  """
+  return _nearest_neighbor_ops.lsh_bucket_search(queries,
+                                                 points,
+                                                 bucket_offsets,
+                                                 point_ids,
+                                                 probes,
+                                                 table_ids,
+                                                 k,
+                                                 name=name)
+
+ops.NotDifferentiable("LSHBucketSearch")
+
+
+def hyperplane_lsh_index(points,
+                         hyperplanes,
+                         num_tables,
+                         num_hyperplanes_per_table,
+                         name=None):
+  """Builds a hyperplane LSH index of points for `lsh_bucket_search`.
+
+  The hash of a point in a table has one bit per hyperplane of the table, set
+  when the inner product of the point with the hyperplane is non-negative. The
+  first hyperplane of the table gives the most significant bit, as in
+  `hyperplane_lsh_probes`.
+
+  Args:
+    points: the points to index. Size `num_points` times `dimension`.
+    hyperplanes: the hyperplanes of all the tables, one per column. Size
+      `dimension` times `num_tables * num_hyperplanes_per_table`.
+    num_tables: Python int, the number of tables.
+    num_hyperplanes_per_table: Python int, the number of hyperplanes per table.
+    name: A name prefix for the returned tensors (optional).
+
+  Returns:
+    bucket_offsets: Size `num_tables` times
+      `2**num_hyperplanes_per_table + 1`. The points in bucket `b` of table `t`
+      are `point_ids[t, bucket_offsets[t, b]:bucket_offsets[t, b + 1]]`.
+    point_ids: the point ids sorted by their hash in each table. Size
+      `num_tables` times `num_points`.
+
+  Raises:
+    ValueError: if `num_hyperplanes_per_table` is not between 1 and 30.
+  """
+  if not 1 <= num_hyperplanes_per_table <= 30:
+    raise ValueError("num_hyperplanes_per_table must be between 1 and 30, "
+                     "got %d." % num_hyperplanes_per_table)
+  num_buckets = 1 << num_hyperplanes_per_table
+  with ops.name_scope(name, "HyperplaneLSHIndex", [points, hyperplanes]):
+    products = math_ops.matmul(points, hyperplanes)
+    bits = math_ops.cast(products >= 0, dtypes.int32)
+    bits = array_ops.reshape(bits,
+                             [-1, num_tables, num_hyperplanes_per_table])
+    bit_values = [1 << (num_hyperplanes_per_table - 1 - i)
+                  for i in range(num_hyperplanes_per_table)]
+    # Size num_tables times num_points.
+    hashes = array_ops.transpose(math_ops.reduce_sum(bits * bit_values, 2))
+
+    # top_k puts equal values in index order, so this is a stable sort.
+    num_points = array_ops.shape(points)[0]
+    _, point_ids = nn_ops.top_k(-hashes, k=num_points)
+
+    table_starts = array_ops.expand_dims(
+        math_ops.range(num_tables) * num_buckets, 1)
+    bucket_sizes = math_ops.unsorted_segment_sum(
+        array_ops.ones_like(hashes), hashes + table_starts,
+        num_tables * num_buckets)
+    bucket_sizes = array_ops.reshape(bucket_sizes, [num_tables, num_buckets])
+    bucket_offsets = array_ops.concat(
+        [array_ops.zeros([num_tables, 1], dtype=dtypes.int32),
+         math_ops.cumsum(bucket_sizes, axis=1)], 1)
+    return bucket_offsets, point_ids
+
+
+def hyperplane_lsh_search(queries,
+                          points,
+                          hyperplanes,
+                          bucket_offsets,
+                          point_ids,
+                          num_tables,
+                          num_hyperplanes_per_table,
+                          num_probes,
+                          k,
+                          name=None):
+  """Finds approximate maximum inner product neighbors with hyperplane LSH.
+
+  Projects the whole batch of queries onto the hyperplanes with a single
+  matmul, computes `num_probes` multiprobe buckets per query with
+  `hyperplane_lsh_probes` and scans them with `lsh_bucket_search`.
+
+  Args:
+    queries: the query points. Size `batch_size` times `dimension`.
+    points: the indexed points. Size `num_points` times `dimension`.
+    hyperplanes: the hyperplanes the index was built with.
+    bucket_offsets: the bucket offsets returned by `hyperplane_lsh_index`.
+    point_ids: the point ids returned by `hyperplane_lsh_index`.
+    num_tables: the number of tables.
+    num_hyperplanes_per_table: the number of hyperplanes per table.
+    num_probes: the number of buckets to scan per query.
+    k: the number of candidates to return for each query.
+    name: A name prefix for the returned tensors (optional).
+
+  Returns:
+    ids: the ids of the best candidates. Size `batch_size` times `k`. If fewer
+      than `k` points were found, the remaining ids are -1.
+    scores: the inner products of the best candidates with the queries. Size
+      `batch_size` times `k`.
+  """
+  with ops.name_scope(name, "HyperplaneLSHSearch",
+                      [queries, points, hyperplanes]):
+    products = math_ops.matmul(queries, hyperplanes)
+    probes, table_ids = hyperplane_lsh_probes(
+        products, num_tables, num_hyperplanes_per_table, num_probes)
+    return lsh_bucket_search(queries, points, bucket_offsets, point_ids,
+                             probes, table_ids, k)
@@ -21,6 +21,10 @@ limitations under the License.
 #include "tensorflow/core/kernels/eigen_activations.h"
 #include "tensorflow/core/platform/types.h"
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/kernels/sycl_blas_utils.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace tensorflow {
 class OpKernelContext;
 namespace functor {
@@ -71,6 +75,42 @@ struct TensorBlasGemm<Device, T, false /* USE_CUBLAS */> {
   }
 };
 
+#ifdef TENSORFLOW_USE_SYCL
+// Eigen contractions are slow on SYCL devices, so the product runs as a
+// sycl-blas GEMM instead. sycl-blas is column major like cuBLAS, so the
+// arguments are swapped in the same way.
+template <typename T>
+struct TensorBlasGemm<Eigen::SyclDevice, T, false /* USE_CUBLAS */> {
+  static void compute(OpKernelContext* ctx, const Eigen::SyclDevice& d,
+                      bool transa, bool transb, T alpha,
+                      typename TTypes<T>::ConstMatrix a,
+                      typename TTypes<T>::ConstMatrix b, T beta,
+                      typename TTypes<T>::Matrix c) {
+    int64 m = c.dimensions()[0];
+    int64 n = c.dimensions()[1];
+    int64 k = transa ? a.dimensions()[0] : a.dimensions()[1];
+    if (m == 0 || n == 0) {
+      return;
+    }
+    if (k == 0) {
+      if (beta == T(0)) {
+        c.device(d) = c.constant(T(0));
+      } else {
+        c.device(d) = c * c.constant(beta);
+      }
+      return;
+    }
+
+    auto ex_handle = AcquireSYCLBlasExecutor(d);
+    SYCLBlasExecutor& ex = *ex_handle;
+    blas::_gemm(ex, transb ? 't' : 'n', transa ? 't' : 'n', n, m, k, alpha,
+                get_buffer_iterator<T>(d, b.data()), transb ? k : n,
+                get_buffer_iterator<T>(d, a.data()), transa ? m : k, beta,
+                get_buffer_iterator<T>(d, c.data()), n);
+  }
+};
+#endif  // TENSORFLOW_USE_SYCL
+
 }  // namespace functor
 }  // namespace tensorflow
 
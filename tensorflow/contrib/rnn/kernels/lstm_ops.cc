@@ -34,6 +34,10 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/contrib/rnn/kernels/lstm_ops_sycl.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
@@ -99,13 +103,7 @@ void LSTMBlockCellFpropWithEigen(
   }
 
   // cs = ci .* i + f .* cs_prev
-//TODO(codeplay): investigate more why this is needed on some device
-#ifdef TENSORFLOW_USE_SYCL
-  cs.device(d) = cs_prev;
-  cs.device(d) = cs * f + i * ci;
-#else
   cs.device(d) = i * ci + f * cs_prev;
-#endif  // TENSORFLOW_USE_SYCL
 
   if (cell_clip > 0.0f) {
     cs.device(d) =
@@ -186,7 +184,7 @@ void LSTMBlockCellBpropWithEigen(
   }
 }
 
-#define DEFINE_SPECS(DEVICE, T)                                                \
+#define DEFINE_SPECS(DEVICE, T, IMPL)                                          \
   template <>                                                                  \
   void LSTMBlockCellFprop<DEVICE, T, false /* USE_CUBLAS */>::operator()(      \
       OpKernelContext* ctx, const DEVICE& d, const T forget_bias,              \
@@ -200,7 +198,7 @@ void LSTMBlockCellBpropWithEigen(
       typename TTypes<T>::Matrix f, typename TTypes<T>::Matrix o,              \
       typename TTypes<T>::Matrix ci, typename TTypes<T>::Matrix co,            \
       typename TTypes<T>::Matrix icfo, typename TTypes<T>::Matrix h) {         \
-    LSTMBlockCellFpropWithEigen<DEVICE, T>(                                    \
+    LSTMBlockCellFprop##IMPL<DEVICE, T>(                                       \
         *this, ctx, d, forget_bias, cell_clip, use_peephole, x, cs_prev,       \
         h_prev, w, wci, wcf, wco, b, xh, i, cs, f, o, ci, co, icfo, h);        \
   }                                                                            \
@@ -224,7 +222,7 @@ void LSTMBlockCellBpropWithEigen(
       typename TTypes<T>::Matrix cs_prev_grad,                                 \
       typename TTypes<T>::Vec wci_grad, typename TTypes<T>::Vec wcf_grad,      \
       typename TTypes<T>::Vec wco_grad) {                                      \
-    LSTMBlockCellBpropWithEigen<DEVICE, T, false /* USE_CUBLAS */>(            \
+    LSTMBlockCellBprop##IMPL<DEVICE, T, false /* USE_CUBLAS */>(               \
         *this, ctx, d, use_peephole, x, cs_prev, h_prev, w, wci, wcf, wco, b,  \
         i, cs, f, o, ci, co, cs_grad, h_grad, do_, dcs, dci, df, di, dicfo,    \
         cs_prev_grad, wci_grad, wcf_grad, wco_grad);                           \
@@ -232,9 +230,9 @@ void LSTMBlockCellBpropWithEigen(
   template struct LSTMBlockCellFprop<DEVICE, T, false /* USE_CUBLAS */>;       \
   template struct LSTMBlockCellBprop<DEVICE, T, false /* USE_CUBLAS */>;
 
-DEFINE_SPECS(CPUDevice, float);
+DEFINE_SPECS(CPUDevice, float, WithEigen);
 #ifdef TENSORFLOW_USE_SYCL
-DEFINE_SPECS(SYCLDevice, float);
+DEFINE_SPECS(SYCLDevice, float, SYCL);
 #endif  // TENSORFLOW_USE_SYCL
 #undef DEFINE_SPECS
 
@@ -1403,4 +1401,560 @@ REGISTER_GPU_KERNEL(float);
 #undef REGISTER_GPU_KERNEL
 #endif  // GOOGLE_CUDA
 
+
+namespace {
+
+// Checks that sequence_length holds one length in [0, timelen] per example and
+// that the batch is sorted by non-increasing length.
+Status ValidateSortedSequenceLength(const Tensor& sequence_length,
+                                    int64 batch_size, int64 timelen) {
+  if (!TensorShapeUtils::IsVector(sequence_length.shape()) ||
+      sequence_length.dim_size(0) != batch_size) {
+    return errors::InvalidArgument(
+        "sequence_length must be a vector of batch_size ", batch_size,
+        " lengths but is ", sequence_length.shape().DebugString());
+  }
+  const auto lengths = sequence_length.vec<int64>();
+  for (int64 b = 0; b < batch_size; ++b) {
+    if (lengths(b) < 0 || lengths(b) > timelen) {
+      return errors::InvalidArgument("sequence_length(", b, ") = ", lengths(b),
+                                     " is not in [0, ", timelen, "]");
+    }
+    if (b > 0 && lengths(b) > lengths(b - 1)) {
+      return errors::InvalidArgument(
+          "sequence_length must be sorted in non-increasing order, but "
+          "sequence_length(",
+          b, ") = ", lengths(b), " > sequence_length(", b - 1,
+          ") = ", lengths(b - 1));
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+// BlockLSTM over a batch sorted by decreasing sequence length. As the
+// sequences end the later time steps run on an ever smaller prefix of the
+// batch, instead of computing the padding of the shorter sequences.
+template <typename Device, typename T, bool USE_CUBLAS>
+class SortedBlockLSTMOp : public OpKernel {
+ public:
+  explicit SortedBlockLSTMOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("forget_bias", &forget_bias_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("cell_clip", &cell_clip_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_peephole", &use_peephole_));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    const Tensor* sequence_length_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("sequence_length", &sequence_length_tensor));
+
+    const Tensor* x;
+    OP_REQUIRES_OK(ctx, ctx->input("x", &x));
+    OP_REQUIRES(ctx, x->dims() == 3, errors::InvalidArgument("x must be 3D"));
+    const int64 timelen = x->dim_size(0);
+    const int64 batch_size = x->dim_size(1);
+    const int64 input_size = x->dim_size(2);
+    OP_REQUIRES_OK(ctx, ValidateSortedSequenceLength(*sequence_length_tensor,
+                                                     batch_size, timelen));
+
+    const Tensor* cs_prev_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("cs_prev", &cs_prev_tensor));
+    OP_REQUIRES(ctx, cs_prev_tensor->dims() == 2,
+                errors::InvalidArgument("cs_prev must be 2D"));
+    OP_REQUIRES(ctx, cs_prev_tensor->dim_size(0) == batch_size,
+                errors::InvalidArgument("cs_prev.dims(0) != batch_size: ",
+                                        cs_prev_tensor->dim_size(0), " vs. ",
+                                        batch_size));
+    const int64 cell_size = cs_prev_tensor->dim_size(1);
+
+    const Tensor* h_prev_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("h_prev", &h_prev_tensor));
+    OP_REQUIRES(ctx, h_prev_tensor->shape() == cs_prev_tensor->shape(),
+                errors::InvalidArgument(
+                    "h_prev and cs_prev shapes don't match: ",
+                    h_prev_tensor->shape().DebugString(), " vs. ",
+                    cs_prev_tensor->shape().DebugString()));
+
+    const Tensor* w_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("w", &w_tensor));
+    OP_REQUIRES(ctx, w_tensor->dims() == 2,
+                errors::InvalidArgument("w must be 2D"));
+    OP_REQUIRES(ctx, w_tensor->dim_size(0) == input_size + cell_size,
+                errors::InvalidArgument(
+                    "w.dim_size(0) != input_size + cell_size: ",
+                    w_tensor->dim_size(0), " vs. ", input_size + cell_size));
+    OP_REQUIRES(ctx, w_tensor->dim_size(1) == cell_size * 4,
+                errors::InvalidArgument(
+                    "w.dim_size(1) != cell_size * 4: ", w_tensor->dim_size(1),
+                    " vs. ", cell_size * 4));
+
+    const Tensor* wci_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("wci", &wci_tensor));
+    const Tensor* wcf_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("wcf", &wcf_tensor));
+    const Tensor* wco_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("wco", &wco_tensor));
+    for (const Tensor* peephole : {wci_tensor, wcf_tensor, wco_tensor}) {
+      OP_REQUIRES(ctx,
+                  peephole->dims() == 1 && peephole->dim_size(0) == cell_size,
+                  errors::InvalidArgument(
+                      "peephole weights must be vectors of cell_size ",
+                      cell_size, ": ", peephole->shape().DebugString()));
+    }
+
+    const Tensor* b_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("b", &b_tensor));
+    OP_REQUIRES(ctx, b_tensor->dims() == 1,
+                errors::InvalidArgument("b must be 1D"));
+    OP_REQUIRES(ctx, b_tensor->dim_size(0) == cell_size * 4,
+                errors::InvalidArgument(
+                    "b.dim_size(0) != cell_size * 4: ", b_tensor->dim_size(0),
+                    " vs. ", cell_size * 4));
+
+    TensorShape batch_cell_shape({timelen, batch_size, cell_size});
+    Tensor* i_out;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output("i", batch_cell_shape, &i_out));
+
+    Tensor* cs_out;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output("cs", batch_cell_shape, &cs_out));
+
+    Tensor* f_out;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output("f", batch_cell_shape, &f_out));
+
+    Tensor* o_out;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output("o", batch_cell_shape, &o_out));
+
+    Tensor* ci_out;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output("ci", batch_cell_shape, &ci_out));
+
+    Tensor* co_out;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output("co", batch_cell_shape, &co_out));
+
+    Tensor* h_out;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output("h", batch_cell_shape, &h_out));
+
+    Tensor xh_tensor;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(
+                            DataTypeToEnum<T>::v(),
+                            TensorShape({batch_size, input_size + cell_size}),
+                            &xh_tensor));
+
+    Tensor icfo_tensor;
+    OP_REQUIRES_OK(ctx,
+                   ctx->allocate_temp(DataTypeToEnum<T>::v(),
+                                      TensorShape({batch_size, cell_size * 4}),
+                                      &icfo_tensor));
+
+    const Device& device = ctx->eigen_device<Device>();
+
+    const auto sequence_length = sequence_length_tensor->vec<int64>();
+    const int64 seq_len_max = batch_size > 0 ? sequence_length(0) : 0;
+    int64 active = batch_size;
+    SliceHelper<Device, T> slicer(ctx);
+    for (int64 t = 0; t < seq_len_max; ++t) {
+      // The examples still running are a prefix of the batch, so every operand
+      // of the step is a row slice starting at the (aligned) slice of step t.
+      while (sequence_length(active - 1) <= t) --active;
+
+      const Tensor x_tensor = slicer.InputSlice(*x, t, "x").Slice(0, active);
+      const Tensor cs_prev_tensor2 =
+          (t == 0 ? *cs_prev_tensor
+                  : slicer.OutputSlice(cs_out, t - 1, "cs_prev"))
+              .Slice(0, active);
+      const Tensor h_prev_tensor2 =
+          (t == 0 ? *h_prev_tensor
+                  : slicer.OutputSlice(h_out, t - 1, "h_prev"))
+              .Slice(0, active);
+
+      Tensor i_tensor = slicer.OutputSlice(i_out, t, "i_out");
+      Tensor cs_tensor = slicer.OutputSlice(cs_out, t, "cs_out");
+      Tensor f_tensor = slicer.OutputSlice(f_out, t, "f_out");
+      Tensor o_tensor = slicer.OutputSlice(o_out, t, "o_out");
+      Tensor ci_tensor = slicer.OutputSlice(ci_out, t, "ci_out");
+      Tensor co_tensor = slicer.OutputSlice(co_out, t, "co_out");
+      Tensor h_tensor = slicer.OutputSlice(h_out, t, "h_out");
+      Tensor xh_active = xh_tensor.Slice(0, active);
+      Tensor icfo_active = icfo_tensor.Slice(0, active);
+
+      functor::LSTMBlockCellFprop<Device, T, USE_CUBLAS>(active, input_size,
+                                                         cell_size)(
+          ctx, device, forget_bias_, cell_clip_, use_peephole_,
+          x_tensor.matrix<T>(), cs_prev_tensor2.matrix<T>(),
+          h_prev_tensor2.matrix<T>(), w_tensor->matrix<T>(),
+          wci_tensor->vec<T>(), wcf_tensor->vec<T>(), wco_tensor->vec<T>(),
+          b_tensor->vec<T>(), xh_active.matrix<T>(),
+          i_tensor.Slice(0, active).matrix<T>(),
+          cs_tensor.Slice(0, active).matrix<T>(),
+          f_tensor.Slice(0, active).matrix<T>(),
+          o_tensor.Slice(0, active).matrix<T>(),
+          ci_tensor.Slice(0, active).matrix<T>(),
+          co_tensor.Slice(0, active).matrix<T>(), icfo_active.matrix<T>(),
+          h_tensor.Slice(0, active).matrix<T>());
+
+      if (active < batch_size) {
+        // Zeroed before FinishTimeStep, which copies unaligned slices back.
+        Tensor cs_ended = cs_tensor.Slice(active, batch_size);
+        Tensor h_ended = h_tensor.Slice(active, batch_size);
+        functor::TensorUnalignedZero<Device, T>()(
+            device, cs_ended.unaligned_flat<T>());
+        functor::TensorUnalignedZero<Device, T>()(
+            device, h_ended.unaligned_flat<T>());
+      }
+      slicer.FinishTimeStep();
+    }
+
+    if (seq_len_max < timelen) {
+      Tensor cs_tensor = cs_out->Slice(seq_len_max, timelen);
+      Tensor h_tensor = h_out->Slice(seq_len_max, timelen);
+
+      functor::TensorUnalignedZero<Device, T>()(
+          device, cs_tensor.unaligned_flat<T>());
+      functor::TensorUnalignedZero<Device, T>()(device,
+                                                h_tensor.unaligned_flat<T>());
+    }
+  }
+
+ private:
+  float forget_bias_;
+  float cell_clip_;
+  bool use_peephole_;
+};
+
+#define REGISTER_KERNEL(T)                                               \
+  REGISTER_KERNEL_BUILDER(                                               \
+      Name("SortedBlockLSTM").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      SortedBlockLSTMOp<CPUDevice, T, false>);
+REGISTER_KERNEL(float);
+// REGISTER_KERNEL(double);
+#undef REGISTER_KERNEL
+
+#ifdef TENSORFLOW_USE_SYCL
+#define REGISTER_KERNEL(T)                                          \
+  REGISTER_KERNEL_BUILDER(Name("SortedBlockLSTM")                   \
+                              .Device(DEVICE_SYCL)                  \
+                              .HostMemory("sequence_length")        \
+                              .TypeConstraint<T>("T"),              \
+                          SortedBlockLSTMOp<SYCLDevice, T, false>);
+REGISTER_KERNEL(float);
+// REGISTER_KERNEL(double);
+#undef REGISTER_KERNEL
+#endif  // TENSORFLOW_USE_SYCL
+
+#if GOOGLE_CUDA
+#define REGISTER_GPU_KERNEL(T)                               \
+  REGISTER_KERNEL_BUILDER(Name("SortedBlockLSTM")            \
+                              .Device(DEVICE_GPU)            \
+                              .HostMemory("sequence_length") \
+                              .TypeConstraint<T>("T"),       \
+                          SortedBlockLSTMOp<GPUDevice, T, true>);
+
+REGISTER_GPU_KERNEL(float);
+// REGISTER_GPU_KERNEL(double);
+#undef REGISTER_GPU_KERNEL
+#endif  // GOOGLE_CUDA
+
+template <typename Device, typename T, bool USE_CUBLAS>
+class SortedBlockLSTMGradOp : public OpKernel {
+ public:
+  explicit SortedBlockLSTMGradOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_peephole", &use_peephole_));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    const Tensor* sequence_length_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("sequence_length", &sequence_length_tensor));
+
+    const Tensor* x;
+    OP_REQUIRES_OK(ctx, ctx->input("x", &x));
+    OP_REQUIRES(ctx, x->dims() == 3, errors::InvalidArgument("x must be 3D"));
+    const int64 timelen = x->dim_size(0);
+    const int64 batch_size = x->dim_size(1);
+    const int64 input_size = x->dim_size(2);
+    OP_REQUIRES_OK(ctx, ValidateSortedSequenceLength(*sequence_length_tensor,
+                                                     batch_size, timelen));
+
+    const Tensor* cs_prev_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("cs_prev", &cs_prev_tensor));
+
+    const Tensor* h_prev_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("h_prev", &h_prev_tensor));
+
+    const Tensor* w_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("w", &w_tensor));
+    const int64 cell_size = w_tensor->dim_size(1) / 4;
+    OP_REQUIRES(ctx, input_size + cell_size == w_tensor->dim_size(0),
+                errors::InvalidArgument(
+                    "w matrix rows don't match: ", input_size + cell_size,
+                    " vs. ", w_tensor->dim_size(0)));
+
+    const Tensor* wci_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("wci", &wci_tensor));
+
+    const Tensor* wcf_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("wcf", &wcf_tensor));
+
+    const Tensor* wco_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("wco", &wco_tensor));
+
+    const Tensor* b_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("b", &b_tensor));
+    OP_REQUIRES(
+        ctx, cell_size == b_tensor->dim_size(0) / 4,
+        errors::InvalidArgument("w and b cell_size don't match: ", cell_size,
+                                " vs. ", b_tensor->dim_size(0)));
+
+    const Tensor* i_out = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("i", &i_out));
+
+    const Tensor* cs_out = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("cs", &cs_out));
+
+    const Tensor* f_out = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("f", &f_out));
+
+    const Tensor* o_out = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("o", &o_out));
+
+    const Tensor* ci_out = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("ci", &ci_out));
+
+    const Tensor* co_out = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("co", &co_out));
+
+    const Tensor* h_out = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("h", &h_out));
+
+    const Tensor* cs_grad = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("cs_grad", &cs_grad));
+
+    const Tensor* h_grad = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("h_grad", &h_grad));
+
+    TensorShape batch_input_shape({timelen, batch_size, input_size});
+    Tensor* x_grad;
+    OP_REQUIRES_OK(ctx,
+                   ctx->allocate_output("x_grad", batch_input_shape, &x_grad));
+
+    Tensor* cs_prev_grad_tensor = nullptr;
+    OP_REQUIRES_OK(ctx,
+                   ctx->allocate_output("cs_prev_grad", cs_prev_tensor->shape(),
+                                        &cs_prev_grad_tensor));
+
+    Tensor* h_prev_grad_tensor = nullptr;
+    OP_REQUIRES_OK(ctx,
+                   ctx->allocate_output("h_prev_grad", h_prev_tensor->shape(),
+                                        &h_prev_grad_tensor));
+
+    Tensor* w_grad_tensor = nullptr;
+    OP_REQUIRES_OK(
+        ctx, ctx->allocate_output("w_grad", w_tensor->shape(), &w_grad_tensor));
+
+    Tensor* wci_grad_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output("wci_grad", wci_tensor->shape(),
+                                             &wci_grad_tensor));
+
+    Tensor* wcf_grad_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output("wcf_grad", wcf_tensor->shape(),
+                                             &wcf_grad_tensor));
+
+    Tensor* wco_grad_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output("wco_grad", wco_tensor->shape(),
+                                             &wco_grad_tensor));
+
+    Tensor* b_grad_tensor = nullptr;
+    OP_REQUIRES_OK(
+        ctx, ctx->allocate_output("b_grad", b_tensor->shape(), &b_grad_tensor));
+
+    TensorShape batch_cell_shape({batch_size, cell_size});
+
+    Tensor xh_tensor;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(
+                            DataTypeToEnum<T>::v(),
+                            TensorShape({batch_size, input_size + cell_size}),
+                            &xh_tensor));
+
+    Tensor xh_grad_tensor;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(DataTypeToEnum<T>::v(),
+                                           xh_tensor.shape(), &xh_grad_tensor));
+
+    Tensor do_tensor;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(DataTypeToEnum<T>::v(),
+                                           batch_cell_shape, &do_tensor));
+
+    Tensor dcs_tensor;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(DataTypeToEnum<T>::v(),
+                                           batch_cell_shape, &dcs_tensor));
+
+    Tensor dci_tensor;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(DataTypeToEnum<T>::v(),
+                                           batch_cell_shape, &dci_tensor));
+
+    Tensor df_tensor;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(DataTypeToEnum<T>::v(),
+                                           batch_cell_shape, &df_tensor));
+
+    Tensor di_tensor;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(DataTypeToEnum<T>::v(),
+                                           batch_cell_shape, &di_tensor));
+
+    Tensor dicfo_tensor;
+    OP_REQUIRES_OK(ctx,
+                   ctx->allocate_temp(DataTypeToEnum<T>::v(),
+                                      TensorShape({batch_size, cell_size * 4}),
+                                      &dicfo_tensor));
+
+    Tensor cs_grad_tensor;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(DataTypeToEnum<T>::v(),
+                                           batch_cell_shape, &cs_grad_tensor));
+
+    Tensor h_grad_tensor;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(DataTypeToEnum<T>::v(),
+                                           batch_cell_shape, &h_grad_tensor));
+
+    const Device& device = ctx->eigen_device<Device>();
+
+    // The state gradients of the examples which are not active yet, going
+    // backwards, must stay zero: they are only written once their sequence
+    // starts contributing.
+    functor::TensorZero<Device, T>()(device, cs_prev_grad_tensor->flat<T>());
+    functor::TensorZero<Device, T>()(device, h_prev_grad_tensor->flat<T>());
+    functor::TensorZero<Device, T>()(device, w_grad_tensor->flat<T>());
+    functor::TensorZero<Device, T>()(device, wci_grad_tensor->flat<T>());
+    functor::TensorZero<Device, T>()(device, wcf_grad_tensor->flat<T>());
+    functor::TensorZero<Device, T>()(device, wco_grad_tensor->flat<T>());
+    functor::TensorZero<Device, T>()(device, b_grad_tensor->flat<T>());
+
+    const auto sequence_length = sequence_length_tensor->vec<int64>();
+    const int64 seq_len_max = batch_size > 0 ? sequence_length(0) : 0;
+    int64 active = 0;
+    SliceHelper<Device, T> slicer(ctx);
+    for (int64 t = seq_len_max - 1; t >= 0; --t) {
+      while (active < batch_size && sequence_length(active) > t) ++active;
+
+      const Tensor x_tensor = slicer.InputSlice(*x, t, "x").Slice(0, active);
+      const Tensor cs_prev_tensor2 =
+          (t == 0 ? *cs_prev_tensor
+                  : slicer.InputSlice(*cs_out, t - 1, "cs_prev"))
+              .Slice(0, active);
+      const Tensor h_prev_tensor2 =
+          (t == 0 ? *h_prev_tensor
+                  : slicer.InputSlice(*h_out, t - 1, "h_prev"))
+              .Slice(0, active);
+      const Tensor i_tensor =
+          slicer.InputSlice(*i_out, t, "i_out").Slice(0, active);
+      const Tensor cs_tensor =
+          slicer.InputSlice(*cs_out, t, "cs_out").Slice(0, active);
+      const Tensor f_tensor =
+          slicer.InputSlice(*f_out, t, "f_out").Slice(0, active);
+      const Tensor o_tensor =
+          slicer.InputSlice(*o_out, t, "o_out").Slice(0, active);
+      const Tensor ci_tensor =
+          slicer.InputSlice(*ci_out, t, "ci_out").Slice(0, active);
+      const Tensor co_tensor =
+          slicer.InputSlice(*co_out, t, "co_out").Slice(0, active);
+
+      Tensor cs_prev_grad_active = cs_prev_grad_tensor->Slice(0, active);
+      Tensor h_prev_grad_active = h_prev_grad_tensor->Slice(0, active);
+      Tensor cs_grad_active = cs_grad_tensor.Slice(0, active);
+      Tensor h_grad_active = h_grad_tensor.Slice(0, active);
+
+      // Grab previous CS grad.
+      const Tensor& const_cs_prev_grad_tensor = cs_prev_grad_active;
+      const Tensor const_cs_grad_slice =
+          slicer.InputSlice(*cs_grad, t, "cs_grad").Slice(0, active);
+      functor::TensorAdd<Device, T>()(
+          device, const_cs_prev_grad_tensor.flat<T>(),
+          const_cs_grad_slice.flat<T>(), cs_grad_active.flat<T>());
+
+      // Combine previous h grad and h grad coming on top.
+      const Tensor& const_h_prev_grad_tensor = h_prev_grad_active;
+      const Tensor const_h_grad_slice =
+          slicer.InputSlice(*h_grad, t, "h_grad").Slice(0, active);
+      functor::TensorAdd<Device, T>()(
+          device, const_h_prev_grad_tensor.flat<T>(),
+          const_h_grad_slice.flat<T>(), h_grad_active.flat<T>());
+
+      const Tensor& const_cs_grad_tensor = cs_grad_active;
+      const Tensor& const_h_grad_tensor = h_grad_active;
+
+      Tensor x_grad_tensor = slicer.OutputSlice(x_grad, t, "x_grad");
+      Tensor xh_active = xh_tensor.Slice(0, active);
+      Tensor xh_grad_active = xh_grad_tensor.Slice(0, active);
+      Tensor do_active = do_tensor.Slice(0, active);
+      Tensor dcs_active = dcs_tensor.Slice(0, active);
+      Tensor dci_active = dci_tensor.Slice(0, active);
+      Tensor df_active = df_tensor.Slice(0, active);
+      Tensor di_active = di_tensor.Slice(0, active);
+      Tensor dicfo_active = dicfo_tensor.Slice(0, active);
+      functor::BlockLSTMBprop<Device, T, USE_CUBLAS>(active, input_size,
+                                                     cell_size)(
+          ctx, device, use_peephole_, x_tensor.matrix<T>(),
+          cs_prev_tensor2.matrix<T>(), h_prev_tensor2.matrix<T>(),
+          w_tensor->matrix<T>(), wci_tensor->vec<T>(), wcf_tensor->vec<T>(),
+          wco_tensor->vec<T>(), b_tensor->vec<T>(), xh_active.matrix<T>(),
+          i_tensor.matrix<T>(), cs_tensor.matrix<T>(), f_tensor.matrix<T>(),
+          o_tensor.matrix<T>(), ci_tensor.matrix<T>(), co_tensor.matrix<T>(),
+          const_cs_grad_tensor.matrix<T>(), const_h_grad_tensor.matrix<T>(),
+          do_active.matrix<T>(), dcs_active.matrix<T>(),
+          dci_active.matrix<T>(), df_active.matrix<T>(), di_active.matrix<T>(),
+          dicfo_active.matrix<T>(), cs_prev_grad_active.matrix<T>(),
+          h_prev_grad_active.matrix<T>(), xh_grad_active.matrix<T>(),
+          x_grad_tensor.Slice(0, active).matrix<T>(),
+          w_grad_tensor->matrix<T>(), wci_grad_tensor->vec<T>(),
+          wcf_grad_tensor->vec<T>(), wco_grad_tensor->vec<T>(),
+          b_grad_tensor->vec<T>());
+
+      if (active < batch_size) {
+        Tensor x_grad_ended = x_grad_tensor.Slice(active, batch_size);
+        functor::TensorUnalignedZero<Device, T>()(
+            device, x_grad_ended.unaligned_flat<T>());
+      }
+      slicer.FinishTimeStep();
+    }
+
+    if (seq_len_max < timelen) {
+      Tensor x_grad_tensor = x_grad->Slice(seq_len_max, timelen);
+      functor::TensorUnalignedZero<Device, T>()(
+          device, x_grad_tensor.unaligned_flat<T>());
+    }
+  }
+
+ private:
+  bool use_peephole_;
+};
+
+#define REGISTER_KERNEL(T)                                                   \
+  REGISTER_KERNEL_BUILDER(                                                   \
+      Name("SortedBlockLSTMGrad").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      SortedBlockLSTMGradOp<CPUDevice, T, false>);
+REGISTER_KERNEL(float);
+// REGISTER_KERNEL(double);
+#undef REGISTER_KERNEL
+
+#ifdef TENSORFLOW_USE_SYCL
+#define REGISTER_KERNEL(T)                                            \
+  REGISTER_KERNEL_BUILDER(Name("SortedBlockLSTMGrad")                 \
+                              .Device(DEVICE_SYCL)                    \
+                              .HostMemory("sequence_length")          \
+                              .TypeConstraint<T>("T"),                \
+                          SortedBlockLSTMGradOp<SYCLDevice, T, false>);
+REGISTER_KERNEL(float);
+// REGISTER_KERNEL(double);
+#undef REGISTER_KERNEL
+#endif  // TENSORFLOW_USE_SYCL
+
+#if GOOGLE_CUDA
+#define REGISTER_GPU_KERNEL(T)                               \
+  REGISTER_KERNEL_BUILDER(Name("SortedBlockLSTMGrad")        \
+                              .Device(DEVICE_GPU)            \
+                              .HostMemory("sequence_length") \
+                              .TypeConstraint<T>("T"),       \
+                          SortedBlockLSTMGradOp<GPUDevice, T, true>);
+
+REGISTER_GPU_KERNEL(float);
+// REGISTER_GPU_KERNEL(double);
+#undef REGISTER_GPU_KERNEL
+#endif  // GOOGLE_CUDA
+
 }  // end namespace tensorflow
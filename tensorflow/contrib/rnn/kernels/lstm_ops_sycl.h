@@ -0,0 +1,383 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_USE_SYCL
+#error This file must only be included when building TensorFlow with SYCL support
+#endif
+
+#ifndef TENSORFLOW_CONTRIB_RNN_KERNELS_LSTM_OPS_SYCL_H_
+#define TENSORFLOW_CONTRIB_RNN_KERNELS_LSTM_OPS_SYCL_H_
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+
+#include "tensorflow/contrib/rnn/kernels/lstm_ops.h"
+#include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+
+namespace tensorflow {
+
+typedef Eigen::SyclDevice SYCLDevice;
+
+namespace functor {
+
+// The data of a tensor in a SYCL kernel: an accessor to its buffer and the
+// offset of the data in the buffer.
+template <typename T, cl::sycl::access::mode Mode>
+class LSTMSYCLArg {
+ public:
+  LSTMSYCLArg(const SYCLDevice& d, const T* data, cl::sycl::handler& cgh)
+      : accessor_(d.get_sycl_buffer(data).template get_access<Mode>(cgh)),
+        offset_(d.get_offset(data) / sizeof(T)) {}
+
+  T* get() const { return ConvertToActualTypeSycl(T, accessor_) + offset_; }
+
+ private:
+  cl::sycl::accessor<uint8_t, 1, Mode, cl::sycl::access::target::global_buffer>
+      accessor_;
+  size_t offset_;
+};
+
+template <typename T>
+using LSTMSYCLInput = LSTMSYCLArg<T, cl::sycl::access::mode::read>;
+template <typename T>
+using LSTMSYCLOutput = LSTMSYCLArg<T, cl::sycl::access::mode::write>;
+
+// Computes all the gates of a LSTM cell from the gate pre-activations
+// icfo = xh * w, with one work item per element of the cell state. The bias,
+// the peepholes and the cell clip are applied on the fly. o and i may alias
+// cs_prev and h_prev, so each work item reads its inputs before writing.
+template <typename T>
+struct LSTMBlockCellFpropKernel {
+  void operator()(cl::sycl::nd_item<1> item) const {
+    const int64 index = item.get_global_id(0);
+    if (index >= size) {
+      return;
+    }
+    const int64 col = index % cell_size;
+    const int64 gates = index / cell_size * cell_size * 4 + col;
+    const T* icfo_data = icfo.get();
+    const T* b_data = b.get();
+    const T one(1);
+
+    const T cs_prev_value = cs_prev.get()[index];
+    T i_value = icfo_data[gates] + b_data[col];
+    T ci_value = icfo_data[gates + cell_size] + b_data[col + cell_size];
+    T f_value = icfo_data[gates + cell_size * 2] +
+                b_data[col + cell_size * 2] + forget_bias;
+    T o_value = icfo_data[gates + cell_size * 3] + b_data[col + cell_size * 3];
+    if (use_peephole) {
+      i_value += cs_prev_value * wci.get()[col];
+      f_value += cs_prev_value * wcf.get()[col];
+    }
+    i_value = one / (one + cl::sycl::exp(-i_value));
+    ci_value = cl::sycl::tanh(ci_value);
+    f_value = one / (one + cl::sycl::exp(-f_value));
+
+    T cs_value = i_value * ci_value + f_value * cs_prev_value;
+    if (cell_clip > T(0)) {
+      cs_value = cs_value < -cell_clip
+                     ? -cell_clip
+                     : (cs_value > cell_clip ? cell_clip : cs_value);
+    }
+    const T co_value = cl::sycl::tanh(cs_value);
+    if (use_peephole) {
+      o_value += cs_value * wco.get()[col];
+    }
+    o_value = one / (one + cl::sycl::exp(-o_value));
+
+    i.get()[index] = i_value;
+    cs.get()[index] = cs_value;
+    f.get()[index] = f_value;
+    o.get()[index] = o_value;
+    ci.get()[index] = ci_value;
+    co.get()[index] = co_value;
+    h.get()[index] = o_value * co_value;
+  }
+
+  LSTMSYCLInput<T> icfo;
+  LSTMSYCLInput<T> b;
+  LSTMSYCLInput<T> cs_prev;
+  LSTMSYCLInput<T> wci;
+  LSTMSYCLInput<T> wcf;
+  LSTMSYCLInput<T> wco;
+  LSTMSYCLOutput<T> i;
+  LSTMSYCLOutput<T> cs;
+  LSTMSYCLOutput<T> f;
+  LSTMSYCLOutput<T> o;
+  LSTMSYCLOutput<T> ci;
+  LSTMSYCLOutput<T> co;
+  LSTMSYCLOutput<T> h;
+  T forget_bias;
+  T cell_clip;
+  bool use_peephole;
+  int64 cell_size;
+  int64 size;
+};
+
+// Computes the gradients of the gates of a LSTM cell and of its previous cell
+// state, with one work item per element of the cell state.
+template <typename T>
+struct LSTMBlockCellBpropKernel {
+  void operator()(cl::sycl::nd_item<1> item) const {
+    const int64 index = item.get_global_id(0);
+    if (index >= size) {
+      return;
+    }
+    const int64 col = index % cell_size;
+    const int64 gates = index / cell_size * cell_size * 4 + col;
+    const T one(1);
+
+    const T i_value = i.get()[index];
+    const T f_value = f.get()[index];
+    const T o_value = o.get()[index];
+    const T ci_value = ci.get()[index];
+    const T co_value = co.get()[index];
+    const T cs_prev_value = cs_prev.get()[index];
+    const T h_grad_value = h_grad.get()[index];
+
+    // do[t] = sigm'(o[t]) .* dh[t] .* co[t]
+    const T do_value = o_value * (one - o_value) * h_grad_value * co_value;
+    // dcs[t] += tanh'(cs[t]) .* dh[t] .* o[t] + dcs[t + 1] .* f[t + 1]
+    T dcs_value = (one - co_value * co_value) * h_grad_value * o_value +
+                  cs_grad.get()[index];
+    if (use_peephole) {
+      dcs_value += do_value * wco.get()[col];
+    }
+    // dci[t] = tanh'(ci[t]) dcs[t] i[t]
+    const T dci_value = (one - ci_value * ci_value) * dcs_value * i_value;
+    // df[t] = sigm'(f[t]) dcs[t] cs[t - 1]
+    const T df_value = f_value * (one - f_value) * dcs_value * cs_prev_value;
+    // di[t] = sigm'(i[t]) dcs[t] ci[t]
+    const T di_value = i_value * (one - i_value) * dcs_value * ci_value;
+    T cs_prev_grad_value = dcs_value * f_value;
+    if (use_peephole) {
+      cs_prev_grad_value +=
+          di_value * wci.get()[col] + df_value * wcf.get()[col];
+    }
+
+    T* dicfo_data = dicfo.get();
+    dicfo_data[gates] = di_value;
+    dicfo_data[gates + cell_size] = dci_value;
+    dicfo_data[gates + cell_size * 2] = df_value;
+    dicfo_data[gates + cell_size * 3] = do_value;
+    do_.get()[index] = do_value;
+    dcs.get()[index] = dcs_value;
+    dci.get()[index] = dci_value;
+    df.get()[index] = df_value;
+    di.get()[index] = di_value;
+    cs_prev_grad.get()[index] = cs_prev_grad_value;
+  }
+
+  LSTMSYCLInput<T> cs_prev;
+  LSTMSYCLInput<T> wci;
+  LSTMSYCLInput<T> wcf;
+  LSTMSYCLInput<T> wco;
+  LSTMSYCLInput<T> i;
+  LSTMSYCLInput<T> f;
+  LSTMSYCLInput<T> o;
+  LSTMSYCLInput<T> ci;
+  LSTMSYCLInput<T> co;
+  LSTMSYCLInput<T> cs_grad;
+  LSTMSYCLInput<T> h_grad;
+  LSTMSYCLOutput<T> do_;
+  LSTMSYCLOutput<T> dcs;
+  LSTMSYCLOutput<T> dci;
+  LSTMSYCLOutput<T> df;
+  LSTMSYCLOutput<T> di;
+  LSTMSYCLOutput<T> dicfo;
+  LSTMSYCLOutput<T> cs_prev_grad;
+  bool use_peephole;
+  int64 cell_size;
+  int64 size;
+};
+
+// Runs the forward pass of a LSTM cell as one sycl-blas GEMM for the gate
+// pre-activations and one LSTMBlockCellFpropKernel for the gates. Device is
+// always SYCLDevice, it is only a parameter to mirror
+// LSTMBlockCellFpropWithEigen.
+template <typename Device, typename T>
+void LSTMBlockCellFpropSYCL(
+    const LSTMBlockCell& cell, OpKernelContext* ctx, const Device& d,
+    const T forget_bias, const T cell_clip, bool use_peephole,
+    typename TTypes<T>::ConstMatrix x, typename TTypes<T>::ConstMatrix cs_prev,
+    typename TTypes<T>::ConstMatrix h_prev, typename TTypes<T>::ConstMatrix w,
+    typename TTypes<T>::ConstVec wci, typename TTypes<T>::ConstVec wcf,
+    typename TTypes<T>::ConstVec wco, typename TTypes<T>::ConstVec b,
+    typename TTypes<T>::Matrix xh, typename TTypes<T>::Matrix i,
+    typename TTypes<T>::Matrix cs, typename TTypes<T>::Matrix f,
+    typename TTypes<T>::Matrix o, typename TTypes<T>::Matrix ci,
+    typename TTypes<T>::Matrix co, typename TTypes<T>::Matrix icfo,
+    typename TTypes<T>::Matrix h) {
+  const int64 size = cell.batch_size() * cell.cell_size();
+  if (size == 0) {
+    return;
+  }
+  // Concat xh = [x, h].
+  xh.slice(cell.xh_x_offsets(), cell.xh_x_extents()).device(d) = x;
+  xh.slice(cell.xh_h_offsets(), cell.xh_h_extents()).device(d) = h_prev;
+
+  // icfo = xh * w
+  typename TTypes<T>::ConstMatrix const_xh(xh.data(), xh.dimensions());
+  TensorBlasGemm<Device, T, false /* USE_CUBLAS */>::compute(
+      ctx, d, false, false, T(1), const_xh, w, T(0), icfo);
+
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    LSTMBlockCellFpropKernel<T> kernel{
+        {d, icfo.data(), cgh}, {d, b.data(), cgh},  {d, cs_prev.data(), cgh},
+        {d, wci.data(), cgh},  {d, wcf.data(), cgh}, {d, wco.data(), cgh},
+        {d, i.data(), cgh},    {d, cs.data(), cgh},  {d, f.data(), cgh},
+        {d, o.data(), cgh},    {d, ci.data(), cgh},  {d, co.data(), cgh},
+        {d, h.data(), cgh},    forget_bias,          cell_clip,
+        use_peephole,          cell.cell_size(),     size};
+    cgh.parallel_for(SYCLUtil::get_nd_range(d, size), kernel);
+  });
+}
+
+// Computes the gate gradients of a LSTM cell with one LSTMBlockCellBpropKernel.
+template <typename T>
+void LSTMBlockCellGateGradsSYCL(
+    const LSTMBlockCell& cell, const SYCLDevice& d, bool use_peephole,
+    typename TTypes<T>::ConstMatrix cs_prev, typename TTypes<T>::ConstVec wci,
+    typename TTypes<T>::ConstVec wcf, typename TTypes<T>::ConstVec wco,
+    typename TTypes<T>::ConstMatrix i, typename TTypes<T>::ConstMatrix f,
+    typename TTypes<T>::ConstMatrix o, typename TTypes<T>::ConstMatrix ci,
+    typename TTypes<T>::ConstMatrix co,
+    typename TTypes<T>::ConstMatrix cs_grad,
+    typename TTypes<T>::ConstMatrix h_grad, typename TTypes<T>::Matrix do_,
+    typename TTypes<T>::Matrix dcs, typename TTypes<T>::Matrix dci,
+    typename TTypes<T>::Matrix df, typename TTypes<T>::Matrix di,
+    typename TTypes<T>::Matrix dicfo,
+    typename TTypes<T>::Matrix cs_prev_grad) {
+  const int64 size = cell.batch_size() * cell.cell_size();
+  if (size == 0) {
+    return;
+  }
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    LSTMBlockCellBpropKernel<T> kernel{
+        {d, cs_prev.data(), cgh}, {d, wci.data(), cgh},
+        {d, wcf.data(), cgh},     {d, wco.data(), cgh},
+        {d, i.data(), cgh},       {d, f.data(), cgh},
+        {d, o.data(), cgh},       {d, ci.data(), cgh},
+        {d, co.data(), cgh},      {d, cs_grad.data(), cgh},
+        {d, h_grad.data(), cgh},  {d, do_.data(), cgh},
+        {d, dcs.data(), cgh},     {d, dci.data(), cgh},
+        {d, df.data(), cgh},      {d, di.data(), cgh},
+        {d, dicfo.data(), cgh},   {d, cs_prev_grad.data(), cgh},
+        use_peephole,             cell.cell_size(),
+        size};
+    cgh.parallel_for(SYCLUtil::get_nd_range(d, size), kernel);
+  });
+}
+
+// Runs the backward pass of a LSTM cell as one LSTMBlockCellBpropKernel,
+// followed by the reductions for the peephole gradients.
+template <typename Device, typename T, bool USE_CUBLAS>
+void LSTMBlockCellBpropSYCL(
+    const LSTMBlockCell& cell, OpKernelContext* ctx, const Device& d,
+    bool use_peephole, typename TTypes<T>::ConstMatrix x,
+    typename TTypes<T>::ConstMatrix cs_prev,
+    typename TTypes<T>::ConstMatrix h_prev, typename TTypes<T>::ConstMatrix w,
+    typename TTypes<T>::ConstVec wci, typename TTypes<T>::ConstVec wcf,
+    typename TTypes<T>::ConstVec wco, typename TTypes<T>::ConstVec b,
+    typename TTypes<T>::ConstMatrix i, typename TTypes<T>::ConstMatrix cs,
+    typename TTypes<T>::ConstMatrix f, typename TTypes<T>::ConstMatrix o,
+    typename TTypes<T>::ConstMatrix ci, typename TTypes<T>::ConstMatrix co,
+    typename TTypes<T>::ConstMatrix cs_grad,
+    typename TTypes<T>::ConstMatrix h_grad, typename TTypes<T>::Matrix do_,
+    typename TTypes<T>::Matrix dcs, typename TTypes<T>::Matrix dci,
+    typename TTypes<T>::Matrix df, typename TTypes<T>::Matrix di,
+    typename TTypes<T>::Matrix dicfo, typename TTypes<T>::Matrix cs_prev_grad,
+    typename TTypes<T>::Vec wci_grad, typename TTypes<T>::Vec wcf_grad,
+    typename TTypes<T>::Vec wco_grad) {
+  LSTMBlockCellGateGradsSYCL<T>(cell, d, use_peephole, cs_prev, wci, wcf, wco,
+                                i, f, o, ci, co, cs_grad, h_grad, do_, dcs,
+                                dci, df, di, dicfo, cs_prev_grad);
+  if (use_peephole) {
+    wci_grad.device(d) = (di * cs_prev).sum(Eigen::array<int, 1>({0}));
+    wcf_grad.device(d) = (df * cs_prev).sum(Eigen::array<int, 1>({0}));
+    wco_grad.device(d) = (do_ * cs).sum(Eigen::array<int, 1>({0}));
+  }
+}
+
+// The backward pass of BlockLSTM over one time step, as in the generic
+// BlockLSTMBprop but with the gate gradients in one kernel.
+template <typename T>
+struct BlockLSTMBprop<SYCLDevice, T, false /* USE_CUBLAS */>
+    : public LSTMBlockCell {
+  BlockLSTMBprop(const int batch_size, const int input_size,
+                 const int cell_size)
+      : LSTMBlockCell(batch_size, input_size, cell_size) {}
+
+  void operator()(
+      OpKernelContext* ctx, const SYCLDevice& d, bool use_peephole,
+      typename TTypes<T>::ConstMatrix x,
+      typename TTypes<T>::ConstMatrix cs_prev,
+      typename TTypes<T>::ConstMatrix h_prev, typename TTypes<T>::ConstMatrix w,
+      typename TTypes<T>::ConstVec wci, typename TTypes<T>::ConstVec wcf,
+      typename TTypes<T>::ConstVec wco, typename TTypes<T>::ConstVec b,
+      typename TTypes<T>::Matrix xh, typename TTypes<T>::ConstMatrix i,
+      typename TTypes<T>::ConstMatrix cs, typename TTypes<T>::ConstMatrix f,
+      typename TTypes<T>::ConstMatrix o, typename TTypes<T>::ConstMatrix ci,
+      typename TTypes<T>::ConstMatrix co,
+      typename TTypes<T>::ConstMatrix cs_grad,
+      typename TTypes<T>::ConstMatrix h_grad, typename TTypes<T>::Matrix do_,
+      typename TTypes<T>::Matrix dcs, typename TTypes<T>::Matrix dci,
+      typename TTypes<T>::Matrix df, typename TTypes<T>::Matrix di,
+      typename TTypes<T>::Matrix dicfo, typename TTypes<T>::Matrix cs_prev_grad,
+      typename TTypes<T>::Matrix h_prev_grad,
+      typename TTypes<T>::Matrix xh_grad, typename TTypes<T>::Matrix x_grad,
+      typename TTypes<T>::Matrix w_grad, typename TTypes<T>::Vec wci_grad,
+      typename TTypes<T>::Vec wcf_grad, typename TTypes<T>::Vec wco_grad,
+      typename TTypes<T>::Vec b_grad) {
+    if (batch_size_ == 0) {
+      return;
+    }
+    LSTMBlockCellGateGradsSYCL<T>(*this, d, use_peephole, cs_prev, wci, wcf,
+                                  wco, i, f, o, ci, co, cs_grad, h_grad, do_,
+                                  dcs, dci, df, di, dicfo, cs_prev_grad);
+
+    // xh_grad.
+    typename TTypes<T>::ConstMatrix const_dicfo(dicfo.data(),
+                                                dicfo.dimensions());
+    TensorBlasGemm<SYCLDevice, T, false /* USE_CUBLAS */>::compute(
+        ctx, d, false, true, T(1), const_dicfo, w, T(0), xh_grad);
+
+    // xh.
+    xh.slice(xh_x_offsets(), xh_x_extents()).device(d) = x;
+    xh.slice(xh_h_offsets(), xh_h_extents()).device(d) = h_prev;
+    typename TTypes<T>::ConstMatrix const_xh(xh.data(), xh.dimensions());
+
+    // x_grad.
+    x_grad.device(d) = xh_grad.slice(xh_x_offsets(), xh_x_extents());
+    h_prev_grad.device(d) = xh_grad.slice(xh_h_offsets(), xh_h_extents());
+
+    // w_grad.
+    TensorBlasGemm<SYCLDevice, T, false /* USE_CUBLAS */>::compute(
+        ctx, d, true, false, T(1), const_xh, const_dicfo, T(1), w_grad);
+
+    // b_grad.
+    b_grad.device(d) += dicfo.sum(Eigen::array<int, 1>({0}));
+
+    if (use_peephole) {
+      wci_grad.device(d) += (di * cs_prev).sum(Eigen::array<int, 1>({0}));
+      wcf_grad.device(d) += (df * cs_prev).sum(Eigen::array<int, 1>({0}));
+      wco_grad.device(d) += (do_ * cs).sum(Eigen::array<int, 1>({0}));
+    }
+  }
+};
+
+}  // namespace functor
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CONTRIB_RNN_KERNELS_LSTM_OPS_SYCL_H_
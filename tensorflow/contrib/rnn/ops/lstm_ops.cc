@@ -176,6 +176,53 @@ wcf_grad: The gradient for wcf to be back-propped.
 wco_grad: The gradient for wco to be back-propped.
 )doc");
 
+namespace {
+
+// Also used by the SortedBlockLSTM ops, which only differ in their first input.
+Status BlockLSTMShapeFn(InferenceContext* c) {
+  ShapeHandle x, b;
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 3, &x));
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(c->num_inputs() - 1), 1, &b));
+
+  DimensionHandle timelen = c->Dim(x, 0);
+  DimensionHandle batch_size = c->Dim(x, 1);
+  DimensionHandle cell_size;
+  TF_RETURN_IF_ERROR(
+      c->Divide(c->Dim(b, 0), 4, true /* evenly_divisible */, &cell_size));
+
+  DCHECK_EQ(7, c->num_outputs());
+  ShapeHandle output = c->MakeShape({timelen, batch_size, cell_size});
+  for (int i = 0; i < 7; ++i) {
+    c->set_output(i, output);
+  }
+  return Status::OK();
+}
+
+Status BlockLSTMGradShapeFn(InferenceContext* c) {
+  ShapeHandle x, cs_prev, h_prev, w, wci, wco, wcf, b;
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 3, &x));
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 2, &cs_prev));
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(3), 2, &h_prev));
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(4), 2, &w));
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(5), 1, &wci));
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(6), 1, &wco));
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(7), 1, &wcf));
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(8), 1, &b));
+
+  c->set_output(0, x);
+  c->set_output(1, cs_prev);
+  c->set_output(2, h_prev);
+  c->set_output(3, w);
+  c->set_output(4, wci);
+  c->set_output(5, wco);
+  c->set_output(6, wcf);
+  c->set_output(7, b);
+
+  return Status::OK();
+}
+
+}  // namespace
+
 REGISTER_OP("BlockLSTM")
     .Input("seq_len_max: int64")
     .Input("x: T")
@@ -197,24 +244,7 @@ REGISTER_OP("BlockLSTM")
     .Attr("cell_clip: float = 3.0")
     .Attr("use_peephole: bool = false")
     .Attr("T: {float}")
-    .SetShapeFn([](InferenceContext* c) {
-      ShapeHandle x, b;
-      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 3, &x));
-      TF_RETURN_IF_ERROR(c->WithRank(c->input(c->num_inputs() - 1), 1, &b));
-
-      DimensionHandle timelen = c->Dim(x, 0);
-      DimensionHandle batch_size = c->Dim(x, 1);
-      DimensionHandle cell_size;
-      TF_RETURN_IF_ERROR(
-          c->Divide(c->Dim(b, 0), 4, true /* evenly_divisible */, &cell_size));
-
-      DCHECK_EQ(7, c->num_outputs());
-      ShapeHandle output = c->MakeShape({timelen, batch_size, cell_size});
-      for (int i = 0; i < 7; ++i) {
-        c->set_output(i, output);
-      }
-      return Status::OK();
-    })
+    .SetShapeFn(BlockLSTMShapeFn)
     .Doc(R"doc(
 Computes the LSTM cell forward propagation for all the time steps.
 
@@ -289,28 +319,7 @@ REGISTER_OP("BlockLSTMGrad")
     .Output("b_grad: T")
     .Attr("use_peephole: bool")
     .Attr("T: {float}")
-    .SetShapeFn([](InferenceContext* c) {
-      ShapeHandle x, cs_prev, h_prev, w, wci, wco, wcf, b;
-      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 3, &x));
-      TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 2, &cs_prev));
-      TF_RETURN_IF_ERROR(c->WithRank(c->input(3), 2, &h_prev));
-      TF_RETURN_IF_ERROR(c->WithRank(c->input(4), 2, &w));
-      TF_RETURN_IF_ERROR(c->WithRank(c->input(5), 1, &wci));
-      TF_RETURN_IF_ERROR(c->WithRank(c->input(6), 1, &wco));
-      TF_RETURN_IF_ERROR(c->WithRank(c->input(7), 1, &wcf));
-      TF_RETURN_IF_ERROR(c->WithRank(c->input(8), 1, &b));
-
-      c->set_output(0, x);
-      c->set_output(1, cs_prev);
-      c->set_output(2, h_prev);
-      c->set_output(3, w);
-      c->set_output(4, wci);
-      c->set_output(5, wco);
-      c->set_output(6, wcf);
-      c->set_output(7, b);
-
-      return Status::OK();
-    })
+    .SetShapeFn(BlockLSTMGradShapeFn)
     .Doc(R"doc(
 Computes the LSTM cell backward propagation for the entire time sequence.
 
@@ -348,4 +357,137 @@ wco_grad: The gradient for wco to be back-propped.
 b_grad: The gradient for w to be back-propped.
 )doc");
 
+REGISTER_OP("SortedBlockLSTM")
+    .Input("sequence_length: int64")
+    .Input("x: T")
+    .Input("cs_prev: T")
+    .Input("h_prev: T")
+    .Input("w: T")
+    .Input("wci: T")
+    .Input("wcf: T")
+    .Input("wco: T")
+    .Input("b: T")
+    .Output("i: T")
+    .Output("cs: T")
+    .Output("f: T")
+    .Output("o: T")
+    .Output("ci: T")
+    .Output("co: T")
+    .Output("h: T")
+    .Attr("forget_bias: float = 1.0")
+    .Attr("cell_clip: float = 3.0")
+    .Attr("use_peephole: bool = false")
+    .Attr("T: {float}")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle sequence_length;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &sequence_length));
+      return BlockLSTMShapeFn(c);
+    })
+    .Doc(R"doc(
+Computes the LSTM cell forward propagation for a batch of sequences sorted by
+decreasing length.
+
+This is equivalent to BlockLSTM, except that each time step only computes the
+sequences which have not ended yet: step t computes the first k examples of the
+batch, where k is the number of sequences longer than t. The whole step still
+uses a single matrix multiplication for all the gates.
+
+cell_clip: Value to clip the 'cs' value to.
+use_peephole: Whether to use peephole weights.
+forget_bias: The forget gate bias.
+
+sequence_length: The length of each sequence of the batch, sorted in
+  non-increasing order. cs and h are zero past the length of their sequence, the
+  other outputs are undefined there.
+x: The sequence input to the LSTM, shape (timelen, batch_size, num_inputs).
+cs_prev: Value of the initial cell state.
+h_prev: Initial output of cell (to be used for peephole).
+w: The weight matrix.
+wci: The weight matrix for input gate peephole connection.
+wcf: The weight matrix for forget gate peephole connection.
+wco: The weight matrix for output gate peephole connection.
+b: The bias vector.
+
+i: The input gate over the whole time sequence.
+cs: The cell state before the tanh over the whole time sequence.
+f: The forget gate over the whole time sequence.
+o: The output gate over the whole time sequence.
+ci: The cell input over the whole time sequence.
+co: The cell after the tanh over the whole time sequence.
+h: The output h vector over the whole time sequence.
+)doc");
+
+REGISTER_OP("SortedBlockLSTMGrad")
+    .Input("sequence_length: int64")
+    .Input("x: T")
+    .Input("cs_prev: T")
+    .Input("h_prev: T")
+    .Input("w: T")
+    .Input("wci: T")
+    .Input("wcf: T")
+    .Input("wco: T")
+    .Input("b: T")
+    .Input("i: T")
+    .Input("cs: T")
+    .Input("f: T")
+    .Input("o: T")
+    .Input("ci: T")
+    .Input("co: T")
+    .Input("h: T")
+    .Input("cs_grad: T")
+    .Input("h_grad: T")
+    .Output("x_grad: T")
+    .Output("cs_prev_grad: T")
+    .Output("h_prev_grad: T")
+    .Output("w_grad: T")
+    .Output("wci_grad: T")
+    .Output("wcf_grad: T")
+    .Output("wco_grad: T")
+    .Output("b_grad: T")
+    .Attr("use_peephole: bool")
+    .Attr("T: {float}")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle sequence_length;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &sequence_length));
+      return BlockLSTMGradShapeFn(c);
+    })
+    .Doc(R"doc(
+Computes the LSTM cell backward propagation for a batch of sequences sorted by
+decreasing length.
+
+This implementation is to be used in conjunction of SortedBlockLSTM. The
+gradients past the length of a sequence are ignored, x_grad is zero there.
+
+use_peephole: Whether to use peephole weights.
+
+sequence_length: The length of each sequence of the batch, sorted in
+  non-increasing order.
+x: The sequence input to the LSTM, shape (timelen, batch_size, num_inputs).
+cs_prev: Value of the initial cell state.
+h_prev: Initial output of cell (to be used for peephole).
+w: The weight matrix.
+wci: The weight matrix for input gate peephole connection.
+wcf: The weight matrix for forget gate peephole connection.
+wco: The weight matrix for output gate peephole connection.
+b: The bias vector.
+i: The input gate over the whole time sequence.
+cs: The cell state before the tanh over the whole time sequence.
+f: The forget gate over the whole time sequence.
+o: The output gate over the whole time sequence.
+ci: The cell input over the whole time sequence.
+co: The cell after the tanh over the whole time sequence.
+h: The output h vector over the whole time sequence.
+cs_grad: The current gradient of cs.
+h_grad: The gradient of h vector.
+
+x_grad: The gradient of x to be back-propped.
+cs_prev_grad: The gradient of cs_prev to be back-propped.
+h_prev_grad: The gradient of h_prev to be back-propped.
+w_grad: The gradient for w to be back-propped.
+wci_grad: The gradient for wci to be back-propped.
+wcf_grad: The gradient for wcf to be back-propped.
+wco_grad: The gradient for wco to be back-propped.
+b_grad: The gradient for w to be back-propped.
+)doc");
+
 }  // end namespace tensorflow
@@ -110,6 +110,31 @@ TEST_F(LSTMOpsTest, BlockLSTM_ShapeFn) {
   INFER_ERROR("must be evenly divisible", op, "?;?" + infix + "[11]");
 }
 
+TEST_F(LSTMOpsTest, SortedBlockLSTM_ShapeFn) {
+  ShapeInferenceTestOp op("SortedBlockLSTM");
+
+  TF_ASSERT_OK(NodeDefBuilder("test", "SortedBlockLSTM")
+                   .Input({"sequence_length", 0, DT_INT64})
+                   .Input({"x", 0, DT_FLOAT})
+                   .Input({"cs_prev", 0, DT_FLOAT})
+                   .Input({"h_prev", 0, DT_FLOAT})
+                   .Input({"w", 0, DT_FLOAT})
+                   .Input({"wci", 0, DT_FLOAT})
+                   .Input({"wcf", 0, DT_FLOAT})
+                   .Input({"wco", 0, DT_FLOAT})
+                   .Input({"b", 0, DT_FLOAT})
+                   .Finalize(&op.node_def));
+
+  string infix = ";" + JoinedCopies("?", 6) + ";";
+
+  // sequence_length holds one length per example.
+  INFER_ERROR("must be rank 1", op, "[];?" + infix + "?");
+  INFER_ERROR("must be rank 3", op, "?;[?]" + infix + "?");
+
+  INFER_OK(op, "[?];[?,?,?]" + infix + "[20]",
+           JoinedCopies("[d1_0,d1_1,5]", 7));
+}
+
 TEST_F(LSTMOpsTest, BlockLSTMGrad_ShapeFn) {
   ShapeInferenceTestOp op("BlockLSTMGrad");
   TF_ASSERT_OK(NodeDefBuilder("test", "BlockLSTMGrad")
@@ -328,6 +328,43 @@ def _BlockLSTMGrad(op, *grad):
   ]
 
 
+@ops.RegisterGradient("SortedBlockLSTM")
+def _SortedBlockLSTMGrad(op, *grad):
+  """Gradient for SortedBlockLSTM."""
+  sequence_length, x, cs_prev, h_prev, w, wci, wcf, wco, b = op.inputs
+  i, cs, f, o, ci, co, h = op.outputs
+
+  cs_grad = grad[1]
+  h_grad = grad[6]
+
+  (x_grad, cs_prev_grad, h_prev_grad, w_grad, wci_grad, wcf_grad, wco_grad,
+   b_grad) = gen_lstm_ops.sorted_block_lstm_grad(
+       sequence_length,
+       x,
+       cs_prev,
+       h_prev,
+       w,
+       wci,
+       wcf,
+       wco,
+       b,
+       i,
+       cs,
+       f,
+       o,
+       ci,
+       co,
+       h,
+       cs_grad,
+       h_grad,
+       use_peephole=op.get_attr("use_peephole"))
+
+  return [
+      None, x_grad, cs_prev_grad, h_prev_grad, w_grad, wci_grad, wcf_grad,
+      wco_grad, b_grad
+  ]
+
+
 class LSTMBlockCell(LayerRNNCell):
   """Basic LSTM recurrent network cell.
 
@@ -587,6 +624,9 @@ class LSTMBlockFusedCell(LSTMBlockWrapper):
   We add forget_bias (default: 1) to the biases of the forget gate in order to
   reduce the scale of forgetting in the beginning of the training.
 
+  When `sequence_length` is given the batch is sorted by length internally, so
+  that each time step skips the sequences which already ended.
+
   The variable naming is consistent with `rnn_cell_impl.LSTMCell`.
   """
 
@@ -681,15 +721,31 @@ class LSTMBlockFusedCell(LSTMBlockWrapper):
       wci = wcf = wco = array_ops.zeros([self._num_units], dtype=dtype)
 
     if sequence_length is None:
-      max_seq_len = math_ops.to_int64(time_len)
-    else:
-      max_seq_len = math_ops.to_int64(math_ops.reduce_max(sequence_length))
-
-    _, cs, _, _, _, _, h = gen_lstm_ops.block_lstm(
-        seq_len_max=max_seq_len,
-        x=inputs,
-        cs_prev=initial_cell_state,
-        h_prev=initial_output,
+      _, cs, _, _, _, _, h = gen_lstm_ops.block_lstm(
+          seq_len_max=math_ops.to_int64(time_len),
+          x=inputs,
+          cs_prev=initial_cell_state,
+          h_prev=initial_output,
+          w=self._kernel,
+          wci=wci,
+          wcf=wcf,
+          wco=wco,
+          b=self._bias,
+          forget_bias=self._forget_bias,
+          cell_clip=self._cell_clip,
+          use_peephole=self._use_peephole)
+      return cs, h
+
+    # Sort the batch by decreasing length so that each time step only computes
+    # the sequences which have not ended yet, then restore the original order.
+    sorted_length, order = nn_ops.top_k(
+        math_ops.to_int32(sequence_length),
+        k=array_ops.shape(sequence_length)[0])
+    _, cs, _, _, _, _, h = gen_lstm_ops.sorted_block_lstm(
+        sequence_length=math_ops.to_int64(sorted_length),
+        x=array_ops.gather(inputs, order, axis=1),
+        cs_prev=array_ops.gather(initial_cell_state, order),
+        h_prev=array_ops.gather(initial_output, order),
         w=self._kernel,
         wci=wci,
         wcf=wcf,
@@ -698,4 +754,6 @@ class LSTMBlockFusedCell(LSTMBlockWrapper):
         forget_bias=self._forget_bias,
         cell_clip=self._cell_clip,
         use_peephole=self._use_peephole)
-    return cs, h
+    inverse_order = array_ops.invert_permutation(order)
+    return (array_ops.gather(cs, inverse_order, axis=1),
+            array_ops.gather(h, inverse_order, axis=1))
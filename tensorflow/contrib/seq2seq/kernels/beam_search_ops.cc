@@ -21,7 +21,11 @@ limitations under the License.
 
 #include "tensorflow/contrib/seq2seq/kernels/beam_search_ops.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
@@ -165,6 +169,188 @@ struct GatherTree<CPUDevice, int32> {
 
 }  // namespace functor
 
+template <typename T>
+class BeamSearchStepOp : public OpKernel {
+ public:
+  explicit BeamSearchStepOp(OpKernelConstruction* ctx) : OpKernel(ctx) {}
+
+  void Compute(OpKernelContext* ctx) override {
+    const Tensor& logits = ctx->input(0);
+    const Tensor& log_probs = ctx->input(1);
+    const Tensor& lengths = ctx->input(2);
+    const Tensor& finished = ctx->input(3);
+    const Tensor& end_token = ctx->input(4);
+    const Tensor& length_penalty_weight = ctx->input(5);
+    OP_REQUIRES(
+        ctx, logits.dims() == 3,
+        errors::InvalidArgument("logits must be a 3-tensor, saw shape: ",
+                                logits.shape().DebugString()));
+    const int64 batch_size = logits.dim_size(0);
+    const int64 beam_width = logits.dim_size(1);
+    const int64 vocab_size = logits.dim_size(2);
+    const TensorShape beams_shape({batch_size, beam_width});
+    for (int i = 1; i < 4; ++i) {
+      OP_REQUIRES(ctx, ctx->input(i).shape() == beams_shape,
+                  errors::InvalidArgument(
+                      "Input ", i, " must have shape ",
+                      beams_shape.DebugString(), ", saw shape: ",
+                      ctx->input(i).shape().DebugString()));
+    }
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(end_token.shape()),
+                errors::InvalidArgument("end_token must be a scalar, saw "
+                                        "shape: ",
+                                        end_token.shape().DebugString()));
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(length_penalty_weight.shape()),
+                errors::InvalidArgument(
+                    "length_penalty_weight must be a scalar, saw shape: ",
+                    length_penalty_weight.shape().DebugString()));
+    OP_REQUIRES(ctx, vocab_size > 0,
+                errors::InvalidArgument("logits must have a non-empty vocab "
+                                        "dimension, saw shape: ",
+                                        logits.shape().DebugString()));
+    OP_REQUIRES(ctx,
+                beam_width * vocab_size <= std::numeric_limits<int32>::max(),
+                errors::InvalidArgument("beam_width * vocab_size must fit in "
+                                        "int32, saw shape: ",
+                                        logits.shape().DebugString()));
+
+    Tensor* outputs[6];
+    for (int i = 0; i < 6; ++i) {
+      OP_REQUIRES_OK(ctx, ctx->allocate_output(i, beams_shape, &outputs[i]));
+    }
+    if (batch_size == 0 || beam_width == 0) return;
+
+    const auto logits_t = logits.tensor<T, 3>();
+    const auto log_probs_t = log_probs.matrix<T>();
+    const auto lengths_t = lengths.matrix<int64>();
+    const auto finished_t = finished.matrix<bool>();
+    const int32 end_token_value = end_token.scalar<int32>()();
+    const T penalty_weight = length_penalty_weight.scalar<T>()();
+    auto scores_t = outputs[0]->matrix<T>();
+    auto word_ids_t = outputs[1]->matrix<int32>();
+    auto parent_ids_t = outputs[2]->matrix<int32>();
+    auto next_log_probs_t = outputs[3]->matrix<T>();
+    auto next_lengths_t = outputs[4]->matrix<int64>();
+    auto next_finished_t = outputs[5]->matrix<bool>();
+
+    // The length penalty of a beam continued to the given length.
+    const T penalty_denominator = std::pow(T(6), penalty_weight);
+    auto length_penalty = [penalty_weight, penalty_denominator](int64 length) {
+      return std::pow(T(5) + static_cast<T>(length), penalty_weight) /
+             penalty_denominator;
+    };
+
+    auto DoWork = [&](int64 start_batch, int64 limit_batch) {
+      // The best continuations seen so far as (score, flat index) pairs,
+      // kept as a heap with the worst one on top.
+      typedef std::pair<T, int32> Candidate;
+      auto better = [](const Candidate& a, const Candidate& b) {
+        return a.first > b.first ||
+               (a.first == b.first && a.second < b.second);
+      };
+      std::vector<Candidate> heap;
+      heap.reserve(beam_width);
+      // Per beam, the max logit and the log of the softmax denominator.
+      std::vector<std::pair<T, T>> normalizers(beam_width);
+      for (int64 b = start_batch; b < limit_batch; ++b) {
+        heap.clear();
+        auto consider = [&heap, &better, beam_width](T score, int32 index) {
+          if (static_cast<int64>(heap.size()) < beam_width) {
+            heap.emplace_back(score, index);
+            std::push_heap(heap.begin(), heap.end(), better);
+          } else if (score > heap.front().first) {
+            // Indices only grow, so a tie never displaces the heap top.
+            std::pop_heap(heap.begin(), heap.end(), better);
+            heap.back() = Candidate(score, index);
+            std::push_heap(heap.begin(), heap.end(), better);
+          }
+        };
+        for (int64 j = 0; j < beam_width; ++j) {
+          const int32 offset = static_cast<int32>(j * vocab_size);
+          const T beam_log_prob = log_probs_t(b, j);
+          if (finished_t(b, j)) {
+            // A finished beam only continues with end_token, the rest of
+            // its continuations get the lowest log probability.
+            const T lowest = beam_log_prob + Eigen::NumTraits<T>::lowest();
+            const T penalty =
+                penalty_weight == T(0) ? T(1) : length_penalty(lengths_t(b, j));
+            for (int64 v = 0; v < vocab_size; ++v) {
+              const T total = v == end_token_value ? beam_log_prob : lowest;
+              consider(total / penalty, offset + v);
+            }
+            continue;
+          }
+          const T* row = &logits_t(b, j, 0);
+          const T max_logit = *std::max_element(row, row + vocab_size);
+          T sum = 0;
+          for (int64 v = 0; v < vocab_size; ++v) {
+            sum += std::exp(row[v] - max_logit);
+          }
+          const T log_sum = std::log(sum);
+          normalizers[j] = std::make_pair(max_logit, log_sum);
+          // The total log probability of continuing with word v, summed in
+          // the same order as log_softmax followed by an add.
+          auto total = [beam_log_prob, row, max_logit, log_sum](int64 v) {
+            return beam_log_prob + ((row[v] - max_logit) - log_sum);
+          };
+          if (penalty_weight == T(0)) {
+            for (int64 v = 0; v < vocab_size; ++v) {
+              consider(total(v), offset + v);
+            }
+          } else {
+            // Continuing with end_token does not add to the length.
+            const T penalty = length_penalty(lengths_t(b, j) + 1);
+            const T end_penalty = length_penalty(lengths_t(b, j));
+            for (int64 v = 0; v < vocab_size; ++v) {
+              consider(
+                  total(v) / (v == end_token_value ? end_penalty : penalty),
+                  offset + v);
+            }
+          }
+        }
+        std::sort_heap(heap.begin(), heap.end(), better);
+        for (int64 k = 0; k < beam_width; ++k) {
+          const int32 index = heap[k].second;
+          const int32 parent = index / vocab_size;
+          const int32 word = index % vocab_size;
+          const bool parent_finished = finished_t(b, parent);
+          scores_t(b, k) = heap[k].first;
+          word_ids_t(b, k) = word;
+          parent_ids_t(b, k) = parent;
+          if (!parent_finished) {
+            next_log_probs_t(b, k) =
+                log_probs_t(b, parent) +
+                ((logits_t(b, parent, word) - normalizers[parent].first) -
+                 normalizers[parent].second);
+          } else if (word == end_token_value) {
+            next_log_probs_t(b, k) = log_probs_t(b, parent);
+          } else {
+            next_log_probs_t(b, k) =
+                log_probs_t(b, parent) + Eigen::NumTraits<T>::lowest();
+          }
+          next_lengths_t(b, k) = lengths_t(b, parent) + !parent_finished;
+          next_finished_t(b, k) = parent_finished || word == end_token_value;
+        }
+      }
+    };
+    // Roughly an exp and a heap comparison per logit.
+    const int64 batch_cost =
+        beam_width * vocab_size *
+        (Eigen::TensorOpCost::AddCost<T>() + 20);
+    auto worker_threads = *(ctx->device()->tensorflow_cpu_worker_threads());
+    Shard(worker_threads.num_threads, worker_threads.workers, batch_size,
+          batch_cost, DoWork);
+  }
+};
+
+#define REGISTER_KERNEL(T)                                              \
+  REGISTER_KERNEL_BUILDER(                                              \
+      Name("BeamSearchStep").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      BeamSearchStepOp<T>);
+REGISTER_KERNEL(float);
+REGISTER_KERNEL(double);
+#undef REGISTER_KERNEL
+
 #if GOOGLE_CUDA
 namespace functor {
 #define DECLARE_GPU_SPEC(T)                                            \
@@ -69,4 +69,64 @@ end_token: `[]`.
 beams: `[max_time, batch_size, beam_width]`.
 )doc");
 
+REGISTER_OP("BeamSearchStep")
+    .Input("logits: T")
+    .Input("log_probs: T")
+    .Input("lengths: int64")
+    .Input("finished: bool")
+    .Input("end_token: int32")
+    .Input("length_penalty_weight: T")
+    .Output("scores: T")
+    .Output("word_ids: int32")
+    .Output("parent_ids: int32")
+    .Output("next_log_probs: T")
+    .Output("next_lengths: int64")
+    .Output("next_finished: bool")
+    .Attr("T: {float, double}")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle logits, beams, unused;
+
+      // logits is shaped [batch_size, beam_width, vocab_size], the other
+      // inputs and all the outputs are shaped [batch_size, beam_width].
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 3, &logits));
+      TF_RETURN_IF_ERROR(c->Subshape(logits, 0, 2, &beams));
+      for (int i = 1; i < 4; ++i) {
+        TF_RETURN_IF_ERROR(c->WithRank(c->input(i), 2, &unused));
+        TF_RETURN_IF_ERROR(c->Merge(beams, c->input(i), &beams));
+      }
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(4), 0, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(5), 0, &unused));
+
+      for (int i = 0; i < 6; ++i) {
+        c->set_output(i, beams);
+      }
+      return tensorflow::Status::OK();
+    })
+    .Doc(R"doc(
+Performs one step of beam search decoding in a single pass.
+
+Fuses the log softmax of `logits`, the masking of finished beams (which only
+continue with `end_token`), the length penalty, the selection of the best
+`beam_width` continuations of each batch entry and the gathering of their
+log probabilities, lengths and finished flags. The scores of the continuations
+are the total log probabilities divided by
+`((5 + length) / 6) ** length_penalty_weight`. Ties are broken in favor of the
+lower flat `beam * vocab_size + word` index, as in `TopKV2`.
+
+logits: `[batch_size, beam_width, vocab_size]`.
+log_probs: `[batch_size, beam_width]`, the total log probabilities of the
+  beams.
+lengths: `[batch_size, beam_width]`, the lengths of the beams.
+finished: `[batch_size, beam_width]`, whether each beam is finished.
+end_token: `[]`.
+length_penalty_weight: `[]`, disabled with 0.
+scores: `[batch_size, beam_width]`, the scores of the selected continuations,
+  best first.
+word_ids: `[batch_size, beam_width]`, their word ids.
+parent_ids: `[batch_size, beam_width]`, the beams they continue.
+next_log_probs: `[batch_size, beam_width]`, their total log probabilities.
+next_lengths: `[batch_size, beam_width]`, their lengths.
+next_finished: `[batch_size, beam_width]`, whether they are finished.
+)doc");
+
 }  // end namespace tensorflow
@@ -23,8 +23,11 @@ import itertools
 
 import numpy as np
 
+from tensorflow.contrib.seq2seq.python.ops import beam_search_decoder
 from tensorflow.contrib.seq2seq.python.ops import beam_search_ops
+from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import ops
+from tensorflow.python.ops import array_ops
 from tensorflow.python.platform import test
 
 
@@ -138,5 +141,90 @@ class GatherTreeTest(test.TestCase):
                               end_token * np.ones_like(v[found + 1:]))
 
 
+class BeamSearchStepTest(test.TestCase):
+
+  def _testMatchesUnfusedStep(self, length_penalty_weight):
+    batch_size = 3
+    beam_width = 4
+    vocab_size = 7
+    end_token = 2
+    np.random.seed(1)
+    logits = np.random.randn(batch_size, beam_width,
+                             vocab_size).astype(np.float32)
+    log_probs = -np.random.rand(batch_size, beam_width).astype(np.float32)
+    lengths = np.random.randint(1, 5, size=(batch_size, beam_width))
+    finished = np.array([[False, True, False, False],
+                         [True, True, False, True],
+                         [False, False, False, False]])
+    beam_state = beam_search_decoder.BeamSearchDecoderState(
+        cell_state=None,
+        log_probs=ops.convert_to_tensor(log_probs),
+        lengths=ops.convert_to_tensor(lengths, dtype=dtypes.int64),
+        finished=ops.convert_to_tensor(finished))
+
+    fused = beam_search_ops.beam_search_step(
+        logits=logits,
+        log_probs=beam_state.log_probs,
+        lengths=beam_state.lengths,
+        finished=beam_state.finished,
+        end_token=end_token,
+        length_penalty_weight=length_penalty_weight)
+    unfused = beam_search_decoder._select_next_beams(
+        logits=ops.convert_to_tensor(logits),
+        beam_state=beam_state,
+        batch_size=ops.convert_to_tensor(batch_size),
+        beam_width=beam_width,
+        end_token=end_token,
+        length_penalty_weight=length_penalty_weight)
+
+    with self.test_session():
+      fused_values = [t.eval() for t in fused]
+      unfused_values = [t.eval() for t in unfused]
+    # scores, word_ids, parent_ids, log_probs, lengths, finished.
+    for i in (1, 2, 4, 5):
+      self.assertAllEqual(unfused_values[i], fused_values[i])
+    for i in (0, 3):
+      self.assertAllClose(unfused_values[i], fused_values[i])
+
+  def testMatchesUnfusedStep(self):
+    self._testMatchesUnfusedStep(length_penalty_weight=0.0)
+
+  def testMatchesUnfusedStepWithLengthPenalty(self):
+    self._testMatchesUnfusedStep(length_penalty_weight=0.6)
+
+  def testFirstStepOnlyContinuesFirstBeam(self):
+    # As set up by BeamSearchDecoder.initialize.
+    logits = np.log([[[0.1, 0.2, 0.7], [0.1, 0.2, 0.7]]]).astype(np.float32)
+    inf = np.float32(np.inf)
+    scores, word_ids, parent_ids, log_probs, lengths, finished = (
+        beam_search_ops.beam_search_step(
+            logits=logits,
+            log_probs=[[0., -inf]],
+            lengths=np.zeros([1, 2], dtype=np.int64),
+            finished=[[False, True]],
+            end_token=0,
+            length_penalty_weight=0.))
+    with self.test_session():
+      self.assertAllClose([[np.log(0.7), np.log(0.2)]], scores.eval())
+      self.assertAllEqual([[2, 1]], word_ids.eval())
+      self.assertAllEqual([[0, 0]], parent_ids.eval())
+      self.assertAllClose([[np.log(0.7), np.log(0.2)]], log_probs.eval())
+      self.assertAllEqual([[1, 1]], lengths.eval())
+      self.assertAllEqual([[False, False]], finished.eval())
+
+  def testBadShape(self):
+    log_probs = array_ops.placeholder(dtypes.float32)
+    scores = beam_search_ops.beam_search_step(
+        logits=np.zeros([1, 2, 3], dtype=np.float32),
+        log_probs=log_probs,
+        lengths=np.zeros([1, 2], dtype=np.int64),
+        finished=np.zeros([1, 2], dtype=np.bool),
+        end_token=0,
+        length_penalty_weight=0.)[0]
+    with self.test_session():
+      with self.assertRaisesOpError("Input 1 must have shape"):
+        scores.eval(feed_dict={log_probs: np.zeros([1, 3])})
+
+
 if __name__ == "__main__":
   test.main()
@@ -275,7 +275,8 @@ class BeamSearchDecoder(decoder.Decoder):
                beam_width,
                output_layer=None,
                length_penalty_weight=0.0,
-               reorder_tensor_arrays=True):
+               reorder_tensor_arrays=True,
+               fused_step=False):
     """Initialize the BeamSearchDecoder.
 
     Args:
@@ -296,6 +297,9 @@ class BeamSearchDecoder(decoder.Decoder):
         Otherwise, the `TensorArray` will be returned as is. Set this flag to
         `False` if the cell state contains `TensorArray`s that are not amenable
         to reordering.
+      fused_step: If `True`, the log softmax, length penalty, top-k selection
+        and gathering of each step run in a single `BeamSearchStep` op instead
+        of a chain of small ones. The op only has a CPU kernel.
 
     Raises:
       TypeError: if `cell` is not an instance of `RNNCell`,
@@ -311,6 +315,7 @@ class BeamSearchDecoder(decoder.Decoder):
     self._cell = cell
     self._output_layer = output_layer
     self._reorder_tensor_arrays = reorder_tensor_arrays
+    self._fused_step = fused_step
 
     if callable(embedding):
       self._embedding_fn = embedding
@@ -659,7 +664,8 @@ class BeamSearchDecoder(decoder.Decoder):
           batch_size=batch_size,
           beam_width=beam_width,
           end_token=end_token,
-          length_penalty_weight=length_penalty_weight)
+          length_penalty_weight=length_penalty_weight,
+          fused=self._fused_step)
 
       finished = beam_search_state.finished
       sample_ids = beam_search_output.predicted_ids
@@ -671,7 +677,8 @@ class BeamSearchDecoder(decoder.Decoder):
 
 
 def _beam_search_step(time, logits, next_cell_state, beam_state, batch_size,
-                      beam_width, end_token, length_penalty_weight):
+                      beam_width, end_token, length_penalty_weight,
+                      fused=False):
   """Performs a single step of Beam Search Decoding.
 
   Args:
@@ -688,11 +695,85 @@ def _beam_search_step(time, logits, next_cell_state, beam_state, batch_size,
     beam_width: Python int.  The size of the beams.
     end_token: The int32 end token.
     length_penalty_weight: Float weight to penalize length. Disabled with 0.0.
+    fused: Python bool. If `True` and `logits` are `float32` or `float64`, the
+      next beams are picked by the fused `BeamSearchStep` op.
 
   Returns:
     A new beam state.
   """
   static_batch_size = tensor_util.constant_value(batch_size)
+  time = ops.convert_to_tensor(time, name="time")
+
+  if fused and logits.dtype in (dtypes.float32, dtypes.float64):
+    (next_beam_scores, next_word_ids, next_beam_ids, next_beam_probs,
+     next_prediction_len, next_finished) = beam_search_ops.beam_search_step(
+         logits=logits,
+         log_probs=beam_state.log_probs,
+         lengths=beam_state.lengths,
+         finished=beam_state.finished,
+         end_token=end_token,
+         length_penalty_weight=math_ops.cast(length_penalty_weight,
+                                             logits.dtype))
+    next_beam_scores.set_shape([static_batch_size, beam_width])
+    next_word_ids.set_shape([static_batch_size, beam_width])
+  else:
+    (next_beam_scores, next_word_ids, next_beam_ids, next_beam_probs,
+     next_prediction_len, next_finished) = _select_next_beams(
+         logits=logits,
+         beam_state=beam_state,
+         batch_size=batch_size,
+         beam_width=beam_width,
+         end_token=end_token,
+         length_penalty_weight=length_penalty_weight)
+
+  # Pick out the cell_states according to the next_beam_ids. We use a
+  # different gather_shape here because the cell_state tensors, i.e.
+  # the tensors that would be gathered from, all have dimension
+  # greater than two and we need to preserve those dimensions.
+  # pylint: disable=g-long-lambda
+  next_cell_state = nest.map_structure(
+      lambda gather_from: _maybe_tensor_gather_helper(
+          gather_indices=next_beam_ids,
+          gather_from=gather_from,
+          batch_size=batch_size,
+          range_size=beam_width,
+          gather_shape=[batch_size * beam_width, -1]),
+      next_cell_state)
+  # pylint: enable=g-long-lambda
+
+  next_state = BeamSearchDecoderState(
+      cell_state=next_cell_state,
+      log_probs=next_beam_probs,
+      lengths=next_prediction_len,
+      finished=next_finished)
+
+  output = BeamSearchDecoderOutput(
+      scores=next_beam_scores,
+      predicted_ids=next_word_ids,
+      parent_ids=next_beam_ids)
+
+  return output, next_state
+
+
+def _select_next_beams(logits, beam_state, batch_size, beam_width, end_token,
+                       length_penalty_weight):
+  """Picks the best continuations of the beams, as `BeamSearchStep` does.
+
+  Args:
+    logits: Logits at the current time step. A tensor of shape
+      `[batch_size, beam_width, vocab_size]`
+    beam_state: Current state of the beam search.
+      An instance of `BeamSearchDecoderState`.
+    batch_size: The batch size for this input.
+    beam_width: Python int.  The size of the beams.
+    end_token: The int32 end token.
+    length_penalty_weight: Float weight to penalize length. Disabled with 0.0.
+
+  Returns:
+    A tuple `(scores, word_ids, parent_ids, log_probs, lengths, finished)` of
+    `[batch_size, beam_width]` tensors describing the next beams.
+  """
+  static_batch_size = tensor_util.constant_value(batch_size)
 
   # Calculate the current lengths of the predictions
   prediction_lengths = beam_state.lengths
@@ -723,8 +804,6 @@ def _beam_search_step(time, logits, next_cell_state, beam_state, batch_size,
       sequence_lengths=new_prediction_lengths,
       length_penalty_weight=length_penalty_weight)
 
-  time = ops.convert_to_tensor(time, name="time")
-  # During the first time step we only consider the initial beam
   scores_flat = array_ops.reshape(scores, [batch_size, -1])
 
   # Pick the next beams according to the specified successors function
@@ -780,33 +859,8 @@ def _beam_search_step(time, logits, next_cell_state, beam_state, batch_size,
       gather_shape=[-1])
   next_prediction_len += lengths_to_add
 
-  # Pick out the cell_states according to the next_beam_ids. We use a
-  # different gather_shape here because the cell_state tensors, i.e.
-  # the tensors that would be gathered from, all have dimension
-  # greater than two and we need to preserve those dimensions.
-  # pylint: disable=g-long-lambda
-  next_cell_state = nest.map_structure(
-      lambda gather_from: _maybe_tensor_gather_helper(
-          gather_indices=next_beam_ids,
-          gather_from=gather_from,
-          batch_size=batch_size,
-          range_size=beam_width,
-          gather_shape=[batch_size * beam_width, -1]),
-      next_cell_state)
-  # pylint: enable=g-long-lambda
-
-  next_state = BeamSearchDecoderState(
-      cell_state=next_cell_state,
-      log_probs=next_beam_probs,
-      lengths=next_prediction_len,
-      finished=next_finished)
-
-  output = BeamSearchDecoderOutput(
-      scores=next_beam_scores,
-      predicted_ids=next_word_ids,
-      parent_ids=next_beam_ids)
-
-  return output, next_state
+  return (next_beam_scores, next_word_ids, next_beam_ids, next_beam_probs,
+          next_prediction_len, next_finished)
 
 
 def _get_scores(log_probs, sequence_lengths, length_penalty_weight):
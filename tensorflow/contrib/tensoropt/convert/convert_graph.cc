@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
 #include <unordered_map>
 #include <utility>
@@ -30,6 +31,8 @@ limitations under the License.
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/graph_constructor.h"
 #include "tensorflow/core/grappler/clusters/virtual_cluster.h"
+#include "tensorflow/core/grappler/costs/graph_properties.h"
+#include "tensorflow/core/grappler/grappler_item.h"
 #include "tensorflow/core/grappler/devices.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -219,15 +222,22 @@ void GetSubGraphOutgoingEdges(const tensorflow::Graph& graph,
 struct ConvertGraphParams {
   ConvertGraphParams(tensorflow::Graph& inp_graph,
                      const std::set<int>& subgraph_node_id_numbers,
-                     const string& device_name, int device_id)
+                     const string& device_name, int device_id,
+                     const EngineOptions& options,
+                     const tensorflow::grappler::GraphProperties* props)
       : graph(inp_graph),
         subgraph_node_ids(subgraph_node_id_numbers),
         device_name_(device_name),
-        device_id_(device_id) {}
+        device_id_(device_id),
+        engine_options(options),
+        properties(props) {}
   tensorflow::Graph& graph;
   const std::set<int>& subgraph_node_ids;
   string device_name_;
   int device_id_;
+  const EngineOptions& engine_options;
+  // Static shapes of the graph, only set when precompiling the engines
+  const tensorflow::grappler::GraphProperties* properties;
   std::vector<std::pair<int, int>> subgraph_inputs;
   std::vector<std::pair<int, int>> subgraph_outputs;
   std::map<std::pair<int, int>, int> subgraph_edge_to_input_map;
@@ -391,6 +401,52 @@ string ConvertSubGraphToProto(const tensorflow::Graph& graph,
   return graph_def_str;
 }
 
+// Fills shapes with the input shapes the engine should be compiled for ahead
+// of time, one group of params->subgraph_inputs.size() shapes per
+// compilation. Leaves shapes empty if an input shape is not known statically.
+void GetPrecompiledInputShapes(
+    const ConvertGraphParams& params,
+    std::vector<tensorflow::TensorShapeProto>* shapes) {
+  const auto& buckets = params.engine_options.batch_buckets;
+  std::vector<tensorflow::TensorShapeProto> input_shapes;
+  bool unknown_batch = false;
+  for (const auto& node_port_pair : params.subgraph_inputs) {
+    const tensorflow::Node* node =
+        params.graph.FindNodeId(node_port_pair.first);
+    const auto& output_props =
+        params.properties->GetOutputProperties(node->name());
+    if (node_port_pair.second >= static_cast<int>(output_props.size())) {
+      return;
+    }
+    const auto& shape = output_props[node_port_pair.second].shape();
+    if (shape.unknown_rank()) {
+      return;
+    }
+    for (int i = 0; i < shape.dim_size(); ++i) {
+      if (shape.dim(i).size() >= 0) {
+        continue;
+      }
+      if (i > 0 || buckets.empty()) {
+        return;
+      }
+      unknown_batch = true;
+    }
+    input_shapes.push_back(shape);
+  }
+  if (!unknown_batch) {
+    *shapes = std::move(input_shapes);
+    return;
+  }
+  for (int bucket : buckets) {
+    for (auto shape : input_shapes) {
+      if (shape.dim_size() > 0) {
+        shape.mutable_dim(0)->set_size(bucket);
+      }
+      shapes->push_back(std::move(shape));
+    }
+  }
+}
+
 tensorflow::Status ConvertSubGraphToTensorOpt(ConvertGraphParams* params) {
   TF_RETURN_IF_ERROR(FillSubGraphEdgeSets(params));
   tensorflow::NodeDef topt_node_def;
@@ -427,6 +483,17 @@ tensorflow::Status ConvertSubGraphToTensorOpt(ConvertGraphParams* params) {
 
   string graph_def_str = ConvertSubGraphToProto(params->graph, order);
 
+  std::vector<tensorflow::TensorShapeProto> precompiled_input_shapes;
+  if (params->properties) {
+    GetPrecompiledInputShapes(*params, &precompiled_input_shapes);
+    VLOG(1) << "Precompiling " << engine_name << " for "
+            << (params->subgraph_inputs.empty()
+                    ? 0
+                    : precompiled_input_shapes.size() /
+                          params->subgraph_inputs.size())
+            << " input shapes";
+  }
+
   if (params->device_name_[0] != '/') {
     params->device_name_ = "/device:" + params->device_name_;
   }
@@ -439,6 +506,12 @@ tensorflow::Status ConvertSubGraphToTensorOpt(ConvertGraphParams* params) {
                .Attr("output_names", params->output_names)
                .Attr("InT", params->input_dtypes)
                .Attr("OutT", params->output_dtypes)
+               .Attr("max_cached_engines",
+                     params->engine_options.max_cached_engines)
+               .Attr("batch_buckets", params->engine_options.batch_buckets)
+               .Attr("precompiled_input_shapes", precompiled_input_shapes)
+               .Attr("background_compilation",
+                     params->engine_options.background_compilation)
                .Device(params->device_name_)
                .Finalize(&topt_node_def);
 
@@ -518,7 +591,8 @@ tensorflow::Status ConvertGraphDefToTensorOpt(
     const tensorflow::GraphDef& gdef,
     const std::vector<string>& graph_output_names,
     tensorflow::GraphDef* new_graph_def, int minimum_segment_size,
-    const tensorflow::grappler::Cluster* cluster) {
+    const tensorflow::grappler::Cluster* cluster,
+    const EngineOptions& engine_options) {
   // Segment the graph into subgraphs that can be converted to TensorOpt
   tensorflow::tensoropt::segment::SegmentOptions segment_options;
   tensorflow::FunctionLibraryDefinition flib(tensorflow::OpRegistry::Global(),
@@ -545,6 +619,18 @@ tensorflow::Status ConvertGraphDefToTensorOpt(
   }
   std::unordered_map<string, tensorflow::Node*> node_map;
   TF_RETURN_IF_ERROR(BuildNodeMap(graph, &node_map));
+  std::unique_ptr<tensorflow::grappler::GraphProperties> properties;
+  if (engine_options.precompile && !segments.empty()) {
+    tensorflow::grappler::GrapplerItem item;
+    item.graph = gdef;
+    properties.reset(new tensorflow::grappler::GraphProperties(item));
+    tensorflow::Status status = properties->InferStatically(false);
+    if (!status.ok()) {
+      LOG(WARNING) << "Could not infer the shapes to precompile the TensorOpt "
+                   << "engines: " << status;
+      properties.reset();
+    }
+  }
   int count = 0;
   // We create the map here since cluster may not be available in all cases.
   std::map<string, tensorflow::Device*> name_to_device_map;
@@ -582,7 +668,8 @@ tensorflow::Status ConvertGraphDefToTensorOpt(
     for (const string& node_name : subgraph_node_names) {
       subgraph_node_ids.insert(node_map.at(node_name)->id());
     }
-    ConvertGraphParams p(graph, subgraph_node_ids, device_name, device_id);
+    ConvertGraphParams p(graph, subgraph_node_ids, device_name, device_id,
+                         engine_options, properties.get());
     tensorflow::Status status = ConvertSubGraphToTensorOpt(&p);
 
     if (status != tensorflow::Status::OK()) {
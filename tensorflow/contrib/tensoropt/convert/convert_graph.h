@@ -29,10 +29,30 @@ namespace tensorflow {
 namespace tensoropt {
 namespace convert {
 
+// Options of the TOPTEngineOp nodes created by the conversion.
+struct EngineOptions {
+  // Maximum number of compiled models kept by each TOPTEngineOp, the least
+  // recently used one being evicted first. 0 means unbounded.
+  int max_cached_engines = 16;
+  // If not empty, the batch dimension of the inputs is padded up to the next
+  // bucket and the outputs are sliced back, so that a few compilations cover
+  // all the batch sizes up to the largest bucket.
+  std::vector<int> batch_buckets;
+  // Record the statically known input shapes of each engine, so that it
+  // compiles them when it is created instead of on the first run. If
+  // batch_buckets is set an unknown batch dimension is replaced by each
+  // bucket.
+  bool precompile = false;
+  // Compile the models for new input shapes on a background thread, running
+  // the original subgraph until they are ready.
+  bool background_compilation = false;
+};
+
 tensorflow::Status ConvertGraphDefToTensorOpt(
     const tensorflow::GraphDef& graph, const std::vector<string>& output_names,
     tensorflow::GraphDef* new_graph_def, int minimum_segment_size,
-    const tensorflow::grappler::Cluster* cluster = nullptr);
+    const tensorflow::grappler::Cluster* cluster = nullptr,
+    const EngineOptions& engine_options = EngineOptions());
 
 }  // namespace convert
 }  // namespace tensoropt
@@ -15,6 +15,9 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/contrib/tensoropt/convert/topt_optimization_pass.h"
+
+#include <algorithm>
+
 #include "tensorflow/contrib/tensoropt/convert/convert_graph.h"
 #include "tensorflow/core/grappler/clusters/cluster.h"
 #include "tensorflow/core/grappler/grappler_item.h"
@@ -47,6 +50,22 @@ tensorflow::Status TOPTOptimizationPass::Init(
   }
   if (params.count("max_workspace_size_bytes"))
     maximum_workspace_size_ = params.at("max_workspace_size_bytes").i();
+  if (params.count("max_cached_engines")) {
+    engine_options_.max_cached_engines = params.at("max_cached_engines").i();
+  }
+  if (params.count("batch_buckets")) {
+    const auto& buckets = params.at("batch_buckets").list().i();
+    engine_options_.batch_buckets.assign(buckets.begin(), buckets.end());
+    std::sort(engine_options_.batch_buckets.begin(),
+              engine_options_.batch_buckets.end());
+  }
+  if (params.count("precompile_engines")) {
+    engine_options_.precompile = params.at("precompile_engines").b();
+  }
+  if (params.count("background_compilation")) {
+    engine_options_.background_compilation =
+        params.at("background_compilation").b();
+  }
   if (params.count("precision_mode")) {
     string pm = Uppercase(params.at("precision_mode").s());
     if (pm == "FP32") {
@@ -176,7 +195,8 @@ tensorflow::Status TOPTOptimizationPass::Optimize(
     PrintDebugInfo(cluster, item);
   }
   auto status = tensorflow::tensoropt::convert::ConvertGraphDefToTensorOpt(
-      item.graph, item.fetch, optimized_graph, minimum_segment_size_, cluster);
+      item.graph, item.fetch, optimized_graph, minimum_segment_size_, cluster,
+      engine_options_);
   VLOG(2) << optimized_graph->DebugString();
   return status;
 }
@@ -19,6 +19,7 @@ limitations under the License.
 
 #include <string>
 
+#include "tensorflow/contrib/tensoropt/convert/convert_graph.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/grappler/optimizers/custom_graph_optimizer.h"
 #include "tensorflow/core/platform/logging.h"
@@ -62,6 +63,7 @@ class TOPTOptimizationPass : public tensorflow::grappler::CustomGraphOptimizer {
   int precision_mode_;
   int maximum_batch_size_;
   int64_t maximum_workspace_size_;
+  EngineOptions engine_options_;
 };
 
 }  // namespace convert
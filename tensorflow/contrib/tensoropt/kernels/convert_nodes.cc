@@ -325,6 +325,7 @@ class Converter {
   std::unordered_map<string, OpConverter> op_registry_;
   ANeuralNetworksModel* topt_model_;
   std::vector<std::vector<uint8_t>>& weight_store_;
+  WeightCache* weight_cache_;
 
   void register_op_converters();
 
@@ -371,8 +372,11 @@ class Converter {
 
  public:
   explicit Converter(ANeuralNetworksModel* model,
-                     std::vector<std::vector<uint8_t>>& weight_store)
-      : topt_model_(model), weight_store_(weight_store) {
+                     std::vector<std::vector<uint8_t>>& weight_store,
+                     WeightCache* weight_cache)
+      : topt_model_(model),
+        weight_store_(weight_store),
+        weight_cache_(weight_cache) {
     this->register_op_converters();
   }
 
@@ -425,6 +429,8 @@ class Converter {
 
   ANeuralNetworksModel* model() { return topt_model_; }
 
+  WeightCache* weight_cache() { return weight_cache_; }
+
   TensorOrWeights get_tensor(string name) { return topt_tensors_.at(name); }
 
   bool insert_input_tensor(string name, const TensorOrWeights& topt_tensor) {
@@ -824,9 +830,24 @@ tensorflow::Status ConvertConst(Converter& ctx,
         "Not supported constant type, at " + node_def.name());
   }
   TOPT_CHECK_OK(Model_addOperand(ctx.model(), &weights.op(), &weights.idx()));
-  TOPT_CHECK_OK(Model_setOperandValue(ctx.model(), weights.get_valid_idx(),
-                                      weights.get_data(),
-                                      weights.size_bytes()));
+  // The host copy is still needed by the converters folding constants but the
+  // model reads large weights from the shared device memory
+  if (ctx.weight_cache() &&
+      weights.size_bytes() >
+          ANEURALNETWORKS_MAX_SIZE_OF_IMMEDIATELY_COPIED_VALUES) {
+    ANeuralNetworksMemory* memory = nullptr;
+    uint32_t offset = 0;
+    TF_RETURN_IF_ERROR(ctx.weight_cache()->GetOrUpload(
+        node_def.name(), weights.get_data(), weights.size_bytes(), &memory,
+        &offset));
+    TOPT_CHECK_OK(Model_setOperandValueFromMemory(
+        ctx.model(), weights.get_valid_idx(), memory, offset,
+        weights.size_bytes()));
+  } else {
+    TOPT_CHECK_OK(Model_setOperandValue(ctx.model(), weights.get_valid_idx(),
+                                        weights.get_data(),
+                                        weights.size_bytes()));
+  }
   outputs->push_back(weights);
   VLOG(2) << "Output Const node '" << node_def.name() << "': " << weights;
   return tensorflow::Status::OK();
@@ -1796,6 +1817,33 @@ void Converter::register_op_converters() {
 
 }  // namespace
 
+WeightCache::~WeightCache() {
+  for (auto& weight : weights_) {
+    ANeuralNetworksMemory_free(weight.second.memory);
+  }
+}
+
+tensorflow::Status WeightCache::GetOrUpload(const string& name,
+                                            const void* data,
+                                            size_t size_bytes,
+                                            ANeuralNetworksMemory** memory,
+                                            uint32_t* offset) {
+  mutex_lock lock(mu_);
+  auto weight_it = weights_.find(name);
+  if (weight_it == weights_.end()) {
+    Entry entry;
+    entry.size_bytes = size_bytes;
+    TF_RETURN_IF_ERROR(upload_(data, size_bytes, &entry.memory, &entry.offset));
+    VLOG(2) << "Uploaded " << size_bytes << " bytes of weights for " << name;
+    weight_it = weights_.emplace(name, entry).first;
+  } else if (weight_it->second.size_bytes != size_bytes) {
+    return tensorflow::errors::Internal("Weights of ", name, " changed size");
+  }
+  *memory = weight_it->second.memory;
+  *offset = weight_it->second.offset;
+  return tensorflow::Status::OK();
+}
+
 tensorflow::Status ConvertSubGraphToTensorOptModel(
     const std::list<tensorflow::Node*>& order,
     const std::vector<string>& input_names,
@@ -1804,10 +1852,10 @@ tensorflow::Status ConvertSubGraphToTensorOptModel(
     const std::vector<string>& output_names,
     const std::vector<DataType>& output_types,
     std::vector<std::vector<uint8_t>>& weight_store,
-    ANeuralNetworksModel** topt_model) {
+    ANeuralNetworksModel** topt_model, WeightCache* weight_cache) {
   TOPT_CHECK_OK(Model_create(topt_model));
 
-  Converter converter(*topt_model, weight_store);
+  Converter converter(*topt_model, weight_store, weight_cache);
   std::vector<uint32_t> topt_inputs;
   CHECK_EQ(input_names.size(), input_shapes.size());
   for (unsigned i = 0; i < input_names.size(); ++i) {
@@ -17,6 +17,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CONTRIB_TENSOROPT_KERNELS_CONVERT_NODES_H_
 #define TENSORFLOW_CONTRIB_TENSOROPT_KERNELS_CONVERT_NODES_H_
 
+#include <functional>
 #include <list>
 #include <set>
 #include <string>
@@ -28,6 +29,8 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
 
 #if defined(TENSORFLOW_USE_SYCL) && TF_SYCL_USE_TENSOROPT
 #include "tensorflow/contrib/tensoropt/api/topt_lib_api.h"
@@ -36,6 +39,41 @@ namespace tensorflow {
 namespace tensoropt {
 namespace convert {
 
+// Device memories holding the constants of a subgraph, shared by all the models
+// converted from it so that the weights are only uploaded once whatever the
+// number of input shapes.
+class WeightCache {
+ public:
+  // Uploads size_bytes of data to the device
+  using UploadFn = std::function<tensorflow::Status(
+      const void* data, size_t size_bytes, ANeuralNetworksMemory** memory,
+      uint32_t* offset)>;
+
+  explicit WeightCache(UploadFn upload) : upload_(std::move(upload)) {}
+  ~WeightCache();
+
+  // Returns the memory holding the constant name, uploading it from data the
+  // first time.
+  tensorflow::Status GetOrUpload(const string& name, const void* data,
+                                 size_t size_bytes,
+                                 ANeuralNetworksMemory** memory,
+                                 uint32_t* offset);
+
+ private:
+  struct Entry {
+    ANeuralNetworksMemory* memory;
+    uint32_t offset;
+    size_t size_bytes;
+  };
+
+  UploadFn upload_;
+  mutex mu_;
+  std::unordered_map<string, Entry> weights_ GUARDED_BY(mu_);
+};
+
+// Converts the nodes in order to a TensorOpt model for the given input shapes.
+// If weight_cache is not null the constants are read from device memories
+// shared by the models instead of being copied in each model.
 tensorflow::Status ConvertSubGraphToTensorOptModel(
     const std::list<tensorflow::Node*>& order,
     const std::vector<string>& input_names,
@@ -44,7 +82,7 @@ tensorflow::Status ConvertSubGraphToTensorOptModel(
     const std::vector<string>& output_names,
     const std::vector<DataType>& output_types,
     std::vector<std::vector<uint8_t>>& weight_store,
-    ANeuralNetworksModel** topt_model);
+    ANeuralNetworksModel** topt_model, WeightCache* weight_cache = nullptr);
 
 }  // namespace convert
 }  // namespace tensoropt
@@ -18,6 +18,7 @@ limitations under the License.
 #include "tensorflow/contrib/tensoropt/kernels/convert_nodes.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/graph_to_functiondef.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/graph/graph_constructor.h"
@@ -29,6 +30,8 @@ limitations under the License.
 #if defined(TENSORFLOW_USE_SYCL) && TF_SYCL_USE_TENSOROPT
 #include <SYCL/codeplay.hpp>
 
+#include <algorithm>
+
 namespace tensorflow {
 namespace tensoropt {
 
@@ -36,11 +39,18 @@ using ::tensorflow::str_util::StringReplace;
 using ::tensorflow::str_util::StrContains;
 using ::tensorflow::strings::StrCat;
 
-TOPTEngineOp::TOPTEngineOp(OpKernelConstruction* context) : OpKernel(context) {
+TOPTEngineOp::TOPTEngineOp(OpKernelConstruction* context)
+    : AsyncOpKernel(context) {
   OP_REQUIRES_OK(context, context->GetAttr("input_names", &input_names_));
   OP_REQUIRES_OK(context, context->GetAttr("InT", &input_types_));
   OP_REQUIRES_OK(context, context->GetAttr("output_names", &output_names_));
   OP_REQUIRES_OK(context, context->GetAttr("OutT", &output_types_));
+  OP_REQUIRES_OK(context,
+                 context->GetAttr("max_cached_engines", &max_cached_engines_));
+  OP_REQUIRES_OK(context, context->GetAttr("batch_buckets", &batch_buckets_));
+  std::sort(batch_buckets_.begin(), batch_buckets_.end());
+  OP_REQUIRES_OK(context, context->GetAttr("background_compilation",
+                                           &background_compilation_));
 
   string proto_graph;
   OP_REQUIRES_OK(context, context->GetAttr("proto_graph", &proto_graph));
@@ -77,6 +87,12 @@ TOPTEngineOp::TOPTEngineOp(OpKernelConstruction* context) : OpKernel(context) {
     AddNodeAttr("dtype", input_types_[i], node);
   }
 
+  if (background_compilation_) {
+    OP_REQUIRES_OK(context, CreateNativeFunction(graph_def));
+    compile_thread_.reset(new thread::ThreadPool(
+        context->env(), "topt_compile", 1));
+  }
+
   tensorflow::FunctionLibraryDefinition flib(tensorflow::OpRegistry::Global(),
                                              graph_def.library());
   graph_ptr_ = std::unique_ptr<tensorflow::Graph>(
@@ -91,6 +107,131 @@ TOPTEngineOp::TOPTEngineOp(OpKernelConstruction* context) : OpKernel(context) {
     if (node->IsOp() && node->type_string() != "Placeholder")
       graph_order_.push_front(node);
   }
+
+  // Compile the models for the shapes known when the graph was converted, so
+  // that the first runs do not pay for it.
+  std::vector<TensorShape> precompiled_input_shapes;
+  OP_REQUIRES_OK(context, context->GetAttr("precompiled_input_shapes",
+                                           &precompiled_input_shapes));
+  const size_t input_count = input_names_.size();
+  if (input_count > 0 && !precompiled_input_shapes.empty()) {
+    OP_REQUIRES(context, precompiled_input_shapes.size() % input_count == 0,
+                errors::InvalidArgument(
+                    "Expected a multiple of ", input_count,
+                    " precompiled input shapes, got ",
+                    precompiled_input_shapes.size()));
+    const auto& eigen_device = *context->device()->eigen_sycl_device();
+    for (size_t i = 0; i < precompiled_input_shapes.size(); i += input_count) {
+      std::vector<TensorShape> input_shapes(
+          precompiled_input_shapes.begin() + i,
+          precompiled_input_shapes.begin() + i + input_count);
+      GetCompiledModel(eigen_device, input_shapes);
+    }
+  }
+}
+
+Status TOPTEngineOp::CreateNativeFunction(const GraphDef& graph_def) {
+  // Replace the fake Placeholder nodes by the function arguments and add the
+  // function results
+  GraphDef func_graph_def = graph_def;
+  const int input_count = input_names_.size();
+  const int first_input = func_graph_def.node_size() - input_count;
+  for (int i = 0; i < input_count; ++i) {
+    NodeDef* node = func_graph_def.mutable_node(first_input + i);
+    node->set_op("_Arg");
+    node->clear_attr();
+    AddNodeAttr("T", input_types_[i], node);
+    AddNodeAttr("index", i, node);
+  }
+  for (size_t i = 0; i < output_names_.size(); ++i) {
+    NodeDef* node = func_graph_def.add_node();
+    node->set_name(StrCat(name(), "/native_output_", i));
+    node->set_op("_Retval");
+    node->add_input(output_names_[i]);
+    AddNodeAttr("T", output_types_[i], node);
+    AddNodeAttr("index", static_cast<int>(i), node);
+  }
+
+  native_lib_.reset(new FunctionLibraryDefinition(OpRegistry::Global(),
+                                                  graph_def.library()));
+  Graph func_graph(*native_lib_);
+  TF_RETURN_IF_ERROR(ConvertGraphDefToGraph(GraphConstructorOptions(),
+                                            func_graph_def, &func_graph));
+  native_func_name_ = StrCat(StringReplace(name(), "/", "_", true), "_native");
+  FunctionDef fdef;
+  TF_RETURN_IF_ERROR(GraphToFunctionDef(func_graph, native_func_name_, &fdef));
+  return native_lib_->AddFunctionDef(fdef);
+}
+
+TOPTEngineOp::~TOPTEngineOp() {
+  // The compiled models reference the weights so they must go first
+  compile_thread_.reset();
+  {
+    mutex_lock lock(mu_);
+    lru_.clear();
+    models_.clear();
+  }
+  mutex_lock lock(compile_mu_);
+  weight_cache_.reset();
+  for (void* buffer : weight_buffers_) {
+    weights_device_->deallocate(buffer);
+  }
+}
+
+Status TOPTEngineOp::UploadWeights(const Eigen::SyclDevice& eigen_device,
+                                   const void* data, size_t size_bytes,
+                                   ANeuralNetworksMemory** memory,
+                                   uint32_t* offset) {
+  void* buffer_ptr = eigen_device.allocate(size_bytes);
+  weights_device_ = &eigen_device;
+  weight_buffers_.push_back(buffer_ptr);
+  eigen_device.memcpyHostToDevice(buffer_ptr, data, size_bytes);
+  // The host data only lives until the end of the compilation
+  eigen_device.synchronize();
+  auto sycl_buffer = eigen_device.get_sycl_buffer(buffer_ptr);
+  *offset = eigen_device.get_offset(buffer_ptr);
+  TOPT_CHECK_OK(Memory_createFromBuffer(sycl_buffer, memory));
+  return Status::OK();
+}
+
+int64 TOPTEngineOp::GetBatchBucket(OpKernelContext* context,
+                                   int64* batch_size) const {
+  if (batch_buckets_.empty() || context->num_inputs() == 0) {
+    return -1;
+  }
+  // All the inputs must share the same batch dimension
+  *batch_size = -1;
+  for (int i = 0; i < context->num_inputs(); ++i) {
+    const auto& shape = context->input(i).shape();
+    if (shape.dims() == 0 ||
+        (*batch_size >= 0 && shape.dim_size(0) != *batch_size)) {
+      return -1;
+    }
+    *batch_size = shape.dim_size(0);
+  }
+  auto bucket_it = std::lower_bound(batch_buckets_.begin(),
+                                    batch_buckets_.end(), *batch_size);
+  if (bucket_it == batch_buckets_.end()) {
+    // Larger than the largest bucket, compile for the exact shape
+    return -1;
+  }
+  return *bucket_it;
+}
+
+Status TOPTEngineOp::PadBatch(OpKernelContext* context, const Tensor& t,
+                              int64 bucket, Tensor* padded) const {
+  TensorShape padded_shape = t.shape();
+  padded_shape.set_dim(0, bucket);
+  TF_RETURN_IF_ERROR(context->allocate_temp(t.dtype(), padded_shape, padded));
+  auto& eigen_device = context->eigen_sycl_device();
+  const size_t copy_bytes = t.TotalBytes();
+  auto padded_ptr = static_cast<uint8*>(DMAHelper::base(padded));
+  if (copy_bytes > 0) {
+    eigen_device.memcpy(padded_ptr, DMAHelper::base(&t), copy_bytes);
+  }
+  eigen_device.memset(padded_ptr + copy_bytes, 0,
+                      padded->TotalBytes() - copy_bytes);
+  return Status::OK();
 }
 
 ANeuralNetworksMemory* TOPTEngineOp::CreateTOPTMemoryFromTensor(
@@ -131,133 +272,294 @@ ANeuralNetworksMemory* TOPTEngineOp::CreateTOPTMemoryFromTensorSafe(
   return CreateTOPTMemoryFromTensor(eigen_device, t, offset, length);
 }
 
-void TOPTEngineOp::Compute(OpKernelContext* context) {
-  auto input_count = static_cast<uint32_t>(context->num_inputs());
-  auto output_count = static_cast<uint32_t>(context->num_outputs());
-  std::vector<TensorShape> input_shapes;
-  input_shapes.reserve(input_count);
-  for (unsigned i = 0; i < input_count; ++i) {
-    input_shapes.push_back(context->input(i).shape());
+std::shared_ptr<TOPTEngineOp::CompiledModel> TOPTEngineOp::FindCompiledModel(
+    const std::vector<TensorShape>& input_shapes) {
+  mutex_lock lock(mu_);
+  auto model_it = models_.find(input_shapes);
+  if (model_it == models_.end()) {
+    return nullptr;
   }
-  auto exec_it = executions_.find(input_shapes);
-  ExecutionCache* exec_ptr = nullptr;
-  auto& eigen_device = context->eigen_sycl_device();
+  auto& model = model_it->second;
+  lru_.splice(lru_.begin(), lru_, model->lru_position);
+  return model;
+}
 
-  if (exec_it == executions_.end()) {
-    auto& exec = executions_[input_shapes];
-    exec_ptr = &exec;
+std::shared_ptr<TOPTEngineOp::CompiledModel> TOPTEngineOp::GetCompiledModel(
+    const Eigen::SyclDevice& eigen_device,
+    const std::vector<TensorShape>& input_shapes) {
+  auto model = FindCompiledModel(input_shapes);
+  if (model) {
+    return model;
+  }
+  // Look again once the compilations are serialized so that concurrent calls
+  // with the same shapes only compile the model once. mu_ is not held while
+  // compiling so that the compiled models can still be used.
+  mutex_lock compile_lock(compile_mu_);
+  model = FindCompiledModel(input_shapes);
+  if (model) {
+    return model;
+  }
 
+  if (!topt_device_ptr_) {
     ANeuralNetworksDevice* topt_device = nullptr;
     TOPT_CHECK_OK(
         Device_create(&eigen_device.sycl_queue(), false, &topt_device));
     topt_device_ptr_.reset(topt_device);
+  }
+  ANeuralNetworksDevice* topt_device = topt_device_ptr_.get();
+  if (!weight_cache_) {
+    const Eigen::SyclDevice* device = &eigen_device;
+    weight_cache_.reset(new convert::WeightCache(
+        [this, device](const void* data, size_t size_bytes,
+                       ANeuralNetworksMemory** memory, uint32_t* offset) {
+          return UploadWeights(*device, data, size_bytes, memory, offset);
+        }));
+  }
 
-    // Convert the model
-    auto node_name = context->op_kernel().name();
-    LOG(INFO) << "Converting model " << node_name << " containing "
-              << graph_order_.size() << " nodes";
-    if (VLOG_IS_ON(2)) {
-      std::stringstream input_shapes_ss;
-      if (input_count > 0) {
-        input_shapes_ss << input_shapes[0];
-        for (unsigned i = 1; i < input_count; ++i) {
-          input_shapes_ss << ", " << input_shapes[i];
-        }
+  // Convert the model
+  const auto& node_name = name();
+  LOG(INFO) << "Converting model " << node_name << " containing "
+            << graph_order_.size() << " nodes";
+  if (VLOG_IS_ON(2)) {
+    std::stringstream input_shapes_ss;
+    if (!input_shapes.empty()) {
+      input_shapes_ss << input_shapes[0];
+      for (unsigned i = 1; i < input_shapes.size(); ++i) {
+        input_shapes_ss << ", " << input_shapes[i];
       }
-      VLOG(2) << "Input shapes: " << input_shapes_ss.str();
-    }
-    std::vector<std::vector<uint8_t>> weight_store;
-    ANeuralNetworksModel* topt_model = nullptr;
-    TF_CHECK_OK(convert::ConvertSubGraphToTensorOptModel(
-        graph_order_, input_names_, input_shapes, input_types_, output_names_,
-        output_types_, weight_store, &topt_model));
-
-    // Compile the model
-    VLOG(2) << "Compiling model " << node_name;
-    ANeuralNetworksCompilation* topt_compilation = nullptr;
-    TOPT_CHECK_OK(Compilation_createForDevices(topt_model, &topt_device, 1,
-                                               &topt_compilation));
-    TOPT_CHECK_OK(Compilation_finish(topt_compilation));
-    exec.topt_compilation_ptr.reset(topt_compilation);
-    ANeuralNetworksModel_free(topt_model);
-
-    ANeuralNetworksExecution* topt_execution = nullptr;
-    TOPT_CHECK_OK(Execution_create(topt_compilation, &topt_execution));
-    exec.topt_execution_ptr.reset(topt_execution);
-
-    // Create inputs
-    uint32_t topt_model_input_count =
-        ANeuralNetworksExecution_getIdentifiedInputCount(topt_execution);
-    if (topt_model_input_count != input_count) {
-      LOG(FATAL) << "Failed to execute TensorOpt node, expected "
-                 << topt_model_input_count << " inputs but got " << input_count;
     }
-    // Get the identified operands for debug check
-    std::vector<ANeuralNetworksOperandType> input_ops(topt_model_input_count);
-    TOPT_CHECK_OK(
-        Execution_getIdentifiedInputs(topt_execution, input_ops.data()));
-    exec.topt_memory.resize(input_count + output_count);
-    for (uint32_t i = 0; i < input_count; ++i) {
-      auto input = context->input(i);
-      uint32_t offset;
-      uint32_t length;
-      auto memory = CreateTOPTMemoryFromTensorSafe(
-          eigen_device, input, i, input_ops, "input", offset, length);
-      exec.topt_memory[i].reset(memory);
-      TOPT_CHECK_OK(Execution_setInputFromMemory(topt_execution, i, nullptr,
-                                                 memory, offset, length));
+    VLOG(2) << "Input shapes: " << input_shapes_ss.str();
+  }
+  std::vector<std::vector<uint8_t>> weight_store;
+  ANeuralNetworksModel* topt_model = nullptr;
+  TF_CHECK_OK(convert::ConvertSubGraphToTensorOptModel(
+      graph_order_, input_names_, input_shapes, input_types_, output_names_,
+      output_types_, weight_store, &topt_model, weight_cache_.get()));
+
+  // Compile the model
+  VLOG(2) << "Compiling model " << node_name;
+  ANeuralNetworksCompilation* topt_compilation = nullptr;
+  TOPT_CHECK_OK(Compilation_createForDevices(topt_model, &topt_device, 1,
+                                             &topt_compilation));
+  TOPT_CHECK_OK(Compilation_finish(topt_compilation));
+  ANeuralNetworksModel_free(topt_model);
+
+  model = std::make_shared<CompiledModel>();
+  model->topt_compilation_ptr.reset(topt_compilation);
+
+  mutex_lock lock(mu_);
+  if (max_cached_engines_ > 0 &&
+      models_.size() >= static_cast<size_t>(max_cached_engines_)) {
+    VLOG(1) << "Evicting the least recently used model of " << name();
+    models_.erase(lru_.back());
+    lru_.pop_back();
+  }
+  lru_.push_front(input_shapes);
+  model->lru_position = lru_.begin();
+  models_.emplace(input_shapes, model);
+  pending_compilations_.erase(input_shapes);
+  return model;
+}
+
+Status TOPTEngineOp::CreateExecutionContext(
+    OpKernelContext* context, const CompiledModel& model,
+    const std::vector<Tensor>& inputs,
+    std::unique_ptr<ExecutionContext>* exec_ptr) {
+  auto input_count = static_cast<uint32_t>(context->num_inputs());
+  auto output_count = static_cast<uint32_t>(context->num_outputs());
+  auto& eigen_device = context->eigen_sycl_device();
+  exec_ptr->reset(new ExecutionContext);
+  auto& exec = **exec_ptr;
+
+  ANeuralNetworksExecution* topt_execution = nullptr;
+  TOPT_CHECK_OK(
+      Execution_create(model.topt_compilation_ptr.get(), &topt_execution));
+  exec.topt_execution_ptr.reset(topt_execution);
+
+  // Create inputs
+  uint32_t topt_model_input_count =
+      ANeuralNetworksExecution_getIdentifiedInputCount(topt_execution);
+  if (topt_model_input_count != input_count) {
+    LOG(FATAL) << "Failed to execute TensorOpt node, expected "
+               << topt_model_input_count << " inputs but got " << input_count;
+  }
+  // Get the identified operands for debug check
+  std::vector<ANeuralNetworksOperandType> input_ops(topt_model_input_count);
+  TOPT_CHECK_OK(
+      Execution_getIdentifiedInputs(topt_execution, input_ops.data()));
+  exec.topt_memory.resize(input_count + output_count);
+  for (uint32_t i = 0; i < input_count; ++i) {
+    const auto& input = inputs[i];
+    uint32_t offset;
+    uint32_t length;
+    auto memory = CreateTOPTMemoryFromTensorSafe(
+        eigen_device, input, i, input_ops, "input", offset, length);
+    exec.topt_memory[i].reset(memory);
+    TOPT_CHECK_OK(Execution_setInputFromMemory(topt_execution, i, nullptr,
+                                               memory, offset, length));
+  }
+
+  // Create and bind outputs
+  uint32_t topt_model_output_count =
+      ANeuralNetworksExecution_getIdentifiedOutputCount(topt_execution);
+  if (topt_model_output_count != output_count) {
+    LOG(FATAL) << "Failed to execute TensorOpt node, expected "
+               << topt_model_output_count << " outputs but got "
+               << output_count;
+  }
+  std::vector<ANeuralNetworksOperandType> output_ops(topt_model_output_count);
+  TOPT_CHECK_OK(
+      Execution_getIdentifiedOutputs(topt_execution, output_ops.data()));
+  exec.output_tensors.reserve(output_count);
+  std::stringstream output_shapes_ss;
+  for (uint32_t i = 0; i < output_count; ++i) {
+    exec.output_tensors.emplace_back();
+    auto& output = exec.output_tensors.back();
+    TensorShape output_shape;
+    for (uint32_t j = 0; j < output_ops[i].dimensionCount; ++j)
+      output_shape.AddDim(output_ops[i].dimensions[j]);
+    if (VLOG_IS_ON(2)) {
+      if (i > 0) {
+        output_shapes_ss << ", ";
+      }
+      output_shapes_ss << output_shape;
     }
+    Tensor* out_tensor = nullptr;
+    AllocatorAttributes attr;
+    attr.set_on_host(false);
+    attr.set_gpu_compatible(true);
+    TF_RETURN_IF_ERROR(context->allocate_persistent(
+        output_types_[i], output_shape, &output, &out_tensor, attr));
+    uint32_t offset;
+    uint32_t length;
+    auto memory = CreateTOPTMemoryFromTensorSafe(
+        eigen_device, *out_tensor, i, output_ops, "output", offset, length);
+    exec.topt_memory[input_count + i].reset(memory);
+    TOPT_CHECK_OK(Execution_setOutputFromMemory(topt_execution, i, nullptr,
+                                                memory, offset, length));
+  }
+  VLOG(2) << "Output shapes: " << output_shapes_ss.str();
+  return Status::OK();
+}
 
-    // Create and bind outputs
-    uint32_t topt_model_output_count =
-        ANeuralNetworksExecution_getIdentifiedOutputCount(topt_execution);
-    if (topt_model_output_count != output_count) {
-      LOG(FATAL) << "Failed to execute TensorOpt node, expected "
-                 << topt_model_output_count << " outputs but got "
-                 << output_count;
+void TOPTEngineOp::ComputeAsync(OpKernelContext* context, DoneCallback done) {
+  auto input_count = static_cast<uint32_t>(context->num_inputs());
+  int64 batch_size = -1;
+  const int64 bucket = GetBatchBucket(context, &batch_size);
+  const bool pad_batch = bucket > batch_size;
+  std::vector<Tensor> inputs;
+  std::vector<TensorShape> input_shapes;
+  inputs.reserve(input_count);
+  input_shapes.reserve(input_count);
+  for (unsigned i = 0; i < input_count; ++i) {
+    if (pad_batch) {
+      Tensor padded;
+      OP_REQUIRES_OK_ASYNC(
+          context, PadBatch(context, context->input(i), bucket, &padded),
+          done);
+      inputs.push_back(padded);
+    } else {
+      inputs.push_back(context->input(i));
     }
-    std::vector<ANeuralNetworksOperandType> output_ops(topt_model_output_count);
-    TOPT_CHECK_OK(
-        Execution_getIdentifiedOutputs(topt_execution, output_ops.data()));
-    exec.output_tensors.reserve(output_count);
-    std::stringstream output_shapes_ss;
-    for (uint32_t i = 0; i < output_count; ++i) {
-      exec.output_tensors.emplace_back();
-      auto& output = exec.output_tensors.back();
-      const auto& out_op = output_ops[i];
-      TensorShape output_shape;
-      for (uint32_t j = 0; j < output_ops[i].dimensionCount; ++j)
-        output_shape.AddDim(output_ops[i].dimensions[j]);
-      if (VLOG_IS_ON(2)) {
-        if (i > 0) {
-          output_shapes_ss << ", ";
-        }
-        output_shapes_ss << output_shape;
+    input_shapes.push_back(inputs.back().shape());
+  }
+
+  std::shared_ptr<CompiledModel> model;
+  if (background_compilation_) {
+    model = FindCompiledModel(input_shapes);
+    if (!model) {
+      bool schedule = false;
+      {
+        mutex_lock lock(mu_);
+        schedule = pending_compilations_.insert(input_shapes).second;
+      }
+      if (schedule) {
+        const Eigen::SyclDevice* eigen_device = &context->eigen_sycl_device();
+        compile_thread_->Schedule([this, eigen_device, input_shapes]() {
+          GetCompiledModel(*eigen_device, input_shapes);
+        });
       }
-      Tensor* out_tensor = nullptr;
-      AllocatorAttributes attr;
-      attr.set_on_host(false);
-      attr.set_gpu_compatible(true);
-      OP_REQUIRES_OK(
-          context, context->allocate_persistent(output_types_[i], output_shape,
-                                                &output, &out_tensor, attr));
-      uint32_t offset;
-      uint32_t length;
-      auto memory = CreateTOPTMemoryFromTensorSafe(
-          eigen_device, *out_tensor, i, output_ops, "output", offset, length);
-      exec.topt_memory[input_count + i].reset(memory);
-      TOPT_CHECK_OK(Execution_setOutputFromMemory(topt_execution, i, nullptr,
-                                                  memory, offset, length));
+      ExecuteNativeSegment(context, std::move(done));
+      return;
     }
-    VLOG(2) << "Output shapes: " << output_shapes_ss.str();
-  } else {  // model is already compiled
-    exec_ptr = &exec_it->second;
+  } else {
+    model = GetCompiledModel(context->eigen_sycl_device(), input_shapes);
+  }
+  ExecuteEngine(context, model.get(), inputs, pad_batch ? bucket : -1,
+                batch_size);
+  done();
+}
+
+void TOPTEngineOp::ExecuteNativeSegment(OpKernelContext* context,
+                                         DoneCallback done) {
+  auto lib = context->function_library();
+  OP_REQUIRES_ASYNC(context, lib != nullptr,
+                    errors::Internal("No function library for ", name()),
+                    done);
+  FunctionLibraryRuntime::Handle handle;
+  {
+    mutex_lock lock(native_mu_);
+    if (native_lib_runtime_ != lib) {
+      FunctionLibraryRuntime::InstantiateOptions inst_opts;
+      inst_opts.overlay_lib = native_lib_.get();
+      OP_REQUIRES_OK_ASYNC(
+          context,
+          lib->Instantiate(native_func_name_, AttrSlice(), inst_opts,
+                           &native_handle_),
+          done);
+      native_lib_runtime_ = lib;
+    }
+    handle = native_handle_;
+  }
+  VLOG(2) << "Running " << name() << " natively";
 
-    // Update inputs
+  FunctionLibraryRuntime::Options opts;
+  opts.step_id = context->step_id();
+  opts.rendezvous = context->rendezvous();
+  opts.cancellation_manager = context->cancellation_manager();
+  opts.runner = context->runner();
+  std::vector<Tensor> args;
+  args.reserve(context->num_inputs());
+  for (int i = 0; i < context->num_inputs(); ++i) {
+    args.push_back(context->input(i));
+  }
+  auto outputs = new std::vector<Tensor>;
+  lib->Run(opts, handle, args, outputs,
+           [context, outputs, done](const Status& s) {
+             std::unique_ptr<std::vector<Tensor>> outputs_deleter(outputs);
+             OP_REQUIRES_OK_ASYNC(context, s, done);
+             for (size_t i = 0; i < outputs->size(); ++i) {
+               context->set_output(i, (*outputs)[i]);
+             }
+             done();
+           });
+}
+
+void TOPTEngineOp::ExecuteEngine(OpKernelContext* context,
+                                 CompiledModel* model,
+                                 const std::vector<Tensor>& inputs,
+                                 int64 bucket, int64 batch_size) {
+  auto input_count = static_cast<uint32_t>(context->num_inputs());
+  auto output_count = static_cast<uint32_t>(context->num_outputs());
+  auto& eigen_device = context->eigen_sycl_device();
+
+  // Check out an execution context, creating one if all of them are in use
+  std::unique_ptr<ExecutionContext> exec_ptr;
+  {
+    mutex_lock lock(model->mu);
+    if (!model->free_contexts.empty()) {
+      exec_ptr = std::move(model->free_contexts.back());
+      model->free_contexts.pop_back();
+    }
+  }
+  if (!exec_ptr) {
+    OP_REQUIRES_OK(context,
+                   CreateExecutionContext(context, *model, inputs, &exec_ptr));
+  } else {  // context already bound to previous inputs
     auto& exec = *exec_ptr;
     for (uint32_t i = 0; i < input_count; ++i) {
       auto memory = exec.topt_memory[i].get();
-      auto input = context->input(i);
+      auto& input = inputs[i];
       auto buffer_ptr = DMAHelper::base(&input);
       auto buffer = eigen_device.get_sycl_buffer(buffer_ptr);
       TOPT_CHECK_OK(Memory_resetBuffer(memory, buffer));
@@ -266,12 +568,22 @@ void TOPTEngineOp::Compute(OpKernelContext* context) {
 
   // Set TF outputs
   for (unsigned i = 0; i < output_count; ++i) {
-    context->set_output(i, *exec_ptr->output_tensors[i].AccessTensor(context));
+    const Tensor& output = *exec_ptr->output_tensors[i].AccessTensor(context);
+    // Drop the padded rows of the outputs sharing the batch dimension
+    if (bucket > 0 && output.dims() > 0 && output.dim_size(0) == bucket) {
+      context->set_output(i, output.Slice(0, batch_size));
+    } else {
+      context->set_output(i, output);
+    }
   }
 
   // No need to wait on the outputed event as no outputs are on the host
   // The SYCL runtime will take care of the dependencies
-  TOPT_CHECK_OK(Execution_startCompute(exec_ptr->topt_execution_ptr.get(), nullptr));
+  TOPT_CHECK_OK(
+      Execution_startCompute(exec_ptr->topt_execution_ptr.get(), nullptr));
+
+  mutex_lock lock(model->mu);
+  model->free_contexts.push_back(std::move(exec_ptr));
 }
 
 REGISTER_KERNEL_BUILDER(Name("TOPTEngineOp").Device(DEVICE_SYCL), TOPTEngineOp);
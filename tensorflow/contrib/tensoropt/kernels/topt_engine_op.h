@@ -19,27 +19,38 @@ limitations under the License.
 
 #include <list>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
 
 #if defined(TENSORFLOW_USE_SYCL) && TF_SYCL_USE_TENSOROPT
 #include "tensorflow/contrib/tensoropt/api/runtime_api.h"
 #include "tensorflow/contrib/tensoropt/api/topt_lib_api.h"
+#include "tensorflow/contrib/tensoropt/kernels/convert_nodes.h"
 #include "tensorflow/contrib/tensoropt/kernels/hash_shapes.h"
 
 namespace tensorflow {
 namespace tensoropt {
 
-class TOPTEngineOp : public OpKernel {
+// Runs a subgraph converted to a TensorOpt model. The model is compiled for
+// each set of input shapes, either on the first run with these shapes or, with
+// background_compilation, on a separate thread while the original subgraph
+// runs natively as a function.
+class TOPTEngineOp : public AsyncOpKernel {
  public:
   explicit TOPTEngineOp(OpKernelConstruction* context);
-  ~TOPTEngineOp() = default;
+  ~TOPTEngineOp() override;
 
-  void Compute(OpKernelContext* context) override;
+  void ComputeAsync(OpKernelContext* context, DoneCallback done) override;
 
  private:
   struct DestroyDevice {
@@ -59,9 +70,9 @@ class TOPTEngineOp : public OpKernel {
     void operator()(ANeuralNetworksMemory* m) { ANeuralNetworksMemory_free(m); }
   };
 
-  struct ExecutionCache {
-    std::unique_ptr<ANeuralNetworksCompilation, DestroyCompilation>
-        topt_compilation_ptr;
+  // Execution of a compiled model with its own bound memories and outputs.
+  // Only one Compute can use a context at a time.
+  struct ExecutionContext {
     std::unique_ptr<ANeuralNetworksExecution, DestroyExecution>
         topt_execution_ptr;
     std::vector<std::unique_ptr<ANeuralNetworksMemory, DestroyMemory>>
@@ -69,9 +80,39 @@ class TOPTEngineOp : public OpKernel {
     std::vector<PersistentTensor> output_tensors;
   };
 
-  // Cache the executions for specific input sizes
-  std::unordered_map<std::vector<TensorShape>, ExecutionCache> executions_;
-  std::unique_ptr<ANeuralNetworksDevice, DestroyDevice> topt_device_ptr_;
+  // Model compiled for specific input sizes along with a pool of execution
+  // contexts, so that concurrent calls to Compute do not share buffers.
+  struct CompiledModel {
+    std::unique_ptr<ANeuralNetworksCompilation, DestroyCompilation>
+        topt_compilation_ptr;
+    mutex mu;
+    // Contexts not used by any Compute, destroyed before the compilation
+    std::vector<std::unique_ptr<ExecutionContext>> free_contexts
+        GUARDED_BY(mu);
+    // Position of the input shapes in lru_
+    std::list<std::vector<TensorShape>>::iterator lru_position;
+  };
+
+  mutex mu_;
+  // Serializes the conversions and compilations
+  mutex compile_mu_ ACQUIRED_AFTER(mu_);
+  // Cache the models for specific input sizes, evicting the least recently
+  // used ones when there are more than max_cached_engines_. Models are shared
+  // so that an evicted model outlives the Compute calls still using it.
+  std::unordered_map<std::vector<TensorShape>, std::shared_ptr<CompiledModel>>
+      models_ GUARDED_BY(mu_);
+  // Input shapes of models_, the most recently used first
+  std::list<std::vector<TensorShape>> lru_ GUARDED_BY(mu_);
+  int max_cached_engines_;
+  // Sorted batch sizes the inputs are padded to, empty if disabled
+  std::vector<int> batch_buckets_;
+  std::unique_ptr<ANeuralNetworksDevice, DestroyDevice> topt_device_ptr_
+      GUARDED_BY(compile_mu_);
+  // Constants uploaded once and shared by all the compiled models
+  std::unique_ptr<convert::WeightCache> weight_cache_ GUARDED_BY(compile_mu_);
+  // Device allocations backing weight_cache_, only used with compile_mu_ held
+  const Eigen::SyclDevice* weights_device_ = nullptr;
+  std::vector<void*> weight_buffers_;
   std::vector<string> input_names_;
   std::vector<tensorflow::DataType> input_types_;
   std::vector<string> output_names_;
@@ -79,6 +120,67 @@ class TOPTEngineOp : public OpKernel {
   std::unique_ptr<tensorflow::Graph> graph_ptr_;
   std::list<tensorflow::Node*> graph_order_;
 
+  bool background_compilation_;
+  // Input shapes being compiled in the background
+  std::unordered_set<std::vector<TensorShape>> pending_compilations_
+      GUARDED_BY(mu_);
+  // Library holding the original subgraph as a function, used while the
+  // models are compiled in the background
+  std::unique_ptr<FunctionLibraryDefinition> native_lib_;
+  string native_func_name_;
+  mutex native_mu_;
+  FunctionLibraryRuntime* native_lib_runtime_ GUARDED_BY(native_mu_) = nullptr;
+  FunctionLibraryRuntime::Handle native_handle_ GUARDED_BY(native_mu_);
+  // Declared last so that the pending compilations are done before the other
+  // members are destroyed
+  std::unique_ptr<thread::ThreadPool> compile_thread_;
+
+  // Builds native_lib_ from the subgraph, its inputs being the Placeholder
+  // nodes at the end of graph_def.
+  Status CreateNativeFunction(const GraphDef& graph_def);
+
+  // Runs the original subgraph through the function library runtime.
+  void ExecuteNativeSegment(OpKernelContext* context, DoneCallback done);
+
+  // Runs model on inputs and sets the outputs of the op.
+  void ExecuteEngine(OpKernelContext* context, CompiledModel* model,
+                     const std::vector<Tensor>& inputs, int64 bucket,
+                     int64 batch_size);
+
+  // Returns the bucket the batch size of the inputs is padded to, or -1 if the
+  // inputs are not bucketed.
+  int64 GetBatchBucket(OpKernelContext* context, int64* batch_size) const;
+
+  // Copies t into a new tensor whose first dimension is bucket, the extra rows
+  // being zero.
+  Status PadBatch(OpKernelContext* context, const Tensor& t, int64 bucket,
+                  Tensor* padded) const;
+
+  // Uploads constant data to a new device allocation owned by the op. Called
+  // by weight_cache_ while converting a model, with compile_mu_ held.
+  Status UploadWeights(const Eigen::SyclDevice& eigen_device, const void* data,
+                       size_t size_bytes, ANeuralNetworksMemory** memory,
+                       uint32_t* offset);
+
+  // Returns the model compiled for input_shapes, or nullptr if it has not been
+  // compiled yet.
+  std::shared_ptr<CompiledModel> FindCompiledModel(
+      const std::vector<TensorShape>& input_shapes) LOCKS_EXCLUDED(mu_);
+
+  // Returns the model compiled for input_shapes, converting and compiling it
+  // on a cache miss.
+  std::shared_ptr<CompiledModel> GetCompiledModel(
+      const Eigen::SyclDevice& eigen_device,
+      const std::vector<TensorShape>& input_shapes)
+      LOCKS_EXCLUDED(mu_, compile_mu_);
+
+  // Creates an execution of model with its inputs bound to inputs and newly
+  // allocated outputs.
+  Status CreateExecutionContext(OpKernelContext* context,
+                                const CompiledModel& model,
+                                const std::vector<Tensor>& inputs,
+                                std::unique_ptr<ExecutionContext>* exec);
+
   ANeuralNetworksMemory* CreateTOPTMemoryFromTensor(
       const Eigen::SyclDevice& eigen_device, const Tensor& t, uint32_t& offset,
       uint32_t& length);
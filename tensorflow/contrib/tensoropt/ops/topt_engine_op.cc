@@ -30,6 +30,10 @@ REGISTER_OP("TOPTEngineOp")
     .Attr("output_names: list(string)")
     .Attr("InT: list(type) >= 0")
     .Attr("OutT: list(type)")
+    .Attr("max_cached_engines: int = 16")
+    .Attr("batch_buckets: list(int) = []")
+    .Attr("precompiled_input_shapes: list(shape) = []")
+    .Attr("background_compilation: bool = false")
     .Input("in_tensor: InT")
     .Output("out_tensor: OutT")
     .SetShapeFn(shape_inference::UnknownShape);
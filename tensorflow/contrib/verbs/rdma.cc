@@ -61,6 +61,22 @@ string MessageTypeToString(RdmaMessageType rmt) {
       return "UNKNOWN MESSAGE";
   }
 }
+
+#ifdef TENSORFLOW_USE_SYCL
+// SYCL buffers can't be registered as memory regions, so tensors in SYCL
+// device memory are staged in SYCL host memory, which is registered by
+// RdmaMgr::InitAllocators.
+bool InSYCLDeviceMemory(Device* device, bool on_host) {
+  return !on_host && device->attributes().device_type() == DEVICE_SYCL;
+}
+
+Allocator* SYCLStagingAllocator(Device* device) {
+  AllocatorAttributes attr;
+  attr.set_on_host(true);
+  attr.set_gpu_compatible(true);
+  return device->GetAllocator(attr);
+}
+#endif  // TENSORFLOW_USE_SYCL
 }  // namespace
 
 // Function to get environment variable
@@ -1056,6 +1072,21 @@ void RdmaTensorResponse::RecvHandler(Rendezvous::ParsedKey parsed,
   Tensor copy;
   TensorProto proto;
   const bool on_host = send_args.alloc_attrs.on_host();
+#ifdef TENSORFLOW_USE_SYCL
+  if (InSYCLDeviceMemory(src_dev_, on_host)) {
+    // The readback is asynchronous, so the RDMA writes of other tensors go
+    // on while this one is copied to the host.
+    copy = Tensor(SYCLStagingAllocator(src_dev_), in.dtype(), in.shape());
+    CountCopies(rm_.name_, (void*)DMAHelper::base(&in),
+                (void*)DMAHelper::base(&copy), in.TotalBytes(), true);
+    send_args.device_context->CopyDeviceTensorToCPU(
+        &in, rm_.name_, src_dev_, &copy,
+        [this, copy, proto, is_dead](const Status& s) {
+          Send(copy, proto, is_dead, s);
+        });
+    return;
+  }
+#endif  // TENSORFLOW_USE_SYCL
   if (src_dev_->tensorflow_gpu_device_info() && !on_host) {
 #if GOOGLE_CUDA
     DeviceContext* send_dev_context = send_args.device_context;
@@ -1537,6 +1568,17 @@ bool RdmaTensorRequest::AllocateTensors() {
     }
     rdma_addr_ = DMAHelper::base(result_tensor_);
     mr_ = RdmaMemoryMgr::Singleton().FindMemoryRegion(rdma_addr_, tensor_size);
+#ifdef TENSORFLOW_USE_SYCL
+    if (InSYCLDeviceMemory(dst_dev_, recv_args_.alloc_attrs.on_host())) {
+      // SYCL device pointers are not host addresses, never RDMA to them.
+      proxy_tensor_ =
+          new Tensor(SYCLStagingAllocator(dst_dev_), result_tensor_->dtype(),
+                     result_tensor_->shape());
+      rdma_addr_ = DMAHelper::base(proxy_tensor_);
+      mr_ =
+          RdmaMemoryMgr::Singleton().FindMemoryRegion(rdma_addr_, tensor_size);
+    }
+#endif  // TENSORFLOW_USE_SYCL
 #if GOOGLE_CUDA
     if (mr_ == nullptr) {
       // Can't RDMA directly to result. Use a proxy.
@@ -1622,6 +1664,18 @@ void RdmaTensorRequest::RecvTensorContent() {
 
   Tensor val;
 
+#ifdef TENSORFLOW_USE_SYCL
+  if (proxy_tensor_ != nullptr) {
+    CountCopies(key_, (void*)DMAHelper::base(proxy_tensor_),
+                (void*)DMAHelper::base(result_tensor_),
+                result_tensor_->TotalBytes(), false);
+    recv_args_.device_context->CopyCPUTensorToDevice(
+        proxy_tensor_, dst_dev_, result_tensor_,
+        [this](const Status& s) { Done(s); });
+    return;
+  }
+#endif  // TENSORFLOW_USE_SYCL
+
 #if GOOGLE_CUDA
   if (proxy_tensor_ != nullptr) {
     CountCopies(key_, (void*)DMAHelper::base(proxy_tensor_),
@@ -23,6 +23,9 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/bfc_allocator.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_util.h"
 #include "tensorflow/core/common_runtime/gpu/process_state.h"
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/common_runtime/sycl/sycl_device.h"
+#endif  // TENSORFLOW_USE_SYCL
 #include "tensorflow/core/distributed_runtime/rpc/grpc_worker_cache.h"
 #include "tensorflow/core/distributed_runtime/session_mgr.h"
 #include "tensorflow/core/framework/allocator_registry.h"
@@ -285,6 +288,10 @@ void RdmaMgr::InitAllocators() {
     ProcessState::singleton()->GetCUDAHostAllocator(0),
     ProcessState::singleton()->GetCPUAllocator(0),
 #endif  // GOOGLE_CUDA
+#ifdef TENSORFLOW_USE_SYCL
+    // Staging memory for the tensors on SYCL devices, see rdma.cc.
+    GSYCLInterface::instance()->GetSYCLHostAllocator(),
+#endif  // TENSORFLOW_USE_SYCL
     cpu_allocator(),
   };
 
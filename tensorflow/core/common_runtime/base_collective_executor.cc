@@ -18,6 +18,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/copy_tensor.h"
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/common_runtime/halving_doubling_reducer.h"
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/common_runtime/ring_reducer.h"
 #include "tensorflow/core/lib/core/notification.h"
@@ -97,19 +98,25 @@ class CollectiveAdapterImpl : public CollectiveAdapter {
   }
 
   // Number of T elements in a particular chunk.
-  inline int64 ChunkElts(int i) const {
-    DCHECK_LT(i, num_chunks_);
+  inline int64 ChunkElts(int i) const { return ChunkRangeElts(i, 1); }
+
+  // Number of T elements in 'num_chunks' consecutive chunks.
+  inline int64 ChunkRangeElts(int i, int num_chunks) const {
+    DCHECK_LE(i + num_chunks, num_chunks_);
     const T* chunk_start = std::min(data_end_, data_start_ + i * chunk_elts_);
-    const T* chunk_end = std::min(data_end_, chunk_start + chunk_elts_);
+    const T* chunk_end =
+        std::min(data_end_, chunk_start + num_chunks * chunk_elts_);
     return chunk_end - chunk_start;
   }
 
   int64 ChunkBytes(int i) const override { return sizeof(T) * ChunkElts(i); }
 
   // Returns a new Tensor that aliases the required chunk.
-  Tensor ChunkAlias(int i) override {
+  Tensor ChunkAlias(int i) override { return ChunkRangeAlias(i, 1); }
+
+  Tensor ChunkRangeAlias(int i, int num_chunks) override {
     int64 start = chunk_elts_ * i;
-    int64 num_elts = ChunkElts(i);
+    int64 num_elts = ChunkRangeElts(i, num_chunks);
     // If this chunk is empty the prior chunk might also be short
     // so always take an empty slice from the front of the tensor
     // to avoid an illegal offset check failure somewhere.
@@ -117,9 +124,11 @@ class CollectiveAdapterImpl : public CollectiveAdapter {
                           : output_.Slice(0, 0);
   }
 
-  Tensor TempChunk(int i) const override {
+  Tensor TempChunk(int i) const override { return TempChunkRange(i, 1); }
+
+  Tensor TempChunkRange(int i, int num_chunks) const override {
     AllocationAttributes empty;
-    return Tensor(allocator_, dt_, {ChunkElts(i)}, empty);
+    return Tensor(allocator_, dt_, {ChunkRangeElts(i, num_chunks)}, empty);
   }
 
   string DebugString() const override {
@@ -182,6 +191,56 @@ CollectiveAdapter* MakeCollectiveAdapter(Tensor* output, int num_chunks,
   }
 }
 
+namespace {
+// Used for executing a sub-operation, e.g. a merge_op instance, with
+// an OpKernelContext based on the one passed into this Op.
+class SubContext {
+ public:
+  OpKernelContext::Params sub_params_;
+  gtl::InlinedVector<TensorValue, 4> sub_inputs_;
+  gtl::InlinedVector<AllocatorAttributes, 4> sub_input_attr_;
+  gtl::InlinedVector<DeviceContext*, 4> sub_input_dc_;
+  // Used only for Binary and Unary Ops for which we require
+  // the calculation to be in-place on the first input.
+  int forward_from_ = 0;
+  OpKernelContext* sub_ctx_;
+  SubContext(OpKernelContext* ctx, OpKernelContext::Params* params,
+             OpKernel* op, Tensor* output, Tensor* input);
+  ~SubContext() { delete sub_ctx_; }
+};
+
+SubContext::SubContext(OpKernelContext* ctx, OpKernelContext::Params* params,
+                       OpKernel* op, Tensor* output, Tensor* input)
+    : sub_params_(*params),
+      sub_inputs_({output, input}),
+      sub_input_attr_({ctx->input_alloc_attr(0), ctx->input_alloc_attr(0)}),
+      sub_input_dc_(
+          {ctx->input_device_context(0), ctx->input_device_context(0)}) {
+  sub_params_.op_kernel = op;
+  sub_params_.inputs = &sub_inputs_;
+  sub_params_.input_alloc_attrs = &sub_input_attr_;
+  sub_params_.input_device_contexts = &sub_input_dc_;
+  sub_params_.eigen_gpu_device = nullptr;
+  sub_params_.ensure_eigen_gpu_device();
+  sub_params_.forward_from_array = &forward_from_;
+  sub_ctx_ = new OpKernelContext(&sub_params_, 1);
+}
+}  // namespace
+
+Status ComputeBinOp(OpKernelContext* ctx, OpKernelContext::Params* params,
+                    Device* device, OpKernel* op, Tensor* output,
+                    Tensor* input) {
+  // Prepare an OpKernelContext that is identical to that of the original Op
+  // (i.e. the collective), except for the input output sizes and identities and
+  // the Op itself.
+  // TODO(tucker): Is it possible to cache and reuse these objects?  They're
+  // mostly identical inside one device execution.
+  std::unique_ptr<SubContext> sub_ctx(
+      new SubContext(ctx, params, op, output, input));
+  device->Compute(op, sub_ctx->sub_ctx_);
+  return sub_ctx->sub_ctx_->status();
+}
+
 BaseCollectiveExecutor::~BaseCollectiveExecutor() {}
 
 void BaseCollectiveExecutor::StartAbort(const Status& s) {
@@ -217,7 +276,7 @@ void BaseCollectiveExecutor::ExecuteAsync(OpKernelContext* ctx,
       // TODO(tucker): support other reduction algorithms,
       // e.g. tree-reduce, hybrid tree/ring, delegate-to-NCCL, etc.
       const Tensor* input = &ctx->input(0);
-      RingReducer* reducer =
+      CollectiveImplementation* reducer =
           CreateReducer(ctx, CtxParams(ctx), col_params, exec_key, step_id_,
                         input, output, &error);
       if (!reducer) {
@@ -258,7 +317,14 @@ void BaseCollectiveExecutor::ExecuteAsync(OpKernelContext* ctx,
   }
 }
 
-RingReducer* BaseCollectiveExecutor::CreateReducer(
+namespace {
+// Reductions of tensors up to this size use the halving-doubling algorithm
+// when the group size allows it, since they are dominated by the latency of
+// the 2 * (group_size - 1) sequential steps of the ring algorithm.
+constexpr int64 kHalvingDoublingMaxBytes = 1 << 20;
+}  // namespace
+
+CollectiveImplementation* BaseCollectiveExecutor::CreateReducer(
     OpKernelContext* ctx, OpKernelContext::Params* params,
     const CollectiveParams& col_params, const string& exec_key, int64 step_id,
     const Tensor* input, Tensor* output, string* error) {
@@ -270,13 +336,48 @@ RingReducer* BaseCollectiveExecutor::CreateReducer(
             "DEVICE_GPU";
         return nullptr;
       }
+#ifdef TENSORFLOW_USE_SYCL
+      // As on GPUs, int32 tensors live in host memory on SYCL devices.
+      if (col_params.group.device_type == DEVICE_SYCL) {
+        *error =
+            "Collective Reduce does not support datatype DT_INT32 on "
+            "DEVICE_SYCL";
+        return nullptr;
+      }
+#endif  // TENSORFLOW_USE_SYCL
       TF_FALLTHROUGH_INTENDED;
     case DT_FLOAT:
     case DT_DOUBLE:
-    case DT_INT64:
-      return new RingReducer(this, dev_mgr_, ctx, params, col_params, exec_key,
-                             step_id, input, output);
-      break;
+    case DT_INT64: {
+      string name = col_params.instance.impl_details.collective_name;
+      if (name.empty()) {
+        // Every device of the group reduces a tensor of the same size, so
+        // they all make the same choice.
+        const int group_size = col_params.group.group_size;
+        name = (group_size > 2 &&
+                HalvingDoublingReducer::IsSupportedGroupSize(group_size) &&
+                input->TotalBytes() <= kHalvingDoublingMaxBytes)
+                   ? "HalvingDoublingReduce"
+                   : "RingReduce";
+      }
+      if (name == "RingReduce") {
+        return new RingReducer(this, dev_mgr_, ctx, params, col_params,
+                               exec_key, step_id, input, output);
+      } else if (name == "HalvingDoublingReduce") {
+        if (!HalvingDoublingReducer::IsSupportedGroupSize(
+                col_params.group.group_size)) {
+          *error = strings::StrCat(
+              "HalvingDoublingReduce does not support a group of size ",
+              col_params.group.group_size);
+          return nullptr;
+        }
+        return new HalvingDoublingReducer(this, dev_mgr_, ctx, params,
+                                          col_params, exec_key, step_id, input,
+                                          output);
+      }
+      *error = strings::StrCat("Unknown reduction algorithm ", name);
+      return nullptr;
+    } break;
     default:
       *error = strings::StrCat("Collective Reduce does not support datatype ",
                                col_params.instance.data_type);
@@ -296,6 +397,15 @@ Broadcaster* BaseCollectiveExecutor::CreateBroadcaster(
             "DEVICE_GPU";
         return nullptr;
       }
+#ifdef TENSORFLOW_USE_SYCL
+      // As on GPUs, int32 tensors live in host memory on SYCL devices.
+      if (col_params.group.device_type == DEVICE_SYCL) {
+        *error =
+            "Collective Broadcast does not support datatype DT_INT32 on "
+            "DEVICE_SYCL";
+        return nullptr;
+      }
+#endif  // TENSORFLOW_USE_SYCL
       TF_FALLTHROUGH_INTENDED;
     case DT_FLOAT:
     case DT_DOUBLE:
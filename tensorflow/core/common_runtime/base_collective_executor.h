@@ -22,8 +22,18 @@ limitations under the License.
 
 namespace tensorflow {
 class Broadcaster;
+class Device;
 class DeviceMgr;
-class RingReducer;
+
+// Algorithm computing a collective op on behalf of a single device, e.g.
+// RingReducer. One instance is created for each execution of the op.
+class CollectiveImplementation {
+ public:
+  virtual ~CollectiveImplementation() {}
+
+  // Computes the collective, then calls 'done'.
+  virtual void Run(StatusCallback done) = 0;
+};
 
 // Helper interface that aliases regular subfields of a Tensor as separate
 // Tensors for in-place update.
@@ -42,11 +52,19 @@ class CollectiveAdapter {
   // Returns tensor for chunk i which aliases the backing buffer.
   virtual Tensor ChunkAlias(int i) = 0;
 
+  // Returns tensor for the 'num_chunks' consecutive chunks starting at
+  // chunk i, which aliases the backing buffer.
+  virtual Tensor ChunkRangeAlias(int i, int num_chunks) = 0;
+
   // Returns tensor allocated on the same device but with its own
   // separate backing buffer.  Will have same type and size as
   // chunk i.
   virtual Tensor TempChunk(int i) const = 0;
 
+  // As TempChunk, for the 'num_chunks' consecutive chunks starting at
+  // chunk i.
+  virtual Tensor TempChunkRange(int i, int num_chunks) const = 0;
+
   // Bytes in chunk i
   virtual int64 ChunkBytes(int i) const = 0;
 
@@ -80,6 +98,15 @@ class CollectiveAdapter {
 CollectiveAdapter* MakeCollectiveAdapter(Tensor* output, int num_chunks,
                                          Allocator* allocator);
 
+// Computes the binary kernel 'op' of a reduction, e.g. its merge_op or
+// final_op, on 'device', in place on 'output' with 'input' as its second
+// input. The OpKernelContext of the kernel is identical to 'ctx', the
+// context of the collective op whose params are 'params', except for the
+// inputs, outputs and kernel.
+Status ComputeBinOp(OpKernelContext* ctx, OpKernelContext::Params* params,
+                    Device* device, OpKernel* op, Tensor* output,
+                    Tensor* input);
+
 // Default implementation of CollectiveExecutor.  Delegates the actual
 // work of moving data to a class specialized for the operation type,
 // arguments and device+interconnect topology.
@@ -133,12 +160,12 @@ class BaseCollectiveExecutor : public CollectiveExecutor {
   std::unique_ptr<PerStepCollectiveRemoteAccess> remote_access_;
 
  private:
-  RingReducer* CreateReducer(OpKernelContext* ctx,
-                             OpKernelContext::Params* params,
-                             const CollectiveParams& col_params,
-                             const string& exec_key, int64 step_id,
-                             const Tensor* input, Tensor* output,
-                             string* error);
+  CollectiveImplementation* CreateReducer(OpKernelContext* ctx,
+                                         OpKernelContext::Params* params,
+                                         const CollectiveParams& col_params,
+                                         const string& exec_key, int64 step_id,
+                                         const Tensor* input, Tensor* output,
+                                         string* error);
 
   Broadcaster* CreateBroadcaster(OpKernelContext* ctx,
                                  OpKernelContext::Params* params,
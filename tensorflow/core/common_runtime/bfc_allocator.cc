@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include <atomic>
+#include <thread>
 
 #include "tensorflow/core/common_runtime/bfc_allocator.h"
 
@@ -188,6 +189,86 @@ void BFCAllocator::DeallocateChunk(ChunkHandle h) {
   free_chunks_list_ = h;
 }
 
+void BFCAllocator::EnableChunkCaches() {
+  chunk_caches_.reset(new ChunkCache[kNumChunkCaches]);
+}
+
+BFCAllocator::ChunkCache* BFCAllocator::ChunkCacheForThread() {
+  const size_t hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+  return &chunk_caches_[hash % kNumChunkCaches];
+}
+
+// lock_ is held shared: no chunk is split, merged or moved meanwhile, and
+// the cached chunks are only accessed through their cache.
+void* BFCAllocator::AllocateFromChunkCache(BinNum bin_num,
+                                           size_t rounded_bytes,
+                                           size_t num_bytes)
+    NO_THREAD_SAFETY_ANALYSIS {
+  tf_shared_lock l(lock_);
+  ChunkCache* cache = ChunkCacheForThread();
+  mutex_lock cache_lock(cache->mu);
+  std::vector<CachedChunk>* chunks = &cache->chunks[bin_num];
+  for (auto it = chunks->rbegin(); it != chunks->rend(); ++it) {
+    // Chunks that FindChunkPtr would split are left to the bins.
+    if (it->size < rounded_bytes || it->size >= rounded_bytes * 2) {
+      continue;
+    }
+    Chunk* chunk = ChunkFromHandle(it->h);
+    chunk->requested_size = num_bytes;
+    chunk->allocation_id = next_allocation_id_++;
+    cache->bytes -= it->size;
+    cached_bytes_ -= it->size;
+    chunks->erase(std::next(it).base());
+    ++num_cached_allocs_;
+    return chunk->ptr;
+  }
+  return nullptr;
+}
+
+bool BFCAllocator::DeallocateToChunkCache(void* ptr, ChunkCache** flush)
+    NO_THREAD_SAFETY_ANALYSIS {
+  tf_shared_lock l(lock_);
+  BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
+  CHECK(h != kInvalidChunkHandle);
+  const size_t size = ChunkFromHandle(h)->size;
+  const BinNum bin_num = BinNumForSize(size);
+  if (bin_num >= kNumCachedBins) {
+    return false;
+  }
+  ChunkCache* cache = ChunkCacheForThread();
+  mutex_lock cache_lock(cache->mu);
+  if (++cache->num_deallocations >= kChunkCacheFlushInterval) {
+    cache->num_deallocations = 0;
+    *flush = cache;
+    return false;
+  }
+  if (cache->bytes + size > kMaxCachedBytesPerCache) {
+    return false;
+  }
+  cache->chunks[bin_num].push_back(CachedChunk{h, size});
+  cache->bytes += size;
+  cached_bytes_ += size;
+  return true;
+}
+
+void BFCAllocator::FlushChunkCache(ChunkCache* cache) {
+  mutex_lock cache_lock(cache->mu);
+  for (std::vector<CachedChunk>& chunks : cache->chunks) {
+    for (const CachedChunk& chunk : chunks) {
+      FreeAndMaybeCoalesce(chunk.h);
+    }
+    chunks.clear();
+  }
+  cached_bytes_ -= cache->bytes;
+  cache->bytes = 0;
+}
+
+void BFCAllocator::FlushChunkCaches() {
+  for (int i = 0; i < kNumChunkCaches; ++i) {
+    FlushChunkCache(&chunk_caches_[i]);
+  }
+}
+
 void* BFCAllocator::AllocateRaw(size_t unused_alignment, size_t num_bytes) {
   // Fast path: Try once to allocate without getting the retry_helper_ involved
   void* r = AllocateRawInternal(unused_alignment, num_bytes, false);
@@ -254,12 +335,28 @@ void* BFCAllocator::AllocateRawInternal(size_t unused_alignment,
   // The BFC allocator tries to find the best fit first.
   BinNum bin_num = BinNumForSize(rounded_bytes);
 
+  if (chunk_caches_ != nullptr && bin_num < kNumCachedBins) {
+    void* ptr = AllocateFromChunkCache(bin_num, rounded_bytes, num_bytes);
+    if (ptr != nullptr) {
+      return ptr;
+    }
+  }
+
   mutex_lock l(lock_);
   void* ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
   if (ptr != nullptr) {
     return ptr;
   }
 
+  // Return the cached chunks before growing the memory.
+  if (cached_bytes_ > 0) {
+    FlushChunkCaches();
+    ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
+    if (ptr != nullptr) {
+      return ptr;
+    }
+  }
+
   // Try to extend
   if (Extend(unused_alignment, rounded_bytes)) {
     ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
@@ -381,6 +478,10 @@ void BFCAllocator::DeallocateRawInternal(void* ptr) {
     LOG(ERROR) << "tried to deallocate nullptr";
     return;
   }
+  ChunkCache* flush = nullptr;
+  if (chunk_caches_ != nullptr && DeallocateToChunkCache(ptr, &flush)) {
+    return;
+  }
   mutex_lock l(lock_);
 
   // Find the chunk from the ptr.
@@ -390,6 +491,10 @@ void BFCAllocator::DeallocateRawInternal(void* ptr) {
   // Consider coalescing it.
   FreeAndMaybeCoalesce(h);
 
+  if (flush != nullptr) {
+    FlushChunkCache(flush);
+  }
+
   if (VLOG_IS_ON(4)) {
     LOG(INFO) << "F: " << RenderOccupancy();
   }
@@ -682,16 +787,94 @@ void BFCAllocator::DumpMemoryLog(size_t num_bytes) {
 
 void BFCAllocator::GetStats(AllocatorStats* stats) {
   mutex_lock l(lock_);
+  if (chunk_caches_ != nullptr) {
+    FlushChunkCaches();
+  }
   *stats = stats_;
+  stats->num_allocs += num_cached_allocs_;
 }
 
 void BFCAllocator::ClearStats() {
   mutex_lock l(lock_);
+  num_cached_allocs_ = 0;
   stats_.num_allocs = 0;
   stats_.max_bytes_in_use = stats_.bytes_in_use;
   stats_.max_alloc_size = 0;
 }
 
+bool BFCAllocator::GetFragmentation(AllocatorFragmentation* fragmentation) {
+  mutex_lock l(lock_);
+  if (chunk_caches_ != nullptr) {
+    FlushChunkCaches();
+  }
+  fragmentation->num_regions = region_manager_.regions().size();
+  fragmentation->region_bytes = total_region_allocated_bytes_;
+  fragmentation->free_bytes = 0;
+  fragmentation->largest_free_block_bytes = 0;
+  fragmentation->free_bytes_per_bin.assign(kNumBins, 0);
+  for (BinNum bin_num = 0; bin_num < kNumBins; bin_num++) {
+    Bin* b = BinFromIndex(bin_num);
+    if (b->free_chunks.empty()) {
+      continue;
+    }
+    int64 bin_bytes = 0;
+    for (ChunkHandle h : b->free_chunks) {
+      bin_bytes += ChunkFromHandle(h)->size;
+    }
+    fragmentation->free_bytes_per_bin[bin_num] = bin_bytes;
+    fragmentation->free_bytes += bin_bytes;
+    // The free chunks of a bin are sorted by size.
+    fragmentation->largest_free_block_bytes =
+        std::max<int64>(fragmentation->largest_free_block_bytes,
+                        ChunkFromHandle(*b->free_chunks.rbegin())->size);
+  }
+  return true;
+}
+
+void BFCAllocator::Compact() {
+  if (!compaction_enabled_) {
+    return;
+  }
+  mutex_lock l(lock_);
+  if (chunk_caches_ != nullptr) {
+    FlushChunkCaches();
+  }
+  if (!region_visitors_.empty()) {
+    return;
+  }
+  void* largest_region = nullptr;
+  size_t largest_region_size = 0;
+  std::vector<std::pair<void*, size_t>> idle_regions;
+  for (const auto& region : region_manager_.regions()) {
+    if (region.memory_size() > largest_region_size) {
+      largest_region = region.ptr();
+      largest_region_size = region.memory_size();
+    }
+    const Chunk* c = ChunkFromHandle(region_manager_.get_handle(region.ptr()));
+    if (c->in_use() || c->size != region.memory_size()) {
+      region_idle_compactions_.erase(region.ptr());
+      continue;
+    }
+    if (++region_idle_compactions_[region.ptr()] >= kRegionIdleCompactions) {
+      idle_regions.emplace_back(region.ptr(), region.memory_size());
+    }
+  }
+  for (const auto& region : idle_regions) {
+    if (region.first == largest_region) {
+      continue;
+    }
+    VLOG(1) << "Releasing idle region at " << region.first << " of "
+            << strings::HumanReadableNumBytes(region.second);
+    const ChunkHandle h = region_manager_.get_handle(region.first);
+    RemoveFreeChunkFromBin(h);
+    DeleteChunk(h);
+    region_manager_.RemoveAllocationRegion(region.first);
+    region_idle_compactions_.erase(region.first);
+    suballocator_->Free(region.first, region.second);
+    total_region_allocated_bytes_ -= region.second;
+  }
+}
+
 std::array<BFCAllocator::BinDebugInfo, BFCAllocator::kNumBins>
 BFCAllocator::get_bin_debug_info() {
   std::array<BinDebugInfo, kNumBins> bin_infos;
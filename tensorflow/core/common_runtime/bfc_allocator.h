@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_COMMON_RUNTIME_BFC_ALLOCATOR_H_
 
 #include <array>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -72,6 +73,31 @@ class BFCAllocator : public VisitableAllocator {
 
   void ClearStats() override;
 
+  // Keeps the deallocated chunks of the bins of up to 64KiB in small caches,
+  // one per group of threads, which serve the next allocations of their
+  // sizes. These allocations and deallocations only take lock_ in shared
+  // mode, and the lock of their cache, so they don't serialize with the
+  // others. The cached chunks stay in use for the bins. A cache holds at
+  // most kMaxCachedBytesPerCache and is flushed back to the bins after
+  // kChunkCacheFlushInterval of its deallocations, which bounds the
+  // fragmentation. All caches are flushed before the memory is extended and
+  // before GetStats, max_bytes_in_use includes the cached chunks.
+  //
+  // Must be called before the first allocation.
+  void EnableChunkCaches();
+
+  bool GetFragmentation(AllocatorFragmentation* fragmentation) override;
+
+  // Flushes the chunk caches, and gives the regions which were entirely free
+  // at the last kRegionIdleCompactions calls back to the sub-allocator, so
+  // that the memory can later be obtained again as larger regions. The
+  // largest region is always kept, and no region is released once a region
+  // visitor was added. Does nothing unless EnableCompaction() was called.
+  void Compact() override;
+
+  // Must be called before the first allocation.
+  void EnableCompaction() { compaction_enabled_ = true; }
+
  private:
   struct Bin;
 
@@ -263,6 +289,13 @@ class BFCAllocator : public VisitableAllocator {
       regions_.insert(entry, AllocationRegion(ptr, memory_size));
     }
 
+    void RemoveAllocationRegion(void* ptr) {
+      auto entry =
+          std::upper_bound(regions_.begin(), regions_.end(), ptr, &Comparator);
+      CHECK(entry != regions_.end() && entry->ptr() == ptr);
+      regions_.erase(entry);
+    }
+
     ChunkHandle get_handle(const void* p) const {
       return RegionFor(p)->get_handle(p);
     }
@@ -348,6 +381,44 @@ class BFCAllocator : public VisitableAllocator {
 
   Chunk* ChunkFromHandle(ChunkHandle h) EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // The chunk caches, see EnableChunkCaches().
+  static const int kNumChunkCaches = 16;
+  // The bins up to the one of 64KiB chunks.
+  static const int kNumCachedBins = 9;
+  static const size_t kMaxCachedBytesPerCache = 1 << 20;
+  static const int kChunkCacheFlushInterval = 1 << 14;
+
+  struct CachedChunk {
+    ChunkHandle h;
+    size_t size;
+  };
+
+  struct ChunkCache {
+    mutex mu;
+    // The cached chunks of each bin, the latest last.
+    std::vector<CachedChunk> chunks[kNumCachedBins] GUARDED_BY(mu);
+    size_t bytes GUARDED_BY(mu) = 0;
+    int num_deallocations GUARDED_BY(mu) = 0;
+  };
+
+  ChunkCache* ChunkCacheForThread();
+
+  // Returns a cached chunk of the bin which fits rounded_bytes without
+  // needing a split, nullptr if there is none.
+  void* AllocateFromChunkCache(BinNum bin_num, size_t rounded_bytes,
+                               size_t num_bytes);
+
+  // Caches the chunk of ptr if it is small enough and the cache not full.
+  // Sets *flush to the cache of the thread when it is due for a flush.
+  bool DeallocateToChunkCache(void* ptr, ChunkCache** flush);
+
+  // Returns the chunks of the caches to their bins.
+  void FlushChunkCache(ChunkCache* cache) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void FlushChunkCaches() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // See Compact().
+  static const int kRegionIdleCompactions = 8;
+
   // Information about a Bin that is useful for debugging.
   struct BinDebugInfo {
     size_t total_bytes_in_use = 0;
@@ -430,12 +501,25 @@ class BFCAllocator : public VisitableAllocator {
   std::vector<Visitor> region_visitors_ GUARDED_BY(lock_);
 
   // Counter containing the next unique identifier to assign to a
-  // newly-created chunk.
-  int64 next_allocation_id_ GUARDED_BY(lock_);
+  // newly-created chunk. Atomic for the chunk caches.
+  std::atomic<int64> next_allocation_id_;
 
   // Stats.
   AllocatorStats stats_ GUARDED_BY(lock_);
 
+  // Null unless EnableChunkCaches() was called.
+  std::unique_ptr<ChunkCache[]> chunk_caches_;
+  // The bytes of the chunks in the caches.
+  std::atomic<size_t> cached_bytes_{0};
+  // The allocations served by the caches, not counted in stats_.
+  std::atomic<int64> num_cached_allocs_{0};
+
+  bool compaction_enabled_ = false;
+  // The number of consecutive calls to Compact() which found each region
+  // entirely free.
+  std::unordered_map<const void*, int> region_idle_compactions_
+      GUARDED_BY(lock_);
+
   friend class GPUBFCAllocatorPrivateMethodsTest;
   TF_DISALLOW_COPY_AND_ASSIGN(BFCAllocator);
 };
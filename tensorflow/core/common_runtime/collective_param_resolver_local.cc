@@ -460,6 +460,22 @@ void CollectiveParamResolverLocal::InitInstanceSharedParams(
   // called by a derived class, some of the devices may be non-local and
   // GetDeviceLocalitiesAsync will use those fields to launch RPCs.
   CompleteTaskIsLocal(task_name_, &ir->shared);
+
+  // The rank order of a group only needs to be established once, which saves
+  // the remote locality lookups of the following instances.
+  bool ranked = false;
+  {
+    mutex_lock gl(gr->mu);
+    if (!gr->ranked_device_names.empty()) {
+      ir->shared.instance.device_names = gr->ranked_device_names;
+      ir->shared.instance.task_names = gr->ranked_task_names;
+      ranked = true;
+    }
+  }
+  if (ranked) {
+    done(Status::OK());
+    return;
+  }
   std::vector<DeviceLocality>* localities = new std::vector<DeviceLocality>;
   dev_resolver_->GetDeviceLocalitiesAsync(
       ir->shared.instance, localities,
@@ -499,6 +515,11 @@ void CollectiveParamResolverLocal::CompleteDefaultRanking(
 
   ir->shared.instance.device_names = new_device_names;
   ir->shared.instance.task_names = new_task_names;
+  {
+    mutex_lock gl(gr->mu);
+    gr->ranked_device_names = new_device_names;
+    gr->ranked_task_names = new_task_names;
+  }
   if (VLOG_IS_ON(2)) {
     string buf;
     for (const auto& d : cp->instance.device_names)
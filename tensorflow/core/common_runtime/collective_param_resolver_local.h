@@ -63,6 +63,12 @@ class CollectiveParamResolverLocal : public ParamResolverInterface {
     std::set<string> task_set GUARDED_BY(mu);
     std::vector<string> task_list GUARDED_BY(mu);
     std::vector<StatusCallback> waiting GUARDED_BY(mu);
+    // Default rank order of the devices of the group, and of their tasks,
+    // established from the device localities by the first instance of the
+    // group and reused by the following ones, since it only depends on the
+    // group membership.
+    mutable std::vector<string> ranked_device_names GUARDED_BY(mu);
+    mutable std::vector<string> ranked_task_names GUARDED_BY(mu);
   };
 
   // Finds the GroupRec that corresponds to cp->group_key.
@@ -155,7 +161,8 @@ class CollectiveParamResolverLocal : public ParamResolverInterface {
       LOCKS_EXCLUDED(ir->out_mu, gr->mu);
 
   // Establishes the final order of ir->shared.instance.device_names and
-  // ir->shared.instance.task_names by considering localities of all devices.
+  // ir->shared.instance.task_names by considering localities of all devices,
+  // and records it in *gr for the following instances of the group.
   void CompleteDefaultRanking(const GroupRec* gr, const CollectiveParams* cp,
                               InstanceRec* ir,
                               const std::vector<DeviceLocality>& localities)
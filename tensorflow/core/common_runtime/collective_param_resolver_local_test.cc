@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/common_runtime/collective_executor_mgr.h"
 
+#include <atomic>
+
 #include "tensorflow/core/common_runtime/collective_param_resolver_local.h"
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/device_factory.h"
@@ -147,6 +149,78 @@ TEST_F(CollectiveParamResolverLocalTest, CompleteParamsBroadcast1Task) {
   }
 }
 
+// Counts the device locality lookups.
+class CountingDeviceResolver : public DeviceResolverLocal {
+ public:
+  explicit CountingDeviceResolver(const DeviceMgr* dev_mgr)
+      : DeviceResolverLocal(dev_mgr) {}
+
+  void GetDeviceLocalitiesAsync(const CollInstanceParams& ci_params,
+                                std::vector<DeviceLocality>* localities,
+                                const StatusCallback& done) override {
+    ++num_lookups_;
+    DeviceResolverLocal::GetDeviceLocalitiesAsync(ci_params, localities, done);
+  }
+
+  std::atomic<int> num_lookups_{0};
+};
+
+TEST(CollectiveParamResolverLocalRankingTest, RankingIsReusedByGroup) {
+  SessionOptions options;
+  string task_name = "/job:localhost/replica:0/task:0";
+  options.config.mutable_device_count()->insert({"CPU", NUM_DEVS});
+  std::vector<Device*> devices;
+  TF_CHECK_OK(DeviceFactory::AddDevices(options, task_name, &devices));
+  DeviceMgr device_mgr(devices);
+  CountingDeviceResolver drl(&device_mgr);
+  CollectiveParamResolverLocal prl(&device_mgr, &drl, task_name);
+
+  for (int instance_key : {7, 8}) {
+    CollectiveParams cps[NUM_DEVS];
+    Status statuses[NUM_DEVS];
+    Notification note[NUM_DEVS];
+    for (int i = 0; i < NUM_DEVS; ++i) {
+      CollectiveParams* cp = &cps[i];
+      cp->group.group_key = 1;
+      cp->group.group_size = NUM_DEVS;
+      cp->group.device_type = DeviceType("CPU");
+      cp->group.num_tasks = 1;
+      cp->instance.instance_key = instance_key;
+      cp->instance.type = REDUCTION_COLLECTIVE;
+      cp->instance.data_type = DataType(DT_FLOAT);
+      cp->instance.shape = TensorShape({5});
+      cp->instance.device_names.push_back(
+          strings::StrCat("/job:localhost/replica:0/task:0/device:CPU:", i));
+      cp->instance.impl_details.subdiv_offsets.push_back(0);
+      cp->is_source = false;
+      Env::Default()->SchedClosure([&prl, i, cp, &note, &statuses]() {
+        prl.CompleteParamsAsync(cp->instance.device_names[0], cp,
+                                nullptr /*CancellationManager*/,
+                                [&statuses, &note, i](const Status& s) {
+                                  statuses[i] = s;
+                                  note[i].Notify();
+                                });
+      });
+    }
+    for (int i = 0; i < NUM_DEVS; ++i) {
+      note[i].WaitForNotification();
+    }
+    for (int i = 0; i < NUM_DEVS; ++i) {
+      TF_ASSERT_OK(statuses[i]);
+      ASSERT_EQ(cps[i].instance.device_names.size(), NUM_DEVS);
+      for (int j = 0; j < NUM_DEVS; ++j) {
+        EXPECT_EQ(
+            strings::StrCat("/job:localhost/replica:0/task:0/device:CPU:", j),
+            cps[i].instance.device_names[j]);
+        EXPECT_TRUE(cps[i].task.is_local[j]);
+      }
+      EXPECT_EQ(cps[i].default_rank, i);
+    }
+  }
+  // The second instance reuses the rank order of the group.
+  EXPECT_EQ(1, drl.num_lookups_);
+}
+
 // TEST_F(CollectiveParamResolverLocalTest,
 
 }  // namespace
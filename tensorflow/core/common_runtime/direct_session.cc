@@ -15,7 +15,9 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/direct_session.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -32,6 +34,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/optimization_registry.h"
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/common_runtime/scoped_allocator_mgr.h"
+#include "tensorflow/core/common_runtime/spinning_workers.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/graph.pb_text.h"
@@ -47,6 +50,8 @@ limitations under the License.
 #include "tensorflow/core/graph/graph_partition.h"
 #include "tensorflow/core/graph/subgraph.h"
 #include "tensorflow/core/graph/tensor_id.h"
+#include "tensorflow/core/grappler/costs/measured_cost_database.h"
+#include "tensorflow/core/grappler/costs/utils.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/refcount.h"
@@ -55,6 +60,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
 #include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/lib/monitoring/sampler.h"
 #include "tensorflow/core/lib/strings/numbers.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
@@ -73,6 +79,38 @@ namespace {
 auto* direct_session_runs = monitoring::Counter<0>::New(
     "/tensorflow/core/direct_session_runs",
     "The number of times DirectSession::Run() has been called.");
+// The counter has no labels, its only cell is looked up once rather than on
+// every run.
+monitoring::CounterCell* const direct_session_runs_cell =
+    direct_session_runs->GetCell();
+
+auto* sampled_op_latency = monitoring::Sampler<1>::New(
+    {"/tensorflow/core/direct_session/sampled_op_latency",
+     "Latency in microseconds of the nodes of the steps sampled by "
+     "ConfigProto.Experimental.sampled_step_stats_interval.",
+     "op"},
+    // Powers of 2 up to about 9 minutes.
+    monitoring::Buckets::Exponential(1, 2, 30));
+
+// Adds the latencies of the nodes in "step_stats" to the sampled_op_latency
+// histograms of their op types, parsed from the "name = Op(inputs)" timeline
+// labels set by the executor.
+void RecordSampledOpLatencies(const StepStats& step_stats) {
+  std::unordered_map<string, monitoring::SamplerCell*> cells;
+  for (const DeviceStepStats& device_stats : step_stats.dev_stats()) {
+    for (const NodeExecStats& node_stats : device_stats.node_stats()) {
+      const string& label = node_stats.timeline_label();
+      size_t op_begin = label.find(" = ");
+      if (op_begin == string::npos) continue;
+      op_begin += 3;
+      const string op =
+          label.substr(op_begin, label.find('(', op_begin) - op_begin);
+      monitoring::SamplerCell*& cell = cells[op];
+      if (cell == nullptr) cell = sampled_op_latency->GetCell(op);
+      cell->Add(node_stats.all_end_rel_micros());
+    }
+  }
+}
 
 Status NewThreadPoolFromThreadPoolOptions(
     const SessionOptions& options,
@@ -430,6 +468,37 @@ Status DirectSession::DecorateAndPublishGraphForDebug(
   return Status::OK();
 }
 
+void DirectSession::MakeRunners(thread::ThreadPool* pool,
+                                const ExecutorsAndKeys& executors_and_keys,
+                                std::vector<Executor::Args::Runner>* runners) {
+  MakeRunners(
+      [this, pool](Executor::Args::Closure c) {
+        SchedClosure(pool, std::move(c));
+      },
+      executors_and_keys, runners);
+}
+
+void DirectSession::MakeRunners(Executor::Args::Runner default_runner,
+                                const ExecutorsAndKeys& executors_and_keys,
+                                std::vector<Executor::Args::Runner>* runners) {
+  runners->reserve(executors_and_keys.items.size());
+  for (const auto& item : executors_and_keys.items) {
+    // TODO(zhengxq): support partial run.
+    // TODO(zhengxq): if the device picks its own threadpool, we need to assign
+    //     less threads to the main compute pool by default.
+    thread::ThreadPool* device_thread_pool =
+        item.device->tensorflow_device_thread_pool();
+    if (!device_thread_pool) {
+      runners->push_back(default_runner);
+    } else {
+      runners->push_back(
+          [this, device_thread_pool](Executor::Args::Closure c) {
+            SchedClosure(device_thread_pool, std::move(c));
+          });
+    }
+  }
+}
+
 Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
                                   CallFrameInterface* call_frame,
                                   ExecutorsAndKeys* executors_and_keys,
@@ -444,8 +513,11 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
                             executor_step_count, &debugger_state));
   }
 
+  // Outlives the collector of run_state, which may write to it.
+  StepStats sampled_step_stats;
+
   // Create a run state and start execution.
-  RunState run_state(step_id, &devices_);
+  RunState run_state(step_id, &executors_and_keys->devices);
   run_state.rendez = new IntraProcessRendezvous(device_mgr_.get());
   // Set up for collectives if the RunOption declares a key.
   if (run_options.experimental().collective_graph_key() > 0) {
@@ -499,11 +571,23 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
           ((measure_step_count + 1) % build_cost_model_every == 0);
     }
   }
+  const int32 sampled_step_stats_interval =
+      options_.config.experimental().sampled_step_stats_interval();
+  const bool sample_step_stats =
+      sampled_step_stats_interval > 0 &&
+      (executor_step_count + 1) % sampled_step_stats_interval == 0;
+  // The stats to add to the sampled op latencies, if the step is sampled.
+  const StepStats* step_stats_to_sample = nullptr;
   if (do_trace || update_cost_model ||
       run_options.report_tensor_allocations_upon_oom()) {
     run_state.collector.reset(
         new StepStatsCollector(run_metadata->mutable_step_stats()));
     args.stats_collector = run_state.collector.get();
+    if (sample_step_stats) step_stats_to_sample = &run_metadata->step_stats();
+  } else if (sample_step_stats) {
+    run_state.collector.reset(new StepStatsCollector(&sampled_step_stats));
+    args.stats_collector = run_state.collector.get();
+    step_stats_to_sample = &sampled_step_stats;
   }
 
   std::unique_ptr<DeviceTracer> tracer;
@@ -545,33 +629,43 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
     return errors::Cancelled("Run call was cancelled");
   }
 
+  // Callables build their runners once, in MakeCallable, unless the step
+  // runs its closures on spinning workers.
+  std::vector<Executor::Args::Runner> step_runners;
+  const std::vector<Executor::Args::Runner>* runners =
+      &executors_and_keys->runners;
   thread::ThreadPool* pool =
       thread_pools_[run_options.inter_op_thread_pool()].first;
-
-  Executor::Args::Runner default_runner = [this,
-                                           pool](Executor::Args::Closure c) {
-    SchedClosure(pool, std::move(c));
-  };
-  for (const auto& item : executors_and_keys->items) {
-    // TODO(zhengxq): support partial run.
-    // TODO(zhengxq): if the device picks its own threadpool, we need to assign
-    //     less threads to the main compute pool by default.
-    thread::ThreadPool* device_thread_pool =
-        item.device->tensorflow_device_thread_pool();
-    if (!device_thread_pool) {
-      args.runner = default_runner;
-    } else {
-      args.runner = [this, device_thread_pool](Executor::Args::Closure c) {
-        SchedClosure(device_thread_pool, std::move(c));
-      };
-    }
-    item.executor->RunAsync(args, barrier->Get());
+  const int num_spinning_workers =
+      std::min(options_.config.experimental().inter_op_spinning_workers(),
+               pool->NumThreads());
+  std::shared_ptr<SpinningWorkers> spinning_workers;
+  if (num_spinning_workers > 0) {
+    spinning_workers = std::make_shared<SpinningWorkers>(
+        pool, num_spinning_workers,
+        options_.config.experimental().inter_op_spin_duration_us());
+    MakeRunners(
+        [spinning_workers](Executor::Args::Closure c) {
+          spinning_workers->Schedule(std::move(c));
+        },
+        *executors_and_keys, &step_runners);
+    runners = &step_runners;
+  } else if (runners->empty()) {
+    MakeRunners(pool, *executors_and_keys, &step_runners);
+    runners = &step_runners;
+  }
+  for (size_t i = 0; i < num_executors; ++i) {
+    args.runner = (*runners)[i];
+    executors_and_keys->items[i].executor->RunAsync(args, barrier->Get());
   }
 
   WaitForNotification(&run_state, &step_cancellation_manager,
                       run_options.timeout_in_ms() > 0
                           ? run_options.timeout_in_ms()
                           : operation_timeout_in_ms_);
+  if (spinning_workers) {
+    spinning_workers->Stop();
+  }
 
   if (!cancellation_manager_->DeregisterCallback(cancellation_token)) {
     // The step has been cancelled: make sure we don't attempt to receive the
@@ -601,6 +695,9 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
   if (args.stats_collector) {
     args.stats_collector->Finalize();
   }
+  if (step_stats_to_sample != nullptr) {
+    RecordSampledOpLatencies(*step_stats_to_sample);
+  }
 
   // Build and return the cost model as instructed.
   if (update_cost_model) {
@@ -622,6 +719,22 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
       TF_RETURN_IF_ERROR(
           cost_model_manager_.AddToCostGraphDef(item.graph, cost_graph));
     }
+
+    // Feed the measured costs back to grappler for future optimizations.
+    grappler::MeasuredCostDatabase* measured_costs =
+        grappler::MeasuredCostDatabase::Global();
+    if (measured_costs != nullptr) {
+      for (const auto& item : executors_and_keys->items) {
+        GraphDef partition_graph_def;
+        item.graph->ToGraphDef(&partition_graph_def);
+        measured_costs->Add(grappler::CostGraphToOpPerformanceData(
+            *cost_graph, partition_graph_def));
+      }
+      Status s = measured_costs->Flush();
+      if (!s.ok()) {
+        LOG(WARNING) << "Failed to save measured op costs: " << s;
+      }
+    }
   }
 
   // If requested via RunOptions, output the partition graphs.
@@ -646,7 +759,7 @@ Status DirectSession::Run(const RunOptions& run_options,
                           RunMetadata* run_metadata) {
   TF_RETURN_IF_ERROR(CheckNotClosed());
   TF_RETURN_IF_ERROR(CheckGraphCreated("Run()"));
-  direct_session_runs->GetCell()->IncrementBy(1);
+  direct_session_runs_cell->IncrementBy(1);
 
   // Extract the inputs names for this run of the session.
   std::vector<string> input_tensor_names;
@@ -1185,6 +1298,12 @@ Status DirectSession::CreateExecutors(
       }
     };
     params.node_outputs_cb = node_outputs_callback_;
+    params.schedule_by_critical_path =
+        options_.config.graph_options().schedule_by_critical_path();
+    if (options_.config.graph_options().executor_work_stealing()) {
+      params.max_stealing_workers = thread_pools_[0].first->NumThreads();
+    }
+    params.plan_memory = options_.config.graph_options().plan_static_memory();
 
     optimizer.Optimize(lib, options_.env, device, &iter->second,
                        /*shape_map=*/nullptr);
@@ -1204,6 +1323,10 @@ Status DirectSession::CreateExecutors(
     item->graph = partition_graph.get();
     item->executor = nullptr;
     item->device = device;
+    if (std::find(ek->devices.begin(), ek->devices.end(), device) ==
+        ek->devices.end()) {
+      ek->devices.push_back(device);
+    }
     Executor* executor;
     TF_RETURN_IF_ERROR(
         NewLocalExecutor(params, std::move(partition_graph), &executor));
@@ -1636,6 +1759,11 @@ Status DirectSession::MakeCallable(const CallableOptions& callable_options,
   RunStateArgs run_state_args(callable_options.run_options().debug_options());
   TF_RETURN_IF_ERROR(
       CreateExecutors(callable_options, &ek, &func_info, &run_state_args));
+  // An invalid thread pool is reported by RunCallable, as for Run.
+  const int pool_index = callable_options.run_options().inter_op_thread_pool();
+  if (pool_index >= 0 && pool_index < thread_pools_.size()) {
+    MakeRunners(thread_pools_[pool_index].first, *ek, &ek->runners);
+  }
   {
     mutex_lock l(callables_lock_);
     *out_handle = next_callable_handle_++;
@@ -1649,11 +1777,12 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
   RunCallableCallFrame(DirectSession* session,
                        ExecutorsAndKeys* executors_and_keys,
                        const std::vector<Tensor>* feed_tensors,
-                       std::vector<Tensor>* fetch_tensors)
+                       std::vector<Tensor>* fetch_tensors, bool into_buffers)
       : session_(session),
         executors_and_keys_(executors_and_keys),
         feed_tensors_(feed_tensors),
-        fetch_tensors_(fetch_tensors) {}
+        fetch_tensors_(fetch_tensors),
+        into_buffers_(into_buffers) {}
 
   size_t num_args() const override {
     return executors_and_keys_->input_types.size();
@@ -1678,23 +1807,61 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
     if (index > fetch_tensors_->size()) {
       return errors::Internal("RetVal index out of bounds: ", index);
     }
-    (*fetch_tensors_)[index] = val;
+    if (!into_buffers_) {
+      (*fetch_tensors_)[index] = val;
+      return Status::OK();
+    }
+    Tensor* buffer = &(*fetch_tensors_)[index];
+    if (val.SharesBufferWith(*buffer)) {
+      // The producer wrote its output directly into the buffer.
+      return Status::OK();
+    }
+    if (val.dtype() != buffer->dtype() || val.shape() != buffer->shape()) {
+      return errors::InvalidArgument(
+          "Fetch ", index, " is a ", DataTypeString(val.dtype()),
+          " tensor of shape ", val.shape().DebugString(),
+          ", but its buffer is a ", DataTypeString(buffer->dtype()),
+          " tensor of shape ", buffer->shape().DebugString());
+    }
+    StringPiece src = val.tensor_data();
+    std::memcpy(const_cast<char*>(buffer->tensor_data().data()), src.data(),
+                src.size());
     return Status::OK();
   }
 
+  const Tensor* GetRetvalDestination(int index) const override {
+    return into_buffers_ ? &(*fetch_tensors_)[index] : nullptr;
+  }
+
  private:
   DirectSession* const session_;                   // Not owned.
   ExecutorsAndKeys* const executors_and_keys_;     // Not owned.
   const std::vector<Tensor>* const feed_tensors_;  // Not owned.
   std::vector<Tensor>* const fetch_tensors_;       // Not owned.
+  const bool into_buffers_;
 };
 
 ::tensorflow::Status DirectSession::RunCallable(
     CallableHandle handle, const std::vector<Tensor>& feed_tensors,
     std::vector<Tensor>* fetch_tensors, RunMetadata* run_metadata) {
+  return RunCallableHelper(handle, feed_tensors, fetch_tensors, run_metadata,
+                           /*into_buffers=*/false);
+}
+
+::tensorflow::Status DirectSession::RunCallableIntoBuffers(
+    CallableHandle handle, const std::vector<Tensor>& feed_tensors,
+    std::vector<Tensor>* fetch_tensors, RunMetadata* run_metadata) {
+  return RunCallableHelper(handle, feed_tensors, fetch_tensors, run_metadata,
+                           /*into_buffers=*/true);
+}
+
+::tensorflow::Status DirectSession::RunCallableHelper(
+    CallableHandle handle, const std::vector<Tensor>& feed_tensors,
+    std::vector<Tensor>* fetch_tensors, RunMetadata* run_metadata,
+    bool into_buffers) {
   TF_RETURN_IF_ERROR(CheckNotClosed());
   TF_RETURN_IF_ERROR(CheckGraphCreated("RunCallable()"));
-  direct_session_runs->GetCell()->IncrementBy(1);
+  direct_session_runs_cell->IncrementBy(1);
 
   // Check if we already have an executor for these arguments.
   std::shared_ptr<ExecutorsAndKeys> executors_and_keys;
@@ -1713,11 +1880,6 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
         "Attempted to run callable after handle was released: ", handle);
   }
 
-  // NOTE(mrry): Debug options are not currently supported in the
-  // callable interface.
-  DebugOptions debug_options;
-  RunStateArgs run_state_args(debug_options);
-
   // Configure a call frame for the step, which we use to feed and
   // fetch values to and from the executors.
   if (feed_tensors.size() != executors_and_keys->input_types.size()) {
@@ -1725,7 +1887,26 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
         "Expected ", executors_and_keys->input_types.size(),
         " feed tensors, but got ", feed_tensors.size());
   }
-  if (fetch_tensors != nullptr) {
+  if (into_buffers) {
+    if (fetch_tensors == nullptr ||
+        fetch_tensors->size() != executors_and_keys->output_types.size()) {
+      return errors::InvalidArgument(
+          "Expected ", executors_and_keys->output_types.size(),
+          " fetch buffers, but got ",
+          fetch_tensors == nullptr ? 0 : fetch_tensors->size());
+    }
+    for (int i = 0; i < fetch_tensors->size(); ++i) {
+      const Tensor& buffer = (*fetch_tensors)[i];
+      if (!buffer.IsInitialized() ||
+          buffer.dtype() != executors_and_keys->output_types[i] ||
+          !DataTypeCanUseMemcpy(buffer.dtype())) {
+        return errors::InvalidArgument(
+            "Fetch buffer ", i, " must be an initialized ",
+            DataTypeString(executors_and_keys->output_types[i]),
+            " tensor of a type that can be copied with memcpy");
+      }
+    }
+  } else if (fetch_tensors != nullptr) {
     fetch_tensors->resize(executors_and_keys->output_types.size());
   } else if (!executors_and_keys->output_types.empty()) {
     return errors::InvalidArgument(
@@ -1737,10 +1918,12 @@ class DirectSession::RunCallableCallFrame : public CallFrameInterface {
   // optimized RunCallable interface.
 
   RunCallableCallFrame call_frame(this, executors_and_keys.get(), &feed_tensors,
-                                  fetch_tensors);
+                                  fetch_tensors, into_buffers);
 
   if (LogMemory::IsEnabled()) {
-    LogMemory::RecordStep(step_id, run_state_args.handle);
+    // NOTE(mrry): Debug options are not currently supported in the
+    // callable interface, the step has no handle.
+    LogMemory::RecordStep(step_id, "");
   }
 
   TF_RETURN_IF_ERROR(
@@ -114,6 +114,9 @@ class DirectSession : public Session {
                                    const std::vector<Tensor>& feed_tensors,
                                    std::vector<Tensor>* fetch_tensors,
                                    RunMetadata* run_metadata) override;
+  ::tensorflow::Status RunCallableIntoBuffers(
+      CallableHandle handle, const std::vector<Tensor>& feed_tensors,
+      std::vector<Tensor>* fetch_tensors, RunMetadata* run_metadata) override;
   ::tensorflow::Status ReleaseCallable(CallableHandle handle) override;
 
  private:
@@ -150,6 +153,13 @@ class DirectSession : public Session {
     DataTypeVector output_types;
 
     CallableOptions callable_options;
+
+    // The distinct devices of the items. Steps only clean up their per-step
+    // resources on these devices.
+    std::vector<Device*> devices;
+    // For callables, the runners of the items, built once for the run
+    // options of the callable. Empty otherwise.
+    std::vector<Executor::Args::Runner> runners;
   };
 
   // A FunctionInfo object is created for every unique set of feeds/fetches.
@@ -236,6 +246,18 @@ class DirectSession : public Session {
       RunStateArgs* run_state_args, DataTypeVector* input_types,
       DataTypeVector* output_types);
 
+  // Builds the runner of each item of executors_and_keys, for steps run with
+  // the inter-op thread pool pool.
+  void MakeRunners(thread::ThreadPool* pool,
+                   const ExecutorsAndKeys& executors_and_keys,
+                   std::vector<Executor::Args::Runner>* runners);
+
+  // As above, with default_runner for the items whose device has no thread
+  // pool of its own.
+  void MakeRunners(Executor::Args::Runner default_runner,
+                   const ExecutorsAndKeys& executors_and_keys,
+                   std::vector<Executor::Args::Runner>* runners);
+
   ::tensorflow::Status RunInternal(int64 step_id, const RunOptions& run_options,
                                    CallFrameInterface* call_frame,
                                    ExecutorsAndKeys* executors_and_keys,
@@ -336,6 +358,12 @@ class DirectSession : public Session {
       GUARDED_BY(executor_lock_);
 
   class RunCallableCallFrame;
+  // Runs the callable `handle`. If `into_buffers`, the fetches are written
+  // into the tensors of `*fetch_tensors`, see RunCallableIntoBuffers().
+  ::tensorflow::Status RunCallableHelper(
+      CallableHandle handle, const std::vector<Tensor>& feed_tensors,
+      std::vector<Tensor>* fetch_tensors, RunMetadata* run_metadata,
+      bool into_buffers);
   struct Callable {
     std::shared_ptr<ExecutorsAndKeys> executors_and_keys;
     std::shared_ptr<FunctionInfo> function_info;
@@ -39,6 +39,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/monitoring/collection_registry.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
@@ -181,6 +182,48 @@ TEST_F(DirectSessionMinusAXTest, RunSimpleNetwork_Callable) {
   }
 }
 
+TEST_F(DirectSessionMinusAXTest, RunSimpleNetwork_CallableIntoBuffers) {
+  Initialize({3, 2, -1, 0});
+  auto session = CreateSession();
+  ASSERT_TRUE(session != nullptr);
+  TF_ASSERT_OK(session->Create(def_));
+
+  // y is produced into its buffer, z = Identity(-y) is copied into it.
+  Session::CallableHandle handle;
+  TF_ASSERT_OK(session->MakeCallable(
+      MakeCallableOptions({}, {y_ + ":0", z_ + ":0"}, {}), &handle));
+
+  std::vector<Tensor> buffers = {Tensor(DT_FLOAT, TensorShape({2, 1})),
+                                 Tensor(DT_FLOAT, TensorShape({2, 1}))};
+  const char* y_data = buffers[0].tensor_data().data();
+  const char* z_data = buffers[1].tensor_data().data();
+  for (int i = 0; i < 2; ++i) {
+    std::vector<Tensor> outputs = buffers;
+    TF_ASSERT_OK(
+        session->RunCallableIntoBuffers(handle, {}, &outputs, nullptr));
+    ASSERT_EQ(2, outputs.size());
+    EXPECT_EQ(y_data, outputs[0].tensor_data().data());
+    EXPECT_EQ(z_data, outputs[1].tensor_data().data());
+    test::ExpectTensorEqual<float>(
+        buffers[0], test::AsTensor<float>({5, -1}, TensorShape({2, 1})));
+    test::ExpectTensorEqual<float>(
+        buffers[1], test::AsTensor<float>({-5, 1}, TensorShape({2, 1})));
+  }
+
+  std::vector<Tensor> outputs = {Tensor(DT_FLOAT, TensorShape({2, 1})),
+                                 Tensor(DT_FLOAT, TensorShape({3}))};
+  Status s = session->RunCallableIntoBuffers(handle, {}, &outputs, nullptr);
+  EXPECT_TRUE(errors::IsInvalidArgument(s));
+
+  outputs = {Tensor(DT_FLOAT, TensorShape({2, 1}))};
+  s = session->RunCallableIntoBuffers(handle, {}, &outputs, nullptr);
+  EXPECT_TRUE(errors::IsInvalidArgument(s));
+  EXPECT_TRUE(str_util::StrContains(s.error_message(),
+                                    "Expected 2 fetch buffers, but got 1"));
+
+  TF_ASSERT_OK(session->ReleaseCallable(handle));
+}
+
 TEST_F(DirectSessionMinusAXTest, TestTensorConnection) {
   Initialize({3, 2, -1, 0});
   auto session = CreateSession();
@@ -498,6 +541,80 @@ TEST_F(DirectSessionMinusAXTest, TestPerSessionThreads) {
   delete tp;
 }
 
+TEST_F(DirectSessionMinusAXTest, TestSpinningWorkers) {
+  Initialize({1, 2, 3, 4});
+
+  SessionOptions options;
+  options.config.set_use_per_session_threads(true);
+  options.config.set_inter_op_parallelism_threads(4);
+  options.config.mutable_experimental()->set_inter_op_spinning_workers(2);
+  options.config.mutable_experimental()->set_inter_op_spin_duration_us(100);
+  (*options.config.mutable_device_count())["CPU"] = 2;
+  std::unique_ptr<Session> session(NewSession(options));
+
+  ASSERT_TRUE(session != nullptr);
+  TF_ASSERT_OK(session->Create(def_));
+
+  // Two concurrent runs compete for the workers of the pool.
+  thread::ThreadPool* tp = new thread::ThreadPool(Env::Default(), "test", 2);
+  std::vector<string> output_names = {y_neg_ + ":0"};
+  auto fn = [&session, output_names]() {
+    for (int i = 0; i < 100; ++i) {
+      std::vector<Tensor> outputs;
+      TF_ASSERT_OK(session->Run({}, output_names, {}, &outputs));
+      ASSERT_EQ(1, outputs.size());
+      auto mat = outputs[0].matrix<float>();
+      EXPECT_FLOAT_EQ(-3.0, mat(0, 0));
+    }
+  };
+  for (int i = 0; i < 2; ++i) {
+    tp->Schedule(fn);
+  }
+  delete tp;
+}
+
+// Returns the number of samples in the sampled op latency histogram of "op".
+double NumSampledOpLatencies(const string& op) {
+  monitoring::CollectionRegistry::CollectMetricsOptions options;
+  options.collect_metric_descriptors = false;
+  const std::unique_ptr<monitoring::CollectedMetrics> metrics =
+      monitoring::CollectionRegistry::Default()->CollectMetrics(options);
+  const auto it = metrics->point_set_map.find(
+      "/tensorflow/core/direct_session/sampled_op_latency");
+  if (it == metrics->point_set_map.end()) return 0;
+  for (const auto& point : it->second->points) {
+    if (point->labels.size() == 1 && point->labels[0].value == op) {
+      return point->histogram_value.num();
+    }
+  }
+  return 0;
+}
+
+TEST_F(DirectSessionMinusAXTest, TestSampledStepStats) {
+  Initialize({1, 2, 3, 4});
+
+  SessionOptions options;
+  options.config.mutable_experimental()->set_sampled_step_stats_interval(5);
+  (*options.config.mutable_device_count())["CPU"] = 2;
+  std::unique_ptr<Session> session(NewSession(options));
+  ASSERT_TRUE(session != nullptr);
+  TF_ASSERT_OK(session->Create(def_));
+
+  const double num_neg_latencies = NumSampledOpLatencies("Neg");
+  for (int i = 0; i < 10; ++i) {
+    std::vector<Tensor> outputs;
+    RunMetadata run_metadata;
+    TF_ASSERT_OK(session->Run(RunOptions(), {}, {y_neg_ + ":0"}, {},
+                              &outputs, &run_metadata));
+    ASSERT_EQ(1, outputs.size());
+    EXPECT_FLOAT_EQ(-3.0, outputs[0].matrix<float>()(0, 0));
+    // The sampled stats are not returned to the caller.
+    EXPECT_EQ(0, run_metadata.step_stats().dev_stats_size());
+  }
+  // One Neg node in each of the 2 sampled steps.
+  EXPECT_EQ(num_neg_latencies + 2, NumSampledOpLatencies("Neg"));
+}
+
 TEST_F(DirectSessionMinusAXTest, TwoCreateCallsFails) {
   Initialize({1, 2, 3, 4});
   auto session = CreateSession();
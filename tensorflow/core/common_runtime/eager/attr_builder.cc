@@ -99,6 +99,7 @@ Status AttrTypeMapForOp(const char* op_name, const AttrTypeMap** out) {
 #define DEFINE_SET_ATTR(value_type, value_field)                             \
   template <>                                                                \
   AttrBuilder& AttrBuilder::Set(StringPiece attr_name, value_type&& value) { \
+    cached_cache_key_valid_ = false;                                         \
     value_field.push_back(std::make_pair(attr_name, value));                 \
     return *this;                                                            \
   }
@@ -195,6 +196,16 @@ inline tensorflow::Fprint128 CacheKeyHelper(StringPiece s, uint64 b) {
 }  // namespace
 
 tensorflow::Fprint128 AttrBuilder::CacheKey(const string& device) const {
+  if (!cached_cache_key_valid_ || device != device_for_cached_cache_key_) {
+    cached_cache_key_ = ComputeCacheKey(device);
+    device_for_cached_cache_key_ = device;
+    cached_cache_key_valid_ = true;
+  }
+  return cached_cache_key_;
+}
+
+tensorflow::Fprint128 AttrBuilder::ComputeCacheKey(
+    const string& device) const {
   tensorflow::Fprint128 f = tensorflow::Fingerprint128(op_name_);
   f = tensorflow::FingerprintCat128(f, tensorflow::Fingerprint128(device));
   if (node_def_ != nullptr) {
@@ -77,6 +77,8 @@ Status AttrTypeByName(const AttrTypeMap& m, const string& attr_name,
 // Note that all calls to Set and NumInputs should happen before calling
 // BuildNodeDef. Also, calls to NumInputs or Set between multiple invocations
 // to CacheKey may cause different values to be returned by CacheKey.
+// Otherwise the key is computed once per device and reused, so that executing
+// the same operation repeatedly does not fingerprint its attributes again.
 //
 // For performance reasons, the class internally delays the actual construction
 // of the NodeDef till BuildNodeDef is called, or Set is called with certain
@@ -95,6 +97,7 @@ class AttrBuilder {
 
   template <class T>
   AttrBuilder& Set(StringPiece attr_name, T&& value) {
+    cached_cache_key_valid_ = false;
     MayBeInitializeNodeDef();
     SetInAttrValueMap(node_def_->mutable_attr(), attr_name, value);
     return *this;
@@ -111,6 +114,7 @@ class AttrBuilder {
 
   void MayBeInitializeNodeDef();
   void FillAttrValueMap(AttrValueMap* m, bool include_those_in_node_def) const;
+  tensorflow::Fprint128 ComputeCacheKey(const string& device) const;
 
   template <class T>
   void SetInAttrValueMap(AttrValueMap* m, StringPiece attr_name,
@@ -140,6 +144,13 @@ class AttrBuilder {
   int num_inputs_;
   std::unique_ptr<NodeDef> node_def_;
   bool node_def_finalized_;
+
+  // The result of the last call to CacheKey and its device. BuildNodeDef
+  // moves the attributes to node_def_, which changes the computed key, so the
+  // key is kept until the attributes change.
+  mutable tensorflow::Fprint128 cached_cache_key_;
+  mutable string device_for_cached_cache_key_;
+  mutable bool cached_cache_key_valid_ = false;
 };  // namespace tensorflow
 
 template <>
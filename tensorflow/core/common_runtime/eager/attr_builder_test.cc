@@ -58,5 +58,21 @@ TEST(AttrTypeMap, Lookup) {
   EXPECT_NE(is_list, 0);
 }
 
+TEST(AttrBuilder, CacheKey) {
+  AttrBuilder a("MatMul");
+  a.Set("T", DT_FLOAT).Set("transpose_a", false);
+  const Fprint128 cpu_key = a.CacheKey("cpu:0");
+  EXPECT_FALSE(cpu_key == a.CacheKey("gpu:0"));
+  // The key of a built operation is the one it was cached with.
+  a.NumInputs(2).BuildNodeDef();
+  EXPECT_TRUE(cpu_key == a.CacheKey("cpu:0"));
+
+  AttrBuilder b("MatMul");
+  b.Set("T", DT_FLOAT);
+  EXPECT_FALSE(cpu_key == b.CacheKey("cpu:0"));
+  b.Set("transpose_a", false);
+  EXPECT_TRUE(cpu_key == b.CacheKey("cpu:0"));
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -673,10 +673,10 @@ Status EagerExecute(EagerContext* ctx, Device* device,
     device = kernel->device();
   }
 
-  std::vector<Tensor> outputs(1);
+  KernelAndDevice::TensorVec outputs;
   const MemoryTypeVector* output_memory_types = nullptr;
   output_memory_types = &kernel->kernel()->output_memory_types();
-  std::vector<Tensor> inputs(op_inputs.size());
+  KernelAndDevice::TensorVec inputs(op_inputs.size());
   for (int i = 0; i < op_inputs.size(); ++i) {
     const Tensor* input_tensor = nullptr;
     TF_RETURN_IF_ERROR(op_inputs[i]->Tensor(&input_tensor));
@@ -55,15 +55,14 @@ Status KernelAndDevice::Init(const NodeDef& ndef, FunctionLibraryRuntime* flib,
   return s;
 }
 
-Status KernelAndDevice::Run(std::vector<Tensor>* input_tensors,
-                            std::vector<Tensor>* output_tensors,
+Status KernelAndDevice::Run(TensorVec* input_tensors, TensorVec* output_tensors,
                             NodeExecStats* stats) {
   gtl::InlinedVector<TensorValue, 4> inputs;
   for (Tensor& t : *input_tensors) {
     inputs.push_back(TensorValue(&t));
   }
 
-  std::vector<AllocatorAttributes> out_attrs(kernel_->num_outputs());
+  gtl::InlinedVector<AllocatorAttributes, 4> out_attrs(kernel_->num_outputs());
   for (size_t i = 0; i < out_attrs.size(); ++i) {
     out_attrs[i].set_on_host(kernel_->output_memory_types()[i] ==
                              tensorflow::HOST_MEMORY);
@@ -75,7 +74,7 @@ Status KernelAndDevice::Run(std::vector<Tensor>* input_tensors,
   params.inputs = &inputs;
   params.op_kernel = kernel_.get();
   params.resource_manager = device_->resource_manager();
-  params.output_attr_array = gtl::vector_as_array(&out_attrs);
+  params.output_attr_array = out_attrs.data();
   params.function_library = flib_;
   params.slice_reader_cache = &slice_reader_cache_;
   params.rendezvous = rendez_;
@@ -108,6 +107,7 @@ Status KernelAndDevice::Run(std::vector<Tensor>* input_tensors,
   if (!context.status().ok()) return context.status();
 
   output_tensors->clear();
+  output_tensors->reserve(context.num_outputs());
   for (int i = 0; i < context.num_outputs(); ++i) {
     output_tensors->push_back(Tensor(*context.mutable_output(i)));
   }
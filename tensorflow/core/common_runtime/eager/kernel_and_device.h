@@ -64,9 +64,12 @@ class KernelAndDevice {
   KernelAndDevice(tensorflow::Rendezvous* rendez)
       : device_(nullptr), flib_(nullptr), rendez_(rendez) {}
 
+  // The tensors are kept inline, as most operations have few inputs and
+  // outputs.
+  typedef gtl::InlinedVector<Tensor, 4> TensorVec;
+
   // TODO(ashankar): Handle list-valued inputs.
-  Status Run(std::vector<Tensor>* inputs, std::vector<Tensor>* outputs,
-             NodeExecStats* stats);
+  Status Run(TensorVec* inputs, TensorVec* outputs, NodeExecStats* stats);
 
   const OpKernel* kernel() const { return kernel_.get(); }
 
@@ -116,10 +116,10 @@ BENCHMARK(BM_KernelAndDeviceInit);
 void BM_KernelAndDeviceRun(int iters) {
   tensorflow::testing::StopTiming();
   Tensor t(Input({{1.0f, 2.0f}, {3.0f, 4.0f}}).tensor());
-  std::vector<Tensor> inputs;
+  KernelAndDevice::TensorVec inputs;
   inputs.push_back(t);
   inputs.push_back(t);
-  std::vector<Tensor> outputs;
+  KernelAndDevice::TensorVec outputs;
   NodeDef ndef(AttrBuilder("MatMul")
                    .Set("T", DT_FLOAT)
                    .Set("transpose_a", false)
@@ -32,11 +32,13 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
 #include "tensorflow/core/framework/rendezvous.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
 #include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/public/session_options.h"
@@ -176,6 +178,29 @@ Status TensorHandle::CopyToDevice(EagerContext* ctx, tensorflow::Device* dstd,
   if (!dst_cpu) {
     dst_device_context = dstd->tensorflow_gpu_device_info()->default_context;
   }
+  // The SYCL runtime orders every access to a SYCL buffer, whichever queue
+  // it is made from. Copies out of a SYCL device therefore wait for the
+  // kernels producing the tensor without syncing the whole device, and
+  // copies from the host to a SYCL device don't need to be waited for: the
+  // kernels reading the destination start once the copy has landed, so the
+  // handle can be returned straight away.
+  const bool src_sycl =
+      !src_cpu && srcd->device_type() == tensorflow::DEVICE_SYCL;
+  const bool dst_sycl =
+      !dst_cpu && dstd->device_type() == tensorflow::DEVICE_SYCL;
+  if (src_cpu && dst_sycl) {
+    const string dst_name = dstd->name();
+    tensorflow::CopyTensor::ViaDMA(
+        "copy", src_device_context, dst_device_context, srcd, dstd,
+        tensorflow::AllocatorAttributes(), tensorflow::AllocatorAttributes(),
+        src, &dst, [dst_name](const tensorflow::Status& s) {
+          if (!s.ok()) {
+            LOG(ERROR) << "Failed copying tensor to " << dst_name << ": " << s;
+          }
+        });
+    *output = new tensorflow::TensorHandle(dst, dstd, dstd, ctx);
+    return tensorflow::Status::OK();
+  }
   // TODO(ashankar): The Sync() call below may be more aggressive than
   // necessary. It is based on knowledge of implementation details - that
   // GPU devices are implemented using 3 streams - one for host->device copies,
@@ -183,7 +208,9 @@ Status TensorHandle::CopyToDevice(EagerContext* ctx, tensorflow::Device* dstd,
   // With that setup, Sync()ing across all 3 streams should be sufficient
   // but more than necessary (since it waits for operations that might have
   // nothing to do with this tensor to complete).
-  TF_RETURN_IF_ERROR(srcd->Sync());
+  if (!src_sycl) {
+    TF_RETURN_IF_ERROR(srcd->Sync());
+  }
   tensorflow::Notification n;
   tensorflow::Status status;
   tensorflow::CopyTensor::ViaDMA("copy", src_device_context, dst_device_context,
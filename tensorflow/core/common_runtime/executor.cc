@@ -17,12 +17,15 @@ limitations under the License.
 
 #include <atomic>
 #include <deque>
+#include <functional>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 #include "tensorflow/core/common_runtime/costmodel_manager.h"
+#include "tensorflow/core/common_runtime/memory_planner.h"
 #include "tensorflow/core/common_runtime/pending_counts.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/framework/allocation_description.pb.h"
@@ -41,6 +44,8 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_reference.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/costmodel.h"
 #include "tensorflow/core/graph/edgeset.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/notification.h"
@@ -196,6 +201,7 @@ void SetReferencedTensors(NodeExecStatsWrapper* stats,
 
 class ExecutorImpl;
 class GraphView;
+class IterationStatePool;
 
 struct EdgeInfo {
   int dst_id;
@@ -236,6 +242,10 @@ struct NodeItem {
   // Number of output edges.
   size_t num_output_edges;
 
+  // Estimated time of the longest path from this node to the end of the
+  // graph. Only computed when scheduling by critical path.
+  int64 critical_path_cost = 0;
+
   PendingCounts::Handle pending_id;
 
   const EdgeInfo* output_edge_list() const { return output_edge_base(); }
@@ -347,23 +357,8 @@ class GraphView {
 
 class ExecutorImpl : public Executor {
  public:
-  ExecutorImpl(const LocalExecutorParams& p, std::unique_ptr<const Graph> g)
-      : params_(p), graph_(std::move(g)), gview_() {
-    CHECK(p.create_kernel != nullptr);
-    CHECK(p.delete_kernel != nullptr);
-  }
-
-  ~ExecutorImpl() override {
-    for (int i = 0; i < graph_->num_node_ids(); i++) {
-      NodeItem* item = gview_.node(i);
-      if (item != nullptr) {
-        params_.delete_kernel(item->kernel);
-      }
-    }
-    for (auto fiter : frame_info_) {
-      delete fiter.second;
-    }
-  }
+  ExecutorImpl(const LocalExecutorParams& p, std::unique_ptr<const Graph> g);
+  ~ExecutorImpl() override;
 
   Status Initialize();
 
@@ -415,6 +410,9 @@ class ExecutorImpl : public Executor {
   static Status BuildControlFlowInfo(const Graph* graph,
                                      ControlFlowInfo* cf_info);
   void InitializePending(const Graph* graph, const ControlFlowInfo& cf_info);
+  void InitializeCriticalPathCosts(const Graph* graph);
+  void InitializeMemoryPlan(const Graph* graph);
+  Status InitializeRetvalProducers(const Graph* graph);
 
   FrameInfo* EnsureFrameInfo(const string& fname) {
     auto slot = &frame_info_[fname];
@@ -440,6 +438,23 @@ class ExecutorImpl : public Executor {
   // the overhead of constructing it for each executor instance.
   gtl::FlatMap<string, FrameInfo*> frame_info_;
 
+  // The iteration states of the finished iterations of all steps, reused by
+  // the new ones.
+  std::unique_ptr<IterationStatePool> iteration_pool_;
+
+  // The static memory plan of the outputs of the steps, if any.
+  std::unique_ptr<MemoryPlan> memory_plan_;
+
+  // The outputs of the graph fetched through _Retval nodes, which may be
+  // written directly into the tensors the caller preallocated for them.
+  // Only on host devices.
+  struct RetvalProducer {
+    int node_id;
+    int output;
+    int retval_index;
+  };
+  std::vector<RetvalProducer> retval_producers_;
+
   TF_DISALLOW_COPY_AND_ASSIGN(ExecutorImpl);
 };
 
@@ -731,7 +746,92 @@ Status ExecutorImpl::Initialize() {
   // all nodes.
   InitializePending(graph_.get(), cf_info);
 
-  return gview_.SetAllocAttrs(graph_.get(), params_.device);
+  if (params_.schedule_by_critical_path) {
+    InitializeCriticalPathCosts(graph_.get());
+  }
+
+  TF_RETURN_IF_ERROR(gview_.SetAllocAttrs(graph_.get(), params_.device));
+
+  // The plan follows a single topological order of the graph, the graphs
+  // with loops are not planned.
+  if (params_.plan_memory && cf_info.unique_frame_names.size() == 1) {
+    InitializeMemoryPlan(graph_.get());
+  }
+  return InitializeRetvalProducers(graph_.get());
+}
+
+Status ExecutorImpl::InitializeRetvalProducers(const Graph* graph) {
+  if (params_.device->attributes().device_type() != DEVICE_CPU) {
+    return Status::OK();
+  }
+  for (const Node* n : graph->nodes()) {
+    if (n->type_string() != "_Retval") {
+      continue;
+    }
+    const Edge* e;
+    TF_RETURN_IF_ERROR(n->input_edge(0, &e));
+    // The outputs of Enter, Exit and the like are their inputs.
+    if (IsRefType(e->src()->output_type(e->src_output())) ||
+        !DataTypeCanUseMemcpy(e->src()->output_type(e->src_output())) ||
+        gview_.node(e->src()->id())->is_enter_exit_or_next_iter ||
+        IsSwitch(e->src()) || IsMerge(e->src())) {
+      continue;
+    }
+    int index;
+    TF_RETURN_IF_ERROR(GetNodeAttr(n->attrs(), "index", &index));
+    retval_producers_.push_back({e->src()->id(), e->src_output(), index});
+  }
+  return Status::OK();
+}
+
+void ExecutorImpl::InitializeCriticalPathCosts(const Graph* graph) {
+  // In post order the successors of a node come first, except across the
+  // back edges of loops which are ignored: their destination still has a
+  // zero cost when its source is visited.
+  std::vector<Node*> order;
+  GetPostOrder(*graph, &order);
+  for (const Node* n : order) {
+    NodeItem* item = gview_.node(n->id());
+    int64 cost;
+    if (params_.cost_model != nullptr) {
+      cost = params_.cost_model->TimeEstimate(n).value();
+    } else {
+      cost = item->kernel_is_expensive ? 1 : 0;
+    }
+    int64 max_successor_cost = 0;
+    for (const Edge* e : n->out_edges()) {
+      max_successor_cost = std::max(
+          max_successor_cost, gview_.node(e->dst()->id())->critical_path_cost);
+    }
+    item->critical_path_cost = cost + max_successor_cost;
+  }
+}
+
+void ExecutorImpl::InitializeMemoryPlan(const Graph* graph) {
+  auto plannable = [this](const Node* n, int output) {
+    const AllocatorAttributes attr =
+        gview_.node(n->id())->output_attrs()[output];
+    if (attr.value != 0 || attr.scope_id != 0) {
+      return false;
+    }
+    // The tensors leaving the step would keep its arena alive.
+    for (const Edge* e : n->out_edges()) {
+      if (e->src_output() == output &&
+          (e->dst()->IsSend() || e->dst()->type_string() == "_Retval")) {
+        return false;
+      }
+    }
+    return true;
+  };
+  std::unique_ptr<MemoryPlan> plan(new MemoryPlan);
+  Status s = PlanGraphMemory(*graph, plannable, plan.get());
+  if (!s.ok()) {
+    VLOG(1) << "Not planning the memory of the graph: " << s;
+    return;
+  }
+  if (plan->arena_bytes > 0) {
+    memory_plan_ = std::move(plan);
+  }
 }
 
 // If a Node has been marked to use a ScopedAllocator x for output i, then
@@ -911,6 +1011,8 @@ class ExecutorState {
   void RunAsync(Executor::DoneCallback done);
 
  private:
+  friend class IterationStatePool;
+
   // Either a tensor pointer (pass-by-reference) or a tensor (pass-by-value).
   // TODO(yuanbyu): A better way to do "has_value"?
   struct Entry {
@@ -1004,9 +1106,28 @@ class ExecutorState {
         : input_tensors(new Entry[total_input_tensors]),
           outstanding_ops(0),
           outstanding_frame_count(0),
+          initial_counts_(pending_counts),
+          total_input_tensors_(total_input_tensors),
           counts_(*pending_counts) {  // Initialize with copy of *pending_counts
     }
 
+    // Releases the tensors of the iteration, before it is kept for reuse.
+    void Clear() {
+      for (int i = 0; i < total_input_tensors_; ++i) {
+        input_tensors[i] = Entry();
+      }
+    }
+
+    // Returns a cleared iteration to the state of a new one.
+    void Reset() {
+      outstanding_ops = 0;
+      outstanding_frame_count = 0;
+      counts_.CopyFrom(*initial_counts_);
+    }
+
+    // The pending counts of the frame this iteration was created with.
+    const PendingCounts* initial_counts() const { return initial_counts_; }
+
     // The state of an iteration.
 
     // One copy per iteration. For iteration k, i-th node's j-th input is in
@@ -1052,6 +1173,8 @@ class ExecutorState {
     ~IterationState() { delete[] input_tensors; }
 
    private:
+    const PendingCounts* const initial_counts_;
+    const int total_input_tensors_;
     PendingCounts counts_;
   };
 
@@ -1230,12 +1353,7 @@ class ExecutorState {
     bool CleanupIterations(const GraphView* gview, int64 iter,
                            TaggedNodeSeq* ready) EXCLUSIVE_LOCKS_REQUIRED(mu);
 
-    ~FrameState() {
-      for (size_t i = 0; i < iterations.size(); ++i) {
-        delete iterations[i];
-        iterations[i] = nullptr;
-      }
-    }
+    ~FrameState();
   };
 
   // A tagged node: <frame*, iter, node*>.
@@ -1316,6 +1434,14 @@ class ExecutorState {
 
   // Owned.
 
+  // Serves the outputs of the step from the arena of the memory plan of
+  // the executor, if it has one. Holds a reference.
+  PlannedAllocator* planned_allocator_ = nullptr;
+
+  // For the nodes producing retvals whose tensor the caller preallocated,
+  // the destination of each output, or nullptr.
+  gtl::FlatMap<int, gtl::InlinedVector<const Tensor*, 2>> output_destinations_;
+
   // A flag that is set on error after the frame state has been
   // dumped for diagnostic purposes.
   bool dumped_on_error_ = false;
@@ -1328,6 +1454,28 @@ class ExecutorState {
 
   std::atomic_int_fast32_t num_outstanding_ops_;
 
+  // The ready queues of the work-stealing mode, one per worker thread. See
+  // ScheduleReady and Process.
+  struct StealQueue {
+    mutex mu;
+    std::deque<TaggedNode> nodes GUARDED_BY(mu);
+  };
+  const int max_stealing_workers_;
+  std::unique_ptr<StealQueue[]> steal_queues_;
+  // The number of Process calls scheduled or running in the work-stealing
+  // mode.
+  std::atomic<int> num_stealing_workers_{0};
+
+  // Returns the index of the queue of the current thread.
+  int StealQueueIndex() const;
+  // Queues node on the queue of the current thread.
+  void PushStealQueue(const TaggedNode& node);
+  // Pops a node from the queue of the current thread, or steals one from
+  // another queue. Returns false if all the queues are empty.
+  bool PopStealQueues(TaggedNode* node);
+  // Schedules node on runner_ as a new worker of the work-stealing mode.
+  void StartStealingWorker(const TaggedNode& node, int64 scheduled_usec);
+
   mutex mu_;
   Status status_ GUARDED_BY(mu_);
 
@@ -1417,6 +1565,87 @@ class ExecutorState {
   }
 };
 
+// Keeps the IterationStates of finished iterations for later iterations of
+// the same frame, in any step of the executor. Loops then reuse the input
+// tensor arrays and pending counts of their iterations instead of
+// allocating them for every iteration.
+class IterationStatePool {
+ public:
+  using IterationState = ExecutorState::IterationState;
+
+  IterationStatePool() {}
+  ~IterationStatePool() {
+    for (auto& it : free_) {
+      for (IterationState* state : it.second) {
+        delete state;
+      }
+    }
+  }
+
+  // Returns an iteration for the frame with the given static information.
+  IterationState* Get(const PendingCounts* pending_counts,
+                      int total_input_tensors) {
+    IterationState* state = nullptr;
+    {
+      mutex_lock l(mu_);
+      auto it = free_.find(pending_counts);
+      if (it != free_.end() && !it->second.empty()) {
+        state = it->second.back();
+        it->second.pop_back();
+      }
+    }
+    if (state == nullptr) {
+      return new IterationState(pending_counts, total_input_tensors);
+    }
+    state->Reset();
+    return state;
+  }
+
+  // Takes back an iteration returned by Get. state may be nullptr.
+  void Release(IterationState* state) {
+    if (state == nullptr) return;
+    state->Clear();
+    mutex_lock l(mu_);
+    free_[state->initial_counts()].push_back(state);
+  }
+
+ private:
+  mutex mu_;
+  gtl::FlatMap<const PendingCounts*, std::vector<IterationState*>> free_
+      GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(IterationStatePool);
+};
+
+ExecutorImpl::ExecutorImpl(const LocalExecutorParams& p,
+                           std::unique_ptr<const Graph> g)
+    : params_(p),
+      graph_(std::move(g)),
+      gview_(),
+      iteration_pool_(new IterationStatePool) {
+  CHECK(p.create_kernel != nullptr);
+  CHECK(p.delete_kernel != nullptr);
+}
+
+ExecutorImpl::~ExecutorImpl() {
+  for (int i = 0; i < graph_->num_node_ids(); i++) {
+    NodeItem* item = gview_.node(i);
+    if (item != nullptr) {
+      params_.delete_kernel(item->kernel);
+    }
+  }
+  for (auto fiter : frame_info_) {
+    delete fiter.second;
+  }
+}
+
+ExecutorState::FrameState::~FrameState() {
+  for (size_t i = 0; i < iterations.size(); ++i) {
+    executor->iteration_pool_->Release(iterations[i]);
+    iterations[i] = nullptr;
+  }
+}
+
 ExecutorState::ExecutorState(const Executor::Args& args, ExecutorImpl* impl)
     : vlog_(VLOG_IS_ON(1)),
       log_memory_(LogMemory::IsEnabled()),
@@ -1433,7 +1662,31 @@ ExecutorState::ExecutorState(const Executor::Args& args, ExecutorImpl* impl)
       cancellation_manager_(args.cancellation_manager),
       runner_(args.runner),
       sync_on_finish_(args.sync_on_finish),
-      num_outstanding_ops_(0) {
+      num_outstanding_ops_(0),
+      max_stealing_workers_(impl->params_.max_stealing_workers) {
+  if (max_stealing_workers_ > 0) {
+    steal_queues_.reset(new StealQueue[max_stealing_workers_]);
+  }
+  if (impl_->memory_plan_ != nullptr) {
+    Allocator* device_allocator =
+        impl_->params_.device->GetAllocator(AllocatorAttributes());
+    planned_allocator_ =
+        new PlannedAllocator(impl_->memory_plan_.get(), device_allocator);
+  }
+  if (call_frame_ != nullptr) {
+    for (const ExecutorImpl::RetvalProducer& producer :
+         impl_->retval_producers_) {
+      const Tensor* destination =
+          call_frame_->GetRetvalDestination(producer.retval_index);
+      if (destination == nullptr) {
+        continue;
+      }
+      auto& destinations = output_destinations_[producer.node_id];
+      destinations.resize(impl_->gview_.node(producer.node_id)->num_outputs,
+                          nullptr);
+      destinations[producer.output] = destination;
+    }
+  }
   // We start the entire execution in iteration 0 of the root frame
   // so let us create the root frame and the state for iteration 0.
   // We assume root_frame_->frame_name.empty().
@@ -1443,7 +1696,7 @@ ExecutorState::ExecutorState(const Executor::Args& args, ExecutorImpl* impl)
 
   // Initialize iteration 0.
   root_frame_->iterations.resize(root_frame_->max_parallel_iterations);
-  root_frame_->iterations[0] = new IterationState(
+  root_frame_->iterations[0] = impl_->iteration_pool_->Get(
       root_frame_->pending_counts, root_frame_->total_input_tensors);
 
   outstanding_frames_.insert({root_frame_->frame_name, root_frame_});
@@ -1457,6 +1710,9 @@ ExecutorState::~ExecutorState() {
     it->Unref();
   }
   delete slice_reader_cache_;
+  if (planned_allocator_ != nullptr) {
+    planned_allocator_->Unref();
+  }
 }
 
 Status ExecutorImpl::BuildControlFlowInfo(const Graph* g,
@@ -1642,6 +1898,7 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_usec) {
   params.resource_manager = device->resource_manager();
   params.step_container = step_container_;
   params.slice_reader_cache = slice_reader_cache_;
+  params.planned_output_allocator = planned_allocator_;
   params.inputs = &inputs;
   params.input_device_contexts = &input_device_contexts;
   params.input_alloc_attrs = &input_alloc_attrs;
@@ -1652,10 +1909,18 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_usec) {
   NodeExecStatsWrapper* stats = nullptr;
   EntryVector outputs;
   bool completed = false;
+  // A worker of the work-stealing mode counts as an outstanding op, so that
+  // the step cannot finish while it looks at the queues.
+  const bool stealing = max_stealing_workers_ > 0;
+  if (stealing) {
+    num_outstanding_ops_.fetch_add(1, std::memory_order_relaxed);
+  }
   inline_ready.push_back(tagged_node);
-  while (!inline_ready.empty()) {
-    tagged_node = inline_ready.front();
-    inline_ready.pop_front();
+  while (!inline_ready.empty() || (stealing && PopStealQueues(&tagged_node))) {
+    if (!inline_ready.empty()) {
+      tagged_node = inline_ready.front();
+      inline_ready.pop_front();
+    }
     const Node* node = tagged_node.node;
     FrameState* input_frame = tagged_node.input_frame;
     const int64 input_iter = tagged_node.input_iter;
@@ -1674,6 +1939,14 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_usec) {
       params.op_device_context = device_context_map_[id];
     }
 
+    params.output_destinations = nullptr;
+    if (TF_PREDICT_FALSE(!output_destinations_.empty())) {
+      auto it = output_destinations_.find(id);
+      if (it != output_destinations_.end()) {
+        params.output_destinations = it->second.data();
+      }
+    }
+
     params.track_allocations = false;
     stats = nullptr;
     if (stats_collector_ && !tagged_node.is_dead) {
@@ -1831,10 +2104,58 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_usec) {
     }
   }  // while !inline_ready.empty()
 
+  if (stealing) {
+    num_stealing_workers_.fetch_sub(1, std::memory_order_relaxed);
+    completed = (num_outstanding_ops_.fetch_sub(1) == 1);
+  }
+
   // This thread of computation is done if completed = true.
   if (completed) Finish();
 }
 
+int ExecutorState::StealQueueIndex() const {
+  return std::hash<std::thread::id>()(std::this_thread::get_id()) %
+         max_stealing_workers_;
+}
+
+void ExecutorState::PushStealQueue(const TaggedNode& node) {
+  const int index = StealQueueIndex();
+  StealQueue* queue = &steal_queues_[index];
+  mutex_lock l(queue->mu);
+  queue->nodes.push_back(node);
+}
+
+bool ExecutorState::PopStealQueues(TaggedNode* node) {
+  const int index = StealQueueIndex();
+  {
+    StealQueue* queue = &steal_queues_[index];
+    mutex_lock l(queue->mu);
+    if (!queue->nodes.empty()) {
+      *node = queue->nodes.front();
+      queue->nodes.pop_front();
+      return true;
+    }
+  }
+  // Steal the most recently queued node of another thread, the oldest ones
+  // are the likeliest to be taken by their owner.
+  for (int i = 1; i < max_stealing_workers_; ++i) {
+    StealQueue* queue = &steal_queues_[(index + i) % max_stealing_workers_];
+    mutex_lock l(queue->mu);
+    if (!queue->nodes.empty()) {
+      *node = queue->nodes.back();
+      queue->nodes.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ExecutorState::StartStealingWorker(const TaggedNode& node,
+                                        int64 scheduled_usec) {
+  num_stealing_workers_.fetch_add(1, std::memory_order_relaxed);
+  runner_(std::bind(&ExecutorState::Process, this, node, scheduled_usec));
+}
+
 Status ExecutorState::PrepareInputs(const NodeItem& item, Entry* first_input,
                                     TensorValueVec* inputs,
                                     DeviceContextVec* input_device_contexts,
@@ -2216,14 +2537,63 @@ bool ExecutorState::NodeDone(const Status& s, const Node* node,
   return completed;
 }
 
-void ExecutorState::ScheduleReady(const TaggedNodeSeq& ready,
+void ExecutorState::ScheduleReady(const TaggedNodeSeq& unordered_ready,
                                   TaggedNodeReadyQueue* inline_ready) {
-  if (ready.empty()) return;
+  if (unordered_ready.empty()) return;
+
+  // Start the nodes on the longest paths first. The runner and the inline
+  // queue are FIFOs, so dispatching in priority order is enough.
+  const GraphView& gview = impl_->gview_;
+  TaggedNodeSeq sorted_ready;
+  if (impl_->params_.schedule_by_critical_path && unordered_ready.size() > 1) {
+    sorted_ready = unordered_ready;
+    std::stable_sort(sorted_ready.begin(), sorted_ready.end(),
+                     [&gview](const TaggedNode& a, const TaggedNode& b) {
+                       return gview.node(a.node->id())->critical_path_cost >
+                              gview.node(b.node->id())->critical_path_cost;
+                     });
+  }
+  const TaggedNodeSeq& ready =
+      sorted_ready.empty() ? unordered_ready : sorted_ready;
 
   int64 scheduled_usec = 0;
   if (stats_collector_) {
     scheduled_usec = nodestats::NowInUsec();
   }
+  if (max_stealing_workers_ > 0) {
+    // Work-stealing mode: inexpensive nodes run inline and expensive ones
+    // start new workers while there are fewer than max_stealing_workers_. The
+    // others wait on the queue of this thread, the current worker or idle
+    // ones take them from there without a trip through runner_.
+    if (inline_ready == nullptr) {
+      // Not called from a worker, nothing would drain the queue.
+      for (auto& tagged_node : ready) {
+        StartStealingWorker(tagged_node, scheduled_usec);
+      }
+      return;
+    }
+    for (auto& tagged_node : ready) {
+      const NodeItem& item = *gview.node(tagged_node.node->id());
+      if (tagged_node.is_dead || !item.kernel_is_expensive) {
+        inline_ready->push_back(tagged_node);
+      }
+    }
+    bool run_inline = inline_ready->empty();
+    for (auto& tagged_node : ready) {
+      const NodeItem& item = *gview.node(tagged_node.node->id());
+      if (tagged_node.is_dead || !item.kernel_is_expensive) continue;
+      if (run_inline) {
+        inline_ready->push_back(tagged_node);
+        run_inline = false;
+      } else if (num_stealing_workers_.load(std::memory_order_relaxed) <
+                 max_stealing_workers_) {
+        StartStealingWorker(tagged_node, scheduled_usec);
+      } else {
+        PushStealQueue(tagged_node);
+      }
+    }
+    return;
+  }
   if (inline_ready == nullptr) {
     // Schedule to run all the ready ops in thread pool.
     for (auto& tagged_node : ready) {
@@ -2231,7 +2601,29 @@ void ExecutorState::ScheduleReady(const TaggedNodeSeq& ready,
     }
     return;
   }
-  const GraphView& gview = impl_->gview_;
+  if (!sorted_ready.empty()) {
+    // As below inexpensive nodes run inline, but the expensive node kept by
+    // this thread is the one with the longest path rather than the last one.
+    for (auto& tagged_node : ready) {
+      const NodeItem& item = *gview.node(tagged_node.node->id());
+      if (tagged_node.is_dead || !item.kernel_is_expensive) {
+        inline_ready->push_back(tagged_node);
+      }
+    }
+    bool run_inline = inline_ready->empty();
+    for (auto& tagged_node : ready) {
+      const NodeItem& item = *gview.node(tagged_node.node->id());
+      if (tagged_node.is_dead || !item.kernel_is_expensive) continue;
+      if (run_inline) {
+        inline_ready->push_back(tagged_node);
+        run_inline = false;
+      } else {
+        runner_(std::bind(&ExecutorState::Process, this, tagged_node,
+                          scheduled_usec));
+      }
+    }
+    return;
+  }
   const TaggedNode* curr_expensive_node = nullptr;
   for (auto& tagged_node : ready) {
     const NodeItem& item = *gview.node(tagged_node.node->id());
@@ -2405,7 +2797,15 @@ void ExecutorState::Finish() {
     // the user until the step (and its side-effects) has actually completed.
     status = impl_->params_.device->Sync();
   }
+  Device* device = impl_->params_.device;
+  StepStatsCollector* stats_collector = stats_collector_;
   delete this;
+  // The memory the step released can be given back to the device now.
+  Allocator* allocator = device->GetAllocator(AllocatorAttributes());
+  allocator->Compact();
+  if (stats_collector != nullptr) {
+    stats_collector->SaveAllocatorFragmentation(device->name(), allocator);
+  }
   CHECK(done_cb != nullptr);
   runner([=]() { done_cb(status); });
 }
@@ -2445,8 +2845,8 @@ void ExecutorState::FindOrCreateChildFrame(FrameState* frame, int64 iter,
   // 'iterations' is a fixed-length circular buffer.
   temp->iterations.resize(temp->max_parallel_iterations + 1);
   // Initialize iteration 0.
-  temp->iterations[0] =
-      new IterationState(temp->pending_counts, temp->total_input_tensors);
+  temp->iterations[0] = impl_->iteration_pool_->Get(
+      temp->pending_counts, temp->total_input_tensors);
 
   {
     mutex_lock executor_lock(mu_);
@@ -2704,7 +3104,7 @@ void ExecutorState::FrameState::IncrementIteration(const GraphView* gview,
 
   // Initialize the next iteration.
   IterationState* iter_state =
-      new IterationState(pending_counts, total_input_tensors);
+      executor->iteration_pool_->Get(pending_counts, total_input_tensors);
   SetIteration(next_iter, iter_state);
   num_outstanding_iterations++;
   dead_exits.clear();
@@ -2722,7 +3122,7 @@ bool ExecutorState::FrameState::CleanupIterations(const GraphView* gview,
   int64 curr_iter = iter;
   while (curr_iter <= iteration_count && IsIterationDone(curr_iter)) {
     // Delete the iteration curr_iter.
-    delete GetIteration(curr_iter);
+    executor->iteration_pool_->Release(GetIteration(curr_iter));
     SetIteration(curr_iter, nullptr);
     --num_outstanding_iterations;
     ++curr_iter;
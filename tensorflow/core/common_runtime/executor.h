@@ -28,6 +28,7 @@ limitations under the License.
 
 namespace tensorflow {
 
+class CostModel;
 class StepStatsCollector;
 
 // Executor runs a graph computation.
@@ -141,6 +142,29 @@ struct LocalExecutorParams {
   std::function<void(OpKernel*)> delete_kernel;
 
   Executor::Args::NodeOutputsCallback node_outputs_cb;
+
+  // If true, the nodes which become ready together are started in decreasing
+  // order of the estimated time of their longest path to the end of the
+  // graph, so that the critical path of wide graphs starts early. The times
+  // are taken from cost_model when it is set, otherwise every expensive
+  // kernel counts for one unit of time and inexpensive ones for none.
+  bool schedule_by_critical_path = false;
+  const CostModel* cost_model = nullptr;
+
+  // If > 0, the executor runs at most this many Process loops at a time
+  // through the runner of a step. Expensive ready nodes which would start
+  // more are queued on per-thread queues instead, and the running loops take
+  // their next node from these queues, stealing from the other threads when
+  // their own is empty. This saves a closure and a trip through the thread
+  // pool for each such node. Should be the size of the inter-op thread pool.
+  int max_stealing_workers = 0;
+
+  // If true and the graph has no loops, the outputs of the nodes whose
+  // shapes are statically known are planned in a single arena per step,
+  // allocated with one call to the device allocator. The plan is followed
+  // as long as the tensors sharing memory in it are not alive together,
+  // the other outputs are allocated by the device as usual.
+  bool plan_memory = false;
 };
 ::tensorflow::Status NewLocalExecutor(const LocalExecutorParams& params,
                                       std::unique_ptr<const Graph> graph,
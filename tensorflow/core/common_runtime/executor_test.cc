@@ -57,10 +57,15 @@ class ExecutorTest : public ::testing::Test {
   }
 
   // Resets executor_ with a new executor based on a graph 'gdef'.
-  void Create(std::unique_ptr<const Graph> graph) {
+  void Create(std::unique_ptr<const Graph> graph,
+              bool schedule_by_critical_path = false,
+              int max_stealing_workers = 0, bool plan_memory = false) {
     const int version = graph->versions().producer();
     LocalExecutorParams params;
     params.device = device_;
+    params.schedule_by_critical_path = schedule_by_critical_path;
+    params.max_stealing_workers = max_stealing_workers;
+    params.plan_memory = plan_memory;
     params.create_kernel = [this, version](const NodeDef& ndef,
                                            OpKernel** kernel) {
       return CreateNonCachedKernel(device_, nullptr, ndef, version, kernel);
@@ -193,6 +198,29 @@ TEST_F(ExecutorTest, SelfAdd) {
   EXPECT_EQ(1024.0, V(out));  // b=v10=2*v9=4*v8=...=1024*a=1024.0
 }
 
+TEST_F(ExecutorTest, SelfAddPlannedMemory) {
+  // Same as SelfAdd, with a constant input so that every shape is known.
+  std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
+  auto v = test::graph::Constant(g.get(), V(1.0));
+  const int N = 10;
+  for (int i = 1; i <= N; ++i) {
+    v = test::graph::Add(g.get(), v, v);
+  }
+  test::graph::Send(g.get(), v, "b", BOB, 1, ALICE);
+  Create(std::move(g), /*schedule_by_critical_path=*/false,
+         /*max_stealing_workers=*/0, /*plan_memory=*/true);
+  // Every step gets its own arena.
+  for (int step = 0; step < 2; ++step) {
+    Rendezvous::Args args;
+    TF_ASSERT_OK(Run(rendez_));
+    Tensor out = V(-1);
+    bool is_dead = false;
+    TF_ASSERT_OK(rendez_->Recv(Key(BOB, kIncarnation, ALICE, "b"), args, &out,
+                               &is_dead));
+    EXPECT_EQ(1024.0, V(out));
+  }
+}
+
 // Builds a graph which adds N copies of one variable "in". I.e.,
 //     a + a + a + ... + a
 // The returned graph is parenthesized ramdonly. I.e.,
@@ -243,6 +271,37 @@ TEST_F(ExecutorTest, RandomTree) {
   EXPECT_EQ(4096.0, V(out));
 }
 
+TEST_F(ExecutorTest, RandomTreeByCriticalPath) {
+  std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
+  BuildTree(4096, g.get());
+  Create(std::move(g), /*schedule_by_critical_path=*/true);
+  Rendezvous::Args args;
+  TF_ASSERT_OK(
+      rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args, V(1.0), false));
+  TF_ASSERT_OK(Run(rendez_));
+  Tensor out = V(-1);
+  bool is_dead = false;
+  TF_ASSERT_OK(
+      rendez_->Recv(Key(BOB, kIncarnation, ALICE, "b"), args, &out, &is_dead));
+  EXPECT_EQ(4096.0, V(out));
+}
+
+TEST_F(ExecutorTest, RandomTreeWorkStealing) {
+  std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
+  BuildTree(4096, g.get());
+  Create(std::move(g), /*schedule_by_critical_path=*/false,
+         /*max_stealing_workers=*/4);
+  Rendezvous::Args args;
+  TF_ASSERT_OK(
+      rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args, V(1.0), false));
+  TF_ASSERT_OK(Run(rendez_));
+  Tensor out = V(-1);
+  bool is_dead = false;
+  TF_ASSERT_OK(
+      rendez_->Recv(Key(BOB, kIncarnation, ALICE, "b"), args, &out, &is_dead));
+  EXPECT_EQ(4096.0, V(out));
+}
+
 void BuildConcurrentAddAssign(Graph* g) {
   auto one = test::graph::Constant(g, V(1.0));
   // A variable holds one float.
@@ -215,6 +215,9 @@ class FunctionLibraryRuntimeImpl : public FunctionLibraryRuntime {
     const FunctionLibraryDefinition* overlay_lib = nullptr;  // Not owned.
     FunctionBody* func_graph = nullptr;
     Executor* exec = nullptr;
+    // Whether the function is small enough to run its nodes inline on the
+    // calling thread.
+    bool run_inline = false;
 
     ~Item() {
       delete this->func_graph;
@@ -241,6 +244,11 @@ class FunctionLibraryRuntimeImpl : public FunctionLibraryRuntime {
   void RunRemote(const Options& opts, Handle handle,
                  gtl::ArraySlice<Tensor> args, std::vector<Tensor>* rets,
                  Executor::Args* exec_args, Item* item, DoneCallback done);
+  // Sets the runner of exec_args to run item on runner. Small functions run
+  // their nodes inline instead, and only *done is passed to runner, so that
+  // loops calling them do not recurse.
+  void SetRunner(const Item& item, const Executor::Args::Runner& runner,
+                 Executor::Args* exec_args, DoneCallback* done);
 
   TF_DISALLOW_COPY_AND_ASSIGN(FunctionLibraryRuntimeImpl);
 };
@@ -618,6 +626,10 @@ void PruneFunctionBody(Graph* g) {
     FixupSourceAndSinkEdges(g);
   }
 }
+// Functions with at most this many op nodes run inline on the calling thread:
+// handing each node to the runner costs more than the parallelism it brings.
+constexpr int kMaxNodesToRunInline = 16;
+
 }  // namespace
 
 Status FunctionLibraryRuntimeImpl::CreateItem(Handle handle, Item** item) {
@@ -656,6 +668,7 @@ Status FunctionLibraryRuntimeImpl::CreateItem(Handle handle, Item** item) {
     DeleteNonCachedKernel(kernel);
   };
   Graph* graph = g.get();
+  const bool run_inline = graph->num_op_nodes() <= kMaxNodesToRunInline;
   Executor* exec;
   TF_RETURN_IF_ERROR(NewLocalExecutor(params, std::move(g), &exec));
 
@@ -667,6 +680,7 @@ Status FunctionLibraryRuntimeImpl::CreateItem(Handle handle, Item** item) {
     } else {
       (*item)->graph = graph;
       (*item)->exec = exec;
+      (*item)->run_inline = run_inline;
     }
   }
   return Status::OK();
@@ -690,6 +704,24 @@ Status FunctionLibraryRuntimeImpl::GetOrCreateItem(Handle handle, Item** item) {
   return CreateItem(handle, item);
 }
 
+void FunctionLibraryRuntimeImpl::SetRunner(const Item& item,
+                                           const Executor::Args::Runner& runner,
+                                           Executor::Args* exec_args,
+                                           DoneCallback* done) {
+  if (!item.run_inline || !runner) {
+    exec_args->runner = runner;
+    return;
+  }
+  exec_args->runner = [](Executor::Args::Closure c) { c(); };
+  *done = std::bind(
+      [runner](DoneCallback done,
+               // Begin unbound arguments.
+               const Status& status) {
+        runner(std::bind(std::move(done), status));
+      },
+      std::move(*done), std::placeholders::_1);
+}
+
 void FunctionLibraryRuntimeImpl::RunRemote(const Options& opts, Handle handle,
                                            gtl::ArraySlice<Tensor> args,
                                            std::vector<Tensor>* rets,
@@ -809,7 +841,6 @@ void FunctionLibraryRuntimeImpl::Run(const Options& opts, Handle handle,
   exec_args->stats_collector = run_opts.stats_collector;
   exec_args->cancellation_manager = run_opts.cancellation_manager;
   exec_args->step_container = run_opts.step_container;
-  exec_args->runner = *run_opts.runner;
   exec_args->collective_executor = run_opts.collective_executor;
 
   Item* item = nullptr;
@@ -821,10 +852,12 @@ void FunctionLibraryRuntimeImpl::Run(const Options& opts, Handle handle,
   }
 
   if (run_opts.remote_execution) {
+    exec_args->runner = *run_opts.runner;
     // NOTE(mrry): `RunRemote()` will set `exec_args->call_frame` for us.
     RunRemote(run_opts, handle, args, rets, exec_args, item, done);
     return;
   }
+  SetRunner(*item, *run_opts.runner, exec_args, &done);
 
   const FunctionBody* fbody = GetFunctionBody(handle);
   FunctionCallFrame* frame =
@@ -900,7 +933,7 @@ void FunctionLibraryRuntimeImpl::Run(const Options& opts, Handle handle,
   exec_args->cancellation_manager = run_opts.cancellation_manager;
   exec_args->collective_executor = run_opts.collective_executor;
   exec_args->step_container = run_opts.step_container;
-  exec_args->runner = *run_opts.runner;
+  SetRunner(*item, *run_opts.runner, exec_args, &done);
   exec_args->call_frame = frame;
 
   item->exec->RunAsync(
@@ -379,6 +379,32 @@ TEST_F(FunctionLibraryRuntimeTest, XTimesTwo) {
   test::ExpectTensorEqual<float>(y, test::AsTensor<float>({2, 4, 6, 8}));
 }
 
+TEST_F(FunctionLibraryRuntimeTest, SmallFunctionRunsInline) {
+  Init({test::function::XTimesTwo()});
+  FunctionLibraryRuntime::Handle handle;
+  TF_CHECK_OK(Instantiate(flr0_, "XTimesTwo", {{"T", DT_FLOAT}}, &handle));
+
+  // The nodes run on the calling thread, only the done callback goes through
+  // the runner.
+  int call_count = 0;
+  std::function<void(std::function<void()>)> runner =
+      [&call_count](std::function<void()> fn) {
+        ++call_count;
+        fn();
+      };
+  FunctionLibraryRuntime::Options opts;
+  opts.runner = &runner;
+  auto x = test::AsTensor<float>({1, 2, 3, 4});
+  std::vector<Tensor> out;
+  Status status;
+  flr0_->Run(opts, handle, {x}, &out,
+             [&status](const Status& s) { status = s; });
+  TF_EXPECT_OK(status);
+  ASSERT_EQ(1, out.size());
+  test::ExpectTensorEqual<float>(out[0], test::AsTensor<float>({2, 4, 6, 8}));
+  EXPECT_EQ(1, call_count);
+}
+
 TEST_F(FunctionLibraryRuntimeTest, XTimesN) {
   Init({test::function::XTimesTwo(), test::function::XTimesFour(),
         test::function::XTimes16()});
@@ -34,6 +34,13 @@ GPUBFCAllocator::GPUBFCAllocator(CudaGpuId cuda_gpu_id, size_t total_memory,
               GpuIdUtil::ExecutorForCudaGpuId(cuda_gpu_id).ValueOrDie(),
               gpu_options.per_process_gpu_memory_fraction() > 1.0 ||
                   gpu_options.experimental().use_unified_memory()),
-          total_memory, gpu_options.allow_growth(), name) {}
+          total_memory, gpu_options.allow_growth(), name) {
+  if (gpu_options.experimental().bfc_allocator_chunk_caches()) {
+    EnableChunkCaches();
+  }
+  if (gpu_options.experimental().bfc_allocator_compaction()) {
+    EnableCompaction();
+  }
+}
 
 }  // namespace tensorflow
@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/platform/test.h"
@@ -74,6 +75,78 @@ TEST(GPUBFCAllocatorTest, NoDups) {
   CheckStats(&a, 1023, 0, 654336, 1024);
 }
 
+TEST(GPUBFCAllocatorTest, ChunkCaches) {
+  GPUOptions options;
+  options.mutable_experimental()->set_bfc_allocator_chunk_caches(true);
+  GPUBFCAllocator a(CudaGpuId(0), 1 << 30, options, "GPU_0_bfc");
+
+  float* t1 = a.Allocate<float>(256);
+  const int64 id = a.AllocationId(t1);
+  a.DeallocateRaw(t1);
+  // The chunk of t1 is cached and fits without a split.
+  float* t2 = a.Allocate<float>(200);
+  EXPECT_EQ(t1, t2);
+  EXPECT_EQ(800, a.RequestedSize(t2));
+  EXPECT_NE(id, a.AllocationId(t2));
+  a.DeallocateRaw(t2);
+  // GetStats flushes the caches.
+  CheckStats(&a, 2, 0, 1024, 1024);
+
+  {
+    thread::ThreadPool pool(Env::Default(), "chunk_caches", 8);
+    for (int t = 0; t < 8; ++t) {
+      pool.Schedule([&a]() {
+        for (int i = 0; i < 10000; ++i) {
+          void* raw = a.AllocateRaw(1, 1 + (i * 97) % 65536);
+          a.DeallocateRaw(raw);
+        }
+      });
+    }
+  }
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(0, stats.bytes_in_use);
+  EXPECT_EQ(80002, stats.num_allocs);
+}
+
+TEST(GPUBFCAllocatorTest, CompactionReleasesIdleRegions) {
+  GPUOptions options;
+  options.set_allow_growth(true);
+  options.mutable_experimental()->set_bfc_allocator_compaction(true);
+  GPUBFCAllocator a(CudaGpuId(0), 1 << 30, options, "GPU_0_bfc");
+
+  // A region of 1MiB, then one of 2MiB.
+  float* t1 = a.Allocate<float>(1 << 18);
+  float* t2 = a.Allocate<float>(1 << 18);
+  AllocatorFragmentation fragmentation;
+  ASSERT_TRUE(a.GetFragmentation(&fragmentation));
+  EXPECT_EQ(2, fragmentation.num_regions);
+  EXPECT_EQ(3 << 20, fragmentation.region_bytes);
+  EXPECT_EQ(1 << 20, fragmentation.free_bytes);
+  EXPECT_EQ(1 << 20, fragmentation.largest_free_block_bytes);
+
+  a.DeallocateRaw(t1);
+  // A region is released after 8 compactions in a row found it free.
+  for (int i = 1; i < 8; ++i) {
+    a.Compact();
+  }
+  ASSERT_TRUE(a.GetFragmentation(&fragmentation));
+  EXPECT_EQ(2, fragmentation.num_regions);
+  a.Compact();
+  ASSERT_TRUE(a.GetFragmentation(&fragmentation));
+  EXPECT_EQ(1, fragmentation.num_regions);
+  EXPECT_EQ(2 << 20, fragmentation.region_bytes);
+
+  // The largest region is kept even once idle.
+  a.DeallocateRaw(t2);
+  for (int i = 0; i < 8; ++i) {
+    a.Compact();
+  }
+  ASSERT_TRUE(a.GetFragmentation(&fragmentation));
+  EXPECT_EQ(1, fragmentation.num_regions);
+  EXPECT_EQ(2 << 20, fragmentation.largest_free_block_bytes);
+}
+
 TEST(GPUBFCAllocatorTest, AllocationsAndDeallocations) {
   GPUBFCAllocator a(CudaGpuId(0), 1 << 30, "GPU_0_bfc");
   // Allocate 256 raw pointers of sizes between 100 bytes and about
@@ -449,15 +449,44 @@ void BaseGPUDevice::ComputeHelper(OpKernel* op_kernel,
   const auto stream_id = gpu_device_context->stream_id();
 
   const bool vlog_1 = VLOG_IS_ON(1);
-  const bool vlog_2 = vlog_1 && VLOG_IS_ON(2);
 
   if (vlog_1) {
     VLOG(1) << "GpuDevice::ComputeHelper "
             << ComputeOpKernelDebugString(*op_kernel, stream_id);
   }
 
+  WaitForInputStreams(context, stream, stream_id);
+  if (!context->status().ok()) return;
+  se::cuda::ScopedActivateExecutorContext scoped_activation{stream->parent()};
+  op_kernel->Compute(context);
+  if (context->status().ok()) {
+    if (sync_every_op_) {
+      // Note: GPUUtil::Sync() only syncs the default stream.
+      // We need to either sync the stream used by this op, or
+      // all streams.  Given that this flag is typically used for
+      // debugging it makes more sense to sync all GPU activity.
+      context->SetStatus(GPUUtil::SyncAll(this));
+      if (vlog_1) {
+        VLOG(1) << "GpuDevice::ComputeHelper finished "
+                << ComputeOpKernelDebugString(*op_kernel, stream_id);
+      }
+    } else if (vlog_1) {
+      VLOG(1) << "GpuDevice::ComputeHelper scheduled "
+              << ComputeOpKernelDebugString(*op_kernel, stream_id);
+    }
+  } else {
+    if (vlog_1) {
+      VLOG(1) << "GpuDevice::ComputeHelper failed to schedule "
+              << ComputeOpKernelDebugString(*op_kernel, stream_id);
+    }
+  }
+}
+
+void BaseGPUDevice::WaitForInputStreams(OpKernelContext* context,
+                                        se::Stream* stream, int stream_id) {
   const auto num_streams = streams_.size();
   if (num_streams > 1) {
+    const bool vlog_2 = VLOG_IS_ON(1) && VLOG_IS_ON(2);
     // If this op's device context is different from the other contexts,
     // we must wait on the stream.
     for (int i = 0; i < context->num_inputs(); ++i) {
@@ -488,29 +517,6 @@ void BaseGPUDevice::ComputeHelper(OpKernel* op_kernel,
       if (idc->stream() != stream) stream->ThenWaitFor(idc->stream());
     }
   }
-  se::cuda::ScopedActivateExecutorContext scoped_activation{stream->parent()};
-  op_kernel->Compute(context);
-  if (context->status().ok()) {
-    if (sync_every_op_) {
-      // Note: GPUUtil::Sync() only syncs the default stream.
-      // We need to either sync the stream used by this op, or
-      // all streams.  Given that this flag is typically used for
-      // debugging it makes more sense to sync all GPU activity.
-      context->SetStatus(GPUUtil::SyncAll(this));
-      if (vlog_1) {
-        VLOG(1) << "GpuDevice::ComputeHelper finished "
-                << ComputeOpKernelDebugString(*op_kernel, stream_id);
-      }
-    } else if (vlog_1) {
-      VLOG(1) << "GpuDevice::ComputeHelper scheduled "
-              << ComputeOpKernelDebugString(*op_kernel, stream_id);
-    }
-  } else {
-    if (vlog_1) {
-      VLOG(1) << "GpuDevice::ComputeHelper failed to schedule "
-              << ComputeOpKernelDebugString(*op_kernel, stream_id);
-    }
-  }
 }
 
 void BaseGPUDevice::ConsumeListOfAccessedTensors(
@@ -542,6 +548,12 @@ void BaseGPUDevice::ComputeAsync(AsyncOpKernel* op_kernel,
           << op_kernel->type_string() << " on GPU" << tf_gpu_id_ << " stream["
           << stream_id << "]";
 
+  WaitForInputStreams(context, stream, stream_id);
+  if (!context->status().ok()) {
+    done();
+    return;
+  }
+
   // When Xprof profiling is off (which is the default), constructing the
   // activity is simple enough that its overhead is negligible.
   tracing::ScopedActivity activity(op_kernel->name(), op_kernel->type_string(),
@@ -139,6 +139,11 @@ class BaseGPUDevice : public LocalDevice {
 
   void ComputeHelper(OpKernel* op_kernel, OpKernelContext* context);
 
+  // Makes "stream" wait for the streams of the inputs of "context" which
+  // were produced on other streams.
+  void WaitForInputStreams(OpKernelContext* context, se::Stream* stream,
+                           int stream_id);
+
   string ComputeOpKernelDebugString(const OpKernel& op_kernel,
                                     const int& stream_id);
 
@@ -20,6 +20,8 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/gpu/gpu_id_utils.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_init.h"
 #include "tensorflow/core/common_runtime/gpu/process_state.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/testlib.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
@@ -64,7 +66,8 @@ class GPUDeviceTest : public ::testing::Test {
   static SessionOptions MakeSessionOptions(
       const string& visible_device_list = "",
       double per_process_gpu_memory_fraction = 0, int gpu_device_count = 1,
-      const std::vector<std::vector<float>>& memory_limit_mb = {}) {
+      const std::vector<std::vector<float>>& memory_limit_mb = {},
+      int num_compute_streams = 0) {
     SessionOptions options;
     ConfigProto* config = &options.config;
     (*config->mutable_device_count())["GPU"] = gpu_device_count;
@@ -79,6 +82,8 @@ class GPUDeviceTest : public ::testing::Test {
         virtual_devices->add_memory_limit_mb(mb);
       }
     }
+    gpu_options->mutable_experimental()->set_num_compute_streams(
+        num_compute_streams);
     return options;
   }
 };
@@ -279,6 +284,34 @@ TEST_F(GPUDeviceTest, UnifiedMemoryAllocation) {
   gtl::STLDeleteElements(&devices);
 }
 
+TEST_F(GPUDeviceTest, MultipleComputeStreams) {
+  SessionOptions opts = MakeSessionOptions("0", 0, 1, {}, 2);
+  std::vector<tensorflow::Device*> devices;
+  TF_ASSERT_OK(DeviceFactory::GetFactory("GPU")->CreateDevices(
+      opts, kDeviceNamePrefix, &devices));
+  ASSERT_EQ(1, devices.size());
+
+  // Nodes without inputs start new streams, so two independent constants
+  // run on different streams.
+  Graph graph(OpRegistry::Global());
+  Node* a = test::graph::Constant(&graph, Tensor(1.0f));
+  Node* b = test::graph::Constant(&graph, Tensor(2.0f));
+  DeviceContextMap device_context_map;
+  TF_ASSERT_OK(devices[0]->FillContextMap(&graph, &device_context_map));
+  ASSERT_EQ(graph.num_node_ids(), device_context_map.size());
+  auto* a_context =
+      static_cast<GPUDeviceContext*>(device_context_map[a->id()]);
+  auto* b_context =
+      static_cast<GPUDeviceContext*>(device_context_map[b->id()]);
+  EXPECT_NE(a_context->stream_id(), b_context->stream_id());
+  EXPECT_NE(a_context->stream(), b_context->stream());
+  for (DeviceContext* context : device_context_map) {
+    if (context != nullptr) context->Unref();
+  }
+
+  gtl::STLDeleteElements(&devices);
+}
+
 }  // namespace tensorflow
 
 #endif
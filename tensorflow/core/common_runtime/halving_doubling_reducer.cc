@@ -0,0 +1,244 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/halving_doubling_reducer.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/common_runtime/collective_rma_local.h"
+#include "tensorflow/core/common_runtime/device_mgr.h"
+#include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+
+namespace tensorflow {
+namespace {
+// BufRendezvous key of the value sent by the device of rank 'source_rank' at
+// step 'step' of phase 'phase' (0 for reduce-scatter, 1 for all-gather).
+string HalvingDoublingBufKey(const string& exec_key, int phase, int step,
+                             int source_rank) {
+  return strings::StrCat(exec_key, ":hd:", phase, ":", step, ":", source_rank);
+}
+}  // namespace
+
+HalvingDoublingReducer::HalvingDoublingReducer(
+    CollectiveExecutor* col_exec, const DeviceMgr* dev_mgr,
+    OpKernelContext* ctx, OpKernelContext::Params* op_params,
+    const CollectiveParams& col_params, const string& exec_key, int64 step_id,
+    const Tensor* input, Tensor* output)
+    : col_exec_(col_exec),
+      dev_mgr_(dev_mgr),
+      ctx_(ctx),
+      op_params_(op_params),
+      col_params_(col_params),
+      exec_key_(exec_key),
+      input_(input),
+      output_(output),
+      rank_(col_params.subdiv_rank[0]),
+      group_size_(col_params.group.group_size),
+      device_(nullptr) {
+  CHECK(IsSupportedGroupSize(group_size_)) << group_size_;
+}
+
+/*static*/
+bool HalvingDoublingReducer::IsSupportedGroupSize(int group_size) {
+  return group_size > 0 && (group_size & (group_size - 1)) == 0;
+}
+
+void HalvingDoublingReducer::Run(StatusCallback done) {
+  CHECK(dev_mgr_);
+  Status status = dev_mgr_->LookupDevice(
+      col_params_.instance.device_names[col_params_.default_rank], &device_);
+  if (!status.ok()) {
+    done(status);
+    return;
+  }
+  device_locality_ = device_->attributes().locality();
+
+  // Start by copying input to output if they're not already the same, i.e. if
+  // we're not computing in-place on the input tensor.
+  if ((input_ != output_) &&
+      (DMAHelper::base(input_) != DMAHelper::base(output_))) {
+    // We are running in a blockable thread and the callback can't block so
+    // just wait here on the copy.
+    Notification note;
+    CollectiveRemoteAccessLocal::MemCpyAsync(
+        ctx_->input_device_context(0), ctx_->op_device_context(), device_,
+        device_, ctx_->input_alloc_attr(0), ctx_->output_alloc_attr(0), input_,
+        output_, [&note, &status](const Status& s) {
+          status.Update(s);
+          note.Notify();
+        });
+    note.WaitForNotification();
+    if (!status.ok()) {
+      done(status);
+      return;
+    }
+  }
+
+  ca_.reset(MakeCollectiveAdapter(output_, group_size_,
+                                  device_->GetAllocator(
+                                      ctx_->output_alloc_attr(0))));
+  status = InitGroupSizeTensor();
+  if (status.ok()) {
+    status = RunSteps();
+  }
+  if (!status.ok()) {
+    StartAbort(status);
+  } else {
+    // Recover the output from the adaptor.
+    ca_->ConsumeFinalValue(output_);
+  }
+  {
+    mutex_lock l(status_mu_);
+    status = status_;
+  }
+  done(status);
+}
+
+Status HalvingDoublingReducer::InitGroupSizeTensor() {
+  if (!col_params_.final_op) return Status::OK();
+  // Create an on-device scalar value from group_size_ for the final_op.
+  Tensor group_size_val = ca_->Scalar(group_size_);
+  if (col_params_.group.device_type == "CPU") {
+    group_size_tensor_ = group_size_val;
+    return Status::OK();
+  }
+  group_size_tensor_ =
+      ca_->Scalar(device_->GetAllocator(ctx_->input_alloc_attr(0)));
+  Notification note;
+  Status status;
+  ctx_->op_device_context()->CopyCPUTensorToDevice(
+      &group_size_val, device_, &group_size_tensor_,
+      [&note, &status](const Status& s) {
+        status = s;
+        note.Notify();
+      });
+  note.WaitForNotification();
+  return status;
+}
+
+void HalvingDoublingReducer::StartAbort(const Status& s) {
+  bool abort_started = false;
+  {
+    mutex_lock l(status_mu_);
+    if (status_.ok()) {
+      LOG(ERROR) << "Aborting HalvingDoublingReduce with " << s;
+      abort_started = true;
+      status_.Update(s);
+    }
+  }
+  // Cancel the outstanding transfers of all the devices of the group.
+  if (abort_started) {
+    col_exec_->StartAbort(s);
+  }
+}
+
+Status HalvingDoublingReducer::Exchange(int phase, int step, int peer_rank,
+                                        Tensor* send, Tensor* recv) {
+  const int peer_dev_idx =
+      col_params_.instance.impl_details.subdiv_permutations[0][peer_rank];
+  const string& peer_device = col_params_.instance.device_names[peer_dev_idx];
+  const string& peer_task = col_params_.instance.task_names[peer_dev_idx];
+  Notification send_note;
+  Notification recv_note;
+  Status send_status;
+  Status recv_status;
+  // A failed transfer aborts the others right away, since the peer of the
+  // other transfer may never come.
+  if (send->NumElements() > 0) {
+    col_exec_->PostToPeer(
+        peer_device, peer_task,
+        HalvingDoublingBufKey(exec_key_, phase, step, rank_), device_,
+        ctx_->op_device_context(), ctx_->output_alloc_attr(0), send,
+        device_locality_, [this, &send_note, &send_status](const Status& s) {
+          if (!s.ok()) StartAbort(s);
+          send_status = s;
+          send_note.Notify();
+        });
+  } else {
+    send_note.Notify();
+  }
+  if (recv->NumElements() > 0) {
+    col_exec_->RecvFromPeer(
+        peer_device, peer_task, col_params_.task.is_local[peer_dev_idx],
+        HalvingDoublingBufKey(exec_key_, phase, step, peer_rank), device_,
+        ctx_->op_device_context(), ctx_->output_alloc_attr(0), recv,
+        device_locality_, [this, &recv_note, &recv_status](const Status& s) {
+          if (!s.ok()) StartAbort(s);
+          recv_status = s;
+          recv_note.Notify();
+        });
+  } else {
+    recv_note.Notify();
+  }
+  send_note.WaitForNotification();
+  recv_note.WaitForNotification();
+  TF_RETURN_IF_ERROR(send_status);
+  return recv_status;
+}
+
+Status HalvingDoublingReducer::RunSteps() {
+  int num_steps = 0;
+  while ((1 << num_steps) < group_size_) ++num_steps;
+
+  // This device is responsible for the chunks [first, first + num_chunks).
+  int first = 0;
+  int num_chunks = group_size_;
+
+  // Reduce-scatter.
+  for (int step = 0; step < num_steps; ++step) {
+    const int mask = 1 << step;
+    num_chunks /= 2;
+    const bool keep_low = (rank_ & mask) == 0;
+    const int keep_first = keep_low ? first : first + num_chunks;
+    const int send_first = keep_low ? first + num_chunks : first;
+    Tensor send = ca_->ChunkRangeAlias(send_first, num_chunks);
+    Tensor keep = ca_->ChunkRangeAlias(keep_first, num_chunks);
+    Tensor received = ca_->TempChunkRange(keep_first, num_chunks);
+    TF_RETURN_IF_ERROR(Exchange(0, step, rank_ ^ mask, &send, &received));
+    if (keep.NumElements() > 0) {
+      TF_RETURN_IF_ERROR(ComputeBinOp(ctx_, op_params_, device_,
+                                      col_params_.merge_op.get(), &keep,
+                                      &received));
+    }
+    first = keep_first;
+  }
+
+  // This device now holds the full reduction of chunk 'first'.
+  if (col_params_.final_op) {
+    Tensor chunk = ca_->ChunkAlias(first);
+    if (chunk.NumElements() > 0) {
+      TF_RETURN_IF_ERROR(ComputeBinOp(ctx_, op_params_, device_,
+                                      col_params_.final_op.get(), &chunk,
+                                      &group_size_tensor_));
+    }
+  }
+
+  // All-gather.
+  for (int step = num_steps - 1; step >= 0; --step) {
+    const int mask = 1 << step;
+    const int peer_first =
+        (rank_ & mask) == 0 ? first + num_chunks : first - num_chunks;
+    Tensor send = ca_->ChunkRangeAlias(first, num_chunks);
+    Tensor recv = ca_->ChunkRangeAlias(peer_first, num_chunks);
+    TF_RETURN_IF_ERROR(Exchange(1, step, rank_ ^ mask, &send, &recv));
+    first = std::min(first, peer_first);
+    num_chunks *= 2;
+  }
+  return Status::OK();
+}
+
+}  // namespace tensorflow
@@ -22,7 +22,10 @@ limitations under the License.
 #include "tensorflow/core/platform/byte_order.h"
 #include "tensorflow/core/platform/cpu_feature_guard.h"
 #include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/public/session_options.h"
 
@@ -32,17 +35,29 @@ namespace tensorflow {
 bool LocalDevice::use_global_threadpool_ = true;
 
 struct LocalDevice::EigenThreadPoolInfo {
-  explicit EigenThreadPoolInfo(const SessionOptions& options) {
+  // The threads of the pool are pinned to "numa_node", unless it is
+  // port::kNUMANoAffinity. A pinned pool gets its share of the threads of the
+  // machine.
+  EigenThreadPoolInfo(const SessionOptions& options, int numa_node) {
     int32 intra_op_parallelism_threads =
         options.config.intra_op_parallelism_threads();
     if (intra_op_parallelism_threads == 0) {
       intra_op_parallelism_threads = port::NumSchedulableCPUs();
     }
+    ThreadOptions thread_opts;
+    string name = "Eigen";
+    if (numa_node != port::kNUMANoAffinity) {
+      const int num_nodes = port::NUMANumNodes();
+      intra_op_parallelism_threads =
+          (intra_op_parallelism_threads + num_nodes - 1) / num_nodes;
+      thread_opts.numa_node = numa_node;
+      name = strings::StrCat("numa_", numa_node, "_Eigen");
+    }
     VLOG(1) << "Local device intra op parallelism threads: "
             << intra_op_parallelism_threads;
     eigen_worker_threads_.num_threads = intra_op_parallelism_threads;
     eigen_worker_threads_.workers = new thread::ThreadPool(
-        options.env, "Eigen", intra_op_parallelism_threads);
+        options.env, thread_opts, name, intra_op_parallelism_threads);
     eigen_threadpool_wrapper_.reset(
         new EigenThreadPoolWrapper(eigen_worker_threads_.workers));
     eigen_device_.reset(new Eigen::ThreadPoolDevice(
@@ -66,17 +81,37 @@ LocalDevice::LocalDevice(const SessionOptions& options,
   // Log info messages if TensorFlow is not compiled with instructions that
   // could speed up performance and are available on the current CPU.
   port::InfoAboutUnusedCPUFeatures();
+  int numa_node = port::kNUMANoAffinity;
+  if (options.config.experimental().use_numa_affinity() &&
+      port::NUMAEnabled()) {
+    numa_node = attributes.locality().numa_node();
+    if (numa_node < 0 || numa_node >= port::NUMANumNodes()) {
+      numa_node = port::kNUMANoAffinity;
+    }
+  }
   LocalDevice::EigenThreadPoolInfo* tp_info;
   if (use_global_threadpool_) {
-    // All ThreadPoolDevices in the process will use this single fixed
-    // sized threadpool for numerical computations.
-    static LocalDevice::EigenThreadPoolInfo* global_tp_info =
-        new LocalDevice::EigenThreadPoolInfo(options);
-    tp_info = global_tp_info;
+    // All ThreadPoolDevices in the process, or on the same NUMA node, will
+    // use this single fixed sized threadpool for numerical computations.
+    static mutex mu(LINKER_INITIALIZED);
+    static std::vector<LocalDevice::EigenThreadPoolInfo*>* global_tp_info =
+        new std::vector<LocalDevice::EigenThreadPoolInfo*>;
+    mutex_lock l(mu);
+    // Index 0 holds the pool without affinity.
+    const int index = numa_node + 1;
+    if (global_tp_info->size() <= index) {
+      global_tp_info->resize(index + 1, nullptr);
+    }
+    if ((*global_tp_info)[index] == nullptr) {
+      (*global_tp_info)[index] =
+          new LocalDevice::EigenThreadPoolInfo(options, numa_node);
+    }
+    tp_info = (*global_tp_info)[index];
   } else {
     // Each LocalDevice owns a separate ThreadPoolDevice for numerical
     // computations.
-    owned_tp_info_.reset(new LocalDevice::EigenThreadPoolInfo(options));
+    owned_tp_info_.reset(
+        new LocalDevice::EigenThreadPoolInfo(options, numa_node));
     tp_info = owned_tp_info_.get();
   }
   set_tensorflow_cpu_worker_threads(&tp_info->eigen_worker_threads_);
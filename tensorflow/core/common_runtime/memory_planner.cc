@@ -0,0 +1,231 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/memory_planner.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "tensorflow/core/common_runtime/shape_refiner.h"
+#include "tensorflow/core/framework/shape_inference.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+namespace {
+
+int64 AlignedSize(int64 size) {
+  const int64 alignment = Allocator::kAllocatorAlignment;
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+void PlanMemory(const std::vector<MemoryPlanBuffer>& buffers,
+                MemoryPlan* plan) {
+  const int num_buffers = buffers.size();
+  plan->slots.assign(num_buffers, MemoryPlan::Slot{0, 0});
+  plan->overlaps.assign(num_buffers, std::vector<int>());
+  plan->slots_by_size.clear();
+  plan->arena_bytes = 0;
+
+  std::vector<int> order(num_buffers);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&buffers](int a, int b) {
+    return buffers[a].size > buffers[b].size;
+  });
+
+  // Places each buffer in the smallest gap it fits in between the slots
+  // already assigned to buffers live at the same time, or after all of them.
+  std::vector<int> placed;
+  std::vector<const MemoryPlan::Slot*> live;
+  for (int i : order) {
+    const MemoryPlanBuffer& buffer = buffers[i];
+    live.clear();
+    for (int j : placed) {
+      if (buffers[j].start <= buffer.end && buffer.start <= buffers[j].end) {
+        live.push_back(&plan->slots[j]);
+      }
+    }
+    std::sort(live.begin(), live.end(),
+              [](const MemoryPlan::Slot* a, const MemoryPlan::Slot* b) {
+                return a->offset < b->offset;
+              });
+    const int64 size = AlignedSize(buffer.size);
+    int64 best_offset = -1;
+    int64 best_gap = std::numeric_limits<int64>::max();
+    int64 offset = 0;
+    for (const MemoryPlan::Slot* slot : live) {
+      const int64 gap = slot->offset - offset;
+      if (gap >= size && gap < best_gap) {
+        best_offset = offset;
+        best_gap = gap;
+      }
+      offset = std::max(offset, slot->offset + AlignedSize(slot->size));
+    }
+    if (best_offset < 0) {
+      best_offset = offset;
+    }
+    plan->slots[i] = MemoryPlan::Slot{best_offset, buffer.size};
+    plan->arena_bytes = std::max(plan->arena_bytes, best_offset + size);
+    placed.push_back(i);
+  }
+
+  // Records the slots sharing bytes, which must not be in use together.
+  std::sort(order.begin(), order.end(), [plan](int a, int b) {
+    return plan->slots[a].offset < plan->slots[b].offset;
+  });
+  for (int i = 0; i < num_buffers; ++i) {
+    const MemoryPlan::Slot& slot = plan->slots[order[i]];
+    const int64 end = slot.offset + AlignedSize(slot.size);
+    for (int j = i + 1; j < num_buffers && plan->slots[order[j]].offset < end;
+         ++j) {
+      plan->overlaps[order[i]].push_back(order[j]);
+      plan->overlaps[order[j]].push_back(order[i]);
+    }
+  }
+
+  std::sort(order.begin(), order.end(), [&buffers](int a, int b) {
+    return buffers[a].start < buffers[b].start ||
+           (buffers[a].start == buffers[b].start && a < b);
+  });
+  for (int i : order) {
+    plan->slots_by_size[buffers[i].size].push_back(i);
+  }
+}
+
+Status PlanGraphMemory(const Graph& graph,
+                       const std::function<bool(const Node*, int)>& plannable,
+                       MemoryPlan* plan) {
+  ShapeRefiner refiner(graph.versions(), graph.op_registry());
+  refiner.set_require_shape_inference_fns(false);
+  std::vector<Node*> order;
+  GetReversePostOrder(graph, &order);
+  std::vector<int64> position(graph.num_node_ids(), -1);
+  for (int i = 0; i < order.size(); ++i) {
+    TF_RETURN_IF_ERROR(refiner.AddNode(order[i]));
+    position[order[i]->id()] = i;
+  }
+
+  std::vector<MemoryPlanBuffer> buffers;
+  for (const Node* n : order) {
+    shape_inference::InferenceContext* c = refiner.GetContext(n);
+    for (int i = 0; i < n->num_outputs(); ++i) {
+      const DataType dtype = n->output_type(i);
+      if (IsRefType(dtype) || !DataTypeCanUseMemcpy(dtype) ||
+          !plannable(n, i)) {
+        continue;
+      }
+      shape_inference::ShapeHandle shape = c->output(i);
+      if (!c->FullyDefined(shape)) {
+        continue;
+      }
+      const int64 num_elements = c->Value(c->NumElements(shape));
+      if (num_elements <= 0) {
+        continue;
+      }
+      MemoryPlanBuffer buffer{num_elements * DataTypeSize(dtype),
+                              position[n->id()], position[n->id()]};
+      for (const Edge* e : n->out_edges()) {
+        if (!e->IsControlEdge() && e->src_output() == i) {
+          buffer.end = std::max(buffer.end, position[e->dst()->id()]);
+        }
+      }
+      buffers.push_back(buffer);
+    }
+  }
+  PlanMemory(buffers, plan);
+  VLOG(1) << "Planned " << buffers.size() << " tensors of the graph in "
+          << plan->arena_bytes << " bytes";
+  return Status::OK();
+}
+
+PlannedAllocator::PlannedAllocator(const MemoryPlan* plan, Allocator* base)
+    : plan_(plan),
+      base_(base),
+      arena_bytes_(plan->arena_bytes),
+      slot_live_(plan->slots.size(), false) {
+  if (arena_bytes_ > 0) {
+    // If the arena cannot be allocated every allocation goes to base_.
+    arena_ = static_cast<char*>(
+        base_->AllocateRaw(Allocator::kAllocatorAlignment, arena_bytes_));
+  }
+}
+
+PlannedAllocator::~PlannedAllocator() {
+  DCHECK(live_slots_.empty());
+  if (arena_ != nullptr) {
+    base_->DeallocateRaw(arena_);
+  }
+}
+
+void* PlannedAllocator::AllocateRaw(size_t alignment, size_t num_bytes) {
+  return AllocateRaw(alignment, num_bytes, AllocationAttributes());
+}
+
+void* PlannedAllocator::AllocateRaw(
+    size_t alignment, size_t num_bytes,
+    const AllocationAttributes& allocation_attr) {
+  if (arena_ != nullptr && alignment <= Allocator::kAllocatorAlignment) {
+    mutex_lock l(mu_);
+    auto it = plan_->slots_by_size.find(num_bytes);
+    if (it != plan_->slots_by_size.end()) {
+      // The slots skipped because they conflict with a tensor in use are not
+      // revisited, that keeps the cost of a step linear in the plan size.
+      const std::vector<int>& slots = it->second;
+      size_t* next = &next_slot_[num_bytes];
+      while (*next < slots.size()) {
+        const int slot = slots[(*next)++];
+        bool conflict = false;
+        for (int other : plan_->overlaps[slot]) {
+          if (slot_live_[other]) {
+            conflict = true;
+            break;
+          }
+        }
+        if (!conflict) {
+          const int64 offset = plan_->slots[slot].offset;
+          slot_live_[slot] = true;
+          live_slots_[offset] = slot;
+          Ref();
+          return arena_ + offset;
+        }
+      }
+    }
+  }
+  return base_->AllocateRaw(alignment, num_bytes, allocation_attr);
+}
+
+void PlannedAllocator::DeallocateRaw(void* ptr) {
+  char* p = static_cast<char*>(ptr);
+  if (arena_ == nullptr || p < arena_ || p >= arena_ + arena_bytes_) {
+    base_->DeallocateRaw(ptr);
+    return;
+  }
+  {
+    mutex_lock l(mu_);
+    auto it = live_slots_.find(p - arena_);
+    CHECK(it != live_slots_.end());
+    slot_live_[it->second] = false;
+    live_slots_.erase(it);
+  }
+  // Releases the reference of the tensor, which may delete the allocator.
+  Unref();
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,116 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_MEMORY_PLANNER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_MEMORY_PLANNER_H_
+
+#include <functional>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/gtl/flatmap.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// A static assignment of the buffers a step allocates to offsets in a single
+// arena, in the spirit of the heap simulator of XLA. Buffers whose lifetimes
+// overlap get disjoint bytes, the others may share them.
+struct MemoryPlan {
+  struct Slot {
+    int64 offset;
+    int64 size;
+  };
+  std::vector<Slot> slots;
+
+  // The slots sharing bytes with each slot.
+  std::vector<std::vector<int>> overlaps;
+
+  // The slots of each buffer size, in the order their buffers are allocated.
+  gtl::FlatMap<int64, std::vector<int>> slots_by_size;
+
+  int64 arena_bytes = 0;
+};
+
+// A buffer to plan, live from the time its producer runs, "start", to the
+// time its last consumer runs, "end".
+struct MemoryPlanBuffer {
+  int64 size;
+  int64 start;
+  int64 end;
+};
+
+// Packs "buffers" into "plan" greedily, largest buffer first, at the lowest
+// offset that fits best between the buffers with overlapping lifetimes.
+// Slot i of the plan holds buffers[i].
+void PlanMemory(const std::vector<MemoryPlanBuffer>& buffers,
+                MemoryPlan* plan);
+
+// Plans the outputs of the nodes of "graph" in topological order. Only the
+// outputs for which "plannable" returns true and whose shape and type are
+// statically known are planned. Returns an error if the shapes of the graph
+// cannot be inferred.
+Status PlanGraphMemory(const Graph& graph,
+                       const std::function<bool(const Node*, int)>& plannable,
+                       MemoryPlan* plan);
+
+// Serves the allocations of a step from the arena of a MemoryPlan, which it
+// allocates once from "base". An allocation gets the next slot of its size
+// in the plan, provided no slot sharing its bytes is in use; every other
+// allocation is forwarded to "base". The plan is therefore only a hint: the
+// steps are free to run their nodes in a different order, to run them in
+// parallel and to keep tensors alive longer than planned.
+//
+// The allocator is reference counted. The step holds one reference and each
+// tensor in the arena another one, so that the arena outlives the tensors
+// which escape the step. Only the allocations depend on the plan, which may
+// be deleted once the step is done.
+class PlannedAllocator : public Allocator, public core::RefCounted {
+ public:
+  PlannedAllocator(const MemoryPlan* plan, Allocator* base);
+
+  string Name() override { return strings::StrCat("planned_", base_->Name()); }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override;
+  void* AllocateRaw(size_t alignment, size_t num_bytes,
+                    const AllocationAttributes& allocation_attr) override;
+  void DeallocateRaw(void* ptr) override;
+
+ private:
+  ~PlannedAllocator() override;
+
+  const MemoryPlan* const plan_;
+  Allocator* const base_;
+  const int64 arena_bytes_;
+  char* arena_ = nullptr;
+
+  mutex mu_;
+  // The slot in use at each offset of the arena.
+  gtl::FlatMap<int64, int> live_slots_ GUARDED_BY(mu_);
+  std::vector<bool> slot_live_ GUARDED_BY(mu_);
+  // The index of the next slot of each size in plan_->slots_by_size.
+  gtl::FlatMap<int64, size_t> next_slot_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(PlannedAllocator);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_MEMORY_PLANNER_H_
@@ -0,0 +1,105 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/memory_planner.h"
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Three buffers of the same size, each live together with the next one.
+void PlanChain(MemoryPlan* plan) {
+  PlanMemory({{100, 0, 1}, {100, 1, 2}, {100, 2, 3}}, plan);
+}
+
+TEST(MemoryPlannerTest, ReusesMemoryOfDeadBuffers) {
+  MemoryPlan plan;
+  PlanChain(&plan);
+  ASSERT_EQ(3, plan.slots.size());
+  EXPECT_EQ(0, plan.slots[0].offset);
+  EXPECT_EQ(128, plan.slots[1].offset);
+  EXPECT_EQ(0, plan.slots[2].offset);
+  EXPECT_EQ(256, plan.arena_bytes);
+  EXPECT_EQ(std::vector<int>({2}), plan.overlaps[0]);
+  EXPECT_TRUE(plan.overlaps[1].empty());
+  EXPECT_EQ(std::vector<int>({0}), plan.overlaps[2]);
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), plan.slots_by_size[100]);
+}
+
+TEST(MemoryPlannerTest, BestFit) {
+  MemoryPlan plan;
+  // The buffers dying at time 0 leave a gap of 256 bytes and one of 128
+  // bytes, the last buffer goes in the smaller one.
+  PlanMemory({{256, 0, 1},
+              {256, 0, 0},
+              {256, 0, 1},
+              {128, 0, 0},
+              {128, 0, 1},
+              {100, 1, 1}},
+             &plan);
+  EXPECT_EQ(0, plan.slots[0].offset);
+  EXPECT_EQ(256, plan.slots[1].offset);
+  EXPECT_EQ(512, plan.slots[2].offset);
+  EXPECT_EQ(768, plan.slots[3].offset);
+  EXPECT_EQ(896, plan.slots[4].offset);
+  EXPECT_EQ(768, plan.slots[5].offset);
+  EXPECT_EQ(1024, plan.arena_bytes);
+}
+
+TEST(PlannedAllocatorTest, FollowsPlan) {
+  MemoryPlan plan;
+  PlanChain(&plan);
+  PlannedAllocator* a = new PlannedAllocator(&plan, cpu_allocator());
+  char* p0 = static_cast<char*>(a->AllocateRaw(64, 100));
+  char* p1 = static_cast<char*>(a->AllocateRaw(64, 100));
+  EXPECT_EQ(p0 + 128, p1);
+  a->DeallocateRaw(p0);
+  char* p2 = static_cast<char*>(a->AllocateRaw(64, 100));
+  EXPECT_EQ(p0, p2);
+
+  // Sizes which are not planned go to the base allocator.
+  char* other = static_cast<char*>(a->AllocateRaw(64, 200));
+  EXPECT_TRUE(other < p0 || other >= p0 + plan.arena_bytes);
+  a->DeallocateRaw(other);
+
+  // The arena outlives the reference of the step.
+  a->Unref();
+  a->DeallocateRaw(p1);
+  a->DeallocateRaw(p2);
+}
+
+TEST(PlannedAllocatorTest, FallsBackOnConflicts) {
+  MemoryPlan plan;
+  PlanChain(&plan);
+  PlannedAllocator* a = new PlannedAllocator(&plan, cpu_allocator());
+  char* p0 = static_cast<char*>(a->AllocateRaw(64, 100));
+  char* p1 = static_cast<char*>(a->AllocateRaw(64, 100));
+  // The third slot shares the bytes of the first one, still in use.
+  char* p2 = static_cast<char*>(a->AllocateRaw(64, 100));
+  EXPECT_TRUE(p2 < p0 || p2 >= p0 + plan.arena_bytes);
+  // The plan has no slot left for this step.
+  a->DeallocateRaw(p0);
+  char* p3 = static_cast<char*>(a->AllocateRaw(64, 100));
+  EXPECT_TRUE(p3 < p0 || p3 >= p0 + plan.arena_bytes);
+  a->DeallocateRaw(p1);
+  a->DeallocateRaw(p2);
+  a->DeallocateRaw(p3);
+  a->Unref();
+}
+
+}  // namespace
+}  // namespace tensorflow
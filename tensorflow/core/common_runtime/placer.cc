@@ -15,8 +15,10 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/placer.h"
 
+#include <algorithm>
 #include <memory>
 #include <set>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -30,6 +32,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 
 namespace tensorflow {
 
@@ -40,6 +43,40 @@ namespace {
 const StringPiece kColocationAttrNameStringPiece(kColocationAttrName);
 const StringPiece kColocationGroupPrefixStringPiece(kColocationGroupPrefix);
 
+// Returns a key identifying the device types supporting `def`. Kernel
+// registrations are looked up by op and "_kernel" label, and their
+// constraints can only refer to type or list(type) attrs, so nodes with the
+// same key are supported by the same device types.
+string SupportedDeviceTypesKey(const NodeDef& def) {
+  std::vector<std::pair<StringPiece, const AttrValue*>> type_attrs;
+  for (const auto& attr : def.attr()) {
+    if (attr.second.value_case() == AttrValue::kType ||
+        attr.second.value_case() == AttrValue::kList) {
+      type_attrs.emplace_back(attr.first, &attr.second);
+    }
+  }
+  std::sort(type_attrs.begin(), type_attrs.end());
+  string key =
+      strings::StrCat(def.op(), ";", GetNodeAttrString(def, "_kernel"));
+  for (const auto& attr : type_attrs) {
+    strings::StrAppend(&key, ";", attr.first, "=");
+    if (attr.second->value_case() == AttrValue::kType) {
+      strings::StrAppend(&key, attr.second->type());
+    } else {
+      // Other kinds of lists, which cannot match a constraint, are told
+      // apart from type lists by their size.
+      const AttrValue::ListValue& list = attr.second->list();
+      strings::StrAppend(&key, "[", list.type_size(), ":");
+      for (int type : list.type()) strings::StrAppend(&key, type, ",");
+      strings::StrAppend(&key, list.s_size() + list.i_size() + list.f_size() +
+                                   list.b_size() + list.shape_size() +
+                                   list.tensor_size() + list.func_size(),
+                         "]");
+    }
+  }
+  return key;
+}
+
 // Returns a list of devices sorted by preferred type and then name
 // from 'devices' whose type is in 'supported_device_types'.  This
 // function searches the device types in 'supported_device_types' and
@@ -510,8 +547,19 @@ class ColocationGraph {
     const int id = node.id();
     DCHECK_GE(id, 0);
     member->parent = id;
-    TF_RETURN_IF_ERROR(SupportedDeviceTypesForNode(
-        device_types_, node.def(), &member->supported_device_types));
+    // Many nodes share the same op and types, so the kernel registrations
+    // supporting them are looked up once. Errors are not cached since they
+    // describe the node.
+    const string key = SupportedDeviceTypesKey(node.def());
+    auto it = supported_device_types_cache_.find(key);
+    if (it != supported_device_types_cache_.end()) {
+      member->supported_device_types = it->second;
+    } else {
+      TF_RETURN_IF_ERROR(SupportedDeviceTypesForNode(
+          device_types_, node.def(), &member->supported_device_types));
+      supported_device_types_cache_.emplace(key,
+                                            member->supported_device_types);
+    }
 
     if (node.has_assigned_device_name()) {
       // This node has already been assigned to a device, so we
@@ -633,6 +681,8 @@ class ColocationGraph {
   const DeviceSet* device_set_;  // Not owned.
   const std::vector<DeviceType> device_types_;
   const bool allow_soft_placement_;
+  // The device types supporting the nodes, by SupportedDeviceTypesKey().
+  std::unordered_map<string, DeviceTypeVector> supported_device_types_cache_;
 };
 
 // Returns true if the node has no inputs and produces outputs
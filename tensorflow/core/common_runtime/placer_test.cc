@@ -161,6 +161,12 @@ REGISTER_OP("TestDeviceEnforce").Input("a: Ref(float)").Output("b: float");
 REGISTER_KERNEL_BUILDER(Name("TestDeviceEnforce").Device("FakeCPU"), DummyOp);
 REGISTER_KERNEL_BUILDER(Name("TestDeviceEnforce").Device("FakeGPU"), DummyOp);
 
+REGISTER_OP("TestTypedOutput").Output("a: T").Attr("T: {float, int32}");
+REGISTER_KERNEL_BUILDER(Name("TestTypedOutput").Device("FakeCPU"), DummyOp);
+REGISTER_KERNEL_BUILDER(
+    Name("TestTypedOutput").Device("FakeGPU").TypeConstraint<float>("T"),
+    DummyOp);
+
 REGISTER_KERNEL_BUILDER(Name("Shape").Device("FakeCPU"), DummyOp);
 REGISTER_KERNEL_BUILDER(Name("Shape").Device("FakeGPU"), DummyOp);
 
@@ -1191,6 +1197,30 @@ TEST_F(PlacerTest, TestDeviceTypeConstraintsAllowSoftPlacement) {
   EXPECT_COLOCATED(g, "var_cpu", "force_cpu");
 }
 
+// Test that nodes of the same op are placed by the kernels registered for
+// their own types.
+TEST_F(PlacerTest, TestKernelTypeConstraints) {
+  Graph g(OpRegistry::Global());
+  {  // Scope for temporary variables used to construct g.
+    GraphDefBuilder b(GraphDefBuilder::kFailImmediately);
+    ops::SourceOp("TestTypedOutput",
+                  b.opts().WithName("float_1").WithAttr("T", DT_FLOAT));
+    ops::SourceOp("TestTypedOutput",
+                  b.opts().WithName("int32_1").WithAttr("T", DT_INT32));
+    ops::SourceOp("TestTypedOutput",
+                  b.opts().WithName("float_2").WithAttr("T", DT_FLOAT));
+    ops::SourceOp("TestTypedOutput",
+                  b.opts().WithName("int32_2").WithAttr("T", DT_INT32));
+    TF_EXPECT_OK(BuildGraph(b, &g));
+  }
+
+  TF_EXPECT_OK(Place(&g));
+  EXPECT_DEVICE_TYPE(g, "float_1", "FakeGPU");
+  EXPECT_DEVICE_TYPE(g, "float_2", "FakeGPU");
+  EXPECT_DEVICE_TYPE(g, "int32_1", "FakeCPU");
+  EXPECT_DEVICE_TYPE(g, "int32_2", "FakeCPU");
+}
+
 // Test that placement fails when two nodes have a reference connection
 // constraint, and each node requires a mutually incompatible device.
 TEST_F(PlacerTest, TestUnsatisfiableConstraintWithReferenceConnections) {
@@ -23,9 +23,11 @@ limitations under the License.
 #include <string.h>
 
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/byte_order.h"
 #include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/platform/types.h"
 
@@ -83,6 +85,24 @@ thread::ThreadPool* NewThreadPoolFromSessionOptions(
   return new thread::ThreadPool(options.env, "Compute", num_threads);
 }
 
+thread::ThreadPool* NewThreadPoolFromSessionOptions(
+    const SessionOptions& options, int numa_node) {
+  if (numa_node == port::kNUMANoAffinity) {
+    return NewThreadPoolFromSessionOptions(options);
+  }
+  const int num_nodes = port::NUMANumNodes();
+  const int32 num_threads =
+      (NumInterOpThreadsFromSessionOptions(options) + num_nodes - 1) /
+      num_nodes;
+  VLOG(1) << "Direct session inter op parallelism threads for NUMA node "
+          << numa_node << ": " << num_threads;
+  ThreadOptions thread_opts;
+  thread_opts.numa_node = numa_node;
+  return new thread::ThreadPool(options.env, thread_opts,
+                                strings::StrCat("numa_", numa_node, "_Compute"),
+                                num_threads);
+}
+
 void SchedClosure(std::function<void()> closure) {
   if (!tracing::EventCollector::IsEnabled()) {
     return Env::Default()->SchedClosure(std::move(closure));
@@ -37,6 +37,11 @@ int32 NumInterOpThreadsFromSessionOptions(const SessionOptions& options);
 thread::ThreadPool* NewThreadPoolFromSessionOptions(
     const SessionOptions& options);
 
+// Creates a thread pool with the share of the inter op threads of NUMA node
+// "numa_node", whose threads are pinned to the node.
+thread::ThreadPool* NewThreadPoolFromSessionOptions(
+    const SessionOptions& options, int numa_node);
+
 // Schedule "closure" in the default thread queue.
 void SchedClosure(std::function<void()> closure);
 
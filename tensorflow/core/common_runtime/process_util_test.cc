@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/common_runtime/process_util.h"
 
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/test.h"
 
 namespace tensorflow {
@@ -34,5 +35,15 @@ TEST(ProcessUtilTest, ThreadPool) {
   delete pool;
 }
 
+TEST(ProcessUtilTest, NUMAThreadPool) {
+  SessionOptions opts;
+  opts.config.set_inter_op_parallelism_threads(10);
+
+  thread::ThreadPool* pool = NewThreadPoolFromSessionOptions(opts, 0);
+  const int num_nodes = port::NUMANumNodes();
+  EXPECT_EQ((10 + num_nodes - 1) / num_nodes, pool->NumThreads());
+  delete pool;
+}
+
 }  // anonymous namespace
 }  // namespace tensorflow
@@ -97,10 +97,18 @@ RingReducer::~RingReducer() { group_size_tensor_ready_.WaitForNotification(); }
 string RingReducer::TensorDebugString(Tensor tensor) {
   const DeviceBase::GpuDeviceInfo* gpu_device_info =
       ctx_->device()->tensorflow_gpu_device_info();
-  if (gpu_device_info) {
+  DeviceContext* dev_ctx =
+      gpu_device_info ? gpu_device_info->default_context : nullptr;
+#ifdef TENSORFLOW_USE_SYCL
+  // SYCL device memory is not addressable from the host either.
+  if (col_params_.group.device_type == DEVICE_SYCL) {
+    dev_ctx = ctx_->op_device_context();
+  }
+#endif  // TENSORFLOW_USE_SYCL
+  if (dev_ctx) {
     Tensor cpu_tensor(tensor.dtype(), tensor.shape());
     Notification note;
-    gpu_device_info->default_context->CopyDeviceTensorToCPU(
+    dev_ctx->CopyDeviceTensorToCPU(
         &tensor, "" /*tensor_name*/, device_, &cpu_tensor,
         [&note](const Status& s) {
           CHECK(s.ok());
@@ -245,37 +253,6 @@ void RingReducer::Finish(bool ok) {
   done_(s);
 }
 
-RingReducer::SubContext::SubContext(OpKernelContext* ctx,
-                                    OpKernelContext::Params* params,
-                                    OpKernel* op, Tensor* output, Tensor* input)
-    : sub_params_(*params),
-      sub_inputs_({output, input}),
-      sub_input_attr_({ctx->input_alloc_attr(0), ctx->input_alloc_attr(0)}),
-      sub_input_dc_(
-          {ctx->input_device_context(0), ctx->input_device_context(0)}) {
-  sub_params_.op_kernel = op;
-  sub_params_.inputs = &sub_inputs_;
-  sub_params_.input_alloc_attrs = &sub_input_attr_;
-  sub_params_.input_device_contexts = &sub_input_dc_;
-  sub_params_.eigen_gpu_device = nullptr;
-  sub_params_.ensure_eigen_gpu_device();
-  sub_params_.forward_from_array = &forward_from_;
-  sub_ctx_ = new OpKernelContext(&sub_params_, 1);
-}
-
-Status RingReducer::ComputeBinOp(Device* device, OpKernel* op, Tensor* output,
-                                 Tensor* input) {
-  // Prepare an OpKernelContext that is identical to that of the original Op
-  // (i.e. the collective), except for the input output sizes and identities and
-  // the Op itself.
-  // TODO(tucker): Is it possible to cache and reuse these objects?  They're
-  // mostly identical inside one device execution.
-  std::unique_ptr<SubContext> sub_ctx(
-      new SubContext(ctx_, op_params_, op, output, input));
-  device->Compute(op, sub_ctx->sub_ctx_);
-  return sub_ctx->sub_ctx_->status();
-}
-
 // At the beginning of the algorithm initialize a RingField struct for
 // every independent field of the tensor.
 void RingReducer::InitRingField(RingField* rf, int chunk_idx, int subdiv_idx,
@@ -463,8 +440,9 @@ bool RingReducer::RunAsyncParts() {
           --recv_pending_count;
           if (!rf->second_pass) {
             rf->action = RF_REDUCE;
-            Status s = ComputeBinOp(device_, col_params_.merge_op.get(),
-                                    &rf->chunk, &rf->tmp_chunk);
+            Status s = ComputeBinOp(ctx_, op_params_, device_,
+                                    col_params_.merge_op.get(), &rf->chunk,
+                                    &rf->tmp_chunk);
             if (!s.ok()) {
               aborted = true;
               StartAbort(s);
@@ -477,8 +455,9 @@ bool RingReducer::RunAsyncParts() {
           if (!rf->second_pass && col_params_.final_op.get() && rf->is_final) {
             rf->action = RF_FINALIZE;
             group_size_tensor_ready_.WaitForNotification();
-            Status s = ComputeBinOp(device_, col_params_.final_op.get(),
-                                    &rf->chunk, &group_size_tensor_);
+            Status s = ComputeBinOp(ctx_, op_params_, device_,
+                                    col_params_.final_op.get(), &rf->chunk,
+                                    &group_size_tensor_);
             if (!s.ok()) {
               aborted = true;
               StartAbort(s);
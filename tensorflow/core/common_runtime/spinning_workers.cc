@@ -0,0 +1,121 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/spinning_workers.h"
+
+namespace tensorflow {
+
+SpinningWorkers::SpinningWorkers(thread::ThreadPool* pool, int num_workers,
+                                 int64 spin_duration_us)
+    : pool_(pool),
+      num_workers_(num_workers),
+      spin_duration_us_(spin_duration_us) {
+  {
+    mutex_lock l(mu_);
+    num_running_ = num_workers_;
+  }
+  for (int i = 0; i < num_workers_; ++i) {
+    pool_->Schedule([this]() { WorkerLoop(); });
+  }
+}
+
+SpinningWorkers::~SpinningWorkers() { Stop(); }
+
+void SpinningWorkers::Schedule(std::function<void()> fn) {
+  {
+    mutex_lock l(mu_);
+    if (!stopped_ && queue_.size() < num_free_) {
+      queue_.push_back(std::move(fn));
+      num_queued_.fetch_add(1, std::memory_order_release);
+      // Wakes up a parked worker only if the spinning ones are all taken.
+      if (queue_.size() > num_free_ - num_parked_) {
+        work_cv_.notify_one();
+      }
+      return;
+    }
+  }
+  pool_->Schedule(std::move(fn));
+}
+
+void SpinningWorkers::Stop() {
+  mutex_lock l(mu_);
+  stopped_ = true;
+  stopping_.store(true, std::memory_order_relaxed);
+  work_cv_.notify_all();
+  while (num_running_ > 0) {
+    stopped_cv_.wait(l);
+  }
+}
+
+bool SpinningWorkers::SpinForWork(Env* env) {
+  const uint64 spin_end = spin_duration_us_ > 0
+                              ? env->NowMicros() + spin_duration_us_
+                              : kuint64max;
+  for (int i = 1;; ++i) {
+    if (num_queued_.load(std::memory_order_acquire) > 0 ||
+        stopping_.load(std::memory_order_relaxed)) {
+      return true;
+    }
+    // Reading the clock costs more than checking the queue.
+    if (i % 1024 == 0 && env->NowMicros() >= spin_end) {
+      return false;
+    }
+  }
+}
+
+void SpinningWorkers::WorkerLoop() {
+  Env* const env = Env::Default();
+  bool free = false;
+  bool spin_expired = false;
+  while (true) {
+    std::function<void()> fn;
+    {
+      mutex_lock l(mu_);
+      if (!free) {
+        ++num_free_;
+        free = true;
+      }
+      if (queue_.empty()) {
+        if (stopped_) {
+          break;
+        }
+        if (spin_expired) {
+          ++num_parked_;
+          work_cv_.wait(l);
+          --num_parked_;
+        }
+      } else {
+        fn = std::move(queue_.front());
+        queue_.pop_front();
+        num_queued_.fetch_sub(1, std::memory_order_relaxed);
+        --num_free_;
+        free = false;
+      }
+    }
+    if (fn) {
+      fn();
+      spin_expired = false;
+    } else {
+      spin_expired = !SpinForWork(env);
+    }
+  }
+  mutex_lock l(mu_);
+  --num_free_;
+  if (--num_running_ == 0) {
+    stopped_cv_.notify_all();
+  }
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,85 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_SPINNING_WORKERS_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_SPINNING_WORKERS_H_
+
+#include <atomic>
+#include <deque>
+#include <functional>
+
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Runs the closures of a step on workers borrowed from "pool", which spin
+// waiting for them instead of parking, so that scheduling a closure does not
+// have to wake up a thread. A worker which finds no closure for
+// "spin_duration_us" parks until the next one, or spins until Stop() if
+// "spin_duration_us" is 0.
+//
+// A closure goes to the pool itself when no worker is free to run it, so
+// that closures blocking their worker cannot starve the step.
+class SpinningWorkers {
+ public:
+  SpinningWorkers(thread::ThreadPool* pool, int num_workers,
+                  int64 spin_duration_us);
+
+  // Calls Stop().
+  ~SpinningWorkers();
+
+  void Schedule(std::function<void()> fn);
+
+  // Returns the workers to the pool once they ran the closures already
+  // scheduled. The later closures go to the pool.
+  void Stop();
+
+ private:
+  void WorkerLoop();
+
+  // Spins until a closure is queued or Stop() is called, returns false if
+  // that took longer than spin_duration_us_.
+  bool SpinForWork(Env* env);
+
+  thread::ThreadPool* const pool_;
+  const int num_workers_;
+  const int64 spin_duration_us_;
+
+  // The size of queue_ and stopped_, read by the spinning workers without
+  // locking mu_.
+  std::atomic<int> num_queued_{0};
+  std::atomic<bool> stopping_{false};
+
+  mutex mu_;
+  condition_variable work_cv_;
+  condition_variable stopped_cv_;
+  std::deque<std::function<void()>> queue_ GUARDED_BY(mu_);
+  // The workers running and not busy with a closure.
+  int num_free_ GUARDED_BY(mu_) = 0;
+  int num_parked_ GUARDED_BY(mu_) = 0;
+  int num_running_ GUARDED_BY(mu_) = 0;
+  bool stopped_ GUARDED_BY(mu_) = false;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(SpinningWorkers);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_SPINNING_WORKERS_H_
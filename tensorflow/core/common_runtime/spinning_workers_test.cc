@@ -0,0 +1,81 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/spinning_workers.h"
+
+#include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+void RunClosures(int64 spin_duration_us) {
+  thread::ThreadPool pool(Env::Default(), "test", 4);
+  SpinningWorkers workers(&pool, 2, spin_duration_us);
+  std::atomic<int> count(0);
+  BlockingCounter counter(1000);
+  for (int i = 0; i < 1000; ++i) {
+    workers.Schedule([&count, &counter]() {
+      ++count;
+      counter.DecrementCount();
+    });
+    if (i % 100 == 0) {
+      // Lets the workers park, if they spin for a while only.
+      Env::Default()->SleepForMicroseconds(1000);
+    }
+  }
+  counter.Wait();
+  workers.Stop();
+  EXPECT_EQ(1000, count);
+}
+
+TEST(SpinningWorkersTest, SpinsForTheWholeStep) { RunClosures(0); }
+
+TEST(SpinningWorkersTest, SpinsThenParks) { RunClosures(10); }
+
+TEST(SpinningWorkersTest, BlockedWorkersFallBackToPool) {
+  thread::ThreadPool pool(Env::Default(), "test", 4);
+  SpinningWorkers workers(&pool, 2, 0);
+  Notification unblock;
+  BlockingCounter blocked(2);
+  // Both workers, if they started, end up blocked and the last closure can
+  // only run on the pool.
+  for (int i = 0; i < 2; ++i) {
+    workers.Schedule([&unblock, &blocked]() {
+      blocked.DecrementCount();
+      unblock.WaitForNotification();
+    });
+  }
+  blocked.Wait();
+  Notification done;
+  workers.Schedule([&done]() { done.Notify(); });
+  done.WaitForNotification();
+  unblock.Notify();
+  workers.Stop();
+}
+
+TEST(SpinningWorkersTest, ScheduleAfterStop) {
+  thread::ThreadPool pool(Env::Default(), "test", 2);
+  SpinningWorkers workers(&pool, 2, 0);
+  workers.Stop();
+  Notification done;
+  workers.Schedule([&done]() { done.Notify(); });
+  done.WaitForNotification();
+}
+
+}  // namespace
+}  // namespace tensorflow
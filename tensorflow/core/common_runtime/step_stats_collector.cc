@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/common_runtime/costmodel_manager.h"
 #include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/tensor_description.pb.h"
 #include "tensorflow/core/framework/tracking_allocator.h"
 #include "tensorflow/core/graph/costmodel.h"
@@ -280,6 +281,32 @@ void StepStatsCollector::Save(const string& device,
   }
 }
 
+void StepStatsCollector::SaveAllocatorFragmentation(const string& device,
+                                                    Allocator* allocator) {
+  AllocatorFragmentation fragmentation;
+  if (!allocator->GetFragmentation(&fragmentation)) {
+    return;
+  }
+  AllocatorStats stats;
+  allocator->GetStats(&stats);
+  mutex_lock l(mu_);
+  if (!step_stats_ || finalized_) {
+    return;
+  }
+  AllocatorFragmentationStats& f =
+      allocator_fragmentation_[std::make_pair(device, allocator->Name())];
+  f.set_allocator_name(allocator->Name());
+  f.set_num_regions(fragmentation.num_regions);
+  f.set_region_bytes(fragmentation.region_bytes);
+  f.set_bytes_in_use(stats.bytes_in_use);
+  f.set_free_bytes(fragmentation.free_bytes);
+  f.set_largest_free_block_bytes(fragmentation.largest_free_block_bytes);
+  f.clear_free_bytes_per_bin();
+  for (int64 bytes : fragmentation.free_bytes_per_bin) {
+    f.add_free_bytes_per_bin(bytes);
+  }
+}
+
 string StepStatsCollector::ReportAllocsOnResourceExhausted(const string& err) {
   mutex_lock l(mu_);
   if (err.find("OOM") == err.npos) {
@@ -393,5 +420,16 @@ void StepStatsCollector::FinalizeInternal() {
       stats->stats()->Swap(dss->add_node_stats());
     }
   }
+  for (auto& fragmentation : allocator_fragmentation_) {
+    const string& device = fragmentation.first.first;
+    if (dev_stats_pb.find(device) == dev_stats_pb.end()) {
+      DeviceStepStats* ndev_stat = step_stats_->add_dev_stats();
+      ndev_stat->set_device(device);
+      dev_stats_pb[device] = ndev_stat;
+    }
+    fragmentation.second.Swap(
+        dev_stats_pb.at(device)->add_allocator_fragmentation());
+  }
+  allocator_fragmentation_.clear();
 }
 }  // namespace tensorflow
@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_STEP_STATS_COLLECTOR_H_
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_STEP_STATS_COLLECTOR_H_
 
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -82,6 +83,10 @@ class StepStatsCollector {
   void Save(const string& device, NodeExecStats* nt);
   void Save(const string& device, NodeExecStatsWrapper* stats);
 
+  // Records the fragmentation of allocator, used by device, if it tracks it.
+  // A later call for the same device and allocator replaces the snapshot.
+  void SaveAllocatorFragmentation(const string& device, Allocator* allocator);
+
   // Generates a string reporting the currently used memory based
   // on ResourceExhausted OOM `err` message.
   // `err` message needs to contain device name and allocator name, E.g.:
@@ -106,6 +111,9 @@ class StepStatsCollector {
   mutex mu_;
   bool finalized_ GUARDED_BY(mu_);
   std::unordered_map<string, NodeExecStatsVec> dev_stats_ GUARDED_BY(mu_);
+  // Keyed by device and allocator name.
+  std::map<std::pair<string, string>, AllocatorFragmentationStats>
+      allocator_fragmentation_ GUARDED_BY(mu_);
   StepStats* step_stats_ GUARDED_BY(mu_);
   uint64 collectedNodes GUARDED_BY(mu_) = 0;
 };
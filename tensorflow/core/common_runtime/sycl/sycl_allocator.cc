@@ -21,7 +21,11 @@ namespace tensorflow {
 
 SYCLAllocator::SYCLAllocator(Eigen::QueueInterface* queue)
     : sycl_device_(new Eigen::SyclDevice(queue)) {
-  stats_.bytes_limit = sycl_device_->max_buffer_size();
+  // Every allocation is its own SYCL buffer, so only a single allocation is
+  // limited by max_buffer_size(). The total is bounded by the global memory.
+  stats_.bytes_limit = sycl_device_->sycl_queue()
+                           .get_device()
+                           .get_info<cl::sycl::info::device::global_mem_size>();
 }
 
 SYCLAllocator::~SYCLAllocator() {
@@ -44,6 +48,7 @@ void* SYCLAllocator::AllocateRaw(size_t alignment, size_t num_bytes) {
   const std::size_t bytes_allocated = allocated_buffer.get_range().size();
 
   ++stats_.num_allocs;
+  ++num_buffers_;
   stats_.bytes_in_use += bytes_allocated;
   stats_.max_bytes_in_use =
       std::max<int64>(stats_.max_bytes_in_use, stats_.bytes_in_use);
@@ -59,6 +64,7 @@ void SYCLAllocator::DeallocateRaw(void* ptr) {
     const auto& buffer_to_delete = sycl_device_->get_sycl_buffer(ptr);
     const std::size_t dealloc_size = buffer_to_delete.get_range().size();
     stats_.bytes_in_use -= dealloc_size;
+    --num_buffers_;
     sycl_device_->deallocate(ptr);
   }
 }
@@ -68,6 +74,16 @@ void SYCLAllocator::GetStats(AllocatorStats* stats) {
   *stats = stats_;
 }
 
+bool SYCLAllocator::GetFragmentation(AllocatorFragmentation* fragmentation) {
+  mutex_lock lock(mu_);
+  fragmentation->num_regions = num_buffers_;
+  fragmentation->region_bytes = stats_.bytes_in_use;
+  fragmentation->free_bytes = 0;
+  fragmentation->largest_free_block_bytes = 0;
+  fragmentation->free_bytes_per_bin.clear();
+  return true;
+}
+
 void SYCLAllocator::ClearStats() {
   mutex_lock l(mu_);
   stats_.num_allocs = 0;
@@ -45,6 +45,8 @@ class SYCLAllocator : public Allocator {
   bool Ok() { return sycl_device_ && sycl_device_->ok(); }
   void GetStats(AllocatorStats* stats) override;
   void ClearStats() override;
+  // Every allocation is a SYCL buffer of its own, so no free memory is held.
+  bool GetFragmentation(AllocatorFragmentation* fragmentation) override;
 
   // The SYCL buffers keep track of their size, so we already have tracking.
   bool TracksAllocationSizes() override { return true; }
@@ -66,6 +68,7 @@ class SYCLAllocator : public Allocator {
   mutable mutex mu_;
   Eigen::SyclDevice* sycl_device_ GUARDED_BY(mu_);  // owned
   AllocatorStats stats_ GUARDED_BY(mu_);
+  int64 num_buffers_ GUARDED_BY(mu_) = 0;
 
   TF_DISALLOW_COPY_AND_ASSIGN(SYCLAllocator);
 };
@@ -0,0 +1,57 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifdef TENSORFLOW_USE_SYCL
+
+#include "tensorflow/core/common_runtime/sycl/sycl_bfc_allocator.h"
+
+namespace tensorflow {
+
+void* SYCLMemAllocator::Alloc(size_t alignment, size_t num_bytes) {
+  if (num_bytes == 0) {
+    return nullptr;
+  }
+  Eigen::SyclDevice* sycl_device = sycl_allocator_->getSyclDevice();
+  // A single SYCL buffer cannot exceed the device's maximum allocation size.
+  // Returning nullptr lets the BFCAllocator back off to a smaller region.
+  if (sycl_device == nullptr || num_bytes > sycl_device->max_buffer_size()) {
+    return nullptr;
+  }
+  return sycl_allocator_->AllocateRaw(alignment, num_bytes);
+}
+
+void SYCLMemAllocator::Free(void* ptr, size_t num_bytes) {
+  if (ptr != nullptr) {
+    sycl_allocator_->DeallocateRaw(ptr);
+  }
+}
+
+SYCLBFCAllocator::SYCLBFCAllocator(SYCLAllocator* sycl_allocator,
+                                   size_t total_memory,
+                                   const GPUOptions& gpu_options,
+                                   const string& name)
+    : BFCAllocator(new SYCLMemAllocator(sycl_allocator), total_memory,
+                   gpu_options.allow_growth(), name) {
+  if (gpu_options.experimental().bfc_allocator_chunk_caches()) {
+    EnableChunkCaches();
+  }
+  if (gpu_options.experimental().bfc_allocator_compaction()) {
+    EnableCompaction();
+  }
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_USE_SYCL
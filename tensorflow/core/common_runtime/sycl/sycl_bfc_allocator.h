@@ -0,0 +1,71 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_USE_SYCL
+#error This file must only be included when building TensorFlow with SYCL support
+#endif
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_BFC_ALLOCATOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_BFC_ALLOCATOR_H_
+
+#include <string>
+
+#include "tensorflow/core/common_runtime/bfc_allocator.h"
+#include "tensorflow/core/common_runtime/sycl/sycl_allocator.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+
+namespace tensorflow {
+
+// Suballocator for SYCL memory. Each region handed to the BFCAllocator is a
+// single SYCL buffer created through the underlying SYCLAllocator, so the
+// pointers carved out of it by the BFCAllocator are offsets into that buffer
+// as tracked by Eigen's PointerMapper.
+class SYCLMemAllocator : public SubAllocator {
+ public:
+  // Note: sycl_allocator cannot be null and is not owned.
+  explicit SYCLMemAllocator(SYCLAllocator* sycl_allocator)
+      : sycl_allocator_(sycl_allocator) {
+    CHECK(sycl_allocator_ != nullptr);
+  }
+  ~SYCLMemAllocator() override {}
+
+  void* Alloc(size_t alignment, size_t num_bytes) override;
+  void Free(void* ptr, size_t num_bytes) override;
+
+ private:
+  SYCLAllocator* sycl_allocator_;  // not owned, non-null
+
+  TF_DISALLOW_COPY_AND_ASSIGN(SYCLMemAllocator);
+};
+
+// A SYCL memory allocator that implements a 'best-fit with coalescing'
+// algorithm on top of a small number of large SYCL buffers.
+//
+// Tensors allocated from this allocator generally do not start at offset zero
+// of their SYCL buffer, so kernels accessing them must take
+// Eigen::SyclDevice::get_offset into account.
+class SYCLBFCAllocator : public BFCAllocator {
+ public:
+  SYCLBFCAllocator(SYCLAllocator* sycl_allocator, size_t total_memory,
+                   const GPUOptions& gpu_options, const string& name);
+  ~SYCLBFCAllocator() override {}
+
+  TF_DISALLOW_COPY_AND_ASSIGN(SYCLBFCAllocator);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_BFC_ALLOCATOR_H_
@@ -0,0 +1,145 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifdef TENSORFLOW_USE_SYCL
+
+#include "tensorflow/core/common_runtime/sycl/sycl_constant_batcher.h"
+
+#include <cstring>
+
+#include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/hash/hash.h"
+
+namespace tensorflow {
+
+constexpr size_t SYCLConstantBatcher::kBatchBytes;
+constexpr size_t SYCLConstantBatcher::kMaxBatchedBytes;
+
+Status SYCLConstantBatcher::Upload(Device* device, const Tensor& host_tensor,
+                                   Tensor* device_tensor) {
+  DCHECK(DataTypeCanUseMemcpy(host_tensor.dtype()));
+  const size_t bytes = host_tensor.TotalBytes();
+  if (bytes > 0 && bytes <= kMaxBatchedBytes) {
+    mutex_lock lock(mu_);
+    if (AddToBatch(device, host_tensor, device_tensor)) {
+      return Status::OK();
+    }
+  }
+  Tensor copy(device_allocator_, host_tensor.dtype(), host_tensor.shape());
+  // If the tensor is not initialized, we likely ran out of memory.
+  if (!copy.IsInitialized()) {
+    return errors::ResourceExhausted(
+        "OOM when allocating tensor of shape ",
+        host_tensor.shape().DebugString(), " and type ",
+        DataTypeString(host_tensor.dtype()));
+  }
+  if (bytes > 0) {
+    device_context_->CopyCPUTensorToDevice(
+        &host_tensor, device, &copy,
+        [this](const Status& s) { RecordStatus(s); });
+  }
+  *device_tensor = copy;
+  return Status::OK();
+}
+
+bool SYCLConstantBatcher::AddToBatch(Device* device, const Tensor& host_tensor,
+                                     Tensor* device_tensor) {
+  const size_t bytes = host_tensor.TotalBytes();
+  const char* data = static_cast<const char*>(DMAHelper::base(&host_tensor));
+  const uint64 hash = Hash64(data, bytes);
+
+  size_t offset = used_bytes_;
+  bool found = false;
+  if (staging_.IsInitialized()) {
+    const char* staging =
+        static_cast<const char*>(DMAHelper::base(&staging_));
+    auto range = entries_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      const Entry& entry = it->second;
+      if (entry.bytes == bytes &&
+          std::memcmp(staging + entry.offset, data, bytes) == 0) {
+        offset = entry.offset;
+        found = true;
+        break;
+      }
+    }
+  }
+  if (!found) {
+    offset = Allocator::kAllocatorAlignment *
+             ((used_bytes_ + Allocator::kAllocatorAlignment - 1) /
+              Allocator::kAllocatorAlignment);
+    if (!staging_.IsInitialized() || offset + bytes > kBatchBytes) {
+      FlushLocked(device);
+      const TensorShape shape({static_cast<int64>(kBatchBytes)});
+      Tensor staging(host_allocator_, DT_UINT8, shape);
+      Tensor device_batch(device_allocator_, DT_UINT8, shape);
+      if (!staging.IsInitialized() || !device_batch.IsInitialized()) {
+        return false;
+      }
+      staging_ = staging;
+      device_batch_ = device_batch;
+      offset = 0;
+    }
+    std::memcpy(static_cast<char*>(DMAHelper::base(&staging_)) + offset, data,
+                bytes);
+    used_bytes_ = offset + bytes;
+    entries_.emplace(hash, Entry{offset, bytes});
+    has_pending_.store(true, std::memory_order_release);
+  }
+
+  device_tensor->UnsafeCopyFromInternal(
+      device_batch_.Slice(offset, offset + bytes), host_tensor.dtype(),
+      host_tensor.shape());
+  return true;
+}
+
+Status SYCLConstantBatcher::Flush(Device* device) {
+  {
+    mutex_lock lock(mu_);
+    FlushLocked(device);
+  }
+  mutex_lock lock(status_mu_);
+  return status_;
+}
+
+void SYCLConstantBatcher::FlushLocked(Device* device) {
+  if (used_bytes_ > 0) {
+    const int64 used = static_cast<int64>(used_bytes_);
+    const Tensor staging = staging_.Slice(0, used);
+    Tensor device_batch = device_batch_.Slice(0, used);
+    VLOG(2) << "Uploading " << entries_.size() << " SYCL constants in "
+            << used_bytes_ << " bytes";
+    device_context_->CopyCPUTensorToDevice(
+        &staging, device, &device_batch,
+        [this](const Status& s) { RecordStatus(s); });
+  }
+  // The views handed out keep the device buffer alive, and the transfer the
+  // staging buffer.
+  staging_ = Tensor();
+  device_batch_ = Tensor();
+  used_bytes_ = 0;
+  entries_.clear();
+  has_pending_.store(false, std::memory_order_release);
+}
+
+void SYCLConstantBatcher::RecordStatus(const Status& s) {
+  mutex_lock lock(status_mu_);
+  status_.Update(s);
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_USE_SYCL
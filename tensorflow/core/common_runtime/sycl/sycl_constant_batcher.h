@@ -0,0 +1,111 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_USE_SYCL
+#error This file must only be included when building TensorFlow with SYCL support
+#endif
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_CONSTANT_BATCHER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_CONSTANT_BATCHER_H_
+
+#include <atomic>
+#include <unordered_map>
+
+#include "tensorflow/core/common_runtime/sycl/sycl_device_context.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// Uploads the constants of a graph to a SYCL device without waiting for each
+// copy, which would otherwise dominate the creation of large graphs.
+//
+// Small constants are packed into a host staging buffer and handed out as
+// views of a device buffer of the same size. The whole batch is then copied
+// with a single transfer once it is full or Flush is called. Constants with
+// the same content in a batch share their device memory.
+//
+// The copies are not waited for: the SYCL runtime orders them before any
+// kernel later accessing the device buffers. Views of a batch must however
+// not be used before the batch is flushed, so the device flushes the pending
+// batch before running any kernel.
+class SYCLConstantBatcher {
+ public:
+  // Size of the staging and device buffers of a batch.
+  static constexpr size_t kBatchBytes = 1 << 20;
+  // Larger constants get their own device tensor and transfer.
+  static constexpr size_t kMaxBatchedBytes = 64 << 10;
+
+  // host_allocator should return memory that can be copied to the device
+  // without extra staging.
+  SYCLConstantBatcher(Allocator* host_allocator, Allocator* device_allocator,
+                      SYCLDeviceContext* device_context)
+      : host_allocator_(host_allocator),
+        device_allocator_(device_allocator),
+        device_context_(device_context) {}
+
+  // Sets device_tensor to a tensor of device holding the content of
+  // host_tensor, whose type must be memcpy-able. The content is only valid
+  // on the device after the next call to Flush.
+  Status Upload(Device* device, const Tensor& host_tensor,
+                Tensor* device_tensor);
+
+  // Starts the transfer of the pending batch if any. Returns the first error
+  // reported by the transfers started so far.
+  Status Flush(Device* device);
+
+  bool HasPending() const {
+    return has_pending_.load(std::memory_order_acquire);
+  }
+
+ private:
+  // Copies host_tensor into the pending batch, starting a new one if it does
+  // not fit. Returns false if no batch could be allocated.
+  bool AddToBatch(Device* device, const Tensor& host_tensor,
+                  Tensor* device_tensor) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void FlushLocked(Device* device) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void RecordStatus(const Status& s);
+
+  Allocator* const host_allocator_;          // not owned
+  Allocator* const device_allocator_;        // not owned
+  SYCLDeviceContext* const device_context_;  // not owned
+
+  mutex mu_;
+  // Buffers of the pending batch, of kBatchBytes bytes, and the number of
+  // bytes used in them.
+  Tensor staging_ GUARDED_BY(mu_);
+  Tensor device_batch_ GUARDED_BY(mu_);
+  size_t used_bytes_ GUARDED_BY(mu_) = 0;
+  // Location of the constants in the pending batch, keyed by content hash.
+  struct Entry {
+    size_t offset;
+    size_t bytes;
+  };
+  std::unordered_multimap<uint64, Entry> entries_ GUARDED_BY(mu_);
+  std::atomic<bool> has_pending_{false};
+
+  // The transfers may complete inline, while mu_ is held.
+  mutex status_mu_;
+  Status status_ GUARDED_BY(status_mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(SYCLConstantBatcher);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_CONSTANT_BATCHER_H_
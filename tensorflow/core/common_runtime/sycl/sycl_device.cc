@@ -21,7 +21,10 @@ limitations under the License.
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 
+#include "tensorflow/core/common_runtime/sycl/sycl_tracer.h"
 #include "tensorflow/core/framework/tensor.pb_text.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/tracing.h"
 
 #include "tensorflow/core/framework/variant_op_registry.h"
@@ -33,21 +36,56 @@ SYCLDevice::~SYCLDevice() {
     delete gpu_device_info_;
 }
 
+// Every kernel builds and submits its own command group, whose accessors
+// register the dependencies of the launch. SYCL 1.2.1 has no way to record
+// command groups and submit them again, like CUDA graphs do: accessors are
+// bound to the handler of a single submission. Most kernels also capture
+// their arguments by reference in the command group. Replaying the launches
+// of a step would therefore need a SYCL implementation with a command graph
+// extension, and submission through a device-level API in every kernel.
 void SYCLDevice::Compute(OpKernel* op_kernel, OpKernelContext* context) {
   assert(context);
+  if (TF_PREDICT_FALSE(constant_batcher_.HasPending())) {
+    Status s = constant_batcher_.Flush(this);
+    if (!s.ok()) {
+      context->SetStatus(s);
+      return;
+    }
+  }
   // When ThreadScape profiling is off (which is the default), constructing the
   // following code is simple enough that its overhead is negligible.
   tracing::ScopedRegion region(tracing::EventCategory::kCompute,
                                op_kernel->name());
 
+  SYCLTracer* tracer = SYCLTracer::Get();
+  if (!tracer->IsEnabled()) {
+    op_kernel->Compute(context);
+    return;
+  }
+  // Eigen neither enables profiling on the compute queue nor exposes the
+  // events of the kernels it submits. While tracing, wait for the kernels of
+  // each op so that its record covers their execution on the device.
+  tracing::ScopedAnnotation annotation(op_kernel->name(),
+                                       op_kernel->type_string());
+  const cl::sycl::queue& queue = eigen_sycl_device()->sycl_queue();
+  const int64 start_us = Env::Default()->NowMicros();
   op_kernel->Compute(context);
+  eigen_sycl_device()->synchronize();
+  tracer->RecordInterval(queue, SYCLTracer::Kind::kKernel, op_kernel->name(),
+                         strings::StrCat(op_kernel->name(), " = ",
+                                         op_kernel->type_string()),
+                         start_us, Env::Default()->NowMicros());
 }
 
 Allocator* SYCLDevice::GetAllocator(AllocatorAttributes attr) {
-  if (attr.on_host())
+  if (attr.on_host()) {
+    if (attr.gpu_compatible() || force_gpu_compatible_) {
+      return sycl_host_allocator_;
+    }
     return cpu_allocator_;
-  else
-    return sycl_allocator_;
+  } else {
+    return device_allocator_;
+  }
 }
 
 Status SYCLDevice::MaybeCopyTensorToGPU(
@@ -147,6 +185,11 @@ Status SYCLDevice::MakeTensorFromProto(const TensorProto& tensor_proto,
     Status status;
     if (alloc_attrs.on_host()) {
       *tensor = parsed;
+    } else if (DataTypeCanUseMemcpy(parsed.dtype())) {
+      // Graphs can hold thousands of small constants, so they are uploaded
+      // in batches rather than waiting for each copy.
+      tracing::ScopedAnnotation annotation("MakeTensorFromProto");
+      status = constant_batcher_.Upload(this, parsed, tensor);
     } else {
       Tensor copy(GetAllocator(alloc_attrs), parsed.dtype(), parsed.shape());
 
@@ -180,10 +223,13 @@ Status SYCLDevice::FillContextMap(const Graph* graph,
     (*device_context_map)[n->id()] = device_context_;
   }
 
-  return Status::OK();
+  // The executor has created its kernels, so upload their constants before
+  // the step starts.
+  return constant_batcher_.Flush(this);
 }
 
 Status SYCLDevice::Sync() {
+  TF_RETURN_IF_ERROR(constant_batcher_.Flush(this));
   sycl_allocator_->Synchronize();
   if (sycl_allocator_->Ok()) {
     return Status::OK();
@@ -22,8 +22,15 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/local_device.h"
 #include "tensorflow/core/common_runtime/sycl/sycl_allocator.h"
+#include "tensorflow/core/common_runtime/sycl/sycl_bfc_allocator.h"
+#include "tensorflow/core/common_runtime/sycl/sycl_constant_batcher.h"
 #include "tensorflow/core/common_runtime/sycl/sycl_device_context.h"
+#include "tensorflow/core/common_runtime/sycl/sycl_host_allocator.h"
+#include "tensorflow/core/common_runtime/sycl/sycl_kernel_warmup.h"
+#include "tensorflow/core/common_runtime/sycl/sycl_tracer.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/public/session_options.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -32,7 +39,19 @@ class GSYCLInterface {
   std::vector<Allocator*> m_cpu_allocator_;                // not owned
   std::vector<SYCLAllocator*> m_sycl_allocator_;           // owned
   std::vector<SYCLDeviceContext*> m_sycl_context_;         // ref counted
+  // Pooled allocators are created lazily, the first time a device is
+  // configured to use them.
+  mutable mutex m_bfc_mu_;
+  mutable std::vector<SYCLBFCAllocator*> m_sycl_bfc_allocator_
+      GUARDED_BY(m_bfc_mu_);  // not deleted, see ~GSYCLInterface
+  mutable BFCAllocator* m_sycl_host_allocator_ GUARDED_BY(m_bfc_mu_) =
+      nullptr;  // not deleted, see ~GSYCLInterface
+  // Whether the kernels have been built for each device.
+  mutable mutex m_warmup_mu_;
+  mutable std::vector<bool> m_kernels_warmed_up_ GUARDED_BY(m_warmup_mu_);
   GSYCLInterface() {
+    // The drivers read their cache settings when the platforms are loaded.
+    SYCLKernelWarmup::EnableDriverCaches();
     bool found_device = false;
     auto device_list = Eigen::get_sycl_supported_devices();
     // Obtain list of supported devices from Eigen
@@ -89,6 +108,12 @@ class GSYCLInterface {
       // Tensors and Allocators when the program is cleaning up.
     }
     m_sycl_allocator_.clear();
+    {
+      // The pooled allocators share the lifetime issue described above and
+      // only hold buffers owned by the SYCLAllocators cleared above.
+      mutex_lock lock(m_bfc_mu_);
+      m_sycl_bfc_allocator_.clear();
+    }
 
     for (auto p : m_sycl_context_) {
       p->Unref();
@@ -116,7 +141,36 @@ class GSYCLInterface {
     m_queue_interface_.push_back(new Eigen::QueueInterface(d));
     m_cpu_allocator_.push_back(cpu_allocator());
     m_sycl_allocator_.push_back(new SYCLAllocator(m_queue_interface_.back()));
-    m_sycl_context_.push_back(new SYCLDeviceContext());
+    cl::sycl::queue* host_to_device_queue = nullptr;
+    cl::sycl::queue* device_to_host_queue = nullptr;
+    bool use_transfer_queues = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_SYCL_USE_TRANSFER_QUEUES", false,
+                                   &use_transfer_queues));
+    const int device_id = static_cast<int>(m_queue_interface_.size()) - 1;
+    SYCLTracer* tracer = SYCLTracer::Get();
+    tracer->RegisterQueue(&m_queue_interface_.back()->sycl_queue(), device_id,
+                          "compute");
+    if (use_transfer_queues) {
+      // The transfer queues share the context of the compute queue so that
+      // the buffers can be used on all of them without extra copies. Unlike
+      // the compute queue created by Eigen they have profiling enabled, so
+      // that traces show when the copies ran on the device.
+      auto context = m_queue_interface_.back()->sycl_queue().get_context();
+      const cl::sycl::property_list properties{
+          cl::sycl::property::queue::enable_profiling()};
+      host_to_device_queue = new cl::sycl::queue(context, d, properties);
+      device_to_host_queue = new cl::sycl::queue(context, d, properties);
+      tracer->RegisterQueue(host_to_device_queue, device_id, "HtoD");
+      tracer->RegisterQueue(device_to_host_queue, device_id, "DtoH");
+    }
+    m_sycl_context_.push_back(new SYCLDeviceContext(
+        device_id, host_to_device_queue, device_to_host_queue));
+    {
+      mutex_lock lock(m_bfc_mu_);
+      m_sycl_bfc_allocator_.push_back(nullptr);
+    }
+    mutex_lock lock(m_warmup_mu_);
+    m_kernels_warmed_up_.push_back(false);
   }
 
  public:
@@ -126,6 +180,10 @@ class GSYCLInterface {
     return &instance;
   }
 
+  // Returns the number of SYCL devices found. Device ids range from 0 to
+  // GetNumDevices() - 1.
+  size_t GetNumDevices() const { return m_queue_interface_.size(); }
+
   Eigen::QueueInterface* GetQueueInterface(size_t i = 0) const {
     if (!m_queue_interface_.empty()) {
       return m_queue_interface_[i];
@@ -144,6 +202,74 @@ class GSYCLInterface {
     }
   }
 
+  // Returns a pooling allocator which sub-allocates tensors from large SYCL
+  // buffers of device i, using at most memory_limit bytes. The allocator is
+  // created on the first call for a given device, later calls return the same
+  // instance regardless of the arguments.
+  SYCLBFCAllocator* GetSYCLBFCAllocator(size_t i, size_t memory_limit,
+                                        const GPUOptions& gpu_options) const {
+    SYCLAllocator* sycl_allocator = GetSYCLAllocator(i);
+    if (!sycl_allocator) {
+      return nullptr;
+    }
+    mutex_lock lock(m_bfc_mu_);
+    if (!m_sycl_bfc_allocator_[i]) {
+      m_sycl_bfc_allocator_[i] = new SYCLBFCAllocator(
+          sycl_allocator, memory_limit, gpu_options,
+          strings::StrCat("sycl_bfc_", i));
+    }
+    return m_sycl_bfc_allocator_[i];
+  }
+
+  // Returns the allocator used for host tensors which are copied to or from
+  // SYCL devices. The memory it returns satisfies the alignment constraints
+  // needed by OpenCL implementations to avoid staging host memory. It is
+  // shared by all the devices.
+  Allocator* GetSYCLHostAllocator() const {
+    mutex_lock lock(m_bfc_mu_);
+    if (!m_sycl_host_allocator_) {
+      int64 sycl_host_mem_limit_in_mb = -1;
+      Status status = ReadInt64FromEnvVar("TF_SYCL_HOST_MEM_LIMIT_IN_MB",
+                                          1LL << 16 /*64GB max by default*/,
+                                          &sycl_host_mem_limit_in_mb);
+      if (!status.ok()) {
+        LOG(ERROR) << "GetSYCLHostAllocator: " << status.error_message();
+      }
+      m_sycl_host_allocator_ = new BFCAllocator(
+          new SYCLHostAllocator(), sycl_host_mem_limit_in_mb * (1LL << 20),
+          true /*allow_growth*/, "sycl_host_bfc" /*name*/);
+    }
+    return m_sycl_host_allocator_;
+  }
+
+  // Builds the programs of the registered SYCL kernels for device i, see
+  // SYCLKernelWarmup. Only the first call for a device does any work, other
+  // callers wait for it to finish.
+  void WarmUpKernels(size_t i) const {
+    Eigen::QueueInterface* queue_ptr = GetQueueInterface(i);
+    if (!queue_ptr) {
+      return;
+    }
+    mutex_lock lock(m_warmup_mu_);
+    if (m_kernels_warmed_up_[i]) {
+      return;
+    }
+    SYCLKernelWarmup::Global()->WarmUp(queue_ptr->sycl_queue(),
+                                       port::NumSchedulableCPUs());
+    m_kernels_warmed_up_[i] = true;
+  }
+
+  // Returns the total amount of global memory available on device i.
+  size_t GetGlobalMemSize(size_t i = 0) const {
+    Eigen::QueueInterface* queue_ptr = GetQueueInterface(i);
+    if (!queue_ptr) {
+      return 0;
+    }
+    return queue_ptr->sycl_queue()
+        .get_device()
+        .get_info<cl::sycl::info::device::global_mem_size>();
+  }
+
   Allocator* GetCPUAllocator(size_t i = 0) const {
     if (!m_cpu_allocator_.empty()) {
       return m_cpu_allocator_[i];
@@ -198,17 +324,26 @@ class SYCLDevice : public LocalDevice {
   SYCLDevice(const SessionOptions& options, const string& name,
              Bytes memory_limit, const DeviceLocality& locality,
              const string& physical_device_desc, SYCLAllocator* sycl_allocator,
-             Allocator* cpu_allocator, SYCLDeviceContext* ctx)
+             Allocator* cpu_allocator, SYCLDeviceContext* ctx,
+             Allocator* device_allocator = nullptr, int device_id = 0)
       : LocalDevice(options, Device::BuildDeviceAttributes(
                                  name, DEVICE_SYCL, memory_limit, locality,
                                  physical_device_desc)),
         cpu_allocator_(cpu_allocator),
         sycl_allocator_(sycl_allocator),
+        device_allocator_(device_allocator ? device_allocator
+                                           : sycl_allocator),
+        sycl_host_allocator_(
+            GSYCLInterface::instance()->GetSYCLHostAllocator()),
         device_context_(ctx),
+        constant_batcher_(sycl_host_allocator_, device_allocator_, ctx),
         gpu_device_info_(new GpuDeviceInfo) {
+    if (options.config.has_gpu_options()) {
+      force_gpu_compatible_ =
+          options.config.gpu_options().force_gpu_compatible();
+    }
     gpu_device_info_->default_context = device_context_;
-    // TODO(codeplay): Improve to support multiple GPU devices
-    gpu_device_info_->gpu_id = 0;
+    gpu_device_info_->gpu_id = device_id;
 
     set_tensorflow_gpu_device_info(gpu_device_info_);
     set_eigen_sycl_device(sycl_allocator->getSyclDevice());
@@ -227,6 +362,12 @@ class SYCLDevice : public LocalDevice {
 
   Status Sync() override;
 
+  // Builds the programs of the SYCL kernels for this device ahead of their
+  // first launch. Blocks until they are built.
+  void WarmUp() {
+    GSYCLInterface::instance()->WarmUpKernels(device_context_->device_id());
+  }
+
   // This method returns an initialization status, in addition to
   // calling the "done" StatusCallback, if there is a failure to
   // allocate memory or if the tensor "from" is not DMA-copyable.
@@ -239,8 +380,18 @@ class SYCLDevice : public LocalDevice {
  private:
   Allocator* cpu_allocator_;           // not owned
   SYCLAllocator* sycl_allocator_;      // not owned
+  // Allocator used for device tensors. Either sycl_allocator_ itself or a
+  // pooling allocator built on top of it.
+  Allocator* device_allocator_;        // not owned
+  // Allocator for host tensors meant to be copied to or from the device.
+  Allocator* sycl_host_allocator_;     // not owned
   SYCLDeviceContext* device_context_;  // not owned
+  // Uploads the tensors of MakeTensorFromProto. Pending constants are flushed
+  // by FillContextMap, at the start of every step, and before running any
+  // kernel for callers not going through an executor.
+  SYCLConstantBatcher constant_batcher_;
   GpuDeviceInfo* gpu_device_info_;
+  bool force_gpu_compatible_ = false;
 };
 
 }  // namespace tensorflow
@@ -20,6 +20,8 @@ limitations under the License.
 #ifndef TENSORFLOW_COMMON_RUNTIME_SYCL_SYCL_DEVICE_CONTEXT_H_
 #define TENSORFLOW_COMMON_RUNTIME_SYCL_SYCL_DEVICE_CONTEXT_H_
 
+#include <memory>
+
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/sycl/sycl_util.h"
 #include "tensorflow/core/framework/device_base.h"
@@ -28,13 +30,30 @@ namespace tensorflow {
 
 class SYCLDeviceContext : public DeviceContext {
  public:
-  SYCLDeviceContext() {}
+  // If not null, host_to_device_queue and device_to_host_queue are used for
+  // the copies instead of the device's compute queue, so that transfers can
+  // overlap with kernels. Takes ownership of the queues.
+  explicit SYCLDeviceContext(int device_id = 0,
+                             cl::sycl::queue *host_to_device_queue = nullptr,
+                             cl::sycl::queue *device_to_host_queue = nullptr)
+      : device_id_(device_id),
+        host_to_device_queue_(host_to_device_queue),
+        device_to_host_queue_(device_to_host_queue) {}
 
   ~SYCLDeviceContext() override {}
 
+  // Index of the device in GSYCLInterface this context belongs to.
+  int device_id() const { return device_id_; }
+
   inline void CopyCPUTensorToDevice(const Tensor *cpu_tensor, Device *device,
                                     Tensor *device_tensor,
                                     StatusCallback done) const override {
+    if (host_to_device_queue_) {
+      SYCLUtil::copyCPUTensorToDevice(*device->eigen_sycl_device(),
+                                      *host_to_device_queue_, *cpu_tensor,
+                                      *device_tensor, done);
+      return;
+    }
     SYCLUtil::copyCPUTensorToDevice(device, *cpu_tensor, *device_tensor, done);
   }
 
@@ -42,8 +61,19 @@ class SYCLDeviceContext : public DeviceContext {
                                     StringPiece,
                                     Device *device, Tensor *cpu_tensor,
                                     StatusCallback done) override {
+    if (device_to_host_queue_) {
+      SYCLUtil::copyDeviceTensorToCPU(*device->eigen_sycl_device(),
+                                      *device_to_host_queue_, *device_tensor,
+                                      *cpu_tensor, done);
+      return;
+    }
     SYCLUtil::copyDeviceTensorToCPU(device, *device_tensor, *cpu_tensor, done);
   }
+
+ private:
+  const int device_id_;
+  std::unique_ptr<cl::sycl::queue> host_to_device_queue_;
+  std::unique_ptr<cl::sycl::queue> device_to_host_queue_;
 };
 
 }  // namespace tensorflow
@@ -19,6 +19,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/sycl/sycl_device.h"
 
 #include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+#include "tensorflow/core/common_runtime/threadpool_device.h"
 
 namespace tensorflow {
 
@@ -34,22 +35,122 @@ class SYCLDeviceFactory : public DeviceFactory {
     if (iter != options.config.device_count().end()) {
       n = iter->second;
     }
+    if (n > syclInterface->GetNumDevices()) {
+      LOG(WARNING) << "Requested " << n << " SYCL devices but only "
+                   << syclInterface->GetNumDevices() << " are available";
+      n = syclInterface->GetNumDevices();
+    }
+
+    const GPUOptions& gpu_options = options.config.gpu_options();
+    const bool use_bfc = gpu_options.allocator_type() == "BFC";
+    bool warmup_kernels = false;
+    TF_RETURN_IF_ERROR(ReadBoolFromEnvVar("TF_SYCL_WARMUP_KERNELS", false,
+                                          &warmup_kernels));
 
     for (int i = 0; i < n; i++) {
       string name = strings::StrCat(name_prefix, "/device:SYCL:", i);
+      // The memory limit is also reported to grappler, whose memory
+      // optimizer swaps tensors to the host when a graph does not fit.
+      const size_t memory_limit =
+          GetMemoryLimit(*syclInterface, i, gpu_options, use_bfc);
+      Allocator* device_allocator = nullptr;
+      if (use_bfc) {
+        device_allocator =
+            syclInterface->GetSYCLBFCAllocator(i, memory_limit, gpu_options);
+      }
       devices->push_back(new SYCLDevice(
-          options, name, Bytes(256 << 20), DeviceLocality(),
+          options, name, Bytes(memory_limit), DeviceLocality(),
           syclInterface->GetShortDeviceDescription(i),
           syclInterface->GetSYCLAllocator(i),
           syclInterface->GetCPUAllocator(i),
-          syclInterface->GetSYCLContext(i)));
+          syclInterface->GetSYCLContext(i), device_allocator, i));
+      if (warmup_kernels) {
+        syclInterface->WarmUpKernels(i);
+      }
     }
 
     return Status::OK();
   }
+
+ private:
+  // Computes the amount of memory device i may use.
+  // per_process_gpu_memory_fraction is honoured the same way as for GPUs,
+  // defaulting to the whole of the device's global memory.
+  static size_t GetMemoryLimit(const GSYCLInterface& syclInterface, int i,
+                               const GPUOptions& gpu_options, bool use_bfc) {
+    const size_t global_mem_size = syclInterface.GetGlobalMemSize(i);
+    size_t memory_limit = global_mem_size;
+    const double fraction = gpu_options.per_process_gpu_memory_fraction();
+    if (fraction > 0.0 && fraction < 1.0) {
+      memory_limit = static_cast<size_t>(global_mem_size * fraction);
+    }
+    if (use_bfc && !gpu_options.allow_growth()) {
+      // Without growth the whole pool is reserved as a single SYCL buffer,
+      // which cannot be larger than the device's maximum allocation size.
+      const size_t max_buffer_size =
+          syclInterface.GetSYCLAllocator(i)->getSyclDevice()->max_buffer_size();
+      memory_limit = std::min(memory_limit, max_buffer_size);
+    }
+    return memory_limit;
+  }
 };
 
 REGISTER_LOCAL_DEVICE_FACTORY("SYCL", SYCLDeviceFactory, 200);
+
+#if !GOOGLE_CUDA
+// A CPU device that uses the SYCL host allocator for tensors which will be
+// copied to SYCL devices, so that input pipelines can produce them directly
+// into memory the OpenCL runtime does not need to stage.
+class SYCLCompatibleCPUDevice : public ThreadPoolDevice {
+ public:
+  SYCLCompatibleCPUDevice(const SessionOptions& options, const string& name,
+                          Bytes memory_limit, const DeviceLocality& locality,
+                          Allocator* allocator)
+      : ThreadPoolDevice(options, name, memory_limit, locality, allocator),
+        sycl_host_allocator_(
+            GSYCLInterface::instance()->GetSYCLHostAllocator()) {
+    if (options.config.has_gpu_options()) {
+      force_gpu_compatible_ =
+          options.config.gpu_options().force_gpu_compatible();
+    }
+  }
+  ~SYCLCompatibleCPUDevice() override {}
+
+  Allocator* GetAllocator(AllocatorAttributes attr) override {
+    if (attr.gpu_compatible() || force_gpu_compatible_) {
+      return sycl_host_allocator_;
+    } else {
+      // Call the parent's implementation.
+      return ThreadPoolDevice::GetAllocator(attr);
+    }
+  }
+
+ private:
+  Allocator* sycl_host_allocator_;  // not owned
+  bool force_gpu_compatible_ = false;
+};
+
+// The associated factory.
+class SYCLCompatibleCPUDeviceFactory : public DeviceFactory {
+ public:
+  Status CreateDevices(const SessionOptions& options, const string& name_prefix,
+                       std::vector<Device*>* devices) override {
+    int n = 1;
+    auto iter = options.config.device_count().find("CPU");
+    if (iter != options.config.device_count().end()) {
+      n = iter->second;
+    }
+    for (int i = 0; i < n; i++) {
+      string name = strings::StrCat(name_prefix, "/device:CPU:", i);
+      devices->push_back(new SYCLCompatibleCPUDevice(
+          options, name, Bytes(256 << 20), DeviceLocality(), cpu_allocator()));
+    }
+
+    return Status::OK();
+  }
+};
+REGISTER_LOCAL_DEVICE_FACTORY("CPU", SYCLCompatibleCPUDeviceFactory, 70);
+#endif  // !GOOGLE_CUDA
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_USE_SYCL
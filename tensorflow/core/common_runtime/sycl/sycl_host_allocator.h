@@ -0,0 +1,72 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_USE_SYCL
+#error This file must only be included when building TensorFlow with SYCL support
+#endif
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_HOST_ALLOCATOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_HOST_ALLOCATOR_H_
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mem.h"
+
+namespace tensorflow {
+
+// Suballocator for host memory meant to be transferred to and from SYCL
+// devices.
+//
+// SYCL 1.2.1 has no API to allocate pinned host memory. OpenCL
+// implementations can however map host memory into the device address space
+// without an extra staging copy when it is page aligned and its size is a
+// multiple of the cache line size, which is what this allocator guarantees.
+// On integrated GPUs this allows the runtime to use the memory directly.
+class SYCLHostAllocator : public SubAllocator {
+ public:
+  static constexpr size_t kAlignment = 4096;
+  static constexpr size_t kSizeMultiple = 64;
+
+  SYCLHostAllocator() {}
+  ~SYCLHostAllocator() override {}
+
+  void* Alloc(size_t alignment, size_t num_bytes) override {
+    void* ptr = nullptr;
+    if (num_bytes > 0) {
+      num_bytes = (num_bytes + kSizeMultiple - 1) / kSizeMultiple *
+                  kSizeMultiple;
+      ptr = port::AlignedMalloc(num_bytes,
+                                std::max(alignment, kAlignment));
+      if (ptr == nullptr) {
+        LOG(WARNING) << "could not allocate SYCL host memory of size: "
+                     << num_bytes;
+      }
+    }
+    return ptr;
+  }
+
+  void Free(void* ptr, size_t num_bytes) override {
+    if (ptr != nullptr) {
+      port::AlignedFree(ptr);
+    }
+  }
+
+ private:
+  TF_DISALLOW_COPY_AND_ASSIGN(SYCLHostAllocator);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_HOST_ALLOCATOR_H_
@@ -0,0 +1,144 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifdef TENSORFLOW_USE_SYCL
+
+#include "tensorflow/core/common_runtime/sycl/sycl_kernel_tuner.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "tensorflow/core/lib/core/bits.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+
+namespace tensorflow {
+
+SYCLKernelTuner* SYCLKernelTuner::Global() {
+  static SYCLKernelTuner* tuner = new SYCLKernelTuner();
+  return tuner;
+}
+
+SYCLKernelTuner::SYCLKernelTuner() {
+  const char* tune = getenv("TF_SYCL_TUNE_KERNELS");
+  enabled_ = tune != nullptr && strcmp(tune, "1") == 0;
+
+  const char* forced = getenv("TF_SYCL_WORK_GROUP_SIZE");
+  if (forced != nullptr) {
+    int64 size;
+    if (strings::safe_strto64(forced, &size) && size > 0) {
+      forced_work_group_size_ = static_cast<size_t>(size);
+    } else {
+      LOG(WARNING) << "Ignoring invalid TF_SYCL_WORK_GROUP_SIZE=" << forced;
+    }
+  }
+
+  const char* path = getenv("TF_SYCL_KERNEL_TUNE_CACHE");
+  if (path != nullptr) {
+    path_ = path;
+    Load();
+  }
+}
+
+string SYCLKernelTuner::DeviceFingerprint(const Eigen::SyclDevice& device) {
+  const cl::sycl::queue* queue = &device.sycl_queue();
+  {
+    mutex_lock lock(mu_);
+    auto iter = fingerprints_.find(queue);
+    if (iter != fingerprints_.end()) {
+      return iter->second;
+    }
+  }
+  auto sycl_device = device.sycl_queue().get_device();
+  const string fingerprint = strings::StrCat(
+      sycl_device.get_info<cl::sycl::info::device::vendor>(), "/",
+      sycl_device.get_info<cl::sycl::info::device::name>(), "/",
+      sycl_device.get_info<cl::sycl::info::device::driver_version>());
+  mutex_lock lock(mu_);
+  fingerprints_[queue] = fingerprint;
+  return fingerprint;
+}
+
+bool SYCLKernelTuner::Find(const string& key, int64* value) const {
+  mutex_lock lock(mu_);
+  auto iter = map_.find(key);
+  if (iter == map_.end()) {
+    return false;
+  }
+  *value = iter->second;
+  return true;
+}
+
+void SYCLKernelTuner::Insert(const string& key, int64 value) {
+  mutex_lock lock(mu_);
+  map_[key] = value;
+  if (!path_.empty()) {
+    string contents;
+    for (const auto& entry : map_) {
+      strings::StrAppend(&contents, entry.first, "\t", entry.second, "\n");
+    }
+    Status s = WriteStringToFile(Env::Default(), path_, contents);
+    if (!s.ok()) {
+      LOG(WARNING) << "Could not save SYCL kernel tune cache to " << path_
+                   << ": " << s;
+    }
+  }
+}
+
+void SYCLKernelTuner::Load() {
+  string contents;
+  if (!ReadFileToString(Env::Default(), path_, &contents).ok()) {
+    return;
+  }
+  mutex_lock lock(mu_);
+  for (const string& line : str_util::Split(contents, '\n')) {
+    std::vector<string> fields = str_util::Split(line, '\t');
+    int64 value;
+    if (fields.size() != 2 || !strings::safe_strto64(fields[1], &value)) {
+      continue;
+    }
+    map_[fields[0]] = value;
+  }
+  VLOG(1) << "Loaded " << map_.size() << " SYCL kernel tune entries from "
+          << path_;
+}
+
+string SYCLKernelTuner::Key(const Eigen::SyclDevice& device,
+                            const string& kernel_name,
+                            const string& shape_key) {
+  return strings::StrCat(DeviceFingerprint(device), "|", kernel_name, "|",
+                         shape_key);
+}
+
+string SYCLKernelTuner::ShapeClass(size_t nb_items) {
+  return strings::StrCat("2^", Log2Ceiling64(std::max<size_t>(nb_items, 1)));
+}
+
+std::vector<int64> SYCLKernelTuner::WorkGroupSizeCandidates(
+    size_t max_group_size, size_t nb_items) {
+  std::vector<int64> candidates;
+  size_t size = 32;
+  for (; size < max_group_size && size < nb_items; size *= 2) {
+    candidates.push_back(size);
+  }
+  candidates.push_back(std::min(size, max_group_size));
+  return candidates;
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_USE_SYCL
@@ -0,0 +1,174 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_USE_SYCL
+#error This file must only be included when building TensorFlow with SYCL support
+#endif
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_KERNEL_TUNER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_KERNEL_TUNER_H_
+
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Picks launch parameters of the hand-written SYCL kernels, such as their
+// work-group size or which tiled variant of a kernel to use.
+//
+// Without any configuration every kernel uses a deterministic default: the
+// work-group size of SYCLUtil::get_nd_range, min(items, max work-group size),
+// and the first variant listed by the caller.
+//
+// The behaviour is controlled with the following environment variables:
+//  - TF_SYCL_TUNE_KERNELS=1 times every candidate on the first launch of a
+//    kernel for a given device and shape class, and keeps the fastest one.
+//  - TF_SYCL_WORK_GROUP_SIZE=<n> forces the work-group size of every tuned
+//    kernel, capped to the device limit. Mostly useful for benchmarking.
+//  - TF_SYCL_KERNEL_TUNE_CACHE=<file> loads the tuned values from the file on
+//    first use and rewrites it every time a new value is found. Each line of
+//    the file is "<key>\t<value>". Saved values are used even when tuning is
+//    disabled.
+//
+// Tuning runs the kernel several times on the real inputs, so it must only be
+// used for kernels whose result does not depend on previous launches, i.e.
+// kernels fully overwriting their outputs.
+class SYCLKernelTuner {
+ public:
+  static SYCLKernelTuner* Global();
+
+  // Calls launch(group_size), where group_size is the work-group size to use
+  // for a kernel covering nb_items work items. kernel_name must identify the
+  // kernel and its template parameters.
+  template <typename Launch>
+  void LaunchWithWorkGroupSize(const Eigen::SyclDevice& device,
+                               const string& kernel_name, size_t nb_items,
+                               Launch launch) {
+    const size_t max_group_size = SYCLUtil::get_max_work_group_size(device);
+    if (forced_work_group_size_ > 0) {
+      launch(std::min(forced_work_group_size_, max_group_size));
+      return;
+    }
+    const size_t default_size =
+        std::max<size_t>(1, std::min(nb_items, max_group_size));
+    if (!enabled_ && path_.empty()) {
+      launch(default_size);
+      return;
+    }
+    const string key = Key(device, kernel_name, ShapeClass(nb_items));
+    Tune(device, key, WorkGroupSizeCandidates(max_group_size, nb_items),
+         default_size, launch);
+  }
+
+  // Calls launch(variant) with one of the given variants of a kernel, by
+  // default the first one. shape_key must describe the parameters the choice
+  // depends on.
+  template <typename Launch>
+  void LaunchWithVariant(const Eigen::SyclDevice& device,
+                         const string& kernel_name, const string& shape_key,
+                         const std::vector<int64>& variants, Launch launch) {
+    DCHECK(!variants.empty());
+    if (variants.size() == 1 || (!enabled_ && path_.empty())) {
+      launch(variants[0]);
+      return;
+    }
+    Tune(device, Key(device, kernel_name, shape_key), variants, variants[0],
+         launch);
+  }
+
+  // Returns a key identifying the device, so that a cache file shared between
+  // machines never mixes results of different devices.
+  string DeviceFingerprint(const Eigen::SyclDevice& device);
+
+ private:
+  SYCLKernelTuner();
+
+  // Launches with the cached value for key if any. Otherwise, when tuning is
+  // enabled, times each candidate and caches the fastest one, or launches
+  // with default_value.
+  template <typename Launch>
+  void Tune(const Eigen::SyclDevice& device, const string& key,
+            const std::vector<int64>& candidates, int64 default_value,
+            Launch launch) {
+    int64 value;
+    if (Find(key, &value)) {
+      launch(value);
+      return;
+    }
+    if (!enabled_ || candidates.size() < 2) {
+      launch(default_value);
+      return;
+    }
+    uint64 best_time = std::numeric_limits<uint64>::max();
+    int64 best_value = default_value;
+    for (int64 candidate : candidates) {
+      // The first launch may compile the kernel, only the second one is
+      // timed.
+      launch(candidate);
+      device.synchronize();
+      const uint64 start = Env::Default()->NowMicros();
+      launch(candidate);
+      device.synchronize();
+      const uint64 elapsed = Env::Default()->NowMicros() - start;
+      VLOG(1) << "SYCL kernel tuner: " << key << " value " << candidate
+              << " took " << elapsed << "us";
+      if (elapsed < best_time) {
+        best_time = elapsed;
+        best_value = candidate;
+      }
+    }
+    // The outputs were written by the last timed launch already.
+    Insert(key, best_value);
+  }
+
+  bool Find(const string& key, int64* value) const;
+  void Insert(const string& key, int64 value);
+  void Load();
+
+  string Key(const Eigen::SyclDevice& device, const string& kernel_name,
+             const string& shape_key);
+
+  // Work items are grouped by power of two, kernels with a similar amount of
+  // work share the same work-group size.
+  static string ShapeClass(size_t nb_items);
+
+  // Powers of two from 32 up to the device limit, plus the device limit
+  // itself. Sizes beyond the first one covering all the work items are
+  // skipped.
+  static std::vector<int64> WorkGroupSizeCandidates(size_t max_group_size,
+                                                    size_t nb_items);
+
+  bool enabled_ = false;
+  size_t forced_work_group_size_ = 0;
+  string path_;
+
+  mutable mutex mu_;
+  std::unordered_map<string, int64> map_ GUARDED_BY(mu_);
+  std::unordered_map<const cl::sycl::queue*, string> fingerprints_
+      GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(SYCLKernelTuner);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_KERNEL_TUNER_H_
@@ -0,0 +1,101 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifdef TENSORFLOW_USE_SYCL
+
+#include "tensorflow/core/common_runtime/sycl/sycl_kernel_warmup.h"
+
+#include <stdlib.h>
+#include <algorithm>
+
+#include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+SYCLKernelWarmup* SYCLKernelWarmup::Global() {
+  static SYCLKernelWarmup* warmup = new SYCLKernelWarmup();
+  return warmup;
+}
+
+void SYCLKernelWarmup::Register(const char* kernel_name, BuildFn build) {
+  mutex_lock lock(mu_);
+  kernels_.emplace_back(kernel_name, std::move(build));
+}
+
+void SYCLKernelWarmup::WarmUp(const cl::sycl::queue& queue,
+                              int num_threads) {
+  std::vector<std::pair<const char*, BuildFn>> kernels;
+  {
+    mutex_lock lock(mu_);
+    kernels = kernels_;
+  }
+  if (kernels.empty()) {
+    return;
+  }
+  const uint64 start = Env::Default()->NowMicros();
+  const cl::sycl::context context = queue.get_context();
+  {
+    thread::ThreadPool pool(Env::Default(), "sycl_kernel_warmup",
+                            std::max(num_threads, 1));
+    BlockingCounter counter(kernels.size());
+    for (const auto& kernel : kernels) {
+      pool.Schedule([&context, &kernel, &counter]() {
+        const uint64 kernel_start = Env::Default()->NowMicros();
+        cl::sycl::program program(context);
+        kernel.second(&program);
+        VLOG(1) << "Built SYCL program of " << kernel.first << " in "
+                << Env::Default()->NowMicros() - kernel_start << "us";
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  }
+  LOG(INFO) << "Built " << kernels.size() << " SYCL kernel programs in "
+            << (Env::Default()->NowMicros() - start) / 1000 << "ms";
+}
+
+/* static */ void SYCLKernelWarmup::EnableDriverCaches() {
+  const char* dir = getenv("TF_SYCL_KERNEL_CACHE_DIR");
+  if (dir == nullptr || *dir == '\0') {
+    return;
+  }
+  // Each driver gets its own directory, their cache formats are unrelated.
+  static const char* const kDriverCacheVariables[][2] = {
+      {"POCL_CACHE_DIR", "pocl"},
+      {"cl_cache_dir", "intel"},
+      {"CUDA_CACHE_PATH", "nvidia"},
+  };
+  for (const auto& variable : kDriverCacheVariables) {
+    if (getenv(variable[0]) != nullptr) {
+      continue;
+    }
+    const string path = io::JoinPath(dir, variable[1]);
+    Status s = Env::Default()->RecursivelyCreateDir(path);
+    if (!s.ok()) {
+      LOG(WARNING) << "Could not create SYCL kernel cache directory " << path
+                   << ": " << s;
+      continue;
+    }
+    setenv(variable[0], path.c_str(), 0 /*overwrite*/);
+  }
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_USE_SYCL
@@ -0,0 +1,106 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_USE_SYCL
+#error This file must only be included when building TensorFlow with SYCL support
+#endif
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_KERNEL_WARMUP_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_KERNEL_WARMUP_H_
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Builds the programs of SYCL kernels ahead of their first launch. Without
+// it the SYCL runtime builds them from SPIR when a kernel is first submitted,
+// which makes the first steps on a device very slow.
+//
+// Kernels are registered with REGISTER_SYCL_KERNEL_WARMUP, in the translation
+// unit launching them. Building the program of a kernel builds all the
+// kernels of its translation unit, so registering one kernel per file is
+// enough.
+//
+// The behaviour is controlled with the following environment variables:
+//  - TF_SYCL_WARMUP_KERNELS=1 warms up every SYCL device when it is first
+//    created, otherwise warm-up only happens through SYCLDevice::WarmUp.
+//  - TF_SYCL_KERNEL_CACHE_DIR=<dir> makes the OpenCL drivers keep the device
+//    binaries they build in dir, so that later processes reuse them instead
+//    of compiling the kernels again. The drivers key the binaries by device
+//    and driver version. Variables the user already set for a driver take
+//    precedence.
+class SYCLKernelWarmup {
+ public:
+  using BuildFn = std::function<void(cl::sycl::program*)>;
+
+  static SYCLKernelWarmup* Global();
+
+  void Register(const char* kernel_name, BuildFn build);
+
+  // Builds the program of every registered kernel for the device of queue,
+  // on num_threads threads. Blocks until all the programs are built.
+  void WarmUp(const cl::sycl::queue& queue, int num_threads);
+
+  // Points the on-disk caches of the OpenCL drivers to
+  // TF_SYCL_KERNEL_CACHE_DIR if set. Must be called before the OpenCL
+  // platforms are first queried.
+  static void EnableDriverCaches();
+
+ private:
+  SYCLKernelWarmup() {}
+
+  mutex mu_;
+  std::vector<std::pair<const char*, BuildFn>> kernels_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(SYCLKernelWarmup);
+};
+
+namespace sycl_kernel_warmup {
+
+template <typename Kernel>
+class WarmupRegistrar {
+ public:
+  explicit WarmupRegistrar(const char* kernel_name) {
+    SYCLKernelWarmup::Global()->Register(
+        kernel_name, [](cl::sycl::program* program) {
+          program->build_with_kernel_type<Kernel>();
+        });
+  }
+};
+
+}  // namespace sycl_kernel_warmup
+
+// Registers the kernel named by the given type, usually the functor passed to
+// parallel_for, for SYCLKernelWarmup.
+#define REGISTER_SYCL_KERNEL_WARMUP(...) \
+  REGISTER_SYCL_KERNEL_WARMUP_UNIQ_HELPER(__COUNTER__, __VA_ARGS__)
+
+#define REGISTER_SYCL_KERNEL_WARMUP_UNIQ_HELPER(ctr, ...) \
+  REGISTER_SYCL_KERNEL_WARMUP_UNIQ(ctr, __VA_ARGS__)
+
+#define REGISTER_SYCL_KERNEL_WARMUP_UNIQ(ctr, ...)                    \
+  static ::tensorflow::sycl_kernel_warmup::WarmupRegistrar<__VA_ARGS__> \
+      sycl_kernel_warmup_registrar__body__##ctr##__object(#__VA_ARGS__)
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_KERNEL_WARMUP_H_
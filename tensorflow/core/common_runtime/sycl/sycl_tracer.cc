@@ -0,0 +1,163 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifdef TENSORFLOW_USE_SYCL
+
+#include "tensorflow/core/common_runtime/sycl/sycl_tracer.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/common_runtime/step_stats_collector.h"
+#include "tensorflow/core/framework/step_stats.pb.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+namespace {
+
+// The most recent annotation of the thread. When non-null this points to the
+// string of the active annotation handle, which outlives the submissions made
+// in its scope.
+thread_local const char* current_annotation = nullptr;
+
+}  // namespace
+
+constexpr size_t SYCLTracer::kMaxRecords;
+
+/* static */ SYCLTracer* SYCLTracer::Get() {
+  static SYCLTracer* tracer = new SYCLTracer();
+  return tracer;
+}
+
+Status SYCLTracer::Start() {
+  VLOG(1) << "SYCLTracer::Start";
+  bool expected = false;
+  if (!enabled_.compare_exchange_strong(expected, true)) {
+    return errors::Unavailable("SYCL tracing is already in progress.");
+  }
+  // Register as a TraceCollector to receive the ScopedAnnotations naming the
+  // commands.
+  tracing::SetTraceCollector(this);
+  return Status::OK();
+}
+
+void SYCLTracer::Stop() {
+  VLOG(1) << "SYCLTracer::Stop";
+  if (enabled_.exchange(false)) {
+    tracing::SetTraceCollector(nullptr);
+  }
+}
+
+Status SYCLTracer::Collect(StepStatsCollector* collector) {
+  if (IsEnabled()) {
+    return errors::FailedPrecondition("SYCL tracing is still enabled.");
+  }
+  mutex_lock l(mu_);
+  for (const auto& rec : records_) {
+    auto it = lanes_.find(rec.queue);
+    if (it == lanes_.end()) {
+      continue;
+    }
+    const Lane& lane = it->second;
+    const string device = strings::StrCat("/device:SYCL:", lane.device_id);
+    NodeExecStats* ns = new NodeExecStats;
+    ns->set_all_start_micros(rec.start_walltime_us);
+    ns->set_op_start_rel_micros(0);
+    const int64 elapsed_us =
+        std::max<int64>(rec.end_walltime_us - rec.start_walltime_us, 1);
+    ns->set_op_end_rel_micros(elapsed_us);
+    ns->set_all_end_rel_micros(elapsed_us);
+    ns->set_node_name(rec.name);
+    ns->set_timeline_label(rec.details);
+    // Kernels are also shown together on an "all" lane and copies on a
+    // "memcpy" lane, as for GPUs.
+    auto nscopy = new NodeExecStats;
+    *nscopy = *ns;
+    if (rec.kind == Kind::kKernel) {
+      collector->Save(strings::StrCat(device, "/stream:all"), ns);
+    } else {
+      collector->Save(strings::StrCat(device, "/memcpy"), ns);
+    }
+    collector->Save(strings::StrCat(device, "/stream:", lane.name), nscopy);
+  }
+  records_.clear();
+  return Status::OK();
+}
+
+void SYCLTracer::RegisterQueue(const cl::sycl::queue* queue, int device_id,
+                               const string& lane) {
+  mutex_lock l(mu_);
+  lanes_[queue] = Lane{device_id, lane};
+}
+
+void SYCLTracer::RecordEvent(const cl::sycl::queue& queue, Kind kind,
+                             const string& name, const string& details,
+                             const cl::sycl::event& event,
+                             int64 submit_walltime_us) {
+  if (!queue.has_property<cl::sycl::property::queue::enable_profiling>()) {
+    RecordInterval(queue, kind, name, details, submit_walltime_us,
+                   Env::Default()->NowMicros());
+    return;
+  }
+  // The profiling info uses a device clock in nanoseconds, it is mapped to
+  // the host clock through the time the command was submitted.
+  using cl::sycl::info::event_profiling;
+  const uint64 submit_ns =
+      event.get_profiling_info<event_profiling::command_submit>();
+  const uint64 start_ns =
+      event.get_profiling_info<event_profiling::command_start>();
+  const uint64 end_ns =
+      event.get_profiling_info<event_profiling::command_end>();
+  const int64 start_walltime_us =
+      submit_walltime_us + static_cast<int64>(start_ns - submit_ns) / 1000;
+  RecordInterval(queue, kind, name, details, start_walltime_us,
+                 start_walltime_us + static_cast<int64>(end_ns - start_ns) /
+                                         1000);
+}
+
+void SYCLTracer::RecordInterval(const cl::sycl::queue& queue, Kind kind,
+                                const string& name, const string& details,
+                                int64 start_walltime_us,
+                                int64 end_walltime_us) {
+  mutex_lock l(mu_);
+  if (records_.size() >= kMaxRecords) return;
+  records_.push_back(Record{&queue, kind, name, details, start_walltime_us,
+                            end_walltime_us});
+}
+
+/* static */ string SYCLTracer::CurrentAnnotation() {
+  return current_annotation ? current_annotation : "";
+}
+
+std::unique_ptr<tracing::TraceCollector::Handle>
+SYCLTracer::CreateAnnotationHandle(StringPiece name_part1,
+                                   StringPiece name_part2) const {
+  struct Impl : public tracing::TraceCollector::Handle {
+    string annotation;
+    explicit Impl(string&& name_scope) : annotation(name_scope) {
+      current_annotation = annotation.c_str();
+    }
+    ~Impl() override { current_annotation = nullptr; }
+  };
+  return std::unique_ptr<Handle>(
+      new Impl{ConcatenateNames(name_part1, name_part2)});
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_USE_SYCL
@@ -0,0 +1,122 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_USE_SYCL
+#error This file must only be included when building TensorFlow with SYCL support
+#endif
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_TRACER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_TRACER_H_
+
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/tracing.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+class StepStatsCollector;
+
+// Records the commands executed by SYCL devices while a DeviceTracer is
+// running, so that the timeline shows when they ran on the device rather than
+// when ops enqueued them.
+//
+// Every queue commands are recorded for must be registered first, each queue
+// gets its own lane in the timeline. When a queue was created with the
+// enable_profiling property the command times are read from the event
+// profiling info, otherwise they are the host times around the command.
+//
+// Recording is cheap to skip: callers check IsEnabled() before building the
+// names of the records.
+class SYCLTracer : public tracing::TraceCollector {
+ public:
+  enum class Kind { kKernel, kMemcpy };
+
+  // Returns the process wide tracer.
+  static SYCLTracer* Get();
+
+  // Starts recording. Only a single trace can be active, returns an
+  // Unavailable error if one already is.
+  Status Start();
+  // Stops recording. It is safe to call Stop on a tracer which is not
+  // recording.
+  void Stop();
+  // Adds the records of the last trace to collector and clears them. It is an
+  // error to call Collect while a trace is running.
+  Status Collect(StepStatsCollector* collector);
+
+  bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // Names the lane of queue, which belongs to SYCL device device_id.
+  void RegisterQueue(const cl::sycl::queue* queue, int device_id,
+                     const string& lane);
+
+  // Records a command submitted to queue at submit_walltime_us, event must be
+  // complete.
+  void RecordEvent(const cl::sycl::queue& queue, Kind kind, const string& name,
+                   const string& details, const cl::sycl::event& event,
+                   int64 submit_walltime_us);
+  // Records commands of queue timed on the host.
+  void RecordInterval(const cl::sycl::queue& queue, Kind kind,
+                      const string& name, const string& details,
+                      int64 start_walltime_us, int64 end_walltime_us);
+
+  // Returns the op annotation of the current thread, or an empty string.
+  static string CurrentAnnotation();
+
+  // tracing::TraceCollector interface:
+  std::unique_ptr<Handle> CreateAnnotationHandle(
+      StringPiece name_part1, StringPiece name_part2) const override;
+  std::unique_ptr<Handle> CreateActivityHandle(StringPiece, StringPiece,
+                                               bool) const override {
+    return nullptr;
+  }
+
+ private:
+  SYCLTracer() {}
+
+  struct Lane {
+    int device_id;
+    string name;
+  };
+  struct Record {
+    const cl::sycl::queue* queue;
+    Kind kind;
+    string name;
+    string details;
+    int64 start_walltime_us;
+    int64 end_walltime_us;
+  };
+
+  static constexpr size_t kMaxRecords = 1024 * 1024;
+
+  std::atomic<bool> enabled_{false};
+
+  mutex mu_;
+  std::unordered_map<const cl::sycl::queue*, Lane> lanes_ GUARDED_BY(mu_);
+  std::vector<Record> records_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(SYCLTracer);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_SYCL_SYCL_TRACER_H_
@@ -16,11 +16,70 @@ limitations under the License.
 #ifdef TENSORFLOW_USE_SYCL
 
 #include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+#include "tensorflow/core/common_runtime/copy_tensor.h"
+#include "tensorflow/core/common_runtime/sycl/sycl_tracer.h"
 #include "tensorflow/core/framework/tensor_reference.h"
 #include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
 
 namespace tensorflow {
 
+namespace {
+
+// The functions below return a closure recording a copy of total_bytes on
+// queue with SYCLTracer once it is run, or an empty function when not
+// tracing. The copy is named after the op or edge annotating the calling
+// thread, as for GPU copies, so they must be called when the copy is
+// submitted.
+
+void TracedCopyNames(const char* kind, int64 total_bytes, string* name,
+                     string* details) {
+  const string annotation = SYCLTracer::CurrentAnnotation();
+  *name = strings::StrCat(annotation.empty() ? "unknown" : annotation,
+                          ":MEMCPY", kind);
+  *details = strings::StrCat("MEMCPY", kind, " ", total_bytes, " bytes");
+}
+
+// Records the copy as running from start_us to the time the closure is run.
+std::function<void()> TraceCopy(const cl::sycl::queue& queue,
+                                const char* kind, int64 total_bytes,
+                                int64 start_us) {
+  SYCLTracer* tracer = SYCLTracer::Get();
+  if (!tracer->IsEnabled()) {
+    return std::function<void()>();
+  }
+  string name;
+  string details;
+  TracedCopyNames(kind, total_bytes, &name, &details);
+  const cl::sycl::queue* queue_ptr = &queue;
+  return [tracer, queue_ptr, name, details, start_us]() {
+    tracer->RecordInterval(*queue_ptr, SYCLTracer::Kind::kMemcpy, name,
+                           details, start_us, Env::Default()->NowMicros());
+  };
+}
+
+// Records the copy from the profiling info of event, which must be complete
+// when the closure is run.
+std::function<void()> TraceCopyEvent(const cl::sycl::queue& queue,
+                                     const char* kind, int64 total_bytes,
+                                     cl::sycl::event event, int64 submit_us) {
+  SYCLTracer* tracer = SYCLTracer::Get();
+  if (!tracer->IsEnabled()) {
+    return std::function<void()>();
+  }
+  string name;
+  string details;
+  TracedCopyNames(kind, total_bytes, &name, &details);
+  const cl::sycl::queue* queue_ptr = &queue;
+  return [tracer, queue_ptr, name, details, event, submit_us]() {
+    tracer->RecordEvent(*queue_ptr, SYCLTracer::Kind::kMemcpy, name, details,
+                        event, submit_us);
+  };
+}
+
+}  // namespace
+
 void SYCLUtil::copyCPUTensorToDevice(const Eigen::SyclDevice& sycl_device,
                                      const Tensor& cpu_tensor,
                                      Tensor& device_tensor,
@@ -28,9 +87,15 @@ void SYCLUtil::copyCPUTensorToDevice(const Eigen::SyclDevice& sycl_device,
   const int64 total_bytes = cpu_tensor.TotalBytes();
   const void *src_ptr = GetBase(&cpu_tensor);
   void *dst_ptr = GetBase(&device_tensor);
+  std::function<void()> trace =
+      TraceCopy(sycl_device.sycl_queue(), "HtoD", total_bytes,
+                Env::Default()->NowMicros());
 #ifdef EIGEN_SYCL_ASYNC_EXECUTION
   TensorReference input_ref(cpu_tensor);
-  auto callback = [done, input_ref]() {
+  auto callback = [done, input_ref, trace]() {
+    if (trace) {
+      trace();
+    }
     input_ref.Unref();
     done(Status::OK());
   };
@@ -41,6 +106,9 @@ void SYCLUtil::copyCPUTensorToDevice(const Eigen::SyclDevice& sycl_device,
   sycl_device.memcpyHostToDevice(dst_ptr, src_ptr, total_bytes,
                                  std::move(callback));
 #ifndef EIGEN_SYCL_ASYNC_EXECUTION
+  if (trace) {
+    trace();
+  }
   done(Status::OK());
 #endif
 }
@@ -52,15 +120,20 @@ void SYCLUtil::copyDeviceTensorToCPU(const Eigen::SyclDevice& sycl_device,
   const int64 total_bytes = device_tensor.TotalBytes();
   const void *src_ptr = GetBase(&device_tensor);
   void *dst_ptr = GetBase(&cpu_tensor);
+  std::function<void()> trace =
+      TraceCopy(sycl_device.sycl_queue(), "DtoH", total_bytes,
+                Env::Default()->NowMicros());
 #ifdef EIGEN_SYCL_ASYNC_EXECUTION
+  // The copy does not block, only done signals that cpu_tensor holds the
+  // device data. Callers needing the host values straight away must use
+  // blockingCopyDeviceTensorToCPU instead.
   TensorReference input_ref(device_tensor);
-  // For now this copy has to be blocking no matter what, later cone_copy
-  // could be removed.
-  Notification done_copy;
-  auto callback = [&done_copy, done, input_ref]() {
+  auto callback = [done, input_ref, trace]() {
+    if (trace) {
+      trace();
+    }
     input_ref.Unref();
     done(Status::OK());
-    done_copy.Notify();
   };
 #else
   // This will make the copy blocking
@@ -68,13 +141,82 @@ void SYCLUtil::copyDeviceTensorToCPU(const Eigen::SyclDevice& sycl_device,
 #endif
   sycl_device.memcpyDeviceToHost(dst_ptr, src_ptr, total_bytes,
                                  std::move(callback));
-#ifdef EIGEN_SYCL_ASYNC_EXECUTION
-  done_copy.WaitForNotification();
-#else
+#ifndef EIGEN_SYCL_ASYNC_EXECUTION
+  if (trace) {
+    trace();
+  }
   done(Status::OK());
 #endif
 }
 
+void SYCLUtil::copyCPUTensorToDevice(const Eigen::SyclDevice& sycl_device,
+                                     cl::sycl::queue& queue,
+                                     const Tensor& cpu_tensor,
+                                     Tensor& device_tensor,
+                                     StatusCallback done) {
+  const int64 total_bytes = cpu_tensor.TotalBytes();
+  if (total_bytes == 0) {
+    done(Status::OK());
+    return;
+  }
+  const uint8* src_ptr = static_cast<const uint8*>(GetBase(&cpu_tensor));
+  void* dst_ptr = GetBase(&device_tensor);
+  auto dst_buffer = sycl_device.get_sycl_buffer(dst_ptr);
+  const size_t dst_offset = sycl_device.get_offset(dst_ptr);
+  const int64 submit_us = Env::Default()->NowMicros();
+  auto event = queue.submit([&](cl::sycl::handler& cgh) {
+    auto dst_acc =
+        dst_buffer.get_access<cl::sycl::access::mode::discard_write>(
+            cgh, cl::sycl::range<1>(total_bytes),
+            cl::sycl::id<1>(dst_offset));
+    cgh.copy(src_ptr, dst_acc);
+  });
+  std::function<void()> trace =
+      TraceCopyEvent(queue, "HtoD", total_bytes, event, submit_us);
+  TensorReference input_ref(cpu_tensor);
+  Env::Default()->SchedClosure([event, input_ref, trace, done]() mutable {
+    event.wait();
+    if (trace) {
+      trace();
+    }
+    input_ref.Unref();
+    done(Status::OK());
+  });
+}
+
+void SYCLUtil::copyDeviceTensorToCPU(const Eigen::SyclDevice& sycl_device,
+                                     cl::sycl::queue& queue,
+                                     const Tensor& device_tensor,
+                                     Tensor& cpu_tensor,
+                                     StatusCallback done) {
+  const int64 total_bytes = device_tensor.TotalBytes();
+  if (total_bytes == 0) {
+    done(Status::OK());
+    return;
+  }
+  const void* src_ptr = GetBase(&device_tensor);
+  uint8* dst_ptr = static_cast<uint8*>(GetBase(&cpu_tensor));
+  auto src_buffer = sycl_device.get_sycl_buffer(src_ptr);
+  const size_t src_offset = sycl_device.get_offset(src_ptr);
+  const int64 submit_us = Env::Default()->NowMicros();
+  auto event = queue.submit([&](cl::sycl::handler& cgh) {
+    auto src_acc = src_buffer.get_access<cl::sycl::access::mode::read>(
+        cgh, cl::sycl::range<1>(total_bytes), cl::sycl::id<1>(src_offset));
+    cgh.copy(src_acc, dst_ptr);
+  });
+  std::function<void()> trace =
+      TraceCopyEvent(queue, "DtoH", total_bytes, event, submit_us);
+  TensorReference input_ref(device_tensor);
+  Env::Default()->SchedClosure([event, input_ref, trace, done]() mutable {
+    event.wait();
+    if (trace) {
+      trace();
+    }
+    input_ref.Unref();
+    done(Status::OK());
+  });
+}
+
 void SYCLUtil::copyDeviceTensorToDevice(const Eigen::SyclDevice& sycl_device,
                                         const Tensor& src_tensor,
                                         Tensor& dst_tensor) {
@@ -84,5 +226,86 @@ void SYCLUtil::copyDeviceTensorToDevice(const Eigen::SyclDevice& sycl_device,
   sycl_device.memcpy(dst_ptr, src_ptr, total_bytes);
 }
 
+// static
+void SYCLUtil::DeviceToDeviceCopy(DeviceContext* send_dev_context,
+                                  DeviceContext* recv_dev_context, Device* src,
+                                  Device* dst,
+                                  AllocatorAttributes src_alloc_attr,
+                                  AllocatorAttributes dst_alloc_attr,
+                                  const Tensor* input, Tensor* output,
+                                  StatusCallback done) {
+  const Eigen::SyclDevice* src_device = src->eigen_sycl_device();
+  const Eigen::SyclDevice* dst_device = dst->eigen_sycl_device();
+  const int64 total_bytes = input->TotalBytes();
+  if (total_bytes == 0) {
+    done(Status::OK());
+    return;
+  }
+  if (src_device == dst_device) {
+    copyDeviceTensorToDevice(*src_device, *input, *output);
+    done(Status::OK());
+    return;
+  }
+
+  if (src_device->sycl_queue().get_context() ==
+      dst_device->sycl_queue().get_context()) {
+    const void* src_ptr = GetBase(input);
+    void* dst_ptr = GetBase(output);
+    auto src_buffer = src_device->get_sycl_buffer(src_ptr);
+    auto dst_buffer = dst_device->get_sycl_buffer(dst_ptr);
+    const size_t src_offset = src_device->get_offset(src_ptr);
+    const size_t dst_offset = dst_device->get_offset(dst_ptr);
+    const cl::sycl::range<1> range(total_bytes);
+    const int64 submit_us = Env::Default()->NowMicros();
+    auto event = dst_device->sycl_queue().submit(
+        [&](cl::sycl::handler& cgh) {
+          auto src_acc = src_buffer.get_access<cl::sycl::access::mode::read>(
+              cgh, range, cl::sycl::id<1>(src_offset));
+          auto dst_acc =
+              dst_buffer.get_access<cl::sycl::access::mode::discard_write>(
+                  cgh, range, cl::sycl::id<1>(dst_offset));
+          cgh.copy(src_acc, dst_acc);
+        });
+    std::function<void()> trace = TraceCopyEvent(
+        dst_device->sycl_queue(), "DtoD", total_bytes, event, submit_us);
+    // Wait off the calling thread so that collectives can issue the copies
+    // of their next chunks while this one is in flight.
+    TensorReference input_ref(*input);
+    Env::Default()->SchedClosure([event, input_ref, trace, done]() mutable {
+      event.wait();
+      if (trace) {
+        trace();
+      }
+      input_ref.Unref();
+      done(Status::OK());
+    });
+    return;
+  }
+
+  // The devices cannot see each other's memory, bounce through the host.
+  AllocatorAttributes host_alloc_attrs;
+  host_alloc_attrs.set_on_host(true);
+  Tensor* cpu_tensor = new Tensor(src->GetAllocator(host_alloc_attrs),
+                                  input->dtype(), input->shape());
+  Tensor* dst_tensor = output;
+  copyDeviceTensorToCPU(
+      *src_device, *input, *cpu_tensor,
+      [dst_device, cpu_tensor, dst_tensor, done](const Status& s) {
+        if (!s.ok()) {
+          delete cpu_tensor;
+          done(s);
+          return;
+        }
+        copyCPUTensorToDevice(*dst_device, *cpu_tensor, *dst_tensor,
+                              [cpu_tensor, done](const Status& s) {
+                                delete cpu_tensor;
+                                done(s);
+                              });
+      });
+}
+
+static CopyTensor::Registration register_sycl_sycl_copy(
+    DEVICE_SYCL, DEVICE_SYCL, SYCLUtil::DeviceToDeviceCopy);
+
 }  // namespace tensorflow
 #endif  // TENSORFLOW_USE_SYCL
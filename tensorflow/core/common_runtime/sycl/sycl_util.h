@@ -37,6 +37,8 @@ class SYCLUtil {
       const Eigen::SyclDevice& sycl_device, const Tensor& cpu_tensor,
       Tensor& device_tensor, StatusCallback done = [](const Status&) {});
 
+  // With EIGEN_SYCL_ASYNC_EXECUTION this returns as soon as the copy is
+  // enqueued, cpu_tensor must then not be read before done has been called.
   static void copyDeviceTensorToCPU(
       const Eigen::SyclDevice& sycl_device, const Tensor& device_tensor,
       Tensor& cpu_tensor, StatusCallback done = [](const Status&) {});
@@ -45,6 +47,32 @@ class SYCLUtil {
                                        const Tensor& src_tensor,
                                        Tensor& dst_tensor);
 
+  // Same as the above, but the copy is submitted to the given queue instead
+  // of the device's compute queue. The queue must share the SYCL context of
+  // the device, so that the SYCL runtime orders the copy with respect to the
+  // kernels accessing the same buffer on the compute queue.
+  static void copyCPUTensorToDevice(const Eigen::SyclDevice& sycl_device,
+                                    cl::sycl::queue& queue,
+                                    const Tensor& cpu_tensor,
+                                    Tensor& device_tensor,
+                                    StatusCallback done);
+
+  static void copyDeviceTensorToCPU(const Eigen::SyclDevice& sycl_device,
+                                    cl::sycl::queue& queue,
+                                    const Tensor& device_tensor,
+                                    Tensor& cpu_tensor, StatusCallback done);
+
+  // Copies a tensor between two different SYCL devices. When both queues
+  // share a SYCL context the copy is done directly by the destination queue,
+  // otherwise the data goes through a temporary host tensor.
+  static void DeviceToDeviceCopy(DeviceContext* send_dev_context,
+                                 DeviceContext* recv_dev_context, Device* src,
+                                 Device* dst,
+                                 AllocatorAttributes src_alloc_attr,
+                                 AllocatorAttributes dst_alloc_attr,
+                                 const Tensor* input, Tensor* output,
+                                 StatusCallback done);
+
   static inline void blockingCopyCPUTensorToDevice(
       const Eigen::SyclDevice& sycl_device, const Tensor& cpu_tensor,
       Tensor& device_tensor) {
@@ -114,6 +142,23 @@ class SYCLUtil {
                                  cl::sycl::range<1>(group_size));
   }
 
+  // Same as the above with an explicit work-group size, as returned by the
+  // SYCLKernelTuner. The global range is rounded up to a multiple of
+  // group_size so kernels must check their global id against items.
+  template <class T>
+  static inline cl::sycl::nd_range<1> get_nd_range(const Eigen::SyclDevice& d,
+                                                   const T items,
+                                                   const size_t group_size) {
+    const size_t nb_items = static_cast<size_t>(items);
+    const size_t local_size = std::max<size_t>(
+        1, std::min(group_size, SYCLUtil::get_max_work_group_size(d)));
+    const size_t group_count = (nb_items + local_size - 1) / local_size;
+
+    return cl::sycl::nd_range<1>(
+        cl::sycl::range<1>(std::max<size_t>(group_count, 1) * local_size),
+        cl::sycl::range<1>(local_size));
+  }
+
   template <class T>
   static inline cl::sycl::nd_range<2> get_nd_range(const Eigen::SyclDevice& d,
                                                    const T item_dim0,
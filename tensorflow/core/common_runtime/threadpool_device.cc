@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/threadpool_device.h"
 
 #include "tensorflow/core/common_runtime/local_device.h"
+#include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/common_runtime/scoped_allocator.h"
 #include "tensorflow/core/common_runtime/scoped_allocator_mgr.h"
 #include "tensorflow/core/framework/allocator.h"
@@ -25,7 +26,9 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.pb_text.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/graph/types.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/public/session_options.h"
@@ -48,6 +51,14 @@ ThreadPoolDevice::ThreadPoolDevice(const SessionOptions& options,
                                name, DEVICE_CPU, memory_limit, locality)),
       allocator_(allocator),
       scoped_allocator_mgr_(new ScopedAllocatorMgr(name)) {
+  // The executors of the device run their nodes on the device's node.
+  if (options.config.experimental().use_numa_affinity() &&
+      port::NUMAEnabled() && locality.numa_node() >= 0 &&
+      locality.numa_node() < port::NUMANumNodes()) {
+    numa_thread_pool_.reset(
+        NewThreadPoolFromSessionOptions(options, locality.numa_node()));
+    set_tensorflow_device_thread_pool(numa_thread_pool_.get());
+  }
 #ifdef INTEL_MKL
 #ifdef _OPENMP
   const char* user_omp_threads = getenv("OMP_NUM_THREADS");
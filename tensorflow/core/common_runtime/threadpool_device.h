@@ -45,6 +45,8 @@ class ThreadPoolDevice : public LocalDevice {
  private:
   Allocator* allocator_;  // Not owned
   std::unique_ptr<ScopedAllocatorMgr> scoped_allocator_mgr_;
+  // The inter op threads pinned to the NUMA node of the device, if any.
+  std::unique_ptr<thread::ThreadPool> numa_thread_pool_;
 };
 
 }  // namespace tensorflow
@@ -19,6 +19,7 @@ limitations under the License.
 #include <vector>
 #include "tensorflow/core/common_runtime/device_factory.h"
 #include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/public/session_options.h"
 
 namespace tensorflow {
@@ -28,17 +29,28 @@ class ThreadPoolDeviceFactory : public DeviceFactory {
  public:
   Status CreateDevices(const SessionOptions& options, const string& name_prefix,
                        std::vector<Device*>* devices) override {
-    // TODO(zhifengc/tucker): Figure out the number of available CPUs
-    // and/or NUMA configuration.
-    int n = 1;
+    // TODO(zhifengc/tucker): Figure out the number of available CPUs.
+    // With NUMA affinity, there is a device per NUMA node by default and
+    // the devices are spread over the nodes.
+    const bool numa_affinity =
+        options.config.experimental().use_numa_affinity() &&
+        port::NUMAEnabled();
+    int n = numa_affinity ? port::NUMANumNodes() : 1;
     auto iter = options.config.device_count().find("CPU");
     if (iter != options.config.device_count().end()) {
       n = iter->second;
     }
     for (int i = 0; i < n; i++) {
       string name = strings::StrCat(name_prefix, "/device:CPU:", i);
-      devices->push_back(new ThreadPoolDevice(
-          options, name, Bytes(256 << 20), DeviceLocality(), cpu_allocator()));
+      DeviceLocality locality;
+      Allocator* allocator = cpu_allocator();
+      if (numa_affinity) {
+        const int numa_node = i % port::NUMANumNodes();
+        locality.set_numa_node(numa_node);
+        allocator = cpu_allocator(numa_node);
+      }
+      devices->push_back(new ThreadPoolDevice(options, name, Bytes(256 << 20),
+                                              locality, allocator));
     }
 
     return Status::OK();
@@ -188,6 +188,11 @@ Status GraphMgr::InitItem(const string& session, const GraphDef& gdef,
       OptimizationPassRegistry::POST_PARTITIONING, optimization_options));
 
   LocalExecutorParams params;
+  params.schedule_by_critical_path = graph_options.schedule_by_critical_path();
+  if (graph_options.executor_work_stealing()) {
+    params.max_stealing_workers = worker_env_->compute_pool->NumThreads();
+  }
+  params.plan_memory = graph_options.plan_static_memory();
 
   item->units.reserve(partitions.size());
   item->graph_mgr = this;
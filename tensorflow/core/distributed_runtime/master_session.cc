@@ -464,7 +464,8 @@ Status MasterSession::ReffedClientGraph::DoRegisterPartitions(
 // Helper class to manage "num" parallel RunGraph calls.
 class RunManyGraphs {
  public:
-  explicit RunManyGraphs(int num) : calls_(num), pending_(num) {}
+  explicit RunManyGraphs(int num)
+      : calls_(num), num_pending_(num), num_waited_(num) {}
 
   ~RunManyGraphs() {}
 
@@ -473,23 +474,50 @@ class RunManyGraphs {
     CallOptions opts;
     std::unique_ptr<MutableRunGraphRequestWrapper> req;
     std::unique_ptr<MutableRunGraphResponseWrapper> resp;
+    // If true, Wait() does not wait for this call.
+    bool in_background = false;
   };
   Call* get(int index) { return &calls_[index]; }
 
+  // Runs the index-th call in the background. Must be called before the call
+  // is issued.
+  void SetInBackground(int index) {
+    calls_[index].in_background = true;
+    ++num_background_;
+    mutex_lock l(mu_);
+    --num_waited_;
+  }
+
+  bool HasBackgroundCalls() const { return num_background_ > 0; }
+
   // When the index-th call is done, updates the overall status.
   void WhenDone(int index, const Status& s) {
     TRACEPRINTF("Partition %d %s", index, s.ToString().c_str());
     auto resp = get(index)->resp.get();
-    if (resp->status_code() != error::Code::OK) {
-      // resp->status_code will only be non-OK if s.ok().
-      mutex_lock l(mu_);
-      UpdateStatusLocked(
-          Status(resp->status_code(), resp->status_error_message()));
-    } else if (!s.ok()) {
+    StatusCallback all_done;
+    Status status;
+    {
       mutex_lock l(mu_);
-      UpdateStatusLocked(s);
+      if (resp->status_code() != error::Code::OK) {
+        // resp->status_code will only be non-OK if s.ok().
+        UpdateStatusLocked(
+            Status(resp->status_code(), resp->status_error_message()));
+      } else if (!s.ok()) {
+        UpdateStatusLocked(s);
+      }
+      if (!calls_[index].in_background) {
+        if (--num_waited_ == 0) {
+          waited_done_.notify_all();
+        }
+      }
+      if (--num_pending_ == 0) {
+        std::swap(all_done, all_done_);
+        status = status_;
+      }
+    }
+    if (all_done) {
+      all_done(status);
     }
-    pending_.DecrementCount();
   }
 
   void StartCancel() {
@@ -497,7 +525,27 @@ class RunManyGraphs {
     UpdateStatusLocked(errors::Cancelled("RunManyGraphs"));
   }
 
-  void Wait() { pending_.Wait(); }
+  // Waits for the calls that do not run in the background.
+  void Wait() {
+    mutex_lock l(mu_);
+    while (num_waited_ > 0) {
+      waited_done_.wait(l);
+    }
+  }
+
+  // Calls `done` with the overall status once all the calls are done.
+  void WhenAllDone(StatusCallback done) {
+    Status status;
+    {
+      mutex_lock l(mu_);
+      if (num_pending_ > 0) {
+        all_done_ = std::move(done);
+        return;
+      }
+      status = status_;
+    }
+    done(status);
+  }
 
   Status status() const {
     mutex_lock l(mu_);
@@ -506,9 +554,13 @@ class RunManyGraphs {
 
  private:
   gtl::InlinedVector<Call, 4> calls_;
+  int num_background_ = 0;
 
-  BlockingCounter pending_;
   mutable mutex mu_;
+  condition_variable waited_done_;
+  int num_pending_ GUARDED_BY(mu_);
+  int num_waited_ GUARDED_BY(mu_);
+  StatusCallback all_done_ GUARDED_BY(mu_);
   Status status_ GUARDED_BY(mu_);
 
   void UpdateStatusLocked(const Status& s) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
@@ -585,11 +637,11 @@ Status MasterSession::ReffedClientGraph::RunPartitionsHelper(
   }
 
   const int num = partitions_.size();
-  RunManyGraphs calls(num);
+  std::unique_ptr<RunManyGraphs> calls(new RunManyGraphs(num));
 
   for (int i = 0; i < num; ++i) {
     const Part& part = partitions_[i];
-    RunManyGraphs::Call* c = calls.get(i);
+    RunManyGraphs::Call* c = calls->get(i);
     c->req.reset(part.worker->CreateRunGraphRequest());
     c->resp.reset(part.worker->CreateRunGraphResponse());
     if (is_partial_) {
@@ -648,38 +700,68 @@ Status MasterSession::ReffedClientGraph::RunPartitionsHelper(
     }
   }
 
+  // In a pipelined step, the partitions without fetches run in the
+  // background.
+  if (pss->pipelined && !is_partial_) {
+    for (int i = 0; i < num; ++i) {
+      if (partitions_[i].key_fetch.empty()) {
+        calls->SetInBackground(i);
+      }
+    }
+  }
+
   // Issues RunGraph calls.
+  RunManyGraphs* const run_calls = calls.get();
   for (int i = 0; i < num; ++i) {
     const Part& part = partitions_[i];
-    RunManyGraphs::Call* call = calls.get(i);
+    RunManyGraphs::Call* call = calls->get(i);
     TRACEPRINTF("Partition %d %s", i, part.name.c_str());
     part.worker->RunGraphAsync(
         &call->opts, call->req.get(), call->resp.get(),
-        std::bind(&RunManyGraphs::WhenDone, &calls, i, std::placeholders::_1));
+        std::bind(&RunManyGraphs::WhenDone, run_calls, i,
+                  std::placeholders::_1));
   }
 
   // Waits for the RunGraph calls.
-  call_opts->SetCancelCallback([&calls]() { calls.StartCancel(); });
+  call_opts->SetCancelCallback([run_calls]() { run_calls->StartCancel(); });
   auto token = cm->get_cancellation_token();
   const bool success =
-      cm->RegisterCallback(token, [&calls]() { calls.StartCancel(); });
+      cm->RegisterCallback(token, [run_calls]() { run_calls->StartCancel(); });
   if (!success) {
-    calls.StartCancel();
+    run_calls->StartCancel();
   }
-  calls.Wait();
+  run_calls->Wait();
   call_opts->ClearCancelCallback();
-  if (success) {
+  if (run_calls->HasBackgroundCalls()) {
+    // The calls are deleted once the partitions running in the background
+    // are done, which the session can still cancel until then.
+    calls.release();
+    pss->when_partitions_done = [run_calls, cm, token,
+                                 success](StatusCallback done) {
+      run_calls->WhenAllDone([run_calls, cm, token, success,
+                              done](const Status& s) {
+        if (success) {
+          cm->DeregisterCallback(token);
+        }
+        delete run_calls;
+        done(s);
+      });
+    };
+  } else if (success) {
     cm->DeregisterCallback(token);
-  } else {
+  }
+  if (!success) {
     return errors::Cancelled("Step was cancelled");
   }
-  TF_RETURN_IF_ERROR(calls.status());
+  TF_RETURN_IF_ERROR(run_calls->status());
 
   // Collects fetches and metadata.
   Status status;
   for (int i = 0; i < num; ++i) {
+    if (run_calls->get(i)->in_background) continue;
     const Part& part = partitions_[i];
-    MutableRunGraphResponseWrapper* run_graph_resp = calls.get(i)->resp.get();
+    MutableRunGraphResponseWrapper* run_graph_resp =
+        run_calls->get(i)->resp.get();
     for (size_t j = 0; j < run_graph_resp->num_recvs(); ++j) {
       auto iter = part.key_fetch.find(run_graph_resp->recv_key(j));
       if (iter == part.key_fetch.end()) {
@@ -1762,14 +1844,37 @@ Status MasterSession::PostRunCleanup(MasterSession::ReffedClientGraph* rcg,
   }
   Ref();
   rcg->Ref();
-  rcg->CleanupPartitionsAsync(step_id, [this, rcg](const Status& s) {
-    if (!s.ok()) {
-      LOG(ERROR) << "Cleanup partition error: " << s;
+  auto cleanup = [this, rcg, step_id]() {
+    rcg->CleanupPartitionsAsync(step_id, [this, rcg](const Status& s) {
+      if (!s.ok()) {
+        LOG(ERROR) << "Cleanup partition error: " << s;
+      }
+      rcg->Unref();
+      MarkRunCompletion();
+      Unref();
+    });
+  };
+  if (pss->when_partitions_done) {
+    // Cleaning up the step would abort the partitions still running.
+    const bool run_ok = s.ok();
+    {
+      mutex_lock l(mu_);
+      ++num_pipelined_steps_;
     }
-    rcg->Unref();
-    MarkRunCompletion();
-    Unref();
-  });
+    pss->when_partitions_done([this, run_ok, cleanup](const Status& s) {
+      {
+        mutex_lock l(mu_);
+        --num_pipelined_steps_;
+        if (run_ok && !s.ok() && pipelined_status_.ok()) {
+          pipelined_status_ = s;
+        }
+        num_pipelined_steps_changed_.notify_all();
+      }
+      cleanup();
+    });
+  } else {
+    cleanup();
+  }
   return s;
 }
 
@@ -1791,6 +1896,22 @@ Status MasterSession::DoRunWithLocalExecution(
   // Unref "rcg" when out of scope.
   core::ScopedUnref unref(rcg);
 
+  // Bounds the number of steps running in the background, and returns the
+  // error of any of them.
+  const int max_pipelined_steps =
+      session_opts_.config.experimental().max_pipelined_steps();
+  if (max_pipelined_steps > 0) {
+    mutex_lock l(mu_);
+    while (num_pipelined_steps_ >= max_pipelined_steps) {
+      num_pipelined_steps_changed_.wait(l);
+    }
+    if (!pipelined_status_.ok()) {
+      Status s = pipelined_status_;
+      pipelined_status_ = Status::OK();
+      return s;
+    }
+  }
+
   std::unique_ptr<DebuggerStateInterface> debugger_state;
   const DebugOptions& debug_options = req.options().debug_options();
 
@@ -1807,6 +1928,9 @@ Status MasterSession::DoRunWithLocalExecution(
 
   std::unique_ptr<ProfileHandler> ph;
   FillPerStepState(rcg, req.options(), step_id, count, &pss, &ph);
+  pss.pipelined = max_pipelined_steps > 0 && !debugger_state &&
+                  !pss.collect_costs && !pss.collect_timeline &&
+                  !pss.collect_rpcs && !pss.collect_partition_graphs;
 
   Status s = rcg->RunPartitions(env_, step_id, count, &pss, opts, req, resp,
                                 &cancellation_manager_, false);
@@ -168,6 +168,11 @@ class MasterSession : public core::RefCounted {
     std::vector<StepStats> step_stats;  // per partition
     StepStats rpc_stats;                // for RPC layer
     CostGraphDef cost_graph;
+    // If true, RunPartitions() only waits for the partitions with fetches.
+    bool pipelined = false;
+    // Set by RunPartitions() if partitions of the step are still running, to
+    // a function that calls its argument once they are done.
+    std::function<void(StatusCallback)> when_partitions_done;
   };
 
   struct RunState {
@@ -195,6 +200,12 @@ class MasterSession : public core::RefCounted {
   condition_variable num_running_is_zero_;
   int32 num_running_ GUARDED_BY(mu_) = 0;
 
+  // Steps whose partitions without fetches are still running, and the first
+  // error of such a partition, which the next step returns.
+  condition_variable num_pipelined_steps_changed_;
+  int32 num_pipelined_steps_ GUARDED_BY(mu_) = 0;
+  Status pipelined_status_ GUARDED_BY(mu_);
+
   bool closed_ GUARDED_BY(mu_) = false;
   bool garbage_collected_ GUARDED_BY(mu_) = false;
 
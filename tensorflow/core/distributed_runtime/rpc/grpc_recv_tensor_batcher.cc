@@ -0,0 +1,255 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/rpc/grpc_recv_tensor_batcher.h"
+
+#include <utility>
+
+#include "grpc++/alarm.h"
+#include "grpc++/grpc++.h"
+
+#include "tensorflow/core/distributed_runtime/rpc/grpc_client_cq_tag.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_tensor_coding.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_worker_service_impl.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Object allocated per active RecvTensorBatch call. Parses each response of
+// the stream into the TensorResponse of its request, and calls the callback
+// of that request right away. The requests that have not received a response
+// when the stream ends fail with the status of the call.
+class RecvTensorBatchCall : public GrpcClientCQTag {
+ public:
+  RecvTensorBatchCall(std::shared_ptr<GrpcRecvTensorBatcher> batcher,
+                      ::grpc::GenericStub* stub, ::grpc::CompletionQueue* cq,
+                      const ::grpc::string& method,
+                      const RecvTensorBatchRequest& request,
+                      std::vector<GrpcRecvTensorBatcher::PendingRecv> pending)
+      : batcher_(std::move(batcher)),
+        pending_(std::move(pending)),
+        num_pending_(pending_.size()) {
+    for (const GrpcRecvTensorBatcher::PendingRecv& recv : pending_) {
+      if (recv.call_opts) {
+        recv.call_opts->SetCancelCallback([this]() { context_.TryCancel(); });
+      }
+    }
+    ::grpc::Status s = GrpcMaybeUnparseProto(request, &request_buf_);
+    if (!s.ok()) {
+      LOG(ERROR) << "GrpcMaybeUnparseProto returned with non-ok status: "
+                 << s.error_message();
+    }
+    call_ = stub->PrepareCall(&context_, method, cq);
+    call_->StartCall(this);
+  }
+
+  void OnCompleted(bool ok) override {
+    switch (state_) {
+      case State::kStartCall:
+        if (!ok) {
+          FinishCall();
+          return;
+        }
+        state_ = State::kWriteRequest;
+        call_->WriteLast(request_buf_, ::grpc::WriteOptions(), this);
+        return;
+      case State::kWriteRequest:
+        if (!ok) {
+          FinishCall();
+          return;
+        }
+        state_ = State::kRead;
+        call_->Read(&response_buf_, this);
+        return;
+      case State::kRead:
+        if (!ok) {
+          // The server has ended the stream.
+          FinishCall();
+          return;
+        }
+        status_ = ReadResponse();
+        response_buf_.Clear();
+        if (!status_.ok()) {
+          context_.TryCancel();
+          FinishCall();
+          return;
+        }
+        call_->Read(&response_buf_, this);
+        return;
+      case State::kFinish:
+        OnFinished();
+        return;
+    }
+  }
+
+ private:
+  enum class State { kStartCall, kWriteRequest, kRead, kFinish };
+
+  Status ReadResponse() {
+    int32 index;
+    TF_RETURN_IF_ERROR(
+        grpc::PeekBatchIndexFromByteBuffer(&response_buf_, &index));
+    if (index < 0 || index >= static_cast<int32>(pending_.size()) ||
+        !pending_[index].done) {
+      return errors::Internal("Unexpected RecvTensorBatch response for ",
+                              "request ", index);
+    }
+    GrpcRecvTensorBatcher::PendingRecv& recv = pending_[index];
+    GrpcByteSource source(&response_buf_);
+    TF_RETURN_IF_ERROR(recv.response->ParseFrom(&source));
+    Done(&recv, Status::OK());
+    return Status::OK();
+  }
+
+  void Done(GrpcRecvTensorBatcher::PendingRecv* recv, const Status& s) {
+    if (recv->call_opts) {
+      recv->call_opts->ClearCancelCallback();
+    }
+    StatusCallback done;
+    std::swap(done, recv->done);
+    --num_pending_;
+    done(s);
+  }
+
+  void FinishCall() {
+    state_ = State::kFinish;
+    call_->Finish(&grpc_status_, this);
+  }
+
+  void OnFinished() {
+    Status s = status_.ok() ? FromGrpcStatus(grpc_status_) : status_;
+    if (s.ok() && num_pending_ > 0) {
+      s = errors::Internal("RecvTensorBatch returned no response for ",
+                           num_pending_, " of ", pending_.size(), " requests");
+    }
+    if (!s.ok()) {
+      VLOG(2) << "Call returned with non-ok status: " << s;
+    }
+    for (GrpcRecvTensorBatcher::PendingRecv& recv : pending_) {
+      if (recv.done) {
+        Done(&recv, s);
+      }
+    }
+    delete this;
+  }
+
+  // Keeps the stub alive.
+  const std::shared_ptr<GrpcRecvTensorBatcher> batcher_;
+  std::vector<GrpcRecvTensorBatcher::PendingRecv> pending_;
+  int num_pending_;
+  ::grpc::ClientContext context_;
+  std::unique_ptr<::grpc::GenericClientAsyncReaderWriter> call_;
+  ::grpc::ByteBuffer request_buf_;
+  ::grpc::ByteBuffer response_buf_;
+  ::grpc::Status grpc_status_;
+  State state_ = State::kStartCall;
+  Status status_;
+};
+
+// Sends a batch once its delay expires, unless it has already been sent.
+class BatchDelayTag : public GrpcClientCQTag {
+ public:
+  BatchDelayTag(std::function<void()> flush, ::grpc::CompletionQueue* cq,
+                int64 delay_micros)
+      : flush_(std::move(flush)),
+        alarm_(cq,
+               gpr_time_add(gpr_now(GPR_CLOCK_MONOTONIC),
+                            gpr_time_from_micros(delay_micros, GPR_TIMESPAN)),
+               this) {}
+
+  void OnCompleted(bool ok) override {
+    // `ok` is false if the completion queue is shutting down.
+    if (ok) {
+      flush_();
+    }
+    delete this;
+  }
+
+ private:
+  const std::function<void()> flush_;
+  ::grpc::Alarm alarm_;
+};
+
+}  // namespace
+
+GrpcRecvTensorBatcher::GrpcRecvTensorBatcher(SharedGrpcChannelPtr channel,
+                                             ::grpc::CompletionQueue* cq,
+                                             int max_batch_size,
+                                             int64 max_delay_micros)
+    : channel_(std::move(channel)),
+      stub_(channel_),
+      cq_(cq),
+      method_(GrpcWorkerMethodName(GrpcWorkerMethod::kRecvTensorBatch)),
+      max_batch_size_(max_batch_size),
+      max_delay_micros_(max_delay_micros) {}
+
+void GrpcRecvTensorBatcher::RecvTensorAsync(CallOptions* call_opts,
+                                            const RecvTensorRequest* request,
+                                            TensorResponse* response,
+                                            StatusCallback done) {
+  mutex_lock l(mu_);
+  if (!pending_.empty() &&
+      request_.request(0).step_id() != request->step_id()) {
+    FlushLocked();
+  }
+  *request_.add_request() = *request;
+  pending_.push_back({call_opts, response, std::move(done)});
+  if (static_cast<int>(pending_.size()) >= max_batch_size_) {
+    FlushLocked();
+  } else if (pending_.size() == 1) {
+    std::shared_ptr<GrpcRecvTensorBatcher> self = shared_from_this();
+    const int64 batch_id = batch_id_;
+    new BatchDelayTag([self, batch_id]() { self->Flush(batch_id); }, cq_,
+                      max_delay_micros_);
+  }
+}
+
+void GrpcRecvTensorBatcher::Flush(int64 batch_id) {
+  mutex_lock l(mu_);
+  if (batch_id == batch_id_) {
+    FlushLocked();
+  }
+}
+
+void GrpcRecvTensorBatcher::FlushLocked() {
+  if (pending_.empty()) return;
+  ++batch_id_;
+  new RecvTensorBatchCall(shared_from_this(), &stub_, cq_, method_, request_,
+                          std::move(pending_));
+  request_.Clear();
+  pending_.clear();
+}
+
+std::shared_ptr<GrpcRecvTensorBatcher> NewGrpcRecvTensorBatcher(
+    SharedGrpcChannelPtr channel, ::grpc::CompletionQueue* cq) {
+  int64 max_batch_size;
+  TF_CHECK_OK(ReadInt64FromEnvVar("TF_GRPC_RECV_TENSOR_BATCH_SIZE", 0,
+                                  &max_batch_size));
+  if (max_batch_size <= 1) {
+    return nullptr;
+  }
+  int64 max_delay_micros;
+  TF_CHECK_OK(ReadInt64FromEnvVar("TF_GRPC_RECV_TENSOR_BATCH_DELAY_MICROS",
+                                  100, &max_delay_micros));
+  return std::make_shared<GrpcRecvTensorBatcher>(
+      std::move(channel), cq, static_cast<int>(max_batch_size),
+      max_delay_micros);
+}
+
+}  // namespace tensorflow
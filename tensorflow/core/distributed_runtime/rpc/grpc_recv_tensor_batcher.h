@@ -0,0 +1,104 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_RECV_TENSOR_BATCHER_H_
+#define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_RECV_TENSOR_BATCHER_H_
+
+#include <memory>
+#include <vector>
+
+#include "grpc++/generic/generic_stub.h"
+
+#include "tensorflow/core/distributed_runtime/call_options.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
+#include "tensorflow/core/distributed_runtime/tensor_coding.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/protobuf/worker.pb.h"
+
+namespace grpc {
+class CompletionQueue;
+}  // namespace grpc
+
+namespace tensorflow {
+
+// Coalesces the RecvTensor calls of a step to one remote worker into
+// RecvTensorBatch calls, so that a graph with many small tensors on the edges
+// between two tasks does not pay the cost of an RPC for each of them.
+//
+// A batch is sent once it holds `max_batch_size` requests, `max_delay_micros`
+// after its first request, or when a request of another step arrives. Each
+// tensor of a batch is delivered as soon as the remote worker returns it, so
+// batching only delays the requests, by at most `max_delay_micros`.
+//
+// A batcher is shared by all the GrpcRemoteWorker objects of a target, which
+// are created for each call.
+class GrpcRecvTensorBatcher
+    : public std::enable_shared_from_this<GrpcRecvTensorBatcher> {
+ public:
+  GrpcRecvTensorBatcher(SharedGrpcChannelPtr channel,
+                        ::grpc::CompletionQueue* cq, int max_batch_size,
+                        int64 max_delay_micros);
+
+  // Like WorkerInterface::RecvTensorAsync. `response` must be on the host.
+  // `call_opts` takes effect once the batch of the request is sent, and
+  // cancels the whole batch.
+  void RecvTensorAsync(CallOptions* call_opts, const RecvTensorRequest* request,
+                       TensorResponse* response, StatusCallback done);
+
+  // A request waiting for its response.
+  struct PendingRecv {
+    CallOptions* call_opts;
+    TensorResponse* response;
+    StatusCallback done;
+  };
+
+ private:
+  // Sends the pending batch, if it is the `batch_id`-th batch.
+  void Flush(int64 batch_id);
+  void FlushLocked() EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  SharedGrpcChannelPtr channel_;
+  ::grpc::GenericStub stub_;
+  ::grpc::CompletionQueue* const cq_;  // Not owned.
+  const ::grpc::string method_;
+  const int max_batch_size_;
+  const int64 max_delay_micros_;
+
+  mutex mu_;
+  RecvTensorBatchRequest request_ GUARDED_BY(mu_);
+  std::vector<PendingRecv> pending_ GUARDED_BY(mu_);
+  // Sequence number of the pending batch, which identifies it when its delay
+  // expires.
+  int64 batch_id_ GUARDED_BY(mu_) = 0;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(GrpcRecvTensorBatcher);
+};
+
+// Returns a batcher for the calls to the worker at the end of `channel`, or
+// nullptr if batching is disabled, which is the default. Batching is enabled
+// by setting the environment variable TF_GRPC_RECV_TENSOR_BATCH_SIZE to the
+// maximum number of requests in a batch, greater than 1, and the maximum
+// delay of a request is set by TF_GRPC_RECV_TENSOR_BATCH_DELAY_MICROS.
+// Batching takes precedence over TF_GRPC_RECV_TENSOR_STREAM_CHUNK_BYTES.
+std::shared_ptr<GrpcRecvTensorBatcher> NewGrpcRecvTensorBatcher(
+    SharedGrpcChannelPtr channel, ::grpc::CompletionQueue* cq);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_RECV_TENSOR_BATCHER_H_
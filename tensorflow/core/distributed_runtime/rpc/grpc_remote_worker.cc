@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_remote_worker.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "grpc++/generic/generic_stub.h"
@@ -22,7 +23,9 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_client_cq_tag.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_recv_tensor_batcher.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_state.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_tensor_coding.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_worker_service_impl.h"
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
@@ -34,14 +37,152 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
+namespace {
+
+// Object allocated per active RecvTensorStream call. Reads the responses of
+// the stream one at a time: the first one into `response`, which allocates
+// the tensor, and the chunks of tensor content that may follow directly into
+// the buffer of that tensor. A response is only read after the previous one
+// has been copied, which applies the flow control of the transport to the
+// sender.
+class RecvTensorStreamState : public GrpcClientCQTag {
+ public:
+  RecvTensorStreamState(::grpc::GenericStub* stub, ::grpc::CompletionQueue* cq,
+                        const ::grpc::string& method,
+                        const RecvTensorRequest& request,
+                        TensorResponse* response, StatusCallback done,
+                        CallOptions* call_opts)
+      : call_opts_(call_opts),
+        chunk_bytes_(request.stream_chunk_bytes()),
+        response_(response),
+        done_(std::move(done)) {
+    if (call_opts) {
+      call_opts->SetCancelCallback([this]() { context_.TryCancel(); });
+    }
+    ::grpc::Status s = GrpcMaybeUnparseProto(request, &request_buf_);
+    if (!s.ok()) {
+      LOG(ERROR) << "GrpcMaybeUnparseProto returned with non-ok status: "
+                 << s.error_message();
+    }
+    call_ = stub->PrepareCall(&context_, method, cq);
+    call_->StartCall(this);
+  }
+
+  void OnCompleted(bool ok) override {
+    switch (state_) {
+      case State::kStartCall:
+        if (!ok) {
+          FinishCall();
+          return;
+        }
+        state_ = State::kWriteRequest;
+        call_->WriteLast(request_buf_, ::grpc::WriteOptions(), this);
+        return;
+      case State::kWriteRequest:
+        if (!ok) {
+          FinishCall();
+          return;
+        }
+        state_ = State::kRead;
+        call_->Read(&response_buf_, this);
+        return;
+      case State::kRead:
+        if (!ok) {
+          // The server has ended the stream.
+          FinishCall();
+          return;
+        }
+        status_ = ReadResponse();
+        response_buf_.Clear();
+        if (!status_.ok()) {
+          context_.TryCancel();
+          FinishCall();
+          return;
+        }
+        call_->Read(&response_buf_, this);
+        return;
+      case State::kFinish:
+        OnFinished();
+        return;
+    }
+  }
+
+ private:
+  enum class State { kStartCall, kWriteRequest, kRead, kFinish };
+
+  Status ReadResponse() {
+    if (num_responses_++ == 0) {
+      GrpcByteSource source(&response_buf_);
+      TF_RETURN_IF_ERROR(response_->ParseFrom(&source));
+      const Tensor& val = response_->tensor();
+      if (!response_->metadata().is_dead() &&
+          DataTypeCanUseMemcpy(val.dtype()) &&
+          static_cast<int64>(val.TotalBytes()) > chunk_bytes_) {
+        // The content of the tensor follows in chunks.
+        expected_bytes_ = val.TotalBytes();
+      }
+      return Status::OK();
+    }
+    int64 num_bytes = 0;
+    TF_RETURN_IF_ERROR(grpc::DecodeTensorChunkFromByteBuffer(
+        &response_buf_, response_->mutable_tensor(), &num_bytes));
+    received_bytes_ += num_bytes;
+    return Status::OK();
+  }
+
+  void FinishCall() {
+    state_ = State::kFinish;
+    call_->Finish(&grpc_status_, this);
+  }
+
+  void OnFinished() {
+    if (call_opts_) {
+      call_opts_->ClearCancelCallback();
+    }
+    Status s = status_.ok() ? FromGrpcStatus(grpc_status_) : status_;
+    if (s.ok() && num_responses_ == 0) {
+      s = errors::Internal("RecvTensorStream returned no response");
+    }
+    if (s.ok() && received_bytes_ != expected_bytes_) {
+      s = errors::Internal("RecvTensorStream returned ", received_bytes_,
+                           " bytes of tensor content instead of ",
+                           expected_bytes_);
+    }
+    if (!s.ok()) {
+      VLOG(2) << "Call returned with non-ok status: " << s;
+    }
+    done_(s);
+    delete this;
+  }
+
+  CallOptions* call_opts_;
+  const int64 chunk_bytes_;
+  TensorResponse* response_;
+  StatusCallback done_;
+  ::grpc::ClientContext context_;
+  std::unique_ptr<::grpc::GenericClientAsyncReaderWriter> call_;
+  ::grpc::ByteBuffer request_buf_;
+  ::grpc::ByteBuffer response_buf_;
+  ::grpc::Status grpc_status_;
+  State state_ = State::kStartCall;
+  Status status_;
+  int num_responses_ = 0;
+  int64 expected_bytes_ = 0;
+  int64 received_bytes_ = 0;
+};
+
+}  // namespace
+
 class GrpcRemoteWorker : public WorkerInterface {
  public:
-  explicit GrpcRemoteWorker(SharedGrpcChannelPtr channel,
-                            ::grpc::CompletionQueue* completion_queue,
-                            WorkerCacheLogger* logger)
+  explicit GrpcRemoteWorker(
+      SharedGrpcChannelPtr channel, ::grpc::CompletionQueue* completion_queue,
+      WorkerCacheLogger* logger,
+      std::shared_ptr<GrpcRecvTensorBatcher> recv_tensor_batcher)
       : channel_(std::move(channel)),
         stub_(channel_),
         cq_(completion_queue),
@@ -60,7 +201,18 @@ class GrpcRemoteWorker : public WorkerInterface {
         completegroup_(Method(GrpcWorkerMethod::kCompleteGroup)),
         instancesource_(Method(GrpcWorkerMethod::kCompleteInstance)),
         getstepsequence_(Method(GrpcWorkerMethod::kGetStepSequence)),
-        logger_(logger) {}
+        recvtensorstream_(Method(GrpcWorkerMethod::kRecvTensorStream)),
+        recv_tensor_batcher_(std::move(recv_tensor_batcher)),
+        logger_(logger) {
+    // If positive, the tensors received in host memory are fetched with the
+    // RecvTensorStream method, in chunks of at most this many bytes, so that
+    // tensors larger than the maximum gRPC message size can be received, and
+    // their content is copied as it arrives.
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_GRPC_RECV_TENSOR_STREAM_CHUNK_BYTES",
+                                    0, &recv_tensor_stream_chunk_bytes_));
+    recv_tensor_stream_chunk_bytes_ =
+        std::min<int64>(recv_tensor_stream_chunk_bytes_, 1 << 30);
+  }
 
   ~GrpcRemoteWorker() override {}
 
@@ -200,6 +352,18 @@ class GrpcRemoteWorker : public WorkerInterface {
       cb_to_use = &wrapper_done;
     }
 
+    if (recv_tensor_batcher_ && response->on_host()) {
+      recv_tensor_batcher_->RecvTensorAsync(call_opts, request, response,
+                                            *cb_to_use);
+      return;
+    }
+    if (recv_tensor_stream_chunk_bytes_ > 0 && response->on_host()) {
+      RecvTensorRequest stream_request(*request);
+      stream_request.set_stream_chunk_bytes(recv_tensor_stream_chunk_bytes_);
+      new RecvTensorStreamState(&stub_, cq_, recvtensorstream_, stream_request,
+                                response, *cb_to_use, call_opts);
+      return;
+    }
     IssueRequest(request, response, recvtensor_, *cb_to_use, call_opts);
   }
 
@@ -251,6 +415,11 @@ class GrpcRemoteWorker : public WorkerInterface {
   const ::grpc::string completegroup_;
   const ::grpc::string instancesource_;
   const ::grpc::string getstepsequence_;
+  const ::grpc::string recvtensorstream_;
+
+  int64 recv_tensor_stream_chunk_bytes_ = 0;
+  // Shared by all the workers of the same target, if not null.
+  std::shared_ptr<GrpcRecvTensorBatcher> recv_tensor_batcher_;
 
   // Support for logging.
   WorkerCacheLogger* logger_;
@@ -258,10 +427,12 @@ class GrpcRemoteWorker : public WorkerInterface {
   TF_DISALLOW_COPY_AND_ASSIGN(GrpcRemoteWorker);
 };
 
-WorkerInterface* NewGrpcRemoteWorker(SharedGrpcChannelPtr channel,
-                                     ::grpc::CompletionQueue* completion_queue,
-                                     WorkerCacheLogger* logger) {
-  return new GrpcRemoteWorker(std::move(channel), completion_queue, logger);
+WorkerInterface* NewGrpcRemoteWorker(
+    SharedGrpcChannelPtr channel, ::grpc::CompletionQueue* completion_queue,
+    WorkerCacheLogger* logger,
+    std::shared_ptr<GrpcRecvTensorBatcher> recv_tensor_batcher) {
+  return new GrpcRemoteWorker(std::move(channel), completion_queue, logger,
+                              std::move(recv_tensor_batcher));
 }
 
 }  // namespace tensorflow
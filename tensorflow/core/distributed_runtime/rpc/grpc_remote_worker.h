@@ -26,12 +26,16 @@ class CompletionQueue;
 
 namespace tensorflow {
 
+class GrpcRecvTensorBatcher;
 class WorkerCacheLogger;
 class WorkerInterface;
 
-WorkerInterface* NewGrpcRemoteWorker(SharedGrpcChannelPtr channel,
-                                     ::grpc::CompletionQueue* completion_queue,
-                                     WorkerCacheLogger* logger);
+// If `recv_tensor_batcher` is not null, the tensors received in host memory
+// are fetched through it.
+WorkerInterface* NewGrpcRemoteWorker(
+    SharedGrpcChannelPtr channel, ::grpc::CompletionQueue* completion_queue,
+    WorkerCacheLogger* logger,
+    std::shared_ptr<GrpcRecvTensorBatcher> recv_tensor_batcher = nullptr);
 
 }  // namespace tensorflow
 
@@ -17,13 +17,17 @@ limitations under the License.
 #include "grpc++/support/byte_buffer.h"
 #include "grpc++/support/slice.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
+#include "tensorflow/core/framework/bfloat16.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_reference.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/io/proto_encode_helper.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
 
 namespace tensorflow {
@@ -73,6 +77,18 @@ static int VarLengthEncodingSize(uint32 tag, size_t bytes) {
   return core::VarintLength(tag << 3) + core::VarintLength(bytes) + bytes;
 }
 
+// Returns a grpc::Slice pointing at "data", a part of the backing store of
+// "val", which keeps the backing store alive until the slice is released.
+static ::grpc::Slice SliceSharingBackingStore(const Tensor& val,
+                                              StringPiece data) {
+  const TensorBuffer* buf = DMAHelper::buffer(&val);
+  buf->Ref();
+  return ::grpc::Slice(
+      const_cast<void*>(static_cast<const void*>(data.data())), data.size(),
+      [](void* backing) { static_cast<TensorBuffer*>(backing)->Unref(); },
+      const_cast<TensorBuffer*>(buf));
+}
+
 // Returns an upper bound in bytes of the protocol buffer encoding of
 // the "skeleton" of "val" (all the data needed for dtype and the shape,
 // but not the actual contents of "val").
@@ -133,22 +149,20 @@ static void EncodeSkeleton(const Tensor& val, io::ProtoEncodeHelper* e) {
 #endif
 }
 
-void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
-                              ::grpc::ByteBuffer* result) {
+// Encodes "val" into "result" as the tensor of "*response", which holds all
+// the other fields of the RecvTensorResponse.
+static void EncodeTensorWithResponse(const Tensor& val,
+                                     RecvTensorResponse* response,
+                                     ::grpc::ByteBuffer* result) {
   const int kLargeTensorBytes = 1024;
-  RecvTensorResponse response;
-  if (is_dead) {
-    response.set_is_dead(is_dead);
-  }
-  response.set_send_start_micros(Env::Default()->NowMicros());
   if (!DataTypeCanUseMemcpy(val.dtype())) {
     // Straightforward but slow path for complicated kinds of tensor data
     // TODO(jeff,sanjay): If this becomes an issue, we could
     // go directly from val -> ByteBuffer, with some effort.
-    val.AsProtoTensorContent(response.mutable_tensor());
+    val.AsProtoTensorContent(response->mutable_tensor());
 
     // Encode full protocol buffer to a ByteBuffer
-    EncodeRecvTensorResponseToByteBuffer(response, result);
+    EncodeRecvTensorResponseToByteBuffer(*response, result);
   } else {
     // skeleton is the encoded TensorProto contents (dtype and shape), but
     // not the actual data
@@ -162,7 +176,7 @@ void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
          VarLengthEncodingSize(TensorProto::kTensorContentFieldNumber,
                                tdata.size()));
     string header;  // All of RecvTensorResponse except the tensor() field
-    response.AppendToString(&header);
+    response->AppendToString(&header);
 
     size_t expected_size =
         (header.size() +
@@ -214,13 +228,7 @@ void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
 
     if (tensor_data_is_large) {
       // (E) Encode tensor data, but by sharing backing store
-      const TensorBuffer* buf = DMAHelper::buffer(&val);
-      buf->Ref();
-      slices[1] = ::grpc::Slice(
-          const_cast<void*>(static_cast<const void*>(tdata.data())),
-          tdata.size(),
-          [](void* backing) { static_cast<TensorBuffer*>(backing)->Unref(); },
-          const_cast<TensorBuffer*>(buf));
+      slices[1] = SliceSharingBackingStore(val, tdata);
       num_slices += 1;
     }
     size_t total_bytes = 0;
@@ -234,5 +242,225 @@ void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
   }
 }
 
+void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
+                              ::grpc::ByteBuffer* result) {
+  RecvTensorResponse response;
+  if (is_dead) {
+    response.set_is_dead(is_dead);
+  }
+  response.set_send_start_micros(Env::Default()->NowMicros());
+  EncodeTensorWithResponse(val, &response, result);
+}
+
+void EncodeTensorToByteBufferWithCodec(bool is_dead, const Tensor& val,
+                                       RPCOptions::TensorCodec codec,
+                                       ::grpc::ByteBuffer* result) {
+  // Below this size, the codec saves too few bytes to be worth applying.
+  const size_t kMinCodecBytes = 1024;
+  if (is_dead || codec == RPCOptions::NO_CODEC ||
+      !DataTypeCanUseMemcpy(val.dtype()) || val.TotalBytes() < kMinCodecBytes) {
+    EncodeTensorToByteBuffer(is_dead, val, result);
+    return;
+  }
+  RecvTensorResponse response;
+  response.set_send_start_micros(Env::Default()->NowMicros());
+  switch (codec) {
+    case RPCOptions::SNAPPY: {
+      StringPiece tdata = val.tensor_data();
+      string* compressed = response.mutable_compressed_tensor_content();
+      if (port::Snappy_Compress(tdata.data(), tdata.size(), compressed) &&
+          compressed->size() < tdata.size()) {
+        response.set_tensor_codec(codec);
+        response.mutable_tensor()->set_dtype(val.dtype());
+        val.shape().AsProto(response.mutable_tensor()->mutable_tensor_shape());
+        EncodeRecvTensorResponseToByteBuffer(response, result);
+        return;
+      }
+      // Snappy is not available, or the content is not compressible.
+      response.clear_compressed_tensor_content();
+      break;
+    }
+    case RPCOptions::CAST_BFLOAT16: {
+      if (val.dtype() != DT_FLOAT) break;
+      Tensor cast(DT_BFLOAT16, val.shape());
+      auto src = val.flat<float>();
+      auto dst = cast.flat<bfloat16>();
+      for (int64 i = 0; i < src.size(); ++i) {
+        dst(i) = bfloat16::round_to_bfloat16(src(i));
+      }
+      response.set_tensor_codec(codec);
+      EncodeTensorWithResponse(cast, &response, result);
+      return;
+    }
+    case RPCOptions::CAST_HALF: {
+      if (val.dtype() != DT_FLOAT) break;
+      Tensor cast(DT_HALF, val.shape());
+      auto src = val.flat<float>();
+      auto dst = cast.flat<Eigen::half>();
+      for (int64 i = 0; i < src.size(); ++i) {
+        dst(i) = Eigen::half(src(i));
+      }
+      response.set_tensor_codec(codec);
+      EncodeTensorWithResponse(cast, &response, result);
+      return;
+    }
+    default:
+      break;
+  }
+  EncodeTensorWithResponse(val, &response, result);
+}
+
+void EncodeTensorMetadataToByteBuffer(bool is_dead, const Tensor& val,
+                                      ::grpc::ByteBuffer* result) {
+  RecvTensorResponse response;
+  if (is_dead) {
+    response.set_is_dead(is_dead);
+  }
+  response.set_send_start_micros(Env::Default()->NowMicros());
+  response.mutable_tensor()->set_dtype(val.dtype());
+  val.shape().AsProto(response.mutable_tensor()->mutable_tensor_shape());
+  EncodeRecvTensorResponseToByteBuffer(response, result);
+}
+
+// A chunk is encoded as follows:
+//
+// A:   <tag and varint encoding of R.tensor_content_offset()>
+// B:   <tag and varint32 length of R.tensor() sub message>
+// C:   <tag and varint32 length of R.tensor().tensor_content()>
+// D:   <the bytes of the chunk>
+//
+// As in EncodeTensorToByteBuffer, D shares the backing store of "val" if it
+// is large.
+void EncodeTensorChunkToByteBuffer(const Tensor& val, int64 offset, int64 size,
+                                   ::grpc::ByteBuffer* result) {
+  const int kLargeChunkBytes = 1024;
+  StringPiece tdata = val.tensor_data();
+  CHECK_LE(offset + size, tdata.size());
+  StringPiece chunk(tdata.data() + offset, size);
+
+  const uint32 tensor_bytes =
+      VarLengthEncodingSize(TensorProto::kTensorContentFieldNumber, size);
+  // Upper bound of the encoding of A, B and C.
+  char space[3 * (core::kMaxVarint32Bytes + core::kMaxVarint64Bytes)];
+  io::ProtoEncodeHelper e(space, sizeof(space));
+  e.WriteUint64(RecvTensorResponse::kTensorContentOffsetFieldNumber, offset);
+  e.WriteVarlengthBeginning(RecvTensorResponse::kTensorFieldNumber,
+                            tensor_bytes);
+  e.WriteVarlengthBeginning(TensorProto::kTensorContentFieldNumber, size);
+
+  const bool chunk_is_large = (chunk.size() > kLargeChunkBytes);
+  ::grpc::Slice slices[2];
+  int num_slices = 0;
+  slices[0] = ::grpc::Slice(e.size() + (chunk_is_large ? 0 : chunk.size()));
+  memcpy(const_cast<uint8_t*>(slices[0].begin()), e.data(), e.size());
+  if (!chunk_is_large) {
+    memcpy(const_cast<uint8_t*>(slices[0].begin()) + e.size(), chunk.data(),
+           chunk.size());
+  }
+  num_slices += 1;
+  if (chunk_is_large) {
+    slices[1] = SliceSharingBackingStore(val, chunk);
+    num_slices += 1;
+  }
+  ::grpc::ByteBuffer tmp(&slices[0], num_slices);
+  result->Swap(&tmp);
+}
+
+void PrependBatchIndexToByteBuffer(int32 batch_index,
+                                   ::grpc::ByteBuffer* result) {
+  // Fields may appear in any order in the encoding of a protocol buffer, so
+  // the index can simply precede the other fields.
+  char space[core::kMaxVarint32Bytes + core::kMaxVarint64Bytes];
+  io::ProtoEncodeHelper e(space, sizeof(space));
+  e.WriteUint64(RecvTensorResponse::kBatchIndexFieldNumber, batch_index);
+  std::vector<::grpc::Slice> slices(1, ::grpc::Slice(e.data(), e.size()));
+  std::vector<::grpc::Slice> rest;
+  (void)result->Dump(&rest);
+  slices.insert(slices.end(), rest.begin(), rest.end());
+  ::grpc::ByteBuffer tmp(slices.data(), slices.size());
+  result->Swap(&tmp);
+}
+
+namespace {
+
+enum WireType {
+  WIRETYPE_VARINT = 0,
+  WIRETYPE_LENGTH_DELIMITED = 2,
+};
+
+constexpr uint32 MakeTag(int field_number, WireType wire_type) {
+  return (static_cast<uint32>(field_number) << 3) | wire_type;
+}
+
+}  // namespace
+
+Status DecodeTensorChunkFromByteBuffer(::grpc::ByteBuffer* buffer, Tensor* val,
+                                       int64* num_bytes) {
+  StringPiece tdata = val->tensor_data();
+  GrpcByteSource source(buffer);
+  protobuf::io::CodedInputStream input(source.contents());
+  input.SetTotalBytesLimit(INT_MAX, INT_MAX);  // Unlimited
+
+  protobuf_uint64 offset = 0;
+  bool seen_content = false;
+  while (true) {
+    const uint32 tag = input.ReadTag();
+    if (tag == 0) {
+      break;
+    }
+    if (seen_content) {
+      return errors::Internal("Unexpected field after a tensor chunk");
+    }
+    if (tag == MakeTag(RecvTensorResponse::kTensorContentOffsetFieldNumber,
+                       WIRETYPE_VARINT)) {
+      if (!input.ReadVarint64(&offset)) {
+        return errors::Internal("Cannot parse tensor chunk offset");
+      }
+    } else if (tag == MakeTag(RecvTensorResponse::kTensorFieldNumber,
+                              WIRETYPE_LENGTH_DELIMITED)) {
+      uint32 tensor_bytes;
+      uint32 size;
+      if (!input.ReadVarint32(&tensor_bytes) ||
+          input.ReadTag() != MakeTag(TensorProto::kTensorContentFieldNumber,
+                                     WIRETYPE_LENGTH_DELIMITED) ||
+          !input.ReadVarint32(&size) ||
+          tensor_bytes != VarLengthEncodingSize(
+                              TensorProto::kTensorContentFieldNumber, size)) {
+        return errors::Internal("Cannot parse tensor chunk");
+      }
+      if (offset > tdata.size() || size > tdata.size() - offset) {
+        return errors::Internal("Tensor chunk of ", size, " bytes at offset ",
+                                offset, " overflows a tensor of ",
+                                tdata.size(), " bytes");
+      }
+      if (!input.ReadRaw(const_cast<char*>(tdata.data()) + offset, size)) {
+        return errors::Internal("Truncated tensor chunk");
+      }
+      *num_bytes = size;
+      seen_content = true;
+    } else {
+      return errors::Internal("Unexpected field in a tensor chunk");
+    }
+  }
+  if (!seen_content) {
+    return errors::Internal("Tensor chunk without content");
+  }
+  return Status::OK();
+}
+
+Status PeekBatchIndexFromByteBuffer(::grpc::ByteBuffer* buffer,
+                                    int32* batch_index) {
+  GrpcByteSource source(buffer);
+  protobuf::io::CodedInputStream input(source.contents());
+  uint32 v;
+  if (input.ReadTag() != MakeTag(RecvTensorResponse::kBatchIndexFieldNumber,
+                                 WIRETYPE_VARINT) ||
+      !input.ReadVarint32(&v)) {
+    return errors::Internal("RecvTensorBatch response without a batch index");
+  }
+  *batch_index = static_cast<int32>(v);
+  return Status::OK();
+}
+
 }  // namespace grpc
 }  // namespace tensorflow
@@ -16,6 +16,10 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_TENSOR_CODING_H_
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_TENSOR_CODING_H_
 
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+
 namespace grpc {
 class ByteBuffer;
 }  // namespace grpc
@@ -51,6 +55,51 @@ void EncodeRecvTensorResponseToByteBuffer(const RecvTensorResponse& proto,
 void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
                               ::grpc::ByteBuffer* result);
 
+// Like EncodeTensorToByteBuffer, but first applies "codec" to "val" as
+// described in RPCOptions::TensorCodec, and records it in
+// "RecvTensorResponse::tensor_codec". "val" is encoded unchanged if the codec
+// does not apply to it (e.g. because of its dtype, or because it is small).
+void EncodeTensorToByteBufferWithCodec(bool is_dead, const Tensor& val,
+                                       RPCOptions::TensorCodec codec,
+                                       ::grpc::ByteBuffer* result);
+
+// Encode the dtype and shape of a Tensor, but not its content, into a byte
+// buffer in a format that is parseable as a RecvTensorResponse protocol
+// buffer. This is the first response of a RecvTensorStream call whose tensor
+// content is sent in chunks.
+//
+// Discards original contents of *result.
+void EncodeTensorMetadataToByteBuffer(bool is_dead, const Tensor& val,
+                                      ::grpc::ByteBuffer* result);
+
+// Encode the "size" bytes of the content of "val" starting at "offset" into
+// a byte buffer in a format that is parseable as a RecvTensorResponse
+// protocol buffer holding them in "tensor.tensor_content", and "offset" in
+// "tensor_content_offset". Large chunks share the backing store of "val".
+//
+// Discards original contents of *result.
+void EncodeTensorChunkToByteBuffer(const Tensor& val, int64 offset, int64 size,
+                                   ::grpc::ByteBuffer* result);
+
+// Prepend "batch_index" to a RecvTensorResponse protocol buffer encoded in
+// "*result", as its "RecvTensorResponse::batch_index", without copying the
+// rest of the encoding. This is how the responses of a RecvTensorBatch call
+// are encoded.
+void PrependBatchIndexToByteBuffer(int32 batch_index,
+                                   ::grpc::ByteBuffer* result);
+
+// Decode the "batch_index" prepended by PrependBatchIndexToByteBuffer, which
+// identifies the request to which the response corresponds before it is
+// parsed. Leaves "*buffer" unchanged.
+Status PeekBatchIndexFromByteBuffer(::grpc::ByteBuffer* buffer,
+                                    int32* batch_index);
+
+// Decode a chunk encoded by EncodeTensorChunkToByteBuffer, copying its bytes
+// directly into the content of "*val", which must have the dtype and shape of
+// the sent tensor. Sets "*num_bytes" to the number of bytes copied.
+Status DecodeTensorChunkFromByteBuffer(::grpc::ByteBuffer* buffer, Tensor* val,
+                                       int64* num_bytes);
+
 }  // namespace grpc
 }  // namespace tensorflow
 
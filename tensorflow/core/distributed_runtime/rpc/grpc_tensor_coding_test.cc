@@ -15,10 +15,14 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_tensor_coding.h"
 
+#include <algorithm>
+
 #include "grpc++/support/byte_buffer.h"
 #include "grpc++/support/slice.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/test.h"
@@ -100,4 +104,138 @@ TEST_F(GrpcTensorCodingTest, Simple) {
 
 TEST_F(GrpcTensorCodingTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+TEST_F(GrpcTensorCodingTest, Codecs) {
+  Tensor large(DT_FLOAT, TensorShape({1000}));
+  test::FillFn<float>(&large, [](int i) { return i % 100 == 0 ? i : 0.0f; });
+  Tensor small(DT_FLOAT, TensorShape({10}));
+  test::FillIota<float>(&small, 1.0f);
+  Tensor ints(DT_INT32, TensorShape({1000}));
+  test::FillFn<int32>(&ints, [](int i) { return i; });
+
+  auto encode = [](const Tensor& val, RPCOptions::TensorCodec codec) {
+    ::grpc::ByteBuffer buf;
+    grpc::EncodeTensorToByteBufferWithCodec(false, val, codec, &buf);
+    std::vector<::grpc::Slice> slices;
+    (void)buf.Dump(&slices);
+    string tmp;
+    for (const auto& s : slices) {
+      tmp.append(reinterpret_cast<const char*>(s.begin()), s.size());
+    }
+    RecvTensorResponse response;
+    EXPECT_TRUE(response.ParseFromString(tmp));
+    return response;
+  };
+
+  RecvTensorResponse response = encode(large, RPCOptions::CAST_BFLOAT16);
+  EXPECT_EQ(RPCOptions::CAST_BFLOAT16, response.tensor_codec());
+  EXPECT_EQ(DT_BFLOAT16, response.tensor().dtype());
+  EXPECT_EQ(large.TotalBytes() / 2, response.tensor().tensor_content().size());
+
+  response = encode(large, RPCOptions::CAST_HALF);
+  EXPECT_EQ(RPCOptions::CAST_HALF, response.tensor_codec());
+  EXPECT_EQ(DT_HALF, response.tensor().dtype());
+
+  // Small tensors, and tensors of other dtypes, are sent unchanged.
+  response = encode(small, RPCOptions::CAST_BFLOAT16);
+  EXPECT_EQ(RPCOptions::NO_CODEC, response.tensor_codec());
+  EXPECT_EQ(DT_FLOAT, response.tensor().dtype());
+  response = encode(ints, RPCOptions::CAST_HALF);
+  EXPECT_EQ(RPCOptions::NO_CODEC, response.tensor_codec());
+  EXPECT_EQ(DT_INT32, response.tensor().dtype());
+
+  // Snappy only applies if it is available.
+  response = encode(large, RPCOptions::SNAPPY);
+  if (response.tensor_codec() == RPCOptions::SNAPPY) {
+    EXPECT_TRUE(response.tensor().tensor_content().empty());
+    EXPECT_LT(response.compressed_tensor_content().size(), large.TotalBytes());
+  } else {
+    EXPECT_EQ(RPCOptions::NO_CODEC, response.tensor_codec());
+    EXPECT_EQ(large.tensor_data(), response.tensor().tensor_content());
+  }
+}
+
+TEST_F(GrpcTensorCodingTest, Chunks) {
+  Tensor src(DT_FLOAT, TensorShape({100, 37}));
+  test::FillIota<float>(&src, 1.0f);
+
+  // The metadata carries the dtype and shape, but no content.
+  ::grpc::ByteBuffer buf;
+  grpc::EncodeTensorMetadataToByteBuffer(false, src, &buf);
+  std::vector<::grpc::Slice> slices;
+  (void)buf.Dump(&slices);
+  string tmp;
+  for (const auto& s : slices) {
+    tmp.append(reinterpret_cast<const char*>(s.begin()), s.size());
+  }
+  RecvTensorResponse response;
+  ASSERT_TRUE(response.ParseFromString(tmp));
+  EXPECT_FALSE(response.is_dead());
+  EXPECT_EQ(DT_FLOAT, response.tensor().dtype());
+  EXPECT_EQ(src.shape().DebugString(),
+            TensorShape(response.tensor().tensor_shape()).DebugString());
+  EXPECT_TRUE(response.tensor().tensor_content().empty());
+
+  // Chunks both below and above the zero-copy threshold are copied into
+  // place, in any order.
+  const int64 total = src.TotalBytes();
+  for (int64 chunk : {int64{1}, int64{1000}, int64{4096}, total}) {
+    Tensor dst(DT_FLOAT, src.shape());
+    test::FillFn<float>(&dst, [](int) { return 0.0f; });
+    int64 received = 0;
+    for (int64 offset = ((total - 1) / chunk) * chunk; offset >= 0;
+         offset -= chunk) {
+      const int64 size = std::min(chunk, total - offset);
+      ::grpc::ByteBuffer chunk_buf;
+      grpc::EncodeTensorChunkToByteBuffer(src, offset, size, &chunk_buf);
+      int64 num_bytes = 0;
+      TF_ASSERT_OK(
+          grpc::DecodeTensorChunkFromByteBuffer(&chunk_buf, &dst, &num_bytes));
+      EXPECT_EQ(size, num_bytes);
+      received += num_bytes;
+    }
+    EXPECT_EQ(total, received);
+    test::ExpectTensorEqual<float>(src, dst);
+  }
+}
+
+TEST_F(GrpcTensorCodingTest, ChunkOutOfBounds) {
+  Tensor src(DT_INT32, TensorShape({10}));
+  test::FillIota<int32>(&src, 0);
+  Tensor dst(DT_INT32, TensorShape({5}));
+  ::grpc::ByteBuffer buf;
+  grpc::EncodeTensorChunkToByteBuffer(src, 16, 8, &buf);
+  int64 num_bytes = 0;
+  EXPECT_FALSE(
+      grpc::DecodeTensorChunkFromByteBuffer(&buf, &dst, &num_bytes).ok());
+}
+
+TEST_F(GrpcTensorCodingTest, BatchIndex) {
+  Tensor small(DT_INT32, TensorShape({3}));
+  test::FillIota<int32>(&small, 0);
+  Tensor large(DT_FLOAT, TensorShape({1000}));
+  test::FillIota<float>(&large, 1.0f);
+  for (const Tensor& val : {small, large}) {
+    ::grpc::ByteBuffer buf;
+    grpc::EncodeTensorToByteBuffer(false, val, &buf);
+    int32 index = -1;
+    EXPECT_FALSE(grpc::PeekBatchIndexFromByteBuffer(&buf, &index).ok());
+
+    grpc::PrependBatchIndexToByteBuffer(300, &buf);
+    TF_ASSERT_OK(grpc::PeekBatchIndexFromByteBuffer(&buf, &index));
+    EXPECT_EQ(300, index);
+
+    // The rest of the encoding is unchanged.
+    std::vector<::grpc::Slice> slices;
+    (void)buf.Dump(&slices);
+    string tmp;
+    for (const auto& s : slices) {
+      tmp.append(reinterpret_cast<const char*>(s.begin()), s.size());
+    }
+    RecvTensorResponse response;
+    ASSERT_TRUE(response.ParseFromString(tmp));
+    EXPECT_EQ(300, response.batch_index());
+    EXPECT_EQ(val.tensor_data(), response.tensor().tensor_content());
+  }
+}
+
 }  // namespace tensorflow
@@ -14,7 +14,12 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
+
+#include <algorithm>
+
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
+#include "tensorflow/core/platform/numa.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -62,4 +67,51 @@ bool GrpcMaybeParseProto(grpc::ByteBuffer* src, string* dst) {
   return true;
 }
 
+const GrpcPollingOptions& GetGrpcPollingOptions() {
+  static const GrpcPollingOptions* options = []() {
+    GrpcPollingOptions* options = new GrpcPollingOptions;
+    int64 num_threads;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_GRPC_WORKER_SERVICE_THREADS",
+                                    options->num_server_threads,
+                                    &num_threads));
+    options->num_server_threads = std::max<int64>(num_threads, 1);
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_GRPC_WORKER_CACHE_THREADS",
+                                    options->num_client_threads,
+                                    &num_threads));
+    options->num_client_threads = std::max<int64>(num_threads, 1);
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GRPC_BUSY_POLL", false,
+                                   &options->busy_poll));
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GRPC_NUMA_AFFINITY", false,
+                                   &options->numa_affinity));
+    return options;
+  }();
+  return *options;
+}
+
+int GrpcPollingThreadNUMANode(int index) {
+  if (!GetGrpcPollingOptions().numa_affinity || !port::NUMAEnabled()) {
+    return port::kNUMANoAffinity;
+  }
+  return index % port::NUMANumNodes();
+}
+
+bool GrpcCompletionQueueNext(::grpc::CompletionQueue* cq, bool busy_poll,
+                             void** tag, bool* ok) {
+  if (!busy_poll) {
+    return cq->Next(tag, ok);
+  }
+  // A deadline in the past makes AsyncNext() return without blocking.
+  const gpr_timespec deadline = gpr_inf_past(GPR_CLOCK_MONOTONIC);
+  while (true) {
+    switch (cq->AsyncNext(tag, ok, deadline)) {
+      case ::grpc::CompletionQueue::GOT_EVENT:
+        return true;
+      case ::grpc::CompletionQueue::SHUTDOWN:
+        return false;
+      case ::grpc::CompletionQueue::TIMEOUT:
+        break;
+    }
+  }
+}
+
 }  // namespace tensorflow
@@ -122,6 +122,37 @@ bool GrpcMaybeParseProto(::grpc::ByteBuffer* src, TensorResponse* dst);
 // Copy grpc buffer src to string *dst.
 bool GrpcMaybeParseProto(::grpc::ByteBuffer* src, string* dst);
 
+// Options of the threads that poll the gRPC completion queues of the worker
+// service, on the server side, and of the worker cache, on the client side.
+// Each thread polls its own completion queue.
+struct GrpcPollingOptions {
+  // Number of threads of the worker service.
+  int num_server_threads = 8;
+  // Number of threads of the worker cache, over which the remote workers are
+  // sharded by target.
+  int num_client_threads = 8;
+  // If true, the threads spin on their completion queue instead of blocking
+  // on it, which lowers the latency of each event at the cost of keeping a
+  // core busy per thread.
+  bool busy_poll = false;
+  // If true, the threads are spread round-robin over the NUMA nodes, and
+  // restricted to the cores of their node.
+  bool numa_affinity = false;
+};
+
+// Returns the options set by the environment variables
+// TF_GRPC_WORKER_SERVICE_THREADS, TF_GRPC_WORKER_CACHE_THREADS,
+// TF_GRPC_BUSY_POLL and TF_GRPC_NUMA_AFFINITY, read once.
+const GrpcPollingOptions& GetGrpcPollingOptions();
+
+// Returns the NUMA node of the `index`-th polling thread of a kind, or
+// port::kNUMANoAffinity.
+int GrpcPollingThreadNUMANode(int index);
+
+// Like cq->Next(), but spins until the next event if `busy_poll`.
+bool GrpcCompletionQueueNext(::grpc::CompletionQueue* cq, bool busy_poll,
+                             void** tag, bool* ok);
+
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_UTIL_H_
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
+#include "grpc++/alarm.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
@@ -193,4 +194,20 @@ static void BM_ParseString(int iters, int size) {
 }
 BENCHMARK(BM_ParseString)->Arg(1)->Arg(1 << 10)->Arg(1 << 20);
 
+TEST(GrpcCompletionQueueNext, BlockingAndBusyPoll) {
+  for (bool busy_poll : {false, true}) {
+    ::grpc::CompletionQueue cq;
+    int tag_value = 0;
+    // An alarm in the past fires right away.
+    ::grpc::Alarm alarm(&cq, gpr_inf_past(GPR_CLOCK_MONOTONIC), &tag_value);
+    void* tag = nullptr;
+    bool ok = false;
+    ASSERT_TRUE(GrpcCompletionQueueNext(&cq, busy_poll, &tag, &ok));
+    EXPECT_EQ(&tag_value, tag);
+    EXPECT_TRUE(ok);
+    cq.Shutdown();
+    EXPECT_FALSE(GrpcCompletionQueueNext(&cq, busy_poll, &tag, &ok));
+  }
+}
+
 }  // namespace tensorflow
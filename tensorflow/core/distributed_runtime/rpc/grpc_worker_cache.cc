@@ -19,6 +19,7 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_channel.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_client_cq_tag.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_recv_tensor_batcher.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_remote_worker.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
 #include "tensorflow/core/distributed_runtime/worker_cache_logger.h"
@@ -26,6 +27,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/worker_interface.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numa.h"
 
 namespace tensorflow {
 
@@ -33,17 +35,19 @@ namespace {
 
 class GrpcWorkerCache : public WorkerCachePartial {
  public:
-  // TODO(ncteisen): consider adding a config var or flag for this
-  static constexpr const size_t kGrpcWorkerCacheThreadCount = 8;
-
   explicit GrpcWorkerCache(std::shared_ptr<GrpcChannelCache> channel_cache,
                            WorkerInterface* local_worker,
                            const string& local_target)
       : local_target_(local_target),
         local_worker_(local_worker),
         channel_cache_(channel_cache),
-        threads_(kGrpcWorkerCacheThreadCount),
-        next_round_robin_assignment_(0) {}
+        next_round_robin_assignment_(0) {
+    const GrpcPollingOptions& options = GetGrpcPollingOptions();
+    for (int i = 0; i < options.num_client_threads; ++i) {
+      threads_.emplace_back(new GrpcWorkerCacheThread(
+          GrpcPollingThreadNUMANode(i), options.busy_poll));
+    }
+  }
 
   // Explicit destructor to control destruction order.
   ~GrpcWorkerCache() override {
@@ -60,9 +64,10 @@ class GrpcWorkerCache : public WorkerCachePartial {
     } else {
       SharedGrpcChannelPtr channel = channel_cache_->FindWorkerChannel(target);
       if (!channel) return nullptr;
-      return NewGrpcRemoteWorker(
-          channel, threads_[AssignWorkerToThread(target)].completion_queue(),
-          &logger_);
+      ::grpc::CompletionQueue* cq =
+          threads_[AssignWorkerToThread(target)]->completion_queue();
+      return NewGrpcRemoteWorker(channel, cq, &logger_,
+                                 FindOrCreateBatcher(target, channel, cq));
     }
   }
 
@@ -88,12 +93,16 @@ class GrpcWorkerCache : public WorkerCachePartial {
   // CompletionQueue.
   class GrpcWorkerCacheThread {
    public:
-    GrpcWorkerCacheThread() {
+    GrpcWorkerCacheThread(int numa_node, bool busy_poll) {
+      ThreadOptions thread_options;
+      thread_options.numa_node = numa_node;
       thread_.reset(Env::Default()->StartThread(
-          ThreadOptions(), "grpc_worker_cache", [this]() {
+          thread_options, "grpc_worker_cache", [this, numa_node, busy_poll]() {
+            port::NUMASetThreadNodeAffinity(numa_node);
             void* tag;
             bool ok;
-            while (completion_queue_.Next(&tag, &ok)) {
+            while (GrpcCompletionQueueNext(&completion_queue_, busy_poll, &tag,
+                                           &ok)) {
               GrpcClientCQTag* callback_tag =
                   static_cast<GrpcClientCQTag*>(tag);
               callback_tag->OnCompleted(ok);
@@ -127,16 +136,34 @@ class GrpcWorkerCache : public WorkerCachePartial {
     return it->second;
   }
 
+  // Returns the RecvTensor batcher shared by the workers of `target`, or
+  // nullptr if batching is disabled.
+  std::shared_ptr<GrpcRecvTensorBatcher> FindOrCreateBatcher(
+      const string& target, const SharedGrpcChannelPtr& channel,
+      ::grpc::CompletionQueue* cq) {
+    mutex_lock lock(batchers_mu_);
+    auto it = batchers_.find(target);
+    if (it == batchers_.end()) {
+      it = batchers_.emplace(target, NewGrpcRecvTensorBatcher(channel, cq))
+               .first;
+    }
+    return it->second;
+  }
+
   const string local_target_;
   WorkerInterface* const local_worker_;  // Not owned.
   std::shared_ptr<GrpcChannelCache> channel_cache_;
   WorkerCacheLogger logger_;
-  std::vector<GrpcWorkerCacheThread> threads_;
+  std::vector<std::unique_ptr<GrpcWorkerCacheThread>> threads_;
 
   mutex assignment_mu_;
   std::unordered_map<std::string, size_t> target_assignments_
       GUARDED_BY(assignment_mu_);
   size_t next_round_robin_assignment_ GUARDED_BY(assignment_mu_);
+
+  mutex batchers_mu_;
+  std::unordered_map<string, std::shared_ptr<GrpcRecvTensorBatcher>> batchers_
+      GUARDED_BY(batchers_mu_);
 };
 
 }  // namespace
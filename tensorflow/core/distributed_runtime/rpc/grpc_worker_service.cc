@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_worker_service.h"
 
+#include <algorithm>
 #include <deque>
 
 #include "grpc++/alarm.h"
@@ -42,6 +43,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/protobuf/transport_options.pb.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
@@ -51,16 +53,17 @@ namespace tensorflow {
 namespace {
 
 class GrpcWorkerService : public AsyncServiceInterface {
-  // TODO(ncteisen): consider adding a config var or flag for this
-  static constexpr const size_t kGrpcWorkerServiceThreadCount = 8;
-
  public:
   GrpcWorkerService(GrpcWorker* worker, ::grpc::ServerBuilder* builder)
       : is_shutdown_(false) {
     builder->RegisterService(&worker_service_);
-    for (int i = 0; i < kGrpcWorkerServiceThreadCount; i++) {
-      threads_.emplace_back(
-          new GrpcWorkerServiceThread(worker, builder, &worker_service_));
+    // gRPC spreads the incoming calls over the completion queues on which
+    // they are requested, so each thread handles a share of all the peers.
+    const GrpcPollingOptions& options = GetGrpcPollingOptions();
+    for (int i = 0; i < options.num_server_threads; i++) {
+      threads_.emplace_back(new GrpcWorkerServiceThread(
+          worker, builder, &worker_service_, GrpcPollingThreadNUMANode(i),
+          options.busy_poll));
     }
   }
 
@@ -122,17 +125,24 @@ class GrpcWorkerService : public AsyncServiceInterface {
    public:
     explicit GrpcWorkerServiceThread(
         GrpcWorker* worker, ::grpc::ServerBuilder* builder,
-        grpc::WorkerService::AsyncService* worker_service)
+        grpc::WorkerService::AsyncService* worker_service, int numa_node,
+        bool busy_poll)
         : worker_(worker),
           worker_service_(worker_service),
+          numa_node_(numa_node),
+          busy_poll_(busy_poll),
           is_shutdown_(false) {
       cq_ = builder->AddCompletionQueue();
     }
 
     void Start() {
+      ThreadOptions thread_options;
+      thread_options.numa_node = numa_node_;
       thread_.reset(worker_->env()->env->StartThread(
-          ThreadOptions(), "grpc_worker_service",
-          [this]() { HandleRPCsLoop(); }));
+          thread_options, "grpc_worker_service", [this]() {
+            port::NUMASetThreadNodeAffinity(numa_node_);
+            HandleRPCsLoop();
+          }));
     }
 
     void Join() { thread_.reset(); }  // Blocks until thread exits
@@ -162,6 +172,12 @@ class GrpcWorkerService : public AsyncServiceInterface {
       for (int i = 0; i < 1000; ++i) {
         EnqueueRecvTensorRequestRaw();
       }
+      for (int i = 0; i < 100; ++i) {
+        EnqueueRecvTensorStreamRequest();
+      }
+      for (int i = 0; i < 100; ++i) {
+        EnqueueRecvTensorBatchRequest();
+      }
       for (int i = 0; i < 500; ++i) {
         ENQUEUE_REQUEST(RecvBuf, true);
       }
@@ -184,7 +200,7 @@ class GrpcWorkerService : public AsyncServiceInterface {
       void* tag;
       bool ok;
 
-      while (cq_->Next(&tag, &ok)) {
+      while (GrpcCompletionQueueNext(cq_.get(), busy_poll_, &tag, &ok)) {
         UntypedCall<GrpcWorkerServiceThread>::Tag* callback_tag =
             static_cast<UntypedCall<GrpcWorkerServiceThread>::Tag*>(tag);
         CHECK(callback_tag);
@@ -303,6 +319,54 @@ class GrpcWorkerService : public AsyncServiceInterface {
       EnqueueRecvTensorRequestRaw();
     }
 
+    void RecvTensorStreamHandler(
+        ServerStreamingCall<GrpcWorkerServiceThread,
+                            grpc::WorkerService::AsyncService,
+                            RecvTensorRequest, ::grpc::ByteBuffer>* call) {
+      Schedule([this, call]() {
+        CallOptions* call_opts = new CallOptions;
+        call->SetCancelCallback([call_opts]() { call_opts->StartCancel(); });
+        worker_->GrpcRecvTensorStreamAsync(
+            call_opts, &call->request,
+            [call](::grpc::ByteBuffer* response, StatusCallback done) {
+              call->Write(*response, [done](bool ok) {
+                done(ok ? Status::OK()
+                        : errors::Aborted("RecvTensorStream call was broken"));
+              });
+            },
+            [call, call_opts](const Status& s) {
+              call->ClearCancelCallback();
+              delete call_opts;
+              call->Finish(ToGrpcStatus(s));
+            });
+      });
+      EnqueueRecvTensorStreamRequest();
+    }
+
+    void RecvTensorBatchHandler(
+        ServerStreamingCall<GrpcWorkerServiceThread,
+                            grpc::WorkerService::AsyncService,
+                            RecvTensorBatchRequest, ::grpc::ByteBuffer>* call) {
+      Schedule([this, call]() {
+        CallOptions* call_opts = new CallOptions;
+        call->SetCancelCallback([call_opts]() { call_opts->StartCancel(); });
+        worker_->GrpcRecvTensorBatchAsync(
+            call_opts, &call->request,
+            [call](::grpc::ByteBuffer* response, StatusCallback done) {
+              call->Write(*response, [done](bool ok) {
+                done(ok ? Status::OK()
+                        : errors::Aborted("RecvTensorBatch call was broken"));
+              });
+            },
+            [call, call_opts](const Status& s) {
+              call->ClearCancelCallback();
+              delete call_opts;
+              call->Finish(ToGrpcStatus(s));
+            });
+      });
+      EnqueueRecvTensorBatchRequest();
+    }
+
     void CleanupGraphHandler(
         WorkerCall<CleanupGraphRequest, CleanupGraphResponse>* call) {
       Schedule([this, call]() {
@@ -397,10 +461,40 @@ class GrpcWorkerService : public AsyncServiceInterface {
       }
     }
 
+    void EnqueueRecvTensorStreamRequest() {
+      mutex_lock l(shutdown_mu_);
+      if (!is_shutdown_) {
+        ServerStreamingCall<GrpcWorkerServiceThread,
+                            grpc::WorkerService::AsyncService,
+                            RecvTensorRequest, ::grpc::ByteBuffer>::
+            EnqueueRequestForMethod(
+                worker_service_, cq_.get(),
+                static_cast<int>(GrpcWorkerMethod::kRecvTensorStream),
+                &GrpcWorkerServiceThread::RecvTensorStreamHandler,
+                true /* supports cancel*/);
+      }
+    }
+
+    void EnqueueRecvTensorBatchRequest() {
+      mutex_lock l(shutdown_mu_);
+      if (!is_shutdown_) {
+        ServerStreamingCall<GrpcWorkerServiceThread,
+                            grpc::WorkerService::AsyncService,
+                            RecvTensorBatchRequest, ::grpc::ByteBuffer>::
+            EnqueueRequestForMethod(
+                worker_service_, cq_.get(),
+                static_cast<int>(GrpcWorkerMethod::kRecvTensorBatch),
+                &GrpcWorkerServiceThread::RecvTensorBatchHandler,
+                true /* supports cancel*/);
+      }
+    }
+
     GrpcWorker* const worker_ = nullptr;  // Not owned.
     std::unique_ptr<::grpc::ServerCompletionQueue> cq_;
     std::unique_ptr<Thread> thread_;
     grpc::WorkerService::AsyncService* const worker_service_;
+    const int numa_node_;
+    const bool busy_poll_;
 
     mutex shutdown_mu_;
     bool is_shutdown_ GUARDED_BY(shutdown_mu_);
@@ -428,10 +522,246 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
                                      const RecvTensorRequest* request,
                                      ::grpc::ByteBuffer* response,
                                      StatusCallback done) {
+  const RPCOptions::TensorCodec codec = request->tensor_codec();
+  RecvHostTensorAsync(opts, request,
+                      [codec, response, done](const Status& s, bool is_dead,
+                                              const Tensor& val) {
+                        if (s.ok()) {
+                          // The value is now ready to be returned on the wire.
+                          grpc::EncodeTensorToByteBufferWithCodec(
+                              is_dead, val, codec, response);
+                        }
+                        done(s);
+                      });
+}
+
+namespace {
+
+// Default and maximum number of bytes of tensor content in each message of a
+// RecvTensorStream response.
+constexpr int64 kDefaultStreamChunkBytes = 4 << 20;
+constexpr int64 kMaxStreamChunkBytes = 1 << 30;
+
+// Sends the content of a tensor in chunks on a RecvTensorStream response,
+// writing each chunk once the previous one has been sent, and deletes itself
+// when done.
+class TensorChunkSender {
+ public:
+  TensorChunkSender(const Tensor& val, int64 chunk_bytes,
+                    GrpcWorker::StreamWriter write, StatusCallback done)
+      : val_(val),
+        chunk_bytes_(chunk_bytes),
+        write_(std::move(write)),
+        done_(std::move(done)) {}
+
+  // Writes `first` (the metadata of the tensor), then its content.
+  void Start(::grpc::ByteBuffer* first) {
+    write_(first, [this](const Status& s) { OnWritten(s); });
+  }
+
+ private:
+  void OnWritten(const Status& s) {
+    const int64 total_bytes = val_.tensor_data().size();
+    if (!s.ok() || offset_ == total_bytes) {
+      done_(s);
+      delete this;
+      return;
+    }
+    const int64 size = std::min(chunk_bytes_, total_bytes - offset_);
+    ::grpc::ByteBuffer chunk;
+    grpc::EncodeTensorChunkToByteBuffer(val_, offset_, size, &chunk);
+    offset_ += size;
+    write_(&chunk, [this](const Status& status) { OnWritten(status); });
+  }
+
+  const Tensor val_;
+  const int64 chunk_bytes_;
+  const GrpcWorker::StreamWriter write_;
+  const StatusCallback done_;
+  int64 offset_ = 0;
+};
+
+}  // namespace
+
+void GrpcWorker::GrpcRecvTensorStreamAsync(CallOptions* opts,
+                                           const RecvTensorRequest* request,
+                                           StreamWriter write,
+                                           StatusCallback done) {
+  int64 chunk_bytes = request->stream_chunk_bytes();
+  if (chunk_bytes <= 0) {
+    chunk_bytes = kDefaultStreamChunkBytes;
+  }
+  chunk_bytes = std::min(chunk_bytes, kMaxStreamChunkBytes);
+  RecvHostTensorAsync(
+      opts, request,
+      [write, done, chunk_bytes](const Status& s, bool is_dead,
+                                 const Tensor& val) {
+        if (!s.ok()) {
+          done(s);
+          return;
+        }
+        ::grpc::ByteBuffer first;
+        if (is_dead || !DataTypeCanUseMemcpy(val.dtype()) ||
+            static_cast<int64>(val.TotalBytes()) <= chunk_bytes) {
+          // The whole tensor fits in a single response.
+          grpc::EncodeTensorToByteBuffer(is_dead, val, &first);
+          write(&first, done);
+          return;
+        }
+        grpc::EncodeTensorMetadataToByteBuffer(is_dead, val, &first);
+        (new TensorChunkSender(val, chunk_bytes, write, done))->Start(&first);
+      });
+}
+
+namespace {
+
+// Serves a RecvTensorBatch call: receives the tensors of all its requests
+// concurrently, each with its own CallOptions, and writes them in the order in
+// which they become available, one at a time. Deletes itself once all the
+// requests are done and the responses are written.
+class RecvTensorBatchState {
+ public:
+  RecvTensorBatchState(CallOptions* opts, int num_requests,
+                       GrpcWorker::StreamWriter write, StatusCallback done)
+      : opts_(opts),
+        write_(std::move(write)),
+        done_(std::move(done)),
+        num_pending_(num_requests) {
+    for (int i = 0; i < num_requests; ++i) {
+      request_opts_.emplace_back(new CallOptions);
+    }
+    opts_->SetCancelCallback([this]() { CancelAll(); });
+  }
+
+  CallOptions* request_opts(int i) { return request_opts_[i].get(); }
+
+  // Called when the tensor of request `index` is on the host.
+  void OnReceived(int index, RPCOptions::TensorCodec codec, const Status& s,
+                  bool is_dead, const Tensor& val) {
+    if (!s.ok()) {
+      bool first_error;
+      {
+        mutex_lock l(mu_);
+        first_error = status_.ok();
+        status_.Update(s);
+      }
+      // The other tensors would not be returned, so stop waiting for them.
+      if (first_error) CancelAll();
+      OnDone(1);
+      return;
+    }
+    std::unique_ptr<::grpc::ByteBuffer> response(new ::grpc::ByteBuffer);
+    grpc::EncodeTensorToByteBufferWithCodec(is_dead, val, codec,
+                                            response.get());
+    grpc::PrependBatchIndexToByteBuffer(index, response.get());
+    {
+      mutex_lock l(mu_);
+      if (status_.ok()) {
+        pending_writes_.push_back(std::move(response));
+      }
+    }
+    if (response) {
+      // The call has failed, and this response is dropped.
+      OnDone(1);
+      return;
+    }
+    MaybeWrite();
+  }
+
+ private:
+  // Writes the first of `pending_writes_`, unless a write is in flight.
+  void MaybeWrite() {
+    std::unique_ptr<::grpc::ByteBuffer> response;
+    {
+      mutex_lock l(mu_);
+      if (writing_ || pending_writes_.empty()) return;
+      writing_ = true;
+      response = std::move(pending_writes_.front());
+      pending_writes_.pop_front();
+    }
+    write_(response.get(), [this](const Status& s) { OnWritten(s); });
+  }
+
+  // The request whose response has been written is done, as are those whose
+  // responses are dropped if the write failed.
+  void OnWritten(const Status& s) {
+    int num_done = 1;
+    {
+      mutex_lock l(mu_);
+      writing_ = false;
+      status_.Update(s);
+      if (!status_.ok()) {
+        num_done += pending_writes_.size();
+        pending_writes_.clear();
+      }
+    }
+    MaybeWrite();
+    OnDone(num_done);
+  }
+
+  void CancelAll() {
+    for (auto& opts : request_opts_) {
+      opts->StartCancel();
+    }
+  }
+
+  // Called when `num_done` more requests are done.
+  void OnDone(int num_done) {
+    Status s;
+    {
+      mutex_lock l(mu_);
+      num_pending_ -= num_done;
+      if (num_pending_ > 0) return;
+      s = status_;
+    }
+    opts_->ClearCancelCallback();
+    done_(s);
+    delete this;
+  }
+
+  CallOptions* const opts_;  // Not owned.
+  std::vector<std::unique_ptr<CallOptions>> request_opts_;
+  const GrpcWorker::StreamWriter write_;
+  const StatusCallback done_;
+
+  mutex mu_;
+  Status status_ GUARDED_BY(mu_);
+  int num_pending_ GUARDED_BY(mu_);
+  std::deque<std::unique_ptr<::grpc::ByteBuffer>> pending_writes_
+      GUARDED_BY(mu_);
+  bool writing_ GUARDED_BY(mu_) = false;
+};
+
+}  // namespace
+
+void GrpcWorker::GrpcRecvTensorBatchAsync(CallOptions* opts,
+                                          const RecvTensorBatchRequest* request,
+                                          StreamWriter write,
+                                          StatusCallback done) {
+  const int num_requests = request->request_size();
+  if (num_requests == 0) {
+    done(Status::OK());
+    return;
+  }
+  RecvTensorBatchState* state =
+      new RecvTensorBatchState(opts, num_requests, write, done);
+  for (int i = 0; i < num_requests; ++i) {
+    const RPCOptions::TensorCodec codec = request->request(i).tensor_codec();
+    RecvHostTensorAsync(
+        state->request_opts(i), &request->request(i),
+        [state, i, codec](const Status& s, bool is_dead, const Tensor& val) {
+          state->OnReceived(i, codec, s, is_dead, val);
+        });
+  }
+}
+
+void GrpcWorker::RecvHostTensorAsync(CallOptions* opts,
+                                     const RecvTensorRequest* request,
+                                     HostTensorCallback done) {
   Status s = recv_tensor_recent_request_ids_.TrackUnique(
       request->request_id(), "RecvTensor (GrpcWorker)", *request);
   if (!s.ok()) {
-    done(s);
+    done(s, false, Tensor());
     return;
   }
 
@@ -445,10 +775,22 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
     s = PrepareRecvTensor(parsed, &src_dev);
   }
   if (!s.ok()) {
-    done(s);
+    done(s, false, Tensor());
     return;
   }
 
+  // Records the load served for the edge once the tensor is on the host.
+  const int64 start_micros = Env::Default()->NowMicros();
+  const string edge_name = parsed.edge_name.ToString();
+  done = [this, edge_name, start_micros, done](const Status& s, bool is_dead,
+                                               const Tensor& val) {
+    if (s.ok()) {
+      recv_tensor_load_.Record(edge_name, val.TotalBytes(),
+                               Env::Default()->NowMicros() - start_micros);
+    }
+    done(s, is_dead, val);
+  };
+
   // Request the tensor associated with the rendezvous key. Any time
   // while waiting for the tensor to be produced, up until the start
   // of execution of the callback lambda body below, an RPC
@@ -456,10 +798,10 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
   opts->SetCancelCallback([this, step_id]() { AbortStep(step_id); });
   env_->rendezvous_mgr->RecvLocalAsync(
       step_id, parsed,
-      [opts, response, done, src_dev, request](
-          const Status& status, const Rendezvous::Args& send_args,
-          const Rendezvous::Args& recv_args, const Tensor& val,
-          const bool is_dead) {
+      [opts, done, src_dev, request](const Status& status,
+                                     const Rendezvous::Args& send_args,
+                                     const Rendezvous::Args& recv_args,
+                                     const Tensor& val, const bool is_dead) {
         opts->ClearCancelCallback();
         if (status.ok()) {
           // DMA can only be used for Tensors that do not fall into
@@ -483,24 +825,21 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
                   << " gpu_info: " << src_dev->tensorflow_gpu_device_info();
               // "val" is on an accelerator device. Uses the device_context to
               // fill the copy on host.
-              StatusCallback copy_ready = [response, done, copy,
+              StatusCallback copy_ready = [done, copy,
                                            is_dead](const Status& s) {
-                // The value is now ready to be returned on the wire.
-                grpc::EncodeTensorToByteBuffer(is_dead, *copy, response);
-                done(s);
+                done(s, is_dead, *copy);
                 delete copy;
               };
 
               send_dev_context->CopyDeviceTensorToCPU(
                   &val, request->rendezvous_key(), src_dev, copy, copy_ready);
             } else {
-              grpc::EncodeTensorToByteBuffer(is_dead, val, response);
-              done(Status::OK());
+              done(Status::OK(), is_dead, val);
             }
           }
         } else {
           //  !s.ok()
-          done(status);
+          done(status, false, Tensor());
         }
       });
 }
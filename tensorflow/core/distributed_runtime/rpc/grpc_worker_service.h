@@ -40,6 +40,27 @@ class GrpcWorker : public Worker {
                                    ::grpc::ByteBuffer* response,
                                    StatusCallback done);
 
+  // Writes a message of a response stream, and calls its callback once the
+  // message has been sent, at which point the next message can be written.
+  typedef std::function<void(::grpc::ByteBuffer*, StatusCallback)>
+      StreamWriter;
+
+  // Streaming version of GrpcRecvTensorAsync, which writes the response with
+  // `write`. The content of large tensors is sent in chunks of at most
+  // `request->stream_chunk_bytes()` bytes, directly from the tensor buffer.
+  virtual void GrpcRecvTensorStreamAsync(CallOptions* opts,
+                                         const RecvTensorRequest* request,
+                                         StreamWriter write,
+                                         StatusCallback done);
+
+  // Receives the tensors of all the requests of `request`, and writes each of
+  // them with `write` as soon as it is available, tagged with the index of its
+  // request. Fails if any of the requests fails.
+  virtual void GrpcRecvTensorBatchAsync(CallOptions* opts,
+                                        const RecvTensorBatchRequest* request,
+                                        StreamWriter write,
+                                        StatusCallback done);
+
   virtual void LoggingAsync(const LoggingRequest* request,
                             LoggingResponse* response, StatusCallback done);
 
@@ -49,6 +70,13 @@ class GrpcWorker : public Worker {
   WorkerEnv* env();
 
  private:
+  // Calls `done` with the tensor requested by `request`, copied to host
+  // memory if it is on an accelerator.
+  typedef std::function<void(const Status&, bool is_dead, const Tensor& val)>
+      HostTensorCallback;
+  void RecvHostTensorAsync(CallOptions* opts, const RecvTensorRequest* request,
+                           HostTensorCallback done);
+
   RecentRequestIds recv_tensor_recent_request_ids_;
 };
 
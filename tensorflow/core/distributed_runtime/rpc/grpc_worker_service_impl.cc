@@ -58,6 +58,10 @@ const char* GrpcWorkerMethodName(GrpcWorkerMethod id) {
       return "/tensorflow.WorkerService/CompleteInstance";
     case GrpcWorkerMethod::kGetStepSequence:
       return "/tensorflow.WorkerService/GetStepSequence";
+    case GrpcWorkerMethod::kRecvTensorStream:
+      return "/tensorflow.WorkerService/RecvTensorStream";
+    case GrpcWorkerMethod::kRecvTensorBatch:
+      return "/tensorflow.WorkerService/RecvTensorBatch";
   }
   // Shouldn't be reached.
   LOG(FATAL) << "Invalid id: this line shouldn't be reached.";
@@ -68,9 +72,14 @@ namespace grpc {
 
 WorkerService::AsyncService::AsyncService() {
   for (int i = 0; i < kGrpcNumWorkerMethods; ++i) {
+    const GrpcWorkerMethod id = static_cast<GrpcWorkerMethod>(i);
     AddMethod(new ::grpc::internal::RpcServiceMethod(
-        GrpcWorkerMethodName(static_cast<GrpcWorkerMethod>(i)),
-        ::grpc::internal::RpcMethod::NORMAL_RPC, nullptr));
+        GrpcWorkerMethodName(id),
+        (id == GrpcWorkerMethod::kRecvTensorStream ||
+         id == GrpcWorkerMethod::kRecvTensorBatch)
+            ? ::grpc::internal::RpcMethod::SERVER_STREAMING
+            : ::grpc::internal::RpcMethod::NORMAL_RPC,
+        nullptr));
     ::grpc::Service::MarkMethodAsync(i);
   }
 }
@@ -87,9 +87,11 @@ enum class GrpcWorkerMethod {
   kCompleteGroup,
   kCompleteInstance,
   kGetStepSequence,
+  kRecvTensorStream,
+  kRecvTensorBatch,
 };
 static const int kGrpcNumWorkerMethods =
-    static_cast<int>(GrpcWorkerMethod::kGetStepSequence) + 1;
+    static_cast<int>(GrpcWorkerMethod::kRecvTensorBatch) + 1;
 
 const char* GrpcWorkerMethodName(GrpcWorkerMethod id);
 
@@ -106,7 +108,9 @@ class WorkerService final {
     AsyncService();
     virtual ~AsyncService();
 
-    // Make RequestAsyncUnary public for grpc_call.h
+    // Make RequestAsyncUnary and RequestAsyncServerStreaming public for
+    // grpc_call.h
+    using ::grpc::Service::RequestAsyncServerStreaming;
     using ::grpc::Service::RequestAsyncUnary;
   };
 };
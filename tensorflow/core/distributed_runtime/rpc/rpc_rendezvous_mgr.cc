@@ -39,8 +39,9 @@ namespace {
 
 class RpcRemoteRendezvous : public BaseRemoteRendezvous {
  public:
-  RpcRemoteRendezvous(const WorkerEnv* env, int64 step_id)
-      : BaseRemoteRendezvous(env, step_id) {}
+  RpcRemoteRendezvous(const WorkerEnv* env, int64 step_id,
+                      RPCOptions::TensorCodec codec)
+      : BaseRemoteRendezvous(env, step_id), codec_(codec) {}
 
  protected:
   void RecvFromRemoteAsync(const Rendezvous::ParsedKey& parsed,
@@ -50,6 +51,9 @@ class RpcRemoteRendezvous : public BaseRemoteRendezvous {
  private:
   ~RpcRemoteRendezvous() override {}
 
+  // The codec to ask for in RecvTensor requests.
+  const RPCOptions::TensorCodec codec_;
+
   TF_DISALLOW_COPY_AND_ASSIGN(RpcRemoteRendezvous);
 };
 
@@ -60,11 +64,13 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
 
   void Init(WorkerInterface* wi, int64 step_id, StringPiece key,
             AllocatorAttributes alloc_attrs, Device* dst_device,
-            const Rendezvous::Args& recv_args, Rendezvous::DoneCallback done) {
+            const Rendezvous::Args& recv_args, RPCOptions::TensorCodec codec,
+            Rendezvous::DoneCallback done) {
     wi_ = wi;
     alloc_attrs_ = alloc_attrs;
     dst_device_ = dst_device;
     recv_args_ = recv_args;
+    codec_ = codec;
     done_ = std::move(done);
     req_.set_step_id(step_id);
     req_.set_rendezvous_key(key.data(), key.size());
@@ -76,6 +82,7 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
     wi_ = nullptr;
     alloc_attrs_ = AllocatorAttributes();
     dst_device_ = nullptr;
+    codec_ = RPCOptions::NO_CODEC;
     // We don't clear opts_ and assume that Init will set up the state for
     // opts_ appropriately.
     req_.Clear();
@@ -127,6 +134,11 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
   // Start the main RecvTensor call, checking for an async abort.
   void StartRTCall(std::function<void()> recv_done) {
     resp_.InitAlloc(dst_device_, alloc_attrs_);
+    // Codecs are decoded on the host, so only ask for one if the tensor is
+    // received into host memory.
+    if (resp_.on_host()) {
+      req_.set_tensor_codec(codec_);
+    }
     using namespace std::placeholders;
     StatusCallback cb = std::bind(
         [this](std::function<void()> recv_done,
@@ -147,6 +159,7 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
   WorkerInterface* wi_;
   AllocatorAttributes alloc_attrs_;
   Device* dst_device_;
+  RPCOptions::TensorCodec codec_ = RPCOptions::NO_CODEC;
   CallOptions opts_;
   RecvTensorRequest req_;
   TensorResponse resp_;
@@ -239,7 +252,7 @@ void RpcRemoteRendezvous::RecvFromRemoteAsync(
   }
 
   call->Init(rwi, step_id_, parsed.FullKey(), recv_args.alloc_attrs, dst_device,
-             recv_args, std::move(done));
+             recv_args, codec_, std::move(done));
 
   // Record "call" in active_ so that it can be aborted cleanly.
   RegisterCall(call);
@@ -263,11 +276,15 @@ void RpcRemoteRendezvous::RecvFromRemoteAsync(
 }  // namespace
 
 RpcRendezvousMgr::RpcRendezvousMgr(const WorkerEnv* env)
-    : BaseRendezvousMgr(env) {}
+    : RpcRendezvousMgr(env, RPCOptions()) {}
+
+RpcRendezvousMgr::RpcRendezvousMgr(const WorkerEnv* env,
+                                   const RPCOptions& rpc_options)
+    : BaseRendezvousMgr(env), codec_(rpc_options.recv_tensor_codec()) {}
 
 BaseRemoteRendezvous* RpcRendezvousMgr::Create(int64 step_id,
                                                const WorkerEnv* worker_env) {
-  return new RpcRemoteRendezvous(worker_env, step_id);
+  return new RpcRemoteRendezvous(worker_env, step_id, codec_);
 }
 
 }  // end namespace tensorflow
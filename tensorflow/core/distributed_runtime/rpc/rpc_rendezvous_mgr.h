@@ -19,6 +19,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/base_rendezvous_mgr.h"
 #include "tensorflow/core/distributed_runtime/worker_env.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/protobuf/config.pb.h"
 
 namespace tensorflow {
 
@@ -46,10 +47,16 @@ class RpcRendezvousMgr : public BaseRendezvousMgr {
  public:
   explicit RpcRendezvousMgr(const WorkerEnv* env);
 
+  // The rendezvous created by this manager ask the remote workers to apply
+  // `rpc_options.recv_tensor_codec()` to the tensors they send.
+  RpcRendezvousMgr(const WorkerEnv* env, const RPCOptions& rpc_options);
+
  protected:
   BaseRemoteRendezvous* Create(int64 step_id, const WorkerEnv* worker_env);
 
  private:
+  const RPCOptions::TensorCodec codec_;
+
   TF_DISALLOW_COPY_AND_ASSIGN(RpcRendezvousMgr);
 };
 
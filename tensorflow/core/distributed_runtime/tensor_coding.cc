@@ -18,8 +18,10 @@ limitations under the License.
 #include "google/protobuf/any.pb.h"
 
 #include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/framework/bfloat16.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/platform/snappy.h"
 
 namespace tensorflow {
 
@@ -65,6 +67,9 @@ Status TensorResponse::InitFrom(RecvTensorResponse* response) {
     meta_.mutable_tensor()->Swap(&empty);
   }
   meta_.clear_tensor();
+  if (s.ok()) {
+    s = DecodeCodec();
+  }
   return s;
 }
 
@@ -95,18 +100,70 @@ Status TensorResponse::ParseFrom(Source* source) {
       meta_.mutable_tensor()->Swap(&empty);
     }
     meta_.clear_tensor();
+    if (s.ok() && meta_.tensor_codec() != RPCOptions::NO_CODEC) {
+      s = errors::Internal("Cannot decode tensor codec ",
+                           RPCOptions::TensorCodec_Name(meta_.tensor_codec()),
+                           " into device memory");
+    }
     return s;
   }
   if (already_used_) {
     ClearTensor();
   }
   already_used_ = true;
-  if (ParseFast(source)) return Status::OK();
+  if (ParseFast(source)) return DecodeCodec();
   meta_.Clear();
-  if (ParseSlow(source)) return Status::OK();
+  if (ParseSlow(source)) return DecodeCodec();
   return errors::InvalidArgument("Cannot parse tensor from response");
 }
 
+Status TensorResponse::DecodeCodec() {
+  switch (meta_.tensor_codec()) {
+    case RPCOptions::NO_CODEC:
+      return Status::OK();
+    case RPCOptions::SNAPPY: {
+      const string& compressed = meta_.compressed_tensor_content();
+      StringPiece buf = tensor_.tensor_data();
+      size_t uncompressed_length;
+      if (!DataTypeCanUseMemcpy(tensor_.dtype()) ||
+          !port::Snappy_GetUncompressedLength(
+              compressed.data(), compressed.size(), &uncompressed_length) ||
+          uncompressed_length != buf.size() ||
+          !port::Snappy_Uncompress(compressed.data(), compressed.size(),
+                                   const_cast<char*>(buf.data()))) {
+        return errors::InvalidArgument(
+            "Cannot decompress tensor from response");
+      }
+      meta_.clear_compressed_tensor_content();
+      return Status::OK();
+    }
+    case RPCOptions::CAST_BFLOAT16: {
+      if (tensor_.dtype() != DT_BFLOAT16) break;
+      Tensor t(allocator_, DT_FLOAT, tensor_.shape());
+      BFloat16ToFloat(tensor_.flat<bfloat16>().data(), t.flat<float>().data(),
+                      t.NumElements());
+      tensor_ = std::move(t);
+      return Status::OK();
+    }
+    case RPCOptions::CAST_HALF: {
+      if (tensor_.dtype() != DT_HALF) break;
+      Tensor t(allocator_, DT_FLOAT, tensor_.shape());
+      auto src = tensor_.flat<Eigen::half>();
+      auto dst = t.flat<float>();
+      for (int64 i = 0; i < src.size(); ++i) {
+        dst(i) = static_cast<float>(src(i));
+      }
+      tensor_ = std::move(t);
+      return Status::OK();
+    }
+    default:
+      break;
+  }
+  return errors::InvalidArgument(
+      "Cannot decode tensor codec ", meta_.tensor_codec(), " from a ",
+      DataTypeString(tensor_.dtype()), " tensor");
+}
+
 // Define some helper routines for decoding protocol buffer wire format data
 namespace {
 // We only need some of the wiretype values for this code
@@ -254,6 +311,28 @@ bool TensorResponse::ParseFast(Source* source) {
         meta_.set_send_start_micros(static_cast<int64>(v));
         break;
       }
+      case RecvTensorResponse::kTensorCodecFieldNumber: {
+        uint32 v;
+        if ((wt != WIRETYPE_VARINT) || !input.ReadVarint32(&v)) return false;
+        meta_.set_tensor_codec(
+            static_cast<RPCOptions::TensorCodec>(static_cast<int>(v)));
+        break;
+      }
+      case RecvTensorResponse::kCompressedTensorContentFieldNumber: {
+        int length;
+        if ((wt != WIRETYPE_LENGTH_DELIMITED) ||
+            !ReadVarintSizeAsInt(&input, &length) ||
+            !input.ReadString(meta_.mutable_compressed_tensor_content(),
+                              length))
+          return false;
+        break;
+      }
+      case RecvTensorResponse::kBatchIndexFieldNumber: {
+        uint32 v;
+        if ((wt != WIRETYPE_VARINT) || !input.ReadVarint32(&v)) return false;
+        meta_.set_batch_index(static_cast<int32>(v));
+        break;
+      }
       case RecvTensorResponse::kTransportOptionsFieldNumber: {
         if ((wt != WIRETYPE_LENGTH_DELIMITED) ||
             !ReadNestedMessage(&input, meta_.mutable_transport_options()))
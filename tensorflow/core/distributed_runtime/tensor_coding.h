@@ -82,6 +82,13 @@ class TensorResponse {
   // live only until *this is destroyed or modified.
   const Tensor& tensor() const { return tensor_; }
 
+  // Return a pointer to the parsed tensor, to fill in its contents when they
+  // are received separately from its metadata.
+  Tensor* mutable_tensor() { return &tensor_; }
+
+  // Return true if the tensor is allocated in host memory.
+  bool on_host() const { return on_host_; }
+
   // Return a reference to the parsed tensor metadata (no contents).
   // The result will remain live only until *this is destroyed or
   // modified.
@@ -93,6 +100,10 @@ class TensorResponse {
   bool ParseFast(Source* source);
   bool ParseSlow(Source* source);
 
+  // Undo the transformation the sender applied to the tensor, as recorded in
+  // meta_.tensor_codec(), if any.
+  Status DecodeCodec();
+
   bool on_host_ = false;
   DeviceBase* device_ = nullptr;
   AllocatorAttributes alloc_attrs_;
@@ -19,10 +19,12 @@ limitations under the License.
 #include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
@@ -156,6 +158,90 @@ TEST_F(TensorResponseTest, Simple) {
 
 TEST_F(TensorResponseTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+Status ParseResponse(const RecvTensorResponse& proto,
+                     TensorResponse* response) {
+  string encoded;
+  proto.AppendToString(&encoded);
+  StringSource source(&encoded, 1024);
+  return response->ParseFrom(&source);
+}
+
+TEST_F(TensorResponseTest, CastCodecs) {
+  Tensor expected(DT_FLOAT, TensorShape({2, 3}));
+  test::FillValues<float>(&expected, {0, 1, -2, 3.5, 1024, -0.25});
+  Tensor bf16(DT_BFLOAT16, expected.shape());
+  test::FillValues<bfloat16>(
+      &bf16, {bfloat16(0), bfloat16(1), bfloat16(-2), bfloat16(3.5),
+              bfloat16(1024), bfloat16(-0.25)});
+  Tensor half(DT_HALF, expected.shape());
+  test::FillValues<Eigen::half>(
+      &half, {Eigen::half(0), Eigen::half(1), Eigen::half(-2),
+              Eigen::half(3.5), Eigen::half(1024), Eigen::half(-0.25)});
+
+  DummyDevice cpu_device(Env::Default());
+  for (const auto& c : {std::make_pair(RPCOptions::CAST_BFLOAT16, &bf16),
+                        std::make_pair(RPCOptions::CAST_HALF, &half)}) {
+    RecvTensorResponse proto;
+    proto.set_tensor_codec(c.first);
+    c.second->AsProtoTensorContent(proto.mutable_tensor());
+    TensorResponse response;
+    response.InitAlloc(&cpu_device, AllocatorAttributes());
+    TF_ASSERT_OK(ParseResponse(proto, &response));
+    test::ExpectTensorEqual<float>(expected, response.tensor());
+  }
+
+  // A cast codec only applies to tensors of the matching dtype.
+  RecvTensorResponse proto;
+  proto.set_tensor_codec(RPCOptions::CAST_HALF);
+  bf16.AsProtoTensorContent(proto.mutable_tensor());
+  TensorResponse response;
+  response.InitAlloc(&cpu_device, AllocatorAttributes());
+  EXPECT_FALSE(ParseResponse(proto, &response).ok());
+}
+
+TEST_F(TensorResponseTest, SnappyCodec) {
+  Tensor expected(DT_INT32, TensorShape({1000}));
+  test::FillFn<int32>(&expected, [](int i) { return i % 7 == 0 ? i : 0; });
+  StringPiece tdata = expected.tensor_data();
+
+  RecvTensorResponse proto;
+  if (!port::Snappy_Compress(tdata.data(), tdata.size(),
+                             proto.mutable_compressed_tensor_content())) {
+    LOG(INFO) << "Snappy is not available, skipping the test";
+    return;
+  }
+  proto.set_tensor_codec(RPCOptions::SNAPPY);
+  proto.mutable_tensor()->set_dtype(DT_INT32);
+  expected.shape().AsProto(proto.mutable_tensor()->mutable_tensor_shape());
+
+  DummyDevice cpu_device(Env::Default());
+  TensorResponse response;
+  response.InitAlloc(&cpu_device, AllocatorAttributes());
+  TF_ASSERT_OK(ParseResponse(proto, &response));
+  test::ExpectTensorEqual<int32>(expected, response.tensor());
+  EXPECT_TRUE(response.metadata().compressed_tensor_content().empty());
+
+  // The decompressed content must fill the tensor.
+  proto.mutable_tensor()->mutable_tensor_shape()->mutable_dim(0)->set_size(10);
+  response.InitAlloc(&cpu_device, AllocatorAttributes());
+  EXPECT_FALSE(ParseResponse(proto, &response).ok());
+}
+
+TEST_F(TensorResponseTest, BatchIndex) {
+  Tensor expected(DT_FLOAT, TensorShape({4}));
+  test::FillValues<float>(&expected, {1, 2, 3, 4});
+  RecvTensorResponse proto;
+  expected.AsProtoTensorContent(proto.mutable_tensor());
+  proto.set_batch_index(7);
+
+  DummyDevice cpu_device(Env::Default());
+  TensorResponse response;
+  response.InitAlloc(&cpu_device, AllocatorAttributes());
+  TF_ASSERT_OK(ParseResponse(proto, &response));
+  test::ExpectTensorEqual<float>(expected, response.tensor());
+  EXPECT_EQ(7, response.metadata().batch_index());
+}
+
 string MakeFloatTensorTestCase(int num_elems) {
   std::vector<int8> v(num_elems);
   for (int i = 0; i < num_elems; i++) {
@@ -0,0 +1,63 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/tensor_load_stats.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace tensorflow {
+
+void TensorLoadStats::Record(StringPiece edge_name, int64 bytes,
+                             int64 micros) {
+  mutex_lock l(mu_);
+  auto it = load_.find(edge_name.ToString());
+  if (it == load_.end()) {
+    it = load_.emplace(edge_name.ToString(), TensorLoad()).first;
+    it->second.set_edge_name(it->first);
+  }
+  TensorLoad* load = &it->second;
+  load->set_num_requests(load->num_requests() + 1);
+  load->set_total_bytes(load->total_bytes() + bytes);
+  load->set_total_micros(load->total_micros() + micros);
+  load->set_max_micros(std::max<int64>(load->max_micros(), micros));
+}
+
+void TensorLoadStats::Export(bool reset, GetStatusResponse* response) {
+  std::vector<TensorLoad> loads;
+  {
+    mutex_lock l(mu_);
+    loads.reserve(load_.size());
+    for (const auto& it : load_) {
+      loads.push_back(it.second);
+    }
+    if (reset) {
+      load_.clear();
+    }
+  }
+  std::sort(loads.begin(), loads.end(),
+            [](const TensorLoad& a, const TensorLoad& b) {
+              if (a.total_bytes() != b.total_bytes()) {
+                return a.total_bytes() > b.total_bytes();
+              }
+              return a.edge_name() < b.edge_name();
+            });
+  response->mutable_tensor_load()->Reserve(loads.size());
+  for (TensorLoad& load : loads) {
+    response->add_tensor_load()->Swap(&load);
+  }
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,56 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_TENSOR_LOAD_STATS_H_
+#define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_TENSOR_LOAD_STATS_H_
+
+#include <string>
+#include <unordered_map>
+
+#include "tensorflow/core/lib/core/stringpiece.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/protobuf/worker.pb.h"
+
+namespace tensorflow {
+
+// TensorLoadStats accumulates the RecvTensor load served by a worker, per
+// edge of the partitioned graphs. On a parameter server this is the load
+// caused by each variable, which shows the tasks and variables that the
+// fetches of the other tasks wait on. Thread safe.
+class TensorLoadStats {
+ public:
+  TensorLoadStats() {}
+
+  // Records a request for the tensor of `edge_name` of `bytes` bytes, which
+  // took `micros` to serve.
+  void Record(StringPiece edge_name, int64 bytes, int64 micros);
+
+  // Appends the accumulated load to `response`, by decreasing number of
+  // bytes, and resets it if `reset` is true.
+  void Export(bool reset, GetStatusResponse* response);
+
+ private:
+  mutex mu_;
+  std::unordered_map<string, TensorLoad> load_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(TensorLoadStats);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_TENSOR_LOAD_STATS_H_
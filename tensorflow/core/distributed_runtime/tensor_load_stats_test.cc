@@ -0,0 +1,68 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/tensor_load_stats.h"
+
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/worker.pb.h"
+
+namespace tensorflow {
+
+TEST(TensorLoadStats, Empty) {
+  TensorLoadStats stats;
+  GetStatusResponse response;
+  stats.Export(false, &response);
+  EXPECT_EQ(0, response.tensor_load_size());
+}
+
+TEST(TensorLoadStats, AccumulatesPerEdge) {
+  TensorLoadStats stats;
+  stats.Record("edge_1_a", 100, 10);
+  stats.Record("edge_2_b", 1000, 5);
+  stats.Record("edge_1_a", 100, 30);
+
+  GetStatusResponse response;
+  stats.Export(false, &response);
+  ASSERT_EQ(2, response.tensor_load_size());
+
+  const TensorLoad& b = response.tensor_load(0);
+  EXPECT_EQ("edge_2_b", b.edge_name());
+  EXPECT_EQ(1, b.num_requests());
+  EXPECT_EQ(1000, b.total_bytes());
+  EXPECT_EQ(5, b.total_micros());
+  EXPECT_EQ(5, b.max_micros());
+
+  const TensorLoad& a = response.tensor_load(1);
+  EXPECT_EQ("edge_1_a", a.edge_name());
+  EXPECT_EQ(2, a.num_requests());
+  EXPECT_EQ(200, a.total_bytes());
+  EXPECT_EQ(40, a.total_micros());
+  EXPECT_EQ(30, a.max_micros());
+}
+
+TEST(TensorLoadStats, Reset) {
+  TensorLoadStats stats;
+  stats.Record("edge_1_a", 100, 10);
+
+  GetStatusResponse response;
+  stats.Export(true, &response);
+  EXPECT_EQ(1, response.tensor_load_size());
+
+  GetStatusResponse after_reset;
+  stats.Export(false, &after_reset);
+  EXPECT_EQ(0, after_reset.tensor_load_size());
+}
+
+}  // namespace tensorflow
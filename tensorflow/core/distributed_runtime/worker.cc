@@ -37,6 +37,9 @@ void Worker::GetStatusAsync(const GetStatusRequest* request,
   for (auto& d : devices) {
     response->add_device_attributes()->Swap(&d);
   }
+  if (request->include_tensor_load()) {
+    recv_tensor_load_.Export(request->reset_tensor_load(), response);
+  }
   done(Status::OK());
 }
 
@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/graph_mgr.h"
 #include "tensorflow/core/distributed_runtime/partial_run_mgr.h"
 #include "tensorflow/core/distributed_runtime/session_mgr.h"
+#include "tensorflow/core/distributed_runtime/tensor_load_stats.h"
 #include "tensorflow/core/distributed_runtime/worker_interface.h"
 
 namespace tensorflow {
@@ -115,6 +116,10 @@ class Worker : public WorkerInterface {
 
   void AbortStep(int64);
 
+  // RecvTensor load served by this worker, recorded by the transport-specific
+  // implementations of RecvTensor and returned by GetStatus.
+  TensorLoadStats recv_tensor_load_;
+
  private:
   PartialRunMgr partial_run_mgr_;
 
@@ -20,7 +20,9 @@ limitations under the License.
 #include "tensorflow/core/framework/tracking_allocator.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/mem.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/types.h"
 
 namespace tensorflow {
@@ -93,13 +95,21 @@ void EnableCPUAllocatorFullStats(bool enable) {
 
 class CPUAllocator : public Allocator {
  public:
-  CPUAllocator()
-      : single_allocation_warning_count_(0),
+  CPUAllocator() : CPUAllocator(port::kNUMANoAffinity) {}
+
+  explicit CPUAllocator(int numa_node)
+      : numa_node_(numa_node),
+        single_allocation_warning_count_(0),
         total_allocation_warning_count_(0) {}
 
   ~CPUAllocator() override {}
 
-  string Name() override { return "cpu"; }
+  string Name() override {
+    if (numa_node_ == port::kNUMANoAffinity) {
+      return "cpu";
+    }
+    return strings::StrCat("cpu_numa_", numa_node_);
+  }
 
   void* AllocateRaw(size_t alignment, size_t num_bytes) override {
     if (num_bytes > LargeAllocationWarningBytes() &&
@@ -110,7 +120,9 @@ class CPUAllocator : public Allocator {
                    << "% of system memory.";
     }
 
-    void* p = port::AlignedMalloc(num_bytes, alignment);
+    void* p = numa_node_ == port::kNUMANoAffinity
+                  ? port::AlignedMalloc(num_bytes, alignment)
+                  : port::NUMAMalloc(numa_node_, num_bytes, alignment);
     if (cpu_allocator_collect_stats) {
       const std::size_t alloc_size = port::MallocExtension_GetAllocatedSize(p);
       mutex_lock l(mu_);
@@ -139,7 +151,11 @@ class CPUAllocator : public Allocator {
       mutex_lock l(mu_);
       stats_.bytes_in_use -= alloc_size;
     }
-    port::AlignedFree(ptr);
+    if (numa_node_ == port::kNUMANoAffinity) {
+      port::AlignedFree(ptr);
+    } else {
+      port::NUMAFree(ptr);
+    }
   }
 
   void GetStats(AllocatorStats* stats) override {
@@ -159,6 +175,8 @@ class CPUAllocator : public Allocator {
   }
 
  private:
+  const int numa_node_;
+
   mutex mu_;
   AllocatorStats stats_ GUARDED_BY(mu_);
 
@@ -178,6 +196,27 @@ Allocator* cpu_allocator() {
   return cpu_alloc;
 }
 
+Allocator* cpu_allocator(int numa_node) {
+  if (numa_node == port::kNUMANoAffinity || !port::NUMAEnabled()) {
+    return cpu_allocator();
+  }
+  CHECK_GE(numa_node, 0);
+  CHECK_LT(numa_node, port::NUMANumNodes());
+  static mutex mu(LINKER_INITIALIZED);
+  static std::vector<Allocator*>* numa_allocators = new std::vector<Allocator*>;
+  mutex_lock l(mu);
+  if (numa_allocators->empty()) {
+    for (int node = 0; node < port::NUMANumNodes(); ++node) {
+      Allocator* a = new CPUAllocator(node);
+      if (cpu_allocator_collect_full_stats) {
+        a = new TrackingAllocator(a, true);
+      }
+      numa_allocators->push_back(a);
+    }
+  }
+  return (*numa_allocators)[numa_node];
+}
+
 REGISTER_MEM_ALLOCATOR("DefaultCPUAllocator", 100, CPUAllocator);
 
 }  // namespace tensorflow
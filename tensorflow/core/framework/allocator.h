@@ -19,6 +19,7 @@ limitations under the License.
 #include <stdlib.h>
 
 #include <limits>
+#include <vector>
 
 #include "tensorflow/core/framework/numeric_types.h"
 #include "tensorflow/core/framework/resource_handle.h"
@@ -63,6 +64,22 @@ struct AllocatorStats {
   string DebugString() const;
 };
 
+// How fragmented the memory held by an allocator is.
+struct AllocatorFragmentation {
+  // The regions of memory the allocator obtained, and their total size.
+  int64 num_regions = 0;
+  int64 region_bytes = 0;
+
+  // The free bytes of the regions, and the largest free block, which is the
+  // largest allocation possible without growing the regions.
+  int64 free_bytes = 0;
+  int64 largest_free_block_bytes = 0;
+
+  // The free bytes by block size: bin i holds the free blocks of
+  // [256 << i, 512 << i) bytes, and the last bin also all the larger ones.
+  std::vector<int64> free_bytes_per_bin;
+};
+
 // Allocator is an abstract interface for allocating and deallocating
 // device memory.
 class Allocator {
@@ -196,6 +213,16 @@ class Allocator {
   // Clears the internal stats except for the `in_use` field.
   virtual void ClearStats() {}
 
+  // Fills in 'fragmentation' with the fragmentation of the memory held by
+  // this allocator. Returns false if the allocator does not track it.
+  virtual bool GetFragmentation(AllocatorFragmentation* fragmentation) {
+    return false;
+  }
+
+  // Gives back the memory this allocator holds but has not used for a while,
+  // if it is configured to. Called by the executors at the end of the steps.
+  virtual void Compact() {}
+
  private:
   // No constructors or destructors are run for simple types
   template <typename T>
@@ -380,6 +407,11 @@ struct AllocatorAttributes {
 // default malloc. The returned allocator is a process singleton.
 Allocator* cpu_allocator();
 
+// Like cpu_allocator(), but the memory is placed on NUMA node "numa_node". The
+// same as cpu_allocator() on machines without NUMA nodes or for
+// port::kNUMANoAffinity.
+Allocator* cpu_allocator(int numa_node);
+
 // If 'enable' is true, the process-wide cpu allocator collects
 // AllocatorStats. By default, it's disabled.
 void EnableCPUAllocatorStats(bool enable);
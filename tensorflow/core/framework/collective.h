@@ -64,6 +64,10 @@ struct CollGroupParams {
 // interpretation.  On first execution the runtime will update this
 // structure with decisions that will guide all subsequent executions.
 struct CollImplDetails {
+  // reduction only: name of the algorithm, "RingReduce" or
+  // "HalvingDoublingReduce". If empty, the algorithm is chosen for each
+  // execution from the group size and the size of the tensor.
+  string collective_name;
   std::vector<std::vector<int>> subdiv_permutations;
   std::vector<int> subdiv_offsets;
   // broadcast only: rank of source in each subdiv
@@ -20,8 +20,10 @@ limitations under the License.
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/attr_value_util.h"
 #include "tensorflow/core/framework/dataset_stateful_op_whitelist.h"
+#include "tensorflow/core/framework/dataset_tracer.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
@@ -275,6 +277,14 @@ class IteratorContext {
 
     // The Allocator to be used to allocate the output of an iterator.
     std::function<Allocator*(AllocatorAttributes)> allocator_getter = nullptr;
+
+    // The performance model of the input pipeline, tuning the parameters
+    // set to `model::kAutoTune`. Owned by the `IteratorResource`.
+    std::shared_ptr<model::Model> model = nullptr;
+
+    // Records the `GetNext()` calls of the iterators of the input pipeline
+    // while a step traces them. Owned by the `IteratorResource`.
+    std::shared_ptr<DatasetTracer> tracer = nullptr;
   };
 
   explicit IteratorContext(Params params) : params_(std::move(params)) {}
@@ -313,6 +323,20 @@ class IteratorContext {
     return params_.stats_aggregator_getter;
   }
 
+  std::shared_ptr<model::Model> model() { return params_.model; }
+
+  void set_model(std::shared_ptr<model::Model> model) {
+    params_.model = std::move(model);
+  }
+
+  const std::shared_ptr<DatasetTracer>& tracer() const {
+    return params_.tracer;
+  }
+
+  void set_tracer(std::shared_ptr<DatasetTracer> tracer) {
+    params_.tracer = std::move(tracer);
+  }
+
  private:
   Params params_;
 };
@@ -341,6 +365,26 @@ class IteratorBase {
   virtual Status GetNext(IteratorContext* ctx, std::vector<Tensor>* out_tensors,
                          bool* end_of_sequence) = 0;
 
+  // Returns true if this iterator implements `GetNextBatch()`.
+  virtual bool SupportsGetNextBatch() const { return false; }
+
+  // Gets up to `batch_size` next outputs from the range that this iterator is
+  // traversing as a batch, with one tensor per tuple component whose 0th
+  // dimension indexes the outputs, as `BatchDataset` would produce them.
+  // Iterators whose outputs are rows of contiguous buffers, or that can write
+  // them directly into batch-sized buffers, implement this so that batching
+  // them does not construct and copy a tensor per output.
+  //
+  // The batch has fewer than `batch_size` outputs only if the range ends. If
+  // no outputs remain, `true` will be stored in `*end_of_sequence`.
+  //
+  // This method is thread-safe.
+  virtual Status GetNextBatch(IteratorContext* ctx, int64 batch_size,
+                              std::vector<Tensor>* out_tensors,
+                              bool* end_of_sequence) {
+    return errors::Unimplemented("GetNextBatch() is not supported.");
+  }
+
   // Returns a vector of DataType values, representing the respective
   // element types of each tuple component in the outputs of this
   // iterator.
@@ -530,7 +574,34 @@ class DatasetIterator : public IteratorBase {
   Status GetNext(IteratorContext* ctx, std::vector<Tensor>* out_tensors,
                  bool* end_of_sequence) final {
     tracing::ScopedActivity activity(params_.prefix);
+    model::Model* model = ctx->model().get();
+    if (model != nullptr && !model->enabled()) {
+      model = nullptr;
+    }
+    if (model != nullptr) {
+      model->RecordStart(params_.prefix);
+    }
+    DatasetTracer* tracer = ctx->tracer().get();
+    if (tracer != nullptr && !tracer->active()) {
+      tracer = nullptr;
+    }
+    if (tracer != nullptr) {
+      tracer->RecordStart(params_.prefix);
+    }
     Status s = GetNextInternal(ctx, out_tensors, end_of_sequence);
+    if (tracer != nullptr) {
+      tracer->RecordStop(params_.prefix);
+    }
+    if (model != nullptr) {
+      int64 num_bytes = 0;
+      const bool produced_element = s.ok() && !*end_of_sequence;
+      if (produced_element) {
+        for (const Tensor& t : *out_tensors) {
+          num_bytes += t.TotalBytes();
+        }
+      }
+      model->RecordStop(params_.prefix, produced_element, num_bytes);
+    }
     if (TF_PREDICT_FALSE(errors::IsOutOfRange(s) && !*end_of_sequence)) {
       s = errors::Internal(
           "Iterator \"", params_.prefix,
@@ -542,6 +613,27 @@ class DatasetIterator : public IteratorBase {
     return s;
   }
 
+  // NOTE: The batches are not reported to the performance model, which
+  // counts elements, so that their time is attributed to the consumer.
+  Status GetNextBatch(IteratorContext* ctx, int64 batch_size,
+                      std::vector<Tensor>* out_tensors,
+                      bool* end_of_sequence) final {
+    tracing::ScopedActivity activity(params_.prefix);
+    DatasetTracer* tracer = ctx->tracer().get();
+    if (tracer != nullptr && !tracer->active()) {
+      tracer = nullptr;
+    }
+    if (tracer != nullptr) {
+      tracer->RecordStart(params_.prefix);
+    }
+    Status s =
+        GetNextBatchInternal(ctx, batch_size, out_tensors, end_of_sequence);
+    if (tracer != nullptr) {
+      tracer->RecordStop(params_.prefix);
+    }
+    return s;
+  }
+
   Status Save(OpKernelContext* ctx, IteratorStateWriter* writer) final {
     TF_RETURN_IF_ERROR(dataset()->Save(ctx, writer));
     return IteratorBase::Save(ctx, writer);
@@ -553,10 +645,40 @@ class DatasetIterator : public IteratorBase {
                                  std::vector<Tensor>* out_tensors,
                                  bool* end_of_sequence) = 0;
 
+  // Internal implementation of GetNextBatch that is wrapped in tracing logic.
+  // Subclasses that override it must also override `SupportsGetNextBatch()`.
+  virtual Status GetNextBatchInternal(IteratorContext* ctx, int64 batch_size,
+                                      std::vector<Tensor>* out_tensors,
+                                      bool* end_of_sequence) {
+    return errors::Unimplemented("GetNextBatch() is not supported.");
+  }
+
   string full_name(const string& name) const {
     return strings::StrCat(prefix(), ":", name);
   }
 
+  // Brackets the time the calling thread spends waiting for elements produced
+  // by the background threads of this iterator, so that the performance model
+  // does not count it as processing time, and the tracer counts it as time
+  // spent waiting on the input.
+  void RecordWaitStart(IteratorContext* ctx) {
+    if (ctx->model() && ctx->model()->enabled()) {
+      ctx->model()->RecordWaitStart(params_.prefix);
+    }
+    if (ctx->tracer() && ctx->tracer()->active()) {
+      ctx->tracer()->RecordWaitStart();
+    }
+  }
+
+  void RecordWaitStop(IteratorContext* ctx) {
+    if (ctx->model() && ctx->model()->enabled()) {
+      ctx->model()->RecordWaitStop(params_.prefix);
+    }
+    if (ctx->tracer() && ctx->tracer()->active()) {
+      ctx->tracer()->RecordWaitStop();
+    }
+  }
+
  private:
   Params params_;
 };
@@ -0,0 +1,106 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/framework/dataset_tracer.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Bounds the memory used by the calls recorded during a traced step.
+constexpr size_t kMaxRecordedCalls = 1 << 16;
+
+}  // namespace
+
+void DatasetTracer::Start() { num_active_.fetch_add(1); }
+
+void DatasetTracer::Stop(std::vector<NodeExecStats>* stats) {
+  mutex_lock l(mu_);
+  num_active_.fetch_sub(1);
+  stats->swap(stats_);
+  stats_.clear();
+}
+
+void DatasetTracer::RecordStart(const string& name) {
+  const uint64 now = Env::Default()->NowMicros();
+  mutex_lock l(mu_);
+  frames_[std::this_thread::get_id()].push_back({now, 0, 0});
+}
+
+void DatasetTracer::RecordStop(const string& name) {
+  const uint64 now = Env::Default()->NowMicros();
+  const std::thread::id thread_id = std::this_thread::get_id();
+  mutex_lock l(mu_);
+  auto it = frames_.find(thread_id);
+  if (it == frames_.end() || it->second.empty()) {
+    return;
+  }
+  std::vector<Frame>& frames = it->second;
+  const Frame frame = frames.back();
+  frames.pop_back();
+  const int64 duration = now - frame.start_micros;
+  if (frames.empty()) {
+    frames_.erase(it);
+  } else {
+    frames.back().input_micros += duration;
+  }
+  if (!active() || stats_.size() >= kMaxRecordedCalls) {
+    return;
+  }
+  const int64 input_micros = std::min(frame.input_micros, duration);
+  stats_.emplace_back();
+  NodeExecStats& stats = stats_.back();
+  stats.set_node_name(name);
+  stats.set_all_start_micros(frame.start_micros);
+  stats.set_op_start_rel_micros(0);
+  stats.set_op_end_rel_micros(duration);
+  stats.set_all_end_rel_micros(duration);
+  stats.set_timeline_label(strings::StrCat(
+      name, " = GetNext(self: ", duration - input_micros,
+      "us, input: ", input_micros, "us)"));
+  stats.set_thread_id(
+      static_cast<uint32>(std::hash<std::thread::id>()(thread_id)));
+}
+
+void DatasetTracer::RecordWaitStart() {
+  const uint64 now = Env::Default()->NowMicros();
+  mutex_lock l(mu_);
+  auto it = frames_.find(std::this_thread::get_id());
+  if (it == frames_.end() || it->second.empty()) {
+    return;
+  }
+  it->second.back().wait_start_micros = now;
+}
+
+void DatasetTracer::RecordWaitStop() {
+  const uint64 now = Env::Default()->NowMicros();
+  mutex_lock l(mu_);
+  auto it = frames_.find(std::this_thread::get_id());
+  if (it == frames_.end() || it->second.empty()) {
+    return;
+  }
+  Frame& frame = it->second.back();
+  if (frame.wait_start_micros > 0) {
+    frame.input_micros += now - frame.wait_start_micros;
+    frame.wait_start_micros = 0;
+  }
+}
+
+}  // namespace tensorflow
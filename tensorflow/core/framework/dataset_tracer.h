@@ -0,0 +1,93 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_FRAMEWORK_DATASET_TRACER_H_
+#define TENSORFLOW_CORE_FRAMEWORK_DATASET_TRACER_H_
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tensorflow/core/framework/step_stats.pb.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Records the `GetNext()` calls of the iterators of an input pipeline as
+// `NodeExecStats`, so that they can be added to the `StepStats` of the steps
+// whose execution is traced, and appear in the timeline and in tfprof next to
+// the ops of the step.
+//
+// Each recorded call is named after the prefix of its iterator (e.g.
+// "Iterator::Prefetch::Map"), spans the whole call, and its timeline label
+// splits it into the time the iterator spent in its own code and the time it
+// waited on its input: in the `GetNext()` calls of its input iterators on the
+// same thread, and for the elements produced by its background threads.
+//
+// Calls are only recorded between `Start()` and `Stop()`; otherwise, the
+// overhead of the tracer is a load of an atomic per `GetNext()` call.
+//
+// This class is thread-safe.
+class DatasetTracer {
+ public:
+  DatasetTracer() = default;
+
+  // Returns true if `GetNext()` calls should be recorded.
+  bool active() const { return num_active_.load() > 0; }
+
+  // Starts recording. Calls to `Start()` can overlap (e.g. for concurrent
+  // traced steps); recording stops when each of them has been matched by a
+  // call to `Stop()`.
+  void Start();
+
+  // Moves the calls recorded since the previous call to `Stop()` to `*stats`,
+  // and stops recording if this matches the last outstanding `Start()`.
+  void Stop(std::vector<NodeExecStats>* stats);
+
+  // Records that the calling thread starts and ends a `GetNext()` call of the
+  // iterator `name`. The caller must call `RecordStop()` after each
+  // `RecordStart()`, which it only needs to call if `active()`. The call is
+  // dropped if recording has stopped before it ends.
+  void RecordStart(const string& name);
+  void RecordStop(const string& name);
+
+  // Records that the calling thread starts and stops waiting for an element
+  // produced asynchronously for the current `GetNext()` call.
+  void RecordWaitStart();
+  void RecordWaitStop();
+
+ private:
+  // A `GetNext()` call in progress on a thread.
+  struct Frame {
+    uint64 start_micros;
+    int64 input_micros;
+    uint64 wait_start_micros;
+  };
+
+  std::atomic<int> num_active_{0};
+  mutex mu_;
+  std::map<std::thread::id, std::vector<Frame>> frames_ GUARDED_BY(mu_);
+  std::vector<NodeExecStats> stats_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(DatasetTracer);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_FRAMEWORK_DATASET_TRACER_H_
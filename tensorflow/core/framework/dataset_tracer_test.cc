@@ -0,0 +1,75 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/dataset_tracer.h"
+
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(DatasetTracerTest, InactiveByDefault) {
+  DatasetTracer tracer;
+  EXPECT_FALSE(tracer.active());
+  tracer.Start();
+  tracer.Start();
+  EXPECT_TRUE(tracer.active());
+  std::vector<NodeExecStats> stats;
+  tracer.Stop(&stats);
+  EXPECT_TRUE(tracer.active());
+  tracer.Stop(&stats);
+  EXPECT_FALSE(tracer.active());
+}
+
+TEST(DatasetTracerTest, RecordsNestedCalls) {
+  DatasetTracer tracer;
+  tracer.Start();
+  tracer.RecordStart("Iterator::Prefetch");
+  tracer.RecordStart("Iterator::Prefetch::Map");
+  Env::Default()->SleepForMicroseconds(2000);
+  tracer.RecordStop("Iterator::Prefetch::Map");
+  tracer.RecordWaitStart();
+  Env::Default()->SleepForMicroseconds(2000);
+  tracer.RecordWaitStop();
+  tracer.RecordStop("Iterator::Prefetch");
+  std::vector<NodeExecStats> stats;
+  tracer.Stop(&stats);
+
+  ASSERT_EQ(2, stats.size());
+  // The calls are recorded as they end.
+  EXPECT_EQ("Iterator::Prefetch::Map", stats[0].node_name());
+  EXPECT_EQ("Iterator::Prefetch", stats[1].node_name());
+  EXPECT_GE(stats[0].all_start_micros(), stats[1].all_start_micros());
+  EXPECT_GE(stats[0].all_end_rel_micros(), 2000);
+  EXPECT_GE(stats[1].all_end_rel_micros(), 4000);
+  EXPECT_EQ(stats[0].thread_id(), stats[1].thread_id());
+  EXPECT_EQ(0, stats[1].timeline_label().find("Iterator::Prefetch = GetNext("));
+}
+
+TEST(DatasetTracerTest, DropsCallsEndingAfterStop) {
+  DatasetTracer tracer;
+  tracer.Start();
+  tracer.RecordStart("Iterator::Range");
+  std::vector<NodeExecStats> stats;
+  tracer.Stop(&stats);
+  tracer.RecordStop("Iterator::Range");
+  tracer.Start();
+  tracer.Stop(&stats);
+  EXPECT_TRUE(stats.empty());
+}
+
+}  // namespace
+}  // namespace tensorflow
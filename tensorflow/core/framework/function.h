@@ -245,6 +245,13 @@ class CallFrameInterface {
 
   virtual Status GetArg(int index, Tensor* val) const = 0;
   virtual Status SetRetval(int index, const Tensor& val) = 0;
+
+  // Returns the tensor preallocated by the caller for retval "index", or
+  // nullptr. The op producing the retval may write it directly into that
+  // tensor, if it has its type and shape; SetRetval still gets called.
+  virtual const Tensor* GetRetvalDestination(int index) const {
+    return nullptr;
+  }
 };
 
 // Represents a function call frame. I.e., the data structure used to
@@ -0,0 +1,412 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/framework/model.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace model {
+
+namespace {
+
+// Adding a unit of parallelism must reduce the output time by at least this
+// fraction to be worth a thread.
+constexpr double kMinImprovement = 0.01;
+
+// A buffer grows when its consumer had to wait for more than this fraction of
+// its requests since the last optimization.
+constexpr double kMaxStarvedFraction = 0.1;
+
+// Returns the name of the iterator with the indices of the input elements the
+// iterators of interleaves and flat maps were created for stripped, e.g.
+// "Iterator::ParallelInterleaveV2[]::TensorSlice" for
+// "Iterator::ParallelInterleaveV2[3]::TensorSlice".
+string CanonicalName(const string& name) {
+  string result;
+  result.reserve(name.size());
+  for (size_t i = 0; i < name.size(); ++i) {
+    result.push_back(name[i]);
+    if (name[i] == '[') {
+      size_t end = i + 1;
+      while (end < name.size() && isdigit(name[end])) {
+        ++end;
+      }
+      if (end > i + 1 && end < name.size() && name[end] == ']') {
+        i = end - 1;
+      }
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+double Model::Node::Ratio(const Node& input) const {
+  if (num_elements_ == 0) {
+    return 1.0;
+  }
+  return static_cast<double>(input.num_elements_) / num_elements_;
+}
+
+double Model::Node::OutputTime(double consumer_time) const {
+  const double self_time =
+      num_elements_ > 0 ? static_cast<double>(processing_time_) / num_elements_
+                        : 0.0;
+  auto parallelism = parameters_.find(ParameterKind::kParallelism);
+  const bool async = parallelism != parameters_.end() ||
+                     parameters_.count(ParameterKind::kBufferSize) > 0;
+  if (!async) {
+    // The inputs run on the thread of the consumer, in between its requests.
+    double output_time = self_time;
+    for (const Node* input : inputs_) {
+      const double ratio = Ratio(*input);
+      const double input_consumer_time =
+          ratio > 0 ? (consumer_time + self_time) / ratio : 0.0;
+      output_time += ratio * input->OutputTime(input_consumer_time);
+    }
+    return output_time;
+  }
+
+  // The elements are produced by background threads while the consumer works,
+  // so the consumer only waits for the part of the work it doesn't hide. The
+  // work on the input elements (e.g. the iterators created by an interleave)
+  // is parallelized, while the input dataset is read sequentially.
+  double parallel_time = self_time;
+  double sequential_time = 0.0;
+  for (const Node* input : inputs_) {
+    const double ratio = Ratio(*input);
+    const double input_time =
+        ratio * input->OutputTime(ratio > 0 ? self_time / ratio : 0.0);
+    if (input->nested_) {
+      parallel_time += input_time;
+    } else {
+      sequential_time += input_time;
+    }
+  }
+  const int64 num_threads = parallelism != parameters_.end()
+                                ? std::max<int64>(1, parallelism->second.value)
+                                : 1;
+  const double production_time =
+      std::max(parallel_time / num_threads, sequential_time);
+  return std::max(0.0, production_time - consumer_time);
+}
+
+double Model::Node::BufferedBytes() const {
+  int64 num_elements = 0;
+  for (const auto& parameter : parameters_) {
+    num_elements += parameter.second.value;
+  }
+  return num_elements * BytesPerElement();
+}
+
+void Model::Node::Decay() {
+  processing_time_ /= 2;
+  num_bytes_ /= 2;
+  num_elements_ /= 2;
+}
+
+Model::Node* Model::GetOrCreateNode(const string& name) {
+  const string canonical_name = CanonicalName(name);
+  auto it = nodes_.find(canonical_name);
+  if (it != nodes_.end()) {
+    return it->second.get();
+  }
+  Node* node = new Node(canonical_name);
+  nodes_[canonical_name].reset(node);
+
+  // The prefix of the iterator identifies its consumer. The first component
+  // ("Iterator") is not an iterator.
+  const size_t pos = canonical_name.rfind("::");
+  string output_name =
+      pos == string::npos ? "" : canonical_name.substr(0, pos);
+  if (output_name.find("::") == string::npos) {
+    outputs_.push_back(node);
+    return node;
+  }
+  if (str_util::EndsWith(output_name, "[]")) {
+    node->nested_ = true;
+    output_name.resize(output_name.size() - 2);
+  }
+  Node* output = GetOrCreateNode(output_name);
+  node->output_ = output;
+  output->inputs_.push_back(node);
+  return node;
+}
+
+void Model::AddParameter(const string& name, ParameterKind kind,
+                         const std::shared_ptr<SharedState>& state, int64 min,
+                         int64 max) {
+  int64 value;
+  {
+    mutex_lock l(mu_);
+    Node* node = GetOrCreateNode(name);
+    auto it = node->parameters_.find(kind);
+    if (it == node->parameters_.end()) {
+      Parameter parameter;
+      parameter.kind = kind;
+      parameter.min = min;
+      parameter.max = std::max(min, max);
+      parameter.value = std::min(std::max(state->value(), min), max);
+      it = node->parameters_.emplace(kind, std::move(parameter)).first;
+    }
+    Parameter& parameter = it->second;
+    parameter.states.erase(
+        std::remove_if(parameter.states.begin(), parameter.states.end(),
+                       [](const std::weak_ptr<SharedState>& state) {
+                         return state.expired();
+                       }),
+        parameter.states.end());
+    parameter.states.push_back(state);
+    value = parameter.value;
+    enabled_ = true;
+  }
+  // Iterators created for the elements of an interleave start with the value
+  // tuned for the iterators they replace.
+  if (state->value() != value) {
+    state->Set(value);
+  }
+}
+
+void Model::RecordStart(const string& name) {
+  const uint64 now = Env::Default()->NowMicros();
+  mutex_lock l(mu_);
+  Node* node = GetOrCreateNode(name);
+  std::vector<Frame>& frames = frames_[std::this_thread::get_id()];
+  if (!frames.empty() && !frames.back().waiting) {
+    Frame& output = frames.back();
+    output.node->processing_time_ += now - output.start_usecs;
+  }
+  frames.push_back({node, now, false});
+}
+
+void Model::RecordStop(const string& name, bool produced_element,
+                       int64 num_bytes) {
+  const uint64 now = Env::Default()->NowMicros();
+  mutex_lock l(mu_);
+  auto it = frames_.find(std::this_thread::get_id());
+  if (it == frames_.end() || it->second.empty()) {
+    return;
+  }
+  std::vector<Frame>& frames = it->second;
+  const Frame frame = frames.back();
+  frames.pop_back();
+  DCHECK_EQ(frame.node->name(), CanonicalName(name));
+  if (!frame.waiting) {
+    frame.node->processing_time_ += now - frame.start_usecs;
+  }
+  if (produced_element) {
+    frame.node->num_elements_++;
+    frame.node->num_bytes_ += num_bytes;
+  }
+  if (frames.empty()) {
+    frames_.erase(it);
+  } else {
+    frames.back().start_usecs = now;
+  }
+}
+
+void Model::RecordWaitStart(const string& name) {
+  const uint64 now = Env::Default()->NowMicros();
+  mutex_lock l(mu_);
+  auto it = frames_.find(std::this_thread::get_id());
+  if (it == frames_.end() || it->second.empty()) {
+    return;
+  }
+  Frame& frame = it->second.back();
+  DCHECK_EQ(frame.node->name(), CanonicalName(name));
+  if (!frame.waiting) {
+    frame.node->processing_time_ += now - frame.start_usecs;
+    frame.waiting = true;
+  }
+}
+
+void Model::RecordWaitStop(const string& name) {
+  const uint64 now = Env::Default()->NowMicros();
+  mutex_lock l(mu_);
+  auto it = frames_.find(std::this_thread::get_id());
+  if (it == frames_.end() || it->second.empty()) {
+    return;
+  }
+  Frame& frame = it->second.back();
+  DCHECK_EQ(frame.node->name(), CanonicalName(name));
+  frame.waiting = false;
+  frame.start_usecs = now;
+}
+
+void Model::AddProcessingTime(const string& name, int64 time_usecs) {
+  mutex_lock l(mu_);
+  GetOrCreateNode(name)->processing_time_ += time_usecs;
+}
+
+void Model::RecordBufferOccupancy(const string& name, int64 num_elements) {
+  mutex_lock l(mu_);
+  Node* node = GetOrCreateNode(name);
+  node->num_buffer_samples_++;
+  if (num_elements == 0) {
+    node->num_buffer_empty_++;
+  }
+  if (node->min_buffer_occupancy_ < 0 ||
+      num_elements < node->min_buffer_occupancy_) {
+    node->min_buffer_occupancy_ = num_elements;
+  }
+}
+
+double Model::OutputTimeLocked() {
+  double output_time = 0.0;
+  for (const Node* output : outputs_) {
+    output_time = std::max(output_time, output->OutputTime(0.0));
+  }
+  return output_time;
+}
+
+double Model::OutputTime() {
+  mutex_lock l(mu_);
+  return OutputTimeLocked();
+}
+
+void Model::Optimize(int64 cpu_budget, int64 ram_budget) {
+  std::vector<std::pair<std::shared_ptr<SharedState>, int64>> updates;
+  {
+    mutex_lock l(mu_);
+    std::vector<std::pair<Node*, Parameter*>> parallelism;
+    std::vector<std::pair<Node*, Parameter*>> buffers;
+    for (auto& it : nodes_) {
+      Node* node = it.second.get();
+      for (auto& parameter : node->parameters_) {
+        if (parameter.first == ParameterKind::kParallelism) {
+          parallelism.emplace_back(node, &parameter.second);
+        } else {
+          buffers.emplace_back(node, &parameter.second);
+        }
+      }
+    }
+
+    // Hill-climb the parallelism from its minimum, adding the thread that
+    // reduces the output time the most until the budget is exhausted or no
+    // thread helps. Starting over at each optimization lets the parallelism
+    // move back to the stages that need it when the pipeline changes.
+    int64 num_threads = 0;
+    double ram = 0.0;
+    for (auto& it : parallelism) {
+      it.second->value = it.second->min;
+      num_threads += it.second->value;
+    }
+    for (auto& it : nodes_) {
+      ram += it.second->BufferedBytes();
+    }
+    while (cpu_budget <= 0 || num_threads < cpu_budget) {
+      const double output_time = OutputTimeLocked();
+      Parameter* best = nullptr;
+      double best_output_time = output_time * (1.0 - kMinImprovement);
+      double best_bytes = 0.0;
+      for (auto& it : parallelism) {
+        Parameter* parameter = it.second;
+        const double bytes = it.first->BytesPerElement();
+        if (parameter->value >= parameter->max ||
+            (ram_budget > 0 && ram + bytes > ram_budget)) {
+          continue;
+        }
+        parameter->value++;
+        const double new_output_time = OutputTimeLocked();
+        parameter->value--;
+        if (new_output_time < best_output_time) {
+          best = parameter;
+          best_output_time = new_output_time;
+          best_bytes = bytes;
+        }
+      }
+      if (best == nullptr) {
+        break;
+      }
+      best->value++;
+      num_threads++;
+      ram += best_bytes;
+    }
+
+    // Grow the buffers that starved their consumer, and give back the part of
+    // the others that never drained.
+    for (auto& it : buffers) {
+      Node* node = it.first;
+      Parameter* parameter = it.second;
+      if (node->num_buffer_samples_ > 0) {
+        const double starved_fraction =
+            static_cast<double>(node->num_buffer_empty_) /
+            node->num_buffer_samples_;
+        if (starved_fraction > kMaxStarvedFraction) {
+          parameter->value = std::min(parameter->max, parameter->value * 2);
+        } else if (node->min_buffer_occupancy_ > 1) {
+          parameter->value =
+              std::max(parameter->min,
+                       parameter->value - node->min_buffer_occupancy_ / 2);
+        }
+      }
+      node->num_buffer_samples_ = 0;
+      node->num_buffer_empty_ = 0;
+      node->min_buffer_occupancy_ = -1;
+    }
+    if (ram_budget > 0) {
+      double buffered_bytes = 0.0;
+      for (auto& it : nodes_) {
+        buffered_bytes += it.second->BufferedBytes();
+      }
+      // Halve the largest buffers until the elements fit in memory.
+      while (buffered_bytes > ram_budget) {
+        std::pair<Node*, Parameter*> largest(nullptr, nullptr);
+        double largest_bytes = 0.0;
+        for (auto& it : buffers) {
+          const double bytes = it.second->value * it.first->BytesPerElement();
+          if (it.second->value > it.second->min && bytes > largest_bytes) {
+            largest = it;
+            largest_bytes = bytes;
+          }
+        }
+        if (largest.first == nullptr) {
+          break;
+        }
+        Parameter* parameter = largest.second;
+        const int64 value = std::max(parameter->min, parameter->value / 2);
+        buffered_bytes -=
+            (parameter->value - value) * largest.first->BytesPerElement();
+        parameter->value = value;
+      }
+    }
+
+    for (auto& it : nodes_) {
+      Node* node = it.second.get();
+      node->Decay();
+      for (auto& parameter : node->parameters_) {
+        for (const auto& weak_state : parameter.second.states) {
+          std::shared_ptr<SharedState> state = weak_state.lock();
+          if (state && state->value() != parameter.second.value) {
+            updates.emplace_back(std::move(state), parameter.second.value);
+          }
+        }
+      }
+    }
+  }
+  // The states notify the iterators, which must not happen while holding
+  // `mu_` since the iterators report to the model while holding their locks.
+  for (auto& update : updates) {
+    VLOG(2) << "Setting a tunable parameter to " << update.second;
+    update.first->Set(update.second);
+  }
+}
+
+}  // namespace model
+}  // namespace tensorflow
@@ -0,0 +1,233 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_FRAMEWORK_MODEL_H_
+#define TENSORFLOW_CORE_FRAMEWORK_MODEL_H_
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace model {
+
+// Value of a parameter (such as the `num_parallel_calls` of a
+// `ParallelMapDataset` or the `buffer_size` of a `PrefetchDataset`) requesting
+// that it is tuned by the model of the input pipeline.
+constexpr int64 kAutoTune = -1;
+
+// The kinds of tunable parameters.
+enum class ParameterKind {
+  // The number of elements an iterator produces concurrently. Each unit of
+  // parallelism uses a thread and holds an element in memory.
+  kParallelism,
+  // The number of produced elements an iterator buffers ahead of its
+  // consumer.
+  kBufferSize,
+};
+
+// The current value of a tunable parameter, shared between the iterator using
+// it and the model tuning it.
+//
+// The model calls `notify` after changing the value, so that the iterator can
+// wake up its threads waiting for more parallelism or buffer space. The
+// iterator must call `Disconnect()` before the state `notify` refers to is
+// destroyed.
+class SharedState {
+ public:
+  SharedState(int64 value, std::function<void()> notify)
+      : value_(value), notify_(std::move(notify)) {}
+
+  int64 value() const { return value_.load(); }
+
+  void Set(int64 value) {
+    mutex_lock l(mu_);
+    value_ = value;
+    if (notify_) {
+      notify_();
+    }
+  }
+
+  void Disconnect() {
+    mutex_lock l(mu_);
+    notify_ = nullptr;
+  }
+
+ private:
+  std::atomic<int64> value_;
+  mutex mu_;
+  std::function<void()> notify_ GUARDED_BY(mu_);
+};
+
+// A performance model of an input pipeline, used to allocate the CPU
+// parallelism and the buffer sizes of its iterators under a total thread and
+// memory budget.
+//
+// The iterators of the pipeline are identified by their prefix (e.g.
+// "Iterator::Prefetch::ParallelMap"), whose last component is the iterator and
+// whose remaining components are its consumer. The iterators created for the
+// input elements of an interleave or a flat map (e.g.
+// "Iterator::ParallelInterleaveV2[3]::TensorSlice") are aggregated regardless
+// of the element they were created for.
+//
+// Each iterator reports the time its threads spend producing elements (minus
+// the time spent in its inputs), the number and size of the elements it
+// produces, and, for buffering iterators, the occupancy of its buffer seen by
+// its consumer. From these, the model estimates the time needed to produce an
+// element of the output of the pipeline, and `Optimize()` hill-climbs the
+// parallelism of the iterators to minimize it, then grows the buffers that
+// starve their consumer and shrinks the ones that never drain.
+//
+// The iterators only report their activity once a tunable parameter has been
+// added, so that pipelines without any tuning incur no overhead.
+//
+// This class is thread-safe.
+class Model {
+ public:
+  Model() = default;
+
+  // Returns true if the model has tunable parameters, and should be kept
+  // informed of the activity of the iterators.
+  bool enabled() const { return enabled_.load(); }
+
+  // Adds a parameter of the iterator `name` to tune between `min` and `max`.
+  // The model only keeps a weak reference to `state`.
+  void AddParameter(const string& name, ParameterKind kind,
+                    const std::shared_ptr<SharedState>& state, int64 min,
+                    int64 max);
+
+  // Records that the calling thread starts producing an element of the
+  // iterator `name`. Until the matching `RecordStop()`, the time spent by the
+  // thread is attributed to `name`, except for the time spent in nested
+  // `RecordStart()` calls (e.g. from the input iterators) and between
+  // `RecordWaitStart()` and `RecordWaitStop()`.
+  void RecordStart(const string& name);
+
+  // Records that the calling thread is done producing an element of the
+  // iterator `name`. If it `produced_element`, `num_bytes` is its size.
+  void RecordStop(const string& name, bool produced_element, int64 num_bytes);
+
+  // Records that the calling thread waits for an element produced
+  // asynchronously by the iterator `name` (e.g. by its background threads),
+  // and when it resumes.
+  void RecordWaitStart(const string& name);
+  void RecordWaitStop(const string& name);
+
+  // Attributes work done asynchronously on behalf of the iterator `name`
+  // (e.g. a user-defined function run on another thread) to it.
+  void AddProcessingTime(const string& name, int64 time_usecs);
+
+  // Records the number of buffered elements of the iterator `name` when its
+  // consumer requests an element. Zero means that the consumer had to wait.
+  void RecordBufferOccupancy(const string& name, int64 num_elements);
+
+  // Reallocates the tunable parameters so that the iterators use at most
+  // `cpu_budget` threads in total, and buffer at most `ram_budget` bytes of
+  // elements (a non-positive budget is not enforced).
+  void Optimize(int64 cpu_budget, int64 ram_budget);
+
+  // Returns the estimated time in microseconds to produce an element of the
+  // output of the pipeline with the current values of the parameters.
+  double OutputTime();
+
+ private:
+  struct Parameter {
+    ParameterKind kind;
+    int64 min;
+    int64 max;
+    int64 value;
+    std::vector<std::weak_ptr<SharedState>> states;
+  };
+
+  class Node {
+   public:
+    explicit Node(const string& name) : name_(name) {}
+
+    const string& name() const { return name_; }
+
+    // Estimated time in microseconds for the consumer to get an element,
+    // given that it spends `consumer_time` microseconds between two
+    // requests.
+    double OutputTime(double consumer_time) const;
+
+    // Bytes buffered with the current values of the parameters.
+    double BufferedBytes() const;
+
+    double BytesPerElement() const {
+      return num_elements_ > 0 ? static_cast<double>(num_bytes_) /
+                                     num_elements_
+                               : 0;
+    }
+
+    // Halves the recorded activity, so that the model follows the changes in
+    // the behavior of the pipeline.
+    void Decay();
+
+   private:
+    friend class Model;
+
+    // Average number of elements consumed from `input` for each element
+    // produced.
+    double Ratio(const Node& input) const;
+
+    const string name_;
+    Node* output_ = nullptr;
+    // Whether the iterator is created for the input elements of the
+    // output (e.g. by an interleave), rather than being its input dataset.
+    bool nested_ = false;
+    std::vector<Node*> inputs_;
+    int64 processing_time_ = 0;
+    int64 num_elements_ = 0;
+    int64 num_bytes_ = 0;
+    // Buffer occupancy seen by the consumer since the last optimization.
+    int64 num_buffer_samples_ = 0;
+    int64 num_buffer_empty_ = 0;
+    int64 min_buffer_occupancy_ = -1;
+    std::map<ParameterKind, Parameter> parameters_;
+  };
+
+  // An iterator a thread is producing an element of.
+  struct Frame {
+    Node* node;
+    uint64 start_usecs;
+    bool waiting;
+  };
+
+  Node* GetOrCreateNode(const string& name) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  double OutputTimeLocked() EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  std::atomic<bool> enabled_{false};
+  mutex mu_;
+  std::unordered_map<string, std::unique_ptr<Node>> nodes_ GUARDED_BY(mu_);
+  // The iterators without consumer.
+  std::vector<Node*> outputs_ GUARDED_BY(mu_);
+  std::map<std::thread::id, std::vector<Frame>> frames_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(Model);
+};
+
+}  // namespace model
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_FRAMEWORK_MODEL_H_
@@ -0,0 +1,159 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/model.h"
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace model {
+namespace {
+
+// Records `num_elements` elements of `num_bytes` produced by `name`, which
+// spent `time_usecs` on each of them.
+void Produce(Model* model, const string& name, int64 num_elements,
+             int64 num_bytes, int64 time_usecs) {
+  for (int64 i = 0; i < num_elements; ++i) {
+    model->RecordStart(name);
+    model->RecordStop(name, true, num_bytes);
+  }
+  model->AddProcessingTime(name, num_elements * time_usecs);
+}
+
+TEST(ModelTest, EnabledByParameters) {
+  Model model;
+  EXPECT_FALSE(model.enabled());
+  auto state = std::make_shared<SharedState>(1, nullptr);
+  model.AddParameter("Iterator::ParallelMap", ParameterKind::kParallelism,
+                     state, 1, 8);
+  EXPECT_TRUE(model.enabled());
+  EXPECT_EQ(1, state->value());
+}
+
+TEST(ModelTest, SharedStateNotifies) {
+  int num_notifications = 0;
+  SharedState state(1, [&num_notifications]() { ++num_notifications; });
+  state.Set(2);
+  EXPECT_EQ(2, state.value());
+  EXPECT_EQ(1, num_notifications);
+  state.Disconnect();
+  state.Set(3);
+  EXPECT_EQ(3, state.value());
+  EXPECT_EQ(1, num_notifications);
+}
+
+TEST(ModelTest, ParallelismUsesCpuBudget) {
+  Model model;
+  auto state = std::make_shared<SharedState>(1, nullptr);
+  model.AddParameter("Iterator::ParallelMap", ParameterKind::kParallelism,
+                     state, 1, 8);
+  Produce(&model, "Iterator::ParallelMap", 10, 0, 1000);
+  const double output_time = model.OutputTime();
+  model.Optimize(4, 0);
+  EXPECT_EQ(4, state->value());
+  EXPECT_LT(model.OutputTime(), output_time);
+}
+
+TEST(ModelTest, ParallelismLimitedByRamBudget) {
+  Model model;
+  auto state = std::make_shared<SharedState>(1, nullptr);
+  model.AddParameter("Iterator::ParallelMap", ParameterKind::kParallelism,
+                     state, 1, 8);
+  Produce(&model, "Iterator::ParallelMap", 10, 1000, 1000);
+  model.Optimize(8, 2500);
+  EXPECT_EQ(2, state->value());
+}
+
+TEST(ModelTest, StarvedBufferGrows) {
+  Model model;
+  int num_notifications = 0;
+  auto state = std::make_shared<SharedState>(
+      1, [&num_notifications]() { ++num_notifications; });
+  model.AddParameter("Iterator::Prefetch", ParameterKind::kBufferSize, state,
+                     1, 16);
+  for (int i = 0; i < 10; ++i) {
+    model.RecordBufferOccupancy("Iterator::Prefetch", 0);
+  }
+  model.Optimize(8, 0);
+  EXPECT_EQ(2, state->value());
+  EXPECT_EQ(1, num_notifications);
+  for (int i = 0; i < 10; ++i) {
+    model.RecordBufferOccupancy("Iterator::Prefetch", 0);
+  }
+  model.Optimize(8, 0);
+  EXPECT_EQ(4, state->value());
+}
+
+TEST(ModelTest, UndrainedBufferShrinks) {
+  Model model;
+  auto state = std::make_shared<SharedState>(8, nullptr);
+  model.AddParameter("Iterator::Prefetch", ParameterKind::kBufferSize, state,
+                     1, 16);
+  model.RecordBufferOccupancy("Iterator::Prefetch", 6);
+  model.RecordBufferOccupancy("Iterator::Prefetch", 4);
+  model.RecordBufferOccupancy("Iterator::Prefetch", 5);
+  model.Optimize(8, 0);
+  EXPECT_EQ(6, state->value());
+}
+
+TEST(ModelTest, BufferLimitedByRamBudget) {
+  Model model;
+  auto state = std::make_shared<SharedState>(16, nullptr);
+  model.AddParameter("Iterator::Prefetch", ParameterKind::kBufferSize, state,
+                     1, 16);
+  Produce(&model, "Iterator::Prefetch", 10, 1000, 0);
+  model.Optimize(8, 5000);
+  EXPECT_EQ(4, state->value());
+}
+
+TEST(ModelTest, NestedIteratorsShareParameters) {
+  Model model;
+  auto state_0 = std::make_shared<SharedState>(1, nullptr);
+  model.AddParameter("Iterator::Interleave[0]::ParallelMap",
+                     ParameterKind::kParallelism, state_0, 1, 8);
+  Produce(&model, "Iterator::Interleave[0]::ParallelMap", 10, 0, 1000);
+  model.Optimize(4, 0);
+  EXPECT_EQ(4, state_0->value());
+
+  // The iterator created for the next input element starts where the previous
+  // one was tuned to.
+  auto state_1 = std::make_shared<SharedState>(1, nullptr);
+  model.AddParameter("Iterator::Interleave[1]::ParallelMap",
+                     ParameterKind::kParallelism, state_1, 1, 8);
+  EXPECT_EQ(4, state_1->value());
+}
+
+TEST(ModelTest, InputTimeLimitsParallelism) {
+  Model model;
+  auto state = std::make_shared<SharedState>(1, nullptr);
+  model.AddParameter("Iterator::ParallelMap", ParameterKind::kParallelism,
+                     state, 1, 16);
+  // The map spends 400us on each element, and its input 100us, which the
+  // parallel calls cannot overlap.
+  for (int i = 0; i < 10; ++i) {
+    model.RecordStart("Iterator::ParallelMap");
+    model.RecordStart("Iterator::ParallelMap::Range");
+    model.RecordStop("Iterator::ParallelMap::Range", true, 0);
+    model.RecordStop("Iterator::ParallelMap", true, 0);
+  }
+  model.AddProcessingTime("Iterator::ParallelMap", 10 * 400);
+  model.AddProcessingTime("Iterator::ParallelMap::Range", 10 * 100);
+  model.Optimize(16, 0);
+  EXPECT_EQ(4, state->value());
+}
+
+}  // namespace
+}  // namespace model
+}  // namespace tensorflow
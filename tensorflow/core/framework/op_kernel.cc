@@ -669,9 +669,8 @@ Status OpKernelContext::allocate_output(StringPiece name,
 }
 
 Status OpKernelContext::allocate_tensor(
-    DataType type, const TensorShape& shape, Tensor* out_tensor,
-    AllocatorAttributes attr, const AllocationAttributes& allocation_attr) {
-  Allocator* a = get_allocator(attr);
+    Allocator* a, DataType type, const TensorShape& shape, Tensor* out_tensor,
+    const AllocationAttributes& allocation_attr) {
   AllocationAttributes logged_attr(allocation_attr);
   logged_attr.allocation_will_be_logged = true;
   Tensor new_tensor(a, type, shape, logged_attr);
@@ -700,7 +699,22 @@ Status OpKernelContext::allocate_output(int index, const TensorShape& shape,
   DCHECK(!IsRefType(type));
   DCHECK(mutable_output(index) == nullptr);
   Tensor* output_tensor = new Tensor();
-  Status s = allocate_tensor(type, shape, output_tensor, attr);
+  Status s;
+  const Tensor* destination = params_->output_destinations != nullptr
+                                  ? params_->output_destinations[index]
+                                  : nullptr;
+  if (TF_PREDICT_FALSE(destination != nullptr) &&
+      destination->dtype() == type && destination->shape() == shape &&
+      attr.scope_id == 0) {
+    // Shares the buffer of the caller.
+    *output_tensor = *destination;
+  } else if (TF_PREDICT_FALSE(params_->planned_output_allocator != nullptr) &&
+      attr.value == 0 && attr.scope_id == 0 && !track_allocations()) {
+    s = allocate_tensor(params_->planned_output_allocator, type, shape,
+                        output_tensor, AllocationAttributes());
+  } else {
+    s = allocate_tensor(type, shape, output_tensor, attr);
+  }
   if (s.ok()) {
     outputs_[index] = TensorValue(output_tensor);
     *output = outputs_[index].tensor;
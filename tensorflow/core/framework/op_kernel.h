@@ -522,6 +522,15 @@ class OpKernelContext {
     // Array indexed by output number for this node
     const AllocatorAttributes* output_attr_array = nullptr;
 
+    // If set, the outputs allocated in plain device memory come from this
+    // allocator rather than from the device, see PlannedAllocator.
+    Allocator* planned_output_allocator = nullptr;
+
+    // If set, array indexed by output number of the tensors the outputs of
+    // the right type and shape are written into, or nullptr. See
+    // CallFrameInterface::GetRetvalDestination.
+    const Tensor* const* output_destinations = nullptr;
+
     // Shared resources accessible by this op kernel invocation.
     ResourceMgr* resource_manager = nullptr;
 
@@ -1122,6 +1131,13 @@ class OpKernelContext {
 
   Status allocate_tensor(DataType type, const TensorShape& shape,
                          Tensor* out_tensor, AllocatorAttributes allocator_attr,
+                         const AllocationAttributes& allocation_attr) {
+    return allocate_tensor(get_allocator(allocator_attr), type, shape,
+                           out_tensor, allocation_attr);
+  }
+
+  Status allocate_tensor(Allocator* a, DataType type, const TensorShape& shape,
+                         Tensor* out_tensor,
                          const AllocationAttributes& allocation_attr);
 
   // This is called by PersistentTensor::AccessTensor whenever the
@@ -15,8 +15,8 @@ limitations under the License.
 
 #include "tensorflow/core/framework/rendezvous.h"
 
-#include <deque>
 #include <functional>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -155,20 +155,21 @@ class LocalRendezvousImpl : public Rendezvous {
     uint64 key_hash = KeyHash(key.FullKey());
     VLOG(2) << "Send " << this << " " << key_hash << " " << key.FullKey();
 
-    mu_.lock();
-    if (!status_.ok()) {
+    Shard* shard = ShardFor(key_hash);
+    shard->mu.lock();
+    if (!shard->status.ok()) {
       // Rendezvous has been aborted.
-      Status s = status_;
-      mu_.unlock();
+      Status s = shard->status;
+      shard->mu.unlock();
       return s;
     }
 
-    ItemQueue* queue = &table_[key_hash];
+    ItemQueue* queue = &shard->table[key_hash];
     if (queue->empty() || queue->front()->IsSendValue()) {
       // There is no waiter for this message. Append the message
       // into the queue. The waiter will pick it up when arrives.
       // Only send-related fields need to be filled.
-      Item* item = new Item;
+      Item* item = shard->NewItem();
       item->value = val;
       item->is_dead = is_dead;
       item->send_args = send_args;
@@ -176,20 +177,25 @@ class LocalRendezvousImpl : public Rendezvous {
         item->send_args.device_context->Ref();
       }
       queue->push_back(item);
-      mu_.unlock();
+      shard->mu.unlock();
       return Status::OK();
     }
 
-    // There is an earliest waiter to consume this message.
-    Item* item = queue->front();
-    queue->pop_front();
-    mu_.unlock();
+    // There is an earliest waiter to consume this message. Take it out of
+    // its item, which can then be reused right away.
+    Item* item = queue->pop_front();
+    DCHECK(!item->IsSendValue());
+    DoneCallback waiter = std::move(item->waiter);
+    const Args recv_args = item->recv_args;
+    shard->FreeItem(item);
+    shard->mu.unlock();
 
     // Notify the waiter by invoking its done closure, outside the
     // lock.
-    DCHECK(!item->IsSendValue());
-    item->waiter(Status::OK(), send_args, item->recv_args, val, is_dead);
-    delete item;
+    waiter(Status::OK(), send_args, recv_args, val, is_dead);
+    if (recv_args.device_context) {
+      recv_args.device_context->Unref();
+    }
     return Status::OK();
   }
 
@@ -198,57 +204,72 @@ class LocalRendezvousImpl : public Rendezvous {
     uint64 key_hash = KeyHash(key.FullKey());
     VLOG(2) << "Recv " << this << " " << key_hash << " " << key.FullKey();
 
-    mu_.lock();
-    if (!status_.ok()) {
+    Shard* shard = ShardFor(key_hash);
+    shard->mu.lock();
+    if (!shard->status.ok()) {
       // Rendezvous has been aborted.
-      Status s = status_;
-      mu_.unlock();
+      Status s = shard->status;
+      shard->mu.unlock();
       done(s, Args(), recv_args, Tensor(), false);
       return;
     }
 
-    ItemQueue* queue = &table_[key_hash];
+    ItemQueue* queue = &shard->table[key_hash];
     if (queue->empty() || !queue->front()->IsSendValue()) {
       // There is no message to pick up.
       // Only recv-related fields need to be filled.
-      Item* item = new Item;
+      Item* item = shard->NewItem();
       item->waiter = std::move(done);
       item->recv_args = recv_args;
       if (item->recv_args.device_context) {
         item->recv_args.device_context->Ref();
       }
       queue->push_back(item);
-      mu_.unlock();
+      shard->mu.unlock();
       return;
     }
 
     // A message has already arrived and is queued in the table under
-    // this key.  Consumes the message and invokes the done closure.
-    Item* item = queue->front();
-    queue->pop_front();
-    mu_.unlock();
+    // this key. Consumes the message, releasing its item.
+    Item* item = queue->pop_front();
+    DCHECK(item->IsSendValue());
+    const Tensor value = std::move(item->value);
+    const bool is_dead = item->is_dead;
+    const Args send_args = item->send_args;
+    shard->FreeItem(item);
+    shard->mu.unlock();
 
     // Invokes the done() by invoking its done closure, outside scope
     // of the table lock.
-    DCHECK(item->IsSendValue());
-    done(Status::OK(), item->send_args, recv_args, item->value, item->is_dead);
-    delete item;
+    done(Status::OK(), send_args, recv_args, value, is_dead);
+    if (send_args.device_context) {
+      send_args.device_context->Unref();
+    }
   }
 
   void StartAbort(const Status& status) override {
     CHECK(!status.ok());
-    Table table;
-    {
-      mutex_lock l(mu_);
-      status_.Update(status);
-      table_.swap(table);
-    }
-    for (auto& p : table) {
-      for (Item* item : p.second) {
-        if (!item->IsSendValue()) {
-          item->waiter(status, Args(), Args(), Tensor(), false);
+    for (Shard& shard : shards_) {
+      Table table;
+      {
+        mutex_lock l(shard.mu);
+        shard.status.Update(status);
+        shard.table.swap(table);
+      }
+      std::vector<Item*> items;
+      for (auto& p : table) {
+        while (!p.second.empty()) {
+          Item* item = p.second.pop_front();
+          if (!item->IsSendValue()) {
+            item->waiter(status, Args(), Args(), Tensor(), false);
+          }
+          ReleaseItem(item);
+          items.push_back(item);
         }
-        delete item;
+      }
+      mutex_lock l(shard.mu);
+      for (Item* item : items) {
+        shard.FreeItem(item);
       }
     }
   }
@@ -262,20 +283,27 @@ class LocalRendezvousImpl : public Rendezvous {
     bool is_dead = false;
     Args send_args;
     Args recv_args;
-
-    ~Item() {
-      if (send_args.device_context) {
-        send_args.device_context->Unref();
-      }
-      if (recv_args.device_context) {
-        recv_args.device_context->Unref();
-      }
-    }
+    // The next item in the same queue, or in the free list.
+    Item* next = nullptr;
 
     // Returns true iff this item represents a value being sent.
     bool IsSendValue() const { return this->waiter == nullptr; }
   };
 
+  // Drops the references held by a queued item.
+  static void ReleaseItem(Item* item) {
+    item->waiter = nullptr;
+    item->value = Tensor();
+    if (item->send_args.device_context) {
+      item->send_args.device_context->Unref();
+    }
+    if (item->recv_args.device_context) {
+      item->recv_args.device_context->Unref();
+    }
+    item->send_args = Args();
+    item->recv_args = Args();
+  }
+
   // We key the hash table by KeyHash of the Rendezvous::CreateKey string
   static uint64 KeyHash(const StringPiece& k) {
     return Hash64(k.data(), k.size());
@@ -286,17 +314,99 @@ class LocalRendezvousImpl : public Rendezvous {
   // or
   //   [!item.IsSendValue()]* meaning each item is a waiter.
   //
-  // TODO(zhifengc): consider a better queue impl than std::deque.
-  typedef std::deque<Item*> ItemQueue;
+  // The queue is intrusive, so that it needs no allocation of its own.
+  class ItemQueue {
+   public:
+    bool empty() const { return head_ == nullptr; }
+    Item* front() const { return head_; }
+    void push_back(Item* item) {
+      item->next = nullptr;
+      if (tail_ == nullptr) {
+        head_ = item;
+      } else {
+        tail_->next = item;
+      }
+      tail_ = item;
+    }
+    Item* pop_front() {
+      Item* item = head_;
+      head_ = item->next;
+      if (head_ == nullptr) {
+        tail_ = nullptr;
+      }
+      item->next = nullptr;
+      return item;
+    }
+
+   private:
+    Item* head_ = nullptr;
+    Item* tail_ = nullptr;
+  };
   typedef gtl::FlatMap<uint64, ItemQueue> Table;
 
-  // TODO(zhifengc): shard table_.
-  mutex mu_;
-  Table table_ GUARDED_BY(mu_);
-  Status status_ GUARDED_BY(mu_);
+  // The keys are spread over several independently locked tables, so that
+  // the many edges of a step do not all contend for a single lock.
+  static constexpr int kLogNumShards = 4;
+  static constexpr int kNumShards = 1 << kLogNumShards;
+  // Items are allocated in slabs of growing size and recycled, rather than
+  // allocated for every message.
+  static constexpr int kMinItemsPerSlab = 8;
+  static constexpr int kLogNumItemsPerSlabGrowth = 5;
+  static constexpr int kMaxItemsPerSlab =
+      kMinItemsPerSlab << kLogNumItemsPerSlabGrowth;
+
+  struct Shard {
+    mutex mu;
+    Table table GUARDED_BY(mu);
+    Status status GUARDED_BY(mu);
+    Item* free_items GUARDED_BY(mu) = nullptr;
+    std::vector<std::unique_ptr<Item[]>> slabs GUARDED_BY(mu);
+
+    Item* NewItem() EXCLUSIVE_LOCKS_REQUIRED(mu) {
+      if (free_items == nullptr) {
+        int n = kMaxItemsPerSlab;
+        if (slabs.size() < kLogNumItemsPerSlabGrowth) {
+          n = kMinItemsPerSlab << slabs.size();
+        }
+        slabs.emplace_back(new Item[n]);
+        Item* slab = slabs.back().get();
+        for (int i = 0; i < n; ++i) {
+          slab[i].next = free_items;
+          free_items = &slab[i];
+        }
+      }
+      Item* item = free_items;
+      free_items = item->next;
+      item->next = nullptr;
+      return item;
+    }
+
+    // Recycles an item whose value, callback and device contexts have been
+    // taken out or released.
+    void FreeItem(Item* item) EXCLUSIVE_LOCKS_REQUIRED(mu) {
+      item->waiter = nullptr;
+      item->value = Tensor();
+      item->is_dead = false;
+      item->next = free_items;
+      free_items = item;
+    }
+  };
+
+  // The table is picked with the high bits of the hash, as FlatMap uses the
+  // low ones.
+  Shard* ShardFor(uint64 key_hash) {
+    return &shards_[key_hash >> (64 - kLogNumShards)];
+  }
+
+  Shard shards_[kNumShards];
 
   ~LocalRendezvousImpl() override {
-    if (!table_.empty()) {
+    bool empty = true;
+    for (Shard& shard : shards_) {
+      mutex_lock l(shard.mu);
+      empty = empty && shard.table.empty();
+    }
+    if (!empty) {
       StartAbort(errors::Cancelled("LocalRendezvousImpl deleted"));
     }
   }
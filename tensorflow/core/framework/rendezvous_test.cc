@@ -272,6 +272,39 @@ TEST_F(LocalRendezvousTest, AbortThenRecvOrSend) {
       errors::IsAborted(rendez_->Recv(KeyFoo(), args, &val, &val_dead)));
 }
 
+// Leaves many messages and waiters pending on different keys, so that they
+// span all the tables and several item slabs, before aborting.
+TEST_F(LocalRendezvousTest, ManyKeysAbort) {
+  static const int N = 1000;
+  Rendezvous::Args args;
+  for (int i = 0; i < N; ++i) {
+    TF_ASSERT_OK(rendez_->Send(MakeKey(strings::StrCat("send", i)), args,
+                               V(strings::StrCat(i)), false));
+  }
+  // Consumes half of the messages, whose items get reused below.
+  Tensor val;
+  bool val_dead = false;
+  for (int i = 0; i < N; i += 2) {
+    TF_ASSERT_OK(rendez_->Recv(MakeKey(strings::StrCat("send", i)), args,
+                               &val, &val_dead));
+    EXPECT_EQ(strings::StrCat(i), V(val));
+  }
+  int num_aborted = 0;
+  for (int i = 0; i < N; ++i) {
+    rendez_->RecvAsync(MakeKey(strings::StrCat("recv", i)), args,
+                       [&num_aborted](const Status& status,
+                                      const Rendezvous::Args& sender_args,
+                                      const Rendezvous::Args& recver_args,
+                                      const Tensor& val, const bool val_dead) {
+                         EXPECT_TRUE(errors::IsAborted(status));
+                         ++num_aborted;
+                       });
+  }
+  EXPECT_EQ(0, num_aborted);
+  rendez_->StartAbort(errors::Aborted(""));
+  EXPECT_EQ(N, num_aborted);
+}
+
 class DummyDeviceContext : public DeviceContext {
  public:
   explicit DummyDeviceContext(int stream_id) : stream_id_(stream_id) {}
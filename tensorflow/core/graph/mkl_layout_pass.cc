@@ -3597,6 +3597,15 @@ void MklLayoutRewritePass::CopyAttrsConv2D(const Node* orig_node,
   nb->Attr("padding", padding);
   nb->Attr("data_format", data_format);
   nb->Attr("use_cudnn_on_gpu", use_cudnn_on_gpu);
+
+  // The forward convolutions reorder a constant filter only once, so tell
+  // them whether it is one, as in inference graphs.
+  if (orig_node->type_string() == csinfo_.conv2d ||
+      orig_node->type_string() == csinfo_.conv2d_with_bias) {
+    const Node* filter = nullptr;
+    TF_CHECK_OK(orig_node->input_node(1, &filter));
+    nb->Attr("is_filter_const", filter->IsConstant());
+  }
 }
 
 void MklLayoutRewritePass::CopyAttrsAddN(const Node* orig_node,
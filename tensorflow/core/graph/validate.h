@@ -25,7 +25,9 @@ namespace graph {
 
 // Returns OK if every NodeDef in `graph_def` is valid with respect to
 // its corresponding OpDef (as defined by ValidateNodeDef()) as
-// registered in `op_registry`.  Also checks for deprecated ops.
+// registered in `op_registry`.  Also checks for deprecated ops.  Large
+// graphs are validated on several threads, so `op_registry` must be safe to
+// use concurrently.
 //
 // REQUIRES:
 //  * `op_registry` is not nullptr.
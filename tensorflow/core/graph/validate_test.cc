@@ -24,9 +24,11 @@ limitations under the License.
 #include "tensorflow/core/graph/graph_def_builder.h"
 #include "tensorflow/core/graph/subgraph.h"
 #include "tensorflow/core/kernels/ops_util.h"
+#include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/test.h"
 
 namespace tensorflow {
@@ -95,6 +97,25 @@ TEST(ValidateGraphDefTest, GraphWithUnspecifiedRequiredAttr) {
   EXPECT_TRUE(str_util::StrContains(s.ToString(), "NodeDef missing attr"));
 }
 
+TEST(ValidateGraphDefTest, LargeGraphReportsFirstInvalidNode) {
+  // Large enough to be validated on several threads.
+  GraphDef graph_def;
+  for (int i = 0; i < 10000; ++i) {
+    NodeDef* node_def = graph_def.add_node();
+    node_def->set_name(strings::StrCat("n", i));
+    node_def->set_op("FloatInput");
+  }
+  graph_def.mutable_node(6000)->set_op("UnknownOpA");
+  graph_def.mutable_node(9000)->set_op("UnknownOpB");
+  Status s = graph::ValidateGraphDef(graph_def, *OpRegistry::Global());
+  EXPECT_TRUE(errors::IsNotFound(s)) << s;
+  EXPECT_TRUE(str_util::StrContains(s.ToString(), "UnknownOpA")) << s;
+
+  graph_def.mutable_node(6000)->set_op("Int32Input");
+  graph_def.mutable_node(9000)->set_op("Int32Input");
+  TF_EXPECT_OK(graph::ValidateGraphDef(graph_def, *OpRegistry::Global()));
+}
+
 TEST(ValidateGraphDefAgainstOpListTest, GraphWithOpOnlyInOpList) {
   OpRegistrationData op_reg_data;
   TF_ASSERT_OK(OpDefBuilder("UniqueSnowflake").Finalize(&op_reg_data));
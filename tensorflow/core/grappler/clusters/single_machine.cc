@@ -109,6 +109,13 @@ Status SingleMachine::Provision() {
                                    tf_gpu_id.value(), ": ", s.ToString());
       }
       attr = GetLocalGPUInfo(cuda_gpu_id);
+    } else if (dev.device_type() == "SYCL") {
+      DeviceNameUtils::ParsedName parsed;
+      if (!DeviceNameUtils::ParseFullName(dev.name(), &parsed)) {
+        return errors::InvalidArgument(strings::StrCat(
+            "Not able to parse SYCL device name: ", dev.name()));
+      }
+      attr = GetLocalSYCLInfo(parsed.id);
     } else if (dev.device_type().find("XLA") == string::npos) {
       // Filter out the fake XLA devices to avoid double counting the actual
       // hardware resources that are available.
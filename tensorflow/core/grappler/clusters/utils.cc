@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "tensorflow/core/grappler/clusters/utils.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "third_party/eigen3/Eigen/Core"
 
 #if GOOGLE_CUDA
@@ -27,14 +30,20 @@ limitations under the License.
 #include "include/libxsmm.h"
 #endif
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#endif
+
 #include "tensorflow/core/common_runtime/gpu/gpu_id.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_id_manager.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/byte_order.h"
 #include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/mem.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -119,6 +128,156 @@ DeviceProperties GetLocalGPUInfo(CudaGpuId cuda_gpu_id) {
   return device;
 }
 
+#ifdef TENSORFLOW_USE_SYCL
+namespace {
+
+// Returns the SYCL devices in the order used by GSYCLInterface to register
+// them: accelerators, GPUs, CPUs and finally the host device.
+std::vector<cl::sycl::device> GetSYCLDevices() {
+  auto device_list = Eigen::get_sycl_supported_devices();
+  std::vector<cl::sycl::device> devices;
+  for (const auto& d : device_list) {
+    if (d.is_accelerator()) devices.push_back(d);
+  }
+  for (const auto& d : device_list) {
+    if (d.is_gpu()) devices.push_back(d);
+  }
+  for (const auto& d : device_list) {
+    if (d.is_cpu()) devices.push_back(d);
+  }
+  for (const auto& d : device_list) {
+    if (d.is_host()) devices.push_back(d);
+  }
+  return devices;
+}
+
+// Returns the number of single precision multiply-add per cycle of a compute
+// unit. OpenCL does not expose it so it is derived from the vendor, the
+// numbers being those of the recent architectures of each vendor.
+int GetSYCLFmaPerComputeUnit(const cl::sycl::device& d, const string& vendor) {
+  const int vector_width =
+      d.get_info<cl::sycl::info::device::native_vector_width_float>();
+  if (d.is_cpu() || d.is_host()) {
+    // Most CPUs have two FMA units per core
+    return 2 * std::max(vector_width, 1);
+  }
+  const string lower_vendor = str_util::Lowercase(vendor);
+  if (str_util::StrContains(lower_vendor, "nvidia")) {
+    // Streaming multiprocessors since Maxwell
+    return 128;
+  } else if (str_util::StrContains(lower_vendor, "advanced micro devices") ||
+             str_util::StrContains(lower_vendor, "amd")) {
+    // GCN compute units
+    return 64;
+  } else if (str_util::StrContains(lower_vendor, "intel")) {
+    // Gen9 execution units
+    return 8;
+  } else if (str_util::StrContains(lower_vendor, "arm")) {
+    // Bifrost shader cores
+    return 12;
+  } else if (str_util::StrContains(lower_vendor, "imagination")) {
+    // PowerVR unified shading clusters
+    return 16;
+  }
+  return std::max(vector_width, 1);
+}
+
+// Returns the data format the convolutions of the device run fastest with.
+// SYCL-DNN computes in NHWC, while the in-tree direct kernels handle NCHW
+// without transposing, which some devices favour.
+// TF_SYCL_PREFERRED_DATA_FORMAT is either the format of all the devices, or
+// a comma separated list of the formats of each device, e.g. "NCHW,NHWC".
+string GetSYCLPreferredDataFormat(int sycl_device_id) {
+  string formats;
+  Status status =
+      ReadStringFromEnvVar("TF_SYCL_PREFERRED_DATA_FORMAT", "NHWC", &formats);
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+  }
+  std::vector<string> per_device =
+      str_util::Split(str_util::Uppercase(formats), ',');
+  string format = "NHWC";
+  if (per_device.size() == 1) {
+    format = per_device[0];
+  } else if (sycl_device_id < static_cast<int>(per_device.size())) {
+    format = per_device[sycl_device_id];
+  }
+  if (format != "NCHW" && format != "NHWC") {
+    LOG(ERROR) << "Invalid SYCL data format " << format << ", using NHWC";
+    format = "NHWC";
+  }
+  return format;
+}
+
+}  // namespace
+#endif  // TENSORFLOW_USE_SYCL
+
+DeviceProperties GetLocalSYCLInfo(int sycl_device_id) {
+  DeviceProperties device;
+  device.set_type("UNKNOWN");
+
+#ifdef TENSORFLOW_USE_SYCL
+  const auto devices = GetSYCLDevices();
+  if (sycl_device_id < 0 ||
+      sycl_device_id >= static_cast<int>(devices.size())) {
+    LOG(ERROR) << "Invalid SYCL device id " << sycl_device_id;
+    return device;
+  }
+  const cl::sycl::device& d = devices[sycl_device_id];
+  device.set_type("SYCL");
+  const string vendor = d.get_info<cl::sycl::info::device::vendor>();
+  device.set_vendor(vendor);
+  device.set_model(d.get_info<cl::sycl::info::device::name>());
+  // Both are in MHz
+  device.set_frequency(
+      d.get_info<cl::sycl::info::device::max_clock_frequency>());
+  device.set_num_cores(
+      d.get_info<cl::sycl::info::device::max_compute_units>());
+  device.set_memory_size(
+      d.get_info<cl::sycl::info::device::global_mem_size>());
+  device.set_l2_cache_size(
+      d.get_info<cl::sycl::info::device::global_mem_cache_size>());
+  device.set_shared_memory_size_per_multiprocessor(
+      d.get_info<cl::sycl::info::device::local_mem_size>());
+
+  // OpenCL does not expose the memory bandwidth. Devices sharing the host
+  // memory are assumed to have dual channel DDR4, discrete devices GDDR5.
+  // TF_SYCL_DEVICE_BANDWIDTH_GBPS overrides the estimate.
+  const bool host_unified_memory =
+      d.get_info<cl::sycl::info::device::host_unified_memory>();
+  int64 bandwidth_gbps = 0;
+  Status status = ReadInt64FromEnvVar("TF_SYCL_DEVICE_BANDWIDTH_GBPS",
+                                      host_unified_memory ? 25 : 256,
+                                      &bandwidth_gbps);
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+  }
+  // In KB/s
+  device.set_bandwidth(bandwidth_gbps * 1000000);
+
+  auto& environment = *device.mutable_environment();
+  if (d.is_gpu()) {
+    environment["sycl_device_type"] = "GPU";
+  } else if (d.is_cpu()) {
+    environment["sycl_device_type"] = "CPU";
+  } else if (d.is_accelerator()) {
+    environment["sycl_device_type"] = "ACCELERATOR";
+  } else {
+    environment["sycl_device_type"] = "HOST";
+  }
+  environment["fma_per_core"] =
+      strings::StrCat(GetSYCLFmaPerComputeUnit(d, vendor));
+  environment["opencl_version"] =
+      d.get_info<cl::sycl::info::device::version>();
+  environment["driver_version"] =
+      d.get_info<cl::sycl::info::device::driver_version>();
+  environment["preferred_data_format"] =
+      GetSYCLPreferredDataFormat(sycl_device_id);
+#endif  // TENSORFLOW_USE_SYCL
+
+  return device;
+}
+
 DeviceProperties GetDeviceInfo(const DeviceNameUtils::ParsedName& device) {
   DeviceProperties unknown;
   unknown.set_type("UNKNOWN");
@@ -138,6 +297,8 @@ DeviceProperties GetDeviceInfo(const DeviceNameUtils::ParsedName& device) {
     } else {
       return GetLocalGPUInfo(CudaGpuId(0));
     }
+  } else if (device.type == "SYCL") {
+    return GetLocalSYCLInfo(device.has_id ? device.id : 0);
   }
   return unknown;
 }
@@ -30,6 +30,11 @@ DeviceProperties GetLocalCPUInfo();
 // which grappler is running.
 DeviceProperties GetLocalGPUInfo(CudaGpuId cuda_gpu_id);
 
+// Returns the DeviceProperties for the specified SYCL device attached to the
+// server on which grappler is running. SYCL devices are numbered in the same
+// order as the TensorFlow SYCL devices.
+DeviceProperties GetLocalSYCLInfo(int sycl_device_id);
+
 // Returns the DeviceProperties of the specified device
 DeviceProperties GetDeviceInfo(const DeviceNameUtils::ParsedName& device);
 
@@ -104,6 +104,34 @@ TEST(UtilsTest, GetDeviceInfo) {
 #endif
 }
 
+TEST(UtilsTest, GetLocalSYCLInfo) {
+  DeviceProperties properties;
+
+  // Invalid SYCL device id.
+  properties = GetLocalSYCLInfo(100);
+  EXPECT_EQ("UNKNOWN", properties.type());
+
+#ifdef TENSORFLOW_USE_SYCL
+  properties = GetLocalSYCLInfo(0);
+  EXPECT_EQ("SYCL", properties.type());
+  EXPECT_LT(0, properties.num_cores());
+  EXPECT_LT(0, properties.frequency());
+  EXPECT_LT(0, properties.memory_size());
+  EXPECT_LT(0, properties.bandwidth());
+  EXPECT_EQ(1, properties.environment().count("fma_per_core"));
+
+  DeviceNameUtils::ParsedName device;
+  device.type = "SYCL";
+  device.has_id = true;
+  device.id = 0;
+  properties = GetDeviceInfo(device);
+  EXPECT_EQ("SYCL", properties.type());
+#else
+  properties = GetLocalSYCLInfo(0);
+  EXPECT_EQ("UNKNOWN", properties.type());
+#endif  // TENSORFLOW_USE_SYCL
+}
+
 }  // namespace
 }  // namespace grappler
 }  // namespace tensorflow
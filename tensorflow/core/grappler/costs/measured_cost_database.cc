@@ -0,0 +1,190 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/costs/measured_cost_database.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "tensorflow/core/grappler/costs/robust_stats.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace grappler {
+
+namespace {
+
+// Number of most recent measurements kept per op.
+constexpr int kMaxMeasurements = 32;
+
+uint64 FingerprintShape(const TensorShapeProto& shape) {
+  if (shape.unknown_rank()) return Fingerprint64("unknown_rank");
+  uint64 fp = shape.dim_size();
+  for (const auto& dim : shape.dim()) {
+    fp = FingerprintCat64(fp, dim.size());
+  }
+  return fp;
+}
+
+}  // namespace
+
+MeasuredCostDatabase* MeasuredCostDatabase::Global() {
+  static MeasuredCostDatabase* database = []() -> MeasuredCostDatabase* {
+    string path;
+    Status status =
+        ReadStringFromEnvVar("TF_GRAPPLER_MEASURED_COSTS", "", &path);
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to read TF_GRAPPLER_MEASURED_COSTS: " << status;
+      return nullptr;
+    }
+    if (path.empty()) return nullptr;
+    auto* database = new MeasuredCostDatabase(path);
+    if (Env::Default()->FileExists(path).ok()) {
+      status = database->Load(path);
+      if (!status.ok()) {
+        LOG(WARNING) << "Failed to load measured op costs from " << path
+                     << ": " << status;
+      } else {
+        VLOG(1) << "Loaded measured costs of " << database->size()
+                << " ops from " << path;
+      }
+    }
+    return database;
+  }();
+  return database;
+}
+
+uint64 MeasuredCostDatabase::OpKey(const OpInfo& op_info) {
+  uint64 fp = Fingerprint64(op_info.op());
+  fp = FingerprintCat64(fp, Fingerprint64(op_info.device().type()));
+
+  // Internal attributes (e.g. colocation constraints) don't change the cost of
+  // an op. Sort the others by name to get a stable key.
+  std::map<string, const AttrValue*> attrs;
+  for (const auto& attr : op_info.attr()) {
+    if (attr.first.empty() || attr.first[0] == '_') continue;
+    attrs.emplace(attr.first, &attr.second);
+  }
+  for (const auto& attr : attrs) {
+    string serialized;
+    SerializeToStringDeterministic(*attr.second, &serialized);
+    fp = FingerprintCat64(fp, Fingerprint64(attr.first));
+    fp = FingerprintCat64(fp, Fingerprint64(serialized));
+  }
+
+  fp = FingerprintCat64(fp, op_info.inputs_size());
+  for (const auto& input : op_info.inputs()) {
+    fp = FingerprintCat64(fp, input.dtype());
+    fp = FingerprintCat64(fp, FingerprintShape(input.shape()));
+  }
+  return fp;
+}
+
+void MeasuredCostDatabase::UpdateCosts(Entry* entry) {
+  std::vector<double> samples(entry->compute_costs_ns.begin(),
+                              entry->compute_costs_ns.end());
+  const double compute_cost_ns = RobustStats(std::move(samples)).mean();
+
+  Costs& costs = entry->costs;
+  costs = Costs::ZeroCosts();
+  costs.execution_time = Costs::NanoSeconds(compute_cost_ns);
+  costs.compute_time = costs.execution_time;
+  costs.temporary_memory = entry->temporary_memory;
+  costs.persistent_memory = entry->persistent_memory;
+  costs.inaccurate = false;
+}
+
+void MeasuredCostDatabase::Add(const OpPerformance& perf) {
+  const uint64 key = OpKey(perf.op());
+  mutex_lock l(mu_);
+  Entry& entry = entries_[key];
+  if (entry.compute_costs_ns.empty()) {
+    entry.op_info = perf.op();
+  }
+  entry.compute_costs_ns.push_back(perf.compute_cost());
+  if (entry.compute_costs_ns.size() > static_cast<size_t>(kMaxMeasurements)) {
+    entry.compute_costs_ns.pop_front();
+  }
+  // Keep the largest memory footprint seen, to stay on the safe side for
+  // memory optimizations.
+  entry.temporary_memory =
+      std::max(entry.temporary_memory, perf.op_memory().temp_memory());
+  entry.persistent_memory =
+      std::max(entry.persistent_memory, perf.op_memory().persistent_memory());
+  UpdateCosts(&entry);
+}
+
+void MeasuredCostDatabase::Add(const OpPerformanceList& perfs) {
+  for (const OpPerformance& perf : perfs.op_performance()) {
+    Add(perf);
+  }
+}
+
+bool MeasuredCostDatabase::Lookup(const OpInfo& op_info, Costs* costs) const {
+  const uint64 key = OpKey(op_info);
+  mutex_lock l(mu_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) return false;
+  *costs = it->second.costs;
+  return true;
+}
+
+int MeasuredCostDatabase::size() const {
+  mutex_lock l(mu_);
+  return entries_.size();
+}
+
+OpPerformanceList MeasuredCostDatabase::ToProto() const {
+  OpPerformanceList perfs;
+  mutex_lock l(mu_);
+  for (const auto& it : entries_) {
+    const Entry& entry = it.second;
+    OpPerformance* perf = perfs.add_op_performance();
+    *perf->mutable_op() = entry.op_info;
+    perf->set_compute_cost(entry.costs.execution_time.count());
+    perf->set_temporary_memory_size(entry.temporary_memory);
+    perf->mutable_op_memory()->set_temp_memory(entry.temporary_memory);
+    perf->mutable_op_memory()->set_persistent_memory(entry.persistent_memory);
+  }
+  return perfs;
+}
+
+Status MeasuredCostDatabase::Load(const string& path) {
+  OpPerformanceList perfs;
+  TF_RETURN_IF_ERROR(ReadBinaryProto(Env::Default(), path, &perfs));
+  Add(perfs);
+  return Status::OK();
+}
+
+Status MeasuredCostDatabase::Save(const string& path) const {
+  // Write to a temporary file first so that readers never see a partially
+  // written database.
+  const string tmp_path = strings::StrCat(path, ".tmp");
+  TF_RETURN_IF_ERROR(WriteBinaryProto(Env::Default(), tmp_path, ToProto()));
+  return Env::Default()->RenameFile(tmp_path, path);
+}
+
+Status MeasuredCostDatabase::Flush() const {
+  if (path_.empty()) return Status::OK();
+  return Save(path_);
+}
+
+}  // namespace grappler
+}  // namespace tensorflow
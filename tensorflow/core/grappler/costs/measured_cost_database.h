@@ -0,0 +1,86 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_COSTS_MEASURED_COST_DATABASE_H_
+#define TENSORFLOW_CORE_GRAPPLER_COSTS_MEASURED_COST_DATABASE_H_
+
+#include <deque>
+#include <unordered_map>
+
+#include "tensorflow/core/grappler/costs/cost_estimator.h"
+#include "tensorflow/core/grappler/costs/op_performance_data.pb.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// Costs of ops measured on real hardware, keyed by op type, attributes, input
+// types and shapes, and device type. The measurements come from the
+// OpPerformance data of prior runs (see CostGraphToOpPerformanceData), and
+// OpLevelCostEstimator prefers them over its analytical estimates.
+class MeasuredCostDatabase {
+ public:
+  MeasuredCostDatabase() {}
+  // A database that Flush() saves to `path`.
+  explicit MeasuredCostDatabase(const string& path) : path_(path) {}
+
+  // Returns the process wide database, or nullptr if it is disabled. It is
+  // enabled by setting TF_GRAPPLER_MEASURED_COSTS to the path of a serialized
+  // OpPerformanceList, which is loaded if it exists. Sessions building cost
+  // models add their measurements to it and flush it back to that path.
+  static MeasuredCostDatabase* Global();
+
+  // Adds one measurement of the op described by `perf.op()`. The estimated
+  // cost of an op is a robust mean of its most recent measurements.
+  void Add(const OpPerformance& perf);
+  void Add(const OpPerformanceList& perfs);
+
+  // Returns true and fills `costs` if the op has been measured.
+  bool Lookup(const OpInfo& op_info, Costs* costs) const;
+
+  int size() const;
+
+  // Returns one OpPerformance per measured op, with its estimated costs.
+  OpPerformanceList ToProto() const;
+
+  Status Load(const string& path);
+  Status Save(const string& path) const;
+  // Saves the database to the path it was created with, if any.
+  Status Flush() const;
+
+ private:
+  struct Entry {
+    OpInfo op_info;
+    std::deque<double> compute_costs_ns;
+    int64 temporary_memory = 0;
+    int64 persistent_memory = 0;
+    Costs costs;
+  };
+
+  static uint64 OpKey(const OpInfo& op_info);
+  static void UpdateCosts(Entry* entry);
+
+  const string path_;
+  mutable mutex mu_;
+  std::unordered_map<uint64, Entry> entries_ GUARDED_BY(mu_);
+};
+
+}  // namespace grappler
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_COSTS_MEASURED_COST_DATABASE_H_
@@ -0,0 +1,134 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/costs/measured_cost_database.h"
+
+#include "tensorflow/core/grappler/costs/op_level_cost_estimator.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+OpInfo MatMulOpInfo(int m, int k, int n) {
+  OpInfo op_info;
+  op_info.set_op("MatMul");
+  op_info.mutable_device()->set_type("CPU");
+  op_info.mutable_device()->set_num_cores(1);
+  op_info.mutable_device()->set_frequency(1000);
+  (*op_info.mutable_attr())["T"].set_type(DT_FLOAT);
+  (*op_info.mutable_attr())["_class"].set_s("loc:@foo");
+  auto* a = op_info.add_inputs();
+  a->set_dtype(DT_FLOAT);
+  a->mutable_shape()->add_dim()->set_size(m);
+  a->mutable_shape()->add_dim()->set_size(k);
+  auto* b = op_info.add_inputs();
+  b->set_dtype(DT_FLOAT);
+  b->mutable_shape()->add_dim()->set_size(k);
+  b->mutable_shape()->add_dim()->set_size(n);
+  return op_info;
+}
+
+OpPerformance Measurement(const OpInfo& op_info, int64 compute_cost_ns,
+                          int64 temp_memory) {
+  OpPerformance perf;
+  *perf.mutable_op() = op_info;
+  perf.set_compute_cost(compute_cost_ns);
+  perf.mutable_op_memory()->set_temp_memory(temp_memory);
+  return perf;
+}
+
+TEST(MeasuredCostDatabaseTest, LookupByOpShapesAndDevice) {
+  MeasuredCostDatabase database;
+  database.Add(Measurement(MatMulOpInfo(10, 20, 30), 5000, 128));
+  EXPECT_EQ(1, database.size());
+
+  Costs costs;
+  ASSERT_TRUE(database.Lookup(MatMulOpInfo(10, 20, 30), &costs));
+  EXPECT_EQ(Costs::NanoSeconds(5000), costs.execution_time);
+  EXPECT_EQ(Costs::NanoSeconds(5000), costs.compute_time);
+  EXPECT_EQ(128, costs.temporary_memory);
+  EXPECT_FALSE(costs.inaccurate);
+
+  // Internal attributes don't matter.
+  OpInfo op_info = MatMulOpInfo(10, 20, 30);
+  op_info.mutable_attr()->erase("_class");
+  EXPECT_TRUE(database.Lookup(op_info, &costs));
+
+  // Shapes, attributes and the device type do.
+  EXPECT_FALSE(database.Lookup(MatMulOpInfo(10, 20, 31), &costs));
+  op_info = MatMulOpInfo(10, 20, 30);
+  (*op_info.mutable_attr())["transpose_a"].set_b(true);
+  EXPECT_FALSE(database.Lookup(op_info, &costs));
+  op_info = MatMulOpInfo(10, 20, 30);
+  op_info.mutable_device()->set_type("GPU");
+  EXPECT_FALSE(database.Lookup(op_info, &costs));
+}
+
+TEST(MeasuredCostDatabaseTest, RobustToOutliers) {
+  MeasuredCostDatabase database;
+  const OpInfo op_info = MatMulOpInfo(10, 20, 30);
+  for (int i = 0; i < 9; ++i) {
+    database.Add(Measurement(op_info, 1000, 0));
+  }
+  database.Add(Measurement(op_info, 1000000, 0));
+
+  Costs costs;
+  ASSERT_TRUE(database.Lookup(op_info, &costs));
+  EXPECT_EQ(Costs::NanoSeconds(1000), costs.execution_time);
+}
+
+TEST(MeasuredCostDatabaseTest, SaveAndLoad) {
+  const string path =
+      io::JoinPath(testing::TmpDir(), "measured_cost_database.pb");
+  {
+    MeasuredCostDatabase database(path);
+    database.Add(Measurement(MatMulOpInfo(10, 20, 30), 5000, 128));
+    TF_ASSERT_OK(database.Flush());
+  }
+
+  MeasuredCostDatabase database;
+  TF_ASSERT_OK(database.Load(path));
+  Costs costs;
+  ASSERT_TRUE(database.Lookup(MatMulOpInfo(10, 20, 30), &costs));
+  EXPECT_EQ(Costs::NanoSeconds(5000), costs.execution_time);
+  EXPECT_EQ(128, costs.temporary_memory);
+}
+
+TEST(MeasuredCostDatabaseTest, PreferredByOpLevelCostEstimator) {
+  MeasuredCostDatabase database;
+  OpContext op_context;
+  op_context.op_info = MatMulOpInfo(10, 20, 30);
+  database.Add(Measurement(op_context.op_info, 123456, 0));
+
+  OpLevelCostEstimator estimator;
+  estimator.set_measured_costs(nullptr);
+  const Costs analytical = estimator.PredictCosts(op_context);
+  EXPECT_NE(Costs::NanoSeconds(123456), analytical.execution_time);
+
+  estimator.set_measured_costs(&database);
+  EXPECT_EQ(Costs::NanoSeconds(123456),
+            estimator.PredictCosts(op_context).execution_time);
+
+  // Ops that weren't measured still get an analytical estimate.
+  op_context.op_info = MatMulOpInfo(10, 20, 40);
+  EXPECT_FALSE(estimator.PredictCosts(op_context).inaccurate);
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/grappler/clusters/utils.h"
+#include "tensorflow/core/lib/strings/numbers.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -324,10 +325,19 @@ OpLevelCostEstimator::OpLevelCostEstimator() {
 
   // By default, use sum of memory_time and compute_time for execution_time.
   compute_memory_overlap_ = false;
+  measured_costs_ = MeasuredCostDatabase::Global();
 }
 
 Costs OpLevelCostEstimator::PredictCosts(const OpContext& op_context) const {
   const auto& op_features = op_context.op_info;
+  Costs measured_costs;
+  if (measured_costs_ != nullptr &&
+      measured_costs_->Lookup(op_features, &measured_costs)) {
+    VLOG(1) << "Operation " << op_features.op() << " measured to take "
+            << measured_costs.execution_time.count() << " ns.";
+    return measured_costs;
+  }
+
   auto it = device_cost_impl_.find(op_features.op());
   if (it == device_cost_impl_.end()) {
     if (elementwise_ops_.find(op_features.op()) != elementwise_ops_.end()) {
@@ -387,6 +397,19 @@ OpLevelCostEstimator::DeviceInfo OpLevelCostEstimator::GetDeviceInfo(
     } else {
       gb_per_sec = 100;
     }
+  } else if (device.type() == "SYCL") {
+    int fma_per_core = 1;
+    auto it = device.environment().find("fma_per_core");
+    if (it != device.environment().end()) {
+      strings::safe_strto32(it->second, &fma_per_core);
+    }
+    gflops = device.num_cores() * device.frequency() * 1e-3 * fma_per_core *
+             kOpsPerMac;
+    if (device.bandwidth() > 0) {
+      gb_per_sec = device.bandwidth() / 1e6;
+    } else {
+      gb_per_sec = 32;
+    }
   }
   VLOG(1) << "Device: " << device.type() << " gflops: " << gflops
           << " gb_per_sec: " << gb_per_sec;
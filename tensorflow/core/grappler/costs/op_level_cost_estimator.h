@@ -21,6 +21,7 @@ limitations under the License.
 #include <string>
 
 #include "tensorflow/core/grappler/costs/cost_estimator.h"
+#include "tensorflow/core/grappler/costs/measured_cost_database.h"
 #include "tensorflow/core/grappler/costs/op_context.h"
 #include "tensorflow/core/grappler/costs/op_performance_data.pb.h"
 #include "tensorflow/core/util/padding.h"
@@ -38,8 +39,17 @@ class OpLevelCostEstimator {
   OpLevelCostEstimator();
   virtual ~OpLevelCostEstimator() {}
 
+  // Returns the measured costs of the op if they are in the measured cost
+  // database, and an analytical estimate otherwise.
   virtual Costs PredictCosts(const OpContext& op_context) const;
 
+  // Overrides the measured cost database, which defaults to
+  // MeasuredCostDatabase::Global(). May be nullptr to only use analytical
+  // estimates. Not owned.
+  void set_measured_costs(const MeasuredCostDatabase* measured_costs) {
+    measured_costs_ = measured_costs;
+  }
+
   // Basic device performance info, sufficient for roofline estimate.
   struct DeviceInfo {
     double gigaops;     // Billions of operations executed per second.
@@ -213,6 +223,8 @@ class OpLevelCostEstimator {
   // If true, assume compute and memory overlap; hence, the op cost is max of
   // compute_time and memory_time, insteaf of sum of those two.
   bool compute_memory_overlap_;
+  // Costs measured on real hardware, preferred over analytical estimates.
+  const MeasuredCostDatabase* measured_costs_;
 
  private:
   friend class OpLevelCostEstimatorTest;
@@ -216,6 +216,8 @@ DeviceProperties GetDeviceInfo(const string& device_str) {
         cuda_gpu_id = CudaGpuId(parsed.id);
       }
       return GetLocalGPUInfo(cuda_gpu_id);
+    } else if (parsed.type == "SYCL") {
+      return GetLocalSYCLInfo(parsed.has_id ? parsed.id : 0);
     } else if (parsed.type == "CPU") {
       return GetLocalCPUInfo();
     }
@@ -776,6 +776,15 @@ bool VirtualScheduler::MarkCurrNodeExecuted(const Costs& node_costs) {
         device.nodes_in_memory.insert(std::make_pair(node, port_num));
       }
     }
+    // The temporary memory of the op (only known when it was measured) is
+    // live while it runs, together with its inputs and outputs.
+    if (node_costs.temporary_memory > 0 &&
+        device.memory_usage + node_costs.temporary_memory >
+            device.max_memory_usage) {
+      device.max_memory_usage =
+          device.memory_usage + node_costs.temporary_memory;
+      device.mem_usage_snapshot_at_peak = device.nodes_in_memory;
+    }
   }
 
   // Update device's per-op cost.
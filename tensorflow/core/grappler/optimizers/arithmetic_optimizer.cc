@@ -24,6 +24,7 @@ limitations under the License.
 
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/attr_value_util.h"
+#include "tensorflow/core/framework/function.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/framework/op.h"
@@ -2106,9 +2107,16 @@ bool ArithmeticOptimizer::CanDedup(const NodeDef& node) const {
   if (nodes_to_preserve_.find(node.name()) != nodes_to_preserve_.end()) {
     return false;
   }
-  if (IsEnter(node) || IsExit(node)) {
+  if (IsExit(node)) {
     return false;
   }
+  if (IsEnter(node)) {
+    // The Enter nodes of the same loop invariant are interchangeable, which
+    // lets the computations of the loop bodies depending only on invariants
+    // be deduped too.
+    return node.op() == "Enter" && node.attr().count("is_constant") > 0 &&
+           node.attr().at("is_constant").b();
+  }
   if (node.device().find("SPU") != string::npos) {
     return false;
   }
@@ -2116,10 +2124,27 @@ bool ArithmeticOptimizer::CanDedup(const NodeDef& node) const {
   if (IsAssert(node)) {
     return true;
   }
+  if (pure_functions_.count(node.op()) > 0) {
+    return true;
+  }
   return IsFreeOfSideEffect(node);
 }
 
 void ArithmeticOptimizer::DedupComputations() {
+  // Functions calling other functions are conservatively assumed impure.
+  pure_functions_.clear();
+  for (const FunctionDef& func : optimized_graph_->library().function()) {
+    if (func.signature().is_stateful()) {
+      continue;
+    }
+    if (std::all_of(func.node_def().begin(), func.node_def().end(),
+                    [](const NodeDef& node) {
+                      return IsFreeOfSideEffect(node);
+                    })) {
+      pure_functions_.insert(func.signature().name());
+    }
+  }
+
   bool stop = true;
   SimpleGraphView graph_view;
   if (!graph_view.Initialize(*optimized_graph_).ok()) {
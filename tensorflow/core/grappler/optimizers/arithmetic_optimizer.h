@@ -136,6 +136,9 @@ class ArithmeticOptimizer : public GraphOptimizer {
   std::unordered_set<string> nodes_to_preserve_;
   std::unique_ptr<NodeMap> node_map_;
   std::unique_ptr<GraphProperties> graph_properties_;
+  // The functions of the graph library without side effects, whose calls can
+  // be deduped like the calls of pure ops.
+  std::unordered_set<string> pure_functions_;
   GraphDef* optimized_graph_ = nullptr;  // Not owned.
 };
 
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/grappler/optimizers/arithmetic_optimizer.h"
 #include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/framework/function_testlib.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/grappler/grappler_item.h"
@@ -145,6 +146,11 @@ class ArithmeticOptimizerTest : public GrapplerTest {
     optimizer->options_.combine_add_to_addn = false;
   }
 
+  void EnableOnlyDedupComputations(ArithmeticOptimizer* optimizer) {
+    DisableAllStages(optimizer);
+    optimizer->options_.dedup_computations = true;
+  }
+
   void EnableOnlyAddToAddNCombining(ArithmeticOptimizer* optimizer) {
     DisableAllStages(optimizer);
     optimizer->options_.combine_add_to_addn = true;
@@ -260,6 +266,70 @@ TEST_F(ArithmeticOptimizerTest, OpDedupping) {
   test::ExpectTensorNear<double>(tensors_expected[0], tensors[0], 1e-6);
 }
 
+TEST_F(ArithmeticOptimizerTest, OpDeduppingLoopInvariants) {
+  using test::function::NDef;
+  GrapplerItem item;
+  item.graph = test::function::GDef(
+      {NDef("x", "Placeholder", {}, {{"dtype", DT_FLOAT}}),
+       NDef("enter1", "Enter", {"x"},
+            {{"T", DT_FLOAT}, {"frame_name", "loop"}, {"is_constant", true}}),
+       NDef("enter2", "Enter", {"x"},
+            {{"T", DT_FLOAT}, {"frame_name", "loop"}, {"is_constant", true}}),
+       NDef("var1", "Enter", {"x"},
+            {{"T", DT_FLOAT}, {"frame_name", "loop"}, {"is_constant", false}}),
+       NDef("var2", "Enter", {"x"},
+            {{"T", DT_FLOAT}, {"frame_name", "loop"}, {"is_constant", false}}),
+       NDef("square1", "Square", {"enter1"}, {{"T", DT_FLOAT}}),
+       NDef("square2", "Square", {"enter2"}, {{"T", DT_FLOAT}}),
+       NDef("add", "Add", {"square1", "square2"}, {{"T", DT_FLOAT}}),
+       NDef("sub", "Sub", {"var1", "var2"}, {{"T", DT_FLOAT}})},
+      {});
+  item.fetch = {"add", "sub"};
+
+  ArithmeticOptimizer optimizer;
+  EnableOnlyDedupComputations(&optimizer);
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+  NodeMap node_map(&output);
+
+  // The invariant Enters and the Squares of the loop body are deduped, but
+  // not the Enters of loop variables.
+  EXPECT_EQ(nullptr, node_map.GetNode("enter2"));
+  EXPECT_EQ(nullptr, node_map.GetNode("square2"));
+  const NodeDef* add = node_map.GetNode("add");
+  ASSERT_NE(add, nullptr);
+  EXPECT_EQ("square1", add->input(0));
+  EXPECT_EQ("square1", add->input(1));
+  const NodeDef* sub = node_map.GetNode("sub");
+  ASSERT_NE(sub, nullptr);
+  EXPECT_EQ("var1", sub->input(0));
+  EXPECT_EQ("var2", sub->input(1));
+}
+
+TEST_F(ArithmeticOptimizerTest, OpDeduppingPureFunctionCalls) {
+  using test::function::NDef;
+  GrapplerItem item;
+  item.graph = test::function::GDef(
+      {NDef("x", "Placeholder", {}, {{"dtype", DT_FLOAT}}),
+       NDef("y1", "XTimesTwo", {"x"}, {{"T", DT_FLOAT}}),
+       NDef("y2", "XTimesTwo", {"x"}, {{"T", DT_FLOAT}}),
+       NDef("z", "Add", {"y1", "y2"}, {{"T", DT_FLOAT}})},
+      {test::function::XTimesTwo()});
+  item.fetch = {"z"};
+
+  ArithmeticOptimizer optimizer;
+  EnableOnlyDedupComputations(&optimizer);
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+  NodeMap node_map(&output);
+
+  EXPECT_EQ(nullptr, node_map.GetNode("y2"));
+  const NodeDef* z = node_map.GetNode("z");
+  ASSERT_NE(z, nullptr);
+  EXPECT_EQ("y1", z->input(0));
+  EXPECT_EQ("y1", z->input(1));
+}
+
 TEST_F(ArithmeticOptimizerTest, OpDeduppingAssertAndCheckNumerics) {
   tensorflow::Scope s = tensorflow::Scope::NewRootScope();
   Output p = ops::Placeholder(s, DT_BOOL, ops::Placeholder::Shape({}));
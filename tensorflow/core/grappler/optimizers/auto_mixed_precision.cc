@@ -0,0 +1,341 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/auto_mixed_precision.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/grappler/utils/topological_sort.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/util/env_var.h"
+#include "tensorflow/core/util/device_name_utils.h"
+
+namespace tensorflow {
+namespace grappler {
+
+namespace {
+
+constexpr char kCastToHalfSuffix[] = "-CastToFp16-AutoMixedPrecision";
+constexpr char kCastToFloatSuffix[] = "-CastToFp32-AutoMixedPrecision";
+
+// The ops deciding which nodes are converted on a device type.
+struct OpLists {
+  // Ops bound by arithmetic throughput, which are always converted.
+  std::unordered_set<string> allow;
+  // Ops that are safe to run in half precision but not worth a conversion on
+  // their own: they are only converted when one of their inputs already is.
+  std::unordered_set<string> infer;
+  // Ops that need the range or the accumulation of float, such as reductions
+  // and losses, which are never converted. Takes precedence over the other
+  // lists.
+  std::unordered_set<string> deny;
+};
+
+// Adds and removes the comma separated ops of the environment variables
+// TF_AUTO_MIXED_PRECISION_<list>_ADD and TF_AUTO_MIXED_PRECISION_<list>_REMOVE.
+void UpdateOpListFromEnv(const string& list, std::unordered_set<string>* ops) {
+  string add, remove;
+  TF_CHECK_OK(ReadStringFromEnvVar(
+      strings::StrCat("TF_AUTO_MIXED_PRECISION_", list, "_ADD"), "", &add));
+  TF_CHECK_OK(ReadStringFromEnvVar(
+      strings::StrCat("TF_AUTO_MIXED_PRECISION_", list, "_REMOVE"), "",
+      &remove));
+  for (const string& op : str_util::Split(add, ',', str_util::SkipEmpty())) {
+    ops->insert(op);
+  }
+  for (const string& op :
+       str_util::Split(remove, ',', str_util::SkipEmpty())) {
+    ops->erase(op);
+  }
+}
+
+OpLists GetOpLists(const string& device_type) {
+  OpLists lists;
+  // The SYCL matrix multiplications accumulate in float, convolutions in the
+  // precision of their kernel. cuDNN has no fast half depthwise convolution.
+  lists.allow = {"Conv2D", "Conv2DBackpropInput", "Conv2DBackpropFilter",
+                 "MatMul", "BatchMatMul"};
+  if (device_type == DEVICE_SYCL) {
+    lists.allow.insert("DepthwiseConv2dNative");
+  }
+  // FusedBatchNormV2 keeps its statistics in float.
+  lists.infer = {"BiasAdd",
+                 "Add",
+                 "AddV2",
+                 "Sub",
+                 "Mul",
+                 "Relu",
+                 "Relu6",
+                 "Elu",
+                 "Tanh",
+                 "Sigmoid",
+                 "MaxPool",
+                 "AvgPool",
+                 "Identity",
+                 "Reshape",
+                 "Squeeze",
+                 "Pad",
+                 "Transpose",
+                 "FusedBatchNormV2",
+                 "ReluGrad",
+                 "Relu6Grad",
+                 "EluGrad",
+                 "TanhGrad",
+                 "SigmoidGrad",
+                 "MaxPoolGrad",
+                 "AvgPoolGrad",
+                 "FusedBatchNormGradV2"};
+  lists.deny = {"Sum",
+                "Mean",
+                "Prod",
+                "BiasAddGrad",
+                "Exp",
+                "Log",
+                "Pow",
+                "Softmax",
+                "LogSoftmax",
+                "SoftmaxCrossEntropyWithLogits",
+                "SparseSoftmaxCrossEntropyWithLogits",
+                "L2Loss",
+                "IsFinite"};
+  UpdateOpListFromEnv("ALLOWLIST", &lists.allow);
+  UpdateOpListFromEnv("INFERLIST", &lists.infer);
+  UpdateOpListFromEnv("DENYLIST", &lists.deny);
+  return lists;
+}
+
+// Returns the type of the device the node is placed on, if it is one with
+// fast half precision.
+bool GetHalfDeviceType(const NodeDef& node, string* device_type) {
+  DeviceNameUtils::ParsedName parsed_name;
+  if (!DeviceNameUtils::ParseFullName(node.device(), &parsed_name) ||
+      !parsed_name.has_type) {
+    return false;
+  }
+  if (parsed_name.type != DEVICE_GPU && parsed_name.type != DEVICE_SYCL) {
+    return false;
+  }
+  *device_type = parsed_name.type;
+  return true;
+}
+
+bool HasFloatType(const NodeDef& node) {
+  auto it = node.attr().find("T");
+  return it != node.attr().end() && it->second.type() == DT_FLOAT;
+}
+
+// Collects the positions of the inputs and outputs typed by the "T"
+// attribute. Returns false for ops with list arguments, which are left alone.
+bool GetTypedArgs(const NodeDef& node, std::vector<int>* typed_inputs,
+                  std::vector<int>* typed_outputs) {
+  const OpDef* op_def = nullptr;
+  if (!OpRegistry::Global()->LookUpOpDef(node.op(), &op_def).ok()) {
+    return false;
+  }
+  for (int i = 0; i < op_def->output_arg_size(); ++i) {
+    const auto& arg = op_def->output_arg(i);
+    if (!arg.number_attr().empty() || !arg.type_list_attr().empty()) {
+      return false;
+    }
+    if (arg.type_attr() == "T") {
+      typed_outputs->push_back(i);
+    }
+  }
+  for (int i = 0; i < op_def->input_arg_size(); ++i) {
+    const auto& arg = op_def->input_arg(i);
+    if (!arg.number_attr().empty() || !arg.type_list_attr().empty()) {
+      return false;
+    }
+    if (arg.type_attr() == "T") {
+      typed_inputs->push_back(i);
+    }
+  }
+  return !typed_inputs->empty() && !typed_outputs->empty();
+}
+
+bool HasHalfKernel(const NodeDef& node, const string& device_type) {
+  NodeDef half_node = node;
+  (*half_node.mutable_attr())["T"].set_type(DT_HALF);
+  return FindKernelDef(DeviceType(device_type), half_node, nullptr, nullptr)
+      .ok();
+}
+
+bool HasCastKernel(const string& device_type, DataType src, DataType dst) {
+  NodeDef cast;
+  cast.set_op("Cast");
+  (*cast.mutable_attr())["SrcT"].set_type(src);
+  (*cast.mutable_attr())["DstT"].set_type(dst);
+  return FindKernelDef(DeviceType(device_type), cast, nullptr, nullptr).ok();
+}
+
+bool Contains(const std::vector<int>& positions, int position) {
+  return std::find(positions.begin(), positions.end(), position) !=
+         positions.end();
+}
+
+// A node converted to half precision.
+struct HalfNode {
+  std::vector<int> inputs;   // Positions of the inputs converted with it.
+  std::vector<int> outputs;  // Positions of its half outputs.
+  string device;
+};
+
+}  // namespace
+
+Status AutoMixedPrecision::Optimize(Cluster* /*cluster*/,
+                                    const GrapplerItem& item,
+                                    GraphDef* optimized_graph) {
+  *optimized_graph = item.graph;
+  if (opt_level_ != RewriterConfig::ON) {
+    return Status::OK();
+  }
+
+  // The device types whose kernels can run the casts.
+  std::unordered_map<string, OpLists> op_lists;
+  for (const char* device_type : {DEVICE_GPU, DEVICE_SYCL}) {
+    if (HasCastKernel(device_type, DT_FLOAT, DT_HALF) &&
+        HasCastKernel(device_type, DT_HALF, DT_FLOAT)) {
+      op_lists.emplace(device_type, GetOpLists(device_type));
+    }
+  }
+  if (op_lists.empty()) {
+    return Status::OK();
+  }
+
+  if (!TopologicalSort(optimized_graph).ok()) {
+    VLOG(1) << "Skipping auto mixed precision, the graph can't be sorted";
+    return Status::OK();
+  }
+
+  // Pick the nodes to convert, visiting producers before their consumers so
+  // that the conversion can extend from the allowed ops to the inferred ops
+  // that follow them.
+  const std::set<string> nodes_to_preserve = item.NodesToPreserve();
+  std::unordered_map<string, HalfNode> half_nodes;
+  auto is_half_input = [&half_nodes](const string& input) {
+    int position;
+    const auto it = half_nodes.find(ParseNodeName(input, &position));
+    return it != half_nodes.end() && Contains(it->second.outputs, position);
+  };
+  for (const NodeDef& node : optimized_graph->node()) {
+    string device_type;
+    if (!GetHalfDeviceType(node, &device_type)) {
+      continue;
+    }
+    const auto lists = op_lists.find(device_type);
+    if (lists == op_lists.end() || lists->second.deny.count(node.op()) > 0) {
+      continue;
+    }
+    const bool allowed = lists->second.allow.count(node.op()) > 0;
+    if (!allowed && lists->second.infer.count(node.op()) == 0) {
+      continue;
+    }
+    HalfNode half_node;
+    if (nodes_to_preserve.count(node.name()) > 0 || !HasFloatType(node) ||
+        !GetTypedArgs(node, &half_node.inputs, &half_node.outputs) ||
+        !HasHalfKernel(node, device_type)) {
+      continue;
+    }
+    if (!allowed) {
+      bool has_half_input = false;
+      for (int i : half_node.inputs) {
+        if (i < node.input_size() && is_half_input(node.input(i))) {
+          has_half_input = true;
+          break;
+        }
+      }
+      if (!has_half_input) {
+        continue;
+      }
+    }
+    half_node.device = node.device();
+    half_nodes.emplace(node.name(), std::move(half_node));
+  }
+  if (half_nodes.empty()) {
+    return Status::OK();
+  }
+
+  // Casts are shared between all the consumers of a tensor.
+  std::unordered_map<string, string> casts;
+  auto get_cast = [optimized_graph, &casts](const string& input,
+                                            const string& device,
+                                            bool to_half) -> string {
+    int position;
+    const string producer = ParseNodeName(input, &position);
+    const string name =
+        strings::StrCat(producer, "-", position,
+                        to_half ? kCastToHalfSuffix : kCastToFloatSuffix);
+    if (casts.emplace(name, input).second) {
+      NodeDef* cast = optimized_graph->add_node();
+      cast->set_name(name);
+      cast->set_op("Cast");
+      cast->set_device(device);
+      cast->add_input(input);
+      (*cast->mutable_attr())["SrcT"].set_type(to_half ? DT_FLOAT : DT_HALF);
+      (*cast->mutable_attr())["DstT"].set_type(to_half ? DT_HALF : DT_FLOAT);
+    }
+    return name;
+  };
+
+  const int num_nodes = optimized_graph->node_size();
+  for (int index = 0; index < num_nodes; ++index) {
+    NodeDef* node = optimized_graph->mutable_node(index);
+    const auto it = half_nodes.find(node->name());
+    const bool is_half = it != half_nodes.end();
+    if (is_half) {
+      (*node->mutable_attr())["T"].set_type(DT_HALF);
+    }
+    for (int i = 0; i < node->input_size(); ++i) {
+      const string input = node->input(i);
+      if (IsControlInput(input)) {
+        continue;
+      }
+      const bool wants_half = is_half && Contains(it->second.inputs, i);
+      if (wants_half == is_half_input(input)) {
+        continue;
+      }
+      // Casts to half run next to the consumer and casts back to float next
+      // to the producer, so that half tensors never leave the device.
+      *node->mutable_input(i) =
+          wants_half
+              ? get_cast(input, node->device(), true)
+              : get_cast(input, half_nodes.at(NodeName(input)).device, false);
+    }
+  }
+  VLOG(1) << "Converted " << half_nodes.size() << " nodes to half precision, "
+          << "inserted " << casts.size() << " casts";
+
+  return Status::OK();
+}
+
+void AutoMixedPrecision::Feedback(Cluster* /*cluster*/,
+                                  const GrapplerItem& /*item*/,
+                                  const GraphDef& /*optimized_graph*/,
+                                  double /*result*/) {
+  // Nothing to do for AutoMixedPrecision.
+}
+
+}  // namespace grappler
+}  // namespace tensorflow
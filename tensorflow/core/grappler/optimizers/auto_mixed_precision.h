@@ -0,0 +1,61 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_AUTO_MIXED_PRECISION_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_AUTO_MIXED_PRECISION_H_
+
+#include "tensorflow/core/grappler/optimizers/graph_optimizer.h"
+#include "tensorflow/core/protobuf/rewriter_config.pb.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// Converts float computations placed on GPU and SYCL devices to half
+// precision. The ops of the allow list of the device (convolutions and matrix
+// multiplications) are converted first, the conversion is then extended to
+// the ops of the infer list (element-wise, pooling and batch norm) that
+// consume their results, and Cast nodes are inserted wherever the graph
+// crosses between the two precisions. The ops of the deny list, such as
+// reductions and losses, stay in float. Ops are only converted when a half
+// kernel is registered for their device, so the pass is a no-op in builds
+// without half support.
+//
+// The lists can be changed with the comma separated ops of the environment
+// variables TF_AUTO_MIXED_PRECISION_{ALLOWLIST,INFERLIST,DENYLIST}_{ADD,REMOVE}.
+// Training graphs should scale their loss, e.g. with the LossScaleOptimizer
+// of contrib/mixed_precision, whose finiteness checks are kept in float.
+class AutoMixedPrecision : public GraphOptimizer {
+ public:
+  explicit AutoMixedPrecision(RewriterConfig::Toggle opt_level)
+      : opt_level_(opt_level) {}
+
+  ~AutoMixedPrecision() override {}
+
+  string name() const override { return "auto_mixed_precision"; };
+
+  Status Optimize(Cluster* cluster, const GrapplerItem& item,
+                  GraphDef* optimized_graph) override;
+
+  void Feedback(Cluster* cluster, const GrapplerItem& item,
+                const GraphDef& optimized_graph, double result) override;
+
+ private:
+  RewriterConfig::Toggle opt_level_;
+};
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_AUTO_MIXED_PRECISION_H_
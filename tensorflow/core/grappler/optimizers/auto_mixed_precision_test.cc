@@ -0,0 +1,203 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/auto_mixed_precision.h"
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/utils/grappler_test.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+
+class AutoMixedPrecisionTest : public GrapplerTest {};
+
+TEST_F(AutoMixedPrecisionTest, IgnoresCPUGraph) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:CPU:0");
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({2, 3}));
+  Output w = ops::Const(s.WithOpName("w"), 1.0f, {3, 4});
+  Output matmul = ops::MatMul(s.WithOpName("matmul"), x, w);
+  Output relu = ops::Relu(s.WithOpName("relu"), matmul);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"relu"};
+
+  AutoMixedPrecision optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_EQ(item.graph.node_size(), output.node_size());
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE("Cast", node.op());
+    if (node.attr().count("T") > 0) {
+      EXPECT_EQ(DT_FLOAT, node.attr().at("T").type());
+    }
+  }
+}
+
+#if defined(TENSORFLOW_USE_SYCL) && !defined(TENSORFLOW_SYCL_NO_HALF)
+TEST_F(AutoMixedPrecisionTest, ConvertsSYCLMatMulChain) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:SYCL:0");
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({2, 3}));
+  Output y = ops::Placeholder(s.WithOpName("y"), DT_FLOAT,
+                              ops::Placeholder::Shape({2, 4}));
+  Output w = ops::Const(s.WithOpName("w"), 1.0f, {3, 4});
+  Output bias = ops::Const(s.WithOpName("bias"), 0.5f, {4});
+  Output matmul = ops::MatMul(s.WithOpName("matmul"), x, w);
+  Output bias_add = ops::BiasAdd(s.WithOpName("bias_add"), matmul, bias);
+  Output relu = ops::Relu(s.WithOpName("relu"), bias_add);
+  Output out = ops::Identity(s.WithOpName("out"), relu);
+  // Not fed by a converted node, so it stays in float.
+  Output tanh = ops::Tanh(s.WithOpName("tanh"), y);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"out", "tanh"};
+
+  AutoMixedPrecision optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_EQ(item.graph.node_size() + 4, output.node_size());
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "matmul") {
+      EXPECT_EQ(DT_HALF, node.attr().at("T").type());
+      EXPECT_EQ("x-0-CastToFp16-AutoMixedPrecision", node.input(0));
+      EXPECT_EQ("w-0-CastToFp16-AutoMixedPrecision", node.input(1));
+      found++;
+    } else if (node.name() == "bias_add") {
+      EXPECT_EQ(DT_HALF, node.attr().at("T").type());
+      EXPECT_EQ("matmul", node.input(0));
+      EXPECT_EQ("bias-0-CastToFp16-AutoMixedPrecision", node.input(1));
+      found++;
+    } else if (node.name() == "relu") {
+      EXPECT_EQ(DT_HALF, node.attr().at("T").type());
+      found++;
+    } else if (node.name() == "out") {
+      EXPECT_EQ(DT_FLOAT, node.attr().at("T").type());
+      EXPECT_EQ("relu-0-CastToFp32-AutoMixedPrecision", node.input(0));
+      found++;
+    } else if (node.name() == "tanh") {
+      EXPECT_EQ(DT_FLOAT, node.attr().at("T").type());
+      EXPECT_EQ("y", node.input(0));
+      found++;
+    } else if (node.name() == "relu-0-CastToFp32-AutoMixedPrecision") {
+      EXPECT_EQ("Cast", node.op());
+      EXPECT_EQ(DT_HALF, node.attr().at("SrcT").type());
+      EXPECT_EQ(DT_FLOAT, node.attr().at("DstT").type());
+      EXPECT_EQ("relu", node.input(0));
+      found++;
+    }
+  }
+  EXPECT_EQ(6, found);
+}
+
+TEST_F(AutoMixedPrecisionTest, KeepsDeniedOpsInFloat) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:SYCL:0");
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({2, 3}));
+  Output w = ops::Const(s.WithOpName("w"), 1.0f, {3, 4});
+  Output matmul = ops::MatMul(s.WithOpName("matmul"), x, w);
+  Output softmax = ops::Softmax(s.WithOpName("softmax"), matmul);
+  Output sum = ops::Sum(s.WithOpName("sum"), softmax, {0, 1});
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"sum"};
+
+  AutoMixedPrecision optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &output));
+
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "matmul") {
+      EXPECT_EQ(DT_HALF, node.attr().at("T").type());
+    } else if (node.name() == "softmax") {
+      EXPECT_EQ(DT_FLOAT, node.attr().at("T").type());
+      EXPECT_EQ("matmul-0-CastToFp32-AutoMixedPrecision", node.input(0));
+    } else if (node.name() == "sum") {
+      EXPECT_EQ(DT_FLOAT, node.attr().at("T").type());
+    }
+  }
+}
+
+TEST_F(AutoMixedPrecisionTest, AllowListFromEnv) {
+  setenv("TF_AUTO_MIXED_PRECISION_ALLOWLIST_REMOVE", "MatMul", 1);
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:SYCL:0");
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({2, 3}));
+  Output w = ops::Const(s.WithOpName("w"), 1.0f, {3, 4});
+  Output matmul = ops::MatMul(s.WithOpName("matmul"), x, w);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"matmul"};
+
+  AutoMixedPrecision optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &output));
+  unsetenv("TF_AUTO_MIXED_PRECISION_ALLOWLIST_REMOVE");
+
+  EXPECT_EQ(item.graph.node_size(), output.node_size());
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "matmul") {
+      EXPECT_EQ(DT_FLOAT, node.attr().at("T").type());
+    }
+  }
+}
+#endif  // TENSORFLOW_USE_SYCL && !TENSORFLOW_SYCL_NO_HALF
+
+#if GOOGLE_CUDA
+TEST_F(AutoMixedPrecisionTest, ConvertsGPUMatMul) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:GPU:0");
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({2, 3}));
+  Output w = ops::Const(s.WithOpName("w"), 1.0f, {3, 4});
+  Output matmul = ops::MatMul(s.WithOpName("matmul"), x, w);
+  Output relu = ops::Relu(s.WithOpName("relu"), matmul);
+  Output out = ops::Identity(s.WithOpName("out"), relu);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"out"};
+
+  AutoMixedPrecision optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &output));
+
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "matmul" || node.name() == "relu") {
+      EXPECT_EQ(DT_HALF, node.attr().at("T").type());
+    } else if (node.name() == "out") {
+      // Fetched, so preserved in float.
+      EXPECT_EQ(DT_FLOAT, node.attr().at("T").type());
+      EXPECT_EQ("relu-0-CastToFp32-AutoMixedPrecision", node.input(0));
+    }
+  }
+}
+#endif  // GOOGLE_CUDA
+
+}  // namespace grappler
+}  // namespace tensorflow
@@ -13,7 +13,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
-// Op kernels used to swap data in and out of GPU memory.
+// Op kernels used to swap data in and out of GPU memory. The same kernels swap
+// the memory of SYCL devices, on which the device context copies are
+// asynchronous as well.
 
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -23,7 +23,8 @@ namespace tensorflow {
 namespace {
 
 // The _CopyFromGpuToHost op copies its input tensor to the host. The input must
-// reside on GPU. The op itself must be placed on GPU.
+// reside on GPU. The op itself must be placed on GPU. Despite the name, the op
+// is also used to swap the memory of SYCL devices.
 REGISTER_OP("_CopyFromGpuToHost")
     .Input("input: T")
     .Output("output: T")
@@ -39,7 +40,8 @@ REGISTER_OP("_CopyFromGpuToHost")
     .Doc("Copies the input tensor from gpu to the host.");
 
 // The _CopyFromHostToGpu op copies its input tensor from the host to the GPU.
-// The input must reside on CPU. The op itself must be placed on GPU.
+// The input must reside on CPU. The op itself must be placed on GPU. Despite
+// the name, the op is also used to swap the memory of SYCL devices.
 REGISTER_OP("_CopyFromHostToGpu")
     .Input("input: T")
     .Output("output: T")
@@ -225,6 +225,20 @@ bool IsNodeByLayoutOptimizer(const string& node_name) {
   return EndWith(node_name, suffix);
 }
 
+// Returns true if the device runs the Conv-related ops faster in NCHW, the
+// layout the NHWC graphs are converted to. The SYCL devices state their
+// preferred layout in their properties.
+bool PrefersNCHW(const DeviceProperties& device) {
+  if (device.type() == "GPU") {
+    return true;
+  }
+  if (device.type() == "SYCL") {
+    auto it = device.environment().find("preferred_data_format");
+    return it != device.environment().end() && it->second == "NCHW";
+  }
+  return false;
+}
+
 bool IsNodeType(const string& node_name, const string& type) {
   const string suffix = strings::StrCat(type, "-", kSuffix);
   return EndWith(node_name, suffix);
@@ -563,7 +577,7 @@ class NodeProcessor : public GraphProcessor {
     return nodes_to_preserve_.find(node_->name()) != nodes_to_preserve_.end();
   }
 
-  bool IsOnGPU() const {
+  bool IsOnTargetDevice() const {
     string device_name;
     if (node_->device().empty()) {
       device_name = virtual_placer_.get_canonical_device_name(*node_);
@@ -572,17 +586,23 @@ class NodeProcessor : public GraphProcessor {
     }
     string device;
     string not_used;
-    if (DeviceNameUtils::SplitDeviceName(device_name, &not_used, &device) &&
-        str_util::StrContains(str_util::Lowercase(device),
-                              str_util::Lowercase(DEVICE_GPU))) {
+    if (!DeviceNameUtils::SplitDeviceName(device_name, &not_used, &device)) {
+      return false;
+    }
+    device = str_util::Lowercase(device);
+    if (str_util::StrContains(device, str_util::Lowercase(DEVICE_GPU))) {
       return true;
     }
+    if (str_util::StrContains(device, str_util::Lowercase(DEVICE_SYCL))) {
+      const DeviceProperties& properties = virtual_placer_.get_device(*node_);
+      return properties.type() == "SYCL" && PrefersNCHW(properties);
+    }
     return false;
   }
 
   virtual bool ShouldProcess() const {
     return !MustPreserve() && IsNHWC() && IsPortZeroDimsFour(*node_) &&
-           HasOutputs() && IsOnGPU();
+           HasOutputs() && IsOnTargetDevice();
   }
 
   virtual void UpdateAttrShape() {
@@ -991,7 +1011,7 @@ class BiasAddGradProcessor : public NodeProcessor {
     if (MustPreserve()) {
       return false;
     }
-    if (!IsOnGPU()) {
+    if (!IsOnTargetDevice()) {
       return false;
     }
     auto input = node_map_->GetNode(node_->input(0));
@@ -1016,7 +1036,7 @@ class Conv2DProcessor : public NodeProcessor {
  protected:
   bool ShouldProcess() const override {
     return !MustPreserve() && IsNHWC() && IsPortZeroDimsFour(*node_) &&
-           HasOutputs() && (!IsGemmUsed() || no_gemm_) && IsOnGPU();
+           HasOutputs() && (!IsGemmUsed() || no_gemm_) && IsOnTargetDevice();
   }
 
   TensorShapeProto GetShape(const string& input_name) const {
@@ -1178,7 +1198,7 @@ class MaxPoolV2Processor : public NodeProcessor {
     int port;
     ParseNodeName(node_->input(0), &port);
     return !MustPreserve() && IsNHWC() && IsPortDimsFour(*data_input, port) &&
-           HasOutputs() && IsOnGPU();
+           HasOutputs() && IsOnTargetDevice();
   }
 
   Status CustomizedProcessing() override {
@@ -1198,7 +1218,7 @@ class AgnosticNodeProcessor : public NodeProcessor {
  protected:
   bool ShouldProcess() const override {
     return !MustPreserve() && IsPortZeroDimsFour(*node_) && HasOutputs() &&
-           IsNodeAfterNCHWToNHWC() && IsOnGPU();
+           IsNodeAfterNCHWToNHWC() && IsOnTargetDevice();
   }
 
   bool IsNodeAfterNCHWToNHWC(const NodeDef& node) const {
@@ -1264,7 +1284,7 @@ class BinaryOpProcessor : public AgnosticNodeProcessor {
            (IsNDOperateWithMD(4, 0) || IsNDOperateWithMD(4, 1) ||
             IsNDOperateWithMD(4, 4) || IsNDOperateWithMD(0, 4) ||
             IsNDOperateWithMD(1, 4)) &&
-           IsOnGPU();
+           IsOnTargetDevice();
   }
 
   std::vector<int> GetInputPos() const override {
@@ -1439,7 +1459,7 @@ class HistogramSummaryProcessor : public AgnosticNodeProcessor {
     int port;
     ParseNodeName(node_->input(1), &port);
     return !MustPreserve() && HasOutputs() && IsNodeAfterNCHWToNHWC() &&
-           IsPortDimsFour(*input1, port) && IsOnGPU();
+           IsPortDimsFour(*input1, port) && IsOnTargetDevice();
   }
 
   std::vector<int> GetInputPos() const override { return {1}; }
@@ -1472,7 +1492,7 @@ class IdentityNProcessor : public AgnosticNodeProcessor {
  protected:
   bool ShouldProcess() const override {
     return !MustPreserve() && HasOutputs() && IsNodeAfterNCHWToNHWC() &&
-           IsOnGPU();
+           IsOnTargetDevice();
   }
 
   std::vector<int> GetInputPos() const override { return input_pos_; }
@@ -1510,7 +1530,7 @@ class MergeProcessor : public AgnosticNodeProcessor {
  protected:
   bool ShouldProcess() const override {
     return !MustPreserve() && IsPortZeroDimsFour(*node_) && HasOutputs() &&
-           IsEveryInputAfterNCHWToNHWC() && IsOnGPU();
+           IsEveryInputAfterNCHWToNHWC() && IsOnTargetDevice();
   }
 
   std::vector<int> GetInputPos() const override {
@@ -1770,7 +1790,7 @@ class SqueezeProcessor : public AgnosticNodeProcessor {
     bool is_dims_supported = (IsPortZeroDimsN(*node_, 2) && IsAlongHW()) ||
                              (IsPortZeroDimsN(*node_, 1) && IsAlongNHW());
     return !MustPreserve() && HasOutputs() && IsNodeAfterNCHWToNHWC() &&
-           IsInputConvertible() && is_dims_supported && IsOnGPU();
+           IsInputConvertible() && is_dims_supported && IsOnTargetDevice();
   }
 
   Status AddLayoutTransposeToOutputs() override { return Status::OK(); }
@@ -1840,7 +1860,7 @@ class ReduceProcessor : public AgnosticNodeProcessor {
     ParseNodeName(node_->input(0), &port);
     return !MustPreserve() && HasOutputs() && IsNodeAfterNCHWToNHWC() &&
            IsPortDimsFour(*input0, port) && IsReduceAxisSupported() &&
-           IsOnGPU();
+           IsOnTargetDevice();
   }
 
   Status CustomizedProcessing() override {
@@ -2130,15 +2150,15 @@ class DataLayoutOptimizer : GraphProcessor {
   const LayoutOptimizer::TuningConfig& config_;
 };
 
-int GetNumGPUs(const Cluster& cluster) {
+int GetNumTargetDevices(const Cluster& cluster) {
   auto devices = cluster.GetDevices();
-  int num_gpus = 0;
+  int num_target_devices = 0;
   for (const auto& device : devices) {
-    if (device.second.type() == "GPU") {
-      num_gpus++;
+    if (PrefersNCHW(device.second)) {
+      num_target_devices++;
     }
   }
-  return num_gpus;
+  return num_target_devices;
 }
 }  // namespace
 
@@ -2165,8 +2185,9 @@ Status LayoutOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
     return errors::InvalidArgument("cluster == nullptr");
   }
 
-  if (GetNumGPUs(*cluster) < 1) {
-    // LayoutOptimizer is currently only tuned for GPU.
+  if (GetNumTargetDevices(*cluster) < 1) {
+    // LayoutOptimizer is currently only tuned for GPU and the SYCL devices
+    // preferring NCHW.
     *output = item.graph;
     return Status::OK();
   }
@@ -22,7 +22,8 @@ limitations under the License.
 
 namespace tensorflow {
 namespace grappler {
-// Convert the NHWC layout to NCHW for Conv-related ops on GPUs.
+// Convert the NHWC layout to NCHW for Conv-related ops on GPUs, and on the
+// SYCL devices whose "preferred_data_format" property is NCHW.
 class LayoutOptimizer : public GraphOptimizer {
  public:
   LayoutOptimizer() {}
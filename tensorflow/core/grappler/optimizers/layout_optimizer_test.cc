@@ -1181,6 +1181,49 @@ TEST_F(LayoutOptimizerTest, DevicePlacement) {
       node_map.GetNode("s-0-0-VecPermuteNCHWToNHWC-LayoutOptimizer");
   EXPECT_EQ(vec_permute->attr().at("_kernel").s(), "host");
 }
+
+TEST_F(LayoutOptimizerTest, SyclDevicePreferringNCHW) {
+  DeviceProperties device_properties;
+  device_properties.set_type("SYCL");
+  device_properties.mutable_environment()->insert(
+      {"preferred_data_format", "NCHW"});
+  VirtualCluster cluster({{"/SYCL:0", device_properties}});
+  TF_ASSERT_OK(cluster.Provision());
+
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  auto conv = SimpleConv2D(&s, 4, 2, "VALID", "/SYCL:0");
+  Output fetch = ops::Identity(s.WithOpName("Fetch"), {conv});
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  LayoutOptimizer optimizer;
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(&cluster, item, &output));
+  NodeMap node_map(&output);
+  EXPECT_TRUE(node_map.GetNode("Conv2D-0-TransposeNHWCToNCHW-LayoutOptimizer"));
+  EXPECT_EQ("NCHW", node_map.GetNode("Conv2D")->attr().at("data_format").s());
+}
+
+TEST_F(LayoutOptimizerTest, SyclDevicePreferringNHWC) {
+  DeviceProperties device_properties;
+  device_properties.set_type("SYCL");
+  device_properties.mutable_environment()->insert(
+      {"preferred_data_format", "NHWC"});
+  VirtualCluster cluster({{"/SYCL:0", device_properties}});
+  TF_ASSERT_OK(cluster.Provision());
+
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  auto conv = SimpleConv2D(&s, 4, 2, "VALID", "/SYCL:0");
+  Output fetch = ops::Identity(s.WithOpName("Fetch"), {conv});
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  LayoutOptimizer optimizer;
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(&cluster, item, &output));
+  NodeMap node_map(&output);
+  EXPECT_FALSE(
+      node_map.GetNode("Conv2D-0-TransposeNHWCToNCHW-LayoutOptimizer"));
+  EXPECT_EQ("NHWC", node_map.GetNode("Conv2D")->attr().at("data_format").s());
+}
 }  // namespace
 }  // namespace grappler
 }  // namespace tensorflow
@@ -331,7 +331,9 @@ Status LoopInvariantNodeMotionOptimizer::FindInvariantNodes(
     auto consumers = node_map_->GetOutputs(node->name());
     invariant_nodes_.emplace(node, consumers.size());
     for (auto* consumer : consumers) {
-      if (invariant_nodes_.count(consumer) || ModifiesFrameInfo(*consumer)) {
+      // Only pure nodes compute the same value in every iteration.
+      if (invariant_nodes_.count(consumer) || ModifiesFrameInfo(*consumer) ||
+          !IsFreeOfSideEffect(*consumer)) {
         continue;
       }
       bool is_invariant = true;
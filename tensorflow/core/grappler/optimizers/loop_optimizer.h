@@ -35,7 +35,7 @@ class LoopOptimizer : public GraphOptimizer {
         options_(LoopOptimizerOptions::Default(RewriterConfig::ON)) {}
   explicit LoopOptimizer(RewriterConfig::Toggle opt_level)
       : opt_level_(opt_level),
-        options_(LoopOptimizerOptions::Default(RewriterConfig::ON)) {}
+        options_(LoopOptimizerOptions::Default(opt_level)) {}
 
   ~LoopOptimizer() override {}
 
@@ -58,6 +58,10 @@ class LoopOptimizer : public GraphOptimizer {
 
     static LoopOptimizerOptions Default(RewriterConfig::Toggle opt_level) {
       LoopOptimizerOptions options;
+      // Hoisting the invariant nodes out of the loops moves their memory out
+      // of the frames, so that it lives for the whole loop.
+      options.enable_loop_invariant_node_motion =
+          opt_level == RewriterConfig::AGGRESSIVE;
       return options;
     }
   };
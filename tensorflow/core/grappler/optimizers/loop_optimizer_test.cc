@@ -123,6 +123,42 @@ TEST_F(LoopOptimizerTest, Basic) {
   EXPECT_EQ(frames.at(node_map->GetNode("VariantAdd")).back(), 0);
 }
 
+TEST_F(LoopOptimizerTest, StatefulNodeNotMoved) {
+  GraphDef graph;
+  AddSimpleNode("In", "Identity", {}, &graph);
+  AddEnterNode("InvariantEnter", "while/while_context", true, 1, {"In"},
+               &graph);
+  // Computes a different value in every iteration despite its invariant input.
+  AddSimpleNode("Shuffle", "RandomShuffle", {"InvariantEnter"}, &graph);
+  AddSimpleNode("VariantAdd", "Add", {"Shuffle", "Identity"}, &graph);
+  AddEnterNode("VariantEnter", "while/while_context", false, 1, {"In"}, &graph);
+  AddSimpleNode("Merge", "Merge", {"VariantEnter", "NextIteration"}, &graph);
+  AddSimpleNode("Less/y", "Const", {"^Identity"}, &graph);
+  AddSimpleNode("Less", "Less", {"VariantAdd", "Less/y"}, &graph);
+  AddSimpleNode("LoopCond", "LoopCond", {"Less"}, &graph);
+  AddSimpleNode("Switch", "Switch", {"Merge", "LoopCond"}, &graph);
+  AddSimpleNode("Identity", "Identity", {"Switch:1"}, &graph);
+  AddSimpleNode("NextIteration", "NextIteration", {"VariantAdd"}, &graph);
+  AddSimpleNode("Exit", "Exit", {"Switch"}, &graph);
+  AddSimpleNode("Out", "Identity", {"Exit"}, &graph);
+
+  GrapplerItem item;
+  item.graph = graph;
+
+  LoopOptimizer optimizer;
+  EnableOnlyLoopInvariantNodeMotion(&optimizer);
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  std::unordered_map<const NodeDef*, std::vector<int>> frames;
+  int num_frames;
+  NodeMap node_map(&output);
+  EXPECT_TRUE(IdentifyFrames(output, &frames, &num_frames).ok());
+  EXPECT_EQ(num_frames, 1);
+  EXPECT_EQ(frames.at(node_map.GetNode("Shuffle")).size(), 1);
+  EXPECT_EQ(frames.at(node_map.GetNode("VariantAdd")).size(), 1);
+}
+
 TEST_F(LoopOptimizerTest, Const) {
   GraphDef graph;
   AddSimpleNode("In", "Identity", {}, &graph);
@@ -16,7 +16,11 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/memory_optimizer.h"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
 #include <queue>
+#include <set>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -28,12 +32,15 @@ limitations under the License.
 #include "tensorflow/core/grappler/clusters/virtual_cluster.h"
 #include "tensorflow/core/grappler/costs/graph_memory.h"
 #include "tensorflow/core/grappler/costs/graph_properties.h"
+#include "tensorflow/core/grappler/costs/op_level_cost_estimator.h"
+#include "tensorflow/core/grappler/costs/utils.h"
 #include "tensorflow/core/grappler/graph_view.h"
 #include "tensorflow/core/grappler/grappler_item.h"
 #include "tensorflow/core/grappler/op_types.h"
 #include "tensorflow/core/grappler/optimizers/graph_rewriter.h"
 #include "tensorflow/core/grappler/optimizers/static_schedule.h"
 #include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/grappler/utils/frame.h"
 #include "tensorflow/core/grappler/utils/topological_sort.h"
 #include "tensorflow/core/grappler/utils/traversal.h"
 #include "tensorflow/core/lib/math/math_util.h"
@@ -941,6 +948,36 @@ struct MemInfo {
   bool operator<(const MemInfo& other) const { return fitness < other.fitness; }
 };
 
+// Simulates the execution of the item on a virtual copy of the cluster, and
+// records the time at which each op completes.
+static bool GetOpCompletionTimes(
+    Cluster* cluster, const GrapplerItem& item,
+    std::unordered_map<string, Costs::NanoSeconds>* op_completion_times) {
+  VirtualCluster vcluster(cluster->GetDevices());
+  if (!vcluster.Provision().ok()) {
+    return false;
+  }
+  if (!vcluster.Initialize(item).ok()) {
+    return false;
+  }
+  RunMetadata metadata;
+  Status s = vcluster.Run(item.graph, item.feed, item.fetch, &metadata);
+  if (!s.ok() && s.code() != error::RESOURCE_EXHAUSTED) {
+    return false;
+  }
+
+  for (const auto& dev_stats : metadata.step_stats().dev_stats()) {
+    for (const auto& node_stats : dev_stats.node_stats()) {
+      Costs::NanoSeconds exec_time =
+          Costs::NanoSeconds(1) +
+          Costs::MicroSeconds(node_stats.all_start_micros() +
+                              node_stats.op_end_rel_micros());
+      op_completion_times->emplace(node_stats.node_name(), exec_time);
+    }
+  }
+  return true;
+}
+
 static bool IdentifySwappingCandidates(
     Cluster* cluster, GrapplerItem* item, std::unordered_set<string>* skip_list,
     std::unordered_map<NodeDef*, SwapInfo>* nodes_to_swap) {
@@ -957,7 +994,8 @@ static bool IdentifySwappingCandidates(
   for (const auto& device : devices) {
     const string& name = device.first;
     const DeviceProperties& prop = device.second;
-    if (prop.type() != "GPU") {
+    // The swap kernels are registered for GPU and SYCL devices.
+    if (prop.type() != "GPU" && prop.type() != "SYCL") {
       continue;
     }
     if (prop.memory_size() <= 0) {
@@ -972,29 +1010,8 @@ static bool IdentifySwappingCandidates(
     int64 required_savings = mem_usage.used_memory - prop.memory_size();
 
     std::unordered_map<string, Costs::NanoSeconds> op_completion_times;
-    {
-      VirtualCluster vcluster(cluster->GetDevices());
-      if (!vcluster.Provision().ok()) {
-        return false;
-      }
-      if (!vcluster.Initialize(*item).ok()) {
-        return false;
-      }
-      RunMetadata metadata;
-      Status s = vcluster.Run(item->graph, item->feed, item->fetch, &metadata);
-      if (!s.ok() && s.code() != error::RESOURCE_EXHAUSTED) {
-        return false;
-      }
-
-      for (const auto& dev_stats : metadata.step_stats().dev_stats()) {
-        for (const auto& node_stats : dev_stats.node_stats()) {
-          Costs::NanoSeconds exec_time =
-              Costs::NanoSeconds(1) +
-              Costs::MicroSeconds(node_stats.all_start_micros() +
-                                  node_stats.op_end_rel_micros());
-          op_completion_times.emplace(node_stats.node_name(), exec_time);
-        }
-      }
+    if (!GetOpCompletionTimes(cluster, *item, &op_completion_times)) {
+      return false;
     }
 
     Costs::Duration peak_time = -1;
@@ -1222,6 +1239,292 @@ bool SwappingPass(RewriterConfig::MemOptType optimization_level,
   return updated_graph;
 }
 
+// A way to release a tensor that is live at the memory peak of a device:
+// either swap it to the host or recompute it for its uses after the peak.
+struct RematerializationCandidate {
+  GraphView::OutputPort port;
+  int64 memory_used;
+  // The uses of the tensor after the peak.
+  std::vector<GraphView::InputPort> uses_left;
+  bool recompute;
+  // Estimated extra time in nanoseconds needed to release the tensor.
+  double cost;
+
+  bool operator<(const RematerializationCandidate& other) const {
+    const double cost_per_byte = cost / memory_used;
+    const double other_cost_per_byte = other.cost / other.memory_used;
+    if (cost_per_byte != other_cost_per_byte) {
+      return cost_per_byte < other_cost_per_byte;
+    }
+    return memory_used > other.memory_used;
+  }
+};
+
+// Returns true if the node can be run a second time right before the uses of
+// its output after the memory peak without changing the results or extending
+// the lifetime of its inputs, which must either be persistent or remain live
+// until the output itself is released.
+static bool IsRecomputable(
+    const NodeDef& node, Costs::Duration deallocation_time,
+    const std::unordered_set<string>& feeds, const FrameMap& frame_map,
+    const std::unordered_map<string, const NodeDef*>& name_map,
+    const std::unordered_map<string, Costs::Duration>& live_until) {
+  // The recomputed node would not take on the fed value.
+  if (feeds.count(node.name()) > 0 || IsPersistent(node) ||
+      IsConstant(node) || !IsFreeOfSideEffect(node) ||
+      ModifiesFrameInfo(node) || IsSwitch(node) || IsMerge(node)) {
+    return false;
+  }
+  // Don't recompute nodes that have already been recomputed.
+  if (node.name().find(kRecomputedNodePrefix) == 0 ||
+      name_map.count(AddPrefixToNodeName(node.name(),
+                                         kRecomputedNodePrefix)) > 0) {
+    return false;
+  }
+  auto frames = frame_map.find(&node);
+  if (frames != frame_map.end() && !frames->second.empty()) {
+    return false;
+  }
+  for (const string& input : node.input()) {
+    if (IsControlInput(input)) {
+      continue;
+    }
+    int port;
+    const string input_name = ParseNodeName(input, &port);
+    auto it = name_map.find(input_name);
+    if (it == name_map.end()) {
+      return false;
+    }
+    if (IsPersistent(*it->second) || IsConstant(*it->second)) {
+      continue;
+    }
+    auto live = live_until.find(strings::StrCat(input_name, ":", port));
+    if (live == live_until.end() || live->second < deallocation_time) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Adds the input to the list of inputs of the node to swap to the host.
+static void AnnotateInputToSwap(int input_id, NodeDef* node) {
+  AttrValue& val = (*node->mutable_attr())["_swap_to_host"];
+  if (!val.has_list()) {
+    const bool has_input = val.value_case() == AttrValue::kI;
+    const int64 previous_input = val.i();
+    val.mutable_list();
+    if (has_input) {
+      val.mutable_list()->add_i(previous_input);
+    }
+  }
+  for (int64 i : val.list().i()) {
+    if (i == input_id) {
+      return;
+    }
+  }
+  val.mutable_list()->add_i(input_id);
+}
+
+// Brings the peak memory usage of each device under the memory budget (or the
+// memory size of the device if the budget is 0). For every tensor live at the
+// peak that is still needed afterwards, estimates the extra time needed to
+// swap it to the host and back, and the time needed to recompute it, and keeps
+// the cheapest option. The tensors are then released greedily by increasing
+// cost per byte until the peak fits, which approximates the rematerialization
+// plan with the least extra compute. The swaps are added as _swap_to_host
+// annotations, processed by SwappingPass.
+static bool BudgetedRematerializationPass(Cluster* cluster, int64 memory_budget,
+                                          GrapplerItem* item) {
+  GraphMemory memory(*item);
+  const std::unordered_map<string, DeviceProperties>& devices =
+      cluster->GetDevices();
+  Status s = memory.InferStatically(devices);
+  if (!s.ok()) {
+    VLOG(1) << "Failed to infer memory usage: " << s.error_message();
+    return false;
+  }
+  std::unordered_map<string, Costs::NanoSeconds> op_completion_times;
+  if (!GetOpCompletionTimes(cluster, *item, &op_completion_times)) {
+    return false;
+  }
+  FrameMap frame_map;
+  int num_frames;
+  if (!IdentifyFrames(item->graph, &frame_map, &num_frames).ok()) {
+    return false;
+  }
+  GraphProperties properties(*item);
+  const bool has_properties = properties.InferStatically(false).ok();
+  OpLevelCostEstimator estimator;
+
+  std::unordered_set<string> feeds;
+  for (const auto& feed : item->feed) {
+    feeds.insert(NodeName(feed.first));
+  }
+  std::unordered_map<string, const NodeDef*> name_map;
+  for (const auto& node : item->graph.node()) {
+    name_map[node.name()] = &node;
+  }
+  GraphView graph(&item->graph);
+
+  // The consumers of each tensor to swap, and the producers to recompute along
+  // with the consumers of their output.
+  std::map<string, std::set<int>> inputs_to_swap;
+  std::map<string, std::set<string>> nodes_to_recompute;
+  for (const auto& device : devices) {
+    const string& name = device.first;
+    const DeviceProperties& prop = device.second;
+    const int64 limit = memory_budget > 0 ? memory_budget : prop.memory_size();
+    if (limit <= 0) {
+      VLOG(1) << "Memory budget unknown for device " << name;
+      continue;
+    }
+    const GraphMemory::MemoryUsage& mem_usage = memory.GetPeakMemoryUsage(name);
+    if (mem_usage.used_memory <= limit) {
+      continue;
+    }
+    int64 required_savings = mem_usage.used_memory - limit;
+    // The swap kernels are registered for GPU and SYCL devices.
+    const bool can_swap = prop.type() == "GPU" || prop.type() == "SYCL";
+
+    Costs::Duration peak_time = -1;
+    std::unordered_map<string, Costs::Duration> live_until;
+    for (const auto& live_tensor : mem_usage.live_tensors) {
+      peak_time = std::max(peak_time, live_tensor.allocation_time);
+      live_until[strings::StrCat(live_tensor.node, ":",
+                                 live_tensor.output_id)] =
+          live_tensor.deallocation_time;
+    }
+
+    std::vector<RematerializationCandidate> candidates;
+    for (const auto& live_tensor : mem_usage.live_tensors) {
+      if (live_tensor.memory_used <= 1024) {
+        // Don't bother with small tensors.
+        continue;
+      }
+      auto producer = name_map.find(live_tensor.node);
+      if (producer == name_map.end()) {
+        continue;
+      }
+      GraphView::OutputPort port =
+          graph.GetOutputPort(live_tensor.node, live_tensor.output_id);
+      RematerializationCandidate candidate;
+      candidate.port = port;
+      candidate.memory_used = live_tensor.memory_used;
+      Costs::Duration earliest_use(Costs::Duration::infinity());
+      bool valid = true;
+      bool uses_swappable = true;
+      for (GraphView::InputPort input : graph.GetFanout(port)) {
+        auto it = op_completion_times.find(input.node->name());
+        if (it == op_completion_times.end()) {
+          valid = false;
+          break;
+        }
+        if (it->second <= peak_time) {
+          continue;
+        }
+        auto frames = frame_map.find(input.node);
+        if (frames != frame_map.end() && !frames->second.empty()) {
+          valid = false;
+          break;
+        }
+        uses_swappable &= IsSwappable(input);
+        candidate.uses_left.push_back(input);
+        earliest_use = std::min(earliest_use, it->second);
+      }
+      if (!valid || candidate.uses_left.empty()) {
+        continue;
+      }
+
+      double swap_cost = std::numeric_limits<double>::infinity();
+      if (can_swap && uses_swappable && IsSwappable(graph, port)) {
+        // Let's assume we're going to swap over PCIe running at 16 GBps. The
+        // transfers are free as long as they overlap with the computations
+        // before and after the peak.
+        const double time_to_swap = live_tensor.memory_used / 16.0;
+        const double time_to_swap_out =
+            (peak_time - live_tensor.allocation_time).count();
+        const double time_to_swap_in = (earliest_use - peak_time).count();
+        swap_cost = std::max(0.0, time_to_swap - time_to_swap_out) +
+                    std::max(0.0, time_to_swap - time_to_swap_in);
+      }
+      double recompute_cost = std::numeric_limits<double>::infinity();
+      // RecomputeSubgraph only rewires the uses of the first output.
+      if (has_properties && live_tensor.output_id == 0 &&
+          IsRecomputable(*producer->second, live_tensor.deallocation_time,
+                         feeds, frame_map, name_map, live_until)) {
+        const NodeDef& node = *producer->second;
+        OpContext op_context;
+        op_context.name = node.name();
+        op_context.device_name = node.device();
+        op_context.op_info = BuildOpInfoWithoutDevice(
+            node, name_map, properties.GetInputProperties(node.name()));
+        *op_context.op_info.mutable_device() = GetDeviceInfo(node.device());
+        recompute_cost =
+            estimator.PredictCosts(op_context).execution_time.count();
+      }
+      if (std::isinf(swap_cost) && std::isinf(recompute_cost)) {
+        continue;
+      }
+      candidate.recompute = recompute_cost < swap_cost;
+      candidate.cost = std::min(swap_cost, recompute_cost);
+      candidates.push_back(candidate);
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    for (const RematerializationCandidate& candidate : candidates) {
+      if (required_savings <= 0) {
+        break;
+      }
+      const string& producer = candidate.port.node->name();
+      VLOG(1) << "Will " << (candidate.recompute ? "recompute" : "swap")
+              << " tensor " << producer << ":" << candidate.port.port_id
+              << " of size " << candidate.memory_used << " at an extra cost of "
+              << candidate.cost << "ns";
+      for (const GraphView::InputPort& use : candidate.uses_left) {
+        if (candidate.recompute) {
+          nodes_to_recompute[producer].insert(use.node->name());
+        } else {
+          inputs_to_swap[use.node->name()].insert(use.port_id);
+        }
+      }
+      required_savings -= candidate.memory_used;
+    }
+  }
+  if (inputs_to_swap.empty() && nodes_to_recompute.empty()) {
+    return false;
+  }
+
+  for (auto& node : *item->graph.mutable_node()) {
+    auto it = inputs_to_swap.find(node.name());
+    if (it != inputs_to_swap.end()) {
+      for (int input_id : it->second) {
+        AnnotateInputToSwap(input_id, &node);
+      }
+    }
+  }
+  if (!nodes_to_recompute.empty()) {
+    // As in RecomputationRewritingPass, the topological numbering and the
+    // NodeMap only need to be valid for the nodes of the original graph.
+    TF_CHECK_OK(TopologicalSort(&item->graph));
+    NodeMap node_map(&item->graph);
+    std::unordered_map<const NodeDef*, int> topological_numbering;
+    for (int node_number = 0; node_number < item->graph.node_size();
+         ++node_number) {
+      topological_numbering[item->graph.mutable_node(node_number)] =
+          item->graph.node_size() - node_number - 1;
+    }
+    for (const auto& recompute : nodes_to_recompute) {
+      std::unordered_set<NodeDef*> target_nodes;
+      for (const string& target : recompute.second) {
+        target_nodes.insert(node_map.GetNode(target));
+      }
+      RecomputeSubgraph({node_map.GetNode(recompute.first)}, target_nodes,
+                        node_map, topological_numbering, &item->graph);
+    }
+  }
+  return true;
+}
+
 // TODO(rmlarsen): Add distributed TF test.
 Status RelaxAllocatorConstraints(GraphDef* optimized_graph) {
   std::unordered_set<string> devices;
@@ -1305,6 +1608,11 @@ Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
                              item);
 
   GrapplerItem optimized_item(item, optimized_graph);
+  if (optimization_level_ == RewriterConfig::BUDGETED_HEURISTICS &&
+      cluster != nullptr) {
+    BudgetedRematerializationPass(cluster, memory_budget_, &optimized_item);
+  }
+
   std::unordered_set<string> skip_list;
   // Bound the number of rewrite passes to avoid long processing times on graphs
   // that simply won't fit in memory.
@@ -1321,6 +1629,7 @@ Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
     if ((optimization_level_ == RewriterConfig::DEFAULT_MEM_OPT ||
          optimization_level_ == RewriterConfig::SWAPPING_HEURISTICS ||
          optimization_level_ == RewriterConfig::HEURISTICS ||
+         optimization_level_ == RewriterConfig::BUDGETED_HEURISTICS ||
          optimization_level_ == RewriterConfig::MANUAL) &&
         cluster != nullptr) {
       updated_graph |= SwappingPass(optimization_level_, cluster,
@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/utils.h"
 #include "tensorflow/core/grappler/utils/grappler_test.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/str_util.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -215,6 +216,28 @@ class MemoryOptimizerTest : public GrapplerTest {
     devices["/job:localhost/replica:0/task:0/gpu:0"] = gpu_device;
     return std::unique_ptr<VirtualCluster>(new VirtualCluster(devices));
   }
+
+  // Same as the above with a SYCL device whose cost estimates match those of
+  // the GPU, so that the swapping decisions are the same.
+  static std::unique_ptr<VirtualCluster> CreateSYCLVirtualCluster() {
+    DeviceProperties cpu_device;
+    cpu_device.set_type("CPU");
+    cpu_device.set_frequency(1000);
+    cpu_device.set_num_cores(4);
+    cpu_device.set_bandwidth(32);
+    cpu_device.set_memory_size(1024 * 1024);
+    DeviceProperties sycl_device;
+    sycl_device.set_type("SYCL");
+    sycl_device.set_frequency(1000);
+    sycl_device.set_num_cores(24);
+    sycl_device.set_bandwidth(128);
+    sycl_device.set_memory_size(1024 * 1024);
+    sycl_device.mutable_environment()->insert({"fma_per_core", "64"});
+    std::unordered_map<string, DeviceProperties> devices;
+    devices["/job:localhost/replica:0/task:0/cpu:0"] = cpu_device;
+    devices["/job:localhost/replica:0/task:0/device:SYCL:0"] = sycl_device;
+    return std::unique_ptr<VirtualCluster>(new VirtualCluster(devices));
+  }
 };
 
 TEST_F(MemoryOptimizerTest, SimpleSwapping) {
@@ -338,6 +361,52 @@ TEST_F(MemoryOptimizerTest, SwappingHeuristics) {
 #endif
 }
 
+TEST_F(MemoryOptimizerTest, SwappingHeuristicsOnSYCL) {
+  const string device = "/device:SYCL:0";
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output v = ops::Variable(s.WithOpName("v").WithDevice(device),
+                           {128, 128, 8}, DT_FLOAT);
+  Output a = ops::Identity(s.WithOpName("a").WithDevice(device), v);
+  Output b = ops::Square(s.WithOpName("b").WithDevice(device), v);
+  Output c = ops::Sqrt(s.WithOpName("c").WithDevice(device), a);
+  Output d = ops::Identity(s.WithOpName("d").WithDevice(device), b);
+  Output axis = ops::Const(s.WithOpName("axis"), 0);
+  Output e =
+      ops::Concat(s.WithOpName("e").WithDevice(device), {a, b, c, d}, axis);
+  Output f = ops::Square(s.WithOpName("f").WithDevice(device), a);
+  Output g = ops::Sqrt(s.WithOpName("g").WithDevice(device), b);
+  Output h = ops::Exp(s.WithOpName("h").WithDevice(device), c);
+  Output i = ops::Log(s.WithOpName("i").WithDevice(device), d);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"e", "f", "g", "h", "i"};
+
+  std::unique_ptr<VirtualCluster> cluster(CreateSYCLVirtualCluster());
+
+  MemoryOptimizer optimizer(RewriterConfig::SWAPPING_HEURISTICS);
+  GraphDef output;
+  Status status = optimizer.Optimize(cluster.get(), item, &output);
+  TF_EXPECT_OK(status);
+
+  int swapped = 0;
+  for (const auto& node : output.node()) {
+    if (node.op() == "_CopyFromGpuToHost") {
+      ++swapped;
+      EXPECT_EQ(device, node.device());
+    }
+    if (node.name() == "e") {
+      EXPECT_EQ(5, node.input_size());
+      EXPECT_EQ("a", node.input(0));
+      EXPECT_EQ("swap_in_e_1", node.input(1));
+      EXPECT_EQ("swap_in_e_2", node.input(2));
+      EXPECT_EQ("swap_in_e_3", node.input(3));
+      EXPECT_EQ("axis", node.input(4));
+    }
+  }
+  EXPECT_LE(3, swapped);
+}
+
 TEST_F(MemoryOptimizerTest, UnswappableInputs) {
   tensorflow::Scope s = tensorflow::Scope::NewRootScope();
   Output v = ops::Variable(s.WithOpName("v").WithDevice("/gpu:0"),
@@ -440,6 +509,51 @@ TEST_F(MemoryOptimizerTest, AccumulationRewrites) {
   }
 }
 
+TEST_F(MemoryOptimizerTest, BudgetedRematerialization) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output v = ops::Variable(s.WithOpName("v").WithDevice("/gpu:0"),
+                           {128, 128, 8}, DT_FLOAT);
+  Output a = ops::Sqrt(s.WithOpName("a").WithDevice("/gpu:0"), v);
+  Output b = ops::Square(s.WithOpName("b").WithDevice("/gpu:0"), a);
+  Output c = ops::Exp(s.WithOpName("c").WithDevice("/gpu:0"), b);
+  Output d = ops::Add(s.WithOpName("d").WithDevice("/gpu:0"), a, c);
+
+  Output constant = ops::Const(s.WithOpName("constant"), 1.0f, {128, 128, 8});
+  Output init = ops::Assign(s.WithOpName("init"), v, constant);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"d"};
+  item.init_ops = {init.name()};
+
+  std::unique_ptr<VirtualCluster> cluster(CreateVirtualCluster());
+
+  // Elementwise ops are much cheaper to recompute than to swap over PCIe.
+  MemoryOptimizer optimizer(RewriterConfig::BUDGETED_HEURISTICS, "gradients/",
+                            768 * 1024);
+  GraphDef output;
+  Status status = optimizer.Optimize(cluster.get(), item, &output);
+  TF_EXPECT_OK(status);
+
+  // The activations are recomputed from the variable rather than kept alive
+  // until the last add.
+  int num_recomputed = 0;
+  for (const auto& node : output.node()) {
+    if (str_util::StartsWith(node.name(), "Recomputed/")) {
+      EXPECT_TRUE(node.op() == "Sqrt" || node.op() == "Square") << node.op();
+      ++num_recomputed;
+    }
+  }
+  EXPECT_LT(0, num_recomputed);
+
+#if GOOGLE_CUDA
+  auto tensors_expected = EvaluateFetchNodes(item);
+  GrapplerItem optimized(item, std::move(output));
+  auto tensors = EvaluateFetchNodes(optimized);
+  test::ExpectTensorNear<float>(tensors_expected[0], tensors[0], 1e-6);
+#endif
+}
+
 class RelaxAllocatorConstraintsTest : public GrapplerTest {};
 
 TEST_F(RelaxAllocatorConstraintsTest, SameDevice) {
@@ -14,10 +14,14 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/grappler/optimizers/meta_optimizer.h"
+
+#include <algorithm>
+
 #include "tensorflow/core/common_runtime/function.h"
 #include "tensorflow/core/framework/function.pb.h"
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/grappler/optimizers/arithmetic_optimizer.h"
+#include "tensorflow/core/grappler/optimizers/auto_mixed_precision.h"
 #include "tensorflow/core/grappler/optimizers/auto_parallel.h"
 #include "tensorflow/core/grappler/optimizers/constant_folding.h"
 #include "tensorflow/core/grappler/optimizers/custom_graph_optimizer_registry.h"
@@ -27,7 +31,10 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/layout_optimizer.h"
 #include "tensorflow/core/grappler/optimizers/loop_optimizer.h"
 #include "tensorflow/core/grappler/optimizers/memory_optimizer.h"
+#include "tensorflow/core/grappler/optimizers/meta_optimizer_cache.h"
 #include "tensorflow/core/grappler/optimizers/model_pruner.h"
+#include "tensorflow/core/grappler/optimizers/op_grouping_optimizer.h"
+#include "tensorflow/core/grappler/optimizers/pipeline_parallel.h"
 #include "tensorflow/core/grappler/optimizers/remapper.h"
 #include "tensorflow/core/grappler/optimizers/scoped_allocator_optimizer.h"
 #include "tensorflow/core/grappler/optimizers/shape_optimizer.h"
@@ -35,6 +42,8 @@ limitations under the License.
 #include "tensorflow/core/grappler/utils/functions.h"
 #include "tensorflow/core/grappler/utils/topological_sort.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/cpu_info.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -81,6 +90,7 @@ std::unique_ptr<GraphOptimizer> MetaOptimizer::MakeNewOptimizer(
   MK_OPT("function", new FunctionOptimizer(cfg_.function_optimization()));
   MK_OPT("constfold", new ConstantFolding(cpu_device_));
   MK_OPT("shape", new ShapeOptimizer());
+  MK_OPT("auto_mixed_precision", new AutoMixedPrecision(RewriterConfig::ON));
   MK_OPT("remap", new Remapper(cfg_.remapping()));
   MK_OPT("layout", new LayoutOptimizer());
   MK_OPT("memory", new MemoryOptimizer(RewriterConfig::MANUAL));
@@ -91,6 +101,11 @@ std::unique_ptr<GraphOptimizer> MetaOptimizer::MakeNewOptimizer(
   MK_OPT("debug_stripper", new DebugStripper());
   MK_OPT("scoped_allocator",
          new ScopedAllocatorOptimizer(cfg_.scoped_allocator_opts()));
+  MK_OPT("op_grouping", new OpGroupingOptimizer(cfg_.op_grouping()));
+  MK_OPT("pipeline_parallel",
+         new PipelineParallel(
+             std::max(1, cfg_.pipeline_parallel().num_stages()),
+             std::max(1, cfg_.pipeline_parallel().num_micro_batches())));
 
   return std::unique_ptr<GraphOptimizer>();
 }
@@ -116,6 +131,10 @@ Status MetaOptimizer::InitializeOptimizers(
   if (cfg_.shape_optimization() != RewriterConfig::OFF) {
     optimizers->emplace_back(new ShapeOptimizer());
   }
+  if (cfg_.auto_mixed_precision() == RewriterConfig::ON) {
+    optimizers->emplace_back(
+        new AutoMixedPrecision(cfg_.auto_mixed_precision()));
+  }
   if (cfg_.remapping() != RewriterConfig::OFF) {
     optimizers->emplace_back(new Remapper(cfg_.remapping()));
   }
@@ -134,20 +153,26 @@ Status MetaOptimizer::InitializeOptimizers(
     optimizers->emplace_back(new LayoutOptimizer());
   }
   if (cfg_.memory_optimization() != RewriterConfig::NO_MEM_OPT) {
-    if (cfg_.memory_optimizer_target_node_name_scope().empty()) {
-      optimizers->emplace_back(
-          // Use the default target node name prefix "gradients/"
-          new MemoryOptimizer(cfg_.memory_optimization()));
-    } else {
-      optimizers->emplace_back(
-          new MemoryOptimizer(cfg_.memory_optimization(),
-                              cfg_.memory_optimizer_target_node_name_scope()));
-    }
+    // Use the default target node name prefix "gradients/" if none is set.
+    const string scope =
+        cfg_.memory_optimizer_target_node_name_scope().empty()
+            ? "gradients/"
+            : cfg_.memory_optimizer_target_node_name_scope();
+    optimizers->emplace_back(new MemoryOptimizer(
+        cfg_.memory_optimization(), scope, cfg_.memory_optimizer_budget()));
   }
   if (cfg_.auto_parallel().enable()) {
     optimizers->emplace_back(
         new AutoParallel(cfg_.auto_parallel().num_replicas()));
   }
+  if (cfg_.pipeline_parallel().enable()) {
+    optimizers->emplace_back(new PipelineParallel(
+        std::max(1, cfg_.pipeline_parallel().num_stages()),
+        std::max(1, cfg_.pipeline_parallel().num_micro_batches())));
+  }
+  if (cfg_.op_grouping() == RewriterConfig::ON) {
+    optimizers->emplace_back(new OpGroupingOptimizer(cfg_.op_grouping()));
+  }
   if (cfg_.scoped_allocator_optimization()) {
     optimizers->emplace_back(
         new ScopedAllocatorOptimizer(cfg_.scoped_allocator_opts()));
@@ -273,7 +298,10 @@ Status MetaOptimizer::OptimizeGraph(Cluster* cluster, const GrapplerItem& item,
   }
 
   // Record graph optimization result.
-  optimization_results_.push_back(optimization_result);
+  {
+    mutex_lock l(optimization_results_mu_);
+    optimization_results_.push_back(optimization_result);
+  }
 
   if (is_optimized) {
     TF_RETURN_IF_ERROR(TopologicalSort(optimized_graph));
@@ -288,7 +316,10 @@ Status MetaOptimizer::OptimizeGraph(Cluster* cluster, const GrapplerItem& item,
 
 Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
                                GraphDef* optimized_graph) {
-  optimization_results_.clear();
+  {
+    mutex_lock l(optimization_results_mu_);
+    optimization_results_.clear();
+  }
 
   // 1. Optimize main graph
   TF_RETURN_IF_ERROR(OptimizeGraph(cluster, item, optimized_graph));
@@ -304,6 +335,8 @@ Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
   while (optimize_function_library) {
     optimize_function_library = false;
 
+    // Make GrapplerItems for all the functions to optimize in this pass.
+    std::vector<GrapplerFunctionItem> func_items;
     for (const FunctionDef& func : optimized_graph->library().function()) {
       const string& func_name = func.signature().name();
 
@@ -322,18 +355,41 @@ Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
       optimized_funcs.insert(func_name);
 
       // Make a GrapplerItem from a FunctionDef.
-      GrapplerFunctionItem func_item;
-      TF_RETURN_IF_ERROR(MakeGrapplerFunctionItem(func, flib, &func_item));
-
-      // Optimize function body graph.
-      GraphDef optimized_func_graph;
+      func_items.emplace_back();
       TF_RETURN_IF_ERROR(
-          OptimizeGraph(cluster, func_item, &optimized_func_graph));
+          MakeGrapplerFunctionItem(func, flib, &func_items.back()));
+    }
+
+    // Optimize function body graphs. They don't depend on each other, so for
+    // large libraries they are optimized in parallel.
+    const int num_funcs = func_items.size();
+    std::vector<GraphDef> optimized_func_graphs(num_funcs);
+    std::vector<Status> statuses(num_funcs);
+    auto optimize_func = [&](int i) {
+      statuses[i] =
+          OptimizeGraph(cluster, func_items[i], &optimized_func_graphs[i]);
+    };
+    const int num_threads = std::min(num_funcs, port::NumSchedulableCPUs());
+    if (num_threads > 1) {
+      // The thread pool destructor waits for all the scheduled closures.
+      thread::ThreadPool pool(Env::Default(), "optimize_functions",
+                              num_threads);
+      for (int i = 0; i < num_funcs; ++i) {
+        pool.Schedule([&optimize_func, i]() { optimize_func(i); });
+      }
+    } else {
+      for (int i = 0; i < num_funcs; ++i) optimize_func(i);
+    }
+
+    for (int i = 0; i < num_funcs; ++i) {
+      TF_RETURN_IF_ERROR(statuses[i]);
+      GrapplerFunctionItem& func_item = func_items[i];
+      const string func_name = func_item.id;
 
       // Function body optimization might have created new specialized
       // functions for each instantiation context. Add them to the library.
       for (const FunctionDef& func_def :
-           optimized_func_graph.library().function()) {
+           optimized_func_graphs[i].library().function()) {
         if (flib.Find(func_def.signature().name()) == nullptr) {
           TF_RETURN_IF_ERROR(flib.AddFunctionDef(func_def));
         }
@@ -341,7 +397,7 @@ Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
 
       // Convert optimized graph back to FunctionDef.
       FunctionDef optimized_func;
-      func_item.SwapFunctionBody(std::move(optimized_func_graph));
+      func_item.SwapFunctionBody(std::move(optimized_func_graphs[i]));
       TF_RETURN_IF_ERROR(MakeFunctionDef(func_item, flib, &optimized_func));
 
       // Replace optimized function with a new FunctionDef.
@@ -362,6 +418,7 @@ Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
 }
 
 void MetaOptimizer::PrintResult() {
+  mutex_lock l(optimization_results_mu_);
   for (const GraphOptimizationResult& graph_result : optimization_results_) {
     LOG(INFO) << "Optimization results for grappler item: " << graph_result.id;
     for (const OptimizerResult& result : graph_result.results) {
@@ -386,17 +443,33 @@ bool MetaOptimizerEnabled(const RewriterConfig& cfg) {
          cfg.loop_optimization() != RewriterConfig::OFF ||
          cfg.dependency_optimization() != RewriterConfig::OFF ||
          cfg.auto_parallel().enable() ||
+         cfg.pipeline_parallel().enable() ||
          cfg.memory_optimization() != RewriterConfig::NO_MEM_OPT ||
          cfg.debug_stripper() == RewriterConfig::ON ||
          cfg.scoped_allocator_optimization() == RewriterConfig::ON ||
+         cfg.auto_mixed_precision() == RewriterConfig::ON ||
+         cfg.op_grouping() == RewriterConfig::ON ||
          !cfg.optimizers().empty() || !cfg.custom_optimizers().empty();
 }
 
 Status RunMetaOptimizer(const GrapplerItem& item, const RewriterConfig& cfg,
                         DeviceBase* cpu_device, Cluster* cluster,
                         GraphDef* optimized_graph) {
+  OptimizedGraphCache* cache = OptimizedGraphCache::Global();
+  uint64 key = 0;
+  if (cache != nullptr) {
+    key = OptimizedGraphCache::Fingerprint(item, cluster, cfg);
+    if (cache->Lookup(key, optimized_graph)) {
+      VLOG(1) << "Reusing cached optimized graph for grappler item " << item.id;
+      return Status::OK();
+    }
+  }
+
   MetaOptimizer optimizer(cpu_device, cfg);
-  return optimizer.Optimize(cluster, item, optimized_graph);
+  TF_RETURN_IF_ERROR(optimizer.Optimize(cluster, item, optimized_graph));
+
+  if (cache != nullptr) cache->Insert(key, *optimized_graph);
+  return Status::OK();
 }
 
 }  // namespace grappler
@@ -20,6 +20,8 @@ limitations under the License.
 #include "tensorflow/core/grappler/grappler_item.h"
 #include "tensorflow/core/grappler/optimizers/graph_optimizer.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/protobuf/rewriter_config.pb.h"
 
 namespace tensorflow {
@@ -54,7 +56,8 @@ class MetaOptimizer : public GraphOptimizer {
       std::vector<std::unique_ptr<GraphOptimizer>>* optimizers) const;
 
   // Run optimization pass over a single GrapplerItem. Meta optimizer might run
-  // multiple such passes: 1) for the main graph 2) for the function library
+  // multiple such passes: 1) for the main graph 2) for the function library.
+  // Function library passes run concurrently for independent functions.
   Status OptimizeGraph(Cluster* cluster, const GrapplerItem& item,
                        GraphDef* optimized_graph);
 
@@ -72,7 +75,9 @@ class MetaOptimizer : public GraphOptimizer {
     std::vector<OptimizerResult> results;
   };
 
-  std::vector<GraphOptimizationResult> optimization_results_;
+  mutex optimization_results_mu_;
+  std::vector<GraphOptimizationResult> optimization_results_
+      GUARDED_BY(optimization_results_mu_);
 };
 
 bool MetaOptimizerEnabled(const RewriterConfig& cfg);
@@ -83,6 +88,10 @@ bool MetaOptimizerEnabled(const RewriterConfig& cfg);
 // during constant folding; if NULL, a new device is created for doing constant
 // folding. For performance, it is recommended to pass in an existing cpu_device
 // when possible.
+//
+// If TF_GRAPPLER_CACHE_DIR is set, optimized graphs are cached in that
+// directory, keyed by a fingerprint of <item>, the devices of <cluster> and
+// <cfg>, and are reused instead of optimizing the same graph again.
 Status RunMetaOptimizer(const GrapplerItem& item, const RewriterConfig& cfg,
                         DeviceBase* cpu_device, Cluster* cluster,
                         GraphDef* optimized_graph);
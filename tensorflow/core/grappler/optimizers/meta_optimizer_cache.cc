@@ -0,0 +1,168 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/meta_optimizer_cache.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/public/version.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace grappler {
+
+namespace {
+
+uint64 FingerprintProto(const protobuf::MessageLite& proto) {
+  string serialized;
+  if (!SerializeToStringDeterministic(proto, &serialized)) {
+    // Use a random fingerprint so that a proto that can't be serialized never
+    // produces a cache hit.
+    return random::New64();
+  }
+  return Fingerprint64(serialized);
+}
+
+uint64 FingerprintStrings(uint64 fp, const std::vector<string>& strs) {
+  fp = FingerprintCat64(fp, strs.size());
+  for (const string& s : strs) {
+    fp = FingerprintCat64(fp, Fingerprint64(s));
+  }
+  return fp;
+}
+
+}  // namespace
+
+OptimizedGraphCache* OptimizedGraphCache::Global() {
+  static OptimizedGraphCache* cache = []() -> OptimizedGraphCache* {
+    string cache_dir;
+    Status status =
+        ReadStringFromEnvVar("TF_GRAPPLER_CACHE_DIR", "", &cache_dir);
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to read TF_GRAPPLER_CACHE_DIR: " << status;
+      return nullptr;
+    }
+    if (cache_dir.empty()) return nullptr;
+    status = Env::Default()->RecursivelyCreateDir(cache_dir);
+    if (!status.ok() && !errors::IsAlreadyExists(status)) {
+      LOG(WARNING) << "Failed to create grappler cache directory " << cache_dir
+                   << ", optimized graphs will only be cached in memory: "
+                   << status;
+      cache_dir.clear();
+    }
+    return new OptimizedGraphCache(cache_dir);
+  }();
+  return cache;
+}
+
+uint64 OptimizedGraphCache::Fingerprint(const GrapplerItem& item,
+                                        const Cluster* cluster,
+                                        const RewriterConfig& cfg) {
+  uint64 fp = Fingerprint64(TF_VERSION_STRING);
+  fp = FingerprintCat64(fp, FingerprintProto(item.graph));
+  fp = FingerprintCat64(fp, FingerprintProto(cfg));
+
+  // Only the signature of the feeds can affect the optimizations, not their
+  // values.
+  fp = FingerprintCat64(fp, item.feed.size());
+  for (const auto& feed : item.feed) {
+    fp = FingerprintCat64(fp, Fingerprint64(feed.first));
+    fp = FingerprintCat64(fp, feed.second.dtype());
+    fp = FingerprintCat64(fp, Fingerprint64(feed.second.shape().DebugString()));
+  }
+  fp = FingerprintStrings(fp, item.fetch);
+  fp = FingerprintStrings(fp, item.init_ops);
+  fp = FingerprintStrings(fp, item.keep_ops);
+  fp = FingerprintStrings(fp, {item.save_op, item.restore_op,
+                               item.save_restore_loc_tensor});
+
+  if (cluster != nullptr) {
+    // The device map is unordered, sort by name to get a stable fingerprint.
+    std::vector<std::pair<string, const DeviceProperties*>> devices;
+    for (const auto& device : cluster->GetDevices()) {
+      devices.emplace_back(device.first, &device.second);
+    }
+    std::sort(devices.begin(), devices.end());
+    fp = FingerprintCat64(fp, devices.size());
+    for (const auto& device : devices) {
+      fp = FingerprintCat64(fp, Fingerprint64(device.first));
+      fp = FingerprintCat64(fp, FingerprintProto(*device.second));
+    }
+  }
+  return fp;
+}
+
+bool OptimizedGraphCache::Lookup(uint64 key, GraphDef* optimized_graph) {
+  {
+    mutex_lock l(mu_);
+    auto it = graphs_.find(key);
+    if (it != graphs_.end()) {
+      *optimized_graph = it->second;
+      return true;
+    }
+  }
+  if (cache_dir_.empty()) return false;
+
+  const string path = FilePath(key);
+  if (!Env::Default()->FileExists(path).ok()) return false;
+  GraphDef graph;
+  Status status = ReadBinaryProto(Env::Default(), path, &graph);
+  if (!status.ok()) {
+    LOG(WARNING) << "Ignoring unreadable grappler cache entry " << path << ": "
+                 << status;
+    return false;
+  }
+  VLOG(1) << "Loaded optimized graph from " << path;
+  *optimized_graph = graph;
+  mutex_lock l(mu_);
+  graphs_.emplace(key, std::move(graph));
+  return true;
+}
+
+void OptimizedGraphCache::Insert(uint64 key, const GraphDef& optimized_graph) {
+  {
+    mutex_lock l(mu_);
+    graphs_[key] = optimized_graph;
+  }
+  if (cache_dir_.empty()) return;
+
+  const string path = FilePath(key);
+  const string tmp_path = strings::StrCat(path, ".tmp.", random::New64());
+  Status status = WriteBinaryProto(Env::Default(), tmp_path, optimized_graph);
+  if (status.ok()) {
+    status = Env::Default()->RenameFile(tmp_path, path);
+  }
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to write grappler cache entry " << path << ": "
+                 << status;
+    Env::Default()->DeleteFile(tmp_path).IgnoreError();
+  }
+}
+
+string OptimizedGraphCache::FilePath(uint64 key) const {
+  return io::JoinPath(cache_dir_,
+                      strings::StrCat(strings::Hex(key, strings::ZERO_PAD_16),
+                                      ".graph.pb"));
+}
+
+}  // namespace grappler
+}  // namespace tensorflow
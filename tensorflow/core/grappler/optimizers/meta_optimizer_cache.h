@@ -0,0 +1,70 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_META_OPTIMIZER_CACHE_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_META_OPTIMIZER_CACHE_H_
+
+#include <unordered_map>
+
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/protobuf/rewriter_config.pb.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// A content addressed cache of graphs optimized by the meta optimizer. The key
+// is a fingerprint of everything the optimization depends on: the grappler
+// item, the devices of the cluster, the rewriter config and the TensorFlow
+// version.
+//
+// Optimized graphs are kept in memory, and also persisted in `cache_dir` if it
+// is not empty, so that they survive process restarts. Entries are written to
+// a temporary file and renamed into place, which makes it safe to share a
+// directory between processes.
+class OptimizedGraphCache {
+ public:
+  explicit OptimizedGraphCache(const string& cache_dir)
+      : cache_dir_(cache_dir) {}
+
+  // Returns the process wide cache, or nullptr if caching is disabled. The
+  // cache is enabled by setting TF_GRAPPLER_CACHE_DIR to a directory, which is
+  // created if it doesn't exist.
+  static OptimizedGraphCache* Global();
+
+  static uint64 Fingerprint(const GrapplerItem& item, const Cluster* cluster,
+                            const RewriterConfig& cfg);
+
+  // Returns true and fills `optimized_graph` if `key` is cached.
+  bool Lookup(uint64 key, GraphDef* optimized_graph);
+
+  void Insert(uint64 key, const GraphDef& optimized_graph);
+
+ private:
+  string FilePath(uint64 key) const;
+
+  const string cache_dir_;
+  mutex mu_;
+  std::unordered_map<uint64, GraphDef> graphs_ GUARDED_BY(mu_);
+};
+
+}  // namespace grappler
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_META_OPTIMIZER_CACHE_H_
@@ -0,0 +1,109 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/meta_optimizer_cache.h"
+
+#include "tensorflow/core/grappler/clusters/virtual_cluster.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/inputs/trivial_test_graph_input_yielder.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+class OptimizedGraphCacheTest : public ::testing::Test {
+ protected:
+  GrapplerItem MakeItem() {
+    TrivialTestGraphInputYielder fake_input(4, 1, 10, false, {"CPU:0"});
+    GrapplerItem item;
+    CHECK(fake_input.NextItem(&item));
+    return item;
+  }
+
+  std::unique_ptr<VirtualCluster> MakeCluster(const string& device_type) {
+    DeviceProperties device;
+    device.set_type(device_type);
+    std::unordered_map<string, DeviceProperties> devices;
+    devices["/job:localhost/replica:0/task:0/device:CPU:0"] = device;
+    return std::unique_ptr<VirtualCluster>(new VirtualCluster(devices));
+  }
+};
+
+TEST_F(OptimizedGraphCacheTest, FingerprintDependsOnItemDevicesAndConfig) {
+  GrapplerItem item = MakeItem();
+  std::unique_ptr<VirtualCluster> cpu_cluster = MakeCluster("CPU");
+  std::unique_ptr<VirtualCluster> gpu_cluster = MakeCluster("GPU");
+  RewriterConfig cfg;
+
+  const uint64 fp =
+      OptimizedGraphCache::Fingerprint(item, cpu_cluster.get(), cfg);
+  EXPECT_EQ(fp, OptimizedGraphCache::Fingerprint(MakeItem(), cpu_cluster.get(),
+                                                 cfg));
+  EXPECT_NE(fp, OptimizedGraphCache::Fingerprint(item, gpu_cluster.get(), cfg));
+  EXPECT_NE(fp, OptimizedGraphCache::Fingerprint(item, nullptr, cfg));
+
+  RewriterConfig other_cfg;
+  other_cfg.set_constant_folding(RewriterConfig::OFF);
+  EXPECT_NE(fp, OptimizedGraphCache::Fingerprint(item, cpu_cluster.get(),
+                                                 other_cfg));
+
+  GrapplerItem other_item = item;
+  other_item.fetch.push_back(other_item.graph.node(0).name());
+  EXPECT_NE(fp, OptimizedGraphCache::Fingerprint(other_item, cpu_cluster.get(),
+                                                 cfg));
+
+  other_item = item;
+  other_item.graph.mutable_node(0)->set_name("renamed");
+  EXPECT_NE(fp, OptimizedGraphCache::Fingerprint(other_item, cpu_cluster.get(),
+                                                 cfg));
+}
+
+TEST_F(OptimizedGraphCacheTest, InMemory) {
+  OptimizedGraphCache cache("");
+  GrapplerItem item = MakeItem();
+
+  GraphDef graph;
+  EXPECT_FALSE(cache.Lookup(1, &graph));
+  cache.Insert(1, item.graph);
+  ASSERT_TRUE(cache.Lookup(1, &graph));
+  EXPECT_EQ(item.graph.DebugString(), graph.DebugString());
+  EXPECT_FALSE(cache.Lookup(2, &graph));
+}
+
+TEST_F(OptimizedGraphCacheTest, PersistedAcrossInstances) {
+  const string cache_dir =
+      io::JoinPath(testing::TmpDir(), "optimized_graph_cache");
+  TF_ASSERT_OK(Env::Default()->RecursivelyCreateDir(cache_dir));
+  GrapplerItem item = MakeItem();
+
+  {
+    OptimizedGraphCache cache(cache_dir);
+    cache.Insert(42, item.graph);
+  }
+
+  // A new cache, as created after a restart, finds the graph on disk.
+  OptimizedGraphCache cache(cache_dir);
+  GraphDef graph;
+  ASSERT_TRUE(cache.Lookup(42, &graph));
+  EXPECT_EQ(item.graph.DebugString(), graph.DebugString());
+  EXPECT_FALSE(cache.Lookup(43, &graph));
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
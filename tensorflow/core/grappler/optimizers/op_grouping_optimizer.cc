@@ -0,0 +1,306 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/op_grouping_optimizer.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "tensorflow/core/framework/attr_value_util.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/grappler/utils/frame.h"
+#include "tensorflow/core/grappler/utils/topological_sort.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/util/device_name_utils.h"
+
+namespace tensorflow {
+namespace grappler {
+
+namespace {
+
+// Largest number of ops replaced by a single grouped op.
+constexpr int kMaxGroupSize = 512;
+
+struct GroupableOp {
+  const char* op;
+  const char* grouped_op;
+  // Number of inputs of the op, or -1 if it is variadic (AddN).
+  int num_inputs;
+};
+
+const GroupableOp* GetGroupableOp(const NodeDef& node) {
+  static const GroupableOp kGroupableOps[] = {
+      {"ApplyAdam", "_GroupedApplyAdam", 10},
+      {"ResourceApplyAdam", "_GroupedResourceApplyAdam", 10},
+      {"ApplyMomentum", "_GroupedApplyMomentum", 5},
+      {"ResourceApplyMomentum", "_GroupedResourceApplyMomentum", 5},
+      {"L2Loss", "_GroupedL2Loss", 1},
+      {"Cast", "_GroupedCast", 1},
+      {"AddN", "_GroupedAddN", -1},
+  };
+  for (const GroupableOp& op : kGroupableOps) {
+    if (node.op() == op.op) {
+      return &op;
+    }
+  }
+  return nullptr;
+}
+
+// Returns true if the attribute is copied to the grouped op. Internal
+// attributes such as colocation constraints are dropped: the devices have
+// already been assigned.
+bool IsGroupedAttr(const GroupableOp& op, const string& attr) {
+  if (attr.empty() || attr[0] == '_') {
+    return false;
+  }
+  // The number of inputs of each AddN is given by group_sizes.
+  return op.num_inputs >= 0 || attr != "N";
+}
+
+// Ops with the same key can be grouped.
+string GroupKey(const GroupableOp& op, const NodeDef& node, int depth) {
+  string key = strings::StrCat(node.op(), "|", node.device(), "|", depth);
+  // Sort the attributes to get a stable key.
+  std::map<string, const AttrValue*> attrs;
+  for (const auto& attr : node.attr()) {
+    if (IsGroupedAttr(op, attr.first)) {
+      attrs.emplace(attr.first, &attr.second);
+    }
+  }
+  for (const auto& attr : attrs) {
+    strings::StrAppend(&key, "|", attr.first, "=",
+                       SummarizeAttrValue(*attr.second));
+  }
+  return key;
+}
+
+int NumDataInputs(const NodeDef& node) {
+  int num_inputs = 0;
+  while (num_inputs < node.input_size() &&
+         !IsControlInput(node.input(num_inputs))) {
+    ++num_inputs;
+  }
+  return num_inputs;
+}
+
+// Builds the grouped op replacing the members, or returns false if their
+// device has no kernel for it.
+bool BuildGroupedNode(const GroupableOp& op,
+                      const std::vector<const NodeDef*>& members,
+                      const string& name, NodeDef* grouped) {
+  const NodeDef& first = *members[0];
+  grouped->set_name(name);
+  grouped->set_op(op.grouped_op);
+  grouped->set_device(first.device());
+  for (const auto& attr : first.attr()) {
+    if (IsGroupedAttr(op, attr.first)) {
+      (*grouped->mutable_attr())[attr.first] = attr.second;
+    }
+  }
+
+  if (op.num_inputs < 0) {
+    auto* group_sizes =
+        (*grouped->mutable_attr())["group_sizes"].mutable_list();
+    for (const NodeDef* member : members) {
+      const int num_inputs = NumDataInputs(*member);
+      for (int i = 0; i < num_inputs; ++i) {
+        *grouped->add_input() = member->input(i);
+      }
+      group_sizes->add_i(num_inputs);
+    }
+    (*grouped->mutable_attr())["N"].set_i(grouped->input_size());
+    (*grouped->mutable_attr())["num_groups"].set_i(members.size());
+  } else {
+    // The inputs of the grouped op are lists holding the k-th input of every
+    // member, for each k.
+    for (int k = 0; k < op.num_inputs; ++k) {
+      for (const NodeDef* member : members) {
+        *grouped->add_input() = member->input(k);
+      }
+    }
+    (*grouped->mutable_attr())["N"].set_i(members.size());
+  }
+
+  std::unordered_set<string> control_inputs;
+  for (const NodeDef* member : members) {
+    for (const string& input : member->input()) {
+      if (IsControlInput(input) && control_inputs.insert(input).second) {
+        *grouped->add_input() = input;
+      }
+    }
+  }
+
+  DeviceNameUtils::ParsedName parsed_name;
+  if (!DeviceNameUtils::ParseFullName(first.device(), &parsed_name) ||
+      !parsed_name.has_type) {
+    return false;
+  }
+  return FindKernelDef(DeviceType(parsed_name.type), *grouped, nullptr,
+                       nullptr)
+      .ok();
+}
+
+// Where the output of a grouped op now comes from.
+struct GroupedOutput {
+  string node;
+  int port;
+};
+
+// Points the inputs of node reading from grouped ops to the grouped op
+// replacing them.
+void RewriteInputs(
+    const std::unordered_map<string, GroupedOutput>& grouped_outputs,
+    NodeDef* node) {
+  std::unordered_set<string> control_inputs;
+  int pos = 0;
+  for (int i = 0; i < node->input_size(); ++i) {
+    string input = node->input(i);
+    int port;
+    const string input_name = ParseNodeName(input, &port);
+    auto it = grouped_outputs.find(input_name);
+    if (it != grouped_outputs.end()) {
+      if (port < 0) {
+        input = AsControlDependency(it->second.node);
+      } else {
+        input = it->second.port == 0
+                    ? it->second.node
+                    : strings::StrCat(it->second.node, ":", it->second.port);
+      }
+    }
+    // Several inputs may now be control dependencies on the same group.
+    if (IsControlInput(input) && !control_inputs.insert(input).second) {
+      continue;
+    }
+    node->set_input(pos++, input);
+  }
+  while (node->input_size() > pos) {
+    node->mutable_input()->RemoveLast();
+  }
+}
+
+}  // namespace
+
+Status OpGroupingOptimizer::Optimize(Cluster* /*cluster*/,
+                                     const GrapplerItem& item,
+                                     GraphDef* optimized_graph) {
+  const std::unordered_set<string> nodes_to_preserve = item.NodesToPreserve();
+  FrameMap frame_map;
+  int num_frames;
+  TF_RETURN_IF_ERROR(IdentifyFrames(item.graph, &frame_map, &num_frames));
+  std::unordered_map<const NodeDef*, int> topo_order;
+  TF_RETURN_IF_ERROR(
+      ComputeTopologicalOrder(item.graph, &topo_order, nullptr));
+  std::vector<const NodeDef*> sorted_nodes(item.graph.node_size());
+  for (const auto& it : topo_order) {
+    sorted_nodes[it.second] = it.first;
+  }
+
+  // Candidates keyed by op, device, attributes and depth. An ordered map keeps
+  // the output deterministic.
+  std::map<string, std::vector<const NodeDef*>> candidates;
+  std::unordered_map<string, int> depths;
+  for (const NodeDef* node : sorted_nodes) {
+    int depth = 0;
+    for (const string& input : node->input()) {
+      // The inputs of a Merge coming from NextIteration nodes, not yet
+      // visited, are back edges and don't matter.
+      auto it = depths.find(NodeName(input));
+      if (it != depths.end()) {
+        depth = std::max(depth, it->second + 1);
+      }
+    }
+    depths[node->name()] = depth;
+
+    const GroupableOp* op = GetGroupableOp(*node);
+    if (op == nullptr || nodes_to_preserve.count(node->name()) > 0 ||
+        !frame_map[node].empty() || node->device().empty() ||
+        (op->num_inputs >= 0 && NumDataInputs(*node) != op->num_inputs)) {
+      continue;
+    }
+    candidates[GroupKey(*op, *node, depth)].push_back(node);
+  }
+
+  std::vector<NodeDef> grouped_nodes;
+  std::unordered_map<string, GroupedOutput> grouped_outputs;
+  std::unordered_set<string> node_names;
+  for (const NodeDef& node : item.graph.node()) {
+    node_names.insert(node.name());
+  }
+  for (const auto& candidate : candidates) {
+    const std::vector<const NodeDef*>& nodes = candidate.second;
+    const int num_nodes = nodes.size();
+    for (int begin = 0; begin < num_nodes; begin += kMaxGroupSize) {
+      const int end = std::min(begin + kMaxGroupSize, num_nodes);
+      const std::vector<const NodeDef*> members(nodes.begin() + begin,
+                                                nodes.begin() + end);
+      if (members.size() < 2) {
+        continue;
+      }
+      string name = AddPrefixToNodeName(members[0]->name(),
+                                        "OpGroupingOptimizer");
+      while (node_names.count(name) > 0) {
+        name = AddPrefixToNodeName(name, "OpGroupingOptimizer");
+      }
+      const GroupableOp& op = *GetGroupableOp(*members[0]);
+      NodeDef grouped;
+      if (!BuildGroupedNode(op, members, name, &grouped)) {
+        VLOG(2) << "No kernel to group " << members.size() << " " << op.op
+                << " ops on " << members[0]->device();
+        continue;
+      }
+      VLOG(2) << "Grouping " << members.size() << " " << op.op << " ops into "
+              << name;
+      node_names.insert(name);
+      for (int i = 0; i < members.size(); ++i) {
+        grouped_outputs[members[i]->name()] = {name, i};
+      }
+      grouped_nodes.push_back(std::move(grouped));
+    }
+  }
+
+  optimized_graph->Clear();
+  for (const NodeDef& node : item.graph.node()) {
+    if (grouped_outputs.count(node.name()) > 0) {
+      continue;
+    }
+    NodeDef* new_node = optimized_graph->add_node();
+    *new_node = node;
+    RewriteInputs(grouped_outputs, new_node);
+  }
+  for (NodeDef& grouped : grouped_nodes) {
+    NodeDef* new_node = optimized_graph->add_node();
+    new_node->Swap(&grouped);
+    RewriteInputs(grouped_outputs, new_node);
+  }
+  *optimized_graph->mutable_library() = item.graph.library();
+  *optimized_graph->mutable_versions() = item.graph.versions();
+  return Status::OK();
+}
+
+void OpGroupingOptimizer::Feedback(Cluster* /*cluster*/,
+                                   const GrapplerItem& /*item*/,
+                                   const GraphDef& /*optimized_graph*/,
+                                   double /*result*/) {
+  // Nothing to do for OpGroupingOptimizer.
+}
+
+}  // end namespace grappler
+}  // end namespace tensorflow
@@ -0,0 +1,57 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_OP_GROUPING_OPTIMIZER_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_OP_GROUPING_OPTIMIZER_H_
+
+#include "tensorflow/core/grappler/optimizers/graph_optimizer.h"
+#include "tensorflow/core/protobuf/rewriter_config.pb.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// Replaces groups of independent ops of the same type and attributes placed
+// on the same device, such as the ApplyAdam updates of the variables of a
+// model, by a single _Grouped op computing all of them. This cuts the number
+// of ops the executor has to schedule, and the per-op overheads, when a step
+// runs many small ops.
+//
+// Ops are independent when neither depends on the other. Ops at the same
+// depth of the graph, the length of the longest path reaching them, always
+// are, so each group is made of ops at the same depth.
+class OpGroupingOptimizer : public GraphOptimizer {
+ public:
+  OpGroupingOptimizer() : opt_level_(RewriterConfig::ON) {}
+  explicit OpGroupingOptimizer(RewriterConfig::Toggle opt_level)
+      : opt_level_(opt_level) {}
+
+  ~OpGroupingOptimizer() override {}
+
+  string name() const override { return "op_grouping_optimizer"; };
+
+  Status Optimize(Cluster* cluster, const GrapplerItem& item,
+                  GraphDef* optimized_graph) override;
+
+  void Feedback(Cluster* cluster, const GrapplerItem& item,
+                const GraphDef& optimized_graph, double result) override;
+
+ private:
+  RewriterConfig::Toggle opt_level_;
+};
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_OP_GROUPING_OPTIMIZER_H_
@@ -0,0 +1,222 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/op_grouping_optimizer.h"
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/utils/grappler_test.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+class OpGroupingOptimizerTest : public GrapplerTest {};
+
+TEST_F(OpGroupingOptimizerTest, GroupL2Losses) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:CPU:0");
+  Output a = ops::Placeholder(s.WithOpName("a"), DT_FLOAT,
+                              ops::Placeholder::Shape({2, 3}));
+  Output b = ops::Placeholder(s.WithOpName("b"), DT_FLOAT,
+                              ops::Placeholder::Shape({4}));
+  Output c = ops::Placeholder(s.WithOpName("c"), DT_FLOAT,
+                              ops::Placeholder::Shape({5, 1}));
+  Output loss_a = ops::L2Loss(s.WithOpName("loss_a"), a);
+  Output loss_b = ops::L2Loss(s.WithOpName("loss_b"), b);
+  Output loss_c = ops::L2Loss(s.WithOpName("loss_c"), c);
+  Output total =
+      ops::AddN(s.WithOpName("total"), {loss_a, loss_b, loss_c});
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"total"};
+
+  OpGroupingOptimizer optimizer;
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_EQ(item.graph.node_size() - 2, output.node_size());
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE("L2Loss", node.op());
+    if (node.op() == "_GroupedL2Loss") {
+      EXPECT_EQ(3, node.attr().at("N").i());
+      ASSERT_EQ(3, node.input_size());
+      EXPECT_EQ("a", node.input(0));
+      EXPECT_EQ("b", node.input(1));
+      EXPECT_EQ("c", node.input(2));
+      found++;
+    }
+    if (node.name() == "total") {
+      ASSERT_EQ(3, node.input_size());
+      EXPECT_EQ("OpGroupingOptimizer/loss_a", node.input(0));
+      EXPECT_EQ("OpGroupingOptimizer/loss_a:1", node.input(1));
+      EXPECT_EQ("OpGroupingOptimizer/loss_a:2", node.input(2));
+      found++;
+    }
+  }
+  EXPECT_EQ(2, found);
+
+  auto a_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({2, 3}));
+  auto b_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({4}));
+  auto c_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({5, 1}));
+  std::vector<std::pair<string, Tensor>> feed = {
+      {"a", a_t}, {"b", b_t}, {"c", c_t}};
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, feed);
+  EXPECT_EQ(1, tensors_expected.size());
+  auto tensors = EvaluateNodes(output, item.fetch, feed);
+  EXPECT_EQ(1, tensors.size());
+  test::ExpectTensorNear<float>(tensors_expected[0], tensors[0], 1e-6);
+}
+
+TEST_F(OpGroupingOptimizerTest, GroupAddNsAndCasts) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:CPU:0");
+  Output a = ops::Placeholder(s.WithOpName("a"), DT_FLOAT,
+                              ops::Placeholder::Shape({2, 3}));
+  Output b = ops::Placeholder(s.WithOpName("b"), DT_FLOAT,
+                              ops::Placeholder::Shape({4}));
+  Output sum_a = ops::AddN(s.WithOpName("sum_a"), {a, a});
+  Output sum_b = ops::AddN(s.WithOpName("sum_b"), {b, b, b});
+  Output cast_a = ops::Cast(s.WithOpName("cast_a"), sum_a, DT_DOUBLE);
+  Output cast_b = ops::Cast(s.WithOpName("cast_b"), sum_b, DT_DOUBLE);
+  Output out_a = ops::Identity(s.WithOpName("out_a"), cast_a);
+  Output out_b = ops::Identity(s.WithOpName("out_b"), cast_b);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"out_a", "out_b"};
+
+  OpGroupingOptimizer optimizer;
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_EQ(item.graph.node_size() - 2, output.node_size());
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    if (node.op() == "_GroupedAddN") {
+      ASSERT_EQ(5, node.input_size());
+      EXPECT_EQ(2, node.attr().at("num_groups").i());
+      const auto& group_sizes = node.attr().at("group_sizes").list();
+      ASSERT_EQ(2, group_sizes.i_size());
+      EXPECT_EQ(2, group_sizes.i(0));
+      EXPECT_EQ(3, group_sizes.i(1));
+      found++;
+    }
+    if (node.op() == "_GroupedCast") {
+      ASSERT_EQ(2, node.input_size());
+      EXPECT_EQ("OpGroupingOptimizer/sum_a", node.input(0));
+      EXPECT_EQ("OpGroupingOptimizer/sum_a:1", node.input(1));
+      found++;
+    }
+  }
+  EXPECT_EQ(2, found);
+
+  auto a_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({2, 3}));
+  auto b_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({4}));
+  std::vector<std::pair<string, Tensor>> feed = {{"a", a_t}, {"b", b_t}};
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, feed);
+  EXPECT_EQ(2, tensors_expected.size());
+  auto tensors = EvaluateNodes(output, item.fetch, feed);
+  EXPECT_EQ(2, tensors.size());
+  for (int i = 0; i < 2; ++i) {
+    test::ExpectTensorNear<double>(tensors_expected[i], tensors[i], 1e-6);
+  }
+}
+
+TEST_F(OpGroupingOptimizerTest, GroupApplyAdams) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:CPU:0");
+  auto scalar = [&s](const string& name) {
+    return ops::Const(s.WithOpName(name), 0.5f, {});
+  };
+  Output beta1_power = scalar("beta1_power");
+  Output beta2_power = scalar("beta2_power");
+  Output lr = scalar("lr");
+  Output beta1 = scalar("beta1");
+  Output beta2 = scalar("beta2");
+  Output epsilon = scalar("epsilon");
+  std::vector<Output> updates;
+  for (const string& name : {"x", "y"}) {
+    const PartialTensorShape shape({3});
+    Output var = ops::Variable(s.WithOpName(name), shape, DT_FLOAT);
+    Output m = ops::Variable(s.WithOpName(name + "_m"), shape, DT_FLOAT);
+    Output v = ops::Variable(s.WithOpName(name + "_v"), shape, DT_FLOAT);
+    Output grad = ops::Const(s.WithOpName(name + "_grad"), 1.0f, {3});
+    updates.push_back(ops::ApplyAdam(s.WithOpName(name + "_update"), var, m,
+                                     v, beta1_power, beta2_power, lr, beta1,
+                                     beta2, epsilon, grad));
+  }
+  auto train = ops::NoOp(s.WithOpName("train").WithControlDependencies(
+      {updates[0].op(), updates[1].op()}));
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"train"};
+
+  OpGroupingOptimizer optimizer;
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_EQ(item.graph.node_size() - 1, output.node_size());
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE("ApplyAdam", node.op());
+    if (node.op() == "_GroupedApplyAdam") {
+      EXPECT_EQ(2, node.attr().at("N").i());
+      ASSERT_EQ(20, node.input_size());
+      EXPECT_EQ("x", node.input(0));
+      EXPECT_EQ("y", node.input(1));
+      EXPECT_EQ("x_m", node.input(2));
+      EXPECT_EQ("y_grad", node.input(19));
+      found++;
+    }
+    if (node.name() == "train") {
+      ASSERT_EQ(1, node.input_size());
+      EXPECT_EQ("^OpGroupingOptimizer/x_update", node.input(0));
+      found++;
+    }
+  }
+  EXPECT_EQ(2, found);
+}
+
+TEST_F(OpGroupingOptimizerTest, DontGroupDependentOps) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:CPU:0");
+  Output a = ops::Placeholder(s.WithOpName("a"), DT_FLOAT,
+                              ops::Placeholder::Shape({2, 3}));
+  Output sum1 = ops::AddN(s.WithOpName("sum1"), {a, a});
+  Output sum2 = ops::AddN(s.WithOpName("sum2"), {sum1, a});
+  Output out = ops::Identity(s.WithOpName("out"), sum2);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"out"};
+
+  OpGroupingOptimizer optimizer;
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_EQ(item.graph.node_size(), output.node_size());
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE("_GroupedAddN", node.op());
+  }
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
@@ -0,0 +1,714 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/pipeline_parallel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/costs/graph_properties.h"
+#include "tensorflow/core/grappler/costs/op_level_cost_estimator.h"
+#include "tensorflow/core/grappler/costs/utils.h"
+#include "tensorflow/core/grappler/devices.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/op_types.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/grappler/utils/frame.h"
+#include "tensorflow/core/grappler/utils/topological_sort.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/util/device_name_utils.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+const char kPipelineParallelPrefix[] = "PipelineParallel";
+
+// Returns the position of the gradient input of the ops applying gradients
+// to variables, or -1 for other ops.
+int GradientPosition(const NodeDef& node) {
+  static const std::unordered_map<string, int>* const kGradientPositions =
+      new std::unordered_map<string, int>({{"ApplyGradientDescent", 2},
+                                           {"ApplyProximalGradientDescent", 4},
+                                           {"ApplyAdadelta", 6},
+                                           {"ApplyAdagrad", 3},
+                                           {"ApplyProximalAdagrad", 5},
+                                           {"ApplyAdagradDA", 3},
+                                           {"ApplyFtrl", 3},
+                                           {"ApplyMomentum", 3},
+                                           {"ApplyAdam", 9},
+                                           {"ApplyRMSProp", 7},
+                                           {"ApplyCenteredRMSProp", 8}});
+  // The resource variants take the same inputs.
+  string op = node.op();
+  if (str_util::StartsWith(op, "Resource")) {
+    op = op.substr(strlen("Resource"));
+  }
+  auto it = kGradientPositions->find(op);
+  return it == kGradientPositions->end() ? -1 : it->second;
+}
+
+// Nodes of the backward pass, in the "gradients/" name scope.
+bool IsBackward(const NodeDef& node) {
+  return str_util::StartsWith(node.name(), "gradients/") ||
+         node.name().find("/gradients/") != string::npos;
+}
+
+// Size in bytes of a tensor, counting unknown dimensions as 1.
+int64 TensorBytes(const OpInfo::TensorProperties& tensor) {
+  if (tensor.shape().unknown_rank()) {
+    return 0;
+  }
+  int64 num_elements = 1;
+  for (const auto& dim : tensor.shape().dim()) {
+    num_elements *= std::max<int64>(dim.size(), 1);
+  }
+  return num_elements * DataTypeSize(tensor.dtype());
+}
+
+std::vector<string> GetClusterGPUs(Cluster* cluster) {
+  std::vector<string> gpus;
+  if (cluster != nullptr) {
+    for (const string& device : cluster->GetDeviceNames()) {
+      DeviceNameUtils::ParsedName parsed_name;
+      if (DeviceNameUtils::ParseFullName(device, &parsed_name) &&
+          parsed_name.type == "GPU") {
+        gpus.push_back(device);
+      }
+    }
+    std::sort(gpus.begin(), gpus.end());
+  } else {
+    const int num_gpus = GetNumAvailableGPUs();
+    for (int i = 0; i < num_gpus; ++i) {
+      gpus.push_back(strings::StrCat("/device:GPU:", i));
+    }
+  }
+  return gpus;
+}
+
+// Rewrites a graph into a pipeline of micro-batches.
+class Pipeliner {
+ public:
+  Pipeliner(const GrapplerItem& item, int num_stages, int num_micro_batches,
+            const std::vector<string>& devices)
+      : item_(item),
+        num_stages_(num_stages),
+        num_micro_batches_(num_micro_batches),
+        devices_(devices),
+        properties_(item) {}
+
+  Status Initialize();
+  void BuildGraph(GraphDef* graph);
+
+ private:
+  Status FindReplicatedNodes();
+  Status CheckEdges();
+  Status AssignStages();
+  void FindScheduleEdges();
+
+  string StageDevice(int stage, const NodeDef& node) const;
+  string ReplicaName(const string& name, int micro_batch) const;
+  string ReplicaInput(const string& input, int micro_batch) const;
+  string SplitName(const string& source, int port) const;
+  string BarrierName(const NodeDef& node, int micro_batch) const;
+  string AxisName() const;
+
+  NodeDef* AddNode(const string& name, const string& op, const string& device,
+                   GraphDef* graph) const;
+  void AddAxis(GraphDef* graph) const;
+  void AddSplits(GraphDef* graph) const;
+  void AddReplicas(GraphDef* graph) const;
+  void AddBarriers(GraphDef* graph) const;
+  void AddFetches(GraphDef* graph) const;
+  void AddSharedNode(const NodeDef& node, GraphDef* graph) const;
+  string AddGradientAccumulation(const NodeDef& apply, const string& input,
+                                 GraphDef* graph) const;
+
+  const GrapplerItem& item_;
+  const int num_stages_;
+  const int num_micro_batches_;
+  const std::vector<string> devices_;
+  GraphProperties properties_;
+
+  std::unordered_map<string, const NodeDef*> nodes_;
+  std::unordered_map<string, std::vector<const NodeDef*>> consumers_;
+  // Nodes producing the batch: fed placeholders and dequeue ops.
+  std::unordered_set<string> batch_sources_;
+  // Outputs of the batch sources split into micro-batches.
+  std::set<std::pair<string, int>> split_outputs_;
+  // Nodes replicated for each micro-batch, in topological order.
+  std::vector<const NodeDef*> replicated_;
+  std::unordered_set<string> replicated_names_;
+  // The fetched replicated nodes, whose outputs are combined.
+  std::set<string> replicated_fetches_;
+  std::unordered_map<string, int> stages_;
+  // Nodes starting the computations of a micro-batch on a stage, and nodes
+  // ending them.
+  std::unordered_set<string> stage_entries_;
+  std::set<string> stage_exits_;
+};
+
+Status Pipeliner::Initialize() {
+  if (item_.fetch.empty()) {
+    return errors::InvalidArgument("No fetch nodes provided.");
+  }
+  for (const NodeDef& node : item_.graph.node()) {
+    nodes_[node.name()] = &node;
+    for (const string& input : node.input()) {
+      consumers_[NodeName(input)].push_back(&node);
+    }
+  }
+  TF_RETURN_IF_ERROR(properties_.InferStatically(false));
+  TF_RETURN_IF_ERROR(FindReplicatedNodes());
+  TF_RETURN_IF_ERROR(CheckEdges());
+  TF_RETURN_IF_ERROR(AssignStages());
+  FindScheduleEdges();
+  return Status::OK();
+}
+
+Status Pipeliner::FindReplicatedNodes() {
+  std::unordered_set<string> train_nodes;
+  for (const NodeDef* node : ComputeTransitiveFanin(item_.graph, item_.fetch)) {
+    train_nodes.insert(node->name());
+    if (IsDequeueOp(*node)) {
+      batch_sources_.insert(node->name());
+    }
+  }
+  // Scalars fed alongside the batch, such as a learning rate, are shared.
+  for (const auto& feed : item_.feed) {
+    const string name = NodeName(feed.first);
+    if (train_nodes.count(name) > 0 && feed.second.dims() > 0) {
+      batch_sources_.insert(name);
+    }
+  }
+  if (batch_sources_.empty()) {
+    return errors::InvalidArgument("No batch to split into micro-batches.");
+  }
+
+  // Replicate the computations depending on the batch, up to the ops applying
+  // the gradients.
+  std::deque<string> queue(batch_sources_.begin(), batch_sources_.end());
+  while (!queue.empty()) {
+    const string name = queue.front();
+    queue.pop_front();
+    for (const NodeDef* consumer : consumers_[name]) {
+      if (train_nodes.count(consumer->name()) > 0 &&
+          GradientPosition(*consumer) < 0 &&
+          batch_sources_.count(consumer->name()) == 0 &&
+          replicated_names_.insert(consumer->name()).second) {
+        queue.push_back(consumer->name());
+      }
+    }
+  }
+
+  std::unordered_map<const NodeDef*, int> topo_order;
+  TF_RETURN_IF_ERROR(
+      ComputeTopologicalOrder(item_.graph, &topo_order, nullptr));
+  for (const string& name : replicated_names_) {
+    replicated_.push_back(nodes_[name]);
+  }
+  std::sort(replicated_.begin(), replicated_.end(),
+            [&topo_order](const NodeDef* a, const NodeDef* b) {
+              return topo_order[a] < topo_order[b];
+            });
+
+  FrameMap frame_map;
+  int num_frames;
+  TF_RETURN_IF_ERROR(IdentifyFrames(item_.graph, &frame_map, &num_frames));
+  std::unordered_set<string> nodes_to_preserve = item_.NodesToPreserve();
+  for (const string& fetch : item_.fetch) {
+    nodes_to_preserve.erase(NodeName(fetch));
+  }
+  for (const NodeDef* node : replicated_) {
+    if (!frame_map[node].empty()) {
+      return errors::Unimplemented("Can't pipeline ", node->name(),
+                                   " which is in a loop.");
+    }
+    if (nodes_to_preserve.count(node->name()) > 0) {
+      return errors::Unimplemented("Can't replicate ", node->name(),
+                                   " which must be preserved.");
+    }
+  }
+  return Status::OK();
+}
+
+Status Pipeliner::CheckEdges() {
+  // The batch sources must be split along their first dimension.
+  for (const NodeDef* node : replicated_) {
+    for (const string& input : node->input()) {
+      int port;
+      const string name = ParseNodeName(input, &port);
+      if (port < 0 || batch_sources_.count(name) == 0) {
+        continue;
+      }
+      if (!properties_.HasOutputProperties(name) ||
+          properties_.GetOutputProperties(name).size() <=
+              static_cast<size_t>(port)) {
+        return errors::Unimplemented("Unknown type of ", input);
+      }
+      const OpInfo::TensorProperties& output =
+          properties_.GetOutputProperties(name)[port];
+      if (!output.shape().unknown_rank()) {
+        if (output.shape().dim_size() == 0) {
+          return errors::Unimplemented("Can't split the scalar ", input,
+                                       " into micro-batches.");
+        }
+        const int64 batch_size = output.shape().dim(0).size();
+        if (batch_size > 0 && batch_size % num_micro_batches_ != 0) {
+          return errors::InvalidArgument(
+              "Can't split ", input, " of batch size ", batch_size, " into ",
+              num_micro_batches_, " micro-batches.");
+        }
+      }
+      split_outputs_.emplace(name, port);
+    }
+  }
+
+  // The outputs of the replicated nodes can only be fetched, or be gradients
+  // which are accumulated.
+  for (const string& fetch : item_.fetch) {
+    int port;
+    const string name = ParseNodeName(fetch, &port);
+    if (replicated_names_.count(name) == 0) {
+      continue;
+    }
+    if (port > 0) {
+      return errors::Unimplemented("Can't combine the micro-batches of ",
+                                   fetch);
+    }
+    if (properties_.HasOutputProperties(name) &&
+        !properties_.GetOutputProperties(name).empty() &&
+        properties_.GetOutputProperties(name)[0].shape().unknown_rank()) {
+      return errors::Unimplemented("Can't combine the micro-batches of ",
+                                   fetch, " of unknown rank.");
+    }
+    replicated_fetches_.insert(name);
+  }
+  for (const NodeDef& node : item_.graph.node()) {
+    if (replicated_names_.count(node.name()) > 0) {
+      continue;
+    }
+    for (int i = 0; i < node.input_size(); ++i) {
+      int port;
+      const string name = ParseNodeName(node.input(i), &port);
+      if (port < 0 || replicated_names_.count(name) == 0 ||
+          (port == 0 && replicated_fetches_.count(name) > 0)) {
+        continue;
+      }
+      if (i != GradientPosition(node)) {
+        return errors::Unimplemented("Can't combine the micro-batches of ",
+                                     node.input(i), " read by ", node.name());
+      }
+    }
+  }
+  return Status::OK();
+}
+
+Status Pipeliner::AssignStages() {
+  OpLevelCostEstimator estimator;
+  std::vector<const NodeDef*> forward;
+  std::vector<double> times;
+  double total_time = 0;
+  for (const NodeDef* node : replicated_) {
+    if (IsBackward(*node)) {
+      continue;
+    }
+    OpContext op_context;
+    op_context.name = node->name();
+    op_context.device_name = node->device();
+    op_context.op_info = BuildOpInfoWithoutDevice(
+        *node, nodes_, properties_.GetInputProperties(node->name()));
+    *op_context.op_info.mutable_device() = GetDeviceInfo(node->device());
+    const Costs costs = estimator.PredictCosts(op_context);
+    forward.push_back(node);
+    times.push_back(costs.execution_time.count());
+    total_time += times.back();
+  }
+
+  // Cut the forward pass into stages of similar compute time, starting a new
+  // stage early if the activations of all the micro-batches in flight would
+  // not fit on the device.
+  int stage = 0;
+  int64 stage_bytes = 0;
+  double time_so_far = 0;
+  for (size_t i = 0; i < forward.size(); ++i) {
+    const NodeDef* node = forward[i];
+    if (total_time > 0) {
+      const int time_stage = std::min(
+          num_stages_ - 1,
+          static_cast<int>((time_so_far + times[i] / 2) * num_stages_ /
+                           total_time));
+      if (time_stage > stage) {
+        stage = time_stage;
+        stage_bytes = 0;
+      }
+    }
+    int64 bytes = 0;
+    if (properties_.HasOutputProperties(node->name())) {
+      for (const auto& output : properties_.GetOutputProperties(node->name())) {
+        bytes += TensorBytes(output);
+      }
+    }
+    const int64 memory_size =
+        devices_.empty()
+            ? 0
+            : GetDeviceInfo(StageDevice(stage, *node)).memory_size();
+    if (memory_size > 0 && stage_bytes > 0 && stage < num_stages_ - 1 &&
+        stage_bytes + bytes > memory_size) {
+      ++stage;
+      stage_bytes = 0;
+    }
+    stage_bytes += bytes;
+    time_so_far += times[i];
+    stages_[node->name()] = stage;
+  }
+
+  // Keep the backward computations on the stage of the forward computations
+  // they differentiate, which is the stage of their forward inputs. Those
+  // only reading other gradients follow them.
+  for (const NodeDef* node : replicated_) {
+    if (!IsBackward(*node)) {
+      continue;
+    }
+    int forward_stage = -1;
+    int backward_stage = num_stages_ - 1;
+    for (const string& input : node->input()) {
+      const string name = NodeName(input);
+      auto it = stages_.find(name);
+      if (it == stages_.end()) {
+        continue;
+      }
+      if (IsBackward(*nodes_[name])) {
+        backward_stage = std::min(backward_stage, it->second);
+      } else {
+        forward_stage = std::max(forward_stage, it->second);
+      }
+    }
+    stages_[node->name()] =
+        forward_stage >= 0 ? forward_stage : backward_stage;
+  }
+  if (VLOG_IS_ON(1)) {
+    std::vector<int> stage_sizes(num_stages_, 0);
+    for (const auto& it : stages_) {
+      ++stage_sizes[it.second];
+    }
+    VLOG(1) << "Pipeline stage sizes: " << str_util::Join(stage_sizes, ", ");
+  }
+  return Status::OK();
+}
+
+void Pipeliner::FindScheduleEdges() {
+  // The forward and the backward computations of a micro-batch on a stage
+  // are ordered separately, so that all the micro-batches can go through the
+  // forward pass before the first one goes back.
+  auto same_step = [this](const NodeDef& a, const NodeDef& b) {
+    return stages_.at(a.name()) == stages_.at(b.name()) &&
+           IsBackward(a) == IsBackward(b);
+  };
+  for (const NodeDef* node : replicated_) {
+    bool is_entry = true;
+    for (const string& input : node->input()) {
+      const string name = NodeName(input);
+      if (replicated_names_.count(name) > 0 &&
+          same_step(*nodes_.at(name), *node)) {
+        is_entry = false;
+        break;
+      }
+    }
+    if (is_entry) {
+      stage_entries_.insert(node->name());
+    }
+    bool is_exit = true;
+    for (const NodeDef* consumer : consumers_[node->name()]) {
+      if (replicated_names_.count(consumer->name()) > 0 &&
+          same_step(*consumer, *node)) {
+        is_exit = false;
+        break;
+      }
+    }
+    if (is_exit) {
+      stage_exits_.insert(node->name());
+    }
+  }
+}
+
+string Pipeliner::StageDevice(int stage, const NodeDef& node) const {
+  if (devices_.empty()) {
+    return node.device();
+  }
+  return devices_[stage % devices_.size()];
+}
+
+string Pipeliner::ReplicaName(const string& name, int micro_batch) const {
+  return AddPrefixToNodeName(
+      name, strings::StrCat(kPipelineParallelPrefix, "-MicroBatch-",
+                            micro_batch));
+}
+
+string Pipeliner::ReplicaInput(const string& input, int micro_batch) const {
+  int port;
+  const string name = ParseNodeName(input, &port);
+  if (replicated_names_.count(name) > 0) {
+    return ReplicaName(input, micro_batch);
+  }
+  if (port >= 0 && split_outputs_.count({name, port}) > 0) {
+    return strings::StrCat(SplitName(name, port), ":", micro_batch);
+  }
+  return input;
+}
+
+string Pipeliner::SplitName(const string& source, int port) const {
+  return AddPrefixToNodeName(
+      strings::StrCat(source, "-", port),
+      strings::StrCat(kPipelineParallelPrefix, "-Split"));
+}
+
+string Pipeliner::BarrierName(const NodeDef& node, int micro_batch) const {
+  return strings::StrCat(kPipelineParallelPrefix, "-Schedule/Stage-",
+                         stages_.at(node.name()),
+                         IsBackward(node) ? "-Backward-" : "-Forward-",
+                         micro_batch);
+}
+
+string Pipeliner::AxisName() const {
+  return strings::StrCat(kPipelineParallelPrefix, "-Axis");
+}
+
+NodeDef* Pipeliner::AddNode(const string& name, const string& op,
+                            const string& device, GraphDef* graph) const {
+  NodeDef* node = graph->add_node();
+  node->set_name(name);
+  node->set_op(op);
+  node->set_device(device);
+  return node;
+}
+
+void Pipeliner::AddAxis(GraphDef* graph) const {
+  NodeDef* axis = AddNode(AxisName(), "Const", "", graph);
+  (*axis->mutable_attr())["dtype"].set_type(DT_INT32);
+  Tensor value(DT_INT32, TensorShape({}));
+  value.scalar<int32>()() = 0;
+  value.AsProtoTensorContent((*axis->mutable_attr())["value"].mutable_tensor());
+}
+
+void Pipeliner::AddSplits(GraphDef* graph) const {
+  for (const auto& output : split_outputs_) {
+    const NodeDef& source = *nodes_.at(output.first);
+    NodeDef* split = AddNode(SplitName(output.first, output.second), "Split",
+                             source.device(), graph);
+    split->add_input(AxisName());
+    split->add_input(output.second == 0
+                         ? output.first
+                         : strings::StrCat(output.first, ":", output.second));
+    (*split->mutable_attr())["num_split"].set_i(num_micro_batches_);
+    (*split->mutable_attr())["T"].set_type(
+        properties_.GetOutputProperties(output.first)[output.second].dtype());
+  }
+}
+
+void Pipeliner::AddReplicas(GraphDef* graph) const {
+  for (int k = 0; k < num_micro_batches_; ++k) {
+    for (const NodeDef* node : replicated_) {
+      NodeDef* replica = graph->add_node();
+      *replica = *node;
+      replica->set_name(ReplicaName(node->name(), k));
+      if (!devices_.empty()) {
+        replica->set_device(StageDevice(stages_.at(node->name()), *node));
+        // The stage placement overrides colocation constraints.
+        replica->mutable_attr()->erase("_class");
+      }
+      for (int i = 0; i < replica->input_size(); ++i) {
+        replica->set_input(i, ReplicaInput(replica->input(i), k));
+      }
+      if (k > 0 && stage_entries_.count(node->name()) > 0) {
+        replica->add_input(AsControlDependency(BarrierName(*node, k - 1)));
+      }
+    }
+  }
+}
+
+void Pipeliner::AddBarriers(GraphDef* graph) const {
+  // A barrier completes when a micro-batch is done with a step of a stage.
+  std::map<string, NodeDef*> barriers;
+  for (int k = 0; k + 1 < num_micro_batches_; ++k) {
+    for (const string& name : stage_exits_) {
+      const NodeDef& node = *nodes_.at(name);
+      const string barrier_name = BarrierName(node, k);
+      NodeDef*& barrier = barriers[barrier_name];
+      if (barrier == nullptr) {
+        barrier = AddNode(barrier_name, "NoOp",
+                          StageDevice(stages_.at(name), node), graph);
+      }
+      barrier->add_input(AsControlDependency(ReplicaName(name, k)));
+    }
+  }
+}
+
+void Pipeliner::AddFetches(GraphDef* graph) const {
+  for (const string& name : replicated_fetches_) {
+    const NodeDef& node = *nodes_.at(name);
+    const string device = StageDevice(stages_.at(name), node);
+    const std::vector<OpInfo::TensorProperties> no_outputs;
+    const std::vector<OpInfo::TensorProperties>& outputs =
+        properties_.HasOutputProperties(name)
+            ? properties_.GetOutputProperties(name)
+            : no_outputs;
+    if (outputs.empty()) {
+      NodeDef* fetch = AddNode(name, "NoOp", device, graph);
+      for (int k = 0; k < num_micro_batches_; ++k) {
+        fetch->add_input(AsControlDependency(ReplicaName(name, k)));
+      }
+      continue;
+    }
+
+    const DataType dtype = outputs[0].dtype();
+    if (outputs[0].shape().dim_size() > 0) {
+      // Batches are concatenated.
+      NodeDef* concat = AddNode(name, "ConcatV2", device, graph);
+      for (int k = 0; k < num_micro_batches_; ++k) {
+        concat->add_input(ReplicaName(name, k));
+      }
+      concat->add_input(AxisName());
+      (*concat->mutable_attr())["N"].set_i(num_micro_batches_);
+      (*concat->mutable_attr())["T"].set_type(dtype);
+      (*concat->mutable_attr())["Tidx"].set_type(DT_INT32);
+      continue;
+    }
+
+    // Scalars such as losses are averaged.
+    NodeDef* pack = AddNode(
+        AddPrefixToNodeName(name,
+                            strings::StrCat(kPipelineParallelPrefix, "-Pack")),
+        "Pack", device, graph);
+    for (int k = 0; k < num_micro_batches_; ++k) {
+      pack->add_input(ReplicaName(name, k));
+    }
+    (*pack->mutable_attr())["N"].set_i(num_micro_batches_);
+    (*pack->mutable_attr())["T"].set_type(dtype);
+    (*pack->mutable_attr())["axis"].set_i(0);
+    NodeDef* mean = AddNode(name, "Mean", device, graph);
+    mean->add_input(pack->name());
+    mean->add_input(AxisName());
+    (*mean->mutable_attr())["T"].set_type(dtype);
+    (*mean->mutable_attr())["Tidx"].set_type(DT_INT32);
+    (*mean->mutable_attr())["keep_dims"].set_b(false);
+  }
+}
+
+string Pipeliner::AddGradientAccumulation(const NodeDef& apply,
+                                          const string& input,
+                                          GraphDef* graph) const {
+  const DataType dtype = apply.attr().at("T").type();
+  NodeDef* sum = AddNode(
+      AddPrefixToNodeName(apply.name(), strings::StrCat(kPipelineParallelPrefix,
+                                                        "-Accumulate")),
+      "AddN", apply.device(), graph);
+  for (int k = 0; k < num_micro_batches_; ++k) {
+    sum->add_input(ReplicaInput(input, k));
+  }
+  (*sum->mutable_attr())["N"].set_i(num_micro_batches_);
+  (*sum->mutable_attr())["T"].set_type(dtype);
+
+  NodeDef* count = AddNode(
+      AddPrefixToNodeName(apply.name(), strings::StrCat(kPipelineParallelPrefix,
+                                                        "-NumMicroBatches")),
+      "Const", apply.device(), graph);
+  (*count->mutable_attr())["dtype"].set_type(dtype);
+  Tensor value(dtype, TensorShape({}));
+  TF_CHECK_OK(SetTensorValue(dtype, num_micro_batches_, &value));
+  value.AsProtoTensorContent(
+      (*count->mutable_attr())["value"].mutable_tensor());
+
+  NodeDef* mean = AddNode(
+      AddPrefixToNodeName(apply.name(),
+                          strings::StrCat(kPipelineParallelPrefix, "-Mean")),
+      "RealDiv", apply.device(), graph);
+  mean->add_input(sum->name());
+  mean->add_input(count->name());
+  (*mean->mutable_attr())["T"].set_type(dtype);
+  return mean->name();
+}
+
+void Pipeliner::AddSharedNode(const NodeDef& node, GraphDef* graph) const {
+  NodeDef* new_node = graph->add_node();
+  *new_node = node;
+  new_node->clear_input();
+  for (const string& input : node.input()) {
+    int port;
+    const string name = ParseNodeName(input, &port);
+    if (replicated_names_.count(name) == 0 ||
+        (port <= 0 && replicated_fetches_.count(name) > 0)) {
+      new_node->add_input(input);
+    } else if (port < 0) {
+      for (int k = 0; k < num_micro_batches_; ++k) {
+        new_node->add_input(ReplicaName(input, k));
+      }
+    } else {
+      // This is a gradient, as checked by CheckEdges().
+      new_node->add_input(AddGradientAccumulation(node, input, graph));
+    }
+  }
+}
+
+void Pipeliner::BuildGraph(GraphDef* graph) {
+  graph->Clear();
+  for (const NodeDef& node : item_.graph.node()) {
+    if (replicated_names_.count(node.name()) == 0) {
+      AddSharedNode(node, graph);
+    }
+  }
+  AddAxis(graph);
+  AddSplits(graph);
+  AddReplicas(graph);
+  AddBarriers(graph);
+  AddFetches(graph);
+  *graph->mutable_library() = item_.graph.library();
+  *graph->mutable_versions() = item_.graph.versions();
+  VLOG(1) << "Pipelined graph size: " << graph->node_size();
+}
+
+}  // namespace
+
+Status PipelineParallel::Optimize(Cluster* cluster, const GrapplerItem& item,
+                                  GraphDef* output) {
+  const std::vector<string> devices =
+      devices_.empty() ? GetClusterGPUs(cluster) : devices_;
+  Pipeliner pipeliner(item, num_stages_, num_micro_batches_, devices);
+  TF_RETURN_IF_ERROR(pipeliner.Initialize());
+  pipeliner.BuildGraph(output);
+  return Status::OK();
+}
+
+void PipelineParallel::Feedback(Cluster* cluster, const GrapplerItem& item,
+                                const GraphDef& optimize_output,
+                                double result) {
+  // Nothing to do for PipelineParallel.
+}
+
+}  // end namespace grappler
+}  // end namespace tensorflow
@@ -0,0 +1,75 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_PIPELINE_PARALLEL_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_PIPELINE_PARALLEL_H_
+
+#include <vector>
+
+#include "tensorflow/core/grappler/optimizers/graph_optimizer.h"
+#include "tensorflow/core/lib/core/status.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// Automatically parallelize a model too large for a single device by
+// partitioning it across devices and pipelining micro-batches through them.
+//
+// The computations depending on the batch, read from the fed placeholders or
+// from a dequeue op, are partitioned into num_stages contiguous stages of
+// similar estimated cost, each placed on its own device. Each batch is split
+// into num_micro_batches micro-batches along the first dimension, and the
+// stages are replicated for each of them. The gradients of the micro-batches
+// are averaged before being applied, and the fetched outputs are
+// concatenated (or averaged for scalars such as losses).
+//
+// As in GPipe, every stage processes the forward computations of the
+// micro-batches in order, then their backward computations (the nodes in the
+// "gradients/" name scope), so that stage i works on micro-batch k while
+// stage i + 1 works on micro-batch k - 1.
+class PipelineParallel : public GraphOptimizer {
+ public:
+  PipelineParallel(int num_stages, int num_micro_batches)
+      : PipelineParallel(num_stages, num_micro_batches, {}) {}
+  // Places the stages on `devices`, round robin. If empty, the GPUs of the
+  // cluster are used.
+  PipelineParallel(int num_stages, int num_micro_batches,
+                   const std::vector<string>& devices)
+      : num_stages_(num_stages),
+        num_micro_batches_(num_micro_batches),
+        devices_(devices) {
+    CHECK(num_stages_ >= 1);
+    CHECK(num_micro_batches_ >= 1);
+  }
+  ~PipelineParallel() override {}
+
+  string name() const override { return "pipeline_parallel"; };
+
+  Status Optimize(Cluster* cluster, const GrapplerItem& item,
+                  GraphDef* output) override;
+
+  void Feedback(Cluster* cluster, const GrapplerItem& item,
+                const GraphDef& optimize_output, double result) override;
+
+ private:
+  int num_stages_;
+  int num_micro_batches_;
+  std::vector<string> devices_;
+};
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_PIPELINE_PARALLEL_H_
@@ -0,0 +1,168 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/pipeline_parallel.h"
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/grappler/utils/grappler_test.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+class PipelineParallelTest : public GrapplerTest {};
+
+TEST_F(PipelineParallelTest, SplitBatchIntoMicroBatches) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:CPU:0");
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({4, 3}));
+  Output w1 = ops::Const(s.WithOpName("w1"), 0.5f, {3, 3});
+  Output h = ops::MatMul(s.WithOpName("h"), x, w1);
+  Output r = ops::Relu(s.WithOpName("r"), h);
+  Output w2 = ops::Const(s.WithOpName("w2"), -0.25f, {3, 2});
+  Output y = ops::MatMul(s.WithOpName("y"), r, w2);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  auto x_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({4, 3}));
+  item.feed = {{"x", x_t}};
+  item.fetch = {"y"};
+
+  // Both stages on the CPU so that the pipeline can run in the test.
+  PipelineParallel pipeline(2, 2, {"/device:CPU:0", "/device:CPU:0"});
+  GraphDef output;
+  TF_EXPECT_OK(pipeline.Optimize(nullptr, item, &output));
+
+  NodeMap node_map(&output);
+  const NodeDef* split = node_map.GetNode("PipelineParallel-Split/x-0");
+  ASSERT_NE(nullptr, split);
+  EXPECT_EQ("Split", split->op());
+  EXPECT_EQ(2, split->attr().at("num_split").i());
+  EXPECT_EQ("x", split->input(1));
+  EXPECT_EQ(nullptr, node_map.GetNode("h"));
+
+  for (int k = 0; k < 2; ++k) {
+    const string prefix = strings::StrCat("PipelineParallel-MicroBatch-", k);
+    const NodeDef* h_k = node_map.GetNode(AddPrefixToNodeName("h", prefix));
+    ASSERT_NE(nullptr, h_k);
+    EXPECT_EQ(strings::StrCat("PipelineParallel-Split/x-0:", k), h_k->input(0));
+    EXPECT_EQ("w1", h_k->input(1));
+    if (k == 0) {
+      EXPECT_EQ(2, h_k->input_size());
+    } else {
+      // The second micro-batch enters the first stage after the first one.
+      ASSERT_EQ(3, h_k->input_size());
+      EXPECT_EQ("^PipelineParallel-Schedule/Stage-0-Forward-0",
+                h_k->input(2));
+    }
+  }
+
+  const NodeDef* fetch = node_map.GetNode("y");
+  ASSERT_NE(nullptr, fetch);
+  EXPECT_EQ("ConcatV2", fetch->op());
+  ASSERT_EQ(3, fetch->input_size());
+  EXPECT_EQ("PipelineParallel-MicroBatch-0/y", fetch->input(0));
+  EXPECT_EQ("PipelineParallel-MicroBatch-1/y", fetch->input(1));
+  EXPECT_EQ("PipelineParallel-Axis", fetch->input(2));
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+  EXPECT_EQ(1, tensors_expected.size());
+  auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+  EXPECT_EQ(1, tensors.size());
+  test::ExpectTensorNear<float>(tensors_expected[0], tensors[0], 1e-6);
+}
+
+TEST_F(PipelineParallelTest, AccumulateGradients) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({4, 3}));
+  Output w = ops::Variable(s.WithOpName("w"), {3, 1}, DT_FLOAT);
+  Output y = ops::MatMul(s.WithOpName("y"), x, w);
+  Output loss = ops::L2Loss(s.WithOpName("loss"), y);
+  Output y_grad = ops::Identity(s.WithOpName("gradients/y_grad"), y);
+  Output w_grad =
+      ops::MatMul(s.WithOpName("gradients/w_grad"), x, y_grad,
+                  ops::MatMul::TransposeA(true));
+  Output lr = ops::Const(s.WithOpName("lr"), 0.1f, {});
+  Output apply =
+      ops::ApplyGradientDescent(s.WithOpName("apply"), w, lr, w_grad);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.feed = {{"x", GenerateRandomTensor<DT_FLOAT>(TensorShape({4, 3}))}};
+  item.fetch = {"loss", "apply"};
+
+  PipelineParallel pipeline(2, 2, {"/device:CPU:0", "/device:CPU:1"});
+  GraphDef output;
+  TF_EXPECT_OK(pipeline.Optimize(nullptr, item, &output));
+
+  NodeMap node_map(&output);
+  const NodeDef* apply_node = node_map.GetNode("apply");
+  ASSERT_NE(nullptr, apply_node);
+  EXPECT_EQ("PipelineParallel-Mean/apply", apply_node->input(2));
+  const NodeDef* mean = node_map.GetNode("PipelineParallel-Mean/apply");
+  ASSERT_NE(nullptr, mean);
+  EXPECT_EQ("RealDiv", mean->op());
+  EXPECT_EQ("PipelineParallel-Accumulate/apply", mean->input(0));
+  EXPECT_EQ("PipelineParallel-NumMicroBatches/apply", mean->input(1));
+  const NodeDef* sum = node_map.GetNode("PipelineParallel-Accumulate/apply");
+  ASSERT_NE(nullptr, sum);
+  EXPECT_EQ("AddN", sum->op());
+  ASSERT_EQ(2, sum->input_size());
+  EXPECT_EQ("PipelineParallel-MicroBatch-0/gradients/w_grad", sum->input(0));
+  EXPECT_EQ("PipelineParallel-MicroBatch-1/gradients/w_grad", sum->input(1));
+
+  // The loss is averaged over the micro-batches.
+  const NodeDef* loss_node = node_map.GetNode("loss");
+  ASSERT_NE(nullptr, loss_node);
+  EXPECT_EQ("Mean", loss_node->op());
+  EXPECT_EQ("PipelineParallel-Pack/loss", loss_node->input(0));
+
+  // The gradients are computed on the stage of the forward op.
+  for (int k = 0; k < 2; ++k) {
+    const string prefix = strings::StrCat("PipelineParallel-MicroBatch-", k);
+    const NodeDef* y_k = node_map.GetNode(AddPrefixToNodeName("y", prefix));
+    const NodeDef* w_grad_k =
+        node_map.GetNode(AddPrefixToNodeName("gradients/w_grad", prefix));
+    ASSERT_NE(nullptr, y_k);
+    ASSERT_NE(nullptr, w_grad_k);
+    EXPECT_EQ(y_k->device(), w_grad_k->device());
+  }
+}
+
+TEST_F(PipelineParallelTest, NoBatch) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output a = ops::Const(s.WithOpName("a"), 1.0f, {4, 3});
+  Output b = ops::Relu(s.WithOpName("b"), a);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"b"};
+
+  PipelineParallel pipeline(2, 2);
+  GraphDef output;
+  EXPECT_FALSE(pipeline.Optimize(nullptr, item, &output).ok());
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
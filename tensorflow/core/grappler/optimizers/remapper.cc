@@ -15,6 +15,12 @@ limitations under the License.
 
 #include "tensorflow/core/grappler/optimizers/remapper.h"
 
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/grappler/costs/graph_properties.h"
 #include "tensorflow/core/grappler/graph_view.h"
@@ -22,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/op_types.h"
 #include "tensorflow/core/grappler/optimizers/constant_folding.h"
 #include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/util/device_name_utils.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -164,15 +171,418 @@ void AddBatchNormNodes(GraphDef* optimized_graph, const NodeDef& fused_node) {
   *r->add_input() = c->name();
 }
 
+namespace {
+
+// Limits of the SYCL _FusedElementwise kernel.
+constexpr int kMaxFusedElementwiseOps = 8;
+constexpr int kMaxFusedElementwiseArgs = 4;
+
+bool IsOnSYCL(const NodeDef& node) {
+  DeviceNameUtils::ParsedName parsed_name;
+  return DeviceNameUtils::ParseFullName(node.device(), &parsed_name) &&
+         parsed_name.has_type && parsed_name.type == DEVICE_SYCL;
+}
+
+bool IsFusibleUnaryOp(const NodeDef& node) {
+  static const std::unordered_set<string>* ops = new std::unordered_set<string>{
+      "Relu", "Relu6", "Elu", "Sigmoid", "Tanh", "Square", "Neg"};
+  return ops->count(node.op()) > 0;
+}
+
+bool IsFusibleBinaryOp(const NodeDef& node) {
+  static const std::unordered_set<string>* ops = new std::unordered_set<string>{
+      "BiasAdd", "Add", "Sub", "Mul", "Maximum", "Minimum"};
+  return ops->count(node.op()) > 0;
+}
+
+bool GetFullyDefinedShape(const OpInfo::TensorProperties& prop,
+                          TensorShape* shape) {
+  if (prop.shape().unknown_rank()) {
+    return false;
+  }
+  for (const auto& dim : prop.shape().dim()) {
+    if (dim.size() < 0) {
+      return false;
+    }
+  }
+  *shape = TensorShape(prop.shape());
+  return true;
+}
+
+// Returns true if a tensor of shape arg can be used as the second operand of a
+// fused binary op producing a tensor of shape out.
+bool IsFusibleArgShape(const TensorShape& arg, const TensorShape& out) {
+  return arg == out || arg.num_elements() == 1 ||
+         (arg.dims() == 1 && out.dims() > 0 &&
+          arg.dim_size(0) == out.dim_size(out.dims() - 1));
+}
+
+// Returns the index of the input of node carrying the value flowing through a
+// chain of fused element-wise ops, or -1 if the node cannot be fused.
+int FusibleChainInput(const NodeDef& node, const GraphProperties& properties) {
+  const bool is_unary = IsFusibleUnaryOp(node);
+  const bool is_binary = IsFusibleBinaryOp(node);
+  if ((!is_unary && !is_binary) || !IsOnSYCL(node) ||
+      node.attr().count("T") == 0) {
+    return -1;
+  }
+  const DataType dtype = node.attr().at("T").type();
+  if (dtype != DT_FLOAT && dtype != DT_DOUBLE) {
+    return -1;
+  }
+  const auto& outputs = properties.GetOutputProperties(node.name());
+  const auto& inputs = properties.GetInputProperties(node.name());
+  TensorShape out_shape;
+  if (outputs.size() != 1 || !GetFullyDefinedShape(outputs[0], &out_shape) ||
+      inputs.size() != (is_unary ? 1 : 2)) {
+    return -1;
+  }
+  TensorShape in_shapes[2];
+  for (int i = 0; i < inputs.size(); ++i) {
+    if (!GetFullyDefinedShape(inputs[i], &in_shapes[i])) {
+      return -1;
+    }
+  }
+  if (is_unary) {
+    return in_shapes[0] == out_shape ? 0 : -1;
+  }
+  if (IsBiasAdd(node)) {
+    if (node.attr().count("data_format") &&
+        node.attr().at("data_format").s() != "NHWC") {
+      return -1;
+    }
+    return in_shapes[0] == out_shape ? 0 : -1;
+  }
+  const bool is_commutative = !IsSub(node);
+  for (int i = 0; i < (is_commutative ? 2 : 1); ++i) {
+    if (in_shapes[i] == out_shape &&
+        IsFusibleArgShape(in_shapes[1 - i], out_shape)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Returns the Conv2D producing input, the chain input of consumer, if the
+// convolution can be fused with the element-wise ops following it.
+const NodeDef* GetFusibleConv2D(
+    const string& input, const NodeDef& consumer, const GraphView& graph,
+    const std::unordered_set<string>& nodes_to_preserve) {
+  int port;
+  const string conv_name = ParseNodeName(input, &port);
+  const NodeDef* conv = graph.GetNode(conv_name);
+  if (port != 0 || conv == nullptr || !IsConv2D(*conv) ||
+      nodes_to_preserve.count(conv_name) > 0 ||
+      conv->device() != consumer.device() ||
+      conv->attr().count("T") == 0 ||
+      conv->attr().at("T").type() != consumer.attr().at("T").type() ||
+      graph.GetFanouts(*conv, true).size() != 1) {
+    return nullptr;
+  }
+  return conv;
+}
+
+// Fuses chains of element-wise ops placed on SYCL devices, such as
+// BiasAdd -> Relu -> Mul -> Add, into single _FusedElementwise nodes. When the
+// chain follows a Conv2D, the convolution is folded in as well, producing a
+// _FusedConv2D node. A node is folded into its consumer only if that consumer
+// is its sole fanout, so the intermediate results are never needed elsewhere. The fused nodes are
+// returned keyed by the name of the last node of their chain, which they
+// replace, and the names of the other nodes of the chains are added to
+// fused_nodes.
+void FuseElementwiseChains(
+    const GrapplerItem& item, const GraphProperties& properties,
+    const GraphView& graph, std::unordered_map<string, NodeDef>* fused_chains,
+    std::unordered_set<string>* fused_nodes) {
+  const std::unordered_set<string> nodes_to_preserve = item.NodesToPreserve();
+  std::unordered_map<string, int> chain_inputs;
+  for (const NodeDef& node : item.graph.node()) {
+    const int chain_input = FusibleChainInput(node, properties);
+    if (chain_input >= 0) {
+      chain_inputs[node.name()] = chain_input;
+    }
+  }
+
+  std::unordered_map<string, const NodeDef*> predecessors;
+  std::unordered_set<string> has_fused_consumer;
+  for (const NodeDef& node : item.graph.node()) {
+    auto it = chain_inputs.find(node.name());
+    if (it == chain_inputs.end()) {
+      continue;
+    }
+    int port;
+    const string pred_name = ParseNodeName(node.input(it->second), &port);
+    const NodeDef* pred = graph.GetNode(pred_name);
+    if (port != 0 || pred == nullptr || chain_inputs.count(pred_name) == 0 ||
+        nodes_to_preserve.count(pred_name) > 0 ||
+        pred->device() != node.device() ||
+        pred->attr().at("T").type() != node.attr().at("T").type() ||
+        graph.GetFanouts(*pred, true).size() != 1) {
+      continue;
+    }
+    predecessors[node.name()] = pred;
+    has_fused_consumer.insert(pred_name);
+  }
+
+  for (const NodeDef& node : item.graph.node()) {
+    if (chain_inputs.count(node.name()) == 0 ||
+        has_fused_consumer.count(node.name()) > 0) {
+      continue;
+    }
+    // Walk the chain back from its last node, within the kernel limits.
+    std::vector<const NodeDef*> chain;
+    int num_args = 0;
+    const NodeDef* current = &node;
+    while (current != nullptr) {
+      const int current_args = IsFusibleBinaryOp(*current) ? 1 : 0;
+      if (chain.size() == kMaxFusedElementwiseOps ||
+          num_args + current_args > kMaxFusedElementwiseArgs) {
+        break;
+      }
+      chain.push_back(current);
+      num_args += current_args;
+      auto it = predecessors.find(current->name());
+      current = it == predecessors.end() ? nullptr : it->second;
+    }
+    std::reverse(chain.begin(), chain.end());
+    const string& chain_head_input =
+        chain[0]->input(chain_inputs[chain[0]->name()]);
+    const NodeDef* conv = GetFusibleConv2D(chain_head_input, *chain[0], graph,
+                                           nodes_to_preserve);
+    if (conv == nullptr && chain.size() < 2) {
+      continue;
+    }
+
+    NodeDef fused;
+    fused.set_name(node.name());
+    fused.set_device(node.device());
+    std::unordered_set<string> control_inputs;
+    if (conv != nullptr) {
+      // The convolution becomes the start of the chain.
+      fused.set_op("_FusedConv2D");
+      *fused.add_input() = conv->input(0);
+      *fused.add_input() = conv->input(1);
+      for (const auto& attr : conv->attr()) {
+        (*fused.mutable_attr())[attr.first] = attr.second;
+      }
+      for (const string& input : conv->input()) {
+        if (IsControlInput(input)) {
+          control_inputs.insert(input);
+        }
+      }
+      fused_nodes->insert(conv->name());
+    } else {
+      fused.set_op("_FusedElementwise");
+      *fused.add_input() = chain_head_input;
+    }
+    auto* fused_ops = (*fused.mutable_attr())["fused_ops"].mutable_list();
+    for (const NodeDef* chain_node : chain) {
+      const int chain_input = chain_inputs[chain_node->name()];
+      if (IsFusibleBinaryOp(*chain_node)) {
+        *fused.add_input() = chain_node->input(1 - chain_input);
+      }
+      for (const string& input : chain_node->input()) {
+        if (IsControlInput(input)) {
+          control_inputs.insert(input);
+        }
+      }
+      fused_ops->add_s(chain_node->op());
+      if (chain_node != &node) {
+        fused_nodes->insert(chain_node->name());
+      }
+    }
+    for (const string& input : control_inputs) {
+      *fused.add_input() = input;
+    }
+    (*fused.mutable_attr())["T"] = node.attr().at("T");
+    (*fused.mutable_attr())["num_args"].set_i(num_args);
+    VLOG(2) << "Fusing " << chain.size() << " element-wise ops"
+            << (conv != nullptr ? " and a convolution" : "") << " into "
+            << node.name();
+    (*fused_chains)[node.name()] = std::move(fused);
+  }
+}
+
+bool IsOnCPU(const NodeDef& node) {
+  DeviceNameUtils::ParsedName parsed_name;
+  return DeviceNameUtils::ParseFullName(node.device(), &parsed_name) &&
+         parsed_name.has_type && parsed_name.type == DEVICE_CPU;
+}
+
+bool HasNHWCDataFormat(const NodeDef& node) {
+  return node.attr().count("data_format") == 0 ||
+         node.attr().at("data_format").s() == "NHWC";
+}
+
+bool HasDataType(const NodeDef& node, DataType dtype) {
+  return node.attr().count("T") > 0 && node.attr().at("T").type() == dtype;
+}
+
+// Returns the sole consumer of the first output of node, if it takes it as its
+// first input, runs on the same device with the same type, and node can be
+// folded into it.
+const NodeDef* GetSoleConsumer(
+    const NodeDef& node, const GraphView& graph,
+    const std::unordered_set<string>& nodes_to_preserve) {
+  if (nodes_to_preserve.count(node.name()) > 0) {
+    return nullptr;
+  }
+  const auto fanouts = graph.GetFanouts(node, true);
+  if (fanouts.size() != 1) {
+    return nullptr;
+  }
+  const GraphView::InputPort& fanout = *fanouts.begin();
+  if (fanout.port_id != 0 || fanout.node->device() != node.device() ||
+      !HasDataType(*fanout.node, node.attr().at("T").type())) {
+    return nullptr;
+  }
+  for (const GraphView::Edge& edge : graph.GetFanoutEdges(node, false)) {
+    if (edge.src.port_id != 0) {
+      return nullptr;
+    }
+  }
+  return fanout.node;
+}
+
+// Returns true if node is a FusedBatchNorm in inference mode whose scale,
+// offset, mean and variance have the same type as its input.
+bool IsFusibleBatchNorm(const NodeDef& node) {
+  if (node.op() != "FusedBatchNorm" && node.op() != "FusedBatchNormV2") {
+    return false;
+  }
+  if (node.attr().count("is_training") == 0 ||
+      node.attr().at("is_training").b() || !HasNHWCDataFormat(node)) {
+    return false;
+  }
+  return node.attr().count("U") == 0 ||
+         node.attr().at("U").type() == node.attr().at("T").type();
+}
+
+// Fuses Conv2D and MatMul nodes placed on CPU devices with the BiasAdd, or for
+// convolutions the inference FusedBatchNorm, following them, and with a Relu,
+// Relu6 or Elu following that, into _FusedConv2D and _FusedMatMul nodes. Their
+// kernels apply the fused ops to each block of the output right after
+// computing it. The fused nodes are returned as in FuseElementwiseChains.
+void FuseContractionsOnCPU(const GrapplerItem& item, const GraphView& graph,
+                           std::unordered_map<string, NodeDef>* fused_chains,
+                           std::unordered_set<string>* fused_nodes) {
+  const std::unordered_set<string> nodes_to_preserve = item.NodesToPreserve();
+  for (const NodeDef& node : item.graph.node()) {
+    const bool is_conv = IsConv2D(node);
+    if (!is_conv && node.op() != "MatMul") {
+      continue;
+    }
+    if (!IsOnCPU(node) || fused_nodes->count(node.name()) > 0 ||
+        fused_chains->count(node.name()) > 0 ||
+        (!HasDataType(node, DT_FLOAT) && !HasDataType(node, DT_DOUBLE)) ||
+        (is_conv && !HasNHWCDataFormat(node))) {
+      continue;
+    }
+    const NodeDef* output_op =
+        GetSoleConsumer(node, graph, nodes_to_preserve);
+    if (output_op == nullptr) {
+      continue;
+    }
+    const bool is_batch_norm = is_conv && IsFusibleBatchNorm(*output_op);
+    if (!is_batch_norm &&
+        (!IsBiasAdd(*output_op) || !HasNHWCDataFormat(*output_op))) {
+      continue;
+    }
+    const NodeDef* activation =
+        GetSoleConsumer(*output_op, graph, nodes_to_preserve);
+    if (activation != nullptr && activation->op() != "Relu" &&
+        activation->op() != "Relu6" && activation->op() != "Elu") {
+      activation = nullptr;
+    }
+    if (is_batch_norm && activation == nullptr) {
+      // The fused node only computes the first output of the batch norm.
+      bool only_first_output = nodes_to_preserve.count(output_op->name()) == 0;
+      for (const GraphView::Edge& edge :
+           graph.GetFanoutEdges(*output_op, false)) {
+        only_first_output &= edge.src.port_id == 0;
+      }
+      if (!only_first_output) {
+        continue;
+      }
+    }
+    const NodeDef* last = activation != nullptr ? activation : output_op;
+    if (fused_nodes->count(last->name()) > 0 ||
+        fused_chains->count(last->name()) > 0) {
+      continue;
+    }
+
+    NodeDef fused;
+    fused.set_name(last->name());
+    fused.set_device(node.device());
+    fused.set_op(is_conv ? "_FusedConv2D" : "_FusedMatMul");
+    *fused.add_input() = node.input(0);
+    *fused.add_input() = node.input(1);
+    for (const auto& attr : node.attr()) {
+      (*fused.mutable_attr())[attr.first] = attr.second;
+    }
+    const int num_args = is_batch_norm ? 4 : 1;
+    for (int i = 1; i <= num_args; ++i) {
+      *fused.add_input() = output_op->input(i);
+    }
+    std::vector<const NodeDef*> fused_ops = {&node, output_op};
+    if (activation != nullptr) {
+      fused_ops.push_back(activation);
+    }
+    std::unordered_set<string> control_inputs;
+    for (const NodeDef* fused_op : fused_ops) {
+      for (const string& input : fused_op->input()) {
+        if (IsControlInput(input) && control_inputs.insert(input).second) {
+          *fused.add_input() = input;
+        }
+      }
+    }
+
+    auto* ops = (*fused.mutable_attr())["fused_ops"].mutable_list();
+    ops->add_s(is_batch_norm ? "FusedBatchNorm" : "BiasAdd");
+    if (activation != nullptr) {
+      ops->add_s(activation->op());
+    }
+    (*fused.mutable_attr())["num_args"].set_i(num_args);
+    float epsilon = 0.0001f;
+    if (is_batch_norm && output_op->attr().count("epsilon") > 0) {
+      epsilon = output_op->attr().at("epsilon").f();
+    }
+    (*fused.mutable_attr())["epsilon"].set_f(epsilon);
+
+    VLOG(2) << "Fusing " << node.name() << " with " << ops->s_size()
+            << " output ops into " << fused.name();
+    fused_nodes->insert(node.name());
+    if (activation != nullptr) {
+      fused_nodes->insert(output_op->name());
+    }
+    (*fused_chains)[fused.name()] = std::move(fused);
+  }
+}
+
+}  // namespace
+
 Status Remapper::Optimize(Cluster* /*cluster*/, const GrapplerItem& item,
                           GraphDef* optimized_graph) {
   GraphProperties properties(item);
   TF_RETURN_IF_ERROR(properties.InferStatically(false));
   GraphView graph(const_cast<GraphDef*>(&item.graph));
 
+  std::unordered_map<string, NodeDef> fused_chains;
+  std::unordered_set<string> fused_nodes;
+  FuseElementwiseChains(item, properties, graph, &fused_chains, &fused_nodes);
+  FuseContractionsOnCPU(item, graph, &fused_chains, &fused_nodes);
+
   // During inference, most of the inputs to FusedBatchNorm are constant, and we
   // can therefore replace the op with a much cheaper set of primitives.
   for (const NodeDef& node : item.graph.node()) {
+    if (fused_nodes.count(node.name()) > 0) {
+      continue;
+    }
+    auto fused_chain = fused_chains.find(node.name());
+    if (fused_chain != fused_chains.end()) {
+      *optimized_graph->add_node() = fused_chain->second;
+      continue;
+    }
     if (node.op() == "FusedBatchNorm" || node.op() == "FusedBatchNormV2") {
       bool optimizable = (node.attr().count("T") == 0 ||
                           node.attr().at("T").type() == DT_FLOAT);
@@ -97,5 +97,355 @@ TEST_F(RemapperTest, FusedBatchNormNCHW) {
   }
 }
 
+TEST_F(RemapperTest, FuseElementwiseChainOnSYCL) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:SYCL:0");
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({2, 3}));
+  Output y = ops::Placeholder(s.WithOpName("y"), DT_FLOAT,
+                              ops::Placeholder::Shape({2, 3}));
+  Output bias = ops::Const(s.WithOpName("bias"), {0.5f, -1.0f, 2.0f}, {3});
+  Output scale = ops::Const(s.WithOpName("scale"), 3.0f, {});
+  Output bias_add = ops::BiasAdd(s.WithOpName("bias_add"), x, bias);
+  Output relu = ops::Relu(s.WithOpName("relu"), bias_add);
+  Output mul = ops::Mul(s.WithOpName("mul"), scale, relu);
+  Output add = ops::Add(s.WithOpName("add"), mul, y);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"add"};
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_EQ(item.graph.node_size() - 3, output.node_size());
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE("bias_add", node.name());
+    EXPECT_NE("relu", node.name());
+    EXPECT_NE("mul", node.name());
+    if (node.name() == "add") {
+      EXPECT_EQ("_FusedElementwise", node.op());
+      ASSERT_EQ(4, node.input_size());
+      EXPECT_EQ("x", node.input(0));
+      EXPECT_EQ("bias", node.input(1));
+      EXPECT_EQ("scale", node.input(2));
+      EXPECT_EQ("y", node.input(3));
+      EXPECT_EQ(3, node.attr().at("num_args").i());
+      const auto& fused_ops = node.attr().at("fused_ops").list();
+      ASSERT_EQ(4, fused_ops.s_size());
+      EXPECT_EQ("BiasAdd", fused_ops.s(0));
+      EXPECT_EQ("Relu", fused_ops.s(1));
+      EXPECT_EQ("Mul", fused_ops.s(2));
+      EXPECT_EQ("Add", fused_ops.s(3));
+      found++;
+    }
+  }
+  EXPECT_EQ(1, found);
+
+#ifdef TENSORFLOW_USE_SYCL
+  auto x_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({2, 3}));
+  auto y_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({2, 3}));
+  std::vector<std::pair<string, Tensor>> feed = {{"x", x_t}, {"y", y_t}};
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, feed);
+  EXPECT_EQ(1, tensors_expected.size());
+  auto tensors = EvaluateNodes(output, item.fetch, feed);
+  EXPECT_EQ(1, tensors.size());
+  test::ExpectTensorNear<float>(tensors_expected[0], tensors[0], 1e-6);
+#endif  // TENSORFLOW_USE_SYCL
+}
+
+TEST_F(RemapperTest, FuseConv2DWithBiasAndReluOnSYCL) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:SYCL:0");
+  Output input = ops::Placeholder(s.WithOpName("input"), DT_FLOAT,
+                                  ops::Placeholder::Shape({1, 5, 5, 2}));
+  Output filter = ops::Placeholder(s.WithOpName("filter"), DT_FLOAT,
+                                   ops::Placeholder::Shape({3, 3, 2, 4}));
+  Output bias = ops::Placeholder(s.WithOpName("bias"), DT_FLOAT,
+                                 ops::Placeholder::Shape({4}));
+  Output conv =
+      ops::Conv2D(s.WithOpName("conv"), input, filter, {1, 1, 1, 1}, "SAME");
+  Output bias_add = ops::BiasAdd(s.WithOpName("bias_add"), conv, bias);
+  Output relu = ops::Relu(s.WithOpName("relu"), bias_add);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"relu"};
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_EQ(item.graph.node_size() - 2, output.node_size());
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE("conv", node.name());
+    EXPECT_NE("bias_add", node.name());
+    if (node.name() == "relu") {
+      EXPECT_EQ("_FusedConv2D", node.op());
+      ASSERT_EQ(3, node.input_size());
+      EXPECT_EQ("input", node.input(0));
+      EXPECT_EQ("filter", node.input(1));
+      EXPECT_EQ("bias", node.input(2));
+      EXPECT_EQ(1, node.attr().at("num_args").i());
+      EXPECT_EQ("SAME", node.attr().at("padding").s());
+      const auto& fused_ops = node.attr().at("fused_ops").list();
+      ASSERT_EQ(2, fused_ops.s_size());
+      EXPECT_EQ("BiasAdd", fused_ops.s(0));
+      EXPECT_EQ("Relu", fused_ops.s(1));
+      found++;
+    }
+  }
+  EXPECT_EQ(1, found);
+
+#ifdef TENSORFLOW_USE_SYCL
+  auto input_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({1, 5, 5, 2}));
+  auto filter_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({3, 3, 2, 4}));
+  auto bias_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({4}));
+  std::vector<std::pair<string, Tensor>> feed = {
+      {"input", input_t}, {"filter", filter_t}, {"bias", bias_t}};
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, feed);
+  EXPECT_EQ(1, tensors_expected.size());
+  auto tensors = EvaluateNodes(output, item.fetch, feed);
+  EXPECT_EQ(1, tensors.size());
+  test::ExpectTensorNear<float>(tensors_expected[0], tensors[0], 1e-5);
+#endif  // TENSORFLOW_USE_SYCL
+}
+
+TEST_F(RemapperTest, DontFuseElementwiseChainWithSharedResult) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:SYCL:0");
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({2, 3}));
+  Output relu = ops::Relu(s.WithOpName("relu"), x);
+  Output tanh = ops::Tanh(s.WithOpName("tanh"), relu);
+  Output sigmoid = ops::Sigmoid(s.WithOpName("sigmoid"), relu);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"tanh", "sigmoid"};
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_EQ(item.graph.node_size(), output.node_size());
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE("_FusedElementwise", node.op());
+  }
+}
+
+TEST_F(RemapperTest, DontFuseElementwiseChainOnCPU) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:CPU:0");
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({2, 3}));
+  Output relu = ops::Relu(s.WithOpName("relu"), x);
+  Output tanh = ops::Tanh(s.WithOpName("tanh"), relu);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"tanh"};
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_EQ(item.graph.node_size(), output.node_size());
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE("_FusedElementwise", node.op());
+  }
+}
+
+TEST_F(RemapperTest, FuseConv2DWithBiasAndReluOnCPU) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:CPU:0");
+  Output input = ops::Placeholder(s.WithOpName("input"), DT_FLOAT,
+                                  ops::Placeholder::Shape({2, 5, 5, 2}));
+  Output filter = ops::Placeholder(s.WithOpName("filter"), DT_FLOAT,
+                                   ops::Placeholder::Shape({3, 3, 2, 4}));
+  Output bias = ops::Placeholder(s.WithOpName("bias"), DT_FLOAT,
+                                 ops::Placeholder::Shape({4}));
+  Output conv =
+      ops::Conv2D(s.WithOpName("conv"), input, filter, {1, 1, 1, 1}, "SAME");
+  Output bias_add = ops::BiasAdd(s.WithOpName("bias_add"), conv, bias);
+  Output relu = ops::Relu(s.WithOpName("relu"), bias_add);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"relu"};
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_EQ(item.graph.node_size() - 2, output.node_size());
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE("conv", node.name());
+    EXPECT_NE("bias_add", node.name());
+    if (node.name() == "relu") {
+      EXPECT_EQ("_FusedConv2D", node.op());
+      ASSERT_EQ(3, node.input_size());
+      EXPECT_EQ("input", node.input(0));
+      EXPECT_EQ("filter", node.input(1));
+      EXPECT_EQ("bias", node.input(2));
+      EXPECT_EQ(1, node.attr().at("num_args").i());
+      const auto& fused_ops = node.attr().at("fused_ops").list();
+      ASSERT_EQ(2, fused_ops.s_size());
+      EXPECT_EQ("BiasAdd", fused_ops.s(0));
+      EXPECT_EQ("Relu", fused_ops.s(1));
+      found++;
+    }
+  }
+  EXPECT_EQ(1, found);
+
+  auto input_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({2, 5, 5, 2}));
+  auto filter_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({3, 3, 2, 4}));
+  auto bias_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({4}));
+  std::vector<std::pair<string, Tensor>> feed = {
+      {"input", input_t}, {"filter", filter_t}, {"bias", bias_t}};
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, feed);
+  EXPECT_EQ(1, tensors_expected.size());
+  auto tensors = EvaluateNodes(output, item.fetch, feed);
+  EXPECT_EQ(1, tensors.size());
+  test::ExpectTensorNear<float>(tensors_expected[0], tensors[0], 1e-5);
+}
+
+TEST_F(RemapperTest, FuseConv2DWithBatchNormOnCPU) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:CPU:0");
+  Output input = ops::Placeholder(s.WithOpName("input"), DT_FLOAT,
+                                  ops::Placeholder::Shape({2, 5, 5, 2}));
+  Output filter = ops::Placeholder(s.WithOpName("filter"), DT_FLOAT,
+                                   ops::Placeholder::Shape({1, 1, 2, 3}));
+  Output scale = ops::Const(s.WithOpName("scale"), {0.3f, 1.5f, 2.0f}, {3});
+  Output offset = ops::Const(s.WithOpName("offset"), {0.1f, -0.2f, 0.f}, {3});
+  Output mean = ops::Const(s.WithOpName("mean"), {0.5f, 1.0f, -1.0f}, {3});
+  Output variance =
+      ops::Const(s.WithOpName("variance"), {0.57f, 1.0f, 2.0f}, {3});
+  Output conv =
+      ops::Conv2D(s.WithOpName("conv"), input, filter, {1, 1, 1, 1}, "SAME");
+  ops::FusedBatchNorm bn(s.WithOpName("batch_norm"), conv, scale, offset, mean,
+                         variance, ops::FusedBatchNorm::IsTraining(false));
+  Output relu6 = ops::Relu6(s.WithOpName("relu6"), bn.y);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"relu6"};
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE("conv", node.name());
+    EXPECT_NE("batch_norm", node.name());
+    if (node.name() == "relu6") {
+      EXPECT_EQ("_FusedConv2D", node.op());
+      ASSERT_EQ(6, node.input_size());
+      EXPECT_EQ("scale", node.input(2));
+      EXPECT_EQ("variance", node.input(5));
+      EXPECT_EQ(4, node.attr().at("num_args").i());
+      const auto& fused_ops = node.attr().at("fused_ops").list();
+      ASSERT_EQ(2, fused_ops.s_size());
+      EXPECT_EQ("FusedBatchNorm", fused_ops.s(0));
+      EXPECT_EQ("Relu6", fused_ops.s(1));
+      found++;
+    }
+  }
+  EXPECT_EQ(1, found);
+
+  auto input_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({2, 5, 5, 2}));
+  auto filter_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({1, 1, 2, 3}));
+  std::vector<std::pair<string, Tensor>> feed = {{"input", input_t},
+                                                 {"filter", filter_t}};
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, feed);
+  EXPECT_EQ(1, tensors_expected.size());
+  auto tensors = EvaluateNodes(output, item.fetch, feed);
+  EXPECT_EQ(1, tensors.size());
+  test::ExpectTensorNear<float>(tensors_expected[0], tensors[0], 1e-5);
+}
+
+TEST_F(RemapperTest, FuseMatMulWithBiasOnCPU) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:CPU:0");
+  Output a = ops::Placeholder(s.WithOpName("a"), DT_FLOAT,
+                              ops::Placeholder::Shape({8, 16}));
+  Output b = ops::Placeholder(s.WithOpName("b"), DT_FLOAT,
+                              ops::Placeholder::Shape({16, 4}));
+  Output bias = ops::Placeholder(s.WithOpName("bias"), DT_FLOAT,
+                                 ops::Placeholder::Shape({4}));
+  Output matmul = ops::MatMul(s.WithOpName("matmul"), a, b);
+  Output bias_add = ops::BiasAdd(s.WithOpName("bias_add"), matmul, bias);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"bias_add"};
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_EQ(item.graph.node_size() - 1, output.node_size());
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE("matmul", node.name());
+    if (node.name() == "bias_add") {
+      EXPECT_EQ("_FusedMatMul", node.op());
+      ASSERT_EQ(3, node.input_size());
+      EXPECT_EQ("bias", node.input(2));
+      EXPECT_FALSE(node.attr().at("transpose_a").b());
+      const auto& fused_ops = node.attr().at("fused_ops").list();
+      ASSERT_EQ(1, fused_ops.s_size());
+      EXPECT_EQ("BiasAdd", fused_ops.s(0));
+      found++;
+    }
+  }
+  EXPECT_EQ(1, found);
+
+  auto a_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({8, 16}));
+  auto b_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({16, 4}));
+  auto bias_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({4}));
+  std::vector<std::pair<string, Tensor>> feed = {
+      {"a", a_t}, {"b", b_t}, {"bias", bias_t}};
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, feed);
+  EXPECT_EQ(1, tensors_expected.size());
+  auto tensors = EvaluateNodes(output, item.fetch, feed);
+  EXPECT_EQ(1, tensors.size());
+  test::ExpectTensorNear<float>(tensors_expected[0], tensors[0], 1e-5);
+}
+
+TEST_F(RemapperTest, DontFuseConv2DWithSharedOutputOnCPU) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:CPU:0");
+  Output input = ops::Placeholder(s.WithOpName("input"), DT_FLOAT,
+                                  ops::Placeholder::Shape({1, 5, 5, 2}));
+  Output filter = ops::Placeholder(s.WithOpName("filter"), DT_FLOAT,
+                                   ops::Placeholder::Shape({3, 3, 2, 4}));
+  Output bias = ops::Placeholder(s.WithOpName("bias"), DT_FLOAT,
+                                 ops::Placeholder::Shape({4}));
+  Output conv =
+      ops::Conv2D(s.WithOpName("conv"), input, filter, {1, 1, 1, 1}, "SAME");
+  Output bias_add = ops::BiasAdd(s.WithOpName("bias_add"), conv, bias);
+  Output relu = ops::Relu(s.WithOpName("relu"), conv);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"bias_add", "relu"};
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_EQ(item.graph.node_size(), output.node_size());
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE("_FusedConv2D", node.op());
+  }
+}
+
 }  // namespace grappler
 }  // namespace tensorflow
@@ -649,8 +649,14 @@ class UnaryElementwiseRewriter : public ScopedAllocatorOptimizer::Rewriter {
   }
 };
 
+// Default upper bound on the size of the backing buffer of a
+// ScopedAllocator.
+constexpr int64 kDefaultMaxFusedBytes = 64 << 20;
+
 ScopedAllocatorOptimizer::ScopedAllocatorOptimizer(
-    const ScopedAllocatorOptions& opts) {
+    const ScopedAllocatorOptions& opts)
+    : max_fused_bytes_(opts.max_fused_bytes() == 0 ? kDefaultMaxFusedBytes
+                                                   : opts.max_fused_bytes()) {
   VLOG(1) << "ScopedAllocatorOptimizer::ScopedAllocatorOptimizer";
   Rewriter* r = new UnaryElementwiseRewriter();
   to_delete_.push_back(r);
@@ -841,7 +847,8 @@ Status ScopedAllocatorOptimizer::ProcessGraphDef(
         // in the same Tree struct.  Split those groups into subgroups that
         // share identical loop nesting.
         status = ApplyToAll(
-            root.get(), [this, rewriter, graph, &frame_map, &op_name](Tree* t) {
+            root.get(), [this, rewriter, graph, &graph_properties, &frame_map,
+                         &op_name](Tree* t) {
               VLOG(2) << "applied to tree node " << t->edge_ << " at depth "
                       << t->depth_ << " of size " << t->nodes_.size();
               if (t->nodes_.size() > 1) {
@@ -849,12 +856,17 @@ Status ScopedAllocatorOptimizer::ProcessGraphDef(
                 PartitionByLoopStructure(frame_map, t->nodes_, &loop_groups);
                 for (auto& lg : loop_groups) {
                   if (lg.size() > 1) {
-                    bool applied = false;
                     Status s = OrderNodeSet(&lg);
                     TF_RETURN_IF_ERROR(s);
-                    VLOG(1) << "Applying Rewriter for " << op_name;
-                    s = rewriter->Rewrite(this, graph, op_name, lg, &applied);
-                    LOG_WARNING_AND_RETURN_IF_ERROR(s);
+                    std::vector<std::vector<NodeDef*>> fused_groups;
+                    PartitionByFusedBytes(graph_properties, lg, &fused_groups);
+                    for (const auto& fg : fused_groups) {
+                      if (fg.size() <= 1) continue;
+                      bool applied = false;
+                      VLOG(1) << "Applying Rewriter for " << op_name;
+                      s = rewriter->Rewrite(this, graph, op_name, fg, &applied);
+                      LOG_WARNING_AND_RETURN_IF_ERROR(s);
+                    }
                   }
                 }
               }
@@ -923,6 +935,34 @@ Status ScopedAllocatorOptimizer::OrderNodeSet(
   return Status::OK();
 }
 
+void ScopedAllocatorOptimizer::PartitionByFusedBytes(
+    const GraphProperties& graph_properties,
+    const std::vector<NodeDef*>& nodes,
+    std::vector<std::vector<NodeDef*>>* groups) const {
+  if (max_fused_bytes_ < 0) {
+    groups->push_back(nodes);
+    return;
+  }
+  int64 group_bytes = 0;
+  for (NodeDef* n : nodes) {
+    // Nodes without a known output size are left to the Rewriter to reject.
+    int64 bytes = 0;
+    if (graph_properties.HasOutputProperties(n->name())) {
+      const auto& prop_list = graph_properties.GetOutputProperties(n->name());
+      if (prop_list.size() == 1 && TensorShape::IsValid(prop_list[0].shape())) {
+        bytes = TensorShape(prop_list[0].shape()).num_elements() *
+                DataTypeSize(prop_list[0].dtype());
+      }
+    }
+    if (groups->empty() || group_bytes + bytes > max_fused_bytes_) {
+      groups->emplace_back();
+      group_bytes = 0;
+    }
+    groups->back().push_back(n);
+    group_bytes += bytes;
+  }
+}
+
 }  // namespace grappler
 }  // namespace tensorflow
 
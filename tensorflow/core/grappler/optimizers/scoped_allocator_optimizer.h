@@ -93,11 +93,19 @@ class ScopedAllocatorOptimizer : public GraphOptimizer {
 
   Status OrderNodeSet(std::vector<NodeDef*>* nodes) const;
 
+  // Splits the ordered nodes into consecutive groups whose outputs add up
+  // to at most max_fused_bytes_, except for single nodes that are larger.
+  void PartitionByFusedBytes(
+      const GraphProperties& graph_properties,
+      const std::vector<NodeDef*>& nodes,
+      std::vector<std::vector<NodeDef*>>* groups) const;
+
   RewriterConfig::Toggle opt_level_;
   std::unordered_set<string> nodes_to_preserve_;
   OpNameSet op_name_set_;
   std::unordered_map<string, Rewriter*> rewriters_;
   std::vector<Rewriter*> to_delete_;
+  int64 max_fused_bytes_;
   int next_sa_id_ = 1;
   std::unique_ptr<NodeMap> node_map_;
 };
@@ -162,6 +162,27 @@ TEST_F(ScopedAllocatorOptimizerTest, UnaryRewriteOnly) {
   }
 }
 
+TEST_F(ScopedAllocatorOptimizerTest, MaxFusedBytes) {
+  // Tests that the parallel Ops are only rewritten when their outputs, 16
+  // bytes each, fit in a single backing buffer.
+  for (int64 max_fused_bytes : {16, 32}) {
+    GrapplerItem item;
+    BuildAbsGraph(&item.graph);
+    SetShapes(&item.graph);
+
+    ScopedAllocatorOptions opts;
+    opts.add_enable_op("Abs");
+    opts.set_max_fused_bytes(max_fused_bytes);
+    ScopedAllocatorOptimizer sao(opts);
+
+    GraphDef optimized_graph;
+    TF_ASSERT_OK(sao.Optimize(nullptr /*cluster*/, item, &optimized_graph));
+    NodeMap node_map(&optimized_graph);
+    EXPECT_EQ(max_fused_bytes >= 32,
+              node_map.GetNode("scoped_allocator_1") != nullptr);
+  }
+}
+
 TEST_F(ScopedAllocatorOptimizerTest, UnaryExecute) {
   // Constructs the same graph as UnaryRewriteOnly, but actually executes it.
   GrapplerItem item;
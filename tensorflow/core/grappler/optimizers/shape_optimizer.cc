@@ -15,6 +15,13 @@ limitations under the License.
 
 #include "tensorflow/core/grappler/optimizers/shape_optimizer.h"
 
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+
+#include "tensorflow/core/framework/attr_value_util.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/grappler/graph_view.h"
@@ -23,10 +30,287 @@ limitations under the License.
 
 #include "tensorflow/core/grappler/op_types.h"
 #include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/grappler/utils/topological_sort.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/util/device_name_utils.h"
 
 namespace tensorflow {
 namespace grappler {
+namespace {
+
+// Replaces the shape fed to a Reshape, when it is computed by a chain of ops
+// such as Pack(StridedSlice(Shape(x)), ...), by a constant if all but one of
+// the output dimensions are known. The Reshape computes the remaining one
+// from a -1.
+Status SimplifyReshapes(const GraphProperties& properties, GraphDef* graph) {
+  NodeMap node_map(graph);
+  const int num_nodes = graph->node_size();
+  for (int i = 0; i < num_nodes; ++i) {
+    NodeDef* node = graph->mutable_node(i);
+    if (!IsReshape(*node) || node->input_size() < 2 ||
+        IsControlInput(node->input(1))) {
+      continue;
+    }
+    const NodeDef* shape = node_map.GetNode(node->input(1));
+    const NodeDef* input = node_map.GetNode(node->input(0));
+    // The constant is anchored to the frame of the input, which can't be a
+    // Switch.
+    if (shape == nullptr || IsConstant(*shape) || input == nullptr ||
+        IsSwitch(*input) || !properties.HasOutputProperties(node->name())) {
+      continue;
+    }
+    const TensorShapeProto& output_shape =
+        properties.GetOutputProperties(node->name())[0].shape();
+    if (output_shape.unknown_rank()) {
+      continue;
+    }
+    int unknown_dim = -1;
+    bool simplify = true;
+    for (int d = 0; d < output_shape.dim_size(); ++d) {
+      const TensorShapeProto::Dim& dim = output_shape.dim(d);
+      // A -1 can't be inferred for empty tensors.
+      if (dim.size() == 0 || (!IsKnown(dim) && unknown_dim >= 0)) {
+        simplify = false;
+        break;
+      }
+      if (!IsKnown(dim)) {
+        unknown_dim = d;
+      }
+    }
+    const string const_name = AddPrefixToNodeName(
+        strings::StrCat(node->name(), "-shape"), "ShapeOptimizer");
+    if (!simplify || node_map.GetNode(const_name) != nullptr) {
+      continue;
+    }
+
+    const DataType dtype = node->attr().count("Tshape") > 0
+                               ? node->attr().at("Tshape").type()
+                               : DT_INT32;
+    Tensor value(dtype, TensorShape({output_shape.dim_size()}));
+    for (int d = 0; d < output_shape.dim_size(); ++d) {
+      const int64 size = d == unknown_dim ? -1 : output_shape.dim(d).size();
+      if (dtype == DT_INT32) {
+        value.vec<int32>()(d) = size;
+      } else {
+        value.vec<int64>()(d) = size;
+      }
+    }
+    NodeDef* new_shape = graph->add_node();
+    new_shape->set_name(const_name);
+    new_shape->set_op("Const");
+    new_shape->set_device(node->device());
+    new_shape->add_input(AsControlDependency(input->name()));
+    (*new_shape->mutable_attr())["dtype"].set_type(dtype);
+    value.AsProtoTensorContent(
+        (*new_shape->mutable_attr())["value"].mutable_tensor());
+    node_map.AddNode(const_name, new_shape);
+    node_map.UpdateInput(node->name(), node->input(1), const_name);
+    node->set_input(1, const_name);
+  }
+  return Status::OK();
+}
+
+// Ops computing shapes, which graphs using tf.shape() based reshapes tend to
+// duplicate for every layer.
+bool IsShapeComputation(const NodeDef& node) {
+  return IsShape(node) || IsShapeN(node) || IsSize(node) || IsRank(node) ||
+         IsStridedSlice(node) || IsSlice(node) || IsPack(node);
+}
+
+string ShapeComputationKey(const NodeDef& node) {
+  string key = strings::StrCat(node.op(), "|", node.device());
+  std::vector<string> control_inputs;
+  for (const string& input : node.input()) {
+    if (IsControlInput(input)) {
+      control_inputs.push_back(input);
+    } else {
+      strings::StrAppend(&key, "|", input);
+    }
+  }
+  std::sort(control_inputs.begin(), control_inputs.end());
+  for (const string& input : control_inputs) {
+    strings::StrAppend(&key, "|", input);
+  }
+  const std::map<string, AttrValue> attrs(node.attr().begin(),
+                                          node.attr().end());
+  for (const auto& attr : attrs) {
+    strings::StrAppend(&key, "|", attr.first, "=",
+                       SummarizeAttrValue(attr.second));
+  }
+  return key;
+}
+
+// Removes duplicate shape computations, so that a single Shape and
+// StridedSlice feed all the consumers of the same dimension.
+Status DedupShapeComputations(
+    const std::unordered_set<string>& nodes_to_preserve, GraphDef* graph) {
+  std::unordered_map<const NodeDef*, int> topo_order;
+  TF_RETURN_IF_ERROR(ComputeTopologicalOrder(*graph, &topo_order, nullptr));
+  std::vector<int> order(graph->node_size());
+  for (int i = 0; i < graph->node_size(); ++i) {
+    order[topo_order.at(&graph->node(i))] = i;
+  }
+
+  // Duplicates and the node replacing them.
+  std::unordered_map<string, string> replacements;
+  std::unordered_map<string, string> computations;
+  for (int index : order) {
+    NodeDef* node = graph->mutable_node(index);
+    // Visiting the nodes in topological order, the inputs of duplicates have
+    // already been deduplicated.
+    for (int i = 0; i < node->input_size(); ++i) {
+      int port;
+      const string name = ParseNodeName(node->input(i), &port);
+      auto it = replacements.find(name);
+      if (it == replacements.end()) {
+        continue;
+      }
+      if (port < 0) {
+        node->set_input(i, AsControlDependency(it->second));
+      } else if (port == 0) {
+        node->set_input(i, it->second);
+      } else {
+        node->set_input(i, strings::StrCat(it->second, ":", port));
+      }
+    }
+    if (!IsShapeComputation(*node) ||
+        nodes_to_preserve.count(node->name()) > 0) {
+      continue;
+    }
+    auto inserted =
+        computations.emplace(ShapeComputationKey(*node), node->name());
+    if (!inserted.second) {
+      replacements[node->name()] = inserted.first->second;
+    }
+  }
+  if (replacements.empty()) {
+    return Status::OK();
+  }
+
+  int num_kept = 0;
+  for (int i = 0; i < graph->node_size(); ++i) {
+    if (replacements.count(graph->node(i).name()) == 0) {
+      graph->mutable_node()->SwapElements(num_kept++, i);
+    }
+  }
+  graph->mutable_node()->DeleteSubrange(num_kept,
+                                        graph->node_size() - num_kept);
+  VLOG(2) << "Removed " << replacements.size()
+          << " duplicate shape computations";
+  return Status::OK();
+}
+
+bool IsIntegerType(const NodeDef& node, const string& type_attr) {
+  auto it = node.attr().find(type_attr);
+  return it != node.attr().end() &&
+         (it->second.type() == DT_INT32 || it->second.type() == DT_INT64);
+}
+
+// Integer ops computing shapes from the outputs of Shape, Size and Rank.
+bool IsShapeArithmetic(const NodeDef& node) {
+  return (IsStridedSlice(node) || IsSlice(node) || IsPack(node) ||
+          IsConcat(node) || IsProd(node) || IsAdd(node) || IsSub(node) ||
+          IsMul(node) || IsFloorDiv(node) || IsMaximum(node) ||
+          IsMinimum(node)) &&
+         IsIntegerType(node, "T");
+}
+
+// Returns the CPU of the task of an accelerator, or an empty string if the
+// device isn't a GPU or a SYCL device.
+string HostDevice(const string& device) {
+  DeviceNameUtils::ParsedName parsed_name;
+  if (!DeviceNameUtils::ParseFullName(device, &parsed_name) ||
+      (parsed_name.type != DEVICE_GPU && parsed_name.type != "SYCL")) {
+    return "";
+  }
+  parsed_name.type = DEVICE_CPU;
+  parsed_name.has_id = true;
+  parsed_name.id = 0;
+  return DeviceNameUtils::ParsedNameToString(parsed_name);
+}
+
+// Shape, Size and Rank produce their outputs in host memory on GPU and SYCL
+// devices. Moves the integer ops consuming them, and the constants these
+// read, to the host so that computing shapes never waits for the device nor
+// copies values back and forth.
+Status PinShapeComputationsToHost(GraphDef* graph) {
+  std::unordered_map<const NodeDef*, int> topo_order;
+  TF_RETURN_IF_ERROR(ComputeTopologicalOrder(*graph, &topo_order, nullptr));
+  std::vector<int> order(graph->node_size());
+  for (int i = 0; i < graph->node_size(); ++i) {
+    order[topo_order.at(&graph->node(i))] = i;
+  }
+  NodeMap node_map(graph);
+
+  std::unordered_set<string> host_values;
+  std::unordered_set<string> pinned;
+  for (int index : order) {
+    NodeDef* node = graph->mutable_node(index);
+    if (IsShape(*node) || IsShapeN(*node) || IsSize(*node) || IsRank(*node)) {
+      host_values.insert(node->name());
+      continue;
+    }
+    if (!IsShapeArithmetic(*node)) {
+      continue;
+    }
+    bool reads_host_values = true;
+    for (const string& input : node->input()) {
+      if (IsControlInput(input)) {
+        continue;
+      }
+      const NodeDef* input_node = node_map.GetNode(input);
+      if (input_node == nullptr ||
+          (host_values.count(input_node->name()) == 0 &&
+           !(IsConstant(*input_node) &&
+             IsIntegerType(*input_node, "dtype")))) {
+        reads_host_values = false;
+        break;
+      }
+    }
+    if (!reads_host_values) {
+      continue;
+    }
+    host_values.insert(node->name());
+    const string host_device = HostDevice(node->device());
+    if (host_device.empty()) {
+      continue;
+    }
+    NodeDef host_node = *node;
+    host_node.set_device(host_device);
+    if (!FindKernelDef(DeviceType(DEVICE_CPU), host_node, nullptr, nullptr)
+             .ok()) {
+      continue;
+    }
+    node->set_device(host_device);
+    pinned.insert(node->name());
+  }
+
+  // Move the constants only read by pinned ops as well.
+  for (NodeDef& node : *graph->mutable_node()) {
+    if (!IsConstant(node) || !IsIntegerType(node, "dtype")) {
+      continue;
+    }
+    const string host_device = HostDevice(node.device());
+    const std::set<NodeDef*>& consumers = node_map.GetOutputs(node.name());
+    if (host_device.empty() || consumers.empty()) {
+      continue;
+    }
+    bool only_read_on_host = true;
+    for (const NodeDef* consumer : consumers) {
+      if (pinned.count(consumer->name()) == 0) {
+        only_read_on_host = false;
+        break;
+      }
+    }
+    if (only_read_on_host) {
+      node.set_device(host_device);
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace
 
 Status ShapeOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
                                 GraphDef* optimized_graph) {
@@ -119,6 +403,11 @@ Status ShapeOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
       }
     }
   }
+
+  TF_RETURN_IF_ERROR(SimplifyReshapes(properties, optimized_graph));
+  TF_RETURN_IF_ERROR(
+      DedupShapeComputations(item.NodesToPreserve(), optimized_graph));
+  TF_RETURN_IF_ERROR(PinShapeComputationsToHost(optimized_graph));
   return Status::OK();
 }
 
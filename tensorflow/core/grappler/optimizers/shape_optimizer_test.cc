@@ -18,6 +18,7 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/utils.h"
 #include "tensorflow/core/grappler/utils/grappler_test.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/test.h"
@@ -100,6 +101,117 @@ TEST_F(ShapeOptimizerTest, OptimizeShapeRatio) {
               tensors_actual[0].scalar<int>()(), 0);
 }
 
+TEST_F(ShapeOptimizerTest, SimplifyReshapeOfUnknownBatch) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({-1, 4, 5}));
+  Output shape = ops::Shape(s.WithOpName("shape"), x);
+  Output batch = ops::StridedSlice(
+      s.WithOpName("batch"), shape, ops::Const(s, {0}, {1}),
+      ops::Const(s, {1}, {1}), ops::Const(s, {1}, {1}),
+      ops::StridedSlice::ShrinkAxisMask(1));
+  Output target = ops::Stack(s.WithOpName("target"),
+                             {batch, ops::Const(s, 20, {})});
+  Output r = ops::Reshape(s.WithOpName("r"), x, target);
+
+  GrapplerItem item;
+  item.fetch = {"r"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  GraphDef output;
+  ShapeOptimizer optimizer;
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  NodeMap node_map(&output);
+  const NodeDef* reshape = node_map.GetNode("r");
+  ASSERT_NE(nullptr, reshape);
+  EXPECT_EQ("ShapeOptimizer/r-shape", reshape->input(1));
+  const NodeDef* new_shape = node_map.GetNode("ShapeOptimizer/r-shape");
+  ASSERT_NE(nullptr, new_shape);
+  EXPECT_EQ("Const", new_shape->op());
+  EXPECT_EQ("^x", new_shape->input(0));
+  Tensor value;
+  ASSERT_TRUE(value.FromProto(new_shape->attr().at("value").tensor()));
+  test::ExpectTensorEqual<int>(test::AsTensor<int>({-1, 20}), value);
+
+  auto x_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({3, 4, 5}));
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, {{"x", x_t}});
+  auto tensors = EvaluateNodes(output, item.fetch, {{"x", x_t}});
+  ASSERT_EQ(1, tensors.size());
+  test::ExpectTensorEqual<float>(tensors_expected[0], tensors[0]);
+}
+
+TEST_F(ShapeOptimizerTest, DedupShapeComputations) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({-1, 4}));
+  Output begin = ops::Const(s.WithOpName("begin"), {0}, {1});
+  Output end = ops::Const(s.WithOpName("end"), {1}, {1});
+  Output strides = ops::Const(s.WithOpName("strides"), {1}, {1});
+  Output shape1 = ops::Shape(s.WithOpName("shape1"), x);
+  Output shape2 = ops::Shape(s.WithOpName("shape2"), x);
+  Output dim1 = ops::StridedSlice(s.WithOpName("dim1"), shape1, begin, end,
+                                  strides);
+  Output dim2 = ops::StridedSlice(s.WithOpName("dim2"), shape2, begin, end,
+                                  strides);
+  Output out1 = ops::Identity(s.WithOpName("out1"), dim1);
+  Output out2 = ops::Identity(s.WithOpName("out2"), dim2);
+
+  GrapplerItem item;
+  item.fetch = {"out1", "out2"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  GraphDef output;
+  ShapeOptimizer optimizer;
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_EQ(item.graph.node_size() - 2, output.node_size());
+  NodeMap node_map(&output);
+  EXPECT_EQ(nullptr, node_map.GetNode("shape2"));
+  EXPECT_EQ(nullptr, node_map.GetNode("dim2"));
+  EXPECT_EQ("dim1", node_map.GetNode("out1")->input(0));
+  EXPECT_EQ("dim1", node_map.GetNode("out2")->input(0));
+
+  auto x_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({3, 4}));
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, {{"x", x_t}});
+  auto tensors = EvaluateNodes(output, item.fetch, {{"x", x_t}});
+  ASSERT_EQ(2, tensors.size());
+  for (int i = 0; i < 2; ++i) {
+    test::ExpectTensorEqual<int>(tensors_expected[i], tensors[i]);
+  }
+}
+
+TEST_F(ShapeOptimizerTest, PinShapeComputationsToHost) {
+  tensorflow::Scope s =
+      tensorflow::Scope::NewRootScope().WithDevice("/device:GPU:0");
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape({-1, -1}));
+  Output shape = ops::Shape(s.WithOpName("shape"), x,
+                            ops::Shape::OutType(DT_INT64));
+  Output begin = ops::Const<int64>(s.WithOpName("begin"), {0}, {1});
+  Output end = ops::Const<int64>(s.WithOpName("end"), {1}, {1});
+  Output strides = ops::Const<int64>(s.WithOpName("strides"), {1}, {1});
+  Output dim = ops::StridedSlice(s.WithOpName("dim"), shape, begin, end,
+                                 strides);
+  Output y = ops::Relu(s.WithOpName("y"), x);
+  Output out = ops::Identity(s.WithOpName("out"), dim);
+
+  GrapplerItem item;
+  item.fetch = {"out", "y"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  GraphDef output;
+  ShapeOptimizer optimizer;
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  NodeMap node_map(&output);
+  // Shape reads the tensor on the device but produces its output on the host.
+  EXPECT_EQ("/device:GPU:0", node_map.GetNode("shape")->device());
+  EXPECT_EQ("/device:CPU:0", node_map.GetNode("dim")->device());
+  EXPECT_EQ("/device:CPU:0", node_map.GetNode("begin")->device());
+  EXPECT_EQ("/device:GPU:0", node_map.GetNode("y")->device());
+}
+
 }  // namespace
 }  // namespace grappler
 }  // namespace tensorflow
@@ -38,41 +38,72 @@ typedef Eigen::GpuDevice GPUDevice;
 typedef Eigen::SyclDevice SYCLDevice;
 #endif  // TENSORFLOW_USE_SYCL
 
+// Also implements _GroupedAddN, which computes one sum per group of
+// consecutive inputs.
 template <typename Device, typename T>
 class AddNOp : public OpKernel {
  public:
-  explicit AddNOp(OpKernelConstruction* context) : OpKernel(context) {}
+  explicit AddNOp(OpKernelConstruction* context) : OpKernel(context) {
+    if (context->HasAttr("group_sizes")) {
+      OP_REQUIRES_OK(context, context->GetAttr("group_sizes", &group_sizes_));
+    } else {
+      group_sizes_.push_back(context->num_inputs());
+    }
+  }
 
   void Compute(OpKernelContext* ctx) override {
-    if (!ctx->ValidateInputsAreSameShape(this)) return;
+    int first = 0;
+    for (int group = 0; group < group_sizes_.size(); ++group) {
+      const int num = group_sizes_[group];
+      OP_REQUIRES(ctx, num >= 1 && first + num <= ctx->num_inputs(),
+                  errors::InvalidArgument("Invalid size ", num, " of group ",
+                                          group, " of ", ctx->num_inputs(),
+                                          " inputs"));
+      ComputeSum(ctx, first, num, group);
+      if (!ctx->status().ok()) return;
+      first += num;
+    }
+  }
 
-    const Tensor& input0 = ctx->input(0);
-    const int num = ctx->num_inputs();
+ private:
+  // Sums the num inputs from first into output output_idx.
+  void ComputeSum(OpKernelContext* ctx, int first, int num, int output_idx) {
+    const Tensor& input0 = ctx->input(first);
+    for (int i = 1; i < num; ++i) {
+      OP_REQUIRES(ctx, input0.IsSameSize(ctx->input(first + i)),
+                  errors::InvalidArgument(
+                      "Inputs to operation ", name(), " of type ",
+                      type_string(), " must have the same size and shape.  ",
+                      "Input ", first, ": ", input0.shape().DebugString(),
+                      " != input ", first + i, ": ",
+                      ctx->input(first + i).shape().DebugString()));
+    }
 
     if (num == 1) {
-      ctx->set_output(0, input0);
+      ctx->set_output(output_idx, input0);
       return;
     }
 
     // Try to forward and accumulate the result in one of the input buffers.
     int reused_input = -1;
     gtl::InlinedVector<int, 8> input_indices(num);
-    std::iota(input_indices.begin(), input_indices.end(), 0);
+    std::iota(input_indices.begin(), input_indices.end(), first);
     Tensor* output = nullptr;
-    for (int input_idx = 0; input_idx < num; ++input_idx) {
-      if (ctx->forward_input_to_output_with_shape(input_idx, 0, input0.shape(),
-                                                  &output)) {
-        reused_input = input_idx;
+    for (int i = 0; i < num; ++i) {
+      if (ctx->forward_input_to_output_with_shape(
+              first + i, output_idx, input0.shape(), &output)) {
+        reused_input = i;
         break;
       }
     }
     if (reused_input == -1) {
-      OP_REQUIRES_OK(ctx, ctx->allocate_output(0, input0.shape(), &output));
+      OP_REQUIRES_OK(
+          ctx, ctx->allocate_output(output_idx, input0.shape(), &output));
     } else if (reused_input > 0) {
       // Move the forwarded buffer to the front so we don't double count
       // anything if there are more than 8 inputs.
-      input_indices[0] = reused_input;
-      input_indices[reused_input] = 0;
+      input_indices[0] = first + reused_input;
+      input_indices[reused_input] = first;
     }
     auto To = output->flat<T>();
 
@@ -151,6 +182,8 @@ class AddNOp : public OpKernel {
 
 #undef I
   }
+
+  std::vector<int32> group_sizes_;
 };
 
 template <typename Device>
@@ -217,6 +250,11 @@ class AddNOp<Device, Variant> : public OpKernel {
       Name("AddN").Device(DEVICE_##dev).TypeConstraint<type>("T"), \
       AddNOp<dev##Device, type>)
 
+#define REGISTER_GROUPED_ADDN(type, dev)                                  \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("_GroupedAddN").Device(DEVICE_##dev).TypeConstraint<type>("T"), \
+      AddNOp<dev##Device, type>)
+
 #define REGISTER_ADDN_CPU(type) REGISTER_ADDN(type, CPU)
 
 TF_CALL_NUMBER_TYPES(REGISTER_ADDN_CPU);
@@ -224,6 +262,10 @@ REGISTER_ADDN_CPU(Variant);
 
 #undef REGISTER_ADDN_CPU
 
+#define REGISTER_GROUPED_ADDN_CPU(type) REGISTER_GROUPED_ADDN(type, CPU)
+TF_CALL_NUMBER_TYPES(REGISTER_GROUPED_ADDN_CPU);
+#undef REGISTER_GROUPED_ADDN_CPU
+
 #if GOOGLE_CUDA
 #define REGISTER_ADDN_GPU(type) REGISTER_ADDN(type, GPU)
 TF_CALL_GPU_NUMBER_TYPES(REGISTER_ADDN_GPU);
@@ -232,6 +274,10 @@ TF_CALL_complex128(REGISTER_ADDN_GPU);
 TF_CALL_variant(REGISTER_ADDN_GPU);
 #undef REGISTER_ADDN_GPU
 
+#define REGISTER_GROUPED_ADDN_GPU(type) REGISTER_GROUPED_ADDN(type, GPU)
+TF_CALL_GPU_NUMBER_TYPES(REGISTER_GROUPED_ADDN_GPU);
+#undef REGISTER_GROUPED_ADDN_GPU
+
 // A special GPU kernel for int32.
 // TODO(b/25387198): Also enable int32 in device memory. This kernel
 // registration requires all int32 inputs and outputs to be in host memory.
@@ -249,6 +295,10 @@ REGISTER_KERNEL_BUILDER(Name("AddN")
 
 TF_CALL_SYCL_NUMBER_TYPES(REGISTER_ADDN_SYCL);
 
+#define REGISTER_GROUPED_ADDN_SYCL(type) REGISTER_GROUPED_ADDN(type, SYCL)
+TF_CALL_SYCL_NUMBER_TYPES(REGISTER_GROUPED_ADDN_SYCL);
+#undef REGISTER_GROUPED_ADDN_SYCL
+
 // A special GPU kernel for int32.
 // TODO(b/25387198): Also enable int32 in device memory. This kernel
 // registration requires all int32 inputs and outputs to be in host memory.
@@ -261,6 +311,7 @@ REGISTER_KERNEL_BUILDER(Name("AddN")
 #undef REGISTER_ADDN_SYCL
 #endif  // TENSORFLOW_USE_SYCL
 
+#undef REGISTER_GROUPED_ADDN
 #undef REGISTER_ADDN
 
 }  // namespace tensorflow
@@ -239,15 +239,18 @@ class AvgPool2DSYCL {
                 const std::array<int64, 2>& window,
                 const std::array<int64, 2>& stride,
                 const std::array<int64, 2>& padding,
-                const read_accessor input_accessor,
-                write_accessor output_accessor)
+                const read_accessor input_accessor, const int input_offset,
+                write_accessor output_accessor, const int output_offset)
       : p_(depth, batch, in_rows, in_cols, out_rows, out_cols, window, stride,
            padding),
         input_accessor_(input_accessor),
-        output_accessor_(output_accessor) {}
+        input_offset_(input_offset),
+        output_accessor_(output_accessor),
+        output_offset_(output_offset) {}
   void operator()(cl::sycl::item<1> item) {
-    T* input_data = ConvertToActualTypeSycl(T, input_accessor_);
-    T* output_data = ConvertToActualTypeSycl(T, output_accessor_);
+    T* input_data = ConvertToActualTypeSycl(T, input_accessor_) + input_offset_;
+    T* output_data =
+        ConvertToActualTypeSycl(T, output_accessor_) + output_offset_;
      int index = item.get_linear_id();
     int n = index;
     int d = n % p_.depth_;
@@ -275,7 +278,9 @@ class AvgPool2DSYCL {
   private:
   const SYCL2DPoolParams p_;
   const read_accessor input_accessor_;
+  const int input_offset_;
   write_accessor output_accessor_;
+  const int output_offset_;
 };
  template <typename T>
 struct LaunchAvgPoolingOpSYCL {
@@ -293,10 +298,12 @@ struct LaunchAvgPoolingOpSYCL {
     const int in_cols = GetTensorDim(tensor_in, data_format, '1');
     const int depth = GetTensorDim(tensor_in, data_format, 'C');
      const int num_threads = output->NumElements();
-     auto input_buffer =
-        device.get_sycl_buffer(tensor_in.template flat<T>().data());
-    auto output_buffer =
-        device.get_sycl_buffer(output->template flat<T>().data());
+     const T* input_data = tensor_in.template flat<T>().data();
+    T* output_data = output->template flat<T>().data();
+    auto input_buffer = device.get_sycl_buffer(input_data);
+    auto output_buffer = device.get_sycl_buffer(output_data);
+    const int input_offset = device.get_offset(input_data) / sizeof(T);
+    const int output_offset = device.get_offset(output_data) / sizeof(T);
      device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
       auto input_access =
           input_buffer.template get_access<cl::sycl::access::mode::read>(cgh);
@@ -304,7 +311,7 @@ struct LaunchAvgPoolingOpSYCL {
           output_buffer.template get_access<cl::sycl::access::mode::write>(cgh);
       AvgPool2DSYCL<T> avg_pool(depth, batch, in_rows, in_cols, out_rows,
                                 out_cols, window, stride, padding, input_access,
-                                output_access);
+                                input_offset, output_access, output_offset);
        cgh.parallel_for(cl::sycl::range<1>(num_threads), avg_pool);
     });
   }
@@ -369,7 +376,7 @@ class AvgPoolingOp<SYCLDevice, T> : public UnaryOp<T> {
     auto in_ptr = tensor_in.template flat<T>().data();
     auto out_ptr = output->template flat<T>().data();
     vlog_pooling_params(sd_params, "forward_avgpooling");
-    CREATE_SNN_BACKEND(sd_backend, device);
+    ACQUIRE_SNN_BACKEND(sd_backend, device);
     auto sd_in = get_sycl_dnn_input<T>(device, in_ptr);
     auto sd_out = get_sycl_dnn_input<T>(device, out_ptr);
     sycldnn::SNNStatus sd_status = sd::launch<T, sd::Average, sd::Forward>(
@@ -795,13 +802,19 @@ class AvgPoolGradSYCL {
                   const std::array<int64, 2>& stride,
                   const std::array<int64, 2>& padding,
                   const read_accessor input_backprop_accessor,
-                  write_accessor output_backprop_accessor)
+                  const int input_backprop_offset,
+                  write_accessor output_backprop_accessor,
+                  const int output_backprop_offset)
       : p_(depth, batch, in_rows, in_cols, out_shape, window, stride, padding),
         input_backprop_accessor_(input_backprop_accessor),
-        output_backprop_accessor_(output_backprop_accessor) {}
+        input_backprop_offset_(input_backprop_offset),
+        output_backprop_accessor_(output_backprop_accessor),
+        output_backprop_offset_(output_backprop_offset) {}
   void operator()(cl::sycl::item<1> item) {
-    T* input_backprop = ConvertToActualTypeSycl(T, input_backprop_accessor_);
-    T* output_backprop = ConvertToActualTypeSycl(T, output_backprop_accessor_);
+    T* input_backprop = ConvertToActualTypeSycl(T, input_backprop_accessor_) +
+                        input_backprop_offset_;
+    T* output_backprop = ConvertToActualTypeSycl(T, output_backprop_accessor_) +
+                         output_backprop_offset_;
      const int index = item.get_linear_id();
     int n = index;
     const int d = n % p_.depth_;
@@ -839,7 +852,9 @@ class AvgPoolGradSYCL {
   private:
   const SYCL2DPoolParams p_;
   const read_accessor input_backprop_accessor_;
+  const int input_backprop_offset_;
   write_accessor output_backprop_accessor_;
+  const int output_backprop_offset_;
 };
 template <typename T>
 struct LaunchAvgPoolingGradOpSYCL {
@@ -857,10 +872,14 @@ struct LaunchAvgPoolingGradOpSYCL {
     const int in_cols = GetTensorDim(tensor_in_shape, data_format, '1');
     const int depth = GetTensorDim(tensor_in_shape, data_format, 'C');
      const int num_threads = output->NumElements();
-     auto input_backprop_buffer =
-        device.get_sycl_buffer(out_backprop.template flat<T>().data());
-    auto output_backprop_buffer =
-        device.get_sycl_buffer(output->template flat<T>().data());
+     const T* input_backprop_data = out_backprop.template flat<T>().data();
+    T* output_backprop_data = output->template flat<T>().data();
+    auto input_backprop_buffer = device.get_sycl_buffer(input_backprop_data);
+    auto output_backprop_buffer = device.get_sycl_buffer(output_backprop_data);
+    const int input_backprop_offset =
+        device.get_offset(input_backprop_data) / sizeof(T);
+    const int output_backprop_offset =
+        device.get_offset(output_backprop_data) / sizeof(T);
      device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
       auto input_backprop_access =
           input_backprop_buffer
@@ -870,7 +889,8 @@ struct LaunchAvgPoolingGradOpSYCL {
               .template get_access<cl::sycl::access::mode::write>(cgh);
       AvgPoolGradSYCL<T> avgpoolgrad(
           depth, batch, in_rows, in_cols, output_shape, window, stride, padding,
-          input_backprop_access, output_backprop_access);
+          input_backprop_access, input_backprop_offset, output_backprop_access,
+          output_backprop_offset);
        cgh.parallel_for(cl::sycl::range<1>(num_threads), avgpoolgrad);
     });
   }
@@ -942,7 +962,7 @@ class AvgPoolingGradOp<SYCLDevice, T> : public OpKernel {
     auto in_ptr = out_backprop.template flat<T>().data();
     auto out_ptr = output->template flat<T>().data();
     vlog_pooling_params(sd_params, "backprop_avgpooling");
-    CREATE_SNN_BACKEND(sd_backend, device);
+    ACQUIRE_SNN_BACKEND(sd_backend, device);
     auto sd_in = get_sycl_dnn_input<T>(device, in_ptr);
     auto sd_out = get_sycl_dnn_input<T>(device, out_ptr);
     sycldnn::SNNStatus sd_status = sd::launch<T, sd::Average, sd::Backpropagate>(
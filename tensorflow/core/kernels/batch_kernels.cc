@@ -35,11 +35,50 @@ typedef Eigen::GpuDevice GPUDevice;
 typedef Eigen::SyclDevice SYCLDevice;
 #endif  // TENSORFLOW_USE_SYCL
 
+// The element types of the tensors batched on GPU and SYCL devices: those
+// which both the concat and the split functors are instantiated for.
+#define TF_CALL_BATCH_GPU_TYPES(m) \
+  TF_CALL_GPU_NUMBER_TYPES(m) TF_CALL_complex64(m) TF_CALL_complex128(m)
+#define TF_CALL_BATCH_SYCL_TYPES(m) TF_CALL_SYCL_NUMBER_TYPES(m)
+
+// Concatenates 'inputs_flat' into 'output', whose flattened view is
+// 'output_flat', on the device of 'context'.
+template <typename T>
+void ConcatFlat(
+    const CPUDevice& d, OpKernelContext* context,
+    const std::vector<std::unique_ptr<typename TTypes<T, 2>::ConstMatrix>>&
+        inputs_flat,
+    Tensor* output, typename TTypes<T, 2>::Matrix* output_flat) {
+  ConcatCPU<T>(context->device(), inputs_flat, output_flat);
+}
+
+#if GOOGLE_CUDA
+template <typename T>
+void ConcatFlat(
+    const GPUDevice& d, OpKernelContext* context,
+    const std::vector<std::unique_ptr<typename TTypes<T, 2>::ConstMatrix>>&
+        inputs_flat,
+    Tensor* output, typename TTypes<T, 2>::Matrix* output_flat) {
+  ConcatGPU<T>(context, inputs_flat, output, output_flat);
+}
+#endif  // GOOGLE_CUDA
+
+#ifdef TENSORFLOW_USE_SYCL
+template <typename T>
+void ConcatFlat(
+    const SYCLDevice& d, OpKernelContext* context,
+    const std::vector<std::unique_ptr<typename TTypes<T, 2>::ConstMatrix>>&
+        inputs_flat,
+    Tensor* output, typename TTypes<T, 2>::Matrix* output_flat) {
+  ConcatSYCL<T>(d, inputs_flat, output, output_flat);
+}
+#endif  // TENSORFLOW_USE_SYCL
+
 // Concatenates 'inputs' into a single tensor along the zeroth dimension.
 // Requires that all elements of 'inputs' have element type T. Writes to the
 // op's output at position 'output_index', using 'context' for the allocation to
 // ensure proper device placement.
-template <typename T>
+template <typename Device, typename T>
 Status Concat(OpKernelContext* context, const gtl::ArraySlice<Tensor>& inputs,
               int output_index) {
   const int input_dims = inputs[0].dims();
@@ -81,13 +120,8 @@ Status Concat(OpKernelContext* context, const gtl::ArraySlice<Tensor>& inputs,
       context->allocate_output(output_index, output_shape, &output));
   if (output->NumElements() > 0) {
     auto output_flat = output->shaped<T, 2>({1, output->NumElements()});
-#if GOOGLE_CUDA
-    if (std::is_same<Device, GPUDevice>::value) {
-      ConcatGPU<T>(context, inputs_flat, output, &output_flat);
-      return Status::OK();
-    }
-#endif  // GOOGLE_CUDA
-    ConcatCPU<T>(context->device(), inputs_flat, &output_flat);
+    ConcatFlat<T>(context->eigen_device<Device>(), context, inputs_flat, output,
+                  &output_flat);
   }
 
   return Status::OK();
@@ -136,11 +170,11 @@ Status SplitEasyCases(OpKernelContext* context, const Tensor& input,
   return Status::OK();
 }
 
-// Handles the general case, on CPU.
-template <typename T>
-Status SplitCPU(OpKernelContext* context, const Tensor& input,
-                const gtl::ArraySlice<int64>& sizes,
-                std::vector<Tensor>* outputs) {
+// Handles the general case, copying the splits on the device of 'context'.
+template <typename Device, typename T>
+Status SplitGeneral(OpKernelContext* context, const Tensor& input,
+                    const gtl::ArraySlice<int64>& sizes,
+                    std::vector<Tensor>* outputs) {
   int64 suffix_dim_size = 1;
   for (int i = 1; i < input.shape().dims(); ++i) {
     suffix_dim_size *= input.shape().dim_size(i);
@@ -159,9 +193,9 @@ Status SplitCPU(OpKernelContext* context, const Tensor& input,
 
     Eigen::DSizes<Eigen::DenseIndex, 2> slice_indices{position, 0};
     Eigen::DSizes<Eigen::DenseIndex, 2> slice_sizes{size, suffix_dim_size};
-    functor::Split<CPUDevice, T, 2>()(context->eigen_device<CPUDevice>(),
-                                      output_shaped, input_reshaped,
-                                      slice_indices, slice_sizes);
+    functor::Split<Device, T, 2>()(context->eigen_device<Device>(),
+                                   output_shaped, input_reshaped,
+                                   slice_indices, slice_sizes);
 
     outputs->emplace_back(output);
 
@@ -171,21 +205,8 @@ Status SplitCPU(OpKernelContext* context, const Tensor& input,
   return Status::OK();
 }
 
-#if GOOGLE_CUDA
-
-// Handles the general case, on GPU.
-template <typename T>
-Status SplitGPU(OpKernelContext* context, const Tensor& input,
-                const gtl::ArraySlice<int64>& sizes,
-                std::vector<Tensor>* outputs) {
-  // TODO(olston, apassos): Implement this.
-  LOG(FATAL) << "Not yet implemented";  // Crash ok
-}
-
-#endif  // GOOGLE_CUDA
-
 // The outer function that dispatches to the various Split*() functions above.
-template <typename T>
+template <typename Device, typename T>
 Status Split(OpKernelContext* context, const Tensor& input,
              const gtl::ArraySlice<int64>& sizes,
              std::vector<Tensor>* outputs) {
@@ -195,15 +216,81 @@ Status Split(OpKernelContext* context, const Tensor& input,
   if (easy_cases_done) {
     return Status::OK();
   }
+  return SplitGeneral<Device, T>(context, input, sizes, outputs);
+}
+
+// ConcatByType() and SplitByType() call Concat() and Split() for the element
+// type of the tensors, among those supported on 'Device'.
+template <typename Device>
+Status ConcatByType(OpKernelContext* context,
+                    const gtl::ArraySlice<Tensor>& inputs, int output_index);
+template <typename Device>
+Status SplitByType(OpKernelContext* context, const Tensor& input,
+                   const gtl::ArraySlice<int64>& sizes,
+                   std::vector<Tensor>* outputs);
+
+#define DEFINE_BY_TYPE(Device, CALL_TYPES)                                   \
+  template <>                                                                \
+  Status ConcatByType<Device>(OpKernelContext * context,                     \
+                              const gtl::ArraySlice<Tensor>& inputs,         \
+                              int output_index) {                            \
+    const DataType type = inputs[0].dtype();                                 \
+    switch (type) {                                                          \
+      CALL_TYPES(CONCAT_CASE)                                                \
+      default:                                                               \
+        return errors::InvalidArgument("Unsupported data type: ", type);     \
+    }                                                                        \
+  }                                                                          \
+  template <>                                                                \
+  Status SplitByType<Device>(OpKernelContext * context, const Tensor& input, \
+                             const gtl::ArraySlice<int64>& sizes,            \
+                             std::vector<Tensor>* outputs) {                 \
+    const DataType type = input.dtype();                                     \
+    switch (type) {                                                          \
+      CALL_TYPES(SPLIT_CASE)                                                 \
+      default:                                                               \
+        return errors::InvalidArgument("Unsupported data type: ", type);     \
+    }                                                                        \
+  }
+
+#define CONCAT_CASE(type)           \
+  case DataTypeToEnum<type>::value: \
+    return Concat<CPUDevice, type>(context, inputs, output_index);
+#define SPLIT_CASE(type)            \
+  case DataTypeToEnum<type>::value: \
+    return Split<CPUDevice, type>(context, input, sizes, outputs);
+DEFINE_BY_TYPE(CPUDevice, TF_CALL_ALL_TYPES)
+#undef SPLIT_CASE
+#undef CONCAT_CASE
 
 #if GOOGLE_CUDA
-// TODO(olston, apassos): Handle non-CPU cases.
-// return SplitGPU<T>(context, input, sizes, outputs);
+#define CONCAT_CASE(type)           \
+  case DataTypeToEnum<type>::value: \
+    return Concat<GPUDevice, type>(context, inputs, output_index);
+#define SPLIT_CASE(type)            \
+  case DataTypeToEnum<type>::value: \
+    return Split<GPUDevice, type>(context, input, sizes, outputs);
+DEFINE_BY_TYPE(GPUDevice, TF_CALL_BATCH_GPU_TYPES)
+#undef SPLIT_CASE
+#undef CONCAT_CASE
 #endif  // GOOGLE_CUDA
-  return SplitCPU<T>(context, input, sizes, outputs);
-}
+
+#ifdef TENSORFLOW_USE_SYCL
+#define CONCAT_CASE(type)           \
+  case DataTypeToEnum<type>::value: \
+    return Concat<SYCLDevice, type>(context, inputs, output_index);
+#define SPLIT_CASE(type)            \
+  case DataTypeToEnum<type>::value: \
+    return Split<SYCLDevice, type>(context, input, sizes, outputs);
+DEFINE_BY_TYPE(SYCLDevice, TF_CALL_BATCH_SYCL_TYPES)
+#undef SPLIT_CASE
+#undef CONCAT_CASE
+#endif  // TENSORFLOW_USE_SYCL
+
+#undef DEFINE_BY_TYPE
 
 // A class encapsulating the state and logic for batching tensors.
+template <typename Device>
 class BatchResource : public ResourceBase {
  public:
   static Status Create(int32 num_batch_threads, int32 max_batch_size,
@@ -212,7 +299,7 @@ class BatchResource : public ResourceBase {
                        std::unique_ptr<BatchResource>* resource) {
     std::unique_ptr<BatchResource> new_resource(new BatchResource);
 
-    Batcher::Options batcher_options;
+    typename Batcher::Options batcher_options;
     batcher_options.num_batch_threads = num_batch_threads;
     TF_RETURN_IF_ERROR(
         Batcher::Create(batcher_options, &new_resource->batcher_));
@@ -355,55 +442,19 @@ class BatchResource : public ResourceBase {
       }
 
       // Add padding as needed. Use the first row of the first task's tensor as
-      // the data for padding.
+      // the data for padding. The first row is always aligned, so slicing it
+      // shares the buffer wherever the tensor lives instead of copying it.
       if (padding_amount > 0) {
-        const Tensor& padding_source = batch->task(0).inputs.at(i);
-        Tensor padding;
-        if (padding_source.shape().dim_size(0) == 1) {
-          padding = padding_source;
-        } else {
-          const std::vector<int64> slice_sizes = {1};
-          const DataType type = padding_source.dtype();
-          Status slice_status;
-          std::vector<Tensor> slices;
-          switch (type) {
-#define CASE(type)                                                   \
-  case DataTypeToEnum<type>::value:                                  \
-    slice_status = SplitCPU<type>(last_task_context, padding_source, \
-                                  slice_sizes, &slices);             \
-    break;
-            TF_CALL_ALL_TYPES(CASE);
-#undef CASE
-            default:
-              slice_status =
-                  errors::InvalidArgument("Unsupported data type: ", type);
-              break;
-          }
-          OP_REQUIRES_OK_ASYNC(last_task_context, slice_status,
-                               last_task_callback);
-          padding = slices.at(0);
-        }
+        const Tensor padding = batch->task(0).inputs.at(i).Slice(0, 1);
         for (int i = 0; i < padding_amount; ++i) {
           to_concatenate.push_back(padding);
         }
       }
 
-      const DataType type = to_concatenate[0].dtype();
-      Status concat_status;
-      switch (type) {
-#define CASE(type)                                                      \
-  case DataTypeToEnum<type>::value:                                     \
-    concat_status = Concat<type>(last_task_context, to_concatenate, i); \
-    break;
-        TF_CALL_ALL_TYPES(CASE);
-#undef CASE
-        default:
-          concat_status =
-              errors::InvalidArgument("Unsupported data type: ", type);
-          break;
-      }
-      OP_REQUIRES_OK_ASYNC(last_task_context, concat_status,
-                           last_task_callback);
+      OP_REQUIRES_OK_ASYNC(
+          last_task_context,
+          ConcatByType<Device>(last_task_context, to_concatenate, i),
+          last_task_callback);
     }
 
     // Emit batch->num_tasks() - 1 empty index tensors.
@@ -488,7 +539,7 @@ class BatchResource : public ResourceBase {
 
   // A batch scheduler, and options for creating queues.
   std::shared_ptr<Batcher> batcher_;
-  Batcher::QueueOptions batcher_queue_options_;
+  typename Batcher::QueueOptions batcher_queue_options_;
 
   // A collection of batcher queues, keyed on queue name.
   // TODO(olston): Garbage-collect unused queues (perhaps simply remove empty
@@ -500,6 +551,7 @@ class BatchResource : public ResourceBase {
   std::vector<int32> allowed_batch_sizes_;
 };
 
+template <typename Device>
 class BatchKernel : public AsyncOpKernel {
  public:
   explicit BatchKernel(OpKernelConstruction* c) : AsyncOpKernel(c) {
@@ -522,11 +574,11 @@ class BatchKernel : public AsyncOpKernel {
   }
 
   void ComputeAsync(OpKernelContext* c, DoneCallback done) final {
-    BatchResource* br;
-    std::function<Status(BatchResource * *r)> creator =
-        [this](BatchResource** r) {
-          std::unique_ptr<BatchResource> new_resource;
-          TF_RETURN_IF_ERROR(BatchResource::Create(
+    BatchResource<Device>* br;
+    std::function<Status(BatchResource<Device> * *r)> creator =
+        [this](BatchResource<Device>** r) {
+          std::unique_ptr<BatchResource<Device>> new_resource;
+          TF_RETURN_IF_ERROR(BatchResource<Device>::Create(
               num_batch_threads_, max_batch_size_, batch_timeout_micros_,
               max_enqueued_batches_, allowed_batch_sizes_, &new_resource));
           *r = new_resource.release();
@@ -578,7 +630,8 @@ class BatchKernel : public AsyncOpKernel {
   std::vector<int32> allowed_batch_sizes_;
 };
 
-REGISTER_KERNEL_BUILDER(Name("Batch").Device(DEVICE_CPU), BatchKernel);
+REGISTER_KERNEL_BUILDER(Name("Batch").Device(DEVICE_CPU),
+                        BatchKernel<CPUDevice>);
 
 // A class encapsulating the state and logic for unbatching tensors.
 //
@@ -588,6 +641,7 @@ REGISTER_KERNEL_BUILDER(Name("Batch").Device(DEVICE_CPU), BatchKernel);
 // kernels to run. Whenever a kernel runs, we either grab its tensor if it's
 // waiting already, or we insert it in the queue and then look at its tensor to
 // see if it can be used to dispatch any stored continuations.
+template <typename Device>
 class UnbatchResource : public ResourceBase {
  public:
   explicit UnbatchResource(int32 timeout_micros)
@@ -638,17 +692,8 @@ class UnbatchResource : public ResourceBase {
         batch_keys.push_back(batch_indices(i, 0));
       }
 
-      const DataType type = data_t.dtype();
-      switch (type) {
-#define CASE(type)                                                          \
-  case DataTypeToEnum<type>::value:                                         \
-    TF_RETURN_IF_ERROR(Split<type>(context, data_t, sizes, &split_inputs)); \
-    break;
-        TF_CALL_ALL_TYPES(CASE);
-#undef CASE
-        default:
-          return errors::InvalidArgument("Unsupported data type: ", type);
-      }
+      TF_RETURN_IF_ERROR(
+          SplitByType<Device>(context, data_t, sizes, &split_inputs));
     }
 
     // Critical section.
@@ -774,6 +819,7 @@ class UnbatchResource : public ResourceBase {
   std::unique_ptr<serving::PeriodicFunction> timeout_enforcer_;
 };
 
+template <typename Device>
 class UnbatchKernel : public AsyncOpKernel {
  public:
   explicit UnbatchKernel(OpKernelConstruction* c) : AsyncOpKernel(c) {
@@ -788,10 +834,10 @@ class UnbatchKernel : public AsyncOpKernel {
   }
 
   void ComputeAsync(OpKernelContext* c, DoneCallback done) final {
-    UnbatchResource* ubr;
-    std::function<Status(UnbatchResource * *r)> creator =
-        [this](UnbatchResource** r) {
-          *r = new UnbatchResource(timeout_micros_);
+    UnbatchResource<Device>* ubr;
+    std::function<Status(UnbatchResource<Device> * *r)> creator =
+        [this](UnbatchResource<Device>** r) {
+          *r = new UnbatchResource<Device>(timeout_micros_);
           return Status::OK();
         };
     OP_REQUIRES_OK_ASYNC(c,
@@ -811,10 +857,12 @@ class UnbatchKernel : public AsyncOpKernel {
   string shared_name_;
   int32 timeout_micros_;
 };
-REGISTER_KERNEL_BUILDER(Name("Unbatch").Device(DEVICE_CPU), UnbatchKernel);
+REGISTER_KERNEL_BUILDER(Name("Unbatch").Device(DEVICE_CPU),
+                        UnbatchKernel<CPUDevice>);
 
 // A class encapsulating the state and logic for batching tensors
 // deterministically for the gradient of unbatch.
+template <typename Device>
 class UnbatchGradResource : public ResourceBase {
  public:
   UnbatchGradResource() {}
@@ -839,17 +887,7 @@ class UnbatchGradResource : public ResourceBase {
       available_tensors_.erase(available_it);
     }
 
-    const DataType type = tensors[0].dtype();
-    switch (type) {
-#define CASE(type)                                         \
-  case DataTypeToEnum<type>::value:                        \
-    TF_RETURN_IF_ERROR(Concat<type>(context, tensors, 0)); \
-    break;
-      TF_CALL_ALL_TYPES(CASE);
-#undef CASE
-      default:
-        return errors::InvalidArgument("Unsupported data type: ", type);
-    }
+    TF_RETURN_IF_ERROR(ConcatByType<Device>(context, tensors, 0));
     done();
     return Status::OK();
   }
@@ -961,6 +999,7 @@ class UnbatchGradResource : public ResourceBase {
   std::unordered_map<int64, int64> desired_tensor_to_batch_map_;
 };
 
+template <typename Device>
 class UnbatchGradKernel : public AsyncOpKernel {
  public:
   explicit UnbatchGradKernel(OpKernelConstruction* c) : AsyncOpKernel(c) {
@@ -974,10 +1013,10 @@ class UnbatchGradKernel : public AsyncOpKernel {
   }
 
   void ComputeAsync(OpKernelContext* c, DoneCallback done) final {
-    UnbatchGradResource* ubr;
-    std::function<Status(UnbatchGradResource * *r)> creator =
-        [this](UnbatchGradResource** r) {
-          *r = new UnbatchGradResource();
+    UnbatchGradResource<Device>* ubr;
+    std::function<Status(UnbatchGradResource<Device> * *r)> creator =
+        [this](UnbatchGradResource<Device>** r) {
+          *r = new UnbatchGradResource<Device>();
           return Status::OK();
         };
     OP_REQUIRES_OK_ASYNC(c,
@@ -997,6 +1036,48 @@ class UnbatchGradKernel : public AsyncOpKernel {
   string shared_name_;
 };
 REGISTER_KERNEL_BUILDER(Name("UnbatchGrad").Device(DEVICE_CPU),
-                        UnbatchGradKernel);
+                        UnbatchGradKernel<CPUDevice>);
+
+// On GPU and SYCL devices the batched data stays on the device: the batch is
+// concatenated and split there, and only the batch index and id, which the
+// kernels read and write on the host, live in host memory. Batch takes a list
+// of types, so each kernel is registered once for all the supported types.
+#define REGISTER_BATCH_KERNELS(DEVICE, Device, types)     \
+  REGISTER_KERNEL_BUILDER(Name("Batch")                   \
+                              .Device(DEVICE)             \
+                              .TypeConstraint("T", types) \
+                              .HostMemory("batch_index")  \
+                              .HostMemory("id"),          \
+                          BatchKernel<Device>);           \
+  REGISTER_KERNEL_BUILDER(Name("Unbatch")                 \
+                              .Device(DEVICE)             \
+                              .TypeConstraint("T", types) \
+                              .HostMemory("batch_index")  \
+                              .HostMemory("id"),          \
+                          UnbatchKernel<Device>);         \
+  REGISTER_KERNEL_BUILDER(Name("UnbatchGrad")             \
+                              .Device(DEVICE)             \
+                              .TypeConstraint("T", types) \
+                              .HostMemory("batch_index")  \
+                              .HostMemory("id"),          \
+                          UnbatchGradKernel<Device>);
+#define DATA_TYPE(type) DataTypeToEnum<type>::value,
+
+#if GOOGLE_CUDA
+std::vector<DataType> BatchGPUTypes() {
+  return {TF_CALL_BATCH_GPU_TYPES(DATA_TYPE)};
+}
+REGISTER_BATCH_KERNELS(DEVICE_GPU, GPUDevice, BatchGPUTypes());
+#endif  // GOOGLE_CUDA
+
+#ifdef TENSORFLOW_USE_SYCL
+std::vector<DataType> BatchSYCLTypes() {
+  return {TF_CALL_BATCH_SYCL_TYPES(DATA_TYPE)};
+}
+REGISTER_BATCH_KERNELS(DEVICE_SYCL, SYCLDevice, BatchSYCLTypes());
+#endif  // TENSORFLOW_USE_SYCL
+
+#undef DATA_TYPE
+#undef REGISTER_BATCH_KERNELS
 
 }  // namespace tensorflow
@@ -37,6 +37,7 @@ limitations under the License.
 
 #if TENSORFLOW_USE_SYCL
 #include "tensorflow/core/kernels/sycl_blas_utils.h"
+#include "tensorflow/core/kernels/sycl_co_execution.h"
 #endif  // TENSORFLOW_USE_SYCL
 
 namespace tensorflow {
@@ -504,7 +505,53 @@ struct LaunchBatchMatMul<SYCLDevice, Scalar> {
   static void Launch(OpKernelContext* context, const Tensor& in_x,
                      const Tensor& in_y, bool adj_x, bool adj_y, Tensor* out) {
     auto& device = context->eigen_sycl_device();
-    SYCLBlasExecutor ex(device.sycl_queue());
+    const int64 batch_size = in_x.dim_size(0);
+    SYCLCoExecution* co_execution = nullptr;
+    int64 host_batches = 0;
+    if (SYCLCoExecution::Enabled()) {
+      co_execution = SYCLCoExecution::Get(device.sycl_queue());
+      host_batches = co_execution->HostRows(
+          batch_size, out->NumElements() * in_x.dim_size(adj_x ? 1 : 2));
+    }
+    if (host_batches == 0) {
+      Gemm(device, in_x, in_y, adj_x, adj_y, out);
+      return;
+    }
+
+    // The first matrices of the batch are multiplied on the device and the
+    // last ones on the host, by the CPU kernel.
+    const int64 device_batches = batch_size - host_batches;
+    Tensor host_x, host_y, host_out;
+    OP_REQUIRES_OK(context,
+                   SYCLCoExecution::CopyToHost(
+                       context, in_x.Slice(device_batches, batch_size),
+                       &host_x));
+    OP_REQUIRES_OK(context,
+                   SYCLCoExecution::CopyToHost(
+                       context, in_y.Slice(device_batches, batch_size),
+                       &host_y));
+    Tensor out_batches = out->Slice(device_batches, batch_size);
+    OP_REQUIRES_OK(context, SYCLCoExecution::AllocateHost(
+                                context, out_batches, &host_out));
+    const Tensor device_x = in_x.Slice(0, device_batches);
+    const Tensor device_y = in_y.Slice(0, device_batches);
+    Tensor device_out = out->Slice(0, device_batches);
+    co_execution->Run(
+        device, device_batches, host_batches,
+        [&] { Gemm(device, device_x, device_y, adj_x, adj_y, &device_out); },
+        [&] {
+          LaunchBatchMatMul<CPUDevice, Scalar>::Launch(
+              context, host_x, host_y, adj_x, adj_y, &host_out);
+        });
+    if (!context->status().ok()) return;
+    SYCLUtil::blockingCopyCPUTensorToDevice(device, host_out, out_batches);
+  }
+
+ private:
+  static void Gemm(const SYCLDevice& device, const Tensor& in_x,
+                   const Tensor& in_y, bool adj_x, bool adj_y, Tensor* out) {
+    auto ex_handle = AcquireSYCLBlasExecutor(device);
+    SYCLBlasExecutor& ex = *ex_handle;
     auto tx = in_x.tensor<Scalar, 3>();
     auto ty = in_y.tensor<Scalar, 3>();
     auto tz = out->tensor<Scalar, 3>();
@@ -524,10 +571,45 @@ struct LaunchBatchMatMul<SYCLDevice, Scalar> {
     auto rhs_blas_ptr = get_buffer_iterator<Scalar>(device, ty.data());
     auto out_blas_ptr = get_buffer_iterator<Scalar>(device, tz.data());
     vlog_blas_params("batch_matmul", trans_m, trans_n, k, t_x, t_y, batch_size);
+    if (batch_size == 1) {
+      // The plain gemm is tuned for larger tiles than the batched one.
+      blas::_gemm(ex, t_x, t_y, trans_m, trans_n, k, Scalar(1), rhs_blas_ptr,
+                  lda, lhs_blas_ptr, ldb, Scalar(0), out_blas_ptr, ldc);
+      return;
+    }
+    // The slices are contiguous, so the whole batch runs as a single strided
+    // kernel launch rather than one launch per slice.
     blas::_gemm_batched(ex, t_x, t_y, trans_m, trans_n, k, Scalar(1), rhs_blas_ptr, lda,
         lhs_blas_ptr, ldb, Scalar(0), out_blas_ptr, ldc, batch_size);
   }
 };
+
+#ifndef TENSORFLOW_SYCL_NO_HALF
+// Half matrices are multiplied by the float gemm so that the dot products
+// accumulate in float.
+template <>
+struct LaunchBatchMatMul<SYCLDevice, Eigen::half> {
+  static void Launch(OpKernelContext* context, const Tensor& in_x,
+                     const Tensor& in_y, bool adj_x, bool adj_y, Tensor* out) {
+    auto& device = context->eigen_sycl_device();
+    Tensor x_float, y_float, out_float;
+    OP_REQUIRES_OK(context,
+                   context->allocate_temp(DT_FLOAT, in_x.shape(), &x_float));
+    OP_REQUIRES_OK(context,
+                   context->allocate_temp(DT_FLOAT, in_y.shape(), &y_float));
+    OP_REQUIRES_OK(context, context->allocate_temp(DT_FLOAT, out->shape(),
+                                                   &out_float));
+    x_float.flat<float>().device(device) =
+        in_x.flat<Eigen::half>().cast<float>();
+    y_float.flat<float>().device(device) =
+        in_y.flat<Eigen::half>().cast<float>();
+    LaunchBatchMatMul<SYCLDevice, float>::Launch(context, x_float, y_float,
+                                                 adj_x, adj_y, &out_float);
+    out->flat<Eigen::half>().device(device) =
+        out_float.flat<float>().cast<Eigen::half>();
+  }
+};
+#endif  // TENSORFLOW_SYCL_NO_HALF
 #endif  // TENSORFLOW_USE_SYCL
 
 template <typename Device, typename Scalar>
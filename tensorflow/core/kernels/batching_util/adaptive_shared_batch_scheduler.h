@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_ADAPTIVE_SHARED_BATCH_SCHEDULER_H_
 
 #include <algorithm>
+#include <cmath>
 #include <functional>
 #include <memory>
 #include <random>
@@ -69,6 +70,17 @@ class ASBSQueue;
 // CPU utilization - If the batch processing is cpu dominated, you can reap
 //   latency gains when underutilized by increasing the processing rate, but
 //   back the rate off when the load increases to avoid overload.
+//
+// Alternatively, ASBS can target a latency SLO (see
+// Options::latency_slo_micros).  All batch threads are then used, and instead
+// of tuning in_flight_batches_limit_, the scheduler chooses per queue the size
+// at which a batch is scheduled (among QueueOptions::allowed_batch_sizes) and
+// how long a smaller batch may wait for more tasks.  It learns the batch
+// processing time per batch size, along with the time ready batches wait for a
+// batch thread, and picks the largest batch size whose 99th percentile
+// processing and wait time fits in the SLO.  The rest of the SLO is the
+// batching timeout.  This maximizes throughput subject to the SLO, also under
+// bursty load.
 
 template <typename TaskType>
 class AdaptiveSharedBatchScheduler
@@ -77,6 +89,7 @@ class AdaptiveSharedBatchScheduler
  public:
   ~AdaptiveSharedBatchScheduler() {
     // Finish processing batches before destroying other class members.
+    batch_timeout_enforcer_.reset();
     batch_thread_pool_.reset();
   }
 
@@ -110,8 +123,15 @@ class AdaptiveSharedBatchScheduler
     double initial_in_flight_batches_limit = 3;
     // Number of batches between adjustments of in_flight_batches_limit.  Larger
     // numbers will give less noisy latency measurements, but will be less
-    // responsive to changes in workload.
+    // responsive to changes in workload.  In latency SLO mode, the number of
+    // batches the processing and wait time estimates are averaged over.
     int64 batches_to_average_over = 1000;
+    // If positive, the 99th percentile latency to target, from the creation of
+    // a batch (i.e. the arrival of its oldest task) until the end of its
+    // processing.  In this mode in_flight_batches_limit_ is fixed at
+    // num_batch_threads, and the batch size and batching timeout are adapted
+    // instead (see above).
+    int64 latency_slo_micros = 0;
   };
 
   // Ownership is shared between the caller of Create() and any queues created
@@ -125,6 +145,11 @@ class AdaptiveSharedBatchScheduler
     int max_batch_size = 1000;
     // Maximum number of enqueued (i.e. non-scheduled) batches.
     int max_enqueued_batches = 10;
+    // The batch sizes the scheduler may target in latency SLO mode, e.g. the
+    // sizes batches are padded to by their processor.  Must be increasing,
+    // with the last entry equal to max_batch_size.  If empty, only
+    // max_batch_size is targeted, and just the batching timeout is adapted.
+    std::vector<int> allowed_batch_sizes;
   };
 
   using BatchProcessor = std::function<void(std::unique_ptr<Batch<TaskType>>)>;
@@ -145,12 +170,58 @@ class AdaptiveSharedBatchScheduler
 
   explicit AdaptiveSharedBatchScheduler(const Options& options);
 
-  // Tracks processing latency and adjusts in_flight_batches_limit to minimize.
+  // Running estimate of the distribution of a latency, averaging over
+  // (roughly) the last Options::batches_to_average_over samples.
+  struct LatencyEstimate {
+    int64 count = 0;
+    double mean_micros = 0;
+    double variance = 0;
+
+    void Add(double micros, int64 window);
+
+    // 99th percentile, assuming a normal distribution.
+    double P99Micros() const {
+      return mean_micros + 2.326 * std::sqrt(variance);
+    }
+  };
+
+  // Model of a queue's batch processing time, for latency SLO mode.
+  struct QueueLatencyModel {
+    // The batch sizes the queue may target, in increasing order.
+    std::vector<int> batch_sizes;
+    // Processing time of batches, by the smallest entry of batch_sizes they
+    // fit in.
+    std::vector<LatencyEstimate> processing;
+  };
+
+  // Tracks processing latency and adjusts in_flight_batches_limit to minimize,
+  // or updates the latency models in latency SLO mode.
   void CallbackWrapper(const internal::ASBSBatch<TaskType>* batch,
                        BatchProcessor callback);
 
-  // Schedules batch if in_flight_batches_limit_ is not met.
-  void MaybeScheduleNextBatch() EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Returns whether 'batch' may be scheduled at time 'now_micros'.
+  static bool IsReady(const internal::ASBSBatch<TaskType>& batch,
+                      int64 now_micros);
+
+  // Schedules batch if in_flight_batches_limit_ is not met. Returns whether a
+  // batch was scheduled.
+  bool MaybeScheduleNextBatch() EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Schedules ready batches until none is left or in_flight_batches_limit_ is
+  // met.
+  void ScheduleReadyBatches();
+
+  // In latency SLO mode, returns the target size and the batching timeout for
+  // a new batch of 'queue'.  Otherwise leaves them untouched.
+  void GetBatchingParams(const internal::ASBSQueue<TaskType>* queue,
+                         int* target_batch_size, int64* timeout_micros);
+
+  // Estimated 99th percentile processing time of a batch of size
+  // model.batch_sizes[i], or -1 if nothing is known yet.  Sizes without samples
+  // are scaled linearly from the nearest smaller size with samples, erring on
+  // the side of smaller batches.
+  static double EstimateP99ProcessingMicros(const QueueLatencyModel& model,
+                                            int i);
 
   // Notifies scheduler of non-empty batch which is eligible for processing.
   void AddBatch(const internal::ASBSBatch<TaskType>* batch);
@@ -160,6 +231,8 @@ class AdaptiveSharedBatchScheduler
 
   Env* GetEnv() const { return options_.env; }
 
+  bool latency_slo_mode() const { return options_.latency_slo_micros > 0; }
+
   const Options options_;
 
   // Collection of batches added by AddBatch, ordered by age. Owned by scheduler
@@ -170,11 +243,21 @@ class AdaptiveSharedBatchScheduler
   std::unordered_map<const internal::ASBSQueue<TaskType>*, BatchProcessor>
       queues_and_callbacks_ GUARDED_BY(mu_);
 
+  // Latency models of the queues added by AddQueue, in latency SLO mode.
+  std::unordered_map<const internal::ASBSQueue<TaskType>*, QueueLatencyModel>
+      queue_latency_models_ GUARDED_BY(mu_);
+
+  // Time ready batches wait for a batch thread, in latency SLO mode.
+  LatencyEstimate ready_batch_wait_ GUARDED_BY(mu_);
+
   mutex mu_;
 
   // Responsible for running the batch processing callbacks.
   std::unique_ptr<thread::ThreadPool> batch_thread_pool_;
 
+  // In latency SLO mode, schedules batches whose batching timeout expired.
+  std::unique_ptr<PeriodicFunction> batch_timeout_enforcer_;
+
   // Limit on number of batches which can be concurrently processed.
   // Non-integer values correspond to probabilistic limits - i.e. a value of 3.2
   // results in an actual cap of 3 80% of the time, and 4 20% of the time.
@@ -204,6 +287,8 @@ class AdaptiveSharedBatchScheduler
   constexpr static double kMinStepSizeMultiplier = 0.0078125;  // 1/128
   // Current adjustment size (as a fraction of in_flight_batches_limit_).
   double step_size_multiplier_ GUARDED_BY(mu_) = kMaxStepSizeMultiplier;
+  // Number of times per latency SLO that expired batching timeouts are checked.
+  static constexpr int64 kTimeoutChecksPerLatencySlo = 100;
 
   TF_DISALLOW_COPY_AND_ASSIGN(AdaptiveSharedBatchScheduler);
 };
@@ -253,12 +338,17 @@ class ASBSQueue : public BatchScheduler<TaskType> {
   TF_DISALLOW_COPY_AND_ASSIGN(ASBSQueue);
 };
 
-// Batch which remembers when and by whom it was created.
+// Batch which remembers when and by whom it was created, and when it may be
+// scheduled: once it reaches target_size or once timeout_micros have passed.
 template <typename TaskType>
 class ASBSBatch : public Batch<TaskType> {
  public:
-  ASBSBatch(ASBSQueue<TaskType>* queue, int64 creation_time_micros)
-      : queue_(queue), creation_time_micros_(creation_time_micros) {}
+  ASBSBatch(ASBSQueue<TaskType>* queue, int64 creation_time_micros,
+            int target_size, int64 timeout_micros)
+      : queue_(queue),
+        creation_time_micros_(creation_time_micros),
+        target_size_(target_size),
+        timeout_micros_(timeout_micros) {}
 
   ~ASBSBatch() override {}
 
@@ -266,9 +356,23 @@ class ASBSBatch : public Batch<TaskType> {
 
   int64 creation_time_micros() const { return creation_time_micros_; }
 
+  int target_size() const { return target_size_; }
+
+  int64 timeout_micros() const { return timeout_micros_; }
+
+  // When the scheduler first saw the batch ready, or -1.  Only accessed by
+  // the scheduler, under its lock.
+  int64 ready_time_micros() const { return ready_time_micros_; }
+  void set_ready_time_micros(int64 micros) const {
+    ready_time_micros_ = micros;
+  }
+
  private:
   ASBSQueue<TaskType>* queue_;
   const int64 creation_time_micros_;
+  const int target_size_;
+  const int64 timeout_micros_;
+  mutable int64 ready_time_micros_ = -1;
   TF_DISALLOW_COPY_AND_ASSIGN(ASBSBatch);
 };
 }  // namespace internal
@@ -281,6 +385,10 @@ constexpr double AdaptiveSharedBatchScheduler<TaskType>::kMaxStepSizeMultiplier;
 template <typename TaskType>
 constexpr double AdaptiveSharedBatchScheduler<TaskType>::kMinStepSizeMultiplier;
 
+template <typename TaskType>
+constexpr int64
+    AdaptiveSharedBatchScheduler<TaskType>::kTimeoutChecksPerLatencySlo;
+
 template <typename TaskType>
 Status AdaptiveSharedBatchScheduler<TaskType>::Create(
     const Options& options,
@@ -324,6 +432,11 @@ Status AdaptiveSharedBatchScheduler<TaskType>::Create(
         "greater than or equal to 1; was ",
         options.batches_to_average_over);
   }
+  if (options.latency_slo_micros < 0) {
+    return errors::InvalidArgument(
+        "latency_slo_micros can't be negative; was ",
+        options.latency_slo_micros);
+  }
   scheduler->reset(new AdaptiveSharedBatchScheduler<TaskType>(options));
   return Status::OK();
 }
@@ -332,12 +445,24 @@ template <typename TaskType>
 AdaptiveSharedBatchScheduler<TaskType>::AdaptiveSharedBatchScheduler(
     const Options& options)
     : options_(options),
-      in_flight_batches_limit_(options.initial_in_flight_batches_limit),
+      in_flight_batches_limit_(options.latency_slo_micros > 0
+                                   ? options.num_batch_threads
+                                   : options.initial_in_flight_batches_limit),
       rand_double_(0.0, 1.0) {
   std::random_device device;
   rand_engine_.seed(device());
   batch_thread_pool_.reset(new thread::ThreadPool(
       GetEnv(), options.thread_pool_name, options.num_batch_threads));
+  if (latency_slo_mode()) {
+    PeriodicFunction::Options periodic_options;
+    periodic_options.env = GetEnv();
+    periodic_options.thread_name_prefix = "batch_timeout_enforcer";
+    batch_timeout_enforcer_.reset(new PeriodicFunction(
+        [this] { ScheduleReadyBatches(); },
+        std::max(int64{1},
+                 options.latency_slo_micros / kTimeoutChecksPerLatencySlo),
+        periodic_options));
+  }
 }
 
 template <typename TaskType>
@@ -353,11 +478,33 @@ Status AdaptiveSharedBatchScheduler<TaskType>::AddQueue(
         "max_enqueued_batches must be positive; was ",
         options.max_enqueued_batches);
   }
+  const std::vector<int>& allowed_batch_sizes = options.allowed_batch_sizes;
+  for (size_t i = 0; i < allowed_batch_sizes.size(); ++i) {
+    if (allowed_batch_sizes[i] <= 0 ||
+        (i > 0 && allowed_batch_sizes[i] <= allowed_batch_sizes[i - 1])) {
+      return errors::InvalidArgument(
+          "allowed_batch_sizes entries must be positive and monotonically "
+          "increasing");
+    }
+  }
+  if (!allowed_batch_sizes.empty() &&
+      allowed_batch_sizes.back() != options.max_batch_size) {
+    return errors::InvalidArgument(
+        "final entry in allowed_batch_sizes must equal max_batch_size");
+  }
   internal::ASBSQueue<TaskType>* asbs_queue_raw;
   queue->reset(asbs_queue_raw = new internal::ASBSQueue<TaskType>(
                    this->shared_from_this(), options));
   mutex_lock l(mu_);
   queues_and_callbacks_[asbs_queue_raw] = process_batch_callback;
+  if (latency_slo_mode()) {
+    QueueLatencyModel& model = queue_latency_models_[asbs_queue_raw];
+    model.batch_sizes = allowed_batch_sizes;
+    if (model.batch_sizes.empty()) {
+      model.batch_sizes.push_back(options.max_batch_size);
+    }
+    model.processing.resize(model.batch_sizes.size());
+  }
   return Status::OK();
 }
 
@@ -374,41 +521,129 @@ void AdaptiveSharedBatchScheduler<TaskType>::RemoveQueue(
     const internal::ASBSQueue<TaskType>* queue) {
   mutex_lock l(mu_);
   queues_and_callbacks_.erase(queue);
+  queue_latency_models_.erase(queue);
 }
 
 template <typename TaskType>
-void AdaptiveSharedBatchScheduler<TaskType>::MaybeScheduleNextBatch() {
+bool AdaptiveSharedBatchScheduler<TaskType>::IsReady(
+    const internal::ASBSBatch<TaskType>& batch, int64 now_micros) {
+  return batch.size() >= batch.target_size() || batch.IsClosed() ||
+         now_micros - batch.creation_time_micros() >= batch.timeout_micros();
+}
+
+template <typename TaskType>
+bool AdaptiveSharedBatchScheduler<TaskType>::MaybeScheduleNextBatch() {
+  const int64 now_micros = GetEnv()->NowMicros();
+  if (latency_slo_mode()) {
+    // Note when batches become ready, to learn how long they wait.
+    for (const internal::ASBSBatch<TaskType>* batch : batches_) {
+      if (batch->ready_time_micros() < 0 && IsReady(*batch, now_micros)) {
+        batch->set_ready_time_micros(now_micros);
+      }
+    }
+  }
   if (batches_.empty() || in_flight_batches_ >= in_flight_batches_limit_)
-    return;
+    return false;
   // Non-integer limit handled probabilistially.
   if (in_flight_batches_limit_ - in_flight_batches_ < 1 &&
       rand_double_(rand_engine_) >
           in_flight_batches_limit_ - in_flight_batches_) {
-    return;
+    return false;
   }
-  auto best_it = batches_.begin();
-  double best_score =
-      (*best_it)->creation_time_micros() -
-      options_.full_batch_scheduling_boost_micros * (*best_it)->size() /
-          static_cast<double>((*best_it)->queue()->max_task_size());
-  for (auto it = batches_.begin() + 1; it != batches_.end(); it++) {
+  auto best_it = batches_.end();
+  double best_score = 0;
+  for (auto it = batches_.begin(); it != batches_.end(); it++) {
+    if (!IsReady(**it, now_micros)) continue;
     const double score =
         (*it)->creation_time_micros() -
         options_.full_batch_scheduling_boost_micros * (*it)->size() /
             static_cast<double>((*it)->queue()->max_task_size());
-    if (score < best_score) {
+    if (best_it == batches_.end() || score < best_score) {
       best_score = score;
       best_it = it;
     }
   }
+  if (best_it == batches_.end()) return false;
   const internal::ASBSBatch<TaskType>* batch = *best_it;
   batches_.erase(best_it);
+  if (latency_slo_mode()) {
+    ready_batch_wait_.Add(now_micros - batch->ready_time_micros(),
+                          options_.batches_to_average_over);
+  }
   // Queue may destroy itself after ReleaseBatch is called.
   batch->queue()->ReleaseBatch(batch);
   batch_thread_pool_->Schedule(
       std::bind(&AdaptiveSharedBatchScheduler<TaskType>::CallbackWrapper, this,
                 batch, queues_and_callbacks_[batch->queue()]));
   in_flight_batches_++;
+  return true;
+}
+
+template <typename TaskType>
+void AdaptiveSharedBatchScheduler<TaskType>::ScheduleReadyBatches() {
+  mutex_lock l(mu_);
+  while (MaybeScheduleNextBatch()) {
+  }
+}
+
+template <typename TaskType>
+void AdaptiveSharedBatchScheduler<TaskType>::LatencyEstimate::Add(
+    double micros, int64 window) {
+  // An exponentially weighted mean and variance, which start out as the plain
+  // mean and variance of the first 'window' samples.
+  if (count < window) ++count;
+  const double weight = 1.0 / count;
+  const double delta = micros - mean_micros;
+  mean_micros += weight * delta;
+  variance = (1 - weight) * (variance + weight * delta * delta);
+}
+
+template <typename TaskType>
+double AdaptiveSharedBatchScheduler<TaskType>::EstimateP99ProcessingMicros(
+    const QueueLatencyModel& model, int i) {
+  for (int j = i; j >= 0; --j) {
+    if (model.processing[j].count > 0) {
+      return model.processing[j].P99Micros() * model.batch_sizes[i] /
+             model.batch_sizes[j];
+    }
+  }
+  // Smaller batches don't take longer than larger ones.
+  for (int j = i + 1; j < model.batch_sizes.size(); ++j) {
+    if (model.processing[j].count > 0) {
+      return model.processing[j].P99Micros();
+    }
+  }
+  return -1;
+}
+
+template <typename TaskType>
+void AdaptiveSharedBatchScheduler<TaskType>::GetBatchingParams(
+    const internal::ASBSQueue<TaskType>* queue, int* target_batch_size,
+    int64* timeout_micros) {
+  if (!latency_slo_mode()) return;
+  mutex_lock l(mu_);
+  auto it = queue_latency_models_.find(queue);
+  if (it == queue_latency_models_.end()) return;
+  const QueueLatencyModel& model = it->second;
+  const double wait_micros =
+      ready_batch_wait_.count > 0 ? ready_batch_wait_.P99Micros() : 0;
+  // Until some batch has been processed, schedule batches as soon as possible
+  // (as without an SLO) to learn their processing time.
+  *target_batch_size = model.batch_sizes.back();
+  *timeout_micros = 0;
+  // Otherwise pick the largest batch size that fits in the SLO, and spend the
+  // rest of the SLO waiting for tasks.
+  for (int i = model.batch_sizes.size() - 1; i >= 0; --i) {
+    const double processing_micros = EstimateP99ProcessingMicros(model, i);
+    if (processing_micros < 0) return;
+    const double slack_micros =
+        options_.latency_slo_micros - processing_micros - wait_micros;
+    if (slack_micros >= 0 || i == 0) {
+      *target_batch_size = model.batch_sizes[i];
+      *timeout_micros = std::max(0.0, slack_micros);
+      return;
+    }
+  }
 }
 
 template <typename TaskType>
@@ -416,11 +651,30 @@ void AdaptiveSharedBatchScheduler<TaskType>::CallbackWrapper(
     const internal::ASBSBatch<TaskType>* batch,
     AdaptiveSharedBatchScheduler<TaskType>::BatchProcessor callback) {
   int64 start_time = batch->creation_time_micros();
+  const int64 processing_start_time = GetEnv()->NowMicros();
+  const internal::ASBSQueue<TaskType>* queue = batch->queue();
+  const size_t batch_size = batch->size();
   callback(std::unique_ptr<Batch<TaskType>>(
       const_cast<internal::ASBSBatch<TaskType>*>(batch)));
   int64 end_time = GetEnv()->NowMicros();
   mutex_lock l(mu_);
   in_flight_batches_--;
+  if (latency_slo_mode()) {
+    // The queue may be gone already, together with its model.
+    auto it = queue_latency_models_.find(queue);
+    if (it != queue_latency_models_.end()) {
+      QueueLatencyModel& model = it->second;
+      const int i = std::min<int>(
+          std::lower_bound(model.batch_sizes.begin(), model.batch_sizes.end(),
+                           batch_size) -
+              model.batch_sizes.begin(),
+          model.batch_sizes.size() - 1);
+      model.processing[i].Add(end_time - processing_start_time,
+                              options_.batches_to_average_over);
+    }
+    MaybeScheduleNextBatch();
+    return;
+  }
   batch_count_++;
   batch_latency_sum_ += end_time - start_time;
   // Occasionally adjust in_flight_batches_limit_ to minimize average latency.
@@ -496,11 +750,16 @@ Status ASBSQueue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
                                    " is larger than maximum batch size ",
                                    options_.max_batch_size);
   }
+  int target_batch_size = options_.max_batch_size;
+  int64 batch_timeout_micros = 0;
+  scheduler_->GetBatchingParams(this, &target_batch_size,
+                                &batch_timeout_micros);
+  bool batch_filled_early = false;
   {
     mutex_lock l(mu_);
     // Current batch is full, create another if allowed.
     if (current_batch_ &&
-        current_batch_->size() + size > options_.max_batch_size) {
+        current_batch_->size() + size > current_batch_->target_size()) {
       if (num_enqueued_batches_ >= options_.max_enqueued_batches) {
         return errors::Unavailable("The batch scheduling queue is full");
       }
@@ -509,14 +768,23 @@ Status ASBSQueue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
     }
     if (!current_batch_) {
       num_enqueued_batches_++;
-      current_batch_ = new_batch =
-          new ASBSBatch<TaskType>(this, scheduler_->GetEnv()->NowMicros());
+      current_batch_ = new_batch = new ASBSBatch<TaskType>(
+          this, scheduler_->GetEnv()->NowMicros(), target_batch_size,
+          batch_timeout_micros);
     }
     current_batch_->AddTask(std::move(*task));
     num_enqueued_tasks_++;
+    batch_filled_early =
+        current_batch_->timeout_micros() > 0 &&
+        current_batch_->size() >= current_batch_->target_size();
   }
   // AddBatch must be called outside of lock, since it may call ReleaseBatch.
-  if (new_batch != nullptr) scheduler_->AddBatch(new_batch);
+  if (new_batch != nullptr) {
+    scheduler_->AddBatch(new_batch);
+  } else if (batch_filled_early) {
+    // The batch reached its target size before its timeout.
+    scheduler_->ScheduleReadyBatches();
+  }
   return Status::OK();
 }
 
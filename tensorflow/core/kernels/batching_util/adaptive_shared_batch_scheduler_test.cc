@@ -92,6 +92,25 @@ TEST(AdaptiveSharedBatchSchedulerTest, BadOptions) {
   options.min_in_flight_batches_limit = 2;
   options.num_batch_threads = 3;
   EXPECT_FALSE(Scheduler::Create(options, &scheduler).ok());
+  options = Scheduler::Options();
+  options.latency_slo_micros = -1;
+  EXPECT_FALSE(Scheduler::Create(options, &scheduler).ok());
+}
+
+TEST(AdaptiveSharedBatchSchedulerTest, BadQueueOptions) {
+  using Scheduler = AdaptiveSharedBatchScheduler<FakeTask>;
+  std::shared_ptr<Scheduler> scheduler;
+  Scheduler::Options options;
+  options.initial_in_flight_batches_limit = 1;
+  TF_ASSERT_OK(Scheduler::Create(options, &scheduler));
+  auto queue_callback = [](std::unique_ptr<Batch<FakeTask>> batch) {};
+  std::unique_ptr<BatchScheduler<FakeTask>> queue;
+  Scheduler::QueueOptions queue_options;
+  queue_options.max_batch_size = 4;
+  queue_options.allowed_batch_sizes = {2, 1, 4};
+  EXPECT_FALSE(scheduler->AddQueue(queue_options, queue_callback, &queue).ok());
+  queue_options.allowed_batch_sizes = {1, 2};
+  EXPECT_FALSE(scheduler->AddQueue(queue_options, queue_callback, &queue).ok());
 }
 
 TEST(AdaptiveSharedBatchSchedulerTest, InFlightBatchesLimit) {
@@ -192,6 +211,74 @@ TEST(AdaptiveSharedBatchSchedulerTest, InFlightBatchesLimitTuning) {
   stop_teardown.Notify();
 }
 
+TEST(AdaptiveSharedBatchSchedulerTest, LatencySlo) {
+  test_util::FakeClockEnv env(Env::Default());
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+  {
+    AdaptiveSharedBatchScheduler<FakeTask>::Options options;
+    options.env = &env;
+    options.num_batch_threads = 1;
+    options.initial_in_flight_batches_limit = 1;
+    options.batches_to_average_over = 1;
+    options.latency_slo_micros = 350;
+    mutex mu;
+    std::vector<int> batch_sizes;
+    auto queue_callback = [&env, &mu, &batch_sizes](
+                              std::unique_ptr<Batch<FakeTask>> batch) {
+      ASSERT_TRUE(batch->IsClosed());
+      // Processing takes 100us per task.
+      env.AdvanceByMicroseconds(100 * batch->size());
+      mutex_lock l(mu);
+      batch_sizes.push_back(batch->size());
+    };
+    auto num_batches = [&mu, &batch_sizes]() {
+      mutex_lock l(mu);
+      return batch_sizes.size();
+    };
+    std::shared_ptr<AdaptiveSharedBatchScheduler<FakeTask>> scheduler;
+    TF_ASSERT_OK(
+        AdaptiveSharedBatchScheduler<FakeTask>::Create(options, &scheduler));
+    AdaptiveSharedBatchScheduler<FakeTask>::QueueOptions queue_options;
+    queue_options.max_batch_size = 4;
+    queue_options.allowed_batch_sizes = {1, 2, 4};
+    std::unique_ptr<BatchScheduler<FakeTask>> queue;
+    TF_ASSERT_OK(scheduler->AddQueue(queue_options, queue_callback, &queue));
+
+    // Nothing is known about the processing time yet, so the first batch is
+    // processed immediately.
+    TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+    while (num_batches() < 1) {
+    }
+
+    // Batches of 4 would take 400us, over the SLO. Batches of 2 take 200us,
+    // so they are processed once full, or after a 150us timeout.
+    TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+    Env::Default()->SleepForMicroseconds(1000);
+    EXPECT_EQ(num_batches(), 1);
+    TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+    while (num_batches() < 2) {
+    }
+
+    TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+    env.AdvanceByMicroseconds(149);
+    Env::Default()->SleepForMicroseconds(1000);
+    EXPECT_EQ(num_batches(), 2);
+    // Past the timeout, and the next check for it.
+    env.AdvanceByMicroseconds(10);
+    while (num_batches() < 3) {
+    }
+
+    {
+      mutex_lock l(mu);
+      EXPECT_EQ(batch_sizes, std::vector<int>({1, 2, 1}));
+    }
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
 TEST(AdaptiveSharedBatchSchedulerTest, FullBatchSchedulingBoostMicros) {
   test_util::FakeClockEnv env(Env::Default());
   Notification start_teardown, stop_teardown;
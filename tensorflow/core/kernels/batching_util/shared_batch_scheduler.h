@@ -17,11 +17,16 @@ limitations under the License.
 #define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_SHARED_BATCH_SCHEDULER_H_
 
 #include <stddef.h>
+#include <algorithm>
+#include <atomic>
 #include <deque>
 #include <functional>
+#include <iterator>
+#include <limits>
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -41,6 +46,9 @@ namespace serving {
 namespace internal {
 template <typename TaskType>
 class Queue;
+
+template <typename TaskType>
+class QueueHandle;
 }  // namespace internal
 }  // namespace serving
 }  // namespace tensorflow
@@ -75,6 +83,18 @@ namespace serving {
 // BasicBatchScheduler instance, in the sense that it has maximum batch size and
 // timeout parameters, which govern when a batch is eligible to be processed.
 //
+// The servicing policy can be tuned per queue (see QueueOptions):
+//  - Queues belong to strict priority classes. A batch thread only takes a
+//    batch from a queue if no higher-priority queue has a batch eligible.
+//  - Within a priority class, batches with a deadline are processed earliest
+//    deadline first, ahead of batches without one. Batches being processed are
+//    never preempted.
+//  - Otherwise, queues are serviced in proportion to their weights, e.g. with
+//    queues A and B having weights 1 and 2, the servicing pattern is ABBABB...
+//    A queue that was idle does not get to catch up on its share.
+//  - While higher-priority queues have at least as many eligible batches as
+//    there are batch threads, lower-priority queues shed new tasks.
+//
 // Each queue is independently configured with a maximum size (in terms of the
 // maximum number of batches worth of enqueued tasks). For online serving, it is
 // recommended that the queue sizes be configured such that the sum of the sizes
@@ -91,11 +111,6 @@ namespace serving {
 // For bulk processing jobs and throughput-oriented benchmarks, you may want to
 // set the maximum queue size to a large value.
 //
-// TODO(b/26539183): Support queue servicing policies other than round-robin.
-// E.g. let each queue specify a "share" (an int >= 1), so e.g. with queues A
-// and B having shares 1 and 2 respectively, the servicing pattern is ABBABB...
-//
-//
 // PERFORMANCE TUNING: See README.md.
 //
 template <typename TaskType>
@@ -158,6 +173,19 @@ class SharedBatchScheduler
     // See the class documentation above for guidelines on how to tune this
     // parameter.
     size_t max_enqueued_batches = 10;
+
+    // The queue's priority class. Queues with higher priorities are serviced
+    // first, and queues with lower priorities shed tasks first under overload.
+    int priority = 0;
+
+    // The queue's share of the batch threads relative to the other queues in
+    // its priority class. Must be >= 1.
+    int weight = 1;
+
+    // If positive, the time (in microseconds) from a task's arrival by which
+    // its batch should start processing. Batches with deadlines are scheduled
+    // earliest deadline first within their priority class.
+    int64 deadline_micros = 0;
   };
   Status AddQueue(const QueueOptions& options,
                   std::function<void(std::unique_ptr<Batch<TaskType>>)>
@@ -168,11 +196,19 @@ class SharedBatchScheduler
   explicit SharedBatchScheduler(const Options& options);
 
   // The code executed in 'batch_threads_'. Obtains a batch to process from the
-  // queue pointed to by 'next_queue_to_schedule_', and processes it. If that
-  // queue declines to provide a batch to process, moves onto the next queue. If
-  // no queues provide a batch to process, just sleeps briefly and exits.
+  // queue chosen by the servicing policy (see the class documentation), and
+  // processes it. Among equally good queues, the first one starting from
+  // 'next_queue_to_schedule_' is chosen. If no queues provide a batch to
+  // process, just sleeps briefly and exits.
   void ThreadLogic();
 
+  // Whether queues with a priority above 'priority' have at least
+  // 'num_batch_threads' batches eligible for processing, in which case queues
+  // of priority 'priority' shed new tasks.
+  bool IsOverloadedAbove(int priority);
+
+  friend class internal::QueueHandle<TaskType>;
+
   const Options options_;
 
   mutex mu_;
@@ -191,6 +227,20 @@ class SharedBatchScheduler
   // available batch thread should grab work.
   typename QueueList::iterator next_queue_to_schedule_ GUARDED_BY(mu_);
 
+  // The virtual time at which each queue is next due for a batch, by which
+  // queues of equal priority are serviced in proportion to their weights.
+  // Each batch a queue gets advances its virtual time by 1 / weight. Queues
+  // lagging behind 'virtual_time_' are brought forward to it.
+  std::unordered_map<const internal::Queue<TaskType>*, double>
+      queue_virtual_times_ GUARDED_BY(mu_);
+
+  // The virtual time of the last scheduled batch.
+  double virtual_time_ GUARDED_BY(mu_) = 0;
+
+  // The highest priority among the queues, for a fast path in
+  // IsOverloadedAbove().
+  std::atomic<int> max_queue_priority_{std::numeric_limits<int>::min()};
+
   // Used by idle batch threads to wait for work to enter the system. Notified
   // whenever a batch becomes schedulable.
   condition_variable schedulable_batch_cv_;
@@ -252,6 +302,17 @@ class Queue {
   // Returns the maximum allowed size of tasks submitted to the queue.
   size_t max_task_size() const { return options_.max_batch_size; }
 
+  int priority() const { return options_.priority; }
+  int weight() const { return options_.weight; }
+  int64 deadline_micros() const { return options_.deadline_micros; }
+
+  // Returns whether ScheduleBatch() would currently return a batch, and if so
+  // sets 'start_time_micros' to the time the batch's first task was added.
+  bool PeekBatch(uint64* start_time_micros) const;
+
+  // Returns the number of batches that are eligible to be scheduled.
+  int NumSchedulableBatches() const;
+
   // Called by a thread that is ready to process a batch, to request one from
   // this queue. Either returns a batch that is ready to be processed, or
   // nullptr if the queue declines to schedule a batch at this time. If it
@@ -312,6 +373,10 @@ class Queue {
   // in 'batches_'. Valid iff that batch contains at least one task.
   uint64 open_batch_start_time_micros_ GUARDED_BY(mu_);
 
+  // The times at which the first task was added to each of the closed batches
+  // in 'batches_', in the same order.
+  std::deque<uint64> closed_batch_start_times_micros_ GUARDED_BY(mu_);
+
   // Whether this queue contains a batch that is eligible to be scheduled. Used
   // to keep track of when to call 'schedulable_batch_callback_'.
   bool schedulable_batch_ GUARDED_BY(mu_) = false;
@@ -408,6 +473,14 @@ Status SharedBatchScheduler<TaskType>::AddQueue(
         "max_enqueued_batches must be non-negative; was ",
         options.max_enqueued_batches);
   }
+  if (options.weight < 1) {
+    return errors::InvalidArgument("weight must be positive; was ",
+                                   options.weight);
+  }
+  if (options.deadline_micros < 0) {
+    return errors::InvalidArgument(
+        "deadline_micros must be non-negative; was ", options.deadline_micros);
+  }
 
   auto schedulable_batch_callback = [this] {
     mutex_lock l(mu_);
@@ -426,6 +499,9 @@ Status SharedBatchScheduler<TaskType>::AddQueue(
     if (next_queue_to_schedule_ == queues_.end()) {
       next_queue_to_schedule_ = queues_.begin();
     }
+    if (options.priority > max_queue_priority_) {
+      max_queue_priority_ = options.priority;
+    }
   }
   *queue = std::move(handle);
   return Status::OK();
@@ -455,51 +531,104 @@ void SharedBatchScheduler<TaskType>::ThreadLogic() {
   {
     mutex_lock l(mu_);
 
+    // Find the queue to take a batch from. Queues are ranked by priority, then
+    // deadline, then virtual time.
+    auto best_queue = queues_.end();
+    int best_priority = 0;
+    uint64 best_deadline_micros = 0;
+    double best_virtual_time = 0;
+    auto it = next_queue_to_schedule_;
     const int num_queues = queues_.size();
-    for (int num_queues_tried = 0;
-         batch_to_process == nullptr && num_queues_tried < num_queues;
+    for (int num_queues_tried = 0; num_queues_tried < num_queues;
          ++num_queues_tried) {
-      DCHECK(next_queue_to_schedule_ != queues_.end());
+      DCHECK(it != queues_.end());
+      const internal::Queue<TaskType>* queue = it->get();
 
-      // If a closed queue responds to ScheduleBatch() with nullptr, the queue
-      // will never yield any further batches so we can drop it. To avoid a
+      // If a closed queue has no batch to schedule, the queue will never yield
+      // any further batches so we can drop it once it is empty. To avoid a
       // race, we take a snapshot of the queue's closedness state *before*
-      // calling ScheduleBatch().
-      const bool queue_closed = (*next_queue_to_schedule_)->closed();
-
-      // Ask '*next_queue_to_schedule_' if it wants us to process a batch.
-      batch_to_process = (*next_queue_to_schedule_)->ScheduleBatch();
-      if (batch_to_process != nullptr) {
-        queue_for_batch = next_queue_to_schedule_->get();
-      }
-
-      // Advance 'next_queue_to_schedule_'.
-      if (queue_closed && (*next_queue_to_schedule_)->IsEmpty() &&
-          batch_to_process == nullptr) {
+      // calling PeekBatch().
+      const bool queue_closed = queue->closed();
+
+      uint64 start_time_micros;
+      if (queue->PeekBatch(&start_time_micros)) {
+        const uint64 deadline_micros =
+            queue->deadline_micros() > 0
+                ? start_time_micros + queue->deadline_micros()
+                : std::numeric_limits<uint64>::max();
+        const double virtual_time =
+            std::max(queue_virtual_times_[queue], virtual_time_);
+        if (best_queue == queues_.end() || queue->priority() > best_priority ||
+            (queue->priority() == best_priority &&
+             (deadline_micros < best_deadline_micros ||
+              (deadline_micros == best_deadline_micros &&
+               virtual_time < best_virtual_time)))) {
+          best_queue = it;
+          best_priority = queue->priority();
+          best_deadline_micros = deadline_micros;
+          best_virtual_time = virtual_time;
+        }
+        ++it;
+      } else if (queue_closed && queue->IsEmpty()) {
         // We've encountered a closed queue with no work to do. Drop it.
-        DCHECK_NE(queue_for_batch, next_queue_to_schedule_->get());
-        next_queue_to_schedule_ = queues_.erase(next_queue_to_schedule_);
+        queue_virtual_times_.erase(queue);
+        const bool dropping_next_queue = it == next_queue_to_schedule_;
+        it = queues_.erase(it);
+        if (dropping_next_queue) {
+          next_queue_to_schedule_ = it;
+        }
       } else {
-        ++next_queue_to_schedule_;
+        ++it;
       }
-      if (next_queue_to_schedule_ == queues_.end() && !queues_.empty()) {
+      if (it == queues_.end() && !queues_.empty()) {
         // We've hit the end. Wrap to the first queue.
-        next_queue_to_schedule_ = queues_.begin();
+        it = queues_.begin();
       }
     }
+    if (next_queue_to_schedule_ == queues_.end()) {
+      next_queue_to_schedule_ = queues_.begin();
+    }
 
-    if (batch_to_process == nullptr) {
+    if (best_queue == queues_.end()) {
       // We couldn't find any work to do. Wait until a new batch becomes
       // schedulable, or some time has elapsed, before checking again.
       const int64 kTimeoutMillis = 1;  // The smallest accepted granule of time.
       WaitForMilliseconds(&l, &schedulable_batch_cv_, kTimeoutMillis);
       return;
     }
+
+    queue_for_batch = best_queue->get();
+    batch_to_process = queue_for_batch->ScheduleBatch();
+    DCHECK(batch_to_process != nullptr);
+    virtual_time_ = best_virtual_time;
+    queue_virtual_times_[queue_for_batch] =
+        best_virtual_time + 1.0 / queue_for_batch->weight();
+
+    // Advance 'next_queue_to_schedule_' past the chosen queue.
+    next_queue_to_schedule_ = std::next(best_queue);
+    if (next_queue_to_schedule_ == queues_.end()) {
+      next_queue_to_schedule_ = queues_.begin();
+    }
   }
 
   queue_for_batch->ProcessBatch(std::move(batch_to_process));
 }
 
+template <typename TaskType>
+bool SharedBatchScheduler<TaskType>::IsOverloadedAbove(int priority) {
+  if (priority >= max_queue_priority_) {
+    return false;
+  }
+  mutex_lock l(mu_);
+  int num_schedulable_batches = 0;
+  for (const auto& queue : queues_) {
+    if (queue->priority() > priority) {
+      num_schedulable_batches += queue->NumSchedulableBatches();
+    }
+  }
+  return num_schedulable_batches >= options_.num_batch_threads;
+}
+
 namespace internal {
 
 template <typename TaskType>
@@ -606,6 +735,7 @@ std::unique_ptr<Batch<TaskType>> Queue<TaskType>::ScheduleBatch() {
       ++num_batches_being_processed_;
       batch_to_schedule = std::move(batches_.front());
       batches_.pop_front();
+      closed_batch_start_times_micros_.pop_front();
     } else {
       schedulable_batch_ = false;
     }
@@ -614,6 +744,26 @@ std::unique_ptr<Batch<TaskType>> Queue<TaskType>::ScheduleBatch() {
   return batch_to_schedule;
 }
 
+template <typename TaskType>
+bool Queue<TaskType>::PeekBatch(uint64* start_time_micros) const {
+  mutex_lock l(mu_);
+  if (batches_.size() >= 2) {
+    *start_time_micros = closed_batch_start_times_micros_.front();
+    return true;
+  }
+  if (IsOpenBatchSchedulable()) {
+    *start_time_micros = open_batch_start_time_micros_;
+    return true;
+  }
+  return false;
+}
+
+template <typename TaskType>
+int Queue<TaskType>::NumSchedulableBatches() const {
+  mutex_lock l(mu_);
+  return batches_.size() - 1 + (IsOpenBatchSchedulable() ? 1 : 0);
+}
+
 template <typename TaskType>
 void Queue<TaskType>::ProcessBatch(std::unique_ptr<Batch<TaskType>> batch) {
   process_batch_callback_(std::move(batch));
@@ -657,6 +807,7 @@ bool Queue<TaskType>::IsEmptyInternal() const {
 
 template <typename TaskType>
 void Queue<TaskType>::StartNewBatch() {
+  closed_batch_start_times_micros_.push_back(open_batch_start_time_micros_);
   batches_.back()->Close();
   batches_.emplace_back(new Batch<TaskType>);
 }
@@ -685,6 +836,11 @@ QueueHandle<TaskType>::~QueueHandle() {
 
 template <typename TaskType>
 Status QueueHandle<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
+  if (scheduler_->IsOverloadedAbove(queue_->priority())) {
+    return errors::Unavailable(
+        "The batch scheduling queue to which this task was submitted is "
+        "shedding load, because higher-priority queues are overloaded");
+  }
   return queue_->Schedule(task);
 }
 
@@ -523,6 +523,122 @@ TEST(SharedBatchSchedulerTest, OneFullQueueDoesntBlockOtherQueues) {
   queue_0_proceed.Notify();
 }
 
+// Occupies the only batch thread of a scheduler, schedules a single-task batch
+// on queue 'i' for each 'i' in 'task_queues', and then lets the batches run.
+// The queues are created with 'queue_options'. Returns the indices of the
+// queues, in the order their batches were processed.
+std::vector<int> ProcessingOrder(
+    const std::vector<SharedBatchScheduler<FakeTask>::QueueOptions>&
+        queue_options,
+    const std::vector<int>& task_queues) {
+  SharedBatchScheduler<FakeTask>::Options options;
+  options.num_batch_threads = 1;
+  std::shared_ptr<SharedBatchScheduler<FakeTask>> scheduler;
+  TF_CHECK_OK(SharedBatchScheduler<FakeTask>::Create(options, &scheduler));
+
+  Notification blocking, proceed;
+  auto blocker_callback = [&blocking,
+                           &proceed](std::unique_ptr<Batch<FakeTask>> batch) {
+    blocking.Notify();
+    proceed.WaitForNotification();
+  };
+  std::unique_ptr<BatchScheduler<FakeTask>> blocker;
+  TF_CHECK_OK(scheduler->AddQueue({}, blocker_callback, &blocker));
+  TF_CHECK_OK(ScheduleTask(1000, blocker.get()));
+  blocking.WaitForNotification();
+
+  mutex mu;
+  std::vector<int> order;
+  std::vector<std::unique_ptr<BatchScheduler<FakeTask>>> queues(
+      queue_options.size());
+  for (int i = 0; i < queue_options.size(); ++i) {
+    SharedBatchScheduler<FakeTask>::QueueOptions options = queue_options[i];
+    options.max_batch_size = 1;
+    auto callback = [i, &mu, &order](std::unique_ptr<Batch<FakeTask>> batch) {
+      mutex_lock l(mu);
+      order.push_back(i);
+    };
+    TF_CHECK_OK(scheduler->AddQueue(options, callback, &queues[i]));
+  }
+  for (const int i : task_queues) {
+    TF_CHECK_OK(ScheduleTask(1, queues[i].get()));
+  }
+  proceed.Notify();
+  // Blocks until all the batches are processed.
+  queues.clear();
+  mutex_lock l(mu);
+  return order;
+}
+
+TEST(SharedBatchSchedulerTest, Priority) {
+  SharedBatchScheduler<FakeTask>::QueueOptions low_priority, high_priority;
+  high_priority.priority = 1;
+  EXPECT_EQ(ProcessingOrder({low_priority, high_priority}, {0, 0, 1, 1}),
+            std::vector<int>({1, 1, 0, 0}));
+}
+
+TEST(SharedBatchSchedulerTest, Weight) {
+  SharedBatchScheduler<FakeTask>::QueueOptions weight_1, weight_2;
+  weight_2.weight = 2;
+  EXPECT_EQ(ProcessingOrder({weight_1, weight_2}, {0, 0, 0, 1, 1, 1, 1, 1}),
+            std::vector<int>({0, 1, 1, 0, 1, 1, 0, 1}));
+}
+
+TEST(SharedBatchSchedulerTest, Deadline) {
+  SharedBatchScheduler<FakeTask>::QueueOptions no_deadline, long_deadline,
+      short_deadline;
+  long_deadline.deadline_micros = 10 * 1000 * 1000;
+  short_deadline.deadline_micros = 1;
+  EXPECT_EQ(ProcessingOrder({no_deadline, long_deadline, short_deadline},
+                            {0, 1, 2}),
+            std::vector<int>({2, 1, 0}));
+}
+
+TEST(SharedBatchSchedulerTest, LowPriorityQueueShedsUnderOverload) {
+  Notification high_priority_processing, high_priority_proceed;
+  auto high_priority_callback = [&high_priority_processing,
+                                 &high_priority_proceed](
+                                    std::unique_ptr<Batch<FakeTask>> batch) {
+    if (!high_priority_processing.HasBeenNotified()) {
+      high_priority_processing.Notify();
+      high_priority_proceed.WaitForNotification();
+    }
+  };
+  auto low_priority_callback = [](std::unique_ptr<Batch<FakeTask>> batch) {};
+
+  SharedBatchScheduler<FakeTask>::Options options;
+  options.num_batch_threads = 1;
+  std::shared_ptr<SharedBatchScheduler<FakeTask>> scheduler;
+  TF_ASSERT_OK(SharedBatchScheduler<FakeTask>::Create(options, &scheduler));
+  SharedBatchScheduler<FakeTask>::QueueOptions queue_options;
+  queue_options.max_batch_size = 1;
+  std::unique_ptr<BatchScheduler<FakeTask>> low_priority_queue;
+  TF_ASSERT_OK(scheduler->AddQueue(queue_options, low_priority_callback,
+                                   &low_priority_queue));
+  queue_options.priority = 1;
+  std::unique_ptr<BatchScheduler<FakeTask>> high_priority_queue;
+  TF_ASSERT_OK(scheduler->AddQueue(queue_options, high_priority_callback,
+                                   &high_priority_queue));
+
+  // Occupy the batch thread with high-priority work, with one more
+  // high-priority batch waiting for it.
+  TF_ASSERT_OK(ScheduleTask(1, high_priority_queue.get()));
+  high_priority_processing.WaitForNotification();
+  TF_ASSERT_OK(ScheduleTask(1, low_priority_queue.get()));
+  TF_ASSERT_OK(ScheduleTask(1, high_priority_queue.get()));
+  EXPECT_EQ(error::UNAVAILABLE,
+            ScheduleTask(1, low_priority_queue.get()).code());
+  EXPECT_EQ(1, low_priority_queue->NumEnqueuedTasks());
+
+  // Once the high-priority batches are done, low-priority tasks are accepted
+  // again.
+  high_priority_proceed.Notify();
+  while (high_priority_queue->NumEnqueuedTasks() > 0) {
+    Env::Default()->SleepForMicroseconds(100);
+  }
+  TF_EXPECT_OK(ScheduleTask(1, low_priority_queue.get()));
+}
+
 TEST(SharedBatchSchedulerTest, QueueDestructorBlocksUntilAllTasksProcessed) {
   test_util::FakeClockEnv env(Env::Default());
   Notification start_teardown, stop_teardown;
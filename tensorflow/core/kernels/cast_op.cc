@@ -58,13 +58,16 @@ CastOpBase::CastOpBase(OpKernelConstruction* ctx) : OpKernel(ctx) {
 }
 
 void CastOpBase::Compute(OpKernelContext* ctx) {
-  const Tensor& inp = ctx->input(0);
-  if (work_ == nullptr) {
-    ctx->set_output(0, inp);
-  } else {
-    Tensor* out = nullptr;
-    OP_REQUIRES_OK(ctx, ctx->allocate_output(0, inp.shape(), &out));
-    work_(ctx, inp, out);
+  // _GroupedCast casts each of its inputs.
+  for (int i = 0; i < ctx->num_inputs(); ++i) {
+    const Tensor& inp = ctx->input(i);
+    if (work_ == nullptr) {
+      ctx->set_output(i, inp);
+    } else {
+      Tensor* out = nullptr;
+      OP_REQUIRES_OK(ctx, ctx->allocate_output(i, inp.shape(), &out));
+      work_(ctx, inp, out);
+    }
   }
 }
 
@@ -167,6 +170,7 @@ class GpuCastOp : public CastOpBase {
 #undef CAST_CASE
 
 REGISTER_KERNEL_BUILDER(Name("Cast").Device(DEVICE_CPU), CpuCastOp);
+REGISTER_KERNEL_BUILDER(Name("_GroupedCast").Device(DEVICE_CPU), CpuCastOp);
 
 #if GOOGLE_CUDA
 #define REGISTER_CAST_GPU(srctype, dsttype)                    \
@@ -174,6 +178,11 @@ REGISTER_KERNEL_BUILDER(Name("Cast").Device(DEVICE_CPU), CpuCastOp);
                               .TypeConstraint<srctype>("SrcT") \
                               .TypeConstraint<dsttype>("DstT") \
                               .Device(DEVICE_GPU),             \
+                          GpuCastOp);                          \
+  REGISTER_KERNEL_BUILDER(Name("_GroupedCast")                 \
+                              .TypeConstraint<srctype>("SrcT") \
+                              .TypeConstraint<dsttype>("DstT") \
+                              .Device(DEVICE_GPU),             \
                           GpuCastOp)
 
 CURRY_TYPES2(REGISTER_CAST_GPU, bool);
@@ -244,6 +253,11 @@ class SyclCastOp : public CastOpBase {
                               .TypeConstraint<srctype>("SrcT") \
                               .TypeConstraint<dsttype>("DstT") \
                               .Device(DEVICE_SYCL),            \
+                          SyclCastOp);                         \
+  REGISTER_KERNEL_BUILDER(Name("_GroupedCast")                 \
+                              .TypeConstraint<srctype>("SrcT") \
+                              .TypeConstraint<dsttype>("DstT") \
+                              .Device(DEVICE_SYCL),            \
                           SyclCastOp)
 CURRY_TYPES2(REGISTER_CAST_SYCL, bool);
 CURRY_TYPES2(REGISTER_CAST_SYCL, uint8);
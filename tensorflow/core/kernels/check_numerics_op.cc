@@ -231,15 +231,19 @@ struct CheckNumericsKernel {
     cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read,
                        cl::sycl::access::target::global_buffer>;
 
-  CheckNumericsKernel(const read_accessor in, write_accessor out, Eigen::DenseIndex size)
+  CheckNumericsKernel(const read_accessor in, Eigen::DenseIndex in_offset,
+                      write_accessor out, Eigen::DenseIndex out_offset,
+                      Eigen::DenseIndex size)
     : in_(in)
+    , in_offset_(in_offset)
     , out_(out)
+    , out_offset_(out_offset)
     , size_(size)
   {}
   void operator()(cl::sycl::nd_item<1> item)
   {
-    const T* input = ConvertToActualTypeSycl(T, in_);
-    bool* output = ConvertToActualTypeSycl(bool, out_);
+    const T* input = ConvertToActualTypeSycl(T, in_) + in_offset_;
+    bool* output = ConvertToActualTypeSycl(bool, out_) + out_offset_;
 
     const auto curr_idx = item.get_global_id(0);
     // Check that kernel is not accessing value out of bound
@@ -254,7 +258,9 @@ struct CheckNumericsKernel {
   }
 private:
   const read_accessor in_;
+  const Eigen::DenseIndex in_offset_;
   write_accessor out_;
+  const Eigen::DenseIndex out_offset_;
   const Eigen::DenseIndex size_;
 };
 
@@ -289,8 +295,11 @@ class CheckNumericsOp<SYCLDevice, T> : public AsyncOpKernel {
     auto init = [this, abnormal_detected_out_ptr, &d]
         (cl::sycl::handler& cgh) {
       auto output_buffer = d.get_sycl_buffer(abnormal_detected_out_ptr);
+      // The buffer may hold other tensors, only the two flags are reset.
       auto output_acc = output_buffer.template get_access<
-                            cl::sycl::access::mode::discard_write>(cgh);
+                            cl::sycl::access::mode::discard_write>(
+          cgh, cl::sycl::range<1>(2 * sizeof(bool)),
+          cl::sycl::id<1>(d.get_offset(abnormal_detected_out_ptr)));
 
       // Initialize output to 0
       cgh.fill(output_acc, Eigen::buffer_scalar_t(false));
@@ -309,7 +318,12 @@ class CheckNumericsOp<SYCLDevice, T> : public AsyncOpKernel {
 
       // Write if any value was inf or nan to output
       cgh.parallel_for(SYCLUtil::get_nd_range(d, in.size()),
-          CheckNumericsKernel<T>{input_acc, output_acc, in.size()});
+          CheckNumericsKernel<T>{
+              input_acc, static_cast<Eigen::DenseIndex>(
+                             d.get_offset(in.data()) / sizeof(T)),
+              output_acc, static_cast<Eigen::DenseIndex>(
+                              d.get_offset(abnormal_detected_out_ptr)),
+              in.size()});
     };
     d.sycl_queue().submit(std::move(compute_cb));
 
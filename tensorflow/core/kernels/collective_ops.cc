@@ -155,6 +155,10 @@ REGISTER_KERNEL_BUILDER(Name("CollectiveReduce").Device(DEVICE_CPU),
                         CollectiveReduceOpKernel);
 REGISTER_KERNEL_BUILDER(Name("CollectiveReduce").Device(DEVICE_GPU),
                         CollectiveReduceOpKernel);
+#ifdef TENSORFLOW_USE_SYCL
+REGISTER_KERNEL_BUILDER(Name("CollectiveReduce").Device(DEVICE_SYCL),
+                        CollectiveReduceOpKernel);
+#endif  // TENSORFLOW_USE_SYCL
 
 class CollectiveBcastSendOpKernel : public CollectiveOpKernel {
  public:
@@ -211,6 +215,10 @@ REGISTER_KERNEL_BUILDER(Name("CollectiveBcastSend").Device(DEVICE_CPU),
                         CollectiveBcastSendOpKernel);
 REGISTER_KERNEL_BUILDER(Name("CollectiveBcastSend").Device(DEVICE_GPU),
                         CollectiveBcastSendOpKernel);
+#ifdef TENSORFLOW_USE_SYCL
+REGISTER_KERNEL_BUILDER(Name("CollectiveBcastSend").Device(DEVICE_SYCL),
+                        CollectiveBcastSendOpKernel);
+#endif  // TENSORFLOW_USE_SYCL
 
 class CollectiveBcastRecvOpKernel : public CollectiveOpKernel {
  public:
@@ -261,6 +269,10 @@ REGISTER_KERNEL_BUILDER(Name("CollectiveBcastRecv").Device(DEVICE_CPU),
                         CollectiveBcastRecvOpKernel);
 REGISTER_KERNEL_BUILDER(Name("CollectiveBcastRecv").Device(DEVICE_GPU),
                         CollectiveBcastRecvOpKernel);
+#ifdef TENSORFLOW_USE_SYCL
+REGISTER_KERNEL_BUILDER(Name("CollectiveBcastRecv").Device(DEVICE_SYCL),
+                        CollectiveBcastRecvOpKernel);
+#endif  // TENSORFLOW_USE_SYCL
 
 }  // namespace
 }  // namespace tensorflow
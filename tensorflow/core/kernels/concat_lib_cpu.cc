@@ -19,15 +19,23 @@ limitations under the License.
 #include <vector>
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/kernels/concat_lib.h"
+#include "tensorflow/core/kernels/streaming_copy.h"
 
 namespace tensorflow {
 
 namespace {
 template <typename T>
 struct MemCpyCopier {
+  // Whether to write the output with non-temporal stores.
+  bool streaming = false;
+
   inline void Copy(T* dst, const T* src, int input_index, size_t n) {
     if (DataTypeCanUseMemcpy(DataTypeToEnum<T>::v())) {
-      memcpy(dst, src, n * sizeof(T));
+      if (streaming) {
+        StreamingMemcpy(dst, src, n * sizeof(T));
+      } else {
+        memcpy(dst, src, n * sizeof(T));
+      }
     } else {
       for (size_t k = 0; k < n; ++k) {
         *dst++ = *src++;
@@ -57,8 +65,10 @@ void ConcatCPU(
     // use a large cost here to force strings to be handled by separate threads
     ConcatCPUImpl<T>(d, inputs, 100000, MemCpyCopier<T>(), output);
   } else {
-    ConcatCPUImpl<T>(d, inputs, sizeof(T) /* cost_per_unit */,
-                     MemCpyCopier<T>(), output);
+    MemCpyCopier<T> copier;
+    copier.streaming = output->size() * sizeof(T) >= kStreamingCopyMinBytes;
+    ConcatCPUImpl<T>(d, inputs, sizeof(T) /* cost_per_unit */, copier,
+                     output);
   }
 }
 
@@ -18,13 +18,15 @@ limitations under the License.
 #include <vector>
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/kernels/concat_lib.h"
+#include "tensorflow/core/kernels/streaming_copy.h"
 #include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
 // ElementCopier must be a struct with a single Copy function, which is passed
 // the output pointer, input pointer, input index, and number of elements to
-// copy from input to output.
+// copy from input to output. It may write with StreamingMemcpy(), whose stores
+// are fenced before this returns.
 template <typename T, typename ElementCopier>
 void ConcatCPUImpl(
     DeviceBase* d,
@@ -68,6 +70,7 @@ void ConcatCPUImpl(
         inp[j] += size;
       }
     }
+    StreamingCopyFence();
     return;
   }
 
@@ -122,8 +125,16 @@ void ConcatCPUImpl(
       }
     }
   };
-  Shard(worker_threads->num_threads, worker_threads->workers, output->size(),
-        cost_per_unit, work);
+  // Shard on whole cache lines of the output, which the allocator aligns, so
+  // that no two threads write to the same line.
+  const int64 total = output->size();
+  const int64 block_size = ElementsPerCacheLine<T>();
+  Shard(worker_threads->num_threads, worker_threads->workers,
+        (total + block_size - 1) / block_size, cost_per_unit * block_size,
+        [&work, total, block_size](int64 start, int64 end) {
+          work(start * block_size, std::min(end * block_size, total));
+          StreamingCopyFence();
+        });
 }
 
 #ifdef TENSORFLOW_USE_SYCL
@@ -37,6 +37,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/bounds_check.h"
 #include "tensorflow/core/kernels/conv_2d.h"
 #include "tensorflow/core/kernels/deep_conv2d.h"
+#include "tensorflow/core/kernels/fused_output_kernels.h"
 #include "tensorflow/core/kernels/ops_util.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
@@ -47,6 +48,7 @@ limitations under the License.
 #include "tensorflow/core/util/padding.h"
 #include "tensorflow/core/util/tensor_format.h"
 #include "tensorflow/core/util/use_cudnn.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 #ifdef TENSORFLOW_USE_LIBXSMM_CONVOLUTIONS
 #include "tensorflow/core/kernels/xsmm_conv2d.h"
@@ -59,6 +61,7 @@ limitations under the License.
 
 #ifdef TENSORFLOW_USE_SYCL
 #include "tensorflow/core/kernels/conv_ops_sycl.h"
+#include "tensorflow/core/kernels/cwise_ops_sycl_fused.h"
 #endif  // TENSORFLOW_USE_SYCL
 
 namespace tensorflow {
@@ -293,10 +296,33 @@ class LaunchXsmmConvOp<CPUDevice, float> {
 };
 #endif
 
+// Dimensions of a 2D convolution, computed by Conv2DOp from its inputs.
+struct Conv2DDimensions {
+  int batch;
+  int input_rows;
+  int input_cols;
+  int64 in_depth;
+  int filter_rows;
+  int filter_cols;
+  int64 patch_depth;
+  int out_depth;
+  int stride_rows;
+  int stride_cols;
+  int dilation_rows;
+  int dilation_cols;
+  int64 out_rows;
+  int64 out_cols;
+  int64 pad_rows;
+  int64 pad_cols;
+};
+
+// The input and output types are checked by the op definitions. Conv2DOp is
+// not a BinaryOp so that it can also implement _FusedConv2D, which takes
+// additional inputs.
 template <typename Device, typename T>
-class Conv2DOp : public BinaryOp<T> {
+class Conv2DOp : public OpKernel {
  public:
-  explicit Conv2DOp(OpKernelConstruction* context) : BinaryOp<T>(context) {
+  explicit Conv2DOp(OpKernelConstruction* context) : OpKernel(context) {
     OP_REQUIRES_OK(context, context->GetAttr("dilations", &dilations_));
     OP_REQUIRES_OK(context, context->GetAttr("strides", &strides_));
     string data_format;
@@ -440,35 +466,51 @@ class Conv2DOp : public BinaryOp<T> {
       return;
     }
 
+    const Conv2DDimensions dims = {
+        batch,       input_rows,   input_cols,    in_depth,
+        filter_rows, filter_cols,  patch_depth,   out_depth,
+        stride_rows, stride_cols,  dilation_rows, dilation_cols,
+        out_rows,    out_cols,     pad_rows,      pad_cols};
+    LaunchConv(context, input, filter, dims, output);
+  }
+
+ protected:
+  // Computes the convolution of input and filter into the allocated output.
+  virtual void LaunchConv(OpKernelContext* context, const Tensor& input,
+                          const Tensor& filter, const Conv2DDimensions& dims,
+                          Tensor* output) {
 #ifdef TENSORFLOW_USE_LIBXSMM_CONVOLUTIONS
     if (LaunchXsmmConvOp<Device, T>::Run(
-            context, input, filter, batch, input_rows, input_cols, in_depth,
-            filter_rows, filter_cols, pad_rows, pad_cols, out_rows, out_cols,
-            out_depth, dilation_rows, dilation_cols, stride_rows, stride_cols,
-            output, data_format_)) {
+            context, input, filter, dims.batch, dims.input_rows,
+            dims.input_cols, dims.in_depth, dims.filter_rows, dims.filter_cols,
+            dims.pad_rows, dims.pad_cols, dims.out_rows, dims.out_cols,
+            dims.out_depth, dims.dilation_rows, dims.dilation_cols,
+            dims.stride_rows, dims.stride_cols, output, data_format_)) {
       return;
     }
 #endif
 
     if (LaunchDeepConvOp<Device, T>::Run(
-            context, input, filter, batch, input_rows, input_cols, in_depth,
-            filter_rows, filter_cols, pad_rows, pad_cols, out_rows, out_cols,
-            out_depth, dilation_rows, dilation_cols, stride_rows, stride_cols,
-            output, data_format_)) {
+            context, input, filter, dims.batch, dims.input_rows,
+            dims.input_cols, dims.in_depth, dims.filter_rows, dims.filter_cols,
+            dims.pad_rows, dims.pad_cols, dims.out_rows, dims.out_cols,
+            dims.out_depth, dims.dilation_rows, dims.dilation_cols,
+            dims.stride_rows, dims.stride_cols, output, data_format_)) {
       return;
     }
 
     launcher_(context, use_cudnn_, cudnn_use_autotune_, input, filter,
-              dilation_rows, dilation_cols, stride_rows, stride_cols, padding_,
-              output, data_format_);
+              dims.dilation_rows, dims.dilation_cols, dims.stride_rows,
+              dims.stride_cols, padding_, output, data_format_);
   }
 
+  Padding padding_;
+  TensorFormat data_format_;
+
  private:
   std::vector<int32> dilations_;
   std::vector<int32> strides_;
   bool use_cudnn_;
-  Padding padding_;
-  TensorFormat data_format_;
   LaunchConv2DOp<Device, T> launcher_;
   bool cudnn_use_autotune_;
 
@@ -488,6 +530,121 @@ TF_CALL_float(REGISTER_CPU);
 TF_CALL_double(REGISTER_CPU);
 #endif  // USE_GEMM_FOR_CONV
 
+template <typename Device, typename T>
+class FusedConv2DOp;
+
+// Conv2D followed by a BiasAdd or an inference FusedBatchNorm, and optionally
+// by Relu, Relu6 or Elu, created by the remapper. The fused ops are applied to
+// blocks of the output by the thread that computed them, while they are still
+// in cache, instead of in separate passes over the whole output.
+template <typename T>
+class FusedConv2DOp<CPUDevice, T> : public Conv2DOp<CPUDevice, T> {
+ public:
+  explicit FusedConv2DOp(OpKernelConstruction* context)
+      : Conv2DOp<CPUDevice, T>(context) {
+    OP_REQUIRES_OK(context, ParseFusedOutputSpec(context, &spec_));
+  }
+
+ protected:
+  void LaunchConv(OpKernelContext* context, const Tensor& input,
+                  const Tensor& filter, const Conv2DDimensions& dims,
+                  Tensor* output) override {
+    OP_REQUIRES(context, this->data_format_ == FORMAT_NHWC,
+                errors::Unimplemented("Fused conv implementation only "
+                                      "supports NHWC tensor format for now."));
+    OP_REQUIRES(context, dims.in_depth == dims.patch_depth,
+                errors::Unimplemented("Fused conv implementation does not "
+                                      "support grouped convolutions for now."));
+    FusedOutputKernel<T> output_kernel;
+    OP_REQUIRES_OK(context,
+                   output_kernel.Init(context, spec_, 2, dims.out_depth));
+
+    Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1> dim_pair;
+    dim_pair[0] = Eigen::IndexPair<Eigen::DenseIndex>(1, 0);
+    if (dims.filter_rows == 1 && dims.filter_cols == 1 &&
+        dims.stride_rows == 1 && dims.stride_cols == 1) {
+      // For 1x1 kernel, the 2D convolution is reduced to matrix
+      // multiplication.
+      const int64 conv_width = dims.batch * dims.out_rows * dims.out_cols;
+      LaunchFusedMatMul<T>(
+          context, input.shaped<T, 2>({conv_width, dims.in_depth}),
+          filter.shaped<T, 2>({dims.in_depth, dims.out_depth}), dim_pair,
+          output_kernel, output->shaped<T, 2>({conv_width, dims.out_depth}));
+      return;
+    }
+    if (dims.filter_rows == dims.input_rows &&
+        dims.filter_cols == dims.input_cols && dims.dilation_rows == 1 &&
+        dims.dilation_cols == 1 && this->padding_ == VALID) {
+      // If the input data and filter have the same height/width, the 2D
+      // convolution is reduced to matrix multiplication.
+      const int64 k = dims.filter_rows * dims.filter_cols * dims.in_depth;
+      LaunchFusedMatMul<T>(
+          context, input.shaped<T, 2>({dims.batch, k}),
+          filter.shaped<T, 2>({k, dims.out_depth}), dim_pair, output_kernel,
+          output->shaped<T, 2>({dims.batch, dims.out_depth}));
+      return;
+    }
+
+    const Eigen::PaddingType padding =
+        BrainPadding2EigenPadding(this->padding_);
+    const int64 image_rows = dims.out_rows * dims.out_cols;
+    auto* workers = context->device()->tensorflow_cpu_worker_threads();
+    if (dims.batch < workers->num_threads) {
+      // Not enough images to keep all the threads busy, the convolution of
+      // each image has to be parallelized.
+      functor::SpatialConvolution<CPUDevice, T>()(
+          context->eigen_device<CPUDevice>(), output->tensor<T, 4>(),
+          input.tensor<T, 4>(), filter.tensor<T, 4>(), dims.stride_rows,
+          dims.stride_cols, dims.dilation_rows, dims.dilation_cols, padding);
+      ApplyFusedOutputKernel<T>(context, output_kernel, dims.out_depth,
+                                output->flat<T>().data(),
+                                dims.batch * image_rows);
+      return;
+    }
+
+    // Each thread convolves whole images, and applies the fused ops to the
+    // output of an image right after computing it.
+    const int64 input_image_size =
+        static_cast<int64>(dims.input_rows) * dims.input_cols * dims.in_depth;
+    const int64 output_image_size = image_rows * dims.out_depth;
+    const int64 cost_per_image = output_image_size * dims.filter_rows *
+                                 dims.filter_cols * dims.in_depth;
+    const T* input_data = input.flat<T>().data();
+    T* output_data = output->flat<T>().data();
+    auto filter_tensor = filter.tensor<T, 4>();
+    Shard(workers->num_threads, workers->workers, dims.batch, cost_per_image,
+          [&](int64 begin, int64 end) {
+            Eigen::DefaultDevice device;
+            for (int64 b = begin; b < end; ++b) {
+              typename TTypes<T, 4>::UnalignedConstTensor input_image(
+                  input_data + b * input_image_size, 1, dims.input_rows,
+                  dims.input_cols, dims.in_depth);
+              typename TTypes<T, 4>::UnalignedTensor output_image(
+                  output_data + b * output_image_size, 1, dims.out_rows,
+                  dims.out_cols, dims.out_depth);
+              functor::SpatialConvolutionFunc(
+                  device, output_image, input_image, filter_tensor,
+                  dims.stride_rows, dims.stride_cols, dims.dilation_rows,
+                  dims.dilation_cols, padding);
+              output_kernel(output_image.data(), image_rows);
+            }
+          });
+  }
+
+ private:
+  FusedOutputSpec spec_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(FusedConv2DOp);
+};
+
+#define REGISTER_CPU(T)                                               \
+  REGISTER_KERNEL_BUILDER(                                            \
+      Name("_FusedConv2D").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      FusedConv2DOp<CPUDevice, T>);
+TF_CALL_float(REGISTER_CPU);
+TF_CALL_double(REGISTER_CPU);
+#undef REGISTER_CPU
+
 // To be used inside depthwise_conv_op.cc.
 template struct LaunchConv2DOp<CPUDevice, Eigen::half>;
 template struct LaunchConv2DOp<CPUDevice, float>;
@@ -891,6 +1048,51 @@ template struct LaunchConv2DOp<GPUDevice, double>;
       Conv2DOp<SYCLDevice, T>);
 TF_CALL_SYCL_NUMBER_TYPES(REGISTER_SYCL_KERNELS)
 #undef REGISTER_SYCL_KERNELS
+
+// Conv2D followed by element-wise ops such as BiasAdd and Relu, created by the
+// remapper. SYCL-DNN writes the convolution output directly, then the whole
+// op chain is applied in place by a single kernel instead of one kernel per
+// op, each reading and writing the full activation tensor.
+template <typename T>
+class FusedConv2DOp<SYCLDevice, T> : public Conv2DOp<SYCLDevice, T> {
+ public:
+  explicit FusedConv2DOp(OpKernelConstruction* context)
+      : Conv2DOp<SYCLDevice, T>(context) {
+    std::vector<string> fused_ops;
+    OP_REQUIRES_OK(context, context->GetAttr("fused_ops", &fused_ops));
+    OP_REQUIRES_OK(context, context->GetAttr("num_args", &num_args_));
+    int num_binary_ops;
+    OP_REQUIRES_OK(context, functor::ParseFusedElementwiseOps(
+                                fused_ops, &program_, &num_binary_ops));
+    OP_REQUIRES(context, num_binary_ops == num_args_,
+                errors::InvalidArgument("Expected ", num_binary_ops,
+                                        " arguments for the fused ops, got ",
+                                        num_args_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    Conv2DOp<SYCLDevice, T>::Compute(context);
+    if (!context->status().ok() || program_.num_ops == 0) {
+      return;
+    }
+    Tensor* output = context->mutable_output(0);
+    functor::LaunchFusedElementwise<T>(context, program_, 2, num_args_,
+                                       *output, output);
+  }
+
+ private:
+  functor::FusedElementwiseProgram program_;
+  int num_args_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(FusedConv2DOp);
+};
+
+#define REGISTER_SYCL_KERNELS(T)                                       \
+  REGISTER_KERNEL_BUILDER(                                             \
+      Name("_FusedConv2D").Device(DEVICE_SYCL).TypeConstraint<T>("T"), \
+      FusedConv2DOp<SYCLDevice, T>);
+TF_CALL_SYCL_NUMBER_TYPES(REGISTER_SYCL_KERNELS)
+#undef REGISTER_SYCL_KERNELS
 #endif  // TENSORFLOW_USE_SYCL
 #endif  // !defined(USE_GEMM_FOR_CONV)
 }  // namespace tensorflow
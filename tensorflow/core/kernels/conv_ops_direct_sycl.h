@@ -96,8 +96,11 @@ inline bool launch_direct(Eigen::SyclDevice const& device, T* const output,
       RoundUpToNearestMultiple(output_size, workgroup_size), max_threads);
 
   auto input_buffer = device.get_sycl_buffer(input);
+  const Index input_offset = device.get_offset(input) / sizeof(T);
   auto filter_buffer = device.get_sycl_buffer(filter);
+  const Index filter_offset = device.get_offset(filter) / sizeof(T);
   auto output_buffer = device.get_sycl_buffer(output);
+  const Index output_offset = device.get_offset(output) / sizeof(T);
   auto kernel_params = get_kernel_params<CType>(params);
 
   auto event = device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
@@ -105,8 +108,8 @@ inline bool launch_direct(Eigen::SyclDevice const& device, T* const output,
     auto filter_access = filter_buffer.template get_access<read_mode>(cgh);
     auto output_access = output_buffer.template get_access<write_mode>(cgh);
 
-    Functor conv(output_size, kernel_params, input_access, filter_access,
-                 output_access);
+    Functor conv(output_size, kernel_params, input_access, input_offset,
+                 filter_access, filter_offset, output_access, output_offset);
 
     cgh.parallel_for(cl::sycl::range<1>(n_threads), conv);
   });
@@ -170,8 +173,11 @@ struct LaunchNCHWConv2DKernel {
         RoundUpToNearestMultiple(output_size, workgroup_size);
 
     auto input_buffer = device.get_sycl_buffer(input);
+    const Index input_offset = device.get_offset(input) / sizeof(T);
     auto filter_buffer = device.get_sycl_buffer(filter);
+    const Index filter_offset = device.get_offset(filter) / sizeof(T);
     auto output_buffer = device.get_sycl_buffer(output);
+    const Index output_offset = device.get_offset(output) / sizeof(T);
     auto kernel_params = direct::get_kernel_params<CType>(params);
 
 #define LAUNCH_STATIC_CONV(use_fast_div, window, stride)                     \
@@ -181,8 +187,8 @@ struct LaunchNCHWConv2DKernel {
     auto output_access = output_buffer.template get_access<write_mode>(cgh); \
                                                                              \
     direct::Conv2DNCHW<T, CType, use_fast_div, window, stride> conv(         \
-        output_size, kernel_params, input_access, filter_access,             \
-        output_access);                                                      \
+        output_size, kernel_params, input_access, input_offset,              \
+        filter_access, filter_offset, output_access, output_offset);         \
                                                                              \
     cgh.parallel_for(cl::sycl::range<1>(n_threads), conv);                   \
   });
@@ -27,7 +27,7 @@ struct Conv2DNCHW<T, ConvType::Forward, use_fast_div, static_window,
   using index_div_type =
       typename fast_div::index_div<Index, use_fast_div>::type;
   static constexpr auto read_mode = cl::sycl::access::mode::read;
-  static constexpr auto write_mode = cl::sycl::access::mode::discard_write;
+  static constexpr auto write_mode = cl::sycl::access::mode::write;
   static constexpr auto global_access = cl::sycl::access::target::global_buffer;
   using write_accessor =
       cl::sycl::accessor<buffer_data, 1, write_mode, global_access>;
@@ -35,8 +35,9 @@ struct Conv2DNCHW<T, ConvType::Forward, use_fast_div, static_window,
       cl::sycl::accessor<buffer_data, 1, read_mode, global_access>;
 
   inline Conv2DNCHW(Index n_elems, const SYCLConv2DParams& params,
-                    const read_accessor input, const read_accessor kernel,
-                    write_accessor output)
+                    const read_accessor input, const Index input_offset,
+                    const read_accessor kernel, const Index kernel_offset,
+                    write_accessor output, const Index output_offset)
       : n_elems_{params.batch_ * params.features_ * params.out_rows_ *
                  params.out_cols_},
         div_features_{params.features_},
@@ -44,17 +45,23 @@ struct Conv2DNCHW<T, ConvType::Forward, use_fast_div, static_window,
         div_out_rows_{params.out_rows_},
         SNN_CONSTRUCT_CONV_PARAMS(params),
         input_accessor_{input},
+        input_offset_{input_offset},
         kernel_accessor_{kernel},
-        output_accessor_{output} {}
+        kernel_offset_{kernel_offset},
+        output_accessor_{output},
+        output_offset_{output_offset} {}
 
   inline SNN_ALWAYS_INLINE void operator()(cl::sycl::item<1> item) {
     Index index = item.get_id(0);
     const Index range = item.get_range().get(0);
 
     for (; index < n_elems_; index += range) {
-      const T* input_data = ConvertToActualTypeSycl(T, input_accessor_);
-      const T* kernel_data = ConvertToActualTypeSycl(T, kernel_accessor_);
-      T* output_data = ConvertToActualTypeSycl(T, output_accessor_);
+      const T* input_data =
+          ConvertToActualTypeSycl(T, input_accessor_) + input_offset_;
+      const T* kernel_data =
+          ConvertToActualTypeSycl(T, kernel_accessor_) + kernel_offset_;
+      T* output_data =
+          ConvertToActualTypeSycl(T, output_accessor_) + output_offset_;
 
       const helpers::TensorIndex4D tensor_idx =
           helpers::unflatten4d<Index, use_fast_div>(
@@ -109,8 +116,11 @@ struct Conv2DNCHW<T, ConvType::Forward, use_fast_div, static_window,
   const index_div_type div_out_rows_;
   SNN_INJECT_CONV_PARAMS;
   const read_accessor input_accessor_;
+  const Index input_offset_;
   const read_accessor kernel_accessor_;
+  const Index kernel_offset_;
   write_accessor output_accessor_;
+  const Index output_offset_;
 };
 template <typename T, bool use_fast_div, int static_window, int static_stride>
 struct Conv2DNCHW<T, ConvType::InputBackprop, use_fast_div, static_window,
@@ -120,7 +130,7 @@ struct Conv2DNCHW<T, ConvType::InputBackprop, use_fast_div, static_window,
   using index_div_type =
       typename fast_div::index_div<Index, use_fast_div>::type;
   static constexpr auto read_mode = cl::sycl::access::mode::read;
-  static constexpr auto write_mode = cl::sycl::access::mode::discard_write;
+  static constexpr auto write_mode = cl::sycl::access::mode::write;
   static constexpr auto global_access = cl::sycl::access::target::global_buffer;
   using write_accessor =
       cl::sycl::accessor<buffer_data, 1, write_mode, global_access>;
@@ -128,8 +138,9 @@ struct Conv2DNCHW<T, ConvType::InputBackprop, use_fast_div, static_window,
       cl::sycl::accessor<buffer_data, 1, read_mode, global_access>;
 
   inline Conv2DNCHW(Index n_elems, const SYCLConv2DParams& params,
-                    const read_accessor input, const read_accessor kernel,
-                    write_accessor output)
+                    const read_accessor input, const Index input_offset,
+                    const read_accessor kernel, const Index kernel_offset,
+                    write_accessor output, const Index output_offset)
       : n_elems_{params.batch_ * params.features_ * params.in_rows_ *
                  params.in_cols_},
         div_features_{params.features_},
@@ -137,17 +148,23 @@ struct Conv2DNCHW<T, ConvType::InputBackprop, use_fast_div, static_window,
         div_in_cols_{params.in_cols_},
         SNN_CONSTRUCT_CONV_PARAMS(params),
         input_accessor_{input},
+        input_offset_{input_offset},
         kernel_accessor_{kernel},
-        output_accessor_{output} {}
+        kernel_offset_{kernel_offset},
+        output_accessor_{output},
+        output_offset_{output_offset} {}
 
   inline SNN_ALWAYS_INLINE void operator()(cl::sycl::item<1> item) {
     Index index = item.get_id(0);
     const Index range = item.get_range().get(0);
 
     for (; index < n_elems_; index += range) {
-      const T* input_data = ConvertToActualTypeSycl(T, input_accessor_);
-      const T* kernel_data = ConvertToActualTypeSycl(T, kernel_accessor_);
-      T* output_data = ConvertToActualTypeSycl(T, output_accessor_);
+      const T* input_data =
+          ConvertToActualTypeSycl(T, input_accessor_) + input_offset_;
+      const T* kernel_data =
+          ConvertToActualTypeSycl(T, kernel_accessor_) + kernel_offset_;
+      T* output_data =
+          ConvertToActualTypeSycl(T, output_accessor_) + output_offset_;
 
       const helpers::TensorIndex4D tensor_idx =
           helpers::unflatten4d<Index, use_fast_div>(
@@ -220,8 +237,11 @@ struct Conv2DNCHW<T, ConvType::InputBackprop, use_fast_div, static_window,
   const index_div_type div_in_cols_;
   SNN_INJECT_CONV_PARAMS;
   const read_accessor input_accessor_;
+  const Index input_offset_;
   const read_accessor kernel_accessor_;
+  const Index kernel_offset_;
   write_accessor output_accessor_;
+  const Index output_offset_;
 };
 /*
  * The main difference between the two backprop kernels is the way strides are
@@ -240,7 +260,7 @@ struct Conv2DNCHW<T, ConvType::FilterBackprop, use_fast_div, static_out,
   using index_div_type =
       typename fast_div::index_div<Index, use_fast_div>::type;
   static constexpr auto read_mode = cl::sycl::access::mode::read;
-  static constexpr auto write_mode = cl::sycl::access::mode::discard_write;
+  static constexpr auto write_mode = cl::sycl::access::mode::write;
   static constexpr auto global_access = cl::sycl::access::target::global_buffer;
   using write_accessor =
       cl::sycl::accessor<buffer_data, 1, write_mode, global_access>;
@@ -248,8 +268,9 @@ struct Conv2DNCHW<T, ConvType::FilterBackprop, use_fast_div, static_out,
       cl::sycl::accessor<buffer_data, 1, read_mode, global_access>;
 
   inline Conv2DNCHW(Index n_elems, const SYCLConv2DParams& params,
-                    const read_accessor input, const read_accessor kernel,
-                    write_accessor output)
+                    const read_accessor input, const Index input_offset,
+                    const read_accessor kernel, const Index kernel_offset,
+                    write_accessor output, const Index output_offset)
       : n_elems_{params.out_rows_ * params.out_cols_ * params.channels_ *
                  params.features_},
         div_features_{params.features_},
@@ -257,17 +278,23 @@ struct Conv2DNCHW<T, ConvType::FilterBackprop, use_fast_div, static_out,
         div_out_cols_{params.out_cols_},
         SNN_CONSTRUCT_CONV_PARAMS(params),
         input_accessor_{input},
+        input_offset_{input_offset},
         kernel_accessor_{kernel},
-        output_accessor_{output} {}
+        kernel_offset_{kernel_offset},
+        output_accessor_{output},
+        output_offset_{output_offset} {}
 
   inline SNN_ALWAYS_INLINE void operator()(cl::sycl::item<1> item) {
     Index index = item.get_id(0);
     const Index range = item.get_range().get(0);
 
     for (; index < n_elems_; index += range) {
-      const T* input_data = ConvertToActualTypeSycl(T, input_accessor_);
-      const T* kernel_data = ConvertToActualTypeSycl(T, kernel_accessor_);
-      T* output_data = ConvertToActualTypeSycl(T, output_accessor_);
+      const T* input_data =
+          ConvertToActualTypeSycl(T, input_accessor_) + input_offset_;
+      const T* kernel_data =
+          ConvertToActualTypeSycl(T, kernel_accessor_) + kernel_offset_;
+      T* output_data =
+          ConvertToActualTypeSycl(T, output_accessor_) + output_offset_;
 
       const helpers::TensorIndex4D tensor_idx =
           helpers::unflatten4d<Index, use_fast_div>(
@@ -327,8 +354,11 @@ struct Conv2DNCHW<T, ConvType::FilterBackprop, use_fast_div, static_out,
   const index_div_type div_out_cols_;
   SNN_INJECT_CONV_PARAMS;
   const read_accessor input_accessor_;
+  const Index input_offset_;
   const read_accessor kernel_accessor_;
+  const Index kernel_offset_;
   write_accessor output_accessor_;
+  const Index output_offset_;
 };
 }  // namespace direct
 }  // namespace tensorflow
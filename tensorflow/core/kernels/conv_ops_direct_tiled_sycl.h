@@ -5,9 +5,14 @@
 #ifndef TENSORFLOW_KERNELS_CONV_OPS_DIRECT_TILED_SYCL_H_
 #define TENSORFLOW_KERNELS_CONV_OPS_DIRECT_TILED_SYCL_H_
 
+#include <numeric>
+#include <vector>
+
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 
+#include "tensorflow/core/common_runtime/sycl/sycl_kernel_tuner.h"
 #include "tensorflow/core/kernels/conv_ops_sycl_common.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 
 #include "tensorflow/core/kernels/conv_ops_direct_tiled_sycl_kernels.h"
 
@@ -134,74 +139,121 @@ inline bool launch_tiled(Eigen::SyclDevice const& device, T* const output,
   const Index output_size =
       tiled_output_size<CType, tile_rows, tile_cols, channel_vector_width,
                         feature_vector_width>::get(params);
-  const Index workgroup_size = device.maxSyclThreadsPerBlock();
-  const Index n_threads = std::max(
-      RoundUpToNearestMultiple(output_size, workgroup_size), max_threads);
+  const Index n_threads = std::max(output_size, max_threads);
 
   auto input_buffer = device.get_sycl_buffer(input);
+  const Index input_offset = device.get_offset(input) / sizeof(T);
   auto filter_buffer = device.get_sycl_buffer(filter);
+  const Index filter_offset = device.get_offset(filter) / sizeof(T);
   auto output_buffer = device.get_sycl_buffer(output);
+  const Index output_offset = device.get_offset(output) / sizeof(T);
   auto kernel_params = get_kernel_params<CType>(params);
 
-  auto event = device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
-    auto input_access = input_buffer.template get_access<read_mode>(cgh);
-    auto filter_access = filter_buffer.template get_access<read_mode>(cgh);
-    auto output_access = output_buffer.template get_access<write_mode>(cgh);
+  static const string kernel_name = strings::StrCat(
+      "Conv2DTiled/", DataTypeString(DataTypeToEnum<T>::v()), "/",
+      static_cast<int>(CType), "/", tile_rows, "x", tile_cols, "/",
+      channel_vector_width, "x", feature_vector_width, "/", window_rows, "x",
+      window_cols, "/", stride);
+  SYCLKernelTuner::Global()->LaunchWithWorkGroupSize(
+      device, kernel_name, n_threads, [&](size_t workgroup_size) {
+        auto event = device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+          auto input_access = input_buffer.template get_access<read_mode>(cgh);
+          auto filter_access =
+              filter_buffer.template get_access<read_mode>(cgh);
+          auto output_access =
+              output_buffer.template get_access<write_mode>(cgh);
 
-    Functor conv(kernel_params, input_access, filter_access, output_access);
+          Functor conv(kernel_params, input_access, input_offset, filter_access,
+                       filter_offset, output_access, output_offset);
 
-    cgh.parallel_for(cl::sycl::range<1>(n_threads), conv);
-  });
-  event.wait();
+          cgh.parallel_for(
+              SYCLUtil::get_nd_range(device, n_threads, workgroup_size), conv);
+        });
+        event.wait();
+      });
   return true;
 }
+// Returns the parameters the choice of tile sizes depends on.
+inline string tiled_shape_key(SYCLConv2DParams const& params) {
+  return strings::StrCat(
+      params.batch_, ",", params.in_rows_, ",", params.in_cols_, ",",
+      params.channels_, ",", params.features_, ",", params.out_rows_, ",",
+      params.out_cols_, ",", params.window_rows_, ",", params.window_cols_, ",",
+      params.stride_rows_, ",", params.stride_cols_, ",", params.pad_rows_, ",",
+      params.pad_cols_);
+}
 template <typename T, ConvType CType>
 struct LaunchConv2DTiled {
   using Index = int;
 
+  using LaunchFunction = bool (*)(Eigen::SyclDevice const&, T* const,
+                                  T const* const, T const* const,
+                                  SYCLConv2DParams const&);
+
+  // Every tile configuration matching the parameters is a candidate of the
+  // SYCLKernelTuner. The first one in the list below is used unless tuning
+  // finds a faster one.
   static bool launch(Eigen::SyclDevice const& device, T* const output,
                      T const* const input, T const* const filter,
                      SYCLConv2DParams const& params) {
-#define LAUNCH_TILED_CONV(tile_row, tile_col, channel_vector_width,           \
-                          feature_vector_width, use_fast_div, window, stride) \
-  return launch_tiled<T, CType, tile_row, tile_col, channel_vector_width,     \
-                      feature_vector_width, use_fast_div, window, window,     \
-                      stride>(device, output, input, filter, params);
-#define LAUNCH_IF_MATCH(params, window, stride, tile_row, tile_col,       \
-                        channel_vector, feature_vector)                   \
+    std::vector<LaunchFunction> variants;
+#define ADD_TILED_CONV(tile_row, tile_col, channel_vector_width,              \
+                       feature_vector_width, use_fast_div, window, stride)    \
+  variants.push_back(                                                         \
+      &launch_tiled<T, CType, tile_row, tile_col, channel_vector_width,       \
+                    feature_vector_width, use_fast_div, window, window,       \
+                    stride>);
+#define ADD_IF_MATCH(params, window, stride, tile_row, tile_col,          \
+                     channel_vector, feature_vector)                      \
   if (use_static_conv<CType>(params, window, stride, channel_vector,      \
                              feature_vector)) {                           \
-    LAUNCH_TILED_CONV(tile_row, tile_col, channel_vector, feature_vector, \
-                      false, window, stride)                              \
+    ADD_TILED_CONV(tile_row, tile_col, channel_vector, feature_vector,    \
+                   false, window, stride)                                 \
   }
     // clang-format off
 #ifdef SNN_ARM
-    LAUNCH_IF_MATCH(params, 3, 1, 1, 4, 1, 1)
-    LAUNCH_IF_MATCH(params, 3, 2, 2, 4, 1, 4)
+    ADD_IF_MATCH(params, 3, 1, 1, 4, 1, 1)
+    ADD_IF_MATCH(params, 3, 2, 2, 4, 1, 4)
 #endif
     if(CType == ConvType::Forward) {
-      LAUNCH_IF_MATCH(params, 1, 2, 1, 2, 1, 4)
-      LAUNCH_IF_MATCH(params, 1, 2, 1, 2, 1, 1)
-      LAUNCH_IF_MATCH(params, 3, 2, 2, 2, 1, 4)
-      LAUNCH_IF_MATCH(params, 3, 2, 2, 2, 1, 1)
+      ADD_IF_MATCH(params, 1, 2, 1, 2, 1, 4)
+      ADD_IF_MATCH(params, 1, 2, 1, 2, 1, 1)
+      ADD_IF_MATCH(params, 3, 2, 2, 2, 1, 4)
+      ADD_IF_MATCH(params, 3, 2, 2, 2, 1, 1)
     }
     if(CType == ConvType::InputBackprop) {
-      LAUNCH_IF_MATCH(params, 1, 2, 2, 2, 1, 4)
-      LAUNCH_IF_MATCH(params, 1, 2, 2, 2, 1, 1)
-      LAUNCH_IF_MATCH(params, 3, 2, 2, 4, 1, 2)
-      LAUNCH_IF_MATCH(params, 3, 1, 3, 4, 1, 4)
+      ADD_IF_MATCH(params, 1, 2, 2, 2, 1, 4)
+      ADD_IF_MATCH(params, 1, 2, 2, 2, 1, 1)
+      ADD_IF_MATCH(params, 3, 2, 2, 4, 1, 2)
+      ADD_IF_MATCH(params, 3, 1, 3, 4, 1, 4)
     }
-    LAUNCH_IF_MATCH(params, 3, 1, 2, 2, 1, 4)
-    LAUNCH_IF_MATCH(params, 3, 1, 3, 4, 1, 1)
-    LAUNCH_IF_MATCH(params, 5, 1, 2, 2, 1, 2)
-    LAUNCH_IF_MATCH(params, 5, 1, 2, 4, 1, 1)
-    LAUNCH_IF_MATCH(params, 1, 1, 2, 2, 1, 4)
-    LAUNCH_IF_MATCH(params, 1, 1, 2, 2, 1, 1)
-
-    return false;
+    ADD_IF_MATCH(params, 3, 1, 2, 2, 1, 4)
+    ADD_IF_MATCH(params, 3, 1, 3, 4, 1, 1)
+    ADD_IF_MATCH(params, 5, 1, 2, 2, 1, 2)
+    ADD_IF_MATCH(params, 5, 1, 2, 4, 1, 1)
+    ADD_IF_MATCH(params, 1, 1, 2, 2, 1, 4)
+    ADD_IF_MATCH(params, 1, 1, 2, 2, 1, 1)
     // clang-format on
-#undef LAUNCH_IF_MATCH
-#undef LAUNCH_TILED_CONV
+#undef ADD_IF_MATCH
+#undef ADD_TILED_CONV
+
+    if (variants.empty()) {
+      return false;
+    }
+    if (variants.size() == 1) {
+      return variants[0](device, output, input, filter, params);
+    }
+    static const string kernel_name = strings::StrCat(
+        "Conv2DTiledVariant/", DataTypeString(DataTypeToEnum<T>::v()), "/",
+        static_cast<int>(CType));
+    std::vector<int64> indices(variants.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    SYCLKernelTuner::Global()->LaunchWithVariant(
+        device, kernel_name, tiled_shape_key(params), indices,
+        [&](int64 index) {
+          variants[index](device, output, input, filter, params);
+        });
+    return true;
   }
 };
 }  // namespace direct_tiled
@@ -404,15 +404,17 @@ struct Conv2DTiledSYCL {
       typename fast_div::index_div<Index, use_fast_div>::type;
   static constexpr auto input_tile_width = tile_cols + window_cols - 1;
   static constexpr auto read_mode = cl::sycl::access::mode::read;
-  static constexpr auto write_mode = cl::sycl::access::mode::discard_write;
+  static constexpr auto write_mode = cl::sycl::access::mode::write;
   static constexpr auto global_access = cl::sycl::access::target::global_buffer;
   using write_accessor =
       cl::sycl::accessor<buffer_data, 1, write_mode, global_access>;
   using read_accessor =
       cl::sycl::accessor<buffer_data, 1, read_mode, global_access>;
-  Conv2DTiledSYCL(SYCLConv2DParams const& params, read_accessor const input,
-                  read_accessor const kernel, write_accessor output) {}
-  inline SNN_ALWAYS_INLINE void operator()(cl::sycl::item<1> item) {}
+  Conv2DTiledSYCL(SYCLConv2DParams const& params,
+                  read_accessor const input, Index const input_offset,
+                  read_accessor const kernel, Index const kernel_offset,
+                  write_accessor output, Index const output_offset) {}
+  inline SNN_ALWAYS_INLINE void operator()(cl::sycl::nd_item<1> item) {}
 };
 /**
  * Forward convolution using a tiled direct computation technique.
@@ -438,7 +440,7 @@ struct Conv2DTiledSYCL<T, ConvType::Forward, tile_rows, tile_cols,
       (tile_cols - 1) * static_stride + window_cols;
   static constexpr auto CType = ConvType::Forward;
   static constexpr auto read_mode = cl::sycl::access::mode::read;
-  static constexpr auto write_mode = cl::sycl::access::mode::discard_write;
+  static constexpr auto write_mode = cl::sycl::access::mode::write;
   static constexpr auto global_access = cl::sycl::access::target::global_buffer;
   using write_accessor =
       cl::sycl::accessor<buffer_data, 1, write_mode, global_access>;
@@ -446,8 +448,10 @@ struct Conv2DTiledSYCL<T, ConvType::Forward, tile_rows, tile_cols,
       cl::sycl::accessor<buffer_data, 1, read_mode, global_access>;
   using feature_vector = cl::sycl::vec<T, feature_vector_width>;
 
-  Conv2DTiledSYCL(SYCLConv2DParams const& params, read_accessor const input,
-                  read_accessor const kernel, write_accessor output)
+  Conv2DTiledSYCL(SYCLConv2DParams const& params,
+                  read_accessor const input, Index const input_offset,
+                  read_accessor const kernel, Index const kernel_offset,
+                  write_accessor output, Index const output_offset)
       : n_tile_cols_{RoundRatioUpAboveZero(params.out_cols_, tile_cols)},
         n_tile_rows_{RoundRatioUpAboveZero(params.out_rows_, tile_rows)},
         n_elems_{params.batch_ * n_tile_rows_ * n_tile_cols_ *
@@ -458,17 +462,23 @@ struct Conv2DTiledSYCL<T, ConvType::Forward, tile_rows, tile_cols,
         div_n_tile_rows_{n_tile_rows_},
         SNN_CONSTRUCT_CONV_PARAMS(params),
         input_accessor_{input},
+        input_offset_{input_offset},
         kernel_accessor_{kernel},
-        output_accessor_{output} {}
+        kernel_offset_{kernel_offset},
+        output_accessor_{output},
+        output_offset_{output_offset} {}
 
-  inline SNN_ALWAYS_INLINE void operator()(cl::sycl::item<1> item) {
-    Index index = item.get_id(0);
-    const Index range = item.get_range().get(0);
+  inline SNN_ALWAYS_INLINE void operator()(cl::sycl::nd_item<1> item) {
+    Index index = item.get_global_id(0);
+    const Index range = item.get_global_range().get(0);
 
     for (; index < n_elems_; index += range) {
-      const T* input_data = ConvertToActualTypeSycl(T, input_accessor_);
-      const T* kernel_data = ConvertToActualTypeSycl(T, kernel_accessor_);
-      T* output_data = ConvertToActualTypeSycl(T, output_accessor_);
+      const T* input_data =
+          ConvertToActualTypeSycl(T, input_accessor_) + input_offset_;
+      const T* kernel_data =
+          ConvertToActualTypeSycl(T, kernel_accessor_) + kernel_offset_;
+      T* output_data =
+          ConvertToActualTypeSycl(T, output_accessor_) + output_offset_;
 
       const helpers::TensorIndex4D tensor_idx =
           helpers::unflatten4d<Index, use_fast_div>(
@@ -543,8 +553,11 @@ struct Conv2DTiledSYCL<T, ConvType::Forward, tile_rows, tile_cols,
   const index_div_type div_n_tile_rows_;
   SNN_INJECT_CONV_PARAMS;
   const read_accessor input_accessor_;
+  const Index input_offset_;
   const read_accessor kernel_accessor_;
+  const Index kernel_offset_;
   write_accessor output_accessor_;
+  const Index output_offset_;
 };
 template <typename T, int tile_rows, int tile_cols, int channel_vector_width,
           int feature_vector_width, bool use_fast_div, int window_rows,
@@ -560,15 +573,17 @@ struct Conv2DTiledSYCL<T, ConvType::InputBackprop, tile_rows, tile_cols,
       (tile_cols + window_cols - 1) / static_stride;
   static constexpr auto CType = ConvType::InputBackprop;
   static constexpr auto read_mode = cl::sycl::access::mode::read;
-  static constexpr auto write_mode = cl::sycl::access::mode::discard_write;
+  static constexpr auto write_mode = cl::sycl::access::mode::write;
   static constexpr auto global_access = cl::sycl::access::target::global_buffer;
   using write_accessor =
       cl::sycl::accessor<buffer_data, 1, write_mode, global_access>;
   using read_accessor =
       cl::sycl::accessor<buffer_data, 1, read_mode, global_access>;
 
-  Conv2DTiledSYCL(SYCLConv2DParams const& params, read_accessor const input,
-                  read_accessor const kernel, write_accessor output)
+  Conv2DTiledSYCL(SYCLConv2DParams const& params,
+                  read_accessor const input, Index const input_offset,
+                  read_accessor const kernel, Index const kernel_offset,
+                  write_accessor output, Index const output_offset)
       : n_tile_cols_{RoundRatioUpAboveZero(params.in_cols_, tile_cols)},
         n_tile_rows_{RoundRatioUpAboveZero(params.in_rows_, tile_rows)},
         n_elems_{params.batch_ * n_tile_rows_ * n_tile_cols_ *
@@ -578,17 +593,23 @@ struct Conv2DTiledSYCL<T, ConvType::InputBackprop, tile_rows, tile_cols,
         div_n_tile_rows_{n_tile_rows_},
         SNN_CONSTRUCT_CONV_PARAMS(params),
         input_accessor_{input},
+        input_offset_{input_offset},
         kernel_accessor_{kernel},
-        output_accessor_{output} {}
+        kernel_offset_{kernel_offset},
+        output_accessor_{output},
+        output_offset_{output_offset} {}
 
-  inline SNN_ALWAYS_INLINE void operator()(cl::sycl::item<1> item) {
-    Index index = item.get_id(0);
-    const Index range = item.get_range().get(0);
+  inline SNN_ALWAYS_INLINE void operator()(cl::sycl::nd_item<1> item) {
+    Index index = item.get_global_id(0);
+    const Index range = item.get_global_range().get(0);
 
     for (; index < n_elems_; index += range) {
-      const T* input_data = ConvertToActualTypeSycl(T, input_accessor_);
-      const T* kernel_data = ConvertToActualTypeSycl(T, kernel_accessor_);
-      T* output_data = ConvertToActualTypeSycl(T, output_accessor_);
+      const T* input_data =
+          ConvertToActualTypeSycl(T, input_accessor_) + input_offset_;
+      const T* kernel_data =
+          ConvertToActualTypeSycl(T, kernel_accessor_) + kernel_offset_;
+      T* output_data =
+          ConvertToActualTypeSycl(T, output_accessor_) + output_offset_;
 
       const helpers::TensorIndex4D tensor_idx =
           helpers::unflatten4d<Index, use_fast_div>(
@@ -670,8 +691,11 @@ struct Conv2DTiledSYCL<T, ConvType::InputBackprop, tile_rows, tile_cols,
   const index_div_type div_n_tile_rows_;
   SNN_INJECT_CONV_PARAMS;
   const read_accessor input_accessor_;
+  const Index input_offset_;
   const read_accessor kernel_accessor_;
+  const Index kernel_offset_;
   write_accessor output_accessor_;
+  const Index output_offset_;
 };
 #if 0
 /*
@@ -14,8 +14,10 @@
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 
+#include "tensorflow/core/framework/common_shape_fns.h"
 #include "tensorflow/core/kernels/sycl_dnn_utils.h"
 #include "tensorflow/core/kernels/conv_grad_ops.h"
+#include "tensorflow/core/kernels/conv_ops_sycl_autotune.h"
 #include "tensorflow/core/kernels/conv_ops_sycl_launcher.h"
 
 #include "sycldnn/conv2d/selector/default_selector.h"
@@ -63,6 +65,117 @@ inline conv2d::Conv2DParams sycl_to_sd_params(const SYCLConv2DParams& params) {
   sd_params.dilation_cols = params.dilation_cols_;
   return sd_params;
 }
+
+// Launches a NHWC convolution with SYCL-DNN.
+template <typename T, typename ConvType>
+Status launch_nhwc(const Eigen::SyclDevice& device, const T* in_ptr,
+                   const T* fil_ptr, T* out_ptr,
+                   const conv2d::Conv2DParams& sd_params, bool autotune,
+                   TensorFormat data_format, const std::string& type) {
+  vlog_conv2d_params(sd_params, data_format, type);
+  auto sycl_device = device.sycl_queue().get_device();
+  static auto sd_selector = conv2d::get_default_selector(sycl_device);
+  ACQUIRE_SNN_BACKEND(sd_backend, device);
+  auto sd_in = get_sycl_dnn_input<T>(device, in_ptr);
+  auto sd_fil = get_sycl_dnn_input<T>(device, fil_ptr);
+  auto sd_out = get_sycl_dnn_input<T>(device, out_ptr);
+  sycldnn::SNNStatus sd_status = launch_selected<T, ConvType>(
+      device, sd_in, sd_fil, sd_out, sd_params, *sd_selector, autotune,
+      sd_backend);
+  if (sd_status.status != sycldnn::StatusCode::OK) {
+    return get_sd_err_msg(sd_status);
+  }
+  return Status::OK();
+}
+
+// Launches a grouped NHWC forward convolution, where the input channels and
+// the filter features are split in `groups` independent convolutions. The
+// groups are gathered into contiguous slices on the device and convolved one
+// after the other.
+template <typename T>
+Status launch_grouped_forward(OpKernelContext* context,
+                              const Eigen::SyclDevice& device,
+                              const Tensor& input, const Tensor& filter,
+                              int64 groups,
+                              const conv2d::Conv2DParams& sd_params,
+                              bool autotune, Tensor* output) {
+  const int64 in_pixels =
+      int64{sd_params.batch} * sd_params.in_rows * sd_params.in_cols;
+  const int64 out_pixels =
+      int64{sd_params.batch} * sd_params.out_rows * sd_params.out_cols;
+  const int64 filter_size =
+      int64{sd_params.window_rows} * sd_params.window_cols * sd_params.channels;
+  const int64 channels = sd_params.channels;
+  const int64 features = sd_params.features;
+  const DataType dtype = DataTypeToEnum<T>::v();
+
+  Tensor grouped_input, grouped_filter, grouped_output;
+  TF_RETURN_IF_ERROR(context->allocate_temp(
+      dtype, TensorShape({groups, in_pixels, channels}), &grouped_input));
+  TF_RETURN_IF_ERROR(context->allocate_temp(
+      dtype, TensorShape({groups, filter_size, features}), &grouped_filter));
+  TF_RETURN_IF_ERROR(context->allocate_temp(
+      dtype, TensorShape({groups, out_pixels, features}), &grouped_output));
+
+  const Eigen::array<int, 3> swap_groups{{1, 0, 2}};
+  grouped_input.tensor<T, 3>().device(device) =
+      input.shaped<T, 3>({in_pixels, groups, channels}).shuffle(swap_groups);
+  grouped_filter.tensor<T, 3>().device(device) =
+      filter.shaped<T, 3>({filter_size, groups, features})
+          .shuffle(swap_groups);
+
+  const T* in_ptr = grouped_input.flat<T>().data();
+  const T* fil_ptr = grouped_filter.flat<T>().data();
+  T* out_ptr = grouped_output.flat<T>().data();
+  for (int64 g = 0; g < groups; ++g) {
+    TF_RETURN_IF_ERROR((launch_nhwc<T, conv2d::conv_type::Forward>(
+        device, in_ptr + g * in_pixels * channels,
+        fil_ptr + g * filter_size * features,
+        out_ptr + g * out_pixels * features, sd_params, autotune,
+        FORMAT_NHWC, "grouped_forward_conv2d")));
+  }
+
+  output->shaped<T, 3>({out_pixels, groups, features}).device(device) =
+      grouped_output.tensor<T, 3>().shuffle(swap_groups);
+  return Status::OK();
+}
+
+// The SYCL-DNN kernels only support NHWC, so NCHW tensors the in-tree
+// kernels cannot handle are transposed on the device.
+template <typename T>
+Status nchw_to_nhwc(OpKernelContext* context, const Eigen::SyclDevice& device,
+                    const Tensor& in, Tensor* out) {
+  TF_RETURN_IF_ERROR(context->allocate_temp(
+      DataTypeToEnum<T>::v(),
+      ShapeFromFormat(FORMAT_NHWC, GetTensorDim(in, FORMAT_NCHW, 'N'),
+                      GetTensorDim(in, FORMAT_NCHW, 'H'),
+                      GetTensorDim(in, FORMAT_NCHW, 'W'),
+                      GetTensorDim(in, FORMAT_NCHW, 'C')),
+      out));
+  out->tensor<T, 4>().device(device) =
+      in.tensor<T, 4>().shuffle(Eigen::array<int, 4>{{0, 2, 3, 1}});
+  return Status::OK();
+}
+
+template <typename T>
+void nhwc_to_nchw(const Eigen::SyclDevice& device, const Tensor& in,
+                  Tensor* out) {
+  out->tensor<T, 4>().device(device) =
+      in.tensor<T, 4>().shuffle(Eigen::array<int, 4>{{0, 3, 1, 2}});
+}
+
+// Allocates a NHWC temporary with the shape of the NCHW tensor `like`.
+template <typename T>
+Status allocate_nhwc(OpKernelContext* context, const Tensor& like,
+                     Tensor* out) {
+  return context->allocate_temp(
+      DataTypeToEnum<T>::v(),
+      ShapeFromFormat(FORMAT_NHWC, GetTensorDim(like, FORMAT_NCHW, 'N'),
+                      GetTensorDim(like, FORMAT_NCHW, 'H'),
+                      GetTensorDim(like, FORMAT_NCHW, 'W'),
+                      GetTensorDim(like, FORMAT_NCHW, 'C')),
+      out);
+}
 }  // namespace snn
 
 typedef Eigen::SyclDevice SYCLDevice;
@@ -73,19 +186,14 @@ struct LaunchConv2DOp;
 template <typename T>
 struct LaunchConv2DOp<SYCLDevice, T> {
   void operator()(OpKernelContext* context, bool /*use_cudnn*/,
-                  bool /*cudnn_use_autotune*/, const Tensor& input,
+                  bool cudnn_use_autotune, const Tensor& input,
                   const Tensor& filter, int row_dilation, int col_dilation,
                   int stride_rows_, int stride_cols_, const Padding& padding,
                   Tensor* output, TensorFormat data_format) {
-    if (row_dilation > 1 || col_dilation > 1) {
-      context->SetStatus(
-          errors::Unimplemented("The current SYCL convolution implementation "
-                                "only supports dilated rate of 1 for now."));
-      return;
-    }
     const int64 batch = GetTensorDim(input, data_format, 'N');
     const int64 input_rows = GetTensorDim(input, data_format, 'H');
     const int64 input_cols = GetTensorDim(input, data_format, 'W');
+    const int64 input_depth = GetTensorDim(input, data_format, 'C');
 
     const int64 stride_rows = stride_rows_;
     const int64 stride_cols = stride_cols_;
@@ -93,47 +201,69 @@ struct LaunchConv2DOp<SYCLDevice, T> {
     const int64 filter_cols = filter.dim_size(1);
     const int64 in_depth = filter.dim_size(2);
     const int64 out_depth = filter.dim_size(3);
+    // Conv2DOp checked that the input depth is a multiple of the filter depth.
+    const int64 groups = input_depth / in_depth;
+    OP_REQUIRES(context, out_depth % groups == 0,
+                errors::InvalidArgument(
+                    "Filter depth must be divisible by the number of groups: ",
+                    out_depth, " vs ", groups));
 
     int64 out_rows = 0, out_cols = 0, pad_rows = 0, pad_cols = 0;
-    OP_REQUIRES_OK(context,
-                   GetWindowedOutputSize(input_rows, filter_rows, stride_rows,
-                                         padding, &out_rows, &pad_rows));
-    OP_REQUIRES_OK(context,
-                   GetWindowedOutputSize(input_cols, filter_cols, stride_cols,
-                                         padding, &out_cols, &pad_cols));
-
-    SYCLConv2DParams params{in_depth,    out_depth,   batch,       input_rows,
-                            input_cols,  filter_rows, filter_cols, stride_rows,
-                            stride_cols, out_rows,    out_cols,    pad_rows,
+    OP_REQUIRES_OK(context, GetWindowedOutputSizeV2(
+                                input_rows, filter_rows, row_dilation,
+                                stride_rows, padding, &out_rows, &pad_rows));
+    OP_REQUIRES_OK(context, GetWindowedOutputSizeV2(
+                                input_cols, filter_cols, col_dilation,
+                                stride_cols, padding, &out_cols, &pad_cols));
+
+    SYCLConv2DParams params{in_depth,    out_depth / groups, batch,
+                            input_rows,  input_cols,         filter_rows,
+                            filter_cols, stride_rows,        stride_cols,
+                            out_rows,    out_cols,           pad_rows,
                             pad_cols};
+    params.dilation_rows_ = row_dilation;
+    params.dilation_cols_ = col_dilation;
+    const bool dilated = row_dilation > 1 || col_dilation > 1;
 
     // TODO: Remove the SYCLConv2DParams struct and always use the sycldnn one instead.
     namespace sd = sycldnn::conv2d;
     auto sd_params = snn::sycl_to_sd_params(params);
     auto device = context->eigen_device<SYCLDevice>();
 
-    auto in_ptr = input.template flat<T>().data();
-    auto fil_ptr = filter.template flat<T>().data();
-    auto out_ptr = output->template flat<T>().data();
-
-    if (data_format == FORMAT_NCHW) {
+    if (data_format == FORMAT_NCHW && !dilated && groups == 1) {
+      auto in_ptr = input.template flat<T>().data();
+      auto fil_ptr = filter.template flat<T>().data();
+      auto out_ptr = output->template flat<T>().data();
       SNN_SELECTOR sel;
       launch_conv2d_nchw<T, ConvType::Forward>(device, in_ptr, fil_ptr,
                                                params, out_ptr, sel);
+      device.async_synchronize();
+      return;
+    }
+
+    Tensor nhwc_input = input;
+    Tensor nhwc_output = *output;
+    if (data_format == FORMAT_NCHW) {
+      OP_REQUIRES_OK(context,
+                     snn::nchw_to_nhwc<T>(context, device, input, &nhwc_input));
+      OP_REQUIRES_OK(context,
+                     snn::allocate_nhwc<T>(context, *output, &nhwc_output));
+    }
+    if (groups > 1) {
+      OP_REQUIRES_OK(context, snn::launch_grouped_forward<T>(
+                                  context, device, nhwc_input, filter, groups,
+                                  sd_params, cudnn_use_autotune,
+                                  &nhwc_output));
     } else {
-      vlog_conv2d_params(sd_params, data_format, "forward_conv2d");
-      auto sycl_device = device.sycl_queue().get_device();
-      static auto sd_selector = sd::get_default_selector(sycl_device);
-      CREATE_SNN_BACKEND(sd_backend, device);
-      auto sd_in = get_sycl_dnn_input<T>(device, in_ptr);
-      auto sd_fil = get_sycl_dnn_input<T>(device, fil_ptr);
-      auto sd_out = get_sycl_dnn_input<T>(device, out_ptr);
-      sycldnn::SNNStatus sd_status = sd::launch<T, sd::conv_type::Forward>(
-          sd_in, sd_fil, sd_out, sd_params, *sd_selector, sd_backend);
-      if (sd_status.status != sycldnn::StatusCode::OK) {
-        context->SetStatus(get_sd_err_msg(sd_status));
-        return;
-      }
+      OP_REQUIRES_OK(context, (snn::launch_nhwc<T, sd::conv_type::Forward>(
+                                  device, nhwc_input.template flat<T>().data(),
+                                  filter.template flat<T>().data(),
+                                  nhwc_output.template flat<T>().data(),
+                                  sd_params, cudnn_use_autotune, data_format,
+                                  "forward_conv2d")));
+    }
+    if (data_format == FORMAT_NCHW) {
+      snn::nhwc_to_nchw<T>(device, nhwc_output, output);
     }
     device.async_synchronize();
   }
@@ -142,16 +272,10 @@ struct LaunchConv2DOp<SYCLDevice, T> {
 template <typename T>
 struct LaunchConv2DBackpropInputOp<SYCLDevice, T> {
   void operator()(OpKernelContext* context, bool /*use_cudnn*/,
-                  bool /*cudnn_use_autotune*/, const Tensor& out_backprop,
+                  bool cudnn_use_autotune, const Tensor& out_backprop,
                   const Tensor& filter, int row_dilation, int col_dilation,
                   int stride_rows_, int stride_cols_, const Padding& padding,
                   Tensor* in_backprop, TensorFormat data_format) {
-    if (row_dilation > 1 || col_dilation > 1) {
-      context->SetStatus(
-          errors::Unimplemented("The current SYCL convolution implementation "
-                                "only supports dilated rate of 1 for now."));
-      return;
-    }
     const int64 batch = GetTensorDim(*in_backprop, data_format, 'N');
     const int64 input_rows = GetTensorDim(*in_backprop, data_format, 'H');
     const int64 input_cols = GetTensorDim(*in_backprop, data_format, 'W');
@@ -162,47 +286,61 @@ struct LaunchConv2DBackpropInputOp<SYCLDevice, T> {
     const int64 filter_cols = filter.dim_size(1);
     const int64 in_depth = filter.dim_size(2);
     const int64 out_depth = filter.dim_size(3);
+    OP_REQUIRES(context,
+                GetTensorDim(*in_backprop, data_format, 'C') == in_depth,
+                errors::Unimplemented("The SYCL convolution backprop does not "
+                                      "support grouped convolutions."));
 
     int64 out_rows = 0, out_cols = 0, pad_rows = 0, pad_cols = 0;
-    OP_REQUIRES_OK(context,
-                   GetWindowedOutputSize(input_rows, filter_rows, stride_rows,
-                                         padding, &out_rows, &pad_rows));
-    OP_REQUIRES_OK(context,
-                   GetWindowedOutputSize(input_cols, filter_cols, stride_cols,
-                                         padding, &out_cols, &pad_cols));
+    OP_REQUIRES_OK(context, GetWindowedOutputSizeV2(
+                                input_rows, filter_rows, row_dilation,
+                                stride_rows, padding, &out_rows, &pad_rows));
+    OP_REQUIRES_OK(context, GetWindowedOutputSizeV2(
+                                input_cols, filter_cols, col_dilation,
+                                stride_cols, padding, &out_cols, &pad_cols));
 
     SYCLConv2DParams params{in_depth,    out_depth,   batch,       input_rows,
                             input_cols,  filter_rows, filter_cols, stride_rows,
                             stride_cols, out_rows,    out_cols,    pad_rows,
                             pad_cols};
+    params.dilation_rows_ = row_dilation;
+    params.dilation_cols_ = col_dilation;
+    const bool dilated = row_dilation > 1 || col_dilation > 1;
 
     // TODO: Remove the SYCLConv2DParams struct and always use the sycldnn one instead.
     namespace sd = sycldnn::conv2d;
     auto sd_params = snn::sycl_to_sd_params(params);
     auto device = context->eigen_device<SYCLDevice>();
 
-    auto in_ptr = out_backprop.template flat<T>().data();
-    auto fil_ptr = filter.template flat<T>().data();
-    auto out_ptr = in_backprop->template flat<T>().data();
-
-    if (data_format == FORMAT_NCHW) {
+    if (data_format == FORMAT_NCHW && !dilated) {
+      auto in_ptr = out_backprop.template flat<T>().data();
+      auto fil_ptr = filter.template flat<T>().data();
+      auto out_ptr = in_backprop->template flat<T>().data();
       SNN_SELECTOR sel;
       launch_conv2d_nchw<T, ConvType::InputBackprop>(device, in_ptr, fil_ptr,
                                                      params, out_ptr, sel);
-    } else {
-      vlog_conv2d_params(sd_params, data_format, "input_backprop_conv2d");
-      auto sycl_device = device.sycl_queue().get_device();
-      static auto sd_selector = sd::get_default_selector(sycl_device);
-      CREATE_SNN_BACKEND(sd_backend, device);
-      auto sd_in = get_sycl_dnn_input<T>(device, in_ptr);
-      auto sd_fil = get_sycl_dnn_input<T>(device, fil_ptr);
-      auto sd_out = get_sycl_dnn_input<T>(device, out_ptr);
-      sycldnn::SNNStatus sd_status = sd::launch<T, sd::conv_type::InputBackprop>(
-          sd_in, sd_fil, sd_out, sd_params, *sd_selector, sd_backend);
-      if (sd_status.status != sycldnn::StatusCode::OK) {
-        context->SetStatus(get_sd_err_msg(sd_status));
-        return;
-      }
+      device.async_synchronize();
+      return;
+    }
+
+    Tensor nhwc_out_backprop = out_backprop;
+    Tensor nhwc_in_backprop = *in_backprop;
+    if (data_format == FORMAT_NCHW) {
+      OP_REQUIRES_OK(context, snn::nchw_to_nhwc<T>(context, device,
+                                                   out_backprop,
+                                                   &nhwc_out_backprop));
+      OP_REQUIRES_OK(context, snn::allocate_nhwc<T>(context, *in_backprop,
+                                                    &nhwc_in_backprop));
+    }
+    OP_REQUIRES_OK(context,
+                   (snn::launch_nhwc<T, sd::conv_type::InputBackprop>(
+                       device, nhwc_out_backprop.template flat<T>().data(),
+                       filter.template flat<T>().data(),
+                       nhwc_in_backprop.template flat<T>().data(), sd_params,
+                       cudnn_use_autotune, data_format,
+                       "input_backprop_conv2d")));
+    if (data_format == FORMAT_NCHW) {
+      snn::nhwc_to_nchw<T>(device, nhwc_in_backprop, in_backprop);
     }
     device.async_synchronize();
   }
@@ -211,16 +349,10 @@ struct LaunchConv2DBackpropInputOp<SYCLDevice, T> {
 template <typename T>
 struct LaunchConv2DBackpropFilterOp<SYCLDevice, T> {
   void operator()(OpKernelContext* context, bool /*use_cudnn*/,
-                  bool /*cudnn_use_autotune*/, const Tensor& out_backprop,
+                  bool cudnn_use_autotune, const Tensor& out_backprop,
                   const Tensor& input, int row_dilation, int col_dilation,
                   int stride_rows_, int stride_cols_, const Padding& padding,
                   Tensor* filter_backprop, TensorFormat data_format) {
-    if (row_dilation > 1 || col_dilation > 1) {
-      context->SetStatus(
-          errors::Unimplemented("The current SYCL convolution implementation "
-                                "only supports dilated rate of 1 for now."));
-      return;
-    }
     const int64 batch = GetTensorDim(input, data_format, 'N');
     const int64 input_rows = GetTensorDim(input, data_format, 'H');
     const int64 input_cols = GetTensorDim(input, data_format, 'W');
@@ -231,49 +363,58 @@ struct LaunchConv2DBackpropFilterOp<SYCLDevice, T> {
     const int64 filter_cols = filter_backprop->dim_size(1);
     const int64 in_depth = filter_backprop->dim_size(2);
     const int64 out_depth = filter_backprop->dim_size(3);
+    OP_REQUIRES(context, GetTensorDim(input, data_format, 'C') == in_depth,
+                errors::Unimplemented("The SYCL convolution backprop does not "
+                                      "support grouped convolutions."));
 
     int64 out_rows = 0, out_cols = 0, pad_rows = 0, pad_cols = 0;
-    OP_REQUIRES_OK(context,
-                   GetWindowedOutputSize(input_rows, filter_rows, stride_rows,
-                                         padding, &out_rows, &pad_rows));
-    OP_REQUIRES_OK(context,
-                   GetWindowedOutputSize(input_cols, filter_cols, stride_cols,
-                                         padding, &out_cols, &pad_cols));
+    OP_REQUIRES_OK(context, GetWindowedOutputSizeV2(
+                                input_rows, filter_rows, row_dilation,
+                                stride_rows, padding, &out_rows, &pad_rows));
+    OP_REQUIRES_OK(context, GetWindowedOutputSizeV2(
+                                input_cols, filter_cols, col_dilation,
+                                stride_cols, padding, &out_cols, &pad_cols));
 
     SYCLConv2DParams params{in_depth,    out_depth,   batch,       input_rows,
                             input_cols,  filter_rows, filter_cols, stride_rows,
                             stride_cols, out_rows,    out_cols,    pad_rows,
                             pad_cols};
+    params.dilation_rows_ = row_dilation;
+    params.dilation_cols_ = col_dilation;
+    const bool dilated = row_dilation > 1 || col_dilation > 1;
 
     // TODO: Remove the SYCLConv2DParams struct and always use the sycldnn one instead.
     namespace sd = sycldnn::conv2d;
     auto sd_params = snn::sycl_to_sd_params(params);
     auto device = context->eigen_device<SYCLDevice>();
 
-    auto in_ptr = input.template flat<T>().data();
-    auto fil_ptr = out_backprop.template flat<T>().data();
-    auto out_ptr = filter_backprop->template flat<T>().data();
-
-    if (data_format == FORMAT_NCHW) {
+    if (data_format == FORMAT_NCHW && !dilated) {
+      auto in_ptr = input.template flat<T>().data();
+      auto fil_ptr = out_backprop.template flat<T>().data();
+      auto out_ptr = filter_backprop->template flat<T>().data();
       SNN_SELECTOR sel;
       launch_conv2d_nchw<T, ConvType::FilterBackprop>(device, in_ptr, fil_ptr,
                                                       params, out_ptr, sel);
-    } else {
-      vlog_conv2d_params(sd_params, data_format, "filter_backprop_conv2d");
-      auto sycl_device = device.sycl_queue().get_device();
-      static auto sd_selector = sd::get_default_selector(sycl_device);
-      CREATE_SNN_BACKEND(sd_backend, device);
-      auto sd_in = get_sycl_dnn_input<T>(device, in_ptr);
-      auto sd_fil = get_sycl_dnn_input<T>(device, fil_ptr);
-      auto sd_out = get_sycl_dnn_input<T>(device, out_ptr);
-      sycldnn::SNNStatus sd_status =
-        sd::launch<T, sd::conv_type::FilterBackprop>(
-          sd_in, sd_fil, sd_out, sd_params, *sd_selector, sd_backend);
-      if (sd_status.status != sycldnn::StatusCode::OK) {
-        context->SetStatus(get_sd_err_msg(sd_status));
-        return;
-      }
+      device.async_synchronize();
+      return;
     }
+
+    Tensor nhwc_input = input;
+    Tensor nhwc_out_backprop = out_backprop;
+    if (data_format == FORMAT_NCHW) {
+      OP_REQUIRES_OK(context,
+                     snn::nchw_to_nhwc<T>(context, device, input, &nhwc_input));
+      OP_REQUIRES_OK(context, snn::nchw_to_nhwc<T>(context, device,
+                                                   out_backprop,
+                                                   &nhwc_out_backprop));
+    }
+    OP_REQUIRES_OK(context,
+                   (snn::launch_nhwc<T, sd::conv_type::FilterBackprop>(
+                       device, nhwc_input.template flat<T>().data(),
+                       nhwc_out_backprop.template flat<T>().data(),
+                       filter_backprop->template flat<T>().data(), sd_params,
+                       cudnn_use_autotune, data_format,
+                       "filter_backprop_conv2d")));
     device.async_synchronize();
   }
 };
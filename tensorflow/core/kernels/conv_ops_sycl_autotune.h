@@ -0,0 +1,267 @@
+#ifndef TENSORFLOW_USE_SYCL
+#error This file should only be included when compiling with SYCL support
+#endif
+
+#ifndef TENSORFLOW_KERNELS_CONV_OPS_SYCL_AUTOTUNE_H_
+#define TENSORFLOW_KERNELS_CONV_OPS_SYCL_AUTOTUNE_H_
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+
+#include "tensorflow/core/common_runtime/sycl/sycl_kernel_tuner.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/kernels/sycl_dnn_utils.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+
+#include "sycldnn/conv2d/selector/selector.h"
+
+namespace tensorflow {
+namespace snn {
+namespace conv2d = sycldnn::conv2d;
+
+// Selector always returning the same algorithm, used to time each SYCL-DNN
+// algorithm in turn.
+class FixedSelector final : public conv2d::Selector {
+ public:
+  explicit FixedSelector(conv2d::Algorithm algo) : algo_(algo) {}
+  conv2d::Algorithm select(conv2d::Conv2DParams const&) override {
+    return algo_;
+  }
+  char const* name() const { return "FixedSelector"; }
+
+ private:
+  conv2d::Algorithm algo_;
+};
+
+inline const char* conv_type_name(conv2d::conv_type::Forward) {
+  return "Forward";
+}
+inline const char* conv_type_name(conv2d::conv_type::InputBackprop) {
+  return "InputBackprop";
+}
+inline const char* conv_type_name(conv2d::conv_type::FilterBackprop) {
+  return "FilterBackprop";
+}
+
+// Process wide cache of the fastest SYCL-DNN convolution algorithm for a given
+// device, convolution type, data type and set of parameters.
+//
+// If the environment variable TF_SYCL_CONV_AUTOTUNE_CACHE names a file, the
+// cache is loaded from it on first use and the file is rewritten every time a
+// new entry is added, so that the following processes start already tuned.
+// Each line of the file is "<key>\t<algorithm>".
+class ConvAutotuneCache {
+ public:
+  static ConvAutotuneCache* Global() {
+    static ConvAutotuneCache* cache = new ConvAutotuneCache();
+    return cache;
+  }
+
+  bool Find(const string& key, conv2d::Algorithm* algo) const {
+    mutex_lock lock(mu_);
+    auto iter = map_.find(key);
+    if (iter == map_.end()) {
+      return false;
+    }
+    *algo = iter->second;
+    return true;
+  }
+
+  void Insert(const string& key, conv2d::Algorithm algo) {
+    mutex_lock lock(mu_);
+    map_[key] = algo;
+    if (!path_.empty()) {
+      string contents;
+      for (const auto& entry : map_) {
+        strings::StrAppend(&contents, entry.first, "\t",
+                           static_cast<int>(entry.second), "\n");
+      }
+      Status s = WriteStringToFile(Env::Default(), path_, contents);
+      if (!s.ok()) {
+        LOG(WARNING) << "Could not save SYCL convolution autotune cache to "
+                     << path_ << ": " << s;
+      }
+    }
+  }
+
+  // Returns a key identifying the device the convolution runs on, so that a
+  // cache file shared between machines never mixes results of different
+  // devices.
+  static string DeviceFingerprint(const Eigen::SyclDevice& device) {
+    return SYCLKernelTuner::Global()->DeviceFingerprint(device);
+  }
+
+  template <typename T, typename ConvType>
+  static string Key(const Eigen::SyclDevice& device,
+                    const conv2d::Conv2DParams& p) {
+    return strings::StrCat(
+        DeviceFingerprint(device), "|", conv_type_name(ConvType()), "|",
+        DataTypeString(DataTypeToEnum<T>::v()), "|", p.channels, ",",
+        p.features, ",", p.batch, ",", p.in_rows, ",", p.in_cols, ",",
+        p.window_rows, ",", p.window_cols, ",", p.stride_rows, ",",
+        p.stride_cols, ",", p.out_rows, ",", p.out_cols, ",", p.pad_rows, ",",
+        p.pad_cols, ",", p.dilation_rows, ",", p.dilation_cols);
+  }
+
+ private:
+  ConvAutotuneCache() {
+    const char* path = getenv("TF_SYCL_CONV_AUTOTUNE_CACHE");
+    if (path != nullptr) {
+      path_ = path;
+      Load();
+    }
+  }
+
+  void Load() {
+    string contents;
+    if (!ReadFileToString(Env::Default(), path_, &contents).ok()) {
+      return;
+    }
+    for (const string& line : str_util::Split(contents, '\n')) {
+      std::vector<string> fields = str_util::Split(line, '\t');
+      int32 algo;
+      if (fields.size() != 2 || !strings::safe_strto32(fields[1], &algo)) {
+        continue;
+      }
+      map_[fields[0]] = static_cast<conv2d::Algorithm>(algo);
+    }
+    VLOG(1) << "Loaded " << map_.size()
+            << " SYCL convolution autotune entries from " << path_;
+  }
+
+  mutable mutex mu_;
+  std::unordered_map<string, conv2d::Algorithm> map_ GUARDED_BY(mu_);
+  string path_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ConvAutotuneCache);
+};
+
+// Launches the convolution with the fastest SYCL-DNN algorithm for the given
+// parameters. On first use of a set of parameters every algorithm is timed
+// and the winner is stored in the ConvAutotuneCache.
+template <typename T, typename ConvType, typename In, typename Fil,
+          typename Out, typename Backend>
+sycldnn::SNNStatus launch_autotuned(const Eigen::SyclDevice& device, In sd_in,
+                                    Fil sd_fil, Out sd_out,
+                                    const conv2d::Conv2DParams& sd_params,
+                                    Backend& sd_backend) {
+  ConvAutotuneCache* cache = ConvAutotuneCache::Global();
+  const string key = ConvAutotuneCache::Key<T, ConvType>(device, sd_params);
+  conv2d::Algorithm best_algo;
+  if (!cache->Find(key, &best_algo)) {
+    static const conv2d::Algorithm kAlgorithms[] = {
+        conv2d::Algorithm::Direct, conv2d::Algorithm::Tiled,
+        conv2d::Algorithm::Im2col, conv2d::Algorithm::Winograd,
+        conv2d::Algorithm::Matmul};
+    uint64 best_time = std::numeric_limits<uint64>::max();
+    best_algo = conv2d::Algorithm::NotSupported;
+    for (conv2d::Algorithm algo : kAlgorithms) {
+      FixedSelector selector(algo);
+      // The first launch compiles the kernels, only the second one is timed.
+      auto status = conv2d::launch<T, ConvType>(sd_in, sd_fil, sd_out,
+                                                sd_params, selector,
+                                                sd_backend);
+      if (status.status != sycldnn::StatusCode::OK) {
+        continue;
+      }
+      device.synchronize();
+      const uint64 start = Env::Default()->NowMicros();
+      conv2d::launch<T, ConvType>(sd_in, sd_fil, sd_out, sd_params, selector,
+                                  sd_backend);
+      device.synchronize();
+      const uint64 elapsed = Env::Default()->NowMicros() - start;
+      VLOG(1) << "[SYCL-DNN] autotune " << key << " algorithm "
+              << static_cast<int>(algo) << " took " << elapsed << "us";
+      if (elapsed < best_time) {
+        best_time = elapsed;
+        best_algo = algo;
+      }
+    }
+    if (best_algo == conv2d::Algorithm::NotSupported) {
+      sycldnn::SNNStatus status;
+      status.status = sycldnn::StatusCode::InvalidAlgorithm;
+      return status;
+    }
+    cache->Insert(key, best_algo);
+  }
+  FixedSelector selector(best_algo);
+  return conv2d::launch<T, ConvType>(sd_in, sd_fil, sd_out, sd_params,
+                                     selector, sd_backend);
+}
+
+// Returns true and sets algo if the environment variable
+// TF_SYCL_CONV_ALGORITHM names the SYCL-DNN algorithm every convolution must
+// use, one of Direct, Tiled, Im2col, Winograd or Matmul. This is mostly
+// useful to benchmark each algorithm in turn.
+inline bool GetForcedAlgorithm(conv2d::Algorithm* algo) {
+  const char* name = getenv("TF_SYCL_CONV_ALGORITHM");
+  if (name == nullptr || *name == '\0') {
+    return false;
+  }
+  static const std::pair<const char*, conv2d::Algorithm> kAlgorithms[] = {
+      {"Direct", conv2d::Algorithm::Direct},
+      {"Tiled", conv2d::Algorithm::Tiled},
+      {"Im2col", conv2d::Algorithm::Im2col},
+      {"Winograd", conv2d::Algorithm::Winograd},
+      {"Matmul", conv2d::Algorithm::Matmul}};
+  for (const auto& entry : kAlgorithms) {
+    if (strcmp(name, entry.first) == 0) {
+      *algo = entry.second;
+      return true;
+    }
+  }
+  static const bool logged = [name]() {
+    LOG(WARNING) << "Ignoring unknown SYCL-DNN algorithm "
+                 << "TF_SYCL_CONV_ALGORITHM=" << name;
+    return true;
+  }();
+  (void)logged;
+  return false;
+}
+
+// Launches the convolution with the algorithm forced by
+// TF_SYCL_CONV_ALGORITHM if any, otherwise with the autotuned algorithm if
+// autotune is true, otherwise with the one picked by default_selector.
+// Dilated convolutions always use the direct algorithm, the only one that
+// reads dilated windows.
+template <typename T, typename ConvType, typename In, typename Fil,
+          typename Out, typename Backend>
+sycldnn::SNNStatus launch_selected(const Eigen::SyclDevice& device, In sd_in,
+                                   Fil sd_fil, Out sd_out,
+                                   const conv2d::Conv2DParams& sd_params,
+                                   conv2d::Selector& default_selector,
+                                   bool autotune, Backend& sd_backend) {
+  if (sd_params.dilation_rows > 1 || sd_params.dilation_cols > 1) {
+    FixedSelector selector(conv2d::Algorithm::Direct);
+    return conv2d::launch<T, ConvType>(sd_in, sd_fil, sd_out, sd_params,
+                                       selector, sd_backend);
+  }
+  conv2d::Algorithm forced_algo;
+  if (GetForcedAlgorithm(&forced_algo)) {
+    FixedSelector selector(forced_algo);
+    return conv2d::launch<T, ConvType>(sd_in, sd_fil, sd_out, sd_params,
+                                       selector, sd_backend);
+  }
+  if (autotune) {
+    return launch_autotuned<T, ConvType>(device, sd_in, sd_fil, sd_out,
+                                         sd_params, sd_backend);
+  }
+  return conv2d::launch<T, ConvType>(sd_in, sd_fil, sd_out, sd_params,
+                                     default_selector, sd_backend);
+}
+
+}  // namespace snn
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_KERNELS_CONV_OPS_SYCL_AUTOTUNE_H_
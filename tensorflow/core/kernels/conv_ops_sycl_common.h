@@ -7,6 +7,7 @@
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 
+#include "tensorflow/core/kernels/sycl_blas_utils.h"
 #include "tensorflow/core/platform/macros.h"
 
 namespace tensorflow {
@@ -90,6 +91,8 @@ enum class algorithm {
   winograd_1x3,
   winograd_3x1,
   winograd_3x3,
+  // Winograd F(4x4, 3x3), trading some accuracy for fewer multiplies.
+  winograd_3x3_large,
   im2col,
   direct,
   direct_tiled,
@@ -313,11 +316,19 @@ static void launch_matmul(Eigen::SyclDevice const& device, T const* const lhs,
         alpha * out_tensor + lhs_tensor.contract(rhs_tensor, ContractDims{});
   }
 }
+/**
+ * Computes `batches` row major matrix products z = op(x) * op(y), where the
+ * matrices of each operand are stored contiguously one after the other.
+ *
+ * sycl-blas runs the whole batch as a single strided kernel, while half is
+ * not provided by sycl-blas so falls back to one Eigen contraction per batch.
+ */
 template <bool trans_lhs, bool trans_rhs, typename T, typename Index>
 static void launch_batch_matmul(Eigen::SyclDevice const& d,
                                 T const* const x_ptr, T const* const y_ptr,
                                 T* const z_ptr, Index const batches,
-                                Index const m, Index const k, Index const n) {
+                                Index const m, Index const k, Index const n,
+                                std::true_type /* use_eigen */) {
   Index const x_size = m * k;
   Index const y_size = k * n;
   Index const z_size = m * n;
@@ -331,6 +342,37 @@ static void launch_batch_matmul(Eigen::SyclDevice const& d,
                                         k, n);
   }
 }
+template <bool trans_lhs, bool trans_rhs, typename T, typename Index>
+static void launch_batch_matmul(Eigen::SyclDevice const& d,
+                                T const* const x_ptr, T const* const y_ptr,
+                                T* const z_ptr, Index const batches,
+                                Index const m, Index const k, Index const n,
+                                std::false_type /* use_eigen */) {
+  auto ex_handle = AcquireSYCLBlasExecutor(d);
+  SYCLBlasExecutor& ex = *ex_handle;
+  // sycl-blas is column major, so compute z^T = op(y)^T * op(x)^T instead.
+  Index const lda = trans_rhs ? k : n;
+  Index const ldb = trans_lhs ? m : k;
+  Index const ldc = n;
+  char const t_y = trans_rhs ? 't' : 'n';
+  char const t_x = trans_lhs ? 't' : 'n';
+  auto x_blas_ptr = get_buffer_iterator<T>(d, x_ptr);
+  auto y_blas_ptr = get_buffer_iterator<T>(d, y_ptr);
+  auto z_blas_ptr = get_buffer_iterator<T>(d, z_ptr);
+  vlog_blas_params("conv_batch_matmul", n, m, k, t_y, t_x, batches);
+  blas::_gemm_batched(ex, t_y, t_x, n, m, k, static_cast<T>(1), y_blas_ptr,
+                      lda, x_blas_ptr, ldb, static_cast<T>(0), z_blas_ptr,
+                      ldc, batches);
+}
+template <bool trans_lhs, bool trans_rhs, typename T, typename Index>
+static void launch_batch_matmul(Eigen::SyclDevice const& d,
+                                T const* const x_ptr, T const* const y_ptr,
+                                T* const z_ptr, Index const batches,
+                                Index const m, Index const k, Index const n) {
+  launch_batch_matmul<trans_lhs, trans_rhs>(
+      d, x_ptr, y_ptr, z_ptr, batches, m, k, n,
+      std::is_same<T, Eigen::half>{});
+}
 }  // namespace sycl_conv
 }  // namespace tensorflow
 #endif  // TENSORFLOW_KERNELS_CONV_OPS_SYCL_COMMON_H_
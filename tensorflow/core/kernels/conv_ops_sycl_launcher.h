@@ -109,6 +109,7 @@ static inline void launch_conv2d(backend_type const& backend,
     CASE(result, winograd_3x1);
     CASE(result, winograd_1x3);
     CASE(result, winograd_3x3);
+    CASE(result, winograd_3x3_large);
     CASE(result, im2col);
     CASE(result, direct);
     CASE(result, direct_tiled);
@@ -23,6 +23,8 @@ using direct_selector = constant_selector<algorithm::direct>;
 using im2col_selector = constant_selector<algorithm::im2col>;
 class winograd_selector final : public algorithm_selector {
  public:
+  static constexpr int kLargeTileMinSize = 16;
+
   algorithm get_selection(SYCLConv2DParams const& params) override {
     if (params.stride_rows_ != 1 || params.stride_cols_ != 1) {
       return algorithm::not_supported;
@@ -34,6 +36,12 @@ class winograd_selector final : public algorithm_selector {
       return algorithm::winograd_3x1;
     }
     if (params.window_rows_ == 3 && params.window_cols_ == 3) {
+      // The 4x4 output tiles need 36 multiplies per tile instead of 64 for
+      // four 2x2 tiles, but waste more work on the image borders.
+      if (params.out_rows_ >= kLargeTileMinSize &&
+          params.out_cols_ >= kLargeTileMinSize) {
+        return algorithm::winograd_3x3_large;
+      }
       return algorithm::winograd_3x3;
     }
     return algorithm::not_supported;
@@ -88,7 +96,7 @@ class arm_selector final : public algorithm_selector {
         if(params.channels_ < 10) {
           return algorithm::direct;
         } else if( params.in_rows_ > 100) {
-          return algorithm::winograd_3x3;
+          return algorithm::winograd_3x3_large;
         } else if (params.in_rows_ > 50) {
           return algorithm::im2col;
         } else {
@@ -381,6 +381,9 @@ template <typename T, typename backend_type, ConvType CType>
 struct Launcher<T, backend_type, algorithm::winograd_3x3, CType> final
     : public WinogradVectorLauncher<T, backend_type, 2, 2, 3, 3, CType> {};
 template <typename T, typename backend_type, ConvType CType>
+struct Launcher<T, backend_type, algorithm::winograd_3x3_large, CType> final
+    : public WinogradVectorLauncher<T, backend_type, 4, 4, 3, 3, CType> {};
+template <typename T, typename backend_type, ConvType CType>
 struct Launcher<T, backend_type, algorithm::winograd_3x1, CType> final
     : public WinogradVectorLauncher<T, backend_type, 2, 1, 3, 1, CType> {};
 template <typename T, typename backend_type, ConvType CType>
@@ -392,6 +395,13 @@ struct Launcher<T, backend_type, algorithm::winograd_3x3,
                 ConvType::FilterBackprop>
     final : public WinogradVectorLauncher<T, backend_type, 3, 3, 2, 2,
                                           ConvType::FilterBackprop> {};
+// The filter gradient has the filter size as its output, so there is no
+// larger output tile to use.
+template <typename T, typename backend_type>
+struct Launcher<T, backend_type, algorithm::winograd_3x3_large,
+                ConvType::FilterBackprop>
+    final : public WinogradVectorLauncher<T, backend_type, 3, 3, 2, 2,
+                                          ConvType::FilterBackprop> {};
 template <typename T, typename backend_type>
 struct Launcher<T, backend_type, algorithm::winograd_3x1,
                 ConvType::FilterBackprop>
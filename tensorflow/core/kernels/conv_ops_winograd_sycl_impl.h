@@ -168,6 +168,111 @@ struct OutputTile<T, 2, 2, 3, 3> final : public BaseOutputTile<T, 2, 2, 3, 3> {
                  tile.data[3][1] - tile.data[3][2] + tile.data[3][3];
   }
 };
+/**
+ * One dimensional transforms of the F(4, 3) Winograd algorithm, as given by
+ * Lavin and Gray. Each writes the transformed values to out[0], out[1], ...
+ *
+ * The 6x6 tiles are transformed by applying these to every column into a
+ * transposed temporary and then to every row of that, which needs far fewer
+ * operations than writing out each of the 36 two dimensional sums.
+ */
+template <typename T>
+inline SNN_ALWAYS_INLINE void filter_transform_4x3(T const g0, T const g1,
+                                                   T const g2, T* const out) {
+  out[0] = g0 / 4;
+  out[1] = -(g0 + g1 + g2) / 6;
+  out[2] = -(g0 - g1 + g2) / 6;
+  out[3] = g0 / 24 + g1 / 12 + g2 / 6;
+  out[4] = g0 / 24 - g1 / 12 + g2 / 6;
+  out[5] = g2;
+}
+template <typename T>
+inline SNN_ALWAYS_INLINE void input_transform_4x3(T const d0, T const d1,
+                                                  T const d2, T const d3,
+                                                  T const d4, T const d5,
+                                                  T* const out) {
+  out[0] = 4 * d0 - 5 * d2 + d4;
+  out[1] = -4 * (d1 + d2) + d3 + d4;
+  out[2] = 4 * (d1 - d2) - d3 + d4;
+  out[3] = 2 * (d3 - d1) - d2 + d4;
+  out[4] = 2 * (d1 - d3) - d2 + d4;
+  out[5] = 4 * d1 - 5 * d3 + d5;
+}
+template <typename T>
+inline SNN_ALWAYS_INLINE void output_transform_4x3(T const m0, T const m1,
+                                                   T const m2, T const m3,
+                                                   T const m4, T const m5,
+                                                   T* const out) {
+  out[0] = m0 + m1 + m2 + m3 + m4;
+  out[1] = m1 - m2 + 2 * (m3 - m4);
+  out[2] = m1 + m2 + 4 * (m3 + m4);
+  out[3] = m1 - m2 + 8 * (m3 - m4) + m5;
+}
+template <typename T>
+struct TransformedFilterTile<T, 4, 4, 3, 3> final
+    : public BaseTransformedFilterTile<T, 4, 4, 3, 3> {
+  using BaseTransformedFilterTile<T, 4, 4, 3, 3>::data;
+  /**
+   * Apply the Winograd transform to the filter tile.
+   */
+  template <ConvType _FT>
+  inline SNN_ALWAYS_INLINE TransformedFilterTile(
+      FilterTile<T, 4, 4, 3, 3, _FT> const& filter)
+      : BaseTransformedFilterTile<T, 4, 4, 3, 3>{} {
+    T tmp[3][6];
+    for (int c = 0; c < 3; ++c) {
+      filter_transform_4x3(filter.data[0][c], filter.data[1][c],
+                           filter.data[2][c], tmp[c]);
+    }
+    for (int r = 0; r < 6; ++r) {
+      filter_transform_4x3(tmp[0][r], tmp[1][r], tmp[2][r], data[r]);
+    }
+  }
+};
+template <typename T>
+struct TransformedInputTile<T, 4, 4, 3, 3> final
+    : public BaseTransformedInputTile<T, 4, 4, 3, 3> {
+  using BaseTransformedInputTile<T, 4, 4, 3, 3>::data;
+  /**
+   * Apply the Winograd transform to the input tile.
+   */
+  inline SNN_ALWAYS_INLINE TransformedInputTile(
+      InputTile<T, 4, 4, 3, 3> const& inp)
+      : BaseTransformedInputTile<T, 4, 4, 3, 3>{} {
+    T tmp[6][6];
+    for (int c = 0; c < 6; ++c) {
+      input_transform_4x3(inp.data[0][c], inp.data[1][c], inp.data[2][c],
+                          inp.data[3][c], inp.data[4][c], inp.data[5][c],
+                          tmp[c]);
+    }
+    for (int r = 0; r < 6; ++r) {
+      input_transform_4x3(tmp[0][r], tmp[1][r], tmp[2][r], tmp[3][r],
+                          tmp[4][r], tmp[5][r], data[r]);
+    }
+  }
+};
+template <typename T>
+struct OutputTile<T, 4, 4, 3, 3> final : public BaseOutputTile<T, 4, 4, 3, 3> {
+  using BaseOutputTile<T, 4, 4, 3, 3>::data;
+  /**
+   * Apply the Winograd transform to the intermediate tile to give the final
+   * output tile.
+   */
+  inline SNN_ALWAYS_INLINE OutputTile(
+      IntermediateTile<T, 4, 4, 3, 3> const& tile)
+      : BaseOutputTile<T, 4, 4, 3, 3>{} {
+    T tmp[6][4];
+    for (int c = 0; c < 6; ++c) {
+      output_transform_4x3(tile.data[0][c], tile.data[1][c], tile.data[2][c],
+                           tile.data[3][c], tile.data[4][c], tile.data[5][c],
+                           tmp[c]);
+    }
+    for (int r = 0; r < 4; ++r) {
+      output_transform_4x3(tmp[0][r], tmp[1][r], tmp[2][r], tmp[3][r],
+                           tmp[4][r], tmp[5][r], data[r]);
+    }
+  }
+};
 template <typename T>
 struct TransformedFilterTile<T, 2, 1, 3, 1> final
     : public BaseTransformedFilterTile<T, 2, 1, 3, 1> {
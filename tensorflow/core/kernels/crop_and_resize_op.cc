@@ -42,11 +42,19 @@ limitations under the License.
 using stream_executor::cuda::ScopedActivateExecutorContext;
 #endif  // GOOGLE_CUDA
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/kernels/crop_and_resize_op_sycl.h"
+#include "tensorflow/core/lib/core/notification.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace tensorflow {
 namespace {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
 typedef Eigen::GpuDevice GPUDevice;
+#ifdef TENSORFLOW_USE_SYCL
+typedef Eigen::SyclDevice SYCLDevice;
+#endif  // TENSORFLOW_USE_SYCL
 using Callback = std::function<void()>;
 
 static inline Status ParseAndCheckBoxSizes(const Tensor& boxes,
@@ -850,4 +858,120 @@ TF_CALL_GPU_NUMBER_TYPES(REGISTER_KERNEL);
 
 #endif  // GOOGLE_CUDA
 
+#ifdef TENSORFLOW_USE_SYCL
+
+namespace {
+
+// Specialization of CheckValidBoxIndex for a SYCLDevice. The indices are
+// checked on the device, only the result is copied back to the host.
+template <>
+inline void RunIfBoxIndexIsValid<SYCLDevice>(
+    OpKernelContext* context, typename TTypes<int32, 1>::ConstTensor box_index,
+    int batch_size, const Callback& compute, const Callback& done) {
+  const int num_boxes = box_index.dimension(0);
+  if (num_boxes > 0) {
+    Tensor isvalid_dev_tensor;
+    OP_REQUIRES_OK_ASYNC(
+        context,
+        context->allocate_temp(DataTypeToEnum<bool>::value, TensorShape({}),
+                               &isvalid_dev_tensor),
+        done);
+    typename TTypes<bool, 0>::Tensor isvalid_dev =
+        isvalid_dev_tensor.tensor<bool, 0>();
+    const SYCLDevice& d = context->eigen_device<SYCLDevice>();
+    functor::CheckValidBoxIndexHelper<SYCLDevice>()(d, box_index, batch_size,
+                                                    isvalid_dev);
+    bool isvalid = false;
+    Notification done_copy;
+    d.memcpyDeviceToHost(&isvalid, isvalid_dev.data(), sizeof(bool),
+                         [&done_copy]() { done_copy.Notify(); });
+    done_copy.WaitForNotification();
+    OP_REQUIRES_ASYNC(
+        context, isvalid,
+        errors::OutOfRange("box_index has values outside [0, batch_size)"),
+        done);
+  }
+  if (compute) {
+    compute();
+  }
+  if (done) {
+    done();
+  }
+}
+
+}  // namespace
+
+namespace functor {
+template <typename T>
+struct CropAndResize<SYCLDevice, T> {
+  bool operator()(const OpKernelContext* context,
+                  typename TTypes<T, 4>::ConstTensor image,
+                  typename TTypes<float, 2>::ConstTensor boxes,
+                  typename TTypes<int32, 1>::ConstTensor box_index,
+                  const string& method_name, float extrapolation_value,
+                  typename TTypes<float, 4>::Tensor crops) {
+    LaunchSYCLCropAndResize<T>(context->eigen_device<SYCLDevice>(), image,
+                               boxes, box_index, method_name == "bilinear",
+                               extrapolation_value, crops);
+    return true;
+  }
+};
+
+// Overlapping boxes scatter into the same pixels of the image gradient, so
+// it is only computed on SYCL devices for types with an atomic add.
+template <>
+struct CropAndResizeBackpropImage<SYCLDevice, float> {
+  bool operator()(const SYCLDevice& d,
+                  typename TTypes<float, 4>::ConstTensor grads,
+                  typename TTypes<float, 2>::ConstTensor boxes,
+                  typename TTypes<int32, 1>::ConstTensor box_index,
+                  typename TTypes<float, 4>::Tensor grads_image,
+                  const string& method_name) {
+    grads_image.device(d) = grads_image.constant(0.0f);
+    LaunchSYCLCropAndResizeBackpropImage(d, grads, boxes, box_index,
+                                         method_name == "bilinear",
+                                         grads_image);
+    return true;
+  }
+};
+
+template <typename T>
+struct CropAndResizeBackpropBoxes<SYCLDevice, T> {
+  bool operator()(const SYCLDevice& d,
+                  typename TTypes<float, 4>::ConstTensor grads,
+                  typename TTypes<T, 4>::ConstTensor image,
+                  typename TTypes<float, 2>::ConstTensor boxes,
+                  typename TTypes<int32, 1>::ConstTensor box_index,
+                  typename TTypes<float, 2>::Tensor grads_boxes) {
+    LaunchSYCLCropAndResizeBackpropBoxes<T>(d, grads, image, boxes,
+                                            box_index, grads_boxes);
+    return true;
+  }
+};
+}  // namespace functor
+
+#define REGISTER_KERNEL(T)                                 \
+  REGISTER_KERNEL_BUILDER(Name("CropAndResize")            \
+                              .Device(DEVICE_SYCL)         \
+                              .TypeConstraint<T>("T")      \
+                              .HostMemory("crop_size"),    \
+                          CropAndResizeOp<SYCLDevice, T>); \
+                                                           \
+  REGISTER_KERNEL_BUILDER(Name("CropAndResizeGradBoxes")   \
+                              .Device(DEVICE_SYCL)         \
+                              .TypeConstraint<T>("T"),     \
+                          CropAndResizeGradBoxesOp<SYCLDevice, T>);
+
+TF_CALL_SYCL_NUMBER_TYPES(REGISTER_KERNEL);
+
+#undef REGISTER_KERNEL
+
+REGISTER_KERNEL_BUILDER(Name("CropAndResizeGradImage")
+                            .Device(DEVICE_SYCL)
+                            .TypeConstraint<float>("T")
+                            .HostMemory("image_size"),
+                        CropAndResizeGradImageOp<SYCLDevice, float>);
+
+#endif  // TENSORFLOW_USE_SYCL
+
 }  // namespace tensorflow
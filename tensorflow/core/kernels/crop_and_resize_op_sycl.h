@@ -0,0 +1,566 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_USE_SYCL
+#error This file must only be included when building TensorFlow with SYCL support
+#endif
+
+#ifndef TENSORFLOW_CORE_KERNELS_CROP_AND_RESIZE_OP_SYCL_H_
+#define TENSORFLOW_CORE_KERNELS_CROP_AND_RESIZE_OP_SYCL_H_
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+
+#include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+#include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/kernels/reduction_ops_sycl.h"
+#include "tensorflow/core/kernels/sycl_atomic_utils.h"
+
+namespace tensorflow {
+
+typedef Eigen::SyclDevice SYCLDevice;
+
+namespace functor {
+namespace crop_and_resize_sycl {
+
+using reduction_sycl::Index;
+
+using read_accessor =
+    cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read,
+                       cl::sycl::access::target::global_buffer>;
+using write_accessor =
+    cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::write,
+                       cl::sycl::access::target::global_buffer>;
+using local_accessor =
+    cl::sycl::accessor<float, 1, cl::sycl::access::mode::read_write,
+                       cl::sycl::access::target::local>;
+
+// Returns the image coordinate of crop row, or column, i of a box spanning
+// [lo, hi] in normalized coordinates, as computed by the CPU functors.
+inline float CropCoordinate(const Index i, const float lo, const float hi,
+                            const Index crop_size, const Index image_size) {
+  if (crop_size > 1) {
+    const float scale = (hi - lo) * (image_size - 1) / (crop_size - 1);
+    return lo * (image_size - 1) + i * scale;
+  }
+  return 0.5f * (lo + hi) * (image_size - 1);
+}
+
+// Splits the index of an element of a [num_boxes, crop_height, crop_width,
+// depth] tensor.
+inline void CropIndices(Index index, const Index crop_height,
+                        const Index crop_width, const Index depth, Index* box,
+                        Index* y, Index* x, Index* d) {
+  *d = index % depth;
+  index /= depth;
+  *x = index % crop_width;
+  index /= crop_width;
+  *y = index % crop_height;
+  *box = index / crop_height;
+}
+
+// Computes one element of the crops per work item.
+template <typename T>
+class CropAndResizeSYCL {
+ public:
+  CropAndResizeSYCL(read_accessor image, Index image_offset,
+                    read_accessor boxes, Index boxes_offset,
+                    read_accessor box_index, Index box_index_offset,
+                    write_accessor crops, Index crops_offset, Index batch,
+                    Index image_height, Index image_width, Index num_boxes,
+                    Index crop_height, Index crop_width, Index depth,
+                    bool bilinear, float extrapolation_value)
+      : image_accessor_(image),
+        image_offset_(image_offset),
+        boxes_accessor_(boxes),
+        boxes_offset_(boxes_offset),
+        box_index_accessor_(box_index),
+        box_index_offset_(box_index_offset),
+        crops_accessor_(crops),
+        crops_offset_(crops_offset),
+        batch_(batch),
+        image_height_(image_height),
+        image_width_(image_width),
+        num_boxes_(num_boxes),
+        crop_height_(crop_height),
+        crop_width_(crop_width),
+        depth_(depth),
+        bilinear_(bilinear),
+        extrapolation_value_(extrapolation_value) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const Index index = item.get_global_id(0);
+    if (index >= num_boxes_ * crop_height_ * crop_width_ * depth_) {
+      return;
+    }
+    Index b, y, x, d;
+    CropIndices(index, crop_height_, crop_width_, depth_, &b, &y, &x, &d);
+    const float* box =
+        ConvertToActualTypeSycl(float, boxes_accessor_) + boxes_offset_ + b * 4;
+    const int32 b_in = ConvertToActualTypeSycl(
+        int32, box_index_accessor_)[box_index_offset_ + b];
+    float* crops =
+        ConvertToActualTypeSycl(float, crops_accessor_) + crops_offset_;
+    // Boxes with an invalid index are skipped, as on the CPU.
+    if (b_in < 0 || b_in >= batch_) {
+      return;
+    }
+
+    const float in_y =
+        CropCoordinate(y, box[0], box[2], crop_height_, image_height_);
+    const float in_x =
+        CropCoordinate(x, box[1], box[3], crop_width_, image_width_);
+    if (in_y < 0 || in_y > image_height_ - 1 || in_x < 0 ||
+        in_x > image_width_ - 1) {
+      crops[index] = extrapolation_value_;
+      return;
+    }
+
+    const T* image = ConvertToActualTypeSycl(T, image_accessor_) +
+                     image_offset_ +
+                     b_in * image_height_ * image_width_ * depth_ + d;
+    if (bilinear_) {
+      const Index top_y = cl::sycl::floor(in_y);
+      const Index bottom_y = cl::sycl::ceil(in_y);
+      const float y_lerp = in_y - top_y;
+      const Index left_x = cl::sycl::floor(in_x);
+      const Index right_x = cl::sycl::ceil(in_x);
+      const float x_lerp = in_x - left_x;
+
+      const float top_left =
+          static_cast<float>(image[(top_y * image_width_ + left_x) * depth_]);
+      const float top_right =
+          static_cast<float>(image[(top_y * image_width_ + right_x) * depth_]);
+      const float bottom_left = static_cast<float>(
+          image[(bottom_y * image_width_ + left_x) * depth_]);
+      const float bottom_right = static_cast<float>(
+          image[(bottom_y * image_width_ + right_x) * depth_]);
+      const float top = top_left + (top_right - top_left) * x_lerp;
+      const float bottom = bottom_left + (bottom_right - bottom_left) * x_lerp;
+      crops[index] = top + (bottom - top) * y_lerp;
+    } else {
+      const Index closest_y = cl::sycl::round(in_y);
+      const Index closest_x = cl::sycl::round(in_x);
+      crops[index] = static_cast<float>(
+          image[(closest_y * image_width_ + closest_x) * depth_]);
+    }
+  }
+
+ private:
+  const read_accessor image_accessor_;
+  const Index image_offset_;
+  const read_accessor boxes_accessor_;
+  const Index boxes_offset_;
+  const read_accessor box_index_accessor_;
+  const Index box_index_offset_;
+  write_accessor crops_accessor_;
+  const Index crops_offset_;
+  const Index batch_;
+  const Index image_height_;
+  const Index image_width_;
+  const Index num_boxes_;
+  const Index crop_height_;
+  const Index crop_width_;
+  const Index depth_;
+  const bool bilinear_;
+  const float extrapolation_value_;
+};
+
+// Scatters one element of the crop gradients per work item into the image
+// gradient. Boxes may overlap, so the additions are atomic.
+class CropAndResizeBackpropImageSYCL {
+ public:
+  CropAndResizeBackpropImageSYCL(read_accessor grads, Index grads_offset,
+                                 read_accessor boxes, Index boxes_offset,
+                                 read_accessor box_index,
+                                 Index box_index_offset,
+                                 sycl_atomic_accessor grads_image,
+                                 Index grads_image_offset, Index batch,
+                                 Index image_height, Index image_width,
+                                 Index num_boxes, Index crop_height,
+                                 Index crop_width, Index depth, bool bilinear)
+      : grads_accessor_(grads),
+        grads_offset_(grads_offset),
+        boxes_accessor_(boxes),
+        boxes_offset_(boxes_offset),
+        box_index_accessor_(box_index),
+        box_index_offset_(box_index_offset),
+        grads_image_accessor_(grads_image),
+        grads_image_offset_(grads_image_offset),
+        batch_(batch),
+        image_height_(image_height),
+        image_width_(image_width),
+        num_boxes_(num_boxes),
+        crop_height_(crop_height),
+        crop_width_(crop_width),
+        depth_(depth),
+        bilinear_(bilinear) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const Index index = item.get_global_id(0);
+    if (index >= num_boxes_ * crop_height_ * crop_width_ * depth_) {
+      return;
+    }
+    Index b, y, x, d;
+    CropIndices(index, crop_height_, crop_width_, depth_, &b, &y, &x, &d);
+    const float* box =
+        ConvertToActualTypeSycl(float, boxes_accessor_) + boxes_offset_ + b * 4;
+    const int32 b_in = ConvertToActualTypeSycl(
+        int32, box_index_accessor_)[box_index_offset_ + b];
+    if (b_in < 0 || b_in >= batch_) {
+      return;
+    }
+
+    const float in_y =
+        CropCoordinate(y, box[0], box[2], crop_height_, image_height_);
+    const float in_x =
+        CropCoordinate(x, box[1], box[3], crop_width_, image_width_);
+    if (in_y < 0 || in_y > image_height_ - 1 || in_x < 0 ||
+        in_x > image_width_ - 1) {
+      return;
+    }
+
+    const float grad = ConvertToActualTypeSycl(
+        float, grads_accessor_)[grads_offset_ + index];
+    const Index image_base =
+        grads_image_offset_ + b_in * image_height_ * image_width_ * depth_ + d;
+    if (bilinear_) {
+      const Index top_y = cl::sycl::floor(in_y);
+      const Index bottom_y = cl::sycl::ceil(in_y);
+      const float y_lerp = in_y - top_y;
+      const Index left_x = cl::sycl::floor(in_x);
+      const Index right_x = cl::sycl::ceil(in_x);
+      const float x_lerp = in_x - left_x;
+
+      const float dtop = (1 - y_lerp) * grad;
+      const float dbottom = y_lerp * grad;
+      Add(image_base, top_y, left_x, (1 - x_lerp) * dtop);
+      Add(image_base, top_y, right_x, x_lerp * dtop);
+      Add(image_base, bottom_y, left_x, (1 - x_lerp) * dbottom);
+      Add(image_base, bottom_y, right_x, x_lerp * dbottom);
+    } else {
+      Add(image_base, cl::sycl::round(in_y), cl::sycl::round(in_x), grad);
+    }
+  }
+
+ private:
+  void Add(const Index image_base, const Index y, const Index x,
+           const float value) {
+    SYCLAtomicAdd(grads_image_accessor_,
+                  image_base + (y * image_width_ + x) * depth_, value);
+  }
+
+  const read_accessor grads_accessor_;
+  const Index grads_offset_;
+  const read_accessor boxes_accessor_;
+  const Index boxes_offset_;
+  const read_accessor box_index_accessor_;
+  const Index box_index_offset_;
+  sycl_atomic_accessor grads_image_accessor_;
+  const Index grads_image_offset_;
+  const Index batch_;
+  const Index image_height_;
+  const Index image_width_;
+  const Index num_boxes_;
+  const Index crop_height_;
+  const Index crop_width_;
+  const Index depth_;
+  const bool bilinear_;
+};
+
+// Computes the gradient of one box per work-group. Every work item sums the
+// contributions of a strided part of the crop, which are then reduced in
+// local memory. The box gradients are written whole so they do not need to
+// be zeroed first.
+template <typename T>
+class CropAndResizeBackpropBoxesSYCL {
+ public:
+  CropAndResizeBackpropBoxesSYCL(read_accessor grads, Index grads_offset,
+                                 read_accessor image, Index image_offset,
+                                 read_accessor boxes, Index boxes_offset,
+                                 read_accessor box_index,
+                                 Index box_index_offset,
+                                 write_accessor grads_boxes,
+                                 Index grads_boxes_offset,
+                                 local_accessor scratch, Index batch,
+                                 Index image_height, Index image_width,
+                                 Index crop_height, Index crop_width,
+                                 Index depth)
+      : grads_accessor_(grads),
+        grads_offset_(grads_offset),
+        image_accessor_(image),
+        image_offset_(image_offset),
+        boxes_accessor_(boxes),
+        boxes_offset_(boxes_offset),
+        box_index_accessor_(box_index),
+        box_index_offset_(box_index_offset),
+        grads_boxes_accessor_(grads_boxes),
+        grads_boxes_offset_(grads_boxes_offset),
+        scratch_(scratch),
+        batch_(batch),
+        image_height_(image_height),
+        image_width_(image_width),
+        crop_height_(crop_height),
+        crop_width_(crop_width),
+        depth_(depth) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const Index b = item.get_group(0);
+    const Index local_id = item.get_local_id(0);
+    const Index local_size = item.get_local_range(0);
+    const float* box =
+        ConvertToActualTypeSycl(float, boxes_accessor_) + boxes_offset_ + b * 4;
+    const float y1 = box[0];
+    const float x1 = box[1];
+    const float y2 = box[2];
+    const float x2 = box[3];
+    const int32 b_in = ConvertToActualTypeSycl(
+        int32, box_index_accessor_)[box_index_offset_ + b];
+
+    const float height_ratio =
+        crop_height_ > 1
+            ? static_cast<float>(image_height_ - 1) / (crop_height_ - 1)
+            : 0;
+    const float width_ratio =
+        crop_width_ > 1
+            ? static_cast<float>(image_width_ - 1) / (crop_width_ - 1)
+            : 0;
+    const float height_scale = crop_height_ > 1 ? (y2 - y1) * height_ratio : 0;
+    const float width_scale = crop_width_ > 1 ? (x2 - x1) * width_ratio : 0;
+
+    float dy1 = 0, dx1 = 0, dy2 = 0, dx2 = 0;
+    if (b_in >= 0 && b_in < batch_) {
+      const float* grads = ConvertToActualTypeSycl(float, grads_accessor_) +
+                           grads_offset_ +
+                           b * crop_height_ * crop_width_ * depth_;
+      const T* image = ConvertToActualTypeSycl(T, image_accessor_) +
+                       image_offset_ +
+                       b_in * image_height_ * image_width_ * depth_;
+      const Index crop_size = crop_height_ * crop_width_ * depth_;
+      for (Index i = local_id; i < crop_size; i += local_size) {
+        const Index d = i % depth_;
+        const Index x = (i / depth_) % crop_width_;
+        const Index y = i / (depth_ * crop_width_);
+        const float in_y = crop_height_ > 1
+                               ? y1 * (image_height_ - 1) + y * height_scale
+                               : 0.5f * (y1 + y2) * (image_height_ - 1);
+        const float in_x = crop_width_ > 1
+                               ? x1 * (image_width_ - 1) + x * width_scale
+                               : 0.5f * (x1 + x2) * (image_width_ - 1);
+        if (in_y < 0 || in_y > image_height_ - 1 || in_x < 0 ||
+            in_x > image_width_ - 1) {
+          continue;
+        }
+        const Index top_y = cl::sycl::floor(in_y);
+        const Index bottom_y = cl::sycl::ceil(in_y);
+        const float y_lerp = in_y - top_y;
+        const Index left_x = cl::sycl::floor(in_x);
+        const Index right_x = cl::sycl::ceil(in_x);
+        const float x_lerp = in_x - left_x;
+
+        const float top_left = static_cast<float>(
+            image[(top_y * image_width_ + left_x) * depth_ + d]);
+        const float top_right = static_cast<float>(
+            image[(top_y * image_width_ + right_x) * depth_ + d]);
+        const float bottom_left = static_cast<float>(
+            image[(bottom_y * image_width_ + left_x) * depth_ + d]);
+        const float bottom_right = static_cast<float>(
+            image[(bottom_y * image_width_ + right_x) * depth_ + d]);
+        const float image_grad_y = grads[i] *
+                                   ((1 - x_lerp) * (bottom_left - top_left) +
+                                    x_lerp * (bottom_right - top_right));
+        const float image_grad_x = grads[i] *
+                                   ((1 - y_lerp) * (top_right - top_left) +
+                                    y_lerp * (bottom_right - bottom_left));
+        if (crop_height_ > 1) {
+          dy1 += image_grad_y * (image_height_ - 1 - y * height_ratio);
+          dy2 += image_grad_y * (y * height_ratio);
+        } else {
+          dy1 += image_grad_y * 0.5f * (image_height_ - 1);
+          dy2 += image_grad_y * 0.5f * (image_height_ - 1);
+        }
+        if (crop_width_ > 1) {
+          dx1 += image_grad_x * (image_width_ - 1 - x * width_ratio);
+          dx2 += image_grad_x * (x * width_ratio);
+        } else {
+          dx1 += image_grad_x * 0.5f * (image_width_ - 1);
+          dx2 += image_grad_x * 0.5f * (image_width_ - 1);
+        }
+      }
+    }
+
+    // The scratch holds the four partial sums of each work item, in the
+    // order of the box coordinates.
+    float* scratch = scratch_.get_pointer();
+    scratch[local_id * 4 + 0] = dy1;
+    scratch[local_id * 4 + 1] = dx1;
+    scratch[local_id * 4 + 2] = dy2;
+    scratch[local_id * 4 + 3] = dx2;
+    item.barrier(cl::sycl::access::fence_space::local_space);
+    for (Index offset = local_size / 2; offset > 0; offset /= 2) {
+      if (local_id < offset) {
+        for (int k = 0; k < 4; ++k) {
+          scratch[local_id * 4 + k] += scratch[(local_id + offset) * 4 + k];
+        }
+      }
+      item.barrier(cl::sycl::access::fence_space::local_space);
+    }
+    if (local_id < 4) {
+      ConvertToActualTypeSycl(float, grads_boxes_accessor_)
+          [grads_boxes_offset_ + b * 4 + local_id] = scratch[local_id];
+    }
+  }
+
+ private:
+  const read_accessor grads_accessor_;
+  const Index grads_offset_;
+  const read_accessor image_accessor_;
+  const Index image_offset_;
+  const read_accessor boxes_accessor_;
+  const Index boxes_offset_;
+  const read_accessor box_index_accessor_;
+  const Index box_index_offset_;
+  write_accessor grads_boxes_accessor_;
+  const Index grads_boxes_offset_;
+  local_accessor scratch_;
+  const Index batch_;
+  const Index image_height_;
+  const Index image_width_;
+  const Index crop_height_;
+  const Index crop_width_;
+  const Index depth_;
+};
+
+}  // namespace crop_and_resize_sycl
+
+// Runs the CropAndResize kernel.
+template <typename T>
+void LaunchSYCLCropAndResize(const SYCLDevice& d,
+                             typename TTypes<T, 4>::ConstTensor image,
+                             typename TTypes<float, 2>::ConstTensor boxes,
+                             typename TTypes<int32, 1>::ConstTensor box_index,
+                             const bool bilinear,
+                             const float extrapolation_value,
+                             typename TTypes<float, 4>::Tensor crops) {
+  if (crops.size() == 0) return;
+  const T* image_ptr = image.data();
+  const float* boxes_ptr = boxes.data();
+  const int32* box_index_ptr = box_index.data();
+  float* crops_ptr = crops.data();
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto image_acc =
+        d.get_sycl_buffer(image_ptr).template get_access<mode::read>(cgh);
+    auto boxes_acc =
+        d.get_sycl_buffer(boxes_ptr).template get_access<mode::read>(cgh);
+    auto box_index_acc =
+        d.get_sycl_buffer(box_index_ptr).template get_access<mode::read>(cgh);
+    auto crops_acc =
+        d.get_sycl_buffer(crops_ptr).template get_access<mode::write>(cgh);
+    crop_and_resize_sycl::CropAndResizeSYCL<T> functor(
+        image_acc, d.get_offset(image_ptr) / sizeof(T), boxes_acc,
+        d.get_offset(boxes_ptr) / sizeof(float), box_index_acc,
+        d.get_offset(box_index_ptr) / sizeof(int32), crops_acc,
+        d.get_offset(crops_ptr) / sizeof(float), image.dimension(0),
+        image.dimension(1), image.dimension(2), crops.dimension(0),
+        crops.dimension(1), crops.dimension(2), crops.dimension(3), bilinear,
+        extrapolation_value);
+    cgh.parallel_for(SYCLUtil::get_nd_range(d, crops.size()), functor);
+  });
+}
+
+// Runs the CropAndResizeGradImage kernel. grads_image must be zeroed.
+inline void LaunchSYCLCropAndResizeBackpropImage(
+    const SYCLDevice& d, typename TTypes<float, 4>::ConstTensor grads,
+    typename TTypes<float, 2>::ConstTensor boxes,
+    typename TTypes<int32, 1>::ConstTensor box_index, const bool bilinear,
+    typename TTypes<float, 4>::Tensor grads_image) {
+  if (grads.size() == 0) return;
+  const float* grads_ptr = grads.data();
+  const float* boxes_ptr = boxes.data();
+  const int32* box_index_ptr = box_index.data();
+  float* grads_image_ptr = grads_image.data();
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto grads_acc =
+        d.get_sycl_buffer(grads_ptr).template get_access<mode::read>(cgh);
+    auto boxes_acc =
+        d.get_sycl_buffer(boxes_ptr).template get_access<mode::read>(cgh);
+    auto box_index_acc =
+        d.get_sycl_buffer(box_index_ptr).template get_access<mode::read>(cgh);
+    auto grads_image_acc = GetSYCLAtomicBuffer(d, grads_image_ptr)
+                               .template get_access<mode::atomic>(cgh);
+    crop_and_resize_sycl::CropAndResizeBackpropImageSYCL functor(
+        grads_acc, d.get_offset(grads_ptr) / sizeof(float), boxes_acc,
+        d.get_offset(boxes_ptr) / sizeof(float), box_index_acc,
+        d.get_offset(box_index_ptr) / sizeof(int32), grads_image_acc,
+        d.get_offset(grads_image_ptr) / sizeof(uint32_t),
+        grads_image.dimension(0), grads_image.dimension(1),
+        grads_image.dimension(2), grads.dimension(0), grads.dimension(1),
+        grads.dimension(2), grads.dimension(3), bilinear);
+    cgh.parallel_for(SYCLUtil::get_nd_range(d, grads.size()), functor);
+  });
+}
+
+// Runs the CropAndResizeGradBoxes kernel.
+template <typename T>
+void LaunchSYCLCropAndResizeBackpropBoxes(
+    const SYCLDevice& d, typename TTypes<float, 4>::ConstTensor grads,
+    typename TTypes<T, 4>::ConstTensor image,
+    typename TTypes<float, 2>::ConstTensor boxes,
+    typename TTypes<int32, 1>::ConstTensor box_index,
+    typename TTypes<float, 2>::Tensor grads_boxes) {
+  using crop_and_resize_sycl::Index;
+  const Index num_boxes = grads.dimension(0);
+  if (num_boxes == 0) return;
+  const Index local_size = reduction_sycl::ReductionWorkGroupSize(d);
+  const cl::sycl::nd_range<1> range(
+      cl::sycl::range<1>(num_boxes * local_size),
+      cl::sycl::range<1>(local_size));
+
+  const float* grads_ptr = grads.data();
+  const T* image_ptr = image.data();
+  const float* boxes_ptr = boxes.data();
+  const int32* box_index_ptr = box_index.data();
+  float* grads_boxes_ptr = grads_boxes.data();
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto grads_acc =
+        d.get_sycl_buffer(grads_ptr).template get_access<mode::read>(cgh);
+    auto image_acc =
+        d.get_sycl_buffer(image_ptr).template get_access<mode::read>(cgh);
+    auto boxes_acc =
+        d.get_sycl_buffer(boxes_ptr).template get_access<mode::read>(cgh);
+    auto box_index_acc =
+        d.get_sycl_buffer(box_index_ptr).template get_access<mode::read>(cgh);
+    auto grads_boxes_acc = d.get_sycl_buffer(grads_boxes_ptr)
+                               .template get_access<mode::write>(cgh);
+    crop_and_resize_sycl::local_accessor scratch(
+        cl::sycl::range<1>(4 * local_size), cgh);
+    crop_and_resize_sycl::CropAndResizeBackpropBoxesSYCL<T> functor(
+        grads_acc, d.get_offset(grads_ptr) / sizeof(float), image_acc,
+        d.get_offset(image_ptr) / sizeof(T), boxes_acc,
+        d.get_offset(boxes_ptr) / sizeof(float), box_index_acc,
+        d.get_offset(box_index_ptr) / sizeof(int32), grads_boxes_acc,
+        d.get_offset(grads_boxes_ptr) / sizeof(float), scratch,
+        image.dimension(0), image.dimension(1), image.dimension(2),
+        grads.dimension(1), grads.dimension(2), grads.dimension(3));
+    cgh.parallel_for(range, functor);
+  });
+}
+
+}  // namespace functor
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_CROP_AND_RESIZE_OP_SYCL_H_
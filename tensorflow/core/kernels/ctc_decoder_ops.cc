@@ -291,41 +291,49 @@ class CTCBeamSearchDecoderOp : public OpKernel {
 
     log_prob_t.setZero();
 
-    std::vector<TTypes<float>::UnalignedConstMatrix> input_list_t;
-
-    for (std::size_t t = 0; t < max_time; ++t) {
-      input_list_t.emplace_back(inputs_t.data() + t * batch_size * num_classes,
-                                batch_size, num_classes);
-    }
-
-    ctc::CTCBeamSearchDecoder<> beam_search(num_classes, beam_width_,
-                                            &beam_scorer_, 1 /* batch_size */,
-                                            merge_repeated_);
-    Tensor input_chip(DT_FLOAT, TensorShape({num_classes}));
-    auto input_chip_t = input_chip.flat<float>();
-
     std::vector<std::vector<std::vector<int> > > best_paths(batch_size);
-    std::vector<float> log_probs;
+    std::vector<Status> statuses(batch_size);
 
     // Assumption: the blank index is num_classes - 1
-    for (int b = 0; b < batch_size; ++b) {
-      auto& best_paths_b = best_paths[b];
-      best_paths_b.resize(decode_helper_.GetTopPaths());
-      for (int t = 0; t < seq_len_t(b); ++t) {
-        input_chip_t = input_list_t[t].chip(b, 0);
-        auto input_bi =
-            Eigen::Map<const Eigen::ArrayXf>(input_chip_t.data(), num_classes);
-        beam_search.Step(input_bi);
+    auto decode = [&](const int64 begin, const int64 end) {
+      // The decoder keeps per-sequence state, so each shard needs its own.
+      ctc::CTCBeamSearchDecoder<> beam_search(num_classes, beam_width_,
+                                              &beam_scorer_, 1 /* batch_size */,
+                                              merge_repeated_);
+      // The default scorer never raises a beam's score, which makes pruning
+      // the labels that cannot enter the beam exact.
+      beam_search.SetPruneUnreachableLabels(true);
+      std::vector<float> log_probs;
+      for (int b = begin; b < end; ++b) {
+        auto& best_paths_b = best_paths[b];
+        best_paths_b.resize(decode_helper_.GetTopPaths());
+        for (int t = 0; t < seq_len_t(b); ++t) {
+          // Step reads the logits in place, without copying out the row.
+          auto input_bi = Eigen::Map<const Eigen::ArrayXf>(
+              inputs_t.data() + (t * batch_size + b) * num_classes,
+              num_classes);
+          beam_search.Step(input_bi);
+        }
+        statuses[b] = beam_search.TopPaths(decode_helper_.GetTopPaths(),
+                                           &best_paths_b, &log_probs,
+                                           merge_repeated_);
+        beam_search.Reset();
+        if (!statuses[b].ok()) continue;
+
+        for (int bp = 0; bp < decode_helper_.GetTopPaths(); ++bp) {
+          log_prob_t(b, bp) = log_probs[bp];
+        }
       }
-      OP_REQUIRES_OK(
-          ctx, beam_search.TopPaths(decode_helper_.GetTopPaths(), &best_paths_b,
-                                    &log_probs, merge_repeated_));
-
-      beam_search.Reset();
+    };
 
-      for (int bp = 0; bp < decode_helper_.GetTopPaths(); ++bp) {
-        log_prob_t(b, bp) = log_probs[bp];
-      }
+    const int64 kCostPerUnit =
+        50 * max_time * num_classes * static_cast<int64>(beam_width_);
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *ctx->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers, batch_size,
+          kCostPerUnit, decode);
+    for (const Status& status : statuses) {
+      OP_REQUIRES_OK(ctx, status);
     }
 
     OP_REQUIRES_OK(ctx, decode_helper_.StoreAllDecodedSequences(
@@ -0,0 +1,67 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifdef TENSORFLOW_USE_SYCL
+
+#define EIGEN_USE_SYCL
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/kernels/cwise_ops_sycl_fused.h"
+
+namespace tensorflow {
+
+// Runs a chain of element-wise ops created by the remapper in a single SYCL
+// kernel, so that the intermediate results never go through global memory.
+template <typename T>
+class FusedElementwiseOp : public OpKernel {
+ public:
+  explicit FusedElementwiseOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    std::vector<string> fused_ops;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("fused_ops", &fused_ops));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("num_args", &num_args_));
+    int num_binary_ops;
+    OP_REQUIRES_OK(ctx, functor::ParseFusedElementwiseOps(
+                            fused_ops, &program_, &num_binary_ops));
+    OP_REQUIRES(ctx, num_binary_ops == num_args_,
+                errors::InvalidArgument("Expected ", num_binary_ops,
+                                        " arguments for the fused ops, got ",
+                                        num_args_));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    const Tensor& x = ctx->input(0);
+    Tensor* out = nullptr;
+    OP_REQUIRES_OK(
+        ctx, ctx->forward_input_or_allocate_output({0}, 0, x.shape(), &out));
+    functor::LaunchFusedElementwise<T>(ctx, program_, 1, num_args_, x, out);
+  }
+
+ private:
+  functor::FusedElementwiseProgram program_;
+  int num_args_;
+};
+
+#define REGISTER_SYCL(type)                                  \
+  REGISTER_KERNEL_BUILDER(Name("_FusedElementwise")          \
+                              .Device(DEVICE_SYCL)           \
+                              .TypeConstraint<type>("T"),    \
+                          FusedElementwiseOp<type>);
+TF_CALL_SYCL_NUMBER_TYPES(REGISTER_SYCL);
+#undef REGISTER_SYCL
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_USE_SYCL
@@ -0,0 +1,338 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_USE_SYCL
+#error This file must only be included when building TensorFlow with SYCL support
+#endif
+
+#ifndef TENSORFLOW_CORE_KERNELS_CWISE_OPS_SYCL_FUSED_H_
+#define TENSORFLOW_CORE_KERNELS_CWISE_OPS_SYCL_FUSED_H_
+
+#include <vector>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+
+#include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/gtl/inlined_vector.h"
+
+namespace tensorflow {
+
+typedef Eigen::SyclDevice SYCLDevice;
+
+namespace functor {
+
+// Element-wise operations which can be chained in _FusedElementwise and as the
+// epilogue of _FusedConv2D.
+enum FusedElementwiseOpCode {
+  kFusedRelu = 0,
+  kFusedRelu6,
+  kFusedElu,
+  kFusedSigmoid,
+  kFusedTanh,
+  kFusedSquare,
+  kFusedNeg,
+  // Binary operations, taking their second operand from the next argument.
+  kFusedAdd,
+  kFusedSub,
+  kFusedMul,
+  kFusedMaximum,
+  kFusedMinimum,
+};
+
+// How a binary operand is indexed for a given output element.
+enum FusedElementwiseArgMode {
+  kFusedArgFull = 0,
+  kFusedArgScalar,
+  // Vector broadcast along the last dimension, as the bias of BiasAdd.
+  kFusedArgChannel,
+};
+
+constexpr int kMaxFusedOps = 8;
+constexpr int kMaxFusedArgs = 4;
+
+// Plain description of the op chain, copied by value into the SYCL kernel.
+// All the chains share the same compiled kernel for a given type, the op
+// sequence is interpreted for each element while it stays in registers.
+struct FusedElementwiseProgram {
+  int num_ops;
+  int ops[kMaxFusedOps];
+  int arg_modes[kMaxFusedArgs];
+};
+
+template <typename T>
+struct FusedElementwiseSYCL {
+  using write_accessor =
+      cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::write,
+                         cl::sycl::access::target::global_buffer>;
+  using read_accessor =
+      cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read,
+                         cl::sycl::access::target::global_buffer>;
+
+  FusedElementwiseSYCL(const FusedElementwiseProgram& program,
+                       const read_accessor x, size_t x_offset,
+                       const read_accessor arg0, size_t arg0_offset,
+                       const read_accessor arg1, size_t arg1_offset,
+                       const read_accessor arg2, size_t arg2_offset,
+                       const read_accessor arg3, size_t arg3_offset,
+                       write_accessor out, size_t out_offset, int64 channels,
+                       int64 size)
+      : program_(program),
+        x_accessor_(x),
+        arg0_accessor_(arg0),
+        arg1_accessor_(arg1),
+        arg2_accessor_(arg2),
+        arg3_accessor_(arg3),
+        out_accessor_(out),
+        x_offset_(x_offset),
+        arg0_offset_(arg0_offset),
+        arg1_offset_(arg1_offset),
+        arg2_offset_(arg2_offset),
+        arg3_offset_(arg3_offset),
+        out_offset_(out_offset),
+        channels_(channels),
+        size_(size) {}
+
+  inline T Arg(int arg, int64 i) const {
+    const T* data;
+    switch (arg) {
+      case 0:
+        data = ConvertToActualTypeSycl(T, arg0_accessor_) + arg0_offset_;
+        break;
+      case 1:
+        data = ConvertToActualTypeSycl(T, arg1_accessor_) + arg1_offset_;
+        break;
+      case 2:
+        data = ConvertToActualTypeSycl(T, arg2_accessor_) + arg2_offset_;
+        break;
+      default:
+        data = ConvertToActualTypeSycl(T, arg3_accessor_) + arg3_offset_;
+        break;
+    }
+    switch (program_.arg_modes[arg]) {
+      case kFusedArgScalar:
+        return data[0];
+      case kFusedArgChannel:
+        return data[i % channels_];
+      default:
+        return data[i];
+    }
+  }
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const int64 i = item.get_global_id(0);
+    if (i >= size_) {
+      return;
+    }
+    const T* x = ConvertToActualTypeSycl(T, x_accessor_) + x_offset_;
+    T* out = ConvertToActualTypeSycl(T, out_accessor_) + out_offset_;
+
+    const T zero(0);
+    const T one(1);
+    T v = x[i];
+    int arg = 0;
+    for (int op = 0; op < program_.num_ops; ++op) {
+      switch (program_.ops[op]) {
+        case kFusedRelu:
+          v = v > zero ? v : zero;
+          break;
+        case kFusedRelu6:
+          v = v > zero ? (v < T(6) ? v : T(6)) : zero;
+          break;
+        case kFusedElu:
+          v = v < zero ? cl::sycl::exp(v) - one : v;
+          break;
+        case kFusedSigmoid:
+          v = one / (one + cl::sycl::exp(-v));
+          break;
+        case kFusedTanh:
+          v = cl::sycl::tanh(v);
+          break;
+        case kFusedSquare:
+          v = v * v;
+          break;
+        case kFusedNeg:
+          v = -v;
+          break;
+        case kFusedAdd:
+          v = v + Arg(arg++, i);
+          break;
+        case kFusedSub:
+          v = v - Arg(arg++, i);
+          break;
+        case kFusedMul:
+          v = v * Arg(arg++, i);
+          break;
+        case kFusedMaximum: {
+          const T a = Arg(arg++, i);
+          v = v > a ? v : a;
+          break;
+        }
+        case kFusedMinimum: {
+          const T a = Arg(arg++, i);
+          v = v < a ? v : a;
+          break;
+        }
+      }
+    }
+    out[i] = v;
+  }
+
+ private:
+  const FusedElementwiseProgram program_;
+  const read_accessor x_accessor_;
+  const read_accessor arg0_accessor_;
+  const read_accessor arg1_accessor_;
+  const read_accessor arg2_accessor_;
+  const read_accessor arg3_accessor_;
+  write_accessor out_accessor_;
+  const size_t x_offset_;
+  const size_t arg0_offset_;
+  const size_t arg1_offset_;
+  const size_t arg2_offset_;
+  const size_t arg3_offset_;
+  const size_t out_offset_;
+  const int64 channels_;
+  const int64 size_;
+};
+
+
+// Fills program with the codes of fused_ops, the names of the TensorFlow ops
+// to apply in order, and sets num_args to the number of binary ops.
+inline Status ParseFusedElementwiseOps(const std::vector<string>& fused_ops,
+                                       FusedElementwiseProgram* program,
+                                       int* num_args) {
+  if (fused_ops.size() > kMaxFusedOps) {
+    return errors::InvalidArgument("At most ", kMaxFusedOps,
+                                   " ops can be fused, got ",
+                                   fused_ops.size());
+  }
+  program->num_ops = fused_ops.size();
+  *num_args = 0;
+  for (int i = 0; i < fused_ops.size(); ++i) {
+    const string& op = fused_ops[i];
+    int code;
+    if (op == "Relu") {
+      code = kFusedRelu;
+    } else if (op == "Relu6") {
+      code = kFusedRelu6;
+    } else if (op == "Elu") {
+      code = kFusedElu;
+    } else if (op == "Sigmoid") {
+      code = kFusedSigmoid;
+    } else if (op == "Tanh") {
+      code = kFusedTanh;
+    } else if (op == "Square") {
+      code = kFusedSquare;
+    } else if (op == "Neg") {
+      code = kFusedNeg;
+    } else if (op == "Add" || op == "BiasAdd") {
+      code = kFusedAdd;
+    } else if (op == "Sub") {
+      code = kFusedSub;
+    } else if (op == "Mul") {
+      code = kFusedMul;
+    } else if (op == "Maximum") {
+      code = kFusedMaximum;
+    } else if (op == "Minimum") {
+      code = kFusedMinimum;
+    } else {
+      return errors::InvalidArgument("Unsupported fused element-wise op: ", op);
+    }
+    if (code >= kFusedAdd) {
+      ++*num_args;
+    }
+    program->ops[i] = code;
+  }
+  if (*num_args > kMaxFusedArgs) {
+    return errors::InvalidArgument("At most ", kMaxFusedArgs,
+                                   " arguments can be fused, got ", *num_args);
+  }
+  return Status::OK();
+}
+
+// Applies program to x, reading the operands of the binary ops from the
+// inputs first_arg, first_arg + 1, ... of ctx, and writes the result to out.
+// out may alias x.
+template <typename T>
+void LaunchFusedElementwise(OpKernelContext* ctx,
+                            const FusedElementwiseProgram& base_program,
+                            int first_arg, int num_args, const Tensor& x,
+                            Tensor* out) {
+  const int64 size = x.NumElements();
+  const int64 channels = x.dims() > 0 ? x.dim_size(x.dims() - 1) : 1;
+
+  FusedElementwiseProgram program = base_program;
+  gtl::InlinedVector<const T*, kMaxFusedArgs> args;
+  for (int i = 0; i < num_args; ++i) {
+    const Tensor& arg = ctx->input(first_arg + i);
+    if (arg.shape() == x.shape()) {
+      program.arg_modes[i] = kFusedArgFull;
+    } else if (arg.NumElements() == 1) {
+      program.arg_modes[i] = kFusedArgScalar;
+    } else if (arg.dims() == 1 && arg.NumElements() == channels) {
+      program.arg_modes[i] = kFusedArgChannel;
+    } else {
+      ctx->CtxFailure(errors::InvalidArgument(
+          "Argument ", i, " of shape ", arg.shape().DebugString(),
+          " cannot be broadcast to ", x.shape().DebugString()));
+      return;
+    }
+    args.push_back(arg.flat<T>().data());
+  }
+  if (size == 0) {
+    return;
+  }
+
+  const T* x_data = x.flat<T>().data();
+  // Unused argument slots alias x so that every accessor is valid.
+  while (args.size() < kMaxFusedArgs) {
+    args.push_back(x_data);
+  }
+  T* out_data = out->flat<T>().data();
+  const SYCLDevice& d = ctx->eigen_sycl_device();
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto x_acc =
+        d.get_sycl_buffer(x_data).template get_access<mode::read>(cgh);
+    auto arg0_acc =
+        d.get_sycl_buffer(args[0]).template get_access<mode::read>(cgh);
+    auto arg1_acc =
+        d.get_sycl_buffer(args[1]).template get_access<mode::read>(cgh);
+    auto arg2_acc =
+        d.get_sycl_buffer(args[2]).template get_access<mode::read>(cgh);
+    auto arg3_acc =
+        d.get_sycl_buffer(args[3]).template get_access<mode::read>(cgh);
+    auto out_acc =
+        d.get_sycl_buffer(out_data).template get_access<mode::write>(cgh);
+    FusedElementwiseSYCL<T> functor(
+        program, x_acc, d.get_offset(x_data) / sizeof(T), arg0_acc,
+        d.get_offset(args[0]) / sizeof(T), arg1_acc,
+        d.get_offset(args[1]) / sizeof(T), arg2_acc,
+        d.get_offset(args[2]) / sizeof(T), arg3_acc,
+        d.get_offset(args[3]) / sizeof(T), out_acc,
+        d.get_offset(out_data) / sizeof(T), channels, size);
+    cgh.parallel_for(SYCLUtil::get_nd_range(d, size), functor);
+  });
+}
+
+}  // namespace functor
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_CWISE_OPS_SYCL_FUSED_H_
@@ -113,6 +113,16 @@ class BatchDatasetOp : public UnaryDatasetOpKernel {
             *end_of_sequence = true;
             return Status::OK();
           }
+          if (input_impl_->SupportsGetNextBatch()) {
+            // The input writes its outputs directly into the buffers of the
+            // batch.
+            TF_RETURN_IF_ERROR(input_impl_->GetNextBatch(
+                ctx, dataset()->batch_size_, out_tensors, end_of_sequence));
+            if (*end_of_sequence) {
+              input_impl_.reset();
+            }
+            return Status::OK();
+          }
           batch_elements.reserve(dataset()->batch_size_);
           *end_of_sequence = false;
           for (int i = 0; i < dataset()->batch_size_ && !*end_of_sequence;
@@ -137,9 +147,8 @@ class BatchDatasetOp : public UnaryDatasetOpKernel {
         // per tuple component.
         // NOTE(mrry): If the input or output sizes are statically
         // known, we could potentially read the input values in-place
-        // into their respective slice locations. This would require a
-        // different GetNext() overload that supports zero-copy, and might
-        // make sense in an optimization pass.
+        // into their respective slice locations. Inputs that support it do so
+        // through `GetNextBatch()` above.
         const size_t num_tuple_components = batch_elements[0].size();
         const int64 num_batch_elements = batch_elements.size();
         for (size_t component_index = 0; component_index < num_tuple_components;
@@ -12,9 +12,13 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
+#include <deque>
+
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/kernels/data/chunked_cache.h"
 #include "tensorflow/core/kernels/data/dataset.h"
+#include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
@@ -29,7 +33,11 @@ namespace {
 class CacheDatasetOp : public UnaryDatasetOpKernel {
  public:
   explicit CacheDatasetOp(OpKernelConstruction* ctx)
-      : UnaryDatasetOpKernel(ctx) {}
+      : UnaryDatasetOpKernel(ctx) {
+    string compression;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("compression", &compression));
+    OP_REQUIRES_OK(ctx, ParseCacheCompression(compression, &compression_));
+  }
 
   void MakeDataset(OpKernelContext* ctx, DatasetBase* input,
                    DatasetBase** output) override {
@@ -41,16 +49,18 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
     if (filename.empty()) {
       *output = new MemoryDataset(input);
     } else {
-      *output = new FileDataset(input, filename, ctx->env());
+      *output = new FileDataset(input, filename, compression_, ctx->env());
     }
   }
 
  private:
   class FileDataset : public DatasetBase {
    public:
-    explicit FileDataset(const DatasetBase* input, string filename, Env* env)
+    explicit FileDataset(const DatasetBase* input, string filename,
+                         CacheCompression compression, Env* env)
         : input_(input),
           filename_(std::move(filename)),
+          compression_(compression),
           env_(env),
           num_tensors_(input->output_dtypes().size()),
           tensor_index_padding_size_(StringPaddingSize(num_tensors_)),
@@ -66,7 +76,10 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
 
     std::unique_ptr<IteratorBase> MakeIteratorInternal(
         const string& prefix) const override {
-      if (env_->FileExists(strings::StrCat(filename_, ".index")).ok()) {
+      if (env_->FileExists(ChunkedCacheFilename(filename_)).ok()) {
+        return std::unique_ptr<IteratorBase>(new ChunkedReaderIterator(
+            {this, strings::StrCat(prefix, "::ChunkedReader")}));
+      } else if (env_->FileExists(strings::StrCat(filename_, ".index")).ok()) {
         return std::unique_ptr<IteratorBase>(new FileReaderIterator(
             {this, strings::StrCat(prefix, "::FileReader")}));
       } else {
@@ -100,15 +113,16 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
     // FileWriterIterator passes through and caches items from the input
     // FileDataset.
     //
-    // This iterator is used when the cache directory is not found on disk. It
-    // creates the cache directory, and passes on the underlying iterator's
-    // elements.
+    // This iterator is used when the cache file is not found on disk. It
+    // writes the elements of the underlying iterator to a chunked cache file
+    // (see chunked_cache.h), and passes them on.
     class FileWriterIterator : public DatasetIterator<FileDataset> {
      public:
       explicit FileWriterIterator(const Params& params)
           : DatasetIterator<FileDataset>(params),
-            cur_index_(0),
-            writer_(params.dataset->env_, params.dataset->filename_),
+            writer_(params.dataset->env_,
+                    ChunkedCacheFilename(params.dataset->filename_),
+                    params.dataset->num_tensors_, params.dataset->compression_),
             lockfile_(strings::StrCat(params.dataset->filename_, ".lockfile")),
             lockfile_created_(false),
             iteration_completed_(false) {}
@@ -123,22 +137,11 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
         mutex_lock l(mu_);
         TF_RETURN_IF_ERROR(EnsureLockFileExists());
         TF_RETURN_IF_ERROR(writer_.status());
-        if (cur_index_ >= kMaxItems) {
-          // As a courtesy, close the [truncated] cache file.
-          Status s = Finish();
-          if (!s.ok()) {
-            LOG(ERROR) << s;
-          }
-          return errors::InvalidArgument(
-              "Upstream iterator is producing more than ", kMaxItems,
-              " items, which is more than the cache limit.");
-        }
 
         TF_RETURN_IF_ERROR(
             input_impl_->GetNext(ctx, out_tensors, end_of_sequence));
         if (*end_of_sequence && out_tensors->empty()) {
           TF_RETURN_IF_ERROR(Finish());
-          cur_index_++;
           return Status::OK();
         }
         if (out_tensors->size() != dataset()->num_tensors_) {
@@ -146,16 +149,10 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
               "Upstream iterator returned invalid number of tensors. Expected ",
               dataset()->num_tensors_, " got: ", out_tensors->size());
         }
-        size_t tensor_index = 0;
-        for (const Tensor& t : *out_tensors) {
-          DCHECK_LT(tensor_index, dataset()->num_tensors_);
-          string key = dataset()->FormatName(cur_index_, tensor_index++);
-          TF_RETURN_IF_ERROR(writer_.Add(key, t));
-        }
+        TF_RETURN_IF_ERROR(writer_.Add(*out_tensors));
         if (*end_of_sequence) {
           TF_RETURN_IF_ERROR(Finish());
         }
-        cur_index_++;
         return Status::OK();
       }
 
@@ -204,14 +201,98 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
       }
 
       mutex mu_;
-      size_t cur_index_ GUARDED_BY(mu_);
       std::unique_ptr<IteratorBase> input_impl_ GUARDED_BY(mu_);
-      BundleWriter writer_ GUARDED_BY(mu_);
+      ChunkedCacheWriter writer_ GUARDED_BY(mu_);
       const string lockfile_;
       bool lockfile_created_ GUARDED_BY(mu_);
       bool iteration_completed_ GUARDED_BY(mu_);
     };  // FileWriterIterator
 
+    // ChunkedReaderIterator reads the elements of a chunked cache file.
+    //
+    // Up to `kReadAheadChunks` chunks after the one being consumed are read
+    // and decoded concurrently on the runner of the iterator, so that the
+    // consumer does not wait for storage or decompression.
+    class ChunkedReaderIterator : public DatasetIterator<FileDataset> {
+     public:
+      explicit ChunkedReaderIterator(const Params& params)
+          : DatasetIterator<FileDataset>(params) {}
+
+      Status Initialize(IteratorContext* ctx) override {
+        std::unique_ptr<ChunkedCacheReader> reader;
+        TF_RETURN_IF_ERROR(ChunkedCacheReader::Open(
+            dataset()->env_, ChunkedCacheFilename(dataset()->filename_),
+            dataset()->num_tensors_, &reader));
+        reader_ = std::move(reader);
+        return Status::OK();
+      }
+
+      Status GetNextInternal(IteratorContext* ctx,
+                             std::vector<Tensor>* out_tensors,
+                             bool* end_of_sequence) override {
+        mutex_lock l(mu_);
+        while (next_element_ == elements_.size()) {
+          StartReadsLocked(ctx);
+          if (chunk_results_.empty()) {
+            *end_of_sequence = true;
+            return Status::OK();
+          }
+          std::shared_ptr<ChunkResult> result = chunk_results_.front();
+          chunk_results_.pop_front();
+          if (!result->notification.HasBeenNotified()) {
+            RecordWaitStart(ctx);
+            result->notification.WaitForNotification();
+            RecordWaitStop(ctx);
+          }
+          StartReadsLocked(ctx);
+          TF_RETURN_IF_ERROR(result->status);
+          elements_ = std::move(result->elements);
+          next_element_ = 0;
+        }
+        *out_tensors = std::move(elements_[next_element_++]);
+        *end_of_sequence = false;
+        return Status::OK();
+      }
+
+     private:
+      struct ChunkResult {
+        Notification notification;
+        Status status;
+        std::vector<std::vector<Tensor>> elements;
+      };
+
+      static constexpr size_t kReadAheadChunks = 4;
+
+      // Starts reading the chunks after the ones being read. The reads share
+      // the ownership of the reader and of their result, so that they can
+      // outlive the iterator.
+      void StartReadsLocked(IteratorContext* ctx)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        while (chunk_results_.size() < kReadAheadChunks &&
+               next_chunk_ < reader_->num_chunks()) {
+          auto result = std::make_shared<ChunkResult>();
+          chunk_results_.push_back(result);
+          std::shared_ptr<const ChunkedCacheReader> reader = reader_;
+          const int64 index = next_chunk_++;
+          (*ctx->runner())([reader, result, index]() {
+            result->status = reader->ReadChunk(index, &result->elements);
+            result->notification.Notify();
+          });
+        }
+      }
+
+      mutex mu_;
+      std::shared_ptr<const ChunkedCacheReader> reader_;
+      int64 next_chunk_ GUARDED_BY(mu_) = 0;
+      // The chunks being read, in order.
+      std::deque<std::shared_ptr<ChunkResult>> chunk_results_ GUARDED_BY(mu_);
+      // The elements of the chunk being consumed.
+      std::vector<std::vector<Tensor>> elements_ GUARDED_BY(mu_);
+      size_t next_element_ GUARDED_BY(mu_) = 0;
+    };  // ChunkedReaderIterator
+
+    // FileReaderIterator reads the elements of a cache written by earlier
+    // versions in the tensor bundle format.
     class FileReaderIterator : public DatasetIterator<FileDataset> {
      public:
       explicit FileReaderIterator(const Params& params)
@@ -257,6 +338,7 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
 
     const DatasetBase* const input_;
     const string filename_;
+    const CacheCompression compression_;
     Env* const env_;
     const size_t num_tensors_;
     const size_t tensor_index_padding_size_;
@@ -410,6 +492,8 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
         GUARDED_BY(mu_);
     mutable bool writer_iterator_created_ GUARDED_BY(mu_) = false;
   };  // MemoryDataset
+
+  CacheCompression compression_;
 };    // CacheDatasetOp
 
 REGISTER_KERNEL_BUILDER(Name("CacheDataset").Device(DEVICE_CPU),
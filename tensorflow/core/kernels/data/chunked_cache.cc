@@ -0,0 +1,326 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/chunked_cache.h"
+
+#include <zlib.h>
+
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/raw_coding.h"
+#include "tensorflow/core/lib/hash/crc32c.h"
+#include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/snappy.h"
+
+namespace tensorflow {
+
+namespace {
+
+// The file header is the magic string, followed by the version of the format,
+// the number of components of each element and the compression of the chunks.
+constexpr char kMagic[] = "TFDCACHE";
+constexpr size_t kMagicSize = sizeof(kMagic) - 1;
+constexpr uint32 kVersion = 1;
+constexpr size_t kFileHeaderSize = kMagicSize + 2 * sizeof(uint32) + 1;
+
+// Each chunk starts with the size of its stored (possibly compressed) bytes,
+// the size of its uncompressed bytes and the masked CRC32C of its stored bytes.
+constexpr size_t kChunkHeaderSize = 2 * sizeof(uint64) + sizeof(uint32);
+
+Status Compress(CacheCompression compression, const string& input,
+                string* output) {
+  switch (compression) {
+    case CacheCompression::kNone:
+      *output = input;
+      return Status::OK();
+    case CacheCompression::kZlib: {
+      uLongf output_size = compressBound(input.size());
+      output->resize(output_size);
+      if (compress2(reinterpret_cast<Bytef*>(&(*output)[0]), &output_size,
+                    reinterpret_cast<const Bytef*>(input.data()),
+                    input.size(), Z_DEFAULT_COMPRESSION) != Z_OK) {
+        return errors::Internal("Failed to compress a cache chunk with zlib.");
+      }
+      output->resize(output_size);
+      return Status::OK();
+    }
+    case CacheCompression::kSnappy:
+      if (!port::Snappy_Compress(input.data(), input.size(), output)) {
+        return errors::Unimplemented(
+            "Snappy compression is not supported on this platform.");
+      }
+      return Status::OK();
+  }
+  return errors::Internal("Unknown cache compression.");
+}
+
+Status Uncompress(CacheCompression compression, StringPiece input,
+                  uint64 uncompressed_size, string* output) {
+  output->resize(uncompressed_size);
+  switch (compression) {
+    case CacheCompression::kNone:
+      return errors::Internal("Uncompress() called on an uncompressed chunk.");
+    case CacheCompression::kZlib: {
+      uLongf output_size = uncompressed_size;
+      if (uncompress(reinterpret_cast<Bytef*>(&(*output)[0]), &output_size,
+                     reinterpret_cast<const Bytef*>(input.data()),
+                     input.size()) != Z_OK ||
+          output_size != uncompressed_size) {
+        return errors::DataLoss("Corrupted zlib-compressed cache chunk.");
+      }
+      return Status::OK();
+    }
+    case CacheCompression::kSnappy: {
+      size_t output_size;
+      if (!port::Snappy_GetUncompressedLength(input.data(), input.size(),
+                                              &output_size) ||
+          output_size != uncompressed_size ||
+          !port::Snappy_Uncompress(input.data(), input.size(),
+                                   &(*output)[0])) {
+        return errors::DataLoss("Corrupted snappy-compressed cache chunk.");
+      }
+      return Status::OK();
+    }
+  }
+  return errors::Internal("Unknown cache compression.");
+}
+
+}  // namespace
+
+Status ParseCacheCompression(const string& name,
+                             CacheCompression* compression) {
+  if (name.empty()) {
+    *compression = CacheCompression::kNone;
+  } else if (name == "ZLIB") {
+    *compression = CacheCompression::kZlib;
+  } else if (name == "SNAPPY") {
+    *compression = CacheCompression::kSnappy;
+  } else {
+    return errors::InvalidArgument("Unsupported cache compression: \"", name,
+                                   "\". Expected \"\", \"ZLIB\" or \"SNAPPY\".");
+  }
+  return Status::OK();
+}
+
+string ChunkedCacheFilename(const string& prefix) {
+  return strings::StrCat(prefix, ".chunks");
+}
+
+ChunkedCacheWriter::ChunkedCacheWriter(Env* env, const string& filename,
+                                       size_t num_components,
+                                       CacheCompression compression)
+    : env_(env),
+      filename_(filename),
+      tmp_filename_(strings::StrCat(filename, ".tempstate", random::New64())),
+      num_components_(num_components),
+      compression_(compression) {
+  status_ = env_->NewWritableFile(tmp_filename_, &file_);
+  if (!status_.ok()) {
+    return;
+  }
+  string header(kMagic, kMagicSize);
+  core::PutFixed32(&header, kVersion);
+  core::PutFixed32(&header, num_components_);
+  header.push_back(static_cast<char>(compression_));
+  DCHECK_EQ(header.size(), kFileHeaderSize);
+  status_ = file_->Append(header);
+}
+
+Status ChunkedCacheWriter::Add(const std::vector<Tensor>& element) {
+  TF_RETURN_IF_ERROR(status_);
+  if (element.size() != num_components_) {
+    status_ = errors::Internal("Expected elements of ", num_components_,
+                               " components, got: ", element.size());
+    return status_;
+  }
+  for (const Tensor& t : element) {
+    TensorProto proto;
+    t.AsProtoTensorContent(&proto);
+    string serialized;
+    proto.AppendToString(&serialized);
+    core::PutVarint64(&chunk_, serialized.size());
+    chunk_.append(serialized);
+  }
+  if (chunk_.size() >= kTargetChunkBytes) {
+    status_ = WriteChunk();
+  }
+  return status_;
+}
+
+Status ChunkedCacheWriter::Finish() {
+  TF_RETURN_IF_ERROR(status_);
+  if (!chunk_.empty()) {
+    status_ = WriteChunk();
+  }
+  if (status_.ok()) {
+    status_ = file_->Close();
+  }
+  if (status_.ok()) {
+    status_ = env_->RenameFile(tmp_filename_, filename_);
+  }
+  file_.reset();
+  if (status_.ok()) {
+    // Any further operation is an error.
+    status_ = errors::FailedPrecondition("The cache has been finished.");
+    return Status::OK();
+  }
+  return status_;
+}
+
+Status ChunkedCacheWriter::WriteChunk() {
+  string stored;
+  TF_RETURN_IF_ERROR(Compress(compression_, chunk_, &stored));
+  string header;
+  core::PutFixed64(&header, stored.size());
+  core::PutFixed64(&header, chunk_.size());
+  core::PutFixed32(&header,
+                   crc32c::Mask(crc32c::Value(stored.data(), stored.size())));
+  TF_RETURN_IF_ERROR(file_->Append(header));
+  TF_RETURN_IF_ERROR(file_->Append(stored));
+  chunk_.clear();
+  return Status::OK();
+}
+
+Status ChunkedCacheReader::Open(Env* env, const string& filename,
+                                size_t num_components,
+                                std::unique_ptr<ChunkedCacheReader>* reader) {
+  std::unique_ptr<ChunkedCacheReader> result(
+      new ChunkedCacheReader(filename, num_components));
+  uint64 file_size;
+  TF_RETURN_IF_ERROR(env->GetFileSize(filename, &file_size));
+  if (!env->NewReadOnlyMemoryRegionFromFile(filename, &result->region_).ok()) {
+    // The file system does not support memory-mapping.
+    result->region_.reset();
+    TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &result->file_));
+  }
+
+  char header_scratch[kFileHeaderSize];
+  StringPiece header;
+  if (file_size < kFileHeaderSize) {
+    return errors::DataLoss("Truncated cache file: ", filename);
+  }
+  TF_RETURN_IF_ERROR(result->Read(0, kFileHeaderSize, &header, header_scratch));
+  if (StringPiece(header.data(), kMagicSize) != StringPiece(kMagic)) {
+    return errors::DataLoss("Not a cache file: ", filename);
+  }
+  const uint32 version = core::DecodeFixed32(header.data() + kMagicSize);
+  if (version != kVersion) {
+    return errors::Unimplemented("Unsupported version ", version,
+                                 " of cache file: ", filename);
+  }
+  const uint32 file_num_components =
+      core::DecodeFixed32(header.data() + kMagicSize + sizeof(uint32));
+  if (file_num_components != num_components) {
+    return errors::InvalidArgument(
+        "The cache file ", filename, " holds elements of ",
+        file_num_components, " components, but the dataset expects ",
+        num_components, ".");
+  }
+  const uint8 compression = header[kFileHeaderSize - 1];
+  if (compression > static_cast<uint8>(CacheCompression::kSnappy)) {
+    return errors::DataLoss("Unknown compression of cache file: ", filename);
+  }
+  result->compression_ = static_cast<CacheCompression>(compression);
+
+  uint64 offset = kFileHeaderSize;
+  while (offset < file_size) {
+    char chunk_header_scratch[kChunkHeaderSize];
+    StringPiece chunk_header;
+    if (offset + kChunkHeaderSize > file_size) {
+      return errors::DataLoss("Truncated cache file: ", filename);
+    }
+    TF_RETURN_IF_ERROR(result->Read(offset, kChunkHeaderSize, &chunk_header,
+                                    chunk_header_scratch));
+    Chunk chunk;
+    chunk.offset = offset + kChunkHeaderSize;
+    chunk.stored_size = core::DecodeFixed64(chunk_header.data());
+    chunk.uncompressed_size =
+        core::DecodeFixed64(chunk_header.data() + sizeof(uint64));
+    chunk.masked_crc =
+        core::DecodeFixed32(chunk_header.data() + 2 * sizeof(uint64));
+    if (chunk.stored_size > file_size - chunk.offset) {
+      return errors::DataLoss("Truncated cache file: ", filename);
+    }
+    result->chunks_.push_back(chunk);
+    offset = chunk.offset + chunk.stored_size;
+  }
+  *reader = std::move(result);
+  return Status::OK();
+}
+
+Status ChunkedCacheReader::ReadChunk(
+    int64 index, std::vector<std::vector<Tensor>>* elements) const {
+  const Chunk& chunk = chunks_[index];
+  std::unique_ptr<char[]> scratch;
+  if (file_) {
+    scratch.reset(new char[chunk.stored_size]);
+  }
+  StringPiece stored;
+  TF_RETURN_IF_ERROR(
+      Read(chunk.offset, chunk.stored_size, &stored, scratch.get()));
+  if (crc32c::Unmask(chunk.masked_crc) !=
+      crc32c::Value(stored.data(), stored.size())) {
+    return errors::DataLoss("Checksum mismatch in chunk ", index,
+                            " of cache file: ", filename_);
+  }
+  string uncompressed;
+  StringPiece data = stored;
+  if (compression_ != CacheCompression::kNone) {
+    TF_RETURN_IF_ERROR(Uncompress(compression_, stored,
+                                  chunk.uncompressed_size, &uncompressed));
+    data = uncompressed;
+  }
+
+  elements->clear();
+  while (!data.empty()) {
+    std::vector<Tensor> element(num_components_);
+    for (size_t i = 0; i < num_components_; ++i) {
+      uint64 size;
+      if (!core::GetVarint64(&data, &size) || size > data.size()) {
+        return errors::DataLoss("Corrupted chunk ", index,
+                                " of cache file: ", filename_);
+      }
+      TensorProto proto;
+      if (!proto.ParseFromArray(data.data(), size) ||
+          !element[i].FromProto(proto)) {
+        return errors::DataLoss("Corrupted tensor in chunk ", index,
+                                " of cache file: ", filename_);
+      }
+      data.remove_prefix(size);
+    }
+    elements->push_back(std::move(element));
+  }
+  return Status::OK();
+}
+
+Status ChunkedCacheReader::Read(uint64 offset, size_t n, StringPiece* result,
+                                char* scratch) const {
+  if (region_) {
+    if (offset + n > region_->length()) {
+      return errors::OutOfRange("Read past the end of cache file: ",
+                                filename_);
+    }
+    *result = StringPiece(static_cast<const char*>(region_->data()) + offset, n);
+    return Status::OK();
+  }
+  TF_RETURN_IF_ERROR(file_->Read(offset, n, result, scratch));
+  if (result->size() != n) {
+    return errors::DataLoss("Truncated cache file: ", filename_);
+  }
+  return Status::OK();
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,129 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_KERNELS_DATA_CHUNKED_CACHE_H_
+#define TENSORFLOW_CORE_KERNELS_DATA_CHUNKED_CACHE_H_
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// The compression applied to each chunk of a chunked cache file.
+enum class CacheCompression : uint8 {
+  kNone = 0,
+  kZlib = 1,
+  kSnappy = 2,
+};
+
+// Parses "", "ZLIB" or "SNAPPY" into `compression`.
+Status ParseCacheCompression(const string& name, CacheCompression* compression);
+
+// Returns the name of the chunked cache file of a cache with the given
+// filename prefix.
+string ChunkedCacheFilename(const string& prefix);
+
+// Writes the elements of a dataset to a chunked cache file.
+//
+// The file is a header followed by a sequence of chunks, each of which holds
+// the serialized components of a run of elements, is optionally compressed,
+// and is checksummed. The elements are written to a temporary file, which is
+// renamed to `filename` by `Finish()`, so that the existence of `filename`
+// means that the cache is complete.
+//
+// This class is not thread-safe.
+class ChunkedCacheWriter {
+ public:
+  // A chunk is written once the serialized elements it holds reach this size.
+  static constexpr size_t kTargetChunkBytes = 4 << 20;  // 4 MB
+
+  ChunkedCacheWriter(Env* env, const string& filename, size_t num_components,
+                     CacheCompression compression);
+
+  // The status of the writer. Once an operation fails, all the following ones
+  // fail with the same status.
+  Status status() const { return status_; }
+
+  // Appends an element, whose size must be `num_components`.
+  Status Add(const std::vector<Tensor>& element);
+
+  // Writes the last chunk, and publishes the file under `filename`.
+  Status Finish();
+
+ private:
+  Status WriteChunk();
+
+  Env* const env_;
+  const string filename_;
+  const string tmp_filename_;
+  const size_t num_components_;
+  const CacheCompression compression_;
+  std::unique_ptr<WritableFile> file_;
+  // The serialized components of the elements of the current chunk.
+  string chunk_;
+  Status status_;
+};
+
+// Reads the chunks of a file written by `ChunkedCacheWriter`.
+//
+// The file is memory-mapped when the file system supports it, and read
+// through `RandomAccessFile` otherwise.
+//
+// This class is thread-safe, so that several chunks can be decoded
+// concurrently.
+class ChunkedCacheReader {
+ public:
+  static Status Open(Env* env, const string& filename, size_t num_components,
+                     std::unique_ptr<ChunkedCacheReader>* reader);
+
+  int64 num_chunks() const { return chunks_.size(); }
+
+  // Decompresses and parses the elements of the chunk `index`.
+  Status ReadChunk(int64 index,
+                   std::vector<std::vector<Tensor>>* elements) const;
+
+ private:
+  struct Chunk {
+    uint64 offset;  // Of the stored bytes, after the chunk header.
+    uint64 stored_size;
+    uint64 uncompressed_size;
+    uint32 masked_crc;
+  };
+
+  ChunkedCacheReader(const string& filename, size_t num_components)
+      : filename_(filename), num_components_(num_components) {}
+
+  // Reads `n` bytes at `offset` of the file into `result`, which may point
+  // into `scratch`.
+  Status Read(uint64 offset, size_t n, StringPiece* result,
+              char* scratch) const;
+
+  const string filename_;
+  const size_t num_components_;
+  CacheCompression compression_ = CacheCompression::kNone;
+  // Exactly one of them is set.
+  std::unique_ptr<ReadOnlyMemoryRegion> region_;
+  std::unique_ptr<RandomAccessFile> file_;
+  std::vector<Chunk> chunks_;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_DATA_CHUNKED_CACHE_H_
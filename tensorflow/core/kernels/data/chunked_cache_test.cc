@@ -0,0 +1,132 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/data/chunked_cache.h"
+
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Returns the element `i` of the test dataset: an int64 scalar and a string
+// vector large enough for the elements to span several chunks.
+std::vector<Tensor> MakeElement(int64 i) {
+  Tensor scalar(DT_INT64, TensorShape({}));
+  scalar.scalar<int64>()() = i;
+  Tensor strings(DT_STRING, TensorShape({2}));
+  strings.vec<string>()(0) = strings::StrCat("element ", i);
+  strings.vec<string>()(1) = string(64 << 10, 'a' + i % 26);
+  return {scalar, strings};
+}
+
+void WriteAndRead(const string& name, CacheCompression compression) {
+  const string filename =
+      ChunkedCacheFilename(io::JoinPath(testing::TmpDir(), name));
+  const int64 kNumElements = 200;
+  {
+    ChunkedCacheWriter writer(Env::Default(), filename, 2, compression);
+    for (int64 i = 0; i < kNumElements; ++i) {
+      TF_ASSERT_OK(writer.Add(MakeElement(i)));
+    }
+    // The cache is only published once it is complete.
+    EXPECT_FALSE(Env::Default()->FileExists(filename).ok());
+    TF_ASSERT_OK(writer.Finish());
+  }
+
+  std::unique_ptr<ChunkedCacheReader> reader;
+  TF_ASSERT_OK(
+      ChunkedCacheReader::Open(Env::Default(), filename, 2, &reader));
+  EXPECT_GT(reader->num_chunks(), 1);
+  int64 i = 0;
+  for (int64 chunk = 0; chunk < reader->num_chunks(); ++chunk) {
+    std::vector<std::vector<Tensor>> elements;
+    TF_ASSERT_OK(reader->ReadChunk(chunk, &elements));
+    for (const std::vector<Tensor>& element : elements) {
+      std::vector<Tensor> expected = MakeElement(i++);
+      ASSERT_EQ(2, element.size());
+      test::ExpectTensorEqual<int64>(expected[0], element[0]);
+      test::ExpectTensorEqual<string>(expected[1], element[1]);
+    }
+  }
+  EXPECT_EQ(kNumElements, i);
+}
+
+TEST(ChunkedCacheTest, Uncompressed) {
+  WriteAndRead("uncompressed", CacheCompression::kNone);
+}
+
+TEST(ChunkedCacheTest, Zlib) { WriteAndRead("zlib", CacheCompression::kZlib); }
+
+TEST(ChunkedCacheTest, Empty) {
+  const string filename =
+      ChunkedCacheFilename(io::JoinPath(testing::TmpDir(), "empty"));
+  ChunkedCacheWriter writer(Env::Default(), filename, 1,
+                            CacheCompression::kNone);
+  TF_ASSERT_OK(writer.Finish());
+  std::unique_ptr<ChunkedCacheReader> reader;
+  TF_ASSERT_OK(
+      ChunkedCacheReader::Open(Env::Default(), filename, 1, &reader));
+  EXPECT_EQ(0, reader->num_chunks());
+}
+
+TEST(ChunkedCacheTest, MismatchedComponents) {
+  const string filename =
+      ChunkedCacheFilename(io::JoinPath(testing::TmpDir(), "mismatched"));
+  ChunkedCacheWriter writer(Env::Default(), filename, 2,
+                            CacheCompression::kNone);
+  TF_ASSERT_OK(writer.Add(MakeElement(0)));
+  TF_ASSERT_OK(writer.Finish());
+  std::unique_ptr<ChunkedCacheReader> reader;
+  EXPECT_FALSE(
+      ChunkedCacheReader::Open(Env::Default(), filename, 3, &reader).ok());
+}
+
+TEST(ChunkedCacheTest, CorruptedChunk) {
+  const string filename =
+      ChunkedCacheFilename(io::JoinPath(testing::TmpDir(), "corrupted"));
+  {
+    ChunkedCacheWriter writer(Env::Default(), filename, 2,
+                              CacheCompression::kNone);
+    TF_ASSERT_OK(writer.Add(MakeElement(0)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), filename, &contents));
+  contents[contents.size() - 1] ^= 1;
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), filename, contents));
+
+  std::unique_ptr<ChunkedCacheReader> reader;
+  TF_ASSERT_OK(
+      ChunkedCacheReader::Open(Env::Default(), filename, 2, &reader));
+  std::vector<std::vector<Tensor>> elements;
+  EXPECT_TRUE(errors::IsDataLoss(reader->ReadChunk(0, &elements)));
+}
+
+TEST(ChunkedCacheTest, ParseCompression) {
+  CacheCompression compression;
+  TF_EXPECT_OK(ParseCacheCompression("", &compression));
+  EXPECT_EQ(CacheCompression::kNone, compression);
+  TF_EXPECT_OK(ParseCacheCompression("ZLIB", &compression));
+  EXPECT_EQ(CacheCompression::kZlib, compression);
+  TF_EXPECT_OK(ParseCacheCompression("SNAPPY", &compression));
+  EXPECT_EQ(CacheCompression::kSnappy, compression);
+  EXPECT_FALSE(ParseCacheCompression("GZIP", &compression).ok());
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -12,9 +12,13 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
+#include <deque>
+
+#include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/function.h"
 #include "tensorflow/core/common_runtime/graph_runner.h"
 #include "tensorflow/core/common_runtime/renamed_device.h"
+#include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/common_runtime/threadpool_device.h"
 #include "tensorflow/core/framework/iterator.pb.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
@@ -26,12 +30,15 @@ limitations under the License.
 #include "tensorflow/core/kernels/data/dataset.h"
 #include "tensorflow/core/kernels/data/dataset_utils.h"
 #include "tensorflow/core/kernels/ops_util.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mem.h"
 #include "tensorflow/core/public/session_options.h"
 
 namespace tensorflow {
@@ -43,6 +50,10 @@ namespace {
 
 const char kIteratorVariantTypeName[] = "tensorflow::Iterator";
 
+// Period at which the performance model of an input pipeline reallocates the
+// tunable parameters.
+const int64 kOptimizationPeriodMicros = 1000000;
+
 Status VerifyTypesMatch(const DataTypeVector& expected,
                         const DataTypeVector& received) {
   if (expected.size() != received.size()) {
@@ -95,7 +106,18 @@ class IteratorResource : public ResourceBase {
         lib_(lib),
         iterator_(nullptr),
         output_dtypes_(output_dtypes),
-        output_shapes_(output_shapes) {}
+        output_shapes_(output_shapes),
+        tracer_(std::make_shared<DatasetTracer>()) {}
+
+  ~IteratorResource() override {
+    {
+      mutex_lock l(optimize_mu_);
+      cancelled_ = true;
+      optimize_cond_var_.notify_all();
+    }
+    // Joins the optimization thread.
+    optimize_thread_.reset();
+  }
 
   Status GetNext(IteratorContext* ctx, std::vector<Tensor>* out_tensors,
                  bool* end_of_sequence) {
@@ -104,6 +126,9 @@ class IteratorResource : public ResourceBase {
       if (lib_ != nullptr) {
         ctx->set_lib(lib_);
       }
+      if (ctx->model() && ctx->model()->enabled()) {
+        EnsureOptimizeThreadStarted(ctx->env());
+      }
       return captured_iterator->GetNext(ctx, out_tensors, end_of_sequence);
     } else {
       return errors::FailedPrecondition(
@@ -159,9 +184,11 @@ class IteratorResource : public ResourceBase {
     TF_RETURN_IF_ERROR(GetDatasetFromVariantTensor(outputs[0], &dataset));
 
     IteratorContext iter_ctx = dataset::MakeIteratorContext(ctx);
+    iter_ctx.set_model(std::make_shared<model::Model>());
+    iter_ctx.set_tracer(tracer_);
     std::unique_ptr<IteratorBase> iterator;
     TF_RETURN_IF_ERROR(dataset->MakeIterator(&iter_ctx, "Iterator", &iterator));
-    TF_RETURN_IF_ERROR(set_iterator(std::move(iterator)));
+    TF_RETURN_IF_ERROR(set_iterator(std::move(iterator), iter_ctx.model()));
     std::shared_ptr<IteratorBase> captured_iterator(iterator_);
 
     if (captured_iterator) {
@@ -173,6 +200,8 @@ class IteratorResource : public ResourceBase {
       params.allocator_getter = [device](AllocatorAttributes attrs) {
         return device->GetAllocator(attrs);
       };
+      params.model = model();
+      params.tracer = tracer_;
       IteratorContext iter_ctx(std::move(params));
 
       TF_RETURN_IF_ERROR(captured_iterator->Restore(&iter_ctx, reader));
@@ -195,24 +224,36 @@ class IteratorResource : public ResourceBase {
     return lib_def_;
   }
 
-  // Transfers ownership of iterator to this. This method is thread-safe.
-  Status set_iterator(std::unique_ptr<IteratorBase> iterator) {
+  // Transfers ownership of iterator to this, along with the performance model
+  // of its input pipeline. This method is thread-safe.
+  Status set_iterator(std::unique_ptr<IteratorBase> iterator,
+                      std::shared_ptr<model::Model> model) {
     if (iterator) {
       TF_RETURN_IF_ERROR(
           VerifyTypesMatch(output_dtypes_, iterator->output_dtypes()));
       TF_RETURN_IF_ERROR(
           VerifyShapesCompatible(output_shapes_, iterator->output_shapes()));
     }
+    {
+      mutex_lock l(mu_);
+      model_ = std::move(model);
+    }
     iterator_.reset(iterator.release());
     return Status::OK();
   }
 
+  std::shared_ptr<model::Model> model() {
+    tf_shared_lock l(mu_);
+    return model_;
+  }
 
   std::shared_ptr<StatsAggregator> stats_aggregator() {
     tf_shared_lock l(mu_);
     return stats_aggregator_;
   }
 
+  const std::shared_ptr<DatasetTracer>& tracer() const { return tracer_; }
+
   string DebugString() override { return "Iterator resource"; }
 
   const DataTypeVector& output_dtypes() const { return output_dtypes_; }
@@ -222,6 +263,35 @@ class IteratorResource : public ResourceBase {
   }
 
  private:
+  void EnsureOptimizeThreadStarted(Env* env) {
+    mutex_lock l(optimize_mu_);
+    if (!optimize_thread_ && !cancelled_) {
+      optimize_thread_.reset(env->StartThread(
+          {}, "iterator_optimize_thread", [this]() { OptimizeThread(); }));
+    }
+  }
+
+  // Periodically reallocates the tunable parameters of the input pipeline,
+  // using the schedulable CPUs and half of the available memory.
+  void OptimizeThread() {
+    const int64 cpu_budget = port::NumSchedulableCPUs();
+    const int64 ram_budget = port::AvailableRam() / 2;
+    while (true) {
+      {
+        mutex_lock l(optimize_mu_);
+        optimize_cond_var_.wait_for(
+            l, std::chrono::microseconds(kOptimizationPeriodMicros));
+        if (cancelled_) {
+          return;
+        }
+      }
+      std::shared_ptr<model::Model> captured_model = model();
+      if (captured_model && captured_model->enabled()) {
+        captured_model->Optimize(cpu_budget, ram_budget);
+      }
+    }
+  }
+
   // The following (device_mgr_, flib_def_, pflr_) are only used when the
   // IteratorResource is shared between sessions and in that case we create
   // a new FLR. Otherwise these are set to null.
@@ -233,8 +303,15 @@ class IteratorResource : public ResourceBase {
   mutex mu_;
   std::shared_ptr<StatsAggregator> stats_aggregator_ GUARDED_BY(mu_);
   std::shared_ptr<const FunctionLibraryDefinition> lib_def_ GUARDED_BY(mu_);
+  std::shared_ptr<model::Model> model_ GUARDED_BY(mu_);
   const DataTypeVector output_dtypes_;
   const std::vector<PartialTensorShape> output_shapes_;
+  const std::shared_ptr<DatasetTracer> tracer_;
+
+  mutex optimize_mu_;
+  condition_variable optimize_cond_var_;
+  bool cancelled_ GUARDED_BY(optimize_mu_) = false;
+  std::unique_ptr<Thread> optimize_thread_ GUARDED_BY(optimize_mu_);
 };
 
 // Helper class for reading data from a VariantTensorData object.
@@ -662,10 +739,13 @@ class MakeIteratorOp : public OpKernel {
     core::ScopedUnref unref(iterator_resource);
 
     IteratorContext iter_ctx = dataset::MakeIteratorContext(ctx);
+    iter_ctx.set_model(std::make_shared<model::Model>());
+    iter_ctx.set_tracer(iterator_resource->tracer());
     std::unique_ptr<IteratorBase> iterator;
     OP_REQUIRES_OK(ctx,
                    dataset->MakeIterator(&iter_ctx, "Iterator", &iterator));
-    OP_REQUIRES_OK(ctx, iterator_resource->set_iterator(std::move(iterator)));
+    OP_REQUIRES_OK(ctx, iterator_resource->set_iterator(std::move(iterator),
+                                                        iter_ctx.model()));
   }
 };
 
@@ -877,9 +957,12 @@ class OneShotIteratorOp : public AsyncOpKernel {
     DatasetBase* dataset;
     TF_RETURN_IF_ERROR(GetDatasetFromVariantTensor(return_values[0], &dataset));
     IteratorContext iter_ctx = dataset::MakeIteratorContext(ctx);
+    iter_ctx.set_model(std::make_shared<model::Model>());
+    iter_ctx.set_tracer((*iterator)->tracer());
     std::unique_ptr<IteratorBase> iter;
     TF_RETURN_IF_ERROR(dataset->MakeIterator(&iter_ctx, "Iterator", &iter));
-    TF_RETURN_IF_ERROR((*iterator)->set_iterator(std::move(iter)));
+    TF_RETURN_IF_ERROR(
+        (*iterator)->set_iterator(std::move(iter), iter_ctx.model()));
 
     (*iterator)->Ref();
     return Status::OK();
@@ -920,6 +1003,28 @@ class OneShotIteratorOp : public AsyncOpKernel {
   const int graph_def_version_;
 };
 
+// Gets the next element of `iterator`. If the step is traced, the `GetNext()`
+// calls of the iterators of the input pipeline that complete in the meantime
+// (including on its background threads) are added to the step stats.
+Status GetNextAndTrace(OpKernelContext* ctx, IteratorResource* iterator,
+                       IteratorContext* iter_ctx,
+                       std::vector<Tensor>* components, bool* end_of_sequence) {
+  StepStatsCollector* stats_collector = ctx->stats_collector();
+  if (stats_collector == nullptr) {
+    return iterator->GetNext(iter_ctx, components, end_of_sequence);
+  }
+  DatasetTracer* tracer = iterator->tracer().get();
+  tracer->Start();
+  Status s = iterator->GetNext(iter_ctx, components, end_of_sequence);
+  std::vector<NodeExecStats> stats;
+  tracer->Stop(&stats);
+  const string& device = ctx->device()->attributes().name();
+  for (NodeExecStats& node_stats : stats) {
+    stats_collector->Save(device, new NodeExecStats(std::move(node_stats)));
+  }
+  return s;
+}
+
 class IteratorGetNextOp : public AsyncOpKernel {
  public:
   explicit IteratorGetNextOp(OpKernelConstruction* ctx)
@@ -953,10 +1058,12 @@ class IteratorGetNextOp : public AsyncOpKernel {
           params.allocator_getter = [device](AllocatorAttributes attrs) {
             return device->GetAllocator(attrs);
           };
+          params.model = iterator->model();
+          params.tracer = iterator->tracer();
           IteratorContext iter_ctx(std::move(params));
 
-          Status s =
-              iterator->GetNext(&iter_ctx, &components, &end_of_sequence);
+          Status s = GetNextAndTrace(ctx, iterator, &iter_ctx, &components,
+                                     &end_of_sequence);
           // NOTE(mrry): We must unref the iterator before calling `done()`, to
           // avoid destruction races.
           iterator->Unref();
@@ -1004,10 +1111,12 @@ class IteratorGetNextSyncOp : public OpKernel {
     params.allocator_getter = [device](AllocatorAttributes attrs) {
       return device->GetAllocator(attrs);
     };
+    params.model = iterator->model();
+    params.tracer = iterator->tracer();
     IteratorContext iter_ctx(std::move(params));
 
-    OP_REQUIRES_OK(ctx,
-                   iterator->GetNext(&iter_ctx, &components, &end_of_sequence));
+    OP_REQUIRES_OK(ctx, GetNextAndTrace(ctx, iterator, &iter_ctx, &components,
+                                        &end_of_sequence));
     OP_REQUIRES(ctx, !end_of_sequence, errors::OutOfRange("End of sequence"));
 
     for (int i = 0; i < components.size(); ++i) {
@@ -1146,6 +1255,329 @@ class DeserializeIteratorOp : public OpKernel {
   }
 };
 
+// Buffers the elements of an iterator on a local CPU device in the memory of
+// another device. A background thread reads the elements and copies them to
+// the device through its default `DeviceContext`, which issues the copies on
+// the host-to-device stream (or queue), so that they overlap with the steps
+// that consume the previous elements.
+class DevicePrefetchIteratorResource : public ResourceBase {
+ public:
+  DevicePrefetchIteratorResource(Env* env, Device* source_device,
+                                 const ResourceHandle& source_handle,
+                                 Device* target_device, int64 buffer_size)
+      : env_(env),
+        source_device_(source_device),
+        source_handle_(source_handle),
+        target_device_(target_device),
+        buffer_size_(buffer_size) {}
+
+  ~DevicePrefetchIteratorResource() override { Reset(); }
+
+  string DebugString() override {
+    return strings::StrCat("DevicePrefetchIterator. Size: ", buffer_size_,
+                           "; target_device: ", target_device_->name());
+  }
+
+  Status GetNext(std::vector<Tensor>* out_tensors, bool* end_of_sequence) {
+    mutex_lock l(mu_);
+    if (!prefetch_thread_ && !end_of_sequence_) {
+      prefetch_thread_.reset(env_->StartThread(
+          {}, "device_prefetch_thread", [this]() { PrefetchThread(); }));
+    }
+    while (!cancelled_ && buffer_.empty() && !end_of_sequence_) {
+      cond_var_.wait(l);
+    }
+    if (cancelled_) {
+      return errors::Cancelled("DevicePrefetchIterator was reset.");
+    }
+    if (buffer_.empty()) {
+      *end_of_sequence = true;
+      return Status::OK();
+    }
+    BufferElement element = std::move(buffer_.front());
+    buffer_.pop_front();
+    cond_var_.notify_all();
+    *out_tensors = std::move(element.value);
+    *end_of_sequence = false;
+    return element.status;
+  }
+
+  // Stops the prefetching thread and discards the buffered elements. The next
+  // call to `GetNext()` restarts the prefetching.
+  void Reset() LOCKS_EXCLUDED(mu_) {
+    std::unique_ptr<Thread> prefetch_thread;
+    {
+      mutex_lock l(mu_);
+      cancelled_ = true;
+      cond_var_.notify_all();
+      prefetch_thread = std::move(prefetch_thread_);
+    }
+    // Joins the prefetching thread.
+    prefetch_thread.reset();
+    mutex_lock l(mu_);
+    buffer_.clear();
+    end_of_sequence_ = false;
+    cancelled_ = false;
+  }
+
+ private:
+  struct BufferElement {
+    // The prefetching thread sets `status` if reading or copying the element
+    // fails.
+    Status status;
+    std::vector<Tensor> value;
+  };
+
+  void PrefetchThread() {
+    while (true) {
+      {
+        mutex_lock l(mu_);
+        while (!cancelled_ && buffer_.size() >= buffer_size_) {
+          cond_var_.wait(l);
+        }
+        if (cancelled_) {
+          return;
+        }
+      }
+      BufferElement element;
+      bool end_of_sequence = false;
+      element.status = ReadElement(&element.value, &end_of_sequence);
+      mutex_lock l(mu_);
+      if (element.status.ok() && end_of_sequence) {
+        end_of_sequence_ = true;
+        cond_var_.notify_all();
+        return;
+      }
+      buffer_.push_back(std::move(element));
+      cond_var_.notify_all();
+    }
+  }
+
+  // Reads the next element of the source iterator, and copies it to the
+  // target device.
+  Status ReadElement(std::vector<Tensor>* out_tensors, bool* end_of_sequence) {
+    IteratorResource* iterator;
+    TF_RETURN_IF_ERROR(source_device_->resource_manager()->Lookup(
+        source_handle_.container(), source_handle_.name(), &iterator));
+    core::ScopedUnref unref_iterator(iterator);
+
+    IteratorContext::Params params;
+    params.env = env_;
+    params.stats_aggregator_getter = [iterator]() {
+      return iterator->stats_aggregator();
+    };
+    thread::ThreadPool* pool =
+        source_device_->tensorflow_cpu_worker_threads()->workers;
+    params.runner = [pool](std::function<void()> c) {
+      pool->Schedule(std::move(c));
+    };
+    params.function_library = iterator->function_library();
+    // The elements are allocated in host memory from which the target device
+    // can copy asynchronously (i.e. pinned memory for GPUs).
+    Device* target_device = target_device_;
+    params.allocator_getter = [target_device](AllocatorAttributes attrs) {
+      attrs.set_on_host(true);
+      attrs.set_gpu_compatible(true);
+      return target_device->GetAllocator(attrs);
+    };
+    params.model = iterator->model();
+    params.tracer = iterator->tracer();
+    IteratorContext iter_ctx(std::move(params));
+
+    std::vector<Tensor> host_tensors;
+    TF_RETURN_IF_ERROR(
+        iterator->GetNext(&iter_ctx, &host_tensors, end_of_sequence));
+    if (*end_of_sequence) {
+      return Status::OK();
+    }
+
+    const DeviceBase::GpuDeviceInfo* device_info =
+        target_device_->tensorflow_gpu_device_info();
+    if (device_info == nullptr || device_info->default_context == nullptr) {
+      // The target device shares the memory of the host.
+      *out_tensors = std::move(host_tensors);
+      return Status::OK();
+    }
+    out_tensors->clear();
+    out_tensors->reserve(host_tensors.size());
+    for (const Tensor& t : host_tensors) {
+      out_tensors->emplace_back(target_device_->GetAllocator({}), t.dtype(),
+                                t.shape());
+    }
+    // Issues the copies of all the components before waiting for them.
+    mutex status_mu;
+    Status status;
+    BlockingCounter counter(host_tensors.size());
+    for (size_t i = 0; i < host_tensors.size(); ++i) {
+      device_info->default_context->CopyCPUTensorToDevice(
+          &host_tensors[i], target_device_, &(*out_tensors)[i],
+          [&status_mu, &status, &counter](const Status& s) {
+            {
+              mutex_lock l(status_mu);
+              status.Update(s);
+            }
+            counter.DecrementCount();
+          });
+    }
+    counter.Wait();
+    return status;
+  }
+
+  Env* const env_;
+  Device* const source_device_;     // Not owned.
+  const ResourceHandle source_handle_;
+  Device* const target_device_;     // Not owned.
+  const int64 buffer_size_;
+
+  mutex mu_;
+  condition_variable cond_var_;
+  std::deque<BufferElement> buffer_ GUARDED_BY(mu_);
+  std::unique_ptr<Thread> prefetch_thread_ GUARDED_BY(mu_);
+  bool end_of_sequence_ GUARDED_BY(mu_) = false;
+  bool cancelled_ GUARDED_BY(mu_) = false;
+};
+
+class DevicePrefetchIteratorHandleOp : public OpKernel {
+ public:
+  explicit DevicePrefetchIteratorHandleOp(OpKernelConstruction* ctx)
+      : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("buffer_size", &buffer_size_));
+    DataTypeVector output_dtypes;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("output_types", &output_dtypes));
+    if (ctx->device_type() != DeviceType(DEVICE_CPU)) {
+      for (DataType dtype : output_dtypes) {
+        OP_REQUIRES(ctx, DataTypeCanUseMemcpy(dtype),
+                    errors::InvalidArgument(
+                        "Elements with components of type ",
+                        DataTypeString(dtype), " cannot be prefetched to a ",
+                        ctx->device_type().type(), " device."));
+      }
+    }
+  }
+
+  ~DevicePrefetchIteratorHandleOp() override {
+    if (cinfo_.resource_is_private_to_kernel()) {
+      if (!cinfo_.resource_manager()
+               ->Delete<DevicePrefetchIteratorResource>(cinfo_.container(),
+                                                        cinfo_.name())
+               .ok()) {
+        // Do nothing; the resource can have been deleted by session resets.
+      }
+    }
+  }
+
+  void Compute(OpKernelContext* ctx) override LOCKS_EXCLUDED(mu_) {
+    const Tensor& string_handle_t = ctx->input(0);
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(string_handle_t.shape()),
+                errors::InvalidArgument("string_handle must be a scalar"));
+    ResourceHandle source_handle;
+    OP_REQUIRES(
+        ctx, source_handle.ParseFromString(string_handle_t.scalar<string>()()),
+        errors::InvalidArgument(
+            "Could not parse string_handle as a valid ResourceHandle"));
+
+    mutex_lock l(mu_);
+    if (!initialized_) {
+      FunctionLibraryRuntime* lib = ctx->function_library();
+      OP_REQUIRES(ctx, lib != nullptr && lib->device_mgr() != nullptr,
+                  errors::Internal("No function library is provided."));
+      Device* source_device;
+      OP_REQUIRES_OK(ctx, lib->device_mgr()->LookupDevice(
+                              source_handle.device(), &source_device));
+      OP_REQUIRES(ctx, source_device->device_type() == DEVICE_CPU,
+                  errors::InvalidArgument(
+                      "The iterator to prefetch from must be on a CPU device, "
+                      "but it is on device \"", source_handle.device(),
+                      "\"."));
+      Device* target_device = lib->device();
+
+      OP_REQUIRES_OK(ctx, cinfo_.Init(ctx->resource_manager(), def()));
+      DevicePrefetchIteratorResource* resource;
+      OP_REQUIRES_OK(
+          ctx,
+          ctx->resource_manager()
+              ->LookupOrCreate<DevicePrefetchIteratorResource>(
+                  cinfo_.container(), cinfo_.name(), &resource,
+                  [ctx, source_device, &source_handle, target_device,
+                   this](DevicePrefetchIteratorResource** ret) {
+                    *ret = new DevicePrefetchIteratorResource(
+                        ctx->env(), source_device, source_handle,
+                        target_device, buffer_size_);
+                    return Status::OK();
+                  }));
+      resource->Unref();
+      initialized_ = true;
+    }
+    OP_REQUIRES_OK(ctx, MakeResourceHandleToOutput(
+                            ctx, 0, cinfo_.container(), cinfo_.name(),
+                            MakeTypeIndex<DevicePrefetchIteratorResource>()));
+  }
+
+ private:
+  mutex mu_;
+  ContainerInfo cinfo_ GUARDED_BY(mu_);
+  bool initialized_ GUARDED_BY(mu_) = false;
+  int64 buffer_size_;
+};
+
+class DevicePrefetchIteratorGetNextOp : public AsyncOpKernel {
+ public:
+  explicit DevicePrefetchIteratorGetNextOp(OpKernelConstruction* ctx)
+      : AsyncOpKernel(ctx),
+        thread_pool_(new thread::ThreadPool(
+            ctx->env(), ThreadOptions(),
+            strings::StrCat("device_prefetch_get_next_thread_",
+                            SanitizeThreadSuffix(name())),
+            1 /* num_threads */, false /* low_latency_hint */)) {}
+
+  void ComputeAsync(OpKernelContext* ctx, DoneCallback done) override {
+    DevicePrefetchIteratorResource* iterator;
+    OP_REQUIRES_OK_ASYNC(
+        ctx, LookupResource(ctx, HandleFromInput(ctx, 0), &iterator), done);
+    // The call to `iterator->GetNext()` blocks until the prefetching thread
+    // has buffered an element, so we issue the call from the owned thread
+    // pool.
+    thread_pool_->Schedule(std::bind(
+        [ctx, iterator](DoneCallback done) {
+          std::vector<Tensor> components;
+          bool end_of_sequence = false;
+          Status s = iterator->GetNext(&components, &end_of_sequence);
+          // NOTE(mrry): We must unref the iterator before calling `done()`, to
+          // avoid destruction races.
+          iterator->Unref();
+
+          if (!s.ok()) {
+            ctx->SetStatus(s);
+          } else if (end_of_sequence) {
+            ctx->SetStatus(errors::OutOfRange("End of sequence"));
+          } else {
+            for (int i = 0; i < components.size(); ++i) {
+              ctx->set_output(i, components[i]);
+            }
+          }
+          done();
+        },
+        std::move(done)));
+  }
+
+ private:
+  std::unique_ptr<thread::ThreadPool> thread_pool_;
+};
+
+class DevicePrefetchIteratorResetOp : public OpKernel {
+ public:
+  explicit DevicePrefetchIteratorResetOp(OpKernelConstruction* ctx)
+      : OpKernel(ctx) {}
+
+  void Compute(OpKernelContext* ctx) override {
+    DevicePrefetchIteratorResource* iterator;
+    OP_REQUIRES_OK(ctx,
+                   LookupResource(ctx, HandleFromInput(ctx, 0), &iterator));
+    core::ScopedUnref unref_iterator(iterator);
+    iterator->Reset();
+  }
+};
+
 
 REGISTER_KERNEL_BUILDER(Name("Iterator").Device(DEVICE_CPU), IteratorHandleOp);
 REGISTER_KERNEL_BUILDER(Name("MakeIterator").Device(DEVICE_CPU),
@@ -1168,6 +1600,47 @@ REGISTER_KERNEL_BUILDER(Name("SerializeIterator").Device(DEVICE_CPU),
                         SerializeIteratorOp);
 REGISTER_KERNEL_BUILDER(Name("DeserializeIterator").Device(DEVICE_CPU),
                         DeserializeIteratorOp);
+REGISTER_KERNEL_BUILDER(Name("DevicePrefetchIterator")
+                            .Device(DEVICE_CPU)
+                            .HostMemory("string_handle")
+                            .HostMemory("handle"),
+                        DevicePrefetchIteratorHandleOp);
+REGISTER_KERNEL_BUILDER(Name("DevicePrefetchIteratorGetNext")
+                            .Device(DEVICE_CPU)
+                            .HostMemory("iterator"),
+                        DevicePrefetchIteratorGetNextOp);
+REGISTER_KERNEL_BUILDER(Name("DevicePrefetchIteratorReset")
+                            .Device(DEVICE_CPU)
+                            .HostMemory("iterator"),
+                        DevicePrefetchIteratorResetOp);
+REGISTER_KERNEL_BUILDER(Name("DevicePrefetchIterator")
+                            .Device(DEVICE_GPU)
+                            .HostMemory("string_handle")
+                            .HostMemory("handle"),
+                        DevicePrefetchIteratorHandleOp);
+REGISTER_KERNEL_BUILDER(Name("DevicePrefetchIteratorGetNext")
+                            .Device(DEVICE_GPU)
+                            .HostMemory("iterator"),
+                        DevicePrefetchIteratorGetNextOp);
+REGISTER_KERNEL_BUILDER(Name("DevicePrefetchIteratorReset")
+                            .Device(DEVICE_GPU)
+                            .HostMemory("iterator"),
+                        DevicePrefetchIteratorResetOp);
+#ifdef TENSORFLOW_USE_SYCL
+REGISTER_KERNEL_BUILDER(Name("DevicePrefetchIterator")
+                            .Device(DEVICE_SYCL)
+                            .HostMemory("string_handle")
+                            .HostMemory("handle"),
+                        DevicePrefetchIteratorHandleOp);
+REGISTER_KERNEL_BUILDER(Name("DevicePrefetchIteratorGetNext")
+                            .Device(DEVICE_SYCL)
+                            .HostMemory("iterator"),
+                        DevicePrefetchIteratorGetNextOp);
+REGISTER_KERNEL_BUILDER(Name("DevicePrefetchIteratorReset")
+                            .Device(DEVICE_SYCL)
+                            .HostMemory("iterator"),
+                        DevicePrefetchIteratorResetOp);
+#endif  // TENSORFLOW_USE_SYCL
 
 }  // namespace
 
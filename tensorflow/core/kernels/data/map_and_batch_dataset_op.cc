@@ -26,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/tracing.h"
 
 namespace tensorflow {
@@ -44,6 +45,9 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("f", &func_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("output_types", &output_types_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("output_shapes", &output_shapes_));
+    if (op_version_ == 2) {
+      OP_REQUIRES_OK(ctx, ctx->GetAttr("sloppy", &sloppy_));
+    }
   }
 
  protected:
@@ -77,7 +81,9 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
       case 2:
         OP_REQUIRES_OK(ctx, ParseScalarArgument(ctx, "num_parallel_calls",
                                                 &num_parallel_calls));
-        OP_REQUIRES(ctx, num_parallel_calls > 0,
+        OP_REQUIRES(ctx,
+                    num_parallel_calls > 0 ||
+                        num_parallel_calls == model::kAutoTune,
                     errors::InvalidArgument(
                         "num_parallel_calls must be greater than zero."));
         break;
@@ -96,15 +102,16 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
                             func_, std::move(other_arguments), &captured_func));
 
     *output = new Dataset(ctx, input, batch_size, num_parallel_calls,
-                          drop_remainder, output_types_, output_shapes_, func_,
-                          std::move(captured_func), &ctx->eigen_cpu_device());
+                          drop_remainder, sloppy_, output_types_,
+                          output_shapes_, func_, std::move(captured_func),
+                          &ctx->eigen_cpu_device());
   }
 
  private:
   class Dataset : public GraphDatasetBase {
    public:
     Dataset(OpKernelContext* ctx, const DatasetBase* input, int64 batch_size,
-            int64 num_parallel_calls, bool drop_remainder,
+            int64 num_parallel_calls, bool drop_remainder, bool sloppy,
             const DataTypeVector& output_types,
             const std::vector<PartialTensorShape>& output_shapes,
             const NameAttrList& func,
@@ -115,6 +122,7 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
           batch_size_(batch_size),
           num_parallel_calls_(num_parallel_calls),
           drop_remainder_(drop_remainder),
+          sloppy_(sloppy),
           output_types_(output_types),
           output_shapes_(output_shapes),
           map_fn_(func),
@@ -171,6 +179,15 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
       b->BuildAttrValue(map_fn_, &f);
       AttrValue other_arguments_types_attr;
       b->BuildAttrValue(other_arguments_types, &other_arguments_types_attr);
+      std::vector<std::pair<StringPiece, AttrValue>> attrs = {
+          std::make_pair("f", f),
+          std::make_pair("Targuments", other_arguments_types_attr)};
+      // Only `MapAndBatchDatasetV2` has the attr.
+      if (sloppy_) {
+        AttrValue sloppy_attr;
+        b->BuildAttrValue(sloppy_, &sloppy_attr);
+        attrs.emplace_back("sloppy", sloppy_attr);
+      }
 
       TF_RETURN_IF_ERROR(b->AddDataset(
           this,
@@ -179,9 +196,7 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
            std::make_pair(3, num_parallel_calls_node),
            std::make_pair(4, drop_remainder_node)},  // Single tensor inputs.
           {std::make_pair(1, other_arguments)},      // Tensor list inputs.
-          {std::make_pair("f", f),
-           std::make_pair("Targuments", other_arguments_types_attr)},  // Attrs
-          output));
+          attrs, output));
       return Status::OK();
     }
 
@@ -190,7 +205,7 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
      public:
       explicit Iterator(const Params& params)
           : DatasetIterator<Dataset>(params),
-            batch_results_((params.dataset->num_parallel_calls_ +
+            batch_results_((MaxParallelism(params.dataset) +
                             params.dataset->batch_size_ - 1) /
                            params.dataset->batch_size_) {
         for (int i = 0; i < batch_results_.size(); ++i) {
@@ -199,6 +214,9 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
       }
 
       ~Iterator() override {
+        if (parallelism_) {
+          parallelism_->Disconnect();
+        }
         mutex_lock l(mu_);
         // Cancel the runner thread.
         cancelled_ = true;
@@ -210,6 +228,21 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
       }
 
       Status Initialize(IteratorContext* ctx) override {
+        if (dataset()->num_parallel_calls_ == model::kAutoTune) {
+          parallelism_ = std::make_shared<model::SharedState>(1, [this]() {
+            mutex_lock l(mu_);
+            cond_var_.notify_all();
+          });
+          if (ctx->model()) {
+            ctx->model()->AddParameter(prefix(),
+                                       model::ParameterKind::kParallelism,
+                                       parallelism_, 1,
+                                       MaxParallelism(dataset()));
+          }
+        } else {
+          parallelism_ = std::make_shared<model::SharedState>(
+              dataset()->num_parallel_calls_, nullptr);
+        }
         return dataset()->input_->MakeIterator(ctx, prefix(), &input_impl_);
       }
 
@@ -220,7 +253,9 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
         mutex_lock l(mu_);
         EnsureRunnerThreadStarted(ctx);
         BatchResult* result = &batch_results_[ComputeIndex(input_batch_)];
+        RecordWaitStart(ctx);
         WaitForBatch(result, &l);
+        RecordWaitStop(ctx);
         return ProcessBatch(ctx, result, out_tensors, end_of_sequence);
       }
 
@@ -283,11 +318,14 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
         condition_variable cond_var;  // access guarded by owner's mutex
         // Counts the number of outstanding calls for this batch.
         int64 num_calls;  // access guarded by owner's mutex
+        // In sloppy mode, counts the elements assigned to this batch.
+        int64 num_claimed;  // access guarded by owner's mutex
 
         void Initialize(int64 batch_size) {
           mutex_lock l(mu);
           end_of_input = false;
           num_calls = batch_size;
+          num_claimed = 0;
           num_elements = 0;
           output_allocated = false;
           status = Status::OK();
@@ -303,6 +341,9 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
                     BatchResult* result, std::vector<Tensor>* return_values,
                     int64 offset, const Status& status) {
         std::unique_ptr<std::vector<Tensor>> cleanup_retvals(return_values);
+        if (dataset()->sloppy_) {
+          ClaimSlot(&result, &offset);
+        }
         result->UpdateStatus(status);
         if (status.ok()) {
           EnsureOutputAllocated(ctx, result, return_values);
@@ -340,6 +381,30 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
         }
       }
 
+      // Assigns the element of a completed call to the earliest batch that is
+      // missing elements, so that a slow call does not hold back the batches
+      // that the calls completing after it can fill.
+      //
+      // Each batch expects one completion per call scheduled for it (and
+      // not ended by the end of the input), and the calls are scheduled in
+      // batch order, so there is always a batch at or before the one the
+      // call was scheduled for with an unassigned slot.
+      void ClaimSlot(BatchResult** result, int64* offset) LOCKS_EXCLUDED(mu_) {
+        mutex_lock l(mu_);
+        const int64 num_batches =
+            std::min<int64>(output_batch_ - input_batch_ + 1,
+                            batch_results_.size());
+        for (int64 i = 0; i < num_batches; ++i) {
+          BatchResult* candidate =
+              &batch_results_[ComputeIndex(input_batch_ + i)];
+          if (candidate->num_calls > candidate->num_claimed) {
+            *result = candidate;
+            break;
+          }
+        }
+        *offset = (*result)->num_claimed++;
+      }
+
       void CallCompleted(BatchResult* result) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
         num_calls_--;
         cond_var_.notify_all();
@@ -371,15 +436,35 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
             [this, result, offset](std::shared_ptr<IteratorContext> ctx,
                                    std::vector<Tensor> input_element) {
               std::vector<Tensor>* return_values = new std::vector<Tensor>();
+              const bool record =
+                  ctx->model() != nullptr && ctx->model()->enabled();
+              const uint64 start_micros = record ? ctx->env()->NowMicros() : 0;
               dataset()->captured_func_->RunAsync(
                   ctx.get(), std::move(input_element), return_values,
-                  [this, ctx, result, return_values, offset](Status status) {
+                  [this, ctx, result, return_values, offset, record,
+                   start_micros](Status status) {
+                    if (record) {
+                      // The function runs on the threads of the runner,
+                      // outside of `GetNext()`. This must happen before
+                      // `Callback()`, which may release the destructor.
+                      ctx->model()->AddProcessingTime(
+                          prefix(), ctx->env()->NowMicros() - start_micros);
+                    }
                     Callback(ctx, result, return_values, offset, status);
                   });
             },
             ctx, std::move(input_element)));
       }
 
+      // The largest number of calls the iterator may run in parallel, which
+      // bounds the number of batches it builds at once.
+      static int64 MaxParallelism(const Dataset* dataset) {
+        if (dataset->num_parallel_calls_ == model::kAutoTune) {
+          return port::NumSchedulableCPUs();
+        }
+        return dataset->num_parallel_calls_;
+      }
+
       int64 ComputeIndex(int64 n) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
         return n % batch_results_.size();
       }
@@ -489,7 +574,7 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
         mutex_lock l(mu_);
         while (true) {
           while (!cancelled_ &&
-                 (num_calls_ == dataset()->num_parallel_calls_ ||
+                 (num_calls_ >= parallelism_->value() ||
                   (output_batch_ - input_batch_ == batch_results_.size()))) {
             cond_var_.wait(l);
           }
@@ -498,7 +583,7 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
             return;
           }
 
-          while (num_calls_ < dataset()->num_parallel_calls_ &&
+          while (num_calls_ < parallelism_->value() &&
                  (output_batch_ - input_batch_ < batch_results_.size())) {
             BatchResult* result = &batch_results_[ComputeIndex(output_batch_)];
             int64 offset = call_counter_++ % dataset()->batch_size_;
@@ -663,6 +748,8 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
       std::vector<BatchResult> batch_results_ GUARDED_BY(mu_);
       std::unique_ptr<Thread> runner_thread_ GUARDED_BY(mu_);
       bool cancelled_ GUARDED_BY(mu_) = false;
+      // The number of calls to keep in flight.
+      std::shared_ptr<model::SharedState> parallelism_;
     };
 
     const DatasetBase* const input_;
@@ -670,6 +757,9 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
     const int64 batch_size_;
     const int64 num_parallel_calls_;
     const bool drop_remainder_;
+    // Whether the elements may be batched in the order in which their calls
+    // complete, rather than in the order of the input.
+    const bool sloppy_;
     const DataTypeVector output_types_;
     const std::vector<PartialTensorShape> output_shapes_;
     const NameAttrList map_fn_;
@@ -682,6 +772,7 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
   DataTypeVector output_types_;
   std::vector<PartialTensorShape> output_shapes_;
   NameAttrList func_;
+  bool sloppy_ = false;
 };
 
 REGISTER_KERNEL_BUILDER(Name("MapAndBatchDataset").Device(DEVICE_CPU),
@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 #include <deque>
+#include <limits>
 
 #include "tensorflow/core/common_runtime/function.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
@@ -70,7 +71,8 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
     OP_REQUIRES_OK(ctx, ParseScalarArgument(ctx, "buffer_output_elements",
                                             &buffer_output_elements));
     OP_REQUIRES(
-        ctx, buffer_output_elements > 0,
+        ctx, buffer_output_elements > 0 ||
+                 buffer_output_elements == model::kAutoTune,
         errors::InvalidArgument("`buffer_output_elements` must be > 0"));
 
     int64 prefetch_input_elements = 0;
@@ -240,6 +242,9 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
             worker_thread_states_(dataset()->num_threads()) {}
 
       ~Iterator() override {
+        if (buffer_output_elements_) {
+          buffer_output_elements_->Disconnect();
+        }
         mutex_lock l(mu_);
         cancelled_ = true;
         // Notify all workers in case they are blocked.
@@ -249,6 +254,26 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
       }
 
       Status Initialize(IteratorContext* ctx) override {
+        // The `cycle_length` determines the order of the output elements, so
+        // only the buffering of the workers is tuned.
+        if (dataset()->buffer_output_elements_ == model::kAutoTune) {
+          buffer_output_elements_ =
+              std::make_shared<model::SharedState>(1, [this]() {
+                mutex_lock l(mu_);
+                for (auto& worker : workers_) {
+                  worker.cond_var.notify_all();
+                }
+              });
+          if (ctx->model()) {
+            ctx->model()->AddParameter(prefix(),
+                                       model::ParameterKind::kBufferSize,
+                                       buffer_output_elements_, 1,
+                                       std::numeric_limits<int64>::max());
+          }
+        } else {
+          buffer_output_elements_ = std::make_shared<model::SharedState>(
+              dataset()->buffer_output_elements_, nullptr);
+        }
         return dataset()->input_->MakeIterator(ctx, prefix(), &input_impl_);
       }
 
@@ -260,6 +285,10 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
                              bool* end_of_sequence) override {
         mutex_lock l(mu_);
         TF_RETURN_IF_ERROR(EnsureWorkerThreadsStarted(ctx));
+        const bool record_occupancy =
+            dataset()->buffer_output_elements_ == model::kAutoTune &&
+            ctx->model() != nullptr;
+        bool waited = false;
         while (!cancelled_) {
           // Wait for an item to become available, blocking if necessary. If we
           // are allowed to be sloppy, we can skip over input datasets that do
@@ -287,6 +316,10 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
                 block_count_ = 0;
               }
               *end_of_sequence = false;
+              if (record_occupancy) {
+                ctx->model()->RecordBufferOccupancy(
+                    prefix(), waited ? 0 : current_worker->outputs.size());
+              }
               Status s = current_worker->outputs.front().status;
               current_worker->outputs.front().output.swap(*out_tensors);
               current_worker->outputs.pop_front();
@@ -341,11 +374,14 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
 
           if (must_wait_for_input) {
             // Wait for elements to become available.
+            waited = true;
+            RecordWaitStart(ctx);
             if (dataset()->sloppy_) {
               sloppy_cond_var_.wait(l);
             } else {
               workers_[interleave_indices_[next_index_]].cond_var.wait(l);
             }
+            RecordWaitStop(ctx);
           }
         }
         return errors::Cancelled(
@@ -590,6 +626,13 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
         return Status::OK();
       }
 
+      // Returns true if the worker `thread_index` must wait for the client to
+      // consume its buffered elements.
+      bool OutputsFull(int64 thread_index) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        return static_cast<int64>(workers_[thread_index].outputs.size()) >=
+               buffer_output_elements_->value();
+      }
+
       // Produces elements into the worker's output buffers.
       void WorkerThread(IteratorContext* ctx_ptr, const int64 thread_index) {
         // Notes on checkpointing thread local state, i.e., `WorkerThreadState`:
@@ -703,8 +746,7 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
           if (!iterator_creation_status.ok()) {
             mutex_lock l(mu_);
             // Wait for space in the prefetch queue.
-            while (!cancelled_ && workers_[thread_index].outputs.size() ==
-                                      dataset()->buffer_output_elements_) {
+            while (!cancelled_ && OutputsFull(thread_index)) {
               workers_[thread_index].cond_var.wait(l);
             }
             if (cancelled_) return;
@@ -752,8 +794,7 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
                 mutex_lock l(mu_);
 
                 // Wait for space in the prefetch queue.
-                while (!cancelled_ && workers_[thread_index].outputs.size() ==
-                                          dataset()->buffer_output_elements_) {
+                while (!cancelled_ && OutputsFull(thread_index)) {
                   workers_[thread_index].cond_var.wait(l);
                 }
                 if (cancelled_) return;
@@ -1032,6 +1073,8 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
       size_t block_count_ GUARDED_BY(mu_) = 0;
       // Flag to instruct the worker threads to exit.
       bool cancelled_ GUARDED_BY(mu_) = false;
+      // The number of elements each worker buffers ahead of the client.
+      std::shared_ptr<model::SharedState> buffer_output_elements_;
       // The worker threads. This must be last to ensure the
       // threads have exited before any other members are deallocated.
       // TODO(b/65178177): Avoid allocating additional threads.
@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/data/dataset.h"
 #include "tensorflow/core/lib/core/error_codes.pb.h"
 #include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/platform/cpu_info.h"
 
 namespace tensorflow {
 
@@ -37,6 +38,7 @@ class ParallelMapDatasetOp : public UnaryDatasetOpKernel {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("f", &func_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("output_types", &output_types_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("output_shapes", &output_shapes_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("sloppy", &sloppy_));
   }
 
  protected:
@@ -53,7 +55,8 @@ class ParallelMapDatasetOp : public UnaryDatasetOpKernel {
     int32 num_parallel_calls;
     OP_REQUIRES_OK(ctx, ParseScalarArgument(ctx, "num_parallel_calls",
                                             &num_parallel_calls));
-    OP_REQUIRES(ctx, num_parallel_calls > 0,
+    OP_REQUIRES(ctx, num_parallel_calls > 0 ||
+                         num_parallel_calls == model::kAutoTune,
                 errors::InvalidArgument(
                     "num_parallel_calls must be greater than zero."));
 
@@ -61,15 +64,16 @@ class ParallelMapDatasetOp : public UnaryDatasetOpKernel {
     OP_REQUIRES_OK(ctx, CapturedFunction::Create(
                             func_, std::move(other_arguments), &captured_func));
 
-    *output = new Dataset(ctx, input, func_, num_parallel_calls, output_types_,
-                          output_shapes_, std::move(captured_func));
+    *output = new Dataset(ctx, input, func_, num_parallel_calls, sloppy_,
+                          output_types_, output_shapes_,
+                          std::move(captured_func));
   }
 
  private:
   class Dataset : public GraphDatasetBase {
    public:
     Dataset(OpKernelContext* ctx, const DatasetBase* input,
-            const NameAttrList& func, int32 num_parallel_calls,
+            const NameAttrList& func, int32 num_parallel_calls, bool sloppy,
             const DataTypeVector& output_types,
             const std::vector<PartialTensorShape>& output_shapes,
             std::unique_ptr<CapturedFunction> captured_func)
@@ -77,6 +81,7 @@ class ParallelMapDatasetOp : public UnaryDatasetOpKernel {
           input_(input),
           func_(func),
           num_parallel_calls_(num_parallel_calls),
+          sloppy_(sloppy),
           output_types_(output_types),
           output_shapes_(output_shapes),
           captured_func_(std::move(captured_func)) {
@@ -136,13 +141,18 @@ class ParallelMapDatasetOp : public UnaryDatasetOpKernel {
       AttrValue other_arguments_types_attr;
       b->BuildAttrValue(other_arguments_types, &other_arguments_types_attr);
 
+      // Attr: sloppy
+      AttrValue sloppy_attr;
+      b->BuildAttrValue(sloppy_, &sloppy_attr);
+
       TF_RETURN_IF_ERROR(b->AddDataset(
           this,
           {std::make_pair(0, input_graph_node),
            std::make_pair(2, num_parallel_calls)},  // Single tensor inputs.
           {std::make_pair(1, other_arguments)},     // Tensor list inputs.
           {std::make_pair("f", f),
-           std::make_pair("Targuments", other_arguments_types_attr)},  // Attrs
+           std::make_pair("Targuments", other_arguments_types_attr),
+           std::make_pair("sloppy", sloppy_attr)},  // Attrs
           output));
       return Status::OK();
     }
@@ -151,8 +161,7 @@ class ParallelMapDatasetOp : public UnaryDatasetOpKernel {
     class Iterator : public DatasetIterator<Dataset> {
      public:
       explicit Iterator(const Params& params)
-          : DatasetIterator<Dataset>(params),
-            invocation_results_(params.dataset->num_parallel_calls_) {}
+          : DatasetIterator<Dataset>(params) {}
 
       ~Iterator() override {
         // TODO(mrry): Replace this cancellation logic with a
@@ -160,17 +169,27 @@ class ParallelMapDatasetOp : public UnaryDatasetOpKernel {
         // but it would be possible to thread a cancellation manager
         // through the IteratorContext to upstream,
         // potentially-blocking iterators, when we add these.
-        {
-          mutex_lock l(mu_);
-          for (size_t i = 0; i < dataset()->num_parallel_calls_; ++i) {
-            if (invocation_results_[i].notification) {
-              invocation_results_[i].notification->WaitForNotification();
-            }
+        mutex_lock l(mu_);
+        for (const auto& result : invocation_results_) {
+          if (result->notification) {
+            result->notification->WaitForNotification();
           }
         }
       }
 
       Status Initialize(IteratorContext* ctx) override {
+        if (dataset()->num_parallel_calls_ == model::kAutoTune) {
+          parallelism_ = std::make_shared<model::SharedState>(1, nullptr);
+          if (ctx->model()) {
+            ctx->model()->AddParameter(prefix(),
+                                       model::ParameterKind::kParallelism,
+                                       parallelism_, 1,
+                                       port::NumSchedulableCPUs());
+          }
+        } else {
+          parallelism_ = std::make_shared<model::SharedState>(
+              dataset()->num_parallel_calls_, nullptr);
+        }
         return dataset()->input_->MakeIterator(ctx, prefix(), &input_impl_);
       }
 
@@ -179,31 +198,36 @@ class ParallelMapDatasetOp : public UnaryDatasetOpKernel {
                              bool* end_of_sequence) override {
         mutex_lock l(mu_);
 
-        // Ensure that there are `dataset()->num_parallel_calls_`
-        // invocations of `func_` outstanding at once.
-        while (input_impl_ && (num_inputs_consumed_ - num_outputs_consumed_ <
-                               dataset()->num_parallel_calls_)) {
+        // Ensure that there are `parallelism_->value()` invocations of
+        // `func_` outstanding at once. The parallelism may change between
+        // calls when it is tuned, in which case the outstanding invocations
+        // drain or grow to the new value.
+        while (input_impl_ && static_cast<int64>(invocation_results_.size()) <
+                                  parallelism_->value()) {
           InvokeFunctionLocked(ctx);
         }
 
-        if (!input_impl_ && num_inputs_consumed_ == num_outputs_consumed_) {
+        if (invocation_results_.empty()) {
           *end_of_sequence = true;
           return Status::OK();
         }
 
-        // Read the next result out of `invocation_results_`, which
-        // acts as a circular buffer.
-        const size_t result_index =
-            num_outputs_consumed_ % dataset()->num_parallel_calls_;
-        InvocationResult* result = &invocation_results_[result_index];
+        std::shared_ptr<InvocationResult> result;
+        if (dataset()->sloppy_) {
+          result = NextCompletedResultLocked(ctx);
+        } else {
+          result = invocation_results_.front();
+          invocation_results_.pop_front();
+        }
         *end_of_sequence = false;
         if (result->notification) {
+          RecordWaitStart(ctx);
           result->notification->WaitForNotification();
+          RecordWaitStop(ctx);
           if (result->status.ok()) {
             std::swap(*out_tensors, result->return_values);
           }
         }
-        ++num_outputs_consumed_;
         if (errors::IsOutOfRange(result->status)) {
           // `f` may deliberately raise `errors::OutOfRange` to indicate
           // that we should terminate the iteration early.
@@ -223,30 +247,23 @@ class ParallelMapDatasetOp : public UnaryDatasetOpKernel {
           TF_RETURN_IF_ERROR(
               writer->WriteScalar(full_name("end_of_input"), ""));
         }
-        TF_RETURN_IF_ERROR(writer->WriteScalar(full_name("num_inputs_consumed"),
-                                               num_inputs_consumed_));
         TF_RETURN_IF_ERROR(writer->WriteScalar(
-            full_name("num_outputs_consumed"), num_outputs_consumed_));
+            full_name("invocation_results.size"), invocation_results_.size()));
 
-        for (size_t i = 0; i < dataset()->num_parallel_calls_; i++) {
-          if (invocation_results_[i].notification) {
-            invocation_results_[i].notification->WaitForNotification();
-            TF_RETURN_IF_ERROR(
-                WriteStatusLocked(writer, i, invocation_results_[i].status));
-            TF_RETURN_IF_ERROR(writer->WriteScalar(
-                full_name(strings::StrCat("invocation_results[", i, "].size")),
-                invocation_results_[i].return_values.size()));
-            for (size_t j = 0; j < invocation_results_[i].return_values.size();
-                 j++) {
-              TF_RETURN_IF_ERROR(writer->WriteTensor(
-                  full_name(
-                      strings::StrCat("invocation_results[", i, "][", j, "]")),
-                  invocation_results_[i].return_values[j]));
-            }
-          } else {
-            TF_RETURN_IF_ERROR(writer->WriteScalar(
-                full_name(strings::StrCat("invocation_results[", i, "]_empty")),
-                ""));
+        for (size_t i = 0; i < invocation_results_.size(); i++) {
+          InvocationResult* result = invocation_results_[i].get();
+          if (result->notification) {
+            result->notification->WaitForNotification();
+          }
+          TF_RETURN_IF_ERROR(WriteStatusLocked(writer, i, result->status));
+          TF_RETURN_IF_ERROR(writer->WriteScalar(
+              full_name(strings::StrCat("invocation_results[", i, "].size")),
+              result->return_values.size()));
+          for (size_t j = 0; j < result->return_values.size(); j++) {
+            TF_RETURN_IF_ERROR(writer->WriteTensor(
+                full_name(
+                    strings::StrCat("invocation_results[", i, "][", j, "]")),
+                result->return_values[j]));
           }
         }
 
@@ -261,42 +278,39 @@ class ParallelMapDatasetOp : public UnaryDatasetOpKernel {
         } else {
           TF_RETURN_IF_ERROR(RestoreParent(ctx, reader, input_impl_));
         }
-        TF_RETURN_IF_ERROR(reader->ReadScalar(full_name("num_inputs_consumed"),
-                                              &num_inputs_consumed_));
-        TF_RETURN_IF_ERROR(reader->ReadScalar(full_name("num_outputs_consumed"),
-                                              &num_outputs_consumed_));
-        for (size_t i = 0; i < dataset()->num_parallel_calls_; i++) {
-          InvocationResult* result = &invocation_results_[i];
-          *result = InvocationResult();
-          if (!reader->Contains(full_name(
-                  strings::StrCat("invocation_results[", i, "]_empty")))) {
-            result->notification.reset(new Notification);
-            result->notification->Notify();
-            TF_RETURN_IF_ERROR(ReadStatusLocked(reader, i, &result->status));
-            size_t num_return_values;
-            {
-              int64 size;
-              TF_RETURN_IF_ERROR(
-                  reader->ReadScalar(full_name(strings::StrCat(
-                                         "invocation_results[", i, "].size")),
-                                     &size));
-              num_return_values = static_cast<size_t>(size);
-              if (num_return_values != size) {
-                return errors::InvalidArgument(strings::StrCat(
-                    full_name(
-                        strings::StrCat("invocation_results[", i, "].size")),
-                    ": ", size, " is not a valid value of type size_t."));
-              }
-            }
-            result->return_values.reserve(num_return_values);
-            for (size_t j = 0; j < num_return_values; j++) {
-              result->return_values.emplace_back();
-              TF_RETURN_IF_ERROR(reader->ReadTensor(
+        int64 invocation_results_size;
+        TF_RETURN_IF_ERROR(reader->ReadScalar(
+            full_name("invocation_results.size"), &invocation_results_size));
+        invocation_results_.clear();
+        for (int64 i = 0; i < invocation_results_size; i++) {
+          std::shared_ptr<InvocationResult> result(new InvocationResult);
+          result->notification.reset(new Notification);
+          result->notification->Notify();
+          TF_RETURN_IF_ERROR(ReadStatusLocked(reader, i, &result->status));
+          size_t num_return_values;
+          {
+            int64 size;
+            TF_RETURN_IF_ERROR(
+                reader->ReadScalar(full_name(strings::StrCat(
+                                       "invocation_results[", i, "].size")),
+                                   &size));
+            num_return_values = static_cast<size_t>(size);
+            if (num_return_values != size) {
+              return errors::InvalidArgument(strings::StrCat(
                   full_name(
-                      strings::StrCat("invocation_results[", i, "][", j, "]")),
-                  &result->return_values.back()));
+                      strings::StrCat("invocation_results[", i, "].size")),
+                  ": ", size, " is not a valid value of type size_t."));
             }
           }
+          result->return_values.reserve(num_return_values);
+          for (size_t j = 0; j < num_return_values; j++) {
+            result->return_values.emplace_back();
+            TF_RETURN_IF_ERROR(reader->ReadTensor(
+                full_name(
+                    strings::StrCat("invocation_results[", i, "][", j, "]")),
+                &result->return_values.back()));
+          }
+          invocation_results_.push_back(std::move(result));
         }
         return Status::OK();
       }
@@ -308,18 +322,59 @@ class ParallelMapDatasetOp : public UnaryDatasetOpKernel {
         std::vector<Tensor> return_values;
       };
 
+      // Counts the completed invocations, so that a sloppy consumer can wait
+      // for any of them. Shared with the callbacks, which may still signal it
+      // after the iterator is destroyed.
+      struct Completions {
+        mutex mu;
+        condition_variable cond_var;
+        int64 count GUARDED_BY(mu) = 0;
+      };
+
+      static bool IsReady(const InvocationResult& result) {
+        return !result.notification || result.notification->HasBeenNotified();
+      }
+
+      // Removes and returns the first completed result, waiting for one if
+      // needed. A result ending the iteration is only returned once the
+      // results before it have been, since later invocations may still
+      // produce elements.
+      std::shared_ptr<InvocationResult> NextCompletedResultLocked(
+          IteratorContext* ctx) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        while (true) {
+          int64 num_completions;
+          {
+            mutex_lock l(completions_->mu);
+            num_completions = completions_->count;
+          }
+          for (auto it = invocation_results_.begin();
+               it != invocation_results_.end(); ++it) {
+            if (IsReady(**it) && (it == invocation_results_.begin() ||
+                                  !errors::IsOutOfRange((*it)->status))) {
+              std::shared_ptr<InvocationResult> result = *it;
+              invocation_results_.erase(it);
+              return result;
+            }
+          }
+          RecordWaitStart(ctx);
+          {
+            mutex_lock l(completions_->mu);
+            while (completions_->count == num_completions) {
+              completions_->cond_var.wait(l);
+            }
+          }
+          RecordWaitStop(ctx);
+        }
+      }
+
       void InvokeFunctionLocked(IteratorContext* ctx)
           EXCLUSIVE_LOCKS_REQUIRED(mu_) {
         DCHECK(input_impl_);
-        DCHECK(num_inputs_consumed_ - num_outputs_consumed_ <
-               dataset()->num_parallel_calls_);
 
-        // The result of invoking the function will be written into the next
-        // slot in `invocation_results_`, which acts as a circular buffer.
-        const size_t result_index =
-            num_inputs_consumed_ % dataset()->num_parallel_calls_;
-        InvocationResult* result = &invocation_results_[result_index];
-        *result = InvocationResult();
+        // The result of invoking the function will be written into the
+        // result at the back of `invocation_results_`.
+        std::shared_ptr<InvocationResult> result(new InvocationResult);
+        invocation_results_.push_back(result);
 
         // Get the next input element.
         std::vector<Tensor> input_element;
@@ -329,8 +384,6 @@ class ParallelMapDatasetOp : public UnaryDatasetOpKernel {
         if (end_of_input) {
           input_impl_.reset();
           result->status = errors::OutOfRange("");
-        } else {
-          ++num_inputs_consumed_;
         }
 
         if (result->status.ok()) {
@@ -338,11 +391,29 @@ class ParallelMapDatasetOp : public UnaryDatasetOpKernel {
           // `result->return_values`, and notify `result->notification`
           // to unblock a consumer.
           result->notification.reset(new Notification);
+          std::shared_ptr<model::Model> model = ctx->model();
+          if (model && !model->enabled()) {
+            model.reset();
+          }
+          const uint64 start_micros = model ? ctx->env()->NowMicros() : 0;
+          Env* env = ctx->env();
+          const string prefix = this->prefix();
+          std::shared_ptr<Completions> completions = completions_;
           dataset()->captured_func_->RunAsync(
               ctx, std::move(input_element), &result->return_values,
-              [result, result_index](Status ret_status) {
+              [result, model, start_micros, env, prefix,
+               completions](Status ret_status) {
+                if (model) {
+                  // The function runs on the threads of the runner, so its
+                  // time is not seen by the `RecordStart()` of this iterator.
+                  model->AddProcessingTime(prefix,
+                                           env->NowMicros() - start_micros);
+                }
                 result->status.Update(ret_status);
                 result->notification->Notify();
+                mutex_lock l(completions->mu);
+                completions->count++;
+                completions->cond_var.notify_all();
               });
         }
       }
@@ -388,14 +459,22 @@ class ParallelMapDatasetOp : public UnaryDatasetOpKernel {
 
       mutex mu_;
       std::unique_ptr<IteratorBase> input_impl_ GUARDED_BY(mu_);
-      std::vector<InvocationResult> invocation_results_ GUARDED_BY(mu_);
-      int64 num_inputs_consumed_ GUARDED_BY(mu_) = 0;
-      int64 num_outputs_consumed_ GUARDED_BY(mu_) = 0;
+      // The results of the outstanding invocations of `func_`, in the order
+      // of their input elements.
+      std::deque<std::shared_ptr<InvocationResult>> invocation_results_
+          GUARDED_BY(mu_);
+      // The number of invocations of `func_` to keep outstanding.
+      std::shared_ptr<model::SharedState> parallelism_;
+      const std::shared_ptr<Completions> completions_ =
+          std::make_shared<Completions>();
     };
 
     const DatasetBase* const input_;
     const NameAttrList func_;
     const int32 num_parallel_calls_;
+    // Whether the elements may be produced in the order in which their
+    // invocations of `func_` complete, rather than in the order of the input.
+    const bool sloppy_;
     const DataTypeVector output_types_;
     const std::vector<PartialTensorShape> output_shapes_;
     const std::unique_ptr<CapturedFunction> captured_func_;
@@ -405,6 +484,7 @@ class ParallelMapDatasetOp : public UnaryDatasetOpKernel {
   DataTypeVector output_types_;
   std::vector<PartialTensorShape> output_shapes_;
   NameAttrList func_;
+  bool sloppy_;
 };
 
 REGISTER_KERNEL_BUILDER(Name("ParallelMapDataset").Device(DEVICE_CPU),
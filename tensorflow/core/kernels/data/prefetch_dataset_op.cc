@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 #include <deque>
+#include <limits>
 
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -98,6 +99,9 @@ class PrefetchDatasetOp : public UnaryDatasetOpKernel {
         // but it would be possible to thread a cancellation manager
         // through the IteratorContext to upstream,
         // potentially-blocking iterators, when we add these.
+        if (buffer_limit_) {
+          buffer_limit_->Disconnect();
+        }
         {
           mutex_lock l(mu_);
           cancelled_ = true;
@@ -106,6 +110,18 @@ class PrefetchDatasetOp : public UnaryDatasetOpKernel {
       }
 
       Status Initialize(IteratorContext* ctx) override {
+        // With a model of the input pipeline, the buffer size is tuned along
+        // with the other parameters of the pipeline, rather than on its own.
+        if (dataset()->buffer_size_ == model::kAutoTune && ctx->model()) {
+          buffer_limit_ = std::make_shared<model::SharedState>(1, [this]() {
+            mutex_lock l(mu_);
+            cond_var_.notify_all();
+          });
+          ctx->model()->AddParameter(prefix(),
+                                     model::ParameterKind::kBufferSize,
+                                     buffer_limit_, 1,
+                                     std::numeric_limits<int64>::max());
+        }
         return dataset()->input_->MakeIterator(ctx, prefix(), &input_impl_);
       }
 
@@ -114,13 +130,18 @@ class PrefetchDatasetOp : public UnaryDatasetOpKernel {
                              bool* end_of_sequence) override {
         mutex_lock l(mu_);
         TF_RETURN_IF_ERROR(EnsurePrefetchThreadStarted(ctx));
+        if (buffer_limit_ && ctx->model()) {
+          ctx->model()->RecordBufferOccupancy(prefix(), buffer_.size());
+        }
 
         while (true) {
           // Wait until the next element in the buffer has been
           // produced, or we are shutting down.
           while (!cancelled_ && !prefetch_thread_finished_ && buffer_.empty()) {
             auto_tuner_.RecordEmpty();
+            RecordWaitStart(ctx);
             cond_var_.wait(l);
+            RecordWaitStop(ctx);
           }
 
           if (cancelled_) {
@@ -250,8 +271,7 @@ class PrefetchDatasetOp : public UnaryDatasetOpKernel {
           // 1. Wait for a slot in the buffer.
           {
             mutex_lock l(mu_);
-            while (!cancelled_ &&
-                   buffer_.size() == auto_tuner_.buffer_limit()) {
+            while (!cancelled_ && buffer_.size() >= BufferLimit()) {
               cond_var_.wait(l);
             }
 
@@ -287,6 +307,14 @@ class PrefetchDatasetOp : public UnaryDatasetOpKernel {
         }
       }
 
+      // The number of elements to prefetch.
+      size_t BufferLimit() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        if (buffer_limit_) {
+          return buffer_limit_->value();
+        }
+        return auto_tuner_.buffer_limit();
+      }
+
       Status WriteStatus(IteratorStateWriter* writer, size_t index,
                          const Status& status) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
         TF_RETURN_IF_ERROR(writer->WriteScalar(
@@ -333,6 +361,9 @@ class PrefetchDatasetOp : public UnaryDatasetOpKernel {
       std::unique_ptr<IteratorBase> input_impl_ GUARDED_BY(parent_mu_);
       condition_variable cond_var_;
       PrefetchAutotuner auto_tuner_ GUARDED_BY(mu_);
+      // Set when the buffer size is tuned by the model of the input pipeline,
+      // in which case `auto_tuner_` is unused.
+      std::shared_ptr<model::SharedState> buffer_limit_;
       std::deque<BufferElement> buffer_ GUARDED_BY(mu_);
       std::unique_ptr<Thread> prefetch_thread_ GUARDED_BY(mu_);
       bool cancelled_ GUARDED_BY(mu_) = false;
@@ -109,7 +109,34 @@ class RangeDatasetOp : public DatasetOpKernel {
         return Status::OK();
       }
 
+      bool SupportsGetNextBatch() const override { return true; }
+
      protected:
+      Status GetNextBatchInternal(IteratorContext* ctx, int64 batch_size,
+                                  std::vector<Tensor>* out_tensors,
+                                  bool* end_of_sequence) override {
+        mutex_lock l(mu_);
+        const int64 step = dataset()->step_;
+        const int64 distance =
+            step > 0 ? dataset()->stop_ - next_ : next_ - dataset()->stop_;
+        if (distance <= 0) {
+          *end_of_sequence = true;
+          return Status::OK();
+        }
+        const int64 abs_step = step > 0 ? step : -step;
+        const int64 num_elements =
+            std::min(batch_size, (distance - 1) / abs_step + 1);
+        Tensor batch(ctx->allocator({}), DT_INT64, {num_elements});
+        auto values = batch.vec<int64>();
+        for (int64 i = 0; i < num_elements; ++i) {
+          values(i) = next_;
+          next_ += step;
+        }
+        out_tensors->emplace_back(std::move(batch));
+        *end_of_sequence = false;
+        return Status::OK();
+      }
+
       Status SaveInternal(IteratorStateWriter* writer) override {
         mutex_lock l(mu_);
         TF_RETURN_IF_ERROR(writer->WriteScalar(full_name("next"), next_));
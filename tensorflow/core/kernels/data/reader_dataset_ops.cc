@@ -18,6 +18,7 @@ limitations under the License.
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
 #include "tensorflow/core/lib/io/inputbuffer.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
+#include "tensorflow/core/lib/io/readahead_file.h"
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
@@ -29,6 +30,54 @@ namespace {
 // See documentation in ../ops/dataset_ops.cc for a high-level
 // description of the following ops.
 
+// Parameters of the readahead of the files read by a dataset, set from the
+// `readahead_chunks` and `readahead_chunk_size` attrs.
+struct ReadaheadOptions {
+  int64 num_chunks = 0;
+  int64 chunk_size = 0;
+};
+
+Status ParseReadaheadOptions(OpKernelConstruction* ctx,
+                             ReadaheadOptions* options) {
+  TF_RETURN_IF_ERROR(ctx->GetAttr("readahead_chunks", &options->num_chunks));
+  TF_RETURN_IF_ERROR(
+      ctx->GetAttr("readahead_chunk_size", &options->chunk_size));
+  if (options->chunk_size == 0) {
+    options->chunk_size = 1 << 20;  // 1 MiB as default.
+  }
+  return Status::OK();
+}
+
+void AddReadaheadAttrs(const ReadaheadOptions& options,
+                       GraphDefBuilderWrapper* b,
+                       std::vector<std::pair<StringPiece, AttrValue>>* attrs) {
+  AttrValue readahead_chunks;
+  AttrValue readahead_chunk_size;
+  b->BuildAttrValue(options.num_chunks, &readahead_chunks);
+  b->BuildAttrValue(options.chunk_size, &readahead_chunk_size);
+  attrs->emplace_back("readahead_chunks", readahead_chunks);
+  attrs->emplace_back("readahead_chunk_size", readahead_chunk_size);
+}
+
+// Wraps `*file` in a file that reads ahead of its reader, on the threads of
+// `*pool`, if `options` enable readahead. `*pool` is created on first use.
+void MaybeAddReadahead(Env* env, const ReadaheadOptions& options,
+                       std::unique_ptr<thread::ThreadPool>* pool,
+                       std::unique_ptr<RandomAccessFile>* file) {
+  if (options.num_chunks == 0) {
+    return;
+  }
+  if (!*pool) {
+    // Each outstanding read blocks a thread until its data arrives.
+    pool->reset(new thread::ThreadPool(env, "readahead_file",
+                                       static_cast<int>(options.num_chunks)));
+  }
+  std::unique_ptr<RandomAccessFile> base_file = std::move(*file);
+  file->reset(new io::ReadaheadRandomAccessFile(
+      std::move(base_file), pool->get(), options.chunk_size,
+      static_cast<int>(options.num_chunks)));
+}
+
 class TextLineDatasetOp : public DatasetOpKernel {
  public:
   using DatasetOpKernel::DatasetOpKernel;
@@ -264,7 +313,10 @@ REGISTER_KERNEL_BUILDER(Name("TextLineDataset").Device(DEVICE_CPU),
 
 class FixedLengthRecordDatasetOp : public DatasetOpKernel {
  public:
-  using DatasetOpKernel::DatasetOpKernel;
+  explicit FixedLengthRecordDatasetOp(OpKernelConstruction* ctx)
+      : DatasetOpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ParseReadaheadOptions(ctx, &readahead_options_));
+  }
 
   void MakeDataset(OpKernelContext* ctx, DatasetBase** output) override {
     const Tensor* filenames_tensor;
@@ -307,7 +359,7 @@ class FixedLengthRecordDatasetOp : public DatasetOpKernel {
     }
 
     *output = new Dataset(ctx, std::move(filenames), header_bytes, record_bytes,
-                          footer_bytes, buffer_size);
+                          footer_bytes, buffer_size, readahead_options_);
   }
 
  private:
@@ -315,13 +367,15 @@ class FixedLengthRecordDatasetOp : public DatasetOpKernel {
    public:
     explicit Dataset(OpKernelContext* ctx, std::vector<string> filenames,
                      int64 header_bytes, int64 record_bytes, int64 footer_bytes,
-                     int64 buffer_size)
+                     int64 buffer_size,
+                     const ReadaheadOptions& readahead_options)
         : GraphDatasetBase(ctx),
           filenames_(std::move(filenames)),
           header_bytes_(header_bytes),
           record_bytes_(record_bytes),
           footer_bytes_(footer_bytes),
-          buffer_size_(buffer_size) {}
+          buffer_size_(buffer_size),
+          readahead_options_(readahead_options) {}
 
     std::unique_ptr<IteratorBase> MakeIteratorInternal(
         const string& prefix) const override {
@@ -357,10 +411,12 @@ class FixedLengthRecordDatasetOp : public DatasetOpKernel {
       TF_RETURN_IF_ERROR(b->AddScalar(record_bytes_, &record_bytes));
       TF_RETURN_IF_ERROR(b->AddScalar(footer_bytes_, &footer_bytes));
       TF_RETURN_IF_ERROR(b->AddScalar(buffer_size_, &buffer_size));
+      std::vector<std::pair<StringPiece, AttrValue>> attrs;
+      AddReadaheadAttrs(readahead_options_, b, &attrs);
       TF_RETURN_IF_ERROR(b->AddDataset(
           this,
           {filenames, header_bytes, record_bytes, footer_bytes, buffer_size},
-          output));
+          attrs, output));
       return Status::OK();
     }
 
@@ -425,6 +481,8 @@ class FixedLengthRecordDatasetOp : public DatasetOpKernel {
           }
           TF_RETURN_IF_ERROR(ctx->env()->NewRandomAccessFile(
               dataset()->filenames_[current_file_index_], &file_));
+          MaybeAddReadahead(ctx->env(), dataset()->readahead_options_,
+                            &readahead_pool_, &file_);
           input_buffer_.reset(
               new io::InputBuffer(file_.get(), dataset()->buffer_size_));
           TF_RETURN_IF_ERROR(
@@ -468,6 +526,8 @@ class FixedLengthRecordDatasetOp : public DatasetOpKernel {
           file_pos_limit_ = file_size - dataset()->footer_bytes_;
           TF_RETURN_IF_ERROR(ctx->env()->NewRandomAccessFile(
               dataset()->filenames_[current_file_index_], &file_));
+          MaybeAddReadahead(ctx->env(), dataset()->readahead_options_,
+                            &readahead_pool_, &file_);
           input_buffer_.reset(
               new io::InputBuffer(file_.get(), dataset()->buffer_size_));
           TF_RETURN_IF_ERROR(input_buffer_->Seek(current_pos));
@@ -479,6 +539,8 @@ class FixedLengthRecordDatasetOp : public DatasetOpKernel {
      private:
       mutex mu_;
       size_t current_file_index_ GUARDED_BY(mu_) = 0;
+      std::unique_ptr<thread::ThreadPool> readahead_pool_
+          GUARDED_BY(mu_);  // must outlive file_
       std::unique_ptr<RandomAccessFile> file_
           GUARDED_BY(mu_);  // must outlive input_buffer_
       std::unique_ptr<io::InputBuffer> input_buffer_ GUARDED_BY(mu_);
@@ -490,7 +552,10 @@ class FixedLengthRecordDatasetOp : public DatasetOpKernel {
     const int64 record_bytes_;
     const int64 footer_bytes_;
     const int64 buffer_size_;
+    const ReadaheadOptions readahead_options_;
   };
+
+  ReadaheadOptions readahead_options_;
 };
 
 REGISTER_KERNEL_BUILDER(Name("FixedLengthRecordDataset").Device(DEVICE_CPU),
@@ -498,7 +563,10 @@ REGISTER_KERNEL_BUILDER(Name("FixedLengthRecordDataset").Device(DEVICE_CPU),
 
 class TFRecordDatasetOp : public DatasetOpKernel {
  public:
-  using DatasetOpKernel::DatasetOpKernel;
+  explicit TFRecordDatasetOp(OpKernelConstruction* ctx)
+      : DatasetOpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ParseReadaheadOptions(ctx, &readahead_options_));
+  }
 
   void MakeDataset(OpKernelContext* ctx, DatasetBase** output) override {
     const Tensor* filenames_tensor;
@@ -524,20 +592,22 @@ class TFRecordDatasetOp : public DatasetOpKernel {
                 errors::InvalidArgument(
                     "`buffer_size` must be >= 0 (0 == no buffering)"));
 
-    *output =
-        new Dataset(ctx, std::move(filenames), compression_type, buffer_size);
+    *output = new Dataset(ctx, std::move(filenames), compression_type,
+                          buffer_size, readahead_options_);
   }
 
  private:
   class Dataset : public GraphDatasetBase {
    public:
     explicit Dataset(OpKernelContext* ctx, std::vector<string> filenames,
-                     const string& compression_type, int64 buffer_size)
+                     const string& compression_type, int64 buffer_size,
+                     const ReadaheadOptions& readahead_options)
         : GraphDatasetBase(ctx),
           filenames_(std::move(filenames)),
           compression_type_(compression_type),
           options_(io::RecordReaderOptions::CreateRecordReaderOptions(
-              compression_type)) {
+              compression_type)),
+          readahead_options_(readahead_options) {
       if (buffer_size > 0) {
         options_.buffer_size = buffer_size;
       }
@@ -571,8 +641,10 @@ class TFRecordDatasetOp : public DatasetOpKernel {
       TF_RETURN_IF_ERROR(b->AddScalar(compression_type_, &compression_type));
       Node* buffer_size = nullptr;
       TF_RETURN_IF_ERROR(b->AddScalar(options_.buffer_size, &buffer_size));
+      std::vector<std::pair<StringPiece, AttrValue>> attrs;
+      AddReadaheadAttrs(readahead_options_, b, &attrs);
       TF_RETURN_IF_ERROR(b->AddDataset(
-          this, {filenames, compression_type, buffer_size}, output));
+          this, {filenames, compression_type, buffer_size}, attrs, output));
       return Status::OK();
     }
 
@@ -658,6 +730,8 @@ class TFRecordDatasetOp : public DatasetOpKernel {
         const string& next_filename =
             dataset()->filenames_[current_file_index_];
         TF_RETURN_IF_ERROR(env->NewRandomAccessFile(next_filename, &file_));
+        MaybeAddReadahead(env, dataset()->readahead_options_, &readahead_pool_,
+                          &file_);
         reader_.reset(
             new io::SequentialRecordReader(file_.get(), dataset()->options_));
         return Status::OK();
@@ -673,7 +747,9 @@ class TFRecordDatasetOp : public DatasetOpKernel {
       size_t current_file_index_ GUARDED_BY(mu_) = 0;
 
       // `reader_` will borrow the object that `file_` points to, so
-      // we must destroy `reader_` before `file_`.
+      // we must destroy `reader_` before `file_`, which may in turn read
+      // ahead on `readahead_pool_`.
+      std::unique_ptr<thread::ThreadPool> readahead_pool_ GUARDED_BY(mu_);
       std::unique_ptr<RandomAccessFile> file_ GUARDED_BY(mu_);
       std::unique_ptr<io::SequentialRecordReader> reader_ GUARDED_BY(mu_);
     };
@@ -681,7 +757,10 @@ class TFRecordDatasetOp : public DatasetOpKernel {
     const std::vector<string> filenames_;
     const string compression_type_;
     io::RecordReaderOptions options_;
+    const ReadaheadOptions readahead_options_;
   };
+
+  ReadaheadOptions readahead_options_;
 };
 
 REGISTER_KERNEL_BUILDER(Name("TFRecordDataset").Device(DEVICE_CPU),
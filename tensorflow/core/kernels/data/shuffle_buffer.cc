@@ -0,0 +1,419 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/shuffle_buffer.h"
+
+#include <unordered_map>
+
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace {
+
+// Stores each element as a vector of tensors. This is used for the elements
+// whose size is not known statically.
+class TensorShuffleBuffer : public ShuffleBuffer {
+ public:
+  explicit TensorShuffleBuffer(int64 num_slots) : slots_(num_slots) {}
+
+  Status Put(int64 slot, std::vector<Tensor> element) override {
+    slots_[slot] = std::move(element);
+    return Status::OK();
+  }
+
+  Status Take(int64 slot, std::vector<Tensor>* element) override {
+    *element = std::move(slots_[slot]);
+    slots_[slot].clear();
+    return Status::OK();
+  }
+
+  void Move(int64 from, int64 to) override {
+    slots_[to] = std::move(slots_[from]);
+    slots_[from].clear();
+  }
+
+  Status Get(int64 slot, std::vector<Tensor>* element) override {
+    *element = slots_[slot];
+    return Status::OK();
+  }
+
+ private:
+  std::vector<std::vector<Tensor>> slots_;
+};
+
+// Stores each element as a fixed-size row holding the bytes of its
+// components one after the other. The rows are carved out of blocks of
+// `kTargetBlockBytes`, and the rows in excess of the memory budget are
+// appended to spill files.
+//
+// A slot refers to its row through `locations_`, so that moving an element
+// between slots does not copy it.
+class ArenaShuffleBuffer : public ShuffleBuffer {
+ public:
+  static constexpr int64 kTargetBlockBytes = 1 << 20;  // 1 MB
+  static constexpr int64 kTargetSegmentBytes = 64 << 20;  // 64 MB
+
+  ArenaShuffleBuffer(Env* env, int64 num_slots, const DataTypeVector& dtypes,
+                     const std::vector<PartialTensorShape>& shapes,
+                     const ShuffleBufferOptions& options)
+      : env_(env),
+        dtypes_(dtypes),
+        spill_directory_(options.spill_directory),
+        locations_(num_slots, kEmpty) {
+    int64 offset = 0;
+    for (size_t i = 0; i < dtypes.size(); ++i) {
+      TensorShape shape;
+      CHECK(shapes[i].AsTensorShape(&shape));
+      shapes_.push_back(shape);
+      offsets_.push_back(offset);
+      offset += shape.num_elements() * DataTypeSize(dtypes[i]);
+    }
+    offsets_.push_back(offset);
+    // Zero-sized elements still take one byte, so that each row has a
+    // distinct address.
+    row_bytes_ = std::max<int64>(offset, 1);
+    rows_per_block_ = std::max<int64>(kTargetBlockBytes / row_bytes_, 1);
+    rows_per_segment_ = std::max<int64>(kTargetSegmentBytes / row_bytes_, 1);
+    if (spill_directory_.empty()) {
+      max_memory_rows_ = num_slots;
+    } else {
+      max_memory_rows_ = std::min(
+          num_slots, std::max<int64>(options.max_memory_bytes / row_bytes_, 1));
+    }
+    file_prefix_ = io::JoinPath(
+        spill_directory_, strings::StrCat("shuffle_buffer_", random::New64()));
+  }
+
+  ~ArenaShuffleBuffer() override {
+    for (auto& segment : segments_) {
+      DeleteSegmentFile(segment.second.get());
+    }
+  }
+
+  Status Put(int64 slot, std::vector<Tensor> element) override {
+    TF_RETURN_IF_ERROR(CheckElement(element));
+    const int64 index = NewMemoryRow();
+    if (index >= 0) {
+      char* row = MemoryRow(index);
+      for (size_t i = 0; i < element.size(); ++i) {
+        StringPiece data = element[i].tensor_data();
+        memcpy(row + offsets_[i], data.data(), data.size());
+      }
+      locations_[slot] = index;
+      return Status::OK();
+    }
+    std::vector<StringPiece> pieces;
+    for (const Tensor& t : element) {
+      pieces.push_back(t.tensor_data());
+    }
+    return AppendToSpill(slot, pieces);
+  }
+
+  Status Take(int64 slot, std::vector<Tensor>* element) override {
+    TF_RETURN_IF_ERROR(Get(slot, element));
+    const int64 location = locations_[slot];
+    locations_[slot] = kEmpty;
+    if (location >= 0) {
+      free_rows_.push_back(location);
+      return Status::OK();
+    }
+    return ReleaseSpilledRow(-location - 1);
+  }
+
+  void Move(int64 from, int64 to) override {
+    const int64 location = locations_[from];
+    locations_[from] = kEmpty;
+    locations_[to] = location;
+    if (location < 0 && location != kEmpty) {
+      const int64 spilled_row = -location - 1;
+      segments_[spilled_row / rows_per_segment_]
+          ->slots[spilled_row % rows_per_segment_] = to;
+    }
+  }
+
+  Status Get(int64 slot, std::vector<Tensor>* element) override {
+    const int64 location = locations_[slot];
+    if (location == kEmpty) {
+      return errors::Internal("Shuffle buffer slot ", slot, " is empty.");
+    }
+    const char* row;
+    string scratch;
+    if (location >= 0) {
+      row = MemoryRow(location);
+    } else {
+      TF_RETURN_IF_ERROR(ReadSpilledRow(-location - 1, &row, &scratch));
+    }
+    element->clear();
+    element->reserve(dtypes_.size());
+    for (size_t i = 0; i < dtypes_.size(); ++i) {
+      Tensor t(dtypes_[i], shapes_[i]);
+      StringPiece data = t.tensor_data();
+      memcpy(const_cast<char*>(data.data()), row + offsets_[i], data.size());
+      element->push_back(std::move(t));
+    }
+    return Status::OK();
+  }
+
+ private:
+  // The location of an empty slot. Memory rows are located by their
+  // non-negative index, and spilled row `i` by `-i - 1`.
+  static constexpr int64 kEmpty = kint64min;
+
+  // A spill file, holding up to `rows_per_segment_` rows.
+  struct Segment {
+    string filename;
+    // Set while rows are appended to the segment.
+    std::unique_ptr<WritableFile> writer;
+    bool needs_flush = false;
+    // Opened on the first read.
+    std::unique_ptr<RandomAccessFile> reader;
+    // The slot holding each row of the segment, or -1 once it is released.
+    std::vector<int64> slots;
+    int64 num_live_rows = 0;
+  };
+
+  Status CheckElement(const std::vector<Tensor>& element) const {
+    if (element.size() != dtypes_.size()) {
+      return errors::InvalidArgument("Expected an element of ", dtypes_.size(),
+                                     " components, but got ", element.size(),
+                                     ".");
+    }
+    for (size_t i = 0; i < element.size(); ++i) {
+      if (element[i].dtype() != dtypes_[i] ||
+          element[i].shape() != shapes_[i]) {
+        return errors::InvalidArgument(
+            "Expected component ", i, " to be a ", DataTypeString(dtypes_[i]),
+            " tensor of shape ", shapes_[i].DebugString(), ", but got a ",
+            DataTypeString(element[i].dtype()), " tensor of shape ",
+            element[i].shape().DebugString(), ".");
+      }
+    }
+    return Status::OK();
+  }
+
+  char* MemoryRow(int64 index) const {
+    return blocks_[index / rows_per_block_].get() +
+           (index % rows_per_block_) * row_bytes_;
+  }
+
+  // Returns the index of a free memory row, or -1 if the memory budget is
+  // used up.
+  int64 NewMemoryRow() {
+    if (!free_rows_.empty()) {
+      const int64 index = free_rows_.back();
+      free_rows_.pop_back();
+      return index;
+    }
+    if (num_memory_rows_ == max_memory_rows_) {
+      return -1;
+    }
+    if (num_memory_rows_ == static_cast<int64>(blocks_.size()) *
+                                rows_per_block_) {
+      const int64 rows = std::min(rows_per_block_,
+                                  max_memory_rows_ - num_memory_rows_);
+      blocks_.emplace_back(new char[rows * row_bytes_]);
+    }
+    return num_memory_rows_++;
+  }
+
+  // Appends the row made of `pieces` to the current segment, and stores its
+  // location in `slot`.
+  Status AppendToSpill(int64 slot, const std::vector<StringPiece>& pieces) {
+    Segment* segment = nullptr;
+    auto it = segments_.find(current_segment_);
+    if (it != segments_.end() &&
+        static_cast<int64>(it->second->slots.size()) < rows_per_segment_) {
+      segment = it->second.get();
+    } else {
+      if (it != segments_.end()) {
+        // Seal the full segment.
+        TF_RETURN_IF_ERROR(it->second->writer->Close());
+        it->second->writer.reset();
+        it->second->needs_flush = false;
+        if (it->second->num_live_rows == 0) {
+          DeleteSegmentFile(it->second.get());
+          segments_.erase(it);
+        }
+      }
+      current_segment_ = next_segment_++;
+      std::unique_ptr<Segment> new_segment(new Segment);
+      new_segment->filename =
+          strings::StrCat(file_prefix_, "_", current_segment_, ".spill");
+      TF_RETURN_IF_ERROR(
+          env_->NewWritableFile(new_segment->filename, &new_segment->writer));
+      segment = new_segment.get();
+      segments_[current_segment_] = std::move(new_segment);
+    }
+    size_t size = 0;
+    for (StringPiece piece : pieces) {
+      TF_RETURN_IF_ERROR(segment->writer->Append(piece));
+      size += piece.size();
+    }
+    if (size < static_cast<size_t>(row_bytes_)) {
+      // Pad the zero-sized rows.
+      TF_RETURN_IF_ERROR(
+          segment->writer->Append(string(row_bytes_ - size, '\0')));
+    }
+    segment->needs_flush = true;
+    const int64 row = segment->slots.size();
+    segment->slots.push_back(slot);
+    ++segment->num_live_rows;
+    locations_[slot] = -(current_segment_ * rows_per_segment_ + row) - 1;
+    return Status::OK();
+  }
+
+  // Reads the spilled row `index` into `*row`, which may point into
+  // `scratch`.
+  Status ReadSpilledRow(int64 index, const char** row, string* scratch) {
+    Segment* segment = segments_[index / rows_per_segment_].get();
+    if (segment->needs_flush) {
+      TF_RETURN_IF_ERROR(segment->writer->Flush());
+      segment->needs_flush = false;
+    }
+    if (segment->reader == nullptr) {
+      TF_RETURN_IF_ERROR(
+          env_->NewRandomAccessFile(segment->filename, &segment->reader));
+    }
+    scratch->resize(row_bytes_);
+    StringPiece result;
+    TF_RETURN_IF_ERROR(segment->reader->Read(
+        (index % rows_per_segment_) * row_bytes_, row_bytes_, &result,
+        &(*scratch)[0]));
+    if (result.size() != static_cast<size_t>(row_bytes_)) {
+      return errors::DataLoss("Truncated shuffle buffer spill file ",
+                              segment->filename);
+    }
+    *row = result.data();
+    return Status::OK();
+  }
+
+  // Releases the spilled row `index`, deleting its segment once it holds no
+  // live row, and compacting it once most of its rows are released.
+  Status ReleaseSpilledRow(int64 index) {
+    const int64 segment_index = index / rows_per_segment_;
+    auto it = segments_.find(segment_index);
+    Segment* segment = it->second.get();
+    segment->slots[index % rows_per_segment_] = -1;
+    --segment->num_live_rows;
+    if (segment_index == current_segment_) {
+      return Status::OK();
+    }
+    if (segment->num_live_rows == 0) {
+      DeleteSegmentFile(segment);
+      segments_.erase(it);
+    } else if (segment->num_live_rows < rows_per_segment_ / 4) {
+      return CompactSegment(segment_index);
+    }
+    return Status::OK();
+  }
+
+  // Moves the live rows of the sealed segment `segment_index` to the current
+  // segment, so that its file can be deleted.
+  Status CompactSegment(int64 segment_index) {
+    Segment* segment = segments_[segment_index].get();
+    string scratch;
+    for (size_t i = 0; i < segment->slots.size(); ++i) {
+      const int64 slot = segment->slots[i];
+      if (slot < 0) continue;
+      const char* row;
+      TF_RETURN_IF_ERROR(ReadSpilledRow(segment_index * rows_per_segment_ + i,
+                                        &row, &scratch));
+      TF_RETURN_IF_ERROR(
+          AppendToSpill(slot, {StringPiece(row, offsets_.back())}));
+    }
+    DeleteSegmentFile(segment);
+    segments_.erase(segment_index);
+    return Status::OK();
+  }
+
+  void DeleteSegmentFile(Segment* segment) {
+    segment->reader.reset();
+    if (segment->writer != nullptr) {
+      segment->writer->Close().IgnoreError();
+      segment->writer.reset();
+    }
+    Status s = env_->DeleteFile(segment->filename);
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to delete shuffle buffer spill file "
+                   << segment->filename << ": " << s;
+    }
+  }
+
+  Env* const env_;
+  const DataTypeVector dtypes_;
+  const string spill_directory_;
+  std::vector<TensorShape> shapes_;
+  // The offset of each component in a row, followed by the size of the
+  // components.
+  std::vector<int64> offsets_;
+  int64 row_bytes_;
+  int64 rows_per_block_;
+  int64 rows_per_segment_;
+  int64 max_memory_rows_;
+  string file_prefix_;
+
+  std::vector<int64> locations_;
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  int64 num_memory_rows_ = 0;
+  std::vector<int64> free_rows_;
+
+  std::unordered_map<int64, std::unique_ptr<Segment>> segments_;
+  int64 current_segment_ = -1;
+  int64 next_segment_ = 0;
+};
+
+constexpr int64 ArenaShuffleBuffer::kEmpty;
+
+}  // namespace
+
+// static
+Status ShuffleBuffer::Create(Env* env, int64 num_slots,
+                             const DataTypeVector& dtypes,
+                             const std::vector<PartialTensorShape>& shapes,
+                             const ShuffleBufferOptions& options,
+                             std::unique_ptr<ShuffleBuffer>* buffer) {
+  bool fixed_size = true;
+  for (size_t i = 0; i < dtypes.size(); ++i) {
+    if (!DataTypeCanUseMemcpy(dtypes[i]) || !shapes[i].IsFullyDefined()) {
+      fixed_size = false;
+      break;
+    }
+  }
+  if (!fixed_size) {
+    if (!options.spill_directory.empty()) {
+      return errors::InvalidArgument(
+          "Spilling a shuffle buffer requires elements whose components have "
+          "a fully defined shape and a numeric or boolean type.");
+    }
+    buffer->reset(new TensorShuffleBuffer(num_slots));
+    return Status::OK();
+  }
+  if (!options.spill_directory.empty()) {
+    if (options.max_memory_bytes <= 0) {
+      return errors::InvalidArgument(
+          "`max_memory_bytes` must be > 0 when spilling a shuffle buffer.");
+    }
+    TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(options.spill_directory));
+  }
+  buffer->reset(
+      new ArenaShuffleBuffer(env, num_slots, dtypes, shapes, options));
+  return Status::OK();
+}
+
+}  // namespace tensorflow
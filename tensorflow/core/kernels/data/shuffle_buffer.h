@@ -0,0 +1,77 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_KERNELS_DATA_SHUFFLE_BUFFER_H_
+#define TENSORFLOW_CORE_KERNELS_DATA_SHUFFLE_BUFFER_H_
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/framework/partial_tensor_shape.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/env.h"
+
+namespace tensorflow {
+
+// Options of the storage of a shuffle buffer.
+struct ShuffleBufferOptions {
+  // If not empty, the elements that do not fit in `max_memory_bytes` are
+  // spilled to files in this directory.
+  string spill_directory;
+  // The maximum number of bytes of elements kept in memory when spilling.
+  int64 max_memory_bytes = 0;
+};
+
+// The storage of the elements of a shuffle buffer, which holds up to a fixed
+// number of elements in numbered slots.
+//
+// When all the components of the elements have a fully defined shape and a
+// type that can be copied with `memcpy()`, the elements are stored as rows of
+// contiguous arenas, rather than as a vector of tensors each, which avoids
+// the overhead of a heap allocation and of a `Tensor` per component when the
+// buffer holds millions of small elements. Such a buffer can also spill the
+// elements that do not fit in memory to local files.
+//
+// This class is not thread-safe.
+class ShuffleBuffer {
+ public:
+  virtual ~ShuffleBuffer() {}
+
+  // Creates a buffer of `num_slots` slots for elements of the given types and
+  // shapes.
+  static Status Create(Env* env, int64 num_slots,
+                       const DataTypeVector& dtypes,
+                       const std::vector<PartialTensorShape>& shapes,
+                       const ShuffleBufferOptions& options,
+                       std::unique_ptr<ShuffleBuffer>* buffer);
+
+  // Stores `element` in the empty slot `slot`.
+  virtual Status Put(int64 slot, std::vector<Tensor> element) = 0;
+
+  // Removes the element stored in `slot`, which becomes empty.
+  virtual Status Take(int64 slot, std::vector<Tensor>* element) = 0;
+
+  // Moves the element stored in `from` to the empty slot `to`, without
+  // copying it. `from` becomes empty.
+  virtual void Move(int64 from, int64 to) = 0;
+
+  // Returns a copy of the element stored in `slot`.
+  virtual Status Get(int64 slot, std::vector<Tensor>* element) = 0;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_DATA_SHUFFLE_BUFFER_H_
@@ -0,0 +1,128 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/data/shuffle_buffer.h"
+
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Returns the element `i` of the test dataset: an int64 scalar and a float
+// vector of 256 values.
+std::vector<Tensor> MakeElement(int64 i) {
+  Tensor scalar(DT_INT64, TensorShape({}));
+  scalar.scalar<int64>()() = i;
+  Tensor vector(DT_FLOAT, TensorShape({256}));
+  vector.vec<float>().setConstant(static_cast<float>(i));
+  return {scalar, vector};
+}
+
+void ExpectElement(int64 i, const std::vector<Tensor>& element) {
+  std::vector<Tensor> expected = MakeElement(i);
+  ASSERT_EQ(2, element.size());
+  test::ExpectTensorEqual<int64>(expected[0], element[0]);
+  test::ExpectTensorEqual<float>(expected[1], element[1]);
+}
+
+const DataTypeVector& Dtypes() {
+  static DataTypeVector* dtypes = new DataTypeVector({DT_INT64, DT_FLOAT});
+  return *dtypes;
+}
+
+// Fills a buffer of `num_slots` slots, then repeatedly takes an element and
+// moves the last element to its slot, the way the shuffle iterator does.
+void FillAndDrain(const std::vector<PartialTensorShape>& shapes,
+                  const ShuffleBufferOptions& options) {
+  const int64 kNumSlots = 1000;
+  std::unique_ptr<ShuffleBuffer> buffer;
+  TF_ASSERT_OK(ShuffleBuffer::Create(Env::Default(), kNumSlots, Dtypes(),
+                                     shapes, options, &buffer));
+  std::vector<int64> values(kNumSlots);
+  for (int64 i = 0; i < kNumSlots; ++i) {
+    TF_ASSERT_OK(buffer->Put(i, MakeElement(i)));
+    values[i] = i;
+  }
+
+  std::vector<Tensor> element;
+  TF_ASSERT_OK(buffer->Get(7, &element));
+  ExpectElement(7, element);
+
+  uint64 state = 1;
+  for (int64 size = kNumSlots; size > 0; --size) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    const int64 slot = (state >> 33) % size;
+    TF_ASSERT_OK(buffer->Take(slot, &element));
+    ExpectElement(values[slot], element);
+    if (slot != size - 1) {
+      buffer->Move(size - 1, slot);
+      values[slot] = values[size - 1];
+    }
+    // Refill a quarter of the freed slots.
+    if (size % 4 == 0) {
+      TF_ASSERT_OK(buffer->Put(size - 1, MakeElement(kNumSlots + size)));
+      values[size - 1] = kNumSlots + size;
+      TF_ASSERT_OK(buffer->Take(size - 1, &element));
+      ExpectElement(kNumSlots + size, element);
+    }
+  }
+}
+
+TEST(ShuffleBufferTest, Tensors) {
+  FillAndDrain({PartialTensorShape({}), PartialTensorShape({-1})},
+               ShuffleBufferOptions());
+}
+
+TEST(ShuffleBufferTest, Arena) {
+  FillAndDrain({PartialTensorShape({}), PartialTensorShape({256})},
+               ShuffleBufferOptions());
+}
+
+TEST(ShuffleBufferTest, Spill) {
+  ShuffleBufferOptions options;
+  options.spill_directory = io::JoinPath(testing::TmpDir(), "shuffle_spill");
+  options.max_memory_bytes = 64 << 10;
+  FillAndDrain({PartialTensorShape({}), PartialTensorShape({256})}, options);
+
+  // The spill files are deleted with the buffer.
+  std::vector<string> children;
+  TF_ASSERT_OK(Env::Default()->GetChildren(options.spill_directory, &children));
+  EXPECT_TRUE(children.empty());
+}
+
+TEST(ShuffleBufferTest, SpillRequiresFixedSize) {
+  ShuffleBufferOptions options;
+  options.spill_directory = io::JoinPath(testing::TmpDir(), "shuffle_spill");
+  options.max_memory_bytes = 64 << 10;
+  std::unique_ptr<ShuffleBuffer> buffer;
+  EXPECT_TRUE(errors::IsInvalidArgument(ShuffleBuffer::Create(
+      Env::Default(), 10, Dtypes(),
+      {PartialTensorShape({}), PartialTensorShape({-1})}, options, &buffer)));
+}
+
+TEST(ShuffleBufferTest, MismatchedShape) {
+  std::unique_ptr<ShuffleBuffer> buffer;
+  TF_ASSERT_OK(ShuffleBuffer::Create(
+      Env::Default(), 10, Dtypes(),
+      {PartialTensorShape({}), PartialTensorShape({128})},
+      ShuffleBufferOptions(), &buffer));
+  EXPECT_TRUE(errors::IsInvalidArgument(buffer->Put(0, MakeElement(0))));
+}
+
+}  // namespace
+}  // namespace tensorflow
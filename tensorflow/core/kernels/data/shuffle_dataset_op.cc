@@ -19,6 +19,7 @@ limitations under the License.
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/kernels/data/dataset.h"
+#include "tensorflow/core/kernels/data/shuffle_buffer.h"
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/random/random_distributions.h"
@@ -42,11 +43,13 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
   class ShuffleDatasetBase : public GraphDatasetBase {
    public:
     ShuffleDatasetBase(OpKernelContext* ctx, const DatasetBase* input,
-                       int64 buffer_size, int64 count)
+                       int64 buffer_size, int64 count,
+                       const ShuffleBufferOptions& buffer_options)
         : GraphDatasetBase(ctx),
           input_(input),
           buffer_size_(buffer_size),
-          count_(count) {
+          count_(count),
+          buffer_options_(buffer_options) {
       input_->Ref();
     }
 
@@ -72,7 +75,6 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
             num_elements_(0),
             parent_generator_(seed, seed2),
             generator_(&parent_generator_) {
-        buffer_.reset(new std::vector<Tensor>[params.dataset->buffer_size_]);
         slices_.emplace_back(new Slice{0, 0});
       }
 
@@ -83,6 +85,9 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
         int64 start_micros = ctx->env()->NowMicros();
         int64 num_log_entries = 0;
         bool first_call = false;
+        if (!buffer_) {
+          TF_RETURN_IF_ERROR(CreateBuffer(ctx));
+        }
         if (!input_impl_ && epoch_ == 0) {
           first_call = true;
           TF_RETURN_IF_ERROR(
@@ -119,8 +124,9 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
                 dataset()->input_->MakeIterator(ctx, prefix(), &input_impl_));
           }
           if (!end_of_input_sequence) {
-            buffer_[slices_.back()->end % dataset()->buffer_size_] =
-                std::move(input_element);
+            TF_RETURN_IF_ERROR(
+                buffer_->Put(slices_.back()->end % dataset()->buffer_size_,
+                             std::move(input_element)));
             num_elements_++;
             slices_.back()->end++;
           } else {
@@ -145,9 +151,14 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
               Random() % (slices_.front()->end - slices_.front()->start);
           int64 index =
               (slices_.front()->start + offset) % dataset()->buffer_size_;
-          *out_tensors = std::move(buffer_[index]);
-          std::swap(buffer_[index],
-                    buffer_[slices_.front()->start % dataset()->buffer_size_]);
+          TF_RETURN_IF_ERROR(buffer_->Take(index, out_tensors));
+          // Fill the hole with the first element of the slice, which only
+          // moves its reference in the buffer.
+          int64 start_index =
+              slices_.front()->start % dataset()->buffer_size_;
+          if (start_index != index) {
+            buffer_->Move(start_index, index);
+          }
           slices_.front()->start++;
           num_elements_--;
         } else {
@@ -188,13 +199,15 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
               full_name(strings::StrCat("slices_end_", i)), slices_[i]->end));
           for (size_t j = slices_[i]->start; j < slices_[i]->end; ++j) {
             size_t index = j % dataset()->buffer_size_;
+            std::vector<Tensor> element;
+            TF_RETURN_IF_ERROR(buffer_->Get(index, &element));
             TF_RETURN_IF_ERROR(writer->WriteScalar(
                 full_name(strings::StrCat("buffer_", index, "_size")),
-                buffer_[index].size()));
-            for (size_t k = 0; k < buffer_[index].size(); ++k) {
+                element.size()));
+            for (size_t k = 0; k < element.size(); ++k) {
               TF_RETURN_IF_ERROR(writer->WriteTensor(
                   full_name(strings::StrCat("buffer_", index, "_", k)),
-                  buffer_[index][k]));
+                  element[k]));
             }
           }
         }
@@ -231,7 +244,7 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
               reader->ReadScalar(full_name("slices_size"), &temp));
           slices_size = static_cast<size_t>(temp);
         }
-        buffer_.reset(new std::vector<Tensor>[dataset()->buffer_size_]);
+        TF_RETURN_IF_ERROR(CreateBuffer(ctx));
         for (size_t i = 0; i < slices_size; ++i) {
           int64 start;
           TF_RETURN_IF_ERROR(reader->ReadScalar(
@@ -246,12 +259,13 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
             TF_RETURN_IF_ERROR(reader->ReadScalar(
                 full_name(strings::StrCat("buffer_", index, "_size")),
                 &list_size));
-            buffer_[index] = std::vector<Tensor>(list_size);
+            std::vector<Tensor> element(list_size);
             for (int k = 0; k < list_size; ++k) {
               TF_RETURN_IF_ERROR(reader->ReadTensor(
                   full_name(strings::StrCat("buffer_", index, "_", k)),
-                  &buffer_[index][k]));
+                  &element[k]));
             }
+            TF_RETURN_IF_ERROR(buffer_->Put(index, std::move(element)));
           }
         }
 
@@ -271,6 +285,12 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
         int64 end;
       };
 
+      Status CreateBuffer(IteratorContext* ctx) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        return ShuffleBuffer::Create(
+            ctx->env(), dataset()->buffer_size_, dataset()->output_dtypes(),
+            dataset()->output_shapes(), dataset()->buffer_options_, &buffer_);
+      }
+
       random::SingleSampleAdapter<random::PhiloxRandom>::ResultType Random()
           EXCLUSIVE_LOCKS_REQUIRED(mu_) {
         num_random_samples_++;
@@ -287,7 +307,8 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
       }
 
       mutex mu_;
-      std::unique_ptr<std::vector<Tensor>[]> buffer_ GUARDED_BY(mu_);
+      // Created on the first call to `GetNext()`, or by `Restore()`.
+      std::unique_ptr<ShuffleBuffer> buffer_ GUARDED_BY(mu_);
       std::unique_ptr<IteratorBase> input_impl_ GUARDED_BY(mu_);
       const int64 seed_ GUARDED_BY(mu_);
       const int64 seed2_ GUARDED_BY(mu_);
@@ -303,6 +324,7 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
     const DatasetBase* const input_;
     const int64 buffer_size_;
     const int64 count_;
+    const ShuffleBufferOptions buffer_options_;
   };
 };
 
@@ -312,6 +334,16 @@ class ShuffleDatasetOp : public ShuffleDatasetOpBase {
       : ShuffleDatasetOpBase(ctx) {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("reshuffle_each_iteration",
                                      &reshuffle_each_iteration_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("spill_directory",
+                                     &buffer_options_.spill_directory));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("max_memory_bytes",
+                                     &buffer_options_.max_memory_bytes));
+    OP_REQUIRES(ctx,
+                buffer_options_.spill_directory.empty() ||
+                    buffer_options_.max_memory_bytes > 0,
+                errors::InvalidArgument(
+                    "max_memory_bytes must be greater than zero when "
+                    "spill_directory is set."));
   }
 
   void MakeDataset(OpKernelContext* ctx, DatasetBase* input,
@@ -338,11 +370,11 @@ class ShuffleDatasetOp : public ShuffleDatasetOpBase {
 
     int64 count = 1;
     if (reshuffle_each_iteration_) {
-      *output =
-          new ReshufflingDataset(ctx, input, buffer_size, seed, seed2, count);
+      *output = new ReshufflingDataset(ctx, input, buffer_size, seed, seed2,
+                                       count, buffer_options_);
     } else {
-      *output =
-          new FixedSeedDataset(ctx, input, buffer_size, seed, seed2, count);
+      *output = new FixedSeedDataset(ctx, input, buffer_size, seed, seed2,
+                                     count, buffer_options_);
     }
   }
 
@@ -352,8 +384,9 @@ class ShuffleDatasetOp : public ShuffleDatasetOpBase {
   class ReshufflingDataset : public ShuffleDatasetBase {
    public:
     ReshufflingDataset(OpKernelContext* ctx, const DatasetBase* input,
-                       int64 buffer_size, int64 seed, int64 seed2, int64 count)
-        : ShuffleDatasetBase(ctx, input, buffer_size, count),
+                       int64 buffer_size, int64 seed, int64 seed2, int64 count,
+                       const ShuffleBufferOptions& buffer_options)
+        : ShuffleDatasetBase(ctx, input, buffer_size, count, buffer_options),
           seed_(seed),
           seed2_(seed2),
           parent_generator_(seed, seed2),
@@ -409,8 +442,9 @@ class ShuffleDatasetOp : public ShuffleDatasetOpBase {
   class FixedSeedDataset : public ShuffleDatasetBase {
    public:
     FixedSeedDataset(OpKernelContext* ctx, const DatasetBase* input,
-                     int64 buffer_size, int64 seed, int64 seed2, int64 count)
-        : ShuffleDatasetBase(ctx, input, buffer_size, count),
+                     int64 buffer_size, int64 seed, int64 seed2, int64 count,
+                     const ShuffleBufferOptions& buffer_options)
+        : ShuffleDatasetBase(ctx, input, buffer_size, count, buffer_options),
           seed_(seed),
           seed2_(seed) {}
 
@@ -434,15 +468,20 @@ class ShuffleDatasetOp : public ShuffleDatasetOpBase {
       Node* seed = nullptr;
       Node* seed2 = nullptr;
       AttrValue reshuffle_each_iteration;
+      AttrValue spill_directory;
+      AttrValue max_memory_bytes;
 
       TF_RETURN_IF_ERROR(b->AddScalar(buffer_size_, &buffer_size));
       TF_RETURN_IF_ERROR(b->AddScalar(seed_, &seed));
       TF_RETURN_IF_ERROR(b->AddScalar(seed2_, &seed2));
       b->BuildAttrValue(false, &reshuffle_each_iteration);
+      b->BuildAttrValue(buffer_options_.spill_directory, &spill_directory);
+      b->BuildAttrValue(buffer_options_.max_memory_bytes, &max_memory_bytes);
       TF_RETURN_IF_ERROR(b->AddDataset(
           this, {input_graph_node, buffer_size, seed, seed2},  // Inputs
-          {std::make_pair("reshuffle_each_iteration",
-                          reshuffle_each_iteration)},  // Attrs
+          {std::make_pair("reshuffle_each_iteration", reshuffle_each_iteration),
+           std::make_pair("spill_directory", spill_directory),
+           std::make_pair("max_memory_bytes", max_memory_bytes)},  // Attrs
           output));
       return Status::OK();
     }
@@ -453,6 +492,7 @@ class ShuffleDatasetOp : public ShuffleDatasetOpBase {
   };
 
   bool reshuffle_each_iteration_;
+  ShuffleBufferOptions buffer_options_;
 };
 
 class ShuffleAndRepeatDatasetOp : public ShuffleDatasetOpBase {
@@ -493,7 +533,8 @@ class ShuffleAndRepeatDatasetOp : public ShuffleDatasetOpBase {
    public:
     Dataset(OpKernelContext* ctx, const DatasetBase* input, int64 buffer_size,
             int64 seed, int64 seed2, int64 count)
-        : ShuffleDatasetBase(ctx, input, buffer_size, count),
+        : ShuffleDatasetBase(ctx, input, buffer_size, count,
+                             ShuffleBufferOptions()),
           seed_(seed),
           seed2_(seed2) {}
 
@@ -103,6 +103,8 @@ class SetStatsAggregatorDatasetOp : public UnaryDatasetOpKernel {
         params.lib = ctx->lib();
         params.function_library = ctx->function_library();
         params.allocator_getter = ctx->allocator_getter();
+        params.model = ctx->model();
+        params.tracer = ctx->tracer();
         IteratorContext set_stats_aggregator_ctx(params);
         return input_impl_->GetNext(&set_stats_aggregator_ctx, out_tensors,
                                     end_of_sequence);
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/kernels/data/dataset.h"
 #include "tensorflow/core/util/batch_util.h"
 
@@ -132,7 +133,34 @@ class TensorSliceDatasetOp : public DatasetOpKernel {
         return Status::OK();
       }
 
+      bool SupportsGetNextBatch() const override { return true; }
+
      protected:
+      Status GetNextBatchInternal(IteratorContext* ctx, int64 batch_size,
+                                  std::vector<Tensor>* out_tensors,
+                                  bool* end_of_sequence) override {
+        mutex_lock l(mu_);
+        if (i_ >= n_) {
+          *end_of_sequence = true;
+          return Status::OK();
+        }
+        const int64 num_elements = std::min(batch_size, n_ - i_);
+        out_tensors->clear();
+        out_tensors->reserve(dataset()->tensors_.size());
+        for (const Tensor& t : dataset()->tensors_) {
+          // The batch is a range of rows of `t`, so it shares its buffer
+          // unless the range is not aligned.
+          Tensor batch = t.Slice(i_, i_ + num_elements);
+          if (!batch.IsAligned()) {
+            batch = tensor::DeepCopy(batch);
+          }
+          out_tensors->emplace_back(std::move(batch));
+        }
+        i_ += num_elements;
+        *end_of_sequence = false;
+        return Status::OK();
+      }
+
       Status SaveInternal(IteratorStateWriter* writer) override {
         mutex_lock l(mu_);
         TF_RETURN_IF_ERROR(writer->WriteScalar(full_name("i"), i_));
@@ -0,0 +1,454 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include <map>
+
+#include "tensorflow/core/framework/partial_tensor_shape.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/kernels/data/dataset.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/util/example_proto_fast_parsing.h"
+
+namespace tensorflow {
+
+namespace {
+
+// See documentation in ../ops/dataset_ops.cc for a high-level
+// description of the following op.
+
+class TFRecordExampleDatasetOp : public DatasetOpKernel {
+ public:
+  explicit TFRecordExampleDatasetOp(OpKernelConstruction* ctx)
+      : DatasetOpKernel(ctx) {
+    Features* f = &features_;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("sparse_keys", &f->sparse_keys));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("dense_keys", &f->dense_keys));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("sparse_types", &f->sparse_types));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("Tdense", &f->dense_types));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("dense_shapes", &f->dense_shapes));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("output_types", &f->output_types));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("output_shapes", &f->output_shapes));
+    const size_t num_sparse = f->sparse_keys.size();
+    const size_t num_dense = f->dense_keys.size();
+    OP_REQUIRES(ctx, num_sparse == f->sparse_types.size(),
+                errors::InvalidArgument(
+                    "len(sparse_keys) != len(sparse_types): ", num_sparse,
+                    " vs. ", f->sparse_types.size()));
+    OP_REQUIRES(ctx,
+                num_dense == f->dense_types.size() &&
+                    num_dense == f->dense_shapes.size(),
+                errors::InvalidArgument(
+                    "len(dense_keys), len(Tdense) and len(dense_shapes) must "
+                    "be equal, but got ",
+                    num_dense, ", ", f->dense_types.size(), " and ",
+                    f->dense_shapes.size()));
+    OP_REQUIRES(ctx, f->output_types.size() == num_sparse + num_dense,
+                errors::InvalidArgument(
+                    "Expected one output per feature, but got ",
+                    f->output_types.size(), " outputs for ",
+                    num_sparse + num_dense, " features."));
+
+    // The components of the elements are the features in the order of their
+    // keys, which is the order in which `nest` flattens a `dict`.
+    std::map<string, size_t> key_to_output_index;
+    for (const string& key : f->dense_keys) {
+      key_to_output_index[key] = 0;
+    }
+    for (const string& key : f->sparse_keys) {
+      key_to_output_index[key] = 0;
+    }
+    OP_REQUIRES(ctx, key_to_output_index.size() == num_sparse + num_dense,
+                errors::InvalidArgument("Feature keys must be unique."));
+    size_t index = 0;
+    for (auto& entry : key_to_output_index) {
+      entry.second = index++;
+    }
+    for (const string& key : f->dense_keys) {
+      f->dense_output_indices.push_back(key_to_output_index[key]);
+    }
+    for (const string& key : f->sparse_keys) {
+      f->sparse_output_indices.push_back(key_to_output_index[key]);
+    }
+
+    for (size_t d = 0; d < num_dense; ++d) {
+      const PartialTensorShape& shape = f->dense_shapes[d];
+      bool shape_ok = shape.dims() >= 0;
+      for (int i = 1; i < shape.dims(); ++i) {
+        shape_ok &= shape.dim_size(i) >= 0;
+      }
+      OP_REQUIRES(ctx, shape_ok,
+                  errors::InvalidArgument(
+                      "dense_shapes[", d,
+                      "] has unknown rank or unknown inner dimensions: ",
+                      shape.DebugString()));
+      bool variable_length = shape.dims() > 0 && shape.dim_size(0) == -1;
+      TensorShape stride_shape;
+      for (int i = variable_length ? 1 : 0; i < shape.dims(); ++i) {
+        stride_shape.AddDim(shape.dim_size(i));
+      }
+      f->variable_length.push_back(variable_length);
+      f->elements_per_stride.push_back(stride_shape.num_elements());
+    }
+  }
+
+  void MakeDataset(OpKernelContext* ctx, DatasetBase** output) override {
+    const Tensor* filenames_tensor;
+    OP_REQUIRES_OK(ctx, ctx->input("filenames", &filenames_tensor));
+    OP_REQUIRES(
+        ctx, filenames_tensor->dims() <= 1,
+        errors::InvalidArgument("`filenames` must be a scalar or a vector."));
+
+    std::vector<string> filenames;
+    filenames.reserve(filenames_tensor->NumElements());
+    for (int i = 0; i < filenames_tensor->NumElements(); ++i) {
+      filenames.push_back(filenames_tensor->flat<string>()(i));
+    }
+
+    string compression_type;
+    OP_REQUIRES_OK(ctx, ParseScalarArgument<string>(ctx, "compression_type",
+                                                    &compression_type));
+
+    int64 buffer_size = -1;
+    OP_REQUIRES_OK(
+        ctx, ParseScalarArgument<int64>(ctx, "buffer_size", &buffer_size));
+    OP_REQUIRES(ctx, buffer_size >= 0,
+                errors::InvalidArgument(
+                    "`buffer_size` must be >= 0 (0 == no buffering)"));
+
+    int64 batch_size;
+    OP_REQUIRES_OK(ctx,
+                   ParseScalarArgument<int64>(ctx, "batch_size", &batch_size));
+    OP_REQUIRES(ctx, batch_size > 0,
+                errors::InvalidArgument("`batch_size` must be > 0."));
+
+    int64 num_parallel_calls;
+    OP_REQUIRES_OK(ctx, ParseScalarArgument<int64>(ctx, "num_parallel_calls",
+                                                   &num_parallel_calls));
+    OP_REQUIRES(ctx, num_parallel_calls > 0,
+                errors::InvalidArgument("`num_parallel_calls` must be > 0."));
+
+    OpInputList dense_defaults;
+    OP_REQUIRES_OK(ctx, ctx->input_list("dense_defaults", &dense_defaults));
+    example::FastParseExampleConfig config;
+    std::vector<Tensor> dense_default_tensors;
+    const Features& f = features_;
+    for (size_t d = 0; d < f.dense_keys.size(); ++d) {
+      const Tensor& def_value = dense_defaults[d];
+      if (f.variable_length[d]) {
+        OP_REQUIRES(ctx, def_value.NumElements() == 1,
+                    errors::InvalidArgument(
+                        "dense_shapes[", d, "] is a variable length shape: ",
+                        f.dense_shapes[d].DebugString(),
+                        ", therefore dense_defaults[", d,
+                        "] must contain a single element (the padding "
+                        "element).  But its shape is: ",
+                        def_value.shape().DebugString()));
+      } else if (def_value.NumElements() > 0) {
+        OP_REQUIRES(ctx, f.dense_shapes[d].IsCompatibleWith(def_value.shape()),
+                    errors::InvalidArgument(
+                        "dense_defaults[", d,
+                        "].shape() == ", def_value.shape().DebugString(),
+                        " is not compatible with dense_shapes[", d,
+                        "] == ", f.dense_shapes[d].DebugString()));
+      }
+      OP_REQUIRES(ctx, def_value.dtype() == f.dense_types[d],
+                  errors::InvalidArgument(
+                      "dense_defaults[", d, "].dtype() == ",
+                      DataTypeString(def_value.dtype()), " != Tdense[", d,
+                      "] == ", DataTypeString(f.dense_types[d])));
+      dense_default_tensors.push_back(def_value);
+      config.dense.push_back({f.dense_keys[d], f.dense_types[d],
+                              f.dense_shapes[d], def_value,
+                              f.variable_length[d], f.elements_per_stride[d]});
+    }
+    for (size_t d = 0; d < f.sparse_keys.size(); ++d) {
+      config.sparse.push_back({f.sparse_keys[d], f.sparse_types[d]});
+    }
+
+    *output = new Dataset(ctx, features_, std::move(filenames),
+                          compression_type, buffer_size, batch_size,
+                          num_parallel_calls,
+                          std::move(dense_default_tensors), std::move(config));
+  }
+
+ private:
+  // The features to parse, as given by the attrs of the op.
+  struct Features {
+    std::vector<string> sparse_keys;
+    std::vector<string> dense_keys;
+    DataTypeVector sparse_types;
+    DataTypeVector dense_types;
+    std::vector<PartialTensorShape> dense_shapes;
+    DataTypeVector output_types;
+    std::vector<PartialTensorShape> output_shapes;
+    std::vector<bool> variable_length;
+    std::vector<std::size_t> elements_per_stride;
+    // The index of the output component of each dense and sparse feature.
+    std::vector<size_t> dense_output_indices;
+    std::vector<size_t> sparse_output_indices;
+  };
+
+  class Dataset : public GraphDatasetBase {
+   public:
+    Dataset(OpKernelContext* ctx, const Features& features,
+            std::vector<string> filenames, const string& compression_type,
+            int64 buffer_size, int64 batch_size, int64 num_parallel_calls,
+            std::vector<Tensor> dense_defaults,
+            example::FastParseExampleConfig config)
+        : GraphDatasetBase(ctx),
+          features_(features),
+          filenames_(std::move(filenames)),
+          compression_type_(compression_type),
+          options_(io::RecordReaderOptions::CreateRecordReaderOptions(
+              compression_type)),
+          batch_size_(batch_size),
+          num_parallel_calls_(num_parallel_calls),
+          dense_defaults_(std::move(dense_defaults)),
+          config_(std::move(config)) {
+      if (buffer_size > 0) {
+        options_.buffer_size = buffer_size;
+      }
+    }
+
+    std::unique_ptr<IteratorBase> MakeIteratorInternal(
+        const string& prefix) const override {
+      return std::unique_ptr<IteratorBase>(
+          new Iterator({this, strings::StrCat(prefix, "::TFRecordExample")}));
+    }
+
+    const DataTypeVector& output_dtypes() const override {
+      return features_.output_types;
+    }
+
+    const std::vector<PartialTensorShape>& output_shapes() const override {
+      return features_.output_shapes;
+    }
+
+    string DebugString() const override {
+      return "TFRecordExampleDatasetOp::Dataset";
+    }
+
+   protected:
+    Status AsGraphDefInternal(DatasetGraphDefBuilder* b,
+                              Node** output) const override {
+      Node* filenames = nullptr;
+      TF_RETURN_IF_ERROR(b->AddVector(filenames_, &filenames));
+      Node* compression_type = nullptr;
+      TF_RETURN_IF_ERROR(b->AddScalar(compression_type_, &compression_type));
+      Node* buffer_size = nullptr;
+      TF_RETURN_IF_ERROR(b->AddScalar(options_.buffer_size, &buffer_size));
+      Node* batch_size = nullptr;
+      TF_RETURN_IF_ERROR(b->AddScalar(batch_size_, &batch_size));
+      Node* num_parallel_calls = nullptr;
+      TF_RETURN_IF_ERROR(
+          b->AddScalar(num_parallel_calls_, &num_parallel_calls));
+      std::vector<Node*> dense_defaults;
+      dense_defaults.reserve(dense_defaults_.size());
+      for (const Tensor& dense_default : dense_defaults_) {
+        Node* node;
+        TF_RETURN_IF_ERROR(b->AddTensor(dense_default, &node));
+        dense_defaults.push_back(node);
+      }
+
+      AttrValue sparse_keys;
+      b->BuildAttrValue(features_.sparse_keys, &sparse_keys);
+      AttrValue dense_keys;
+      b->BuildAttrValue(features_.dense_keys, &dense_keys);
+      AttrValue sparse_types;
+      b->BuildAttrValue(features_.sparse_types, &sparse_types);
+      AttrValue dense_types;
+      b->BuildAttrValue(features_.dense_types, &dense_types);
+      AttrValue dense_shapes;
+      b->BuildAttrValue(features_.dense_shapes, &dense_shapes);
+
+      TF_RETURN_IF_ERROR(b->AddDataset(
+          this,
+          {{0, filenames},
+           {1, compression_type},
+           {2, buffer_size},
+           {3, batch_size},
+           {4, num_parallel_calls}},      // Single tensor inputs.
+          {{5, dense_defaults}},          // Tensor list inputs.
+          {{"sparse_keys", sparse_keys},
+           {"dense_keys", dense_keys},
+           {"sparse_types", sparse_types},
+           {"Tdense", dense_types},
+           {"dense_shapes", dense_shapes}},  // Attrs
+          output));
+      return Status::OK();
+    }
+
+   private:
+    // Reads batches of up to `batch_size_` records, and parses each batch
+    // directly into the dense and sparse output tensors with
+    // `FastParseExample()`, which shards the records of the batch over a
+    // pool of `num_parallel_calls_` threads.
+    class Iterator : public DatasetIterator<Dataset> {
+     public:
+      explicit Iterator(const Params& params)
+          : DatasetIterator<Dataset>(params),
+            records_(params.dataset->batch_size_) {
+        if (params.dataset->num_parallel_calls_ > 1) {
+          thread_pool_.reset(new thread::ThreadPool(
+              Env::Default(), ThreadOptions(), "tf_record_example_parser",
+              params.dataset->num_parallel_calls_,
+              false /* low_latency_hint */));
+        }
+      }
+
+      Status GetNextInternal(IteratorContext* ctx,
+                             std::vector<Tensor>* out_tensors,
+                             bool* end_of_sequence) override {
+        mutex_lock l(mu_);
+        // The records are read into the strings of the previous batch, so
+        // that their buffers are reused once they have grown large enough.
+        size_t num_records = 0;
+        while (num_records < records_.size()) {
+          if (reader_) {
+            Status s = reader_->ReadRecord(&records_[num_records]);
+            if (s.ok()) {
+              ++num_records;
+              continue;
+            } else if (!errors::IsOutOfRange(s)) {
+              return s;
+            }
+            // We have reached the end of the current file, so maybe
+            // move on to next file.
+            ResetStreamsLocked();
+            ++current_file_index_;
+          }
+          if (current_file_index_ == dataset()->filenames_.size()) {
+            break;
+          }
+          TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env()));
+        }
+        if (num_records == 0) {
+          *end_of_sequence = true;
+          return Status::OK();
+        }
+
+        example::Result result;
+        TF_RETURN_IF_ERROR(example::FastParseExample(
+            dataset()->config_,
+            gtl::ArraySlice<string>(records_.data(), num_records),
+            gtl::ArraySlice<string>(), thread_pool_.get(), &result));
+
+        out_tensors->resize(dataset()->features_.output_types.size());
+        const auto& dense_indices = dataset()->features_.dense_output_indices;
+        for (size_t d = 0; d < dense_indices.size(); ++d) {
+          (*out_tensors)[dense_indices[d]] = std::move(result.dense_values[d]);
+        }
+        // Sparse features are represented as a variant vector of their
+        // indices, values and dense shape, as by `SerializeSparse`.
+        const auto& sparse_indices =
+            dataset()->features_.sparse_output_indices;
+        for (size_t d = 0; d < sparse_indices.size(); ++d) {
+          Tensor serialized_sparse(DT_VARIANT, TensorShape({3}));
+          auto serialized_sparse_t = serialized_sparse.vec<Variant>();
+          serialized_sparse_t(0) = std::move(result.sparse_indices[d]);
+          serialized_sparse_t(1) = std::move(result.sparse_values[d]);
+          serialized_sparse_t(2) = std::move(result.sparse_shapes[d]);
+          (*out_tensors)[sparse_indices[d]] = std::move(serialized_sparse);
+        }
+        *end_of_sequence = false;
+        return Status::OK();
+      }
+
+     protected:
+      Status SaveInternal(IteratorStateWriter* writer) override {
+        mutex_lock l(mu_);
+        TF_RETURN_IF_ERROR(writer->WriteScalar(full_name("current_file_index"),
+                                               current_file_index_));
+
+        if (reader_) {
+          TF_RETURN_IF_ERROR(
+              writer->WriteScalar(full_name("offset"), reader_->TellOffset()));
+        }
+        return Status::OK();
+      }
+
+      Status RestoreInternal(IteratorContext* ctx,
+                             IteratorStateReader* reader) override {
+        mutex_lock l(mu_);
+        ResetStreamsLocked();
+        int64 current_file_index;
+        TF_RETURN_IF_ERROR(reader->ReadScalar(full_name("current_file_index"),
+                                              &current_file_index));
+        current_file_index_ = size_t(current_file_index);
+        if (reader->Contains(full_name("offset"))) {
+          int64 offset;
+          TF_RETURN_IF_ERROR(reader->ReadScalar(full_name("offset"), &offset));
+          TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env()));
+          TF_RETURN_IF_ERROR(reader_->SeekOffset(offset));
+        }
+        return Status::OK();
+      }
+
+     private:
+      // Sets up reader streams to read from the file at `current_file_index_`.
+      Status SetupStreamsLocked(Env* env) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        if (current_file_index_ >= dataset()->filenames_.size()) {
+          return errors::InvalidArgument(
+              "current_file_index_:", current_file_index_,
+              " >= filenames_.size():", dataset()->filenames_.size());
+        }
+
+        // Actually move on to next file.
+        const string& next_filename =
+            dataset()->filenames_[current_file_index_];
+        TF_RETURN_IF_ERROR(env->NewRandomAccessFile(next_filename, &file_));
+        reader_.reset(
+            new io::SequentialRecordReader(file_.get(), dataset()->options_));
+        return Status::OK();
+      }
+
+      // Resets all reader streams.
+      void ResetStreamsLocked() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        reader_.reset();
+        file_.reset();
+      }
+
+      mutex mu_;
+      size_t current_file_index_ GUARDED_BY(mu_) = 0;
+      std::vector<string> records_ GUARDED_BY(mu_);
+      // Not set when `num_parallel_calls_` is 1, in which case the records
+      // are parsed on the calling thread.
+      std::unique_ptr<thread::ThreadPool> thread_pool_;
+
+      // `reader_` will borrow the object that `file_` points to, so
+      // we must destroy `reader_` before `file_`.
+      std::unique_ptr<RandomAccessFile> file_ GUARDED_BY(mu_);
+      std::unique_ptr<io::SequentialRecordReader> reader_ GUARDED_BY(mu_);
+    };
+
+    const Features features_;
+    const std::vector<string> filenames_;
+    const string compression_type_;
+    io::RecordReaderOptions options_;
+    const int64 batch_size_;
+    const int64 num_parallel_calls_;
+    const std::vector<Tensor> dense_defaults_;
+    const example::FastParseExampleConfig config_;
+  };
+
+  Features features_;
+};
+
+REGISTER_KERNEL_BUILDER(Name("TFRecordExampleDataset").Device(DEVICE_CPU),
+                        TFRecordExampleDatasetOp);
+
+}  // namespace
+
+}  // namespace tensorflow
@@ -0,0 +1,205 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/image_ops.cc
+
+#include <limits>
+#include <vector>
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/jpeg/jpeg_mem.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+namespace {
+
+// Decodes a batch of JPEG images, optionally cropped, into one uint8 tensor of
+// shape [batch, height, width, channels]. All the images must decode to the
+// same shape. The first image is decoded alone to find that shape and
+// allocate the output, then the others are decoded in parallel straight into
+// their slice of it.
+class DecodeJpegBatchOp : public OpKernel {
+ public:
+  explicit DecodeJpegBatchOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    crop_ = type_string() == "DecodeAndCropJpegBatch";
+
+    OP_REQUIRES_OK(context, context->GetAttr("channels", &flags_.components));
+    OP_REQUIRES(context,
+                flags_.components == 0 || flags_.components == 1 ||
+                    flags_.components == 3,
+                errors::InvalidArgument(
+                    "channels must be 0, 1, or 3 for JPEG, got ",
+                    flags_.components));
+    OP_REQUIRES_OK(context, context->GetAttr("ratio", &flags_.ratio));
+    OP_REQUIRES(context,
+                flags_.ratio == 1 || flags_.ratio == 2 || flags_.ratio == 4 ||
+                    flags_.ratio == 8,
+                errors::InvalidArgument("ratio must be 1, 2, 4, or 8, got ",
+                                        flags_.ratio));
+    OP_REQUIRES_OK(context, context->GetAttr("fancy_upscaling",
+                                             &flags_.fancy_upscaling));
+    OP_REQUIRES_OK(context,
+                   context->GetAttr("try_recover_truncated",
+                                    &flags_.try_recover_truncated_jpeg));
+    OP_REQUIRES_OK(context, context->GetAttr("acceptable_fraction",
+                                             &flags_.min_acceptable_fraction));
+
+    // As in DecodeJpeg, the default is IFAST, sacrificing image quality for
+    // speed.
+    string dct_method;
+    OP_REQUIRES_OK(context, context->GetAttr("dct_method", &dct_method));
+    OP_REQUIRES(
+        context,
+        (dct_method.empty() || dct_method == "INTEGER_FAST" ||
+         dct_method == "INTEGER_ACCURATE"),
+        errors::InvalidArgument("dct_method must be one of "
+                                "{'', 'INTEGER_FAST', 'INTEGER_ACCURATE'}"));
+    flags_.dct_method =
+        dct_method == "INTEGER_ACCURATE" ? JDCT_ISLOW : JDCT_IFAST;
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& contents = context->input(0);
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(contents.shape()),
+                errors::InvalidArgument("contents must be a vector, got shape ",
+                                        contents.shape().DebugString()));
+    const auto contents_vec = contents.vec<string>();
+    const int64 batch_size = contents_vec.dimension(0);
+    for (int64 i = 0; i < batch_size; ++i) {
+      OP_REQUIRES(context,
+                  contents_vec(i).size() <= std::numeric_limits<int>::max(),
+                  errors::InvalidArgument("JPEG contents ", i,
+                                          " are too large for int: ",
+                                          contents_vec(i).size()));
+    }
+
+    // The flags of each image, with its crop window if any.
+    std::vector<jpeg::UncompressFlags> flags(batch_size, flags_);
+    if (crop_) {
+      const Tensor& crop_windows = context->input(1);
+      OP_REQUIRES(context,
+                  crop_windows.dims() == 2 &&
+                      crop_windows.dim_size(0) == batch_size &&
+                      crop_windows.dim_size(1) == 4,
+                  errors::InvalidArgument(
+                      "crop_windows must have shape [", batch_size,
+                      ", 4], got ", crop_windows.shape().DebugString()));
+      const auto crop_windows_mat = crop_windows.matrix<int32>();
+      for (int64 i = 0; i < batch_size; ++i) {
+        flags[i].crop = true;
+        flags[i].crop_y = crop_windows_mat(i, 0);
+        flags[i].crop_x = crop_windows_mat(i, 1);
+        flags[i].crop_height = crop_windows_mat(i, 2);
+        flags[i].crop_width = crop_windows_mat(i, 3);
+      }
+    }
+
+    if (batch_size == 0) {
+      Tensor* output = nullptr;
+      OP_REQUIRES_OK(context, context->allocate_output(
+                                  0, TensorShape({0, 0, 0, flags_.components}),
+                                  &output));
+      return;
+    }
+
+    // Decode the first image, allocating the output once its shape is known.
+    Tensor* output = nullptr;
+    int height = 0;
+    int width = 0;
+    int channels = 0;
+    OP_REQUIRES(
+        context,
+        jpeg::Uncompress(
+            contents_vec(0).data(), contents_vec(0).size(), flags[0],
+            nullptr /* nwarn */,
+            [&](int w, int h, int c) -> uint8* {
+              Status status(context->allocate_output(
+                  0, TensorShape({batch_size, h, w, c}), &output));
+              if (!status.ok()) {
+                VLOG(1) << status;
+                context->SetStatus(status);
+                return nullptr;
+              }
+              width = w;
+              height = h;
+              channels = c;
+              return output->flat<uint8>().data();
+            }),
+        errors::InvalidArgument(
+            "Invalid JPEG data or crop window for image 0, data size ",
+            contents_vec(0).size()));
+    if (batch_size == 1) return;
+
+    // Decode the other ones in parallel. Each one fails if its shape differs
+    // from the first one.
+    uint8* const output_data = output->flat<uint8>().data();
+    const int64 image_size = static_cast<int64>(height) * width * channels;
+    std::vector<Status> statuses(batch_size);
+    auto decode = [&](int64 start, int64 limit) {
+      for (int64 i = start; i < limit; ++i) {
+        const string& data = contents_vec(i);
+        bool shape_matches = true;
+        const uint8* image = jpeg::Uncompress(
+            data.data(), data.size(), flags[i], nullptr /* nwarn */,
+            [&](int w, int h, int c) -> uint8* {
+              if (w != width || h != height || c != channels) {
+                shape_matches = false;
+                statuses[i] = errors::InvalidArgument(
+                    "Image ", i, " has shape [", h, ", ", w, ", ", c,
+                    "], but image 0 has shape [", height, ", ", width, ", ",
+                    channels, "]");
+                return nullptr;
+              }
+              return output_data + i * image_size;
+            });
+        if (image == nullptr && shape_matches) {
+          statuses[i] = errors::InvalidArgument(
+              "Invalid JPEG data or crop window for image ", i,
+              ", data size ", data.size());
+        }
+      }
+    };
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    // Decoding costs a few hundred cycles per output byte.
+    Shard(worker_threads.num_threads, worker_threads.workers, batch_size - 1,
+          image_size * 200, [&decode](int64 start, int64 limit) {
+            decode(start + 1, limit + 1);
+          });
+    for (const Status& status : statuses) {
+      OP_REQUIRES_OK(context, status);
+    }
+  }
+
+ private:
+  bool crop_;
+  jpeg::UncompressFlags flags_;
+};
+
+}  // namespace
+
+REGISTER_KERNEL_BUILDER(Name("DecodeJpegBatch").Device(DEVICE_CPU),
+                        DecodeJpegBatchOp);
+REGISTER_KERNEL_BUILDER(Name("DecodeAndCropJpegBatch").Device(DEVICE_CPU),
+                        DecodeJpegBatchOp);
+
+}  // namespace tensorflow
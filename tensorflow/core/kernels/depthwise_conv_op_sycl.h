@@ -7,8 +7,10 @@
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 
+#include "tensorflow/core/common_runtime/sycl/sycl_kernel_tuner.h"
 #include "tensorflow/core/kernels/sycl_dnn_utils.h"
 #include "tensorflow/core/kernels/depthwise_conv_op.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 
 #include "sycldnn/accessor_types.h"
 #include "sycldnn/conv2d/conv_type.h"
@@ -155,7 +157,7 @@ struct DepthwiseConv2D<T, ConvType::Forward> {
   using Index = int;
   using buffer_data = uint8_t;
   static constexpr auto read_mode = cl::sycl::access::mode::read;
-  static constexpr auto write_mode = cl::sycl::access::mode::discard_write;
+  static constexpr auto write_mode = cl::sycl::access::mode::write;
   static constexpr auto global_access = cl::sycl::access::target::global_buffer;
   using write_accessor =
       cl::sycl::accessor<buffer_data, 1, write_mode, global_access>;
@@ -163,20 +165,27 @@ struct DepthwiseConv2D<T, ConvType::Forward> {
       cl::sycl::accessor<buffer_data, 1, read_mode, global_access>;
    inline TF_ATTRIBUTE_ALWAYS_INLINE DepthwiseConv2D(
       Index n_elems, const DepthwiseConv2DParams& params,
-      const read_accessor input, const read_accessor kernel,
-      write_accessor output) noexcept
+      const read_accessor input, const Index input_offset,
+      const read_accessor kernel, const Index kernel_offset,
+      write_accessor output, const Index output_offset) noexcept
       : n_elems_{n_elems},
         p_(params),
         input_accessor_{input},
+        input_offset_{input_offset},
         kernel_accessor_{kernel},
-        output_accessor_{output} {}
+        kernel_offset_{kernel_offset},
+        output_accessor_{output},
+        output_offset_{output_offset} {}
    inline TF_ATTRIBUTE_ALWAYS_INLINE void operator()(
-      cl::sycl::item<1> item) noexcept {
-    const Index index = item.get_id(0);
+      cl::sycl::nd_item<1> item) noexcept {
+    const Index index = item.get_global_id(0);
      if (index < n_elems_) {
-      const T* input_data = ConvertToActualTypeSycl(T, input_accessor_);
-      const T* kernel_data = ConvertToActualTypeSycl(T, kernel_accessor_);
-      T* output_data = ConvertToActualTypeSycl(T, output_accessor_);
+      const T* input_data =
+          ConvertToActualTypeSycl(T, input_accessor_) + input_offset_;
+      const T* kernel_data =
+          ConvertToActualTypeSycl(T, kernel_accessor_) + kernel_offset_;
+      T* output_data =
+          ConvertToActualTypeSycl(T, output_accessor_) + output_offset_;
        const Index out_channel = index % p_.out_depth_;
       const Index tile_idx = index / p_.out_depth_;
       const Index multiple = out_channel % p_.channel_multiplier_;
@@ -203,15 +212,18 @@ struct DepthwiseConv2D<T, ConvType::Forward> {
   const Index n_elems_;
   const DepthwiseConv2DParams p_;
   const read_accessor input_accessor_;
+  const Index input_offset_;
   const read_accessor kernel_accessor_;
+  const Index kernel_offset_;
   write_accessor output_accessor_;
+  const Index output_offset_;
 };
 template <typename T>
 struct DepthwiseConv2D<T, ConvType::InputBackprop> {
   using Index = int;
   using buffer_data = uint8_t;
   static constexpr auto read_mode = cl::sycl::access::mode::read;
-  static constexpr auto write_mode = cl::sycl::access::mode::discard_write;
+  static constexpr auto write_mode = cl::sycl::access::mode::write;
   static constexpr auto global_access = cl::sycl::access::target::global_buffer;
   using write_accessor =
       cl::sycl::accessor<buffer_data, 1, write_mode, global_access>;
@@ -219,20 +231,27 @@ struct DepthwiseConv2D<T, ConvType::InputBackprop> {
       cl::sycl::accessor<buffer_data, 1, read_mode, global_access>;
    inline TF_ATTRIBUTE_ALWAYS_INLINE DepthwiseConv2D(
       Index n_elems, const DepthwiseConv2DParams& params,
-      const read_accessor input, const read_accessor kernel,
-      write_accessor output) noexcept
+      const read_accessor input, const Index input_offset,
+      const read_accessor kernel, const Index kernel_offset,
+      write_accessor output, const Index output_offset) noexcept
       : n_elems_{n_elems},
         p_(params),
         input_accessor_{input},
+        input_offset_{input_offset},
         kernel_accessor_{kernel},
-        output_accessor_{output} {}
+        kernel_offset_{kernel_offset},
+        output_accessor_{output},
+        output_offset_{output_offset} {}
    inline TF_ATTRIBUTE_ALWAYS_INLINE void operator()(
-      cl::sycl::item<1> item) noexcept {
-    const Index index = item.get_id(0);
+      cl::sycl::nd_item<1> item) noexcept {
+    const Index index = item.get_global_id(0);
     if (index < n_elems_) {
-      const T* input_data = ConvertToActualTypeSycl(T, input_accessor_);
-      const T* kernel_data = ConvertToActualTypeSycl(T, kernel_accessor_);
-      T* output_data = ConvertToActualTypeSycl(T, output_accessor_);
+      const T* input_data =
+          ConvertToActualTypeSycl(T, input_accessor_) + input_offset_;
+      const T* kernel_data =
+          ConvertToActualTypeSycl(T, kernel_accessor_) + kernel_offset_;
+      T* output_data =
+          ConvertToActualTypeSycl(T, output_accessor_) + output_offset_;
        const Index channel = index % p_.channels_;
       const Index tile_idx = index / p_.channels_;
       const SYCL2DWindow w = p_.output_window_from_input_no_dilation(tile_idx);
@@ -261,15 +280,18 @@ struct DepthwiseConv2D<T, ConvType::InputBackprop> {
   const Index n_elems_;
   const DepthwiseConv2DParams p_;
   const read_accessor input_accessor_;
+  const Index input_offset_;
   const read_accessor kernel_accessor_;
+  const Index kernel_offset_;
   write_accessor output_accessor_;
+  const Index output_offset_;
 };
 template <typename T>
 struct DepthwiseConv2D<T, ConvType::FilterBackprop> {
   using Index = int;
   using buffer_data = uint8_t;
   static constexpr auto read_mode = cl::sycl::access::mode::read;
-  static constexpr auto d_write_mode = cl::sycl::access::mode::discard_write;
+  static constexpr auto d_write_mode = cl::sycl::access::mode::write;
   static constexpr auto write_mode = cl::sycl::access::mode::write;
   static constexpr auto read_write_mode = cl::sycl::access::mode::read_write;
   static constexpr auto global_access = cl::sycl::access::target::global_buffer;
@@ -285,25 +307,33 @@ struct DepthwiseConv2D<T, ConvType::FilterBackprop> {
    inline TF_ATTRIBUTE_ALWAYS_INLINE DepthwiseConv2D(
       Index n_filter_elems, Index n_group_items, Index n_b_items,
       Index n_k_items, const DepthwiseConv2DParams& params,
-      const read_accessor input, const read_accessor kernel,
-      local_accessor local, write_accessor output) noexcept
+      const read_accessor input, const Index input_offset,
+      const read_accessor kernel, const Index kernel_offset,
+      local_accessor local,
+      write_accessor output, const Index output_offset) noexcept
       : n_filter_elems_{n_filter_elems},
         n_group_items_{n_group_items},
         n_b_items_{n_b_items},
         n_k_items_{n_k_items},
         p_(params),
         input_accessor_{input},
+        input_offset_{input_offset},
         kernel_accessor_{kernel},
+        kernel_offset_{kernel_offset},
         local_accessor_{local},
-        output_accessor_{output} {}
+        output_accessor_{output},
+        output_offset_{output_offset} {}
    inline TF_ATTRIBUTE_ALWAYS_INLINE void operator()(
       cl::sycl::nd_item<2> item) noexcept {
     const Index local_idx = item.get_global_id(0);
     const Index fil_idx = item.get_global_id(1);
     if (local_idx < n_group_items_ && fil_idx < n_filter_elems_) {
-      const T* input_data = ConvertToActualTypeSycl(T, input_accessor_);
-      const T* kernel_data = ConvertToActualTypeSycl(T, kernel_accessor_);
-      T* output_data = ConvertToActualTypeSycl(T, output_accessor_);
+      const T* input_data =
+          ConvertToActualTypeSycl(T, input_accessor_) + input_offset_;
+      const T* kernel_data =
+          ConvertToActualTypeSycl(T, kernel_accessor_) + kernel_offset_;
+      T* output_data =
+          ConvertToActualTypeSycl(T, output_accessor_) + output_offset_;
       T* local_data = local_accessor_.get_pointer();
        const Index k_idx = local_idx % n_k_items_;
       const Index b_idx = local_idx / n_k_items_;
@@ -368,9 +398,12 @@ struct DepthwiseConv2D<T, ConvType::FilterBackprop> {
   const Index n_k_items_;
   const DepthwiseConv2DParams p_;
   const read_accessor input_accessor_;
+  const Index input_offset_;
   const read_accessor kernel_accessor_;
+  const Index kernel_offset_;
   local_accessor local_accessor_;
   write_accessor output_accessor_;
+  const Index output_offset_;
 };
 template <ConvType CType>
 inline DepthwiseConv2DParams get_kernel_params(
@@ -419,21 +452,33 @@ struct LaunchDepthwiseConv2DKernel {
                      T const* const input, T const* const filter,
                      DepthwiseConv2DParams const& params) noexcept {
     const Index output_size = get_output_size<CType>(params);
-    const Index workgroup_size = device.maxSyclThreadsPerBlock();
-    const Index n_threads =
-        RoundUpToNearestMultiple(output_size, workgroup_size);
-     auto input_buffer = device.get_sycl_buffer(input);
+    auto input_buffer = device.get_sycl_buffer(input);
+    const Index input_offset = device.get_offset(input) / sizeof(T);
     auto filter_buffer = device.get_sycl_buffer(filter);
+    const Index filter_offset = device.get_offset(filter) / sizeof(T);
     auto output_buffer = device.get_sycl_buffer(output);
+    const Index output_offset = device.get_offset(output) / sizeof(T);
     DepthwiseConv2DParams kernel_params = get_kernel_params<CType>(params);
-     device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
-      auto input_access = input_buffer.template get_access<read_mode>(cgh);
-      auto filter_access = filter_buffer.template get_access<read_mode>(cgh);
-      auto output_access = output_buffer.template get_access<write_mode>(cgh);
-       Functor conv(output_size, kernel_params, input_access, filter_access,
-                   output_access);
-       cgh.parallel_for(cl::sycl::range<1>(n_threads), conv);
-    });
+    static const string kernel_name = strings::StrCat(
+        "DepthwiseConv2D/", DataTypeString(DataTypeToEnum<T>::v()), "/",
+        static_cast<int>(CType));
+    SYCLKernelTuner::Global()->LaunchWithWorkGroupSize(
+        device, kernel_name, output_size, [&](size_t workgroup_size) {
+          device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+            auto input_access =
+                input_buffer.template get_access<read_mode>(cgh);
+            auto filter_access =
+                filter_buffer.template get_access<read_mode>(cgh);
+            auto output_access =
+                output_buffer.template get_access<write_mode>(cgh);
+            Functor conv(output_size, kernel_params, input_access, input_offset,
+                         filter_access, filter_offset, output_access,
+                         output_offset);
+            cgh.parallel_for(
+                SYCLUtil::get_nd_range(device, output_size, workgroup_size),
+                conv);
+          });
+        });
   }
 };
 template <typename T>
@@ -464,8 +509,11 @@ struct LaunchDepthwiseConv2DKernel<T, ConvType::FilterBackprop> {
     }
     const size_t workgroup_size = pow2_batch * pow2_out_cols;
      auto input_buffer = device.get_sycl_buffer(input);
+    const Index input_offset = device.get_offset(input) / sizeof(T);
     auto filter_buffer = device.get_sycl_buffer(filter);
+    const Index filter_offset = device.get_offset(filter) / sizeof(T);
     auto output_buffer = device.get_sycl_buffer(output);
+    const Index output_offset = device.get_offset(output) / sizeof(T);
     DepthwiseConv2DParams kernel_params = get_kernel_params<CType>(params);
      device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
       auto input_access = input_buffer.template get_access<read_mode>(cgh);
@@ -473,8 +521,8 @@ struct LaunchDepthwiseConv2DKernel<T, ConvType::FilterBackprop> {
       auto output_access = output_buffer.template get_access<write_mode>(cgh);
        local_accessor local_access{cl::sycl::range<1>{workgroup_size}, cgh};
        Functor conv(output_size, workgroup_size, pow2_batch, pow2_out_cols,
-                   kernel_params, input_access, filter_access, local_access,
-                   output_access);
+                   kernel_params, input_access, input_offset, filter_access,
+                   filter_offset, local_access, output_access, output_offset);
        cgh.parallel_for(
           cl::sycl::nd_range<2>{cl::sycl::range<2>{workgroup_size, output_size},
                                 cl::sycl::range<2>{workgroup_size, 1}},
@@ -505,7 +553,7 @@ struct LaunchDepthwiseConvOp<SYCLDevice, T> {
     vlog_depthwise_params(sd_params, data_format, "forward_depthwise_conv2d");
 
     auto device = ctx->template eigen_device<SYCLDevice>();
-    CREATE_SNN_BACKEND(sd_backend, device);
+    ACQUIRE_SNN_BACKEND(sd_backend, device);
     auto sd_in = get_sycl_dnn_input<T>(device, input);
     auto sd_fil = get_sycl_dnn_input<T>(device, depthwise_filter);
     auto sd_out = get_sycl_dnn_input<T>(device, output);
@@ -535,7 +583,7 @@ struct LaunchDepthwiseConvBackpropInputOp<SYCLDevice, T> {
     vlog_depthwise_params(sd_params, data_format, "input_backprop_depthwise_conv2d");
 
     auto device = ctx->template eigen_device<SYCLDevice>();
-    CREATE_SNN_BACKEND(sd_backend, device);
+    ACQUIRE_SNN_BACKEND(sd_backend, device);
     auto sd_out = get_sycl_dnn_input<T>(device, out_backprop);
     auto sd_fil = get_sycl_dnn_input<T>(device, depthwise_filter);
     auto sd_in = get_sycl_dnn_input<T>(device, in_backprop);
@@ -565,7 +613,7 @@ struct LaunchDepthwiseConvBackpropFilterOp<SYCLDevice, T> {
     vlog_depthwise_params(sd_params, data_format, "filter_backprop_depthwise_conv2d");
 
     auto device = ctx->template eigen_device<SYCLDevice>();
-    CREATE_SNN_BACKEND(sd_backend, device);
+    ACQUIRE_SNN_BACKEND(sd_backend, device);
     auto sd_in = get_sycl_dnn_input<T>(device, input);
     auto sd_out = get_sycl_dnn_input<T>(device, out_backprop);
     auto sd_fil = get_sycl_dnn_input<T>(device, filter_backprop);
@@ -25,6 +25,10 @@ limitations under the License.
 #include "tensorflow/core/kernels/quantization_utils.h"
 #include "tensorflow/core/lib/core/errors.h"
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/kernels/quantized_ops_sycl.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace {
 enum {
   QUANTIZE_MODE_MIN_COMBINED,
@@ -36,6 +40,9 @@ enum {
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
+#ifdef TENSORFLOW_USE_SYCL
+typedef Eigen::SyclDevice SYCLDevice;
+#endif  // TENSORFLOW_USE_SYCL
 
 template <typename Device, typename T>
 class DequantizeOp : public OpKernel {
@@ -70,6 +77,14 @@ class DequantizeOp : public OpKernel {
 
     Tensor* output = nullptr;
     OP_REQUIRES_OK(ctx, ctx->allocate_output(0, input.shape(), &output));
+    DequantizeTensor(ctx->template eigen_device<Device>(), ctx, input,
+                     min_range, max_range, output);
+  }
+
+ private:
+  void DequantizeTensor(const CPUDevice& d, OpKernelContext* ctx,
+                        const Tensor& input, float min_range, float max_range,
+                        Tensor* output) {
     if (mode_ == QUANTIZE_MODE_MIN_COMBINED) {
       const float scale_factor =
           (max_range - min_range) /
@@ -91,9 +106,8 @@ class DequantizeOp : public OpKernel {
         meta::Dequantize(ctx, input_ui8_array.data(), input_ui8_array.size(),
                          min_range, max_range, output->flat<float>().data());
       } else {
-        QuantizedTensorToFloatInPlaceUsingEigen<T>(
-            ctx->template eigen_device<Device>(), input, min_range, max_range,
-            output);
+        QuantizedTensorToFloatInPlaceUsingEigen<T>(d, input, min_range,
+                                                   max_range, output);
       }
     } else if (mode_ == QUANTIZE_MODE_SCALED) {
       // TODO(pauldonnelly): Update QuantizeAndDequantizeV2 and
@@ -112,7 +126,37 @@ class DequantizeOp : public OpKernel {
     }
   }
 
- private:
+#ifdef TENSORFLOW_USE_SYCL
+  void DequantizeTensor(const SYCLDevice& d, OpKernelContext* ctx,
+                        const Tensor& input, float min_range, float max_range,
+                        Tensor* output) {
+    float pre_offset = 0.0f;
+    float scale = 1.0f;
+    float post_offset = 0.0f;
+    if (mode_ == QUANTIZE_MODE_MIN_COMBINED) {
+      pre_offset = half_range_;
+      scale = (max_range - min_range) /
+              (static_cast<float>(std::numeric_limits<T>::max()) -
+               std::numeric_limits<T>::min());
+      post_offset = min_range;
+    } else if (mode_ == QUANTIZE_MODE_MIN_FIRST) {
+      QuantizedToFloatStruct<T> q2f(min_range, max_range);
+      scale = q2f.range_scale;
+      post_offset =
+          q2f.range_min_rounded - q2f.lowest_quantized() * q2f.range_scale;
+    } else if (mode_ == QUANTIZE_MODE_SCALED) {
+      scale = std::numeric_limits<T>::min() == 0
+                  ? (max_range / std::numeric_limits<T>::max())
+                  : std::max(min_range / std::numeric_limits<T>::min(),
+                             max_range / std::numeric_limits<T>::max());
+    }
+    functor::LaunchSYCLDequantize<T>(d, input.flat<T>().data(),
+                                     output->flat<float>().data(),
+                                     input.NumElements(), pre_offset, scale,
+                                     post_offset);
+  }
+#endif  // TENSORFLOW_USE_SYCL
+
   float half_range_;
   int mode_;
 };
@@ -134,4 +178,18 @@ REGISTER_KERNEL_BUILDER(
     Name("Dequantize").Device(DEVICE_CPU).TypeConstraint<qint32>("T"),
     DequantizeOp<CPUDevice, qint32>);
 
+#ifdef TENSORFLOW_USE_SYCL
+#define REGISTER_SYCL_KERNEL(T)                          \
+  REGISTER_KERNEL_BUILDER(Name("Dequantize")             \
+                              .Device(DEVICE_SYCL)       \
+                              .HostMemory("min_range")   \
+                              .HostMemory("max_range")   \
+                              .TypeConstraint<T>("T"),   \
+                          DequantizeOp<SYCLDevice, T>);
+REGISTER_SYCL_KERNEL(quint8);
+REGISTER_SYCL_KERNEL(qint8);
+REGISTER_SYCL_KERNEL(qint32);
+#undef REGISTER_SYCL_KERNEL
+#endif  // TENSORFLOW_USE_SYCL
+
 }  // namespace tensorflow
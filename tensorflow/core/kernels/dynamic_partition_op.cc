@@ -24,8 +24,17 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/util/util.h"
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/common_runtime/sycl/sycl_kernel_warmup.h"
+#include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace tensorflow {
 
+#ifdef TENSORFLOW_USE_SYCL
+typedef Eigen::SyclDevice SYCLDevice;
+#endif  // TENSORFLOW_USE_SYCL
+
 // Shared code that is not dependent on the type of T.  We do this to reduce
 // code size by not duplicating all this for all T (float, double, int32, etc.)
 class DynamicPartitionOp_Shared : public OpKernel {
@@ -166,4 +175,140 @@ class DynamicPartitionOp : public DynamicPartitionOp_Shared {
 TF_CALL_ALL_TYPES(REGISTER_DYNAMIC_PARTITION);
 #undef REGISTER_DYNAMIC_PARTITION
 
+#ifdef TENSORFLOW_USE_SYCL
+// Copies out[i, :] = data[sources[i], :] for the rows of one partition.
+template <typename T>
+class DynamicPartitionGatherSYCL {
+  using read_accessor =
+      cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read,
+                         cl::sycl::access::target::global_buffer>;
+  using write_accessor =
+      cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::write,
+                         cl::sycl::access::target::global_buffer>;
+
+ public:
+  DynamicPartitionGatherSYCL(read_accessor data, size_t data_offset,
+                             read_accessor sources, size_t sources_offset,
+                             write_accessor out, size_t out_offset,
+                             int64 num_rows, int64 slice_size)
+      : data_(data),
+        data_offset_(data_offset),
+        sources_(sources),
+        sources_offset_(sources_offset),
+        out_(out),
+        out_offset_(out_offset),
+        num_rows_(num_rows),
+        slice_size_(slice_size) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const int64 index = item.get_global_id(0);
+    if (index >= num_rows_ * slice_size_) {
+      return;
+    }
+    const int64 row = index / slice_size_;
+    const int64 col = index - row * slice_size_;
+    const int64* sources =
+        ConvertToActualTypeSycl(int64, sources_) + sources_offset_;
+    const T* data = ConvertToActualTypeSycl(T, data_) + data_offset_;
+    T* out = ConvertToActualTypeSycl(T, out_) + out_offset_;
+    out[index] = data[sources[row] * slice_size_ + col];
+  }
+
+ private:
+  const read_accessor data_;
+  const size_t data_offset_;
+  const read_accessor sources_;
+  const size_t sources_offset_;
+  write_accessor out_;
+  const size_t out_offset_;
+  const int64 num_rows_;
+  const int64 slice_size_;
+};
+
+// The partitions live in host memory, where they are validated and counted
+// to allocate the outputs. The data stays on the device: the source row of
+// every output row is computed on the host and sent to the device once, then
+// each partition is gathered by a kernel.
+template <class T>
+class DynamicPartitionOpSYCL : public DynamicPartitionOp_Shared {
+ public:
+  explicit DynamicPartitionOpSYCL(OpKernelConstruction* c)
+      : DynamicPartitionOp_Shared(c) {}
+  void Compute(OpKernelContext* c) override {
+    const Tensor* data;
+    const Tensor* partitions;
+    OpOutputList outputs;
+    ValidateAndAllocateOutputs(c, &data, &partitions, &outputs);
+    if (!c->status().ok()) return;
+    if (num_partitions_ == 0 || data->NumElements() == 0) return;
+
+    auto e_partitions = partitions->flat<int32>();
+    const int64 N = e_partitions.dimension(0);
+    const int64 slice_size = data->NumElements() / N;
+
+    // Rows of partition p start at offset[p] in sources, in the order in
+    // which they appear in data.
+    gtl::InlinedVector<int64, 32> offset(num_partitions_);
+    for (int p = 1; p < num_partitions_; p++) {
+      offset[p] = offset[p - 1] + outputs[p - 1]->dim_size(0);
+    }
+    AllocatorAttributes host_alloc_attrs;
+    host_alloc_attrs.set_on_host(true);
+    host_alloc_attrs.set_gpu_compatible(true);
+    Tensor host_sources;
+    OP_REQUIRES_OK(c, c->allocate_temp(DT_INT64, TensorShape({N}),
+                                       &host_sources, host_alloc_attrs));
+    auto sources = host_sources.vec<int64>();
+    gtl::InlinedVector<int64, 32> position(offset);
+    for (int64 i = 0; i < N; i++) {
+      const int32 p = internal::SubtleMustCopy(e_partitions(i));
+      OP_REQUIRES(
+          c, FastBoundsCheck(p, num_partitions_),
+          errors::InvalidArgument("indices[", i, "] is out of range"));
+      sources(position[p]++) = i;
+    }
+    Tensor device_sources;
+    OP_REQUIRES_OK(
+        c, c->allocate_temp(DT_INT64, TensorShape({N}), &device_sources));
+    const SYCLDevice& d = c->eigen_device<SYCLDevice>();
+    SYCLUtil::copyCPUTensorToDevice(d, host_sources, device_sources);
+
+    const T* data_ptr = data->flat<T>().data();
+    const int64* sources_ptr = device_sources.flat<int64>().data();
+    for (int p = 0; p < num_partitions_; p++) {
+      const int64 num_rows = outputs[p]->dim_size(0);
+      if (num_rows == 0) continue;
+      T* out_ptr = outputs[p]->flat<T>().data();
+      d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+        using mode = cl::sycl::access::mode;
+        auto data_acc =
+            d.get_sycl_buffer(data_ptr).template get_access<mode::read>(cgh);
+        auto sources_acc = d.get_sycl_buffer(sources_ptr)
+                               .template get_access<mode::read>(cgh);
+        auto out_acc =
+            d.get_sycl_buffer(out_ptr).template get_access<mode::write>(cgh);
+        DynamicPartitionGatherSYCL<T> functor(
+            data_acc, d.get_offset(data_ptr) / sizeof(T), sources_acc,
+            d.get_offset(sources_ptr) / sizeof(int64) + offset[p], out_acc,
+            d.get_offset(out_ptr) / sizeof(T), num_rows, slice_size);
+        cgh.parallel_for(SYCLUtil::get_nd_range(d, num_rows * slice_size),
+                         functor);
+      });
+    }
+  }
+};
+
+#define REGISTER_DYNAMIC_PARTITION_SYCL(T)               \
+  REGISTER_KERNEL_BUILDER(Name("DynamicPartition")       \
+                              .Device(DEVICE_SYCL)       \
+                              .TypeConstraint<T>("T")    \
+                              .HostMemory("partitions"), \
+                          DynamicPartitionOpSYCL<T>)
+
+TF_CALL_SYCL_NUMBER_TYPES(REGISTER_DYNAMIC_PARTITION_SYCL);
+TF_CALL_int64(REGISTER_DYNAMIC_PARTITION_SYCL);
+#undef REGISTER_DYNAMIC_PARTITION_SYCL
+REGISTER_SYCL_KERNEL_WARMUP(DynamicPartitionGatherSYCL<float>);
+#endif  // TENSORFLOW_USE_SYCL
+
 }  // namespace tensorflow
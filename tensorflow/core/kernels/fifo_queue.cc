@@ -47,9 +47,51 @@ void FIFOQueue::DequeueLocked(OpKernelContext* ctx, Tuple* tuple) {
   }
 }
 
+void FIFOQueue::DequeueManyLocked(Attempt* attempt) {
+  OpKernelContext* ctx = attempt->context;
+  const int64 count =
+      std::min<int64>(queues_[0].size(), attempt->elements_requested);
+  const int64 index =
+      attempt->tuple[0].dim_size(0) - attempt->elements_requested;
+  for (int i = 0; i < num_components(); ++i) {
+    for (int64 j = 0; j < count; ++j) {
+      ctx->SetStatus(batch_util::CopyElementToSlice(
+          *queues_[i][j].AccessTensor(ctx), &attempt->tuple[i], index + j));
+      if (!ctx->status().ok()) return;
+    }
+  }
+  for (int i = 0; i < num_components(); ++i) {
+    queues_[i].erase(queues_[i].begin(), queues_[i].begin() + count);
+  }
+  attempt->elements_requested -= count;
+}
+
 void FIFOQueue::TryEnqueue(const Tuple& tuple, OpKernelContext* ctx,
                            DoneCallback callback) {
   CancellationManager* cm = ctx->cancellation_manager();
+  // Fast path: without pending enqueues, an element fitting in the queue is
+  // added straight away, skipping the attempt and cancellation bookkeeping.
+  if (!cm->IsCancelled()) {
+    bool enqueued = false;
+    bool flush = false;
+    {
+      mutex_lock l(mu_);
+      if (!closed_ && enqueue_attempts_.empty() &&
+          queues_[0].size() < static_cast<size_t>(capacity_)) {
+        for (int i = 0; i < num_components(); ++i) {
+          queues_[i].push_back(PersistentTensor(tuple[i]));
+        }
+        enqueued = true;
+        flush = !dequeue_attempts_.empty();
+      }
+    }
+    if (enqueued) {
+      if (flush) FlushUnlocked();
+      callback();
+      return;
+    }
+  }
+
   CancellationToken token = cm->get_cancellation_token();
   bool already_cancelled;
   {
@@ -154,6 +196,25 @@ void FIFOQueue::TryEnqueueMany(const Tuple& tuple, OpKernelContext* ctx,
 
 void FIFOQueue::TryDequeue(OpKernelContext* ctx, CallbackWithTuple callback) {
   CancellationManager* cm = ctx->cancellation_manager();
+  // Fast path: without pending dequeues, the front element of a non-empty
+  // queue is removed straight away.
+  if (!cm->IsCancelled()) {
+    Tuple tuple;
+    bool flush = false;
+    {
+      mutex_lock l(mu_);
+      if (dequeue_attempts_.empty() && !queues_[0].empty()) {
+        DequeueLocked(ctx, &tuple);
+        flush = !enqueue_attempts_.empty();
+      }
+    }
+    if (!tuple.empty()) {
+      if (flush) FlushUnlocked();
+      callback(tuple);
+      return;
+    }
+  }
+
   CancellationToken token = cm->get_cancellation_token();
   bool already_cancelled;
   {
@@ -306,44 +367,33 @@ void FIFOQueue::TryDequeueMany(int num_elements, OpKernelContext* ctx,
               }
             }
 
-            RunResult result = kNoProgress;
-            for (; queue_size > 0; --queue_size) {
-              if (attempt->tuple.empty()) {
-                // Only allocate tuple when we have something to dequeue
-                // so we don't use excessive memory when there are many
-                // blocked dequeue attempts waiting.
-                attempt->tuple.reserve(num_components());
-                for (int i = 0; i < num_components(); ++i) {
-                  const TensorShape shape =
-                      ManyOutShape(i, attempt->elements_requested);
-                  Tensor element;
-                  attempt->context->SetStatus(attempt->context->allocate_temp(
-                      component_dtypes_[i], shape, &element));
-                  if (!attempt->context->status().ok()) return kComplete;
-                  attempt->tuple.emplace_back(element);
-                }
-              }
-              result = kProgress;
-              Tuple tuple;
-              DequeueLocked(attempt->context, &tuple);
-              const int64 index =
-                  attempt->tuple[0].dim_size(0) - attempt->elements_requested;
+            if (queue_size == 0) return kNoProgress;
+            if (attempt->tuple.empty()) {
+              // Only allocate tuple when we have something to dequeue
+              // so we don't use excessive memory when there are many
+              // blocked dequeue attempts waiting.
+              attempt->tuple.reserve(num_components());
               for (int i = 0; i < num_components(); ++i) {
-                attempt->context->SetStatus(batch_util::CopyElementToSlice(
-                    std::move(tuple[i]), &attempt->tuple[i], index));
+                const TensorShape shape =
+                    ManyOutShape(i, attempt->elements_requested);
+                Tensor element;
+                attempt->context->SetStatus(attempt->context->allocate_temp(
+                    component_dtypes_[i], shape, &element));
                 if (!attempt->context->status().ok()) return kComplete;
-              }
-              tuple.clear();
-              --attempt->elements_requested;
-              if (attempt->elements_requested == 0) {
-                tuple = attempt->tuple;
-                attempt->done_callback = [callback, tuple]() {
-                  callback(tuple);
-                };
-                return kComplete;
+                attempt->tuple.emplace_back(element);
               }
             }
-            return result;
+            // Dequeue all the available elements in one pass.
+            DequeueManyLocked(attempt);
+            if (!attempt->context->status().ok()) return kComplete;
+            if (attempt->elements_requested == 0) {
+              Tuple tuple = attempt->tuple;
+              attempt->done_callback = [callback, tuple]() {
+                callback(tuple);
+              };
+              return kComplete;
+            }
+            return kProgress;
           });
     }
   }
@@ -60,6 +60,10 @@ class FIFOQueue : public TypedQueue<std::deque<PersistentTensor> > {
   void DequeueLocked(OpKernelContext* ctx, Tuple* tuple)
       EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Helper for dequeuing as many of the attempt->elements_requested elements
+  // as available from queues_, straight into the slices of attempt->tuple.
+  void DequeueManyLocked(Attempt* attempt) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   static Status GetElementComponentFromBatch(const Tuple& tuple, int64 index,
                                              int component,
                                              OpKernelContext* ctx,
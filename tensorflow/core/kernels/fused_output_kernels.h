@@ -0,0 +1,247 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Output kernels of the _FusedConv2D and _FusedMatMul ops created by the
+// remapper for CPU. They apply a BiasAdd or an inference FusedBatchNorm,
+// optionally followed by Relu, Relu6 or Elu, to a block of output rows right
+// after the contraction has produced it, while it is still in cache, instead
+// of making separate passes over the whole output. Users must define
+// EIGEN_USE_THREADS.
+
+#ifndef TENSORFLOW_CORE_KERNELS_FUSED_OUTPUT_KERNELS_H_
+#define TENSORFLOW_CORE_KERNELS_FUSED_OUTPUT_KERNELS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "third_party/eigen3/Eigen/Core"
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/math/math_util.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+enum class FusedActivation { kNone, kRelu, kRelu6, kElu };
+
+// The ops fused after the contraction, described by the fused_ops attribute:
+// "BiasAdd" or "FusedBatchNorm", optionally followed by an activation.
+struct FusedOutputSpec {
+  // If true the args are the scale, offset, mean and variance of a
+  // FusedBatchNorm, otherwise the bias of a BiasAdd.
+  bool batch_norm = false;
+  FusedActivation activation = FusedActivation::kNone;
+  float epsilon = 0.0f;
+
+  int num_args() const { return batch_norm ? 4 : 1; }
+};
+
+// Parses the fused_ops, num_args and epsilon attributes of a fused op.
+inline Status ParseFusedOutputSpec(OpKernelConstruction* context,
+                                   FusedOutputSpec* spec) {
+  std::vector<string> fused_ops;
+  int num_args;
+  TF_RETURN_IF_ERROR(context->GetAttr("fused_ops", &fused_ops));
+  TF_RETURN_IF_ERROR(context->GetAttr("num_args", &num_args));
+  TF_RETURN_IF_ERROR(context->GetAttr("epsilon", &spec->epsilon));
+
+  const string fused_ops_str = str_util::Join(fused_ops, ", ");
+  if (fused_ops.empty() || fused_ops.size() > 2) {
+    return errors::Unimplemented("Unsupported fused ops on CPU: [",
+                                 fused_ops_str, "]");
+  }
+  if (fused_ops[0] == "FusedBatchNorm") {
+    spec->batch_norm = true;
+  } else if (fused_ops[0] != "BiasAdd") {
+    return errors::Unimplemented("Unsupported fused ops on CPU: [",
+                                 fused_ops_str, "]");
+  }
+  if (fused_ops.size() == 2) {
+    if (fused_ops[1] == "Relu") {
+      spec->activation = FusedActivation::kRelu;
+    } else if (fused_ops[1] == "Relu6") {
+      spec->activation = FusedActivation::kRelu6;
+    } else if (fused_ops[1] == "Elu") {
+      spec->activation = FusedActivation::kElu;
+    } else {
+      return errors::Unimplemented("Unsupported fused ops on CPU: [",
+                                   fused_ops_str, "]");
+    }
+  }
+  if (num_args != spec->num_args()) {
+    return errors::InvalidArgument("Expected ", spec->num_args(),
+                                   " arguments for the fused ops [",
+                                   fused_ops_str, "], got ", num_args);
+  }
+  return Status::OK();
+}
+
+// Applies the fused ops to blocks of rows of a row-major [rows, channels]
+// output, the channels being the innermost dimension.
+template <typename T>
+class FusedOutputKernel {
+ public:
+  // Reads the args of the fused ops, which are the inputs of the op from
+  // `first_arg` on.
+  Status Init(OpKernelContext* context, const FusedOutputSpec& spec,
+              int first_arg, int64 channels) {
+    spec_ = spec;
+    channels_ = channels;
+    for (int i = 0; i < spec.num_args(); ++i) {
+      const Tensor& arg = context->input(first_arg + i);
+      if (arg.dims() != 1 || arg.dim_size(0) != channels) {
+        return errors::InvalidArgument(
+            "Fused op argument ", i, " must be a vector of size ", channels,
+            ", got shape ", arg.shape().DebugString());
+      }
+    }
+    if (!spec.batch_norm) {
+      bias_ = context->input(first_arg).flat<T>().data();
+      return Status::OK();
+    }
+
+    // Fold the batch norm into a per-channel affine transform.
+    auto scale = context->input(first_arg).flat<T>();
+    auto offset = context->input(first_arg + 1).flat<T>();
+    auto mean = context->input(first_arg + 2).flat<T>();
+    auto variance = context->input(first_arg + 3).flat<T>();
+    scale_.resize(channels);
+    offset_.resize(channels);
+    for (int64 c = 0; c < channels; ++c) {
+      scale_[c] = scale(c) / std::sqrt(variance(c) + T(spec.epsilon));
+      offset_[c] = offset(c) - mean(c) * scale_[c];
+    }
+    return Status::OK();
+  }
+
+  void operator()(T* output, int64 rows) const {
+    typedef Eigen::Array<T, 1, Eigen::Dynamic> RowArray;
+    typedef Eigen::Map<RowArray> Row;
+    typedef Eigen::Map<const RowArray> ConstRow;
+    for (int64 r = 0; r < rows; ++r) {
+      Row row(output + r * channels_, channels_);
+      if (spec_.batch_norm) {
+        row = row * ConstRow(scale_.data(), channels_) +
+              ConstRow(offset_.data(), channels_);
+      } else {
+        row += ConstRow(bias_, channels_);
+      }
+      switch (spec_.activation) {
+        case FusedActivation::kNone:
+          break;
+        case FusedActivation::kRelu:
+          row = row.max(T(0));
+          break;
+        case FusedActivation::kRelu6:
+          row = row.max(T(0)).min(T(6));
+          break;
+        case FusedActivation::kElu:
+          row = (row < T(0)).select(row.exp() - T(1), row);
+          break;
+      }
+    }
+  }
+
+ private:
+  FusedOutputSpec spec_;
+  int64 channels_ = 0;
+  const T* bias_ = nullptr;
+  // The batch norm as output * scale_ + offset_.
+  std::vector<T> scale_;
+  std::vector<T> offset_;
+};
+
+// Number of output rows computed and post-processed by a thread at a time.
+// The block stays in the L2 cache between the contraction writing it and the
+// output kernel reading it back.
+inline int64 FusedOutputBlockRows(int64 channels, int64 element_size) {
+  constexpr int64 kOutputBlockBytes = 128 * 1024;
+  return std::max<int64>(1, kOutputBlockBytes / (channels * element_size));
+}
+
+// Applies `output_kernel` to all the rows of the [rows, channels] `output` in
+// parallel.
+template <typename T>
+void ApplyFusedOutputKernel(OpKernelContext* context,
+                            const FusedOutputKernel<T>& output_kernel,
+                            int64 channels, T* output, int64 rows) {
+  const int64 block_rows = FusedOutputBlockRows(channels, sizeof(T));
+  const int64 num_blocks = MathUtil::CeilOfRatio(rows, block_rows);
+  auto* workers = context->device()->tensorflow_cpu_worker_threads();
+  Shard(workers->num_threads, workers->workers, num_blocks,
+        block_rows * channels * 4, [&](int64 begin, int64 end) {
+          for (int64 b = begin; b < end; ++b) {
+            const int64 row = b * block_rows;
+            output_kernel(output + row * channels,
+                          std::min(block_rows, rows - row));
+          }
+        });
+}
+
+// Computes the [m, n] `output` = `lhs` x `rhs`, contracting `dim_pair`, and
+// applies `output_kernel`. If lhs isn't transposed and there are enough rows
+// to keep all the threads busy, each thread computes blocks of output rows
+// with a single-threaded contraction and applies the output kernel to them
+// immediately. Otherwise the whole contraction uses all the threads and the
+// output kernel is applied afterwards.
+template <typename T>
+void LaunchFusedMatMul(
+    OpKernelContext* context, typename TTypes<T>::ConstMatrix lhs,
+    typename TTypes<T>::ConstMatrix rhs,
+    const Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1>& dim_pair,
+    const FusedOutputKernel<T>& output_kernel,
+    typename TTypes<T>::Matrix output) {
+  const int64 m = output.dimension(0);
+  const int64 n = output.dimension(1);
+  const int64 k = lhs.dimension(dim_pair[0].first);
+  auto* workers = context->device()->tensorflow_cpu_worker_threads();
+
+  const int64 block_rows = FusedOutputBlockRows(n, sizeof(T));
+  const bool lhs_rows_contiguous = dim_pair[0].first == 1;
+  if (!lhs_rows_contiguous ||
+      MathUtil::CeilOfRatio(m, block_rows) < workers->num_threads) {
+    output.device(context->eigen_device<Eigen::ThreadPoolDevice>()) =
+        lhs.contract(rhs, dim_pair);
+    ApplyFusedOutputKernel<T>(context, output_kernel, n, output.data(), m);
+    return;
+  }
+
+  const int64 num_blocks = MathUtil::CeilOfRatio(m, block_rows);
+  Shard(workers->num_threads, workers->workers, num_blocks,
+        block_rows * n * k, [&](int64 begin, int64 end) {
+          Eigen::DefaultDevice device;
+          for (int64 b = begin; b < end; ++b) {
+            const int64 row = b * block_rows;
+            const int64 rows = std::min(block_rows, m - row);
+            typename TTypes<T>::UnalignedConstMatrix lhs_block(
+                lhs.data() + row * k, rows, k);
+            typename TTypes<T>::UnalignedMatrix output_block(
+                output.data() + row * n, rows, n);
+            output_block.device(device) = lhs_block.contract(rhs, dim_pair);
+            output_kernel(output_block.data(), rows);
+          }
+        });
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_FUSED_OUTPUT_KERNELS_H_
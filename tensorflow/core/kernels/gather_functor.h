@@ -27,6 +27,10 @@ limitations under the License.
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/util/work_sharder.h"
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace tensorflow {
 typedef Eigen::ThreadPoolDevice CPUDevice;
 typedef Eigen::GpuDevice GPUDevice;
@@ -107,8 +111,12 @@ SliceIndex HandleCopies(OpKernelContext* ctx,
     }
   };
 
-  Shard(worker_threads->num_threads, worker_threads->workers,
-        batch_size * indices_size, slice_elems * sizeof(T), work);
+  // The cost of a copy depends heavily on where params live in the cache
+  // hierarchy, so learn it rather than relying on the byte count alone.
+  static AdaptiveShardCost* cost = new AdaptiveShardCost;
+  AdaptiveShard(worker_threads->num_threads, worker_threads->workers,
+                batch_size * indices_size, slice_elems * sizeof(T), cost,
+                work);
   return result;
 }
 
@@ -178,234 +186,178 @@ struct GatherFunctor<GPUDevice, Variant, Index> {
 };
 
 #ifdef TENSORFLOW_USE_SYCL
-// GatherOp is a very generic operation that extracts and copies a submatrix.
-// It can be broken down in several more optimal sub-cases which is what this version is doing.
-// When copying rows:
-//   - copying a continuous chunk of memory (one or more rows) uses memcpy
-// When copying columns:
-//   - copying one column uses chip
-//   - copying several adjacent columns uses slice
-//   - copying the same column several times uses chip and broadcast
-//   - generic case uses several chips
-template <typename T, typename Index>
-struct HandleCopiesDetails {
-  using ParamsT = typename TTypes<T, 3>::ConstTensor;
-  using IndicesT = typename TTypes<Index>::ConstFlat;
-  using OutT = typename TTypes<T, 3>::Tensor;
-  using TensorDataT = T;
-  using IndicesDataT = Index;
-  using TensorIndexT = typename ParamsT::Index;
-
-  HandleCopiesDetails(const SYCLDevice& d,
-                      ParamsT p,
-                      IndicesT i,
-                      OutT o)
-    : device(d),
-      params(p),
-      indices(i),
-      out(o),
-      indices_size(i.dimension(0)),
-      limit(p.dimension(1)),
-      slice_size(0),
-      host_indices() {}
-
-  virtual ~HandleCopiesDetails() = default;
-
-  virtual void full_copy(TensorIndexT from) = 0;
-  virtual void adjacent_copy(TensorIndexT from, TensorIndexT to) = 0;
-  virtual void broadcast_copy(TensorIndexT from, TensorIndexT to) = 0;
-  virtual void single_copy(TensorIndexT from) = 0;
-
-  const SYCLDevice& device;
-  ParamsT params;
-  IndicesT indices;
-  OutT out;
-  TensorIndexT indices_size;
-  TensorIndexT limit;
-  TensorIndexT slice_size;
-  std::vector<IndicesDataT> host_indices;
-};
-
-template <typename T, typename Index>
-struct HandleCopiesDetailsRows : public HandleCopiesDetails<T, Index> {
-  using Parent = HandleCopiesDetails<T, Index>;
-  using TensorIndexT = typename Parent::TensorIndexT;
-
-  HandleCopiesDetailsRows(const SYCLDevice& d,
-                          typename Parent::ParamsT p,
-                          typename Parent::IndicesT i,
-                          typename Parent::OutT o)
-    : Parent(d, p, i, o) {
-    this->slice_size = o.dimension(2);
-  }
-
-  virtual inline void full_copy(TensorIndexT from) override {
-    this->device.memcpy(this->out.data(),
-                        this->params.data() + (from * this->slice_size),
-                        this->slice_size * sizeof(T));
-  }
-
-  virtual inline void adjacent_copy(TensorIndexT from, TensorIndexT to) override {
-    this->device.memcpy(this->out.data() + (from * this->slice_size),
-                        this->params.data() + (this->host_indices[from] * this->slice_size),
-                        (to - from) * this->slice_size * sizeof(T));
-  }
-
-  virtual inline void broadcast_copy(TensorIndexT from, TensorIndexT to) override {
-    // On some device, it may be more efficient to launch a chip and a
-    // broadcast instead of several memcpy
-    for (TensorIndexT i = from; i < to; ++i) {
-      this->single_copy(i);
+// SYCL kernel gathering slices of params into out, with the indices read from
+// device memory. Expects the number of threads to be at least the number of
+// elements in the output tensor. Out of range indices produce zeros in the
+// output and set the error flag, as there is no way to report them from the
+// device synchronously.
+template <typename T, typename Index, bool is_axis_zero>
+struct GatherOpKernelSYCL {
+  using write_accessor =
+      cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::write,
+                         cl::sycl::access::target::global_buffer>;
+  using read_accessor =
+      cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read,
+                         cl::sycl::access::target::global_buffer>;
+  GatherOpKernelSYCL(const read_accessor params, size_t params_offset,
+                     const read_accessor indices, size_t indices_offset,
+                     write_accessor out, size_t out_offset,
+                     write_accessor bad_index, size_t bad_index_offset,
+                     int64 gather_dim_size,
+                     int64 indices_size, int64 slice_size, int64 out_size)
+      : params_accessor_(params),
+        indices_accessor_(indices),
+        out_accessor_(out),
+        bad_index_accessor_(bad_index),
+        params_offset_(params_offset),
+        indices_offset_(indices_offset),
+        out_offset_(out_offset),
+        bad_index_offset_(bad_index_offset),
+        gather_dim_size_(gather_dim_size),
+        indices_size_(indices_size),
+        slice_size_(slice_size),
+        out_size_(out_size) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const int64 i = item.get_global_id(0);
+    if (i >= out_size_) {
+      return;
     }
-  }
-
-  virtual inline void single_copy(TensorIndexT from) override {
-    this->adjacent_copy(from, from + 1);
-  }
-};
-
-template <typename T, typename Index>
-struct HandleCopiesDetailsCols : public HandleCopiesDetails<T, Index> {
-  using Parent = HandleCopiesDetails<T, Index>;
-  using TensorIndexT = typename Parent::TensorIndexT;
-
-  HandleCopiesDetailsCols(const SYCLDevice& d,
-                          typename Parent::ParamsT p,
-                          typename Parent::IndicesT i,
-                          typename Parent::OutT o)
-    : Parent(d, p, i, o),
-      out_slice_offsets({0, 0, 0}),
-      params_slice_offsets({0, 0, 0}),
-      out_slice_extents({1, 1, 1}),
-      params_slice_extents({1, 1, 1}),
-      bcast_shape({1, 1, 1}) {
-      this->slice_size = o.dimension(0);
-      out_slice_extents[0] = this->slice_size;
-      params_slice_extents[0] = this->slice_size;
-      out_slice_extents[2] = o.dimension(2);
-      params_slice_extents[2] = o.dimension(2);
+    const T* params =
+        ConvertToActualTypeSycl(T, params_accessor_) + params_offset_;
+    const Index* indices =
+        ConvertToActualTypeSycl(Index, indices_accessor_) + indices_offset_;
+    T* out = ConvertToActualTypeSycl(T, out_accessor_) + out_offset_;
+
+    Index batch_i = 0;
+    Index indices_i = 0;
+    Index slice_i = 0;
+    if (is_axis_zero) {
+      indices_i = i / slice_size_;
+      slice_i = i - indices_i * slice_size_;
+    } else {
+      Index batch_indices_i = i / slice_size_;
+      // The batch index into params to use for i.
+      batch_i = batch_indices_i / indices_size_;
+      // The index into indices to use for i.
+      indices_i = batch_indices_i - batch_i * indices_size_;
+      // Index into the current slice in params to use for i.
+      slice_i = i - batch_indices_i * slice_size_;
     }
 
-  virtual inline void full_copy(TensorIndexT from) override {
-    this->out.template chip<1>(0).device(this->device) = this->params.template chip<1>(from);
-  }
-
-  virtual inline void adjacent_copy(TensorIndexT from, TensorIndexT to) override {
-    out_slice_offsets[1] = from;
-    params_slice_offsets[1] = this->host_indices[from];
-    out_slice_extents[1] = to - from;
-    params_slice_extents[1] = to - from;
-    this->out.slice(out_slice_offsets, out_slice_extents).device(this->device) =
-      this->params.slice(params_slice_offsets, params_slice_extents);
-  }
-
-  virtual inline void broadcast_copy(TensorIndexT from, TensorIndexT to) override {
-    out_slice_offsets[1] = from;
-    out_slice_extents[1] = to - from;
-    bcast_shape[1] = to - from;
-    this->out.template slice(out_slice_offsets, out_slice_extents).device(this->device) =
-      this->params.template chip<1>(this->host_indices[from]).broadcast(bcast_shape);
-  }
-
-  virtual inline void single_copy(TensorIndexT from) override {
-    this->out.template chip<1>(from).device(this->device) =
-      this->params.template chip<1>(this->host_indices[from]);
+    // Index into the gather axis to use for i.
+    const Index gather_i = indices[indices_i];
+    if (!FastBoundsCheck(gather_i, gather_dim_size_)) {
+      out[i] = T(0);
+      int32* bad_index =
+          ConvertToActualTypeSycl(int32, bad_index_accessor_) +
+          bad_index_offset_;
+      *bad_index = 1;
+    } else {
+      // params is a [batch_size, gather_dim_size, slice_size] tensor. Read
+      // params[batch_i, gather_i, slice_i] and write it to the i'th position
+      // in out.
+      const Index params_i =
+          (batch_i * gather_dim_size_ + gather_i) * slice_size_ + slice_i;
+      out[i] = params[params_i];
+    }
   }
 
  private:
-  Eigen::DSizes<TensorIndexT, 3> out_slice_offsets;
-  Eigen::DSizes<TensorIndexT, 3> params_slice_offsets;
-  Eigen::DSizes<TensorIndexT, 3> out_slice_extents;
-  Eigen::DSizes<TensorIndexT, 3> params_slice_extents;
-  Eigen::array<TensorIndexT, 3> bcast_shape;
+  const read_accessor params_accessor_;
+  const read_accessor indices_accessor_;
+  write_accessor out_accessor_;
+  write_accessor bad_index_accessor_;
+  const size_t params_offset_;
+  const size_t indices_offset_;
+  const size_t out_offset_;
+  const size_t bad_index_offset_;
+  const int64 gather_dim_size_;
+  const int64 indices_size_;
+  const int64 slice_size_;
+  const int64 out_size_;
 };
 
-template <typename HandleCopiesImplDetails>
-typename HandleCopiesImplDetails::TensorIndexT
-HandleCopiesSYCL(OpKernelContext* ctx,
-                 typename HandleCopiesImplDetails::ParamsT params,
-                 typename HandleCopiesImplDetails::IndicesT indices,
-                 typename HandleCopiesImplDetails::OutT out) {
-  HandleCopiesImplDetails impl_details(ctx->eigen_sycl_device(), params, indices, out);
-
-  using TensorIndexT = typename HandleCopiesImplDetails::TensorIndexT;
-  using IndicesDataT = typename HandleCopiesImplDetails::IndicesDataT;
-
-  // Handle simple case
-  if (impl_details.indices_size == 1) {
-    const IndicesDataT index = internal::SubtleMustCopy(indices(0));
-    if (!FastBoundsCheck(index, impl_details.limit))
-      return 0;
-    impl_details.full_copy(index);
-    return -1;
-  }
-
-  // Grab the index and check its validity.  An earlier version of the
-  // code checked it and then grabbed it from memory a second time, which
-  // was a security risk since it could have changed in between.
-  // Now copy the indices on the host.
-  auto& host_indices = impl_details.host_indices;
-  host_indices.reserve(impl_details.indices_size);
-  for (TensorIndexT i = 0; i < impl_details.indices_size; i++) {
-    const IndicesDataT index = internal::SubtleMustCopy(indices(i));
-    if (!FastBoundsCheck(index, impl_details.limit)) {
-      return i;
-    }
-    host_indices.push_back(index);
-  }
+template <typename T, typename Index, bool is_axis_zero>
+void LaunchGatherOpKernelSYCL(const SYCLDevice& d, const T* params,
+                              const Index* indices, T* out, int32* bad_index,
+                              int64 gather_dim_size, int64 indices_size,
+                              int64 slice_size, int64 out_size) {
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    auto params_buffer = d.get_sycl_buffer(params);
+    auto indices_buffer = d.get_sycl_buffer(indices);
+    auto out_buffer = d.get_sycl_buffer(out);
+    auto bad_index_buffer = d.get_sycl_buffer(bad_index);
+    using mode = cl::sycl::access::mode;
+    auto params_acc = params_buffer.template get_access<mode::read>(cgh);
+    auto indices_acc = indices_buffer.template get_access<mode::read>(cgh);
+    auto out_acc = out_buffer.template get_access<mode::write>(cgh);
+    auto bad_index_acc = bad_index_buffer.template get_access<mode::write>(cgh);
+    GatherOpKernelSYCL<T, Index, is_axis_zero> functor(
+        params_acc, d.get_offset(params) / sizeof(T), indices_acc,
+        d.get_offset(indices) / sizeof(Index), out_acc,
+        d.get_offset(out) / sizeof(T), bad_index_acc,
+        d.get_offset(bad_index) / sizeof(int32), gather_dim_size,
+        indices_size, slice_size, out_size);
+    cgh.parallel_for(SYCLUtil::get_nd_range(d, out_size), functor);
+  });
+}
 
-  TensorIndexT copy_from = 0;  // bound included
-  TensorIndexT copy_to = 1;    // bound excluded
-  do {
-    // Find block of incrementing indices to copy all the lines in one go
-    while (copy_to < impl_details.indices_size &&
-           host_indices[copy_to - 1] + 1 == host_indices[copy_to]) {
-      ++copy_to;
+// Gathers on the device, so that indices produced by earlier SYCL ops do not
+// need to be copied back to the host. Out of range indices are reported
+// asynchronously in the log once the kernel has run, and the corresponding
+// output elements are set to zero, similarly to the GPU implementation.
+template <typename T, typename Index>
+struct GatherFunctor<SYCLDevice, T, Index> {
+  int64 operator()(OpKernelContext* ctx,
+                   typename TTypes<T, 3>::ConstTensor params,
+                   typename TTypes<Index>::ConstFlat indices,
+                   typename TTypes<T, 3>::Tensor out) {
+    const SYCLDevice& d = ctx->eigen_sycl_device();
+    const int64 out_size = out.size();
+    if (out_size == 0) {
+      return -1;
     }
-    if (copy_to > copy_from + 1) {
-      // At least 2 consecutives indices were found
-      impl_details.adjacent_copy(copy_from, copy_to);
+    const bool is_axis_zero = params.dimension(0) == 1;
+    const int64 gather_dim_size = params.dimension(1);
+    const int64 indices_size = indices.size();
+    const int64 slice_size = params.dimension(2);
+
+    Tensor bad_index;
+    Status s = ctx->allocate_temp(DT_INT32, TensorShape({1}), &bad_index);
+    if (!s.ok()) {
+      ctx->SetStatus(s);
+      return -1;
     }
-    else {
-      // Find block of same indicies to broadcast lines
-      while (copy_to < impl_details.indices_size &&
-             host_indices[copy_to - 1] == host_indices[copy_to]) {
-        ++copy_to;
-      }
-      if (copy_to > copy_from + 1) {
-        // At least 2 same consecutive indices were found
-        impl_details.broadcast_copy(copy_from, copy_to);
-      }
-      else {  // Generic copy of a single line
-        impl_details.single_copy(copy_from);
-      }
+    auto bad_index_flat = bad_index.flat<int32>();
+    bad_index_flat.device(d) = bad_index_flat.constant(0);
+
+    if (is_axis_zero) {
+      LaunchGatherOpKernelSYCL<T, Index, true>(
+          d, params.data(), indices.data(), out.data(), bad_index_flat.data(),
+          gather_dim_size, indices_size, slice_size, out_size);
+    } else {
+      LaunchGatherOpKernelSYCL<T, Index, false>(
+          d, params.data(), indices.data(), out.data(), bad_index_flat.data(),
+          gather_dim_size, indices_size, slice_size, out_size);
     }
-    copy_from = copy_to++;
-  } while (copy_to <= impl_details.indices_size);
-  return -1;
-}
-
-template <typename T, typename Index>
-struct GatherFunctorSYCL {
-  inline int64 operator()(OpKernelContext* ctx,
-                          typename TTypes<T, 3>::ConstTensor params,
-                          typename TTypes<Index>::ConstFlat indices,
-                          typename TTypes<T, 3>::Tensor out) {
-    if (params.dimension(0) == 1)
-      return HandleCopiesSYCL<HandleCopiesDetailsRows<T, Index>>(ctx, params, indices, out);
-    else
-      return HandleCopiesSYCL<HandleCopiesDetailsCols<T, Index>>(ctx, params, indices, out);
-  }
-};
 
-// Stripped down version of CPU functor which uses Eigen loops to copy slices
-template <typename T, typename Index>
-struct GatherFunctor<SYCLDevice, T, Index> {
-  inline int64 operator()(OpKernelContext* ctx,
-                          typename TTypes<T, 3>::ConstTensor params,
-                          typename TTypes<Index>::ConstFlat indices,
-                          typename TTypes<T, 3>::Tensor out) {
-    return GatherFunctorSYCL<T, Index>()(ctx, params, indices, out);
+    // The temporary tensors are kept alive by the callback until the flag
+    // has been read back.
+    Tensor* host_bad_index = new Tensor(DT_INT32, TensorShape({1}));
+    const string op_name = ctx->op_kernel().name();
+    SYCLUtil::copyDeviceTensorToCPU(
+        d, bad_index, *host_bad_index,
+        [host_bad_index, bad_index, op_name, gather_dim_size](
+            const Status& s) {
+          if (s.ok() && host_bad_index->flat<int32>()(0) != 0) {
+            LOG(ERROR) << op_name << ": some indices are not in [0, "
+                       << gather_dim_size << "), the corresponding output "
+                       << "values have been set to zero";
+          }
+          delete host_bad_index;
+        });
+    return -1;
   }
 };
 #endif  // TENSORFLOW_USE_SYCL
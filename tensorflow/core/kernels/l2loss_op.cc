@@ -31,9 +31,12 @@ typedef Eigen::ThreadPoolDevice CPUDevice;
 typedef Eigen::SyclDevice SYCLDevice;
 #endif  // TENSORFLOW_USE_SYCL
 
-#define REGISTER_KERNEL(T)                                      \
-  REGISTER_KERNEL_BUILDER(                                      \
-      Name("L2Loss").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+#define REGISTER_KERNEL(T)                                              \
+  REGISTER_KERNEL_BUILDER(                                              \
+      Name("L2Loss").Device(DEVICE_CPU).TypeConstraint<T>("T"),         \
+      L2LossOp<CPUDevice, T>);                                          \
+  REGISTER_KERNEL_BUILDER(                                              \
+      Name("_GroupedL2Loss").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
       L2LossOp<CPUDevice, T>);
 
 REGISTER_KERNEL(float);
@@ -43,9 +46,12 @@ REGISTER_KERNEL(Eigen::half);
 
 
 #ifdef TENSORFLOW_USE_SYCL
-#define REGISTER_SYCL_KERNEL(T)                                  \
-  REGISTER_KERNEL_BUILDER(                                       \
-      Name("L2Loss").Device(DEVICE_SYCL).TypeConstraint<T>("T"), \
+#define REGISTER_SYCL_KERNEL(T)                                          \
+  REGISTER_KERNEL_BUILDER(                                               \
+      Name("L2Loss").Device(DEVICE_SYCL).TypeConstraint<T>("T"),         \
+      L2LossOp<SYCLDevice, T>);                                          \
+  REGISTER_KERNEL_BUILDER(                                               \
+      Name("_GroupedL2Loss").Device(DEVICE_SYCL).TypeConstraint<T>("T"), \
       L2LossOp<SYCLDevice, T>);
 
 TF_CALL_SYCL_NUMBER_TYPES(REGISTER_SYCL_KERNEL);
@@ -21,22 +21,25 @@ limitations under the License.
 
 namespace tensorflow {
 
+// Also implements _GroupedL2Loss, computing the loss of each of its inputs.
 template <typename Device, typename T>
 class L2LossOp : public OpKernel {
  public:
   explicit L2LossOp(OpKernelConstruction* context) : OpKernel(context) {}
 
   void Compute(OpKernelContext* context) override {
-    // The input tensor can be of any number of dimensions, even though it's
-    // 2D in most typical applications.
-    const Tensor& input = context->input(0);
-    // The output is a single number.
-    Tensor* output = nullptr;
-    OP_REQUIRES_OK(context,
-                   context->allocate_output(0, TensorShape({}), &output));
     const Device& d = context->eigen_device<Device>();
-    output->scalar<T>().device(d) =
-        (input.flat<T>().square() * static_cast<T>(0.5)).sum();
+    for (int i = 0; i < context->num_inputs(); ++i) {
+      // The input tensor can be of any number of dimensions, even though it's
+      // 2D in most typical applications.
+      const Tensor& input = context->input(i);
+      // The output is a single number.
+      Tensor* output = nullptr;
+      OP_REQUIRES_OK(context,
+                     context->allocate_output(i, TensorShape({}), &output));
+      output->scalar<T>().device(d) =
+          (input.flat<T>().square() * static_cast<T>(0.5)).sum();
+    }
   }
 };
 
@@ -42,28 +42,32 @@ class L2LossOp<GPUDevice, T> : public OpKernel {
   explicit L2LossOp(OpKernelConstruction* context) : OpKernel(context) {}
 
   void Compute(OpKernelContext* context) override {
-    // The input tensor can be of any number of dimensions, even though it's
-    // 2D in most typical applications.
-    const Tensor& input = context->input(0);
-    // The output is a single number.
-    Tensor* output = nullptr;
-    OP_REQUIRES_OK(context,
-                   context->allocate_output(0, TensorShape({}), &output));
     typedef cub::TransformInputIterator<T, squareHalf<T>, T*> inputIterType;
-    inputIterType input_itr((T*)input.flat<T>().data(), squareHalf<T>());
     typedef const Eigen::array<TTypes<float>::Tensor::Index, 1>& ReductionAxes;
-
     Constants<GPUDevice> constants;
-    functor::ReduceImpl<T, cub::Sum, T*, inputIterType, ReductionAxes>(
-        context, (T*)output->flat<T>().data(), input_itr, 1,
-        input.flat<T>().size(), 1, 1, 0, constants.kZero, cub::Sum());
+    for (int i = 0; i < context->num_inputs(); ++i) {
+      // The input tensor can be of any number of dimensions, even though it's
+      // 2D in most typical applications.
+      const Tensor& input = context->input(i);
+      // The output is a single number.
+      Tensor* output = nullptr;
+      OP_REQUIRES_OK(context,
+                     context->allocate_output(i, TensorShape({}), &output));
+      inputIterType input_itr((T*)input.flat<T>().data(), squareHalf<T>());
+      functor::ReduceImpl<T, cub::Sum, T*, inputIterType, ReductionAxes>(
+          context, (T*)output->flat<T>().data(), input_itr, 1,
+          input.flat<T>().size(), 1, 1, 0, constants.kZero, cub::Sum());
+    }
   }
 };
 
 // Registration of the GPU implementations.
-#define REGISTER_GPU_KERNEL(T)                                  \
-  REGISTER_KERNEL_BUILDER(                                      \
-      Name("L2Loss").Device(DEVICE_GPU).TypeConstraint<T>("T"), \
+#define REGISTER_GPU_KERNEL(T)                                          \
+  REGISTER_KERNEL_BUILDER(                                              \
+      Name("L2Loss").Device(DEVICE_GPU).TypeConstraint<T>("T"),         \
+      L2LossOp<GPUDevice, T>);                                          \
+  REGISTER_KERNEL_BUILDER(                                              \
+      Name("_GroupedL2Loss").Device(DEVICE_GPU).TypeConstraint<T>("T"), \
       L2LossOp<GPUDevice, T>);
 
 REGISTER_GPU_KERNEL(float);
@@ -16,21 +16,157 @@ limitations under the License.
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #define EIGEN_USE_THREADS
 
+#include <limits>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/variant.h"
 #include "tensorflow/core/kernels/initializable_lookup_table.h"
+#include "tensorflow/core/lib/gtl/flatmap.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/hash/hash.h"
 
 namespace tensorflow {
 namespace lookup {
 
-// Lookup table that wraps an unordered_map, where the key and value data type
+// A hash map from K to V split into shards, each an open-addressed
+// gtl::FlatMap with its own lock, so that lookups and inserts of keys in
+// different shards don't contend, and lookups of keys in the same shard share
+// its lock.
+template <class K, class V>
+class ShardedFlatMap {
+ public:
+  typedef gtl::FlatMap<K, V, LookupTableHash<K>> Map;
+
+  size_t size() const {
+    size_t size = 0;
+    for (const Shard& shard : shards_) {
+      tf_shared_lock l(shard.mu);
+      size += shard.map.size();
+    }
+    return size;
+  }
+
+  // Calls fn(&map, i) for each key keys(i), where map is the shard of the key,
+  // locked for reading. The keys are visited shard by shard, prefetching the
+  // entries of the ones coming up.
+  template <class Keys, class Fn>
+  void Read(const Keys& keys, Fn fn) const {
+    std::vector<int64> indices[kNumShards];
+    GroupByShard(keys, indices);
+    for (int s = 0; s < kNumShards; ++s) {
+      if (indices[s].empty()) continue;
+      const Shard& shard = shards_[s];
+      tf_shared_lock l(shard.mu);
+      Visit(keys, indices[s], &shard.map, fn);
+    }
+  }
+
+  // Calls fn(&map, i) for each key keys(i), where map is the shard of the key,
+  // locked for writing. If `clear` is true, all shards are cleared first, and
+  // the table is updated atomically.
+  template <class Keys, class Fn>
+  void Write(const Keys& keys, bool clear, Fn fn) {
+    std::vector<int64> indices[kNumShards];
+    GroupByShard(keys, indices);
+    if (clear) {
+      // Locks are always taken in the order of the shards.
+      std::vector<mutex_lock> locks;
+      locks.reserve(kNumShards);
+      for (Shard& shard : shards_) {
+        locks.emplace_back(shard.mu);
+        shard.map.clear();
+      }
+      for (int s = 0; s < kNumShards; ++s) {
+        Visit(keys, indices[s], &shards_[s].map, fn);
+      }
+      return;
+    }
+    for (int s = 0; s < kNumShards; ++s) {
+      if (indices[s].empty()) continue;
+      Shard& shard = shards_[s];
+      mutex_lock l(shard.mu);
+      Visit(keys, indices[s], &shard.map, fn);
+    }
+  }
+
+  // Calls size_fn(size), then entry_fn(key, value) for each entry, with all
+  // the shards locked for reading.
+  template <class SizeFn, class EntryFn>
+  void ForEach(SizeFn size_fn, EntryFn entry_fn) const {
+    std::vector<tf_shared_lock> locks;
+    locks.reserve(kNumShards);
+    size_t size = 0;
+    for (const Shard& shard : shards_) {
+      locks.emplace_back(shard.mu);
+      size += shard.map.size();
+    }
+    size_fn(size);
+    for (const Shard& shard : shards_) {
+      for (const auto& entry : shard.map) {
+        entry_fn(entry.first, entry.second);
+      }
+    }
+  }
+
+  int64 MemoryUsed() const {
+    int64 ret = 0;
+    for (const Shard& shard : shards_) {
+      tf_shared_lock l(shard.mu);
+      // Each entry holds a key, a value and a one-byte marker.
+      ret += shard.map.bucket_count() * (sizeof(K) + sizeof(V) + 1);
+    }
+    return ret;
+  }
+
+ private:
+  static constexpr int kLog2NumShards = 4;
+  static constexpr int kNumShards = 1 << kLog2NumShards;
+
+  struct Shard {
+    mutable mutex mu;
+    Map map GUARDED_BY(mu);
+  };
+
+  // Returns the shard of `key`. It uses the top bits of the hash, which
+  // gtl::FlatMap only uses for huge tables, so that the keys of a shard still
+  // spread over its buckets.
+  static int ShardOf(const K& key) {
+    const size_t h = LookupTableHash<K>()(key);
+    return static_cast<int>(h >> (std::numeric_limits<size_t>::digits -
+                                  kLog2NumShards));
+  }
+
+  template <class Keys>
+  static void GroupByShard(const Keys& keys, std::vector<int64>* indices) {
+    const int64 num_keys = keys.size();
+    for (int64 i = 0; i < num_keys; ++i) {
+      indices[ShardOf(SubtleMustCopyIfIntegral(keys(i)))].push_back(i);
+    }
+  }
+
+  // Calls fn(map, i) for each i in `indices`, prefetching ahead.
+  template <class Keys, class MapPtr, class Fn>
+  static void Visit(const Keys& keys, const std::vector<int64>& indices,
+                    MapPtr map, Fn fn) {
+    const int64 num_indices = indices.size();
+    for (int64 j = 0; j < num_indices; ++j) {
+      if (j + kLookupTablePrefetchDistance < num_indices) {
+        map->prefetch_value(SubtleMustCopyIfIntegral(
+            keys(indices[j + kLookupTablePrefetchDistance])));
+      }
+      fn(map, indices[j]);
+    }
+  }
+
+  Shard shards_[kNumShards];
+};
+
+// Lookup table that wraps a ShardedFlatMap, where the key and value data type
 // is specified. Each individual value must be a scalar. If vector values are
 // required, use MutableHashTableOfTensors.
 //
@@ -49,10 +185,7 @@ class MutableHashTableOfScalars final : public LookupInterface {
  public:
   MutableHashTableOfScalars(OpKernelContext* ctx, OpKernel* kernel) {}
 
-  size_t size() const override {
-    mutex_lock l(mu_);
-    return table_.size();
-  }
+  size_t size() const override { return table_.size(); }
 
   Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
               const Tensor& default_value) override {
@@ -60,12 +193,10 @@ class MutableHashTableOfScalars final : public LookupInterface {
     const auto key_values = key.flat<K>();
     auto value_values = value->flat<V>();
 
-    mutex_lock l(mu_);
-    for (int64 i = 0; i < key_values.size(); ++i) {
-      value_values(i) = gtl::FindWithDefault(
-          table_, SubtleMustCopyIfIntegral(key_values(i)), default_val);
-    }
-
+    table_.Read(key_values, [&](const Map* map, int64 i) {
+      auto it = map->find(SubtleMustCopyIfIntegral(key_values(i)));
+      value_values(i) = it == map->end() ? default_val : it->second;
+    });
     return Status::OK();
   }
 
@@ -73,14 +204,10 @@ class MutableHashTableOfScalars final : public LookupInterface {
     const auto key_values = keys.flat<K>();
     const auto value_values = values.flat<V>();
 
-    mutex_lock l(mu_);
-    if (clear) {
-      table_.clear();
-    }
-    for (int64 i = 0; i < key_values.size(); ++i) {
-      gtl::InsertOrUpdate(&table_, SubtleMustCopyIfIntegral(key_values(i)),
-                          SubtleMustCopyIfIntegral(value_values(i)));
-    }
+    table_.Write(key_values, clear, [&](Map* map, int64 i) {
+      (*map)[SubtleMustCopyIfIntegral(key_values(i))] =
+          SubtleMustCopyIfIntegral(value_values(i));
+    });
     return Status::OK();
   }
 
@@ -95,24 +222,25 @@ class MutableHashTableOfScalars final : public LookupInterface {
   }
 
   Status ExportValues(OpKernelContext* ctx) override {
-    mutex_lock l(mu_);
-    int64 size = table_.size();
-
-    Tensor* keys;
-    Tensor* values;
-    TF_RETURN_IF_ERROR(
-        ctx->allocate_output("keys", TensorShape({size}), &keys));
-    TF_RETURN_IF_ERROR(
-        ctx->allocate_output("values", TensorShape({size}), &values));
-
-    auto keys_data = keys->flat<K>();
-    auto values_data = values->flat<V>();
+    Status status;
+    Tensor* keys = nullptr;
+    Tensor* values = nullptr;
     int64 i = 0;
-    for (auto it = table_.begin(); it != table_.end(); ++it, ++i) {
-      keys_data(i) = it->first;
-      values_data(i) = it->second;
-    }
-    return Status::OK();
+    table_.ForEach(
+        [&](int64 size) {
+          status.Update(
+              ctx->allocate_output("keys", TensorShape({size}), &keys));
+          if (!status.ok()) return;
+          status.Update(
+              ctx->allocate_output("values", TensorShape({size}), &values));
+        },
+        [&](const K& key, const V& value) {
+          if (!status.ok()) return;
+          keys->flat<K>()(i) = key;
+          values->flat<V>()(i) = value;
+          ++i;
+        });
+    return status;
   }
 
   DataType key_dtype() const override { return DataTypeToEnum<K>::v(); }
@@ -124,26 +252,15 @@ class MutableHashTableOfScalars final : public LookupInterface {
   TensorShape value_shape() const override { return TensorShape(); }
 
   int64 MemoryUsed() const override {
-    int64 ret = 0;
-    mutex_lock l(mu_);
-    for (unsigned i = 0; i < table_.bucket_count(); ++i) {
-      size_t bucket_size = table_.bucket_size(i);
-      if (bucket_size == 0) {
-        ret++;
-      } else {
-        ret += bucket_size;
-      }
-    }
-    return sizeof(MutableHashTableOfScalars) + ret;
+    return sizeof(MutableHashTableOfScalars) + table_.MemoryUsed();
   }
 
  private:
-  // TODO(andreasst): consider using a read/write lock or a concurrent map
-  mutable mutex mu_;
-  std::unordered_map<K, V> table_ GUARDED_BY(mu_);
+  typedef typename ShardedFlatMap<K, V>::Map Map;
+  ShardedFlatMap<K, V> table_;
 };
 
-// Lookup table that wraps an unordered_map. Behaves identical to
+// Lookup table that wraps a ShardedFlatMap. Behaves identical to
 // MutableHashTableOfScalars except that each value must be a vector.
 template <class K, class V>
 class MutableHashTableOfTensors final : public LookupInterface {
@@ -157,10 +274,7 @@ class MutableHashTableOfTensors final : public LookupInterface {
                                 value_shape_.DebugString()));
   }
 
-  size_t size() const override {
-    mutex_lock l(mu_);
-    return table_.size();
-  }
+  size_t size() const override { return table_.size(); }
 
   Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
               const Tensor& default_value) override {
@@ -169,21 +283,19 @@ class MutableHashTableOfTensors final : public LookupInterface {
     auto value_values = value->flat_inner_dims<V, 2>();
     int64 value_dim = value_shape_.dim_size(0);
 
-    mutex_lock l(mu_);
-    for (int64 i = 0; i < key_values.size(); ++i) {
-      ValueArray* value_vec =
-          gtl::FindOrNull(table_, SubtleMustCopyIfIntegral(key_values(i)));
-      if (value_vec != nullptr) {
+    table_.Read(key_values, [&](const Map* map, int64 i) {
+      auto it = map->find(SubtleMustCopyIfIntegral(key_values(i)));
+      if (it != map->end()) {
+        const ValueArray& value_vec = it->second;
         for (int64 j = 0; j < value_dim; j++) {
-          value_values(i, j) = value_vec->at(j);
+          value_values(i, j) = value_vec.at(j);
         }
       } else {
         for (int64 j = 0; j < value_dim; j++) {
           value_values(i, j) = default_flat(j);
         }
       }
-    }
-
+    });
     return Status::OK();
   }
 
@@ -192,19 +304,14 @@ class MutableHashTableOfTensors final : public LookupInterface {
     const auto value_values = values.flat_inner_dims<V, 2>();
     int64 value_dim = value_shape_.dim_size(0);
 
-    mutex_lock l(mu_);
-    if (clear) {
-      table_.clear();
-    }
-    for (int64 i = 0; i < key_values.size(); ++i) {
-      ValueArray value_vec;
+    table_.Write(key_values, clear, [&](Map* map, int64 i) {
+      ValueArray& value_vec = (*map)[SubtleMustCopyIfIntegral(key_values(i))];
+      value_vec.clear();
       for (int64 j = 0; j < value_dim; j++) {
         V value = value_values(i, j);
         value_vec.push_back(value);
       }
-      gtl::InsertOrUpdate(&table_, SubtleMustCopyIfIntegral(key_values(i)),
-                          value_vec);
-    }
+    });
     return Status::OK();
   }
 
@@ -219,29 +326,30 @@ class MutableHashTableOfTensors final : public LookupInterface {
   }
 
   Status ExportValues(OpKernelContext* ctx) override {
-    mutex_lock l(mu_);
-    int64 size = table_.size();
     int64 value_dim = value_shape_.dim_size(0);
 
-    Tensor* keys;
-    Tensor* values;
-    TF_RETURN_IF_ERROR(
-        ctx->allocate_output("keys", TensorShape({size}), &keys));
-    TF_RETURN_IF_ERROR(ctx->allocate_output(
-        "values", TensorShape({size, value_dim}), &values));
-
-    auto keys_data = keys->flat<K>();
-    auto values_data = values->matrix<V>();
+    Status status;
+    Tensor* keys = nullptr;
+    Tensor* values = nullptr;
     int64 i = 0;
-    for (auto it = table_.begin(); it != table_.end(); ++it, ++i) {
-      K key = it->first;
-      ValueArray value = it->second;
-      keys_data(i) = key;
-      for (int64 j = 0; j < value_dim; j++) {
-        values_data(i, j) = value[j];
-      }
-    }
-    return Status::OK();
+    table_.ForEach(
+        [&](int64 size) {
+          status.Update(
+              ctx->allocate_output("keys", TensorShape({size}), &keys));
+          if (!status.ok()) return;
+          status.Update(ctx->allocate_output(
+              "values", TensorShape({size, value_dim}), &values));
+        },
+        [&](const K& key, const ValueArray& value) {
+          if (!status.ok()) return;
+          keys->flat<K>()(i) = key;
+          auto values_data = values->matrix<V>();
+          for (int64 j = 0; j < value_dim; j++) {
+            values_data(i, j) = value[j];
+          }
+          ++i;
+        });
+    return status;
   }
 
   DataType key_dtype() const override { return DataTypeToEnum<K>::v(); }
@@ -253,25 +361,15 @@ class MutableHashTableOfTensors final : public LookupInterface {
   TensorShape value_shape() const override { return value_shape_; }
 
   int64 MemoryUsed() const override {
-    int64 ret = 0;
-    mutex_lock l(mu_);
-    for (unsigned i = 0; i < table_.bucket_count(); ++i) {
-      size_t bucket_size = table_.bucket_size(i);
-      if (bucket_size == 0) {
-        ret++;
-      } else {
-        ret += bucket_size;
-      }
-    }
-    return sizeof(MutableHashTableOfTensors) + ret;
+    return sizeof(MutableHashTableOfTensors) + table_.MemoryUsed();
   }
 
  private:
-  TensorShape value_shape_;
-  // TODO(andreasst): consider using a read/write lock or a concurrent map
-  mutable mutex mu_;
   typedef gtl::InlinedVector<V, 4> ValueArray;
-  std::unordered_map<K, ValueArray> table_ GUARDED_BY(mu_);
+  typedef typename ShardedFlatMap<K, ValueArray>::Map Map;
+
+  TensorShape value_shape_;
+  ShardedFlatMap<K, ValueArray> table_;
 };
 
 namespace {
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_KERNELS_LOOKUP_TABLE_OP_H_
 #define TENSORFLOW_KERNELS_LOOKUP_TABLE_OP_H_
 
+#include <type_traits>
+
 #include "tensorflow/core/framework/lookup_interface.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/resource_mgr.h"
@@ -25,7 +27,9 @@ limitations under the License.
 #include "tensorflow/core/kernels/lookup_util.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/gtl/flatmap.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/thread_annotations.h"
 
@@ -143,8 +147,30 @@ inline const Variant& SubtleMustCopyIfIntegral(const Variant& value) {
   return value;
 }
 
-// Lookup table that wraps an unordered_map, where the key and value data type
-// is specified.
+// Hash function for the keys of the hash tables.  gtl::FlatMap derives both
+// the bucket of a key and the marker it stores with the entry from its hash,
+// and std::hash maps integers to themselves, so integer keys are mixed first:
+// otherwise dense ranges of them would pile up in the same buckets.
+template <class K, class Enable = void>
+struct LookupTableHash {
+  size_t operator()(const K& key) const { return hash<K>()(key); }
+};
+
+template <class K>
+struct LookupTableHash<
+    K, typename std::enable_if<std::is_integral<K>::value>::type> {
+  size_t operator()(K key) const {
+    const uint64 h = static_cast<uint64>(key) * 0x9ddfea08eb382d69ULL;
+    return static_cast<size_t>(h ^ (h >> 32));
+  }
+};
+
+// How many keys ahead the hash tables prefetch the entries of, when looking
+// up a batch of keys.
+constexpr int64 kLookupTablePrefetchDistance = 8;
+
+// Lookup table that wraps an open-addressed gtl::FlatMap, where the key and
+// value data type is specified.
 //
 // This table is recommended for any variations to key values.
 //
@@ -211,8 +237,7 @@ class HashTable : public InitializableLookupTable {
       return errors::Aborted("HashTable already initialized.");
     }
     if (!table_) {
-      table_ = std::unique_ptr<std::unordered_map<K, V>>(
-          new std::unordered_map<K, V>());
+      table_ = std::unique_ptr<Map>(new Map());
     }
     return Status::OK();
   };
@@ -232,7 +257,7 @@ class HashTable : public InitializableLookupTable {
     for (int64 i = 0; i < key_values.size(); ++i) {
       const K key = SubtleMustCopyIfIntegral(key_values(i));
       const V value = SubtleMustCopyIfIntegral(value_values(i));
-      const V& previous_value = gtl::LookupOrInsert(table_.get(), key, value);
+      const V& previous_value = table_->insert({key, value}).first->second;
       if (previous_value != value) {
         return errors::FailedPrecondition(
             "HashTable has different value for same key. Key ", key, " has ",
@@ -248,24 +273,31 @@ class HashTable : public InitializableLookupTable {
     const auto key_values = key.flat<K>();
     auto value_values = value->flat<V>();
 
-    for (int64 i = 0; i < key_values.size(); ++i) {
-      value_values(i) = gtl::FindWithDefault(
-          *table_, SubtleMustCopyIfIntegral(key_values(i)), default_val);
+    const int64 num_keys = key_values.size();
+    for (int64 i = 0; i < num_keys; ++i) {
+      if (i + kLookupTablePrefetchDistance < num_keys) {
+        table_->prefetch_value(SubtleMustCopyIfIntegral(
+            key_values(i + kLookupTablePrefetchDistance)));
+      }
+      auto it = table_->find(SubtleMustCopyIfIntegral(key_values(i)));
+      value_values(i) = it == table_->end() ? default_val : it->second;
     }
     return Status::OK();
   }
 
   int64 MemoryUsed() const override {
     if (table_) {
-      const int64 num_elements = table_->size();
-      return num_elements * (sizeof(K) + sizeof(V));
+      // Each entry holds a key, a value and a one-byte marker.
+      const int64 num_entries = table_->bucket_count();
+      return num_entries * (sizeof(K) + sizeof(V) + 1);
     } else {
       return 0;
     }
   }
 
  private:
-  std::unique_ptr<std::unordered_map<K, V>> table_;
+  typedef gtl::FlatMap<K, V, LookupTableHash<K>> Map;
+  std::unique_ptr<Map> table_;
 };
 
 }  // namespace lookup
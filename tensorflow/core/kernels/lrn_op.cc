@@ -270,26 +270,28 @@ struct LRNKernelSYCL {
     cl::sycl::accessor<Eigen::buffer_scalar_t, 1,
                        cl::sycl::access::mode::read,
                        cl::sycl::access::target::global_buffer>;
-  using dw_acc =
+  using w_acc =
     cl::sycl::accessor<Eigen::buffer_scalar_t, 1,
-                       cl::sycl::access::mode::discard_write,
+                       cl::sycl::access::mode::write,
                        cl::sycl::access::target::global_buffer>;
 
   LRNKernelSYCL(int depth, int depth_radius, T bias, T alpha, T beta,
-                r_acc in_acc, dw_acc out_acc, const int rows, const int cols)
+                r_acc in_acc, int in_offset, w_acc out_acc, int out_offset,
+                const int rows, const int cols)
     : depth_(depth), depth_radius_(depth_radius), bias_(bias), alpha_(alpha),
-      binary_op_(BinaryOp(beta)), in_acc_(in_acc), out_acc_(out_acc),
-      rows_(rows), cols_(cols) {}
+      binary_op_(BinaryOp(beta)), in_acc_(in_acc), in_offset_(in_offset),
+      out_acc_(out_acc), out_offset_(out_offset), rows_(rows), cols_(cols) {}
 
   inline void operator()(cl::sycl::nd_item<2> item) {
-    T* in_data = ConvertToActualTypeSycl(T, in_acc_);
-    T* out_data = ConvertToActualTypeSycl(T, out_acc_);
+    T* in_data = ConvertToActualTypeSycl(T, in_acc_) + in_offset_;
+    T* out_data = ConvertToActualTypeSycl(T, out_acc_) + out_offset_;
 
-    const auto id = item.get_global_linear_id();
     const int row = item.get_global_id(0);
     const int col = item.get_global_id(1);
     if (row >= rows_ || col >= cols_)
       return;
+    // The global range is rounded up, so the linear id would skip elements.
+    const int id = row * cols_ + col;
     const int base_id = row * depth_;
     int start_col = col - depth_radius_;
     int band_width = 2 * depth_radius_ + 1;
@@ -315,7 +317,9 @@ struct LRNKernelSYCL {
   T alpha_;
   BinaryOp binary_op_;
   r_acc in_acc_;
-  dw_acc out_acc_;
+  const int in_offset_;
+  w_acc out_acc_;
+  const int out_offset_;
   const int rows_, cols_;
 };
 
@@ -337,24 +341,30 @@ struct LaunchLRN<SYCLDevice, T> {
       const int depth = static_cast<int>(in.dim_size(3));
       const int reshaped_rows = batch * rows * cols;
       cl::sycl::nd_range<2> rng = SYCLUtil::get_nd_range(device, reshaped_rows, depth);
-      auto in_acc = device.get_sycl_buffer(in.template flat<T>().data())
+      const T* in_ptr = in.template flat<T>().data();
+      T* out_ptr = output->template flat<T>().data();
+      auto in_acc = device.get_sycl_buffer(in_ptr)
           .template get_access<cl::sycl::access::mode::read>(cgh);
-      auto out_acc = device.get_sycl_buffer(output->template flat<T>().data())
-          .template get_access<cl::sycl::access::mode::discard_write>(cgh);
+      // The output may share its buffer with other tensors, so the buffer
+      // must not be discarded.
+      auto out_acc = device.get_sycl_buffer(out_ptr)
+          .template get_access<cl::sycl::access::mode::write>(cgh);
+      const int in_offset = device.get_offset(in_ptr) / sizeof(T);
+      const int out_offset = device.get_offset(out_ptr) / sizeof(T);
       if (beta_ == T(1)) {
         LRNKernelSYCL<T, LRNInvSYCL<T>>
-          kernel(depth, depth_radius_, bias_, alpha_, beta_, in_acc, out_acc,
-                 reshaped_rows, depth);
+          kernel(depth, depth_radius_, bias_, alpha_, beta_, in_acc,
+                 in_offset, out_acc, out_offset, reshaped_rows, depth);
         cgh.parallel_for(rng, kernel);
       } else if (beta_ == T(0.5)) {
         LRNKernelSYCL<T, LRNRsqrtSYCL<T>>
-          kernel(depth, depth_radius_, bias_, alpha_, beta_, in_acc, out_acc,
-                 reshaped_rows, depth);
+          kernel(depth, depth_radius_, bias_, alpha_, beta_, in_acc,
+                 in_offset, out_acc, out_offset, reshaped_rows, depth);
         cgh.parallel_for(rng, kernel);
       } else {
         LRNKernelSYCL<T, LRNGenSYCL<T>>
-          kernel(depth, depth_radius_, bias_, alpha_, beta_, in_acc, out_acc,
-                 reshaped_rows, depth);
+          kernel(depth, depth_radius_, bias_, alpha_, beta_, in_acc,
+                 in_offset, out_acc, out_offset, reshaped_rows, depth);
         cgh.parallel_for(rng, kernel);
       }
     });
@@ -23,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/kernels/fill_functor.h"
+#include "tensorflow/core/kernels/fused_output_kernels.h"
 #include "tensorflow/core/util/matmul_autotune.h"
 #if GOOGLE_CUDA
 #include "cuda/include/cuda.h"
@@ -32,6 +33,7 @@ limitations under the License.
 
 #ifdef TENSORFLOW_USE_SYCL
 #include "tensorflow/core/kernels/sycl_blas_utils.h"
+#include "tensorflow/core/kernels/sycl_co_execution.h"
 #endif  // TENSORFLOW_USE_SYCL
 
 #ifdef ARM_COMPUTE_CL
@@ -61,6 +63,13 @@ ToEigenMatrix(const Tensor& tensor) {
   return Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>::Map(
       matrix.data(), matrix.dimension(0), matrix.dimension(1));
 }
+template <typename T>
+Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
+ToEigenMatrix(Tensor* tensor) {
+  auto matrix = tensor->matrix<T>();
+  return Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>::Map(
+      matrix.data(), matrix.dimension(0), matrix.dimension(1));
+}
 
 // Converts a TensorFlow Tensor to an Eigen Vector.
 template <typename T>
@@ -119,6 +128,49 @@ bool ExplicitVectorMatrixOptimization<Eigen::half>(
   return false;
 }
 
+// The most multiply-adds for which ExplicitSmallMatrixOptimization applies.
+// Up to this size, the fixed cost of an Eigen Tensor contraction, which
+// shards the product over the thread pool, outweighs the product itself.
+constexpr int64 kMaxSmallMatMulMultiplyAdds = 1 << 18;
+
+// If the product is small, multiply the matrices on the calling thread with
+// plain Eigen, whose matrix products go straight to its register-blocked
+// kernels (or to coefficient-wise ones for the tiniest sizes), and return
+// true; else return false.
+template <typename T>
+bool ExplicitSmallMatrixOptimization(
+    const Tensor& a, const Tensor& b,
+    const Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1>& dim_pair,
+    Tensor* out) {
+  const int64 k = a.dim_size(dim_pair[0].first);
+  if (out->dim_size(0) * out->dim_size(1) * k > kMaxSmallMatMulMultiplyAdds) {
+    return false;
+  }
+  auto out_m = ToEigenMatrix<T>(out);
+  auto a_m = ToEigenMatrix<T>(a);
+  auto b_m = ToEigenMatrix<T>(b);
+  const bool transpose_a = dim_pair[0].first == 0;
+  const bool transpose_b = dim_pair[0].second == 1;
+  if (transpose_a && transpose_b) {
+    out_m.noalias() = a_m.transpose() * b_m.transpose();
+  } else if (transpose_a) {
+    out_m.noalias() = a_m.transpose() * b_m;
+  } else if (transpose_b) {
+    out_m.noalias() = a_m * b_m.transpose();
+  } else {
+    out_m.noalias() = a_m * b_m;
+  }
+  return true;
+}
+// Half is not supported.
+template <>
+bool ExplicitSmallMatrixOptimization<Eigen::half>(
+    const Tensor& a, const Tensor& b,
+    const Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1>& dim_pair,
+    Tensor* out) {
+  return false;
+}
+
 template <typename Device, typename T>
 struct LaunchMatMulBase {
 #if GOOGLE_CUDA
@@ -134,7 +186,9 @@ struct LaunchMatMulBase {
     // An explicit vector-matrix multiply is much better optimized than an
     // implicit one and this is a bottleneck during non-batched inference.
     bool was_vector = ExplicitVectorMatrixOptimization<T>(a, b, dim_pair, out);
-    if (!was_vector) {
+    // Likewise for small matrices, common in per-request inference.
+    if (!was_vector &&
+        !ExplicitSmallMatrixOptimization<T>(a, b, dim_pair, out)) {
       functor::MatMulFunctor<Device, T>()(ctx->eigen_device<Device>(),
                                           out->matrix<T>(), a.matrix<T>(),
                                           b.matrix<T>(), dim_pair);
@@ -440,9 +494,59 @@ struct LaunchMatMul<SYCLDevice, T, USE_CUBLAS> {
   static void launch(
       OpKernelContext* ctx, const Tensor& a, const Tensor& b,
       const Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1>& dim_pair,
-      std::vector<AlgorithmType>*, bool, Tensor* out) {
+      std::vector<AlgorithmType>* algorithms, bool use_autotune,
+      Tensor* out) {
     auto& device = ctx->eigen_sycl_device();
-    SYCLBlasExecutor ex(device.sycl_queue());
+    // Only the rows of a are contiguous, so a transposed a is not split.
+    const bool transpose_a = dim_pair[0].first == 0;
+    const int64 m = out->dim_size(0);
+    SYCLCoExecution* co_execution = nullptr;
+    int64 host_rows = 0;
+    if (SYCLCoExecution::Enabled() && !transpose_a) {
+      co_execution = SYCLCoExecution::Get(device.sycl_queue());
+      host_rows = co_execution->HostRows(
+          m, m * out->dim_size(1) * a.dim_size(dim_pair[0].first));
+    }
+    if (host_rows == 0) {
+      Gemm(device, a, b, dim_pair, out);
+      return;
+    }
+
+    // The first rows are computed on the device and the last ones on the
+    // host, by the CPU kernel.
+    const int64 device_rows = m - host_rows;
+    Tensor host_a, host_b, host_out;
+    OP_REQUIRES_OK(ctx, SYCLCoExecution::CopyToHost(
+                            ctx, a.Slice(device_rows, m), &host_a));
+    OP_REQUIRES_OK(ctx, SYCLCoExecution::CopyToHost(ctx, b, &host_b));
+    Tensor out_rows = out->Slice(device_rows, m);
+    OP_REQUIRES_OK(ctx,
+                   SYCLCoExecution::AllocateHost(ctx, out_rows, &host_out));
+    const Tensor device_a = a.Slice(0, device_rows);
+    Tensor device_out = out->Slice(0, device_rows);
+    co_execution->Run(
+        device, device_rows, host_rows,
+        [&] { Gemm(device, device_a, b, dim_pair, &device_out); },
+        [&] {
+          LaunchMatMul<CPUDevice, T, false>::launch(
+              ctx, host_a, host_b, dim_pair, algorithms, use_autotune,
+              &host_out);
+        });
+    if (!ctx->status().ok()) return;
+    SYCLUtil::blockingCopyCPUTensorToDevice(device, host_out, out_rows);
+  }
+
+  static void GetBlasGemmAlgorithm(OpKernelConstruction*,
+                                   std::vector<int64>*,
+                                   bool*) {}
+
+ private:
+  static void Gemm(
+      const SYCLDevice& device, const Tensor& a, const Tensor& b,
+      const Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1>& dim_pair,
+      Tensor* out) {
+    auto ex_handle = AcquireSYCLBlasExecutor(device);
+    SYCLBlasExecutor& ex = *ex_handle;
     auto ta = a.matrix<T>();
     auto tb = b.matrix<T>();
     auto tc = out->matrix<T>();
@@ -466,11 +570,41 @@ struct LaunchMatMul<SYCLDevice, T, USE_CUBLAS> {
     blas::_gemm(ex, t_x, t_y, trans_m, trans_n, k, T(1), rhs_blas_ptr, lda,
                 lhs_blas_ptr, ldb, T(0), out_blas_ptr, ldc);
   }
+};
+
+#ifndef TENSORFLOW_SYCL_NO_HALF
+// Accumulating a long dot product in half loses too much precision, so half
+// matrices are multiplied by the float gemm and only stored in half.
+template <bool USE_CUBLAS>
+struct LaunchMatMul<SYCLDevice, Eigen::half, USE_CUBLAS> {
+  typedef int64 AlgorithmType;
+  static void launch(
+      OpKernelContext* ctx, const Tensor& a, const Tensor& b,
+      const Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1>& dim_pair,
+      std::vector<AlgorithmType>* algorithms, bool use_autotune,
+      Tensor* out) {
+    auto& device = ctx->eigen_sycl_device();
+    Tensor a_float, b_float, out_float;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(DT_FLOAT, a.shape(), &a_float));
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(DT_FLOAT, b.shape(), &b_float));
+    OP_REQUIRES_OK(ctx,
+                   ctx->allocate_temp(DT_FLOAT, out->shape(), &out_float));
+    a_float.flat<float>().device(device) =
+        a.flat<Eigen::half>().template cast<float>();
+    b_float.flat<float>().device(device) =
+        b.flat<Eigen::half>().template cast<float>();
+    LaunchMatMul<SYCLDevice, float, USE_CUBLAS>::launch(
+        ctx, a_float, b_float, dim_pair, algorithms, use_autotune,
+        &out_float);
+    out->flat<Eigen::half>().device(device) =
+        out_float.flat<float>().template cast<Eigen::half>();
+  }
 
   static void GetBlasGemmAlgorithm(OpKernelConstruction*,
                                    std::vector<int64>*,
                                    bool*) {}
 };
+#endif  // TENSORFLOW_SYCL_NO_HALF
 #endif  // TENSORFLOW_USE_SYCL
 
 template <typename Device, typename T, bool USE_CUBLAS>
@@ -715,6 +849,68 @@ TF_CALL_complex64(REGISTER_CPU);
 TF_CALL_complex128(REGISTER_CPU);
 #endif
 
+// MatMul followed by a BiasAdd, and optionally by Relu, Relu6 or Elu, created
+// by the remapper. The fused ops are applied to blocks of output rows by the
+// thread that computed them, while they are still in cache.
+template <typename T>
+class FusedMatMulOp : public OpKernel {
+ public:
+  explicit FusedMatMulOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("transpose_a", &transpose_a_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("transpose_b", &transpose_b_));
+    OP_REQUIRES_OK(ctx, ParseFusedOutputSpec(ctx, &spec_));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    const Tensor& a = ctx->input(0);
+    const Tensor& b = ctx->input(1);
+
+    OP_REQUIRES(ctx, TensorShapeUtils::IsMatrix(a.shape()),
+                errors::InvalidArgument("In[0] is not a matrix"));
+    OP_REQUIRES(ctx, TensorShapeUtils::IsMatrix(b.shape()),
+                errors::InvalidArgument("In[1] is not a matrix"));
+    Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1> dim_pair;
+    dim_pair[0].first = transpose_a_ ? 0 : 1;
+    dim_pair[0].second = transpose_b_ ? 1 : 0;
+
+    OP_REQUIRES(
+        ctx, a.dim_size(dim_pair[0].first) == b.dim_size(dim_pair[0].second),
+        errors::InvalidArgument(
+            "Matrix size-incompatible: In[0]: ", a.shape().DebugString(),
+            ", In[1]: ", b.shape().DebugString()));
+    const int64 m = a.dim_size(1 - dim_pair[0].first);
+    const int64 n = b.dim_size(1 - dim_pair[0].second);
+    Tensor* out = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(0, TensorShape({m, n}), &out));
+    if (out->NumElements() == 0) return;
+
+    FusedOutputKernel<T> output_kernel;
+    OP_REQUIRES_OK(ctx, output_kernel.Init(ctx, spec_, 2, n));
+    if (a.NumElements() == 0 || b.NumElements() == 0) {
+      functor::SetZeroFunctor<CPUDevice, T> f;
+      f(ctx->eigen_device<CPUDevice>(), out->flat<T>());
+      ApplyFusedOutputKernel<T>(ctx, output_kernel, n, out->flat<T>().data(),
+                                m);
+      return;
+    }
+    LaunchFusedMatMul<T>(ctx, a.matrix<T>(), b.matrix<T>(), dim_pair,
+                         output_kernel, out->matrix<T>());
+  }
+
+ private:
+  FusedOutputSpec spec_;
+  bool transpose_a_;
+  bool transpose_b_;
+};
+
+#define REGISTER_FUSED_CPU(T)                                         \
+  REGISTER_KERNEL_BUILDER(                                            \
+      Name("_FusedMatMul").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      FusedMatMulOp<T>);
+TF_CALL_float(REGISTER_FUSED_CPU);
+TF_CALL_double(REGISTER_FUSED_CPU);
+#undef REGISTER_FUSED_CPU
+
 #if GOOGLE_CUDA
 TF_CALL_float(REGISTER_GPU);
 TF_CALL_double(REGISTER_GPU);
@@ -143,4 +143,13 @@ BM_Matmul(2000, 1, 2000, true, false);
 BM_Matmul(2000, 1, 2000, false, true);
 BM_Matmul(2000, 1, 2000, true, true);
 
+// Test some small matrix multiplies.
+BM_Matmul(4, 64, 64, false, false);
+BM_Matmul(16, 32, 16, false, false);
+BM_Matmul(16, 32, 16, true, false);
+BM_Matmul(16, 32, 16, false, true);
+BM_Matmul(16, 32, 16, true, true);
+BM_Matmul(32, 256, 32, false, false);
+BM_Matmul(64, 64, 64, false, false);
+
 }  // end namespace tensorflow
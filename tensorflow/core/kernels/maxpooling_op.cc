@@ -1543,7 +1543,7 @@ class MaxPoolingOp<SYCLDevice, T> : public OpKernel {
     auto out_t = output->template flat<T>();
     auto in_ptr = in_t.data();
     auto out_ptr = out_t.data();
-    CREATE_SNN_BACKEND(sd_backend, device);
+    ACQUIRE_SNN_BACKEND(sd_backend, device);
     auto sd_in = get_sycl_dnn_input<T>(device, in_ptr);
     auto sd_out = get_sycl_dnn_input<T>(device, out_ptr);
     sycldnn::SNNStatus sd_status;
@@ -1655,7 +1655,7 @@ class MaxPoolingV2Op<SYCLDevice, T> : public OpKernel {
     auto out_t = output->template flat<T>();
     auto in_ptr = in_t.data();
     auto out_ptr = out_t.data();
-    CREATE_SNN_BACKEND(sd_backend, device);
+    ACQUIRE_SNN_BACKEND(sd_backend, device);
     auto sd_in = get_sycl_dnn_input<T>(device, in_ptr);
     auto sd_out = get_sycl_dnn_input<T>(device, out_ptr);
     sycldnn::SNNStatus sd_status;
@@ -1793,7 +1793,7 @@ class MaxPoolingGradOp<SYCLDevice, T> : public OpKernel {
     auto backprop_ptr = backprop_t.data();
     auto out_ptr = out_t.data();
 
-    CREATE_SNN_BACKEND(sd_backend, device);
+    ACQUIRE_SNN_BACKEND(sd_backend, device);
     auto sd_in_data = get_sycl_dnn_input<T>(device, in_data_ptr);
     auto sd_out_data = get_sycl_dnn_input<T>(device, out_data_ptr);
     auto sd_backprop = get_sycl_dnn_input<T>(device, backprop_ptr);
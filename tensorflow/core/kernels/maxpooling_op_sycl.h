@@ -81,7 +81,7 @@ template <typename T, typename Comparator>
 class MaxPool2DSYCL {
  public:
   static constexpr auto read_mode = cl::sycl::access::mode::read;
-  static constexpr auto write_mode = cl::sycl::access::mode::discard_write;
+  static constexpr auto write_mode = cl::sycl::access::mode::write;
   static constexpr auto global_access = cl::sycl::access::target::global_buffer;
   using read_accessor =
       cl::sycl::accessor<uint8_t, 1, read_mode, global_access>;
@@ -90,16 +90,22 @@ class MaxPool2DSYCL {
 
   MaxPool2DSYCL(const int output_size, const PoolParameters& params,
                 const read_accessor input_accessor,
-                write_accessor output_accessor)
+                const int input_offset,
+                write_accessor output_accessor,
+                const int output_offset)
       : output_size_{output_size},
         p_{params},
         input_accessor_{input_accessor},
-        output_accessor_{output_accessor} {}
+        input_offset_{input_offset},
+        output_accessor_{output_accessor},
+        output_offset_{output_offset} {}
   inline TF_ATTRIBUTE_ALWAYS_INLINE void operator()(cl::sycl::item<1> item) {
     int index = item.get_id(0);
     if (index < output_size_) {
-      T* input_data = ConvertToActualTypeSycl(T, input_accessor_);
-      T* output_data = ConvertToActualTypeSycl(T, output_accessor_);
+      T* input_data =
+          ConvertToActualTypeSycl(T, input_accessor_) + input_offset_;
+      T* output_data =
+          ConvertToActualTypeSycl(T, output_accessor_) + output_offset_;
 
       const helpers::TensorIndex4D index4d = helpers::unflatten4d<int, false>(
           index, p_.out_rows_, p_.out_rows_, p_.out_cols_, p_.out_cols_,
@@ -134,7 +140,9 @@ class MaxPool2DSYCL {
   const int output_size_;
   const SYCL2DPoolParams p_;
   const read_accessor input_accessor_;
+  const int input_offset_;
   write_accessor output_accessor_;
+  const int output_offset_;
 };
 template <typename T, typename Comparator>
 struct LaunchMaxPoolingOpSYCL {
@@ -152,13 +160,18 @@ struct LaunchMaxPoolingOpSYCL {
 
     auto input_buffer =
         device.get_sycl_buffer(tensor_in.template flat<T>().data());
+    const int input_offset =
+        device.get_offset(tensor_in.template flat<T>().data()) / sizeof(T);
     auto output_buffer =
         device.get_sycl_buffer(output->template flat<T>().data());
+    const int output_offset =
+        device.get_offset(output->template flat<T>().data()) / sizeof(T);
 
     device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
       auto input_access = input_buffer.template get_access<read_mode>(cgh);
       auto output_access = output_buffer.template get_access<write_mode>(cgh);
-      Functor max_pool(output_size, params, input_access, output_access);
+      Functor max_pool(output_size, params, input_access, input_offset,
+                       output_access, output_offset);
 
       cgh.parallel_for(cl::sycl::range<1>(n_threads), max_pool);
     });
@@ -180,7 +193,7 @@ template <typename T, typename EqualCheck>
 class MaxPoolGradSYCL {
  public:
   static constexpr auto read_mode = cl::sycl::access::mode::read;
-  static constexpr auto write_mode = cl::sycl::access::mode::discard_write;
+  static constexpr auto write_mode = cl::sycl::access::mode::write;
   static constexpr auto global_access = cl::sycl::access::target::global_buffer;
   using read_accessor =
       cl::sycl::accessor<uint8_t, 1, read_mode, global_access>;
@@ -189,23 +202,37 @@ class MaxPoolGradSYCL {
 
   MaxPoolGradSYCL(const int output_size, const SYCL2DPoolParams& params,
                   const read_accessor input_data_accessor,
+                  const int input_data_offset,
                   const read_accessor output_data_accessor,
+                  const int output_data_offset,
                   const read_accessor input_backprop_accessor,
-                  write_accessor output_backprop_accessor)
+                  const int input_backprop_offset,
+                  write_accessor output_backprop_accessor,
+                  const int output_backprop_offset)
       : output_size_{output_size},
         p_{params},
         input_data_accessor_{input_data_accessor},
+        input_data_offset_{input_data_offset},
         output_data_accessor_{output_data_accessor},
+        output_data_offset_{output_data_offset},
         input_backprop_accessor_{input_backprop_accessor},
-        output_backprop_accessor_{output_backprop_accessor} {}
+        input_backprop_offset_{input_backprop_offset},
+        output_backprop_accessor_{output_backprop_accessor},
+        output_backprop_offset_{output_backprop_offset} {}
   inline TF_ATTRIBUTE_ALWAYS_INLINE void operator()(cl::sycl::item<1> item) {
     const int index = item.get_id(0);
     if (index < output_size_) {
-      T* input_data = ConvertToActualTypeSycl(T, input_data_accessor_);
-      T* output_data = ConvertToActualTypeSycl(T, output_data_accessor_);
-      T* input_backprop = ConvertToActualTypeSycl(T, input_backprop_accessor_);
+      T* input_data =
+          ConvertToActualTypeSycl(T, input_data_accessor_) + input_data_offset_;
+      T* output_data =
+          ConvertToActualTypeSycl(T, output_data_accessor_) +
+          output_data_offset_;
+      T* input_backprop =
+          ConvertToActualTypeSycl(T, input_backprop_accessor_) +
+          input_backprop_offset_;
       T* output_backprop =
-          ConvertToActualTypeSycl(T, output_backprop_accessor_);
+          ConvertToActualTypeSycl(T, output_backprop_accessor_) +
+          output_backprop_offset_;
 
       T output_value = static_cast<T>(0);
       const helpers::TensorIndex4D tensor_idx =
@@ -278,9 +305,13 @@ class MaxPoolGradSYCL {
   const SYCL2DPoolParams p_;
 
   const read_accessor input_data_accessor_;
+  const int input_data_offset_;
   const read_accessor output_data_accessor_;
+  const int output_data_offset_;
   const read_accessor input_backprop_accessor_;
+  const int input_backprop_offset_;
   write_accessor output_backprop_accessor_;
+  const int output_backprop_offset_;
 };
 template <typename T, typename Equal>
 struct LaunchMaxPoolingGradOpSYCL {
@@ -299,12 +330,20 @@ struct LaunchMaxPoolingGradOpSYCL {
 
     auto input_data_buffer =
         device.get_sycl_buffer(tensor_in.template flat<T>().data());
+    const int input_data_offset =
+        device.get_offset(tensor_in.template flat<T>().data()) / sizeof(T);
     auto output_data_buffer =
         device.get_sycl_buffer(tensor_out.template flat<T>().data());
+    const int output_data_offset =
+        device.get_offset(tensor_out.template flat<T>().data()) / sizeof(T);
     auto input_backprop_buffer =
         device.get_sycl_buffer(out_backprop.template flat<T>().data());
+    const int input_backprop_offset =
+        device.get_offset(out_backprop.template flat<T>().data()) / sizeof(T);
     auto output_backprop_buffer =
         device.get_sycl_buffer(output->template flat<T>().data());
+    const int output_backprop_offset =
+        device.get_offset(output->template flat<T>().data()) / sizeof(T);
 
     device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
       auto input_data_access =
@@ -316,8 +355,10 @@ struct LaunchMaxPoolingGradOpSYCL {
       auto output_backprop_access =
           output_backprop_buffer.template get_access<write_mode>(cgh);
       Functor max_pool(output_size, params, input_data_access,
-                       output_data_access, input_backprop_access,
-                       output_backprop_access);
+                       input_data_offset, output_data_access,
+                       output_data_offset, input_backprop_access,
+                       input_backprop_offset, output_backprop_access,
+                       output_backprop_offset);
 
       cgh.parallel_for(cl::sycl::range<1>(n_threads), max_pool);
     });
@@ -337,7 +378,7 @@ template <typename T>
 class MaxPoolGradGradSYCL {
  public:
   static constexpr auto read_mode = cl::sycl::access::mode::read;
-  static constexpr auto write_mode = cl::sycl::access::mode::discard_write;
+  static constexpr auto write_mode = cl::sycl::access::mode::write;
   static constexpr auto global_access = cl::sycl::access::target::global_buffer;
   using read_accessor =
       cl::sycl::accessor<uint8_t, 1, read_mode, global_access>;
@@ -346,23 +387,37 @@ class MaxPoolGradGradSYCL {
 
   MaxPoolGradGradSYCL(const int output_size, const PoolParameters& params,
                       const read_accessor input_data_accessor,
+                      const int input_data_offset,
                       const read_accessor output_data_accessor,
+                      const int output_data_offset,
                       const read_accessor input_backprop_accessor,
-                      write_accessor output_backprop_accessor)
+                      const int input_backprop_offset,
+                      write_accessor output_backprop_accessor,
+                      const int output_backprop_offset)
       : output_size_{output_size},
         p_{params},
         input_data_accessor_{input_data_accessor},
+        input_data_offset_{input_data_offset},
         output_data_accessor_{output_data_accessor},
+        output_data_offset_{output_data_offset},
         input_backprop_accessor_{input_backprop_accessor},
-        output_backprop_accessor_{output_backprop_accessor} {}
+        input_backprop_offset_{input_backprop_offset},
+        output_backprop_accessor_{output_backprop_accessor},
+        output_backprop_offset_{output_backprop_offset} {}
   inline TF_ATTRIBUTE_ALWAYS_INLINE void operator()(cl::sycl::item<1> item) {
     int index = item.get_id(0);
     if (index < output_size_) {
-      T* input_data = ConvertToActualTypeSycl(T, input_data_accessor_);
-      T* output_data = ConvertToActualTypeSycl(T, output_data_accessor_);
-      T* input_backprop = ConvertToActualTypeSycl(T, input_backprop_accessor_);
+      T* input_data =
+          ConvertToActualTypeSycl(T, input_data_accessor_) + input_data_offset_;
+      T* output_data =
+          ConvertToActualTypeSycl(T, output_data_accessor_) +
+          output_data_offset_;
+      T* input_backprop =
+          ConvertToActualTypeSycl(T, input_backprop_accessor_) +
+          input_backprop_offset_;
       T* output_backprop =
-          ConvertToActualTypeSycl(T, output_backprop_accessor_);
+          ConvertToActualTypeSycl(T, output_backprop_accessor_) +
+          output_backprop_offset_;
 
       const helpers::TensorIndex4D tensor_idx =
           helpers::unflatten4d<int, false>(index, p_.out_rows_, p_.out_rows_,
@@ -405,9 +460,13 @@ class MaxPoolGradGradSYCL {
   const SYCL2DPoolParams p_;
 
   const read_accessor input_data_accessor_;
+  const int input_data_offset_;
   const read_accessor output_data_accessor_;
+  const int output_data_offset_;
   const read_accessor input_backprop_accessor_;
+  const int input_backprop_offset_;
   write_accessor output_backprop_accessor_;
+  const int output_backprop_offset_;
 };
 template <typename T>
 struct LaunchMaxPoolingGradGradOpSYCL {
@@ -426,12 +485,20 @@ struct LaunchMaxPoolingGradGradOpSYCL {
 
     auto input_data_buffer =
         device.get_sycl_buffer(tensor_in.template flat<T>().data());
+    const int input_data_offset =
+        device.get_offset(tensor_in.template flat<T>().data()) / sizeof(T);
     auto output_data_buffer =
         device.get_sycl_buffer(tensor_out.template flat<T>().data());
+    const int output_data_offset =
+        device.get_offset(tensor_out.template flat<T>().data()) / sizeof(T);
     auto input_backprop_buffer =
         device.get_sycl_buffer(out_backprop.template flat<T>().data());
+    const int input_backprop_offset =
+        device.get_offset(out_backprop.template flat<T>().data()) / sizeof(T);
     auto output_backprop_buffer =
         device.get_sycl_buffer(output->template flat<T>().data());
+    const int output_backprop_offset =
+        device.get_offset(output->template flat<T>().data()) / sizeof(T);
 
     device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
       auto input_data_access =
@@ -443,8 +510,10 @@ struct LaunchMaxPoolingGradGradOpSYCL {
       auto output_backprop_access =
           output_backprop_buffer.template get_access<write_mode>(cgh);
       Functor maxpoolgradgrad(output_size, params, input_data_access,
-                              output_data_access, input_backprop_access,
-                              output_backprop_access);
+                              input_data_offset, output_data_access,
+                              output_data_offset, input_backprop_access,
+                              input_backprop_offset, output_backprop_access,
+                              output_backprop_offset);
 
       cgh.parallel_for(cl::sycl::range<1>(n_threads), maxpoolgradgrad);
     });
@@ -37,6 +37,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/util/padding.h"
 #include "tensorflow/core/util/tensor_format.h"
 
@@ -745,6 +746,8 @@ class MklConv2DOp : public OpKernel {
     OP_REQUIRES(
         context, dilation_h > 0 && dilation_w > 0,
         errors::InvalidArgument("Dilated rates should be larger than 0."));
+    OP_REQUIRES_OK(context,
+                   context->GetAttr("is_filter_const", &is_filter_const_));
   }
 
   void Compute(OpKernelContext* context) override {
@@ -840,6 +843,15 @@ class MklConv2DOp : public OpKernel {
         conv2d_fwd = Conv2DFwdFactory<T>::Get(convFwdDims);
       }
 
+      // A constant filter only needs to be reordered once: reuse the
+      // result of the first reorder for the same layout.
+      const bool reorder_filter =
+          filter_md.data.format != conv2d_fwd->filter_fmt_;
+      Tensor cached_filter;
+      const bool use_cached_filter =
+          is_filter_const_ && reorder_filter &&
+          GetCachedFilter(conv2d_fwd->filter_fmt_, &cached_filter);
+
       // allocate output tensors output_tensor and filter_out_tensor
       std::shared_ptr<mkldnn::convolution_forward::primitive_desc>
       conv_fwd_pd = conv2d_fwd->fwd_pd_;
@@ -848,7 +860,9 @@ class MklConv2DOp : public OpKernel {
       Tensor* filter_out_tensor = nullptr;
       AllocateFilterOutputTensor(context, *conv_fwd_pd,
                                  TFShapeToMklDnnDims(filter_tf_shape),
+                                 use_cached_filter ? &cached_filter : nullptr,
                                  &filter_out_tensor);
+      if (!context->status().ok()) return;
 
       T* dst_data = static_cast<T*>(dst_tensor->flat<T>().data());
 
@@ -858,16 +872,21 @@ class MklConv2DOp : public OpKernel {
           src.CheckReorderToOpMem(
               conv_fwd_pd.get()->src_primitive_desc(), &net);
 
-      if (filter_md.data.format != conv2d_fwd->filter_fmt_)
+      if (reorder_filter && !use_cached_filter)
           filter.CheckReorderToOpMem(
               conv_fwd_pd.get()->weights_primitive_desc(),
               filter.GetTensorBuffer(filter_out_tensor), &net);
       stream(stream::kind::eager).submit(net).wait();
+      if (is_filter_const_ && reorder_filter && !use_cached_filter) {
+        CacheFilter(conv2d_fwd->filter_fmt_, *filter_out_tensor);
+      }
 
       T* src_data = static_cast<T*>(
                 src.GetOpMem().get_data_handle());
-      T* filter_data = static_cast<T*>(
-                filter.GetOpMem().get_data_handle());
+      T* filter_data =
+          use_cached_filter
+              ? filter_out_tensor->flat<T>().data()
+              : static_cast<T*>(filter.GetOpMem().get_data_handle());
 
       // execute convolution
       if (biasEnabled) {
@@ -899,6 +918,31 @@ class MklConv2DOp : public OpKernel {
   const int kDilationH = 0, kDilationW = 1;
   engine cpu_engine = engine(engine::cpu, 0);
 
+  // Whether the filter is a constant, so that its reorder can be cached.
+  bool is_filter_const_;
+  mutex mu_;
+  // The filter reordered to cached_filter_fmt_, if that is not format_undef.
+  // Holding a reference to it keeps the ops consuming the filter output from
+  // forwarding and overwriting it.
+  Tensor cached_filter_ GUARDED_BY(mu_);
+  memory::format cached_filter_fmt_ GUARDED_BY(mu_) =
+      memory::format::format_undef;
+
+  // Returns whether the filter reordered to "fmt" is cached, and if so sets
+  // "filter" to it.
+  bool GetCachedFilter(memory::format fmt, Tensor* filter) {
+    mutex_lock l(mu_);
+    if (cached_filter_fmt_ != fmt) return false;
+    *filter = cached_filter_;
+    return true;
+  }
+
+  void CacheFilter(memory::format fmt, const Tensor& filter) {
+    mutex_lock l(mu_);
+    cached_filter_ = filter;
+    cached_filter_fmt_ = fmt;
+  }
+
   // Allocate output tensor.
   void AllocateOutputTensor(
       OpKernelContext* context,
@@ -924,11 +968,13 @@ class MklConv2DOp : public OpKernel {
                               output_tf_shape, output_mkl_shape);
   }
 
-  // Allocate output tensor.
+  // Allocate the filter output tensor, or output "cached_filter" instead of
+  // allocating it if it is not null.
   void AllocateFilterOutputTensor(
       OpKernelContext* context,
       const convolution_forward::primitive_desc& conv_prim_desc,
-      const memory::dims& filter_dims_tf_order, Tensor** filter_tensor) {
+      const memory::dims& filter_dims_tf_order, const Tensor* cached_filter,
+      Tensor** filter_tensor) {
     CHECK_NOTNULL(filter_tensor);
     auto filter_pd = conv_prim_desc.weights_primitive_desc();
 
@@ -944,6 +990,16 @@ class MklConv2DOp : public OpKernel {
     filter_mkl_shape.SetTfLayout(filter_dims_tf_order.size(),
                                  filter_dims_tf_order, memory::format::blocked);
 
+    if (cached_filter != nullptr) {
+      const int index =
+          GetTensorDataIndex(kOutputIndex_Filter, context->num_outputs());
+      context->set_output(index, *cached_filter);
+      *filter_tensor = context->mutable_output(index);
+      AllocateOutputSetMklShape(context, kOutputIndex_Filter,
+                                filter_mkl_shape);
+      return;
+    }
+
     // Allocate the data space for the filter to propagate as TF tensor.
     TensorShape filter_tf_shape;
     filter_tf_shape.AddDim((filter_pd.get_size() / sizeof(T)));
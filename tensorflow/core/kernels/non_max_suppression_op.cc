@@ -37,6 +37,9 @@ namespace tensorflow {
 namespace {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
+#ifdef TENSORFLOW_USE_SYCL
+typedef Eigen::SyclDevice SYCLDevice;
+#endif  // TENSORFLOW_USE_SYCL
 
 static inline void ParseAndCheckBoxSizes(OpKernelContext* context,
                                          const Tensor& boxes,
@@ -259,4 +262,36 @@ REGISTER_KERNEL_BUILDER(Name("NonMaxSuppressionV2").Device(DEVICE_CPU),
 REGISTER_KERNEL_BUILDER(Name("NonMaxSuppressionV3").Device(DEVICE_CPU),
                         NonMaxSuppressionV3Op<CPUDevice>);
 
+#ifdef TENSORFLOW_USE_SYCL
+// The greedy selection is sequential, so the SYCL kernels run it on host
+// copies of the boxes. Registering them still keeps the surrounding graph on
+// the device instead of splitting it around the op.
+REGISTER_KERNEL_BUILDER(Name("NonMaxSuppression")
+                            .Device(DEVICE_SYCL)
+                            .HostMemory("boxes")
+                            .HostMemory("scores")
+                            .HostMemory("max_output_size")
+                            .HostMemory("selected_indices"),
+                        NonMaxSuppressionOp<SYCLDevice>);
+
+REGISTER_KERNEL_BUILDER(Name("NonMaxSuppressionV2")
+                            .Device(DEVICE_SYCL)
+                            .HostMemory("boxes")
+                            .HostMemory("scores")
+                            .HostMemory("max_output_size")
+                            .HostMemory("iou_threshold")
+                            .HostMemory("selected_indices"),
+                        NonMaxSuppressionV2Op<SYCLDevice>);
+
+REGISTER_KERNEL_BUILDER(Name("NonMaxSuppressionV3")
+                            .Device(DEVICE_SYCL)
+                            .HostMemory("boxes")
+                            .HostMemory("scores")
+                            .HostMemory("max_output_size")
+                            .HostMemory("iou_threshold")
+                            .HostMemory("score_threshold")
+                            .HostMemory("selected_indices"),
+                        NonMaxSuppressionV3Op<SYCLDevice>);
+#endif  // TENSORFLOW_USE_SYCL
+
 }  // namespace tensorflow
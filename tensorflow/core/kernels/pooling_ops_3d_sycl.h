@@ -20,7 +20,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_POOLING_OP_3D_SYCL_H_
 #define TENSORFLOW_CORE_KERNELS_POOLING_OP_3D_SYCL_H_
 
+#include "tensorflow/core/common_runtime/sycl/sycl_kernel_tuner.h"
 #include "tensorflow/core/kernels/pooling_ops_3d.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 
 namespace tensorflow {
 
@@ -104,8 +106,15 @@ struct SYCL3DPoolParams {
   const int pad_planes_;
   const int pad_rows_;
   const int pad_cols_;
+
+  int num_input_elements() const {
+    return batch_ * in_planes_ * in_rows_ * in_cols_ * depth_;
+  }
+  int num_output_elements() const {
+    return batch_ * out_planes_ * out_rows_ * out_cols_ * depth_;
+  }
 };
-// MaxPool3d SYCL kernel. Expects the number of threads to be equal to the
+// MaxPool3d SYCL kernel. Expects the number of threads to be at least the
 // number of elements in the output tensor.
 //
 // For each output element, find the corresponding input window and run over
@@ -128,16 +137,24 @@ class MaxPool3DSYCL {
                 const std::array<int64, 3>& stride,
                 const std::array<int64, 3>& padding,
                 const read_accessor input_accessor,
-                write_accessor output_accessor)
+                const int input_offset,
+                write_accessor output_accessor,
+                const int output_offset)
       : p_(depth, batch, in_planes, in_rows, in_cols, out_planes, out_rows,
            out_cols, window, stride, padding),
         input_accessor_(input_accessor),
-        output_accessor_(output_accessor) {}
-  void operator()(cl::sycl::item<1> item) {
-    T* input_data = ConvertToActualTypeSycl(T, input_accessor_);
-    T* output_data = ConvertToActualTypeSycl(T, output_accessor_);
-
-    int index = item.get_linear_id();
+        input_offset_(input_offset),
+        output_accessor_(output_accessor),
+        output_offset_(output_offset) {}
+  void operator()(cl::sycl::nd_item<1> item) {
+    T* input_data = ConvertToActualTypeSycl(T, input_accessor_) + input_offset_;
+    T* output_data =
+        ConvertToActualTypeSycl(T, output_accessor_) + output_offset_;
+
+    int index = item.get_global_id(0);
+    if (index >= p_.num_output_elements()) {
+      return;
+    }
     int n = index;
     int d = n % p_.depth_;
     n /= p_.depth_;
@@ -172,7 +189,9 @@ class MaxPool3DSYCL {
  private:
   const SYCL3DPoolParams p_;
   const read_accessor input_accessor_;
+  const int input_offset_;
   write_accessor output_accessor_;
+  const int output_offset_;
 };
 template <typename T>
 struct LaunchPoolingOp<SYCLDevice, T, MAX> {
@@ -196,23 +215,38 @@ struct LaunchPoolingOp<SYCLDevice, T, MAX> {
 
     auto input_buffer =
         device.get_sycl_buffer(tensor_in.template flat<T>().data());
+    const int input_offset =
+        device.get_offset(tensor_in.template flat<T>().data()) / sizeof(T);
     auto output_buffer =
         device.get_sycl_buffer(output->template flat<T>().data());
-
-    device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
-      auto input_access =
-          input_buffer.template get_access<cl::sycl::access::mode::read>(cgh);
-      auto output_access =
-          output_buffer.template get_access<cl::sycl::access::mode::write>(cgh);
-      MaxPool3DSYCL<T> max_pool(depth, batch, in_planes, in_rows, in_cols,
-                                out_planes, out_rows, out_cols, window, stride,
-                                padding, input_access, output_access);
-
-      cgh.parallel_for(cl::sycl::range<1>(num_threads), max_pool);
-    });
+    const int output_offset =
+        device.get_offset(output->template flat<T>().data()) / sizeof(T);
+
+    static const string kernel_name = strings::StrCat(
+        "MaxPool3D/", DataTypeString(DataTypeToEnum<T>::v()));
+    SYCLKernelTuner::Global()->LaunchWithWorkGroupSize(
+        device, kernel_name, num_threads, [&](size_t workgroup_size) {
+          device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+            auto input_access =
+                input_buffer.template get_access<cl::sycl::access::mode::read>(
+                    cgh);
+            auto output_access =
+                output_buffer
+                    .template get_access<cl::sycl::access::mode::write>(cgh);
+            MaxPool3DSYCL<T> max_pool(depth, batch, in_planes, in_rows, in_cols,
+                                      out_planes, out_rows, out_cols, window,
+                                      stride, padding, input_access,
+                                      input_offset, output_access,
+                                      output_offset);
+
+            cgh.parallel_for(
+                SYCLUtil::get_nd_range(device, num_threads, workgroup_size),
+                max_pool);
+          });
+        });
   }
 };
-// MaxPool3DGrad SYCL kernel. Expects the number of threads to be equal to the
+// MaxPool3DGrad SYCL kernel. Expects the number of threads to be at least the
 // number of elements in the output backprop tensor (i.e. the number of elements
 // in the input data tensor).
 //
@@ -239,22 +273,39 @@ class MaxPool3DGradSYCL {
                     const std::array<int64, 3>& stride,
                     const std::array<int64, 3>& padding,
                     const read_accessor input_data_accessor,
+                    const int input_data_offset,
                     const read_accessor output_data_accessor,
+                    const int output_data_offset,
                     const read_accessor input_backprop_accessor,
-                    write_accessor output_backprop_accessor)
+                    const int input_backprop_offset,
+                    write_accessor output_backprop_accessor,
+                    const int output_backprop_offset)
       : p_(depth, batch, in_planes, in_rows, in_cols, output_shape, window,
            stride, padding),
         input_data_accessor_(input_data_accessor),
+        input_data_offset_(input_data_offset),
         output_data_accessor_(output_data_accessor),
+        output_data_offset_(output_data_offset),
         input_backprop_accessor_(input_backprop_accessor),
-        output_backprop_accessor_(output_backprop_accessor) {}
-  void operator()(cl::sycl::item<1> item) {
-    T* input_data = ConvertToActualTypeSycl(T, input_data_accessor_);
-    T* output_data = ConvertToActualTypeSycl(T, output_data_accessor_);
-    T* input_backprop = ConvertToActualTypeSycl(T, input_backprop_accessor_);
-    T* output_backprop = ConvertToActualTypeSycl(T, output_backprop_accessor_);
-
-    const int index = item.get_linear_id();
+        input_backprop_offset_(input_backprop_offset),
+        output_backprop_accessor_(output_backprop_accessor),
+        output_backprop_offset_(output_backprop_offset) {}
+  void operator()(cl::sycl::nd_item<1> item) {
+    T* input_data =
+        ConvertToActualTypeSycl(T, input_data_accessor_) + input_data_offset_;
+    T* output_data =
+        ConvertToActualTypeSycl(T, output_data_accessor_) + output_data_offset_;
+    T* input_backprop =
+        ConvertToActualTypeSycl(T, input_backprop_accessor_) +
+        input_backprop_offset_;
+    T* output_backprop =
+        ConvertToActualTypeSycl(T, output_backprop_accessor_) +
+        output_backprop_offset_;
+
+    const int index = item.get_global_id(0);
+    if (index >= p_.num_input_elements()) {
+      return;
+    }
     T output_value = 0;
     int n = index;
     const int d = n % p_.depth_;
@@ -338,9 +389,13 @@ class MaxPool3DGradSYCL {
   const SYCL3DPoolParams p_;
 
   const read_accessor input_data_accessor_;
+  const int input_data_offset_;
   const read_accessor output_data_accessor_;
+  const int output_data_offset_;
   const read_accessor input_backprop_accessor_;
+  const int input_backprop_offset_;
   write_accessor output_backprop_accessor_;
+  const int output_backprop_offset_;
 };
 template <typename T>
 struct LaunchMaxPooling3dGradOp<SYCLDevice, T> {
@@ -362,36 +417,53 @@ struct LaunchMaxPooling3dGradOp<SYCLDevice, T> {
 
     auto input_data_buffer =
         device.get_sycl_buffer(tensor_in.template flat<T>().data());
+    const int input_data_offset =
+        device.get_offset(tensor_in.template flat<T>().data()) / sizeof(T);
     auto output_data_buffer =
         device.get_sycl_buffer(tensor_out.template flat<T>().data());
+    const int output_data_offset =
+        device.get_offset(tensor_out.template flat<T>().data()) / sizeof(T);
     auto input_backprop_buffer =
         device.get_sycl_buffer(out_backprop.template flat<T>().data());
+    const int input_backprop_offset =
+        device.get_offset(out_backprop.template flat<T>().data()) / sizeof(T);
     auto output_backprop_buffer =
         device.get_sycl_buffer(output->template flat<T>().data());
-
-    device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
-      auto input_data_access =
-          input_data_buffer.template get_access<cl::sycl::access::mode::read>(
-              cgh);
-      auto output_data_access =
-          output_data_buffer.template get_access<cl::sycl::access::mode::read>(
-              cgh);
-      auto input_backprop_access =
-          input_backprop_buffer
-              .template get_access<cl::sycl::access::mode::read>(cgh);
-      auto output_backprop_access =
-          output_backprop_buffer
-              .template get_access<cl::sycl::access::mode::write>(cgh);
-      MaxPool3DGradSYCL<T> max_pool(
-          depth, batch, in_planes, in_rows, in_cols, out, window, stride,
-          padding, input_data_access, output_data_access, input_backprop_access,
-          output_backprop_access);
-
-      cgh.parallel_for(cl::sycl::range<1>(output_size), max_pool);
-    });
+    const int output_backprop_offset =
+        device.get_offset(output->template flat<T>().data()) / sizeof(T);
+
+    static const string kernel_name = strings::StrCat(
+        "MaxPool3DGrad/", DataTypeString(DataTypeToEnum<T>::v()));
+    SYCLKernelTuner::Global()->LaunchWithWorkGroupSize(
+        device, kernel_name, output_size, [&](size_t workgroup_size) {
+          device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+            auto input_data_access =
+                input_data_buffer
+                    .template get_access<cl::sycl::access::mode::read>(cgh);
+            auto output_data_access =
+                output_data_buffer
+                    .template get_access<cl::sycl::access::mode::read>(cgh);
+            auto input_backprop_access =
+                input_backprop_buffer
+                    .template get_access<cl::sycl::access::mode::read>(cgh);
+            auto output_backprop_access =
+                output_backprop_buffer
+                    .template get_access<cl::sycl::access::mode::write>(cgh);
+            MaxPool3DGradSYCL<T> max_pool(
+                depth, batch, in_planes, in_rows, in_cols, out, window, stride,
+                padding, input_data_access, input_data_offset,
+                output_data_access, output_data_offset, input_backprop_access,
+                input_backprop_offset, output_backprop_access,
+                output_backprop_offset);
+
+            cgh.parallel_for(
+                SYCLUtil::get_nd_range(device, output_size, workgroup_size),
+                max_pool);
+          });
+        });
   }
 };
-// MaxPool3DGradGrad SYCL kernel. Expects the number of threads to be equal to
+// MaxPool3DGradGrad SYCL kernel. Expects the number of threads to be at least
 // the number of elements in the output backprop tensor, i.e. the number of
 // elements in the output tensor.
 //
@@ -411,21 +483,38 @@ class MaxPool3DGradGradSYCL {
  public:
   MaxPool3DGradGradSYCL(const Pool3dParameters& params,
                         const read_accessor input_data_accessor,
+                        const int input_data_offset,
                         const read_accessor output_data_accessor,
+                        const int output_data_offset,
                         const read_accessor input_backprop_accessor,
-                        write_accessor output_backprop_accessor)
+                        const int input_backprop_offset,
+                        write_accessor output_backprop_accessor,
+                        const int output_backprop_offset)
       : p_(params),
         input_data_accessor_(input_data_accessor),
+        input_data_offset_(input_data_offset),
         output_data_accessor_(output_data_accessor),
+        output_data_offset_(output_data_offset),
         input_backprop_accessor_(input_backprop_accessor),
-        output_backprop_accessor_(output_backprop_accessor) {}
-  void operator()(cl::sycl::item<1> item) {
-    T* input_data = ConvertToActualTypeSycl(T, input_data_accessor_);
-    T* output_data = ConvertToActualTypeSycl(T, output_data_accessor_);
-    T* input_backprop = ConvertToActualTypeSycl(T, input_backprop_accessor_);
-    T* output_backprop = ConvertToActualTypeSycl(T, output_backprop_accessor_);
-
-    int index = item.get_linear_id();
+        input_backprop_offset_(input_backprop_offset),
+        output_backprop_accessor_(output_backprop_accessor),
+        output_backprop_offset_(output_backprop_offset) {}
+  void operator()(cl::sycl::nd_item<1> item) {
+    T* input_data =
+        ConvertToActualTypeSycl(T, input_data_accessor_) + input_data_offset_;
+    T* output_data =
+        ConvertToActualTypeSycl(T, output_data_accessor_) + output_data_offset_;
+    T* input_backprop =
+        ConvertToActualTypeSycl(T, input_backprop_accessor_) +
+        input_backprop_offset_;
+    T* output_backprop =
+        ConvertToActualTypeSycl(T, output_backprop_accessor_) +
+        output_backprop_offset_;
+
+    int index = item.get_global_id(0);
+    if (index >= p_.num_output_elements()) {
+      return;
+    }
     int n = index;
     int d = n % p_.depth_;
     n /= p_.depth_;
@@ -467,9 +556,13 @@ class MaxPool3DGradGradSYCL {
   const SYCL3DPoolParams p_;
 
   const read_accessor input_data_accessor_;
+  const int input_data_offset_;
   const read_accessor output_data_accessor_;
+  const int output_data_offset_;
   const read_accessor input_backprop_accessor_;
+  const int input_backprop_offset_;
   write_accessor output_backprop_accessor_;
+  const int output_backprop_offset_;
 };
 template <typename T>
 struct LaunchMaxPooling3dGradGradOp<SYCLDevice, T> {
@@ -482,35 +575,52 @@ struct LaunchMaxPooling3dGradGradOp<SYCLDevice, T> {
 
     auto input_data_buffer =
         device.get_sycl_buffer(tensor_in.template flat<T>().data());
+    const int input_data_offset =
+        device.get_offset(tensor_in.template flat<T>().data()) / sizeof(T);
     auto output_data_buffer =
         device.get_sycl_buffer(tensor_out.template flat<T>().data());
+    const int output_data_offset =
+        device.get_offset(tensor_out.template flat<T>().data()) / sizeof(T);
     auto input_backprop_buffer =
         device.get_sycl_buffer(out_backprop.template flat<T>().data());
+    const int input_backprop_offset =
+        device.get_offset(out_backprop.template flat<T>().data()) / sizeof(T);
     auto output_backprop_buffer =
         device.get_sycl_buffer(output->template flat<T>().data());
-
-    device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
-      auto input_data_access =
-          input_data_buffer.template get_access<cl::sycl::access::mode::read>(
-              cgh);
-      auto output_data_access =
-          output_data_buffer.template get_access<cl::sycl::access::mode::read>(
-              cgh);
-      auto input_backprop_access =
-          input_backprop_buffer
-              .template get_access<cl::sycl::access::mode::read>(cgh);
-      auto output_backprop_access =
-          output_backprop_buffer
-              .template get_access<cl::sycl::access::mode::write>(cgh);
-      MaxPool3DGradGradSYCL<T> functor(
-          params, input_data_access, output_data_access, input_backprop_access,
-          output_backprop_access);
-
-      cgh.parallel_for(cl::sycl::range<1>(num_threads), functor);
-    });
+    const int output_backprop_offset =
+        device.get_offset(output->template flat<T>().data()) / sizeof(T);
+
+    static const string kernel_name = strings::StrCat(
+        "MaxPool3DGradGrad/", DataTypeString(DataTypeToEnum<T>::v()));
+    SYCLKernelTuner::Global()->LaunchWithWorkGroupSize(
+        device, kernel_name, num_threads, [&](size_t workgroup_size) {
+          device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+            auto input_data_access =
+                input_data_buffer
+                    .template get_access<cl::sycl::access::mode::read>(cgh);
+            auto output_data_access =
+                output_data_buffer
+                    .template get_access<cl::sycl::access::mode::read>(cgh);
+            auto input_backprop_access =
+                input_backprop_buffer
+                    .template get_access<cl::sycl::access::mode::read>(cgh);
+            auto output_backprop_access =
+                output_backprop_buffer
+                    .template get_access<cl::sycl::access::mode::write>(cgh);
+            MaxPool3DGradGradSYCL<T> functor(
+                params, input_data_access, input_data_offset,
+                output_data_access, output_data_offset, input_backprop_access,
+                input_backprop_offset, output_backprop_access,
+                output_backprop_offset);
+
+            cgh.parallel_for(
+                SYCLUtil::get_nd_range(device, num_threads, workgroup_size),
+                functor);
+          });
+        });
   }
 };
-// AvgPool3D SYCL kernel. Expects the number of threads to be equal to the
+// AvgPool3D SYCL kernel. Expects the number of threads to be at least the
 // number of elements in the output tensor.
 //
 // For each output value find the corresponding input window, and run through
@@ -534,16 +644,24 @@ class AvgPool3DSYCL {
                 const std::array<int64, 3>& stride,
                 const std::array<int64, 3>& padding,
                 const read_accessor input_accessor,
-                write_accessor output_accessor)
+                const int input_offset,
+                write_accessor output_accessor,
+                const int output_offset)
       : p_(depth, batch, in_planes, in_rows, in_cols, out_planes, out_rows,
            out_cols, window, stride, padding),
         input_accessor_(input_accessor),
-        output_accessor_(output_accessor) {}
-  void operator()(cl::sycl::item<1> item) {
-    T* input_data = ConvertToActualTypeSycl(T, input_accessor_);
-    T* output_data = ConvertToActualTypeSycl(T, output_accessor_);
-
-    int index = item.get_linear_id();
+        input_offset_(input_offset),
+        output_accessor_(output_accessor),
+        output_offset_(output_offset) {}
+  void operator()(cl::sycl::nd_item<1> item) {
+    T* input_data = ConvertToActualTypeSycl(T, input_accessor_) + input_offset_;
+    T* output_data =
+        ConvertToActualTypeSycl(T, output_accessor_) + output_offset_;
+
+    int index = item.get_global_id(0);
+    if (index >= p_.num_output_elements()) {
+      return;
+    }
     int n = index;
     int d = n % p_.depth_;
     n /= p_.depth_;
@@ -578,7 +696,9 @@ class AvgPool3DSYCL {
  private:
   const SYCL3DPoolParams p_;
   const read_accessor input_accessor_;
+  const int input_offset_;
   write_accessor output_accessor_;
+  const int output_offset_;
 };
 template <typename T>
 struct LaunchPoolingOp<SYCLDevice, T, AVG> {
@@ -602,23 +722,38 @@ struct LaunchPoolingOp<SYCLDevice, T, AVG> {
 
     auto input_buffer =
         device.get_sycl_buffer(tensor_in.template flat<T>().data());
+    const int input_offset =
+        device.get_offset(tensor_in.template flat<T>().data()) / sizeof(T);
     auto output_buffer =
         device.get_sycl_buffer(output->template flat<T>().data());
-
-    device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
-      auto input_access =
-          input_buffer.template get_access<cl::sycl::access::mode::read>(cgh);
-      auto output_access =
-          output_buffer.template get_access<cl::sycl::access::mode::write>(cgh);
-      AvgPool3DSYCL<T> avg_pool(depth, batch, in_planes, in_rows, in_cols,
-                                out_planes, out_rows, out_cols, window, stride,
-                                padding, input_access, output_access);
-
-      cgh.parallel_for(cl::sycl::range<1>(num_threads), avg_pool);
-    });
+    const int output_offset =
+        device.get_offset(output->template flat<T>().data()) / sizeof(T);
+
+    static const string kernel_name = strings::StrCat(
+        "AvgPool3D/", DataTypeString(DataTypeToEnum<T>::v()));
+    SYCLKernelTuner::Global()->LaunchWithWorkGroupSize(
+        device, kernel_name, num_threads, [&](size_t workgroup_size) {
+          device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+            auto input_access =
+                input_buffer.template get_access<cl::sycl::access::mode::read>(
+                    cgh);
+            auto output_access =
+                output_buffer
+                    .template get_access<cl::sycl::access::mode::write>(cgh);
+            AvgPool3DSYCL<T> avg_pool(depth, batch, in_planes, in_rows, in_cols,
+                                      out_planes, out_rows, out_cols, window,
+                                      stride, padding, input_access,
+                                      input_offset, output_access,
+                                      output_offset);
+
+            cgh.parallel_for(
+                SYCLUtil::get_nd_range(device, num_threads, workgroup_size),
+                avg_pool);
+          });
+        });
   }
 };
-// AvgPool3DGrad SYCL kernel. Expects the number of threads to be equal to the
+// AvgPool3DGrad SYCL kernel. Expects the number of threads to be at least the
 // number of elements in the output backprop tensor, i.e. the number of
 // elements in the input tensor.
 //
@@ -645,16 +780,27 @@ class AvgPool3DGradSYCL {
                     const std::array<int64, 3>& stride,
                     const std::array<int64, 3>& padding,
                     const read_accessor input_backprop_accessor,
-                    write_accessor output_backprop_accessor)
+                    const int input_backprop_offset,
+                    write_accessor output_backprop_accessor,
+                    const int output_backprop_offset)
       : p_(depth, batch, in_planes, in_rows, in_cols, out_shape, window, stride,
            padding),
         input_backprop_accessor_(input_backprop_accessor),
-        output_backprop_accessor_(output_backprop_accessor) {}
-  void operator()(cl::sycl::item<1> item) {
-    T* input_backprop = ConvertToActualTypeSycl(T, input_backprop_accessor_);
-    T* output_backprop = ConvertToActualTypeSycl(T, output_backprop_accessor_);
-
-    const int index = item.get_linear_id();
+        input_backprop_offset_(input_backprop_offset),
+        output_backprop_accessor_(output_backprop_accessor),
+        output_backprop_offset_(output_backprop_offset) {}
+  void operator()(cl::sycl::nd_item<1> item) {
+    T* input_backprop =
+        ConvertToActualTypeSycl(T, input_backprop_accessor_) +
+        input_backprop_offset_;
+    T* output_backprop =
+        ConvertToActualTypeSycl(T, output_backprop_accessor_) +
+        output_backprop_offset_;
+
+    const int index = item.get_global_id(0);
+    if (index >= p_.num_input_elements()) {
+      return;
+    }
     int n = index;
     const int d = n % p_.depth_;
     n /= p_.depth_;
@@ -711,7 +857,9 @@ class AvgPool3DGradSYCL {
  private:
   const SYCL3DPoolParams p_;
   const read_accessor input_backprop_accessor_;
+  const int input_backprop_offset_;
   write_accessor output_backprop_accessor_;
+  const int output_backprop_offset_;
 };
 template <typename T>
 struct LaunchAvgPooling3dGradOp<SYCLDevice, T> {
@@ -734,22 +882,34 @@ struct LaunchAvgPooling3dGradOp<SYCLDevice, T> {
 
     auto input_backprop_buffer =
         device.get_sycl_buffer(out_backprop.template flat<T>().data());
+    const int input_backprop_offset =
+        device.get_offset(out_backprop.template flat<T>().data()) / sizeof(T);
     auto output_backprop_buffer =
         device.get_sycl_buffer(output->template flat<T>().data());
-
-    device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
-      auto input_backprop_access =
-          input_backprop_buffer
-              .template get_access<cl::sycl::access::mode::read>(cgh);
-      auto output_backprop_access =
-          output_backprop_buffer
-              .template get_access<cl::sycl::access::mode::write>(cgh);
-      AvgPool3DGradSYCL<T> functor(
-          depth, batch, in_planes, in_rows, in_cols, output_shape, window,
-          stride, padding, input_backprop_access, output_backprop_access);
-
-      cgh.parallel_for(cl::sycl::range<1>(num_threads), functor);
-    });
+    const int output_backprop_offset =
+        device.get_offset(output->template flat<T>().data()) / sizeof(T);
+
+    static const string kernel_name = strings::StrCat(
+        "AvgPool3DGrad/", DataTypeString(DataTypeToEnum<T>::v()));
+    SYCLKernelTuner::Global()->LaunchWithWorkGroupSize(
+        device, kernel_name, num_threads, [&](size_t workgroup_size) {
+          device.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+            auto input_backprop_access =
+                input_backprop_buffer
+                    .template get_access<cl::sycl::access::mode::read>(cgh);
+            auto output_backprop_access =
+                output_backprop_buffer
+                    .template get_access<cl::sycl::access::mode::write>(cgh);
+            AvgPool3DGradSYCL<T> functor(
+                depth, batch, in_planes, in_rows, in_cols, output_shape, window,
+                stride, padding, input_backprop_access, input_backprop_offset,
+                output_backprop_access, output_backprop_offset);
+
+            cgh.parallel_for(
+                SYCLUtil::get_nd_range(device, num_threads, workgroup_size),
+                functor);
+          });
+        });
   }
 };
 
@@ -26,6 +26,10 @@ limitations under the License.
 #include "tensorflow/core/kernels/quantization_utils.h"
 #include "tensorflow/core/lib/core/errors.h"
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/kernels/quantized_ops_sycl.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace {
 enum {
   QUANTIZE_MODE_MIN_COMBINED,
@@ -50,6 +54,9 @@ enum {
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
+#ifdef TENSORFLOW_USE_SYCL
+typedef Eigen::SyclDevice SYCLDevice;
+#endif  // TENSORFLOW_USE_SYCL
 
 // Quantize a tensor from float to T, with user-specified min_range and
 // max_range.
@@ -131,6 +138,26 @@ class QuantizeV2Op : public OpKernel {
 
     Tensor* output = nullptr;
     OP_REQUIRES_OK(ctx, ctx->allocate_output(0, input.shape(), &output));
+    QuantizeTensor(ctx->template eigen_device<Device>(), ctx, input,
+                   &min_range, &max_range, output);
+
+    Tensor* output_min_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(1, {}, &output_min_tensor));
+    output_min_tensor->flat<float>()(0) = min_range;
+
+    Tensor* output_max_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(2, {}, &output_max_tensor));
+    output_max_tensor->flat<float>()(0) = max_range;
+  }
+
+ private:
+  // Quantizes input into output in mode_, adjusting the range to the one
+  // represented by the output.
+  void QuantizeTensor(const CPUDevice& d, OpKernelContext* ctx,
+                      const Tensor& input, float* output_min_range,
+                      float* output_max_range, Tensor* output) {
+    float min_range = *output_min_range;
+    float max_range = *output_max_range;
     typename TTypes<T>::Vec o = output->template flat<T>();
     if (mode_ == QUANTIZE_MODE_MIN_COMBINED) {
       const float scale_factor =
@@ -152,7 +179,7 @@ class QuantizeV2Op : public OpKernel {
       if (is_signed) {
         // The slow path.
         // TODO(xbing,yonghui): Speedup this path as well.
-        o.device(ctx->template eigen_device<Device>()) =
+        o.device(d) =
             ((input.flat<float>().cwiseMin(max_range).cwiseMax(min_range) -
               min_range) *
                  scale_factor -
@@ -175,9 +202,8 @@ class QuantizeV2Op : public OpKernel {
         meta::Quantize(ctx, input_array.data(), input_array.size(), min_range,
                        max_range, output->flat<quint8>().data());
       } else {
-        FloatTensorToQuantizedInPlaceUsingEigen<T>(
-            ctx->template eigen_device<Device>(), input, min_range, max_range,
-            output);
+        FloatTensorToQuantizedInPlaceUsingEigen<T>(d, input, min_range,
+                                                   max_range, output);
       }
     } else if (mode_ == QUANTIZE_MODE_SCALED) {
       const int min_output_value = std::numeric_limits<T>::min();
@@ -196,31 +222,75 @@ class QuantizeV2Op : public OpKernel {
       max_range = max_output_value / scale_factor;
       if (round_mode_ == ROUND_HALF_TO_EVEN) {
         // scalar_round_op_google implements "round-half-to-even".
-        o.device(ctx->template eigen_device<Device>()) =
+        o.device(d) =
             (input.flat<float>().cwiseMin(max_range).cwiseMax(min_range) *
              scale_factor)
                 .unaryExpr(Eigen::internal::scalar_round_op_google<float>())
                 .template cast<T>();
       } else if (round_mode_ == ROUND_HALF_AWAY_FROM_ZERO) {
         // scalar_round_op implements "round-half-away-from-zero".
-        o.device(ctx->template eigen_device<Device>()) =
+        o.device(d) =
             (input.flat<float>().cwiseMin(max_range).cwiseMax(min_range) *
              scale_factor)
                 .unaryExpr(Eigen::internal::scalar_round_op<float>())
                 .template cast<T>();
       }
     }
+    *output_min_range = min_range;
+    *output_max_range = max_range;
+  }
 
-    Tensor* output_min_tensor = nullptr;
-    OP_REQUIRES_OK(ctx, ctx->allocate_output(1, {}, &output_min_tensor));
-    output_min_tensor->flat<float>()(0) = min_range;
-
-    Tensor* output_max_tensor = nullptr;
-    OP_REQUIRES_OK(ctx, ctx->allocate_output(2, {}, &output_max_tensor));
-    output_max_tensor->flat<float>()(0) = max_range;
+#ifdef TENSORFLOW_USE_SYCL
+  void QuantizeTensor(const SYCLDevice& d, OpKernelContext* ctx,
+                      const Tensor& input, float* output_min_range,
+                      float* output_max_range, Tensor* output) {
+    const float min_range = *output_min_range;
+    const float max_range = *output_max_range;
+    functor::quantized_sycl::QuantizeParams params;
+    if (mode_ == QUANTIZE_MODE_MIN_COMBINED) {
+      params.clamp_input = true;
+      params.input_min = min_range;
+      params.input_max = max_range;
+      params.input_shift = min_range;
+      params.scale = (static_cast<double>(std::numeric_limits<T>::max()) -
+                      static_cast<double>(std::numeric_limits<T>::min())) /
+                     (max_range - min_range);
+      params.pre_round_offset = -half_range_;
+    } else if (mode_ == QUANTIZE_MODE_MIN_FIRST) {
+      FloatToQuantizedStruct<T> f2q(min_range, max_range);
+      params.scale = f2q.range_scale;
+      params.post_round_offset =
+          -(f2q.range_min_scaled - f2q.lowest_quantized());
+    } else if (mode_ == QUANTIZE_MODE_SCALED) {
+      const int min_output_value = std::numeric_limits<T>::min();
+      const int max_output_value = std::numeric_limits<T>::max();
+      const float scale_factor_from_min_side =
+          (min_output_value * min_range > 0)
+              ? min_output_value / min_range
+              : std::numeric_limits<float>::max();
+      const float scale_factor_from_max_side =
+          (max_output_value * max_range > 0)
+              ? max_output_value / max_range
+              : std::numeric_limits<float>::max();
+      const float scale_factor =
+          std::min(scale_factor_from_min_side, scale_factor_from_max_side);
+      *output_min_range = min_output_value / scale_factor;
+      *output_max_range = max_output_value / scale_factor;
+      params.clamp_input = true;
+      params.input_min = *output_min_range;
+      params.input_max = *output_max_range;
+      params.scale = scale_factor;
+      params.round_half_to_even = round_mode_ == ROUND_HALF_TO_EVEN;
+    }
+    // The bounds of T which survive the conversion to float and back.
+    params.lower_bound = FloatToQuantizedStruct<T>::lower_bound_float();
+    params.upper_bound = FloatToQuantizedStruct<T>::upper_bound_float();
+    functor::LaunchSYCLQuantize<T>(d, input.flat<float>().data(),
+                                   output->flat<T>().data(),
+                                   input.NumElements(), params);
   }
+#endif  // TENSORFLOW_USE_SYCL
 
- private:
   float half_range_;
   int mode_;
   int round_mode_;
@@ -241,4 +311,20 @@ REGISTER_KERNEL_BUILDER(
 REGISTER_KERNEL_BUILDER(
     Name("QuantizeV2").Device(DEVICE_CPU).TypeConstraint<qint32>("T"),
     QuantizeV2Op<CPUDevice, qint32>);
+
+#ifdef TENSORFLOW_USE_SYCL
+#define REGISTER_SYCL_KERNEL(T)                           \
+  REGISTER_KERNEL_BUILDER(Name("QuantizeV2")              \
+                              .Device(DEVICE_SYCL)        \
+                              .HostMemory("min_range")    \
+                              .HostMemory("max_range")    \
+                              .HostMemory("output_min")   \
+                              .HostMemory("output_max")   \
+                              .TypeConstraint<T>("T"),    \
+                          QuantizeV2Op<SYCLDevice, T>);
+REGISTER_SYCL_KERNEL(quint8);
+REGISTER_SYCL_KERNEL(qint8);
+REGISTER_SYCL_KERNEL(qint32);
+#undef REGISTER_SYCL_KERNEL
+#endif  // TENSORFLOW_USE_SYCL
 }  // namespace tensorflow
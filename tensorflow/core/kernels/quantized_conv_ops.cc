@@ -32,6 +32,10 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/util/padding.h"
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/kernels/quantized_ops_sycl.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace tensorflow {
 
 // This functor implements the convolution operation in as simple a form as
@@ -594,4 +598,21 @@ REGISTER_KERNEL_BUILDER(
         .TypeConstraint<qint32>("out_type"),
     QuantizedConv2DOp<quint8, quint8, qint32, Im2ColConvFunctor>);
 
+#ifdef TENSORFLOW_USE_SYCL
+REGISTER_KERNEL_BUILDER(
+    Name("QuantizedConv2D")
+        .Device(DEVICE_SYCL)
+        .HostMemory("min_input")
+        .HostMemory("max_input")
+        .HostMemory("min_filter")
+        .HostMemory("max_filter")
+        .HostMemory("min_output")
+        .HostMemory("max_output")
+        .TypeConstraint<quint8>("Tinput")
+        .TypeConstraint<quint8>("Tfilter")
+        .TypeConstraint<qint32>("out_type"),
+    QuantizedConv2DOp<quint8, quint8, qint32,
+                      functor::SYCLQuantizedConvFunctor>);
+#endif  // TENSORFLOW_USE_SYCL
+
 }  // namespace tensorflow
@@ -26,8 +26,17 @@ limitations under the License.
 #include "tensorflow/core/kernels/reference_gemm.h"
 #include "tensorflow/core/lib/core/errors.h"
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/kernels/quantized_ops_sycl.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace tensorflow {
 
+typedef Eigen::ThreadPoolDevice CPUDevice;
+#ifdef TENSORFLOW_USE_SYCL
+typedef Eigen::SyclDevice SYCLDevice;
+#endif  // TENSORFLOW_USE_SYCL
+
 // We have to break this out as a separate function because there are multiple
 // combinations of transpose attributes we need to support, and they have to be
 // compile-time constants to work with the templates used internally.
@@ -63,7 +72,7 @@ void GemmlowpMultiply(OpKernelContext* op_context, const quint8* a_data,
   TF_ANNOTATE_MEMORY_IS_INITIALIZED(c_data_as_int32, m * n * sizeof(int32));
 }
 
-template <class T1, class T2, class Toutput>
+template <class Device, class T1, class T2, class Toutput>
 class QuantizedMatMulOp : public OpKernel {
  public:
   explicit QuantizedMatMulOp(OpKernelConstruction* context)
@@ -120,6 +129,31 @@ class QuantizedMatMulOp : public OpKernel {
     OP_REQUIRES_OK(context, context->allocate_output(0, out_shape, &c));
     CHECK(c);
 
+    Multiply(context->eigen_device<Device>(), context, a, b, offset_a,
+             offset_b, a_dim_remaining, b_dim_remaining, dim_pair[0].first,
+             c);
+
+    float min_c_value;
+    float max_c_value;
+    QuantizationRangeForMultiplication<T1, T2, Toutput>(
+        min_a, max_a, min_b, max_b, &min_c_value, &max_c_value);
+    Tensor* c_min = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(1, {}, &c_min));
+    c_min->flat<float>()(0) = min_c_value;
+
+    Tensor* c_max = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(2, {}, &c_max));
+    c_max->flat<float>()(0) = max_c_value;
+  }
+
+ private:
+  void Multiply(const CPUDevice& d, OpKernelContext* context, const Tensor& a,
+                const Tensor& b, int32 offset_a, int32 offset_b,
+                int a_dim_remaining, int b_dim_remaining, int contract_dim,
+                Tensor* c) {
+    const int32 offset_c = 0;
+    const int32 mult_c = 1;
+    const int32 shift_c = 0;
     const T1* a_data = a.flat<T1>().data();
     const T2* b_data = b.flat<T2>().data();
     Toutput* c_data = c->flat<Toutput>().data();
@@ -127,7 +161,7 @@ class QuantizedMatMulOp : public OpKernel {
     const bool transpose_c = false;
     const size_t m = a.dim_size(a_dim_remaining);
     const size_t n = b.dim_size(b_dim_remaining);
-    const size_t k = a.dim_size(dim_pair[0].first);
+    const size_t k = a.dim_size(contract_dim);
     const size_t lda = a.dim_size(1);
     const size_t ldb = b.dim_size(1);
     const size_t ldc = n;
@@ -172,21 +206,23 @@ class QuantizedMatMulOp : public OpKernel {
           transpose_a_, transpose_b_, transpose_c, m, n, k, a_data, offset_a,
           lda, b_data, offset_b, ldb, c_data, shift_c, offset_c, mult_c, ldc);
     }
+  }
 
-    float min_c_value;
-    float max_c_value;
-    QuantizationRangeForMultiplication<T1, T2, Toutput>(
-        min_a, max_a, min_b, max_b, &min_c_value, &max_c_value);
-    Tensor* c_min = nullptr;
-    OP_REQUIRES_OK(context, context->allocate_output(1, {}, &c_min));
-    c_min->flat<float>()(0) = min_c_value;
-
-    Tensor* c_max = nullptr;
-    OP_REQUIRES_OK(context, context->allocate_output(2, {}, &c_max));
-    c_max->flat<float>()(0) = max_c_value;
+#ifdef TENSORFLOW_USE_SYCL
+  // Only quint8 inputs with a qint32 output are registered on SYCL.
+  void Multiply(const SYCLDevice& d, OpKernelContext* context, const Tensor& a,
+                const Tensor& b, int32 offset_a, int32 offset_b,
+                int a_dim_remaining, int b_dim_remaining, int contract_dim,
+                Tensor* c) {
+    functor::LaunchSYCLQuantizedGemm<T1, T2>(
+        d, transpose_a_, transpose_b_, a.flat<T1>().data(),
+        b.flat<T2>().data(), c->flat<qint32>().data(),
+        a.dim_size(a_dim_remaining), b.dim_size(b_dim_remaining),
+        a.dim_size(contract_dim), offset_a, offset_b, a.dim_size(1),
+        b.dim_size(1));
   }
+#endif  // TENSORFLOW_USE_SYCL
 
- private:
   bool transpose_a_;
   bool transpose_b_;
 };
@@ -196,6 +232,21 @@ REGISTER_KERNEL_BUILDER(Name("QuantizedMatMul")
                             .TypeConstraint<quint8>("T1")
                             .TypeConstraint<quint8>("T2")
                             .TypeConstraint<qint32>("Toutput"),
-                        QuantizedMatMulOp<quint8, quint8, qint32>);
+                        QuantizedMatMulOp<CPUDevice, quint8, quint8, qint32>);
+
+#ifdef TENSORFLOW_USE_SYCL
+REGISTER_KERNEL_BUILDER(Name("QuantizedMatMul")
+                            .Device(DEVICE_SYCL)
+                            .HostMemory("min_a")
+                            .HostMemory("max_a")
+                            .HostMemory("min_b")
+                            .HostMemory("max_b")
+                            .HostMemory("min_out")
+                            .HostMemory("max_out")
+                            .TypeConstraint<quint8>("T1")
+                            .TypeConstraint<quint8>("T2")
+                            .TypeConstraint<qint32>("Toutput"),
+                        QuantizedMatMulOp<SYCLDevice, quint8, quint8, qint32>);
+#endif  // TENSORFLOW_USE_SYCL
 
 }  // namespace tensorflow
@@ -0,0 +1,766 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_USE_SYCL
+#error This file must only be included when building TensorFlow with SYCL support
+#endif
+
+#ifndef TENSORFLOW_CORE_KERNELS_QUANTIZED_OPS_SYCL_H_
+#define TENSORFLOW_CORE_KERNELS_QUANTIZED_OPS_SYCL_H_
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+
+#include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/notification.h"
+#include "tensorflow/core/util/padding.h"
+
+namespace tensorflow {
+
+typedef Eigen::SyclDevice SYCLDevice;
+
+namespace functor {
+namespace quantized_sycl {
+
+using Index = int;
+
+// The integer type holding the value of a quantized type in device memory.
+template <typename T>
+struct Storage;
+template <>
+struct Storage<quint8> {
+  using type = uint8_t;
+};
+template <>
+struct Storage<qint8> {
+  using type = int8_t;
+};
+template <>
+struct Storage<quint16> {
+  using type = uint16_t;
+};
+template <>
+struct Storage<qint16> {
+  using type = int16_t;
+};
+template <>
+struct Storage<qint32> {
+  using type = int32_t;
+};
+
+using read_accessor =
+    cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read,
+                       cl::sycl::access::target::global_buffer>;
+using write_accessor =
+    cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::write,
+                       cl::sycl::access::target::global_buffer>;
+
+template <typename T>
+using local_accessor =
+    cl::sycl::accessor<T, 1, cl::sycl::access::mode::read_write,
+                       cl::sycl::access::target::local>;
+
+// Every quantization mode of QuantizeV2 is an affine map of the, optionally
+// clamped, input followed by a rounding:
+//   q = round((clamp(x) - input_shift) * scale + pre_round_offset)
+//       + post_round_offset
+// saturated to [lower_bound, upper_bound]. The op computes the parameters on
+// the host so that the results match its CPU kernel.
+struct QuantizeParams {
+  bool clamp_input = false;
+  float input_min = 0.0f;
+  float input_max = 0.0f;
+  float input_shift = 0.0f;
+  float scale = 1.0f;
+  float pre_round_offset = 0.0f;
+  bool round_half_to_even = false;
+  float post_round_offset = 0.0f;
+  float lower_bound = 0.0f;
+  float upper_bound = 0.0f;
+};
+
+template <typename Q>
+class QuantizeSYCL {
+ public:
+  QuantizeSYCL(read_accessor in, Index in_offset, write_accessor out,
+               Index out_offset, Index n, const QuantizeParams& params)
+      : in_accessor_(in),
+        in_offset_(in_offset),
+        out_accessor_(out),
+        out_offset_(out_offset),
+        n_(n),
+        params_(params) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const Index id = item.get_global_linear_id();
+    if (id >= n_) {
+      return;
+    }
+    const float* in = ConvertToActualTypeSycl(float, in_accessor_) + in_offset_;
+    Q* out = ConvertToActualTypeSycl(Q, out_accessor_) + out_offset_;
+
+    float value = in[id];
+    if (params_.clamp_input) {
+      value = cl::sycl::fmax(cl::sycl::fmin(value, params_.input_max),
+                             params_.input_min);
+    }
+    value = (value - params_.input_shift) * params_.scale +
+            params_.pre_round_offset;
+    // rint rounds half to even in the default rounding mode, round rounds half
+    // away from zero like std::round.
+    value = params_.round_half_to_even ? cl::sycl::rint(value)
+                                       : cl::sycl::round(value);
+    value = cl::sycl::fmin(
+        cl::sycl::fmax(value + params_.post_round_offset, params_.lower_bound),
+        params_.upper_bound);
+    out[id] = static_cast<Q>(static_cast<int32_t>(value));
+  }
+
+ private:
+  const read_accessor in_accessor_;
+  const Index in_offset_;
+  write_accessor out_accessor_;
+  const Index out_offset_;
+  const Index n_;
+  const QuantizeParams params_;
+};
+
+// Dequantize in every mode computes (q + pre_offset) * scale + post_offset.
+template <typename Q>
+class DequantizeSYCL {
+ public:
+  DequantizeSYCL(read_accessor in, Index in_offset, write_accessor out,
+                 Index out_offset, Index n, float pre_offset, float scale,
+                 float post_offset)
+      : in_accessor_(in),
+        in_offset_(in_offset),
+        out_accessor_(out),
+        out_offset_(out_offset),
+        n_(n),
+        pre_offset_(pre_offset),
+        scale_(scale),
+        post_offset_(post_offset) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const Index id = item.get_global_linear_id();
+    if (id >= n_) {
+      return;
+    }
+    const Q* in = ConvertToActualTypeSycl(Q, in_accessor_) + in_offset_;
+    float* out = ConvertToActualTypeSycl(float, out_accessor_) + out_offset_;
+    out[id] =
+        (static_cast<float>(in[id]) + pre_offset_) * scale_ + post_offset_;
+  }
+
+ private:
+  const read_accessor in_accessor_;
+  const Index in_offset_;
+  write_accessor out_accessor_;
+  const Index out_offset_;
+  const Index n_;
+  const float pre_offset_;
+  const float scale_;
+  const float post_offset_;
+};
+
+// The fixed-point constants of RequantizeManyInNewRangeUsingEigen for qint32
+// to quint8, see quantization_utils.h.
+struct RequantizeParams {
+  static constexpr int kFpShift = 16;
+  int64_t range_scale_fp;
+  int64_t offset_fp;
+};
+
+inline RequantizeParams GetRequantizeParams(float min_input, float max_input,
+                                            float min_output,
+                                            float max_output) {
+  const int fp_shift = RequantizeParams::kFpShift;
+  const float input_range = max_input - min_input;
+  const float output_range = max_output - min_output;
+  const float recip_output_range =
+      output_range == 0.0 ? 0.0 : (255.0 / output_range);
+  const float input_rezero = (min_input + max_input) / 2.0;
+  const int64_t range_scale_fp =
+      output_range == 0.0 ? 0.0
+                          : static_cast<int64_t>(255.0 * (1 << fp_shift) *
+                                                 input_range / output_range);
+  const int64_t input_offset_fp = static_cast<int64_t>(
+      input_rezero * recip_output_range * (1 << fp_shift));
+  const int64_t output_offset_fp =
+      output_range == 0.0
+          ? 0
+          : static_cast<int64_t>((1 << fp_shift) * (min_output * 255.0) /
+                                 output_range);
+  const int64_t rounding_delta = 1 << (fp_shift - 1);
+  RequantizeParams params;
+  params.range_scale_fp = range_scale_fp;
+  params.offset_fp = input_offset_fp - output_offset_fp + rounding_delta;
+  return params;
+}
+
+class Requantize32To8SYCL {
+ public:
+  Requantize32To8SYCL(read_accessor in, Index in_offset, write_accessor out,
+                      Index out_offset, Index n, RequantizeParams params)
+      : in_accessor_(in),
+        in_offset_(in_offset),
+        out_accessor_(out),
+        out_offset_(out_offset),
+        n_(n),
+        range_scale_fp_(params.range_scale_fp),
+        offset_fp_(params.offset_fp) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const Index id = item.get_global_linear_id();
+    if (id >= n_) {
+      return;
+    }
+    const int32_t* in =
+        ConvertToActualTypeSycl(int32_t, in_accessor_) + in_offset_;
+    uint8_t* out = ConvertToActualTypeSycl(uint8_t, out_accessor_) + out_offset_;
+    const int64_t fp_value =
+        ((static_cast<int64_t>(in[id]) * range_scale_fp_) >> 32) + offset_fp_;
+    const int64_t value = fp_value >> RequantizeParams::kFpShift;
+    out[id] = static_cast<uint8_t>(
+        value < 0 ? 0 : (value > 255 ? 255 : static_cast<int32_t>(value)));
+  }
+
+ private:
+  const read_accessor in_accessor_;
+  const Index in_offset_;
+  write_accessor out_accessor_;
+  const Index out_offset_;
+  const Index n_;
+  const int64_t range_scale_fp_;
+  const int64_t offset_fp_;
+};
+
+// Computes the minimum and maximum of each work-group's share of the input,
+// written to out[2 * group] and out[2 * group + 1]. The caller reduces the
+// few per group results on the host. The work-group size must be a power of
+// two.
+class RangeSYCL {
+ public:
+  RangeSYCL(read_accessor in, Index in_offset, write_accessor out,
+            Index out_offset, local_accessor<int32_t> min_scratch,
+            local_accessor<int32_t> max_scratch, Index n)
+      : in_accessor_(in),
+        in_offset_(in_offset),
+        out_accessor_(out),
+        out_offset_(out_offset),
+        min_scratch_(min_scratch),
+        max_scratch_(max_scratch),
+        n_(n) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const Index local_id = item.get_local_id(0);
+    const Index local_size = item.get_local_range(0);
+    const int32_t* in =
+        ConvertToActualTypeSycl(int32_t, in_accessor_) + in_offset_;
+
+    int32_t local_min = std::numeric_limits<int32_t>::max();
+    int32_t local_max = std::numeric_limits<int32_t>::lowest();
+    const Index stride = item.get_global_range(0);
+    for (Index i = item.get_global_id(0); i < n_; i += stride) {
+      local_min = cl::sycl::min(local_min, in[i]);
+      local_max = cl::sycl::max(local_max, in[i]);
+    }
+    min_scratch_[local_id] = local_min;
+    max_scratch_[local_id] = local_max;
+    item.barrier(cl::sycl::access::fence_space::local_space);
+    for (Index offset = local_size / 2; offset > 0; offset /= 2) {
+      if (local_id < offset) {
+        min_scratch_[local_id] =
+            cl::sycl::min(min_scratch_[local_id], min_scratch_[local_id + offset]);
+        max_scratch_[local_id] =
+            cl::sycl::max(max_scratch_[local_id], max_scratch_[local_id + offset]);
+      }
+      item.barrier(cl::sycl::access::fence_space::local_space);
+    }
+    if (local_id == 0) {
+      int32_t* out = ConvertToActualTypeSycl(int32_t, out_accessor_) +
+                     out_offset_ + 2 * item.get_group(0);
+      out[0] = min_scratch_[0];
+      out[1] = max_scratch_[0];
+    }
+  }
+
+ private:
+  const read_accessor in_accessor_;
+  const Index in_offset_;
+  write_accessor out_accessor_;
+  const Index out_offset_;
+  local_accessor<int32_t> min_scratch_;
+  local_accessor<int32_t> max_scratch_;
+  const Index n_;
+};
+
+// c = (a - offset_a) * (b - offset_b) with 32-bit accumulation, for row-major
+// a of m x k (k x m if TransA) and b of k x n (n x k if TransB). Each
+// work-group computes a kTile x kTile block of c, staging the matching blocks
+// of a and b, with their offsets already removed, in local memory.
+template <typename T1, typename T2, bool TransA, bool TransB, int kTile>
+class QuantizedGemmSYCL {
+ public:
+  QuantizedGemmSYCL(read_accessor a, Index a_offset, read_accessor b,
+                    Index b_offset, write_accessor c, Index c_offset,
+                    local_accessor<int32_t> a_tile,
+                    local_accessor<int32_t> b_tile, Index m, Index n, Index k,
+                    int32_t quantized_zero_a, int32_t quantized_zero_b,
+                    Index lda, Index ldb)
+      : a_accessor_(a),
+        a_offset_(a_offset),
+        b_accessor_(b),
+        b_offset_(b_offset),
+        c_accessor_(c),
+        c_offset_(c_offset),
+        a_tile_(a_tile),
+        b_tile_(b_tile),
+        m_(m),
+        n_(n),
+        k_(k),
+        quantized_zero_a_(quantized_zero_a),
+        quantized_zero_b_(quantized_zero_b),
+        lda_(lda),
+        ldb_(ldb) {}
+
+  void operator()(cl::sycl::nd_item<2> item) {
+    const Index row = item.get_global_id(0);
+    const Index col = item.get_global_id(1);
+    const Index local_row = item.get_local_id(0);
+    const Index local_col = item.get_local_id(1);
+    const T1* a = ConvertToActualTypeSycl(T1, a_accessor_) + a_offset_;
+    const T2* b = ConvertToActualTypeSycl(T2, b_accessor_) + b_offset_;
+
+    int32_t total = 0;
+    for (Index tile_k = 0; tile_k < k_; tile_k += kTile) {
+      // Out of range elements are staged as zero so that they do not
+      // contribute to the sums.
+      const Index a_k = tile_k + local_col;
+      int32_t a_value = 0;
+      if (row < m_ && a_k < k_) {
+        a_value = static_cast<int32_t>(TransA ? a[a_k * lda_ + row]
+                                              : a[row * lda_ + a_k]) -
+                  quantized_zero_a_;
+      }
+      a_tile_[local_row * kTile + local_col] = a_value;
+      const Index b_k = tile_k + local_row;
+      int32_t b_value = 0;
+      if (col < n_ && b_k < k_) {
+        b_value = static_cast<int32_t>(TransB ? b[col * ldb_ + b_k]
+                                              : b[b_k * ldb_ + col]) -
+                  quantized_zero_b_;
+      }
+      b_tile_[local_row * kTile + local_col] = b_value;
+      item.barrier(cl::sycl::access::fence_space::local_space);
+
+#pragma unroll
+      for (int i = 0; i < kTile; ++i) {
+        total += a_tile_[local_row * kTile + i] * b_tile_[i * kTile + local_col];
+      }
+      item.barrier(cl::sycl::access::fence_space::local_space);
+    }
+    if (row < m_ && col < n_) {
+      int32_t* c = ConvertToActualTypeSycl(int32_t, c_accessor_) + c_offset_;
+      c[row * n_ + col] = total;
+    }
+  }
+
+ private:
+  const read_accessor a_accessor_;
+  const Index a_offset_;
+  const read_accessor b_accessor_;
+  const Index b_offset_;
+  write_accessor c_accessor_;
+  const Index c_offset_;
+  local_accessor<int32_t> a_tile_;
+  local_accessor<int32_t> b_tile_;
+  const Index m_;
+  const Index n_;
+  const Index k_;
+  const int32_t quantized_zero_a_;
+  const int32_t quantized_zero_b_;
+  const Index lda_;
+  const Index ldb_;
+};
+
+struct QuantizedConvParams {
+  Index batches;
+  Index input_height;
+  Index input_width;
+  Index input_depth;
+  Index filter_height;
+  Index filter_width;
+  Index filter_count;
+  Index stride;
+  Index filter_top_offset;
+  Index filter_left_offset;
+  Index output_height;
+  Index output_width;
+  int32_t input_offset;
+  int32_t filter_offset;
+  int32_t output_shift;
+  int32_t output_offset;
+  int32_t output_mult;
+  int32_t lowest;
+  int32_t highest;
+};
+
+// Direct NHWC convolution with HWIO filters with one work item per output
+// value, matching ReferenceConvFunctor. The output channel varies fastest so
+// that neighbouring work items share the input reads and read consecutive
+// filter values.
+template <typename T1, typename T2, typename T3>
+class QuantizedConvSYCL {
+ public:
+  QuantizedConvSYCL(read_accessor input, Index input_offset,
+                    read_accessor filter, Index filter_offset,
+                    write_accessor output, Index output_offset,
+                    const QuantizedConvParams& params)
+      : input_accessor_(input),
+        input_offset_(input_offset),
+        filter_accessor_(filter),
+        filter_offset_(filter_offset),
+        output_accessor_(output),
+        output_offset_(output_offset),
+        p_(params) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const Index id = item.get_global_linear_id();
+    if (id >= p_.batches * p_.output_height * p_.output_width *
+                  p_.filter_count) {
+      return;
+    }
+    const T1* input =
+        ConvertToActualTypeSycl(T1, input_accessor_) + input_offset_;
+    const T2* filter =
+        ConvertToActualTypeSycl(T2, filter_accessor_) + filter_offset_;
+    T3* output = ConvertToActualTypeSycl(T3, output_accessor_) + output_offset_;
+
+    const Index out_channel = id % p_.filter_count;
+    const Index out_x = (id / p_.filter_count) % p_.output_width;
+    const Index out_y =
+        (id / (p_.filter_count * p_.output_width)) % p_.output_height;
+    const Index batch =
+        id / (p_.filter_count * p_.output_width * p_.output_height);
+    const Index in_x_origin = out_x * p_.stride - p_.filter_left_offset;
+    const Index in_y_origin = out_y * p_.stride - p_.filter_top_offset;
+
+    int32_t total = 0;
+    for (Index filter_y = 0; filter_y < p_.filter_height; ++filter_y) {
+      const Index in_y = in_y_origin + filter_y;
+      if (in_y < 0 || in_y >= p_.input_height) {
+        continue;
+      }
+      for (Index filter_x = 0; filter_x < p_.filter_width; ++filter_x) {
+        const Index in_x = in_x_origin + filter_x;
+        if (in_x < 0 || in_x >= p_.input_width) {
+          continue;
+        }
+        const T1* input_pixel =
+            input + ((batch * p_.input_height + in_y) * p_.input_width + in_x) *
+                        p_.input_depth;
+        const T2* filter_pixel =
+            filter + (filter_y * p_.filter_width + filter_x) * p_.input_depth *
+                         p_.filter_count +
+            out_channel;
+        for (Index in_channel = 0; in_channel < p_.input_depth; ++in_channel) {
+          total += (static_cast<int32_t>(input_pixel[in_channel]) -
+                    p_.input_offset) *
+                   (static_cast<int32_t>(
+                        filter_pixel[in_channel * p_.filter_count]) -
+                    p_.filter_offset);
+        }
+      }
+    }
+    const int32_t rounding =
+        (p_.output_shift < 1) ? 0 : (1 << (p_.output_shift - 1));
+    const int32_t value =
+        (((total + p_.output_offset) * p_.output_mult) + rounding) >>
+        p_.output_shift;
+    output[id] = static_cast<T3>(
+        cl::sycl::max(cl::sycl::min(value, p_.highest), p_.lowest));
+  }
+
+ private:
+  const read_accessor input_accessor_;
+  const Index input_offset_;
+  const read_accessor filter_accessor_;
+  const Index filter_offset_;
+  write_accessor output_accessor_;
+  const Index output_offset_;
+  const QuantizedConvParams p_;
+};
+
+}  // namespace quantized_sycl
+
+template <typename T>
+void LaunchSYCLQuantize(const SYCLDevice& d, const float* in, T* out,
+                        quantized_sycl::Index n,
+                        const quantized_sycl::QuantizeParams& params) {
+  using Q = typename quantized_sycl::Storage<T>::type;
+  if (n == 0) {
+    return;
+  }
+  const cl::sycl::nd_range<1> range = SYCLUtil::get_nd_range(d, n);
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto in_acc = d.get_sycl_buffer(in).template get_access<mode::read>(cgh);
+    auto out_acc =
+        d.get_sycl_buffer(out).template get_access<mode::write>(cgh);
+    quantized_sycl::QuantizeSYCL<Q> functor(
+        in_acc, d.get_offset(in) / sizeof(float), out_acc,
+        d.get_offset(out) / sizeof(T), n, params);
+    cgh.parallel_for(range, functor);
+  });
+}
+
+template <typename T>
+void LaunchSYCLDequantize(const SYCLDevice& d, const T* in, float* out,
+                          quantized_sycl::Index n, float pre_offset,
+                          float scale, float post_offset) {
+  using Q = typename quantized_sycl::Storage<T>::type;
+  if (n == 0) {
+    return;
+  }
+  const cl::sycl::nd_range<1> range = SYCLUtil::get_nd_range(d, n);
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto in_acc = d.get_sycl_buffer(in).template get_access<mode::read>(cgh);
+    auto out_acc =
+        d.get_sycl_buffer(out).template get_access<mode::write>(cgh);
+    quantized_sycl::DequantizeSYCL<Q> functor(
+        in_acc, d.get_offset(in) / sizeof(T), out_acc,
+        d.get_offset(out) / sizeof(float), n, pre_offset, scale, post_offset);
+    cgh.parallel_for(range, functor);
+  });
+}
+
+inline void LaunchSYCLRequantize32To8(const SYCLDevice& d, const qint32* in,
+                                      quint8* out, quantized_sycl::Index n,
+                                      float min_input, float max_input,
+                                      float min_output, float max_output) {
+  if (n == 0) {
+    return;
+  }
+  const quantized_sycl::RequantizeParams params =
+      quantized_sycl::GetRequantizeParams(min_input, max_input, min_output,
+                                          max_output);
+  const cl::sycl::nd_range<1> range = SYCLUtil::get_nd_range(d, n);
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto in_acc = d.get_sycl_buffer(in).template get_access<mode::read>(cgh);
+    auto out_acc =
+        d.get_sycl_buffer(out).template get_access<mode::write>(cgh);
+    quantized_sycl::Requantize32To8SYCL functor(
+        in_acc, d.get_offset(in) / sizeof(qint32), out_acc,
+        d.get_offset(out) / sizeof(quint8), n, params);
+    cgh.parallel_for(range, functor);
+  });
+}
+
+// Computes the minimum and maximum of the n values of in. Blocks until the
+// result is back on the host.
+inline Status SYCLQuantizedRange(OpKernelContext* ctx, const qint32* in,
+                                 quantized_sycl::Index n, qint32* min,
+                                 qint32* max) {
+  using quantized_sycl::Index;
+  const SYCLDevice& d = ctx->eigen_device<SYCLDevice>();
+  if (n == 0) {
+    // Matches the empty Eigen reductions of the CPU kernel.
+    *min = std::numeric_limits<int32>::max();
+    *max = std::numeric_limits<int32>::lowest();
+    return Status::OK();
+  }
+  // A power of two work-group size for the reduction in local memory, and
+  // few enough groups for their results to be cheap to reduce on the host.
+  Index local_size = 1;
+  while (local_size * 2 <= static_cast<Index>(std::min<size_t>(
+                               SYCLUtil::get_max_work_group_size(d), 256))) {
+    local_size *= 2;
+  }
+  const Index groups =
+      std::max(1, std::min((n + local_size - 1) / local_size, 64));
+  Tensor partial;
+  TF_RETURN_IF_ERROR(
+      ctx->allocate_temp(DT_INT32, TensorShape({2 * groups}), &partial));
+  int32* partial_data = partial.flat<int32>().data();
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto in_acc = d.get_sycl_buffer(in).template get_access<mode::read>(cgh);
+    auto out_acc = d.get_sycl_buffer(partial_data)
+                       .template get_access<mode::write>(cgh);
+    quantized_sycl::local_accessor<int32_t> min_scratch(
+        cl::sycl::range<1>(local_size), cgh);
+    quantized_sycl::local_accessor<int32_t> max_scratch(
+        cl::sycl::range<1>(local_size), cgh);
+    quantized_sycl::RangeSYCL functor(
+        in_acc, d.get_offset(in) / sizeof(qint32), out_acc,
+        d.get_offset(partial_data) / sizeof(int32), min_scratch, max_scratch,
+        n);
+    cgh.parallel_for(cl::sycl::nd_range<1>(cl::sycl::range<1>(groups * local_size),
+                                           cl::sycl::range<1>(local_size)),
+                     functor);
+  });
+  std::vector<int32> host_partial(2 * groups);
+  Notification done_copy;
+  d.memcpyDeviceToHost(host_partial.data(), partial_data,
+                       host_partial.size() * sizeof(int32),
+                       [&done_copy]() { done_copy.Notify(); });
+  done_copy.WaitForNotification();
+  int32 used_min = host_partial[0];
+  int32 used_max = host_partial[1];
+  for (Index group = 1; group < groups; ++group) {
+    used_min = std::min(used_min, host_partial[2 * group]);
+    used_max = std::max(used_max, host_partial[2 * group + 1]);
+  }
+  *min = used_min;
+  *max = used_max;
+  return Status::OK();
+}
+
+// Runs c = (a - offset_a) * (b - offset_b) for quantized row-major matrices,
+// with the conventions of the CPU QuantizedMatMul: lda and ldb are the number
+// of columns of the stored a and b.
+template <typename T1, typename T2>
+void LaunchSYCLQuantizedGemm(const SYCLDevice& d, bool transpose_a,
+                             bool transpose_b, const T1* a, const T2* b,
+                             qint32* c, quantized_sycl::Index m,
+                             quantized_sycl::Index n, quantized_sycl::Index k,
+                             int32 offset_a, int32 offset_b,
+                             quantized_sycl::Index lda,
+                             quantized_sycl::Index ldb) {
+  using quantized_sycl::Index;
+  using Q1 = typename quantized_sycl::Storage<T1>::type;
+  using Q2 = typename quantized_sycl::Storage<T2>::type;
+  constexpr int kTile = 16;
+  if (m == 0 || n == 0) {
+    return;
+  }
+  const cl::sycl::nd_range<2> range(
+      cl::sycl::range<2>((m + kTile - 1) / kTile * kTile,
+                         (n + kTile - 1) / kTile * kTile),
+      cl::sycl::range<2>(kTile, kTile));
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto a_acc = d.get_sycl_buffer(a).template get_access<mode::read>(cgh);
+    auto b_acc = d.get_sycl_buffer(b).template get_access<mode::read>(cgh);
+    auto c_acc = d.get_sycl_buffer(c).template get_access<mode::write>(cgh);
+    quantized_sycl::local_accessor<int32_t> a_tile(
+        cl::sycl::range<1>(kTile * kTile), cgh);
+    quantized_sycl::local_accessor<int32_t> b_tile(
+        cl::sycl::range<1>(kTile * kTile), cgh);
+    const Index a_offset = d.get_offset(a) / sizeof(T1);
+    const Index b_offset = d.get_offset(b) / sizeof(T2);
+    const Index c_offset = d.get_offset(c) / sizeof(qint32);
+#define LAUNCH_QUANTIZED_GEMM(TRANS_A, TRANS_B)                            \
+  cgh.parallel_for(                                                        \
+      range,                                                               \
+      quantized_sycl::QuantizedGemmSYCL<Q1, Q2, TRANS_A, TRANS_B, kTile>(  \
+          a_acc, a_offset, b_acc, b_offset, c_acc, c_offset, a_tile,       \
+          b_tile, m, n, k, offset_a, offset_b, lda, ldb))
+    if (transpose_a) {
+      if (transpose_b) {
+        LAUNCH_QUANTIZED_GEMM(true, true);
+      } else {
+        LAUNCH_QUANTIZED_GEMM(true, false);
+      }
+    } else {
+      if (transpose_b) {
+        LAUNCH_QUANTIZED_GEMM(false, true);
+      } else {
+        LAUNCH_QUANTIZED_GEMM(false, false);
+      }
+    }
+#undef LAUNCH_QUANTIZED_GEMM
+  });
+}
+
+// A ConvFunctor for QuantizedConv2DOp running the convolution on a SYCL
+// device. The pointers are SYCL device pointers.
+template <class T1, class T2, class T3>
+class SYCLQuantizedConvFunctor {
+ public:
+  void operator()(OpKernelContext* context, const T1* input_data,
+                  int input_batches, int input_height, int input_width,
+                  int input_depth, int input_offset, const T2* filter_data,
+                  int filter_height, int filter_width, int filter_count,
+                  int filter_offset, int stride, Padding padding,
+                  T3* output_data, int output_height, int output_width,
+                  int output_shift, int output_offset, int output_mult) {
+    using Q1 = typename quantized_sycl::Storage<T1>::type;
+    using Q2 = typename quantized_sycl::Storage<T2>::type;
+    using Q3 = typename quantized_sycl::Storage<T3>::type;
+    const SYCLDevice& d = context->eigen_device<SYCLDevice>();
+
+    quantized_sycl::QuantizedConvParams params;
+    params.batches = input_batches;
+    params.input_height = input_height;
+    params.input_width = input_width;
+    params.input_depth = input_depth;
+    params.filter_height = filter_height;
+    params.filter_width = filter_width;
+    params.filter_count = filter_count;
+    params.stride = stride;
+    // Same filter origins as ReferenceConvFunctor.
+    const int padding_adjust = padding == VALID ? 1 : 0;
+    params.filter_left_offset = ((output_width - 1) * stride + filter_width -
+                                 input_width + padding_adjust) /
+                                2;
+    params.filter_top_offset = ((output_height - 1) * stride + filter_height -
+                                input_height + padding_adjust) /
+                               2;
+    params.output_height = output_height;
+    params.output_width = output_width;
+    params.input_offset = input_offset;
+    params.filter_offset = filter_offset;
+    params.output_shift = output_shift;
+    params.output_offset = output_offset;
+    params.output_mult = output_mult;
+    params.lowest = static_cast<int32>(Eigen::NumTraits<T3>::lowest());
+    params.highest = static_cast<int32>(Eigen::NumTraits<T3>::highest());
+
+    const quantized_sycl::Index n =
+        input_batches * output_height * output_width * filter_count;
+    if (n == 0) {
+      return;
+    }
+    const cl::sycl::nd_range<1> range = SYCLUtil::get_nd_range(d, n);
+    d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+      using mode = cl::sycl::access::mode;
+      auto input_acc =
+          d.get_sycl_buffer(input_data).template get_access<mode::read>(cgh);
+      auto filter_acc =
+          d.get_sycl_buffer(filter_data).template get_access<mode::read>(cgh);
+      auto output_acc = d.get_sycl_buffer(output_data)
+                            .template get_access<mode::write>(cgh);
+      quantized_sycl::QuantizedConvSYCL<Q1, Q2, Q3> functor(
+          input_acc, d.get_offset(input_data) / sizeof(T1), filter_acc,
+          d.get_offset(filter_data) / sizeof(T2), output_acc,
+          d.get_offset(output_data) / sizeof(T3), params);
+      cgh.parallel_for(range, functor);
+    });
+  }
+};
+
+}  // namespace functor
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_QUANTIZED_OPS_SYCL_H_
@@ -88,10 +88,15 @@ struct FillPhiloxRandomTask<Distribution, false> {
     gen.Skip(start_group);
     int64 offset = start_group * kGroupSize;
 
+    // Each output group takes exactly one sample, so the samples can be
+    // computed several at a time, which vectorizes the Philox rounds without
+    // changing the stream.
+    random::BatchedPhiloxRandom batched_gen(gen);
+
     // First fill all the full-size groups
     int64 limit_group_full = std::min(limit_group, size / kGroupSize);
     for (int64 index = start_group; index < limit_group_full; ++index) {
-      auto samples = dist(&gen);
+      auto samples = dist(&batched_gen);
       std::copy(&samples[0], &samples[0] + kGroupSize, data + offset);
       offset += kGroupSize;
     }
@@ -99,7 +104,7 @@ struct FillPhiloxRandomTask<Distribution, false> {
     // If there are any remaining elements that need to be filled, process them
     if (limit_group_full < limit_group) {
       int64 remaining_size = size - limit_group_full * kGroupSize;
-      auto samples = dist(&gen);
+      auto samples = dist(&batched_gen);
       std::copy(&samples[0], &samples[0] + remaining_size, data + offset);
     }
   }
@@ -598,9 +603,14 @@ struct FillPhiloxRandomKernel {
   static constexpr size_t kGeneratorSkipPerOutputGroup = kGroupSize *
     kReservedSamplesPerOutput / PhiloxRandom::kResultElementCount;
 
-  FillPhiloxRandomKernel(write_accessor& data, random::PhiloxRandom gen,
-                         Distribution dist, size_t size)
-      : data_(data), gen_(gen), dist_(dist), size_(size) {}
+  FillPhiloxRandomKernel(write_accessor& data, size_t data_offset,
+                         random::PhiloxRandom gen, Distribution dist,
+                         size_t size)
+      : data_(data),
+        data_offset_(data_offset),
+        gen_(gen),
+        dist_(dist),
+        size_(size) {}
 
   void operator()(cl::sycl::nd_item<1> item) {
     const size_t item_id = item.get_global_id(0);
@@ -608,7 +618,7 @@ struct FillPhiloxRandomKernel {
     if (offset > size_)
       return;
 
-    T* data = ConvertToActualTypeSycl(T, data_) + offset;
+    T* data = ConvertToActualTypeSycl(T, data_) + data_offset_ + offset;
 
     auto samples = generate_samples_(item_id, dist_, gen_);
     const size_t nb_fill = std::min(kGroupSize, size_ - offset);
@@ -619,6 +629,7 @@ struct FillPhiloxRandomKernel {
 
  private:
   write_accessor data_;
+  size_t data_offset_;
   random::PhiloxRandom gen_;
   Distribution dist_;
   size_t size_;
@@ -656,7 +667,8 @@ void FillPhiloxRandom<SYCLDevice, Distribution>::operator()(
 
     FillPhiloxRandomKernel<Distribution,
                            Distribution::kVariableSamplesPerOutput>
-      task(access, gen, dist, size);
+      task(access, device.get_offset(data) / sizeof(*data), gen, dist,
+           size);
     cgh.parallel_for(nd_rng, task);
   });
 }
@@ -32,6 +32,9 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/kernels/reduction_ops.h"
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/kernels/reduction_ops_sycl.h"
+#endif  // TENSORFLOW_USE_SYCL
 #include "tensorflow/core/kernels/transpose_functor.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
@@ -269,9 +272,22 @@ template <typename Reducer>
 struct ReduceFunctor<CPUDevice, Reducer>
     : ReduceFunctorBase<CPUDevice, Reducer> {};
 #ifdef TENSORFLOW_USE_SYCL
+// Sum, Mean, Prod, Max and Min of floating point values use the SYCL
+// reduction kernels when they support the shape of the reduction, everything
+// else goes through Eigen.
 template <typename Reducer>
 struct ReduceFunctor<SYCLDevice, Reducer>
-    : ReduceFunctorBase<SYCLDevice, Reducer> {};
+    : ReduceFunctorBase<SYCLDevice, Reducer> {
+  template <typename OUT_T, typename IN_T, typename ReductionAxes>
+  static void Reduce(OpKernelContext* ctx, OUT_T out, IN_T in,
+                     const ReductionAxes& reduction_axes,
+                     const Reducer& reducer) {
+    if (!LaunchSYCLReduction(ctx, out, in, reduction_axes, reducer)) {
+      ReduceFunctorBase<SYCLDevice, Reducer>::Reduce(ctx, out, in,
+                                                     reduction_axes, reducer);
+    }
+  }
+};
 #endif  // TENSORFLOW_USE_SYCL
 
 }  // namespace functor
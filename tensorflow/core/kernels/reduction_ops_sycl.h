@@ -0,0 +1,568 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_USE_SYCL
+#error This file must only be included when building TensorFlow with SYCL support
+#endif
+
+#ifndef TENSORFLOW_CORE_KERNELS_REDUCTION_OPS_SYCL_H_
+#define TENSORFLOW_CORE_KERNELS_REDUCTION_OPS_SYCL_H_
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+
+#include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/lib/core/status.h"
+
+namespace tensorflow {
+
+typedef Eigen::SyclDevice SYCLDevice;
+
+namespace functor {
+namespace reduction_sycl {
+
+// Reductions run by the kernels below are only done in 32 bit indices.
+using Index = int;
+
+// Number of consecutive elements each work item loads per iteration when
+// reducing along the innermost dimension.
+constexpr int kVectorWidth = 4;
+// Minimum number of loop iterations of a work item before splitting a
+// reduction over several work-groups is worth a second pass.
+constexpr int kMinIterationsPerItem = 8;
+// Work-groups launched per compute unit to keep the device busy.
+constexpr int kGroupsPerComputeUnit = 4;
+// Rows up to this size are reduced by a single work item, as using a whole
+// work-group for them would leave most of it idle.
+constexpr int kMaxColsPerItem = 32;
+
+template <typename T>
+struct SumOp {
+  inline T operator()(const T a, const T b) const { return a + b; }
+};
+template <typename T>
+struct ProdOp {
+  inline T operator()(const T a, const T b) const { return a * b; }
+};
+template <typename T>
+struct MaxOp {
+  inline T operator()(const T a, const T b) const { return a > b ? a : b; }
+};
+template <typename T>
+struct MinOp {
+  inline T operator()(const T a, const T b) const { return a < b ? a : b; }
+};
+
+template <typename T>
+struct Accessors {
+  using read =
+      cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read,
+                         cl::sycl::access::target::global_buffer>;
+  using write =
+      cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::write,
+                         cl::sycl::access::target::global_buffer>;
+  using local =
+      cl::sycl::accessor<T, 1, cl::sycl::access::mode::read_write,
+                         cl::sycl::access::target::local>;
+};
+
+// Reduces each row of a [rows, cols] matrix. Each row is split in
+// groups_per_row chunks, each reduced by one work-group to out[row, chunk].
+// Consecutive work items load consecutive runs of kVectorWidth elements, the
+// partial results are then combined with a tree reduction in local memory.
+// The work-group size must be a power of two.
+template <typename T, typename Op>
+class ReduceRowsSYCL {
+  using read_accessor = typename Accessors<T>::read;
+  using write_accessor = typename Accessors<T>::write;
+  using local_accessor = typename Accessors<T>::local;
+
+ public:
+  ReduceRowsSYCL(read_accessor in, Index in_offset, write_accessor out,
+                 Index out_offset, local_accessor scratch, Index cols,
+                 Index groups_per_row, T init, T divisor)
+      : in_accessor_(in),
+        in_offset_(in_offset),
+        out_accessor_(out),
+        out_offset_(out_offset),
+        scratch_(scratch),
+        cols_(cols),
+        groups_per_row_(groups_per_row),
+        init_(init),
+        divisor_(divisor) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const Index group = item.get_group(0);
+    const Index local_id = item.get_local_id(0);
+    const Index local_size = item.get_local_range(0);
+    const Index row = group / groups_per_row_;
+    const Index chunk = group - row * groups_per_row_;
+    const T* in =
+        ConvertToActualTypeSycl(T, in_accessor_) + in_offset_ + row * cols_;
+    T* scratch = scratch_.get_pointer();
+    Op op;
+
+    T accum = init_;
+    const Index stride = groups_per_row_ * local_size * kVectorWidth;
+    Index col = (chunk * local_size + local_id) * kVectorWidth;
+    for (; col + kVectorWidth <= cols_; col += stride) {
+#pragma unroll
+      for (int i = 0; i < kVectorWidth; ++i) {
+        accum = op(accum, in[col + i]);
+      }
+    }
+    for (; col < cols_; ++col) {
+      accum = op(accum, in[col]);
+    }
+
+    scratch[local_id] = accum;
+    item.barrier(cl::sycl::access::fence_space::local_space);
+    for (Index offset = local_size / 2; offset > 0; offset /= 2) {
+      if (local_id < offset) {
+        scratch[local_id] = op(scratch[local_id], scratch[local_id + offset]);
+      }
+      item.barrier(cl::sycl::access::fence_space::local_space);
+    }
+    if (local_id == 0) {
+      T* out = ConvertToActualTypeSycl(T, out_accessor_) + out_offset_;
+      out[group] = scratch[0] / divisor_;
+    }
+  }
+
+ private:
+  const read_accessor in_accessor_;
+  const Index in_offset_;
+  write_accessor out_accessor_;
+  const Index out_offset_;
+  local_accessor scratch_;
+  const Index cols_;
+  const Index groups_per_row_;
+  const T init_;
+  const T divisor_;
+};
+
+// Reduces each row of a [rows, cols] matrix with a single work item, used
+// when the rows are too short to keep a work-group busy.
+template <typename T, typename Op>
+class ReduceShortRowsSYCL {
+  using read_accessor = typename Accessors<T>::read;
+  using write_accessor = typename Accessors<T>::write;
+
+ public:
+  ReduceShortRowsSYCL(read_accessor in, Index in_offset, write_accessor out,
+                      Index out_offset, Index rows, Index cols, T init,
+                      T divisor)
+      : in_accessor_(in),
+        in_offset_(in_offset),
+        out_accessor_(out),
+        out_offset_(out_offset),
+        rows_(rows),
+        cols_(cols),
+        init_(init),
+        divisor_(divisor) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const Index row = item.get_global_id(0);
+    if (row >= rows_) {
+      return;
+    }
+    const T* in =
+        ConvertToActualTypeSycl(T, in_accessor_) + in_offset_ + row * cols_;
+    T* out = ConvertToActualTypeSycl(T, out_accessor_) + out_offset_;
+    Op op;
+    T accum = init_;
+    for (Index col = 0; col < cols_; ++col) {
+      accum = op(accum, in[col]);
+    }
+    out[row] = accum / divisor_;
+  }
+
+ private:
+  const read_accessor in_accessor_;
+  const Index in_offset_;
+  write_accessor out_accessor_;
+  const Index out_offset_;
+  const Index rows_;
+  const Index cols_;
+  const T init_;
+  const T divisor_;
+};
+
+// Reduces the middle dimension of a [batch, rows, cols] tensor. Work-groups
+// are two dimensional: along the second dimension consecutive work items read
+// consecutive columns, along the first one they stride over the rows. Rows
+// are split in row_groups chunks, each reduced by one work-group to
+// out[batch, chunk, col]. Partial results are combined with a tree reduction
+// over the first dimension in local memory, whose size must be a power of
+// two.
+template <typename T, typename Op>
+class ReduceColumnsSYCL {
+  using read_accessor = typename Accessors<T>::read;
+  using write_accessor = typename Accessors<T>::write;
+  using local_accessor = typename Accessors<T>::local;
+
+ public:
+  ReduceColumnsSYCL(read_accessor in, Index in_offset, write_accessor out,
+                    Index out_offset, local_accessor scratch, Index rows,
+                    Index cols, Index row_groups, T init, T divisor)
+      : in_accessor_(in),
+        in_offset_(in_offset),
+        out_accessor_(out),
+        out_offset_(out_offset),
+        scratch_(scratch),
+        rows_(rows),
+        cols_(cols),
+        row_groups_(row_groups),
+        init_(init),
+        divisor_(divisor) {}
+
+  void operator()(cl::sycl::nd_item<2> item) {
+    const Index group = item.get_group(0);
+    const Index batch = group / row_groups_;
+    const Index chunk = group - batch * row_groups_;
+    const Index local_row = item.get_local_id(0);
+    const Index local_rows = item.get_local_range(0);
+    const Index local_col = item.get_local_id(1);
+    const Index local_cols = item.get_local_range(1);
+    const Index col = item.get_global_id(1);
+    // Work items past the last column still take part in the barriers.
+    const bool valid = col < cols_;
+    const T* in = ConvertToActualTypeSycl(T, in_accessor_) + in_offset_ +
+                  batch * rows_ * cols_;
+    T* scratch = scratch_.get_pointer();
+    Op op;
+
+    T accum = init_;
+    if (valid) {
+      for (Index row = chunk * local_rows + local_row; row < rows_;
+           row += row_groups_ * local_rows) {
+        accum = op(accum, in[row * cols_ + col]);
+      }
+    }
+
+    const Index local_id = local_row * local_cols + local_col;
+    scratch[local_id] = accum;
+    item.barrier(cl::sycl::access::fence_space::local_space);
+    for (Index offset = local_rows / 2; offset > 0; offset /= 2) {
+      if (local_row < offset) {
+        scratch[local_id] =
+            op(scratch[local_id], scratch[local_id + offset * local_cols]);
+      }
+      item.barrier(cl::sycl::access::fence_space::local_space);
+    }
+    if (local_row == 0 && valid) {
+      T* out = ConvertToActualTypeSycl(T, out_accessor_) + out_offset_;
+      out[group * cols_ + col] = scratch[local_col] / divisor_;
+    }
+  }
+
+ private:
+  const read_accessor in_accessor_;
+  const Index in_offset_;
+  write_accessor out_accessor_;
+  const Index out_offset_;
+  local_accessor scratch_;
+  const Index rows_;
+  const Index cols_;
+  const Index row_groups_;
+  const T init_;
+  const T divisor_;
+};
+
+inline Index RoundUpToPowerOfTwo(Index n) {
+  Index result = 1;
+  while (result < n) {
+    result *= 2;
+  }
+  return result;
+}
+
+inline Index RoundDownToPowerOfTwo(Index n) {
+  Index result = 1;
+  while (result * 2 <= n) {
+    result *= 2;
+  }
+  return result;
+}
+
+inline Index CeilDiv(Index a, Index b) { return (a + b - 1) / b; }
+
+// Work-group size of the tree reductions.
+inline Index ReductionWorkGroupSize(const SYCLDevice& d) {
+  return RoundDownToPowerOfTwo(static_cast<Index>(
+      std::min<size_t>(256, SYCLUtil::get_max_work_group_size(d))));
+}
+
+// Number of work-groups needed to keep every compute unit busy.
+inline Index TargetWorkGroups(const SYCLDevice& d) {
+  return static_cast<Index>(
+      std::max<unsigned long>(1, d.getNumSyclMultiProcessors()) *
+      kGroupsPerComputeUnit);
+}
+
+template <typename T, typename Op>
+void LaunchRowReduction(const SYCLDevice& d, const T* in, T* out, Index rows,
+                        Index cols, Index groups_per_row, T init, T divisor) {
+  if (groups_per_row == 1 && cols <= kMaxColsPerItem) {
+    d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+      using mode = cl::sycl::access::mode;
+      auto in_acc = d.get_sycl_buffer(in).template get_access<mode::read>(cgh);
+      auto out_acc =
+          d.get_sycl_buffer(out).template get_access<mode::write>(
+              cgh);
+      ReduceShortRowsSYCL<T, Op> functor(
+          in_acc, d.get_offset(in) / sizeof(T), out_acc,
+          d.get_offset(out) / sizeof(T), rows, cols, init, divisor);
+      cgh.parallel_for(SYCLUtil::get_nd_range(d, rows), functor);
+    });
+    return;
+  }
+  const Index local_size = ReductionWorkGroupSize(d);
+  const Index n_groups = rows * groups_per_row;
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto in_acc = d.get_sycl_buffer(in).template get_access<mode::read>(cgh);
+    auto out_acc =
+        d.get_sycl_buffer(out).template get_access<mode::write>(cgh);
+    typename Accessors<T>::local scratch(cl::sycl::range<1>(local_size), cgh);
+    ReduceRowsSYCL<T, Op> functor(in_acc, d.get_offset(in) / sizeof(T),
+                                  out_acc, d.get_offset(out) / sizeof(T),
+                                  scratch, cols, groups_per_row, init,
+                                  divisor);
+    cgh.parallel_for(
+        cl::sycl::nd_range<1>(cl::sycl::range<1>(n_groups * local_size),
+                              cl::sycl::range<1>(local_size)),
+        functor);
+  });
+}
+
+template <typename T, typename Op>
+void LaunchColumnReduction(const SYCLDevice& d, const T* in, T* out,
+                           Index batch, Index rows, Index cols,
+                           Index row_groups, Index local_rows,
+                           Index local_cols, T init, T divisor) {
+  const Index col_groups = CeilDiv(cols, local_cols);
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto in_acc = d.get_sycl_buffer(in).template get_access<mode::read>(cgh);
+    auto out_acc =
+        d.get_sycl_buffer(out).template get_access<mode::write>(cgh);
+    typename Accessors<T>::local scratch(
+        cl::sycl::range<1>(local_rows * local_cols), cgh);
+    ReduceColumnsSYCL<T, Op> functor(
+        in_acc, d.get_offset(in) / sizeof(T), out_acc,
+        d.get_offset(out) / sizeof(T), scratch, rows, cols, row_groups, init,
+        divisor);
+    cgh.parallel_for(
+        cl::sycl::nd_range<2>(
+            cl::sycl::range<2>(batch * row_groups * local_rows,
+                               col_groups * local_cols),
+            cl::sycl::range<2>(local_rows, local_cols)),
+        functor);
+  });
+}
+
+// Reduces the rows of a [rows, cols] matrix into out. Long rows which would
+// not give enough work-groups to fill the device are first reduced by several
+// work-groups each into a temporary, which is then reduced in a second pass.
+template <typename T, typename Op>
+void ReduceRows(OpKernelContext* ctx, const T* in, T* out, Index rows,
+                Index cols, T init, T divisor) {
+  const SYCLDevice& d = ctx->eigen_device<SYCLDevice>();
+  const Index local_size = ReductionWorkGroupSize(d);
+  const Index target_groups = TargetWorkGroups(d);
+  Index groups_per_row = 1;
+  if (rows < target_groups && cols > kMaxColsPerItem) {
+    const Index max_chunks =
+        CeilDiv(cols, local_size * kVectorWidth * kMinIterationsPerItem);
+    groups_per_row = std::min(CeilDiv(target_groups, rows), max_chunks);
+  }
+  if (groups_per_row <= 1) {
+    LaunchRowReduction<T, Op>(d, in, out, rows, cols, 1, init, divisor);
+    return;
+  }
+  Tensor partial;
+  OP_REQUIRES_OK(ctx, ctx->allocate_temp(DataTypeToEnum<T>::value,
+                                         TensorShape({rows, groups_per_row}),
+                                         &partial));
+  T* partial_data = partial.flat<T>().data();
+  LaunchRowReduction<T, Op>(d, in, partial_data, rows, cols, groups_per_row,
+                            init, T(1));
+  LaunchRowReduction<T, Op>(d, partial_data, out, rows, groups_per_row, 1,
+                            init, divisor);
+}
+
+// Reduces the middle dimension of a [batch, rows, cols] tensor into out. When
+// there are too few columns to fill the device the rows are split between
+// several work-groups, whose partial results are reduced in a second pass.
+template <typename T, typename Op>
+void ReduceColumns(OpKernelContext* ctx, const T* in, T* out, Index batch,
+                   Index rows, Index cols, T init, T divisor) {
+  const SYCLDevice& d = ctx->eigen_device<SYCLDevice>();
+  const Index local_size = ReductionWorkGroupSize(d);
+  const Index local_cols =
+      std::min(std::min(RoundUpToPowerOfTwo(cols), Index(32)), local_size);
+  const Index local_rows =
+      std::min(local_size / local_cols, RoundUpToPowerOfTwo(rows));
+  const Index target_groups = TargetWorkGroups(d);
+  const Index groups = batch * CeilDiv(cols, local_cols);
+  Index row_groups = 1;
+  if (groups < target_groups) {
+    const Index max_chunks =
+        CeilDiv(rows, local_rows * kMinIterationsPerItem);
+    row_groups = std::min(CeilDiv(target_groups, groups), max_chunks);
+  }
+  if (row_groups <= 1) {
+    LaunchColumnReduction<T, Op>(d, in, out, batch, rows, cols, 1, local_rows,
+                                 local_cols, init, divisor);
+    return;
+  }
+  Tensor partial;
+  OP_REQUIRES_OK(
+      ctx, ctx->allocate_temp(DataTypeToEnum<T>::value,
+                              TensorShape({batch, row_groups, cols}),
+                              &partial));
+  T* partial_data = partial.flat<T>().data();
+  LaunchColumnReduction<T, Op>(d, in, partial_data, batch, rows, cols,
+                               row_groups, local_rows, local_cols, init, T(1));
+  LaunchColumnReduction<T, Op>(
+      d, partial_data, out, batch, row_groups, cols, 1,
+      std::min(local_size / local_cols, RoundUpToPowerOfTwo(row_groups)),
+      local_cols, init, divisor);
+}
+
+// Describes how the SYCL kernels implement an Eigen reducer. Reducers and
+// types without a specialization use the Eigen implementation.
+template <typename Reducer>
+struct ReducerTraits {
+  static constexpr bool kSupported = false;
+};
+
+template <typename T, template <typename> class OpT, bool IsMean>
+struct ReducerTraitsBase {
+  static constexpr bool kSupported = std::is_floating_point<T>::value;
+  static constexpr bool kIsMean = IsMean;
+  using Scalar = T;
+  using Op = OpT<T>;
+};
+
+template <typename T>
+struct ReducerTraits<Eigen::internal::SumReducer<T>>
+    : ReducerTraitsBase<T, SumOp, false> {
+  static T Init(const Eigen::internal::SumReducer<T>& r) {
+    return r.initialize();
+  }
+};
+template <typename T>
+struct ReducerTraits<Eigen::internal::MeanReducer<T>>
+    : ReducerTraitsBase<T, SumOp, true> {
+  static T Init(const Eigen::internal::MeanReducer<T>&) { return T(0); }
+};
+template <typename T>
+struct ReducerTraits<Eigen::internal::ProdReducer<T>>
+    : ReducerTraitsBase<T, ProdOp, false> {
+  static T Init(const Eigen::internal::ProdReducer<T>& r) {
+    return r.initialize();
+  }
+};
+template <typename T>
+struct ReducerTraits<Eigen::internal::MaxReducer<T>>
+    : ReducerTraitsBase<T, MaxOp, false> {
+  static T Init(const Eigen::internal::MaxReducer<T>& r) {
+    return r.initialize();
+  }
+};
+template <typename T>
+struct ReducerTraits<Eigen::internal::MinReducer<T>>
+    : ReducerTraitsBase<T, MinOp, false> {
+  static T Init(const Eigen::internal::MinReducer<T>& r) {
+    return r.initialize();
+  }
+};
+
+template <typename Reducer, typename OUT_T, typename IN_T,
+          typename ReductionAxes>
+bool ReduceImpl(std::false_type, OpKernelContext*, OUT_T, IN_T,
+                const ReductionAxes&, const Reducer&) {
+  return false;
+}
+
+// Runs the reduction with the SYCL kernels above, picking them from the
+// shape of the reduction the same way the CUDA implementation does. Returns
+// false if the reduction is not supported, in which case nothing was
+// launched.
+template <typename Reducer, typename OUT_T, typename IN_T,
+          typename ReductionAxes>
+bool ReduceImpl(std::true_type, OpKernelContext* ctx, OUT_T out, IN_T in,
+                const ReductionAxes& reduction_axes, const Reducer& reducer) {
+  using Traits = ReducerTraits<Reducer>;
+  using T = typename Traits::Scalar;
+  using Op = typename Traits::Op;
+  if (in.size() > std::numeric_limits<Index>::max()) {
+    return false;
+  }
+  const int in_rank = in.rank();
+  const int out_rank = out.rank();
+  const Index dim0 = in.dimension(0);
+  const Index dim1 = in_rank >= 2 ? in.dimension(1) : 1;
+  const Index dim2 = in_rank >= 3 ? in.dimension(2) : 1;
+  const T init = Traits::Init(reducer);
+  const T* in_data = in.data();
+  T* out_data = out.data();
+
+  if (out_rank == 0) {
+    const Index size = dim0 * dim1 * dim2;
+    ReduceRows<T, Op>(ctx, in_data, out_data, 1, size, init,
+                      Traits::kIsMean ? T(size) : T(1));
+  } else if (in_rank == 2 && out_rank == 1 && reduction_axes[0] == 1) {
+    ReduceRows<T, Op>(ctx, in_data, out_data, dim0, dim1, init,
+                      Traits::kIsMean ? T(dim1) : T(1));
+  } else if (in_rank == 2 && out_rank == 1 && reduction_axes[0] == 0) {
+    ReduceColumns<T, Op>(ctx, in_data, out_data, 1, dim0, dim1, init,
+                         Traits::kIsMean ? T(dim0) : T(1));
+  } else if (in_rank == 3 && out_rank == 2 && reduction_axes[0] == 1) {
+    ReduceColumns<T, Op>(ctx, in_data, out_data, dim0, dim1, dim2, init,
+                         Traits::kIsMean ? T(dim1) : T(1));
+  } else {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace reduction_sycl
+
+// Reduces in into out with the SYCL reduction kernels if they support the
+// reducer, the type and the shape of the reduction, returns false otherwise.
+template <typename Reducer, typename OUT_T, typename IN_T,
+          typename ReductionAxes>
+bool LaunchSYCLReduction(OpKernelContext* ctx, OUT_T out, IN_T in,
+                         const ReductionAxes& reduction_axes,
+                         const Reducer& reducer) {
+  return reduction_sycl::ReduceImpl(
+      std::integral_constant<
+          bool, reduction_sycl::ReducerTraits<Reducer>::kSupported>(),
+      ctx, out, in, reduction_axes, reducer);
+}
+
+}  // namespace functor
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_REDUCTION_OPS_SYCL_H_
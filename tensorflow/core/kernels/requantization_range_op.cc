@@ -27,9 +27,16 @@ limitations under the License.
 #include "tensorflow/core/kernels/quantization_utils.h"
 #include "tensorflow/core/lib/core/errors.h"
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/kernels/quantized_ops_sycl.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
+#ifdef TENSORFLOW_USE_SYCL
+typedef Eigen::SyclDevice SYCLDevice;
+#endif  // TENSORFLOW_USE_SYCL
 
 void CalculateUsedRange(const Tensor& input, qint32* used_min_quantized,
                         qint32* used_max_quantized) {
@@ -40,6 +47,7 @@ void CalculateUsedRange(const Tensor& input, qint32* used_min_quantized,
   *used_max_quantized = max();
 }
 
+template <typename Device>
 class RequantizationRangeOp : public OpKernel {
  public:
   explicit RequantizationRangeOp(OpKernelConstruction* ctx) : OpKernel(ctx) {}
@@ -55,7 +63,8 @@ class RequantizationRangeOp : public OpKernel {
 
     qint32 used_min_quantized;
     qint32 used_max_quantized;
-    CalculateUsedRange(input, &used_min_quantized, &used_max_quantized);
+    OP_REQUIRES_OK(ctx, UsedRange(ctx->eigen_device<Device>(), ctx, input,
+                                  &used_min_quantized, &used_max_quantized));
 
     // We want to make sure that the minimum is no larger than zero, so that the
     // convolution operation can run efficiently.
@@ -68,11 +77,40 @@ class RequantizationRangeOp : public OpKernel {
     output_min->flat<float>().setConstant(used_min_float);
     output_max->flat<float>().setConstant(used_max_float);
   }
+
+ private:
+  Status UsedRange(const CPUDevice& d, OpKernelContext* ctx,
+                   const Tensor& input, qint32* used_min_quantized,
+                   qint32* used_max_quantized) {
+    CalculateUsedRange(input, used_min_quantized, used_max_quantized);
+    return Status::OK();
+  }
+
+#ifdef TENSORFLOW_USE_SYCL
+  Status UsedRange(const SYCLDevice& d, OpKernelContext* ctx,
+                   const Tensor& input, qint32* used_min_quantized,
+                   qint32* used_max_quantized) {
+    return functor::SYCLQuantizedRange(ctx, input.flat<qint32>().data(),
+                                       input.NumElements(), used_min_quantized,
+                                       used_max_quantized);
+  }
+#endif  // TENSORFLOW_USE_SYCL
 };
 
 REGISTER_KERNEL_BUILDER(Name("RequantizationRange")
                             .Device(DEVICE_CPU)
                             .TypeConstraint<qint32>("Tinput"),
-                        RequantizationRangeOp);
+                        RequantizationRangeOp<CPUDevice>);
+
+#ifdef TENSORFLOW_USE_SYCL
+REGISTER_KERNEL_BUILDER(Name("RequantizationRange")
+                            .Device(DEVICE_SYCL)
+                            .HostMemory("input_min")
+                            .HostMemory("input_max")
+                            .HostMemory("output_min")
+                            .HostMemory("output_max")
+                            .TypeConstraint<qint32>("Tinput"),
+                        RequantizationRangeOp<SYCLDevice>);
+#endif  // TENSORFLOW_USE_SYCL
 
 }  // namespace tensorflow
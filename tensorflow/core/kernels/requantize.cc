@@ -28,11 +28,18 @@ limitations under the License.
 #include "tensorflow/core/kernels/quantization_utils.h"
 #include "tensorflow/core/lib/core/errors.h"
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/kernels/quantized_ops_sycl.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
+#ifdef TENSORFLOW_USE_SYCL
+typedef Eigen::SyclDevice SYCLDevice;
+#endif  // TENSORFLOW_USE_SYCL
 
-template <class T1, class T2>
+template <class Device, class T1, class T2>
 class RequantizeOp : public OpKernel {
  public:
   explicit RequantizeOp(OpKernelConstruction* ctx) : OpKernel(ctx) {}
@@ -61,9 +68,25 @@ class RequantizeOp : public OpKernel {
             "requested_output_max must be >= requested_output_min, but got ",
             requested_output_max_float, " and ", requested_output_min_float));
 
-    auto input_array = input.flat<T1>();
+    if (input.NumElements() > 0) {
+      RequantizeTensor(ctx->eigen_device<Device>(), ctx, input,
+                       input_min_float, input_max_float,
+                       requested_output_min_float, requested_output_max_float,
+                       output);
+    }
+
+    output_min->flat<float>().setConstant(requested_output_min_float);
+    output_max->flat<float>().setConstant(requested_output_max_float);
+  }
 
+ private:
+  void RequantizeTensor(const CPUDevice& d, OpKernelContext* ctx,
+                        const Tensor& input, float input_min_float,
+                        float input_max_float,
+                        float requested_output_min_float,
+                        float requested_output_max_float, Tensor* output) {
 #if 0
+    auto input_array = input.flat<T1>();
     // This is the reference, non-eigen implementation:
     auto output_array = output->flat<T2>();
     RequantizeManyInNewRange<T1, T2>(
@@ -73,31 +96,53 @@ class RequantizeOp : public OpKernel {
         output_array.data());
 #endif
 
-    if (input_array.size() > 0) {
-      if (meta::IsSupportedAndEnabled() && std::is_same<T1, qint32>() &&
-          std::is_same<T2, quint8>()) {
-        auto input_i32_array = input.flat<qint32>();
-        meta::Requantize(ctx, input_i32_array.data(), input_i32_array.size(),
-                         input_min_float, input_max_float,
-                         requested_output_min_float, requested_output_max_float,
-                         output->flat<quint8>().data());
-      } else {
-        RequantizeManyInNewRangeUsingEigen<T1, T2>(
-            ctx->eigen_device<CPUDevice>(), input, input_min_float,
-            input_max_float, requested_output_min_float,
-            requested_output_max_float, output);
-      }
+    if (meta::IsSupportedAndEnabled() && std::is_same<T1, qint32>() &&
+        std::is_same<T2, quint8>()) {
+      auto input_i32_array = input.flat<qint32>();
+      meta::Requantize(ctx, input_i32_array.data(), input_i32_array.size(),
+                       input_min_float, input_max_float,
+                       requested_output_min_float, requested_output_max_float,
+                       output->flat<quint8>().data());
+    } else {
+      RequantizeManyInNewRangeUsingEigen<T1, T2>(
+          d, input, input_min_float, input_max_float,
+          requested_output_min_float, requested_output_max_float, output);
     }
+  }
 
-    output_min->flat<float>().setConstant(requested_output_min_float);
-    output_max->flat<float>().setConstant(requested_output_max_float);
+#ifdef TENSORFLOW_USE_SYCL
+  // Only qint32 to quint8 is registered on SYCL.
+  void RequantizeTensor(const SYCLDevice& d, OpKernelContext* ctx,
+                        const Tensor& input, float input_min_float,
+                        float input_max_float,
+                        float requested_output_min_float,
+                        float requested_output_max_float, Tensor* output) {
+    functor::LaunchSYCLRequantize32To8(
+        d, input.flat<qint32>().data(), output->flat<quint8>().data(),
+        input.NumElements(), input_min_float, input_max_float,
+        requested_output_min_float, requested_output_max_float);
   }
+#endif  // TENSORFLOW_USE_SYCL
 };
 
 REGISTER_KERNEL_BUILDER(Name("Requantize")
                             .Device(DEVICE_CPU)
                             .TypeConstraint<qint32>("Tinput")
                             .TypeConstraint<quint8>("out_type"),
-                        RequantizeOp<qint32, quint8>);
+                        RequantizeOp<CPUDevice, qint32, quint8>);
+
+#ifdef TENSORFLOW_USE_SYCL
+REGISTER_KERNEL_BUILDER(Name("Requantize")
+                            .Device(DEVICE_SYCL)
+                            .HostMemory("input_min")
+                            .HostMemory("input_max")
+                            .HostMemory("requested_output_min")
+                            .HostMemory("requested_output_max")
+                            .HostMemory("output_min")
+                            .HostMemory("output_max")
+                            .TypeConstraint<qint32>("Tinput")
+                            .TypeConstraint<quint8>("out_type"),
+                        RequantizeOp<SYCLDevice, qint32, quint8>);
+#endif  // TENSORFLOW_USE_SYCL
 
 }  // namespace tensorflow
@@ -29,10 +29,18 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/logging.h"
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/common_runtime/sycl/sycl_kernel_warmup.h"
+#include "tensorflow/core/kernels/resize_bilinear_op_sycl.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
 typedef Eigen::GpuDevice GPUDevice;
+#ifdef TENSORFLOW_USE_SYCL
+typedef Eigen::SyclDevice SYCLDevice;
+#endif  // TENSORFLOW_USE_SYCL
 
 template <typename Device, typename T>
 class ResizeBilinearOp : public OpKernel {
@@ -372,4 +380,54 @@ TF_CALL_GPU_NUMBER_TYPES_NO_HALF(REGISTER_GRAD_KERNEL);
 
 #endif  // GOOGLE_CUDA
 
+#ifdef TENSORFLOW_USE_SYCL
+
+namespace functor {
+template <typename T>
+struct ResizeBilinear<SYCLDevice, T> {
+  void operator()(const SYCLDevice& d,
+                  typename TTypes<T, 4>::ConstTensor images,
+                  const float height_scale, const float width_scale,
+                  typename TTypes<float, 4>::Tensor output) {
+    LaunchSYCLResizeBilinear<T>(d, images, height_scale, width_scale, output);
+  }
+};
+
+template <typename T>
+struct ResizeBilinearGrad<SYCLDevice, T> {
+  void operator()(const SYCLDevice& d,
+                  typename TTypes<float, 4>::ConstTensor input_grad,
+                  const float height_scale, const float width_scale,
+                  typename TTypes<T, 4>::Tensor output_grad) {
+    LaunchSYCLResizeBilinearGrad<T>(d, input_grad, height_scale, width_scale,
+                                    output_grad);
+  }
+};
+}  // namespace functor
+
+#define REGISTER_KERNEL(T)                            \
+  REGISTER_KERNEL_BUILDER(Name("ResizeBilinear")      \
+                              .Device(DEVICE_SYCL)    \
+                              .TypeConstraint<T>("T") \
+                              .HostMemory("size"),    \
+                          ResizeBilinearOp<SYCLDevice, T>);
+
+TF_CALL_SYCL_NUMBER_TYPES(REGISTER_KERNEL);
+
+#undef REGISTER_KERNEL
+
+#define REGISTER_GRAD_KERNEL(T)                                              \
+  REGISTER_KERNEL_BUILDER(                                                   \
+      Name("ResizeBilinearGrad").Device(DEVICE_SYCL).TypeConstraint<T>("T"), \
+      ResizeBilinearOpGrad<SYCLDevice, T>);
+
+TF_CALL_SYCL_NUMBER_TYPES(REGISTER_GRAD_KERNEL);
+
+#undef REGISTER_GRAD_KERNEL
+
+REGISTER_SYCL_KERNEL_WARMUP(
+    functor::resize_bilinear_sycl::ResizeBilinearSYCL<float>);
+
+#endif  // TENSORFLOW_USE_SYCL
+
 }  // namespace tensorflow
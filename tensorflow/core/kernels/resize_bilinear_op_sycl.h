@@ -0,0 +1,354 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_USE_SYCL
+#error This file must only be included when building TensorFlow with SYCL support
+#endif
+
+#ifndef TENSORFLOW_CORE_KERNELS_RESIZE_BILINEAR_OP_SYCL_H_
+#define TENSORFLOW_CORE_KERNELS_RESIZE_BILINEAR_OP_SYCL_H_
+
+#include <algorithm>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+
+#include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+#include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/kernels/reduction_ops_sycl.h"
+
+namespace tensorflow {
+
+typedef Eigen::SyclDevice SYCLDevice;
+
+namespace functor {
+namespace resize_bilinear_sycl {
+
+using reduction_sycl::Index;
+
+using read_accessor =
+    cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read,
+                       cl::sycl::access::target::global_buffer>;
+using write_accessor =
+    cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::write,
+                       cl::sycl::access::target::global_buffer>;
+using local_accessor =
+    cl::sycl::accessor<float, 1, cl::sycl::access::mode::read_write,
+                       cl::sycl::access::target::local>;
+
+// Computes one output row of ResizeBilinear per work-group, the rows being
+// numbered batch * out_height + y. Each output row interpolates between two
+// input rows. With use_tile these are first converted to float in local
+// memory, so that an input pixel is read once from global memory however
+// many output pixels it contributes to. Consecutive work items compute
+// consecutive channels, which keeps the global reads and writes contiguous.
+template <typename T>
+class ResizeBilinearSYCL {
+ public:
+  ResizeBilinearSYCL(read_accessor in, Index in_offset, write_accessor out,
+                     Index out_offset, local_accessor tile, bool use_tile,
+                     Index in_height, Index in_width, Index out_height,
+                     Index out_width, Index channels, float height_scale,
+                     float width_scale)
+      : in_accessor_(in),
+        in_offset_(in_offset),
+        out_accessor_(out),
+        out_offset_(out_offset),
+        tile_(tile),
+        use_tile_(use_tile),
+        in_height_(in_height),
+        in_width_(in_width),
+        out_height_(out_height),
+        out_width_(out_width),
+        channels_(channels),
+        height_scale_(height_scale),
+        width_scale_(width_scale) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const Index row = item.get_group(0);
+    const Index local_id = item.get_local_id(0);
+    const Index local_size = item.get_local_range(0);
+    const Index batch = row / out_height_;
+    const Index y = row - batch * out_height_;
+    const Index in_row_size = in_width_ * channels_;
+
+    // The same indices as compute_interpolation_weights on the CPU.
+    const float in_y = y * height_scale_;
+    const Index top_y = static_cast<Index>(in_y);
+    const Index bottom_y = cl::sycl::min(top_y + 1, in_height_ - 1);
+    const float y_lerp = in_y - top_y;
+
+    const T* in = ConvertToActualTypeSycl(T, in_accessor_) + in_offset_ +
+                  batch * in_height_ * in_row_size;
+    float* out = ConvertToActualTypeSycl(float, out_accessor_) + out_offset_ +
+                 row * out_width_ * channels_;
+
+    if (use_tile_) {
+      float* tile = tile_.get_pointer();
+      for (Index i = local_id; i < in_row_size; i += local_size) {
+        tile[i] = static_cast<float>(in[top_y * in_row_size + i]);
+        tile[in_row_size + i] =
+            static_cast<float>(in[bottom_y * in_row_size + i]);
+      }
+      item.barrier(cl::sycl::access::fence_space::local_space);
+      InterpolateRow(tile, tile + in_row_size, y_lerp, out, local_id,
+                     local_size);
+    } else {
+      InterpolateRow(in + top_y * in_row_size, in + bottom_y * in_row_size,
+                     y_lerp, out, local_id, local_size);
+    }
+  }
+
+ private:
+  template <typename U>
+  void InterpolateRow(const U* top, const U* bottom, const float y_lerp,
+                      float* out, const Index local_id,
+                      const Index local_size) const {
+    const Index out_row_size = out_width_ * channels_;
+    for (Index i = local_id; i < out_row_size; i += local_size) {
+      const Index x = i / channels_;
+      const Index c = i - x * channels_;
+      const float in_x = x * width_scale_;
+      const Index left_x = static_cast<Index>(in_x);
+      const Index right_x = cl::sycl::min(left_x + 1, in_width_ - 1);
+      const float x_lerp = in_x - left_x;
+      const Index left = left_x * channels_ + c;
+      const Index right = right_x * channels_ + c;
+
+      const float top_left = static_cast<float>(top[left]);
+      const float top_right = static_cast<float>(top[right]);
+      const float bottom_left = static_cast<float>(bottom[left]);
+      const float bottom_right = static_cast<float>(bottom[right]);
+      const float top_value = top_left + (top_right - top_left) * x_lerp;
+      const float bottom_value =
+          bottom_left + (bottom_right - bottom_left) * x_lerp;
+      out[i] = top_value + (bottom_value - top_value) * y_lerp;
+    }
+  }
+
+  const read_accessor in_accessor_;
+  const Index in_offset_;
+  write_accessor out_accessor_;
+  const Index out_offset_;
+  local_accessor tile_;
+  const bool use_tile_;
+  const Index in_height_;
+  const Index in_width_;
+  const Index out_height_;
+  const Index out_width_;
+  const Index channels_;
+  const float height_scale_;
+  const float width_scale_;
+};
+
+// Returns whether the resized row, or column, index interpolated from the
+// original index, with the weight it did so in *weight. The indices are the
+// ones ResizeBilinearGrad computes on the CPU.
+inline bool GradWeight(const Index resized, const Index original,
+                       const float scale, const Index original_size,
+                       float* weight) {
+  const float in = resized * scale;
+  const Index lower = static_cast<Index>(cl::sycl::floor(in));
+  const Index upper =
+      cl::sycl::min(static_cast<Index>(cl::sycl::ceil(in)), original_size - 1);
+  const float lerp = in - lower;
+  *weight = (lower == original ? 1.0f - lerp : 0.0f) +
+            (upper == original ? lerp : 0.0f);
+  return lower == original || upper == original;
+}
+
+// Returns a range of resized indices containing all the ones interpolated
+// from the original index, whose scaled values are within one of it. The
+// clamped upper index makes the last original index collect all the
+// remaining ones. The range is widened by one on each side against rounding,
+// GradWeight rejects the extra indices.
+inline void GradRange(const Index original, const float scale,
+                      const Index resized_size, const Index original_size,
+                      Index* begin, Index* end) {
+  if (scale <= 0.0f) {
+    *begin = 0;
+    *end = resized_size;
+    return;
+  }
+  *begin = cl::sycl::max(static_cast<Index>((original - 1) / scale) - 1,
+                         Index(0));
+  *end = original == original_size - 1
+             ? resized_size
+             : cl::sycl::min(static_cast<Index>((original + 1) / scale) + 2,
+                             resized_size);
+}
+
+// Computes one element of the gradient with respect to the original image
+// per work item, by summing the weighted gradients of the resized pixels
+// that interpolated from it. Gathering instead of scattering into the
+// output as the CPU does needs no atomics, so all types are supported.
+template <typename T>
+class ResizeBilinearGradSYCL {
+ public:
+  ResizeBilinearGradSYCL(read_accessor grad, Index grad_offset,
+                         write_accessor out, Index out_offset, Index batch,
+                         Index resized_height, Index resized_width,
+                         Index original_height, Index original_width,
+                         Index channels, float height_scale, float width_scale)
+      : grad_accessor_(grad),
+        grad_offset_(grad_offset),
+        out_accessor_(out),
+        out_offset_(out_offset),
+        batch_(batch),
+        resized_height_(resized_height),
+        resized_width_(resized_width),
+        original_height_(original_height),
+        original_width_(original_width),
+        channels_(channels),
+        height_scale_(height_scale),
+        width_scale_(width_scale) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const Index index = item.get_global_id(0);
+    if (index >= batch_ * original_height_ * original_width_ * channels_) {
+      return;
+    }
+    const Index c = index % channels_;
+    const Index pixel = index / channels_;
+    const Index original_x = pixel % original_width_;
+    const Index original_y = (pixel / original_width_) % original_height_;
+    const Index batch = pixel / (original_width_ * original_height_);
+
+    Index y_begin, y_end, x_begin, x_end;
+    GradRange(original_y, height_scale_, resized_height_, original_height_,
+              &y_begin, &y_end);
+    GradRange(original_x, width_scale_, resized_width_, original_width_,
+              &x_begin, &x_end);
+
+    const float* grad = ConvertToActualTypeSycl(float, grad_accessor_) +
+                        grad_offset_ +
+                        batch * resized_height_ * resized_width_ * channels_ +
+                        c;
+    float sum = 0.0f;
+    for (Index y = y_begin; y < y_end; ++y) {
+      float y_weight;
+      if (!GradWeight(y, original_y, height_scale_, original_height_,
+                      &y_weight)) {
+        continue;
+      }
+      for (Index x = x_begin; x < x_end; ++x) {
+        float x_weight;
+        if (!GradWeight(x, original_x, width_scale_, original_width_,
+                        &x_weight)) {
+          continue;
+        }
+        sum += grad[(y * resized_width_ + x) * channels_] * y_weight *
+               x_weight;
+      }
+    }
+    ConvertToActualTypeSycl(T, out_accessor_)[out_offset_ + index] =
+        static_cast<T>(sum);
+  }
+
+ private:
+  const read_accessor grad_accessor_;
+  const Index grad_offset_;
+  write_accessor out_accessor_;
+  const Index out_offset_;
+  const Index batch_;
+  const Index resized_height_;
+  const Index resized_width_;
+  const Index original_height_;
+  const Index original_width_;
+  const Index channels_;
+  const float height_scale_;
+  const float width_scale_;
+};
+
+}  // namespace resize_bilinear_sycl
+
+// Runs the ResizeBilinear kernel. The input rows are only staged in local
+// memory when upsampling, downsampling would load pixels that are never
+// interpolated from, and when both rows fit in half of the local memory.
+template <typename T>
+void LaunchSYCLResizeBilinear(const SYCLDevice& d,
+                              typename TTypes<T, 4>::ConstTensor images,
+                              const float height_scale,
+                              const float width_scale,
+                              typename TTypes<float, 4>::Tensor resized) {
+  using resize_bilinear_sycl::Index;
+  const Index batch = images.dimension(0);
+  const Index in_height = images.dimension(1);
+  const Index in_width = images.dimension(2);
+  const Index channels = images.dimension(3);
+  const Index out_height = resized.dimension(1);
+  const Index out_width = resized.dimension(2);
+
+  const size_t tile_size = 2 * static_cast<size_t>(in_width) * channels;
+  const size_t local_mem_size =
+      d.sycl_queue()
+          .get_device()
+          .template get_info<cl::sycl::info::device::local_mem_size>();
+  const bool use_tile = out_width >= in_width &&
+                        tile_size * sizeof(float) <= local_mem_size / 2;
+  const Index local_size =
+      std::min(reduction_sycl::ReductionWorkGroupSize(d),
+               reduction_sycl::RoundUpToPowerOfTwo(
+                   std::max<Index>(out_width * channels, 1)));
+  const cl::sycl::nd_range<1> range(
+      cl::sycl::range<1>(batch * out_height * local_size),
+      cl::sycl::range<1>(local_size));
+
+  const T* in = images.data();
+  float* out = resized.data();
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto in_acc = d.get_sycl_buffer(in).template get_access<mode::read>(cgh);
+    auto out_acc =
+        d.get_sycl_buffer(out).template get_access<mode::write>(cgh);
+    resize_bilinear_sycl::local_accessor tile(
+        cl::sycl::range<1>(use_tile ? tile_size : 1), cgh);
+    resize_bilinear_sycl::ResizeBilinearSYCL<T> functor(
+        in_acc, d.get_offset(in) / sizeof(T), out_acc,
+        d.get_offset(out) / sizeof(float), tile, use_tile, in_height,
+        in_width, out_height, out_width, channels, height_scale, width_scale);
+    cgh.parallel_for(range, functor);
+  });
+}
+
+// Runs the ResizeBilinearGrad kernel, which writes every element of
+// output_grad so that it does not need to be zeroed first.
+template <typename T>
+void LaunchSYCLResizeBilinearGrad(
+    const SYCLDevice& d, typename TTypes<float, 4>::ConstTensor input_grad,
+    const float height_scale, const float width_scale,
+    typename TTypes<T, 4>::Tensor output_grad) {
+  if (output_grad.size() == 0) return;
+  const float* grad = input_grad.data();
+  T* out = output_grad.data();
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto grad_acc =
+        d.get_sycl_buffer(grad).template get_access<mode::read>(cgh);
+    auto out_acc =
+        d.get_sycl_buffer(out).template get_access<mode::write>(cgh);
+    resize_bilinear_sycl::ResizeBilinearGradSYCL<T> functor(
+        grad_acc, d.get_offset(grad) / sizeof(float), out_acc,
+        d.get_offset(out) / sizeof(T), output_grad.dimension(0),
+        input_grad.dimension(1), input_grad.dimension(2),
+        output_grad.dimension(1), output_grad.dimension(2),
+        output_grad.dimension(3), height_scale, width_scale);
+    cgh.parallel_for(SYCLUtil::get_nd_range(d, output_grad.size()), functor);
+  });
+}
+
+}  // namespace functor
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_RESIZE_BILINEAR_OP_SYCL_H_
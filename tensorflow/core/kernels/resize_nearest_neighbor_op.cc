@@ -29,10 +29,17 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/logging.h"
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/kernels/resize_nearest_neighbor_op_sycl.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
 typedef Eigen::GpuDevice GPUDevice;
+#ifdef TENSORFLOW_USE_SYCL
+typedef Eigen::SyclDevice SYCLDevice;
+#endif  // TENSORFLOW_USE_SYCL
 
 template <typename Device, typename T>
 class ResizeNearestNeighborOp : public OpKernel {
@@ -267,4 +274,50 @@ TF_CALL_GPU_NUMBER_TYPES(REGISTER_KERNEL);
 
 #endif  // GOOGLE_CUDA
 
+#ifdef TENSORFLOW_USE_SYCL
+
+namespace functor {
+template <typename T, bool align_corners>
+struct ResizeNearestNeighbor<SYCLDevice, T, align_corners> {
+  bool operator()(const SYCLDevice& d,
+                  typename TTypes<T, 4>::ConstTensor input,
+                  const float height_scale, const float width_scale,
+                  typename TTypes<T, 4>::Tensor output) {
+    LaunchSYCLResizeNearestNeighbor<T, align_corners>(
+        d, input, height_scale, width_scale, output);
+    return true;
+  }
+};
+
+template <typename T, bool align_corners>
+struct ResizeNearestNeighborGrad<SYCLDevice, T, align_corners> {
+  bool operator()(const SYCLDevice& d,
+                  typename TTypes<T, 4>::ConstTensor input_grad,
+                  const float height_scale, const float width_scale,
+                  typename TTypes<T, 4>::Tensor output_grad) {
+    LaunchSYCLResizeNearestNeighborGrad<T, align_corners>(
+        d, input_grad, height_scale, width_scale, output_grad);
+    return true;
+  }
+};
+}  // namespace functor
+
+#define REGISTER_KERNEL(T)                                         \
+  REGISTER_KERNEL_BUILDER(Name("ResizeNearestNeighbor")            \
+                              .Device(DEVICE_SYCL)                 \
+                              .TypeConstraint<T>("T")              \
+                              .HostMemory("size"),                 \
+                          ResizeNearestNeighborOp<SYCLDevice, T>); \
+  REGISTER_KERNEL_BUILDER(Name("ResizeNearestNeighborGrad")        \
+                              .Device(DEVICE_SYCL)                 \
+                              .TypeConstraint<T>("T")              \
+                              .HostMemory("size"),                 \
+                          ResizeNearestNeighborOpGrad<SYCLDevice, T>);
+
+TF_CALL_SYCL_NUMBER_TYPES(REGISTER_KERNEL);
+
+#undef REGISTER_KERNEL
+
+#endif  // TENSORFLOW_USE_SYCL
+
 }  // namespace tensorflow
@@ -0,0 +1,260 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_USE_SYCL
+#error This file must only be included when building TensorFlow with SYCL support
+#endif
+
+#ifndef TENSORFLOW_CORE_KERNELS_RESIZE_NEAREST_NEIGHBOR_OP_SYCL_H_
+#define TENSORFLOW_CORE_KERNELS_RESIZE_NEAREST_NEIGHBOR_OP_SYCL_H_
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+
+#include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+#include "tensorflow/core/framework/tensor_types.h"
+
+namespace tensorflow {
+
+typedef Eigen::SyclDevice SYCLDevice;
+
+namespace functor {
+namespace resize_nearest_neighbor_sycl {
+
+using Index = int;
+
+using read_accessor =
+    cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read,
+                       cl::sycl::access::target::global_buffer>;
+using write_accessor =
+    cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::write,
+                       cl::sycl::access::target::global_buffer>;
+
+// Returns the index scaled_index is mapped to in a dimension of size limit,
+// as computed by the CPU functors.
+template <bool align_corners>
+inline Index NearestIndex(const Index scaled_index, const float scale,
+                          const Index limit) {
+  const float in = scaled_index * scale;
+  return cl::sycl::min(
+      static_cast<Index>(align_corners ? cl::sycl::round(in)
+                                       : cl::sycl::floor(in)),
+      limit - 1);
+}
+
+// Copies one element of the resized image per work item.
+template <typename T, bool align_corners>
+class ResizeNearestNeighborSYCL {
+ public:
+  ResizeNearestNeighborSYCL(read_accessor in, Index in_offset,
+                            write_accessor out, Index out_offset, Index batch,
+                            Index in_height, Index in_width, Index out_height,
+                            Index out_width, Index channels,
+                            float height_scale, float width_scale)
+      : in_accessor_(in),
+        in_offset_(in_offset),
+        out_accessor_(out),
+        out_offset_(out_offset),
+        batch_(batch),
+        in_height_(in_height),
+        in_width_(in_width),
+        out_height_(out_height),
+        out_width_(out_width),
+        channels_(channels),
+        height_scale_(height_scale),
+        width_scale_(width_scale) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const Index index = item.get_global_id(0);
+    if (index >= batch_ * out_height_ * out_width_ * channels_) {
+      return;
+    }
+    const Index c = index % channels_;
+    const Index pixel = index / channels_;
+    const Index x = pixel % out_width_;
+    const Index y = (pixel / out_width_) % out_height_;
+    const Index batch = pixel / (out_width_ * out_height_);
+
+    const Index in_y =
+        NearestIndex<align_corners>(y, height_scale_, in_height_);
+    const Index in_x = NearestIndex<align_corners>(x, width_scale_, in_width_);
+    const T* in = ConvertToActualTypeSycl(T, in_accessor_) + in_offset_;
+    ConvertToActualTypeSycl(T, out_accessor_)[out_offset_ + index] =
+        in[((batch * in_height_ + in_y) * in_width_ + in_x) * channels_ + c];
+  }
+
+ private:
+  const read_accessor in_accessor_;
+  const Index in_offset_;
+  write_accessor out_accessor_;
+  const Index out_offset_;
+  const Index batch_;
+  const Index in_height_;
+  const Index in_width_;
+  const Index out_height_;
+  const Index out_width_;
+  const Index channels_;
+  const float height_scale_;
+  const float width_scale_;
+};
+
+// Returns a range of gradient indices containing all the ones mapped to
+// original_index, whose scaled values are within one of it. The clamping
+// makes the last original index collect all the remaining ones. The range
+// is widened by one on each side against rounding.
+inline void GradRange(const Index original_index, const float scale,
+                      const Index grad_size, const Index original_size,
+                      Index* begin, Index* end) {
+  if (scale <= 0.0f) {
+    *begin = 0;
+    *end = grad_size;
+    return;
+  }
+  *begin = cl::sycl::max(
+      static_cast<Index>((original_index - 1) / scale) - 1, Index(0));
+  *end = original_index == original_size - 1
+             ? grad_size
+             : cl::sycl::min(
+                   static_cast<Index>((original_index + 1) / scale) + 2,
+                   grad_size);
+}
+
+// Computes one element of the gradient with respect to the original image
+// per work item, by summing the gradients of the pixels mapped to it. This
+// gathers instead of scattering like the CPU, so no atomics are needed.
+template <typename T, bool align_corners>
+class ResizeNearestNeighborGradSYCL {
+ public:
+  ResizeNearestNeighborGradSYCL(read_accessor grad, Index grad_offset,
+                                write_accessor out, Index out_offset,
+                                Index batch, Index grad_height,
+                                Index grad_width, Index out_height,
+                                Index out_width, Index channels,
+                                float height_scale, float width_scale)
+      : grad_accessor_(grad),
+        grad_offset_(grad_offset),
+        out_accessor_(out),
+        out_offset_(out_offset),
+        batch_(batch),
+        grad_height_(grad_height),
+        grad_width_(grad_width),
+        out_height_(out_height),
+        out_width_(out_width),
+        channels_(channels),
+        height_scale_(height_scale),
+        width_scale_(width_scale) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const Index index = item.get_global_id(0);
+    if (index >= batch_ * out_height_ * out_width_ * channels_) {
+      return;
+    }
+    const Index c = index % channels_;
+    const Index pixel = index / channels_;
+    const Index out_x = pixel % out_width_;
+    const Index out_y = (pixel / out_width_) % out_height_;
+    const Index batch = pixel / (out_width_ * out_height_);
+
+    Index y_begin, y_end, x_begin, x_end;
+    GradRange(out_y, height_scale_, grad_height_, out_height_, &y_begin,
+              &y_end);
+    GradRange(out_x, width_scale_, grad_width_, out_width_, &x_begin,
+              &x_end);
+
+    const T* grad = ConvertToActualTypeSycl(T, grad_accessor_) +
+                    grad_offset_ +
+                    batch * grad_height_ * grad_width_ * channels_ + c;
+    T sum = T(0);
+    for (Index y = y_begin; y < y_end; ++y) {
+      if (NearestIndex<align_corners>(y, height_scale_, out_height_) !=
+          out_y) {
+        continue;
+      }
+      for (Index x = x_begin; x < x_end; ++x) {
+        if (NearestIndex<align_corners>(x, width_scale_, out_width_) ==
+            out_x) {
+          sum += grad[(y * grad_width_ + x) * channels_];
+        }
+      }
+    }
+    ConvertToActualTypeSycl(T, out_accessor_)[out_offset_ + index] = sum;
+  }
+
+ private:
+  const read_accessor grad_accessor_;
+  const Index grad_offset_;
+  write_accessor out_accessor_;
+  const Index out_offset_;
+  const Index batch_;
+  const Index grad_height_;
+  const Index grad_width_;
+  const Index out_height_;
+  const Index out_width_;
+  const Index channels_;
+  const float height_scale_;
+  const float width_scale_;
+};
+
+template <typename T, template <typename, bool> class Kernel,
+          bool align_corners>
+void Launch(const SYCLDevice& d, typename TTypes<T, 4>::ConstTensor input,
+            const float height_scale, const float width_scale,
+            typename TTypes<T, 4>::Tensor output) {
+  if (output.size() == 0) return;
+  const T* in = input.data();
+  T* out = output.data();
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto in_acc = d.get_sycl_buffer(in).template get_access<mode::read>(cgh);
+    auto out_acc =
+        d.get_sycl_buffer(out).template get_access<mode::write>(cgh);
+    Kernel<T, align_corners> functor(
+        in_acc, d.get_offset(in) / sizeof(T), out_acc,
+        d.get_offset(out) / sizeof(T), input.dimension(0), input.dimension(1),
+        input.dimension(2), output.dimension(1), output.dimension(2),
+        input.dimension(3), height_scale, width_scale);
+    cgh.parallel_for(SYCLUtil::get_nd_range(d, output.size()), functor);
+  });
+}
+
+}  // namespace resize_nearest_neighbor_sycl
+
+// Runs the ResizeNearestNeighbor kernel.
+template <typename T, bool align_corners>
+void LaunchSYCLResizeNearestNeighbor(const SYCLDevice& d,
+                                     typename TTypes<T, 4>::ConstTensor input,
+                                     const float height_scale,
+                                     const float width_scale,
+                                     typename TTypes<T, 4>::Tensor output) {
+  resize_nearest_neighbor_sycl::Launch<
+      T, resize_nearest_neighbor_sycl::ResizeNearestNeighborSYCL,
+      align_corners>(d, input, height_scale, width_scale, output);
+}
+
+// Runs the ResizeNearestNeighborGrad kernel, which writes every element of
+// output so that it does not need to be zeroed first.
+template <typename T, bool align_corners>
+void LaunchSYCLResizeNearestNeighborGrad(
+    const SYCLDevice& d, typename TTypes<T, 4>::ConstTensor input,
+    const float height_scale, const float width_scale,
+    typename TTypes<T, 4>::Tensor output) {
+  resize_nearest_neighbor_sycl::Launch<
+      T, resize_nearest_neighbor_sycl::ResizeNearestNeighborGradSYCL,
+      align_corners>(d, input, height_scale, width_scale, output);
+}
+
+}  // namespace functor
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_RESIZE_NEAREST_NEIGHBOR_OP_SYCL_H_
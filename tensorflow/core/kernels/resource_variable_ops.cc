@@ -447,11 +447,28 @@ class AssignUpdateVariableOp : public OpKernel {
     core::ScopedUnref s(variable);
 
     const Tensor& value = context->input(1);
-    // TODO(apassos): We could possibly avoid the copy done by
-    // PrepareToUpdateVariable() for commutative operations like Op ==
-    // ADD if value's refcount was 1.
     mutex_lock ml(*variable->mu());
     Tensor* var_tensor = variable->tensor();
+    if (Op == ADD && var_tensor->shape().IsSameSize(value.shape())) {
+      // If this is the last user of value, adding the variable into value's
+      // buffer, which then becomes the variable's, costs the same as adding
+      // value into the variable's buffer. But it never has to copy the
+      // variable first when a read still holds its buffer.
+      AllocatorAttributes attr;
+      attr.set_gpu_compatible(true);
+      attr.set_nic_compatible(true);
+      std::unique_ptr<Tensor> value_alias = context->forward_input(
+          1, OpKernelContext::Params::kNoReservation /*output_index*/,
+          value.dtype(), value.shape(), DEVICE_MEMORY, attr);
+      if (value_alias) {
+        functor::DenseUpdate<Device, T, ADD> update_functor;
+        update_functor(context->eigen_device<Device>(),
+                       value_alias->flat<T>(),
+                       const_cast<const Tensor*>(var_tensor)->flat<T>());
+        *var_tensor = *value_alias;
+        return;
+      }
+    }
     OP_REQUIRES_OK(context,
                    PrepareToUpdateVariable<Device, T>(context, var_tensor));
     functor::DenseUpdate<Device, T, Op> update_functor;
@@ -665,7 +682,6 @@ REGISTER_KERNEL_BUILDER(Name("ResourceGather")
   REGISTER_KERNEL_BUILDER(Name("ResourceGather")                       \
                               .Device(DEVICE_SYCL)                     \
                               .HostMemory("resource")                  \
-                              .HostMemory("indices")                   \
                               .TypeConstraint<type>("dtype")           \
                               .TypeConstraint<index_type>("Tindices"), \
                           ResourceGatherOp<SYCLDevice, type, index_type>)
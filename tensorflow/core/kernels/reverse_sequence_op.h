@@ -87,18 +87,21 @@ struct ReverseSequenceKernelSYCL {
     cl::sycl::accessor<Eigen::buffer_scalar_t, 1,
                        cl::sycl::access::mode::read,
                        cl::sycl::access::target::global_buffer>;
-  using dw_acc =
+  using w_acc =
     cl::sycl::accessor<Eigen::buffer_scalar_t, 1,
-                       cl::sycl::access::mode::discard_write,
+                       cl::sycl::access::mode::write,
                        cl::sycl::access::target::global_buffer>;
 
   ReverseSequenceKernelSYCL(int32 batch_dim, int32 seq_dim,
       const Eigen::DSizes<Eigen::DenseIndex, Dims>& coord_dims,
-      r_acc seq_lengths_acc, r_acc input_acc, dw_acc output_acc,
-      const unsigned int size)
+      r_acc seq_lengths_acc, const unsigned int seq_lengths_offset,
+      r_acc input_acc, const unsigned int input_offset, w_acc output_acc,
+      const unsigned int output_offset, const unsigned int size)
     : batch_dim_(batch_dim), seq_dim_(seq_dim),
       coord_dims_(coord_dims), seq_lengths_acc_(seq_lengths_acc),
-      input_acc_(input_acc), output_acc_(output_acc),
+      seq_lengths_offset_(seq_lengths_offset),
+      input_acc_(input_acc), input_offset_(input_offset),
+      output_acc_(output_acc), output_offset_(output_offset),
       size_(size) {}
 
   // Unflatten the indices and return the dimension dim
@@ -113,9 +116,10 @@ struct ReverseSequenceKernelSYCL {
   }
 
   inline void operator()(cl::sycl::nd_item<1> item) {
-    Tlen* seq_lengths = ConvertToActualTypeSycl(Tlen, seq_lengths_acc_);
-    T* input = ConvertToActualTypeSycl(T, input_acc_);
-    T* output = ConvertToActualTypeSycl(T, output_acc_);
+    Tlen* seq_lengths =
+        ConvertToActualTypeSycl(Tlen, seq_lengths_acc_) + seq_lengths_offset_;
+    T* input = ConvertToActualTypeSycl(T, input_acc_) + input_offset_;
+    T* output = ConvertToActualTypeSycl(T, output_acc_) + output_offset_;
     const auto coord = item.get_global_id(0);
     if (coord >= size_)
       return;
@@ -137,8 +141,11 @@ struct ReverseSequenceKernelSYCL {
   int32 seq_dim_;
   Eigen::DSizes<Eigen::DenseIndex, Dims> coord_dims_;
   r_acc seq_lengths_acc_;
+  const unsigned int seq_lengths_offset_;
   r_acc input_acc_;
-  dw_acc output_acc_;
+  const unsigned int input_offset_;
+  w_acc output_acc_;
+  const unsigned int output_offset_;
   const unsigned int size_;
 };
 
@@ -157,10 +164,12 @@ struct ReverseSequence<SYCLDevice, T, Tlen, Dims> {
       auto input_acc = d.get_sycl_buffer(input.data()).
           template get_access<mode::read>(cgh);
       auto output_acc = d.get_sycl_buffer(output.data()).
-          template get_access<mode::discard_write>(cgh);
+          template get_access<mode::write>(cgh);
       ReverseSequenceKernelSYCL<T, Tlen, Dims> kernel(batch_dim, seq_dim,
-          input.dimensions(), seq_lengths_acc, input_acc, output_acc,
-          input.size());
+          input.dimensions(), seq_lengths_acc,
+          d.get_offset(seq_lengths.data()) / sizeof(Tlen), input_acc,
+          d.get_offset(input.data()) / sizeof(T), output_acc,
+          d.get_offset(output.data()) / sizeof(T), input.size());
 
       cl::sycl::nd_range<1> nd_rng = SYCLUtil::get_nd_range(d, input.size());
       cgh.parallel_for(nd_rng, kernel);
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/kernels/save_restore_tensor.h"
+#include <algorithm>
 #include <numeric>
 #include <unordered_map>
 #include <utility>
@@ -28,10 +29,12 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 #include "tensorflow/core/util/tensor_slice_reader.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
 #include "tensorflow/core/util/tensor_slice_writer.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -226,6 +229,42 @@ void RestoreTensor(OpKernelContext* context,
 #undef READER_COPY
 }
 
+namespace {
+
+// Groups of tensors smaller than this are not worth a reader of their own.
+constexpr int64 kMinRestoreGroupBytes = 1 << 24;
+
+// A tensor to restore in RestoreTensorsV2().
+struct RestoreJob {
+  const string* name = nullptr;
+  int index = 0;  // The output index.
+  // The slice to restore, if "is_slice".
+  bool is_slice = false;
+  TensorSlice slice;
+  // The allocated output, or null to let the reader allocate "restored".
+  Tensor* tensor = nullptr;
+  Tensor restored;
+  int64 bytes = 0;
+};
+
+// Restores the tensors of the jobs [begin, end) with "reader".
+Status RunRestoreJobs(BundleReader* reader, RestoreJob* begin,
+                      RestoreJob* end) {
+  for (RestoreJob* job = begin; job != end; ++job) {
+    if (job->tensor == nullptr) {
+      TF_RETURN_IF_ERROR(reader->Lookup(*job->name, &job->restored));
+    } else if (job->is_slice) {
+      TF_RETURN_IF_ERROR(reader->LookupSlice(*job->name, job->slice,
+                                             job->tensor));
+    } else {
+      TF_RETURN_IF_ERROR(reader->Lookup(*job->name, job->tensor));
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
 Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
                         const Tensor& tensor_names,
                         const Tensor& shape_and_slices,
@@ -243,35 +282,56 @@ Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
               return tensor_names_flat(a) < tensor_names_flat(b);
             });
 
-  BundleReader reader(Env::Default(), prefix_string);
+  // Serving processes, which never update the restored tensors, can set
+  // TF_RESTORE_V2_MEMORY_MAP to restore them from the mapped checkpoint files
+  // instead of copies.
+  BundleReader::Options options;
+  TF_RETURN_IF_ERROR(ReadBoolFromEnvVar("TF_RESTORE_V2_MEMORY_MAP", false,
+                                        &options.memory_map));
+  BundleReader reader(Env::Default(), prefix_string, options);
   TF_RETURN_IF_ERROR(reader.status());
 
-  // TODO(zongheng): potential optimization: one Seek() in first lookup.
-  // TODO(zongheng): consider measuring speed and issuing concurrent lookups
-  // within a fixed memory budget.
-  TensorShape restored_full_shape;
-  Tensor* restored_tensor = nullptr;
-  for (auto i : sorted_name_idx) {
+  // Validates the requests and allocates the outputs, in sorted order.
+  std::vector<RestoreJob> jobs(sorted_name_idx.size());
+  int64 total_bytes = 0;
+  for (int k = 0; k < sorted_name_idx.size(); ++k) {
+    const size_t i = sorted_name_idx[k];
     const string& tensor_name = tensor_names_flat(i);
     const string& shape_and_slice = shape_and_slices_flat(i);
+    RestoreJob& job = jobs[k];
+    job.name = &tensor_name;
+    job.index = i;
+
+    DataType restored_dtype;
+    TensorShape restored_full_shape;
+    TF_RETURN_IF_ERROR(reader.LookupDtypeAndShape(
+        tensor_name, &restored_dtype, &restored_full_shape));
+    if (dtypes[i] != restored_dtype) {
+      return errors::InvalidArgument(
+          "tensor_name = ", tensor_name, "; expected dtype ",
+          DataTypeString(dtypes[i]), " does not equal restored dtype ",
+          DataTypeString(restored_dtype));
+    }
 
-    TF_RETURN_IF_ERROR(
-        reader.LookupTensorShape(tensor_name, &restored_full_shape));
-
-    if (shape_and_slice.empty()) {
-      // Lookup the full tensor.
+    TensorShape restored_shape = restored_full_shape;
+    std::vector<TensorSlice> stored_slices;
+    if (shape_and_slice.empty() && options.memory_map) {
       TF_RETURN_IF_ERROR(
-          context->allocate_output(i, restored_full_shape, &restored_tensor));
-      TF_RETURN_IF_ERROR(reader.Lookup(tensor_name, restored_tensor));
+          reader.LookupTensorSlices(tensor_name, &stored_slices));
+    }
+    if (shape_and_slice.empty() && options.memory_map &&
+        stored_slices.empty()) {
+      // Lets the reader allocate the full tensor.
+      job.tensor = nullptr;
+    } else if (shape_and_slice.empty()) {
+      TF_RETURN_IF_ERROR(
+          context->allocate_output(i, restored_full_shape, &job.tensor));
     } else {
-      // Lookup the slice.
       TensorShape parsed_full_shape;
-      TensorSlice parsed_slice;
       TensorShape parsed_slice_shape;
-
       TF_RETURN_IF_ERROR(
           checkpoint::ParseShapeAndSlice(shape_and_slice, &parsed_full_shape,
-                                         &parsed_slice, &parsed_slice_shape));
+                                         &job.slice, &parsed_slice_shape));
       if (!restored_full_shape.IsSameSize(parsed_full_shape)) {
         return errors::InvalidArgument(
             "tensor_name = ", tensor_name, "; shape in shape_and_slice spec ",
@@ -279,18 +339,65 @@ Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
             " does not match the shape stored in checkpoint: ",
             restored_full_shape.DebugString());
       }
-
-      TF_RETURN_IF_ERROR(
-          context->allocate_output(i, parsed_slice_shape, &restored_tensor));
+      job.is_slice = true;
+      restored_shape = parsed_slice_shape;
       TF_RETURN_IF_ERROR(
-          reader.LookupSlice(tensor_name, parsed_slice, restored_tensor));
+          context->allocate_output(i, parsed_slice_shape, &job.tensor));
     }
-    if (dtypes[i] != restored_tensor->dtype()) {
-      return errors::InvalidArgument(
-          "tensor_name = ", tensor_name, "; expected dtype ",
-          DataTypeString(dtypes[i]), " does not equal restored dtype ",
-          DataTypeString(restored_tensor->dtype()));
+    job.bytes = restored_shape.num_elements() *
+                std::max(DataTypeSize(restored_dtype), 1);
+    total_bytes += job.bytes;
+  }
+
+  // Splits the jobs into contiguous groups of about the same size, each read
+  // by its own BundleReader, as readers are not thread-safe. The slices of a
+  // tensor stay in the same group, whose reader then reads the stored slices
+  // they overlap only once.
+  const DeviceBase::CpuWorkerThreads& worker_threads =
+      *context->device()->tensorflow_cpu_worker_threads();
+  const int64 group_bytes = std::max(
+      kMinRestoreGroupBytes, total_bytes / worker_threads.num_threads);
+  std::vector<int> group_starts = {0};
+  int64 bytes = 0;
+  for (int k = 0; k < jobs.size(); ++k) {
+    if (bytes >= group_bytes && *jobs[k].name != *jobs[k - 1].name) {
+      group_starts.push_back(k);
+      bytes = 0;
     }
+    bytes += jobs[k].bytes;
+  }
+  group_starts.push_back(jobs.size());
+  const int num_groups = group_starts.size() - 1;
+
+  std::vector<Status> statuses(num_groups);
+  auto restore_groups = [&](int64 start, int64 limit) {
+    for (int64 g = start; g < limit; ++g) {
+      RestoreJob* const begin = jobs.data() + group_starts[g];
+      RestoreJob* const end = jobs.data() + group_starts[g + 1];
+      if (g == 0) {
+        statuses[g] = RunRestoreJobs(&reader, begin, end);
+        continue;
+      }
+      BundleReader group_reader(Env::Default(), prefix_string, options);
+      statuses[g] = group_reader.status();
+      if (statuses[g].ok()) {
+        statuses[g] = RunRestoreJobs(&group_reader, begin, end);
+      }
+    }
+  };
+  if (num_groups == 1) {
+    restore_groups(0, 1);
+  } else {
+    // Each group is a separate shard.
+    Shard(worker_threads.num_threads, worker_threads.workers, num_groups,
+          group_bytes, restore_groups);
+  }
+  for (const Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+
+  for (const RestoreJob& job : jobs) {
+    if (job.tensor == nullptr) context->set_output(job.index, job.restored);
   }
   return Status::OK();
 }
@@ -15,23 +15,34 @@ limitations under the License.
 
 // See docs in ../ops/io_ops.cc.
 
+#include <algorithm>
+#include <functional>
+#include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/kernels/bounds_check.h"
 #include "tensorflow/core/kernels/save_restore_tensor.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/saved_tensor_slice_util.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 #include "tensorflow/core/util/tensor_slice_reader.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -85,12 +96,247 @@ void ValidateInputs(bool is_save_op, OpKernelContext* context,
   }
 }
 
+// A tensor to save with a BundleWriter, or a slice of one.
+struct SaveItem {
+  string name;
+  Tensor tensor;
+  bool is_slice = false;
+  // The shape of the full tensor and the slice of it, if is_slice.
+  TensorShape full_shape;
+  TensorSlice slice;
+};
+
+Status AddItem(const SaveItem& item, BundleWriter* writer) {
+  if (item.is_slice) {
+    return writer->AddSlice(item.name, item.full_shape, item.slice,
+                            item.tensor);
+  }
+  return writer->Add(item.name, item.tensor);
+}
+
+// Tensors smaller than this are never split across writers, as restoring a
+// tensor saved in slices costs an extra copy.
+constexpr int64 kMinSplitTensorBytes = 1 << 24;
+
+// Splits the full tensors of "items" larger than "max_bytes" along their
+// first dimension into slices, which can be written by different writers.
+void SplitLargeItems(int64 max_bytes, std::vector<SaveItem>* items) {
+  std::vector<SaveItem> split_items;
+  for (SaveItem& item : *items) {
+    const int64 bytes = item.tensor.TotalBytes();
+    if (item.is_slice || item.tensor.dims() == 0 || bytes <= max_bytes ||
+        item.tensor.dim_size(0) < 2) {
+      split_items.push_back(std::move(item));
+      continue;
+    }
+    const int64 rows = item.tensor.dim_size(0);
+    const int64 num_slices =
+        std::min(rows, (bytes + max_bytes - 1) / max_bytes);
+    const int64 rows_per_slice = (rows + num_slices - 1) / num_slices;
+    for (int64 start = 0; start < rows; start += rows_per_slice) {
+      const int64 length = std::min(rows_per_slice, rows - start);
+      SaveItem slice_item;
+      slice_item.name = item.name;
+      slice_item.tensor = item.tensor.Slice(start, start + length);
+      slice_item.is_slice = true;
+      slice_item.full_shape = item.tensor.shape();
+      slice_item.slice = TensorSlice(item.tensor.dims());
+      slice_item.slice.set_start(0, start);
+      slice_item.slice.set_length(0, length);
+      split_items.push_back(std::move(slice_item));
+    }
+  }
+  items->swap(split_items);
+}
+
+// Writes "items" to the bundle "prefix" with "num_writers" BundleWriters
+// running in parallel, each to its own data file, then merges their
+// metadata. The large tensors are split so that each writer gets about the
+// same number of bytes.
+Status SaveInParallel(const string& prefix, int num_writers,
+                      const BundleWriter::Options& options,
+                      std::vector<SaveItem> items) {
+  int64 total_bytes = 0;
+  for (const SaveItem& item : items) total_bytes += item.tensor.TotalBytes();
+  SplitLargeItems(std::max(kMinSplitTensorBytes, total_bytes / num_writers),
+                  &items);
+  num_writers = std::min<int>(num_writers, items.size());
+
+  // Hands the largest remaining item to the least loaded writer.
+  std::vector<int> order(items.size());
+  for (int i = 0; i < items.size(); ++i) order[i] = i;
+  std::sort(order.begin(), order.end(), [&items](int a, int b) {
+    return items[a].tensor.TotalBytes() > items[b].tensor.TotalBytes();
+  });
+  std::vector<std::vector<int>> writer_items(num_writers);
+  // Pairs of the bytes a writer has and its index.
+  typedef std::pair<int64, int> Load;
+  std::priority_queue<Load, std::vector<Load>, std::greater<Load>> loads;
+  for (int w = 0; w < num_writers; ++w) loads.emplace(0, w);
+  for (int i : order) {
+    const Load load = loads.top();
+    loads.pop();
+    writer_items[load.second].push_back(i);
+    loads.emplace(load.first + items[i].tensor.TotalBytes(), load.second);
+  }
+
+  std::vector<string> writer_prefixes(num_writers);
+  std::vector<Status> statuses(num_writers);
+  {
+    // The writers mostly wait on I/O, so they get their own threads rather
+    // than the compute ones.
+    thread::ThreadPool pool(Env::Default(), "save_v2", num_writers);
+    for (int w = 0; w < num_writers; ++w) {
+      writer_prefixes[w] = strings::Printf(
+          "%s_temp_writer-%05d-of-%05d", prefix.c_str(), w, num_writers);
+      pool.Schedule([&, w]() {
+        BundleWriter writer(Env::Default(), writer_prefixes[w], options);
+        statuses[w] = writer.status();
+        for (int i : writer_items[w]) {
+          if (!statuses[w].ok()) return;
+          statuses[w] = AddItem(items[i], &writer);
+        }
+        statuses[w].Update(writer.Finish());
+      });
+    }
+  }
+  for (const Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  return MergeBundles(Env::Default(), writer_prefixes, prefix);
+}
+
+// Writes "items" to the bundle "prefix", in parallel if "num_writers" > 1.
+//
+// With the environment variable TF_SAVE_V2_WRITE_BEHIND_BYTES set, the data
+// files are written on background threads with up to that many bytes
+// buffered, overlapping the serialization of the tensors with the writes.
+Status WriteItems(const string& prefix, int num_writers,
+                  std::vector<SaveItem> items) {
+  BundleWriter::Options options;
+  TF_RETURN_IF_ERROR(ReadInt64FromEnvVar("TF_SAVE_V2_WRITE_BEHIND_BYTES", 0,
+                                         &options.write_behind_bytes));
+  if (num_writers > 1 && !items.empty()) {
+    VLOG(1) << "Saving with " << num_writers
+            << " BundleWriters, prefix_string: " << prefix;
+    return SaveInParallel(prefix, num_writers, options, std::move(items));
+  }
+  BundleWriter writer(Env::Default(), prefix, options);
+  TF_RETURN_IF_ERROR(writer.status());
+  VLOG(1) << "BundleWriter, prefix_string: " << prefix;
+  for (const SaveItem& item : items) {
+    TF_RETURN_IF_ERROR(AddItem(item, &writer));
+  }
+  return writer.Finish();
+}
+
+// Returns the tensors to save of a SaveV2 or AsyncSaveV2 op, whose inputs
+// have been validated.
+Status GetSaveItems(OpKernelContext* context, std::vector<SaveItem>* items) {
+  const int kFixedInputs = 3;  // Prefix, tensor names, shape_and_slices.
+  const auto& tensor_names_flat = context->input(1).flat<string>();
+  const auto& shape_and_slices_flat = context->input(2).flat<string>();
+  const int num_tensors = static_cast<int>(tensor_names_flat.size());
+
+  items->resize(num_tensors);
+  for (int i = 0; i < num_tensors; ++i) {
+    SaveItem& item = (*items)[i];
+    item.name = tensor_names_flat(i);
+    item.tensor = context->input(i + kFixedInputs);
+    const Tensor& tensor = item.tensor;
+
+    if (!shape_and_slices_flat(i).empty()) {
+      const string& shape_spec = shape_and_slices_flat(i);
+      TensorShape shape;
+      TensorSlice slice(tensor.dims());
+      TensorShape slice_shape;
+
+      TF_RETURN_IF_ERROR(checkpoint::ParseShapeAndSlice(shape_spec, &shape,
+                                                        &slice, &slice_shape));
+      if (!slice_shape.IsSameSize(tensor.shape())) {
+        return errors::InvalidArgument(
+            "Slice in shape_and_slice specification does not match the "
+            "shape of the tensor to  save: ",
+            shape_spec, ", tensor: ", tensor.shape().DebugString());
+      }
+
+      item.is_slice = true;
+      item.full_shape = shape;
+      item.slice = slice;
+    }
+  }
+  return Status::OK();
+}
+
+// Writes the snapshots taken by AsyncSaveV2 ops on a background thread, one
+// checkpoint at a time.
+class AsyncCheckpointWriter {
+ public:
+  static AsyncCheckpointWriter* Global() {
+    static AsyncCheckpointWriter* writer = new AsyncCheckpointWriter;
+    return writer;
+  }
+
+  // Waits for the checkpoint in flight to be written, then starts writing
+  // "items" to "prefix". If the previous write failed, returns its error
+  // instead.
+  Status Schedule(const string& prefix, int num_writers,
+                  std::vector<SaveItem> items) {
+    mutex_lock l(mu_);
+    TF_RETURN_IF_ERROR(WaitLocked(&l));
+    saving_ = true;
+    thread_.Schedule([this, prefix, num_writers, items]() {
+      const Status status = WriteItems(prefix, num_writers, items);
+      if (!status.ok()) {
+        LOG(ERROR) << "Failed to save the checkpoint " << prefix << ": "
+                   << status;
+      }
+      {
+        mutex_lock l(mu_);
+        saving_ = false;
+        status_ = status;
+      }
+      saved_.notify_all();
+    });
+    return Status::OK();
+  }
+
+  // Waits for the checkpoint in flight to be written, and returns the error
+  // of the last write, if any.
+  Status Wait() {
+    mutex_lock l(mu_);
+    return WaitLocked(&l);
+  }
+
+ private:
+  AsyncCheckpointWriter() : thread_(Env::Default(), "async_save_v2", 1) {}
+
+  Status WaitLocked(mutex_lock* l) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    while (saving_) saved_.wait(*l);
+    Status status = status_;
+    status_ = Status::OK();
+    return status;
+  }
+
+  mutex mu_;
+  condition_variable saved_;
+  bool saving_ GUARDED_BY(mu_) = false;
+  Status status_ GUARDED_BY(mu_);
+  thread::ThreadPool thread_;
+};
+
 }  // namespace
 
 // Saves a list of named tensors using the tensor bundle library.
+//
+// With the environment variable TF_SAVE_V2_NUM_WRITERS set above 1, the
+// tensors are written by that many threads, each to its own data file.
 class SaveV2 : public OpKernel {
  public:
-  explicit SaveV2(OpKernelConstruction* context) : OpKernel(context) {}
+  explicit SaveV2(OpKernelConstruction* context) : OpKernel(context) {
+    OP_REQUIRES_OK(context, ReadInt64FromEnvVar("TF_SAVE_V2_NUM_WRITERS", 1,
+                                                &num_writers_));
+  }
 
   void Compute(OpKernelContext* context) override {
     const Tensor& prefix = context->input(0);
@@ -98,47 +344,79 @@ class SaveV2 : public OpKernel {
     const Tensor& shape_and_slices = context->input(2);
     ValidateInputs(true /* is save op */, context, prefix, tensor_names,
                    shape_and_slices);
-
-    const int kFixedInputs = 3;  // Prefix, tensor names, shape_and_slices.
-    const int num_tensors = static_cast<int>(tensor_names.NumElements());
+    if (!context->status().ok()) return;
     const string& prefix_string = prefix.scalar<string>()();
-    const auto& tensor_names_flat = tensor_names.flat<string>();
-    const auto& shape_and_slices_flat = shape_and_slices.flat<string>();
-
-    BundleWriter writer(Env::Default(), prefix_string);
-    OP_REQUIRES_OK(context, writer.status());
-    VLOG(1) << "BundleWriter, prefix_string: " << prefix_string;
-
-    for (int i = 0; i < num_tensors; ++i) {
-      const string& tensor_name = tensor_names_flat(i);
-      const Tensor& tensor = context->input(i + kFixedInputs);
-
-      if (!shape_and_slices_flat(i).empty()) {
-        const string& shape_spec = shape_and_slices_flat(i);
-        TensorShape shape;
-        TensorSlice slice(tensor.dims());
-        TensorShape slice_shape;
-
-        OP_REQUIRES_OK(context, checkpoint::ParseShapeAndSlice(
-                                    shape_spec, &shape, &slice, &slice_shape));
-        OP_REQUIRES(context, slice_shape.IsSameSize(tensor.shape()),
-                    errors::InvalidArgument("Slice in shape_and_slice "
-                                            "specification does not match the "
-                                            "shape of the tensor to  save: ",
-                                            shape_spec, ", tensor: ",
-                                            tensor.shape().DebugString()));
-
-        OP_REQUIRES_OK(context,
-                       writer.AddSlice(tensor_name, shape, slice, tensor));
-      } else {
-        OP_REQUIRES_OK(context, writer.Add(tensor_name, tensor));
-      }
-    }
-    OP_REQUIRES_OK(context, writer.Finish());
+
+    std::vector<SaveItem> items;
+    OP_REQUIRES_OK(context, GetSaveItems(context, &items));
+    OP_REQUIRES_OK(context,
+                   WriteItems(prefix_string, static_cast<int>(num_writers_),
+                              std::move(items)));
   }
+
+ private:
+  int64 num_writers_;
 };
 REGISTER_KERNEL_BUILDER(Name("SaveV2").Device(DEVICE_CPU), SaveV2);
 
+// Copies a list of named tensors into host memory, and saves the copies
+// with the tensor bundle library on a background thread.
+class AsyncSaveV2 : public OpKernel {
+ public:
+  explicit AsyncSaveV2(OpKernelConstruction* context) : OpKernel(context) {
+    OP_REQUIRES_OK(context, ReadInt64FromEnvVar("TF_SAVE_V2_NUM_WRITERS", 1,
+                                                &num_writers_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& prefix = context->input(0);
+    const Tensor& tensor_names = context->input(1);
+    const Tensor& shape_and_slices = context->input(2);
+    ValidateInputs(true /* is save op */, context, prefix, tensor_names,
+                   shape_and_slices);
+    if (!context->status().ok()) return;
+    const string& prefix_string = prefix.scalar<string>()();
+
+    std::vector<SaveItem> items;
+    OP_REQUIRES_OK(context, GetSaveItems(context, &items));
+
+    // The inputs may alias variables that the next steps update in place,
+    // so the snapshot copies them.
+    int64 total_bytes = 0;
+    for (const SaveItem& item : items) total_bytes += item.tensor.TotalBytes();
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers, items.size(),
+          items.empty() ? 0 : total_bytes / items.size(),
+          [&items](int64 start, int64 limit) {
+            for (int64 i = start; i < limit; ++i) {
+              items[i].tensor = tensor::DeepCopy(items[i].tensor);
+            }
+          });
+
+    OP_REQUIRES_OK(context, AsyncCheckpointWriter::Global()->Schedule(
+                                prefix_string, static_cast<int>(num_writers_),
+                                std::move(items)));
+  }
+
+ private:
+  int64 num_writers_;
+};
+REGISTER_KERNEL_BUILDER(Name("AsyncSaveV2").Device(DEVICE_CPU), AsyncSaveV2);
+
+// Waits for the checkpoint being written by AsyncSaveV2, if any.
+class AwaitAsyncSaves : public OpKernel {
+ public:
+  explicit AwaitAsyncSaves(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    OP_REQUIRES_OK(context, AsyncCheckpointWriter::Global()->Wait());
+  }
+};
+REGISTER_KERNEL_BUILDER(Name("AwaitAsyncSaves").Device(DEVICE_CPU),
+                        AwaitAsyncSaves);
+
 // Restores a list of named tensors from a tensor bundle (V2 checkpoint format).
 class RestoreV2 : public OpKernel {
  public:
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include <complex>
+#include <cstdlib>
 #include <string>
 
 #include "tensorflow/core/framework/fake_input.h"
@@ -25,9 +26,11 @@ limitations under the License.
 #include "tensorflow/core/kernels/ops_testutil.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/tensor_bundle/naming.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 
 namespace tensorflow {
@@ -339,5 +342,65 @@ TEST_F(SaveV2OpTest, Simple) {
   }
 }
 
+TEST_F(SaveV2OpTest, ParallelWriters) {
+  setenv("TF_SAVE_V2_NUM_WRITERS", "4", 1);
+  TF_ASSERT_OK(NodeDefBuilder("myop", "SaveV2")
+                   .Input(FakeInput())  // prefix
+                   .Input(FakeInput())  // tensor_names
+                   .Input(FakeInput())  // shape_and_slices
+                   .Input(FakeInput({DT_FLOAT, DT_INT32, DT_STRING}))
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  unsetenv("TF_SAVE_V2_NUM_WRITERS");
+
+  const string prefix = io::JoinPath(testing::TmpDir(), "tensor_parallel");
+  const string tensornames[] = {"tensor_large", "tensor_int",
+                                "tensor_string"};
+  AddInput<string>(TensorShape({}),
+                   [&prefix](int x) -> string { return prefix; });
+  AddInput<string>(TensorShape({3}),
+                   [&tensornames](int x) -> string { return tensornames[x]; });
+  AddInput<string>(TensorShape({3}), [](int x) -> string { return ""; });
+  // A 20MB float tensor, split between two writers.
+  const int64 kRows = 5000;
+  AddInput<float>(TensorShape({kRows, 1000}),
+                  [](int x) -> float { return x; });
+  AddInput<int32>(TensorShape({10}), [](int x) -> int32 { return x + 1; });
+  AddInput<string>(TensorShape({3}),
+                   [](int x) -> string { return strings::StrCat("s", x); });
+  TF_ASSERT_OK(RunOpKernel());
+
+  // One data file per writer.
+  for (int i = 0; i < 4; ++i) {
+    TF_EXPECT_OK(Env::Default()->FileExists(DataFilename(prefix, i, 4)));
+  }
+
+  BundleReader reader(Env::Default(), prefix);
+  TF_ASSERT_OK(reader.status());
+  {
+    Tensor val;
+    TF_ASSERT_OK(reader.Lookup("tensor_large", &val));
+    ASSERT_TRUE(val.shape().IsSameSize(TensorShape({kRows, 1000})));
+    const auto flat = val.flat<float>();
+    for (int64 i = 0; i < flat.size(); ++i) {
+      ASSERT_EQ(static_cast<float>(i), flat(i));
+    }
+  }
+  {
+    Tensor val;
+    TF_ASSERT_OK(reader.Lookup("tensor_int", &val));
+    for (int i = 0; i < 10; ++i) {
+      EXPECT_EQ(i + 1, val.flat<int32>()(i));
+    }
+  }
+  {
+    Tensor val;
+    TF_ASSERT_OK(reader.Lookup("tensor_string", &val));
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_EQ(strings::StrCat("s", i), val.flat<string>()(i));
+    }
+  }
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -37,6 +37,7 @@ limitations under the License.
 
 #ifdef TENSORFLOW_USE_SYCL
 #include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+#include "tensorflow/core/kernels/sycl_atomic_utils.h"
 #endif  // TENSORFLOW_USE_SYCL
 
 namespace tensorflow {
@@ -211,14 +212,18 @@ struct ScatterNdKernel {
                          cl::sycl::access::target::global_buffer>;
 
   ScatterNdKernel(
-      const read_accessor indices, const read_accessor updates,
-      write_accessor out,
+      const read_accessor indices, const Index indices_offset,
+      const read_accessor updates, const Index updates_offset,
+      write_accessor out, const Index out_offset,
       const Index batch_size, const Index slice_size,
       const unsigned int out_size,
       const size_t batch_strides[IXDIM])
       : indices_(indices),
+        indices_offset_(indices_offset),
         updates_(updates),
+        updates_offset_(updates_offset),
         out_(out),
+        out_offset_(out_offset),
         batch_size_(batch_size),
         slice_size_(slice_size),
         out_size_(out_size)
@@ -232,9 +237,10 @@ struct ScatterNdKernel {
     if (curr_item >= slice_size_)
       return;
 
-    const T* updates = ConvertToActualTypeSycl(T, updates_);
-    const Index* indices = ConvertToActualTypeSycl(Index, indices_);
-    T* out = ConvertToActualTypeSycl(T, out_);
+    const T* updates = ConvertToActualTypeSycl(T, updates_) + updates_offset_;
+    const Index* indices =
+        ConvertToActualTypeSycl(Index, indices_) + indices_offset_;
+    T* out = ConvertToActualTypeSycl(T, out_) + out_offset_;
 
     auto update_op = LeftUpdateSYCL<decltype(out), T, op>();
 
@@ -254,8 +260,11 @@ struct ScatterNdKernel {
 
  private:
   const read_accessor indices_;
+  const Index indices_offset_;
   const read_accessor updates_;
+  const Index updates_offset_;
   write_accessor out_;
+  const Index out_offset_;
 
   const Index batch_size_;
   const Index slice_size_;
@@ -263,6 +272,130 @@ struct ScatterNdKernel {
   size_t batch_strides_[IXDIM];
 };
 
+// Same as ScatterNdKernel for additions and subtractions of types with
+// atomics, with one work item per updated element instead of one per slice
+// element. Scattering many indices into small slices, as embedding gradients
+// do, is then spread over the whole device.
+template <typename T, typename Index, scatter_nd_op::UpdateOp op, int IXDIM>
+struct ScatterNdAtomicKernel {
+  using read_accessor =
+      cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read,
+                         cl::sycl::access::target::global_buffer>;
+
+  ScatterNdAtomicKernel(
+      const read_accessor indices, const Index indices_offset,
+      const read_accessor updates, const Index updates_offset,
+      sycl_atomic_accessor out, const Index out_offset,
+      const Index batch_size, const Index slice_size,
+      const unsigned int out_size,
+      const size_t batch_strides[IXDIM])
+      : indices_(indices),
+        indices_offset_(indices_offset),
+        updates_(updates),
+        updates_offset_(updates_offset),
+        out_(out),
+        out_offset_(out_offset),
+        batch_size_(batch_size),
+        slice_size_(slice_size),
+        out_size_(out_size) {
+    for (int i = 0; i < IXDIM; ++i) batch_strides_[i] = batch_strides[i];
+  }
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const size_t curr_item = item.get_global_id(0);
+    if (curr_item >= static_cast<size_t>(batch_size_) * slice_size_) return;
+    const size_t idx = curr_item / slice_size_;
+    const size_t slice_item = curr_item - idx * slice_size_;
+
+    const T* updates = ConvertToActualTypeSycl(T, updates_) + updates_offset_;
+    const Index* indices =
+        ConvertToActualTypeSycl(Index, indices_) + indices_offset_;
+
+    size_t update_idx = slice_item;
+    for (int i = 0; i < IXDIM; ++i) {
+      update_idx += indices[(idx * IXDIM) + i] * batch_strides_[i];
+    }
+    if (update_idx < out_size_) {
+      const T value = updates[curr_item];
+      SYCLAtomicAdd(out_, out_offset_ + update_idx,
+                    op == scatter_nd_op::UpdateOp::SUB ? -value : value);
+    }
+  }
+
+ private:
+  const read_accessor indices_;
+  const Index indices_offset_;
+  const read_accessor updates_;
+  const Index updates_offset_;
+  sycl_atomic_accessor out_;
+  const Index out_offset_;
+
+  const Index batch_size_;
+  const Index slice_size_;
+  const unsigned int out_size_;
+  size_t batch_strides_[IXDIM];
+};
+
+template <typename T, typename Index, scatter_nd_op::UpdateOp op, int IXDIM,
+          bool Atomic = op != scatter_nd_op::UpdateOp::ASSIGN &&
+                        SYCLHasAtomicAdd<T>::value>
+struct ScatterNdLauncherSYCL {
+  static void Launch(const SYCLDevice& d, const T* updates,
+                     const Index* indices, T* out, const Index batch_size,
+                     const Index slice_size, const unsigned int out_size,
+                     const size_t batch_strides[IXDIM]) {
+    d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+      using mode = cl::sycl::access::mode;
+      auto indices_acc =
+          d.get_sycl_buffer(indices).template get_access<mode::read>(cgh);
+      auto updates_acc =
+          d.get_sycl_buffer(updates).template get_access<mode::read>(cgh);
+      auto output_acc =
+          d.get_sycl_buffer(out).template get_access<mode::read_write>(cgh);
+
+      cl::sycl::nd_range<1> nd_rng = SYCLUtil::get_nd_range(d, slice_size);
+
+      ScatterNdKernel<T, Index, op, IXDIM> kernel(
+          indices_acc, d.get_offset(indices) / sizeof(Index), updates_acc,
+          d.get_offset(updates) / sizeof(T), output_acc,
+          d.get_offset(out) / sizeof(T), batch_size, slice_size, out_size,
+          batch_strides);
+
+      cgh.parallel_for(nd_rng, kernel);
+    });
+  }
+};
+
+template <typename T, typename Index, scatter_nd_op::UpdateOp op, int IXDIM>
+struct ScatterNdLauncherSYCL<T, Index, op, IXDIM, true> {
+  static void Launch(const SYCLDevice& d, const T* updates,
+                     const Index* indices, T* out, const Index batch_size,
+                     const Index slice_size, const unsigned int out_size,
+                     const size_t batch_strides[IXDIM]) {
+    d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+      using mode = cl::sycl::access::mode;
+      auto indices_acc =
+          d.get_sycl_buffer(indices).template get_access<mode::read>(cgh);
+      auto updates_acc =
+          d.get_sycl_buffer(updates).template get_access<mode::read>(cgh);
+      auto output_acc =
+          GetSYCLAtomicBuffer(d, out).template get_access<mode::atomic>(cgh);
+
+      cl::sycl::nd_range<1> nd_rng =
+          SYCLUtil::get_nd_range(d, static_cast<size_t>(batch_size) *
+                                        static_cast<size_t>(slice_size));
+
+      ScatterNdAtomicKernel<T, Index, op, IXDIM> kernel(
+          indices_acc, d.get_offset(indices) / sizeof(Index), updates_acc,
+          d.get_offset(updates) / sizeof(T), output_acc,
+          d.get_offset(out) / sizeof(uint32_t), batch_size, slice_size,
+          out_size, batch_strides);
+
+      cgh.parallel_for(nd_rng, kernel);
+    });
+  }
+};
+
 // Implementation of update functor for SYCL.
 template <typename T, typename Index, scatter_nd_op::UpdateOp OP, int IXDIM>
 struct ScatterNdFunctor<SYCLDevice, T, Index, OP, IXDIM> {
@@ -275,7 +408,6 @@ struct ScatterNdFunctor<SYCLDevice, T, Index, OP, IXDIM> {
       typename TTypes<T, 2>::Tensor Toutput) {
 
     const Eigen::DenseIndex batch_size = Tindices.dimension(0);
-    const int num_threads = batch_size;
 
     // batch_strides are the number of dimensions in each rank, is used to know
     // how many elements to skip on each rank when accessing indices
@@ -287,25 +419,9 @@ struct ScatterNdFunctor<SYCLDevice, T, Index, OP, IXDIM> {
         batch_strides[dim] *= output_shape_prefix[i];
     }
 
-    d.sycl_queue().submit([&d, Tindices, Tupdates, Toutput, slice_size,
-                           batch_size, batch_strides]
-                           (cl::sycl::handler& cgh) {
-      using mode = cl::sycl::access::mode;
-      auto indices_acc = d.get_sycl_buffer(Tindices.data())
-          .template get_access<mode::read>(cgh);
-      auto updates_acc = d.get_sycl_buffer(Tupdates.data())
-          .template get_access<mode::read>(cgh);
-      auto output_acc = d.get_sycl_buffer(Toutput.data())
-          .template get_access<mode::read_write>(cgh);
-
-      cl::sycl::nd_range<1> nd_rng = SYCLUtil::get_nd_range(d, slice_size);
-
-      ScatterNdKernel<T, Index, OP, IXDIM> kernel(
-          indices_acc, updates_acc, output_acc, batch_size,
-          slice_size, Toutput.size(), batch_strides);
-
-      cgh.parallel_for(nd_rng, kernel);
-    });
+    ScatterNdLauncherSYCL<T, Index, OP, IXDIM>::Launch(
+        d, Tupdates.data(), Tindices.data(), Toutput.data(), batch_size,
+        slice_size, Toutput.size(), batch_strides);
 
     return -1;
   }
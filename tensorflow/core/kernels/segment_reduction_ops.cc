@@ -33,7 +33,9 @@ limitations under the License.
 #include "tensorflow/core/kernels/bounds_check.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/prefetch.h"
 #include "tensorflow/core/util/util.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 #if GOOGLE_CUDA
 #include "tensorflow/core/common_runtime/gpu/gpu_event_mgr.h"
@@ -967,60 +969,75 @@ class SparseSegmentReductionOpBase : public OpKernel {
                 errors::InvalidArgument("segment ids must be >= 0"));
     auto output_flat = output->flat_outer_dims<T>();
 
-    int64 start = 0, end = 1;
-    // Index from which the output is not initialized.
-    OutputRow uninitialized_index = 0;
-    OutputRow out_index = internal::SubtleMustCopy(segment_vec(start));
-
-    while (true) {
-      // We initialize next_index to 0 to avoid "warning: 'next_index' may be
-      // used uninitialized in this function" in the Mac build (since the
-      // compiler isn't smart enough to realize the code is safe).
-      OutputRow next_index = 0;
-      if (end < num_indices) {
-        next_index = internal::SubtleMustCopy(segment_vec(end));
-        if (out_index == next_index) {
-          ++end;
-          continue;
-        }
-        // We have a new segment here.  Verify that the segment ids are growing.
-        OP_REQUIRES(context, out_index < next_index,
+    // Find the segments, each a run of equal segment ids, and check that the
+    // ids are increasing and in range.
+    std::vector<int64> segment_starts;
+    std::vector<OutputRow> segment_rows;
+    for (int64 i = 0; i < num_indices; ++i) {
+      const OutputRow out_index = internal::SubtleMustCopy(segment_vec(i));
+      if (!segment_rows.empty() && segment_rows.back() == out_index) continue;
+      if (!segment_rows.empty()) {
+        OP_REQUIRES(context, segment_rows.back() < out_index,
                     errors::InvalidArgument("segment ids are not increasing"));
       }
-
       OP_REQUIRES(
           context, FastBoundsCheck(out_index, output_rows),
           errors::InvalidArgument(
               "Segment id ", out_index, " out of range [0, ", output_rows,
               "), possibly because 'segment_ids' input is not sorted."));
+      segment_starts.push_back(i);
+      segment_rows.push_back(out_index);
+    }
+    const int64 num_segments = segment_rows.size();
+    segment_starts.push_back(num_indices);
+
+    // Reduce the segments in parallel. Each one also sets the rows of the
+    // missing segment ids before it to the default value, and prefetches the
+    // rows of the next one.
+    mutex mu;
+    int64 bad_index = num_indices;
+    auto work = [&](int64 begin, int64 limit) {
+      for (int64 k = begin; k < limit; ++k) {
+        const OutputRow out_index = segment_rows[k];
+        const OutputRow uninitialized_index =
+            k == 0 ? 0 : segment_rows[k - 1] + 1;
+        if (out_index > uninitialized_index) {
+          Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
+              out_index - uninitialized_index, num_col);
+          Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>,
+                           Eigen::Unaligned>
+              gap_slice(&output_flat(uninitialized_index, 0), gap_slice_shape);
+          gap_slice.setConstant(default_value_);
+        }
+        if (k + 1 < limit) {
+          Prefetch(input_flat, indices_vec, segment_starts[k + 1],
+                   segment_starts[k + 2]);
+        }
 
-      // If there is a gap between two indices, we need to set that gap to the
-      // default value.
-      if (out_index > uninitialized_index) {
-        Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
-            out_index - uninitialized_index, num_col);
-        Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>, Eigen::Unaligned>
-            gap_slice(&output_flat(uninitialized_index, 0), gap_slice_shape);
-        gap_slice.setConstant(default_value_);
+        const int64 start = segment_starts[k];
+        const int64 end = segment_starts[k + 1];
+        auto out = output_flat.template chip<0>(out_index);
+        const int64 bad_offset =
+            Reduce(input_flat, indices_vec, start, end - start, out);
+        if (bad_offset >= 0) {
+          mutex_lock l(mu);
+          bad_index = std::min(bad_index, start + bad_offset);
+        }
       }
-
-      auto out = output_flat.template chip<0>(out_index);
-      const int bad_offset =
-          Reduce(input_flat, indices_vec, start, end - start, out);
-      OP_REQUIRES(context, bad_offset < 0,
-                  errors::InvalidArgument(
-                      "Bad: indices[", start + bad_offset,
-                      "] == ", indices_vec(start + bad_offset),
-                      " out of range [0, ", input_flat.dimension(0), ")"));
-
-      start = end;
-      ++end;
-      uninitialized_index = out_index + 1;
-      out_index = next_index;
-      if (end > num_indices) break;
-    }
+    };
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    const int64 cost_per_segment =
+        (num_indices / num_segments + 1) * num_col * 2;
+    Shard(worker_threads.num_threads, worker_threads.workers, num_segments,
+          cost_per_segment, work);
+    OP_REQUIRES(context, bad_index == num_indices,
+                errors::InvalidArgument(
+                    "Bad: indices[", bad_index, "] == ", indices_vec(bad_index),
+                    " out of range [0, ", input_flat.dimension(0), ")"));
 
     // Fill the gap at the end with the default value.
+    const OutputRow uninitialized_index = segment_rows.back() + 1;
     if (uninitialized_index < output_rows) {
       Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
           output_rows - uninitialized_index, num_col);
@@ -1033,6 +1050,19 @@ class SparseSegmentReductionOpBase : public OpKernel {
  private:
   typedef int32 Index;
 
+  // Prefetches the first cache line of the input rows of indices
+  // [start, end).
+  static void Prefetch(const typename TTypes<T>::ConstMatrix& input_flat,
+                       const typename TTypes<Index>::ConstVec& indices_vec,
+                       int64 start, int64 end) {
+    for (int64 i = start; i < end; ++i) {
+      const Index index = internal::SubtleMustCopy(indices_vec(i));
+      if (FastBoundsCheck(index, input_flat.dimension(0))) {
+        port::prefetch<port::PREFETCH_HINT_T0>(&input_flat(index, 0));
+      }
+    }
+  }
+
   int64 Reduce(const typename TTypes<T>::ConstMatrix& input_flat,
                const typename TTypes<Index>::ConstVec& indices_vec, int64 start,
                int64 num,
@@ -1340,42 +1370,52 @@ class SparseSegmentGradOpBase : public OpKernel {
       }
     }
 
-    auto output_flat = output->flat_outer_dims<T>();
-    output_flat.setZero();
-    std::vector<bool> is_modified(M, false);
-
     for (int64 i = 0; i < N; ++i) {
       const Index output_idx = internal::SubtleMustCopy(indices_vec(i));
       OP_REQUIRES(context, FastBoundsCheck(output_idx, M),
                   errors::InvalidArgument("Index ", output_idx,
                                           " out of range [0, ", M, ")."));
+    }
 
-      const SegmentId idx = internal::SubtleMustCopy(segment_vec(i));
-      OP_REQUIRES(
-          context, FastBoundsCheck(idx, num_segments),
-          errors::InvalidArgument("Segment id ", idx, " out of range [0, ",
-                                  num_segments, ")."));
-
-      const T scale = static_cast<T>(scaling[idx]);
-      if (is_modified[output_idx]) {
-        if (scale == 1.0) {
-          output_flat.template chip<0>(output_idx) +=
-              input_flat.template chip<0>(idx);
-        } else {
-          output_flat.template chip<0>(output_idx) +=
-              input_flat.template chip<0>(idx) * scale;
-        }
-      } else {
-        if (scale == 1.0) {
-          output_flat.template chip<0>(output_idx) =
-              input_flat.template chip<0>(idx);
+    auto output_flat = output->flat_outer_dims<T>();
+    output_flat.setZero();
+    // Not a std::vector<bool>, whose bits can't be set concurrently.
+    std::vector<uint8> is_modified(M, false);
+
+    // Each shard owns a range of output rows, and accumulates the input rows
+    // scattered to them, so that no two shards write the same row.
+    auto work = [&](int64 begin, int64 limit) {
+      for (int64 i = 0; i < N; ++i) {
+        const Index output_idx = internal::SubtleMustCopy(indices_vec(i));
+        if (output_idx < begin || output_idx >= limit) continue;
+        const SegmentId idx = internal::SubtleMustCopy(segment_vec(i));
+        const T scale = static_cast<T>(scaling[idx]);
+        if (is_modified[output_idx]) {
+          if (scale == 1.0) {
+            output_flat.template chip<0>(output_idx) +=
+                input_flat.template chip<0>(idx);
+          } else {
+            output_flat.template chip<0>(output_idx) +=
+                input_flat.template chip<0>(idx) * scale;
+          }
         } else {
-          output_flat.template chip<0>(output_idx) =
-              input_flat.template chip<0>(idx) * scale;
+          if (scale == 1.0) {
+            output_flat.template chip<0>(output_idx) =
+                input_flat.template chip<0>(idx);
+          } else {
+            output_flat.template chip<0>(output_idx) =
+                input_flat.template chip<0>(idx) * scale;
+          }
         }
+        is_modified[output_idx] = true;
       }
-      is_modified[output_idx] = true;
-    }
+    };
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    const int64 num_col = output_flat.dimension(1);
+    const int64 cost_per_row = (N / M + 1) * num_col * 2 + N / M + 1;
+    Shard(worker_threads.num_threads, worker_threads.workers, M, cost_per_row,
+          work);
   }
 
  private:
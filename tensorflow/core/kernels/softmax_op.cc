@@ -25,6 +25,11 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/kernels/softmax_op_functor.h"
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/common_runtime/sycl/sycl_kernel_warmup.h"
+#include "tensorflow/core/kernels/softmax_op_sycl.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
@@ -48,7 +53,16 @@ struct SoftmaxFunctor<CPUDevice, T> : SoftmaxFunctorBase<CPUDevice, T> {};
 
 #ifdef TENSORFLOW_USE_SYCL
 template <typename T>
-struct SoftmaxFunctor<SYCLDevice, T> : SoftmaxFunctorBase<SYCLDevice, T> {};
+struct SoftmaxFunctor<SYCLDevice, T> {
+  void operator()(const SYCLDevice& d, typename TTypes<T>::ConstMatrix logits,
+                  typename TTypes<T>::Matrix softmax, const bool log) {
+    if (softmax_sycl::IsSupported<T>::value) {
+      LaunchSYCLSoftmax<T>(d, logits, softmax, log);
+    } else {
+      SoftmaxEigenImpl<SYCLDevice, T>::Compute(d, logits, softmax, log);
+    }
+  }
+};
 #endif  // TENSORFLOW_USE_SYCL
 }  // namespace functor
 
@@ -104,5 +118,6 @@ TF_CALL_double(REGISTER_CPU);
       SoftmaxOp<SYCLDevice, type>);
 TF_CALL_SYCL_NUMBER_TYPES(REGISTER_SYCL);
 #undef REGISTER_SYCL
+REGISTER_SYCL_KERNEL_WARMUP(functor::softmax_sycl::SoftmaxSYCL<float>);
 #endif  // TENSORFLOW_USE_SYCL
 }  // namespace tensorflow
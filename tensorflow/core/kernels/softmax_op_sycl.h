@@ -0,0 +1,336 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_USE_SYCL
+#error This file must only be included when building TensorFlow with SYCL support
+#endif
+
+#ifndef TENSORFLOW_CORE_KERNELS_SOFTMAX_OP_SYCL_H_
+#define TENSORFLOW_CORE_KERNELS_SOFTMAX_OP_SYCL_H_
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+
+#include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+#include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/kernels/reduction_ops_sycl.h"
+
+namespace tensorflow {
+
+typedef Eigen::SyclDevice SYCLDevice;
+
+namespace functor {
+namespace softmax_sycl {
+
+using reduction_sycl::Index;
+using reduction_sycl::kVectorWidth;
+
+// The fused kernels replace the Eigen expressions for the types below, other
+// types keep using SoftmaxEigenImpl and SparseXentEigenImpl.
+template <typename T>
+struct IsSupported {
+  static constexpr bool value =
+      std::is_same<T, float>::value || std::is_same<T, double>::value;
+};
+
+using read_accessor =
+    cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read,
+                       cl::sycl::access::target::global_buffer>;
+using write_accessor =
+    cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::write,
+                       cl::sycl::access::target::global_buffer>;
+
+template <typename T>
+using local_accessor =
+    cl::sycl::accessor<T, 1, cl::sycl::access::mode::read_write,
+                       cl::sycl::access::target::local>;
+
+// Running maximum and sum of exp(x - max) of the online softmax: adding a
+// new maximum rescales the sum instead of requiring a separate max pass.
+template <typename T>
+inline void Accumulate(T* max, T* sum, const T other_max, const T other_sum) {
+  if (other_max > *max) {
+    *sum = *sum * cl::sycl::exp(*max - other_max) + other_sum;
+    *max = other_max;
+  } else {
+    *sum += other_sum * cl::sycl::exp(other_max - *max);
+  }
+}
+
+// Computes the maximum and the sum of exp(x - max) of a row of cols elements
+// with the whole work-group. Returns the same values to all work items. The
+// work-group size must be a power of two.
+template <typename T>
+inline void RowStatistics(cl::sycl::nd_item<1> item, const T* in,
+                          const Index cols, T* max_scratch, T* sum_scratch,
+                          T* max, T* sum) {
+  const Index local_id = item.get_local_id(0);
+  const Index local_size = item.get_local_range(0);
+
+  T local_max = -std::numeric_limits<T>::infinity();
+  T local_sum = T(0);
+  const Index stride = local_size * kVectorWidth;
+  Index col = local_id * kVectorWidth;
+  for (; col + kVectorWidth <= cols; col += stride) {
+#pragma unroll
+    for (int i = 0; i < kVectorWidth; ++i) {
+      Accumulate(&local_max, &local_sum, in[col + i], T(1));
+    }
+  }
+  for (; col < cols; ++col) {
+    Accumulate(&local_max, &local_sum, in[col], T(1));
+  }
+
+  max_scratch[local_id] = local_max;
+  sum_scratch[local_id] = local_sum;
+  item.barrier(cl::sycl::access::fence_space::local_space);
+  for (Index offset = local_size / 2; offset > 0; offset /= 2) {
+    if (local_id < offset) {
+      Accumulate(&max_scratch[local_id], &sum_scratch[local_id],
+                 max_scratch[local_id + offset],
+                 sum_scratch[local_id + offset]);
+    }
+    item.barrier(cl::sycl::access::fence_space::local_space);
+  }
+  *max = max_scratch[0];
+  *sum = sum_scratch[0];
+}
+
+// Computes the softmax, or log softmax, of each row of a [rows, cols] matrix
+// with one work-group per row. The row is read once to compute its maximum
+// and normalization sum, and once more to write the output, instead of the
+// five passes of SoftmaxEigenImpl.
+template <typename T>
+class SoftmaxSYCL {
+ public:
+  SoftmaxSYCL(read_accessor in, Index in_offset, write_accessor out,
+              Index out_offset, local_accessor<T> max_scratch,
+              local_accessor<T> sum_scratch, Index cols, bool log)
+      : in_accessor_(in),
+        in_offset_(in_offset),
+        out_accessor_(out),
+        out_offset_(out_offset),
+        max_scratch_(max_scratch),
+        sum_scratch_(sum_scratch),
+        cols_(cols),
+        log_(log) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const Index row = item.get_group(0);
+    const Index local_id = item.get_local_id(0);
+    const Index local_size = item.get_local_range(0);
+    const T* in =
+        ConvertToActualTypeSycl(T, in_accessor_) + in_offset_ + row * cols_;
+    T* out =
+        ConvertToActualTypeSycl(T, out_accessor_) + out_offset_ + row * cols_;
+
+    T max;
+    T sum;
+    RowStatistics(item, in, cols_, max_scratch_.get_pointer(),
+                  sum_scratch_.get_pointer(), &max, &sum);
+
+    // Every element is read and written by the same work item, so out may
+    // be the same memory as in.
+    if (log_) {
+      const T log_sum = cl::sycl::log(sum);
+      for (Index col = local_id; col < cols_; col += local_size) {
+        out[col] = in[col] - max - log_sum;
+      }
+    } else {
+      const T inv_sum = T(1) / sum;
+      for (Index col = local_id; col < cols_; col += local_size) {
+        out[col] = cl::sycl::exp(in[col] - max) * inv_sum;
+      }
+    }
+  }
+
+ private:
+  const read_accessor in_accessor_;
+  const Index in_offset_;
+  write_accessor out_accessor_;
+  const Index out_offset_;
+  local_accessor<T> max_scratch_;
+  local_accessor<T> sum_scratch_;
+  const Index cols_;
+  const bool log_;
+};
+
+// Computes the sparse softmax cross entropy loss and its backprop for each
+// row of a [rows, cols] matrix of logits with one work-group per row. As on
+// GPU, invalid labels are not reported but give NaN losses and backprops.
+template <typename T, typename Label>
+class SparseXentSYCL {
+ public:
+  SparseXentSYCL(read_accessor logits, Index logits_offset,
+                 read_accessor labels, Index labels_offset,
+                 write_accessor loss, Index loss_offset,
+                 write_accessor backprop, Index backprop_offset,
+                 local_accessor<T> max_scratch,
+                 local_accessor<T> sum_scratch, Index cols)
+      : logits_accessor_(logits),
+        logits_offset_(logits_offset),
+        labels_accessor_(labels),
+        labels_offset_(labels_offset),
+        loss_accessor_(loss),
+        loss_offset_(loss_offset),
+        backprop_accessor_(backprop),
+        backprop_offset_(backprop_offset),
+        max_scratch_(max_scratch),
+        sum_scratch_(sum_scratch),
+        cols_(cols) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const Index row = item.get_group(0);
+    const Index local_id = item.get_local_id(0);
+    const Index local_size = item.get_local_range(0);
+    const T* logits = ConvertToActualTypeSycl(T, logits_accessor_) +
+                      logits_offset_ + row * cols_;
+    T* backprop = ConvertToActualTypeSycl(T, backprop_accessor_) +
+                  backprop_offset_ + row * cols_;
+    const Label label =
+        ConvertToActualTypeSycl(Label, labels_accessor_)[labels_offset_ + row];
+    const bool valid = label >= 0 && label < cols_;
+
+    // The labelled logit must be read before the barriers of RowStatistics,
+    // once they are passed backprop may already overwrite the logits.
+    T label_logit = T(0);
+    if (local_id == 0 && valid) {
+      label_logit = logits[label];
+    }
+
+    T max;
+    T sum;
+    RowStatistics(item, logits, cols_, max_scratch_.get_pointer(),
+                  sum_scratch_.get_pointer(), &max, &sum);
+    const T log_sum = max + cl::sycl::log(sum);
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+
+    if (local_id == 0) {
+      T* loss = ConvertToActualTypeSycl(T, loss_accessor_) + loss_offset_;
+      loss[row] = valid ? log_sum - label_logit : nan;
+    }
+    for (Index col = local_id; col < cols_; col += local_size) {
+      const T prob = cl::sycl::exp(logits[col] - log_sum);
+      backprop[col] = !valid ? nan : (col == label ? prob - T(1) : prob);
+    }
+  }
+
+ private:
+  const read_accessor logits_accessor_;
+  const Index logits_offset_;
+  const read_accessor labels_accessor_;
+  const Index labels_offset_;
+  write_accessor loss_accessor_;
+  const Index loss_offset_;
+  write_accessor backprop_accessor_;
+  const Index backprop_offset_;
+  local_accessor<T> max_scratch_;
+  local_accessor<T> sum_scratch_;
+  const Index cols_;
+};
+
+// Rows shorter than the default work-group size use smaller work-groups so
+// that most work items still get some columns.
+inline cl::sycl::nd_range<1> RowNdRange(const SYCLDevice& d, Index rows,
+                                        Index cols) {
+  const Index local_size =
+      std::min(reduction_sycl::ReductionWorkGroupSize(d),
+               reduction_sycl::RoundUpToPowerOfTwo(std::max(cols, 1)));
+  return cl::sycl::nd_range<1>(cl::sycl::range<1>(rows * local_size),
+                               cl::sycl::range<1>(local_size));
+}
+
+template <typename T>
+void LaunchSoftmax(const SYCLDevice& d, const T* in, T* out, Index rows,
+                   Index cols, bool log) {
+  const cl::sycl::nd_range<1> range = RowNdRange(d, rows, cols);
+  const size_t local_size = range.get_local_range()[0];
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto in_acc = d.get_sycl_buffer(in).template get_access<mode::read>(cgh);
+    auto out_acc =
+        d.get_sycl_buffer(out).template get_access<mode::write>(cgh);
+    local_accessor<T> max_scratch(cl::sycl::range<1>(local_size), cgh);
+    local_accessor<T> sum_scratch(cl::sycl::range<1>(local_size), cgh);
+    SoftmaxSYCL<T> functor(in_acc, d.get_offset(in) / sizeof(T), out_acc,
+                           d.get_offset(out) / sizeof(T), max_scratch,
+                           sum_scratch, cols, log);
+    cgh.parallel_for(range, functor);
+  });
+}
+
+template <typename T, typename Label>
+void LaunchSparseXent(const SYCLDevice& d, const T* logits,
+                      const Label* labels, T* loss, T* backprop, Index rows,
+                      Index cols) {
+  const cl::sycl::nd_range<1> range = RowNdRange(d, rows, cols);
+  const size_t local_size = range.get_local_range()[0];
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto logits_acc =
+        d.get_sycl_buffer(logits).template get_access<mode::read>(cgh);
+    auto labels_acc =
+        d.get_sycl_buffer(labels).template get_access<mode::read>(cgh);
+    auto loss_acc =
+        d.get_sycl_buffer(loss).template get_access<mode::write>(cgh);
+    auto backprop_acc =
+        d.get_sycl_buffer(backprop).template get_access<mode::write>(cgh);
+    local_accessor<T> max_scratch(cl::sycl::range<1>(local_size), cgh);
+    local_accessor<T> sum_scratch(cl::sycl::range<1>(local_size), cgh);
+    SparseXentSYCL<T, Label> functor(
+        logits_acc, d.get_offset(logits) / sizeof(T), labels_acc,
+        d.get_offset(labels) / sizeof(Label), loss_acc,
+        d.get_offset(loss) / sizeof(T), backprop_acc,
+        d.get_offset(backprop) / sizeof(T), max_scratch, sum_scratch, cols);
+    cgh.parallel_for(range, functor);
+  });
+}
+
+}  // namespace softmax_sycl
+
+// Runs the fused softmax kernel on a [rows, cols] matrix. softmax may be
+// forwarded from logits.
+template <typename T>
+void LaunchSYCLSoftmax(const SYCLDevice& d,
+                       typename TTypes<T>::ConstMatrix logits,
+                       typename TTypes<T>::Matrix softmax, const bool log) {
+  using softmax_sycl::Index;
+  softmax_sycl::LaunchSoftmax<T>(d, logits.data(), softmax.data(),
+                                 static_cast<Index>(logits.dimension(0)),
+                                 static_cast<Index>(logits.dimension(1)), log);
+}
+
+// Runs the fused sparse softmax cross entropy kernel on a [rows, cols]
+// matrix of logits. backprop may be forwarded from logits.
+template <typename T, typename Label>
+void LaunchSYCLSparseXent(const SYCLDevice& d,
+                          typename TTypes<T>::ConstMatrix logits,
+                          typename TTypes<Label>::ConstVec labels,
+                          typename TTypes<T>::Vec loss,
+                          typename TTypes<T>::Matrix backprop) {
+  using softmax_sycl::Index;
+  softmax_sycl::LaunchSparseXent<T, Label>(
+      d, logits.data(), labels.data(), loss.data(), backprop.data(),
+      static_cast<Index>(logits.dimension(0)),
+      static_cast<Index>(logits.dimension(1)));
+}
+
+}  // namespace functor
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_SOFTMAX_OP_SYCL_H_
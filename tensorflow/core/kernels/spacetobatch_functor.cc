@@ -170,17 +170,22 @@ struct S2BKernel {
       cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read_write,
                          cl::sycl::access::target::global_buffer>;
 
-  S2BKernel(read_write_accessor space_tensor_ptr,
+  S2BKernel(read_write_accessor space_tensor_ptr, const int64 space_offset,
             S2BParameters<NUM_BLOCK_DIMS> args,
-            read_write_accessor batch_tensor_ptr, const int64 num_indices)
+            read_write_accessor batch_tensor_ptr, const int64 batch_offset,
+            const int64 num_indices)
       : space_tensor_ptr_(space_tensor_ptr),
+        space_offset_(space_offset),
         batch_tensor_ptr_(batch_tensor_ptr),
+        batch_offset_(batch_offset),
         args_(args),
         num_indices_(num_indices) {}
 
   void operator()(cl::sycl::item<1> id) {
-    T* space_tensor_ptr = ConvertToActualTypeSycl(T, space_tensor_ptr_);
-    T* batch_tensor_ptr = ConvertToActualTypeSycl(T, batch_tensor_ptr_);
+    T* space_tensor_ptr =
+        ConvertToActualTypeSycl(T, space_tensor_ptr_) + space_offset_;
+    T* batch_tensor_ptr =
+        ConvertToActualTypeSycl(T, batch_tensor_ptr_) + batch_offset_;
 
     for (int batch_tensor_idx = 0; batch_tensor_idx < num_indices_;
          batch_tensor_idx++) {
@@ -234,7 +239,9 @@ struct S2BKernel {
     }
   }
   read_write_accessor space_tensor_ptr_;
+  const int64 space_offset_;
   read_write_accessor batch_tensor_ptr_;
+  const int64 batch_offset_;
   S2BParameters<NUM_BLOCK_DIMS> args_;
   const int64 num_indices_;
 };
@@ -289,8 +296,10 @@ struct SpaceToBatchFunctor<SYCLDevice, T, NUM_BLOCK_DIMS, B2S> {
       auto batch_tensor_acc = d.get_sycl_buffer(batch_tensor.data())
           .template get_access<cl::sycl::access::mode::read_write>(cgh);
 
-      S2BKernel<T, NUM_BLOCK_DIMS, B2S> kernel(space_tensor_acc, args,
-                                               batch_tensor_acc, num_threads);
+      S2BKernel<T, NUM_BLOCK_DIMS, B2S> kernel(
+          space_tensor_acc, d.get_offset(space_tensor.data()) / sizeof(T),
+          args, batch_tensor_acc,
+          d.get_offset(batch_tensor.data()) / sizeof(T), num_threads);
 
       cgh.parallel_for(cl::sycl::range<1>(num_threads), kernel);
     });
@@ -24,10 +24,19 @@ limitations under the License.
 #include "tensorflow/core/kernels/bounds_check.h"
 #include "tensorflow/core/kernels/fill_functor.h"
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/common_runtime/sycl/sycl_kernel_warmup.h"
+#include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+#include "tensorflow/core/kernels/sycl_atomic_utils.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
 typedef Eigen::GpuDevice GPUDevice;
+#ifdef TENSORFLOW_USE_SYCL
+typedef Eigen::SyclDevice SYCLDevice;
+#endif  // TENSORFLOW_USE_SYCL
 
 template <typename Device, typename T, typename Tindices>
 class SparseTensorDenseMatMulOp : public OpKernel {
@@ -223,6 +232,26 @@ REGISTER_KERNELS_GPU(float);
 #undef REGISTER_KERNELS_GPU
 #endif  // GOOGLE_CUDA
 
+#ifdef TENSORFLOW_USE_SYCL
+#define REGISTER_SYCL(TypeT, TypeIndex)          \
+  REGISTER_KERNEL_BUILDER(                       \
+      Name("SparseTensorDenseMatMul")            \
+          .Device(DEVICE_SYCL)                   \
+          .TypeConstraint<TypeT>("T")            \
+          .TypeConstraint<TypeIndex>("Tindices") \
+          .HostMemory("a_shape"),                \
+      SparseTensorDenseMatMulOp<SYCLDevice, TypeT, TypeIndex>);
+
+#define REGISTER_KERNELS_SYCL(T) \
+  REGISTER_SYCL(T, int64);       \
+  REGISTER_SYCL(T, int32)
+
+TF_CALL_float(REGISTER_KERNELS_SYCL);
+TF_CALL_SYCL_double(REGISTER_KERNELS_SYCL);
+#undef REGISTER_SYCL
+#undef REGISTER_KERNELS_SYCL
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace functor {
 
 namespace {
@@ -314,6 +343,222 @@ struct SparseTensorDenseMatMulFunctor<CPUDevice, T, Tindices, ADJ_A, ADJ_B> {
   }
 };
 
+#ifdef TENSORFLOW_USE_SYCL
+// Adds a_value * b[k, j] to out[m, j] for every non zero a_value of A at
+// (m, k), with one work item per non zero value and column of the output,
+// as the CUDA kernel does. As there is no way to return an error from the
+// device, out of range rows are skipped and out of range columns give NaN.
+template <typename T, typename Tindices, bool ADJ_A, bool ADJ_B>
+class SparseTensorDenseMatMulAtomicSYCL {
+  using read_accessor =
+      cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read,
+                         cl::sycl::access::target::global_buffer>;
+
+ public:
+  SparseTensorDenseMatMulAtomicSYCL(
+      read_accessor a_indices, size_t a_indices_offset,
+      read_accessor a_values, size_t a_values_offset, read_accessor b,
+      size_t b_offset, sycl_atomic_accessor out, size_t out_offset,
+      int64 nnz, int64 m, int64 b_rows, int64 b_cols, int64 p)
+      : a_indices_(a_indices),
+        a_indices_offset_(a_indices_offset),
+        a_values_(a_values),
+        a_values_offset_(a_values_offset),
+        b_(b),
+        b_offset_(b_offset),
+        out_(out),
+        out_offset_(out_offset),
+        nnz_(nnz),
+        m_(m),
+        b_rows_(b_rows),
+        b_cols_(b_cols),
+        p_(p) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const int64 index = item.get_global_id(0);
+    if (index >= nnz_ * p_) {
+      return;
+    }
+    const Tindices* a_indices =
+        ConvertToActualTypeSycl(Tindices, a_indices_) + a_indices_offset_;
+    const int64 a_ix = index / p_;
+    const int64 j = index - a_ix * p_;
+    const int64 i = a_indices[2 * a_ix + (ADJ_A ? 1 : 0)];
+    const int64 k = a_indices[2 * a_ix + (ADJ_A ? 0 : 1)];
+    const int64 n = ADJ_B ? b_cols_ : b_rows_;
+    if (!FastBoundsCheck(i, m_)) {
+      return;
+    }
+    const size_t out_index = out_offset_ + i * p_ + j;
+    if (!FastBoundsCheck(k, n)) {
+      SYCLAtomicAdd(out_, out_index, std::numeric_limits<T>::quiet_NaN());
+      return;
+    }
+    const T a_value =
+        ConvertToActualTypeSycl(T, a_values_)[a_values_offset_ + a_ix];
+    const T* b = ConvertToActualTypeSycl(T, b_) + b_offset_;
+    const T b_value = b[ADJ_B ? j * b_cols_ + k : k * b_cols_ + j];
+    SYCLAtomicAdd(out_, out_index, a_value * b_value);
+  }
+
+ private:
+  const read_accessor a_indices_;
+  const size_t a_indices_offset_;
+  const read_accessor a_values_;
+  const size_t a_values_offset_;
+  const read_accessor b_;
+  const size_t b_offset_;
+  sycl_atomic_accessor out_;
+  const size_t out_offset_;
+  const int64 nnz_;
+  const int64 m_;
+  const int64 b_rows_;
+  const int64 b_cols_;
+  const int64 p_;
+};
+
+// Fallback for the types without atomics: each work item owns a column of
+// the output and walks through all the non zero values of A.
+template <typename T, typename Tindices, bool ADJ_A, bool ADJ_B>
+class SparseTensorDenseMatMulColumnSYCL {
+  using read_accessor =
+      cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read,
+                         cl::sycl::access::target::global_buffer>;
+  using write_accessor =
+      cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read_write,
+                         cl::sycl::access::target::global_buffer>;
+
+ public:
+  SparseTensorDenseMatMulColumnSYCL(
+      read_accessor a_indices, size_t a_indices_offset,
+      read_accessor a_values, size_t a_values_offset, read_accessor b,
+      size_t b_offset, write_accessor out, size_t out_offset, int64 nnz,
+      int64 m, int64 b_rows, int64 b_cols, int64 p)
+      : a_indices_(a_indices),
+        a_indices_offset_(a_indices_offset),
+        a_values_(a_values),
+        a_values_offset_(a_values_offset),
+        b_(b),
+        b_offset_(b_offset),
+        out_(out),
+        out_offset_(out_offset),
+        nnz_(nnz),
+        m_(m),
+        b_rows_(b_rows),
+        b_cols_(b_cols),
+        p_(p) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const int64 j = item.get_global_id(0);
+    if (j >= p_) {
+      return;
+    }
+    const Tindices* a_indices =
+        ConvertToActualTypeSycl(Tindices, a_indices_) + a_indices_offset_;
+    const T* a_values =
+        ConvertToActualTypeSycl(T, a_values_) + a_values_offset_;
+    const T* b = ConvertToActualTypeSycl(T, b_) + b_offset_;
+    T* out = ConvertToActualTypeSycl(T, out_) + out_offset_;
+    const int64 n = ADJ_B ? b_cols_ : b_rows_;
+    for (int64 a_ix = 0; a_ix < nnz_; ++a_ix) {
+      const int64 i = a_indices[2 * a_ix + (ADJ_A ? 1 : 0)];
+      const int64 k = a_indices[2 * a_ix + (ADJ_A ? 0 : 1)];
+      if (!FastBoundsCheck(i, m_)) {
+        continue;
+      }
+      if (!FastBoundsCheck(k, n)) {
+        out[i * p_ + j] = std::numeric_limits<T>::quiet_NaN();
+        continue;
+      }
+      out[i * p_ + j] +=
+          a_values[a_ix] * b[ADJ_B ? j * b_cols_ + k : k * b_cols_ + j];
+    }
+  }
+
+ private:
+  const read_accessor a_indices_;
+  const size_t a_indices_offset_;
+  const read_accessor a_values_;
+  const size_t a_values_offset_;
+  const read_accessor b_;
+  const size_t b_offset_;
+  write_accessor out_;
+  const size_t out_offset_;
+  const int64 nnz_;
+  const int64 m_;
+  const int64 b_rows_;
+  const int64 b_cols_;
+  const int64 p_;
+};
+
+template <typename T, typename Tindices, bool ADJ_A, bool ADJ_B,
+          bool Atomic = SYCLHasAtomicAdd<T>::value>
+struct LaunchSparseTensorDenseMatMulSYCL {
+  static void Launch(const SYCLDevice& d, T* out, const Tindices* a_indices,
+                     const T* a_values, const T* b, int64 nnz, int64 m,
+                     int64 b_rows, int64 b_cols, int64 p) {
+    d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+      using mode = cl::sycl::access::mode;
+      auto a_indices_acc =
+          d.get_sycl_buffer(a_indices).template get_access<mode::read>(cgh);
+      auto a_values_acc =
+          d.get_sycl_buffer(a_values).template get_access<mode::read>(cgh);
+      auto b_acc = d.get_sycl_buffer(b).template get_access<mode::read>(cgh);
+      auto out_acc =
+          d.get_sycl_buffer(out).template get_access<mode::read_write>(cgh);
+      SparseTensorDenseMatMulColumnSYCL<T, Tindices, ADJ_A, ADJ_B> functor(
+          a_indices_acc, d.get_offset(a_indices) / sizeof(Tindices),
+          a_values_acc, d.get_offset(a_values) / sizeof(T), b_acc,
+          d.get_offset(b) / sizeof(T), out_acc, d.get_offset(out) / sizeof(T),
+          nnz, m, b_rows, b_cols, p);
+      cgh.parallel_for(SYCLUtil::get_nd_range(d, p), functor);
+    });
+  }
+};
+
+template <typename T, typename Tindices, bool ADJ_A, bool ADJ_B>
+struct LaunchSparseTensorDenseMatMulSYCL<T, Tindices, ADJ_A, ADJ_B, true> {
+  static void Launch(const SYCLDevice& d, T* out, const Tindices* a_indices,
+                     const T* a_values, const T* b, int64 nnz, int64 m,
+                     int64 b_rows, int64 b_cols, int64 p) {
+    d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+      using mode = cl::sycl::access::mode;
+      auto a_indices_acc =
+          d.get_sycl_buffer(a_indices).template get_access<mode::read>(cgh);
+      auto a_values_acc =
+          d.get_sycl_buffer(a_values).template get_access<mode::read>(cgh);
+      auto b_acc = d.get_sycl_buffer(b).template get_access<mode::read>(cgh);
+      auto out_acc =
+          GetSYCLAtomicBuffer(d, out).template get_access<mode::atomic>(cgh);
+      SparseTensorDenseMatMulAtomicSYCL<T, Tindices, ADJ_A, ADJ_B> functor(
+          a_indices_acc, d.get_offset(a_indices) / sizeof(Tindices),
+          a_values_acc, d.get_offset(a_values) / sizeof(T), b_acc,
+          d.get_offset(b) / sizeof(T), out_acc,
+          d.get_offset(out) / sizeof(uint32_t), nnz, m, b_rows, b_cols, p);
+      cgh.parallel_for(SYCLUtil::get_nd_range(d, nnz * p), functor);
+    });
+  }
+};
+
+template <typename T, typename Tindices, bool ADJ_A, bool ADJ_B>
+struct SparseTensorDenseMatMulFunctor<SYCLDevice, T, Tindices, ADJ_A, ADJ_B> {
+  static Status Compute(const SYCLDevice& d, typename TTypes<T>::Matrix out,
+                        typename TTypes<Tindices>::ConstMatrix a_indices,
+                        typename TTypes<T>::ConstVec a_values,
+                        typename TTypes<T>::ConstMatrix b) {
+    out.device(d) = out.constant(T(0));
+    LaunchSparseTensorDenseMatMulSYCL<T, Tindices, ADJ_A, ADJ_B>::Launch(
+        d, out.data(), a_indices.data(), a_values.data(), b.data(),
+        a_values.size(), out.dimension(0), b.dimension(0), b.dimension(1),
+        out.dimension(1));
+    return Status::OK();
+  }
+};
+
+REGISTER_SYCL_KERNEL_WARMUP(
+    SparseTensorDenseMatMulAtomicSYCL<float, int64, false, false>);
+#endif  // TENSORFLOW_USE_SYCL
+
 }  // namespace functor
 
 }  // namespace tensorflow
@@ -20,14 +20,22 @@ limitations under the License.
 #include "tensorflow/core/kernels/sparse_xent_op.h"
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_types.h"
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/kernels/softmax_op_sycl.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
 typedef Eigen::GpuDevice GPUDevice;
+#ifdef TENSORFLOW_USE_SYCL
+typedef Eigen::SyclDevice SYCLDevice;
+#endif  // TENSORFLOW_USE_SYCL
 
 template <typename Index>
 Status CheckInvalidLabelIndex(const Tensor& labels, int64 max_index) {
@@ -110,6 +118,20 @@ struct SparseXentFunctor<CPUDevice, T, Index> {
                                                       scratch, loss, backprop);
   }
 };
+
+#ifdef TENSORFLOW_USE_SYCL
+// Uses the fused kernel of softmax_op_sycl.h, which like the GPU kernel
+// does not check the labels on the host but outputs NaN for invalid ones.
+template <typename T, typename Index>
+struct SparseXentFunctor<SYCLDevice, T, Index> {
+  void operator()(const SYCLDevice& d, typename TTypes<T>::ConstMatrix logits,
+                  typename TTypes<Index>::ConstVec labels,
+                  typename TTypes<T>::Vec scratch, typename TTypes<T>::Vec loss,
+                  typename TTypes<T>::Matrix backprop) {
+    LaunchSYCLSparseXent<T, Index>(d, logits, labels, loss, backprop);
+  }
+};
+#endif  // TENSORFLOW_USE_SYCL
 }  // namespace functor
 
 #define REGISTER(Dev, T, Index)                   \
@@ -133,6 +155,15 @@ REGISTER(GPU, Eigen::half, int32)
 REGISTER(GPU, Eigen::half, int64)
 #endif  // GOOGLE_CUDA
 
+#ifdef TENSORFLOW_USE_SYCL
+#define REGISTER_SYCL(T)   \
+  REGISTER(SYCL, T, int32) \
+  REGISTER(SYCL, T, int64)
+TF_CALL_float(REGISTER_SYCL);
+TF_CALL_SYCL_double(REGISTER_SYCL);
+#undef REGISTER_SYCL
+#endif  // TENSORFLOW_USE_SYCL
+
 #undef REGISTER
 
 }  // namespace tensorflow
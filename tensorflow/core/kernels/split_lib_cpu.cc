@@ -17,20 +17,99 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/split_lib.h"
 
+#include <algorithm>
+
 #include "tensorflow/core/framework/numeric_types.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/streaming_copy.h"
 
 namespace tensorflow {
 namespace functor {
 
+namespace {
+
+// Copies the slice of `input` starting at `slice_indices` into `output`, with
+// memcpy. Both are row-major, so the slice is made of runs of contiguous
+// elements, as long as the innermost dimensions that it takes whole.
+template <typename T, int NDims>
+void SplitMemcpy(const Eigen::ThreadPoolDevice& d,
+                 typename TTypes<T, NDims>::Tensor output,
+                 typename TTypes<T, NDims>::ConstTensor input,
+                 const Eigen::DSizes<Eigen::DenseIndex, NDims>& slice_indices,
+                 const Eigen::DSizes<Eigen::DenseIndex, NDims>& slice_sizes) {
+  // Merge the whole innermost dimensions into the runs. The dimensions from
+  // `outer_dims` on make up a run, the ones before it are iterated over.
+  int outer_dims = NDims - 1;
+  int64 run_size = slice_sizes[outer_dims];
+  while (outer_dims > 0 && slice_indices[outer_dims] == 0 &&
+         slice_sizes[outer_dims] == input.dimension(outer_dims)) {
+    --outer_dims;
+    run_size *= slice_sizes[outer_dims];
+  }
+  int64 input_strides[NDims];
+  input_strides[NDims - 1] = 1;
+  for (int i = NDims - 1; i > 0; --i) {
+    input_strides[i - 1] = input_strides[i] * input.dimension(i);
+  }
+
+  const int64 total = output.size();
+  const bool streaming = total * sizeof(T) >= kStreamingCopyMinBytes;
+  T* const out = output.data();
+  const T* const in = input.data();
+  auto copy = [&](int64 start, int64 end) {
+    int64 run = start / run_size;
+    int64 offset = start - run * run_size;
+    while (start < end) {
+      // Find the input position of the run from its index in the output.
+      int64 input_offset =
+          slice_indices[outer_dims] * input_strides[outer_dims];
+      int64 rest = run;
+      for (int i = outer_dims - 1; i >= 0; --i) {
+        input_offset +=
+            (slice_indices[i] + rest % slice_sizes[i]) * input_strides[i];
+        rest /= slice_sizes[i];
+      }
+      const int64 n = std::min(run_size - offset, end - start);
+      if (streaming) {
+        StreamingMemcpy(out + start, in + input_offset + offset,
+                        n * sizeof(T));
+      } else {
+        memcpy(out + start, in + input_offset + offset, n * sizeof(T));
+      }
+      start += n;
+      offset = 0;
+      ++run;
+    }
+    if (streaming) StreamingCopyFence();
+  };
+  if (total < 131072) {
+    copy(0, total);
+    return;
+  }
+  // Split the output on whole cache lines, so that no two threads write to
+  // the same line.
+  const int64 block_size = ElementsPerCacheLine<T>();
+  d.parallelFor((total + block_size - 1) / block_size,
+                Eigen::TensorOpCost(block_size * sizeof(T),
+                                    block_size * sizeof(T), block_size),
+                [&copy, total, block_size](int64 start, int64 end) {
+                  copy(start * block_size, std::min(end * block_size, total));
+                });
+}
+
+}  // namespace
+
 template <typename T, int NDims>
 void Split<Eigen::ThreadPoolDevice, T, NDims>::operator()(
     const Eigen::ThreadPoolDevice& d, typename TTypes<T, NDims>::Tensor output,
     typename TTypes<T, NDims>::ConstTensor input,
     const Eigen::DSizes<Eigen::DenseIndex, NDims>& slice_indices,
     const Eigen::DSizes<Eigen::DenseIndex, NDims>& slice_sizes) {
-  if (output.size() < 131072) {
+  if (DataTypeCanUseMemcpy(DataTypeToEnum<T>::v())) {
+    SplitMemcpy<T, NDims>(d, output, input, slice_indices, slice_sizes);
+  } else if (output.size() < 131072) {
     output = input.slice(slice_indices, slice_sizes);
   } else {
     output.device(d) = input.slice(slice_indices, slice_sizes);
@@ -0,0 +1,99 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_STREAMING_COPY_H_
+#define TENSORFLOW_CORE_KERNELS_STREAMING_COPY_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// The size of a cache line. Parallel copies split their output on multiples
+// of it, so that no two threads write to the same line.
+constexpr int64 kCopyCacheLineBytes = 64;
+
+// Copies whose whole output is at least this large are written with
+// non-temporal stores: the output would not fit in the last level cache
+// anyway, and writing it through the cache would evict the working set of
+// the other ops.
+constexpr int64 kStreamingCopyMinBytes = 1 << 22;
+
+// Returns the number of elements of type T in a cache line, at least 1.
+template <typename T>
+constexpr int64 ElementsPerCacheLine() {
+  return sizeof(T) >= kCopyCacheLineBytes ? 1
+                                          : kCopyCacheLineBytes / sizeof(T);
+}
+
+// Copies n bytes from src to dst like memcpy, but with stores that bypass the
+// caches where the platform has them. The stores are weakly ordered: a thread
+// must call StreamingCopyFence() after its last copy, before the output is
+// read by another thread. Fencing each copy would halve the bandwidth of the
+// many small copies of a concatenation.
+inline void StreamingMemcpy(void* dst, const void* src, size_t n) {
+#ifdef __SSE2__
+  if (n < 4 * kCopyCacheLineBytes) {
+    memcpy(dst, src, n);
+    return;
+  }
+  char* out = static_cast<char*>(dst);
+  const char* in = static_cast<const char*>(src);
+  // Non-temporal stores must be aligned.
+  const size_t head = -reinterpret_cast<uintptr_t>(out) & 15;
+  memcpy(out, in, head);
+  out += head;
+  in += head;
+  n -= head;
+  for (; n >= 64; n -= 64, in += 64, out += 64) {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    const __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16));
+    const __m128i c =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 32));
+    const __m128i d =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 48));
+    _mm_stream_si128(reinterpret_cast<__m128i*>(out), a);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(out + 16), b);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(out + 32), c);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(out + 48), d);
+  }
+  for (; n >= 16; n -= 16, in += 16, out += 16) {
+    _mm_stream_si128(reinterpret_cast<__m128i*>(out),
+                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(in)));
+  }
+  memcpy(out, in, n);
+#else
+  memcpy(dst, src, n);
+#endif
+}
+
+// Orders the stores of the previous StreamingMemcpy() calls of this thread
+// before its later ones.
+inline void StreamingCopyFence() {
+#ifdef __SSE2__
+  _mm_sfence();
+#endif
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_STREAMING_COPY_H_
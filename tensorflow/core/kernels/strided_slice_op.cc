@@ -115,8 +115,6 @@ class StridedSliceOp : public OpKernel {
       return;
     }
 
-// This optimization is currently not applicable for SYCL devices
-#ifndef TENSORFLOW_USE_SYCL
     // Optimization #2, slice is memory contiguous (only occurs in dim 0)
     if (slice_dim0 && IsDim0SliceAligned<T>(input.shape(), begin[0], end[0])) {
       OP_REQUIRES(context, input.dims() >= 1,
@@ -135,7 +133,6 @@ class StridedSliceOp : public OpKernel {
       context->set_output(0, tmp);
       return;
     }
-#endif  // TENSORFLOW_USE_SYCL
 
     Tensor* result = nullptr;
     OP_REQUIRES_OK(context, context->allocate_output(0, final_shape, &result));
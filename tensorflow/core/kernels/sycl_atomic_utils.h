@@ -0,0 +1,78 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_USE_SYCL
+#error This file must only be included when building TensorFlow with SYCL support
+#endif
+
+#ifndef TENSORFLOW_CORE_KERNELS_SYCL_ATOMIC_UTILS_H_
+#define TENSORFLOW_CORE_KERNELS_SYCL_ATOMIC_UTILS_H_
+
+#include <type_traits>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// SYCL 1.2.1 only guarantees 32 bit integer atomics. Kernels scattering
+// other types have to use a fallback that does not need atomics, typically
+// by giving each output element to a single work item.
+template <typename T>
+struct SYCLHasAtomicAdd : std::false_type {};
+template <>
+struct SYCLHasAtomicAdd<float> : std::true_type {};
+template <>
+struct SYCLHasAtomicAdd<int32> : std::true_type {};
+
+using sycl_atomic_accessor =
+    cl::sycl::accessor<uint32_t, 1, cl::sycl::access::mode::atomic,
+                       cl::sycl::access::target::global_buffer>;
+
+// Returns the buffer holding ptr viewed as 32 bit words, on which a
+// sycl_atomic_accessor can be requested. The word offset of ptr in it is
+// d.get_offset(ptr) / sizeof(uint32_t).
+inline cl::sycl::buffer<uint32_t, 1> GetSYCLAtomicBuffer(
+    const Eigen::SyclDevice& d, const void* ptr) {
+  auto buffer = d.get_sycl_buffer(ptr);
+  return buffer.template reinterpret<uint32_t>(
+      cl::sycl::range<1>(buffer.get_size() / sizeof(uint32_t)));
+}
+
+inline void SYCLAtomicAdd(sycl_atomic_accessor acc, size_t index,
+                          const int32 value) {
+  acc[cl::sycl::id<1>(index)].fetch_add(static_cast<uint32_t>(value));
+}
+
+// There is no floating point atomic add, the value is added with a compare
+// and swap loop on its bits instead.
+inline void SYCLAtomicAdd(sycl_atomic_accessor acc, size_t index,
+                          const float value) {
+  union Bits {
+    float f;
+    uint32_t u;
+  };
+  cl::sycl::atomic<uint32_t> word = acc[cl::sycl::id<1>(index)];
+  Bits expected;
+  expected.u = word.load();
+  Bits desired;
+  do {
+    desired.f = expected.f + value;
+  } while (!word.compare_exchange_strong(expected.u, desired.u));
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_SYCL_ATOMIC_UTILS_H_
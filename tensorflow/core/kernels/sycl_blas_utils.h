@@ -20,9 +20,12 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_SYCL_BLAS_UTILS_H_
 #define TENSORFLOW_CORE_KERNELS_SYCL_BLAS_UTILS_H_
 
+#include <memory>
+#include <unordered_map>
 #include <utility>
 #include <thread>
 #include <cstdlib>
+#include <vector>
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 
@@ -51,12 +54,86 @@ inline void SYCLfreeAll(PointerMapper &pMap) {
 #include "sycl_blas.hpp"
 
 #include "tensorflow/core/platform/default/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
 
 namespace tensorflow {
 
 using SYCLBlasPolicy = blas::PolicyHandler<blas::codeplay_policy>;
 using SYCLBlasExecutor = blas::Executor<SYCLBlasPolicy>;
 
+// Pool of objects bound to a SYCL queue that are too expensive to construct
+// on every kernel launch, such as sycl-blas executors and SYCL-DNN backends.
+// An object is used by a single kernel at a time and goes back to the pool
+// once the kernel has been enqueued, so the next launch on the same queue
+// reuses it together with the scratch memory it holds. The pool only grows
+// up to the number of kernels enqueued concurrently on a queue. Queues live
+// as long as the process, so pooled objects are never released.
+template <class Resource>
+class SYCLResourcePool {
+ public:
+  class Handle {
+   public:
+    Handle(SYCLResourcePool* pool, const cl::sycl::queue* queue,
+           std::unique_ptr<Resource> resource)
+        : pool_(pool), queue_(queue), resource_(std::move(resource)) {}
+    Handle(Handle&& other) = default;
+    ~Handle() {
+      if (resource_) {
+        pool_->Release(queue_, std::move(resource_));
+      }
+    }
+
+    Resource& operator*() const { return *resource_; }
+    Resource* operator->() const { return resource_.get(); }
+
+   private:
+    SYCLResourcePool* pool_;
+    const cl::sycl::queue* queue_;
+    std::unique_ptr<Resource> resource_;
+  };
+
+  static SYCLResourcePool* Global() {
+    static SYCLResourcePool* pool = new SYCLResourcePool;
+    return pool;
+  }
+
+  // Returns a free object for `queue`, calling `create` to construct a new
+  // one when they are all in use.
+  template <class Factory>
+  Handle Acquire(const cl::sycl::queue& queue, Factory create) {
+    {
+      mutex_lock lock(mu_);
+      auto& free_list = free_[&queue];
+      if (!free_list.empty()) {
+        std::unique_ptr<Resource> resource = std::move(free_list.back());
+        free_list.pop_back();
+        return Handle(this, &queue, std::move(resource));
+      }
+    }
+    return Handle(this, &queue, std::unique_ptr<Resource>(create()));
+  }
+
+ private:
+  void Release(const cl::sycl::queue* queue,
+               std::unique_ptr<Resource> resource) {
+    mutex_lock lock(mu_);
+    free_[queue].push_back(std::move(resource));
+  }
+
+  mutex mu_;
+  std::unordered_map<const cl::sycl::queue*,
+                     std::vector<std::unique_ptr<Resource>>>
+      free_ GUARDED_BY(mu_);
+};
+
+inline SYCLResourcePool<SYCLBlasExecutor>::Handle AcquireSYCLBlasExecutor(
+    const Eigen::SyclDevice& device) {
+  return SYCLResourcePool<SYCLBlasExecutor>::Global()->Acquire(
+      device.sycl_queue(),
+      [&device] { return new SYCLBlasExecutor(device.sycl_queue()); });
+}
+
 template <class T>
 inline blas::BufferIterator<T, blas::codeplay_policy>
     get_buffer_iterator(const Eigen::SyclDevice& d, const T* ptr) {
@@ -0,0 +1,168 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_USE_SYCL
+#error This file must only be included when building TensorFlow with SYCL support
+#endif
+
+#ifndef TENSORFLOW_CORE_KERNELS_SYCL_CO_EXECUTION_H_
+#define TENSORFLOW_CORE_KERNELS_SYCL_CO_EXECUTION_H_
+
+#include <unordered_map>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+
+#include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+
+// Splits large matrix products between a SYCL device and the CPU threads of
+// the host, when TF_SYCL_CO_EXECUTION is set. This pays off on integrated
+// devices sharing the memory of the host, whose cores are otherwise idle
+// while the device computes.
+//
+// The kernels split the rows, or the batch, of their output. The device
+// computes the first part in place while the host computes the rest on
+// copies of its inputs, which is then copied back into the output. The
+// fraction of the work done on the host is tuned for each queue from the
+// time both sides took for the previous products.
+class SYCLCoExecution {
+ public:
+  // Products with fewer multiply-adds are left to the device alone, as the
+  // copies would cost more than the host saves.
+  static constexpr int64 kMinMultiplyAdds = int64{1} << 27;
+
+  static bool Enabled() {
+    static const bool enabled = [] {
+      bool value = false;
+      TF_CHECK_OK(ReadBoolFromEnvVar("TF_SYCL_CO_EXECUTION", false, &value));
+      return value;
+    }();
+    return enabled;
+  }
+
+  // Returns the split of the products enqueued on `queue`.
+  static SYCLCoExecution* Get(const cl::sycl::queue& queue) {
+    static mutex* mu = new mutex;
+    static auto* splits =
+        new std::unordered_map<const cl::sycl::queue*, SYCLCoExecution*>;
+    mutex_lock lock(*mu);
+    SYCLCoExecution*& split = (*splits)[&queue];
+    if (split == nullptr) {
+      split = new SYCLCoExecution;
+    }
+    return split;
+  }
+
+  // Returns how many of the `rows` rows of a product of `multiply_adds`
+  // multiply-adds should be computed on the host, 0 if it is not split.
+  int64 HostRows(int64 rows, int64 multiply_adds) {
+    if (multiply_adds < kMinMultiplyAdds) {
+      return 0;
+    }
+    mutex_lock lock(mu_);
+    return static_cast<int64>(rows * host_fraction_);
+  }
+
+  // Copies device_tensor to a new host tensor.
+  static Status CopyToHost(OpKernelContext* ctx, const Tensor& device_tensor,
+                           Tensor* host_tensor) {
+    AllocatorAttributes attr;
+    attr.set_on_host(true);
+    attr.set_gpu_compatible(true);
+    TF_RETURN_IF_ERROR(ctx->allocate_temp(
+        device_tensor.dtype(), device_tensor.shape(), host_tensor, attr));
+    SYCLUtil::blockingCopyDeviceTensorToCPU(ctx->eigen_sycl_device(),
+                                            device_tensor, *host_tensor);
+    return Status::OK();
+  }
+
+  // Allocates a host tensor of the shape of device_tensor.
+  static Status AllocateHost(OpKernelContext* ctx, const Tensor& device_tensor,
+                             Tensor* host_tensor) {
+    AllocatorAttributes attr;
+    attr.set_on_host(true);
+    attr.set_gpu_compatible(true);
+    return ctx->allocate_temp(device_tensor.dtype(), device_tensor.shape(),
+                              host_tensor, attr);
+  }
+
+  // Calls enqueue_device_part, which must enqueue the kernels computing the
+  // device_rows rows of the device, then compute_host_part, which computes
+  // the other host_rows rows on the host. Returns once both are done, and
+  // updates the split from the time each took.
+  template <class DevicePart, class HostPart>
+  void Run(const Eigen::SyclDevice& device, int64 device_rows,
+           int64 host_rows, DevicePart enqueue_device_part,
+           HostPart compute_host_part) {
+    const int64 start_us = Env::Default()->NowMicros();
+    enqueue_device_part();
+    compute_host_part();
+    const int64 host_done_us = Env::Default()->NowMicros();
+    device.synchronize();
+    const int64 device_done_us = Env::Default()->NowMicros();
+    Update(device_rows, host_rows, host_done_us - start_us,
+           device_done_us - host_done_us);
+  }
+
+ private:
+  // The host starts with a small part, and always keeps one so that its
+  // throughput is still measured.
+  static constexpr double kInitialHostFraction = 0.25;
+  static constexpr double kMinHostFraction = 1.0 / 16;
+  static constexpr double kMaxHostFraction = 15.0 / 16;
+
+  SYCLCoExecution() : host_fraction_(kInitialHostFraction) {}
+
+  // The device only finished after the host if the wait for it took a
+  // noticeable time, which gives the time it took. Otherwise it was waiting
+  // for the host, by an unknown time, and the host part is shrunk.
+  void Update(int64 device_rows, int64 host_rows, int64 host_us,
+              int64 device_wait_us) {
+    if (device_rows <= 0 || host_rows <= 0 || host_us <= 0) {
+      return;
+    }
+    mutex_lock lock(mu_);
+    double fraction = 0.8 * host_fraction_;
+    if (device_wait_us * 20 > host_us) {
+      const double host_rate = static_cast<double>(host_rows) / host_us;
+      const double device_rate =
+          static_cast<double>(device_rows) / (host_us + device_wait_us);
+      // Averaged with the current split to damp the noise of single runs.
+      fraction = 0.5 * host_fraction_ +
+                 0.5 * host_rate / (host_rate + device_rate);
+    }
+    if (fraction < kMinHostFraction) {
+      fraction = kMinHostFraction;
+    } else if (fraction > kMaxHostFraction) {
+      fraction = kMaxHostFraction;
+    }
+    host_fraction_ = fraction;
+  }
+
+  mutex mu_;
+  double host_fraction_ GUARDED_BY(mu_);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_SYCL_CO_EXECUTION_H_
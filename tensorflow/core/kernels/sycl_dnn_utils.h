@@ -38,10 +38,12 @@ limitations under the License.
 
 namespace tensorflow {
 
-// Backends cannot be copied or moved so they are constructed in a macro
 #if defined(SYCL_SNN_USE_EIGEN_BACKEND)
-#define CREATE_SNN_BACKEND(BACKEND, DEVICE) \
-  sycldnn::backend::EigenBackend BACKEND(DEVICE)
+using SNNBackend = sycldnn::backend::EigenBackend;
+
+inline SNNBackend* NewSNNBackend(const Eigen::SyclDevice& device) {
+  return new SNNBackend(device);
+}
 
 template <class T>
 inline T* get_sycl_dnn_input(const Eigen::SyclDevice&, T* ptr) {
@@ -53,8 +55,11 @@ inline const T* get_sycl_dnn_input(const Eigen::SyclDevice&, const T* ptr) {
   return ptr;
 }
 #else
-#define CREATE_SNN_BACKEND(BACKEND, DEVICE) \
-  sycldnn::backend::SyclBLASBackend BACKEND(DEVICE.sycl_queue())
+using SNNBackend = sycldnn::backend::SyclBLASBackend;
+
+inline SNNBackend* NewSNNBackend(const Eigen::SyclDevice& device) {
+  return new SNNBackend(device.sycl_queue());
+}
 
 template <class T>
 inline blas::BufferIterator<T, blas::codeplay_policy>
@@ -63,6 +68,18 @@ inline blas::BufferIterator<T, blas::codeplay_policy>
 }
 #endif
 
+// Backends cannot be copied or moved, so they are pooled per queue and bound
+// to a reference for the duration of the launch.
+inline SYCLResourcePool<SNNBackend>::Handle AcquireSNNBackend(
+    const Eigen::SyclDevice& device) {
+  return SYCLResourcePool<SNNBackend>::Global()->Acquire(
+      device.sycl_queue(), [&device] { return NewSNNBackend(device); });
+}
+
+#define ACQUIRE_SNN_BACKEND(BACKEND, DEVICE)         \
+  auto BACKEND##_handle = AcquireSNNBackend(DEVICE); \
+  SNNBackend& BACKEND = *BACKEND##_handle
+
 template <class SDStatus>
 inline Status get_sd_err_msg(const SDStatus& s) {
   return errors::Internal("Internal error from SYCL-DNN code " +
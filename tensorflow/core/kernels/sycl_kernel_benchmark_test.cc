@@ -0,0 +1,406 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Benchmarks of the SYCL convolution, pooling, matrix multiplication,
+// reduction and softmax kernels on the layer shapes of ResNet-50, MobileNet,
+// Inception v3 and large vocabulary language models.
+//
+// Forward convolutions are run once with the default SYCL-DNN selector and
+// once for every algorithm the selectors can pick. The items/s column reports
+// FLOP/s and the MB/s column the minimum memory traffic of the op (inputs and
+// output read or written once).
+//
+// Run with:
+//   bazel run -c opt --config=sycl \
+//     //tensorflow/core/kernels:sycl_kernel_benchmarks -- --benchmarks=all
+// Setting TEST_REPORT_FILE_PREFIX writes each result as a BenchmarkEntries
+// proto, suitable to track the kernels across releases and devices.
+
+#ifdef TENSORFLOW_USE_SYCL
+
+#include <stdlib.h>
+
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/graph/default_device.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/public/session.h"
+
+namespace tensorflow {
+namespace {
+
+// Algorithm names understood by TF_SYCL_CONV_ALGORITHM, the empty string
+// selecting the default SYCL-DNN selector.
+const char* const kDefault = "";
+const char* const kDirect = "Direct";
+const char* const kTiled = "Tiled";
+const char* const kIm2col = "Im2col";
+const char* const kWinograd = "Winograd";
+const char* const kMatmul = "Matmul";
+
+Node* RandomConstant(Graph* g, const TensorShape& shape) {
+  Tensor t(DT_FLOAT, shape);
+  t.flat<float>().setRandom();
+  return test::graph::Constant(g, t);
+}
+
+// Runs g once in a session to find out whether the kernels support the
+// configuration, e.g. not every SYCL-DNN algorithm supports every filter size.
+Status CheckSupported(const Graph& g) {
+  GraphDef graph_def;
+  g.ToGraphDef(&graph_def);
+  graph::SetDefaultDevice("/device:SYCL:0", &graph_def);
+  std::unique_ptr<Session> session(NewSession(SessionOptions()));
+  TF_RETURN_IF_ERROR(session->Create(graph_def));
+  std::vector<string> targets;
+  for (const NodeDef& node : graph_def.node()) {
+    if (node.op() != "Const") {
+      targets.push_back(node.name());
+    }
+  }
+  return session->Run({}, {}, targets, nullptr);
+}
+
+void RunBenchmark(int iters, Graph* g, int64 flops, int64 bytes,
+                  const char* algorithm) {
+  testing::StopTiming();
+  setenv("TF_SYCL_CONV_ALGORITHM", algorithm, 1);
+  Status s = CheckSupported(*g);
+  if (!s.ok()) {
+    testing::SetLabel(strings::StrCat("unsupported: ", s.error_message()));
+    delete g;
+    unsetenv("TF_SYCL_CONV_ALGORITHM");
+    return;
+  }
+  testing::ItemsProcessed(static_cast<int64>(iters) * flops);
+  testing::BytesProcessed(static_cast<int64>(iters) * bytes);
+  testing::SetLabel(*algorithm == '\0' ? "default" : algorithm);
+  testing::StartTiming();
+  test::Benchmark("sycl", g).Run(iters);
+  testing::StopTiming();
+  unsetenv("TF_SYCL_CONV_ALGORITHM");
+}
+
+int64 OutputSize(int64 in_size, int64 window, int64 stride,
+                 const string& padding) {
+  return padding == "SAME" ? (in_size + stride - 1) / stride
+                           : (in_size - window + stride) / stride;
+}
+
+void BM_Conv2D(int iters, int batch, int rows, int cols, int in_depth,
+               int out_depth, int filter_rows, int filter_cols, int stride,
+               const string& padding, const char* algorithm) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Node* conv;
+  TF_CHECK_OK(
+      NodeBuilder(g->NewName("conv"), "Conv2D")
+          .Input(RandomConstant(g, {batch, rows, cols, in_depth}))
+          .Input(RandomConstant(g, {filter_rows, filter_cols, in_depth,
+                                    out_depth}))
+          .Attr("T", DT_FLOAT)
+          .Attr("strides", {1, stride, stride, 1})
+          .Attr("padding", padding)
+          .Finalize(g, &conv));
+  const int64 out_rows = OutputSize(rows, filter_rows, stride, padding);
+  const int64 out_cols = OutputSize(cols, filter_cols, stride, padding);
+  const int64 out_size = batch * out_rows * out_cols * out_depth;
+  const int64 flops = 2 * out_size * filter_rows * filter_cols * in_depth;
+  const int64 bytes =
+      sizeof(float) * (batch * rows * cols * in_depth +
+                       filter_rows * filter_cols * in_depth * out_depth +
+                       out_size);
+  RunBenchmark(iters, g, flops, bytes, algorithm);
+}
+
+void BM_DepthwiseConv2D(int iters, int batch, int rows, int cols, int depth,
+                        int filter_size, int stride) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Node* conv;
+  TF_CHECK_OK(
+      NodeBuilder(g->NewName("depthwise"), "DepthwiseConv2dNative")
+          .Input(RandomConstant(g, {batch, rows, cols, depth}))
+          .Input(RandomConstant(g, {filter_size, filter_size, depth, 1}))
+          .Attr("T", DT_FLOAT)
+          .Attr("strides", {1, stride, stride, 1})
+          .Attr("padding", "SAME")
+          .Finalize(g, &conv));
+  const int64 out_size = batch * OutputSize(rows, filter_size, stride, "SAME") *
+                         OutputSize(cols, filter_size, stride, "SAME") * depth;
+  const int64 flops = 2 * out_size * filter_size * filter_size;
+  const int64 bytes =
+      sizeof(float) * (batch * rows * cols * depth +
+                       filter_size * filter_size * depth + out_size);
+  RunBenchmark(iters, g, flops, bytes, kDefault);
+}
+
+void BM_Pool(int iters, const string& op, int batch, int rows, int cols,
+             int depth, int window, int stride, const string& padding) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Node* pool;
+  TF_CHECK_OK(NodeBuilder(g->NewName("pool"), op)
+                  .Input(RandomConstant(g, {batch, rows, cols, depth}))
+                  .Attr("T", DT_FLOAT)
+                  .Attr("ksize", {1, window, window, 1})
+                  .Attr("strides", {1, stride, stride, 1})
+                  .Attr("padding", padding)
+                  .Finalize(g, &pool));
+  const int64 out_size = batch * OutputSize(rows, window, stride, padding) *
+                         OutputSize(cols, window, stride, padding) * depth;
+  const int64 flops = out_size * window * window;
+  const int64 bytes = sizeof(float) * (batch * rows * cols * depth + out_size);
+  RunBenchmark(iters, g, flops, bytes, kDefault);
+}
+
+void BM_Pool3D(int iters, const string& op, int batch, int planes, int rows,
+               int cols, int depth, int window, int stride) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Node* pool;
+  TF_CHECK_OK(
+      NodeBuilder(g->NewName("pool3d"), op)
+          .Input(RandomConstant(g, {batch, planes, rows, cols, depth}))
+          .Attr("T", DT_FLOAT)
+          .Attr("ksize", {1, window, window, window, 1})
+          .Attr("strides", {1, stride, stride, stride, 1})
+          .Attr("padding", "VALID")
+          .Finalize(g, &pool));
+  const int64 out_size = batch * OutputSize(planes, window, stride, "VALID") *
+                         OutputSize(rows, window, stride, "VALID") *
+                         OutputSize(cols, window, stride, "VALID") * depth;
+  const int64 flops = out_size * window * window * window;
+  const int64 bytes =
+      sizeof(float) * (batch * planes * rows * cols * depth + out_size);
+  RunBenchmark(iters, g, flops, bytes, kDefault);
+}
+
+void BM_MatMul(int iters, int m, int k, int n) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Node* matmul;
+  TF_CHECK_OK(NodeBuilder(g->NewName("matmul"), "MatMul")
+                  .Input(RandomConstant(g, {m, k}))
+                  .Input(RandomConstant(g, {k, n}))
+                  .Attr("T", DT_FLOAT)
+                  .Attr("transpose_a", false)
+                  .Attr("transpose_b", false)
+                  .Finalize(g, &matmul));
+  const int64 flops = 2LL * m * k * n;
+  const int64 bytes = sizeof(float) * (1LL * m * k + 1LL * k * n + 1LL * m * n);
+  RunBenchmark(iters, g, flops, bytes, kDefault);
+}
+
+void BM_BatchMatMul(int iters, int batch, int m, int k, int n, bool adj_y) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Node* matmul;
+  TF_CHECK_OK(NodeBuilder(g->NewName("batch_matmul"), "BatchMatMul")
+                  .Input(RandomConstant(g, {batch, m, k}))
+                  .Input(RandomConstant(g, adj_y ? TensorShape({batch, n, k})
+                                                 : TensorShape({batch, k, n})))
+                  .Attr("T", DT_FLOAT)
+                  .Attr("adj_x", false)
+                  .Attr("adj_y", adj_y)
+                  .Finalize(g, &matmul));
+  const int64 flops = 2LL * batch * m * k * n;
+  const int64 bytes = sizeof(float) * batch *
+                      (1LL * m * k + 1LL * k * n + 1LL * m * n);
+  RunBenchmark(iters, g, flops, bytes, kDefault);
+}
+
+// Reduces a [rows, cols] matrix along the given axes.
+void BM_Reduction(int iters, const string& op, int rows, int cols,
+                  const std::vector<int32>& axes) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor axes_tensor(DT_INT32, TensorShape({static_cast<int64>(axes.size())}));
+  for (size_t i = 0; i < axes.size(); ++i) {
+    axes_tensor.vec<int32>()(i) = axes[i];
+  }
+  Node* reduction;
+  TF_CHECK_OK(NodeBuilder(g->NewName("reduction"), op)
+                  .Input(RandomConstant(g, {rows, cols}))
+                  .Input(test::graph::Constant(g, axes_tensor))
+                  .Attr("T", DT_FLOAT)
+                  .Attr("keep_dims", false)
+                  .Finalize(g, &reduction));
+  const int64 size = 1LL * rows * cols;
+  RunBenchmark(iters, g, size, sizeof(float) * size, kDefault);
+}
+
+// Softmax and LogSoftmax read the logits and write the output.
+void BM_Softmax(int iters, const string& op, int rows, int cols) {
+  Graph* g = new Graph(OpRegistry::Global());
+  test::graph::Unary(g, op, RandomConstant(g, {rows, cols}));
+  const int64 size = 1LL * rows * cols;
+  RunBenchmark(iters, g, size, 2 * sizeof(float) * size, kDefault);
+}
+
+// SparseSoftmaxCrossEntropyWithLogits reads the logits and writes the
+// backprop, the labels and the loss being negligible.
+void BM_SparseXent(int iters, int rows, int cols) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor labels(DT_INT32, TensorShape({rows}));
+  for (int i = 0; i < rows; ++i) {
+    labels.vec<int32>()(i) = (i * 7919) % cols;
+  }
+  Node* xent;
+  TF_CHECK_OK(NodeBuilder(g->NewName("xent"),
+                          "SparseSoftmaxCrossEntropyWithLogits")
+                  .Input(RandomConstant(g, {rows, cols}))
+                  .Input(test::graph::Constant(g, labels))
+                  .Attr("T", DT_FLOAT)
+                  .Attr("Tlabels", DT_INT32)
+                  .Finalize(g, &xent));
+  const int64 size = 1LL * rows * cols;
+  RunBenchmark(iters, g, size, 2 * sizeof(float) * size, kDefault);
+}
+
+}  // namespace
+
+#define BM_Conv2DAlgo(NAME, ALGO, B, R, C, ID, OD, KR, KC, S, PAD)        \
+  static void BM_SYCL_Conv2D_##NAME##_##ALGO(int iters) {                 \
+    BM_Conv2D(iters, B, R, C, ID, OD, KR, KC, S, #PAD, k##ALGO);          \
+  }                                                                       \
+  BENCHMARK(BM_SYCL_Conv2D_##NAME##_##ALGO)
+
+#define BM_Conv2DAllAlgos(NAME, B, R, C, ID, OD, KR, KC, S, PAD)          \
+  BM_Conv2DAlgo(NAME, Default, B, R, C, ID, OD, KR, KC, S, PAD);          \
+  BM_Conv2DAlgo(NAME, Direct, B, R, C, ID, OD, KR, KC, S, PAD);           \
+  BM_Conv2DAlgo(NAME, Tiled, B, R, C, ID, OD, KR, KC, S, PAD);            \
+  BM_Conv2DAlgo(NAME, Im2col, B, R, C, ID, OD, KR, KC, S, PAD);           \
+  BM_Conv2DAlgo(NAME, Winograd, B, R, C, ID, OD, KR, KC, S, PAD);         \
+  BM_Conv2DAlgo(NAME, Matmul, B, R, C, ID, OD, KR, KC, S, PAD)
+
+// ResNet-50.
+BM_Conv2DAllAlgos(resnet_conv1, 16, 224, 224, 3, 64, 7, 7, 2, SAME);
+BM_Conv2DAllAlgos(resnet_2a_1x1, 16, 56, 56, 64, 64, 1, 1, 1, SAME);
+BM_Conv2DAllAlgos(resnet_2a_3x3, 16, 56, 56, 64, 64, 3, 3, 1, SAME);
+BM_Conv2DAllAlgos(resnet_2a_expand, 16, 56, 56, 64, 256, 1, 1, 1, SAME);
+BM_Conv2DAllAlgos(resnet_3a_3x3, 16, 28, 28, 128, 128, 3, 3, 1, SAME);
+BM_Conv2DAllAlgos(resnet_4a_3x3, 16, 14, 14, 256, 256, 3, 3, 1, SAME);
+BM_Conv2DAllAlgos(resnet_5a_3x3, 16, 7, 7, 512, 512, 3, 3, 1, SAME);
+BM_Conv2DAllAlgos(resnet_5a_reduce, 16, 7, 7, 2048, 512, 1, 1, 1, SAME);
+
+// MobileNet v1 pointwise convolutions.
+BM_Conv2DAllAlgos(mobilenet_conv1, 16, 224, 224, 3, 32, 3, 3, 2, SAME);
+BM_Conv2DAllAlgos(mobilenet_pw1, 16, 112, 112, 32, 64, 1, 1, 1, SAME);
+BM_Conv2DAllAlgos(mobilenet_pw6, 16, 14, 14, 512, 512, 1, 1, 1, SAME);
+BM_Conv2DAllAlgos(mobilenet_pw13, 16, 7, 7, 1024, 1024, 1, 1, 1, SAME);
+
+// Inception v3.
+BM_Conv2DAllAlgos(inception_5b_1x1, 16, 35, 35, 192, 64, 1, 1, 1, SAME);
+BM_Conv2DAllAlgos(inception_5b_5x5, 16, 35, 35, 48, 64, 5, 5, 1, SAME);
+BM_Conv2DAllAlgos(inception_6b_1x7, 16, 17, 17, 128, 128, 1, 7, 1, SAME);
+BM_Conv2DAllAlgos(inception_6b_7x1, 16, 17, 17, 128, 192, 7, 1, 1, SAME);
+BM_Conv2DAllAlgos(inception_7a_3x3, 16, 17, 17, 192, 320, 3, 3, 2, VALID);
+
+#define BM_DepthwiseShape(NAME, B, R, C, D, K, S)                 \
+  static void BM_SYCL_DepthwiseConv2D_##NAME(int iters) {         \
+    BM_DepthwiseConv2D(iters, B, R, C, D, K, S);                  \
+  }                                                               \
+  BENCHMARK(BM_SYCL_DepthwiseConv2D_##NAME)
+
+// MobileNet v1 depthwise convolutions.
+BM_DepthwiseShape(mobilenet_dw1, 16, 112, 112, 32, 3, 1);
+BM_DepthwiseShape(mobilenet_dw2, 16, 112, 112, 64, 3, 2);
+BM_DepthwiseShape(mobilenet_dw6, 16, 14, 14, 512, 3, 1);
+BM_DepthwiseShape(mobilenet_dw13, 16, 7, 7, 1024, 3, 1);
+
+#define BM_PoolShape(OP, NAME, B, R, C, D, K, S, PAD)             \
+  static void BM_SYCL_##OP##_##NAME(int iters) {                  \
+    BM_Pool(iters, #OP, B, R, C, D, K, S, #PAD);                  \
+  }                                                               \
+  BENCHMARK(BM_SYCL_##OP##_##NAME)
+
+BM_PoolShape(MaxPool, resnet_pool1, 16, 112, 112, 64, 3, 2, SAME);
+BM_PoolShape(AvgPool, resnet_pool5, 16, 7, 7, 2048, 7, 1, VALID);
+BM_PoolShape(MaxPool, inception_pool1, 16, 147, 147, 64, 3, 2, VALID);
+BM_PoolShape(MaxPool, inception_6a_pool, 16, 35, 35, 288, 3, 2, VALID);
+BM_PoolShape(AvgPool, inception_5b_pool, 16, 35, 35, 192, 3, 1, SAME);
+BM_PoolShape(AvgPool, mobilenet_pool, 16, 7, 7, 1024, 7, 1, VALID);
+
+#define BM_Pool3DShape(OP, NAME, B, P, R, C, D, K, S)             \
+  static void BM_SYCL_##OP##_##NAME(int iters) {                  \
+    BM_Pool3D(iters, #OP, B, P, R, C, D, K, S);                   \
+  }                                                               \
+  BENCHMARK(BM_SYCL_##OP##_##NAME)
+
+// C3D style video models.
+BM_Pool3DShape(MaxPool3D, c3d_pool2, 8, 16, 56, 56, 128, 2, 2);
+BM_Pool3DShape(AvgPool3D, c3d_pool2, 8, 16, 56, 56, 128, 2, 2);
+
+#define BM_MatMulShape(NAME, M, K, N)                             \
+  static void BM_SYCL_MatMul_##NAME(int iters) {                  \
+    BM_MatMul(iters, M, K, N);                                    \
+  }                                                               \
+  BENCHMARK(BM_SYCL_MatMul_##NAME)
+
+BM_MatMulShape(resnet_fc, 16, 2048, 1000);
+BM_MatMulShape(mobilenet_fc, 16, 1024, 1000);
+BM_MatMulShape(inception_fc, 16, 2048, 1001);
+BM_MatMulShape(square_1024, 1024, 1024, 1024);
+BM_MatMulShape(square_4096, 4096, 4096, 4096);
+
+#define BM_BatchMatMulShape(NAME, B, M, K, N, ADJ_Y)              \
+  static void BM_SYCL_BatchMatMul_##NAME(int iters) {             \
+    BM_BatchMatMul(iters, B, M, K, N, ADJ_Y);                     \
+  }                                                               \
+  BENCHMARK(BM_SYCL_BatchMatMul_##NAME)
+
+// Transformer attention with batch 64 and 8 heads: Q * K^T, then scores * V.
+BM_BatchMatMulShape(attention_qk, 512, 128, 64, 128, true);
+BM_BatchMatMulShape(attention_v, 512, 128, 128, 64, false);
+BM_BatchMatMulShape(square_256, 16, 256, 256, 256, false);
+
+#define BM_ReductionShape(OP, NAME, R, C, ...)                    \
+  static void BM_SYCL_##OP##_##NAME(int iters) {                  \
+    BM_Reduction(iters, #OP, R, C, {__VA_ARGS__});                \
+  }                                                               \
+  BENCHMARK(BM_SYCL_##OP##_##NAME)
+
+// Batch norm statistics over N * H * W for 256 channels, softmax over 1000
+// classes, and a loss reduced to a scalar.
+BM_ReductionShape(Mean, batch_norm_stats, 16 * 56 * 56, 256, 0);
+BM_ReductionShape(Sum, softmax_rows, 512, 1000, 1);
+BM_ReductionShape(Max, softmax_rows, 512, 1000, 1);
+BM_ReductionShape(Sum, long_rows, 8, 1 << 20, 1);
+BM_ReductionShape(Sum, full, 4096, 4096, 0, 1);
+
+#define BM_SoftmaxShape(OP, NAME, R, C)          \
+  static void BM_SYCL_##OP##_##NAME(int iters) { \
+    BM_Softmax(iters, #OP, R, C);                \
+  }                                              \
+  BENCHMARK(BM_SYCL_##OP##_##NAME)
+
+#define BM_SparseXentShape(NAME, R, C)                              \
+  static void BM_SYCL_SparseSoftmaxCrossEntropy_##NAME(int iters) { \
+    BM_SparseXent(iters, R, C);                                     \
+  }                                                                 \
+  BENCHMARK(BM_SYCL_SparseSoftmaxCrossEntropy_##NAME)
+
+// ImageNet classifiers over 1000 classes, and language models over vocabularies
+// of 32k and 256k words.
+BM_SoftmaxShape(Softmax, imagenet, 512, 1000);
+BM_SoftmaxShape(Softmax, vocab_32k, 256, 32768);
+BM_SoftmaxShape(LogSoftmax, vocab_32k, 256, 32768);
+BM_SoftmaxShape(Softmax, vocab_256k, 64, 262144);
+BM_SparseXentShape(imagenet, 512, 1000);
+BM_SparseXentShape(vocab_32k, 256, 32768);
+BM_SparseXentShape(vocab_256k, 64, 262144);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_USE_SYCL
@@ -106,18 +106,21 @@ struct TileSYCL {
   using stride_read_accessor =
       cl::sycl::accessor<int64, 2, cl::sycl::access::mode::read,
                          cl::sycl::access::target::global_buffer>;
-  TileSYCL(int ndims, const read_accessor input,
+  TileSYCL(int ndims, const read_accessor input, const size_t input_offset,
            const stride_read_accessor strides, write_accessor output,
-           const unsigned int size)
+           const size_t output_offset, const unsigned int size)
       : ndims_(ndims),
         input_accessor_(input),
+        input_offset_(input_offset),
         stride_accessor_(strides),
         output_accessor_(output),
+        output_offset_(output_offset),
         size_(size) {}
 
   void operator()(cl::sycl::nd_item<1> id) {
-    const T* input = ConvertToActualTypeSycl(T, input_accessor_);
-    T* output = ConvertToActualTypeSycl(T, output_accessor_);
+    const T* input = ConvertToActualTypeSycl(T, input_accessor_) +
+                     input_offset_;
+    T* output = ConvertToActualTypeSycl(T, output_accessor_) + output_offset_;
 
     const size_t item_id = id.get_global_id(0);
     if (item_id >= size_)
@@ -136,8 +139,10 @@ struct TileSYCL {
  private:
   const int ndims_;
   const read_accessor input_accessor_;
+  const size_t input_offset_;
   const stride_read_accessor stride_accessor_;
   write_accessor output_accessor_;
+  const size_t output_offset_;
   const unsigned int size_;
 };
 
@@ -145,8 +150,10 @@ template <typename T>
 struct TileFunctor<SYCLDevice, T> {
   void operator()(const SYCLDevice& d, Tensor* out, const Tensor& in) {
     d.sycl_queue().submit([&d, in, out](cl::sycl::handler& cgh) {
-      auto input_buffer = d.get_sycl_buffer(in.template flat<T>().data());
-      auto output_buffer = d.get_sycl_buffer(out->template flat<T>().data());
+      const T* in_ptr = in.template flat<T>().data();
+      T* out_ptr = out->template flat<T>().data();
+      auto input_buffer = d.get_sycl_buffer(in_ptr);
+      auto output_buffer = d.get_sycl_buffer(out_ptr);
       const int ndims = in.dims();
       const int64 nelem = out->NumElements();
       gtl::InlinedVector<int64, 8> in_strides =
@@ -169,7 +176,9 @@ struct TileFunctor<SYCLDevice, T> {
       auto input_acc = input_buffer.template get_access<mode::read>(cgh);
       auto stride_acc = stride_buffer.template get_access<mode::read>(cgh);
       auto output_acc = output_buffer.template get_access<mode::write>(cgh);
-      TileSYCL<T> functor(ndims, input_acc, stride_acc, output_acc, nelem);
+      TileSYCL<T> functor(ndims, input_acc, d.get_offset(in_ptr) / sizeof(T),
+                          stride_acc, output_acc,
+                          d.get_offset(out_ptr) / sizeof(T), nelem);
 
       cl::sycl::nd_range<1> nd_rng = SYCLUtil::get_nd_range(d, nelem);
       cgh.parallel_for(nd_rng, functor);
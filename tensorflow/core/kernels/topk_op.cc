@@ -28,13 +28,20 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
-#include "tensorflow/core/lib/gtl/top_n.h"
 #include "tensorflow/core/util/work_sharder.h"
 
+#ifdef TENSORFLOW_USE_SYCL
+#include "tensorflow/core/common_runtime/sycl/sycl_kernel_warmup.h"
+#include "tensorflow/core/common_runtime/sycl/sycl_util.h"
+#endif  // TENSORFLOW_USE_SYCL
+
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
 typedef Eigen::GpuDevice GPUDevice;
+#ifdef TENSORFLOW_USE_SYCL
+typedef Eigen::SyclDevice SYCLDevice;
+#endif  // TENSORFLOW_USE_SYCL
 
 template <typename Device, typename T>
 class TopK : public OpKernel {
@@ -98,6 +105,69 @@ class TopK : public OpKernel {
 };
 
 namespace functor {
+namespace {
+
+// Rows of at least twice this many columns are split between threads when
+// there are fewer rows than threads.
+constexpr int64 kMinTopKColumnsPerShard = 1 << 15;
+
+// Orders column indices by decreasing value, then increasing index.
+template <typename T>
+struct TopKGreater {
+  explicit TopKGreater(const T* data) : data(data) {}
+  bool operator()(const int32 a, const int32 b) const {
+    if (data[b] < data[a]) {
+      return true;
+    } else if (data[b] > data[a]) {
+      return false;
+    } else {
+      return a < b;
+    }
+  }
+  const T* data;
+};
+
+// Stores in `top_k` the indices of the k largest values of the columns
+// [begin, end) of `input_data`, ties going to the lowest index, sorted as by
+// TopKGreater if `sorted`. Requires k < end - begin.
+//
+// The candidates are gathered in a buffer of 2k indices. Whenever it is full
+// the best k are kept, and the value of the k-th one becomes a threshold
+// that the following columns must beat, so past the first few columns most of
+// them cost a single comparison.
+template <typename T>
+void SelectTopK(const T* input_data, int32 begin, int32 end, int k,
+                bool sorted, std::vector<int32>* top_k) {
+  const TopKGreater<T> greater(input_data);
+  std::vector<int32>& candidates = *top_k;
+  const size_t capacity = std::min<int64>(2 * static_cast<int64>(k),
+                                          static_cast<int64>(end) - begin);
+  candidates.clear();
+  candidates.reserve(capacity);
+  int32 c = begin;
+  // Fill the buffer before there is a threshold.
+  for (; c < end && candidates.size() < capacity; ++c) {
+    candidates.push_back(c);
+  }
+  while (c < end) {
+    std::nth_element(candidates.begin(), candidates.begin() + (k - 1),
+                     candidates.end(), greater);
+    candidates.resize(k);
+    // Later columns must be strictly larger, as they lose ties.
+    const T threshold = input_data[candidates[k - 1]];
+    for (; c < end && candidates.size() < capacity; ++c) {
+      if (input_data[c] > threshold) candidates.push_back(c);
+    }
+  }
+  if (candidates.size() > k) {
+    std::nth_element(candidates.begin(), candidates.begin() + (k - 1),
+                     candidates.end(), greater);
+    candidates.resize(k);
+  }
+  if (sorted) std::sort(candidates.begin(), candidates.end(), greater);
+}
+
+}  // namespace
 
 template <typename T>
 struct TopKFunctor<CPUDevice, T> {
@@ -134,26 +204,23 @@ struct TopKFunctor<CPUDevice, T> {
       return Status::OK();
     }
 
+    const auto worker_threads =
+        *(context->device()->tensorflow_cpu_worker_threads());
+    const int64 num_shards_per_row =
+        std::min<int64>(worker_threads.num_threads / num_rows,
+                        num_cols / kMinTopKColumnsPerShard);
+    if (num_shards_per_row > 1) {
+      ComputeSplittingRows(context, k, input, num_rows, num_cols,
+                           num_shards_per_row, values, indices);
+      return Status::OK();
+    }
+
     auto SortIndices = [&, context](int start_batch, int limit_batch) {
       for (int32 b = start_batch; b < limit_batch; ++b) {
         const T* input_data = &input(b, 0);
-        const auto stable_comp = [input_data](const int32 a, const int32 b) {
-          if (input_data[b] < input_data[a]) {
-            return true;
-          } else if (input_data[b] > input_data[a]) {
-            return false;
-          } else {
-            return a < b;
-          }
-        };
         const auto comp = [input_data](const int32 a, const int32 b) {
           return input_data[b] < input_data[a];
         };
-        // TODO(ebrevdo): For large k < num_cols, instead of using
-        // TopN, it may be faster to create a temporary vector of
-        // values 0..num_cols - 1 and then use std::partial_sort_copy
-        // of this into indices. Choosing the appropriate minimum k or
-        // ratio of k/num_cols will require some experimentation.
         if (k == num_cols) {
           auto* begin = &indices(b, 0);
           auto* end = &indices(b, k);
@@ -177,26 +244,9 @@ struct TopKFunctor<CPUDevice, T> {
             run_begin = run_end;
           }
         } else {
-          // Use the TopN heap object to sort.
-          gtl::TopN<int32, decltype(stable_comp)> filter(k, stable_comp);
-          filter.reserve(num_cols);
-          for (int32 c = 0; c < num_cols; ++c) {
-            filter.push(c);
-          }
-
-          int32 i = 0;
-          if (sorted) {
-            std::unique_ptr<std::vector<int32>> top_k(filter.Extract());
-            for (auto top_k_it = top_k->begin(); top_k_it != top_k->end();
-                 ++top_k_it, ++i) {
-              indices(b, i) = *top_k_it;
-            }
-          } else {
-            for (auto top_k_it = filter.unsorted_begin();
-                 top_k_it != filter.unsorted_end(); ++top_k_it, ++i) {
-              indices(b, i) = *top_k_it;
-            }
-          }
+          std::vector<int32> top_k;
+          SelectTopK(input_data, 0, num_cols, k, sorted, &top_k);
+          std::copy(top_k.begin(), top_k.end(), &indices(b, 0));
         }
         // Now that the indices are sorted, copy the values over in
         // sorted order.
@@ -219,12 +269,78 @@ struct TopKFunctor<CPUDevice, T> {
     const int64 final_cost = (total_cost >= static_cast<double>(kint64max))
                                  ? kint64max
                                  : static_cast<int64>(total_cost);
-    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
     Shard(worker_threads.num_threads, worker_threads.workers, num_rows,
           final_cost, SortIndices);
 
     return Status::OK();
   }
+
+ private:
+  // Splits each row in `num_shards_per_row` shards, whose sorted top k are
+  // selected in parallel, then merged pairwise. This keeps the threads busy
+  // when there are few long rows, e.g. for a single query.
+  static void ComputeSplittingRows(
+      OpKernelContext* context, int k,
+      const typename TTypes<T, 2>::ConstTensor& input, const int64 num_rows,
+      const int64 num_cols, const int64 num_shards_per_row,
+      typename TTypes<T, 2>::Tensor values,
+      typename TTypes<int, 2>::Tensor indices) {
+    const int64 num_shards = num_rows * num_shards_per_row;
+    const int64 shard_size =
+        (num_cols + num_shards_per_row - 1) / num_shards_per_row;
+    std::vector<std::vector<int32>> shard_top_k(num_shards);
+    auto select = [&](int64 start, int64 limit) {
+      for (int64 s = start; s < limit; ++s) {
+        const T* input_data = &input(s / num_shards_per_row, 0);
+        const int32 begin = (s % num_shards_per_row) * shard_size;
+        const int32 end = std::min(num_cols, begin + shard_size);
+        std::vector<int32>* top_k = &shard_top_k[s];
+        if (k < end - begin) {
+          SelectTopK(input_data, begin, end, k, /*sorted=*/true, top_k);
+        } else {
+          top_k->resize(end - begin);
+          std::iota(top_k->begin(), top_k->end(), begin);
+          std::sort(top_k->begin(), top_k->end(), TopKGreater<T>(input_data));
+        }
+      }
+    };
+    const double cmp_cost = 3 * Eigen::TensorOpCost::AddCost<int32>() +
+                            Eigen::TensorOpCost::AddCost<T>();
+    const double select_cost =
+        cmp_cost * shard_size *
+        Eigen::numext::log2(static_cast<float>(std::min<int64>(k, shard_size) +
+                                               1));
+    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+    Shard(worker_threads.num_threads, worker_threads.workers, num_shards,
+          static_cast<int64>(select_cost), select);
+
+    auto merge = [&](int64 start, int64 limit) {
+      for (int64 row = start; row < limit; ++row) {
+        const TopKGreater<T> greater(&input(row, 0));
+        std::vector<int32>* row_top_k = &shard_top_k[row * num_shards_per_row];
+        std::vector<int32> merged;
+        for (int64 step = 1; step < num_shards_per_row; step *= 2) {
+          for (int64 i = 0; i + step < num_shards_per_row; i += 2 * step) {
+            std::vector<int32>& a = row_top_k[i];
+            std::vector<int32>& b = row_top_k[i + step];
+            merged.resize(a.size() + b.size());
+            std::merge(a.begin(), a.end(), b.begin(), b.end(), merged.begin(),
+                       greater);
+            if (merged.size() > k) merged.resize(k);
+            a.swap(merged);
+            std::vector<int32>().swap(b);
+          }
+        }
+        std::copy(row_top_k->begin(), row_top_k->begin() + k,
+                  &indices(row, 0));
+        std::transform(
+            &indices(row, 0), &indices(row, k), &values(row, 0),
+            [row, &input](const int32 loc) { return input(row, loc); });
+      }
+    };
+    Shard(worker_threads.num_threads, worker_threads.workers, num_rows,
+          static_cast<int64>(cmp_cost * num_shards_per_row * k), merge);
+  }
 };
 
 }  // namespace functor
@@ -278,4 +394,210 @@ TF_CALL_INTEGRAL_TYPES(REGISTER_KERNELS);
 
 #endif  // end GOOGLE_CUDA
 
+#ifdef TENSORFLOW_USE_SYCL
+namespace functor {
+
+// Keeps the k largest values of a range of candidates of each row, sorted by
+// decreasing value and increasing index as on CPU. Rows are split in chunks,
+// each selected by one work item with an insertion sort into its k output
+// slots. Candidates are either the columns of the input, or when
+// has_indices is set the output of a previous pass over the chunks, whose
+// original columns are in in_indices.
+template <typename T>
+class TopKSYCL {
+  using read_accessor =
+      cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read,
+                         cl::sycl::access::target::global_buffer>;
+  using write_accessor =
+      cl::sycl::accessor<uint8_t, 1, cl::sycl::access::mode::read_write,
+                         cl::sycl::access::target::global_buffer>;
+
+ public:
+  TopKSYCL(read_accessor in_values, size_t in_values_offset,
+           read_accessor in_indices, size_t in_indices_offset,
+           bool has_indices, write_accessor values, size_t values_offset,
+           write_accessor indices, size_t indices_offset, int num_rows,
+           int num_cols, int chunks, int k)
+      : in_values_(in_values),
+        in_values_offset_(in_values_offset),
+        in_indices_(in_indices),
+        in_indices_offset_(in_indices_offset),
+        has_indices_(has_indices),
+        values_(values),
+        values_offset_(values_offset),
+        indices_(indices),
+        indices_offset_(indices_offset),
+        num_rows_(num_rows),
+        num_cols_(num_cols),
+        chunks_(chunks),
+        k_(k) {}
+
+  void operator()(cl::sycl::nd_item<1> item) {
+    const int index = item.get_global_id(0);
+    if (index >= num_rows_ * chunks_) {
+      return;
+    }
+    const int row = index / chunks_;
+    const int chunk = index - row * chunks_;
+    // Every chunk but the last has chunk_size >= k columns, the last one
+    // also gets the remainder.
+    const int chunk_size = num_cols_ / chunks_;
+    const int begin = chunk * chunk_size;
+    const int end = chunk == chunks_ - 1 ? num_cols_ : begin + chunk_size;
+
+    const T* in_values = ConvertToActualTypeSycl(T, in_values_) +
+                         in_values_offset_ + row * num_cols_;
+    const int* in_indices = ConvertToActualTypeSycl(int, in_indices_) +
+                            in_indices_offset_ + row * num_cols_;
+    T* values =
+        ConvertToActualTypeSycl(T, values_) + values_offset_ + index * k_;
+    int* indices =
+        ConvertToActualTypeSycl(int, indices_) + indices_offset_ + index * k_;
+
+    int count = 0;
+    for (int col = begin; col < end; ++col) {
+      const T value = in_values[col];
+      const int value_index = has_indices_ ? in_indices[col] : col;
+      int pos;
+      if (count < k_) {
+        pos = count++;
+      } else if (Before(value, value_index, values[k_ - 1],
+                        indices[k_ - 1])) {
+        pos = k_ - 1;
+      } else {
+        continue;
+      }
+      for (; pos > 0 &&
+             Before(value, value_index, values[pos - 1], indices[pos - 1]);
+           --pos) {
+        values[pos] = values[pos - 1];
+        indices[pos] = indices[pos - 1];
+      }
+      values[pos] = value;
+      indices[pos] = value_index;
+    }
+  }
+
+ private:
+  static inline bool Before(const T a, const int a_index, const T b,
+                            const int b_index) {
+    return a > b || (a == b && a_index < b_index);
+  }
+
+  const read_accessor in_values_;
+  const size_t in_values_offset_;
+  const read_accessor in_indices_;
+  const size_t in_indices_offset_;
+  const bool has_indices_;
+  write_accessor values_;
+  const size_t values_offset_;
+  write_accessor indices_;
+  const size_t indices_offset_;
+  const int num_rows_;
+  const int num_cols_;
+  const int chunks_;
+  const int k_;
+};
+
+template <typename T>
+void LaunchTopKSYCL(const SYCLDevice& d, const T* in_values,
+                    const int* in_indices, T* values, int* indices,
+                    int num_rows, int num_cols, int chunks, int k) {
+  d.sycl_queue().submit([&](cl::sycl::handler& cgh) {
+    using mode = cl::sycl::access::mode;
+    auto in_values_acc =
+        d.get_sycl_buffer(in_values).template get_access<mode::read>(cgh);
+    // Without candidate indices the values are bound in their place, the
+    // kernel does not read them.
+    const void* in_indices_ptr =
+        in_indices != nullptr ? static_cast<const void*>(in_indices)
+                              : static_cast<const void*>(in_values);
+    auto in_indices_acc =
+        d.get_sycl_buffer(in_indices_ptr).template get_access<mode::read>(cgh);
+    auto values_acc =
+        d.get_sycl_buffer(values).template get_access<mode::read_write>(cgh);
+    auto indices_acc =
+        d.get_sycl_buffer(indices).template get_access<mode::read_write>(cgh);
+    TopKSYCL<T> functor(
+        in_values_acc, d.get_offset(in_values) / sizeof(T), in_indices_acc,
+        d.get_offset(in_indices_ptr) / sizeof(int), in_indices != nullptr,
+        values_acc, d.get_offset(values) / sizeof(T), indices_acc,
+        d.get_offset(indices) / sizeof(int), num_rows, num_cols, chunks, k);
+    cgh.parallel_for(SYCLUtil::get_nd_range(d, num_rows * chunks), functor);
+  });
+}
+
+// Long rows are first split in chunks whose top k are selected in parallel,
+// so that the device is busy even with few rows. A second pass then selects
+// the top k of the chunks * k candidates of each row. The output is always
+// sorted.
+template <typename T>
+struct TopKFunctor<SYCLDevice, T> {
+  static Status Compute(OpKernelContext* context, bool sorted, int k,
+                        const typename TTypes<T, 2>::ConstTensor& input,
+                        const int64 num_rows, const int64 num_cols,
+                        typename TTypes<T, 2>::Tensor values,
+                        typename TTypes<int, 2>::Tensor indices) {
+    const SYCLDevice& d = context->eigen_device<SYCLDevice>();
+    if (num_rows * num_cols > std::numeric_limits<int>::max()) {
+      return errors::InvalidArgument(
+          "TopK on SYCL only supports inputs with less than 2^31 elements");
+    }
+    if (num_rows == 0) {
+      return Status::OK();
+    }
+    // Each chunk must hold at least k columns, and enough of them to amortize
+    // the second pass.
+    const int64 min_chunk_size = std::max<int64>(4 * k, 256);
+    const int64 target_items =
+        static_cast<int64>(d.getNumSyclMultiProcessors()) *
+        static_cast<int64>(SYCLUtil::get_max_work_group_size(d));
+    const int64 chunks = std::max<int64>(
+        1, std::min(num_cols / min_chunk_size,
+                    (target_items + num_rows - 1) / num_rows));
+    if (chunks == 1) {
+      LaunchTopKSYCL<T>(d, input.data(), nullptr, values.data(),
+                        indices.data(), num_rows, num_cols, 1, k);
+      return Status::OK();
+    }
+
+    Tensor candidate_values;
+    TF_RETURN_IF_ERROR(context->allocate_temp(
+        DataTypeToEnum<T>::value, TensorShape({num_rows, chunks * k}),
+        &candidate_values));
+    Tensor candidate_indices;
+    TF_RETURN_IF_ERROR(context->allocate_temp(
+        DT_INT32, TensorShape({num_rows, chunks * k}), &candidate_indices));
+    T* candidate_values_ptr = candidate_values.flat<T>().data();
+    int* candidate_indices_ptr = candidate_indices.flat<int>().data();
+    LaunchTopKSYCL<T>(d, input.data(), nullptr, candidate_values_ptr,
+                      candidate_indices_ptr, num_rows, num_cols, chunks, k);
+    LaunchTopKSYCL<T>(d, candidate_values_ptr, candidate_indices_ptr,
+                      values.data(), indices.data(), num_rows, chunks * k, 1,
+                      k);
+    return Status::OK();
+  }
+};
+
+}  // namespace functor
+
+#define REGISTER_KERNELS(type)                                    \
+  REGISTER_KERNEL_BUILDER(                                        \
+      Name("TopK").Device(DEVICE_SYCL).TypeConstraint<type>("T"), \
+      TopK<SYCLDevice, type>)                                     \
+  REGISTER_KERNEL_BUILDER(Name("TopKV2")                          \
+                              .Device(DEVICE_SYCL)                \
+                              .TypeConstraint<type>("T")          \
+                              .HostMemory("k"),                   \
+                          TopK<SYCLDevice, type>)
+
+TF_CALL_float(REGISTER_KERNELS);
+TF_CALL_SYCL_double(REGISTER_KERNELS);
+
+#undef REGISTER_KERNELS
+
+REGISTER_SYCL_KERNEL_WARMUP(functor::TopKSYCL<float>);
+
+#endif  // TENSORFLOW_USE_SYCL
+
 }  // end namespace tensorflow
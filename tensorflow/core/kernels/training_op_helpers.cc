@@ -15,8 +15,32 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/training_op_helpers.h"
 
+#include "tensorflow/core/lib/monitoring/counter.h"
+
 namespace tensorflow {
 
+namespace {
+
+auto* variable_copies_on_write = monitoring::Counter<1>::New(
+    "/tensorflow/core/variable_copies_on_write",
+    "The number of times an update copied a whole variable because a read "
+    "still held its buffer, by op type.",
+    "op");
+auto* variable_copies_on_write_bytes = monitoring::Counter<1>::New(
+    "/tensorflow/core/variable_copies_on_write_bytes",
+    "The bytes copied by /tensorflow/core/variable_copies_on_write, by op "
+    "type.",
+    "op");
+
+}  // namespace
+
+void RecordVariableCopyOnWrite(OpKernelContext* ctx, const Tensor& tensor) {
+  const string& op = ctx->op_kernel().type_string();
+  variable_copies_on_write->GetCell(op)->IncrementBy(1);
+  variable_copies_on_write_bytes->GetCell(op)->IncrementBy(
+      tensor.TotalBytes());
+}
+
 mutex* GetTrainingVariableMutex(OpKernelContext* ctx, int input) {
   if (ctx->input_dtype(input) == DT_RESOURCE) {
     Var* var;
@@ -57,7 +81,7 @@ std::vector<mutex_lock> MaybeLockVariableInputMutexesInOrder(
             [&mutexes](int a, int b) { return mutexes[a] < mutexes[b]; });
 
   for (auto input : acquire_order) {
-    mutex* mu = GetTrainingVariableMutex(ctx, input);
+    mutex* mu = mutexes[input];
     if (mu != nullptr) {
       locks.emplace_back(*mu);
     }
@@ -31,6 +31,10 @@ std::vector<mutex_lock> MaybeLockVariableInputMutexesInOrder(
 void MaybeForwardRefInputToRefOutput(OpKernelContext* ctx, int input,
                                      int output);
 
+// Counts a full copy of the buffer of a variable updated by ctx while a read
+// still held it, in the /tensorflow/core/variable_copies_on_write metrics.
+void RecordVariableCopyOnWrite(OpKernelContext* ctx, const Tensor& tensor);
+
 // This is for use with ResourceVariables to ensure *tensor has a
 // reference count of 1 before you update it.
 // REQUIRES: If you pass in variable->tensor(), *variable->mu() must be held.
@@ -39,6 +43,7 @@ Status PrepareToUpdateVariable(OpKernelContext* ctx, Tensor* tensor) {
   if (!tensor->RefCountIsOne()) {
     // Tensor's buffer is in use by some read, so we need to copy before
     // updating.
+    RecordVariableCopyOnWrite(ctx, *tensor);
     PersistentTensor unused;
     Tensor* tmp;
     if (std::is_same<T, Variant>::value) {
@@ -2464,63 +2464,76 @@ TF_CALL_double(REGISTER_CPU_KERNELS);
 #undef REGISTER_CPU_KERNELS
 #undef REGISTER_KERNELS
 
+// Also implements _GroupedApplyMomentum, which applies N independent updates.
+// Each argument is then a list holding the inputs of all the updates.
 template <typename Device, typename T>
 class ApplyMomentumOp : public OpKernel {
  public:
   explicit ApplyMomentumOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("use_nesterov", &use_nesterov_));
+    if (ctx->HasAttr("N")) {
+      OP_REQUIRES_OK(ctx, ctx->GetAttr("N", &num_updates_));
+    }
   }
 
   void Compute(OpKernelContext* ctx) override {
-    auto locks =
-        MaybeLockVariableInputMutexesInOrder(ctx, use_exclusive_lock_, {0, 1});
-
-    Tensor var;
-    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<Device, T>(
-                            ctx, 0, use_exclusive_lock_, false, &var));
-    Tensor accum;
-    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<Device, T>(
-                            ctx, 1, use_exclusive_lock_, false, &accum));
-    OP_REQUIRES(
-        ctx, var.IsInitialized(),
-        errors::FailedPrecondition(
-            "Attempting to use uninitialized variables: ", requested_input(0)));
-    OP_REQUIRES(
-        ctx, accum.IsInitialized(),
-        errors::FailedPrecondition(
-            "Attempting to use uninitialized variables: ", requested_input(1)));
-    const Tensor& lr = ctx->input(2);
-    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(lr.shape()),
-                errors::InvalidArgument("lr is not a scalar: ",
-                                        lr.shape().DebugString()));
-    const Tensor& grad = ctx->input(3);
-    OP_REQUIRES(
-        ctx, var.shape().IsSameSize(accum.shape()),
-        errors::InvalidArgument("var and accum do not have the same shape",
-                                var.shape().DebugString(), " ",
-                                accum.shape().DebugString()));
-    OP_REQUIRES(
-        ctx, var.shape().IsSameSize(grad.shape()),
-        errors::InvalidArgument("var and grad do not have the same shape",
-                                var.shape().DebugString(), " ",
-                                grad.shape().DebugString()));
-
-    const Tensor& momentum = ctx->input(4);
-    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(momentum.shape()),
-                errors::InvalidArgument("momentum is not a scalar: ",
-                                        momentum.shape().DebugString()));
-
-    const Device& device = ctx->template eigen_device<Device>();
-    functor::ApplyMomentum<Device, T>()(device, var.flat<T>(), accum.flat<T>(),
-                                        lr.scalar<T>(), grad.flat<T>(),
-                                        momentum.scalar<T>(), use_nesterov_);
-    MaybeForwardRefInputToRefOutput(ctx, 0, 0);
+    const int n = num_updates_;
+    for (int i = 0; i < n; ++i) {
+      const int var_input = i;
+      const int accum_input = n + i;
+      auto locks = MaybeLockVariableInputMutexesInOrder(
+          ctx, use_exclusive_lock_, {var_input, accum_input});
+
+      Tensor var;
+      OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<Device, T>(
+                              ctx, var_input, use_exclusive_lock_, false,
+                              &var));
+      Tensor accum;
+      OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<Device, T>(
+                              ctx, accum_input, use_exclusive_lock_, false,
+                              &accum));
+      OP_REQUIRES(ctx, var.IsInitialized(),
+                  errors::FailedPrecondition(
+                      "Attempting to use uninitialized variables: ",
+                      requested_input(var_input)));
+      OP_REQUIRES(ctx, accum.IsInitialized(),
+                  errors::FailedPrecondition(
+                      "Attempting to use uninitialized variables: ",
+                      requested_input(accum_input)));
+      const Tensor& lr = ctx->input(2 * n + i);
+      OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(lr.shape()),
+                  errors::InvalidArgument("lr is not a scalar: ",
+                                          lr.shape().DebugString()));
+      const Tensor& grad = ctx->input(3 * n + i);
+      OP_REQUIRES(
+          ctx, var.shape().IsSameSize(accum.shape()),
+          errors::InvalidArgument("var and accum do not have the same shape",
+                                  var.shape().DebugString(), " ",
+                                  accum.shape().DebugString()));
+      OP_REQUIRES(
+          ctx, var.shape().IsSameSize(grad.shape()),
+          errors::InvalidArgument("var and grad do not have the same shape",
+                                  var.shape().DebugString(), " ",
+                                  grad.shape().DebugString()));
+
+      const Tensor& momentum = ctx->input(4 * n + i);
+      OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(momentum.shape()),
+                  errors::InvalidArgument("momentum is not a scalar: ",
+                                          momentum.shape().DebugString()));
+
+      const Device& device = ctx->template eigen_device<Device>();
+      functor::ApplyMomentum<Device, T>()(
+          device, var.flat<T>(), accum.flat<T>(), lr.scalar<T>(),
+          grad.flat<T>(), momentum.scalar<T>(), use_nesterov_);
+      MaybeForwardRefInputToRefOutput(ctx, var_input, i);
+    }
   }
 
  private:
   bool use_exclusive_lock_;
   bool use_nesterov_;
+  int num_updates_ = 1;
 };
 
 #define REGISTER_KERNELS(D, T)                                         \
@@ -2532,6 +2545,16 @@ class ApplyMomentumOp : public OpKernel {
                               .HostMemory("var")                       \
                               .HostMemory("accum")                     \
                               .TypeConstraint<T>("T"),                 \
+                          ApplyMomentumOp<D##Device, T>);              \
+  REGISTER_KERNEL_BUILDER(Name("_GroupedApplyMomentum")                \
+                              .Device(DEVICE_##D)                      \
+                              .TypeConstraint<T>("T"),                 \
+                          ApplyMomentumOp<D##Device, T>);              \
+  REGISTER_KERNEL_BUILDER(Name("_GroupedResourceApplyMomentum")        \
+                              .Device(DEVICE_##D)                      \
+                              .HostMemory("var")                       \
+                              .HostMemory("accum")                     \
+                              .TypeConstraint<T>("T"),                 \
                           ApplyMomentumOp<D##Device, T>);
 #define REGISTER_CPU_KERNELS(T) REGISTER_KERNELS(CPU, T);
 
@@ -2690,94 +2713,107 @@ TF_CALL_double(REGISTER_CPU_KERNELS);
 #undef REGISTER_CPU_KERNELS
 #undef REGISTER_KERNELS
 
+// Also implements _GroupedApplyAdam, which applies N independent updates. Each
+// argument is then a list holding the inputs of all the updates.
 template <typename Device, typename T>
 class ApplyAdamOp : public OpKernel {
  public:
   explicit ApplyAdamOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("use_nesterov", &use_nesterov_));
+    if (ctx->HasAttr("N")) {
+      OP_REQUIRES_OK(ctx, ctx->GetAttr("N", &num_updates_));
+    }
   }
 
   void Compute(OpKernelContext* ctx) override {
-    auto locks = MaybeLockVariableInputMutexesInOrder(ctx, use_exclusive_lock_,
-                                                      {0, 1, 2});
-
-    Tensor var;
-    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<Device, T>(
-                            ctx, 0, use_exclusive_lock_, false, &var));
-    Tensor m;
-    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<Device, T>(
-                            ctx, 1, use_exclusive_lock_, false, &m));
-    Tensor v;
-    OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<Device, T>(
-                            ctx, 2, use_exclusive_lock_, false, &v));
-    OP_REQUIRES(
-        ctx, var.IsInitialized(),
-        errors::FailedPrecondition(
-            "Attempting to use uninitialized variables: ", requested_input(0)));
-    OP_REQUIRES(
-        ctx, m.IsInitialized(),
-        errors::FailedPrecondition(
-            "Attempting to use uninitialized variables: ", requested_input(1)));
-    OP_REQUIRES(
-        ctx, v.IsInitialized(),
-        errors::FailedPrecondition(
-            "Attempting to use uninitialized variables: ", requested_input(2)));
-
-    const Tensor& beta1_power = ctx->input(3);
-    const Tensor& beta2_power = ctx->input(4);
-    const Tensor& lr = ctx->input(5);
-    const Tensor& beta1 = ctx->input(6);
-    const Tensor& beta2 = ctx->input(7);
-    const Tensor& epsilon = ctx->input(8);
-
-    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(beta1_power.shape()),
-                errors::InvalidArgument("beta1_power is not a scalar: ",
-                                        beta1_power.shape().DebugString()));
-    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(beta2_power.shape()),
-                errors::InvalidArgument("beta2_power is not a scalar: ",
-                                        beta2_power.shape().DebugString()));
-    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(lr.shape()),
-                errors::InvalidArgument("lr is not a scalar : ",
-                                        lr.shape().DebugString()));
-    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(beta1.shape()),
-                errors::InvalidArgument("beta1 is not a scalar: ",
-                                        beta1.shape().DebugString()));
-    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(beta2.shape()),
-                errors::InvalidArgument("beta2 is not a scalar: ",
-                                        beta2.shape().DebugString()));
-    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(epsilon.shape()),
-                errors::InvalidArgument("epsilon is not a scalar: ",
-                                        epsilon.shape().DebugString()));
-
-    const Tensor& grad = ctx->input(9);
-    OP_REQUIRES(ctx, var.shape().IsSameSize(m.shape()),
-                errors::InvalidArgument("var and m do not have the same shape",
-                                        var.shape().DebugString(), " ",
-                                        m.shape().DebugString()));
-    OP_REQUIRES(ctx, var.shape().IsSameSize(v.shape()),
-                errors::InvalidArgument("var and v do not have the same shape",
-                                        var.shape().DebugString(), " ",
-                                        v.shape().DebugString()));
-    OP_REQUIRES(
-        ctx, var.shape().IsSameSize(grad.shape()),
-        errors::InvalidArgument("var and grad do not have the same shape",
-                                var.shape().DebugString(), " ",
-                                grad.shape().DebugString()));
-
-    const Device& device = ctx->template eigen_device<Device>();
-    functor::ApplyAdam<Device, T>()(
-        device, var.flat<T>(), m.flat<T>(), v.flat<T>(),
-        beta1_power.scalar<T>(), beta2_power.scalar<T>(), lr.scalar<T>(),
-        beta1.scalar<T>(), beta2.scalar<T>(), epsilon.scalar<T>(),
-        grad.flat<T>(), use_nesterov_);
-
-    MaybeForwardRefInputToRefOutput(ctx, 0, 0);
+    const int n = num_updates_;
+    for (int i = 0; i < n; ++i) {
+      const int var_input = i;
+      const int m_input = n + i;
+      const int v_input = 2 * n + i;
+      auto locks = MaybeLockVariableInputMutexesInOrder(
+          ctx, use_exclusive_lock_, {var_input, m_input, v_input});
+
+      Tensor var;
+      OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<Device, T>(
+                              ctx, var_input, use_exclusive_lock_, false,
+                              &var));
+      Tensor m;
+      OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<Device, T>(
+                              ctx, m_input, use_exclusive_lock_, false, &m));
+      Tensor v;
+      OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<Device, T>(
+                              ctx, v_input, use_exclusive_lock_, false, &v));
+      OP_REQUIRES(ctx, var.IsInitialized(),
+                  errors::FailedPrecondition(
+                      "Attempting to use uninitialized variables: ",
+                      requested_input(var_input)));
+      OP_REQUIRES(ctx, m.IsInitialized(),
+                  errors::FailedPrecondition(
+                      "Attempting to use uninitialized variables: ",
+                      requested_input(m_input)));
+      OP_REQUIRES(ctx, v.IsInitialized(),
+                  errors::FailedPrecondition(
+                      "Attempting to use uninitialized variables: ",
+                      requested_input(v_input)));
+
+      const Tensor& beta1_power = ctx->input(3 * n + i);
+      const Tensor& beta2_power = ctx->input(4 * n + i);
+      const Tensor& lr = ctx->input(5 * n + i);
+      const Tensor& beta1 = ctx->input(6 * n + i);
+      const Tensor& beta2 = ctx->input(7 * n + i);
+      const Tensor& epsilon = ctx->input(8 * n + i);
+
+      OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(beta1_power.shape()),
+                  errors::InvalidArgument("beta1_power is not a scalar: ",
+                                          beta1_power.shape().DebugString()));
+      OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(beta2_power.shape()),
+                  errors::InvalidArgument("beta2_power is not a scalar: ",
+                                          beta2_power.shape().DebugString()));
+      OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(lr.shape()),
+                  errors::InvalidArgument("lr is not a scalar : ",
+                                          lr.shape().DebugString()));
+      OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(beta1.shape()),
+                  errors::InvalidArgument("beta1 is not a scalar: ",
+                                          beta1.shape().DebugString()));
+      OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(beta2.shape()),
+                  errors::InvalidArgument("beta2 is not a scalar: ",
+                                          beta2.shape().DebugString()));
+      OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(epsilon.shape()),
+                  errors::InvalidArgument("epsilon is not a scalar: ",
+                                          epsilon.shape().DebugString()));
+
+      const Tensor& grad = ctx->input(9 * n + i);
+      OP_REQUIRES(ctx, var.shape().IsSameSize(m.shape()),
+                  errors::InvalidArgument(
+                      "var and m do not have the same shape",
+                      var.shape().DebugString(), " ", m.shape().DebugString()));
+      OP_REQUIRES(ctx, var.shape().IsSameSize(v.shape()),
+                  errors::InvalidArgument(
+                      "var and v do not have the same shape",
+                      var.shape().DebugString(), " ", v.shape().DebugString()));
+      OP_REQUIRES(
+          ctx, var.shape().IsSameSize(grad.shape()),
+          errors::InvalidArgument("var and grad do not have the same shape",
+                                  var.shape().DebugString(), " ",
+                                  grad.shape().DebugString()));
+
+      const Device& device = ctx->template eigen_device<Device>();
+      functor::ApplyAdam<Device, T>()(
+          device, var.flat<T>(), m.flat<T>(), v.flat<T>(),
+          beta1_power.scalar<T>(), beta2_power.scalar<T>(), lr.scalar<T>(),
+          beta1.scalar<T>(), beta2.scalar<T>(), epsilon.scalar<T>(),
+          grad.flat<T>(), use_nesterov_);
+
+      MaybeForwardRefInputToRefOutput(ctx, var_input, i);
+    }
   }
 
  private:
   bool use_exclusive_lock_;
   bool use_nesterov_;
+  int num_updates_ = 1;
 };
 
 #define REGISTER_KERNELS(D, T)                                     \
@@ -2790,6 +2826,17 @@ class ApplyAdamOp : public OpKernel {
                               .HostMemory("v")                     \
                               .Device(DEVICE_##D)                  \
                               .TypeConstraint<T>("T"),             \
+                          ApplyAdamOp<D##Device, T>);              \
+  REGISTER_KERNEL_BUILDER(Name("_GroupedApplyAdam")                \
+                              .Device(DEVICE_##D)                  \
+                              .TypeConstraint<T>("T"),             \
+                          ApplyAdamOp<D##Device, T>);              \
+  REGISTER_KERNEL_BUILDER(Name("_GroupedResourceApplyAdam")        \
+                              .HostMemory("var")                   \
+                              .HostMemory("m")                     \
+                              .HostMemory("v")                     \
+                              .Device(DEVICE_##D)                  \
+                              .TypeConstraint<T>("T"),             \
                           ApplyAdamOp<D##Device, T>);
 #define REGISTER_CPU_KERNELS(T) REGISTER_KERNELS(CPU, T);
 
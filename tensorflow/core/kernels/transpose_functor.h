@@ -84,6 +84,7 @@ inline void ReduceTransposeDimensions(const TensorShape& shape,
     // If input dimension is already 1, no need to reduce dimension.
     new_perm->resize(1);
     (*new_perm)[0] = perm[0];
+    new_dims->resize(1);
     (*new_dims)[0] = shape.dim_size(0);
     return;
   }
@@ -114,7 +115,7 @@ inline void ReduceTransposeDimensions(const TensorShape& shape,
   for (int i = 0; i < new_dim_position.size(); ++i) {
     if (new_dim_position[i] >= 0) {
       int new_perm_idx = new_dim_position[i];
-      (*new_perm)[dim_idx] = new_perm_idx;
+      (*new_perm)[new_perm_idx] = dim_idx;
       (*new_dims)[dim_idx] = combined_dims[new_perm_idx];
       dim_idx++;
     }
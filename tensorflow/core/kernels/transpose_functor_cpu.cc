@@ -15,12 +15,12 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
 #include <complex>
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/tensor.h"
-#include "tensorflow/core/kernels/ops_util.h"
 #include "tensorflow/core/kernels/transpose_functor.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
@@ -32,37 +32,147 @@ namespace tensorflow {
 namespace {
 
 template <typename T, bool conjugate>
-void TransposeSimple(const CPUDevice& device, const Tensor& in,
-                     const gtl::ArraySlice<int32> perm, Tensor* out) {
-  const int ndims = in.dims();
-  gtl::InlinedVector<int64, 8> in_strides = ComputeStride<int64>(in.shape());
-  gtl::InlinedVector<int64, 8> out_strides = ComputeStride<int64>(out->shape());
-  const T* p = reinterpret_cast<const T*>(in.tensor_data().data());
-  T* q = reinterpret_cast<T*>(const_cast<char*>((out->tensor_data().data())));
-  auto transpose_fn = [=, &in_strides, &out_strides, &perm](int64 begin,
-                                                            int64 end) {
-    for (int64 o_idx = begin; o_idx < end; ++o_idx) {
-      int64 i_idx = 0;
-      int64 t = o_idx;
-      for (int i = 0; i < ndims; ++i) {
-        const int64 ratio = t / out_strides[i];
-        t -= ratio * out_strides[i];
-        i_idx += ratio * in_strides[perm[i]];
+inline void CopyElement(const T& from, T* to) {
+  if (conjugate) {
+    *to = Eigen::numext::conj(from);
+  } else {
+    *to = from;
+  }
+}
+
+// Copies the `rows` x `cols` tile at `in`, whose rows are `in_stride` apart,
+// to the transposed tile at `out`, whose rows are `out_stride` apart. With
+// compile-time sizes, the compiler unrolls and vectorizes the loops.
+template <typename T, bool conjugate, int64 rows, int64 cols>
+inline void TransposeTile(const T* in, int64 in_stride, T* out,
+                          int64 out_stride) {
+  for (int64 c = 0; c < cols; ++c) {
+    for (int64 r = 0; r < rows; ++r) {
+      CopyElement<T, conjugate>(in[r * in_stride + c],
+                                &out[c * out_stride + r]);
+    }
+  }
+}
+template <typename T, bool conjugate>
+inline void TransposeTile(const T* in, int64 in_stride, T* out,
+                          int64 out_stride, int64 rows, int64 cols) {
+  for (int64 c = 0; c < cols; ++c) {
+    for (int64 r = 0; r < rows; ++r) {
+      CopyElement<T, conjugate>(in[r * in_stride + c],
+                                &out[c * out_stride + r]);
+    }
+  }
+}
+
+// Transposes `in`, of shape `dims`, into `out` with permutation `perm`, as
+// reduced by ReduceTransposeDimensions. No two consecutive input dimensions
+// thus stay consecutive in the output.
+//
+// If the innermost dimension stays innermost, each output row is a copy of an
+// input row. Else the input dimension becoming innermost in the output, `a`,
+// and the innermost input dimension span planes which are transposed one
+// square tile at a time, so that both the reads and the writes of a tile hit
+// a few cache lines. The tiles span at least a cache line. The work is split
+// over the thread pool by strips of tiles along `a`.
+template <typename T, bool conjugate>
+void TransposeBlocked(const CPUDevice& device, const T* in,
+                      const internal::TransposeDimsVec& dims,
+                      const internal::TransposePermsVec& perm, T* out) {
+  const int ndims = dims.size();
+  internal::TransposeDimsVec in_strides(ndims, 1);
+  for (int i = ndims - 2; i >= 0; --i) {
+    in_strides[i] = in_strides[i + 1] * dims[i + 1];
+  }
+  internal::TransposeDimsVec out_strides(ndims, 1);
+  for (int i = ndims - 2; i >= 0; --i) {
+    out_strides[i] = out_strides[i + 1] * dims[perm[i + 1]];
+  }
+
+  const int inner = ndims - 1;
+  if (ndims == 1 || perm[inner] == inner) {
+    // Copy whole rows. The outer dimensions are the output ones but the last.
+    const int64 row_size = dims[inner];
+    const int64 num_rows = in_strides[0] * dims[0] / row_size;
+    auto copy_rows = [=, &in_strides, &out_strides, &perm](int64 begin,
+                                                           int64 end) {
+      for (int64 row = begin; row < end; ++row) {
+        int64 in_offset = 0;
+        int64 t = row * row_size;
+        for (int i = 0; i < inner; ++i) {
+          const int64 index = t / out_strides[i];
+          t -= index * out_strides[i];
+          in_offset += index * in_strides[perm[i]];
+        }
+        const T* from = in + in_offset;
+        T* to = out + row * row_size;
+        if (conjugate) {
+          for (int64 k = 0; k < row_size; ++k) {
+            CopyElement<T, conjugate>(from[k], &to[k]);
+          }
+        } else {
+          std::copy(from, from + row_size, to);
+        }
+      }
+    };
+    Eigen::TensorOpCost cost(/*bytes_loaded=*/sizeof(T) * row_size,
+                             /*bytes_stored=*/sizeof(T) * row_size,
+                             /*compute_cycles=*/row_size);
+    device.parallelFor(num_rows, cost, std::move(copy_rows));
+    return;
+  }
+
+  // The tiled plane: input dimension `a` is innermost in the output, and the
+  // innermost input dimension is output dimension `b`.
+  constexpr int64 kTileSize =
+      sizeof(T) >= 8 ? 8 : (64 / sizeof(T) > 64 ? 64 : 64 / sizeof(T));
+  const int a = perm[inner];
+  int b = 0;
+  while (perm[b] != inner) ++b;
+  const int64 a_size = dims[a];
+  const int64 inner_size = dims[inner];
+  const int64 in_a_stride = in_strides[a];
+  const int64 out_b_stride = out_strides[b];
+  const int64 num_strips = (a_size + kTileSize - 1) / kTileSize;
+  const int64 num_planes = in_strides[0] * dims[0] / (a_size * inner_size);
+
+  auto transpose_strips = [=, &in_strides, &out_strides, &perm](int64 begin,
+                                                                int64 end) {
+    for (int64 unit = begin; unit < end; ++unit) {
+      // Find the plane from its index over the other output dimensions.
+      int64 plane = unit / num_strips;
+      int64 in_offset = 0;
+      int64 out_offset = 0;
+      for (int i = inner - 1; i >= 0; --i) {
+        if (i == b) continue;
+        const int64 size = dims[perm[i]];
+        const int64 index = plane % size;
+        plane /= size;
+        in_offset += index * in_strides[perm[i]];
+        out_offset += index * out_strides[i];
       }
-      if (conjugate) {
-        q[o_idx] = Eigen::numext::conj(p[i_idx]);
-      } else {
-        q[o_idx] = p[i_idx];
+      const int64 a_begin = (unit % num_strips) * kTileSize;
+      const int64 rows = std::min(kTileSize, a_size - a_begin);
+      const T* from = in + in_offset + a_begin * in_a_stride;
+      T* to = out + out_offset + a_begin;
+      int64 c = 0;
+      if (rows == kTileSize) {
+        for (; c + kTileSize <= inner_size; c += kTileSize) {
+          TransposeTile<T, conjugate, kTileSize, kTileSize>(
+              from + c, in_a_stride, to + c * out_b_stride, out_b_stride);
+        }
+      }
+      if (c < inner_size) {
+        TransposeTile<T, conjugate>(from + c, in_a_stride,
+                                    to + c * out_b_stride, out_b_stride, rows,
+                                    inner_size - c);
       }
     }
   };
-  double cycles_per_element =
-      (conjugate ? 1 : 0) + ndims * (Eigen::TensorOpCost::DivCost<int64>() +
-                                     2 * Eigen::TensorOpCost::MulCost<int64>() +
-                                     2 * Eigen::TensorOpCost::AddCost<int64>());
-  Eigen::TensorOpCost cost(/*bytes_loaded=*/sizeof(T),
-                           /*bytes_stored=*/sizeof(T), cycles_per_element);
-  device.parallelFor(in.NumElements(), cost, std::move(transpose_fn));
+  Eigen::TensorOpCost cost(/*bytes_loaded=*/sizeof(T) * kTileSize * inner_size,
+                           /*bytes_stored=*/sizeof(T) * kTileSize * inner_size,
+                           /*compute_cycles=*/kTileSize * inner_size);
+  device.parallelFor(num_planes * num_strips, cost,
+                     std::move(transpose_strips));
 }
 
 }  // namespace
@@ -71,39 +181,15 @@ template <typename T, bool conjugate>
 struct Transpose<CPUDevice, T, conjugate> {
   static void run(const CPUDevice& d, const Tensor& in,
                   const gtl::ArraySlice<int32> perm, Tensor* out) {
-    switch (in.dims()) {
-      case 2:
-        internal::TransposeUsingEigen<CPUDevice, T, 2>(d, in, perm, conjugate,
-                                                       out);
-        break;
-      case 3:
-        internal::TransposeUsingEigen<CPUDevice, T, 3>(d, in, perm, conjugate,
-                                                       out);
-        break;
-      case 4:
-        internal::TransposeUsingEigen<CPUDevice, T, 4>(d, in, perm, conjugate,
-                                                       out);
-        break;
-      case 5:
-        internal::TransposeUsingEigen<CPUDevice, T, 5>(d, in, perm, conjugate,
-                                                       out);
-        break;
-      case 6:
-        internal::TransposeUsingEigen<CPUDevice, T, 6>(d, in, perm, conjugate,
-                                                       out);
-        break;
-      case 7:
-        internal::TransposeUsingEigen<CPUDevice, T, 7>(d, in, perm, conjugate,
-                                                       out);
-        break;
-      case 8:
-        internal::TransposeUsingEigen<CPUDevice, T, 8>(d, in, perm, conjugate,
-                                                       out);
-        break;
-      default:
-        TransposeSimple<T, conjugate>(d, in, perm, out);
-        break;
-    }
+    if (in.NumElements() == 0) return;
+    internal::TransposePermsVec new_perm;
+    internal::TransposeDimsVec new_dims;
+    internal::ReduceTransposeDimensions(in.shape(), perm, &new_perm,
+                                        &new_dims);
+    TransposeBlocked<T, conjugate>(
+        d, reinterpret_cast<const T*>(in.tensor_data().data()), new_dims,
+        new_perm,
+        reinterpret_cast<T*>(const_cast<char*>(out->tensor_data().data())));
   }
 };
 
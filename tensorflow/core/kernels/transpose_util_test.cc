@@ -78,6 +78,12 @@ TEST_F(TransposeUtilTest, NormalDimensionReduction) {
 
   TestDimensionReduction({2, 3, 4, 5, 6}, {4, 0, 1, 2, 3}, {1, 0}, {120, 6});
 
+  TestDimensionReduction({2, 3, 4, 5}, {1, 3, 0, 2}, {1, 3, 0, 2},
+                         {2, 3, 4, 5});
+
+  TestDimensionReduction({2, 3, 4, 5, 6}, {3, 4, 0, 2, 1}, {3, 0, 2, 1},
+                         {2, 3, 4, 30});
+
   TestDimensionReduction({2, 3, 4, 5, 6}, {0, 1, 2, 3, 4}, {0}, {720});
 
   TestDimensionReduction({2, 3, 4, 5}, {0, 1, 2, 3}, {0}, {120});
@@ -13,9 +13,11 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <functional>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
@@ -23,12 +25,33 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/kernels/bounds_check.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/gtl/flatmap.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
 
+namespace {
+
+// Hashes the elements of the input of Unique when it runs in parallel.
+// std::hash maps integers to themselves, so the hashes are mixed, both to
+// spread the elements over the partitions and for the open-addressed maps.
+template <typename T>
+struct UniqueHash {
+  size_t operator()(const T& value) const {
+    const uint64 h =
+        static_cast<uint64>(hash<T>{}(value)) * 0x9ddfea08eb382d69ULL;
+    return static_cast<size_t>(h ^ (h >> 32));
+  }
+};
+
+// The minimum number of elements per thread for Unique to run in parallel.
+constexpr int64 kMinParallelUniqueElements = 32768;
+
+}  // namespace
+
 template <typename T, typename TIndex>
 class UniqueOp : public OpKernel {
  public:
@@ -99,7 +122,15 @@ class UniqueOp : public OpKernel {
     auto idx_vec = idx->template vec<TIndex>();
 
     int64 uniq_size;
-    if (new_sizes[0] == 1 && new_sizes[2] == 1) {
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    const int64 num_parts =
+        std::min<int64>(worker_threads.num_threads,
+                        input.NumElements() / kMinParallelUniqueElements);
+    if (new_sizes[0] == 1 && new_sizes[2] == 1 && num_parts > 1) {
+      ComputeInParallel(context, input, num_parts, idx_vec, &uniq_size);
+      if (!context->status().ok()) return;
+    } else if (new_sizes[0] == 1 && new_sizes[2] == 1) {
       // Specialized and faster implementation when unique is run over single
       // elements. Here we put T directly into the map rather than ints pointing
       // to them as in the general case.
@@ -191,6 +222,97 @@ class UniqueOp : public OpKernel {
       }
     }
   }
+
+ private:
+  // Computes the unique elements of the vector `input`, in the order of their
+  // first occurrence, with `num_parts` threads. The input is split into
+  // chunks, whose elements are partitioned by hash; each partition then finds
+  // the first occurrence of its elements, and the first occurrences are
+  // numbered in order of position, chunk by chunk.
+  void ComputeInParallel(OpKernelContext* context, const Tensor& input,
+                         int64 num_parts,
+                         typename TTypes<TIndex>::Vec idx_vec,
+                         int64* uniq_size) {
+    auto Tin = input.flat<T>();
+    const int64 N = static_cast<int64>(Tin.size());
+    const int64 chunk_size = (N + num_parts - 1) / num_parts;
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    // Runs fn(p) for each p in [0, num_parts), each on its own thread.
+    auto parallel_for = [&worker_threads, num_parts, chunk_size](
+                            const std::function<void(int64)>& fn) {
+      Shard(num_parts, worker_threads.workers, num_parts,
+            /*cost_per_unit=*/chunk_size * 1000,
+            [&fn](int64 start, int64 limit) {
+              for (int64 p = start; p < limit; ++p) fn(p);
+            });
+    };
+
+    // The positions of the elements of each chunk that fall in each
+    // partition, in increasing order.
+    std::vector<std::vector<int64>> positions(num_parts * num_parts);
+    parallel_for([&](int64 chunk) {
+      const int64 start = chunk * chunk_size;
+      const int64 limit = std::min(N, start + chunk_size);
+      std::vector<int64>* chunk_positions = &positions[chunk * num_parts];
+      for (int64 i = start; i < limit; ++i) {
+        chunk_positions[UniqueHash<T>{}(Tin(i)) % num_parts].push_back(i);
+      }
+    });
+
+    // The position of the first occurrence of each element.
+    std::vector<int64> first(N);
+    parallel_for([&](int64 part) {
+      gtl::FlatMap<T, int64, UniqueHash<T>> uniq;
+      for (int64 chunk = 0; chunk < num_parts; ++chunk) {
+        for (int64 i : positions[chunk * num_parts + part]) {
+          first[i] = uniq.insert({Tin(i), i}).first->second;
+        }
+      }
+    });
+    positions.clear();
+
+    // The number of unique elements before each chunk.
+    std::vector<int64> chunk_offsets(num_parts + 1, 0);
+    parallel_for([&](int64 chunk) {
+      const int64 start = chunk * chunk_size;
+      const int64 limit = std::min(N, start + chunk_size);
+      int64 count = 0;
+      for (int64 i = start; i < limit; ++i) {
+        if (first[i] == i) ++count;
+      }
+      chunk_offsets[chunk + 1] = count;
+    });
+    for (int64 chunk = 0; chunk < num_parts; ++chunk) {
+      chunk_offsets[chunk + 1] += chunk_offsets[chunk];
+    }
+    *uniq_size = chunk_offsets[num_parts];
+
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                0, TensorShape({*uniq_size}), &output));
+    auto Tout = output->flat<T>();
+
+    // Number the first occurrences, then the other elements after them.
+    parallel_for([&](int64 chunk) {
+      const int64 start = chunk * chunk_size;
+      const int64 limit = std::min(N, start + chunk_size);
+      int64 j = chunk_offsets[chunk];
+      for (int64 i = start; i < limit; ++i) {
+        if (first[i] == i) {
+          Tout(j) = Tin(i);
+          idx_vec(i) = j++;
+        }
+      }
+    });
+    parallel_for([&](int64 chunk) {
+      const int64 start = chunk * chunk_size;
+      const int64 limit = std::min(N, start + chunk_size);
+      for (int64 i = start; i < limit; ++i) {
+        if (first[i] != i) idx_vec(i) = idx_vec(first[i]);
+      }
+    });
+  }
 };
 
 #define REGISTER_UNIQUE(type)                                    \
@@ -15,10 +15,15 @@ limitations under the License.
 
 #include <functional>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/graph/node_builder.h"
@@ -62,6 +67,46 @@ TensorProto GetRandomInt32TensorProtoWithRepeat(int dim, int repeat,
   return tensor_proto;
 }
 
+class UniqueOpTest : public OpsTestBase {};
+
+// Large enough inputs are deduplicated in parallel, which must give the same
+// results as the sequential implementation.
+TEST_F(UniqueOpTest, LargeInputKeepsFirstOccurrenceOrder) {
+  TF_ASSERT_OK(NodeDefBuilder("unique", "UniqueWithCounts")
+                   .Input(FakeInput(DT_INT64))
+                   .Attr("out_idx", DT_INT32)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  const int kNumElements = 1 << 20;
+  std::vector<int64> values(kNumElements);
+  for (int i = 0; i < kNumElements; ++i) {
+    values[i] = (i * 7919LL) % 100003;
+  }
+  AddInputFromArray<int64>(TensorShape({kNumElements}), values);
+  TF_ASSERT_OK(RunOpKernel());
+
+  std::unordered_map<int64, int32> uniq;
+  std::vector<int64> expected_values;
+  std::vector<int32> expected_idx(kNumElements);
+  std::vector<int32> expected_counts;
+  for (int i = 0; i < kNumElements; ++i) {
+    auto it = uniq.insert(std::make_pair(values[i], uniq.size()));
+    if (it.second) {
+      expected_values.push_back(values[i]);
+      expected_counts.push_back(0);
+    }
+    expected_idx[i] = it.first->second;
+    ++expected_counts[it.first->second];
+  }
+  const int num_unique = expected_values.size();
+  test::ExpectTensorEqual<int64>(
+      *GetOutput(0), test::AsTensor<int64>(expected_values, {num_unique}));
+  test::ExpectTensorEqual<int32>(
+      *GetOutput(1), test::AsTensor<int32>(expected_idx, {kNumElements}));
+  test::ExpectTensorEqual<int32>(
+      *GetOutput(2), test::AsTensor<int32>(expected_counts, {num_unique}));
+}
+
 static void BM_Unique_INT32(int iters, int dim, int max_int) {
   testing::StopTiming();
   Graph* g = new Graph(OpRegistry::Global());
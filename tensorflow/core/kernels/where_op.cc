@@ -433,13 +433,21 @@ struct Where<SYCLDevice, NDIM, T, TIndex> {
       auto input_cumsum_acc =
           input_cumsum_buffer.template get_access<cl::sycl::access::mode::read>(cgh);
       auto output_acc =
-          output_buffer.template get_access<cl::sycl::access::mode::discard_write>(cgh);
+          output_buffer.template get_access<cl::sycl::access::mode::write>(cgh);
+      // The tensors may be views into a larger buffer.
+      const size_t input_offset = d.get_offset(input.data()) / sizeof(T);
+      const size_t input_cumsum_offset =
+          d.get_offset(input_cumsum.data()) / sizeof(TIndex);
+      const size_t output_offset = d.get_offset(output.data()) / sizeof(int64);
       cl::sycl::nd_range<1> nd_rng = SYCLUtil::get_nd_range(d, input.size());
       cgh.parallel_for<Where<SYCLDevice, NDIM, T, TIndex>>(nd_rng,
           [=] (cl::sycl::nd_item<1> item) {
-				auto input = ConvertToActualTypeSycl(T, input_acc);
-        auto input_cumsum = ConvertToActualTypeSycl(TIndex, input_cumsum_acc);
-        auto output = ConvertToActualTypeSycl(int64, output_acc);
+        auto input = ConvertToActualTypeSycl(T, input_acc) + input_offset;
+        auto input_cumsum =
+            ConvertToActualTypeSycl(TIndex, input_cumsum_acc) +
+            input_cumsum_offset;
+        auto output = ConvertToActualTypeSycl(int64, output_acc) +
+                      output_offset;
         auto id = item.get_global_id(0);
         if (input[id]) {
           auto row_lin = (input_cumsum[id] - 1) * NDIM;
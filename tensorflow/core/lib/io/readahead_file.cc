@@ -0,0 +1,126 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/lib/io/readahead_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+namespace io {
+
+ReadaheadRandomAccessFile::ReadaheadRandomAccessFile(
+    std::unique_ptr<RandomAccessFile> file, thread::ThreadPool* pool,
+    size_t chunk_size, int num_chunks)
+    : file_(std::move(file)),
+      pool_(pool),
+      chunk_size_(chunk_size),
+      num_chunks_(num_chunks),
+      file_size_(kuint64max) {
+  DCHECK_GT(chunk_size_, 0);
+  DCHECK_GT(num_chunks_, 0);
+}
+
+ReadaheadRandomAccessFile::~ReadaheadRandomAccessFile() {
+  mutex_lock l(mu_);
+  while (num_pending_ > 0) {
+    cond_var_.wait(l);
+  }
+}
+
+void ReadaheadRandomAccessFile::FillWindowLocked(uint64 offset) const {
+  while (!chunks_.empty() && chunks_.front()->offset + chunk_size_ <= offset) {
+    chunks_.pop_front();
+  }
+  if (!chunks_.empty() && chunks_.front()->offset > offset) {
+    chunks_.clear();
+  }
+  if (chunks_.empty()) {
+    next_offset_ = offset;
+  }
+  while (chunks_.size() < static_cast<size_t>(num_chunks_) &&
+         next_offset_ < file_size_) {
+    std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>();
+    chunk->offset = next_offset_;
+    next_offset_ += chunk_size_;
+    chunks_.push_back(chunk);
+    ++num_pending_;
+    pool_->Schedule([this, chunk]() {
+      chunk->data.resize(chunk_size_);
+      StringPiece data;
+      Status s =
+          file_->Read(chunk->offset, chunk_size_, &data, &chunk->data[0]);
+      if (data.data() == chunk->data.data()) {
+        chunk->data.resize(data.size());
+      } else {
+        chunk->data.assign(data.data(), data.size());
+      }
+      mutex_lock l(mu_);
+      if (s.ok() || errors::IsOutOfRange(s)) {
+        if (chunk->data.size() < chunk_size_) {
+          file_size_ = std::min(file_size_, chunk->offset + chunk->data.size());
+        }
+      } else {
+        chunk->status = s;
+      }
+      chunk->done = true;
+      --num_pending_;
+      cond_var_.notify_all();
+    });
+  }
+}
+
+Status ReadaheadRandomAccessFile::Read(uint64 offset, size_t n,
+                                       StringPiece* result,
+                                       char* scratch) const {
+  mutex_lock l(mu_);
+  Status s;
+  size_t bytes_read = 0;
+  while (bytes_read < n) {
+    const uint64 pos = offset + bytes_read;
+    if (pos >= file_size_) {
+      break;
+    }
+    FillWindowLocked(pos);
+    std::shared_ptr<Chunk> chunk = chunks_.front();
+    while (!chunk->done) {
+      cond_var_.wait(l);
+    }
+    if (!chunk->status.ok()) {
+      s = chunk->status;
+      // Issue the read again if the caller retries.
+      chunks_.clear();
+      break;
+    }
+    const size_t chunk_pos = pos - chunk->offset;
+    if (chunk_pos >= chunk->data.size()) {
+      break;
+    }
+    const size_t len =
+        std::min(n - bytes_read, chunk->data.size() - chunk_pos);
+    memcpy(scratch + bytes_read, chunk->data.data() + chunk_pos, len);
+    bytes_read += len;
+  }
+  *result = StringPiece(scratch, bytes_read);
+  if (s.ok() && bytes_read < n) {
+    s = errors::OutOfRange("Read less bytes than requested");
+  }
+  return s;
+}
+
+}  // namespace io
+}  // namespace tensorflow
@@ -0,0 +1,94 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LIB_IO_READAHEAD_FILE_H_
+#define TENSORFLOW_LIB_IO_READAHEAD_FILE_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace io {
+
+// Wraps a RandomAccessFile that is read (mostly) sequentially, and keeps up to
+// `num_chunks` reads of `chunk_size` bytes outstanding ahead of the position
+// of the last read, on the threads of `pool`. This hides the latency of each
+// read on file systems where a read is a round trip to a remote server (e.g.
+// an HTTP range request against GCS), so that reading a single file can use
+// most of the available bandwidth.
+//
+// A read that does not start inside the current window of chunks discards it
+// and starts a new one at its offset.
+//
+// This class is thread-safe, but it is meant to be used by a single reader,
+// such as an InputBuffer or a RecordReader: interleaved reads at distant
+// offsets defeat the readahead.
+class ReadaheadRandomAccessFile : public RandomAccessFile {
+ public:
+  // `pool` must outlive *this.
+  ReadaheadRandomAccessFile(std::unique_ptr<RandomAccessFile> file,
+                            thread::ThreadPool* pool, size_t chunk_size,
+                            int num_chunks);
+
+  // Waits for the outstanding reads to complete.
+  ~ReadaheadRandomAccessFile() override;
+
+  Status Read(uint64 offset, size_t n, StringPiece* result,
+              char* scratch) const override;
+
+ private:
+  // A read of up to `chunk_size_` bytes at `offset`, issued ahead of time.
+  struct Chunk {
+    uint64 offset = 0;
+    string data;
+    bool done = false;
+    Status status;
+  };
+
+  // Makes `chunks_.front()` the chunk covering `offset`, and issues reads
+  // until `num_chunks_` of them are outstanding or the end of the file is
+  // known to be reached.
+  void FillWindowLocked(uint64 offset) const EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const std::unique_ptr<RandomAccessFile> file_;
+  thread::ThreadPool* const pool_;  // Not owned.
+  const size_t chunk_size_;
+  const int num_chunks_;
+
+  mutable mutex mu_;
+  mutable condition_variable cond_var_;
+  mutable std::deque<std::shared_ptr<Chunk>> chunks_ GUARDED_BY(mu_);
+  // Offset of the next chunk to issue.
+  mutable uint64 next_offset_ GUARDED_BY(mu_) = 0;
+  // Size of the file, once a short read has revealed it.
+  mutable uint64 file_size_ GUARDED_BY(mu_);
+  mutable int num_pending_ GUARDED_BY(mu_) = 0;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ReadaheadRandomAccessFile);
+};
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_LIB_IO_READAHEAD_FILE_H_
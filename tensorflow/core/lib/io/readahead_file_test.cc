@@ -0,0 +1,111 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/lib/io/readahead_file.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/inputbuffer.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+string MakeContents(size_t size) {
+  string contents(size, '\0');
+  for (size_t i = 0; i < size; ++i) {
+    contents[i] = static_cast<char>('a' + i % 26);
+  }
+  return contents;
+}
+
+std::unique_ptr<RandomAccessFile> OpenReadahead(const string& contents,
+                                                thread::ThreadPool* pool,
+                                                size_t chunk_size,
+                                                int num_chunks) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/readahead_file_test";
+  TF_CHECK_OK(WriteStringToFile(env, fname, contents));
+  std::unique_ptr<RandomAccessFile> file;
+  TF_CHECK_OK(env->NewRandomAccessFile(fname, &file));
+  return std::unique_ptr<RandomAccessFile>(new ReadaheadRandomAccessFile(
+      std::move(file), pool, chunk_size, num_chunks));
+}
+
+TEST(ReadaheadRandomAccessFile, SequentialReads) {
+  thread::ThreadPool pool(Env::Default(), "readahead_test", 4);
+  const string contents = MakeContents(1000);
+  for (size_t chunk_size : {1, 7, 64, 1000, 4096}) {
+    for (int num_chunks : {1, 4}) {
+      std::unique_ptr<RandomAccessFile> file =
+          OpenReadahead(contents, &pool, chunk_size, num_chunks);
+      for (size_t read_size : {1, 13, 100}) {
+        string scratch(read_size, '\0');
+        uint64 offset = 0;
+        while (offset < contents.size()) {
+          StringPiece result;
+          Status s = file->Read(offset, read_size, &result, &scratch[0]);
+          EXPECT_EQ(contents.substr(offset, read_size), result.ToString());
+          if (offset + read_size <= contents.size()) {
+            TF_EXPECT_OK(s);
+          } else {
+            EXPECT_TRUE(errors::IsOutOfRange(s));
+          }
+          offset += read_size;
+        }
+      }
+    }
+  }
+}
+
+TEST(ReadaheadRandomAccessFile, Seeks) {
+  thread::ThreadPool pool(Env::Default(), "readahead_test", 2);
+  const string contents = MakeContents(1000);
+  std::unique_ptr<RandomAccessFile> file =
+      OpenReadahead(contents, &pool, 64, 3);
+  char scratch[100];
+  StringPiece result;
+  for (uint64 offset : {500, 10, 900, 11, 0, 999}) {
+    const size_t n = std::min<size_t>(100, contents.size() - offset);
+    TF_ASSERT_OK(file->Read(offset, n, &result, scratch));
+    EXPECT_EQ(contents.substr(offset, n), result.ToString());
+  }
+  EXPECT_TRUE(errors::IsOutOfRange(file->Read(1000, 10, &result, scratch)));
+  EXPECT_TRUE(result.empty());
+  EXPECT_TRUE(errors::IsOutOfRange(file->Read(2000, 10, &result, scratch)));
+  EXPECT_TRUE(result.empty());
+}
+
+TEST(ReadaheadRandomAccessFile, InputBuffer) {
+  thread::ThreadPool pool(Env::Default(), "readahead_test", 2);
+  const string contents = MakeContents(10000);
+  std::unique_ptr<RandomAccessFile> file =
+      OpenReadahead(contents, &pool, 256, 4);
+  InputBuffer in(file.get(), 100);
+  string read;
+  TF_ASSERT_OK(in.ReadNBytes(3000, &read));
+  EXPECT_EQ(contents.substr(0, 3000), read);
+  TF_ASSERT_OK(in.SkipNBytes(5000));
+  TF_ASSERT_OK(in.ReadNBytes(1999, &read));
+  EXPECT_EQ(contents.substr(8000, 1999), read);
+  EXPECT_TRUE(errors::IsOutOfRange(in.ReadNBytes(2, &read)));
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace tensorflow
@@ -0,0 +1,92 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/lib/io/record_index.h"
+
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/hash/crc32c.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+// Format of an index file:
+//  uint64    magic number
+//  uint64    interval
+//  uint64    number of records
+//  uint64    end offset
+//  uint64    offsets[ceil(number of records / interval)]
+//  uint32    masked crc of the above
+constexpr uint64 kRecordIndexMagic = 0x7466726563696478ull;  // "tfrecidx"
+constexpr size_t kHeaderFields = 4;
+
+}  // namespace
+
+string RecordIndexFileName(StringPiece fname) {
+  return strings::StrCat(fname, ".index");
+}
+
+Status WriteRecordIndex(Env* env, const string& fname,
+                        const RecordIndex& index) {
+  string data;
+  core::PutFixed64(&data, kRecordIndexMagic);
+  core::PutFixed64(&data, index.interval);
+  core::PutFixed64(&data, index.num_records);
+  core::PutFixed64(&data, index.end_offset);
+  for (uint64 offset : index.offsets) {
+    core::PutFixed64(&data, offset);
+  }
+  core::PutFixed32(&data,
+                   crc32c::Mask(crc32c::Value(data.data(), data.size())));
+  return WriteStringToFile(env, fname, data);
+}
+
+Status ReadRecordIndex(Env* env, const string& fname, RecordIndex* index) {
+  string data;
+  TF_RETURN_IF_ERROR(ReadFileToString(env, fname, &data));
+  const size_t header_size = kHeaderFields * sizeof(uint64);
+  if (data.size() < header_size + sizeof(uint32) ||
+      core::DecodeFixed64(data.data()) != kRecordIndexMagic) {
+    return errors::DataLoss("Not a record index: ", fname);
+  }
+  const size_t crc_pos = data.size() - sizeof(uint32);
+  if (crc32c::Unmask(core::DecodeFixed32(data.data() + crc_pos)) !=
+      crc32c::Value(data.data(), crc_pos)) {
+    return errors::DataLoss("Corrupted record index: ", fname);
+  }
+  const int64 interval = core::DecodeFixed64(data.data() + sizeof(uint64));
+  const int64 num_records =
+      core::DecodeFixed64(data.data() + 2 * sizeof(uint64));
+  if (interval <= 0 || num_records < 0 ||
+      (crc_pos - header_size) % sizeof(uint64) != 0 ||
+      (crc_pos - header_size) / sizeof(uint64) !=
+          (num_records + interval - 1) / interval) {
+    return errors::DataLoss("Inconsistent record index: ", fname);
+  }
+  index->interval = interval;
+  index->num_records = num_records;
+  index->end_offset = core::DecodeFixed64(data.data() + 3 * sizeof(uint64));
+  index->offsets.clear();
+  for (size_t pos = header_size; pos < crc_pos; pos += sizeof(uint64)) {
+    index->offsets.push_back(core::DecodeFixed64(data.data() + pos));
+  }
+  return Status::OK();
+}
+
+}  // namespace io
+}  // namespace tensorflow
@@ -0,0 +1,63 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LIB_IO_RECORD_INDEX_H_
+#define TENSORFLOW_LIB_IO_RECORD_INDEX_H_
+
+#include <vector>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/stringpiece.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+class Env;
+
+namespace io {
+
+// An index of the records of a TFRecord file, holding the offset of every
+// `interval`-th record. A reader can seek to any record by number after
+// reading at most `interval - 1` record headers, and split the file into
+// ranges of records read independently.
+//
+// The offsets are those passed to RecordReader::ReadRecord(), i.e. offsets in
+// the uncompressed records even if the file is compressed.
+struct RecordIndex {
+  // The number of records between two indexed ones.
+  int64 interval = 0;
+  // The number of records in the file.
+  int64 num_records = 0;
+  // The offset of the end of the last record.
+  uint64 end_offset = 0;
+  // offsets[i] is the offset of the record i * interval.
+  std::vector<uint64> offsets;
+};
+
+// Returns the name of the index file written next to the TFRecord file
+// `fname`.
+string RecordIndexFileName(StringPiece fname);
+
+// Writes `index` to the file `fname`.
+Status WriteRecordIndex(Env* env, const string& fname,
+                        const RecordIndex& index);
+
+// Reads the index written by WriteRecordIndex() from the file `fname`.
+Status ReadRecordIndex(Env* env, const string& fname, RecordIndex* index);
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_LIB_IO_RECORD_INDEX_H_
@@ -46,6 +46,13 @@ RecordReaderOptions RecordReaderOptions::CreateRecordReaderOptions(
                << " No compression will be used.";
 #else
     options.zlib_options = io::ZlibCompressionOptions::GZIP();
+#endif  // IS_SLIM_BUILD
+  } else if (compression_type == compression::kSnappy) {
+#if defined(IS_SLIM_BUILD)
+    LOG(ERROR) << "Compression is not supported but compression_type is set."
+               << " No compression will be used.";
+#else
+    options.compression_type = io::RecordReaderOptions::SNAPPY_COMPRESSION;
 #endif  // IS_SLIM_BUILD
   } else if (compression_type != compression::kNone) {
     LOG(ERROR) << "Unsupported compression_type:" << compression_type
@@ -71,6 +78,17 @@ RecordReader::RecordReader(RandomAccessFile* file,
     input_stream_.reset(new ZlibInputStream(
         input_stream_.release(), options.zlib_options.input_buffer_size,
         options.zlib_options.output_buffer_size, options.zlib_options, true));
+#endif  // IS_SLIM_BUILD
+  } else if (options.compression_type ==
+             RecordReaderOptions::SNAPPY_COMPRESSION) {
+#if defined(IS_SLIM_BUILD)
+    LOG(FATAL) << "Snappy compression is unsupported on mobile platforms.";
+#else   // IS_SLIM_BUILD
+    // The input buffer must hold a whole compressed block, whose size is
+    // bounded as in snappy::MaxCompressedLength.
+    const size_t block_bytes = options.snappy_block_bytes;
+    input_stream_.reset(new SnappyInputBuffer(
+        file, 32 + block_bytes + block_bytes / 6, block_bytes));
 #endif  // IS_SLIM_BUILD
   } else if (options.compression_type == RecordReaderOptions::NONE) {
     // Nothing to do.
@@ -108,13 +126,9 @@ Status RecordReader::ReadChecksummed(uint64 offset, size_t n, string* result) {
   return Status::OK();
 }
 
-Status RecordReader::ReadRecord(uint64* offset, string* record) {
-  static const size_t kHeaderSize = sizeof(uint64) + sizeof(uint32);
-  static const size_t kFooterSize = sizeof(uint32);
-
-  // Position the input stream.
+Status RecordReader::PositionInputStream(uint64 offset) {
   int64 curr_pos = input_stream_->Tell();
-  int64 desired_pos = static_cast<int64>(*offset);
+  int64 desired_pos = static_cast<int64>(offset);
   if (curr_pos > desired_pos || curr_pos < 0 /* EOF */ ||
       (curr_pos == desired_pos && last_read_failed_)) {
     last_read_failed_ = false;
@@ -124,6 +138,15 @@ Status RecordReader::ReadRecord(uint64* offset, string* record) {
     TF_RETURN_IF_ERROR(input_stream_->SkipNBytes(desired_pos - curr_pos));
   }
   DCHECK_EQ(desired_pos, input_stream_->Tell());
+  return Status::OK();
+}
+
+Status RecordReader::ReadRecord(uint64* offset, string* record) {
+  static const size_t kHeaderSize = sizeof(uint64) + sizeof(uint32);
+  static const size_t kFooterSize = sizeof(uint32);
+
+  // Position the input stream.
+  TF_RETURN_IF_ERROR(PositionInputStream(*offset));
 
   // Read header data.
   Status s = ReadChecksummed(*offset, sizeof(uint64), record);
@@ -148,6 +171,40 @@ Status RecordReader::ReadRecord(uint64* offset, string* record) {
   return Status::OK();
 }
 
+Status RecordReader::SeekToRecord(const RecordIndex& index,
+                                  int64 record_number, uint64* offset) {
+  static const size_t kHeaderSize = sizeof(uint64) + sizeof(uint32);
+  static const size_t kFooterSize = sizeof(uint32);
+
+  if (record_number < 0 || record_number > index.num_records) {
+    return errors::OutOfRange("Record ", record_number, " is not in [0, ",
+                              index.num_records, "]");
+  }
+  if (record_number == index.num_records) {
+    *offset = index.end_offset;
+    return Status::OK();
+  }
+  if (index.interval <= 0 ||
+      static_cast<size_t>(record_number / index.interval) >=
+          index.offsets.size()) {
+    return errors::InvalidArgument("Invalid record index");
+  }
+  const size_t i = record_number / index.interval;
+  *offset = index.offsets[i];
+  // Skip the records after the indexed one by reading their length only.
+  string header;
+  for (int64 n = i * index.interval; n < record_number; ++n) {
+    TF_RETURN_IF_ERROR(PositionInputStream(*offset));
+    Status s = ReadChecksummed(*offset, sizeof(uint64), &header);
+    if (!s.ok()) {
+      last_read_failed_ = true;
+      return s;
+    }
+    *offset += kHeaderSize + core::DecodeFixed64(header.data()) + kFooterSize;
+  }
+  return Status::OK();
+}
+
 SequentialRecordReader::SequentialRecordReader(
     RandomAccessFile* file, const RecordReaderOptions& options)
     : underlying_(file, options), offset_(0) {}
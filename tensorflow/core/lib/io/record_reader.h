@@ -19,7 +19,9 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
 #include "tensorflow/core/lib/io/inputstream_interface.h"
+#include "tensorflow/core/lib/io/record_index.h"
 #if !defined(IS_SLIM_BUILD)
+#include "tensorflow/core/lib/io/snappy/snappy_inputbuffer.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
 #endif  // IS_SLIM_BUILD
@@ -34,7 +36,11 @@ namespace io {
 
 class RecordReaderOptions {
  public:
-  enum CompressionType { NONE = 0, ZLIB_COMPRESSION = 1 };
+  enum CompressionType {
+    NONE = 0,
+    ZLIB_COMPRESSION = 1,
+    SNAPPY_COMPRESSION = 2
+  };
   CompressionType compression_type = NONE;
 
   // If buffer_size is non-zero, then all reads must be sequential, and no
@@ -48,6 +54,12 @@ class RecordReaderOptions {
 #if !defined(IS_SLIM_BUILD)
   // Options specific to zlib compression.
   ZlibCompressionOptions zlib_options;
+
+  // The largest uncompressed block of a snappy compressed file. Must be at
+  // least the RecordWriterOptions::snappy_block_bytes the file was written
+  // with. Snappy compressed files are read through their own buffers, so
+  // `buffer_size` is ignored.
+  int32 snappy_block_bytes = 256 << 10;
 #endif  // IS_SLIM_BUILD
 };
 
@@ -71,8 +83,16 @@ class RecordReader {
   // OUT_OF_RANGE for end of file, or something else for an error.
   Status ReadRecord(uint64* offset, string* record);
 
+  // Sets *offset to the offset of the record `record_number` (counting from 0)
+  // of the file indexed by `index`, reading the headers of the records between
+  // it and the closest indexed record before it. `record_number` may be the
+  // number of records, for the end of the file.
+  Status SeekToRecord(const RecordIndex& index, int64 record_number,
+                      uint64* offset);
+
  private:
   Status ReadChecksummed(uint64 offset, size_t n, string* result);
+  Status PositionInputStream(uint64 offset);
 
   RecordReaderOptions options_;
   std::unique_ptr<InputStreamInterface> input_stream_;
@@ -22,6 +22,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/compression.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/test.h"
@@ -105,4 +106,183 @@ TEST(RecordReaderWriterTest, TestZlib) {
   }
 }
 
+TEST(RecordReaderWriterTest, TestIndex) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_index_test";
+  const int kNumRecords = 100;
+
+  for (const string& compression_type : {"", "GZIP"}) {
+    {
+      std::unique_ptr<WritableFile> file;
+      TF_CHECK_OK(env->NewWritableFile(fname, &file));
+      io::RecordWriterOptions options =
+          io::RecordWriterOptions::CreateRecordWriterOptions(compression_type);
+      options.index_interval = 8;
+      io::RecordWriter writer(file.get(), options);
+      for (int i = 0; i < kNumRecords; ++i) {
+        TF_EXPECT_OK(writer.WriteRecord(string(i, 'a' + i % 26)));
+      }
+      TF_EXPECT_OK(writer.Close());
+      TF_CHECK_OK(file->Close());
+      EXPECT_EQ(writer.index().num_records, kNumRecords);
+      EXPECT_EQ(writer.index().offsets.size(), 13);
+      TF_CHECK_OK(io::WriteRecordIndex(env, io::RecordIndexFileName(fname),
+                                       writer.index()));
+    }
+
+    io::RecordIndex index;
+    TF_CHECK_OK(
+        io::ReadRecordIndex(env, io::RecordIndexFileName(fname), &index));
+    EXPECT_EQ(index.interval, 8);
+    EXPECT_EQ(index.num_records, kNumRecords);
+
+    std::unique_ptr<RandomAccessFile> read_file;
+    TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+    io::RecordReader reader(
+        read_file.get(),
+        io::RecordReaderOptions::CreateRecordReaderOptions(compression_type));
+    string record;
+    for (int i : {57, 3, 96, 0, 8, 99, 41}) {
+      uint64 offset;
+      TF_CHECK_OK(reader.SeekToRecord(index, i, &offset));
+      TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+      EXPECT_EQ(record, string(i, 'a' + i % 26));
+    }
+    uint64 offset;
+    TF_CHECK_OK(reader.SeekToRecord(index, kNumRecords, &offset));
+    EXPECT_TRUE(errors::IsOutOfRange(reader.ReadRecord(&offset, &record)));
+    EXPECT_TRUE(errors::IsOutOfRange(
+        reader.SeekToRecord(index, kNumRecords + 1, &offset)));
+  }
+
+  // A corrupted index is detected.
+  string data;
+  TF_CHECK_OK(ReadFileToString(env, io::RecordIndexFileName(fname), &data));
+  data[40] ^= 1;
+  TF_CHECK_OK(WriteStringToFile(env, io::RecordIndexFileName(fname), data));
+  io::RecordIndex index;
+  EXPECT_TRUE(errors::IsDataLoss(
+      io::ReadRecordIndex(env, io::RecordIndexFileName(fname), &index)));
+}
+
+TEST(RecordReaderWriterTest, TestParallelCompression) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_parallel_test";
+
+  for (const auto& zlib_options :
+       {io::ZlibCompressionOptions::DEFAULT(),
+        io::ZlibCompressionOptions::GZIP()}) {
+    std::vector<string> records;
+    for (int i = 0; i < 1000; ++i) {
+      records.push_back(strings::StrCat(i, string(i % 97, 'a' + i % 26)));
+    }
+    {
+      std::unique_ptr<WritableFile> file;
+      TF_CHECK_OK(env->NewWritableFile(fname, &file));
+
+      io::RecordWriterOptions options;
+      options.compression_type = io::RecordWriterOptions::ZLIB_COMPRESSION;
+      options.zlib_options = zlib_options;
+      options.num_compression_threads = 4;
+      options.compression_block_bytes = 256;
+      io::RecordWriter writer(file.get(), options);
+      for (size_t i = 0; i < records.size(); ++i) {
+        TF_EXPECT_OK(writer.WriteRecord(records[i]));
+        if (i == records.size() / 2) {
+          TF_EXPECT_OK(writer.Flush());
+        }
+      }
+      TF_EXPECT_OK(writer.Close());
+      TF_CHECK_OK(file->Close());
+    }
+
+    {
+      std::unique_ptr<RandomAccessFile> read_file;
+      TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+      io::RecordReaderOptions options;
+      options.compression_type = io::RecordReaderOptions::ZLIB_COMPRESSION;
+      options.zlib_options = zlib_options;
+      io::RecordReader reader(read_file.get(), options);
+      uint64 offset = 0;
+      string record;
+      for (const string& expected : records) {
+        TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+        EXPECT_EQ(expected, record);
+      }
+      EXPECT_TRUE(errors::IsOutOfRange(reader.ReadRecord(&offset, &record)));
+    }
+  }
+}
+
+TEST(RecordReaderWriterTest, TestSnappy) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_snappy_test";
+
+  // Some of the records are larger than a block.
+  std::vector<string> records;
+  for (int i = 0; i < 100; ++i) {
+    records.push_back(strings::StrCat(i, string(i * 3, 'a' + i % 26)));
+  }
+  std::vector<uint64> offsets;
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+
+    io::RecordWriterOptions options = io::RecordWriterOptions::
+        CreateRecordWriterOptions(io::compression::kSnappy);
+    EXPECT_EQ(io::RecordWriterOptions::SNAPPY_COMPRESSION,
+              options.compression_type);
+    options.snappy_block_bytes = 64;
+    io::RecordWriter writer(file.get(), options);
+    for (size_t i = 0; i < records.size(); ++i) {
+      TF_EXPECT_OK(writer.WriteRecord(records[i]));
+      if (i == records.size() / 2) {
+        TF_EXPECT_OK(writer.Flush());
+      }
+    }
+    TF_EXPECT_OK(writer.Close());
+    TF_CHECK_OK(file->Close());
+  }
+
+  {
+    std::unique_ptr<RandomAccessFile> read_file;
+    TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+    io::RecordReaderOptions options = io::RecordReaderOptions::
+        CreateRecordReaderOptions(io::compression::kSnappy);
+    EXPECT_EQ(io::RecordReaderOptions::SNAPPY_COMPRESSION,
+              options.compression_type);
+    options.snappy_block_bytes = 64;
+    io::RecordReader reader(read_file.get(), options);
+    uint64 offset = 0;
+    string record;
+    for (const string& expected : records) {
+      offsets.push_back(offset);
+      TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+      EXPECT_EQ(expected, record);
+    }
+    EXPECT_TRUE(errors::IsOutOfRange(reader.ReadRecord(&offset, &record)));
+
+    // Seek backwards, then forwards.
+    for (int i : {10, 3, 70}) {
+      offset = offsets[i];
+      TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+      EXPECT_EQ(records[i], record);
+    }
+  }
+
+  {
+    // A reader whose blocks are too small fails instead of overflowing.
+    std::unique_ptr<RandomAccessFile> read_file;
+    TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+    io::RecordReaderOptions options;
+    options.compression_type = io::RecordReaderOptions::SNAPPY_COMPRESSION;
+    options.snappy_block_bytes = 16;
+    io::RecordReader reader(read_file.get(), options);
+    uint64 offset = 0;
+    string record;
+    EXPECT_TRUE(
+        errors::IsResourceExhausted(reader.ReadRecord(&offset, &record)));
+  }
+}
+
 }  // namespace tensorflow
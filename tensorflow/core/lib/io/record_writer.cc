@@ -15,10 +15,17 @@ limitations under the License.
 
 #include "tensorflow/core/lib/io/record_writer.h"
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
 #include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/hash/crc32c.h"
 #include "tensorflow/core/lib/io/compression.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
 
 namespace tensorflow {
 namespace io {
@@ -26,8 +33,151 @@ namespace {
 bool IsZlibCompressed(RecordWriterOptions options) {
   return options.compression_type == RecordWriterOptions::ZLIB_COMPRESSION;
 }
+
+#if !defined(IS_SLIM_BUILD)
+// Compresses `input` into `output` as one complete zlib stream.
+Status DeflateStream(const ZlibCompressionOptions& options, StringPiece input,
+                     string* output) {
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  int error = deflateInit2(&stream, options.compression_level,
+                           options.compression_method, options.window_bits,
+                           options.mem_level, options.compression_strategy);
+  if (error != Z_OK) {
+    return errors::Internal("deflateInit2() failed with error ", error);
+  }
+  output->resize(deflateBound(&stream, input.size()));
+  stream.next_out = reinterpret_cast<Bytef*>(&(*output)[0]);
+  stream.avail_out = output->size();
+  // avail_in is 32 bits, so the input is fed in chunks.
+  constexpr size_t kMaxChunkBytes = 1 << 30;
+  const char* next = input.data();
+  size_t remaining = input.size();
+  do {
+    const size_t chunk = std::min(remaining, kMaxChunkBytes);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(next));
+    stream.avail_in = chunk;
+    next += chunk;
+    remaining -= chunk;
+    error = deflate(&stream, remaining == 0 ? Z_FINISH : Z_NO_FLUSH);
+  } while (remaining > 0 && error == Z_OK);
+  output->resize(output->size() - stream.avail_out);
+  deflateEnd(&stream);
+  if (error != Z_STREAM_END) {
+    return errors::Internal("deflate() failed with error ", error);
+  }
+  return Status::OK();
+}
+#endif  // IS_SLIM_BUILD
 }  // namespace
 
+#if !defined(IS_SLIM_BUILD)
+// Compresses blocks of records on a thread pool, and appends them to the file
+// in order as they are done. Each block is a complete zlib stream; the reader
+// inflates the streams one after the other.
+class RecordWriter::ParallelCompressor {
+ public:
+  ParallelCompressor(WritableFile* dest, const RecordWriterOptions& options)
+      : dest_(dest),
+        zlib_options_(options.zlib_options),
+        block_bytes_(options.compression_block_bytes),
+        max_pending_blocks_(2 * options.num_compression_threads),
+        pool_(Env::Default(), "record_writer",
+              options.num_compression_threads) {}
+
+  // Adds `record`, already framed, to the current block.
+  Status Append(StringPiece record) {
+    block_.append(record.data(), record.size());
+    if (block_.size() >= block_bytes_) {
+      return SubmitBlock();
+    }
+    return Status::OK();
+  }
+
+  // Compresses and writes the current block, and waits for all the blocks to
+  // be written.
+  Status Flush() {
+    if (!block_.empty()) {
+      TF_RETURN_IF_ERROR(SubmitBlock());
+    }
+    mutex_lock l(mu_);
+    while (!pending_.empty()) {
+      cond_var_.wait(l);
+    }
+    return status_;
+  }
+
+ private:
+  struct Block {
+    // The records of the block, then their compressed stream.
+    string data;
+    bool compressed = false;
+  };
+
+  Status SubmitBlock() {
+    auto block = std::make_shared<Block>();
+    block->data.swap(block_);
+    {
+      mutex_lock l(mu_);
+      // Bound the memory held by the blocks in flight.
+      while (status_.ok() && pending_.size() >= max_pending_blocks_) {
+        cond_var_.wait(l);
+      }
+      TF_RETURN_IF_ERROR(status_);
+      pending_.push_back(block);
+    }
+    pool_.Schedule([this, block]() { Compress(block); });
+    return Status::OK();
+  }
+
+  void Compress(const std::shared_ptr<Block>& block) {
+    string compressed;
+    Status s = DeflateStream(zlib_options_, block->data, &compressed);
+    mutex_lock l(mu_);
+    status_.Update(s);
+    block->data.swap(compressed);
+    block->compressed = true;
+    // Only one thread appends to the file at a time, taking the blocks done at
+    // the head of the queue, including those done by other threads meanwhile.
+    if (writing_) return;
+    writing_ = true;
+    while (!pending_.empty() && pending_.front()->compressed) {
+      std::shared_ptr<Block> front = pending_.front();
+      if (status_.ok()) {
+        mu_.unlock();
+        s = dest_->Append(front->data);
+        mu_.lock();
+        status_.Update(s);
+      }
+      pending_.pop_front();
+      cond_var_.notify_all();
+    }
+    writing_ = false;
+  }
+
+  WritableFile* const dest_;  // Not owned.
+  const ZlibCompressionOptions zlib_options_;
+  const size_t block_bytes_;
+  const size_t max_pending_blocks_;
+
+  // The block being filled, only accessed by the caller's thread.
+  string block_;
+
+  mutex mu_;
+  condition_variable cond_var_;
+  // The blocks not written yet, in file order.
+  std::deque<std::shared_ptr<Block>> pending_ GUARDED_BY(mu_);
+  // Whether a thread is appending blocks to the file.
+  bool writing_ GUARDED_BY(mu_) = false;
+  Status status_ GUARDED_BY(mu_);
+
+  // Last, so that its threads are joined first.
+  thread::ThreadPool pool_;
+};
+#else   // IS_SLIM_BUILD
+class RecordWriter::ParallelCompressor {};
+#endif  // IS_SLIM_BUILD
+
 RecordWriterOptions RecordWriterOptions::CreateRecordWriterOptions(
     const string& compression_type) {
   RecordWriterOptions options;
@@ -46,6 +196,13 @@ RecordWriterOptions RecordWriterOptions::CreateRecordWriterOptions(
                << " No compression will be used.";
 #else
     options.zlib_options = io::ZlibCompressionOptions::GZIP();
+#endif  // IS_SLIM_BUILD
+  } else if (compression_type == compression::kSnappy) {
+#if defined(IS_SLIM_BUILD)
+    LOG(ERROR) << "Compression is not supported but compression_type is set."
+               << " No compression will be used.";
+#else
+    options.compression_type = io::RecordWriterOptions::SNAPPY_COMPRESSION;
 #endif  // IS_SLIM_BUILD
   } else if (compression_type != compression::kNone) {
     LOG(ERROR) << "Unsupported compression_type:" << compression_type
@@ -57,11 +214,16 @@ RecordWriterOptions RecordWriterOptions::CreateRecordWriterOptions(
 RecordWriter::RecordWriter(WritableFile* dest,
                            const RecordWriterOptions& options)
     : dest_(dest), options_(options) {
+  index_.interval = options.index_interval;
   if (IsZlibCompressed(options)) {
 // We don't have zlib available on all embedded platforms, so fail.
 #if defined(IS_SLIM_BUILD)
     LOG(FATAL) << "Zlib compression is unsupported on mobile platforms.";
 #else   // IS_SLIM_BUILD
+    if (options.num_compression_threads > 0) {
+      parallel_compressor_.reset(new ParallelCompressor(dest, options));
+      return;
+    }
     ZlibOutputBuffer* zlib_output_buffer = new ZlibOutputBuffer(
         dest, options.zlib_options.input_buffer_size,
         options.zlib_options.output_buffer_size, options.zlib_options);
@@ -71,6 +233,14 @@ RecordWriter::RecordWriter(WritableFile* dest,
                  << s.ToString();
     }
     dest_ = zlib_output_buffer;
+#endif  // IS_SLIM_BUILD
+  } else if (options.compression_type ==
+             RecordWriterOptions::SNAPPY_COMPRESSION) {
+#if defined(IS_SLIM_BUILD)
+    LOG(FATAL) << "Snappy compression is unsupported on mobile platforms.";
+#else   // IS_SLIM_BUILD
+    dest_ = new SnappyOutputBuffer(dest, options.snappy_block_bytes,
+                                   options.snappy_block_bytes);
 #endif  // IS_SLIM_BUILD
   } else if (options.compression_type == RecordWriterOptions::NONE) {
     // Nothing to do
@@ -105,6 +275,22 @@ Status RecordWriter::WriteRecord(StringPiece data) {
   char footer[sizeof(uint32)];
   core::EncodeFixed32(footer, MaskedCrc(data.data(), data.size()));
 
+  if (index_.interval > 0) {
+    if (index_.num_records % index_.interval == 0) {
+      index_.offsets.push_back(index_.end_offset);
+    }
+    ++index_.num_records;
+    index_.end_offset += sizeof(header) + data.size() + sizeof(footer);
+  }
+
+#if !defined(IS_SLIM_BUILD)
+  if (parallel_compressor_) {
+    TF_RETURN_IF_ERROR(
+        parallel_compressor_->Append(StringPiece(header, sizeof(header))));
+    TF_RETURN_IF_ERROR(parallel_compressor_->Append(data));
+    return parallel_compressor_->Append(StringPiece(footer, sizeof(footer)));
+  }
+#endif  // IS_SLIM_BUILD
   TF_RETURN_IF_ERROR(dest_->Append(StringPiece(header, sizeof(header))));
   TF_RETURN_IF_ERROR(dest_->Append(data));
   return dest_->Append(StringPiece(footer, sizeof(footer)));
@@ -112,7 +298,13 @@ Status RecordWriter::WriteRecord(StringPiece data) {
 
 Status RecordWriter::Close() {
 #if !defined(IS_SLIM_BUILD)
-  if (IsZlibCompressed(options_)) {
+  if (parallel_compressor_) {
+    Status s = parallel_compressor_->Flush();
+    parallel_compressor_.reset();
+    dest_ = nullptr;
+    return s;
+  }
+  if (options_.compression_type != RecordWriterOptions::NONE) {
     Status s = dest_->Close();
     delete dest_;
     dest_ = nullptr;
@@ -123,9 +315,14 @@ Status RecordWriter::Close() {
 }
 
 Status RecordWriter::Flush() {
-  if (IsZlibCompressed(options_)) {
+#if !defined(IS_SLIM_BUILD)
+  if (parallel_compressor_) {
+    return parallel_compressor_->Flush();
+  }
+  if (options_.compression_type != RecordWriterOptions::NONE) {
     return dest_->Flush();
   }
+#endif  // IS_SLIM_BUILD
   return Status::OK();
 }
 
@@ -16,9 +16,13 @@ limitations under the License.
 #ifndef TENSORFLOW_LIB_IO_RECORD_WRITER_H_
 #define TENSORFLOW_LIB_IO_RECORD_WRITER_H_
 
+#include <memory>
+
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
+#include "tensorflow/core/lib/io/record_index.h"
 #if !defined(IS_SLIM_BUILD)
+#include "tensorflow/core/lib/io/snappy/snappy_outputbuffer.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_outputbuffer.h"
 #endif  // IS_SLIM_BUILD
@@ -33,15 +37,34 @@ namespace io {
 
 class RecordWriterOptions {
  public:
-  enum CompressionType { NONE = 0, ZLIB_COMPRESSION = 1 };
+  enum CompressionType {
+    NONE = 0,
+    ZLIB_COMPRESSION = 1,
+    SNAPPY_COMPRESSION = 2
+  };
   CompressionType compression_type = NONE;
 
   static RecordWriterOptions CreateRecordWriterOptions(
       const string& compression_type);
 
+  // If positive, the offset of every `index_interval`-th record is kept in the
+  // index returned by RecordWriter::index().
+  int64 index_interval = 0;
+
 // Options specific to zlib compression.
 #if !defined(IS_SLIM_BUILD)
   ZlibCompressionOptions zlib_options;
+
+  // If positive, the records are grouped into blocks of about
+  // `compression_block_bytes`, which are compressed as separate zlib (or gzip)
+  // streams on that many threads and appended to the file in the background.
+  // The file is readable by RecordReader like a single stream.
+  int num_compression_threads = 0;
+  int64 compression_block_bytes = 1 << 20;
+
+  // Options specific to snappy compression: the records are compressed in
+  // blocks of `snappy_block_bytes` of uncompressed data.
+  int32 snappy_block_bytes = 256 << 10;
 #endif  // IS_SLIM_BUILD
 };
 
@@ -72,9 +95,19 @@ class RecordWriter {
   // are invalid.
   Status Close();
 
+  // The index of the records written so far, empty unless
+  // `options.index_interval` is positive. Typically written with
+  // WriteRecordIndex() to RecordIndexFileName() of the file once it is closed.
+  const RecordIndex& index() const { return index_; }
+
  private:
+  class ParallelCompressor;
+
   WritableFile* dest_;
   RecordWriterOptions options_;
+  RecordIndex index_;
+  // Compresses the blocks of records in parallel, if enabled.
+  std::unique_ptr<ParallelCompressor> parallel_compressor_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(RecordWriter);
 };
@@ -51,7 +51,8 @@ class SnappyInputBuffer : public InputStreamInterface {
   // DATA_LOSS:
   //   If uncompression failed or if the file is corrupted.
   // RESOURCE_EXHAUSTED:
-  //   If input_buffer_ is smaller in size than a compressed block.
+  //   If input_buffer_ is smaller in size than a compressed block, or
+  //   output_buffer_ than an uncompressed one.
   // others:
   //   If reading from file failed.
   Status ReadNBytes(int64 bytes_to_read, string* result) override;
@@ -119,6 +120,9 @@ class SnappyInputBuffer : public InputStreamInterface {
   // Number of unread bytes bytes available at `next_out_` in `output_buffer_`.
   size_t avail_out_ = 0;
 
+  // Number of uncompressed bytes read so far.
+  int64 bytes_read_ = 0;
+
   TF_DISALLOW_COPY_AND_ASSIGN(SnappyInputBuffer);
 };
 
@@ -55,27 +55,43 @@ Status SnappyOutputBuffer::Write(StringPiece data) {
     return Status::OK();
   }
 
-  // `data` is too large to fit in input buffer so we deflate it directly.
+  // `data` is too large to fit in input buffer so we deflate it directly, in
+  // blocks no larger than the input buffer so that readers can bound the
+  // size of an uncompressed block.
   // Note that at this point we have already deflated all existing input so
   // we do not need to backup next_in and avail_in.
-  next_in_ = const_cast<char*>(data.data());
-  avail_in_ = bytes_to_write;
+  while (!data.empty()) {
+    next_in_ = const_cast<char*>(data.data());
+    avail_in_ = std::min(data.size(), input_buffer_capacity_);
+    data.remove_prefix(avail_in_);
 
-  TF_RETURN_IF_ERROR(Deflate());
+    TF_RETURN_IF_ERROR(Deflate());
 
-  DCHECK(avail_in_ == 0);  // All input will be used up.
+    DCHECK(avail_in_ == 0);  // All input will be used up.
+  }
 
   next_in_ = input_buffer_.get();
 
   return Status::OK();
 }
 
+Status SnappyOutputBuffer::Append(const StringPiece& data) {
+  return Write(data);
+}
+
 Status SnappyOutputBuffer::Flush() {
   TF_RETURN_IF_ERROR(DeflateBuffered());
   TF_RETURN_IF_ERROR(FlushOutputBufferToFile());
   return Status::OK();
 }
 
+Status SnappyOutputBuffer::Close() { return Flush(); }
+
+Status SnappyOutputBuffer::Sync() {
+  TF_RETURN_IF_ERROR(Flush());
+  return file_->Sync();
+}
+
 int32 SnappyOutputBuffer::AvailableInputSpace() const {
   return input_buffer_capacity_ - avail_in_;
 }
@@ -0,0 +1,159 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#include "tensorflow/core/lib/io/write_behind_file.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace io {
+
+WriteBehindWritableFile::WriteBehindWritableFile(
+    Env* env, std::unique_ptr<WritableFile> file, size_t max_buffered_bytes)
+    : file_(std::move(file)),
+      max_buffered_bytes_(max_buffered_bytes),
+      chunk_bytes_(std::max<size_t>(1, max_buffered_bytes / 4)) {
+  thread_.reset(env->StartThread(ThreadOptions(), "write_behind_file",
+                                 [this]() { WriteLoop(); }));
+}
+
+WriteBehindWritableFile::~WriteBehindWritableFile() {
+  bool closed;
+  {
+    mutex_lock l(mu_);
+    closed = closed_;
+  }
+  if (!closed) {
+    Status s = Close();
+    if (!s.ok()) {
+      LOG(ERROR) << "Failed to close a write-behind file: " << s;
+    }
+  }
+  thread_.reset();
+}
+
+int64 WriteBehindWritableFile::ScheduleLocked(OpType type) {
+  if (!buffer_.empty()) {
+    ops_.push_back(Op{OpType::kAppend, std::move(buffer_)});
+    buffer_.clear();
+    ++num_scheduled_;
+  }
+  if (type != OpType::kAppend) {
+    ops_.push_back(Op{type, string()});
+    ++num_scheduled_;
+  }
+  cond_var_.notify_all();
+  return num_scheduled_;
+}
+
+Status WriteBehindWritableFile::Append(const StringPiece& data) {
+  mutex_lock l(mu_);
+  if (closed_) {
+    return errors::FailedPrecondition("Append to a closed file");
+  }
+  TF_RETURN_IF_ERROR(status_);
+  buffer_.append(data.data(), data.size());
+  buffered_bytes_ += data.size();
+  if (buffer_.size() >= chunk_bytes_) {
+    ScheduleLocked(OpType::kAppend);
+  }
+  while (buffered_bytes_ > max_buffered_bytes_ && status_.ok()) {
+    cond_var_.wait(l);
+  }
+  return status_;
+}
+
+Status WriteBehindWritableFile::Flush() {
+  mutex_lock l(mu_);
+  if (closed_) {
+    return errors::FailedPrecondition("Flush of a closed file");
+  }
+  ScheduleLocked(OpType::kFlush);
+  return status_;
+}
+
+Status WriteBehindWritableFile::Sync() {
+  mutex_lock l(mu_);
+  if (closed_) {
+    return errors::FailedPrecondition("Sync of a closed file");
+  }
+  const int64 op = ScheduleLocked(OpType::kSync);
+  while (num_done_ < op) {
+    cond_var_.wait(l);
+  }
+  return status_;
+}
+
+Status WriteBehindWritableFile::Close() {
+  mutex_lock l(mu_);
+  if (closed_) {
+    return status_;
+  }
+  closed_ = true;
+  const int64 op = ScheduleLocked(OpType::kClose);
+  while (num_done_ < op) {
+    cond_var_.wait(l);
+  }
+  return status_;
+}
+
+void WriteBehindWritableFile::WriteLoop() {
+  while (true) {
+    Op op;
+    bool failed;
+    {
+      mutex_lock l(mu_);
+      while (ops_.empty()) {
+        cond_var_.wait(l);
+      }
+      op = std::move(ops_.front());
+      ops_.pop_front();
+      failed = !status_.ok();
+    }
+    Status s;
+    switch (op.type) {
+      case OpType::kAppend:
+        if (!failed) s = file_->Append(op.data);
+        break;
+      case OpType::kFlush:
+        if (!failed) s = file_->Flush();
+        break;
+      case OpType::kSync:
+        if (!failed) s = file_->Sync();
+        break;
+      case OpType::kClose:
+        // The file is closed even after an error.
+        s = file_->Close();
+        break;
+    }
+    {
+      mutex_lock l(mu_);
+      status_.Update(s);
+      if (op.type == OpType::kAppend) {
+        buffered_bytes_ -= op.data.size();
+      }
+      ++num_done_;
+      cond_var_.notify_all();
+    }
+    if (op.type == OpType::kClose) return;
+  }
+}
+
+}  // namespace io
+}  // namespace tensorflow
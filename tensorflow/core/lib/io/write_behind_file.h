@@ -0,0 +1,105 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#ifndef TENSORFLOW_LIB_IO_WRITE_BEHIND_FILE_H_
+#define TENSORFLOW_LIB_IO_WRITE_BEHIND_FILE_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace io {
+
+// Wraps a WritableFile so that the appends to it, and its flushes, happen on a
+// background thread. This keeps the latency of the underlying file system
+// (e.g. an upload to GCS on Flush()) off the caller, for writes whose
+// durability does not matter until the file is closed.
+//
+// Append() only copies the data into a buffer. It blocks only while more than
+// `max_buffered_bytes` are waiting to be written. Flush() schedules the
+// buffered data to be written and the file to be flushed, without waiting.
+// Sync() and Close() wait for all the scheduled writes to complete.
+//
+// The first error of the underlying file is returned by the next call, and by
+// all the calls after it. Once an error occurred, the data appended is
+// dropped.
+//
+// Like other WritableFiles, this class must not be used by several threads
+// concurrently.
+class WriteBehindWritableFile : public WritableFile {
+ public:
+  WriteBehindWritableFile(Env* env, std::unique_ptr<WritableFile> file,
+                          size_t max_buffered_bytes);
+
+  // Closes the file if Close() was not called, and logs any error.
+  ~WriteBehindWritableFile() override;
+
+  Status Append(const StringPiece& data) override;
+  Status Flush() override;
+  Status Sync() override;
+  Status Close() override;
+
+ private:
+  enum class OpType { kAppend, kFlush, kSync, kClose };
+  struct Op {
+    OpType type;
+    string data;  // For kAppend.
+  };
+
+  // Schedules the buffered data to be appended to the file, followed by an
+  // operation of `type` unless it is kAppend. Returns the number of
+  // operations scheduled so far.
+  int64 ScheduleLocked(OpType type) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Runs the scheduled operations, until the file is closed.
+  void WriteLoop();
+
+  const std::unique_ptr<WritableFile> file_;
+  const size_t max_buffered_bytes_;
+  // The size at which the buffered data is scheduled to be appended.
+  const size_t chunk_bytes_;
+
+  mutex mu_;
+  condition_variable cond_var_;
+  // The data appended since the last scheduled append.
+  string buffer_ GUARDED_BY(mu_);
+  std::deque<Op> ops_ GUARDED_BY(mu_);
+  // The bytes appended and not yet written to `file_`, including `buffer_`.
+  size_t buffered_bytes_ GUARDED_BY(mu_) = 0;
+  int64 num_scheduled_ GUARDED_BY(mu_) = 0;
+  int64 num_done_ GUARDED_BY(mu_) = 0;
+  bool closed_ GUARDED_BY(mu_) = false;
+  Status status_ GUARDED_BY(mu_);
+
+  // Last, so that it is joined first.
+  std::unique_ptr<Thread> thread_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(WriteBehindWritableFile);
+};
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_LIB_IO_WRITE_BEHIND_FILE_H_
@@ -0,0 +1,137 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+
+#include "tensorflow/core/lib/io/write_behind_file.h"
+
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+// A file recording what is written to it, whose appends block until
+// `unblock` is notified, and fail once `fail_appends` is set.
+class TestFile : public WritableFile {
+ public:
+  explicit TestFile(Notification* unblock) : unblock_(unblock) {}
+
+  Status Append(const StringPiece& data) override {
+    unblock_->WaitForNotification();
+    if (fail_appends) return errors::Unavailable("Append failed");
+    mutex_lock l(mu_);
+    contents_.append(data.data(), data.size());
+    return Status::OK();
+  }
+  Status Flush() override {
+    mutex_lock l(mu_);
+    ++num_flushes_;
+    return Status::OK();
+  }
+  Status Sync() override { return Flush(); }
+  Status Close() override {
+    mutex_lock l(mu_);
+    closed_ = true;
+    return Status::OK();
+  }
+
+  string contents() {
+    mutex_lock l(mu_);
+    return contents_;
+  }
+  int num_flushes() {
+    mutex_lock l(mu_);
+    return num_flushes_;
+  }
+  bool closed() {
+    mutex_lock l(mu_);
+    return closed_;
+  }
+
+  bool fail_appends = false;
+
+ private:
+  Notification* const unblock_;
+  mutex mu_;
+  string contents_ GUARDED_BY(mu_);
+  int num_flushes_ GUARDED_BY(mu_) = 0;
+  bool closed_ GUARDED_BY(mu_) = false;
+};
+
+TEST(WriteBehindWritableFile, WritesInOrder) {
+  Notification unblock;
+  unblock.Notify();
+  TestFile* test_file = new TestFile(&unblock);
+  WriteBehindWritableFile file(Env::Default(),
+                               std::unique_ptr<WritableFile>(test_file), 64);
+  string expected;
+  for (int i = 0; i < 1000; ++i) {
+    const string data = strings::StrCat(i, ",");
+    TF_ASSERT_OK(file.Append(data));
+    expected += data;
+    if (i % 100 == 0) {
+      TF_ASSERT_OK(file.Flush());
+    }
+  }
+  TF_ASSERT_OK(file.Append(string(1000, 'x')));
+  expected += string(1000, 'x');
+  TF_ASSERT_OK(file.Sync());
+  EXPECT_EQ(expected, test_file->contents());
+  EXPECT_EQ(11, test_file->num_flushes());
+  TF_ASSERT_OK(file.Close());
+  EXPECT_TRUE(test_file->closed());
+  EXPECT_TRUE(errors::IsFailedPrecondition(file.Append("a")));
+}
+
+TEST(WriteBehindWritableFile, DoesNotBlockOnSlowWrites) {
+  Notification unblock;
+  TestFile* test_file = new TestFile(&unblock);
+  WriteBehindWritableFile file(Env::Default(),
+                               std::unique_ptr<WritableFile>(test_file), 100);
+  // The appends and flushes return while the underlying file is stuck.
+  for (int i = 0; i < 10; ++i) {
+    TF_ASSERT_OK(file.Append("0123456789"));
+    TF_ASSERT_OK(file.Flush());
+  }
+  EXPECT_EQ("", test_file->contents());
+  unblock.Notify();
+  TF_ASSERT_OK(file.Close());
+  EXPECT_EQ(100, test_file->contents().size());
+  EXPECT_TRUE(test_file->closed());
+}
+
+TEST(WriteBehindWritableFile, ReturnsErrors) {
+  Notification unblock;
+  TestFile* test_file = new TestFile(&unblock);
+  test_file->fail_appends = true;
+  WriteBehindWritableFile file(Env::Default(),
+                               std::unique_ptr<WritableFile>(test_file), 4);
+  TF_ASSERT_OK(file.Append("ab"));
+  unblock.Notify();
+  // Exceeds the buffer, so waits for the failed append.
+  EXPECT_TRUE(errors::IsUnavailable(file.Append("cdefgh")));
+  EXPECT_TRUE(errors::IsUnavailable(file.Sync()));
+  EXPECT_TRUE(errors::IsUnavailable(file.Close()));
+  EXPECT_TRUE(test_file->closed());
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace tensorflow
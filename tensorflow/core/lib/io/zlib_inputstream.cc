@@ -197,6 +197,14 @@ Status ZlibInputStream::Inflate() {
     }
     return errors::DataLoss(error_string);
   }
+  if (error == Z_STREAM_END) {
+    // Streams may be concatenated, as written by parallel compression. Reset
+    // the state to inflate the next one, if any, from the remaining input.
+    error = inflateReset(z_stream_.get());
+    if (error != Z_OK) {
+      return errors::DataLoss("inflateReset() failed with error ", error);
+    }
+  }
   return Status::OK();
 }
 
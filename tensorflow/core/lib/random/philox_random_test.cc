@@ -68,6 +68,48 @@ TEST(PhiloxRandomTest, SkipMatchTest) {
   }
 }
 
+// This test checks that the batched generators return the same stream as
+// PhiloxRandom, including when the lowest counter word wraps around.
+TEST(PhiloxRandomTest, GenerateMatchTest) {
+  constexpr int count = 203;
+
+  PhiloxRandom::ResultType counter;
+  counter[0] = 0xFFFFFFFFu - 37;
+  counter[1] = 0xFFFFFFFFu;
+  counter[2] = 17;
+  PhiloxRandom::Key key;
+  key[0] = static_cast<uint32>(GetTestSeed());
+  key[1] = 5;
+  for (const PhiloxRandom& start :
+       {PhiloxRandom(GetTestSeed()), PhiloxRandom(counter, key)}) {
+    std::vector<PhiloxRandom::ResultType> expected(count);
+    PhiloxRandom gen = start;
+    for (int i = 0; i < count; ++i) {
+      expected[i] = gen();
+    }
+
+    std::vector<PhiloxRandom::ResultType> generated(count);
+    gen = start;
+    gen.Generate(generated.data(), count);
+    BatchedPhiloxRandom batched_gen(start);
+    for (int i = 0; i < count; ++i) {
+      const PhiloxRandom::ResultType batched = batched_gen();
+      for (int j = 0; j < PhiloxRandom::kResultElementCount; ++j) {
+        ASSERT_EQ(expected[i][j], generated[i][j]);
+        ASSERT_EQ(expected[i][j], batched[j]);
+      }
+    }
+    // Generate leaves the generator where operator() would.
+    PhiloxRandom::ResultType next = gen();
+    PhiloxRandom expected_gen = start;
+    expected_gen.Skip(count);
+    PhiloxRandom::ResultType expected_next = expected_gen();
+    for (int j = 0; j < PhiloxRandom::kResultElementCount; ++j) {
+      ASSERT_EQ(expected_next[j], next[j]);
+    }
+  }
+}
+
 }  // namespace
 }  // namespace random
 }  // namespace tensorflow
@@ -87,6 +87,37 @@ Status DecodeImageShapeFn(InferenceContext* c) {
   return Status::OK();
 }
 
+// Shape function of the ops decoding a batch of JPEG images into a 4-D
+// tensor. `crop_windows`, if not null, holds the crop window of each image.
+Status DecodeJpegBatchShapeFn(InferenceContext* c,
+                              const Tensor* crop_windows) {
+  ShapeHandle contents;
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &contents));
+  DimensionHandle batch_dim = c->Dim(contents, 0);
+  DimensionHandle channels_dim = c->UnknownDim();
+  DimensionHandle h = c->UnknownDim();
+  DimensionHandle w = c->UnknownDim();
+
+  int32 channels;
+  TF_RETURN_IF_ERROR(c->GetAttr("channels", &channels));
+  if (channels != 0) {
+    if (channels < 0) {
+      return errors::InvalidArgument("channels must be non-negative, got ",
+                                     channels);
+    }
+    channels_dim = c->MakeDim(channels);
+  }
+
+  // All the crop windows must have the size of the first one.
+  if (crop_windows != nullptr && crop_windows->dim_size(0) > 0) {
+    auto crop_windows_mat = crop_windows->matrix<int32>();
+    h = c->MakeDim(crop_windows_mat(0, 2));
+    w = c->MakeDim(crop_windows_mat(0, 3));
+  }
+  c->set_output(0, c->MakeShape({batch_dim, h, w, channels_dim}));
+  return Status::OK();
+}
+
 Status EncodeImageShapeFn(InferenceContext* c) {
   ShapeHandle unused;
   TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 3, &unused));
@@ -311,6 +342,42 @@ REGISTER_OP("DecodeAndCropJpeg")
       return Status::OK();
     });
 
+// --------------------------------------------------------------------------
+REGISTER_OP("DecodeJpegBatch")
+    .Input("contents: string")
+    .Attr("channels: int = 0")
+    .Attr("ratio: int = 1")
+    .Attr("fancy_upscaling: bool = true")
+    .Attr("try_recover_truncated: bool = false")
+    .Attr("acceptable_fraction: float = 1.0")
+    .Attr("dct_method: string = ''")
+    .Output("images: uint8")
+    .SetShapeFn([](InferenceContext* c) {
+      return DecodeJpegBatchShapeFn(c, nullptr);
+    });
+
+// --------------------------------------------------------------------------
+REGISTER_OP("DecodeAndCropJpegBatch")
+    .Input("contents: string")
+    .Input("crop_windows: int32")
+    .Attr("channels: int = 0")
+    .Attr("ratio: int = 1")
+    .Attr("fancy_upscaling: bool = true")
+    .Attr("try_recover_truncated: bool = false")
+    .Attr("acceptable_fraction: float = 1.0")
+    .Attr("dct_method: string = ''")
+    .Output("images: uint8")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle crop_windows;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 2, &crop_windows));
+      DimensionHandle unused_dim;
+      TF_RETURN_IF_ERROR(
+          c->WithValue(c->Dim(crop_windows, 1), 4, &unused_dim));
+      TF_RETURN_IF_ERROR(c->Merge(c->Dim(crop_windows, 0),
+                                  c->Dim(c->input(0), 0), &unused_dim));
+      return DecodeJpegBatchShapeFn(c, c->input_tensor(1));
+    });
+
 // --------------------------------------------------------------------------
 REGISTER_OP("EncodeJpeg")
     .Input("image: uint8")
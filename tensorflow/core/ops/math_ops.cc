@@ -42,6 +42,46 @@ REGISTER_OP("AddN")
       return Status::OK();
     });
 
+REGISTER_OP("_GroupedAddN")
+    .Input("inputs: N * T")
+    .Output("sum: num_groups * T")
+    .Attr("N: int >= 1")
+    .Attr("num_groups: int >= 1")
+    .Attr("group_sizes: list(int)")
+    .Attr("T: numbertype")
+    .SetShapeFn([](InferenceContext* c) {
+      std::vector<int32> group_sizes;
+      TF_RETURN_IF_ERROR(c->GetAttr("group_sizes", &group_sizes));
+      if (static_cast<int>(group_sizes.size()) != c->num_outputs()) {
+        return errors::InvalidArgument("Expected ", c->num_outputs(),
+                                       " group sizes, got ",
+                                       group_sizes.size());
+      }
+      int first = 0;
+      for (int group = 0; group < c->num_outputs(); ++group) {
+        const int last = first + group_sizes[group] - 1;
+        if (group_sizes[group] < 1 || last >= c->num_inputs()) {
+          return errors::InvalidArgument("Invalid group sizes");
+        }
+        ShapeHandle cur = c->input(last);
+        for (int i = last - 1; i >= first; --i) {
+          TF_RETURN_WITH_CONTEXT_IF_ERROR(c->Merge(c->input(i), cur, &cur),
+                                          "From merging shape ", i,
+                                          " with other shapes.");
+        }
+        c->set_output(group, cur);
+        first = last + 1;
+      }
+      return Status::OK();
+    })
+    .Doc(R"doc(
+Computes num_groups independent AddN sums in a single op.
+
+The inputs are the concatenation of the inputs of the sums, the i-th sum
+adding the next group_sizes[i] inputs. This op is created by the graph
+optimizer and is not meant to be used directly.
+)doc");
+
 // --------------------------------------------------------------------------
 
 // Note that the following operator is just a placeholder and has no
@@ -128,6 +168,25 @@ Cast x of type SrcT to y of DstT.
 _HostCast requires its input and produces its output in host memory.
 )doc");
 
+REGISTER_OP("_GroupedCast")
+    .Input("x: N * SrcT")
+    .Output("y: N * DstT")
+    .Attr("N: int >= 1")
+    .Attr("SrcT: type")
+    .Attr("DstT: type")
+    .SetShapeFn([](InferenceContext* c) {
+      for (int i = 0; i < c->num_outputs(); ++i) {
+        c->set_output(i, c->input(i));
+      }
+      return Status::OK();
+    })
+    .Doc(R"doc(
+Casts N tensors of type SrcT to DstT in a single op.
+
+This op is created by the graph optimizer and is not meant to be used
+directly.
+)doc");
+
 // --------------------------------------------------------------------------
 
 REGISTER_OP("Abs")
@@ -1566,6 +1625,26 @@ REGISTER_OP("ClipByValue")
     .Attr("T: numbertype")
     .SetShapeFn(shape_inference::UnchangedShape);
 
+REGISTER_OP("_FusedElementwise")
+    .Input("x: T")
+    .Input("args: num_args * T")
+    .Output("y: T")
+    .Attr("T: {float, double}")
+    .Attr("num_args: int >= 0")
+    .Attr("fused_ops: list(string)")
+    .SetShapeFn(shape_inference::UnchangedShape)
+    .Doc(R"doc(
+Applies a chain of element-wise operations to x in a single pass.
+
+The ops in fused_ops are applied in order, each one to the result of the
+previous one. Binary ops consume the next tensor of args as their second
+operand, which must either have the same shape as x, be a scalar, or be a
+vector broadcast along the last dimension of x like the bias of BiasAdd.
+
+This op is created by the graph optimizer and is not meant to be used
+directly.
+)doc");
+
 #ifdef INTEL_MKL
 REGISTER_OP("_MklAddN")
     .Input("inputs: N * T")
@@ -274,6 +274,56 @@ REGISTER_OP("Conv2D")
     .Attr("dilations: list(int) = [1, 1, 1, 1]")
     .SetShapeFn(shape_inference::Conv2DShape);
 
+REGISTER_OP("_FusedConv2D")
+    .Input("input: T")
+    .Input("filter: T")
+    .Input("args: num_args * T")
+    .Output("output: T")
+    .Attr("T: {float, double}")
+    .Attr("num_args: int >= 0")
+    .Attr("strides: list(int)")
+    .Attr("use_cudnn_on_gpu: bool = true")
+    .Attr(GetPaddingAttrString())
+    .Attr(GetConvnetDataFormatAttrString())
+    .Attr("dilations: list(int) = [1, 1, 1, 1]")
+    .Attr("fused_ops: list(string) = []")
+    .Attr("epsilon: float = 0.0001")
+    .SetShapeFn(shape_inference::Conv2DShape)
+    .Doc(R"doc(
+Computes a Conv2D followed by a chain of element-wise ops.
+
+The element-wise ops in fused_ops, such as BiasAdd and Relu, are applied to
+the output of the convolution in order, with the same semantics as in
+_FusedElementwise.
+
+On CPU, fused_ops must be BiasAdd or FusedBatchNorm, optionally followed by
+Relu, Relu6 or Elu. The args are the bias, or the scale, offset, mean and
+variance of an inference FusedBatchNorm, whose variance epsilon is epsilon.
+
+This op is created by the graph optimizer and is not meant to be used
+directly.
+)doc");
+
+REGISTER_OP("_FusedMatMul")
+    .Input("a: T")
+    .Input("b: T")
+    .Input("args: num_args * T")
+    .Output("product: T")
+    .Attr("transpose_a: bool = false")
+    .Attr("transpose_b: bool = false")
+    .Attr("T: {float, double}")
+    .Attr("num_args: int >= 0")
+    .Attr("fused_ops: list(string) = []")
+    .Attr("epsilon: float = 0.0001")
+    .SetShapeFn(shape_inference::MatMulShape)
+    .Doc(R"doc(
+Computes a MatMul followed by a BiasAdd, optionally followed by Relu, Relu6 or
+Elu, as listed in fused_ops. The args hold the bias.
+
+This op is created by the graph optimizer and is not meant to be used
+directly.
+)doc");
+
 REGISTER_OP("Conv2DBackpropInput")
     .Input("input_sizes: int32")
     .Input("filter: T")
@@ -667,6 +717,24 @@ REGISTER_OP("L2Loss")
     .Attr("T: {half, bfloat16, float, double}")
     .SetShapeFn(shape_inference::ScalarShape);
 
+REGISTER_OP("_GroupedL2Loss")
+    .Input("t: N * T")
+    .Output("output: N * T")
+    .Attr("N: int >= 1")
+    .Attr("T: {half, bfloat16, float, double}")
+    .SetShapeFn([](InferenceContext* c) {
+      for (int i = 0; i < c->num_outputs(); ++i) {
+        c->set_output(i, c->Scalar());
+      }
+      return Status::OK();
+    })
+    .Doc(R"doc(
+Computes the L2Loss of N tensors in a single op.
+
+This op is created by the graph optimizer and is not meant to be used
+directly.
+)doc");
+
 // --------------------------------------------------------------------------
 
 REGISTER_OP("LRN")
@@ -1518,6 +1586,7 @@ REGISTER_OP("_MklConv2D")
     .Attr(GetPaddingAttrString())
     .Attr(GetConvnetDataFormatAttrString())
     .Attr("dilations: list(int) = [1, 1, 1, 1]")
+    .Attr("is_filter_const: bool = false")
     .SetShapeFn(shape_inference::Conv2DShape)
     .Doc(R"doc(
 MKL version of Conv2D operator. Uses MKL DNN APIs to perform 2D convolution.
@@ -1537,6 +1606,7 @@ REGISTER_OP("__MklDummyConv2DWithBias")
     .Attr(GetPaddingAttrString())
     .Attr(GetConvnetDataFormatAttrString())
     .Attr("dilations: list(int) = [1, 1, 1, 1]")
+    .Attr("is_filter_const: bool = false")
     .SetShapeFn(shape_inference::Conv2DShape)
     .Doc(R"doc(
 Dummy node that enables fusing Conv2D and BiasAdd operator for MKL. This node
@@ -1564,6 +1634,7 @@ REGISTER_OP("_MklConv2DWithBias")
     .Attr(GetPaddingAttrString())
     .Attr(GetConvnetDataFormatAttrString())
     .Attr("dilations: list(int) = [1, 1, 1, 1]")
+    .Attr("is_filter_const: bool = false")
     .SetShapeFn(shape_inference::Conv2DShape)
     .Doc(R"doc(
 MKL version of Conv2D and BiasAdd operator. Uses MKL DNN APIs to perform
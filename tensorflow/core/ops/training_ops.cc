@@ -741,6 +741,125 @@ REGISTER_OP("ResourceApplyAdam")
       return ApplyAdamShapeFn(c, false /* sparse */);
     });
 
+// Shape function of the _Grouped ops created by the op grouping optimizer,
+// whose every argument is a list of one input per grouped op. The first
+// num_vars arguments are variables with the shape of the grad argument at
+// index grad_arg, the others scalars.
+static Status GroupedApplyShapeFn(InferenceContext* c, int num_vars,
+                                  int num_args, int grad_arg) {
+  int n;
+  TF_RETURN_IF_ERROR(c->GetAttr("N", &n));
+  for (int i = 0; i < n; ++i) {
+    ShapeHandle unused;
+    ShapeHandle s = ShapeOrHandleShape(c, i);
+    for (int arg = 1; arg < num_args; ++arg) {
+      if (arg < num_vars) {
+        TF_RETURN_IF_ERROR(c->Merge(s, ShapeOrHandleShape(c, arg * n + i), &s));
+      } else if (arg == grad_arg) {
+        TF_RETURN_IF_ERROR(c->Merge(s, c->input(arg * n + i), &s));
+      } else {
+        TF_RETURN_IF_ERROR(c->WithRank(c->input(arg * n + i), 0, &unused));
+      }
+    }
+    if (c->num_outputs() > 0) {
+      c->set_output(i, s);
+    }
+  }
+  return Status::OK();
+}
+
+REGISTER_OP("_GroupedApplyMomentum")
+    .Input("var: N * Ref(T)")
+    .Input("accum: N * Ref(T)")
+    .Input("lr: N * T")
+    .Input("grad: N * T")
+    .Input("momentum: N * T")
+    .Output("out: N * Ref(T)")
+    .Attr("N: int >= 1")
+    .Attr("T: numbertype")
+    .Attr("use_locking: bool = false")
+    .Attr("use_nesterov: bool = false")
+    .SetShapeFn([](InferenceContext* c) {
+      return GroupedApplyShapeFn(c, 2, 5, 3 /* grad_arg */);
+    })
+    .Doc(R"doc(
+Applies N independent ApplyMomentum updates in a single op.
+
+Input i of each list belongs to the i-th update. This op is created by the
+graph optimizer and is not meant to be used directly.
+)doc");
+
+REGISTER_OP("_GroupedResourceApplyMomentum")
+    .Input("var: N * resource")
+    .Input("accum: N * resource")
+    .Input("lr: N * T")
+    .Input("grad: N * T")
+    .Input("momentum: N * T")
+    .Attr("N: int >= 1")
+    .Attr("T: numbertype")
+    .Attr("use_locking: bool = false")
+    .Attr("use_nesterov: bool = false")
+    .SetShapeFn([](InferenceContext* c) {
+      return GroupedApplyShapeFn(c, 2, 5, 3 /* grad_arg */);
+    })
+    .Doc(R"doc(
+Applies N independent ResourceApplyMomentum updates in a single op.
+
+Input i of each list belongs to the i-th update. This op is created by the
+graph optimizer and is not meant to be used directly.
+)doc");
+
+REGISTER_OP("_GroupedApplyAdam")
+    .Input("var: N * Ref(T)")
+    .Input("m: N * Ref(T)")
+    .Input("v: N * Ref(T)")
+    .Input("beta1_power: N * T")
+    .Input("beta2_power: N * T")
+    .Input("lr: N * T")
+    .Input("beta1: N * T")
+    .Input("beta2: N * T")
+    .Input("epsilon: N * T")
+    .Input("grad: N * T")
+    .Output("out: N * Ref(T)")
+    .Attr("N: int >= 1")
+    .Attr("T: numbertype")
+    .Attr("use_locking: bool = false")
+    .Attr("use_nesterov: bool = false")
+    .SetShapeFn([](InferenceContext* c) {
+      return GroupedApplyShapeFn(c, 3, 10, 9 /* grad_arg */);
+    })
+    .Doc(R"doc(
+Applies N independent ApplyAdam updates in a single op.
+
+Input i of each list belongs to the i-th update. This op is created by the
+graph optimizer and is not meant to be used directly.
+)doc");
+
+REGISTER_OP("_GroupedResourceApplyAdam")
+    .Input("var: N * resource")
+    .Input("m: N * resource")
+    .Input("v: N * resource")
+    .Input("beta1_power: N * T")
+    .Input("beta2_power: N * T")
+    .Input("lr: N * T")
+    .Input("beta1: N * T")
+    .Input("beta2: N * T")
+    .Input("epsilon: N * T")
+    .Input("grad: N * T")
+    .Attr("N: int >= 1")
+    .Attr("T: numbertype")
+    .Attr("use_locking: bool = false")
+    .Attr("use_nesterov: bool = false")
+    .SetShapeFn([](InferenceContext* c) {
+      return GroupedApplyShapeFn(c, 3, 10, 9 /* grad_arg */);
+    })
+    .Doc(R"doc(
+Applies N independent ResourceApplyAdam updates in a single op.
+
+Input i of each list belongs to the i-th update. This op is created by the
+graph optimizer and is not meant to be used directly.
+)doc");
+
 static Status ApplyAdaMaxShapeFn(InferenceContext* c, bool sparse) {
   ShapeHandle unused;
   ShapeHandle s = ShapeOrHandleShape(c, 0);                       // var
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include <algorithm>
+#include <vector>
 
 #include "tensorflow/core/platform/cloud/curl_http_request.h"
 
@@ -22,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/scanner.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/public/version.h"
 
@@ -34,7 +36,16 @@ namespace {
 // Set to 1 to enable verbose debug output from curl.
 constexpr uint64 kVerboseOutput = 0;
 
+// The maximum number of idle curl handles kept for reuse.
+constexpr size_t kMaxIdleHandles = 64;
+
 // Proxy to the real libcurl implementation.
+//
+// The curl handles are pooled: a cleaned up handle is reset and kept for the
+// next request, along with its open connections, so that requests from any
+// thread reuse the keep-alive connections of the previous ones. The handles
+// also share their DNS and TLS session caches, so that a new connection skips
+// the DNS lookup and resumes the TLS session.
 class LibCurlProxy : public LibCurl {
  public:
   static LibCurlProxy* Load() {
@@ -45,7 +56,32 @@ class LibCurlProxy : public LibCurl {
     return libcurl;
   }
 
-  CURL* curl_easy_init() override { return ::curl_easy_init(); }
+  LibCurlProxy() {
+    share_ = ::curl_share_init();
+    if (share_ != nullptr) {
+      ::curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &LockShare);
+      ::curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &UnlockShare);
+      ::curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+      ::curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+      ::curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+  }
+
+  CURL* curl_easy_init() override {
+    {
+      mutex_lock l(mu_);
+      if (!idle_handles_.empty()) {
+        CURL* curl = idle_handles_.back();
+        idle_handles_.pop_back();
+        return curl;
+      }
+    }
+    CURL* curl = ::curl_easy_init();
+    if (curl != nullptr && share_ != nullptr) {
+      ::curl_easy_setopt(curl, CURLOPT_SHARE, share_);
+    }
+    return curl;
+  }
 
   CURLcode curl_easy_setopt(CURL* curl, CURLoption option,
                             uint64 param) override {
@@ -96,7 +132,16 @@ class LibCurlProxy : public LibCurl {
   }
 
   void curl_easy_cleanup(CURL* curl) override {
-    return ::curl_easy_cleanup(curl);
+    // Resetting the options keeps the connections and the share.
+    ::curl_easy_reset(curl);
+    {
+      mutex_lock l(mu_);
+      if (idle_handles_.size() < kMaxIdleHandles) {
+        idle_handles_.push_back(curl);
+        return;
+      }
+    }
+    ::curl_easy_cleanup(curl);
   }
 
   char* curl_easy_escape(CURL* curl, const char* str, int length) override {
@@ -112,6 +157,22 @@ class LibCurlProxy : public LibCurl {
   }
 
   void curl_free(void* p) override { ::curl_free(p); }
+
+ private:
+  static void LockShare(CURL* curl, curl_lock_data data,
+                        curl_lock_access access, void* userptr) {
+    static_cast<LibCurlProxy*>(userptr)->share_mu_[data].lock();
+  }
+
+  static void UnlockShare(CURL* curl, curl_lock_data data, void* userptr) {
+    static_cast<LibCurlProxy*>(userptr)->share_mu_[data].unlock();
+  }
+
+  CURLSH* share_ = nullptr;
+  mutex share_mu_[CURL_LOCK_DATA_LAST];
+
+  mutex mu_;
+  std::vector<CURL*> idle_handles_ GUARDED_BY(mu_);
 };
 }  // namespace
 
@@ -138,6 +199,9 @@ CurlHttpRequest::CurlHttpRequest(LibCurl* libcurl, Env* env)
 
   // TODO(b/74351157): Enable HTTP/2.
 
+  // Keep the idle connections of pooled handles alive.
+  CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_TCP_KEEPALIVE, 1L));
+
   // Set up the progress meter.
   CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_NOPROGRESS, 0ULL));
   CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_XFERINFODATA, this));
@@ -26,6 +26,7 @@ limitations under the License.
 #include <io.h>  // for _mktemp
 #endif
 #include "include/json/json.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
@@ -81,6 +82,16 @@ constexpr size_t kDefaultMaxCacheSize = 2 * kDefaultBlockSize;
 // will be evicted on the next read.
 constexpr char kMaxStaleness[] = "GCS_READ_CACHE_MAX_STALENESS";
 constexpr uint64 kDefaultMaxStaleness = 0;
+// The environment variable that sets the maximum number of blocks fetched in
+// the background ahead of sequential reads. A value of 0 (the default)
+// disables the readahead.
+constexpr char kMaxReadaheadBlocks[] = "GCS_READ_CACHE_MAX_READAHEAD_BLOCKS";
+// The environment variable that sets the maximum number of ranged requests sent
+// in parallel for one read from GCS. A value of 1 (the default) sends a single
+// request per read.
+constexpr char kMaxParallelReads[] = "GCS_READ_MAX_PARALLEL_REQUESTS";
+// The minimum number of bytes fetched by each request of a split read.
+constexpr size_t kMinParallelReadBytes = 8 * 1024 * 1024;
 // The environment variable that overrides the maximum age of entries in the
 // Stat cache. A value of 0 (the default) means nothing is cached.
 constexpr char kStatCacheMaxAge[] = "GCS_STAT_CACHE_MAX_AGE";
@@ -627,6 +638,16 @@ GcsFileSystem::GcsFileSystem()
   if (GetEnvVar(kMaxStaleness, strings::safe_strtou64, &value)) {
     max_staleness = value;
   }
+  if (GetEnvVar(kMaxReadaheadBlocks, strings::safe_strtou64, &value)) {
+    max_readahead_blocks_ = value;
+  }
+  if (GetEnvVar(kMaxParallelReads, strings::safe_strtou64, &value) &&
+      value > 1) {
+    max_parallel_reads_ = value;
+    // The calling thread sends one of the requests itself.
+    read_pool_.reset(new thread::ThreadPool(Env::Default(), "gcs_read",
+                                            max_parallel_reads_ - 1));
+  }
   if (std::getenv(kReadCacheDisabled)) {
     // Setting either to 0 disables the cache; set both for good measure.
     block_size = max_bytes = 0;
@@ -818,7 +839,8 @@ std::unique_ptr<FileBlockCache> GcsFileSystem::MakeFileBlockCache(
              size_t* bytes_transferred) {
         return LoadBufferFromGCS(filename, offset, n, buffer,
                                  bytes_transferred);
-      }));
+      },
+      Env::Default(), max_readahead_blocks_));
   return file_block_cache;
 }
 
@@ -831,24 +853,57 @@ Status GcsFileSystem::LoadBufferFromGCS(const string& filename, size_t offset,
   string bucket, object;
   TF_RETURN_IF_ERROR(ParseGcsPath(filename, false, &bucket, &object));
 
-  std::unique_ptr<HttpRequest> request;
-  TF_RETURN_WITH_CONTEXT_IF_ERROR(CreateHttpRequest(&request),
-                                  "when reading gs://", bucket, "/", object);
-
-  request->SetUri(strings::StrCat("https://", kStorageHost, "/", bucket, "/",
-                                  request->EscapeString(object)));
-  request->SetRange(offset, offset + n - 1);
-  request->SetResultBufferDirect(buffer, n);
-  request->SetTimeouts(timeouts_.connect, timeouts_.idle, timeouts_.read);
-
   if (stats_ != nullptr) {
     stats_->RecordBlockLoadRequest(filename, offset);
   }
 
-  TF_RETURN_WITH_CONTEXT_IF_ERROR(request->Send(), " when reading gs://",
-                                  bucket, "/", object);
-
-  size_t bytes_read = request->GetResultBufferDirectBytesTransferred();
+  size_t bytes_read = 0;
+  const size_t num_ranges =
+      read_pool_ ? std::min(max_parallel_reads_,
+                            std::max<size_t>(n / kMinParallelReadBytes, 1))
+                 : 1;
+  if (num_ranges == 1) {
+    TF_RETURN_IF_ERROR(
+        LoadRangeFromGCS(bucket, object, offset, n, buffer, &bytes_read));
+  } else {
+    // Split the read into ranges requested in parallel, each one filling its
+    // own part of the buffer. The first range is requested by this thread.
+    const size_t range_size = (n + num_ranges - 1) / num_ranges;
+    std::vector<Status> statuses(num_ranges);
+    std::vector<size_t> range_bytes(num_ranges, 0);
+    auto load_range = [&, range_size](size_t i) {
+      const size_t start = i * range_size;
+      statuses[i] = LoadRangeFromGCS(bucket, object, offset + start,
+                                     std::min(range_size, n - start),
+                                     buffer + start, &range_bytes[i]);
+    };
+    BlockingCounter counter(num_ranges - 1);
+    for (size_t i = 1; i < num_ranges; ++i) {
+      read_pool_->Schedule([&load_range, &counter, i] {
+        load_range(i);
+        counter.DecrementCount();
+      });
+    }
+    load_range(0);
+    counter.Wait();
+    for (const Status& status : statuses) {
+      TF_RETURN_IF_ERROR(status);
+    }
+    // The bytes read end at the first short range. The ranges after it are past
+    // the end of the object, and must be empty.
+    size_t i = 0;
+    for (; i < num_ranges; ++i) {
+      bytes_read += range_bytes[i];
+      if (range_bytes[i] < std::min(range_size, n - i * range_size)) break;
+    }
+    for (++i; i < num_ranges; ++i) {
+      if (range_bytes[i] > 0) {
+        return errors::Internal(strings::Printf(
+            "File contents are inconsistent for file: %s @ %lu.",
+            filename.c_str(), offset + i * range_size));
+      }
+    }
+  }
   *bytes_transferred = bytes_read;
   VLOG(1) << "Successful read of gs://" << bucket << "/" << object << " @ "
           << offset << " of size: " << bytes_read;
@@ -876,6 +931,27 @@ Status GcsFileSystem::LoadBufferFromGCS(const string& filename, size_t offset,
   return Status::OK();
 }
 
+Status GcsFileSystem::LoadRangeFromGCS(const string& bucket,
+                                       const string& object, size_t offset,
+                                       size_t n, char* buffer,
+                                       size_t* bytes_transferred) {
+  std::unique_ptr<HttpRequest> request;
+  TF_RETURN_WITH_CONTEXT_IF_ERROR(CreateHttpRequest(&request),
+                                  "when reading gs://", bucket, "/", object);
+
+  request->SetUri(strings::StrCat("https://", kStorageHost, "/", bucket, "/",
+                                  request->EscapeString(object)));
+  request->SetRange(offset, offset + n - 1);
+  request->SetResultBufferDirect(buffer, n);
+  request->SetTimeouts(timeouts_.connect, timeouts_.idle, timeouts_.read);
+
+  TF_RETURN_WITH_CONTEXT_IF_ERROR(request->Send(), " when reading gs://",
+                                  bucket, "/", object);
+
+  *bytes_transferred = request->GetResultBufferDirectBytesTransferred();
+  return Status::OK();
+}
+
 void GcsFileSystem::ClearFileCaches(const string& fname) {
   tf_shared_lock l(block_cache_lock_);
   file_block_cache_->RemoveFile(fname);
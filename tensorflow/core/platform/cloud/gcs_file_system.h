@@ -21,6 +21,7 @@ limitations under the License.
 #include <vector>
 
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/cloud/auth_provider.h"
 #include "tensorflow/core/platform/cloud/expiring_lru_cache.h"
 #include "tensorflow/core/platform/cloud/file_block_cache.h"
@@ -267,15 +268,24 @@ class GcsFileSystem : public FileSystem {
                                                      uint64 max_staleness);
 
   /// Loads file contents from GCS for a given filename, offset, and length.
+  /// Large reads are split into ranges requested in parallel.
   Status LoadBufferFromGCS(const string& filename, size_t offset, size_t n,
                            char* buffer, size_t* bytes_transferred);
 
+  /// Loads a range of an object with a single request.
+  Status LoadRangeFromGCS(const string& bucket, const string& object,
+                          size_t offset, size_t n, char* buffer,
+                          size_t* bytes_transferred);
+
   // Clear all the caches related to the file with name `filename`.
   void ClearFileCaches(const string& fname);
 
   mutex mu_;
   std::unique_ptr<AuthProvider> auth_provider_ GUARDED_BY(mu_);
   std::unique_ptr<HttpRequest::Factory> http_request_factory_;
+  // The maximum number of blocks the block cache reads ahead of sequential
+  // reads. Declared before file_block_cache_, which is built from it.
+  size_t max_readahead_blocks_ = 0;
   // block_cache_lock_ protects the file_block_cache_ pointer (Note that
   // FileBlockCache instances are themselves threadsafe).
   mutex block_cache_lock_;
@@ -294,6 +304,11 @@ class GcsFileSystem : public FileSystem {
 
   GcsStatsInterface* stats_ = nullptr;  // Not owned.
 
+  // The maximum number of requests a read is split into.
+  size_t max_parallel_reads_ = 1;
+  // The threads sending the requests of split reads, or null if disabled.
+  std::unique_ptr<thread::ThreadPool> read_pool_;
+
   /// The initial delay for exponential backoffs when retrying failed calls.
   const int64 initial_retry_delay_usec_ = 1000000L;
 
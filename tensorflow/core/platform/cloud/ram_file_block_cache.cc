@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/platform/cloud/ram_file_block_cache.h"
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include "tensorflow/core/lib/gtl/cleanup.h"
@@ -21,6 +22,14 @@ limitations under the License.
 
 namespace tensorflow {
 
+namespace {
+
+// The number of files whose readahead state is kept. Past it, the state of all
+// the files is reset.
+constexpr size_t kMaxReadaheadFiles = 1024;
+
+}  // namespace
+
 bool RamFileBlockCache::BlockNotStale(const std::shared_ptr<Block>& block) {
   mutex_lock l(block->mu);
   if (block->state != FetchState::FINISHED) {
@@ -76,15 +85,19 @@ Status RamFileBlockCache::UpdateLRU(const Key& key,
     block->lru_iterator = lru_list_.begin();
   }
 
-  // Check for inconsistent state. If there is a block later in the same file
-  // in the cache, and our current block is not block size, this likely means
-  // we have inconsistent state within the cache. Note: it's possible some
-  // incomplete reads may still go undetected.
+  // Check for inconsistent state. If there is a block with data later in the
+  // same file in the cache, and our current block is not block size, this
+  // likely means we have inconsistent state within the cache. Later blocks
+  // still being fetched, or read past the end of the file, hold no data. Note:
+  // it's possible some incomplete reads may still go undetected.
   if (block->data.size() < block_size_) {
-    Key fmax = std::make_pair(key.first, std::numeric_limits<size_t>::max());
-    auto fcmp = block_map_.upper_bound(fmax);
-    if (fcmp != block_map_.begin() && key < (--fcmp)->first) {
-      return errors::Internal("Block cache contents are inconsistent.");
+    for (auto it = block_map_.upper_bound(key);
+         it != block_map_.end() && it->first.first == key.first; ++it) {
+      mutex_lock l(it->second->mu);
+      if (it->second->state == FetchState::FINISHED &&
+          !it->second->data.empty()) {
+        return errors::Internal("Block cache contents are inconsistent.");
+      }
     }
   }
 
@@ -172,6 +185,9 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
   if (finish < offset + n) {
     finish += block_size_;
   }
+  if (fetch_pool_) {
+    Readahead(filename, start, finish);
+  }
   size_t total_bytes_transferred = 0;
   // Now iterate through the blocks, reading them one at a time.
   for (size_t pos = start; pos < finish; pos += block_size_) {
@@ -210,6 +226,9 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
     }
     if (data.size() < block_size_) {
       // The block was a partial block and thus signals EOF at its upper bound.
+      if (fetch_pool_) {
+        SetEndOfFile(filename, pos + data.size());
+      }
       break;
     }
   }
@@ -217,6 +236,70 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
   return Status::OK();
 }
 
+void RamFileBlockCache::Readahead(const string& filename, size_t start,
+                                  size_t finish) {
+  std::vector<size_t> offsets;
+  {
+    mutex_lock lock(mu_);
+    if (readahead_.size() >= kMaxReadaheadFiles &&
+        readahead_.find(filename) == readahead_.end()) {
+      readahead_.clear();
+    }
+    ReadaheadState& state = readahead_[filename];
+    // A read is sequential if it starts in the last block of the previous read,
+    // or right after it.
+    if (start == state.next_block ||
+        (state.next_block > 0 && start + block_size_ == state.next_block)) {
+      // Grow the window while the reads stay sequential, so that more fetches
+      // are in flight the faster the file is consumed.
+      state.window = std::min(std::max<size_t>(2 * state.window, 1),
+                              max_readahead_blocks_);
+    } else {
+      state.window = 0;
+      state.prefetched_until = 0;
+    }
+    state.next_block = finish;
+    // Leave room in the cache for the blocks of this read, so that the blocks
+    // read ahead do not evict them.
+    const size_t max_blocks = max_bytes_ / block_size_;
+    const size_t read_blocks = (finish - start) / block_size_;
+    const size_t window =
+        max_blocks > read_blocks
+            ? std::min(state.window, max_blocks - read_blocks)
+            : 0;
+    const size_t limit = std::min(finish + window * block_size_, state.eof);
+    for (size_t pos = std::max(finish, state.prefetched_until); pos < limit;
+         pos += block_size_) {
+      offsets.push_back(pos);
+    }
+    state.prefetched_until = std::max(state.prefetched_until, limit);
+  }
+  for (size_t pos : offsets) {
+    Key key = std::make_pair(filename, pos);
+    fetch_pool_->Schedule([this, key] { Prefetch(key); });
+  }
+}
+
+void RamFileBlockCache::Prefetch(const Key& key) {
+  std::shared_ptr<Block> block = Lookup(key);
+  // Errors are left to the read of the block, which fetches it again.
+  if (!MaybeFetch(key, block).ok()) {
+    return;
+  }
+  if (block->data.size() < block_size_) {
+    SetEndOfFile(key.first, key.second + block->data.size());
+  }
+  UpdateLRU(key, block).IgnoreError();
+}
+
+void RamFileBlockCache::SetEndOfFile(const string& filename, size_t eof) {
+  mutex_lock lock(mu_);
+  auto it = readahead_.find(filename);
+  if (it != readahead_.end()) {
+    it->second.eof = std::min(it->second.eof, eof);
+  }
+}
+
 bool RamFileBlockCache::ValidateAndUpdateFileSignature(const string& filename,
                                                        int64 file_signature) {
   mutex_lock lock(mu_);
@@ -262,6 +345,7 @@ void RamFileBlockCache::Flush() {
   lru_list_.clear();
   lra_list_.clear();
   cache_size_ = 0;
+  readahead_.clear();
 }
 
 void RamFileBlockCache::RemoveFile(const string& filename) {
@@ -270,6 +354,7 @@ void RamFileBlockCache::RemoveFile(const string& filename) {
 }
 
 void RamFileBlockCache::RemoveFile_Locked(const string& filename) {
+  readahead_.erase(filename);
   Key begin = std::make_pair(filename, 0);
   auto it = block_map_.lower_bound(begin);
   while (it != block_map_.end() && it->first.first == filename) {
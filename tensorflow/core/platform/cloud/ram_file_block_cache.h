@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_PLATFORM_CLOUD_RAM_FILE_BLOCK_CACHE_H_
 
 #include <functional>
+#include <limits>
 #include <list>
 #include <map>
 #include <memory>
@@ -24,6 +25,7 @@ limitations under the License.
 #include <vector>
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/cloud/file_block_cache.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -49,22 +51,33 @@ class RamFileBlockCache : public FileBlockCache {
                                size_t* bytes_transferred)>
       BlockFetcher;
 
+  /// If `max_readahead_blocks` is positive, sequential reads of a file fetch
+  /// up to that many blocks past the read in the background. The readahead
+  /// window starts at one block and doubles on each sequential read.
   RamFileBlockCache(size_t block_size, size_t max_bytes, uint64 max_staleness,
-                    BlockFetcher block_fetcher, Env* env = Env::Default())
+                    BlockFetcher block_fetcher, Env* env = Env::Default(),
+                    size_t max_readahead_blocks = 0)
       : block_size_(block_size),
         max_bytes_(max_bytes),
         max_staleness_(max_staleness),
+        max_readahead_blocks_(max_readahead_blocks),
         block_fetcher_(block_fetcher),
         env_(env) {
     if (max_staleness_ > 0) {
       pruning_thread_.reset(env_->StartThread(ThreadOptions(), "TF_prune_FBC",
                                               [this] { Prune(); }));
     }
+    if (IsCacheEnabled() && max_readahead_blocks_ > 0) {
+      fetch_pool_.reset(new thread::ThreadPool(env_, "TF_readahead_FBC",
+                                               max_readahead_blocks_));
+    }
     VLOG(1) << "GCS file block cache is "
             << (IsCacheEnabled() ? "enabled" : "disabled");
   }
 
   ~RamFileBlockCache() override {
+    // Destroying fetch_pool_ blocks until the pending readahead fetches finish.
+    fetch_pool_.reset();
     if (pruning_thread_) {
       stop_pruning_thread_.Notify();
       // Destroying pruning_thread_ will block until Prune() receives the above
@@ -126,6 +139,8 @@ class RamFileBlockCache : public FileBlockCache {
   const size_t max_bytes_;
   /// The maximum staleness of any block in the LRU cache, in seconds.
   const uint64 max_staleness_;
+  /// The maximum number of blocks read ahead of a sequential read.
+  const size_t max_readahead_blocks_;
   /// The callback to read a block from the underlying filesystem.
   const BlockFetcher block_fetcher_;
   /// The Env from which we read timestamps.
@@ -206,6 +221,17 @@ class RamFileBlockCache : public FileBlockCache {
   Status UpdateLRU(const Key& key, const std::shared_ptr<Block>& block)
       LOCKS_EXCLUDED(mu_);
 
+  /// Update the readahead state of `filename` for a read of the blocks in
+  /// [start, finish), and schedule the fetches of the blocks to read ahead.
+  void Readahead(const string& filename, size_t start, size_t finish)
+      LOCKS_EXCLUDED(mu_);
+
+  /// Fetch the block at `key` in the background and add it to the cache.
+  void Prefetch(const Key& key) LOCKS_EXCLUDED(mu_);
+
+  /// Stop reading ahead of `eof` in `filename`, where a partial block ended.
+  void SetEndOfFile(const string& filename, size_t eof) LOCKS_EXCLUDED(mu_);
+
   /// Remove all blocks of a file, with mu_ already held.
   void RemoveFile_Locked(const string& filename) EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
@@ -219,6 +245,21 @@ class RamFileBlockCache : public FileBlockCache {
   /// Notification for stopping the cache pruning thread.
   Notification stop_pruning_thread_;
 
+  /// The threads fetching the blocks read ahead, or null if disabled.
+  std::unique_ptr<thread::ThreadPool> fetch_pool_;
+
+  /// The readahead state of a file.
+  struct ReadaheadState {
+    /// The end of the last read, block-aligned.
+    size_t next_block = 0;
+    /// The number of blocks to read ahead of the next sequential read.
+    size_t window = 0;
+    /// The end of the blocks already scheduled for readahead.
+    size_t prefetched_until = 0;
+    /// The size of the file, once a partial block has been fetched.
+    size_t eof = std::numeric_limits<size_t>::max();
+  };
+
   /// Guards access to the block map, LRU list, and cached byte count.
   mutable mutex mu_;
 
@@ -241,6 +282,9 @@ class RamFileBlockCache : public FileBlockCache {
 
   // A filename->file_signature map.
   std::map<string, int64> file_signature_map_ GUARDED_BY(mu_);
+
+  /// The readahead state of the files read since the state was last reset.
+  std::map<string, ReadaheadState> readahead_ GUARDED_BY(mu_);
 };
 
 }  // namespace tensorflow
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/platform/cloud/ram_file_block_cache.h"
 #include <cstring>
+#include <map>
 #include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/cloud/now_seconds_env.h"
@@ -541,6 +542,79 @@ TEST(RamFileBlockCacheTest, CoalesceConcurrentReads) {
   EXPECT_EQ(1, num_requests);
 }
 
+TEST(RamFileBlockCacheTest, Readahead) {
+  // Reads a 152-byte file with block size 16, one block at a time.
+  const size_t block_size = 16;
+  const size_t file_size = 9 * block_size + 8;
+  mutex mu;
+  std::map<size_t, int> fetches;
+  auto fetcher = [&mu, &fetches, file_size](
+                     const string& filename, size_t offset, size_t n,
+                     char* buffer, size_t* bytes_transferred) {
+    {
+      mutex_lock l(mu);
+      fetches[offset]++;
+    }
+    const size_t bytes = offset < file_size ? std::min(n, file_size - offset)
+                                            : 0;
+    memset(buffer, 'x', bytes);
+    *bytes_transferred = bytes;
+    return Status::OK();
+  };
+  auto num_fetches = [&mu, &fetches](size_t offset) {
+    mutex_lock l(mu);
+    return fetches.count(offset) ? fetches[offset] : 0;
+  };
+  {
+    RamFileBlockCache cache(block_size, 8 * block_size, 0, fetcher,
+                            Env::Default(), 4 /* max_readahead_blocks */);
+    std::vector<char> out;
+    TF_EXPECT_OK(ReadCache(&cache, "a", 0, block_size, &out));
+    // The next block is fetched in the background.
+    for (int i = 0; i < 10000 && num_fetches(block_size) == 0; ++i) {
+      Env::Default()->SleepForMicroseconds(1000);
+    }
+    EXPECT_EQ(num_fetches(block_size), 1);
+    for (size_t offset = block_size; offset < file_size;
+         offset += block_size) {
+      TF_EXPECT_OK(ReadCache(&cache, "a", offset, block_size, &out));
+      EXPECT_EQ(out.size(), std::min(block_size, file_size - offset));
+    }
+    EXPECT_LE(cache.CacheSize(), cache.max_bytes());
+  }
+  // Each block was fetched once, whether read ahead or not.
+  for (size_t offset = 0; offset < file_size; offset += block_size) {
+    EXPECT_EQ(num_fetches(offset), 1) << offset;
+  }
+}
+
+TEST(RamFileBlockCacheTest, NoReadaheadOfRandomReads) {
+  const size_t block_size = 16;
+  mutex mu;
+  std::vector<size_t> fetches;
+  auto fetcher = [&mu, &fetches](const string& filename, size_t offset,
+                                 size_t n, char* buffer,
+                                 size_t* bytes_transferred) {
+    {
+      mutex_lock l(mu);
+      fetches.push_back(offset);
+    }
+    memset(buffer, 'x', n);
+    *bytes_transferred = n;
+    return Status::OK();
+  };
+  {
+    RamFileBlockCache cache(block_size, 8 * block_size, 0, fetcher,
+                            Env::Default(), 4 /* max_readahead_blocks */);
+    std::vector<char> out;
+    TF_EXPECT_OK(ReadCache(&cache, "a", 5 * block_size, block_size, &out));
+    TF_EXPECT_OK(ReadCache(&cache, "a", 2 * block_size, block_size, &out));
+  }
+  // Destroying the cache waits for the blocks read ahead, if any.
+  mutex_lock l(mu);
+  EXPECT_EQ(fetches, std::vector<size_t>({5 * block_size, 2 * block_size}));
+}
+
 TEST(RamFileBlockCacheTest, Flush) {
   int calls = 0;
   auto fetcher = [&calls](const string& filename, size_t offset, size_t n,
@@ -642,6 +642,73 @@ std::unique_ptr<DeviceTracer> CreateDeviceTracer() {
 
 }  // namespace tensorflow
 
+#elif defined(TENSORFLOW_USE_SYCL)
+
+#include <memory>
+
+#include "tensorflow/core/common_runtime/sycl/sycl_tracer.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+namespace devicetracer {
+
+// Traces SYCL devices through the process wide SYCLTracer.
+class SYCLDeviceTracerImpl : public DeviceTracer {
+ public:
+  SYCLDeviceTracerImpl() : tracer_(SYCLTracer::Get()) {}
+  ~SYCLDeviceTracerImpl() override { Stop().IgnoreError(); }
+
+  Status Start() override {
+    VLOG(1) << "DeviceTracer::Start";
+    mutex_lock l(mu_);
+    if (enabled_) {
+      return errors::FailedPrecondition("DeviceTracer is already enabled.");
+    }
+    TF_RETURN_IF_ERROR(tracer_->Start());
+    enabled_ = true;
+    return Status::OK();
+  }
+
+  Status Stop() override {
+    VLOG(1) << "DeviceTracer::Stop";
+    mutex_lock l(mu_);
+    if (!enabled_) {
+      return Status::OK();
+    }
+    tracer_->Stop();
+    enabled_ = false;
+    return Status::OK();
+  }
+
+  Status Collect(StepStatsCollector *collector) override {
+    mutex_lock l(mu_);
+    if (enabled_) {
+      return errors::FailedPrecondition("DeviceTracer is still enabled.");
+    }
+    return tracer_->Collect(collector);
+  }
+
+ private:
+  SYCLTracer *tracer_;  // not owned
+  mutex mu_;
+  bool enabled_ GUARDED_BY(mu_) = false;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(SYCLDeviceTracerImpl);
+};
+
+}  // namespace devicetracer
+
+std::unique_ptr<DeviceTracer> CreateDeviceTracer() {
+  std::unique_ptr<DeviceTracer> tracer(
+      new devicetracer::SYCLDeviceTracerImpl());
+  return tracer;
+}
+
+}  // namespace tensorflow
+
 #else  // GOOGLE_CUDA
 
 namespace tensorflow {
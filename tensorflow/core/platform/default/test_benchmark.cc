@@ -19,10 +19,13 @@ limitations under the License.
 #include <cstdlib>
 
 #include <algorithm>
+#include <cmath>
 #include <vector>
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/regexp.h"
 #include "tensorflow/core/util/reporter.h"
 
 namespace tensorflow {
@@ -110,92 +113,205 @@ Benchmark* Benchmark::RangePair(int lo1, int hi1, int lo2, int hi2) {
   return this;
 }
 
-void Benchmark::Run(const char* pattern) {
+namespace {
+
+// A benchmark with its arguments.
+struct Instance {
+  Benchmark* benchmark;
+  int arg1;
+  int arg2;
+  string name;
+};
+
+// The result of one run of a benchmark.
+struct RunResult {
+  int iters;
+  double seconds;
+  string label;
+  double bytes_per_second;
+  double items_per_second;
+
+  double ns_per_iter() const { return seconds * 1e9 / iters; }
+};
+
+string JsonEscape(const string& s) {
+  string escaped;
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", c);
+      escaped += buf;
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+// Prints a result as a JSON object, preceded by a comma unless it is the
+// first one.
+void PrintJson(const string& name, int64 iters, double ns_per_iter,
+               const string& label, double bytes_per_second,
+               double items_per_second, bool* first) {
+  printf("%s    {\n", *first ? "" : ",\n");
+  *first = false;
+  printf("      \"name\": \"%s\",\n", JsonEscape(name).c_str());
+  printf("      \"iterations\": %lld,\n", static_cast<long long>(iters));
+  printf("      \"real_time\": %.2f,\n", ns_per_iter);
+  printf("      \"time_unit\": \"ns\"");
+  if (bytes_per_second > 0) {
+    printf(",\n      \"bytes_per_second\": %.2f", bytes_per_second);
+  }
+  if (items_per_second > 0) {
+    printf(",\n      \"items_per_second\": %.2f", items_per_second);
+  }
+  if (!label.empty()) {
+    printf(",\n      \"label\": \"%s\"", JsonEscape(label).c_str());
+  }
+  printf("\n    }");
+}
+
+void ReportOrDie(const string& name, const RunResult& result,
+                 const std::vector<std::pair<string, double>>& properties) {
+  TestReporter reporter(name);
+  Status s = reporter.Initialize();
+  if (s.ok()) {
+    s = reporter.Benchmark(result.iters, 0.0, result.seconds,
+                           result.items_per_second * 1e-6);
+  }
+  for (const auto& property : properties) {
+    if (s.ok()) s = reporter.SetProperty(property.first, property.second);
+  }
+  if (s.ok()) s = reporter.Close();
+  if (!s.ok()) {
+    LOG(ERROR) << s.ToString();
+    exit(EXIT_FAILURE);
+  }
+}
+
+}  // namespace
+
+void Benchmark::Run(const char* pattern) { Run(pattern, Options()); }
+
+void Benchmark::Run(const char* pattern, const Options& options) {
   if (!all_benchmarks) return;
 
-  // Converts "all" into the wildcard '.*'.  Currently pattern isn't
-  // specified by clients, but we keep this here to match the internal
-  // Google implementation, should we ever enable user-specified
-  // pattern specification.
+  // Converts "all" into the wildcard '.*'.
   if (StringPiece(pattern) == "all") {
     pattern = ".*";
   }
+  const RE2 regexp(pattern);
+  if (!regexp.ok()) {
+    LOG(ERROR) << "Invalid benchmark pattern " << pattern << ": "
+               << regexp.error();
+    exit(EXIT_FAILURE);
+  }
 
-  // Compute name width.
+  // Lists the matching benchmarks and computes the name width.
+  std::vector<Instance> instances;
   int width = 10;
-  string name;
   for (auto b : *all_benchmarks) {
-    name = b->name_;
     for (auto arg : b->args_) {
-      name.resize(b->name_.size());
+      string name = b->name_;
       if (arg.first >= 0) {
         strings::StrAppend(&name, "/", arg.first);
         if (arg.second >= 0) {
           strings::StrAppend(&name, "/", arg.second);
         }
       }
-
-      // TODO(vrv): Check against 'pattern' using a regex before
-      // computing the width, if we start allowing clients to pass in
-      // a custom pattern.
-      width = std::max<int>(width, name.size());
+      if (!RE2::PartialMatch(name, regexp)) continue;
+      width = std::max<int>(width, name.size() + 7);  // For "_stddev".
+      instances.push_back({b, arg.first, arg.second, name});
     }
   }
 
-  printf("%-*s %10s %10s\n", width, "Benchmark", "Time(ns)", "Iterations");
-  printf("%s\n", string(width + 22, '-').c_str());
-  for (auto b : *all_benchmarks) {
-    name = b->name_;
-    for (auto arg : b->args_) {
-      name.resize(b->name_.size());
-      if (arg.first >= 0) {
-        strings::StrAppend(&name, "/", arg.first);
-        if (arg.second >= 0) {
-          strings::StrAppend(&name, "/", arg.second);
-        }
+  const int repetitions = std::max(options.repetitions, 1);
+  bool first_json = true;
+  if (options.json) {
+    printf("{\n  \"benchmarks\": [\n");
+  } else {
+    printf("%-*s %10s %10s\n", width, "Benchmark", "Time(ns)", "Iterations");
+    printf("%s\n", string(width + 22, '-').c_str());
+  }
+  for (const Instance& instance : instances) {
+    std::vector<RunResult> results;
+    for (int r = 0; r < repetitions; ++r) {
+      RunResult result;
+      instance.benchmark->Run(instance.arg1, instance.arg2, &result.iters,
+                              &result.seconds);
+      result.label = label;
+      result.bytes_per_second =
+          bytes_processed > 0 ? bytes_processed / result.seconds : 0;
+      result.items_per_second =
+          items_processed > 0 ? items_processed / result.seconds : 0;
+      results.push_back(result);
+
+      if (options.json) {
+        PrintJson(instance.name, result.iters, result.ns_per_iter(),
+                  result.label, result.bytes_per_second,
+                  result.items_per_second, &first_json);
+        continue;
       }
-
-      // TODO(vrv): Match 'name' against 'pattern' using a regex
-      // before continuing, if we start allowing clients to pass in a
-      // custom pattern.
-
-      int iters;
-      double seconds;
-      b->Run(arg.first, arg.second, &iters, &seconds);
-
       char buf[100];
-      std::string full_label = label;
-      if (bytes_processed > 0) {
+      std::string full_label = result.label;
+      if (result.bytes_per_second > 0) {
         snprintf(buf, sizeof(buf), " %.1fMB/s",
-                 (bytes_processed * 1e-6) / seconds);
+                 result.bytes_per_second * 1e-6);
         full_label += buf;
       }
-      if (items_processed > 0) {
+      if (result.items_per_second > 0) {
         snprintf(buf, sizeof(buf), " %.1fM items/s",
-                 (items_processed * 1e-6) / seconds);
+                 result.items_per_second * 1e-6);
         full_label += buf;
       }
-      printf("%-*s %10.0f %10d\t%s\n", width, name.c_str(),
-             seconds * 1e9 / iters, iters, full_label.c_str());
-
-      TestReporter reporter(name);
-      Status s = reporter.Initialize();
-      if (!s.ok()) {
-        LOG(ERROR) << s.ToString();
-        exit(EXIT_FAILURE);
+      printf("%-*s %10.0f %10d\t%s\n", width, instance.name.c_str(),
+             result.ns_per_iter(), result.iters, full_label.c_str());
+    }
+
+    std::sort(results.begin(), results.end(),
+              [](const RunResult& a, const RunResult& b) {
+                return a.ns_per_iter() < b.ns_per_iter();
+              });
+    const RunResult& median_result = results[results.size() / 2];
+    std::vector<std::pair<string, double>> properties;
+    if (repetitions > 1) {
+      double mean = 0;
+      for (const RunResult& result : results) mean += result.ns_per_iter();
+      mean /= results.size();
+      double variance = 0;
+      for (const RunResult& result : results) {
+        const double deviation = result.ns_per_iter() - mean;
+        variance += deviation * deviation;
       }
-      s = reporter.Benchmark(iters, 0.0, seconds,
-                             items_processed * 1e-6 / seconds);
-      if (!s.ok()) {
-        LOG(ERROR) << s.ToString();
-        exit(EXIT_FAILURE);
+      const double stddev = std::sqrt(variance / (results.size() - 1));
+      double median = median_result.ns_per_iter();
+      if (results.size() % 2 == 0) {
+        median = (median + results[results.size() / 2 - 1].ns_per_iter()) / 2;
       }
-      s = reporter.Close();
-      if (!s.ok()) {
-        LOG(ERROR) << s.ToString();
-        exit(EXIT_FAILURE);
+      properties = {{"mean_ns_per_iter", mean},
+                    {"median_ns_per_iter", median},
+                    {"stddev_ns_per_iter", stddev}};
+      for (const auto& property : properties) {
+        // "mean_ns_per_iter" -> "_mean".
+        const string name = strings::StrCat(
+            instance.name, "_",
+            property.first.substr(0, property.first.find('_')));
+        if (options.json) {
+          PrintJson(name, repetitions, property.second, "", 0, 0,
+                    &first_json);
+        } else {
+          printf("%-*s %10.0f %10d\n", width, name.c_str(), property.second,
+                 repetitions);
+        }
       }
     }
+    ReportOrDie(instance.name, median_result, properties);
+  }
+  if (options.json) {
+    printf("\n  ]\n}\n");
   }
 }
 
@@ -0,0 +1,50 @@
+/* Copyright 2015 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_PLATFORM_NUMA_H_
+#define TENSORFLOW_PLATFORM_NUMA_H_
+
+#include "tensorflow/core/platform/platform.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace port {
+
+// Returns true if the threads and the memory of the process can be placed on
+// the NUMA nodes of the machine.
+bool NUMAEnabled();
+
+// Returns the number of NUMA nodes of the machine, 1 if it is not known.
+int NUMANumNodes();
+
+static const int kNUMANoAffinity = -1;
+
+// Restricts the calling thread to the CPUs of "node". Does nothing if "node"
+// is kNUMANoAffinity or NUMA is not enabled.
+void NUMASetThreadNodeAffinity(int node);
+
+// Returns the node the calling thread is restricted to, kNUMANoAffinity if
+// it may run on the CPUs of several nodes.
+int NUMAGetThreadNodeAffinity();
+
+// Like AlignedMalloc, but the pages of the allocation are preferably placed on
+// "node". Memory allocated by NUMAMalloc must be released with NUMAFree.
+void* NUMAMalloc(int node, size_t size, int minimum_alignment);
+void NUMAFree(void* ptr);
+
+}  // namespace port
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_PLATFORM_NUMA_H_
@@ -13,11 +13,13 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <string.h>
 #include <condition_variable>
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/mem.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/test.h"
 
 namespace tensorflow {
@@ -33,6 +35,27 @@ TEST(Port, AlignedMalloc) {
   }
 }
 
+TEST(Port, NUMA) {
+  EXPECT_GE(NUMANumNodes(), 1);
+  for (int node = kNUMANoAffinity; node < NUMANumNodes(); ++node) {
+    for (size_t size : {1, 1 << 20}) {
+      void* p = NUMAMalloc(node, size, 64);
+      ASSERT_TRUE(p != nullptr);
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0);
+      memset(p, 0, size);
+      NUMAFree(p);
+    }
+  }
+  if (NUMAEnabled()) {
+    thread::ThreadPool pool(Env::Default(), "numa", 1);
+    pool.Schedule([]() {
+      EXPECT_EQ(kNUMANoAffinity, NUMAGetThreadNodeAffinity());
+      NUMASetThreadNodeAffinity(NUMANumNodes() - 1);
+      EXPECT_EQ(NUMANumNodes() - 1, NUMAGetThreadNodeAffinity());
+    });
+  }
+}
+
 TEST(ConditionVariable, WaitForMilliseconds_Timeout) {
   mutex m;
   mutex_lock l(m);
@@ -24,13 +24,18 @@ limitations under the License.
 #include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mem.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/platform/types.h"
 
 #if defined(__linux__) && !defined(__ANDROID__)
 #include <sched.h>
+#include <sys/syscall.h>
 #include <sys/sysinfo.h>
+#include <vector>
 #endif
+#include <errno.h>
+#include <algorithm>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -104,6 +109,131 @@ void* AlignedMalloc(size_t size, int minimum_alignment) {
 
 void AlignedFree(void* aligned_memory) { Free(aligned_memory); }
 
+#if defined(__linux__) && !defined(__ANDROID__)
+namespace {
+
+// Reads the CPUs of NUMA node "node" from sysfs, returns false if the node
+// does not exist.
+bool NUMANodeCPUs(int node, cpu_set_t* cpus) {
+  char path[64];
+  snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+           node);
+  FILE* f = fopen(path, "r");
+  if (f == nullptr) {
+    return false;
+  }
+  CPU_ZERO(cpus);
+  // The list is made of ranges like "0-7,16-23".
+  int first;
+  while (fscanf(f, "%d", &first) == 1) {
+    int last = first;
+    int c = fgetc(f);
+    if (c == '-') {
+      if (fscanf(f, "%d", &last) != 1) {
+        break;
+      }
+      c = fgetc(f);
+    }
+    for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+      CPU_SET(cpu, cpus);
+    }
+    if (c != ',') {
+      break;
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+const std::vector<cpu_set_t>& NUMANodes() {
+  static const std::vector<cpu_set_t>* nodes = []() {
+    auto* nodes = new std::vector<cpu_set_t>;
+    cpu_set_t cpus;
+    while (NUMANodeCPUs(nodes->size(), &cpus)) {
+      nodes->push_back(cpus);
+    }
+    return nodes;
+  }();
+  return *nodes;
+}
+
+}  // namespace
+#endif
+
+bool NUMAEnabled() { return NUMANumNodes() > 1; }
+
+int NUMANumNodes() {
+#if defined(__linux__) && !defined(__ANDROID__)
+  return std::max<int>(NUMANodes().size(), 1);
+#else
+  return 1;
+#endif
+}
+
+void NUMASetThreadNodeAffinity(int node) {
+#if defined(__linux__) && !defined(__ANDROID__)
+  if (node == kNUMANoAffinity || !NUMAEnabled()) {
+    return;
+  }
+  const std::vector<cpu_set_t>& nodes = NUMANodes();
+  if (node < 0 || node >= nodes.size()) {
+    LOG(ERROR) << "Invalid NUMA node " << node;
+    return;
+  }
+  if (sched_setaffinity(0, sizeof(cpu_set_t), &nodes[node]) != 0) {
+    LOG(ERROR) << "Could not restrict the thread to NUMA node " << node
+               << ": " << strerror(errno);
+  }
+#endif
+}
+
+int NUMAGetThreadNodeAffinity() {
+#if defined(__linux__) && !defined(__ANDROID__)
+  if (!NUMAEnabled()) {
+    return kNUMANoAffinity;
+  }
+  cpu_set_t cpus;
+  if (sched_getaffinity(0, sizeof(cpu_set_t), &cpus) != 0) {
+    return kNUMANoAffinity;
+  }
+  const std::vector<cpu_set_t>& nodes = NUMANodes();
+  for (int node = 0; node < nodes.size(); ++node) {
+    // The thread may only run on the node if adding its CPUs to those of
+    // the node adds none.
+    cpu_set_t combined;
+    CPU_OR(&combined, &cpus, &nodes[node]);
+    if (CPU_EQUAL(&combined, &nodes[node])) {
+      return node;
+    }
+  }
+#endif
+  return kNUMANoAffinity;
+}
+
+void* NUMAMalloc(int node, size_t size, int minimum_alignment) {
+#if defined(__linux__) && !defined(__ANDROID__) && defined(SYS_mbind)
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+  // The placement is set per page, so only the allocations of whole pages
+  // are bound, those of a few bytes share their pages with other nodes.
+  if (node != kNUMANoAffinity && node < 64 && size >= page_size &&
+      NUMAEnabled()) {
+    void* ptr = AlignedMalloc(
+        size, std::max<int>(minimum_alignment, static_cast<int>(page_size)));
+    if (ptr != nullptr) {
+      const int kMpolPreferred = 1;
+      const unsigned long node_mask = 1UL << node;
+      // Failures only cost locality.
+      syscall(SYS_mbind, ptr, size, kMpolPreferred, &node_mask,
+              sizeof(node_mask) * 8 + 1, 0);
+    }
+    return ptr;
+  }
+#endif
+  return AlignedMalloc(size, minimum_alignment);
+}
+
+void NUMAFree(void* ptr) { AlignedFree(ptr); }
+
 void* Malloc(size_t size) {
 #ifdef TENSORFLOW_USE_JEMALLOC
   return jemalloc_malloc(size);
@@ -89,7 +89,21 @@ class Benchmark {
   Benchmark* ArgPair(int x, int y);
   Benchmark* Range(int lo, int hi);
   Benchmark* RangePair(int lo1, int hi1, int lo2, int hi2);
+
+  // Options of Run().
+  struct Options {
+    // The number of times each benchmark is run. With more than one, the
+    // mean, median and standard deviation of the time per iteration are
+    // printed too, and the median run is the one reported.
+    int repetitions = 1;
+    // If true, the results are printed as JSON instead of a table.
+    bool json = false;
+  };
+
+  // Runs the benchmarks whose names, with their arguments, partially match
+  // the regular expression "pattern", or all of them for "all".
   static void Run(const char* pattern);
+  static void Run(const char* pattern, const Options& options);
 
  private:
   string name_;
@@ -17,6 +17,8 @@ limitations under the License.
 // that also define microbenchmarks.  Based on whether the user specified
 // the --benchmark_filter flag which specifies which benchmarks to run,
 // we will either run benchmarks or run the gtest tests in the program.
+// --benchmark_repetitions=N runs each benchmark N times and prints statistics
+// of the runs, and --benchmark_format=json prints the results as JSON.
 
 #include "tensorflow/core/platform/platform.h"
 
@@ -26,6 +28,7 @@ limitations under the License.
 
 #include <iostream>
 
+#include "tensorflow/core/lib/strings/numbers.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/stacktrace_handler.h"
 #include "tensorflow/core/platform/test.h"
@@ -36,13 +39,36 @@ GTEST_API_ int main(int argc, char** argv) {
 
   tensorflow::testing::InstallStacktraceHandler();
   testing::InitGoogleTest(&argc, argv);
+  const char* pattern = nullptr;
+  tensorflow::testing::Benchmark::Options options;
   for (int i = 1; i < argc; i++) {
     if (tensorflow::str_util::StartsWith(argv[i], "--benchmarks=")) {
-      const char* pattern = argv[i] + strlen("--benchmarks=");
-      tensorflow::testing::Benchmark::Run(pattern);
-      return 0;
+      pattern = argv[i] + strlen("--benchmarks=");
+    } else if (tensorflow::str_util::StartsWith(argv[i],
+                                                "--benchmark_repetitions=")) {
+      const char* repetitions = argv[i] + strlen("--benchmark_repetitions=");
+      if (!tensorflow::strings::safe_strto32(repetitions,
+                                             &options.repetitions) ||
+          options.repetitions < 1) {
+        std::cerr << "Invalid --benchmark_repetitions: " << repetitions
+                  << "\n";
+        return 1;
+      }
+    } else if (tensorflow::str_util::StartsWith(argv[i],
+                                                "--benchmark_format=")) {
+      const std::string format = argv[i] + strlen("--benchmark_format=");
+      if (format != "console" && format != "json") {
+        std::cerr << "Invalid --benchmark_format: " << format
+                  << ", expected console or json\n";
+        return 1;
+      }
+      options.json = format == "json";
     }
   }
+  if (pattern != nullptr) {
+    tensorflow::testing::Benchmark::Run(pattern, options);
+    return 0;
+  }
   return RUN_ALL_TESTS();
 }
 #endif
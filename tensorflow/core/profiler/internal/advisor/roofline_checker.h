@@ -0,0 +1,207 @@
+/* Copyright 2018 The TensorFlow Authors All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// This checker compares the achieved FLOP/s and memory bandwidth of the
+// operations with the roofline of the device.
+#ifndef TENSORFLOW_CORE_PROFILER_INTERNAL_ADVISOR_ROOFLINE_CHECKER_H_
+#define TENSORFLOW_CORE_PROFILER_INTERNAL_ADVISOR_ROOFLINE_CHECKER_H_
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/lib/strings/stringprintf.h"
+#include "tensorflow/core/profiler/internal/advisor/checker.h"
+
+namespace tensorflow {
+namespace tfprof {
+
+// Reports the GFLOP/s, GB/s and arithmetic intensity achieved by each
+// operation type. If the "peak_gflops" and "peak_gbps" options describe the
+// device, it also reports the fraction of the roofline bound,
+// min(peak_gflops, intensity * peak_gbps), each operation type reaches, and
+// flags the operations below "min_efficiency" (0.1 by default) of it.
+//
+// The float ops are those of the registered op statistics. The bytes accessed
+// are the measured output bytes plus the input elements, assumed to have the
+// size of the output elements.
+class RooflineChecker : public Checker {
+ public:
+  string name() const override { return kCheckers[4]; }
+
+ private:
+  struct Costs {
+    int64 float_ops = 0;
+    double bytes = 0;
+    int64 exec_micros = 0;
+  };
+
+  AdviceProto::Checker Check(const AdvisorOptionsProto::CheckerOption& options,
+                             const TFStats* stats) override {
+    if (!stats) {
+      fprintf(stderr, "Missing profiles (e.g. graph, run_meta). Skip %s\n",
+              name().c_str());
+      return reports_;
+    }
+    if (stats->steps().empty()) {
+      fprintf(stderr, "Missing RunMetadata info. Skip %s\n", name().c_str());
+      return reports_;
+    }
+    double peak_gflops = 0;
+    double peak_gbps = 0;
+    double min_efficiency = 0.1;
+    GetOption(options, "peak_gflops", &peak_gflops);
+    GetOption(options, "peak_gbps", &peak_gbps);
+    GetOption(options, "min_efficiency", &min_efficiency);
+    const bool has_roofline = peak_gflops > 0 && peak_gbps > 0;
+
+    std::map<string, Costs> op_type_costs;
+    std::vector<std::pair<const TFGraphNode*, Costs>> node_costs;
+    for (const auto& n : stats->nodes()) {
+      const TFGraphNode* node = n.second.get();
+      Costs costs;
+      costs.float_ops = node->float_ops(-1);
+      costs.exec_micros = node->exec_micros(-1);
+      if (costs.float_ops <= 0 || costs.exec_micros <= 0) continue;
+      costs.bytes = EstimateBytesAccessed(node);
+      Costs& type_costs = op_type_costs[node->op()];
+      type_costs.float_ops += costs.float_ops;
+      type_costs.bytes += costs.bytes;
+      type_costs.exec_micros += costs.exec_micros;
+      node_costs.emplace_back(node, costs);
+    }
+    if (op_type_costs.empty()) {
+      fprintf(stderr, "Missing float ops for %s\n", name().c_str());
+      return reports_;
+    }
+
+    std::vector<std::pair<string, Costs>> sorted_op_types(
+        op_type_costs.begin(), op_type_costs.end());
+    std::sort(sorted_op_types.begin(), sorted_op_types.end(),
+              [](const std::pair<string, Costs>& a,
+                 const std::pair<string, Costs>& b) {
+                return a.second.exec_micros > b.second.exec_micros;
+              });
+    std::vector<string> outputs;
+    for (int i = 0; i < 10 && i < sorted_op_types.size(); ++i) {
+      const string& op_type = sorted_op_types[i].first;
+      const Costs& costs = sorted_op_types[i].second;
+      string output = strings::Printf(
+          "%s: %.2f GFLOP/s, %.2f GB/s, %.2f FLOP/byte, exec: %s",
+          op_type.c_str(), GFlops(costs), GBps(costs), Intensity(costs),
+          FormatTime(costs.exec_micros).c_str());
+      if (has_roofline) {
+        strings::Appendf(&output, ", %.1f%% of roofline",
+                         100 * Efficiency(costs, peak_gflops, peak_gbps));
+      }
+      outputs.push_back(output);
+    }
+    reports_.add_reports(str_util::Join(outputs, "\n"));
+    if (!has_roofline) return reports_;
+
+    // The slowest operations far below the roofline.
+    std::sort(node_costs.begin(), node_costs.end(),
+              [](const std::pair<const TFGraphNode*, Costs>& a,
+                 const std::pair<const TFGraphNode*, Costs>& b) {
+                return a.second.exec_micros > b.second.exec_micros;
+              });
+    outputs.clear();
+    for (const auto& node_and_costs : node_costs) {
+      const TFGraphNode* node = node_and_costs.first;
+      const Costs& costs = node_and_costs.second;
+      const double efficiency = Efficiency(costs, peak_gflops, peak_gbps);
+      if (efficiency >= min_efficiency) continue;
+      outputs.push_back(strings::Printf(
+          "%s (%s) reaches %.1f%% of roofline: %.2f GFLOP/s, %.2f GB/s, "
+          "exec: %s",
+          node->name().c_str(), node->op().c_str(), 100 * efficiency,
+          GFlops(costs), GBps(costs), FormatTime(costs.exec_micros).c_str()));
+      if (outputs.size() == 5) break;
+    }
+    if (!outputs.empty()) {
+      reports_.add_reports(strings::StrCat(
+          "Operations below ", 100 * min_efficiency,
+          "% of roofline, maybe limited by launch overheads, layouts or "
+          "poor kernels:\n",
+          str_util::Join(outputs, "\n")));
+    }
+    return reports_;
+  }
+
+  static void GetOption(const AdvisorOptionsProto::CheckerOption& options,
+                        const string& key, double* value) {
+    const auto it = options.options().find(key);
+    if (it == options.options().end()) return;
+    if (!strings::safe_strtod(it->second.c_str(), value)) {
+      fprintf(stderr, "Invalid %s: %s\n", key.c_str(), it->second.c_str());
+    }
+  }
+
+  // Returns the number of elements of "shape", or -1 if it is unknown.
+  static int64 NumElements(const std::vector<int64>& shape) {
+    if (shape.empty()) return -1;
+    int64 num_elements = 1;
+    for (int64 dim : shape) {
+      if (dim < 0) return -1;
+      num_elements *= dim;
+    }
+    return num_elements;
+  }
+
+  static double EstimateBytesAccessed(const TFGraphNode* node) {
+    const int64 output_bytes = node->output_bytes(-1);
+    int64 output_elements = 0;
+    for (const auto& shape : node->output_shapes()) {
+      const int64 num_elements = NumElements(shape.second);
+      if (num_elements < 0) return output_bytes;
+      output_elements += num_elements;
+    }
+    if (output_elements == 0) return output_bytes;
+    const double bytes_per_element =
+        static_cast<double>(output_bytes) / output_elements;
+    double bytes = output_bytes;
+    for (const auto& shape : node->input_shapes()) {
+      const int64 num_elements = NumElements(shape.second);
+      if (num_elements > 0) bytes += num_elements * bytes_per_element;
+    }
+    return bytes;
+  }
+
+  static double GFlops(const Costs& costs) {
+    return costs.float_ops / (costs.exec_micros * 1e3);
+  }
+
+  static double GBps(const Costs& costs) {
+    return costs.bytes / (costs.exec_micros * 1e3);
+  }
+
+  static double Intensity(const Costs& costs) {
+    return costs.float_ops / (costs.bytes + 1e-10);
+  }
+
+  static double Efficiency(const Costs& costs, double peak_gflops,
+                           double peak_gbps) {
+    const double bound =
+        std::min(peak_gflops, Intensity(costs) * peak_gbps);
+    return GFlops(costs) / bound;
+  }
+
+  AdviceProto::Checker reports_;
+};
+
+}  // namespace tfprof
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_PROFILER_INTERNAL_ADVISOR_ROOFLINE_CHECKER_H_
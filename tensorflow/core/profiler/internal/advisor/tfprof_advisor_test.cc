@@ -105,5 +105,46 @@ TEST_F(TFProfAdvisorTest, ExpensiveOperationChecker) {
                             "top 1 operation type: Conv2D"));
 }
 
+TEST_F(TFProfAdvisorTest, RooflineChecker) {
+  // A MatMul running 1000 float ops and writing 1000 bytes in 1us on CPU.
+  node_defs_.push_back(std::unique_ptr<NodeDef>(new NodeDef()));
+  NodeDef* def = node_defs_.back().get();
+  def->set_name("n3");
+  def->set_op("MatMul");
+  std::unique_ptr<TFGraphNode> node(new TFGraphNode(def, -1, nullptr));
+  node->AddFloatOps(1000);
+  NodeExecStats node_stat;
+  node_stat.set_all_start_micros(10);
+  node_stat.set_op_end_rel_micros(1);
+  node_stat.add_output()
+      ->mutable_tensor_description()
+      ->mutable_allocation_description()
+      ->set_requested_bytes(1000);
+  node->AddStepStat(0, "/job:localhost/replica:0/task:0/device:cpu:0",
+                    node_stat);
+  stats_->AddNodeForTest(0, std::move(node));
+
+  AdvisorOptionsProto options;
+  (*options.mutable_checkers())[kCheckers[4]];
+  AdviceProto advice = advisor_->Advise(options);
+  ASSERT_EQ(advice.checkers().at(kCheckers[4]).reports_size(), 1);
+  EXPECT_TRUE(
+      str_util::StrContains(advice.checkers().at(kCheckers[4]).reports(0),
+                            "MatMul: 1.00 GFLOP/s, 1.00 GB/s, 1.00 FLOP/byte"));
+
+  // The roofline bound is min(100, 1 * 20) = 20 GFLOP/s.
+  auto* checker_options =
+      (*options.mutable_checkers())[kCheckers[4]].mutable_options();
+  (*checker_options)["peak_gflops"] = "100";
+  (*checker_options)["peak_gbps"] = "20";
+  advice = advisor_->Advise(options);
+  ASSERT_EQ(advice.checkers().at(kCheckers[4]).reports_size(), 2);
+  EXPECT_TRUE(str_util::StrContains(
+      advice.checkers().at(kCheckers[4]).reports(0), "5.0% of roofline"));
+  EXPECT_TRUE(
+      str_util::StrContains(advice.checkers().at(kCheckers[4]).reports(1),
+                            "n3 (MatMul) reaches 5.0% of roofline"));
+}
+
 }  // namespace tfprof
 }  // namespace tensorflow
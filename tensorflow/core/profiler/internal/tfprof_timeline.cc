@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/core/profiler/internal/tfprof_timeline.h"
 
+#include <algorithm>
+#include <functional>
 #include <utility>
 
 #include "tensorflow/core/lib/core/status.h"
@@ -37,6 +39,54 @@ string GetTimeDevName(const string& dev) {
 string GetMemoryLaneName(const string& dev) {
   return strings::StrCat("mem usage on:", dev);
 }
+
+// Prints the nodes whose tensors were alive when the memory of "device" was
+// at its peak, largest first. The peak is taken from the allocator stats or,
+// for allocators without stats such as the default CPU allocator, from the
+// sum of the tracked allocations.
+void PrintTensorsLiveAtPeak(const string& dev,
+                            const MemoryTracker::Device& device) {
+  int64 peak_micros = 0;
+  int64 peak_bytes = 0;
+  for (const auto& alloc : device.allocations) {
+    if (alloc.second > peak_bytes) {
+      peak_micros = alloc.first;
+      peak_bytes = alloc.second;
+    }
+  }
+  if (peak_bytes == 0) {
+    int64 bytes_in_use = 0;
+    for (const auto& alloc : device.tracked_allocations) {
+      bytes_in_use += alloc.second;
+      if (bytes_in_use > peak_bytes) {
+        peak_micros = alloc.first;
+        peak_bytes = bytes_in_use;
+      }
+    }
+  }
+  if (peak_bytes == 0) return;
+
+  std::vector<std::pair<int64, string>> live_tensors;
+  for (const auto& tensor_alloc_it : device.tensor_allocs) {
+    // The bytes held by the node at the last change before the peak.
+    const auto& tensor_alloc = tensor_alloc_it.second;
+    auto it = tensor_alloc.upper_bound(peak_micros);
+    if (it == tensor_alloc.begin()) continue;
+    --it;
+    if (it->second > 0) {
+      live_tensors.emplace_back(it->second, tensor_alloc_it.first);
+    }
+  }
+  std::sort(live_tensors.begin(), live_tensors.end(),
+            std::greater<std::pair<int64, string>>());
+  fprintf(stdout, "%s tensors live at peak (%.2f MB at %lld us):\n",
+          dev.c_str(), peak_bytes / 1000000.0,
+          static_cast<long long>(peak_micros));
+  for (int i = 0; i < kMaxDisplayedMemNode && i < live_tensors.size(); ++i) {
+    fprintf(stdout, "  %s: %.2f MB\n", live_tensors[i].second.c_str(),
+            live_tensors[i].first / 1000000.0);
+  }
+}
 }  // namespace
 
 Json::Value ChromeTraceFormatter::CreateEvent(const string& ph,
@@ -263,6 +313,7 @@ void Timeline::GenerateGraphTimeline(const std::vector<GraphNode*>& gnodes) {
     }
   }
   for (const auto& dev : mem_tracker_.devices()) {
+    PrintTensorsLiveAtPeak(dev.first, dev.second);
     if (IsPlacedOnCPU(dev.first)) {
       // TODO(xpan): Maybe also support CPU allocator memory tracking.
       continue;
@@ -223,6 +223,22 @@ class Session {
         "RunCallable is not supported for this session.");
   }
 
+  /// \brief Invokes the subgraph named by `handle` like `RunCallable()`, but
+  /// writes the fetches into the tensors of `*fetch_tensors`, which the
+  /// caller preallocated with the dtype and shape of each fetch.
+  ///
+  /// The ops producing the fetches on host devices write their outputs
+  /// directly into these buffers, and the other fetches are copied into
+  /// them. Only types that can be copied with memcpy are supported.
+  /// NOTE: This API is still experimental and may change.
+  virtual Status RunCallableIntoBuffers(CallableHandle handle,
+                                        const std::vector<Tensor>& feed_tensors,
+                                        std::vector<Tensor>* fetch_tensors,
+                                        RunMetadata* run_metadata) {
+    return errors::Unimplemented(
+        "RunCallableIntoBuffers is not supported for this session.");
+  }
+
   /// \brief Releases resources associated with the given `handle` in this
   /// session.
   /// NOTE: This API is still experimental and may change.
@@ -123,6 +123,14 @@ class CTCBeamSearchDecoder : public CTCDecoder {
     label_selection_margin_ = label_selection_margin;
   }
 
+  // Once the beam is full, skip the labels whose child beam could not enter
+  // it, without creating the child. This is only exact for scorers whose
+  // GetStateExpansionScore never exceeds previous_score, such as the default
+  // scorer, and avoids growing a child for almost every label at each step.
+  void SetPruneUnreachableLabels(bool prune_unreachable_labels) {
+    prune_unreachable_labels_ = prune_unreachable_labels;
+  }
+
   // Reset the beam search
   void Reset();
 
@@ -145,6 +153,7 @@ class CTCBeamSearchDecoder : public CTCDecoder {
   // For more detail: https://research.google.com/pubs/pub44823.html
   int label_selection_size_ = 0;       // zero means unlimited
   float label_selection_margin_ = -1;  // -1 means unlimited.
+  bool prune_unreachable_labels_ = false;
 
   gtl::TopN<BeamEntry*, CTCBeamComparer> leaves_;
   std::unique_ptr<BeamRoot> beam_root_;
@@ -331,6 +340,13 @@ void CTCBeamSearchDecoder<CTCBeamState, CTCBeamComparer>::Step(
       if (logit < label_selection_input_min) {
         continue;
       }
+      // The child scores at most logit - max_coeff + b->oldp.total, as
+      // previous below is at most b->oldp.total.
+      if (prune_unreachable_labels_ && leaves_.size() == beam_width_ &&
+          logit - max_coeff + b->oldp.total <=
+              leaves_.peek_bottom()->newp.total) {
+        continue;
+      }
       BeamEntry& c = b->GetChild(label);
       if (!c.Active()) {
         //   Pblank(l=abcd @ t=6) = 0
@@ -343,4 +343,52 @@ TEST(CtcBeamSearch, LabelSelection) {
   }
 }
 
+TEST(CtcBeamSearch, PruningUnreachableLabelsKeepsResults) {
+  const int batch_size = 2;
+  const int timesteps = 20;
+  const int top_paths = 4;
+  const int beam_width = 8;
+  const int num_classes = 30;
+
+  // Pseudo-random logits, peaked enough for the beam to fill up.
+  std::vector<float> input_data(timesteps * batch_size * num_classes);
+  tensorflow::uint32 state = 1;
+  for (float& logit : input_data) {
+    state = state * 1664525 + 1013904223;
+    logit = 8.0f * (state >> 8) / (1 << 24);
+  }
+  int sequence_lengths[batch_size] = {timesteps, timesteps / 2};
+  Eigen::Map<const Eigen::ArrayXi> seq_len(&sequence_lengths[0], batch_size);
+  std::vector<Eigen::Map<const Eigen::MatrixXf>> inputs;
+  inputs.reserve(timesteps);
+  for (int t = 0; t < timesteps; ++t) {
+    inputs.emplace_back(&input_data[t * batch_size * num_classes], batch_size,
+                        num_classes);
+  }
+
+  CTCBeamSearchDecoder<>::DefaultBeamScorer default_scorer;
+  std::vector<std::vector<CTCDecoder::Output>> outputs(2);
+  std::vector<Eigen::MatrixXf> scores(2);
+  for (int prune = 0; prune < 2; ++prune) {
+    CTCBeamSearchDecoder<> decoder(num_classes, beam_width, &default_scorer,
+                                   batch_size);
+    decoder.SetPruneUnreachableLabels(prune);
+    outputs[prune].resize(top_paths);
+    for (CTCDecoder::Output& output : outputs[prune]) {
+      output.resize(batch_size);
+    }
+    scores[prune].resize(batch_size, top_paths);
+    Eigen::Map<Eigen::MatrixXf> scores_map(scores[prune].data(), batch_size,
+                                           top_paths);
+    ASSERT_TRUE(
+        decoder.Decode(seq_len, inputs, &outputs[prune], &scores_map).ok());
+  }
+  for (int path = 0; path < top_paths; ++path) {
+    for (int b = 0; b < batch_size; ++b) {
+      EXPECT_EQ(outputs[0][path][b], outputs[1][path][b]);
+      EXPECT_EQ(scores[0](b, path), scores[1](b, path));
+    }
+  }
+}
+
 }  // namespace
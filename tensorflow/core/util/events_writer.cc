@@ -20,12 +20,14 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/io/write_behind_file.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/host_info.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/event.pb.h"
 
 namespace tensorflow {
@@ -34,7 +36,14 @@ EventsWriter::EventsWriter(const string& file_prefix)
     // TODO(jeff,sanjay): Pass in env and use that here instead of Env::Default
     : env_(Env::Default()),
       file_prefix_(file_prefix),
-      num_outstanding_events_(0) {}
+      num_outstanding_events_(0) {
+  Status s = ReadInt64FromEnvVar("TF_EVENTS_WRITER_WRITE_BEHIND_BYTES", 0,
+                                 &write_behind_bytes_);
+  if (!s.ok()) {
+    LOG(WARNING) << s;
+    write_behind_bytes_ = 0;
+  }
+}
 
 EventsWriter::~EventsWriter() {
   Close().IgnoreError();  // Autoclose in destructor.
@@ -72,6 +81,11 @@ Status EventsWriter::InitIfNeeded() {
   TF_RETURN_WITH_CONTEXT_IF_ERROR(
       env_->NewWritableFile(filename_, &recordio_file_),
       "Creating writable file ", filename_);
+  write_behind_ = write_behind_bytes_ > 0;
+  if (write_behind_) {
+    recordio_file_.reset(new io::WriteBehindWritableFile(
+        env_, std::move(recordio_file_), write_behind_bytes_));
+  }
   recordio_writer_.reset(new io::RecordWriter(recordio_file_.get()));
   if (recordio_writer_ == nullptr) {
     return errors::Unknown("Could not create record writer");
@@ -124,6 +138,15 @@ Status EventsWriter::Flush() {
   TF_RETURN_WITH_CONTEXT_IF_ERROR(recordio_writer_->Flush(), "Failed to flush ",
                                   num_outstanding_events_, " events to ",
                                   filename_);
+  if (write_behind_) {
+    // Only schedules the events to be written, and does not check that the
+    // file still exists, which would stall on remote file systems.
+    TF_RETURN_WITH_CONTEXT_IF_ERROR(recordio_file_->Flush(), "Failed to flush ",
+                                    num_outstanding_events_, " events to ",
+                                    filename_);
+    num_outstanding_events_ = 0;
+    return Status::OK();
+  }
   TF_RETURN_WITH_CONTEXT_IF_ERROR(recordio_file_->Sync(), "Failed to sync ",
                                   num_outstanding_events_, " events to ",
                                   filename_);
@@ -79,6 +79,15 @@ class EventsWriter {
   Status Flush();
   Status Close();
 
+  // If `bytes` is positive, the events are written to the file on a
+  // background thread, with up to `bytes` of them buffered. Flush() then only
+  // schedules the events to be written and flushed, and does not wait for
+  // them: write errors are returned by later calls. Close() still waits.
+  //
+  // Applies to the events files opened after the call. Defaults to the
+  // TF_EVENTS_WRITER_WRITE_BEHIND_BYTES environment variable, or 0.
+  void set_write_behind_bytes(int64 bytes) { write_behind_bytes_ = bytes; }
+
  private:
   Status FileStillExists();  // OK if event_file_path_ exists.
   Status InitIfNeeded();
@@ -90,6 +99,8 @@ class EventsWriter {
   std::unique_ptr<WritableFile> recordio_file_;
   std::unique_ptr<io::RecordWriter> recordio_writer_;
   int num_outstanding_events_;
+  int64 write_behind_bytes_;
+  bool write_behind_ = false;  // Whether recordio_file_ writes behind.
   TF_DISALLOW_COPY_AND_ASSIGN(EventsWriter);
 };
 
@@ -126,6 +126,18 @@ TEST(EventWriter, WriteClose) {
   VerifyFile(filename);
 }
 
+TEST(EventWriter, WriteBehindClose) {
+  string file_prefix = GetDirName("/writebehindclose_test");
+  EventsWriter writer(file_prefix);
+  writer.set_write_behind_bytes(16);
+  WriteFile(&writer);
+  TF_EXPECT_OK(writer.Flush());
+  WriteFile(&writer);
+  TF_EXPECT_OK(writer.Close());
+  string filename = writer.FileName();
+  VerifyFile(filename);
+}
+
 TEST(EventWriter, WriteDelete) {
   string file_prefix = GetDirName("/writedelete_test");
   EventsWriter* writer = new EventsWriter(file_prefix);
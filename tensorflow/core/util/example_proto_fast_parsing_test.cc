@@ -211,6 +211,19 @@ TEST(FastParse, SingleInt64) {
   TestCorrectness(Serialize(example));
 }
 
+TEST(FastParse, LongPackedLists) {
+  Example example;
+  auto& features = *example.mutable_features()->mutable_feature();
+  auto* int64_list = features["ids"].mutable_int64_list();
+  auto* float_list = features["weights"].mutable_float_list();
+  for (int i = 0; i < 1000; ++i) {
+    // Varints of 1 to 10 bytes.
+    int64_list->add_value(i % 2 == 0 ? -i : int64{1} << (i % 63));
+    float_list->add_value(i * 0.25f);
+  }
+  TestCorrectness(Serialize(example));
+}
+
 TEST(FastParse, SomeFeatures) {
   Example example;
 
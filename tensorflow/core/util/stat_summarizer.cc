@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/util/stat_summarizer.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <map>
 #include <queue>
@@ -24,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/framework/step_stats.pb.h"
 #include "tensorflow/core/framework/tensor_description.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/lib/strings/numbers.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
@@ -162,6 +164,7 @@ void StatSummarizer::ProcessStepStats(const StepStats& step_stats) {
           // for edge_ memcpys). We only care that it's a memcpy for now.
           op_type = "gpu:" + parts.back();
         }
+        AddTransfer(ns);
       } else {
         op_type = OpType(ds, ns);
       }
@@ -216,6 +219,39 @@ void StatSummarizer::ProcessStepStats(const StepStats& step_stats) {
   stats_calculator_->UpdateMemoryUsed(mem_total);
 }
 
+void StatSummarizer::AddTransfer(const NodeExecStats& ns) {
+  const std::vector<string> parts =
+      str_util::Split(ns.timeline_label(), ' ');
+  int64 bytes;
+  if (parts.size() < 2 || !str_util::StartsWith(parts[0], "MEMCPY") ||
+      !strings::safe_strto64(parts[1], &bytes)) {
+    return;
+  }
+  TransferStats* transfer = &transfers_[parts[0].substr(6)];
+  ++transfer->count;
+  transfer->bytes += bytes;
+  transfer->time_us += ns.all_end_rel_micros();
+}
+
+std::string StatSummarizer::GetTransferSummary() const {
+  const int num_runs = std::max(stats_calculator_->num_runs(), 1);
+  std::stringstream stream;
+  for (const auto& entry : transfers_) {
+    const TransferStats& transfer = entry.second;
+    stream << "Transfers " << entry.first << ": "
+           << transfer.count / static_cast<double>(num_runs)
+           << " copies per run, "
+           << transfer.bytes / static_cast<double>(num_runs)
+           << " bytes per run, "
+           << transfer.time_us / static_cast<double>(num_runs)
+           << " us per run";
+    if (transfer.time_us > 0) {
+      stream << ", " << transfer.bytes / (transfer.time_us * 1e3) << " GB/s";
+    }
+    stream << std::endl;
+  }
+  return stream.str();
+}
 
 void StatSummarizer::PrintOutputs() const {
   std::priority_queue<
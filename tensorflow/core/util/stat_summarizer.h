@@ -73,6 +73,11 @@ class StatSummarizer {
   // Prints the output tensor sizes and types for each node.
   void PrintOutputs() const;
 
+  // Returns the copies between host and devices traced on the /memcpy lanes
+  // (with RunOptions::HARDWARE_TRACE), by kind, averaged over the runs. It is
+  // empty if no copy was traced.
+  std::string GetTransferSummary() const;
+
   void ComputeStatsByType(
       std::map<std::string, int64_t>* node_type_map_count,
       std::map<std::string, int64_t>* node_type_map_time,
@@ -106,7 +111,17 @@ class StatSummarizer {
   void Validate(const std::vector<TensorDescription>* outputs,
                 const NodeExecStats& ns) const;
 
+  // Adds the copy traced by ns, labeled "MEMCPY<kind> <bytes> bytes ...".
+  void AddTransfer(const NodeExecStats& ns);
+
+  struct TransferStats {
+    int64 count = 0;
+    int64 bytes = 0;
+    int64 time_us = 0;
+  };
+
   std::map<std::string, std::vector<TensorDescription> > outputs_;
+  std::map<std::string, TransferStats> transfers_;
 
   std::unique_ptr<StatsCalculator> stats_calculator_;
 };
@@ -84,5 +84,40 @@ versions {
   ASSERT_TRUE(by_node_type.find("Const") != std::string::npos) << by_node_type;
 }
 
+TEST(StatSummarizerTest, SummarizesTransfers) {
+  const std::string step_stats_str(R"EOF(
+dev_stats {
+  device: "/device:SYCL:0/memcpy"
+  node_stats {
+    node_name: "x:MEMCPYHtoD"
+    all_start_micros: 10
+    all_end_rel_micros: 4
+    timeline_label: "MEMCPYHtoD 4000 bytes"
+  }
+  node_stats {
+    node_name: "y:MEMCPYDtoH"
+    all_start_micros: 20
+    all_end_rel_micros: 2
+    timeline_label: "MEMCPYDtoH 1000 bytes"
+  }
+}
+  )EOF");
+  StepStats step_stats;
+  ASSERT_TRUE(
+      protobuf::TextFormat::ParseFromString(step_stats_str, &step_stats));
+
+  StatSummarizer stats((StatSummarizerOptions()));
+  EXPECT_EQ("", stats.GetTransferSummary());
+  stats.ProcessStepStats(step_stats);
+  stats.ProcessStepStats(step_stats);
+
+  EXPECT_EQ(
+      "Transfers DtoH: 1 copies per run, 1000 bytes per run, 2 us per run, "
+      "0.5 GB/s\n"
+      "Transfers HtoD: 1 copies per run, 4000 bytes per run, 4 us per run, "
+      "1 GB/s\n",
+      stats.GetTransferSummary());
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -21,6 +21,7 @@ limitations under the License.
 #include <memory>
 #include <utility>
 
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb_text.h"
@@ -39,6 +40,7 @@ limitations under the License.
 #include "tensorflow/core/lib/hash/crc32c.h"
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/lib/io/table_builder.h"
+#include "tensorflow/core/lib/io/write_behind_file.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/util/saved_tensor_slice_util.h"
@@ -54,6 +56,10 @@ const int kTensorBundleVersion = 1;
 // Size of our input buffer for streaming reads
 static const int kBufferSize = 1024 * 1024;
 
+// Maximum size of the stored slices kept by a BundleReader between lookups of
+// slices of the same tensor.
+static const int64 kMaxCachedSliceBytes = 256 << 20;
+
 // Key to the special BundleHeaderProto entry.  Do not change this, as clients
 // can make the assumption that the header is always the first entry in the
 // bundle.
@@ -385,6 +391,10 @@ BundleWriter::BundleWriter(Env* env, StringPiece prefix, const Options& options)
   std::unique_ptr<WritableFile> wrapper;
   status_ = env_->NewWritableFile(tmp_data_path_, &wrapper);
   if (!status_.ok()) return;
+  if (options_.write_behind_bytes > 0) {
+    wrapper.reset(new io::WriteBehindWritableFile(
+        env_, std::move(wrapper), options_.write_behind_bytes));
+  }
   out_ = std::unique_ptr<FileOutputBuffer>(
       new FileOutputBuffer(wrapper.release(), 8 << 20 /* 8MB write buffer */));
 
@@ -693,11 +703,38 @@ Status MergeBundles(Env* env, gtl::ArraySlice<string> prefixes,
   return status;
 }
 
+// Allocates the buffer of one tensor in a memory mapped data file: the
+// buffer starts "offset" bytes into "region". Owned by the tensor buffer, and
+// deleted with it.
+class MappedTensorAllocator : public Allocator {
+ public:
+  MappedTensorAllocator(std::shared_ptr<ReadOnlyMemoryRegion> region,
+                        uint64 offset)
+      : region_(std::move(region)), offset_(offset) {}
+
+  string Name() override { return "MappedTensorAllocator"; }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    return const_cast<char*>(static_cast<const char*>(region_->data()) +
+                             offset_);
+  }
+
+  void DeallocateRaw(void* ptr) override { delete this; }
+
+ private:
+  const std::shared_ptr<ReadOnlyMemoryRegion> region_;
+  const uint64 offset_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(MappedTensorAllocator);
+};
+
 // Interface for reading a tensor bundle.
 
-BundleReader::BundleReader(Env* env, StringPiece prefix)
+BundleReader::BundleReader(Env* env, StringPiece prefix,
+                           const Options& options)
     : env_(env),
       prefix_(std::string(prefix)),
+      options_(options),
       metadata_(nullptr),
       table_(nullptr),
       iter_(nullptr) {
@@ -775,7 +812,57 @@ Status BundleReader::GetBundleEntryProto(StringPiece key,
   return Status::OK();
 }
 
+bool BundleReader::GetMappedValue(const BundleEntryProto& entry, Tensor* val) {
+  const TensorShape shape(entry.shape());
+  if (!DataTypeCanUseMemcpy(entry.dtype()) || shape.num_elements() == 0 ||
+      entry.size() != shape.num_elements() * DataTypeSize(entry.dtype())) {
+    return false;
+  }
+
+  // Map the data file if it has not been tried yet.
+  auto it = mapped_data_.find(entry.shard_id());
+  if (it == mapped_data_.end()) {
+    std::unique_ptr<ReadOnlyMemoryRegion> region;
+    const string filename =
+        DataFilename(prefix_, entry.shard_id(), num_shards_);
+    Status status = env_->NewReadOnlyMemoryRegionFromFile(filename, &region);
+    if (!status.ok()) {
+      VLOG(1) << "Reading " << filename << " without mapping it: " << status;
+    }
+    it = mapped_data_.emplace(entry.shard_id(), std::move(region)).first;
+  }
+  const std::shared_ptr<ReadOnlyMemoryRegion>& region = it->second;
+  if (region == nullptr || entry.offset() + entry.size() > region->length()) {
+    return false;
+  }
+  const char* data = static_cast<const char*>(region->data()) + entry.offset();
+  if (reinterpret_cast<uintptr_t>(data) % Allocator::kAllocatorAlignment != 0) {
+    return false;
+  }
+
+  // The allocator is owned by the tensor buffer from here on.
+  *val = Tensor(new MappedTensorAllocator(region, entry.offset()),
+                entry.dtype(), shape);
+  return true;
+}
+
 Status BundleReader::GetValue(const BundleEntryProto& entry, Tensor* val) {
+  if (options_.memory_map && val->NumElements() == 0) {
+    Tensor mapped;
+    if (GetMappedValue(entry, &mapped)) {
+      const uint32 actual_crc32c =
+          crc32c::Value(mapped.tensor_data().data(), entry.size());
+      if (crc32c::Unmask(entry.crc32c()) != actual_crc32c) {
+        return errors::DataLoss(
+            "Checksum does not match: stored ",
+            strings::Printf("%08u", crc32c::Unmask(entry.crc32c())),
+            " vs. calculated on the restored bytes ", actual_crc32c);
+      }
+      *val = mapped;
+      return Status::OK();
+    }
+  }
+
   Tensor* ret = val;
   const TensorShape stored_shape(TensorShape(entry.shape()));
   if (val->NumElements() == 0) {
@@ -988,9 +1075,30 @@ Status BundleReader::GetSliceValue(StringPiece full_tensor_key,
       return status_;
     }
 
-    Tensor stored_slice_tensor(stored_slice_entry.dtype(), stored_slice_shape);
-    status_ = GetValue(stored_slice_entry, &stored_slice_tensor);
-    if (!status_.ok()) return status_;
+    // The stored slices read for the previous slices of the same tensor are
+    // kept, as resharding reads each of them for every new slice it overlaps.
+    if (cached_slices_key_ != full_tensor_key_string) {
+      cached_slices_key_ = full_tensor_key_string;
+      cached_slices_.clear();
+      cached_slices_bytes_ = 0;
+    }
+    const string cache_key =
+        checkpoint::EncodeTensorNameSlice(full_tensor_key_string, stored_slice);
+    Tensor stored_slice_tensor;
+    const Tensor* cached = gtl::FindOrNull(cached_slices_, cache_key);
+    if (cached != nullptr) {
+      stored_slice_tensor = *cached;
+    } else {
+      stored_slice_tensor =
+          Tensor(stored_slice_entry.dtype(), stored_slice_shape);
+      status_ = GetValue(stored_slice_entry, &stored_slice_tensor);
+      if (!status_.ok()) return status_;
+      const int64 bytes = stored_slice_tensor.TotalBytes();
+      if (cached_slices_bytes_ + bytes <= kMaxCachedSliceBytes) {
+        cached_slices_[cache_key] = stored_slice_tensor;
+        cached_slices_bytes_ += bytes;
+      }
+    }
 
     // Copies the intersection over.
     const DataType common_dtype = full_tensor_entry.dtype();
@@ -64,6 +64,7 @@ limitations under the License.
 #include "tensorflow/core/protobuf/tensor_bundle.pb.h"
 
 #include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -112,6 +113,10 @@ class BundleWriter {
     // Alignment, in bytes, for tensor data.
     // Must be >= 1. The default size of 1 densely packs tensors.
     int data_alignment{1};
+    // If positive, the data file is written on a background thread with up
+    // to this many bytes buffered, so that Add() does not wait for the file
+    // system. Finish() waits for all the writes.
+    int64 write_behind_bytes{0};
   };
   BundleWriter(Env* env, StringPiece prefix,
                const Options& options = Options());
@@ -181,7 +186,18 @@ Status MergeBundles(Env* env, gtl::ArraySlice<string> prefixes,
 // All threads accessing the same BundleReader must synchronize.
 class BundleReader {
  public:
-  BundleReader(Env* const env, StringPiece prefix);
+  struct Options {
+    Options() {}
+    // Whether to map the data files into memory, if the file system supports
+    // it. The tensors of memcpy-able types whose data is aligned, e.g. written
+    // with BundleWriter::Options::data_alignment = 64, then point into the
+    // mapped files instead of being copied, so that the processes restoring
+    // the same bundle share its pages. They must not be modified, and keep
+    // the mapping alive after the reader is gone.
+    bool memory_map{false};
+  };
+  BundleReader(Env* const env, StringPiece prefix,
+               const Options& options = Options());
   ~BundleReader();
 
   // Is ok() iff the reader construction is successful (completed the read of
@@ -274,6 +290,10 @@ class BundleReader {
   Status GetValue(const BundleEntryProto& entry,
                   Tensor* val) TF_MUST_USE_RESULT;
 
+  // Sets "*val" to a tensor pointing into the memory mapped data file, if
+  // "entry" allows it. Returns false if it does not.
+  bool GetMappedValue(const BundleEntryProto& entry, Tensor* val);
+
   // Reads the slice described by "slice_spec".  The corresponding full tensor
   // has key "ful_tensor_key" and metadata proto "full_tensor_entry".
   // REQUIRES: full_tensor_entry.slices_size() > 0
@@ -284,6 +304,7 @@ class BundleReader {
 
   Env* env_;  // Not owned.
   const string prefix_;
+  const Options options_;
 
   Status status_;
   RandomAccessFile* metadata_;  // Owned.
@@ -291,11 +312,21 @@ class BundleReader {
   table::Iterator* iter_;
   // Owned the InputBuffer objects and their underlying RandomAccessFile's.
   std::unordered_map<int32, io::InputBuffer*> data_;
+  // The memory mapped data files, or null for the ones that cannot be mapped.
+  // Shared with the tensors pointing into them.
+  std::unordered_map<int32, std::shared_ptr<ReadOnlyMemoryRegion>>
+      mapped_data_;
 
   // Maps each partitioned tensor's key to its stored slices (represented in a
   // TensorSliceSet).  Populated on-demand.
   std::unordered_map<string, checkpoint::TensorSliceSet*> tensor_slices_;
 
+  // The stored slices of the partitioned tensor "cached_slices_key_" read by
+  // GetSliceValue(), by encoded slice key, and their total size.
+  string cached_slices_key_;
+  std::unordered_map<string, Tensor> cached_slices_;
+  int64 cached_slices_bytes_ = 0;
+
   // Expected number of data file shards in the bundle.  Extracted by reading
   // the header entry in the metadata table.
   int num_shards_;
@@ -392,6 +392,42 @@ TEST(TensorBundleTest, PartitionedVariables) {
   }
 }
 
+TEST(TensorBundleTest, ReshardedPartitionedVariables) {
+  // Saved in two slices of rows, with row i holding i.
+  const TensorShape kFullShape({4, 3});
+  {
+    BundleWriter writer(Env::Default(), Prefix("resharded"));
+    for (int start : {0, 2}) {
+      Tensor slice_val(DT_FLOAT, TensorShape({2, 3}));
+      test::FillFn<float>(&slice_val, [start](int offset) -> float {
+        return start + offset / 3;
+      });
+      const TensorSlice slice =
+          TensorSlice::ParseOrDie(strings::StrCat(start, ",2:-"));
+      TF_ASSERT_OK(writer.AddSlice("foo", kFullShape, slice, slice_val));
+    }
+    TF_ASSERT_OK(writer.Finish());
+  }
+  // Restored in three slices of rows, reusing the stored slices read for the
+  // previous ones.
+  BundleReader reader(Env::Default(), Prefix("resharded"));
+  TF_ASSERT_OK(reader.status());
+  for (const auto& start_and_length :
+       std::vector<std::pair<int, int>>({{0, 1}, {1, 2}, {3, 1}, {1, 2}})) {
+    const int start = start_and_length.first;
+    const int length = start_and_length.second;
+    Tensor expected_val(DT_FLOAT, TensorShape({length, 3}));
+    test::FillFn<float>(&expected_val, [start](int offset) -> float {
+      return start + offset / 3;
+    });
+    const TensorSlice slice =
+        TensorSlice::ParseOrDie(strings::StrCat(start, ",", length, ":-"));
+    Tensor val(DT_FLOAT, TensorShape({length, 3}));
+    TF_ASSERT_OK(reader.LookupSlice("foo", slice, &val));
+    test::ExpectTensorEqual<float>(val, expected_val);
+  }
+}
+
 TEST(TensorBundleTest, EquivalentSliceTest) {
   const TensorShape kFullShape({5, 10});
   const Tensor kExpected(Constant<float>(1., kFullShape));
@@ -825,6 +861,62 @@ TEST_F(TensorBundleAlignmentTest, AlignmentTest) {
   }
 }
 
+TEST(TensorBundleTest, WriteBehind) {
+  {
+    BundleWriter::Options opts;
+    opts.write_behind_bytes = 16;
+    BundleWriter writer(Env::Default(), Prefix("write_behind"), opts);
+    for (int i = 0; i < 10; ++i) {
+      TF_EXPECT_OK(writer.Add(strings::StrCat("foo_", i),
+                              Constant_2x3<float>(i)));
+    }
+    TF_EXPECT_OK(writer.Add("strings", Constant<string>("abc", {100})));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  {
+    BundleReader reader(Env::Default(), Prefix("write_behind"));
+    TF_ASSERT_OK(reader.status());
+    for (int i = 0; i < 10; ++i) {
+      Expect<float>(&reader, strings::StrCat("foo_", i),
+                    Constant_2x3<float>(i));
+    }
+    Expect<string>(&reader, "strings", Constant<string>("abc", {100}));
+  }
+}
+
+TEST(TensorBundleTest, MemoryMap) {
+  for (int alignment : {1, 64}) {
+    {
+      BundleWriter::Options opts;
+      opts.data_alignment = alignment;
+      BundleWriter writer(Env::Default(), Prefix("mapped"), opts);
+      TF_EXPECT_OK(writer.Add("flag", Constant(true, TensorShape({1}))));
+      TF_EXPECT_OK(writer.Add("float", Constant_2x3<float>(1.5)));
+      TF_EXPECT_OK(writer.Add("string", Constant_2x3<string>("foo")));
+      TF_ASSERT_OK(writer.Finish());
+    }
+    BundleReader::Options opts;
+    opts.memory_map = true;
+    Tensor first;
+    {
+      BundleReader reader(Env::Default(), Prefix("mapped"), opts);
+      TF_ASSERT_OK(reader.status());
+      Expect<bool>(&reader, "flag", Constant(true, TensorShape({1})));
+      Expect<float>(&reader, "float", Constant_2x3<float>(1.5));
+      Expect<string>(&reader, "string", Constant_2x3<string>("foo"));
+
+      // The aligned tensors point into the mapped file, which outlives the
+      // reader.
+      Tensor second;
+      TF_ASSERT_OK(reader.Lookup("float", &first));
+      TF_ASSERT_OK(reader.Lookup("float", &second));
+      EXPECT_EQ(alignment == 64,
+                first.tensor_data().data() == second.tensor_data().data());
+    }
+    test::ExpectTensorEqual<float>(first, Constant_2x3<float>(1.5));
+  }
+}
+
 static void BM_BundleAlignmentByteOff(int iters, int alignment,
                                       int tensor_size) {
   testing::StopTiming();
@@ -15,10 +15,31 @@ limitations under the License.
 
 #include "tensorflow/core/util/work_sharder.h"
 
+#include <chrono>  // NOLINT(build/c++11)
+
 #include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/platform/logging.h"
 
 namespace tensorflow {
+namespace {
+
+// If total * cost_per_unit is small, it is not worth shard too
+// much. Let us assume each cost unit is 1ns, kMinCostPerShard=10000
+// is 10us.
+const int64 kMinCostPerShard = 10000;
+
+// The learned costs are kept in fixed point with this many fractional bits,
+// since cheap units (e.g. copying a few bytes) take less than a nanosecond.
+const int kCostShift = 10;
+
+// Env only has a microsecond clock, which is too coarse to time shards.
+uint64 NowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
 
 void Shard(int max_parallelism, thread::ThreadPool* workers, int64 total,
            int64 cost_per_unit, std::function<void(int64, int64)> work) {
@@ -38,11 +59,6 @@ void Shard(int max_parallelism, thread::ThreadPool* workers, int64 total,
   cost_per_unit = std::max(int64{1}, cost_per_unit);
   // We shard [0, total) into "num_shards" shards.
   //   1 <= num_shards <= num worker threads
-  //
-  // If total * cost_per_unit is small, it is not worth shard too
-  // much. Let us assume each cost unit is 1ns, kMinCostPerShard=10000
-  // is 10us.
-  static const int64 kMinCostPerShard = 10000;
   const int num_shards =
       std::max<int>(1, std::min(static_cast<int64>(max_parallelism),
                                 total * cost_per_unit / kMinCostPerShard));
@@ -74,4 +90,70 @@ void Shard(int max_parallelism, thread::ThreadPool* workers, int64 total,
   counter.Wait();
 }
 
+AdaptiveShardCost::AdaptiveShardCost() {
+  for (auto& cost : cost_per_unit_) cost.store(0, std::memory_order_relaxed);
+}
+
+int AdaptiveShardCost::Bucket(int64 total) {
+  int bucket = 0;
+  while (total > 1 && bucket < kNumBuckets - 1) {
+    total >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+int64 AdaptiveShardCost::CostPerUnit(int64 total, int64 cost_per_unit) const {
+  const int64 learned =
+      cost_per_unit_[Bucket(total)].load(std::memory_order_relaxed);
+  if (learned == 0) return cost_per_unit;
+  // Round up, so that learned costs never drop below 1.
+  return (learned + (int64{1} << kCostShift) - 1) >> kCostShift;
+}
+
+void AdaptiveShardCost::Record(int64 total, int64 units, uint64 nanos) {
+  if (units <= 0) return;
+  // Cap the sample so that it cannot overflow once shifted; such units are
+  // expensive enough to be sharded as finely as possible anyway.
+  const uint64 kMaxNanos = uint64{1} << 40;
+  const int64 sample = std::max<int64>(
+      1, static_cast<int64>(std::min(nanos, kMaxNanos) << kCostShift) / units);
+  std::atomic<int64>& cost = cost_per_unit_[Bucket(total)];
+  const int64 old = cost.load(std::memory_order_relaxed);
+  // An exponential moving average, so that a single noisy sample (e.g. the
+  // calling thread being preempted) does not swing the sharding.
+  cost.store(old == 0 ? sample : (old * 7 + sample) / 8,
+             std::memory_order_relaxed);
+}
+
+void AdaptiveShard(int max_parallelism, thread::ThreadPool* workers,
+                   int64 total, int64 cost_per_unit, AdaptiveShardCost* cost,
+                   std::function<void(int64, int64)> work) {
+  CHECK(cost != nullptr);
+  CHECK_GE(total, 0);
+  if (total == 0) {
+    return;
+  }
+  const int64 learned_cost_per_unit = cost->CostPerUnit(total, cost_per_unit);
+  if (max_parallelism <= 1 ||
+      total * learned_cost_per_unit < kMinCostPerShard) {
+    // Not worth sharding: run inline, which also refines the estimate.
+    const uint64 start_nanos = NowNanos();
+    work(0, total);
+    cost->Record(total, total, NowNanos() - start_nanos);
+    return;
+  }
+  // Time the shard starting at 0, which the calling thread usually runs.
+  Shard(max_parallelism, workers, total, learned_cost_per_unit,
+        [total, cost, &work](int64 start, int64 limit) {
+          if (start != 0) {
+            work(start, limit);
+            return;
+          }
+          const uint64 start_nanos = NowNanos();
+          work(start, limit);
+          cost->Record(total, limit - start, NowNanos() - start_nanos);
+        });
+}
+
 }  // end namespace tensorflow
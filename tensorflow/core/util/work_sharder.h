@@ -16,9 +16,11 @@ limitations under the License.
 #ifndef TENSORFLOW_UTIL_WORK_SHARDER_H_
 #define TENSORFLOW_UTIL_WORK_SHARDER_H_
 
+#include <atomic>
 #include <functional>
 
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/types.h"
 
 namespace tensorflow {
@@ -48,6 +50,49 @@ namespace tensorflow {
 void Shard(int max_parallelism, thread::ThreadPool* workers, int64 total,
            int64 cost_per_unit, std::function<void(int64, int64)> work);
 
+// Learns the actual cost per unit of work of one call site of AdaptiveShard,
+// in nanoseconds, from timing the shards it runs. The costs are kept per
+// power-of-two bucket of "total", since the per-unit cost usually depends on
+// the size of the work (e.g. on how much of it fits in cache). It is meant to
+// be a function-local static at the call site:
+//
+//   static AdaptiveShardCost* cost = new AdaptiveShardCost;
+//   AdaptiveShard(max_parallelism, workers, total, cost_per_unit, cost, work);
+//
+// Thread-safe. Concurrent updates may lose a sample, which is harmless.
+class AdaptiveShardCost {
+ public:
+  AdaptiveShardCost();
+
+  // Returns the cost per unit learned for "total" units, or "cost_per_unit"
+  // if none has been learned yet.
+  int64 CostPerUnit(int64 total, int64 cost_per_unit) const;
+
+  // Records that "units" of the "total" units took "nanos" to run.
+  void Record(int64 total, int64 units, uint64 nanos);
+
+ private:
+  static const int kNumBuckets = 64;
+
+  static int Bucket(int64 total);
+
+  // The learned cost per unit of each bucket in 1/1024th of a nanosecond, or
+  // 0 if unknown.
+  std::atomic<int64> cost_per_unit_[kNumBuckets];
+
+  TF_DISALLOW_COPY_AND_ASSIGN(AdaptiveShardCost);
+};
+
+// Like Shard, but "cost_per_unit" is only the initial estimate: the cost
+// actually used is the one "cost" learned for "total", which is updated from
+// the time taken by the shard run by the calling thread. Work whose learned
+// total cost is too small to be worth sharding is run inline.
+//
+// REQUIRES: cost != nullptr
+void AdaptiveShard(int max_parallelism, thread::ThreadPool* workers,
+                   int64 total, int64 cost_per_unit, AdaptiveShardCost* cost,
+                   std::function<void(int64, int64)> work);
+
 }  // end namespace tensorflow
 
 #endif  // TENSORFLOW_UTIL_WORK_SHARDER_H_
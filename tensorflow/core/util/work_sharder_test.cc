@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/util/work_sharder.h"
 
+#include <algorithm>
 #include <atomic>
 #include <vector>
 #include "tensorflow/core/lib/core/threadpool.h"
@@ -76,6 +77,65 @@ TEST(Shard, OverflowTest) {
   }
 }
 
+TEST(AdaptiveShard, Basic) {
+  thread::ThreadPool threads(Env::Default(), "test", 16);
+  AdaptiveShardCost cost;
+  for (auto workers : {0, 1, 2, 7, 16, 100}) {
+    for (auto total : {0, 1, 7, 64, 1000, 9999}) {
+      for (auto cost_per_unit : {0, 1, 1003, 1000007}) {
+        mutex mu;
+        std::vector<bool> work(total, false);
+        AdaptiveShard(workers, &threads, total, cost_per_unit, &cost,
+                      [&mu, &work](int64 start, int64 limit) {
+                        mutex_lock l(mu);
+                        for (; start < limit; ++start) {
+                          EXPECT_FALSE(work[start]);  // No duplicate
+                          work[start] = true;
+                        }
+                      });
+        EXPECT_EQ(std::count(work.begin(), work.end(), true), total);
+      }
+    }
+  }
+}
+
+TEST(AdaptiveShard, LearnsCostPerUnit) {
+  AdaptiveShardCost cost;
+  EXPECT_EQ(cost.CostPerUnit(1000, 77), 77);
+  // 1000 units taking 5us cost 5ns each.
+  cost.Record(1000, 1000, 5000);
+  EXPECT_EQ(cost.CostPerUnit(1000, 77), 5);
+  EXPECT_EQ(cost.CostPerUnit(1023, 77), 5);
+  // Other sizes are learned separately.
+  EXPECT_EQ(cost.CostPerUnit(100, 77), 77);
+  // The estimate moves towards new samples without jumping to them.
+  cost.Record(1000, 1000, 13000);
+  EXPECT_EQ(cost.CostPerUnit(1000, 77), 6);
+  // Units cheaper than a nanosecond still cost at least 1.
+  cost.Record(100, 100, 1);
+  EXPECT_EQ(cost.CostPerUnit(100, 77), 1);
+}
+
+TEST(AdaptiveShard, RunsCheapWorkInline) {
+  thread::ThreadPool threads(Env::Default(), "test", 16);
+  AdaptiveShardCost cost;
+  // The initial estimate is far too high, so the first call is sharded.
+  const int64 total = 1000;
+  cost.Record(total, total, 1000 * 1000);
+  std::atomic<int> num_shards(0);
+  auto count_shards = [&num_shards](int64 start, int64 limit) {
+    ++num_shards;
+  };
+  AdaptiveShard(4, &threads, total, 1, &cost, count_shards);
+  EXPECT_GT(num_shards.load(), 1);
+  // Once the work is known to be cheap, it runs in a single shard.
+  for (int i = 0; i < 100; ++i) {
+    num_shards = 0;
+    AdaptiveShard(4, &threads, total, 1, &cost, count_shards);
+  }
+  EXPECT_EQ(num_shards.load(), 1);
+}
+
 void BM_Sharding(int iters, int arg) {
   thread::ThreadPool threads(Env::Default(), "test", 16);
   const int64 total = 1LL << 30;
@@ -210,6 +210,39 @@ class BatchDatasetTest(test.TestCase):
           r'First element had shape \[3\] and element 2 had shape \[4\].'):
         sess.run(next_element)
 
+  def testBatchTensorSlicesInPlace(self):
+    # `TensorSliceDataset` produces the batches as ranges of rows of its
+    # tensors, including strings and misaligned ranges.
+    components = (np.arange(10, dtype=np.int8),
+                  np.array([[i, -i] for i in range(10)], dtype=np.float32),
+                  np.array([compat.as_bytes(str(i)) for i in range(10)]))
+    iterator = (
+        dataset_ops.Dataset.from_tensor_slices(components).batch(3)
+        .make_one_shot_iterator())
+    next_element = iterator.get_next()
+
+    with self.test_session() as sess:
+      for start in range(0, 10, 3):
+        result = sess.run(next_element)
+        for component, result_component in zip(components, result):
+          self.assertAllEqual(component[start:start + 3], result_component)
+      with self.assertRaises(errors.OutOfRangeError):
+        sess.run(next_element)
+
+  def testBatchRangeInPlace(self):
+    for start, stop, step in [(0, 10, 3), (10, 0, -3), (5, 5, 1), (0, 4, 1)]:
+      iterator = (
+          dataset_ops.Dataset.range(start, stop, step).batch(2)
+          .make_one_shot_iterator())
+      next_element = iterator.get_next()
+      expected = list(range(start, stop, step))
+
+      with self.test_session() as sess:
+        for i in range(0, len(expected), 2):
+          self.assertAllEqual(expected[i:i + 2], sess.run(next_element))
+        with self.assertRaises(errors.OutOfRangeError):
+          sess.run(next_element)
+
   def testPaddedBatchDataset(self):
     seq_lens = array_ops.placeholder(dtypes.int32, shape=[None])
     padded_shape = array_ops.placeholder(dtypes.int64, shape=[1])
@@ -199,6 +199,32 @@ class FilesystemCacheDatasetTest(test.TestCase):
       self.assertAllEqual(elements, elements_itr1)
       self.assertAllEqual(elements, elements_itr2)
 
+  def testCompressedCache(self):
+    count = array_ops.placeholder(dtypes.int64, shape=[])
+    dataset = (dataset_ops.Dataset.range(count)
+               .map(lambda x: (x, array_ops.fill([1000], x)))
+               .cache(self.cache_prefix, compression_type="ZLIB"))
+    iterator = dataset.make_initializable_iterator()
+    get_next = iterator.get_next()
+
+    with self.test_session() as sess:
+      sess.run(iterator.initializer, feed_dict={count: 100})
+      for i in range(100):
+        value, filled = sess.run(get_next)
+        self.assertEqual(i, value)
+        self.assertAllEqual([i] * 1000, filled)
+      with self.assertRaises(errors.OutOfRangeError):
+        sess.run(get_next)
+
+      # Replay the cache with an empty upstream.
+      sess.run(iterator.initializer, feed_dict={count: 0})
+      for i in range(100):
+        value, filled = sess.run(get_next)
+        self.assertEqual(i, value)
+        self.assertAllEqual([i] * 1000, filled)
+      with self.assertRaises(errors.OutOfRangeError):
+        sess.run(get_next)
+
 
 class MemoryCacheDatasetTest(test.TestCase):
 
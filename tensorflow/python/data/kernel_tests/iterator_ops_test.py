@@ -715,6 +715,26 @@ class IteratorTest(test.TestCase):
       self.assertTrue(
           iterator_ops.GET_NEXT_CALL_WARNING_MESSAGE in str(warning.message))
 
+  def testGetNextTracedInStepStats(self):
+    dataset = dataset_ops.Dataset.range(10).map(lambda x: x * x)
+    iterator = dataset.make_one_shot_iterator()
+    get_next = iterator.get_next()
+
+    with self.test_session() as sess:
+      # Untraced steps do not record the iterators.
+      self.assertEqual(0, sess.run(get_next))
+      run_options = config_pb2.RunOptions(
+          trace_level=config_pb2.RunOptions.FULL_TRACE)
+      run_metadata = config_pb2.RunMetadata()
+      self.assertEqual(1, sess.run(
+          get_next, options=run_options, run_metadata=run_metadata))
+      node_names = set(
+          node_stats.node_name
+          for dev_stats in run_metadata.step_stats.dev_stats
+          for node_stats in dev_stats.node_stats)
+      self.assertIn("Iterator::Map", node_names)
+      self.assertIn("Iterator::Map::Range", node_names)
+
   def testEagerIteratorAsync(self):
     with context.eager_mode(), context.execution_mode(context.ASYNC):
       val = 0
@@ -624,6 +624,33 @@ class MapDatasetTest(test.TestCase):
       with self.assertRaises(errors.OutOfRangeError):
         sess.run(get_next)
 
+  def testSloppyParallelMap(self):
+    # The first element is only produced once the others have been consumed,
+    # which requires the iterator to return them out of order.
+    others_consumed = threading.Event()
+
+    def slow_first(i):
+      if i == 0:
+        others_consumed.wait()
+      return i
+
+    iterator = (
+        dataset_ops.Dataset.range(5)
+        .map(lambda x: script_ops.py_func(slow_first, [x], dtypes.int64),
+             num_parallel_calls=5, sloppy=True)
+        .make_initializable_iterator())
+    init_op = iterator.initializer
+    get_next = iterator.get_next()
+
+    with self.test_session() as sess:
+      sess.run(init_op)
+      results = [sess.run(get_next) for _ in range(4)]
+      self.assertEqual([1, 2, 3, 4], sorted(results))
+      others_consumed.set()
+      self.assertEqual(0, sess.run(get_next))
+      with self.assertRaises(errors.OutOfRangeError):
+        sess.run(get_next)
+
   def testConstantOutput(self):
     iterator = (
         dataset_ops.Dataset.range(10).map(lambda x: [x, "hello", 10])
@@ -309,6 +309,25 @@ class FixedLengthRecordReaderTest(test.TestCase):
       with self.assertRaises(errors.OutOfRangeError):
         sess.run(iterator.get_next())
 
+  def testFixedLengthRecordDatasetReadahead(self):
+    test_filenames = self._createFiles()
+    dataset = readers.FixedLengthRecordDataset(
+        test_filenames,
+        self._record_bytes,
+        self._header_bytes,
+        self._footer_bytes,
+        buffer_size=4,
+        readahead_chunks=3,
+        readahead_chunk_size=5)
+    iterator = dataset.make_one_shot_iterator()
+
+    with self.test_session() as sess:
+      for j in range(self._num_files):
+        for i in range(self._num_records):
+          self.assertEqual(self._record(j, i), sess.run(iterator.get_next()))
+      with self.assertRaises(errors.OutOfRangeError):
+        sess.run(iterator.get_next())
+
   def testFixedLengthRecordDatasetWrongSize(self):
     test_filenames = self._createFiles()
     dataset = readers.FixedLengthRecordDataset(
@@ -781,6 +800,22 @@ class TFRecordDatasetTest(test.TestCase):
       with self.assertRaises(errors.OutOfRangeError):
         sess.run(next_element)
 
+  def testReadWithReadahead(self):
+    for chunk_size in [None, 1, 7, 100]:
+      d = readers.TFRecordDataset(
+          self.test_filenames,
+          buffer_size=16,
+          readahead_chunks=4,
+          readahead_chunk_size=chunk_size)
+      iterator = d.make_one_shot_iterator()
+      next_element = iterator.get_next()
+      with self.test_session() as sess:
+        for j in range(self._num_files):
+          for i in range(self._num_records):
+            self.assertAllEqual(self._record(j, i), sess.run(next_element))
+        with self.assertRaises(errors.OutOfRangeError):
+          sess.run(next_element)
+
   def testReadFromDatasetOfFiles(self):
     files = dataset_ops.Dataset.from_tensor_slices(self.test_filenames)
     d = readers.TFRecordDataset(files)
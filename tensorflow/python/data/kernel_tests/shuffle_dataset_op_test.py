@@ -18,6 +18,7 @@ from __future__ import division
 from __future__ import print_function
 
 import collections
+import os
 
 import numpy as np
 
@@ -208,5 +209,25 @@ class ShuffleDatasetTest(test.TestCase):
       with self.assertRaises(errors.OutOfRangeError):
         sess.run(next_element)
 
+  def testShuffleSpill(self):
+    spill_directory = os.path.join(self.get_temp_dir(), "spill")
+    iterator = (dataset_ops.Dataset.range(1000)
+                .shuffle(1000, seed=7, spill_directory=spill_directory,
+                         max_memory_bytes=800)
+                .make_one_shot_iterator())
+    next_element = iterator.get_next()
+
+    with self.test_session() as sess:
+      results = [sess.run(next_element) for _ in range(1000)]
+      self.assertNotEqual(list(range(1000)), results)
+      self.assertAllEqual(list(range(1000)), sorted(results))
+      with self.assertRaises(errors.OutOfRangeError):
+        sess.run(next_element)
+
+  def testShuffleSpillRequiresMaxMemoryBytes(self):
+    with self.assertRaises(ValueError):
+      dataset_ops.Dataset.range(10).shuffle(
+          10, spill_directory=self.get_temp_dir())
+
 if __name__ == "__main__":
   test.main()
@@ -44,6 +44,11 @@ from tensorflow.python.util import deprecation
 from tensorflow.python.util.tf_export import tf_export
 
 
+# Value of a parallelism or buffer size argument (e.g. `num_parallel_calls` of
+# `Dataset.map()` or `buffer_size` of `Dataset.prefetch()`) requesting that it
+# is tuned at runtime by the performance model of the input pipeline.
+AUTOTUNE = -1
+
 @tf_export("data.Dataset")
 class Dataset(object):
   """Represents a potentially large set of elements.
@@ -591,7 +596,9 @@ class Dataset(object):
 
     Args:
       buffer_size: A `tf.int64` scalar `tf.Tensor`, representing the
-        maximum number of elements that will be buffered when prefetching.
+        maximum number of elements that will be buffered when prefetching. If
+        `AUTOTUNE`, the buffer size is tuned at runtime along with the rest of
+        the pipeline.
 
     Returns:
       Dataset: A `Dataset`.
@@ -662,9 +669,18 @@ class Dataset(object):
     max_value = np.iinfo(dtypes.int64.as_numpy_dtype).max
     return Dataset.zip((Dataset.range(start, max_value), self))
 
-  def shuffle(self, buffer_size, seed=None, reshuffle_each_iteration=None):
+  def shuffle(self,
+              buffer_size,
+              seed=None,
+              reshuffle_each_iteration=None,
+              spill_directory=None,
+              max_memory_bytes=None):
     """Randomly shuffles the elements of this dataset.
 
+    Large buffers of elements whose components have a fully defined shape and
+    a numeric or boolean type can be partially spilled to local files by
+    passing `spill_directory` and `max_memory_bytes`.
+
     Args:
       buffer_size: A `tf.int64` scalar `tf.Tensor`, representing the
         number of elements from this dataset from which the new
@@ -675,24 +691,32 @@ class Dataset(object):
       reshuffle_each_iteration: (Optional.) A boolean, which if true indicates
         that the dataset should be pseudorandomly reshuffled each time it is
         iterated over. (Defaults to `True`.)
+      spill_directory: (Optional.) A local directory to which the buffered
+        elements in excess of `max_memory_bytes` are spilled.
+      max_memory_bytes: (Optional.) The maximum number of bytes of buffered
+        elements kept in memory. Required if `spill_directory` is set.
 
     Returns:
       Dataset: A `Dataset`.
     """
-    return ShuffleDataset(self, buffer_size, seed, reshuffle_each_iteration)
+    return ShuffleDataset(self, buffer_size, seed, reshuffle_each_iteration,
+                          spill_directory, max_memory_bytes)
 
-  def cache(self, filename=""):
+  def cache(self, filename="", compression_type=None):
     """Caches the elements in this dataset.
 
     Args:
       filename: A `tf.string` scalar `tf.Tensor`, representing the name of a
         directory on the filesystem to use for caching tensors in this Dataset.
         If a filename is not provided, the dataset will be cached in memory.
+      compression_type: (Optional.) One of `"ZLIB"` or `"SNAPPY"`, the
+        compression of the chunks of elements written to `filename`. Defaults
+        to no compression.
 
     Returns:
       Dataset: A `Dataset`.
     """
-    return CacheDataset(self, filename)
+    return CacheDataset(self, filename, compression_type)
 
   def take(self, count):
     """Creates a `Dataset` with at most `count` elements from this dataset.
@@ -862,7 +886,7 @@ class Dataset(object):
     """
     return PaddedBatchDataset(self, batch_size, padded_shapes, padding_values)
 
-  def map(self, map_func, num_parallel_calls=None):
+  def map(self, map_func, num_parallel_calls=None, sloppy=False):
     """Maps `map_func` across this dataset.
 
     Args:
@@ -871,7 +895,12 @@ class Dataset(object):
        `self.output_types`) to another nested structure of tensors.
       num_parallel_calls: (Optional.) A `tf.int32` scalar `tf.Tensor`,
         representing the number elements to process in parallel. If not
-        specified, elements will be processed sequentially.
+        specified, elements will be processed sequentially. If `AUTOTUNE`,
+        the number is tuned at runtime along with the rest of the pipeline.
+      sloppy: (Optional.) A `bool`. If `True` and `num_parallel_calls` is
+        specified, the elements are produced in the order in which
+        `map_func` completes for them rather than in the order of the input,
+        so that a slow element does not delay the elements after it.
 
     Returns:
       Dataset: A `Dataset`.
@@ -879,7 +908,7 @@ class Dataset(object):
     if num_parallel_calls is None:
       return MapDataset(self, map_func)
     else:
-      return ParallelMapDataset(self, map_func, num_parallel_calls)
+      return ParallelMapDataset(self, map_func, num_parallel_calls, sloppy)
 
   def flat_map(self, map_func):
     """Maps `map_func` across this dataset and flattens the result.
@@ -1501,17 +1530,19 @@ class RangeDataset(Dataset):
 class CacheDataset(Dataset):
   """A `Dataset` that caches elements of its input."""
 
-  def __init__(self, input_dataset, filename):
+  def __init__(self, input_dataset, filename, compression_type=None):
     """See `Dataset.cache()` for details."""
     super(CacheDataset, self).__init__()
     self._input_dataset = input_dataset
     self._filename = ops.convert_to_tensor(
         filename, dtype=dtypes.string, name="filename")
+    self._compression_type = compression_type or ""
 
   def _as_variant_tensor(self):
     return gen_dataset_ops.cache_dataset(
         self._input_dataset._as_variant_tensor(),  # pylint: disable=protected-access
         filename=self._filename,
+        compression=self._compression_type,
         output_shapes=nest.flatten(
             sparse.as_dense_shapes(self.output_shapes, self.output_classes)),
         output_types=nest.flatten(
@@ -1537,7 +1568,9 @@ class ShuffleDataset(Dataset):
                input_dataset,
                buffer_size,
                seed=None,
-               reshuffle_each_iteration=None):
+               reshuffle_each_iteration=None,
+               spill_directory=None,
+               max_memory_bytes=None):
     """Randomly shuffles the elements of this dataset.
 
     Args:
@@ -1551,6 +1584,10 @@ class ShuffleDataset(Dataset):
       reshuffle_each_iteration: (Optional.) A boolean, which if true indicates
         that the dataset should be pseudorandomly reshuffled each time it is
         iterated over. (Defaults to `True`.)
+      spill_directory: (Optional.) A local directory to which the buffered
+        elements in excess of `max_memory_bytes` are spilled.
+      max_memory_bytes: (Optional.) The maximum number of bytes of buffered
+        elements kept in memory. Required if `spill_directory` is set.
 
     Returns:
       A `Dataset`.
@@ -1567,6 +1604,11 @@ class ShuffleDataset(Dataset):
       self._reshuffle_each_iteration = True
     else:
       self._reshuffle_each_iteration = reshuffle_each_iteration
+    if spill_directory is not None and not max_memory_bytes:
+      raise ValueError(
+          "`max_memory_bytes` must be set when `spill_directory` is set.")
+    self._spill_directory = spill_directory or ""
+    self._max_memory_bytes = max_memory_bytes or 0
 
   def _as_variant_tensor(self):
     return gen_dataset_ops.shuffle_dataset(
@@ -1575,6 +1617,8 @@ class ShuffleDataset(Dataset):
         seed=self._seed,
         seed2=self._seed2,
         reshuffle_each_iteration=self._reshuffle_each_iteration,
+        spill_directory=self._spill_directory,
+        max_memory_bytes=self._max_memory_bytes,
         output_shapes=nest.flatten(
             sparse.as_dense_shapes(self.output_shapes, self.output_classes)),
         output_types=nest.flatten(
@@ -1894,9 +1938,11 @@ class MapDataset(Dataset):
 class ParallelMapDataset(MapDataset):
   """A `Dataset` that maps a function over elements in its input in parallel."""
 
-  def __init__(self, input_dataset, map_func, num_parallel_calls):
+  def __init__(self, input_dataset, map_func, num_parallel_calls,
+               sloppy=False):
     """See `Dataset.map()` for details."""
     super(ParallelMapDataset, self).__init__(input_dataset, map_func)
+    self._sloppy = sloppy
 
     self._num_parallel_calls = ops.convert_to_tensor(
         num_parallel_calls, dtype=dtypes.int32, name="num_parallel_calls")
@@ -1909,6 +1955,7 @@ class ParallelMapDataset(MapDataset):
         self._map_func.captured_inputs,
         f=self._map_func,
         num_parallel_calls=self._num_parallel_calls,
+        sloppy=self._sloppy,
         output_types=nest.flatten(
             sparse.as_dense_types(self.output_types, self.output_classes)),
         output_shapes=nest.flatten(
@@ -79,15 +79,24 @@ class TextLineDataset(dataset_ops.Dataset):
 class _TFRecordDataset(dataset_ops.Dataset):
   """A `Dataset` comprising records from one or more TFRecord files."""
 
-  def __init__(self, filenames, compression_type=None, buffer_size=None):
+  def __init__(self,
+               filenames,
+               compression_type=None,
+               buffer_size=None,
+               readahead_chunks=None,
+               readahead_chunk_size=None):
     """Creates a `TFRecordDataset`.
 
     Args:
       filenames: A `tf.string` tensor containing one or more filenames.
       compression_type: (Optional.) A `tf.string` scalar evaluating to one of
-        `""` (no compression), `"ZLIB"`, or `"GZIP"`.
+        `""` (no compression), `"ZLIB"`, `"GZIP"`, or `"SNAPPY"`.
       buffer_size: (Optional.) A `tf.int64` scalar representing the number of
         bytes in the read buffer. 0 means no buffering.
+      readahead_chunks: (Optional.) The number of reads to keep outstanding
+        ahead of the reader of each file. Defaults to no readahead.
+      readahead_chunk_size: (Optional.) The number of bytes read by each
+        readahead request. Defaults to 1 MiB.
     """
     super(_TFRecordDataset, self).__init__()
     # Force the type to string even if filenames is an empty list.
@@ -102,10 +111,16 @@ class _TFRecordDataset(dataset_ops.Dataset):
         "buffer_size",
         buffer_size,
         argument_default=_DEFAULT_READER_BUFFER_SIZE_BYTES)
+    self._readahead_chunks = readahead_chunks or 0
+    self._readahead_chunk_size = readahead_chunk_size or 0
 
   def _as_variant_tensor(self):
     return gen_dataset_ops.tf_record_dataset(
-        self._filenames, self._compression_type, self._buffer_size)
+        self._filenames,
+        self._compression_type,
+        self._buffer_size,
+        readahead_chunks=self._readahead_chunks,
+        readahead_chunk_size=self._readahead_chunk_size)
 
   @property
   def output_classes(self):
@@ -162,22 +177,31 @@ class TFRecordDataset(dataset_ops.Dataset):
   """A `Dataset` comprising records from one or more TFRecord files."""
 
   def __init__(self, filenames, compression_type=None, buffer_size=None,
-               num_parallel_reads=None):
+               num_parallel_reads=None, readahead_chunks=None,
+               readahead_chunk_size=None):
     """Creates a `TFRecordDataset` to read for one or more TFRecord files.
 
-    NOTE: The `num_parallel_reads` argument can be used to improve performance
-    when reading from a remote filesystem.
+    NOTE: The `num_parallel_reads` and `readahead_chunks` arguments can be used
+    to improve performance when reading from a remote filesystem. The former
+    reads several files in parallel; the latter issues several reads of each
+    file in parallel, which helps when the files are few or large.
 
     Args:
       filenames: A `tf.string` tensor or `tf.data.Dataset` containing one or
         more filenames.
       compression_type: (Optional.) A `tf.string` scalar evaluating to one of
-        `""` (no compression), `"ZLIB"`, or `"GZIP"`.
+        `""` (no compression), `"ZLIB"`, `"GZIP"`, or `"SNAPPY"`.
       buffer_size: (Optional.) A `tf.int64` scalar representing the number of
         bytes in the read buffer. 0 means no buffering.
       num_parallel_reads: (Optional.) A `tf.int64` scalar representing the
         number of files to read in parallel. Defaults to reading files
         sequentially.
+      readahead_chunks: (Optional.) A Python integer representing the number
+        of reads of `readahead_chunk_size` bytes to keep outstanding ahead of
+        the reader of each file, on a dedicated thread pool. Defaults to no
+        readahead.
+      readahead_chunk_size: (Optional.) A Python integer representing the
+        number of bytes read by each readahead request. Defaults to 1 MiB.
 
     Raises:
       TypeError: If any argument does not have the expected type.
@@ -201,9 +225,12 @@ class TFRecordDataset(dataset_ops.Dataset):
     self._compression_type = compression_type
     self._buffer_size = buffer_size
     self._num_parallel_reads = num_parallel_reads
+    self._readahead_chunks = readahead_chunks
+    self._readahead_chunk_size = readahead_chunk_size
 
     def read_one_file(filename):
-      return _TFRecordDataset(filename, compression_type, buffer_size)
+      return _TFRecordDataset(filename, compression_type, buffer_size,
+                              readahead_chunks, readahead_chunk_size)
 
     if num_parallel_reads is None:
       self._impl = filenames.flat_map(read_one_file)
@@ -217,11 +244,15 @@ class TFRecordDataset(dataset_ops.Dataset):
              filenames=None,
              compression_type=None,
              buffer_size=None,
-             num_parallel_reads=None):
+             num_parallel_reads=None,
+             readahead_chunks=None,
+             readahead_chunk_size=None):
     return TFRecordDataset(filenames or self._filenames,
                            compression_type or self._compression_type,
                            buffer_size or self._buffer_size,
-                           num_parallel_reads or self._num_parallel_reads)
+                           num_parallel_reads or self._num_parallel_reads,
+                           readahead_chunks or self._readahead_chunks,
+                           readahead_chunk_size or self._readahead_chunk_size)
 
   def _as_variant_tensor(self):
     return self._impl._as_variant_tensor()  # pylint: disable=protected-access
@@ -248,7 +279,9 @@ class FixedLengthRecordDataset(dataset_ops.Dataset):
                record_bytes,
                header_bytes=None,
                footer_bytes=None,
-               buffer_size=None):
+               buffer_size=None,
+               readahead_chunks=None,
+               readahead_chunk_size=None):
     """Creates a `FixedLengthRecordDataset`.
 
     Args:
@@ -261,6 +294,12 @@ class FixedLengthRecordDataset(dataset_ops.Dataset):
         bytes to ignore at the end of a file.
       buffer_size: (Optional.) A `tf.int64` scalar representing the number of
         bytes to buffer when reading.
+      readahead_chunks: (Optional.) A Python integer representing the number
+        of reads of `readahead_chunk_size` bytes to keep outstanding ahead of
+        the reader of each file, on a dedicated thread pool. Defaults to no
+        readahead.
+      readahead_chunk_size: (Optional.) A Python integer representing the
+        number of bytes read by each readahead request. Defaults to 1 MiB.
     """
     super(FixedLengthRecordDataset, self).__init__()
     self._filenames = ops.convert_to_tensor(
@@ -274,11 +313,18 @@ class FixedLengthRecordDataset(dataset_ops.Dataset):
         "footer_bytes", footer_bytes)
     self._buffer_size = convert.optional_param_to_tensor(
         "buffer_size", buffer_size, _DEFAULT_READER_BUFFER_SIZE_BYTES)
+    self._readahead_chunks = readahead_chunks or 0
+    self._readahead_chunk_size = readahead_chunk_size or 0
 
   def _as_variant_tensor(self):
     return gen_dataset_ops.fixed_length_record_dataset(
-        self._filenames, self._header_bytes, self._record_bytes,
-        self._footer_bytes, self._buffer_size)
+        self._filenames,
+        self._header_bytes,
+        self._record_bytes,
+        self._footer_bytes,
+        self._buffer_size,
+        readahead_chunks=self._readahead_chunks,
+        readahead_chunk_size=self._readahead_chunk_size)
 
   @property
   def output_classes(self):
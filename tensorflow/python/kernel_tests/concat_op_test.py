@@ -49,6 +49,15 @@ class ConcatOpTest(test.TestCase):
     self.assertAllEqual(result[:4, :], params[p1])
     self.assertAllEqual(result[4:, :], params[p2])
 
+  def testLarge(self):
+    # Large enough for the output to be written with non-temporal stores, and
+    # with rows that do not start on cache lines.
+    with self.test_session(use_gpu=True):
+      x1 = np.random.rand(2048, 501).astype("f")
+      x2 = np.random.rand(2048, 1003).astype("f")
+      result = array_ops.concat([x1, x2], 1).eval()
+    self.assertAllEqual(result, np.concatenate([x1, x2], 1))
+
   def testVStack(self):
     with self.test_session(use_gpu=True):
       p1 = array_ops.placeholder(dtypes.float32, shape=[4, 4])
@@ -17,11 +17,17 @@ from __future__ import absolute_import
 from __future__ import division
 from __future__ import print_function
 
+import os
+
 from tensorflow.core.protobuf import config_pb2
 from tensorflow.python.client import session
+from tensorflow.python.framework import constant_op
 from tensorflow.python.framework import dtypes
+from tensorflow.python.framework import errors
+from tensorflow.python.framework import ops
 from tensorflow.python.ops import gen_io_ops
 from tensorflow.python.ops import io_ops
+from tensorflow.python.platform import gfile
 from tensorflow.python.platform import test
 
 
@@ -56,5 +62,37 @@ class ShapeInferenceTest(test.TestCase):
     self.assertEqual([1, 4], op.get_shape())
 
 
+class AsyncSaveTest(test.TestCase):
+
+  def testSaveAndRestore(self):
+    prefix = os.path.join(self.get_temp_dir(), "async_ckpt")
+    with self.test_session() as sess:
+      save = gen_io_ops.async_save_v2(
+          prefix, ["x", "y"], ["", ""],
+          [constant_op.constant([1.0, 2.0]), constant_op.constant(3)])
+      with ops.control_dependencies([save]):
+        wait = gen_io_ops.await_async_saves()
+      sess.run(wait)
+      x, y = io_ops.restore_v2(prefix, ["x", "y"], ["", ""],
+                               [dtypes.float32, dtypes.int32])
+      self.assertAllEqual([1.0, 2.0], x.eval())
+      self.assertEqual(3, y.eval())
+
+  def testWriteErrorIsReportedOnce(self):
+    # A prefix whose directory cannot be created, as it is a file.
+    not_a_dir = os.path.join(self.get_temp_dir(), "not_a_dir")
+    with gfile.GFile(not_a_dir, "w") as f:
+      f.write("")
+    prefix = os.path.join(not_a_dir, "async_ckpt")
+    with self.test_session() as sess:
+      save = gen_io_ops.async_save_v2(prefix, ["x"], [""],
+                                      [constant_op.constant(1.0)])
+      wait = gen_io_ops.await_async_saves()
+      sess.run(save)
+      with self.assertRaises(errors.OpError):
+        sess.run(wait)
+      sess.run(wait)
+
+
 if __name__ == "__main__":
   test.main()
@@ -259,6 +259,14 @@ class SplitOpTest(test.TestCase):
       self._compare(self._makeData((6, 7, 18), dtype), 0, 3)
       self._compare(self._makeData((6, 7, 9), dtype), 0, 3)
 
+  @test_util.run_in_graph_and_eager_modes()
+  def testLarge(self):
+    # Large enough for the outputs to be written with non-temporal stores, and
+    # with rows that do not start on cache lines.
+    inp = self._makeData((3, 1024, 1503), np.float32)
+    self._compare(inp, 1, 2)
+    self._compare(inp, 2, 3)
+
   def _RunAndVerify(self, dtype, large_num_splits=False):
     # Random dims of rank 5
     shape = np.random.randint(0, 5, size=5)
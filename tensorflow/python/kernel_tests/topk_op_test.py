@@ -160,6 +160,17 @@ class TopKTest(test.TestCase):
       values = -np.sort(-inputs, axis=1)[:, :k]
       self._validateTopK(inputs, k, values, indices)
 
+  def testLongRows(self):
+    # Few rows long enough to be split between threads.
+    b = 2
+    n = 300000
+    for k in [1, 100, n]:
+      # Repeated integers, to check that ties still go to the lowest index.
+      inputs = np.random.randint(0, 1000, size=(b, n)).astype(np.int32)
+      indices = np.argsort(-inputs, axis=1, kind="mergesort")[:, :k]
+      values = -np.sort(-inputs, axis=1)[:, :k]
+      self._validateTopK(inputs, k, values, indices)
+
   def testTopAll(self):
     inputs = [[0.1, 0.3, 0.2, 0.4], [0.1, 0.3, 0.3, 0.2]]
     self._validateTopK(inputs, 4, [[0.4, 0.3, 0.2, 0.1], [0.3, 0.3, 0.2, 0.1]],
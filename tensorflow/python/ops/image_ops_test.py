@@ -2847,6 +2847,52 @@ class JpegTest(test_util.TensorFlowTestCase):
             lambda e: "Invalid JPEG data or crop window" in str(e)):
           sess.run(result)
 
+  def testDecodeJpegBatch(self):
+    with self.test_session() as sess:
+      base = "tensorflow/core/lib/jpeg/testdata"
+      jpeg0 = io_ops.read_file(os.path.join(base, "jpeg_merge_test1.jpg"))
+      jpeg1 = image_ops.encode_jpeg(image_ops.decode_jpeg(jpeg0), quality=50)
+      contents = array_ops.stack([jpeg0, jpeg1, jpeg0, jpeg1, jpeg0])
+
+      for ratio in 1, 2:
+        images = image_ops.decode_jpeg_batch(contents, ratio=ratio)
+        expected = [image_ops.decode_jpeg(jpeg0, ratio=ratio),
+                    image_ops.decode_jpeg(jpeg1, ratio=ratio)]
+        images, expected = sess.run([images, expected])
+        self.assertEqual(images.shape,
+                         (5, 256 // ratio, 128 // ratio, 3))
+        for i in range(5):
+          self.assertAllEqual(images[i], expected[i % 2])
+
+  def testDecodeAndCropJpegBatch(self):
+    with self.test_session() as sess:
+      base = "tensorflow/core/lib/jpeg/testdata"
+      jpeg0 = io_ops.read_file(os.path.join(base, "jpeg_merge_test1.jpg"))
+      contents = array_ops.stack([jpeg0, jpeg0, jpeg0])
+      crop_windows = [[0, 0, 15, 10], [6, 5, 15, 10], [241, 118, 15, 10]]
+
+      images = image_ops.decode_and_crop_jpeg_batch(contents, crop_windows)
+      self.assertAllEqual(images.get_shape().as_list(), [3, 15, 10, None])
+      expected = [
+          image_ops.decode_and_crop_jpeg(jpeg0, crop_window)
+          for crop_window in crop_windows
+      ]
+      images, expected = sess.run([images, expected])
+      for i in range(3):
+        self.assertAllEqual(images[i], expected[i])
+
+  def testDecodeJpegBatchWithDifferentShapes(self):
+    with self.test_session() as sess:
+      base = "tensorflow/core/lib/jpeg/testdata"
+      jpeg0 = io_ops.read_file(os.path.join(base, "jpeg_merge_test1.jpg"))
+      jpeg1 = image_ops.encode_jpeg(
+          image_ops.decode_and_crop_jpeg(jpeg0, [0, 0, 5, 5]))
+      images = image_ops.decode_jpeg_batch(array_ops.stack([jpeg0, jpeg1]))
+      with self.assertRaisesWithPredicateMatch(
+          errors.InvalidArgumentError,
+          lambda e: "but image 0 has shape" in str(e)):
+        sess.run(images)
+
   def testSynthetic(self):
     with self.test_session(use_gpu=True) as sess:
       # Encode it, then decode it, then encode it
@@ -26,6 +26,9 @@ limitations under the License.
 #include <unordered_set>
 #include <vector>
 
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_mgr.h"
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/step_stats.pb.h"
@@ -282,7 +285,8 @@ Status InitializeSession(int num_threads, const string& graph,
 Status RunBenchmark(const std::vector<InputLayerInfo>& inputs,
                     const std::vector<string>& outputs,
                     const std::vector<string>& targets, Session* session,
-                    StatSummarizer* stats, int64* inference_time_us) {
+                    StatSummarizer* stats, bool hardware_trace,
+                    int64* inference_time_us) {
   std::vector<std::pair<string, tensorflow::Tensor> > input_tensors;
   CreateTensorsFromInputInfo(inputs, &input_tensors);
 
@@ -292,7 +296,8 @@ Status RunBenchmark(const std::vector<InputLayerInfo>& inputs,
 
   RunOptions run_options;
   if (stats != nullptr) {
-    run_options.set_trace_level(RunOptions::FULL_TRACE);
+    run_options.set_trace_level(hardware_trace ? RunOptions::HARDWARE_TRACE
+                                               : RunOptions::FULL_TRACE);
   }
 
   RunMetadata run_metadata;
@@ -320,8 +325,8 @@ Status TimeMultipleRuns(double sleep_seconds, int num_runs, double max_time_s,
                         const std::vector<InputLayerInfo>& inputs,
                         const std::vector<string>& outputs,
                         const std::vector<string>& targets, Session* session,
-                        StatSummarizer* stats, int64* total_time_us,
-                        int64* actual_num_runs) {
+                        StatSummarizer* stats, bool hardware_trace,
+                        int64* total_time_us, int64* actual_num_runs) {
   *total_time_us = 0;
 
   LOG(INFO) << "Running benchmark for max " << num_runs << " iterations, max "
@@ -334,8 +339,8 @@ Status TimeMultipleRuns(double sleep_seconds, int num_runs, double max_time_s,
   const bool until_max_time = num_runs <= 0;
   for (int i = 0; until_max_time || i < num_runs; ++i) {
     int64 time;
-    Status run_status =
-        RunBenchmark(inputs, outputs, targets, session, stats, &time);
+    Status run_status = RunBenchmark(inputs, outputs, targets, session, stats,
+                                     hardware_trace, &time);
     stat.UpdateStat(time);
     (*total_time_us) += time;
     ++(*actual_num_runs);
@@ -363,6 +368,24 @@ Status TimeMultipleRuns(double sleep_seconds, int num_runs, double max_time_s,
   return Status::OK();
 }
 
+void LogDeviceMemoryUsage(Session* session) {
+  const DeviceMgr* device_mgr;
+  if (!session->LocalDeviceManager(&device_mgr).ok()) {
+    return;
+  }
+  for (Device* device : device_mgr->ListDevices()) {
+    AllocatorStats allocator_stats;
+    device->GetAllocator(AllocatorAttributes())->GetStats(&allocator_stats);
+    // Allocators not keeping stats, like the default CPU one, report nothing.
+    if (allocator_stats.max_bytes_in_use == 0) {
+      continue;
+    }
+    LOG(INFO) << "Memory of " << device->name() << ": "
+              << allocator_stats.bytes_in_use << " bytes in use, peak "
+              << allocator_stats.max_bytes_in_use << " bytes";
+  }
+}
+
 int Main(int argc, char** argv) {
   string graph = "/data/local/tmp/tensorflow_inception_graph.pb";
   string init_ops_string = "";
@@ -390,6 +413,7 @@ int Main(int argc, char** argv) {
   bool show_summary = true;
   bool show_flops = false;
   int warmup_runs = 1;
+  bool hardware_trace = false;
 
   std::vector<Flag> flag_list = {
       Flag("graph", &graph, "graph file name"),
@@ -425,6 +449,8 @@ int Main(int argc, char** argv) {
            "whether to show a summary of the stats"),
       Flag("show_flops", &show_flops, "whether to estimate the model's FLOPs"),
       Flag("warmup_runs", &warmup_runs, "how many runs to initialize model"),
+      Flag("hardware_trace", &hardware_trace,
+           "whether to time the kernels and copies on GPU and SYCL devices"),
   };
   string usage = Flags::Usage(argv[0], flag_list);
   const bool parse_result = Flags::Parse(&argc, argv, flag_list);
@@ -482,6 +508,7 @@ int Main(int argc, char** argv) {
   LOG(INFO) << "Output prefix: [" << output_prefix << "]";
   LOG(INFO) << "Show sizes: [" << show_sizes << "]";
   LOG(INFO) << "Warmup runs: [" << warmup_runs << "]";
+  LOG(INFO) << "Hardware trace: [" << hardware_trace << "]";
 
   std::unique_ptr<Session> session;
   std::unique_ptr<StatSummarizer> stats;
@@ -561,7 +588,7 @@ int Main(int argc, char** argv) {
     Status warmup_time_status =
         TimeMultipleRuns(inter_inference_sleep_seconds, warmup_runs, -1.0,
                          inputs, output_layers, target_layers, session.get(),
-                         nullptr, &warmup_time_us, &num_warmup_runs);
+                         nullptr, false, &warmup_time_us, &num_warmup_runs);
     if (!warmup_time_status.ok()) {
       LOG(ERROR) << "Timing failed with " << warmup_time_status;
       return -1;
@@ -575,7 +602,7 @@ int Main(int argc, char** argv) {
   int64 no_stat_num_runs = 0;
   Status no_stat_time_status = TimeMultipleRuns(
       inter_inference_sleep_seconds, max_num_runs, max_benchmark_time_seconds,
-      inputs, output_layers, target_layers, session.get(), nullptr,
+      inputs, output_layers, target_layers, session.get(), nullptr, false,
       &no_stat_time_us, &no_stat_num_runs);
   const double no_stat_wall_time = no_stat_time_us / 1000000.0;
   if (!no_stat_time_status.ok()) {
@@ -591,7 +618,7 @@ int Main(int argc, char** argv) {
   Status stat_time_status = TimeMultipleRuns(
       inter_inference_sleep_seconds, max_num_runs, max_benchmark_time_seconds,
       inputs, output_layers, target_layers, session.get(), stats.get(),
-      &stat_time_us, &stat_num_runs);
+      hardware_trace, &stat_time_us, &stat_num_runs);
   if (!stat_time_status.ok()) {
     LOG(ERROR) << "Timing failed with " << stat_time_status;
     return -1;
@@ -605,6 +632,12 @@ int Main(int argc, char** argv) {
 
   stats->PrintStepStats();
 
+  const string transfer_summary = stats->GetTransferSummary();
+  if (!transfer_summary.empty()) {
+    LOG(INFO) << transfer_summary;
+  }
+  LogDeviceMemoryUsage(session.get());
+
   if (show_sizes) {
     stats->PrintOutputs();
   }
@@ -36,18 +36,25 @@ Status InitializeSession(int num_threads, const string& graph,
                          std::unique_ptr<GraphDef>* graph_def);
 
 // Does a single run of the model that's been loaded into the given session.
+// If hardware_trace is true, the stats also hold the kernels and copies timed
+// by the device tracers (for GPU and SYCL devices).
 Status RunBenchmark(const std::vector<InputLayerInfo>& inputs,
                     const std::vector<string>& outputs,
                     const std::vector<string>& targets, Session* session,
-                    StatSummarizer* stats, int64* inference_time_us);
+                    StatSummarizer* stats, bool hardware_trace,
+                    int64* inference_time_us);
 
 // Runs the model multiple time, keeping track of timing information.
 Status TimeMultipleRuns(double sleep_seconds, int num_runs, double max_time_s,
                         const std::vector<InputLayerInfo>& inputs,
                         const std::vector<string>& outputs,
                         const std::vector<string>& targets, Session* session,
-                        StatSummarizer* stats, int64* total_time_us,
-                        int64* actual_num_runs);
+                        StatSummarizer* stats, bool hardware_trace,
+                        int64* total_time_us, int64* actual_num_runs);
+
+// Logs the bytes in use and the peak bytes in use of the device allocators of
+// the session.
+void LogDeviceMemoryUsage(Session* session);
 
 // Handles all setup and argument parsing.
 int Main(int argc, char** argv);